@@ -23,6 +23,7 @@
 
 #include <array>
 #include <memory>
+#include <mutex>
 #include <shared_mutex>
 
 #include "com_android_bluetooth.h"
@@ -112,6 +113,8 @@ namespace android {
 static jmethodID method_onClientRegistered;
 static jmethodID method_onScannerRegistered;
 static jmethodID method_onScanResult;
+static jmethodID method_onScanResultBatch;
+static jmethodID method_onScanResultBatchPending;
 static jmethodID method_onConnected;
 static jmethodID method_onDisconnected;
 static jmethodID method_onReadCharacteristic;
@@ -121,6 +124,7 @@ static jmethodID method_onSearchCompleted;
 static jmethodID method_onReadDescriptor;
 static jmethodID method_onWriteDescriptor;
 static jmethodID method_onNotify;
+static jmethodID method_onNotifyBatch;
 static jmethodID method_onRegisterForNotifications;
 static jmethodID method_onReadRemoteRssi;
 static jmethodID method_onConfigureMTU;
@@ -194,6 +198,107 @@ static jobject mAdvertiseCallbacksObj = NULL;
 static jobject mPeriodicScanCallbacksObj = NULL;
 static std::shared_mutex callbacks_mutex;
 
+/**
+ * Scan result batching
+ *
+ * While enabled, the scan results are packed into a buffer instead of being
+ * delivered one by one, and the buffer is handed to Java as a single direct
+ * ByteBuffer. The first result of a batch notifies Java, which flushes the
+ * batch with gattClientFlushScanResultsNative() once its dispatch interval
+ * elapsed. A batch that fills up before that is delivered right away.
+ *
+ * Each result is packed as, multi-byte values in little endian:
+ *   event_type (2), addr_type (1), address (6), primary_phy (1),
+ *   secondary_phy (1), advertising_sid (1), tx_power (1), rssi (1),
+ *   periodic_adv_int (2), original_address (6), adv_data length (2), adv_data
+ */
+struct ScanResultBatch {
+  std::mutex mutex;
+  // Size the batch is delivered at, 0 when batching is disabled
+  size_t max_bytes = 0;
+  std::vector<uint8_t> pending;
+  int pending_count = 0;
+  // Buffer of the last delivered batch, kept to reuse its allocation
+  std::vector<uint8_t> spare;
+};
+static ScanResultBatch sScanResultBatch;
+
+static void append_le16(std::vector<uint8_t>* buffer, uint16_t value) {
+  buffer->push_back(value & 0xFF);
+  buffer->push_back(value >> 8);
+}
+
+static void append_address(std::vector<uint8_t>* buffer,
+                           const RawAddress& address) {
+  buffer->insert(buffer->end(), address.address,
+                 address.address + RawAddress::kLength);
+}
+
+// Deliver the pending batch to |callbacks| on the thread of |env|. The
+// ByteBuffer is only valid during the call
+static void dispatchScanResultBatch(JNIEnv* env, jobject callbacks) {
+  std::vector<uint8_t> batch;
+  int count;
+  {
+    std::lock_guard<std::mutex> lock(sScanResultBatch.mutex);
+    if (sScanResultBatch.pending_count == 0) return;
+    batch = std::move(sScanResultBatch.pending);
+    count = sScanResultBatch.pending_count;
+    sScanResultBatch.pending = std::move(sScanResultBatch.spare);
+    sScanResultBatch.pending.clear();
+    sScanResultBatch.pending_count = 0;
+  }
+
+  if (callbacks != NULL) {
+    ScopedLocalRef<jobject> buffer(
+        env, env->NewDirectByteBuffer(batch.data(), batch.size()));
+    env->CallVoidMethod(callbacks, method_onScanResultBatch, buffer.get(),
+                        count);
+  }
+
+  batch.clear();
+  std::lock_guard<std::mutex> lock(sScanResultBatch.mutex);
+  sScanResultBatch.spare = std::move(batch);
+}
+
+// Add a scan result to the pending batch, false when batching is disabled
+static bool batchScanResult(const CallbackEnv& env, uint16_t event_type,
+                            uint8_t addr_type, const RawAddress& bda,
+                            uint8_t primary_phy, uint8_t secondary_phy,
+                            uint8_t advertising_sid, int8_t tx_power,
+                            int8_t rssi, uint16_t periodic_adv_int,
+                            const std::vector<uint8_t>& adv_data,
+                            const RawAddress& original_bda) {
+  bool first;
+  bool full;
+  {
+    std::lock_guard<std::mutex> lock(sScanResultBatch.mutex);
+    if (sScanResultBatch.max_bytes == 0) return false;
+    std::vector<uint8_t>* buffer = &sScanResultBatch.pending;
+    append_le16(buffer, event_type);
+    buffer->push_back(addr_type);
+    append_address(buffer, bda);
+    buffer->push_back(primary_phy);
+    buffer->push_back(secondary_phy);
+    buffer->push_back(advertising_sid);
+    buffer->push_back(tx_power);
+    buffer->push_back(rssi);
+    append_le16(buffer, periodic_adv_int);
+    append_address(buffer, original_bda);
+    append_le16(buffer, adv_data.size());
+    buffer->insert(buffer->end(), adv_data.begin(), adv_data.end());
+    first = sScanResultBatch.pending_count++ == 0;
+    full = buffer->size() >= sScanResultBatch.max_bytes;
+  }
+
+  if (full) {
+    dispatchScanResultBatch(env.get(), mCallbacksObj);
+  } else if (first) {
+    env->CallVoidMethod(mCallbacksObj, method_onScanResultBatchPending);
+  }
+  return true;
+}
+
 /**
  * BTA client callbacks
  */
@@ -215,6 +320,12 @@ void btgattc_scan_result_cb(uint16_t event_type, uint8_t addr_type,
   CallbackEnv sCallbackEnv(__func__);
   if (!sCallbackEnv.valid()) return;
 
+  if (batchScanResult(sCallbackEnv, event_type, addr_type, *bda, primary_phy,
+                      secondary_phy, advertising_sid, tx_power, rssi,
+                      periodic_adv_int, adv_data, *original_bda)) {
+    return;
+  }
+
   ScopedLocalRef<jstring> address(sCallbackEnv.get(),
                                   bdaddr2newjstr(sCallbackEnv.get(), bda));
   ScopedLocalRef<jbyteArray> jb(sCallbackEnv.get(),
@@ -286,6 +397,45 @@ void btgattc_notify_cb(int conn_id, const btgatt_notify_params_t& p_data) {
                                jb.get());
 }
 
+/**
+ * Notification batching
+ *
+ * The notifications delivered together by the stack are packed into a pooled
+ * buffer, handed to Java as a single direct ByteBuffer instead of one byte[]
+ * and one call per notification.
+ *
+ * Each notification is packed as, multi-byte values in little endian:
+ *   conn_id (2), address (6), handle (2), is_notify (1), value length (2),
+ *   value
+ */
+// Only accessed on the JNI thread, keeps its allocation between batches
+static std::vector<uint8_t> sNotifyBatchBuffer;
+
+void btgattc_notify_batch_cb(const btgatt_notify_batch_entry_t* entries,
+                             int count) {
+  CallbackEnv sCallbackEnv(__func__);
+  if (!sCallbackEnv.valid()) return;
+
+  sNotifyBatchBuffer.clear();
+  for (int i = 0; i < count; i++) {
+    const btgatt_notify_params_t& params = entries[i].params;
+    append_le16(&sNotifyBatchBuffer, entries[i].conn_id);
+    append_address(&sNotifyBatchBuffer, params.bda);
+    append_le16(&sNotifyBatchBuffer, params.handle);
+    sNotifyBatchBuffer.push_back(params.is_notify);
+    append_le16(&sNotifyBatchBuffer, params.len);
+    sNotifyBatchBuffer.insert(sNotifyBatchBuffer.end(), params.value,
+                              params.value + params.len);
+  }
+
+  ScopedLocalRef<jobject> buffer(
+      sCallbackEnv.get(),
+      sCallbackEnv->NewDirectByteBuffer(sNotifyBatchBuffer.data(),
+                                        sNotifyBatchBuffer.size()));
+  sCallbackEnv->CallVoidMethod(mCallbacksObj, method_onNotifyBatch,
+                               buffer.get(), count);
+}
+
 void btgattc_read_characteristic_cb(int conn_id, int status,
                                     btgatt_read_params_t* p_data) {
   CallbackEnv sCallbackEnv(__func__);
@@ -576,6 +726,7 @@ static const btgatt_client_callbacks_t sGattClientCallbacks = {
     btgattc_phy_updated_cb,
     btgattc_conn_updated_cb,
     btgattc_service_changed_cb,
+    btgattc_notify_batch_cb,
 };
 
 /**
@@ -910,6 +1061,13 @@ class JniScanningCallbacks : ScanningCallbacks {
     CallbackEnv sCallbackEnv(__func__);
     if (!sCallbackEnv.valid()) return;
 
+    // The original address is not known here either, see below
+    if (batchScanResult(sCallbackEnv, event_type, addr_type, bda, primary_phy,
+                        secondary_phy, advertising_sid, tx_power, rssi,
+                        periodic_adv_int, adv_data, RawAddress::kEmpty)) {
+      return;
+    }
+
     ScopedLocalRef<jstring> address(sCallbackEnv.get(),
                                     bdaddr2newjstr(sCallbackEnv.get(), &bda));
     ScopedLocalRef<jbyteArray> jb(sCallbackEnv.get(),
@@ -1064,6 +1222,10 @@ static void classInitNative(JNIEnv* env, jclass clazz) {
   method_onScanResult =
       env->GetMethodID(clazz, "onScanResult",
                        "(IILjava/lang/String;IIIIII[BLjava/lang/String;)V");
+  method_onScanResultBatch = env->GetMethodID(clazz, "onScanResultBatch",
+                                              "(Ljava/nio/ByteBuffer;I)V");
+  method_onScanResultBatchPending =
+      env->GetMethodID(clazz, "onScanResultBatchPending", "()V");
   method_onConnected =
       env->GetMethodID(clazz, "onConnected", "(IIILjava/lang/String;)V");
   method_onDisconnected =
@@ -1082,6 +1244,8 @@ static void classInitNative(JNIEnv* env, jclass clazz) {
       env->GetMethodID(clazz, "onWriteDescriptor", "(III[B)V");
   method_onNotify =
       env->GetMethodID(clazz, "onNotify", "(ILjava/lang/String;IZ[B)V");
+  method_onNotifyBatch = env->GetMethodID(clazz, "onNotifyBatch",
+                                          "(Ljava/nio/ByteBuffer;I)V");
   method_onRegisterForNotifications =
       env->GetMethodID(clazz, "onRegisterForNotifications", "(IIII)V");
   method_onReadRemoteRssi =
@@ -1212,6 +1376,13 @@ static void initializeNative(JNIEnv* env, jobject object) {
 static void cleanupNative(JNIEnv* env, jobject object) {
   if (!btIf) return;
 
+  {
+    std::lock_guard<std::mutex> lock(sScanResultBatch.mutex);
+    sScanResultBatch.max_bytes = 0;
+    sScanResultBatch.pending.clear();
+    sScanResultBatch.pending_count = 0;
+  }
+
   if (sGattIf != NULL) {
     sGattIf->cleanup();
     sGattIf = NULL;
@@ -1228,6 +1399,20 @@ static void cleanupNative(JNIEnv* env, jobject object) {
  * Native Client functions
  */
 
+static void gattClientSetScanResultBatchingNative(JNIEnv* env, jobject object,
+                                                  jint max_bytes) {
+  {
+    std::lock_guard<std::mutex> lock(sScanResultBatch.mutex);
+    sScanResultBatch.max_bytes = max_bytes > 0 ? max_bytes : 0;
+  }
+  // The results batched so far are not left behind when disabling
+  if (max_bytes <= 0) dispatchScanResultBatch(env, object);
+}
+
+static void gattClientFlushScanResultsNative(JNIEnv* env, jobject object) {
+  dispatchScanResultBatch(env, object);
+}
+
 static int gattClientGetDeviceTypeNative(JNIEnv* env, jobject object,
                                          jstring address) {
   if (!sGattIf) return 0;
@@ -2449,6 +2634,10 @@ static JNINativeMethod sMethods[] = {
     {"classInitNative", "()V", (void*)classInitNative},
     {"initializeNative", "()V", (void*)initializeNative},
     {"cleanupNative", "()V", (void*)cleanupNative},
+    {"gattClientSetScanResultBatchingNative", "(I)V",
+     (void*)gattClientSetScanResultBatchingNative},
+    {"gattClientFlushScanResultsNative", "()V",
+     (void*)gattClientFlushScanResultsNative},
     {"gattClientGetDeviceTypeNative", "(Ljava/lang/String;)I",
      (void*)gattClientGetDeviceTypeNative},
     {"gattClientRegisterAppNative", "(JJZ)V",
@@ -92,6 +92,7 @@ public final class Utils {
     private static final long DEFAULT_TEMP_ALLOW_LIST_DURATION_MS = 20_000;
 
     static final int BD_ADDR_LEN = 6; // bytes
+    private static final char[] HEX_DIGITS = "0123456789ABCDEF".toCharArray();
     static final int BD_UUID_LEN = 16; // bytes
 
     /*
@@ -135,8 +136,16 @@ public final class Utils {
             return null;
         }
 
-        return String.format("%02X:%02X:%02X:%02X:%02X:%02X", address[0], address[1], address[2],
-                address[3], address[4], address[5]);
+        // Called for every scan result, so this does not go through String.format()
+        char[] chars = new char[BD_ADDR_LEN * 3 - 1];
+        for (int i = 0; i < BD_ADDR_LEN; i++) {
+            if (i > 0) {
+                chars[i * 3 - 1] = ':';
+            }
+            chars[i * 3] = HEX_DIGITS[(address[i] >> 4) & 0xF];
+            chars[i * 3 + 1] = HEX_DIGITS[address[i] & 0xF];
+        }
+        return new String(chars);
     }
 
     public static byte[] getByteAddress(BluetoothDevice device) {
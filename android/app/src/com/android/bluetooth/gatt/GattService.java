@@ -56,6 +56,7 @@ import android.net.MacAddress;
 import android.os.Binder;
 import android.os.Build;
 import android.os.Handler;
+import android.os.HandlerThread;
 import android.os.IBinder;
 import android.os.Message;
 import android.os.ParcelUuid;
@@ -83,6 +84,8 @@ import com.android.modules.utils.SynchronousResultReceiver;
 
 import libcore.util.HexEncoding;
 
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
 import java.util.ArrayDeque;
 import java.util.ArrayList;
 import java.util.Arrays;
@@ -144,6 +147,18 @@ public class GattService extends ProfileService {
      */
     private static final long DEFAULT_REPORT_DELAY_FLOOR = 5000;
 
+    /**
+     * The scan results are delivered by the native stack in batches when the batch interval is
+     * greater than 0: a batch is flushed at the latest this long after its first result, or as
+     * soon as it reaches the max size.
+     */
+    private static final String SCAN_RESULT_BATCH_INTERVAL_PROPERTY =
+            "scan_result_batch_interval_millis";
+    private static final String SCAN_RESULT_BATCH_MAX_BYTES_PROPERTY =
+            "scan_result_batch_max_bytes";
+    private static final long DEFAULT_SCAN_RESULT_BATCH_INTERVAL = 0;
+    private static final int DEFAULT_SCAN_RESULT_BATCH_MAX_BYTES = 16 * 1024;
+
     // onFoundLost related constants
     private static final int ADVT_STATE_ONFOUND = 0;
     private static final int ADVT_STATE_ONLOST = 1;
@@ -272,6 +287,10 @@ public class GattService extends ProfileService {
     private String mExposureNotificationPackage;
     private Handler mTestModeHandler;
     private final Object mTestModeLock = new Object();
+    private long mScanResultBatchInterval;
+    private HandlerThread mScanResultBatchThread;
+    private Handler mScanResultBatchHandler;
+    private final Runnable mFlushScanResultBatch = () -> gattClientFlushScanResultsNative();
 
     public static boolean isEnabled() {
         return BluetoothProperties.isProfileGattEnabled().orElse(true);
@@ -333,6 +352,8 @@ public class GattService extends ProfileService {
         mPeriodicScanManager = new PeriodicScanManager(mAdapterService);
         mPeriodicScanManager.start();
 
+        startScanResultBatching();
+
         setGattService(this);
         return true;
     }
@@ -343,6 +364,7 @@ public class GattService extends ProfileService {
             Log.d(TAG, "stop()");
         }
         setGattService(null);
+        stopScanResultBatching();
         mScannerMap.clear();
         mClientMap.clear();
         mServerMap.clear();
@@ -1777,6 +1799,70 @@ public class GattService extends ProfileService {
                 advertisingSid, txPower, rssi, periodicAdvInt, advData, originalAddress);
     }
 
+    private void startScanResultBatching() {
+        mScanResultBatchInterval = DeviceConfig.getLong(DeviceConfig.NAMESPACE_BLUETOOTH,
+                SCAN_RESULT_BATCH_INTERVAL_PROPERTY, DEFAULT_SCAN_RESULT_BATCH_INTERVAL);
+        if (mScanResultBatchInterval <= 0) {
+            return;
+        }
+        int maxBytes = DeviceConfig.getInt(DeviceConfig.NAMESPACE_BLUETOOTH,
+                SCAN_RESULT_BATCH_MAX_BYTES_PROPERTY, DEFAULT_SCAN_RESULT_BATCH_MAX_BYTES);
+        mScanResultBatchThread = new HandlerThread("BluetoothScanResultBatch");
+        mScanResultBatchThread.start();
+        mScanResultBatchHandler = new Handler(mScanResultBatchThread.getLooper());
+        gattClientSetScanResultBatchingNative(maxBytes);
+    }
+
+    private void stopScanResultBatching() {
+        if (mScanResultBatchThread == null) {
+            return;
+        }
+        // Delivers the pending results
+        gattClientSetScanResultBatchingNative(0);
+        mScanResultBatchHandler.removeCallbacks(mFlushScanResultBatch);
+        mScanResultBatchHandler = null;
+        mScanResultBatchThread.quitSafely();
+        mScanResultBatchThread = null;
+    }
+
+    void onScanResultBatchPending() {
+        Handler handler = mScanResultBatchHandler;
+        if (handler != null && !handler.hasCallbacks(mFlushScanResultBatch)) {
+            handler.postDelayed(mFlushScanResultBatch, mScanResultBatchInterval);
+        }
+    }
+
+    /**
+     * Scan results packed by the native stack, see com_android_bluetooth_gatt.cpp for their
+     * layout. The buffer is only valid during this call.
+     */
+    void onScanResultBatch(ByteBuffer batch, int count) {
+        // When in testing mode, ignore all real-world events
+        if (isTestModeEnabled()) return;
+
+        batch.order(ByteOrder.LITTLE_ENDIAN);
+        byte[] address = new byte[MAC_ADDRESS_LENGTH];
+        byte[] originalAddress = new byte[MAC_ADDRESS_LENGTH];
+        for (int i = 0; i < count; i++) {
+            int eventType = batch.getShort() & 0xFFFF;
+            int addressType = batch.get() & 0xFF;
+            batch.get(address);
+            int primaryPhy = batch.get() & 0xFF;
+            int secondaryPhy = batch.get() & 0xFF;
+            int advertisingSid = batch.get() & 0xFF;
+            int txPower = batch.get();
+            int rssi = batch.get();
+            int periodicAdvInt = batch.getShort() & 0xFFFF;
+            batch.get(originalAddress);
+            byte[] advData = new byte[batch.getShort() & 0xFFFF];
+            batch.get(advData);
+
+            onScanResultInternal(eventType, addressType, Utils.getAddressStringFromByte(address),
+                    primaryPhy, secondaryPhy, advertisingSid, txPower, rssi, periodicAdvInt,
+                    advData, Utils.getAddressStringFromByte(originalAddress));
+        }
+    }
+
     void onScanResultInternal(int eventType, int addressType, String address, int primaryPhy,
             int secondaryPhy, int advertisingSid, int txPower, int rssi, int periodicAdvInt,
             byte[] advData, String originalAddress) {
@@ -2348,6 +2434,30 @@ public class GattService extends ProfileService {
         }
     }
 
+    /**
+     * Notifications packed by the native stack, see com_android_bluetooth_gatt.cpp for their
+     * layout. The buffer is only valid during this call.
+     */
+    void onNotifyBatch(ByteBuffer batch, int count) {
+        batch.order(ByteOrder.LITTLE_ENDIAN);
+        byte[] address = new byte[MAC_ADDRESS_LENGTH];
+        for (int i = 0; i < count; i++) {
+            int connId = batch.getShort() & 0xFFFF;
+            batch.get(address);
+            int handle = batch.getShort() & 0xFFFF;
+            boolean isNotify = batch.get() != 0;
+            byte[] data = new byte[batch.getShort() & 0xFFFF];
+            batch.get(data);
+            // A failing client does not keep the others from their notifications
+            try {
+                onNotify(connId, Utils.getAddressStringFromByte(address), handle, isNotify,
+                        data);
+            } catch (RemoteException | SecurityException e) {
+                Log.e(TAG, "onNotifyBatch() - connId=" + connId + ", handle=" + handle, e);
+            }
+        }
+    }
+
     void onReadCharacteristic(int connId, int status, int handle, byte[] data)
             throws RemoteException {
         String address = mClientMap.addressByConnId(connId);
@@ -4746,6 +4856,10 @@ public class GattService extends ProfileService {
 
     private native void cleanupNative();
 
+    private native void gattClientSetScanResultBatchingNative(int maxBytes);
+
+    private native void gattClientFlushScanResultsNative();
+
     private native int gattClientGetDeviceTypeNative(String address);
 
     private native void gattClientRegisterAppNative(long appUuidLsb, long appUuidMsb, boolean eatt_support);
@@ -38,6 +38,10 @@
 #define A2DP_AUDIO_HARDWARE_INTERFACE "audio.a2dp"
 #define A2DP_CTRL_PATH "/data/misc/bluedroid/.a2dp_ctrl"
 #define A2DP_DATA_PATH "/data/misc/bluedroid/.a2dp_data"
+// Shared memory ring carrying the audio data when enabled by the stack, see
+// udrv/include/uipc_shm.h. The data socket is still connected to signal the
+// lifetime of the audio path.
+#define A2DP_DATA_SHM_RING_PATH "/data/misc/bluedroid/.a2dp_data.shm"
 
 // AUDIO_STREAM_OUTPUT_BUFFER_SZ controls the size of the audio socket buffer.
 // If one assumes the write buffer is always full during normal BT playback,
@@ -30,12 +30,14 @@
 #include <fcntl.h>
 #include <inttypes.h>
 #include <log/log.h>
+#include <poll.h>
 #include <stdint.h>
 #include <sys/errno.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/time.h>
 #include <sys/un.h>
+#include <time.h>
 #include <unistd.h>
 
 #include <mutex>
@@ -49,6 +51,7 @@
 #include "osi/include/socket_utils/sockets.h"
 
 #include "audio_a2dp_hw.h"
+#include "udrv/include/uipc_shm.h"
 
 /*****************************************************************************
  *  Constants & Macros
@@ -66,10 +69,6 @@
 #define MIN_DELAY_MS 100
 #define MAX_DELAY_MS 1000
 
-// set WRITE_POLL_MS to 0 for blocking sockets, nonzero for polled non-blocking
-// sockets
-#define WRITE_POLL_MS 20
-
 #define FNLOG() ALOGV("%s:%d %s: ", __FILE__, __LINE__, __func__)
 #define DEBUG(fmt, args...) \
   ALOGD("%s:%d %s: " fmt, __FILE__, __LINE__, __func__, ##args)
@@ -125,8 +124,10 @@ struct a2dp_stream_common {
   std::recursive_mutex* mutex;  // See note below on mutex acquisition order.
   int ctrl_fd;
   int audio_fd;
+  tUIPC_SHM_RING* audio_ring;  // Shared memory data path, if provided
   size_t buffer_sz;
   struct a2dp_config cfg;
+  uint64_t pace_deadline_ns;  // End of the audio time emulated on failures
   a2dp_state_t state;
 };
 
@@ -135,6 +136,7 @@ struct a2dp_stream_out {
   struct a2dp_stream_common common;
   uint64_t frames_presented;  // frames written, never reset
   uint64_t frames_rendered;   // frames written, reset on standby
+  struct timespec frames_presented_ts;  // time of the last write
 };
 
 struct a2dp_stream_in {
@@ -240,6 +242,31 @@ static int calc_audiotime_usec(struct a2dp_config cfg, int bytes) {
            cfg.rate);
 }
 
+static uint64_t time_now_ns(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * SEC_TO_NS + now.tv_nsec;
+}
+
+/* Sleeps until the end of the next |us_delay| of audio time. The deadline is
+   absolute so that the time spent between two calls is not added to the
+   delay, it restarts from now when the stream fell behind by more than that
+   (e.g. after a standby). */
+static void pace_audiotime(uint64_t* deadline_ns, int us_delay) {
+  const uint64_t delay_ns = (uint64_t)us_delay * 1000;
+  const uint64_t now_ns = time_now_ns();
+
+  if (*deadline_ns + delay_ns < now_ns) *deadline_ns = now_ns;
+  *deadline_ns += delay_ns;
+
+  struct timespec deadline;
+  deadline.tv_sec = *deadline_ns / SEC_TO_NS;
+  deadline.tv_nsec = *deadline_ns % SEC_TO_NS;
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) ==
+         EINTR) {
+  }
+}
+
 /*****************************************************************************
  *
  *   bluedroid stack adaptation
@@ -309,16 +336,11 @@ static int skt_write(int fd, const void* p, size_t len) {
 
   ts_log("skt_write", len, NULL);
 
-  if (WRITE_POLL_MS == 0) {
-    // do not poll, use blocking send
-    OSI_NO_INTR(sent = send(fd, p, len, MSG_NOSIGNAL));
-    if (sent == -1) ERROR("write failed with error(%s)", strerror(errno));
-
-    return (int)sent;
-  }
-
-  // use non-blocking send, poll
-  int ms_timeout = SOCK_SEND_TIMEOUT_MS;
+  // Non-blocking sends, waiting in poll() for the stack to drain the socket
+  // until the send deadline. A disconnection of the socket while waiting
+  // wakes up poll() and fails the next send.
+  const uint64_t deadline_ns =
+      time_now_ns() + (uint64_t)SOCK_SEND_TIMEOUT_MS * MS_TO_NS;
   size_t count = 0;
   while (count < len) {
     OSI_NO_INTR(sent = send(fd, p, len - count, MSG_NOSIGNAL | MSG_DONTWAIT));
@@ -327,13 +349,23 @@ static int skt_write(int fd, const void* p, size_t len) {
         ERROR("write failed with error(%s)", strerror(errno));
         return -1;
       }
-      if (ms_timeout >= WRITE_POLL_MS) {
-        usleep(WRITE_POLL_MS * 1000);
-        ms_timeout -= WRITE_POLL_MS;
-        continue;
+      const uint64_t now_ns = time_now_ns();
+      if (now_ns >= deadline_ns) {
+        WARN("write timeout exceeded, sent %zu bytes", count);
+        return -1;
       }
-      WARN("write timeout exceeded, sent %zu bytes", count);
-      return -1;
+      struct pollfd pfd;
+      pfd.fd = fd;
+      pfd.events = POLLOUT;
+      pfd.revents = 0;
+      const int timeout_ms = (deadline_ns - now_ns + MS_TO_NS - 1) / MS_TO_NS;
+      int ret;
+      OSI_NO_INTR(ret = poll(&pfd, 1, timeout_ms));
+      if (ret == -1) {
+        ERROR("poll failed with error(%s)", strerror(errno));
+        return -1;
+      }
+      continue;
     }
     count += sent;
     p = (const uint8_t*)p + sent;
@@ -351,6 +383,50 @@ static int skt_disconnect(int fd) {
   return 0;
 }
 
+/*****************************************************************************
+ *
+ *  AUDIO DATA RING
+ *
+ ****************************************************************************/
+
+// Attach to the shared memory ring of the stack if it provides one, in which
+// case the audio data is written to the ring instead of the data socket.
+// The mapping is kept when detaching as a write may still be accessing it:
+// it is only replaced once the stack closed the ring.
+static void audio_ring_connect(struct a2dp_stream_common* common) {
+  if (common->audio_ring != NULL &&
+      !UIPC_ShmRingIsPeerAttached(common->audio_ring)) {
+    UIPC_ShmRingFree(common->audio_ring);
+    common->audio_ring = NULL;
+  }
+
+  if (common->audio_ring == NULL) {
+    common->audio_ring = UIPC_ShmRingMap(A2DP_DATA_SHM_RING_PATH);
+    if (common->audio_ring == NULL) return;
+  }
+
+  UIPC_ShmRingAttach(common->audio_ring);
+  INFO("audio data path using shared memory ring");
+}
+
+static void audio_ring_disconnect(struct a2dp_stream_common* common) {
+  if (common->audio_ring != NULL) UIPC_ShmRingDetach(common->audio_ring);
+}
+
+static int audio_ring_write(tUIPC_SHM_RING* ring, const void* p, size_t len) {
+  FNLOG();
+
+  ts_log("audio_ring_write", len, NULL);
+
+  uint32_t sent = UIPC_ShmRingWrite(ring, (const uint8_t*)p, len,
+                                    SOCK_SEND_TIMEOUT_MS);
+  if (sent < len) {
+    WARN("write timeout exceeded, sent %u bytes", sent);
+    return -1;
+  }
+  return (int)sent;
+}
+
 /*****************************************************************************
  *
  *  AUDIO CONTROL PATH
@@ -826,6 +902,7 @@ static void a2dp_stream_common_init(struct a2dp_stream_common* common) {
 
   common->ctrl_fd = AUDIO_SKT_DISCONNECTED;
   common->audio_fd = AUDIO_SKT_DISCONNECTED;
+  common->audio_ring = NULL;
   common->state = AUDIO_A2DP_STATE_STOPPED;
 
   /* manages max capacity of socket pipe */
@@ -835,6 +912,9 @@ static void a2dp_stream_common_init(struct a2dp_stream_common* common) {
 static void a2dp_stream_common_destroy(struct a2dp_stream_common* common) {
   FNLOG();
 
+  UIPC_ShmRingFree(common->audio_ring);
+  common->audio_ring = NULL;
+
   delete common->mutex;
   common->mutex = NULL;
 }
@@ -892,6 +972,7 @@ static int stop_audio_datapath(struct a2dp_stream_common* common) {
   common->state = (a2dp_state_t)AUDIO_A2DP_STATE_STOPPED;
 
   /* disconnect audio path */
+  audio_ring_disconnect(common);
   skt_disconnect(common->audio_fd);
   common->audio_fd = AUDIO_SKT_DISCONNECTED;
 
@@ -912,6 +993,7 @@ static int suspend_audio_datapath(struct a2dp_stream_common* common,
     common->state = AUDIO_A2DP_STATE_SUSPENDED;
 
   /* disconnect audio path */
+  audio_ring_disconnect(common);
   skt_disconnect(common->audio_fd);
 
   common->audio_fd = AUDIO_SKT_DISCONNECTED;
@@ -930,6 +1012,7 @@ static ssize_t out_write(struct audio_stream_out* stream, const void* buffer,
   struct a2dp_stream_out* out = (struct a2dp_stream_out*)stream;
   int sent = -1;
   size_t write_bytes = bytes;
+  tUIPC_SHM_RING* ring = NULL;
 
   DEBUG("write %zu bytes (fd %d)", bytes, out->common.audio_fd);
 
@@ -946,6 +1029,7 @@ static ssize_t out_write(struct audio_stream_out* stream, const void* buffer,
     if (start_audio_datapath(&out->common) < 0) {
       goto finish;
     }
+    audio_ring_connect(&out->common);
   } else if (out->common.state != AUDIO_A2DP_STATE_STARTED) {
     ERROR("stream not in stopped or standby");
     goto finish;
@@ -964,11 +1048,19 @@ static ssize_t out_write(struct audio_stream_out* stream, const void* buffer,
           out->common.audio_fd);
   }
 
+  if (out->common.audio_ring != NULL &&
+      UIPC_ShmRingIsConnected(out->common.audio_ring))
+    ring = out->common.audio_ring;
+
   lock.unlock();
-  sent = skt_write(out->common.audio_fd, buffer, write_bytes);
+  if (ring != NULL)
+    sent = audio_ring_write(ring, buffer, write_bytes);
+  else
+    sent = skt_write(out->common.audio_fd, buffer, write_bytes);
   lock.lock();
 
   if (sent == -1) {
+    audio_ring_disconnect(&out->common);
     skt_disconnect(out->common.audio_fd);
     out->common.audio_fd = AUDIO_SKT_DISCONNECTED;
     if ((out->common.state != AUDIO_A2DP_STATE_SUSPENDED) &&
@@ -984,13 +1076,15 @@ finish:;
   const size_t frames = bytes / audio_stream_out_frame_size(stream);
   out->frames_rendered += frames;
   out->frames_presented += frames;
-  lock.unlock();
+  clock_gettime(CLOCK_MONOTONIC, &out->frames_presented_ts);
 
   // If send didn't work out, sleep to emulate write delay.
   if (sent == -1) {
     const int us_delay = calc_audiotime_usec(out->common.cfg, bytes);
+    uint64_t* deadline_ns = &out->common.pace_deadline_ns;
+    lock.unlock();
     DEBUG("emulate a2dp write delay (%d us)", us_delay);
-    usleep(us_delay);
+    pace_audiotime(deadline_ns, us_delay);
   }
   return bytes;
 }
@@ -1372,7 +1466,7 @@ static int out_get_presentation_position(const struct audio_stream_out* stream,
       *frames = bytes / audio_stream_out_frame_size(stream);
 
       timestamp->tv_nsec += delay_ns;
-      if (timestamp->tv_nsec > 1 * SEC_TO_NS) {
+      if (timestamp->tv_nsec >= 1 * SEC_TO_NS) {
         timestamp->tv_sec++;
         timestamp->tv_nsec -= SEC_TO_NS;
       }
@@ -1383,7 +1477,9 @@ static int out_get_presentation_position(const struct audio_stream_out* stream,
   uint64_t latency_frames =
       (uint64_t)out_get_latency(stream) * out->common.cfg.rate / 1000;
   if (out->frames_presented >= latency_frames) {
-    clock_gettime(CLOCK_MONOTONIC, timestamp);
+    // Position at the time of the last write rather than of this call, the
+    // frames presented since are accounted by the extrapolation of the caller
+    *timestamp = out->frames_presented_ts;
     *frames = out->frames_presented - latency_frames;
     return 0;
   }
@@ -1555,7 +1651,7 @@ error:
   us_delay = calc_audiotime_usec(in->common.cfg, bytes);
   DEBUG("emulate a2dp read delay (%d us)", us_delay);
 
-  usleep(us_delay);
+  pace_audiotime(&in->common.pace_deadline_ns, us_delay);
   return bytes;
 }
 
@@ -36,6 +36,12 @@
 
 #define A2DP_DATA_READ_POLL_MS 10
 #define A2DP_HOST_DATA_PATH "/var/run/bluetooth/audio/.a2dp_data"
+// Shared memory ring carrying the audio data instead of the socket when the
+// property below is set, see udrv/include/uipc_shm.h for its layout.
+#define A2DP_HOST_DATA_SHM_RING_PATH "/var/run/bluetooth/audio/.a2dp_data.shm"
+#define A2DP_HOST_DATA_SHM_RING_PROPERTY "persist.bluetooth.a2dp.uipc_shm_ring"
+#define A2DP_HOST_DATA_SHM_RING_SIZE (28 * 512)
+#define A2DP_HOST_DATA_RX_BATCH_SIZE (28 * 512)
 // TODO(b/198260375): Make A2DP data owner group configurable.
 #define A2DP_HOST_DATA_GROUP "bluetooth-audio"
 
@@ -58,6 +64,9 @@ static void btif_a2dp_data_cb([[maybe_unused]] tUIPC_CH_ID ch_id,
                  UIPC_REG_REMOVE_ACTIVE_READSET, NULL);
       UIPC_Ioctl(*a2dp_uipc, UIPC_CH_ID_AV_AUDIO, UIPC_SET_READ_POLL_TMO,
                  reinterpret_cast<void*>(A2DP_DATA_READ_POLL_MS));
+      /* The encoder reads one frame at a time: drain the socket once */
+      UIPC_Ioctl(*a2dp_uipc, UIPC_CH_ID_AV_AUDIO, UIPC_SET_RX_BATCH_SIZE,
+                 reinterpret_cast<void*>(A2DP_HOST_DATA_RX_BATCH_SIZE));
 
       // Will start audio on btif_a2dp_on_started
 
@@ -87,19 +96,30 @@ static void btif_a2dp_data_cb([[maybe_unused]] tUIPC_CH_ID ch_id,
 // in this group therefore have access to A2DP socket. Otherwise audio
 // server should be in the same group that BT stack runs with to access
 // A2DP socket.
-static void a2dp_data_path_open() {
-  UIPC_Open(*a2dp_uipc, UIPC_CH_ID_AV_AUDIO, btif_a2dp_data_cb,
-            A2DP_HOST_DATA_PATH);
+static void a2dp_data_path_set_group(const char* path) {
   struct group* grp = getgrnam(A2DP_HOST_DATA_GROUP);
-  chmod(A2DP_HOST_DATA_PATH, 0770);
+  chmod(path, 0770);
   if (grp) {
-    int res = chown(A2DP_HOST_DATA_PATH, -1, grp->gr_gid);
+    int res = chown(path, -1, grp->gr_gid);
     if (res == -1) {
       LOG(ERROR) << __func__ << " failed: " << strerror(errno);
     }
   }
 }
 
+static void a2dp_data_path_open() {
+  UIPC_Open(*a2dp_uipc, UIPC_CH_ID_AV_AUDIO, btif_a2dp_data_cb,
+            A2DP_HOST_DATA_PATH);
+  a2dp_data_path_set_group(A2DP_HOST_DATA_PATH);
+
+  if (osi_property_get_bool(A2DP_HOST_DATA_SHM_RING_PROPERTY, false) &&
+      UIPC_OpenShmRing(*a2dp_uipc, UIPC_CH_ID_AV_AUDIO,
+                       A2DP_HOST_DATA_SHM_RING_PATH,
+                       A2DP_HOST_DATA_SHM_RING_SIZE)) {
+    a2dp_data_path_set_group(A2DP_HOST_DATA_SHM_RING_PATH);
+  }
+}
+
 tA2DP_CTRL_CMD a2dp_pending_cmd_ = A2DP_CTRL_CMD_NONE;
 uint64_t total_bytes_read_;
 timespec data_position_;
@@ -20,6 +20,9 @@
 
 #include <android/binder_manager.h>
 
+#include <algorithm>
+#include <thread>
+
 namespace bluetooth {
 namespace audio {
 namespace aidl {
@@ -298,6 +301,12 @@ int BluetoothAudioClientInterface::StartSession() {
 
   if (data_mq && data_mq->isValid()) {
     data_mq_ = std::move(data_mq);
+    if (data_mq_->getEventFlagWord() != nullptr &&
+        EventFlag::createEventFlag(data_mq_->getEventFlagWord(),
+                                   &data_mq_event_flag_) != ::android::OK) {
+      LOG(WARNING) << __func__ << ": unable to use the data queue event flag";
+      data_mq_event_flag_ = nullptr;
+    }
   } else if (transport_->GetSessionType() ==
                  SessionType::A2DP_HARDWARE_OFFLOAD_ENCODING_DATAPATH ||
              transport_->GetSessionType() ==
@@ -379,6 +388,9 @@ int BluetoothAudioClientInterface::EndSession() {
     LOG(ERROR) << __func__ << ": BluetoothAudioHal nullptr";
     return -EINVAL;
   }
+  if (data_mq_event_flag_ != nullptr) {
+    EventFlag::deleteEventFlag(&data_mq_event_flag_);
+  }
   data_mq_ = nullptr;
 
   auto aidl_retval = provider_->endSession();
@@ -405,64 +417,92 @@ void BluetoothAudioClientInterface::FlushAudioData() {
     LOG(WARNING) << __func__ << ", data_mq_ invalid";
     return;
   }
+  // Discard the data in place rather than reading it out
   size_t size = data_mq_->availableToRead();
-  std::vector<MqDataType> buffer(size);
-
-  if (data_mq_->read(buffer.data(), size) != size) {
+  DataMQ::MemTransaction tx;
+  if (size != 0 && (!data_mq_->beginRead(size, &tx) ||
+                    !data_mq_->commitRead(size))) {
     LOG(WARNING) << __func__ << ", failed to flush data queue!";
   }
 }
 
+void BluetoothAudioClientInterface::WaitForDataMqNotification(int timeout_ms) {
+  if (data_mq_event_flag_ == nullptr) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(timeout_ms));
+    return;
+  }
+  // Both notifications wake up the wait: the writer sets NOT_EMPTY and the
+  // reader NOT_FULL, the caller checks the queue again in either case
+  uint32_t ef_state = 0;
+  data_mq_event_flag_->wait(
+      ::android::hardware::details::FMQ_NOT_EMPTY |
+          ::android::hardware::details::FMQ_NOT_FULL,
+      &ef_state,
+      std::chrono::nanoseconds(std::chrono::milliseconds(timeout_ms)).count());
+}
+
 size_t BluetoothAudioSinkClientInterface::ReadAudioData(uint8_t* p_buf,
                                                         uint32_t len) {
+  if (p_buf == nullptr) return 0;
+  return ReadAudioDataInPlace(
+      len, [p_buf](const uint8_t* first, size_t first_len,
+                   const uint8_t* second, size_t second_len) {
+        std::copy(first, first + first_len, p_buf);
+        std::copy(second, second + second_len, p_buf + first_len);
+      });
+}
+
+size_t BluetoothAudioSinkClientInterface::WaitForAudioDataLocked(
+    uint32_t len, int timeout_ms) {
+  size_t avail_to_read = data_mq_->availableToRead();
+  while (avail_to_read < len && timeout_ms >= kDefaultDataReadPollIntervalMs) {
+    WaitForDataMqNotification(kDefaultDataReadPollIntervalMs);
+    timeout_ms -= kDefaultDataReadPollIntervalMs;
+    avail_to_read = data_mq_->availableToRead();
+  }
+  return std::min(avail_to_read, static_cast<size_t>(len));
+}
+
+bool BluetoothAudioSinkClientInterface::WaitForAudioData(uint32_t len,
+                                                         int timeout_ms) {
+  if (!IsValid()) return false;
+  std::lock_guard<std::mutex> guard(internal_mutex_);
+  if (data_mq_ == nullptr || !data_mq_->isValid()) return false;
+  return WaitForAudioDataLocked(len, timeout_ms) == len;
+}
+
+size_t BluetoothAudioSinkClientInterface::ReadAudioDataInPlace(
+    uint32_t len, const AudioDataConsumer& consume) {
   if (!IsValid()) {
     LOG(ERROR) << __func__ << ": BluetoothAudioHal is not valid";
     return 0;
   }
-  if (p_buf == nullptr || len == 0) return 0;
+  if (len == 0) return 0;
 
   std::lock_guard<std::mutex> guard(internal_mutex_);
+  if (data_mq_ == nullptr || !data_mq_->isValid()) return 0;
 
-  size_t total_read = 0;
-  int timeout_ms = kDefaultDataReadTimeoutMs;
-  do {
-    if (data_mq_ == nullptr || !data_mq_->isValid()) break;
-
-    size_t avail_to_read = data_mq_->availableToRead();
-    if (avail_to_read) {
-      if (avail_to_read > len - total_read) {
-        avail_to_read = len - total_read;
-      }
-      if (data_mq_->read((MqDataType*)p_buf + total_read, avail_to_read) == 0) {
-        LOG(WARNING) << __func__ << ": len=" << len
-                     << " total_read=" << total_read << " failed";
-        break;
-      }
-      total_read += avail_to_read;
-    } else if (timeout_ms >= kDefaultDataReadPollIntervalMs) {
-      std::this_thread::sleep_for(
-          std::chrono::milliseconds(kDefaultDataReadPollIntervalMs));
-      timeout_ms -= kDefaultDataReadPollIntervalMs;
-      continue;
-    } else {
-      LOG(WARNING) << __func__ << ": " << (len - total_read) << "/" << len
-                   << " no data " << (kDefaultDataReadTimeoutMs - timeout_ms)
-                   << " ms";
-      break;
-    }
-  } while (total_read < len);
+  size_t size = WaitForAudioDataLocked(len, kDefaultDataReadTimeoutMs);
+  if (size < len) {
+    LOG(WARNING) << __func__ << ": " << (len - size) << "/" << len
+                 << " no data " << kDefaultDataReadTimeoutMs << " ms";
+  }
+  DataMQ::MemTransaction tx;
+  if (size == 0 || !data_mq_->beginRead(size, &tx)) return 0;
 
-  if (timeout_ms <
-          (kDefaultDataReadTimeoutMs - kDefaultDataReadPollIntervalMs) &&
-      timeout_ms >= kDefaultDataReadPollIntervalMs) {
-    VLOG(1) << __func__ << ": underflow " << len << " -> " << total_read
-            << " read " << (kDefaultDataReadTimeoutMs - timeout_ms) << " ms";
-  } else {
-    VLOG(2) << __func__ << ": " << len << " -> " << total_read << " read";
+  const auto& first = tx.getFirstRegion();
+  const auto& second = tx.getSecondRegion();
+  consume(reinterpret_cast<const uint8_t*>(first.getAddress()),
+          first.getLength(),
+          reinterpret_cast<const uint8_t*>(second.getAddress()),
+          second.getLength());
+  if (!data_mq_->commitRead(size)) {
+    LOG(WARNING) << __func__ << ": len=" << len << " size=" << size
+                 << " commit failed";
   }
 
-  sink_->LogBytesRead(total_read);
-  return total_read;
+  sink_->LogBytesRead(size);
+  return size;
 }
 
 void BluetoothAudioClientInterface::RenewAudioProviderAndSession() {
@@ -17,9 +17,11 @@
 #pragma once
 
 #include <fmq/AidlMessageQueue.h>
+#include <fmq/EventFlag.h>
 #include <hardware/audio.h>
 
 #include <ctime>
+#include <functional>
 #include <mutex>
 #include <vector>
 
@@ -49,6 +51,7 @@ using ::aidl::android::hardware::bluetooth::audio::PcmConfiguration;
 using ::aidl::android::hardware::common::fmq::MQDescriptor;
 using ::aidl::android::hardware::common::fmq::SynchronizedReadWrite;
 using ::android::AidlMessageQueue;
+using ::android::hardware::EventFlag;
 
 using MqDataType = int8_t;
 using MqDataMode = SynchronizedReadWrite;
@@ -95,6 +98,12 @@ class BluetoothAudioClientInterface {
 
  protected:
   mutable std::mutex internal_mutex_;
+  /***
+   * Wait up to |timeout_ms| for the HAL to notify a change of the data queue,
+   * or sleep that long if the queue has no event flag to be notified with
+   ***/
+  void WaitForDataMqNotification(int timeout_ms);
+
   /***
    * Helper function to connect to an IBluetoothAudioProvider
    ***/
@@ -111,6 +120,8 @@ class BluetoothAudioClientInterface {
 
   bool session_started_;
   std::unique_ptr<DataMQ> data_mq_;
+  // Event flag of |data_mq_|, when the HAL configured one
+  EventFlag* data_mq_event_flag_ = nullptr;
 
   ::ndk::ScopedAIBinder_DeathRecipient death_recipient_;
   // static constexpr const char* kDefaultAudioProviderFactoryInterface =
@@ -150,9 +161,34 @@ class BluetoothAudioSinkClientInterface : public BluetoothAudioClientInterface {
    ***/
   size_t ReadAudioData(uint8_t* p_buf, uint32_t len);
 
+  /***
+   * Audio data read in place in the fmq: |second| holds the rest of the data
+   * when it wraps around the end of the queue, and is empty otherwise
+   ***/
+  using AudioDataConsumer =
+      std::function<void(const uint8_t* first, size_t first_len,
+                         const uint8_t* second, size_t second_len)>;
+
+  /***
+   * Read up to |len| bytes of data from audio HAL without copying it out of
+   * the fmq: |consume| is called with the data, which is released once it
+   * returns. Waits for the data as ReadAudioData() does, and returns the
+   * number of bytes consumed.
+   ***/
+  size_t ReadAudioDataInPlace(uint32_t len, const AudioDataConsumer& consume);
+
+  /***
+   * Wait up to |timeout_ms| for |len| bytes of data from audio HAL, returns
+   * true if they are available to read
+   ***/
+  bool WaitForAudioData(uint32_t len, int timeout_ms);
+
  private:
   IBluetoothSinkTransportInstance* sink_;
 
+  // Returns the number of bytes available, up to |len|
+  size_t WaitForAudioDataLocked(uint32_t len, int timeout_ms);
+
   static constexpr int kDefaultDataReadTimeoutMs = 10;
   static constexpr int kDefaultDataReadPollIntervalMs = 1;
 };
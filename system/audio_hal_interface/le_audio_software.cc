@@ -368,6 +368,15 @@ size_t LeAudioClientInterface::Sink::Read(uint8_t* p_buf, uint32_t len) {
   return get_aidl_client_interface(is_broadcaster_)->ReadAudioData(p_buf, len);
 }
 
+bool LeAudioClientInterface::Sink::WaitForData(uint32_t len, int timeout_ms) {
+  if (HalVersionManager::GetHalTransport() ==
+      BluetoothAudioHalTransport::HIDL) {
+    return false;
+  }
+  return get_aidl_client_interface(is_broadcaster_)
+      ->WaitForAudioData(len, timeout_ms);
+}
+
 void LeAudioClientInterface::Source::Cleanup() {
   LOG(INFO) << __func__ << " source";
   StopSession();
@@ -107,6 +107,9 @@ class LeAudioClientInterface {
     void ReconfigurationComplete() override;
     // Read the stream of bytes sinked to us by the upper layers
     size_t Read(uint8_t* p_buf, uint32_t len);
+    // Wait up to |timeout_ms| for |len| bytes to read. Returns false when they
+    // did not come in time, or at once when the HAL transport cannot wait
+    bool WaitForData(uint32_t len, int timeout_ms);
     bool IsBroadcaster() { return is_broadcaster_; }
 
    private:
@@ -54,6 +54,10 @@ size_t LeAudioClientInterface::Sink::Read(uint8_t* p_buf, uint32_t len) {
   return 0;
 }
 
+bool LeAudioClientInterface::Sink::WaitForData(uint32_t len, int timeout_ms) {
+  return false;
+}
+
 LeAudioClientInterface::Source* LeAudioClientInterface::GetSource(
     StreamCallbacks stream_cb,
     bluetooth::common::MessageLoopThread* message_loop) {
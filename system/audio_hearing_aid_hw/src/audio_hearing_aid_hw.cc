@@ -23,12 +23,14 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <inttypes.h>
+#include <poll.h>
 #include <stdint.h>
 #include <sys/errno.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/time.h>
 #include <sys/un.h>
+#include <time.h>
 #include <unistd.h>
 
 #include <mutex>
@@ -52,10 +54,8 @@
 #define USEC_PER_SEC 1000000L
 #define SOCK_SEND_TIMEOUT_MS 2000 /* Timeout for sending */
 #define SOCK_RECV_TIMEOUT_MS 5000 /* Timeout for receiving */
-
-// set WRITE_POLL_MS to 0 for blocking sockets, nonzero for polled non-blocking
-// sockets
-#define WRITE_POLL_MS 20
+#define SEC_TO_NS 1000000000
+#define MS_TO_NS 1000000
 
 #define FNLOG() ALOGV("%s:%d %s: ", __FILE__, __LINE__, __func__)
 #define DEBUG(fmt, args...) \
@@ -136,6 +136,7 @@ struct ha_stream_common {
   int audio_fd;
   size_t buffer_sz;
   struct ha_config cfg;
+  uint64_t pace_deadline_ns;  // End of the audio time emulated on failures
   ha_state_t state;
 };
 
@@ -144,6 +145,7 @@ struct ha_stream_out {
   struct ha_stream_common common;
   uint64_t frames_presented;  // frames written, never reset
   uint64_t frames_rendered;   // frames written, reset on standby
+  struct timespec frames_presented_ts;  // time of the last write
 };
 
 struct ha_stream_in {
@@ -246,6 +248,31 @@ static int calc_audiotime_usec(struct ha_config cfg, int bytes) {
            cfg.rate);
 }
 
+static uint64_t time_now_ns(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * SEC_TO_NS + now.tv_nsec;
+}
+
+/* Sleeps until the end of the next |us_delay| of audio time. The deadline is
+   absolute so that the time spent between two calls is not added to the
+   delay, it restarts from now when the stream fell behind by more than that
+   (e.g. after a standby). */
+static void pace_audiotime(uint64_t* deadline_ns, int us_delay) {
+  const uint64_t delay_ns = (uint64_t)us_delay * 1000;
+  const uint64_t now_ns = time_now_ns();
+
+  if (*deadline_ns + delay_ns < now_ns) *deadline_ns = now_ns;
+  *deadline_ns += delay_ns;
+
+  struct timespec deadline;
+  deadline.tv_sec = *deadline_ns / SEC_TO_NS;
+  deadline.tv_nsec = *deadline_ns % SEC_TO_NS;
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) ==
+         EINTR) {
+  }
+}
+
 /*****************************************************************************
  *
  *   bluedroid stack adaptation
@@ -315,16 +342,11 @@ static int skt_write(int fd, const void* p, size_t len) {
 
   ts_log("skt_write", len, NULL);
 
-  if (WRITE_POLL_MS == 0) {
-    // do not poll, use blocking send
-    OSI_NO_INTR(sent = send(fd, p, len, MSG_NOSIGNAL));
-    if (sent == -1) ERROR("write failed with error(%s)", strerror(errno));
-
-    return (int)sent;
-  }
-
-  // use non-blocking send, poll
-  int ms_timeout = SOCK_SEND_TIMEOUT_MS;
+  // Non-blocking sends, waiting in poll() for the stack to drain the socket
+  // until the send deadline. A disconnection of the socket while waiting
+  // wakes up poll() and fails the next send.
+  const uint64_t deadline_ns =
+      time_now_ns() + (uint64_t)SOCK_SEND_TIMEOUT_MS * MS_TO_NS;
   size_t count = 0;
   while (count < len) {
     OSI_NO_INTR(sent = send(fd, p, len - count, MSG_NOSIGNAL | MSG_DONTWAIT));
@@ -333,13 +355,23 @@ static int skt_write(int fd, const void* p, size_t len) {
         ERROR("write failed with error(%s)", strerror(errno));
         return -1;
       }
-      if (ms_timeout >= WRITE_POLL_MS) {
-        usleep(WRITE_POLL_MS * 1000);
-        ms_timeout -= WRITE_POLL_MS;
-        continue;
+      const uint64_t now_ns = time_now_ns();
+      if (now_ns >= deadline_ns) {
+        WARN("write timeout exceeded, sent %zu bytes", count);
+        return -1;
       }
-      WARN("write timeout exceeded, sent %zu bytes", count);
-      return -1;
+      struct pollfd pfd;
+      pfd.fd = fd;
+      pfd.events = POLLOUT;
+      pfd.revents = 0;
+      const int timeout_ms = (deadline_ns - now_ns + MS_TO_NS - 1) / MS_TO_NS;
+      int ret;
+      OSI_NO_INTR(ret = poll(&pfd, 1, timeout_ms));
+      if (ret == -1) {
+        ERROR("poll failed with error(%s)", strerror(errno));
+        return -1;
+      }
+      continue;
     }
     count += sent;
     p = (const uint8_t*)p + sent;
@@ -961,13 +993,15 @@ finish:;
   const size_t frames = bytes / audio_stream_out_frame_size(stream);
   out->frames_rendered += frames;
   out->frames_presented += frames;
-  lock.unlock();
+  clock_gettime(CLOCK_MONOTONIC, &out->frames_presented_ts);
 
   // If send didn't work out, sleep to emulate write delay.
   if (sent == -1) {
     const int us_delay = calc_audiotime_usec(out->common.cfg, bytes);
+    uint64_t* deadline_ns = &out->common.pace_deadline_ns;
+    lock.unlock();
     DEBUG("emulate ha write delay (%d us)", us_delay);
-    usleep(us_delay);
+    pace_audiotime(deadline_ns, us_delay);
   }
   return bytes;
 }
@@ -1347,9 +1381,10 @@ static int out_get_presentation_position(const struct audio_stream_out* stream,
   uint64_t latency_frames =
       (uint64_t)out_get_latency(stream) * out->common.cfg.rate / 1000;
   if (out->frames_presented >= latency_frames) {
+    // Position at the time of the last write rather than of this call, the
+    // frames presented since are accounted by the extrapolation of the caller
     *frames = out->frames_presented - latency_frames;
-    clock_gettime(CLOCK_MONOTONIC,
-                  timestamp);  // could also be associated with out_write().
+    *timestamp = out->frames_presented_ts;
     ret = 0;
   }
   return ret;
@@ -1519,7 +1554,7 @@ error:
   us_delay = calc_audiotime_usec(in->common.cfg, bytes);
   DEBUG("emulate ha read delay (%d us)", us_delay);
 
-  usleep(us_delay);
+  pace_audiotime(&in->common.pace_deadline_ns, us_delay);
   return bytes;
 }
 
@@ -27,6 +27,8 @@ from blueberry.tests.gd.cert.behavior import SingleArgumentBehavior
 from blueberry.tests.gd.cert.behavior import ReplyStage
 from blueberry.tests.gd.cert.event_stream import EventStream, FilteringEventStream
 from blueberry.tests.gd.cert.metadata import metadata
+from blueberry.tests.gd.cert.performance_baseline import find_regressions
+from blueberry.tests.gd.cert.performance_report import make_baseline, summarize
 from blueberry.tests.gd.cert.truth import assertThat
 from bluetooth_packets_python3 import hci_packets
 from bluetooth_packets_python3 import l2cap_packets
@@ -669,6 +671,40 @@ class CertSelfTest(base_test.BaseTestClass):
         t2.start()
         assertThat(wait_until(thing).test_request(lambda obj: obj == "A").times(2)).isFalse()
 
+    def test_performance_regressions(self):
+        baseline = {
+            "throughput": {"value": 1000, "unit": "bytes/s"},
+            "latency": {"value": 10, "unit": "ms"},
+            "mtu": {"value": 672, "unit": "bytes"},
+        }
+        within = {
+            "throughput": {"value": 950, "unit": "bytes/s"},
+            "latency": {"value": 10.5, "unit": "ms"},
+            "mtu": {"value": 100, "unit": "bytes"},
+        }
+        assertThat(find_regressions(baseline, within, tolerance=0.1)).isEqualTo([])
+        worse = {
+            "throughput": {"value": 800, "unit": "bytes/s"},
+            "latency": {"value": 12, "unit": "ms"},
+            "new_metric": {"value": 1, "unit": "ms"},
+        }
+        regressions = find_regressions(baseline, worse, tolerance=0.1)
+        assertThat(len(regressions)).isEqualTo(2)
+        assertThat(regressions[0].startswith("latency")).isTrue()
+        assertThat(regressions[1].startswith("throughput")).isTrue()
+
+    def test_performance_trend_summary(self):
+        records = [{
+            "test": "Test.test_a",
+            "devices": [],
+            "metrics": {
+                "latency": {"value": value, "unit": "ms"}
+            }
+        } for value in [50, 10, 30, 20]]
+        summary = summarize(records, runs=3)
+        assertThat(summary["Test.test_a"]["latency"]["values"]).isEqualTo([10, 30, 20])
+        assertThat(make_baseline(summary)).isEqualTo({"Test.test_a": {"latency": {"value": 20, "unit": "ms"}}})
+
 
 if __name__ == '__main__':
     test_runner.main()
@@ -0,0 +1,118 @@
+#!/usr/bin/env python3
+#
+#   Copyright 2026 - The Android Open Source Project
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+from datetime import datetime
+import json
+import logging
+import os
+
+from mobly import asserts
+
+# Metrics in these units are better when higher, throughputs and rates
+HIGHER_IS_BETTER_UNITS = {"bytes/s", "reports/s"}
+# Metrics in these units are better when lower, durations
+LOWER_IS_BETTER_UNITS = {"ms"}
+
+DEFAULT_TOLERANCE = 0.1
+
+
+def find_regressions(baseline_metrics, metrics, tolerance=DEFAULT_TOLERANCE):
+    """
+    Compare metrics to baseline_metrics, both in the format of PerformanceTestLogger.metrics, and return the
+    descriptions of the metrics that are worse than their baseline by more than the tolerance, a fraction of the
+    baseline. Metrics that are parameters of the test, in other units, are not compared.
+    """
+    regressions = []
+    for name, metric in sorted(metrics.items()):
+        if name not in baseline_metrics:
+            continue
+        unit = metric["unit"]
+        value = metric["value"]
+        baseline = baseline_metrics[name]["value"]
+        if unit in HIGHER_IS_BETTER_UNITS and value < baseline * (1 - tolerance):
+            regressions.append("%s: %g %s, below the baseline of %g %s" % (name, value, unit, baseline, unit))
+        elif unit in LOWER_IS_BETTER_UNITS and value > baseline * (1 + tolerance):
+            regressions.append("%s: %g %s, above the baseline of %g %s" % (name, value, unit, baseline, unit))
+    return regressions
+
+
+def describe_device(device):
+    """
+    What identifies the device and the build under test in the history, the build fingerprint for the real devices
+    """
+    description = {"label": device.label}
+    serial_number = getattr(device, "serial_number", None)
+    if serial_number is None:
+        description["type"] = "host"
+        return description
+    description["serial_number"] = serial_number
+    try:
+        description["build"] = device.adb.getprop("ro.build.fingerprint")
+        description["model"] = device.adb.getprop("ro.product.model")
+    except Exception as error:
+        logging.warning("Cannot read the build of %s: %s" % (serial_number, error))
+    return description
+
+
+class PerformanceBaseline(object):
+    """
+    Checks the metrics of the performance tests against a stored baseline, and keeps their history for the trend
+    reports of performance_report.py.
+
+    The user params of the test config set the files, none being used by default:
+        performance_baseline: JSON file mapping "<test class>.<test name>" to the metrics expected, as written by
+                              performance_report.py --update-baseline
+        performance_history: file the metrics of each test run are appended to, one JSON record per line
+        performance_tolerance: fraction of the baseline a metric may be worse by (default 0.1)
+        performance_fail_on_regression: whether a metric worse than its baseline fails the test (default False)
+    """
+
+    def __init__(self, user_params):
+        self.baseline_path = user_params.get('performance_baseline')
+        self.history_path = user_params.get('performance_history')
+        self.tolerance = float(user_params.get('performance_tolerance', DEFAULT_TOLERANCE))
+        self.fail_on_regression = bool(user_params.get('performance_fail_on_regression', False))
+        self.baseline = {}
+        if self.baseline_path and os.path.isfile(self.baseline_path):
+            with open(self.baseline_path) as baseline_file:
+                self.baseline = json.load(baseline_file)
+
+    def record(self, test, metrics, devices):
+        """
+        Append the metrics of test to the history and return the regressions against its baseline
+        """
+        if not metrics:
+            return []
+        if self.history_path:
+            record = {
+                "test": test,
+                "time": datetime.now().isoformat(),
+                "devices": [describe_device(device) for device in devices],
+                "metrics": metrics,
+            }
+            with open(self.history_path, "a") as history_file:
+                history_file.write(json.dumps(record, sort_keys=True) + "\n")
+        regressions = find_regressions(self.baseline.get(test, {}), metrics, self.tolerance)
+        for regression in regressions:
+            logging.warning("%s regressed, %s" % (test, regression))
+        return regressions
+
+    def check(self, regressions):
+        """
+        Fail the test for the regressions returned by record, if asked to
+        """
+        if self.fail_on_regression and regressions:
+            asserts.fail("Performance regressions: " + "; ".join(regressions))
@@ -0,0 +1,127 @@
+#!/usr/bin/env python3
+#
+#   Copyright 2026 - The Android Open Source Project
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+"""
+Trend reports of the performance cert tests, from the history written by PerformanceBaseline
+
+    python3 -m blueberry.tests.gd.cert.performance_report --history <file> [--baseline <file>] [--runs N]
+        [--build <fingerprint substring>] [--update-baseline]
+
+For each test and metric, prints the values of the last runs, oldest first, their median and the change of the last
+run against the baseline. --update-baseline stores the medians of the last runs as the new baseline.
+"""
+
+import argparse
+import json
+import os
+import statistics
+
+from blueberry.tests.gd.cert.performance_baseline import find_regressions
+from blueberry.tests.gd.cert.performance_baseline import DEFAULT_TOLERANCE
+
+DEFAULT_RUNS = 10
+
+
+def read_history(path, build=None):
+    """
+    Return the records of the history, oldest first, keeping those run on a device build containing build if given
+    """
+    records = []
+    with open(path) as history_file:
+        for line in history_file:
+            if not line.strip():
+                continue
+            record = json.loads(line)
+            if build is not None and not any(build in device.get("build", "") for device in record["devices"]):
+                continue
+            records.append(record)
+    return records
+
+
+def summarize(records, runs=DEFAULT_RUNS):
+    """
+    Return {test: {metric: {"values": [...], "median": ..., "unit": ...}}} over the last runs of each test
+    """
+    values = {}
+    for record in records:
+        for name, metric in record["metrics"].items():
+            entry = values.setdefault(record["test"], {}).setdefault(name, {"values": [], "unit": metric["unit"]})
+            entry["values"].append(metric["value"])
+    for metrics in values.values():
+        for entry in metrics.values():
+            entry["values"] = entry["values"][-runs:]
+            entry["median"] = statistics.median(entry["values"])
+    return values
+
+
+def format_report(summary, baseline, tolerance=DEFAULT_TOLERANCE):
+    lines = []
+    for test in sorted(summary):
+        lines.append(test)
+        metrics = summary[test]
+        last = {name: {"value": entry["values"][-1], "unit": entry["unit"]} for name, entry in metrics.items()}
+        regressions = find_regressions(baseline.get(test, {}), last, tolerance)
+        regressed = {regression.split(":")[0] for regression in regressions}
+        for name in sorted(metrics):
+            entry = metrics[name]
+            values = " ".join("%g" % value for value in entry["values"])
+            line = "  %s (%s): %s, median %g" % (name, entry["unit"], values, entry["median"])
+            baseline_metric = baseline.get(test, {}).get(name)
+            if baseline_metric is not None and baseline_metric["value"]:
+                change = (entry["values"][-1] - baseline_metric["value"]) / baseline_metric["value"]
+                line += ", %+.1f%% against the baseline" % (change * 100)
+            if name in regressed:
+                line += ", REGRESSED"
+            lines.append(line)
+    return "\n".join(lines)
+
+
+def make_baseline(summary):
+    return {
+        test: {name: {
+            "value": entry["median"],
+            "unit": entry["unit"]
+        } for name, entry in metrics.items()} for test, metrics in summary.items()
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Trend report of the performance cert tests")
+    parser.add_argument("--history", required=True, help="history written by the tests")
+    parser.add_argument("--baseline", help="baseline to compare the last runs to")
+    parser.add_argument("--runs", type=int, default=DEFAULT_RUNS, help="number of runs to report for each test")
+    parser.add_argument("--build", help="only report the runs on the device builds containing this")
+    parser.add_argument("--tolerance", type=float, default=DEFAULT_TOLERANCE)
+    parser.add_argument(
+        "--update-baseline", action="store_true", help="store the medians of the runs reported as the baseline")
+    args = parser.parse_args()
+
+    summary = summarize(read_history(args.history, args.build), args.runs)
+    baseline = {}
+    if args.baseline and os.path.isfile(args.baseline):
+        with open(args.baseline) as baseline_file:
+            baseline = json.load(baseline_file)
+    print(format_report(summary, baseline, args.tolerance))
+
+    if args.update_baseline:
+        if not args.baseline:
+            parser.error("--update-baseline needs --baseline")
+        baseline.update(make_baseline(summary))
+        with open(args.baseline, "w") as baseline_file:
+            json.dump(baseline, baseline_file, indent=2, sort_keys=True)
+
+
+if __name__ == '__main__':
+    main()
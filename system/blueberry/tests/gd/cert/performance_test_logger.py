@@ -15,6 +15,7 @@
 #   limitations under the License.
 
 from datetime import datetime
+import json
 
 
 class PerformanceTestLogger(object):
@@ -28,6 +29,7 @@ class PerformanceTestLogger(object):
         self.start_interval_points = {}
         self.end_interval_points = {}
         self.single_points = {}
+        self.metrics = {}
 
     def log_single_point(self, label=""):
         if label not in self.single_points:
@@ -69,3 +71,16 @@ class PerformanceTestLogger(object):
             self._check_interval_label(label)
             yield ((label, self.start_interval_points[label][i], self.end_interval_points[label][i])
                    for i in range(len(self.start_interval_points[label])))
+
+    def add_metric(self, name, value, unit=""):
+        """
+        Record a result of the test under name
+        """
+        self.metrics[name] = {"value": value, "unit": unit}
+
+    def dump_metrics(self, path):
+        """
+        Write the metrics recorded to path as JSON, for the regression checks to read
+        """
+        with open(path, "w") as metrics_file:
+            json.dump(self.metrics, metrics_file, indent=2, sort_keys=True)
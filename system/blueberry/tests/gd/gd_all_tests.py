@@ -19,6 +19,7 @@ from blueberry.tests.gd.hal.simple_hal_test import SimpleHalTest
 from blueberry.tests.gd.hci.acl_manager_test import AclManagerTest
 from blueberry.tests.gd.hci.controller_test import ControllerTest
 from blueberry.tests.gd.hci.direct_hci_test import DirectHciTest
+from blueberry.tests.gd.hci.hci_performance_test import HciPerformanceTest
 from blueberry.tests.gd.hci.le_acl_manager_test import LeAclManagerTest
 from blueberry.tests.gd.hci.le_advertising_manager_test import LeAdvertisingManagerTest
 from blueberry.tests.gd.hci.le_scanning_manager_test import LeScanningManagerTest
@@ -27,6 +28,7 @@ from blueberry.tests.gd.iso.le_iso_test import LeIsoTest
 from blueberry.tests.gd.l2cap.classic.l2cap_performance_test import L2capPerformanceTest
 from blueberry.tests.gd.l2cap.classic.l2cap_test import L2capTest
 from blueberry.tests.gd.l2cap.le.dual_l2cap_test import DualL2capTest
+from blueberry.tests.gd.l2cap.le.le_l2cap_performance_test import LeL2capPerformanceTest
 from blueberry.tests.gd.l2cap.le.le_l2cap_test import LeL2capTest
 from blueberry.tests.gd.neighbor.neighbor_test import NeighborTest
 from blueberry.tests.gd.security.le_security_test import LeSecurityTest
@@ -37,9 +39,10 @@ from blueberry.tests.gd.shim.stack_test import StackTest
 from mobly import suite_runner
 
 ALL_TESTS = {
-    CertSelfTest, SimpleHalTest, AclManagerTest, ControllerTest, DirectHciTest, LeAclManagerTest,
+    CertSelfTest, SimpleHalTest, AclManagerTest, ControllerTest, DirectHciTest, HciPerformanceTest, LeAclManagerTest,
     LeAdvertisingManagerTest, LeScanningManagerTest, LeScanningWithSecurityTest, LeIsoTest, L2capPerformanceTest,
-    L2capTest, DualL2capTest, LeL2capTest, NeighborTest, LeSecurityTest, SecurityTest, ShimTest, StackTest
+    L2capTest, DualL2capTest, LeL2capPerformanceTest, LeL2capTest, NeighborTest, LeSecurityTest, SecurityTest, ShimTest,
+    StackTest
 }
 
 DISABLED_TESTS = set()
@@ -33,7 +33,14 @@ from blueberry.tests.gd.security.le_security_test import LeSecurityTest
 # TODO(b/194723246): Investigate failures to re-activate the test class.
 from blueberry.tests.gd.security.security_test import SecurityTest
 
-DISABLED_TESTS = {LeScanningManagerTest, L2capTest, LeL2capTest, LeSecurityTest, SecurityTest}
+# Benchmarks, their results are checked apart from the presubmit.
+from blueberry.tests.gd.hci.hci_performance_test import HciPerformanceTest
+from blueberry.tests.gd.l2cap.le.le_l2cap_performance_test import LeL2capPerformanceTest
+
+DISABLED_TESTS = {
+    LeScanningManagerTest, L2capTest, LeL2capTest, LeSecurityTest, SecurityTest, HciPerformanceTest,
+    LeL2capPerformanceTest
+}
 
 PRESUBMIT_TESTS = list(ALL_TESTS - DISABLED_TESTS)
 
@@ -14,9 +14,13 @@
 #   See the License for the specific language governing permissions and
 #   limitations under the License.
 
+import statistics
 import time
+from datetime import timedelta
 
+from blueberry.facade import rootservice_pb2 as facade_rootservice
 from blueberry.tests.gd.cert import gd_base_test
+from blueberry.tests.gd.cert.performance_test_logger import PerformanceTestLogger
 from blueberry.tests.gd.cert.truth import assertThat
 from bluetooth_packets_python3 import hci_packets
 from google.protobuf import empty_pb2 as empty_proto
@@ -54,6 +58,25 @@ class ControllerTest(gd_base_test.GdBaseTestClass):
                 controller_facade.OpCodeMsg(op_code=int(hci_packets.OpCode.LE_SET_EXTENDED_ADVERTISING_PARAMETERS)))
             assertThat(supported.supported).isEqualTo(True)
 
+    def test_enable_time(self):
+        """
+        Restart the DUT stack and log how long the controller bring-up takes
+        """
+        performance_test_logger = PerformanceTestLogger()
+        for _ in range(5):
+            self.dut.rootservice.StopStack(facade_rootservice.StopStackRequest())
+            performance_test_logger.start_interval("ENABLE")
+            self.dut.rootservice.StartStack(
+                facade_rootservice.StartStackRequest(
+                    module_under_test=facade_rootservice.BluetoothModule.Value(self.dut_module)))
+            performance_test_logger.end_interval("ENABLE")
+            self.dut.wait_channel_ready()
+
+        durations = performance_test_logger.get_duration_of_intervals("ENABLE")
+        median = statistics.median(durations)
+        self.log.info("Enable durations: %s, median: %s" % (", ".join(str(d) for d in durations), str(median)))
+        assertThat(median).isLessThan(timedelta(seconds=2))
+
 
 if __name__ == '__main__':
     test_runner.main()
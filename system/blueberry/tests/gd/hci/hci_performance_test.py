@@ -0,0 +1,194 @@
+#!/usr/bin/env python3
+#
+#   Copyright 2026 - The Android Open Source Project
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+from datetime import timedelta
+import os
+
+from blueberry.tests.gd.cert import gd_base_test
+from blueberry.tests.gd.cert.closable import safeClose
+from blueberry.tests.gd.cert.event_stream import EventStream
+from blueberry.tests.gd.cert.performance_baseline import PerformanceBaseline
+from blueberry.tests.gd.cert.performance_test_logger import PerformanceTestLogger
+from blueberry.tests.gd.cert.py_acl_manager import PyAclManager
+from blueberry.tests.gd.cert.py_hci import PyHci, PyHciAdvertisement
+from blueberry.tests.gd.cert.py_le_acl_manager import PyLeAclManager
+from blueberry.tests.gd.cert.truth import assertThat
+from blueberry.facade import common_pb2 as common
+from blueberry.facade.hci import le_initiator_address_facade_pb2 as le_initiator_address_facade
+from blueberry.facade.hci import le_scanning_manager_facade_pb2 as le_scanning_facade
+from bluetooth_packets_python3 import hci_packets
+from google.protobuf import empty_pb2 as empty_proto
+from mobly import test_runner
+
+SCAN_TIMEOUT = timedelta(seconds=60)
+
+
+class HciPerformanceTest(gd_base_test.GdBaseTestClass):
+    """
+    Connection establishment time and scan result rate of the DUT stack, through the HCI facades, with CERT driving
+    its controller directly. Meant to be run on the AndroidDeviceCert testbed, with two real devices, to catch host
+    stack regressions on real radios; it also runs over rootcanal.
+
+    The user params of the test config set the counts:
+        connections: number of connections established for the connection times (default 10)
+        scan_reports: number of advertising reports timed for the scan result rate (default 100)
+        adv_interval: advertising interval of CERT, in units of 0.625 ms (default 0x20, 20 ms)
+
+    The results of each test are written to performance_metrics.json in its log directory, and checked against the
+    baseline given to PerformanceBaseline.
+    """
+
+    def setup_class(self):
+        gd_base_test.GdBaseTestClass.setup_class(self, dut_module='HCI_INTERFACES', cert_module='HCI')
+
+    def setup_test(self):
+        gd_base_test.GdBaseTestClass.setup_test(self)
+        self.cert_hci = PyHci(self.cert, acl_streaming=True)
+        self.dut_acl_manager = PyAclManager(self.dut)
+        self.dut_le_acl_manager = PyLeAclManager(self.dut)
+        self.dut_random_address = 'd0:05:04:03:02:01'
+        self.cert_random_address = 'c0:05:04:03:02:01'
+        self.performance_test_logger = PerformanceTestLogger()
+        self.performance_baseline = PerformanceBaseline(self.user_params)
+        self.connections = int(self.user_params.get('connections', 10))
+        self.scan_reports = int(self.user_params.get('scan_reports', 100))
+        self.adv_interval = int(self.user_params.get('adv_interval', 0x20))
+
+    def teardown_test(self):
+        self.performance_test_logger.dump_metrics(os.path.join(self.log_path_base, "performance_metrics.json"))
+        regressions = self.performance_baseline.record("%s.%s" % (self.TAG, self.current_test_info.name),
+                                                       self.performance_test_logger.metrics, [self.dut, self.cert])
+        safeClose(self.dut_le_acl_manager)
+        self.dut_acl_manager.close()
+        self.cert_hci.close()
+        gd_base_test.GdBaseTestClass.teardown_test(self)
+        self.performance_baseline.check(regressions)
+
+    def _set_dut_privacy_policy_static(self):
+        private_policy = le_initiator_address_facade.PrivacyPolicy(
+            address_policy=le_initiator_address_facade.AddressPolicy.USE_STATIC_ADDRESS,
+            address_with_type=common.BluetoothAddressWithType(
+                address=common.BluetoothAddress(address=bytes(self.dut_random_address, "utf-8")),
+                type=common.RANDOM_DEVICE_ADDRESS))
+        self.dut.hci_le_initiator_address.SetPrivacyPolicyForInitiatorAddress(private_policy)
+
+    def _cert_advertises(self, properties):
+        advertising_handle = 0
+        self.cert_hci.create_advertisement(
+            advertising_handle,
+            self.cert_random_address,
+            properties,
+            min_interval=self.adv_interval,
+            max_interval=self.adv_interval)
+        advertisement = PyHciAdvertisement(advertising_handle, self.cert_hci)
+        advertisement.set_data(b'Im_A_Cert')
+        if properties == hci_packets.LegacyAdvertisingEventProperties.ADV_IND:
+            advertisement.set_scan_response(b'Im_A_C')
+        advertisement.start()
+        return advertisement
+
+    def _add_durations(self, name, label):
+        durations = self.performance_test_logger.get_duration_of_intervals(label)
+        durations = sorted(duration.total_seconds() * 1000 for duration in durations)
+        mean = sum(durations) / len(durations)
+        self.log.info("%s, mean %f ms" % (name, mean))
+        self.performance_test_logger.add_metric(name + "_mean", mean, "ms")
+        self.performance_test_logger.add_metric(name + "_median", durations[len(durations) // 2], "ms")
+        self.performance_test_logger.add_metric(name + "_max", durations[-1], "ms")
+
+    def test_classic_connection_establishment_time(self):
+        """
+        From the Create Connection of the DUT to its Connection Complete, CERT accepting, then disconnected by the DUT
+        """
+        self.cert_hci.enable_inquiry_and_page_scan()
+        cert_address = self.cert_hci.read_own_address()
+
+        for _ in range(self.connections):
+            self.performance_test_logger.start_interval("CONNECT")
+            self.dut_acl_manager.initiate_connection(cert_address)
+            self.cert_hci.accept_connection()
+            dut_acl = self.dut_acl_manager.complete_outgoing_connection()
+            self.performance_test_logger.end_interval("CONNECT")
+
+            dut_acl.disconnect(hci_packets.DisconnectReason.REMOTE_USER_TERMINATED_CONNECTION)
+            dut_acl.wait_for_disconnection_complete()
+            dut_acl.close()
+
+        self._add_durations("classic_connection_establishment", "CONNECT")
+
+    def test_le_connection_establishment_time(self):
+        """
+        From the LE Create Connection of the DUT to its LE Connection Complete, CERT advertising connectable, then
+        disconnected by the DUT
+        """
+        self._set_dut_privacy_policy_static()
+        remote_addr = common.BluetoothAddressWithType(
+            address=common.BluetoothAddress(address=bytes(self.cert_random_address, 'utf8')),
+            type=int(hci_packets.AddressType.RANDOM_DEVICE_ADDRESS))
+
+        advertisement = self._cert_advertises(hci_packets.LegacyAdvertisingEventProperties.ADV_IND)
+        for i in range(self.connections):
+            # Legacy advertising stops on connection
+            if i > 0:
+                advertisement.start()
+            self.performance_test_logger.start_interval("CONNECT")
+            dut_le_acl = self.dut_le_acl_manager.connect_to_remote(remote_addr)
+            self.performance_test_logger.end_interval("CONNECT")
+            self.cert_hci.incoming_le_connection()
+
+            dut_le_acl.disconnect()
+            dut_le_acl.wait_for_disconnection_complete()
+
+        self._add_durations("le_connection_establishment", "CONNECT")
+        self.performance_test_logger.add_metric("adv_interval", self.adv_interval, "0.625 ms")
+
+    def test_le_scan_result_rate(self):
+        """
+        Advertising reports of CERT delivered by the DUT scanning passively and continuously, CERT advertising
+        non-connectable every adv_interval. The rate is taken between the first report and the last one.
+        """
+        self._set_dut_privacy_policy_static()
+        advertising_report_stream = EventStream(
+            self.dut.hci_le_scanning_manager.FetchAdvertisingReports(empty_proto.Empty()))
+        try:
+            self._cert_advertises(hci_packets.LegacyAdvertisingEventProperties.ADV_NONCONN_IND)
+            self.dut.hci_le_scanning_manager.SetScanParameters(
+                le_scanning_facade.SetScanParametersRequest(
+                    scanner_id=0x01,
+                    scan_type=le_scanning_facade.LeScanType.PASSIVE,
+                    scan_interval=0x10,
+                    scan_window=0x10))
+            self.dut.hci_le_scanning_manager.Scan(le_scanning_facade.ScanRequest(start=True))
+
+            from_cert = lambda report: b'Im_A_Cert' in report.event
+            assertThat(advertising_report_stream).emits(from_cert, timeout=SCAN_TIMEOUT)
+            self.performance_test_logger.start_interval("SCAN")
+            assertThat(advertising_report_stream).emits(
+                from_cert, at_least_times=self.scan_reports - 1, timeout=SCAN_TIMEOUT)
+            self.performance_test_logger.end_interval("SCAN")
+            self.dut.hci_le_scanning_manager.Scan(le_scanning_facade.ScanRequest(start=False))
+        finally:
+            safeClose(advertising_report_stream)
+
+        duration = self.performance_test_logger.get_duration_of_intervals("SCAN")[0]
+        self.log.info("%d scan results in %s" % (self.scan_reports, str(duration)))
+        self.performance_test_logger.add_metric("le_scan_result_rate",
+                                                (self.scan_reports - 1) / duration.total_seconds(), "reports/s")
+        self.performance_test_logger.add_metric("adv_interval", self.adv_interval, "0.625 ms")
+
+
+if __name__ == '__main__':
+    test_runner.main()
@@ -14,9 +14,11 @@
 #   limitations under the License.
 
 from datetime import datetime, timedelta
+import os
 
 from blueberry.tests.gd.cert.matchers import L2capMatchers
 from blueberry.tests.gd.cert.truth import assertThat
+from blueberry.tests.gd.cert.performance_baseline import PerformanceBaseline
 from blueberry.tests.gd.cert.performance_test_logger import PerformanceTestLogger
 from blueberry.tests.gd.cert import gd_base_test
 from blueberry.tests.gd.l2cap.classic.cert_l2cap import CertL2cap
@@ -38,10 +40,15 @@ class L2capPerformanceTest(gd_base_test.GdBaseTestClass, L2capTestBase):
         gd_base_test.GdBaseTestClass.setup_test(self)
         L2capTestBase.setup_test(self, self.dut, self.cert)
         self.performance_test_logger = PerformanceTestLogger()
+        self.performance_baseline = PerformanceBaseline(self.user_params)
 
     def teardown_test(self):
+        self.performance_test_logger.dump_metrics(os.path.join(self.log_path_base, "performance_metrics.json"))
+        regressions = self.performance_baseline.record("%s.%s" % (self.TAG, self.current_test_info.name),
+                                                       self.performance_test_logger.metrics, [self.dut, self.cert])
         L2capTestBase.teardown_test(self)
         gd_base_test.GdBaseTestClass.teardown_test(self)
+        self.performance_baseline.check(regressions)
 
     def _basic_mode_tx(self, mtu, packets):
         """
@@ -166,6 +173,19 @@ class L2capPerformanceTest(gd_base_test.GdBaseTestClass, L2capTestBase):
         duration = self._ertm_mode_tx(672, 100)
         assertThat(duration).isWithin(timedelta(seconds=5))
 
+    def test_ertm_mode_tx_throughput(self):
+        """
+        I-frames of ertm_mtu bytes sent by the DUT, CERT acknowledging each full window. The size and the number of
+        packets are taken from the ertm_mtu and packets user params.
+        """
+        mtu = int(self.user_params.get('ertm_mtu', 672))
+        tx_window_size = 10
+        packets = int(self.user_params.get('packets', 200)) // tx_window_size * tx_window_size
+        duration = self._ertm_mode_tx(mtu, packets, tx_window_size)
+        self.performance_test_logger.add_metric("ertm_tx_throughput", packets * mtu / duration.total_seconds(),
+                                                "bytes/s")
+        self.performance_test_logger.add_metric("ertm_mtu", mtu, "bytes")
+
     def test_basic_mode_rx_672_100(self):
         self._basic_mode_rx(672, 100)
 
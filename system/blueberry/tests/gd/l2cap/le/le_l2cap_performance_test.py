@@ -0,0 +1,183 @@
+#
+#   Copyright 2026 - The Android Open Source Project
+#
+#   Licensed under the Apache License, Version 2.0 (the "License");
+#   you may not use this file except in compliance with the License.
+#   You may obtain a copy of the License at
+#
+#       http://www.apache.org/licenses/LICENSE-2.0
+#
+#   Unless required by applicable law or agreed to in writing, software
+#   distributed under the License is distributed on an "AS IS" BASIS,
+#   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#   See the License for the specific language governing permissions and
+#   limitations under the License.
+
+
+from datetime import timedelta
+import os
+
+from bluetooth_packets_python3 import RawBuilder
+from bluetooth_packets_python3 import l2cap_packets
+from blueberry.tests.gd.cert.matchers import L2capMatchers
+from blueberry.tests.gd.cert.performance_baseline import PerformanceBaseline
+from blueberry.tests.gd.cert.performance_test_logger import PerformanceTestLogger
+from blueberry.tests.gd.cert.truth import assertThat
+from blueberry.tests.gd.cert import gd_base_test
+from blueberry.tests.gd.l2cap.le.le_l2cap_test import LeL2capTestBase
+
+from mobly import test_runner
+
+ATT_CID = 4
+ATT_READ_REQUEST = 0x0a
+ATT_READ_RESPONSE = 0x0b
+ATT_WRITE_COMMAND = 0x52
+ATT_HANDLE = 0x0003
+
+TRANSFER_TIMEOUT = timedelta(seconds=60)
+
+
+class LeL2capPerformanceTest(gd_base_test.GdBaseTestClass, LeL2capTestBase):
+    """
+    End to end throughput and latency of the LE L2CAP channels and of the ATT traffic between the DUT and CERT stacks,
+    over rootcanal. The DUT is the central, the link is set to the connection interval asked for before measuring.
+
+    The user params of the test config set the sizes and the connection interval:
+        le_coc_mtu: MTU of the LE credit based channel, an SDU of this size each K-frame (default 1000)
+        att_mtu: size of the ATT PDUs (default 247)
+        conn_interval: connection interval, in units of 1.25 ms (default 0x18, 30 ms)
+        packets: number of SDUs or PDUs sent for the throughput (default 200)
+        round_trips: number of ATT requests for the latency (default 100)
+
+    The results of each test are written to performance_metrics.json in its log directory, and checked against the
+    baseline given to PerformanceBaseline.
+    """
+
+    def setup_class(self):
+        gd_base_test.GdBaseTestClass.setup_class(self, dut_module='L2CAP', cert_module='HCI_INTERFACES')
+
+    def setup_test(self):
+        gd_base_test.GdBaseTestClass.setup_test(self)
+        LeL2capTestBase.setup_test(self, self.dut, self.cert)
+        self.performance_test_logger = PerformanceTestLogger()
+        self.performance_baseline = PerformanceBaseline(self.user_params)
+        self.le_coc_mtu = int(self.user_params.get('le_coc_mtu', 1000))
+        self.att_mtu = int(self.user_params.get('att_mtu', 247))
+        self.conn_interval = int(self.user_params.get('conn_interval', 0x18))
+        self.packets = int(self.user_params.get('packets', 200))
+        self.round_trips = int(self.user_params.get('round_trips', 100))
+
+    def teardown_test(self):
+        self.performance_test_logger.dump_metrics(os.path.join(self.log_path_base, "performance_metrics.json"))
+        regressions = self.performance_baseline.record("%s.%s" % (self.TAG, self.current_test_info.name),
+                                                       self.performance_test_logger.metrics, [self.dut, self.cert])
+        LeL2capTestBase.teardown_test(self)
+        gd_base_test.GdBaseTestClass.teardown_test(self)
+        self.performance_baseline.check(regressions)
+
+    def _setup_link(self):
+        """
+        Connect from the DUT, then have it move the link to the connection interval of the test
+        """
+        self.performance_test_logger.start_interval("SETUP")
+        self._set_link_from_dut_and_open_channel()
+        self.performance_test_logger.end_interval("SETUP")
+
+        # The DUT being the central, it updates the link for the request of CERT
+        self.cert_l2cap.get_control_channel().send(
+            l2cap_packets.ConnectionParameterUpdateRequestBuilder(2, self.conn_interval, self.conn_interval, 0, 0x1f4))
+        assertThat(self.cert_l2cap.get_control_channel()).emits(
+            L2capMatchers.LeConnectionParameterUpdateResponse(
+                l2cap_packets.ConnectionParameterUpdateResponseResult.ACCEPTED))
+
+    def _add_throughput(self, name, label, total_bytes):
+        duration = self.performance_test_logger.get_duration_of_intervals(label)[0]
+        self.log.info("%s: %d bytes in %s" % (name, total_bytes, str(duration)))
+        self.performance_test_logger.add_metric(name, total_bytes / duration.total_seconds(), "bytes/s")
+
+    def _add_parameters(self, **parameters):
+        self.performance_test_logger.add_metric("conn_interval", self.conn_interval, "1.25 ms")
+        for name, value in parameters.items():
+            self.performance_test_logger.add_metric(name, value, "bytes")
+
+    def test_le_connection_setup_time(self):
+        self._setup_link()
+        duration = self.performance_test_logger.get_duration_of_intervals("SETUP")[0]
+        self.log.info("Connection setup: %s" % str(duration))
+        self.performance_test_logger.add_metric("le_connection_setup", duration.total_seconds() * 1000, "ms")
+        self._add_parameters()
+
+    def test_le_coc_tx_throughput(self):
+        """
+        SDUs of le_coc_mtu bytes sent by the DUT, CERT giving all the credits up front. The MPS leaves room for the SDU
+        length so each SDU is a single K-frame.
+        """
+        self._setup_link()
+        psm = 0x35
+        dut_channel = self.dut_l2cap.register_coc(self.cert_address, psm)
+        cert_channel = self.cert_l2cap.open_channel(
+            3, psm, 0x0102, mtu=self.le_coc_mtu, mps=self.le_coc_mtu + 2, initial_credit=min(self.packets, 0xffff))
+
+        data = b'a' * self.le_coc_mtu
+        self.performance_test_logger.start_interval("TX")
+        for _ in range(self.packets):
+            dut_channel.send(data)
+        assertThat(cert_channel).emits(
+            L2capMatchers.FirstLeIFrame(data, sdu_size=self.le_coc_mtu),
+            at_least_times=self.packets,
+            timeout=TRANSFER_TIMEOUT)
+        self.performance_test_logger.end_interval("TX")
+
+        self._add_throughput("le_coc_tx_throughput", "TX", self.packets * self.le_coc_mtu)
+        self._add_parameters(le_coc_mtu=self.le_coc_mtu)
+
+    def test_att_write_command_throughput(self):
+        """
+        ATT Write Commands of att_mtu bytes sent by the DUT on the ATT fixed channel, as GATT Write Without Response
+        """
+        self.dut_l2cap.enable_fixed_channel(ATT_CID)
+        self._setup_link()
+        (dut_channel, cert_channel) = self._open_fixed_channel(ATT_CID)
+
+        pdu = bytes([ATT_WRITE_COMMAND, ATT_HANDLE & 0xff, ATT_HANDLE >> 8]) + b'a' * (self.att_mtu - 3)
+        self.performance_test_logger.start_interval("TX")
+        for _ in range(self.packets):
+            dut_channel.send(pdu)
+        assertThat(cert_channel).emits(L2capMatchers.Data(pdu), at_least_times=self.packets, timeout=TRANSFER_TIMEOUT)
+        self.performance_test_logger.end_interval("TX")
+
+        # The value written, without the opcode and handle
+        self._add_throughput("att_write_command_throughput", "TX", self.packets * (self.att_mtu - 3))
+        self._add_parameters(att_mtu=self.att_mtu)
+
+    def test_att_round_trip_latency(self):
+        """
+        ATT Read Requests sent by the DUT, each answered by CERT with a Read Response of att_mtu bytes
+        """
+        self.dut_l2cap.enable_fixed_channel(ATT_CID)
+        self._setup_link()
+        (dut_channel, cert_channel) = self._open_fixed_channel(ATT_CID)
+
+        request = bytes([ATT_READ_REQUEST, ATT_HANDLE & 0xff, ATT_HANDLE >> 8])
+        response = bytes([ATT_READ_RESPONSE]) + b'a' * (self.att_mtu - 1)
+        response_packet = RawBuilder([x for x in response])
+        for _ in range(self.round_trips):
+            self.performance_test_logger.start_interval("RTT")
+            dut_channel.send(request)
+            assertThat(cert_channel).emits(L2capMatchers.Data(request))
+            cert_channel.send(response_packet)
+            assertThat(dut_channel).emits(L2capMatchers.PacketPayloadRawData(response))
+            self.performance_test_logger.end_interval("RTT")
+
+        durations = self.performance_test_logger.get_duration_of_intervals("RTT")
+        durations = sorted(duration.total_seconds() * 1000 for duration in durations)
+        mean = sum(durations) / len(durations)
+        self.log.info("ATT round trip, mean %f ms" % mean)
+        self.performance_test_logger.add_metric("att_round_trip_mean", mean, "ms")
+        self.performance_test_logger.add_metric("att_round_trip_median", durations[len(durations) // 2], "ms")
+        self.performance_test_logger.add_metric("att_round_trip_max", durations[-1], "ms")
+        self._add_parameters(att_mtu=self.att_mtu)
+
+
+if __name__ == '__main__':
+    test_runner.main()
@@ -34,13 +34,11 @@ from mobly import test_runner
 SAMPLE_PACKET = bt_packets.RawBuilder([0x19, 0x26, 0x08, 0x17])
 
 
-class LeL2capTest(gd_base_test.GdBaseTestClass):
+class LeL2capTestBase():
 
-    def setup_class(self):
-        gd_base_test.GdBaseTestClass.setup_class(self, dut_module='L2CAP', cert_module='HCI_INTERFACES')
-
-    def setup_test(self):
-        gd_base_test.GdBaseTestClass.setup_test(self)
+    def setup_test(self, dut, cert):
+        self.dut = dut
+        self.cert = cert
 
         self.dut_l2cap = PyLeL2cap(self.dut)
         self.cert_l2cap = CertLeL2cap(self.cert)
@@ -66,7 +64,6 @@ class LeL2capTest(gd_base_test.GdBaseTestClass):
     def teardown_test(self):
         self.cert_l2cap.close()
         self.dut_l2cap.close()
-        gd_base_test.GdBaseTestClass.teardown_test(self)
 
     def _setup_link_from_cert(self):
         # DUT Advertises
@@ -133,6 +130,20 @@ class LeL2capTest(gd_base_test.GdBaseTestClass):
         cert_channel = self.cert_l2cap.open_fixed_channel(cid)
         return (dut_channel, cert_channel)
 
+
+class LeL2capTest(gd_base_test.GdBaseTestClass, LeL2capTestBase):
+
+    def setup_class(self):
+        gd_base_test.GdBaseTestClass.setup_class(self, dut_module='L2CAP', cert_module='HCI_INTERFACES')
+
+    def setup_test(self):
+        gd_base_test.GdBaseTestClass.setup_test(self)
+        LeL2capTestBase.setup_test(self, self.dut, self.cert)
+
+    def teardown_test(self):
+        LeL2capTestBase.teardown_test(self)
+        gd_base_test.GdBaseTestClass.teardown_test(self)
+
     def test_fixed_channel_send(self):
         self.dut_l2cap.enable_fixed_channel(4)
         self._setup_link_from_cert()
@@ -372,6 +372,7 @@ void bta_ag_rfc_close(tBTA_AG_SCB* p_scb,
   p_scb->codec_updated = false;
   p_scb->codec_fallback = false;
   p_scb->codec_msbc_settings = BTA_AG_SCO_MSBC_SETTINGS_T2;
+  p_scb->preferred_msbc_settings = BTA_AG_SCO_MSBC_SETTINGS_T2;
   p_scb->role = 0;
   p_scb->svc_conn = false;
   p_scb->hsp_version = HSP_VERSION_1_2;
@@ -482,6 +483,7 @@ void bta_ag_rfc_open(tBTA_AG_SCB* p_scb, const tBTA_AG_DATA& data) {
 
   /* set up AT command interpreter */
   p_scb->at_cb.p_at_tbl = bta_ag_at_tbl[p_scb->conn_service];
+  p_scb->at_cb.p_at_idx = bta_ag_at_idx[p_scb->conn_service];
   p_scb->at_cb.p_cmd_cback = bta_ag_at_cback_tbl[p_scb->conn_service];
   p_scb->at_cb.p_err_cback = bta_ag_at_err_cback;
   p_scb->at_cb.p_user = p_scb;
@@ -767,6 +769,8 @@ void bta_ag_svc_conn_open(tBTA_AG_SCB* p_scb,
     /* Clear AT+BIA mask from previous SLC if any. */
     p_scb->bia_masked_out = 0;
 
+    bta_ag_sco_load_msbc_settings(p_scb);
+
     alarm_cancel(p_scb->ring_timer);
 
     /* call callback */
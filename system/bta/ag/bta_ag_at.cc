@@ -86,10 +86,23 @@ void bta_ag_process_at(tBTA_AG_AT_CB* p_cb, char* p_end) {
   uint8_t arg_type;
   char* p_arg;
   int16_t int_arg = 0;
-  /* loop through at command table looking for match */
-  for (idx = 0; p_cb->p_at_tbl[idx].p_cmd[0] != 0; idx++) {
-    if (!utl_strucmp(p_cb->p_at_tbl[idx].p_cmd, p_cb->p_cmd_buf)) {
-      break;
+  uint8_t found = BTA_AT_INDEX_NONE;
+
+  /* look the command name up in the table index */
+  if (p_cb->p_at_idx != nullptr) {
+    found = bta_at_find(p_cb->p_at_idx, p_cb->p_at_tbl, &tBTA_AG_AT_CMD::p_cmd,
+                        p_cb->p_cmd_buf, bta_at_cmd_name_len(p_cb->p_cmd_buf));
+  }
+
+  if (found != BTA_AT_INDEX_NONE) {
+    idx = found;
+  } else {
+    /* loop through at command table looking for a prefix match, for the
+     * commands which do not end where the name of a table command does */
+    for (idx = 0; p_cb->p_at_tbl[idx].p_cmd[0] != 0; idx++) {
+      if (!utl_strucmp(p_cb->p_at_tbl[idx].p_cmd, p_cb->p_cmd_buf)) {
+        break;
+      }
     }
   }
 
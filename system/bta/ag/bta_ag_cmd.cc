@@ -59,7 +59,7 @@ enum {
 };
 
 /* AT command interpreter table for HSP */
-static const tBTA_AG_AT_CMD bta_ag_hsp_cmd[] = {
+static constexpr tBTA_AG_AT_CMD bta_ag_hsp_cmd[] = {
     {"+CKPD", BTA_AG_AT_CKPD_EVT, BTA_AG_AT_SET, BTA_AG_AT_INT, 200, 200},
     {"+VGS", BTA_AG_SPK_EVT, BTA_AG_AT_SET, BTA_AG_AT_INT, 0, 15},
     {"+VGM", BTA_AG_MIC_EVT, BTA_AG_AT_SET, BTA_AG_AT_INT, 0, 15},
@@ -67,7 +67,7 @@ static const tBTA_AG_AT_CMD bta_ag_hsp_cmd[] = {
     {"", 0, 0, 0, 0, 0}};
 
 /* AT command interpreter table for HFP */
-static const tBTA_AG_AT_CMD bta_ag_hfp_cmd[] = {
+static constexpr tBTA_AG_AT_CMD bta_ag_hfp_cmd[] = {
     {"A", BTA_AG_AT_A_EVT, BTA_AG_AT_NONE, BTA_AG_AT_STR, 0, 0},
     {"D", BTA_AG_AT_D_EVT, BTA_AG_AT_NONE | BTA_AG_AT_FREE, BTA_AG_AT_STR, 0,
      0},
@@ -108,6 +108,14 @@ static const tBTA_AG_AT_CMD bta_ag_hfp_cmd[] = {
     /* End-of-table marker used to stop lookup iteration */
     {"", 0, 0, 0, 0, 0}};
 
+/* Perfect hash indexes of the command tables, built at compile time */
+static constexpr tBTA_AT_INDEX bta_ag_hsp_idx =
+    bta_at_make_index(bta_ag_hsp_cmd, &tBTA_AG_AT_CMD::p_cmd);
+static constexpr tBTA_AT_INDEX bta_ag_hfp_idx =
+    bta_at_make_index(bta_ag_hfp_cmd, &tBTA_AG_AT_CMD::p_cmd);
+static_assert(bta_ag_hsp_idx.seed != 0 && bta_ag_hfp_idx.seed != 0,
+              "No perfect hash of the AT command tables");
+
 /* AT result code table element */
 typedef struct {
   const char* result_string; /* AT result string */
@@ -169,6 +177,8 @@ static const tBTA_AG_RESULT* bta_ag_result_by_code(size_t code) {
 
 const tBTA_AG_AT_CMD* bta_ag_at_tbl[BTA_AG_NUM_IDX] = {bta_ag_hsp_cmd,
                                                        bta_ag_hfp_cmd};
+const tBTA_AT_INDEX* bta_ag_at_idx[BTA_AG_NUM_IDX] = {&bta_ag_hsp_idx,
+                                                     &bta_ag_hfp_idx};
 
 typedef struct {
   size_t result_code;
@@ -672,7 +682,8 @@ static int bta_ag_find_hf_ind_by_id(tBTA_AG_HF_IND* p_hf_ind, int size,
  *
  ******************************************************************************/
 static bool bta_ag_parse_bind_set(tBTA_AG_SCB* p_scb, tBTA_AG_VAL val) {
-  char* p_token = strtok(val.str, ",");
+  char* p_pos = val.str;
+  char* p_token = bta_at_next_arg(&p_pos);
   if (p_token == nullptr) return false;
 
   while (p_token != nullptr) {
@@ -686,7 +697,7 @@ static bool bta_ag_parse_bind_set(tBTA_AG_SCB* p_scb, tBTA_AG_VAL val) {
     p_scb->peer_hf_indicators[index].ind_id = rcv_ind_id;
     APPL_TRACE_DEBUG("%s peer_hf_ind[%d] = %d", __func__, index, rcv_ind_id);
 
-    p_token = strtok(nullptr, ",");
+    p_token = bta_at_next_arg(&p_pos);
   }
 
   return true;
@@ -781,11 +792,12 @@ static void bta_ag_bind_response(tBTA_AG_SCB* p_scb, uint8_t arg_type) {
  *
  ******************************************************************************/
 static bool bta_ag_parse_biev_response(tBTA_AG_SCB* p_scb, tBTA_AG_VAL* val) {
-  char* p_token = strtok(val->str, ",");
+  char* p_pos = val->str;
+  char* p_token = bta_at_next_arg(&p_pos);
   if (p_token == nullptr) return false;
   uint16_t rcv_ind_id = atoi(p_token);
 
-  p_token = strtok(nullptr, ",");
+  p_token = bta_at_next_arg(&p_pos);
   if (p_token == nullptr) return false;
   uint16_t rcv_ind_val = atoi(p_token);
 
@@ -249,6 +249,9 @@ struct tBTA_AG_SCB {
   bool codec_fallback; /* If sco nego fails for mSBC, fallback to CVSD */
   tBTA_AG_SCO_MSBC_SETTINGS
       codec_msbc_settings; /* settings to be used for the impending eSCO */
+  tBTA_AG_SCO_MSBC_SETTINGS
+      preferred_msbc_settings; /* settings the last mSBC eSCO opened with,
+                                  tried first */
 
   tBTA_AG_HF_IND
       peer_hf_indicators[BTA_AG_MAX_NUM_PEER_HF_IND]; /* Peer supported
@@ -292,6 +295,7 @@ typedef struct {
 extern const uint16_t bta_ag_uuid[BTA_AG_NUM_IDX];
 extern const uint8_t bta_ag_sec_id[BTA_AG_NUM_IDX];
 extern const tBTA_AG_AT_CMD* bta_ag_at_tbl[BTA_AG_NUM_IDX];
+extern const tBTA_AT_INDEX* bta_ag_at_idx[BTA_AG_NUM_IDX];
 
 /* control block declaration */
 extern tBTA_AG_CB bta_ag_cb;
@@ -389,6 +393,7 @@ extern void bta_ag_sco_listen(tBTA_AG_SCB* p_scb, const tBTA_AG_DATA& data);
 extern void bta_ag_sco_open(tBTA_AG_SCB* p_scb, const tBTA_AG_DATA& data);
 extern void bta_ag_sco_close(tBTA_AG_SCB* p_scb, const tBTA_AG_DATA& data);
 extern void bta_ag_sco_shutdown(tBTA_AG_SCB* p_scb, const tBTA_AG_DATA& data);
+extern void bta_ag_sco_load_msbc_settings(tBTA_AG_SCB* p_scb);
 extern void bta_ag_sco_conn_open(tBTA_AG_SCB* p_scb, const tBTA_AG_DATA& data);
 extern void bta_ag_sco_conn_close(tBTA_AG_SCB* p_scb, const tBTA_AG_DATA& data);
 extern void bta_ag_post_sco_open(tBTA_AG_SCB* p_scb, const tBTA_AG_DATA& data);
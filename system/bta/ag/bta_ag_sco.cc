@@ -30,6 +30,7 @@
 #include "bt_trace.h"   // Legacy trace logging
 
 #include "bta/ag/bta_ag_int.h"
+#include "btif/include/btif_storage.h"
 #include "device/include/controller.h"
 #include "main/shim/dumpsys.h"
 #include "osi/include/log.h"
@@ -381,8 +382,8 @@ static void bta_ag_create_sco(tBTA_AG_SCB* p_scb, bool is_orig) {
     p_scb->codec_fallback = false;
     /* Force AG to send +BCS for the next audio connection. */
     p_scb->codec_updated = true;
-    /* Reset mSBC settings to T2 for the next audio connection */
-    p_scb->codec_msbc_settings = BTA_AG_SCO_MSBC_SETTINGS_T2;
+    /* Reset mSBC settings to the preferred for the next audio connection */
+    p_scb->codec_msbc_settings = p_scb->preferred_msbc_settings;
   }
 
   /* Initialize eSCO parameters */
@@ -1230,6 +1231,30 @@ void bta_ag_sco_shutdown(tBTA_AG_SCB* p_scb,
   bta_ag_sco_event(p_scb, BTA_AG_SCO_SHUTDOWN_E);
 }
 
+/*******************************************************************************
+ *
+ * Function         bta_ag_sco_load_msbc_settings
+ *
+ * Description      Load the mSBC settings the last mSBC connection with the
+ *                  peer opened with, to try them first. Peers that rejected
+ *                  T2 then do not pay for a failed attempt on each call.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_ag_sco_load_msbc_settings(tBTA_AG_SCB* p_scb) {
+  uint8_t settings;
+  if (!btif_storage_get_hfp_msbc_settings(p_scb->peer_addr, &settings) ||
+      settings > BTA_AG_SCO_MSBC_SETTINGS_T1) {
+    settings = BTA_AG_SCO_MSBC_SETTINGS_T2;
+  }
+  p_scb->preferred_msbc_settings = (tBTA_AG_SCO_MSBC_SETTINGS)settings;
+  /* Do not override a fallback in progress */
+  if (bta_ag_cb.sco.p_curr_scb != p_scb) {
+    p_scb->codec_msbc_settings = p_scb->preferred_msbc_settings;
+  }
+}
+
 /*******************************************************************************
  *
  * Function         bta_ag_sco_conn_open
@@ -1249,8 +1274,17 @@ void bta_ag_sco_conn_open(tBTA_AG_SCB* p_scb,
   /* call app callback */
   bta_ag_cback_sco(p_scb, BTA_AG_AUDIO_OPEN_EVT);
 
-  /* reset to mSBC T2 settings as the preferred */
-  p_scb->codec_msbc_settings = BTA_AG_SCO_MSBC_SETTINGS_T2;
+  /* Start the next mSBC connections with the settings that opened this one,
+   * to skip those the peer rejected */
+  if (p_scb->inuse_codec == BTM_SCO_CODEC_MSBC &&
+      p_scb->codec_msbc_settings != p_scb->preferred_msbc_settings) {
+    LOG_INFO("%s opened mSBC with settings %d, trying them first from now on",
+             PRIVATE_ADDRESS(p_scb->peer_addr), p_scb->codec_msbc_settings);
+    p_scb->preferred_msbc_settings = p_scb->codec_msbc_settings;
+    btif_storage_set_hfp_msbc_settings(p_scb->peer_addr,
+                                       p_scb->preferred_msbc_settings);
+  }
+  p_scb->codec_msbc_settings = p_scb->preferred_msbc_settings;
 }
 
 /*******************************************************************************
@@ -1270,11 +1304,12 @@ void bta_ag_sco_conn_close(tBTA_AG_SCB* p_scb,
   p_scb->sco_idx = BTM_INVALID_SCO_INDEX;
 
   /* codec_fallback is set when AG is initiator and connection failed for mSBC.
-   * OR if codec is msbc and T2 settings failed, then retry Safe T1 settings */
+   * OR if codec is msbc and the preferred T2 settings failed, then retry Safe
+   * T1 settings */
   if (p_scb->svc_conn &&
       (p_scb->codec_fallback ||
        (p_scb->sco_codec == BTM_SCO_CODEC_MSBC &&
-        p_scb->codec_msbc_settings == BTA_AG_SCO_MSBC_SETTINGS_T1))) {
+        p_scb->codec_msbc_settings != p_scb->preferred_msbc_settings))) {
     bta_ag_sco_event(p_scb, BTA_AG_SCO_REOPEN_E);
   } else {
     /* Indicate if the closing of audio is because of transfer */
@@ -1292,7 +1327,7 @@ void bta_ag_sco_conn_close(tBTA_AG_SCB* p_scb,
 
     /* call app callback */
     bta_ag_cback_sco(p_scb, BTA_AG_AUDIO_CLOSE_EVT);
-    p_scb->codec_msbc_settings = BTA_AG_SCO_MSBC_SETTINGS_T2;
+    p_scb->codec_msbc_settings = p_scb->preferred_msbc_settings;
   }
 }
 
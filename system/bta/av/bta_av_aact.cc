@@ -28,8 +28,11 @@
 
 #include <base/strings/stringprintf.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
+#include <list>
+#include <utility>
 #include <vector>
 
 #include "bt_target.h"  // Must be first to define build configuration
@@ -49,6 +52,7 @@
 #include "stack/include/a2dp_sbc.h"
 #include "stack/include/acl_api.h"
 #include "stack/include/bt_hdr.h"
+#include "stack/include/bt_types.h"
 #include "stack/include/btm_api.h"
 #include "stack/include/btm_client_interface.h"
 #include "stack/include/l2c_api.h"
@@ -284,6 +288,305 @@ void bta_av_st_rc_timer(tBTA_AV_SCB* p_scb, UNUSED_ATTR tBTA_AV_DATA* p_data) {
   }
 }
 
+/* The SEPs and their capabilities of the peers a stream was opened with, most
+ * recently used first, also kept in the storage of the bonded peers. Opening
+ * or reconfiguring a stream with one of them again goes straight to the set
+ * configuration, without the AVDTP discover and get capabilities round
+ * trips. */
+#define BTA_AV_NUM_PEER_CAPS 8
+
+/* Version of the encoding of the peer capabilities in the storage */
+#define BTA_AV_PEER_CAPS_VERSION 1
+/* SEP: in use, SEID, media type, SEP type */
+#define BTA_AV_PEER_SEP_SIZE 4
+/* SEID then the capabilities */
+#define BTA_AV_PEER_CAP_SIZE (9 + AVDT_CODEC_SIZE + AVDT_PROTECT_SIZE)
+
+typedef struct {
+  RawAddress peer_address;
+  uint16_t avdt_version; /* AVDTP version of the peer SDP record */
+  bool complete; /* true once a stream was opened with these capabilities */
+  bool stored;   /* true if these capabilities are in the storage */
+  uint8_t num_seps;
+  tAVDT_SEP_INFO sep_info[BTA_AV_NUM_SEPS];
+  std::vector<std::pair<uint8_t, AvdtpSepConfig>> caps; /* by SEID */
+} tBTA_AV_PEER_CAPS;
+
+static std::list<tBTA_AV_PEER_CAPS> bta_av_peer_caps;
+
+static std::list<tBTA_AV_PEER_CAPS>::iterator bta_av_find_peer_caps(
+    const RawAddress& peer_address) {
+  return std::find_if(bta_av_peer_caps.begin(), bta_av_peer_caps.end(),
+                      [&peer_address](const tBTA_AV_PEER_CAPS& entry) {
+                        return entry.peer_address == peer_address;
+                      });
+}
+
+static std::list<tBTA_AV_PEER_CAPS>::iterator bta_av_new_peer_caps(
+    const RawAddress& peer_address) {
+  if (bta_av_peer_caps.size() == BTA_AV_NUM_PEER_CAPS) {
+    bta_av_peer_caps.pop_back();
+  }
+  auto it = bta_av_peer_caps.emplace(bta_av_peer_caps.begin());
+  it->peer_address = peer_address;
+  return it;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_av_encode_peer_caps
+ *
+ * Description      Encode the SEPs and capabilities of a peer for the
+ *                  storage.
+ *
+ * Returns          The encoded capabilities.
+ *
+ ******************************************************************************/
+static std::vector<uint8_t> bta_av_encode_peer_caps(
+    const tBTA_AV_PEER_CAPS& entry) {
+  std::vector<uint8_t> data(5 + entry.num_seps * BTA_AV_PEER_SEP_SIZE +
+                            entry.caps.size() * BTA_AV_PEER_CAP_SIZE);
+  uint8_t* p = data.data();
+
+  UINT8_TO_STREAM(p, BTA_AV_PEER_CAPS_VERSION);
+  UINT16_TO_STREAM(p, entry.avdt_version);
+  UINT8_TO_STREAM(p, entry.num_seps);
+  for (int i = 0; i < entry.num_seps; i++) {
+    UINT8_TO_STREAM(p, entry.sep_info[i].in_use);
+    UINT8_TO_STREAM(p, entry.sep_info[i].seid);
+    UINT8_TO_STREAM(p, entry.sep_info[i].media_type);
+    UINT8_TO_STREAM(p, entry.sep_info[i].tsep);
+  }
+  UINT8_TO_STREAM(p, entry.caps.size());
+  for (const auto& cap : entry.caps) {
+    UINT8_TO_STREAM(p, cap.first);
+    ARRAY_TO_STREAM(p, cap.second.codec_info, AVDT_CODEC_SIZE);
+    ARRAY_TO_STREAM(p, cap.second.protect_info, AVDT_PROTECT_SIZE);
+    UINT8_TO_STREAM(p, cap.second.num_codec);
+    UINT8_TO_STREAM(p, cap.second.num_protect);
+    UINT16_TO_STREAM(p, cap.second.psc_mask);
+    UINT8_TO_STREAM(p, cap.second.recov_type);
+    UINT8_TO_STREAM(p, cap.second.recov_mrws);
+    UINT8_TO_STREAM(p, cap.second.recov_mnmp);
+    UINT8_TO_STREAM(p, cap.second.hdrcmp_mask);
+  }
+  return data;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_av_decode_peer_caps
+ *
+ * Description      Decode the SEPs and capabilities of a peer read from the
+ *                  storage.
+ *
+ * Returns          true if they were decoded.
+ *
+ ******************************************************************************/
+static bool bta_av_decode_peer_caps(const std::vector<uint8_t>& data,
+                                    tBTA_AV_PEER_CAPS* p_entry) {
+  const uint8_t* p = data.data();
+  uint8_t version, num_caps;
+
+  if (data.size() < 5) return false;
+  STREAM_TO_UINT8(version, p);
+  if (version != BTA_AV_PEER_CAPS_VERSION) return false;
+  STREAM_TO_UINT16(p_entry->avdt_version, p);
+  STREAM_TO_UINT8(p_entry->num_seps, p);
+  if (p_entry->num_seps > BTA_AV_NUM_SEPS ||
+      data.size() < 5u + p_entry->num_seps * BTA_AV_PEER_SEP_SIZE) {
+    return false;
+  }
+  for (int i = 0; i < p_entry->num_seps; i++) {
+    uint8_t in_use;
+    STREAM_TO_UINT8(in_use, p);
+    p_entry->sep_info[i].in_use = (in_use != 0);
+    STREAM_TO_UINT8(p_entry->sep_info[i].seid, p);
+    STREAM_TO_UINT8(p_entry->sep_info[i].media_type, p);
+    STREAM_TO_UINT8(p_entry->sep_info[i].tsep, p);
+  }
+  STREAM_TO_UINT8(num_caps, p);
+  if (data.size() != 5u + p_entry->num_seps * BTA_AV_PEER_SEP_SIZE +
+                         num_caps * BTA_AV_PEER_CAP_SIZE) {
+    return false;
+  }
+  p_entry->caps.resize(num_caps);
+  for (auto& cap : p_entry->caps) {
+    STREAM_TO_UINT8(cap.first, p);
+    STREAM_TO_ARRAY(cap.second.codec_info, p, AVDT_CODEC_SIZE);
+    STREAM_TO_ARRAY(cap.second.protect_info, p, AVDT_PROTECT_SIZE);
+    STREAM_TO_UINT8(cap.second.num_codec, p);
+    STREAM_TO_UINT8(cap.second.num_protect, p);
+    STREAM_TO_UINT16(cap.second.psc_mask, p);
+    STREAM_TO_UINT8(cap.second.recov_type, p);
+    STREAM_TO_UINT8(cap.second.recov_mrws, p);
+    STREAM_TO_UINT8(cap.second.recov_mnmp, p);
+    STREAM_TO_UINT8(cap.second.hdrcmp_mask, p);
+  }
+  return true;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_av_get_peer_caps
+ *
+ * Description      Look up the SEPs and capabilities a stream was opened
+ *                  with before by the peer of the stream, reading them from
+ *                  the storage if they are not cached yet.  Those found for
+ *                  another AVDTP version of the peer are not used.
+ *
+ * Returns          The capabilities, or nullptr if there are none.
+ *
+ ******************************************************************************/
+static tBTA_AV_PEER_CAPS* bta_av_get_peer_caps(tBTA_AV_SCB* p_scb) {
+  auto it = bta_av_find_peer_caps(p_scb->PeerAddress());
+  if (it == bta_av_peer_caps.end()) {
+    std::vector<uint8_t> data =
+        btif_storage_get_a2dp_sep_caps(p_scb->PeerAddress());
+    if (data.empty()) return nullptr;
+
+    it = bta_av_new_peer_caps(p_scb->PeerAddress());
+    if (!bta_av_decode_peer_caps(data, &*it)) {
+      APPL_TRACE_WARNING("%s: peer %s: bad stored SEP capabilities", __func__,
+                         p_scb->PeerAddress().ToString().c_str());
+      bta_av_peer_caps.erase(it);
+      btif_storage_remove_a2dp_sep_caps(p_scb->PeerAddress());
+      return nullptr;
+    }
+    it->complete = true;
+    it->stored = true;
+  }
+
+  if (!it->complete) return nullptr;
+  if (it->avdt_version != p_scb->AvdtpVersion()) {
+    APPL_TRACE_DEBUG("%s: peer %s: SEP capabilities of AVDTP 0x%x not 0x%x",
+                     __func__, p_scb->PeerAddress().ToString().c_str(),
+                     it->avdt_version, p_scb->AvdtpVersion());
+    return nullptr;
+  }
+  return &*it;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_av_save_peer_seps
+ *
+ * Description      Start caching the SEPs the peer returned to a discover
+ *                  request.  Their capabilities are added as they are
+ *                  received.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_av_save_peer_seps(tBTA_AV_SCB* p_scb) {
+  if (p_scb->caps_cached) return;
+
+  auto it = bta_av_find_peer_caps(p_scb->PeerAddress());
+  if (it == bta_av_peer_caps.end()) {
+    it = bta_av_new_peer_caps(p_scb->PeerAddress());
+  }
+  it->avdt_version = p_scb->AvdtpVersion();
+  it->complete = false;
+  it->stored = false;
+  it->num_seps = p_scb->num_seps;
+  memcpy(it->sep_info, p_scb->sep_info, sizeof(it->sep_info));
+  it->caps.clear();
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_av_save_peer_cap
+ *
+ * Description      Cache the capabilities of the SEP at sep_info_idx, just
+ *                  received in peer_cap.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_av_save_peer_cap(tBTA_AV_SCB* p_scb) {
+  auto it = bta_av_find_peer_caps(p_scb->PeerAddress());
+  if (it == bta_av_peer_caps.end() || p_scb->sep_info_idx >= p_scb->num_seps) {
+    return;
+  }
+
+  uint8_t seid = p_scb->sep_info[p_scb->sep_info_idx].seid;
+  for (auto& cap : it->caps) {
+    if (cap.first == seid) {
+      if (memcmp(cap.second.codec_info, p_scb->peer_cap.codec_info,
+                 AVDT_CODEC_SIZE) != 0 ||
+          cap.second.psc_mask != p_scb->peer_cap.psc_mask) {
+        it->stored = false;
+      }
+      cap.second = p_scb->peer_cap;
+      return;
+    }
+  }
+  it->caps.emplace_back(seid, p_scb->peer_cap);
+  it->stored = false;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_av_find_peer_cap
+ *
+ * Description      Look up the cached capabilities of a SEP of the peer.
+ *
+ * Returns          The capabilities, or nullptr if they are not cached.
+ *
+ ******************************************************************************/
+static const AvdtpSepConfig* bta_av_find_peer_cap(tBTA_AV_SCB* p_scb,
+                                                  uint8_t seid) {
+  if (!p_scb->caps_cached) return nullptr;
+
+  auto it = bta_av_find_peer_caps(p_scb->PeerAddress());
+  if (it == bta_av_peer_caps.end()) return nullptr;
+  for (const auto& cap : it->caps) {
+    if (cap.first == seid) return &cap.second;
+  }
+  return nullptr;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_av_peer_caps_opened
+ *
+ * Description      A stream was opened with the cached capabilities of the
+ *                  peer, they can be used the next time.  They are stored
+ *                  if they changed.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_av_peer_caps_opened(tBTA_AV_SCB* p_scb) {
+  auto it = bta_av_find_peer_caps(p_scb->PeerAddress());
+  if (it == bta_av_peer_caps.end()) return;
+
+  it->complete = true;
+  bta_av_peer_caps.splice(bta_av_peer_caps.begin(), bta_av_peer_caps, it);
+  if (!it->stored) {
+    btif_storage_set_a2dp_sep_caps(p_scb->PeerAddress(),
+                                   bta_av_encode_peer_caps(*it));
+    it->stored = true;
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_av_remove_peer_caps
+ *
+ * Description      Forget the cached SEPs and capabilities of the peer.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_av_remove_peer_caps(const RawAddress& peer_address) {
+  auto it = bta_av_find_peer_caps(peer_address);
+  if (it == bta_av_peer_caps.end()) return;
+
+  if (it->stored) btif_storage_remove_a2dp_sep_caps(peer_address);
+  bta_av_peer_caps.erase(it);
+}
+
 /*******************************************************************************
  *
  * Function         bta_av_next_getcap
@@ -312,11 +615,23 @@ static bool bta_av_next_getcap(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
         (p_scb->sep_info[i].media_type == p_scb->media_type)) {
       p_scb->sep_info_idx = i;
 
-      /* we got a stream; get its capabilities */
-      bool get_all_cap = (p_scb->AvdtpVersion() >= AVDT_VERSION_1_3) &&
-                         (A2DP_GetAvdtpVersion() >= AVDT_VERSION_1_3);
-      AVDT_GetCapReq(p_scb->PeerAddress(), p_scb->hdi, p_scb->sep_info[i].seid,
-                     &p_scb->peer_cap, &bta_av_proc_stream_evt, get_all_cap);
+      /* we got a stream; get its capabilities, unless they are cached */
+      const AvdtpSepConfig* p_cap =
+          bta_av_find_peer_cap(p_scb, p_scb->sep_info[i].seid);
+      if (p_cap != nullptr) {
+        tAVDT_CTRL avdt_ctrl;
+        memset(&avdt_ctrl, 0, sizeof(avdt_ctrl));
+        p_scb->peer_cap = *p_cap;
+        avdt_ctrl.getcap_cfm.p_cfg = &p_scb->peer_cap;
+        bta_av_proc_stream_evt(0, p_scb->PeerAddress(), AVDT_GETCAP_CFM_EVT,
+                               &avdt_ctrl, p_scb->hdi);
+      } else {
+        bool get_all_cap = (p_scb->AvdtpVersion() >= AVDT_VERSION_1_3) &&
+                           (A2DP_GetAvdtpVersion() >= AVDT_VERSION_1_3);
+        AVDT_GetCapReq(p_scb->PeerAddress(), p_scb->hdi,
+                       p_scb->sep_info[i].seid, &p_scb->peer_cap,
+                       &bta_av_proc_stream_evt, get_all_cap);
+      }
       sent_cmd = true;
       break;
     }
@@ -471,6 +786,8 @@ void bta_av_sink_data_cback(uint8_t handle, BT_HDR* p_pkt, uint32_t time_stamp,
     return;
   }
   p_pkt->event = BTA_AV_SINK_MEDIA_DATA_EVT;
+  /* use the offset area for the time stamp, the RTP header was stripped */
+  *(uint32_t*)(p_pkt + 1) = time_stamp;
   p_scb->seps[p_scb->sep_idx].p_app_sink_data_cback(
       p_scb->PeerAddress(), BTA_AV_SINK_MEDIA_DATA_EVT, (tBTA_AV_MEDIA*)p_pkt);
   /* Free the buffer: a copy of the packet has been delivered */
@@ -1161,6 +1478,8 @@ void bta_av_str_opened(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
   APPL_TRACE_DEBUG("%s: peer %s bta_handle: 0x%x", __func__,
                    p_scb->PeerAddress().ToString().c_str(), p_scb->hndl);
 
+  bta_av_peer_caps_opened(p_scb);
+
   msg.hdr.layer_specific = p_scb->hndl;
   msg.is_up = true;
   msg.peer_addr = p_scb->PeerAddress();
@@ -1405,6 +1724,7 @@ void bta_av_disc_results(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
 
   /* store number of stream endpoints returned */
   p_scb->num_seps = p_data->str_msg.msg.discover_cfm.num_seps;
+  bta_av_save_peer_seps(p_scb);
 
   for (i = 0; i < p_scb->num_seps; i++) {
     /* steam not in use, is a sink, and is audio */
@@ -1460,6 +1780,7 @@ void bta_av_disc_res_as_acp(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
 
   /* store number of stream endpoints returned */
   p_scb->num_seps = p_data->str_msg.msg.discover_cfm.num_seps;
+  bta_av_save_peer_seps(p_scb);
 
   for (i = 0; i < p_scb->num_seps; i++) {
     /* steam is a sink, and is audio */
@@ -1505,6 +1826,7 @@ void bta_av_save_caps(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
   uint8_t old_wait = p_scb->wait;
   bool getcap_done = false;
 
+  bta_av_save_peer_cap(p_scb);
   APPL_TRACE_DEBUG(
       "%s: peer %s bta_handle:0x%x num_seps:%d sep_info_idx:%d wait:0x%x",
       __func__, p_scb->PeerAddress().ToString().c_str(), p_scb->hndl,
@@ -1656,6 +1978,7 @@ void bta_av_getcap_results(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
   uint8_t media_type = A2DP_GetMediaType(p_scb->peer_cap.codec_info);
   tAVDT_SEP_INFO* p_info = &p_scb->sep_info[p_scb->sep_info_idx];
 
+  bta_av_save_peer_cap(p_scb);
   cfg.num_codec = 1;
   cfg.num_protect = p_scb->peer_cap.num_protect;
   memcpy(cfg.codec_info, p_scb->peer_cap.codec_info, AVDT_CODEC_SIZE);
@@ -1765,12 +2088,45 @@ void bta_av_setconfig_rej(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
  *
  ******************************************************************************/
 void bta_av_discover_req(tBTA_AV_SCB* p_scb, UNUSED_ATTR tBTA_AV_DATA* p_data) {
-  /* send avdtp discover request */
+  tBTA_AV_PEER_CAPS* p_caps = bta_av_get_peer_caps(p_scb);
+  p_scb->caps_cached = (p_caps != nullptr);
+  if (p_scb->caps_cached) {
+    /* report the cached SEPs as if the peer returned them */
+    LOG_INFO("%s: peer %s: %d cached SEPs", __func__,
+             p_scb->PeerAddress().ToString().c_str(), p_caps->num_seps);
+    tAVDT_CTRL avdt_ctrl;
+    memset(&avdt_ctrl, 0, sizeof(avdt_ctrl));
+    memcpy(p_scb->sep_info, p_caps->sep_info, sizeof(p_scb->sep_info));
+    avdt_ctrl.discover_cfm.p_sep_info = p_scb->sep_info;
+    avdt_ctrl.discover_cfm.num_seps = p_caps->num_seps;
+    bta_av_proc_stream_evt(0, p_scb->PeerAddress(), AVDT_DISCOVER_CFM_EVT,
+                           &avdt_ctrl, p_scb->hdi);
+    return;
+  }
 
+  /* send avdtp discover request */
   AVDT_DiscoverReq(p_scb->PeerAddress(), p_scb->hdi, p_scb->sep_info,
                    BTA_AV_NUM_SEPS, &bta_av_proc_stream_evt);
 }
 
+/*******************************************************************************
+ *
+ * Function         bta_av_rediscover_req
+ *
+ * Description      The stream could not be opened with the cached SEPs of
+ *                  the peer, which may have changed since.  Forget them and
+ *                  send an AVDTP discover request.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_av_rediscover_req(tBTA_AV_SCB* p_scb, tBTA_AV_DATA* p_data) {
+  LOG_WARN("%s: peer %s: cached SEPs failed, discovering them", __func__,
+           p_scb->PeerAddress().ToString().c_str());
+  bta_av_remove_peer_caps(p_scb->PeerAddress());
+  bta_av_discover_req(p_scb, p_data);
+}
+
 /*******************************************************************************
  *
  * Function         bta_av_conn_failed
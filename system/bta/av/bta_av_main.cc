@@ -230,6 +230,17 @@ int BTA_AvObtainPeerChannelIndex(const RawAddress& peer_address) {
   return -1;
 }
 
+bool BTA_AvGetStreamLinkState(const RawAddress& peer_address, bool* p_congested,
+                              uint8_t* p_l2c_bufs) {
+  tBTA_AV_SCB* p_scb = bta_av_addr_to_scb(peer_address);
+  if (p_scb == nullptr || !p_scb->started) {
+    return false;
+  }
+  *p_congested = p_scb->cong;
+  *p_l2c_bufs = p_scb->l2c_bufs;
+  return true;
+}
+
 /*******************************************************************************
  *
  * Function         bta_av_hndl_to_scb
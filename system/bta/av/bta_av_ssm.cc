@@ -178,6 +178,10 @@ static void bta_av_better_stream_state_machine(tBTA_AV_SCB* p_scb,
           event_handler1 = &bta_av_getcap_results;
           break;
         case BTA_AV_STR_GETCAP_FAIL_EVT:
+          if (p_scb->caps_cached) {
+            event_handler1 = &bta_av_rediscover_req;
+            break;
+          }
           p_scb->state = BTA_AV_CLOSING_SST;
           event_handler1 = &bta_av_open_failed;
           break;
@@ -187,6 +191,10 @@ static void bta_av_better_stream_state_machine(tBTA_AV_SCB* p_scb,
           event_handler2 = &bta_av_str_opened;
           break;
         case BTA_AV_STR_OPEN_FAIL_EVT:
+          if (p_scb->caps_cached) {
+            event_handler1 = &bta_av_rediscover_req;
+            break;
+          }
           p_scb->state = BTA_AV_CLOSING_SST;
           event_handler1 = &bta_av_open_failed;
           break;
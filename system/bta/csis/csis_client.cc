@@ -366,12 +366,13 @@ class CsisClientImpl : public CsisClient {
     }
 
     if (target_lock_state == CsisLockState::CSIS_STATE_LOCKED) {
-      std::shared_ptr<CsisDevice> next_dev;
-
-      do {
-        next_dev = csis_group->GetNextDevice(device);
-        if (!next_dev) break;
-      } while (!next_dev->IsConnected());
+      /* The lock requests are sent in the ascending order of the ranks,
+       * each one once the previous member granted its lock.
+       */
+      std::shared_ptr<CsisDevice> next_dev = csis_group->GetNextDevice(device);
+      while (next_dev && !next_dev->IsConnected()) {
+        next_dev = csis_group->GetNextDevice(next_dev);
+      }
 
       if (next_dev) {
         auto next_csis_inst = next_dev->GetCsisInstanceByGroupId(group_id);
@@ -512,13 +513,14 @@ class CsisClientImpl : public CsisClient {
        * order and check if we get new state notification.
        */
       auto csis_device = csis_group->GetLastDevice();
-      auto csis_instance = csis_device->GetCsisInstanceByGroupId(group_id);
-      LOG_ASSERT(csis_instance) << " csis_instance does not exist!";
       while (csis_device) {
-        if ((csis_device->IsConnected()) &&
-            ((csis_instance->GetLockState() != new_lock_state))) {
-          csis_group->UpdateLockTransitionCnt(1);
-          SetLock(csis_device, csis_instance, new_lock_state);
+        if (csis_device->IsConnected()) {
+          auto csis_instance = csis_device->GetCsisInstanceByGroupId(group_id);
+          LOG_ASSERT(csis_instance) << " csis_instance does not exist!";
+          if (csis_instance->GetLockState() != new_lock_state) {
+            csis_group->UpdateLockTransitionCnt(1);
+            SetLock(csis_device, csis_instance, new_lock_state);
+          }
         }
         csis_device = csis_group->GetPrevDevice(csis_device);
       }
@@ -1156,12 +1158,25 @@ class CsisClientImpl : public CsisClient {
           return csis_group->IsRsiMatching(rsi);
         });
     if (discovered_group_rsi != all_rsi.cend()) {
+      /* The members keep advertising while being discovered */
+      if (std::find(discovered_members_.begin(), discovered_members_.end(),
+                    result->bd_addr) != discovered_members_.end())
+        return;
+
       DLOG(INFO) << "Found set member " << result->bd_addr;
+      discovered_members_.push_back(result->bd_addr);
       callbacks_->OnSetMemberAvailable(result->bd_addr,
                                        csis_group->GetGroupId());
 
+      /* Keep scanning until all the missing members are found, so that they
+       * can be connected in parallel rather than one scan after the other.
+       */
+      if (csis_group->GetCurrentSize() + (int)discovered_members_.size() <
+          csis_group->GetDesiredSize())
+        return;
+
       /* Switch back to the opportunistic observer mode.
-       * When second device will pair, csis will restart active scan
+       * When next device will pair, csis will restart active scan
        * to search more members if needed */
       CsisActiveObserverSet(false);
       csis_group->SetDiscoveryState(CsisDiscoveryState::CSIS_DISCOVERY_IDLE);
@@ -1216,6 +1231,7 @@ class CsisClientImpl : public CsisClient {
     csis_group->SetDiscoveryState(CsisDiscoveryState::CSIS_DISCOVERY_ONGOING);
     /* TODO Maybe we don't need it */
     discovering_group_ = csis_group->GetGroupId();
+    discovered_members_.clear();
     CsisActiveObserverSet(true);
   }
 
@@ -1889,6 +1905,8 @@ class CsisClientImpl : public CsisClient {
   std::list<std::shared_ptr<CsisGroup>> csis_groups_;
   DeviceGroups* dev_groups_;
   int discovering_group_ = -1;
+  /* Members reported by the ongoing active discovery */
+  std::vector<RawAddress> discovered_members_;
 };
 
 class DeviceGroupsCallbacksImpl : public DeviceGroupsCallbacks {
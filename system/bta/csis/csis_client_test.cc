@@ -873,6 +873,35 @@ TEST_F(CsisClientTest, test_get_set_sirk) {
   ASSERT_EQ(g_1->GetSirk(), sirk);
 }
 
+TEST_F(CsisClientTest, test_rsi_matching) {
+  auto g_1 = std::make_shared<CsisGroup>(666, bluetooth::Uuid::kEmpty);
+  Octet16 sirk = {0x45, 0x7d, 0x7d, 0x09, 0x21, 0xa1, 0xfd, 0x22,
+                  0xce, 0xcd, 0x8c, 0x86, 0xdd, 0x72, 0xcc, 0xcd};
+  g_1->SetSirk(sirk);
+
+  // RSI made of the prand and its hash
+  uint8_t prand[3] = {0x63, 0xf5, 0x69};
+  Octet16 x = crypto_toolbox::aes_128(sirk, prand, sizeof(prand));
+  const uint8_t rsi_bytes[6] = {prand[2], prand[1], prand[0],
+                                x[2],     x[1],     x[0]};
+  RawAddress rsi(rsi_bytes);
+  ASSERT_TRUE(CsisGroup::is_rsi_match_sirk(rsi, sirk));
+  ASSERT_TRUE(g_1->IsRsiMatching(rsi));
+  // Cached result
+  ASSERT_TRUE(g_1->IsRsiMatching(rsi));
+
+  RawAddress other_rsi = rsi;
+  other_rsi.address[5] ^= 0x01;
+  ASSERT_FALSE(CsisGroup::is_rsi_match_sirk(other_rsi, sirk));
+  ASSERT_FALSE(g_1->IsRsiMatching(other_rsi));
+
+  // The results are dropped with the SIRK
+  Octet16 new_sirk = {1};
+  g_1->SetSirk(new_sirk);
+  ASSERT_EQ(g_1->IsRsiMatching(rsi),
+            CsisGroup::is_rsi_match_sirk(rsi, new_sirk));
+}
+
 class CsisMultiClientTest : public CsisClientTest {
  protected:
   const RawAddress test_address_1 = GetTestAddress(1);
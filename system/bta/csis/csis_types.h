@@ -20,6 +20,7 @@
 #include <base/strings/string_number_conversions.h>
 
 #include <algorithm>
+#include <array>
 #include <map>
 #include <vector>
 
@@ -290,6 +291,8 @@ class CsisGroup {
         target_lock_state_(CsisLockState::CSIS_STATE_UNSET),
         lock_transition_cnt_(0) {
     devices_.clear();
+    sirk_ctx_ = crypto_toolbox::aes_128_key_schedule(sirk_);
+    rsi_cache_.fill({RawAddress::kEmpty, false});
   }
 
   void AddDevice(std::shared_ptr<CsisDevice> csis_device) {
@@ -319,7 +322,19 @@ class CsisGroup {
         find_if(devices_.begin(), devices_.end(), CsisDevice::MatchAddress(csis_device->addr));
     return (it != devices_.end());
   }
-  bool IsRsiMatching(const RawAddress& rsi) const { return is_rsi_match_sirk(rsi, GetSirk()); }
+  /* The members advertise the same RSI until it is refreshed, so the recent
+   * results are kept. The SIRK key schedule is computed once.
+   */
+  bool IsRsiMatching(const RawAddress& rsi) const {
+    auto it = std::find_if(rsi_cache_.begin(), rsi_cache_.end(),
+                           [&rsi](const auto& e) { return e.first == rsi; });
+    if (it != rsi_cache_.end()) return it->second;
+
+    bool match = is_rsi_match_sirk(rsi, sirk_ctx_);
+    rsi_cache_[rsi_cache_next_] = {rsi, match};
+    rsi_cache_next_ = (rsi_cache_next_ + 1) % rsi_cache_.size();
+    return match;
+  }
   bool IsSirkBelongsToGroup(Octet16 sirk) const { return (sirk_available_ && sirk_ == sirk); }
   Octet16 GetSirk(void) const { return sirk_; }
   void SetSirk(Octet16& sirk) {
@@ -328,6 +343,8 @@ class CsisGroup {
     }
     sirk_available_ = true;
     sirk_ = sirk;
+    sirk_ctx_ = crypto_toolbox::aes_128_key_schedule(sirk_);
+    rsi_cache_.fill({RawAddress::kEmpty, false});
   }
 
   int GetNumOfConnectedDevices(void) {
@@ -474,10 +491,29 @@ class CsisGroup {
     return false;
   }
 
+  /* Same as above, with the key schedule of the SIRK */
+  static bool is_rsi_match_sirk(const RawAddress& rsi, const crypto_toolbox::Aes128KeySchedule& sirk_ctx) {
+    /* prand, the 3 MSB of the address, in the 3 LSB of the big endian block */
+    uint8_t in[AES_BLOCK_SIZE] = {0};
+    in[13] = rsi.address[0];
+    in[14] = rsi.address[1];
+    in[15] = rsi.address[2];
+
+    uint8_t out[AES_BLOCK_SIZE];
+    AES_encrypt(in, out, &sirk_ctx);
+
+    /* The hash is the 3 LSB of the address */
+    return (out[13] == rsi.address[3]) && (out[14] == rsi.address[4]) &&
+           (out[15] == rsi.address[5]);
+  }
+
  private:
   int group_id_;
   Octet16 sirk_ = {0};
+  crypto_toolbox::Aes128KeySchedule sirk_ctx_ = {};
   bool sirk_available_ = false;
+  mutable std::array<std::pair<RawAddress, bool>, 8> rsi_cache_;
+  mutable size_t rsi_cache_next_ = 0;
   int size_;
   bluetooth::Uuid uuid_;
 
@@ -28,6 +28,7 @@
 #include <base/logging.h>
 
 #include <cstdint>
+#include <unordered_set>
 
 #include "bta/dm/bta_dm_int.h"
 #include "bta/gatt/bta_gattc_int.h"
@@ -36,6 +37,7 @@
 #include "btif/include/btif_dm.h"
 #include "btif/include/btif_storage.h"
 #include "btif/include/stack_manager.h"
+#include "common/time_util.h"
 #include "device/include/controller.h"
 #include "device/include/interop.h"
 #include "main/shim/acl_api.h"
@@ -197,6 +199,20 @@ WaitForAllAclConnectionsToDrain::FromAlarmCallbackData(void* data) {
       static_cast<WaitForAllAclConnectionsToDrain*>(data));
 }
 
+// State of the general search started by bta_dm_search_start(), kept out of
+// bta_dm_search_cb as that one is cleared with memset.
+struct GeneralSearch {
+  bool active = false;
+  uint64_t start_ms = 0;
+  uint64_t first_result_ms = 0;
+  size_t num_results = 0;
+  size_t num_merged = 0;
+  // Identity addresses of the BR/EDR capable devices found
+  std::unordered_set<RawAddress> bredr_identities;
+  // Identity addresses of the devices name and service discovery ran for
+  std::unordered_set<RawAddress> discovered;
+} general_search;
+
 }  // namespace
 
 static void bta_dm_reset_sec_dev_pending(const RawAddress& remote_bd_addr);
@@ -562,6 +578,7 @@ static void bta_dm_process_remove_device_no_callback(
 
   /* remove all cached GATT information */
   BTA_GATTC_Refresh(bd_addr);
+  SDP_FlushDiscoveryCache(bd_addr);
 }
 
 void bta_dm_process_remove_device(const RawAddress& bd_addr) {
@@ -853,6 +870,10 @@ void bta_dm_search_start(tBTA_DM_MSG* p_data) {
   bta_dm_search_cb.p_search_cback = p_data->search.p_cback;
   bta_dm_search_cb.services = p_data->search.services;
 
+  general_search = {};
+  general_search.active = true;
+  general_search.start_ms = bluetooth::common::time_get_os_boottime_ms();
+
   result.status = BTM_StartInquiry(bta_dm_inq_results_cb, bta_dm_inq_cmpl_cb);
 
   APPL_TRACE_EVENT("%s status=%d", __func__, result.status);
@@ -985,6 +1006,75 @@ static bool bta_dm_read_remote_device_name(const RawAddress& bd_addr,
   }
 }
 
+/*******************************************************************************
+ *
+ * Function         bta_dm_search_identity_addr
+ *
+ * Description      Returns the address of the security record of a device
+ *                  found, so that its BR/EDR and LE results match, or the
+ *                  address it was found with when it has no record.
+ *
+ * Returns          RawAddress
+ *
+ ******************************************************************************/
+static RawAddress bta_dm_search_identity_addr(const RawAddress& bd_addr) {
+  tBTM_SEC_DEV_REC* p_dev_rec = btm_find_dev(bd_addr);
+  return (p_dev_rec != nullptr) ? p_dev_rec->bd_addr : bd_addr;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_dm_search_merge_results
+ *
+ * Description      Collects the identities of the BR/EDR capable devices of
+ *                  the inquiry database, which LE only results of the same
+ *                  devices are merged into.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_dm_search_merge_results(void) {
+  general_search.bredr_identities.clear();
+  general_search.discovered.clear();
+  for (tBTM_INQ_INFO* p_inq_info = BTM_InqDbFirst(); p_inq_info != nullptr;
+       p_inq_info = BTM_InqDbNext(p_inq_info)) {
+    if (p_inq_info->results.device_type & BT_DEVICE_TYPE_BREDR) {
+      general_search.bredr_identities.insert(bta_dm_search_identity_addr(
+          p_inq_info->results.remote_bd_addr));
+    }
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_dm_search_next_to_discover
+ *
+ * Description      Returns the first entry of the inquiry database from
+ *                  p_inq_info on that name and service discovery has to run
+ *                  for. Entries of devices already discovered under another
+ *                  address, and LE only entries of devices that were also
+ *                  found over BR/EDR, are skipped.
+ *
+ * Returns          tBTM_INQ_INFO*, or NULL when the end is reached
+ *
+ ******************************************************************************/
+static tBTM_INQ_INFO* bta_dm_search_next_to_discover(
+    tBTM_INQ_INFO* p_inq_info) {
+  for (; p_inq_info != nullptr; p_inq_info = BTM_InqDbNext(p_inq_info)) {
+    RawAddress identity =
+        bta_dm_search_identity_addr(p_inq_info->results.remote_bd_addr);
+    bool merged = (p_inq_info->results.device_type == BT_DEVICE_TYPE_BLE &&
+                   general_search.bredr_identities.count(identity) != 0) ||
+                  !general_search.discovered.insert(identity).second;
+    if (!merged) return p_inq_info;
+
+    VLOG(1) << __func__ << " " << p_inq_info->results.remote_bd_addr
+            << " already discovered as " << identity;
+    general_search.num_merged++;
+  }
+  return nullptr;
+}
+
 /*******************************************************************************
  *
  * Function         bta_dm_inq_cmpl
@@ -1012,7 +1102,9 @@ void bta_dm_inq_cmpl(uint8_t num) {
   data.inq_cmpl.num_resps = num;
   bta_dm_search_cb.p_search_cback(BTA_DM_INQ_CMPL_EVT, &data);
 
-  bta_dm_search_cb.p_btm_inq_info = BTM_InqDbFirst();
+  bta_dm_search_merge_results();
+  bta_dm_search_cb.p_btm_inq_info =
+      bta_dm_search_next_to_discover(BTM_InqDbFirst());
   if (bta_dm_search_cb.p_btm_inq_info != NULL) {
     /* start name and service discovery from the first device on inquiry result
      */
@@ -1291,6 +1383,21 @@ void bta_dm_sdp_result(tBTA_DM_MSG* p_data) {
 void bta_dm_search_cmpl() {
   bta_dm_search_set_state(BTA_DM_SEARCH_IDLE);
 
+  if (general_search.active) {
+    uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+    LOG_INFO(
+        "General search done in %llu ms, %zu results, first after %llu ms, "
+        "%zu devices merged into their BR/EDR or identity result",
+        static_cast<unsigned long long>(now_ms - general_search.start_ms),
+        general_search.num_results,
+        static_cast<unsigned long long>(
+            general_search.num_results > 0
+                ? general_search.first_result_ms - general_search.start_ms
+                : 0),
+        general_search.num_merged);
+    general_search = {};
+  }
+
   uint16_t conn_id = bta_dm_search_cb.conn_id;
 
   /* no BLE connection, i.e. Classic service discovery end */
@@ -1633,8 +1740,8 @@ static void bta_dm_discover_next_device(void) {
   APPL_TRACE_DEBUG("bta_dm_discover_next_device");
 
   /* searching next device on inquiry result */
-  bta_dm_search_cb.p_btm_inq_info =
-      BTM_InqDbNext(bta_dm_search_cb.p_btm_inq_info);
+  bta_dm_search_cb.p_btm_inq_info = bta_dm_search_next_to_discover(
+      BTM_InqDbNext(bta_dm_search_cb.p_btm_inq_info));
   if (bta_dm_search_cb.p_btm_inq_info != NULL) {
     bta_dm_search_cb.name_discover_done = false;
     bta_dm_search_cb.peer_name[0] = 0;
@@ -1837,6 +1944,11 @@ static void bta_dm_inq_results_cb(tBTM_INQ_RESULTS* p_inq, const uint8_t* p_eir,
     result.inq_res.remt_name_not_required = false;
   }
 
+  if (general_search.active && general_search.num_results++ == 0) {
+    general_search.first_result_ms =
+        bluetooth::common::time_get_os_boottime_ms();
+  }
+
   if (bta_dm_search_cb.p_search_cback)
     bta_dm_search_cb.p_search_cback(BTA_DM_INQ_RES_EVT, &result);
 
@@ -2473,6 +2585,7 @@ static void bta_dm_acl_down(const RawAddress& bd_addr,
 
       /* remove all cached GATT information */
       BTA_GATTC_Refresh(bd_addr);
+      SDP_FlushDiscoveryCache(bd_addr);
 
       APPL_TRACE_DEBUG("%s: Unpairing: issue unpair CB = %d ", __func__,
                        issue_unpair_cb);
@@ -2500,6 +2613,9 @@ static void bta_dm_acl_down(const RawAddress& bd_addr,
     bta_dm_cb.device_list.le_count--;
   }
 
+  /* The records of the peer may change before it connects again */
+  if (transport == BT_TRANSPORT_BR_EDR) SDP_FlushDiscoveryCache(bd_addr);
+
   if ((transport == BT_TRANSPORT_BR_EDR) &&
       (bta_dm_search_cb.wait_disc && bta_dm_search_cb.peer_bdaddr == bd_addr)) {
     bta_dm_search_cb.wait_disc = false;
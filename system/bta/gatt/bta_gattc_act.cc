@@ -29,6 +29,8 @@
 #include <base/logging.h>
 #include <base/strings/stringprintf.h>
 
+#include <algorithm>
+
 #include "bt_target.h"  // Must be first to define build configuration
 #include "bta/gatt/bta_gattc_int.h"
 #include "bta/hh/bta_hh_int.h"
@@ -657,6 +659,8 @@ void bta_gattc_close(tBTA_GATTC_CLCB* p_clcb, const tBTA_GATTC_DATA* p_data) {
 
 /** when a SRCB finished discovery, tell all related clcb */
 void bta_gattc_reset_discover_st(tBTA_GATTC_SERV* p_srcb, tGATT_STATUS status) {
+  if (status == GATT_SUCCESS) bta_gattc_cache_warmup_ready(p_srcb->server_bda);
+
   for (uint8_t i = 0; i < BTA_GATTC_CLCB_MAX; i++) {
     if (bta_gattc_cb.clcb[i].p_srcb == p_srcb) {
       bta_gattc_cb.clcb[i].status = status;
@@ -730,9 +734,21 @@ void bta_gattc_start_discover_internal(tBTA_GATTC_CLCB* p_clcb) {
   if (p_clcb->transport == BT_TRANSPORT_LE)
     L2CA_EnableUpdateBleConnParams(p_clcb->p_srcb->server_bda, false);
 
-  bta_gattc_init_cache(p_clcb->p_srcb);
-  p_clcb->status = bta_gattc_discover_pri_service(
-      p_clcb->bta_conn_id, p_clcb->p_srcb, GATT_DISC_SRVC_ALL);
+  tBTA_GATTC_SERV* p_srcb = p_clcb->p_srcb;
+  if (p_clcb->transport == BT_TRANSPORT_LE && p_srcb->disc_s_handle != 0 &&
+      !p_srcb->gatt_database.IsEmpty() &&
+      bta_gattc_is_scoped_rediscovery_enabled()) {
+    /* keep the cached services outside of the changed range */
+    gatt::Database cached = p_srcb->gatt_database;
+    bta_gattc_init_cache(p_srcb);
+    p_clcb->status =
+        bta_gattc_discover_changed_range(p_clcb->bta_conn_id, p_srcb, cached);
+  } else {
+    p_srcb->disc_s_handle = p_srcb->disc_e_handle = 0;
+    bta_gattc_init_cache(p_srcb);
+    p_clcb->status = bta_gattc_discover_pri_service(p_clcb->bta_conn_id, p_srcb,
+                                                    GATT_DISC_SRVC_ALL);
+  }
   if (p_clcb->status != GATT_SUCCESS) {
     LOG(ERROR) << "discovery on server failed";
     bta_gattc_reset_discover_st(p_clcb->p_srcb, p_clcb->status);
@@ -763,6 +779,15 @@ void bta_gattc_start_discover(tBTA_GATTC_CLCB* p_clcb,
       // 2. false, invoked by connect API
       bool is_svc_chg = p_clcb->p_srcb->srvc_hdl_chg;
 
+      /* the changed range, if any, is all there is to rediscover */
+      if (is_svc_chg) {
+        p_clcb->p_srcb->disc_s_handle = p_clcb->p_srcb->srvc_chg_s_handle;
+        p_clcb->p_srcb->disc_e_handle = p_clcb->p_srcb->srvc_chg_e_handle;
+      } else {
+        p_clcb->p_srcb->disc_s_handle = p_clcb->p_srcb->disc_e_handle = 0;
+      }
+      p_clcb->p_srcb->srvc_chg_s_handle = p_clcb->p_srcb->srvc_chg_e_handle = 0;
+
       /* clear the service change mask */
       p_clcb->p_srcb->srvc_hdl_chg = false;
       p_clcb->p_srcb->update_count = 0;
@@ -886,6 +911,7 @@ void bta_gattc_read_multi(tBTA_GATTC_CLCB* p_clcb,
 
   read_param.read_multiple.num_handles = p_data->api_read_multi.num_attr;
   read_param.read_multiple.auth_req = p_data->api_read_multi.auth_req;
+  read_param.read_multiple.variable_len = p_data->api_read_multi.variable_len;
   memcpy(&read_param.read_multiple.handles, p_data->api_read_multi.handles,
          sizeof(uint16_t) * p_data->api_read_multi.num_attr);
 
@@ -964,6 +990,24 @@ void bta_gattc_confirm(tBTA_GATTC_CLCB* p_clcb, const tBTA_GATTC_DATA* p_data) {
 /** read complete */
 static void bta_gattc_read_cmpl(tBTA_GATTC_CLCB* p_clcb,
                                 const tBTA_GATTC_OP_CMPL* p_data) {
+  if (p_clcb->p_q_cmd->hdr.event == BTA_GATTC_API_READ_MULTI_EVT) {
+    GATT_READ_MULTI_OP_CB cb = p_clcb->p_q_cmd->api_read_multi.read_multi_cb;
+    void* my_cb_data = p_clcb->p_q_cmd->api_read_multi.read_multi_cb_data;
+    tBTA_GATTC_MULTI handles;
+    handles.num_attr = p_clcb->p_q_cmd->api_read_multi.num_attr;
+    memcpy(handles.handles, p_clcb->p_q_cmd->api_read_multi.handles,
+           sizeof(uint16_t) * handles.num_attr);
+
+    osi_free_and_reset((void**)&p_clcb->p_q_cmd);
+
+    if (cb) {
+      cb(p_clcb->bta_conn_id, p_data->status, handles,
+         p_data->p_cmpl->att_value.len, p_data->p_cmpl->att_value.value,
+         my_cb_data);
+    }
+    return;
+  }
+
   GATT_READ_OP_CB cb = p_clcb->p_q_cmd->api_read.read_cb;
   void* my_cb_data = p_clcb->p_q_cmd->api_read.read_cb_data;
 
@@ -1076,8 +1120,13 @@ void bta_gattc_op_cmpl(tBTA_GATTC_CLCB* p_clcb, const tBTA_GATTC_DATA* p_data) {
       return;
   }
 
+  /* a read multiple completes as a read */
+  bool is_read_multi =
+      op == GATTC_OPTYPE_READ &&
+      p_clcb->p_q_cmd->hdr.event == BTA_GATTC_API_READ_MULTI_EVT;
   if (p_clcb->p_q_cmd->hdr.event !=
-      bta_gattc_opcode_to_int_evt[op - GATTC_OPTYPE_READ]) {
+          bta_gattc_opcode_to_int_evt[op - GATTC_OPTYPE_READ] &&
+      !is_read_multi) {
     uint8_t mapped_op =
         p_clcb->p_q_cmd->hdr.event - BTA_GATTC_API_READ_EVT + GATTC_OPTYPE_READ;
     if (mapped_op > GATTC_OPTYPE_INDICATION) mapped_op = 0;
@@ -1305,6 +1354,19 @@ static bool bta_gattc_process_srvc_chg_ind(uint16_t conn_id,
   LOG(ERROR) << __func__ << ": service changed s_handle=" << loghex(s_handle)
              << ", e_handle=" << loghex(e_handle);
 
+  /* widen the changed range of the indications pending discovery */
+  uint16_t chg_s_handle = s_handle, chg_e_handle = e_handle;
+  if (chg_s_handle == 0 || chg_s_handle > chg_e_handle) {
+    chg_s_handle = gatt::HANDLE_MIN;
+    chg_e_handle = gatt::HANDLE_MAX;
+  }
+  if (p_srcb->srvc_hdl_chg) {
+    chg_s_handle = std::min(chg_s_handle, p_srcb->srvc_chg_s_handle);
+    chg_e_handle = std::max(chg_e_handle, p_srcb->srvc_chg_e_handle);
+  }
+  p_srcb->srvc_chg_s_handle = chg_s_handle;
+  p_srcb->srvc_chg_e_handle = chg_e_handle;
+
   /* mark service handle change pending */
   p_srcb->srvc_hdl_chg = true;
   /* clear up all notification/indication registration */
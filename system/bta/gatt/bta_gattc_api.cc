@@ -452,18 +452,25 @@ void BTA_GATTC_ReadCharDescr(uint16_t conn_id, uint16_t handle,
  *
  * Parameters       conn_id - connectino ID.
  *                    p_read_multi - pointer to the read multiple parameter.
+ *                  variable_len - use the Read Multiple Variable Length
+ *                                 request.
+ *                  callback - called with the values once read.
  *
  * Returns          None
  *
  ******************************************************************************/
 void BTA_GATTC_ReadMultiple(uint16_t conn_id, tBTA_GATTC_MULTI* p_read_multi,
-                            tGATT_AUTH_REQ auth_req) {
+                            bool variable_len, tGATT_AUTH_REQ auth_req,
+                            GATT_READ_MULTI_OP_CB callback, void* cb_data) {
   tBTA_GATTC_API_READ_MULTI* p_buf =
       (tBTA_GATTC_API_READ_MULTI*)osi_calloc(sizeof(tBTA_GATTC_API_READ_MULTI));
 
   p_buf->hdr.event = BTA_GATTC_API_READ_MULTI_EVT;
   p_buf->hdr.layer_specific = conn_id;
   p_buf->auth_req = auth_req;
+  p_buf->variable_len = variable_len;
+  p_buf->read_multi_cb = callback;
+  p_buf->read_multi_cb_data = cb_data;
   p_buf->num_attr = p_read_multi->num_attr;
 
   if (p_buf->num_attr > 0)
@@ -760,3 +767,20 @@ void BTA_GATTC_Refresh(const RawAddress& remote_bda) {
   do_in_main_thread(FROM_HERE,
                     base::Bind(&bta_gattc_process_api_refresh, remote_bda));
 }
+
+/*******************************************************************************
+ *
+ * Function         BTA_GATTC_WarmupCache
+ *
+ * Description      Read the cached databases of the bonded devices ahead of
+ *                  their connection, off the main thread.
+ *
+ * Parameters       bonded_devices: BD addresses of the bonded devices.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void BTA_GATTC_WarmupCache(std::vector<RawAddress> bonded_devices) {
+  do_in_main_thread(FROM_HERE, base::BindOnce(&bta_gattc_cache_warmup,
+                                              std::move(bonded_devices)));
+}
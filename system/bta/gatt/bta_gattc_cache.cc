@@ -60,11 +60,14 @@ const Characteristic* bta_gattc_get_characteristic_srcb(tBTA_GATTC_SERV* p_srcb,
                                                         uint16_t handle);
 static void bta_gattc_explore_srvc_finished(uint16_t conn_id,
                                             tBTA_GATTC_SERV* p_srvc_cb);
+static void bta_gattc_save_discovered_db(tBTA_GATTC_CLCB* p_clcb);
 
 static void bta_gattc_read_db_hash_cmpl(tBTA_GATTC_CLCB* p_clcb,
                                         const tBTA_GATTC_OP_CMPL* p_data,
                                         bool is_svc_chg);
 
+static void bta_gattc_verify_db_hash_cmpl(tBTA_GATTC_CLCB* p_clcb,
+                                          const tBTA_GATTC_OP_CMPL* p_data);
 static void bta_gattc_read_ext_prop_desc_cmpl(tBTA_GATTC_CLCB* p_clcb,
                                               const tBTA_GATTC_OP_CMPL* p_data);
 
@@ -137,6 +140,45 @@ tGATT_STATUS bta_gattc_discover_pri_service(uint16_t conn_id,
   return bta_gattc_sdp_service_disc(conn_id, p_server_cb);
 }
 
+/** Start the discovery of the handle range changed on the server, keeping the
+ * services of |cached| outside of it */
+tGATT_STATUS bta_gattc_discover_changed_range(uint16_t conn_id,
+                                              tBTA_GATTC_SERV* p_server_cb,
+                                              const gatt::Database& cached) {
+  std::pair<uint16_t, uint16_t> range =
+      p_server_cb->pending_discovery.KeepServicesOutsideRange(
+          cached, p_server_cb->disc_s_handle, p_server_cb->disc_e_handle);
+  p_server_cb->disc_s_handle = range.first;
+  p_server_cb->disc_e_handle = range.second;
+
+  LOG_INFO("Rediscover handles 0x%04x-0x%04x only", range.first,
+           range.second);
+  return GATTC_Discover(conn_id, GATT_DISC_SRVC_ALL, range.first,
+                        range.second);
+}
+
+/** Read the database hash to check a database of which only a range was
+ * rediscovered. Returns false if the server has no database hash. */
+static bool bta_gattc_verify_db_hash(tBTA_GATTC_CLCB* p_clcb) {
+  const Uuid db_hash_uuid = Uuid::From16Bit(GATT_UUID_DATABASE_HASH);
+  for (const Service& service : p_clcb->p_srcb->gatt_database.Services()) {
+    for (const Characteristic& characteristic : service.characteristics) {
+      if (characteristic.uuid != db_hash_uuid) continue;
+
+      tGATT_READ_PARAM read_param{
+          .by_handle = {.handle = characteristic.value_handle,
+                        .auth_req = GATT_AUTH_REQ_NONE}};
+      if (GATTC_Read(p_clcb->bta_conn_id, GATT_READ_BY_HANDLE, &read_param) !=
+          GATT_SUCCESS) {
+        return false;
+      }
+      p_clcb->request_during_discovery = BTA_GATTC_DISCOVER_REQ_VERIFY_DB_HASH;
+      return true;
+    }
+  }
+  return false;
+}
+
 /** start exploring next service, or finish discovery if no more services left
  */
 static void bta_gattc_explore_next_service(uint16_t conn_id,
@@ -215,6 +257,23 @@ static void bta_gattc_explore_srvc_finished(uint16_t conn_id,
 #if (BTA_GATT_DEBUG == TRUE)
   bta_gattc_display_cache_server(p_srvc_cb->gatt_database);
 #endif
+
+  /* a range was rediscovered, check the result against the server */
+  if (p_srvc_cb->disc_s_handle != 0) {
+    p_srvc_cb->disc_s_handle = p_srvc_cb->disc_e_handle = 0;
+    if (bta_gattc_verify_db_hash(p_clcb)) {
+      // asynchronous continuation in bta_gattc_verify_db_hash_cmpl
+      return;
+    }
+  }
+
+  bta_gattc_save_discovered_db(p_clcb);
+}
+
+/** Save the discovered database and end the discovery */
+static void bta_gattc_save_discovered_db(tBTA_GATTC_CLCB* p_clcb) {
+  tBTA_GATTC_SERV* p_srvc_cb = p_clcb->p_srcb;
+
   /* save cache to NV */
   p_clcb->p_srcb->state = BTA_GATTC_SERV_SAVE;
 
@@ -236,7 +295,7 @@ static void bta_gattc_explore_srvc_finished(uint16_t conn_id,
 
     // After success, reset the count.
     LOG_DEBUG("service discovery succeed, reset count to zero, conn_id=0x%04x",
-              conn_id);
+              p_clcb->bta_conn_id);
     p_srvc_cb->srvc_disc_count = 0;
   }
 
@@ -387,6 +446,9 @@ void bta_gattc_op_cmpl_during_discovery(tBTA_GATTC_CLCB* p_clcb,
         p_clcb->request_during_discovery = BTA_GATTC_DISCOVER_REQ_NONE;
       }
       break;
+    case BTA_GATTC_DISCOVER_REQ_VERIFY_DB_HASH:
+      bta_gattc_verify_db_hash_cmpl(p_clcb, &p_data->op_cmpl);
+      break;
     case BTA_GATTC_DISCOVER_REQ_NONE:
     default:
       break;
@@ -733,6 +795,34 @@ static void bta_gattc_read_db_hash_cmpl(tBTA_GATTC_CLCB* p_clcb,
   }
 }
 
+/* handle response of reading database hash after a range rediscovery */
+static void bta_gattc_verify_db_hash_cmpl(tBTA_GATTC_CLCB* p_clcb,
+                                          const tBTA_GATTC_OP_CMPL* p_data) {
+  uint8_t op = (uint8_t)p_data->op_code;
+  if (op != GATTC_OPTYPE_READ) {
+    VLOG(1) << __func__ << ": op = " << +p_data->hdr.layer_specific;
+    return;
+  }
+
+  if (!p_clcb->disc_active) {
+    VLOG(1) << __func__ << ": not active in discover state";
+    return;
+  }
+  p_clcb->request_during_discovery = BTA_GATTC_DISCOVER_REQ_NONE;
+
+  const tGATT_VALUE& att_value = p_data->p_cmpl->att_value;
+  Octet16 local_hash = p_clcb->p_srcb->gatt_database.Hash();
+  if (p_data->status != GATT_SUCCESS || att_value.len != local_hash.size() ||
+      !std::equal(local_hash.begin(), local_hash.end(), att_value.value)) {
+    LOG_WARN("Database hash mismatch after range rediscovery, status=%d",
+             p_data->status);
+    bta_gattc_start_discover_internal(p_clcb);
+    return;
+  }
+
+  bta_gattc_save_discovered_db(p_clcb);
+}
+
 /* handle response of reading extended properties descriptor */
 static void bta_gattc_read_ext_prop_desc_cmpl(
     tBTA_GATTC_CLCB* p_clcb, const tBTA_GATTC_OP_CMPL* p_data) {
@@ -18,23 +18,32 @@
 
 #define LOG_TAG "bt_bta_gattc"
 
+#include <base/bind.h>
 #include <base/logging.h>
 #include <base/strings/string_number_conversions.h>
 #include <dirent.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
+#include <map>
 #include <string>
 #include <vector>
 
 #include "bta/gatt/bta_gattc_int.h"
+#include "common/message_loop_thread.h"
+#include "common/time_util.h"
 #include "osi/include/log.h"
+#include "stack/include/btu.h"  // do_in_main_thread
 
 using gatt::StoredAttribute;
 using std::string;
 using std::vector;
 
 #define GATT_CACHE_PREFIX "/data/misc/bluetooth/gatt_cache_"
-#define GATT_CACHE_VERSION 6
+#define GATT_CACHE_VERSION 7
 
 #define GATT_HASH_MAX_SIZE 30
 #define GATT_HASH_PATH_PREFIX "/data/misc/bluetooth/gatt_hash_"
@@ -44,7 +53,42 @@ using std::vector;
 // Default expired time is 7 days
 #define GATT_HASH_EXPIRED_TIME 604800
 
+/* Header of a GATT cache file. It is followed by |num_attr| StoredAttribute
+ * laid out exactly as in memory, so the file can be mapped and deserialized in
+ * place. */
+typedef struct {
+  uint16_t version;
+  uint16_t num_attr;
+  Octet16 hash;
+} tBTA_GATTC_CACHE_HDR;
+
+static_assert(sizeof(tBTA_GATTC_CACHE_HDR) % alignof(StoredAttribute) == 0,
+              "attributes following the cache header must stay aligned");
+
+/* Databases already loaded, indexed by hash. Devices with identical databases
+ * share an entry, so each database is read and deserialized only once. */
+static std::map<Octet16, gatt::Database> bta_gattc_loaded_dbs;
+
+/* Cache warmup run for the bonded devices at adapter enable, see
+ * bta_gattc_cache_warmup(). Only accessed from the main thread, the files are
+ * read on |bta_gattc_warmup_thread|. */
+static struct {
+  uint64_t start_us;
+  uint64_t end_us; /* 0 while the files are being read */
+  size_t num_devices;
+  size_t num_loaded;
+  /* databases read ahead and not handed to a connection yet */
+  std::map<RawAddress, gatt::Database> dbs;
+  /* time from the start of the warmup until each database was usable */
+  std::map<RawAddress, uint64_t> ready_us;
+} bta_gattc_warmup;
+
+static bluetooth::common::MessageLoopThread bta_gattc_warmup_thread(
+    "bt_gattc_warmup_thread");
+
 static void bta_gattc_hash_remove_least_recently_used_if_possible();
+static void bta_gattc_cache_warmup_done(
+    std::map<RawAddress, gatt::Database> dbs);
 
 static void bta_gattc_generate_cache_file_name(char* buffer, size_t buffer_len,
                                                const RawAddress& bda) {
@@ -65,58 +109,70 @@ static gatt::Database EMPTY_DB;
  *
  * Function         bta_gattc_load_db
  *
- * Description      Load GATT database from storage.
+ * Description      Load GATT database from storage. The file is mapped and its
+ *                  attributes deserialized in place, unless a database with the
+ *                  same hash was loaded already.
  *
  * Parameter        fname: input file name
+ *                  loaded_dbs: databases already loaded, indexed by hash
  *
  * Returns          non-empty GATT database on success, empty GATT database
  *                  otherwise
  *
  ******************************************************************************/
-static gatt::Database bta_gattc_load_db(const char* fname) {
-  FILE* fd = fopen(fname, "rb");
-  if (!fd) {
+static gatt::Database bta_gattc_load_db(
+    const char* fname, std::map<Octet16, gatt::Database>& loaded_dbs) {
+  int fd = open(fname, O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
     LOG(ERROR) << __func__ << ": can't open GATT cache file " << fname
                << " for reading, error: " << strerror(errno);
     return EMPTY_DB;
   }
 
-  uint16_t cache_ver = 0;
-  uint16_t num_attr = 0;
-
-  if (fread(&cache_ver, sizeof(uint16_t), 1, fd) != 1) {
-    LOG(ERROR) << __func__ << ": can't read GATT cache version from: " << fname;
-    goto done;
-  }
-
-  if (cache_ver != GATT_CACHE_VERSION) {
-    LOG(ERROR) << __func__ << ": wrong GATT cache version: " << fname;
-    goto done;
+  struct stat st;
+  if (fstat(fd, &st) == -1 ||
+      st.st_size < (off_t)sizeof(tBTA_GATTC_CACHE_HDR)) {
+    LOG(ERROR) << __func__ << ": can't read GATT cache header from: " << fname;
+    close(fd);
+    return EMPTY_DB;
   }
 
-  if (fread(&num_attr, sizeof(uint16_t), 1, fd) != 1) {
-    LOG(ERROR) << __func__
-               << ": can't read number of GATT attributes: " << fname;
-    goto done;
+  size_t size = st.st_size;
+  void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    LOG(ERROR) << __func__ << ": can't map GATT cache file " << fname
+               << ", error: " << strerror(errno);
+    return EMPTY_DB;
   }
 
-  {
-    std::vector<StoredAttribute> attr(num_attr);
-
-    if (fread(attr.data(), sizeof(StoredAttribute), num_attr, fd) != num_attr) {
-      LOG(ERROR) << __func__ << ": can't read GATT attributes: " << fname;
-      goto done;
+  gatt::Database result = EMPTY_DB;
+  const tBTA_GATTC_CACHE_HDR* hdr = (const tBTA_GATTC_CACHE_HDR*)map;
+  if (hdr->version != GATT_CACHE_VERSION) {
+    LOG(ERROR) << __func__ << ": wrong GATT cache version: " << fname;
+  } else if (size != sizeof(tBTA_GATTC_CACHE_HDR) +
+                         hdr->num_attr * sizeof(StoredAttribute)) {
+    LOG(ERROR) << __func__ << ": can't read GATT attributes: " << fname;
+  } else {
+    auto it = loaded_dbs.find(hdr->hash);
+    if (it != loaded_dbs.end()) {
+      result = it->second;
+    } else {
+      bool success = false;
+      gatt::Database db = gatt::Database::Deserialize(
+          (const StoredAttribute*)(hdr + 1), hdr->num_attr, &success);
+      if (success) {
+        if (loaded_dbs.size() >= GATT_HASH_MAX_SIZE) {
+          loaded_dbs.clear();
+        }
+        loaded_dbs.emplace(hdr->hash, db);
+        result = std::move(db);
+      }
     }
-    fclose(fd);
-
-    bool success = false;
-    gatt::Database result = gatt::Database::Deserialize(attr, &success);
-    return success ? result : EMPTY_DB;
   }
 
-done:
-  fclose(fd);
-  return EMPTY_DB;
+  munmap(map, size);
+  return result;
 }
 
 /*******************************************************************************
@@ -132,9 +188,16 @@ done:
  *
  ******************************************************************************/
 gatt::Database bta_gattc_cache_load(const RawAddress& server_bda) {
+  auto it = bta_gattc_warmup.dbs.find(server_bda);
+  if (it != bta_gattc_warmup.dbs.end()) {
+    gatt::Database db = std::move(it->second);
+    bta_gattc_warmup.dbs.erase(it);
+    return db;
+  }
+
   char fname[255] = {0};
   bta_gattc_generate_cache_file_name(fname, sizeof(fname), server_bda);
-  return bta_gattc_load_db(fname);
+  return bta_gattc_load_db(fname, bta_gattc_loaded_dbs);
 }
 
 /*******************************************************************************
@@ -152,7 +215,7 @@ gatt::Database bta_gattc_cache_load(const RawAddress& server_bda) {
 gatt::Database bta_gattc_hash_load(const Octet16& hash) {
   char fname[255] = {0};
   bta_gattc_generate_hash_file_name(fname, sizeof(fname), hash);
-  return bta_gattc_load_db(fname);
+  return bta_gattc_load_db(fname, bta_gattc_loaded_dbs);
 }
 
 /*******************************************************************************
@@ -162,12 +225,13 @@ gatt::Database bta_gattc_hash_load(const Octet16& hash) {
  * Description      Storess GATT db.
  *
  * Parameter        fname: output file name
+ *                  hash: hash of the database
  *                  attr: attributes to save.
  *
  * Returns          true on success, false otherwise
  *
  ******************************************************************************/
-static bool bta_gattc_store_db(const char* fname,
+static bool bta_gattc_store_db(const char* fname, const Octet16& hash,
                                const std::vector<StoredAttribute>& attr) {
   FILE* fd = fopen(fname, "wb");
   if (!fd) {
@@ -176,22 +240,16 @@ static bool bta_gattc_store_db(const char* fname,
     return false;
   }
 
-  uint16_t cache_ver = GATT_CACHE_VERSION;
-  if (fwrite(&cache_ver, sizeof(uint16_t), 1, fd) != 1) {
-    LOG(ERROR) << __func__ << ": can't write GATT cache version: " << fname;
-    fclose(fd);
-    return false;
-  }
+  // Lay the whole file out in memory so it is written at once.
+  std::vector<uint8_t> buf(sizeof(tBTA_GATTC_CACHE_HDR) +
+                           attr.size() * sizeof(StoredAttribute));
+  tBTA_GATTC_CACHE_HDR* hdr = (tBTA_GATTC_CACHE_HDR*)buf.data();
+  hdr->version = GATT_CACHE_VERSION;
+  hdr->num_attr = attr.size();
+  hdr->hash = hash;
+  memcpy(hdr + 1, attr.data(), attr.size() * sizeof(StoredAttribute));
 
-  uint16_t num_attr = attr.size();
-  if (fwrite(&num_attr, sizeof(uint16_t), 1, fd) != 1) {
-    LOG(ERROR) << __func__
-               << ": can't write GATT cache attribute count: " << fname;
-    fclose(fd);
-    return false;
-  }
-
-  if (fwrite(attr.data(), sizeof(StoredAttribute), num_attr, fd) != num_attr) {
+  if (fwrite(buf.data(), buf.size(), 1, fd) != 1) {
     LOG(ERROR) << __func__ << ": can't write GATT cache attributes: " << fname;
     fclose(fd);
     return false;
@@ -248,6 +306,7 @@ void bta_gattc_cache_link(const RawAddress& server_bda, const Octet16& hash) {
   bta_gattc_generate_cache_file_name(addr_file, sizeof(addr_file), server_bda);
   bta_gattc_generate_hash_file_name(hash_file, sizeof(hash_file), hash);
 
+  bta_gattc_warmup.dbs.erase(server_bda);
   unlink(addr_file);  // remove addr file first if the file exists
   if (link(hash_file, addr_file) == -1) {
     LOG_ERROR("link %s to %s, errno=%d", addr_file, hash_file, errno);
@@ -271,7 +330,7 @@ bool bta_gattc_hash_write(const Octet16& hash, const gatt::Database& database) {
   char fname[255] = {0};
   bta_gattc_generate_hash_file_name(fname, sizeof(fname), hash);
   bta_gattc_hash_remove_least_recently_used_if_possible();
-  return bta_gattc_store_db(fname, database.Serialize());
+  return bta_gattc_store_db(fname, hash, database.Serialize());
 }
 
 /*******************************************************************************
@@ -290,9 +349,149 @@ void bta_gattc_cache_reset(const RawAddress& server_bda) {
   VLOG(1) << __func__;
   char fname[255] = {0};
   bta_gattc_generate_cache_file_name(fname, sizeof(fname), server_bda);
+  bta_gattc_warmup.dbs.erase(server_bda);
   unlink(fname);
 }
 
+/*******************************************************************************
+ *
+ * Function         bta_gattc_cache_prefetch
+ *
+ * Description      Read and validate the cached databases of |devices|. Runs
+ *                  on the warmup thread and hands the result to the main
+ *                  thread.
+ *
+ ******************************************************************************/
+static void bta_gattc_cache_prefetch(std::vector<RawAddress> devices) {
+  std::map<Octet16, gatt::Database> loaded_dbs;
+  std::map<RawAddress, gatt::Database> dbs;
+
+  for (const RawAddress& bda : devices) {
+    char fname[255] = {0};
+    bta_gattc_generate_cache_file_name(fname, sizeof(fname), bda);
+    // Not every bonded device is a GATT server we discovered.
+    if (access(fname, F_OK) != 0) continue;
+
+    gatt::Database db = bta_gattc_load_db(fname, loaded_dbs);
+    if (!db.IsEmpty()) dbs.emplace(bda, std::move(db));
+  }
+
+  do_in_main_thread(FROM_HERE, base::BindOnce(&bta_gattc_cache_warmup_done,
+                                              std::move(dbs)));
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_gattc_cache_warmup
+ *
+ * Description      Read the cached databases of the bonded devices ahead of
+ *                  their connection, off the main thread. A database read this
+ *                  way is returned by the next bta_gattc_cache_load() for the
+ *                  device.
+ *
+ * Parameter        devices: bonded devices
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_gattc_cache_warmup(std::vector<RawAddress> devices) {
+  if (bta_gattc_warmup_thread.IsRunning()) {
+    LOG_WARN("cache warmup already running");
+    return;
+  }
+
+  bta_gattc_warmup.start_us = bluetooth::common::time_get_os_boottime_us();
+  bta_gattc_warmup.end_us = 0;
+  bta_gattc_warmup.num_devices = devices.size();
+  bta_gattc_warmup.num_loaded = 0;
+  bta_gattc_warmup.dbs.clear();
+  bta_gattc_warmup.ready_us.clear();
+
+  bta_gattc_warmup_thread.StartUp();
+  if (!bta_gattc_warmup_thread.DoInThread(
+          FROM_HERE,
+          base::BindOnce(&bta_gattc_cache_prefetch, std::move(devices)))) {
+    LOG_ERROR("unable to start cache warmup");
+    bta_gattc_warmup_thread.ShutDown();
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_gattc_cache_warmup_done
+ *
+ * Description      Keep the databases read by the warmup until the devices
+ *                  connect.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_gattc_cache_warmup_done(
+    std::map<RawAddress, gatt::Database> dbs) {
+  bta_gattc_warmup_thread.ShutDown();
+
+  bta_gattc_warmup.end_us = bluetooth::common::time_get_os_boottime_us();
+  bta_gattc_warmup.num_loaded = dbs.size();
+  for (auto& entry : dbs) {
+    // A device that connected meanwhile already has its database.
+    if (bta_gattc_warmup.ready_us.count(entry.first) != 0) continue;
+    bta_gattc_warmup.dbs.insert(std::move(entry));
+  }
+  LOG_INFO("read %zu of %zu cached databases in %" PRIu64 " ms",
+           bta_gattc_warmup.num_loaded, bta_gattc_warmup.num_devices,
+           (bta_gattc_warmup.end_us - bta_gattc_warmup.start_us) / 1000);
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_gattc_cache_warmup_ready
+ *
+ * Description      Record that the database of |server_bda| is usable, either
+ *                  loaded from the cache or discovered.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_gattc_cache_warmup_ready(const RawAddress& server_bda) {
+  if (bta_gattc_warmup.start_us == 0) return;
+
+  bta_gattc_warmup.ready_us.emplace(
+      server_bda, bluetooth::common::time_get_os_boottime_us() -
+                      bta_gattc_warmup.start_us);
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_debug_gattc_cache_dump
+ *
+ * Description      Dump the result of the cache warmup.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_debug_gattc_cache_dump(int fd) {
+  dprintf(fd, "\nGATT client cache warmup:\n");
+  if (bta_gattc_warmup.start_us == 0) {
+    dprintf(fd, "\tnot run\n");
+    return;
+  }
+
+  dprintf(fd, "\tbonded devices: %zu, cached databases read: %zu\n",
+          bta_gattc_warmup.num_devices, bta_gattc_warmup.num_loaded);
+  if (bta_gattc_warmup.end_us == 0) {
+    dprintf(fd, "\treading cached databases\n");
+  } else {
+    dprintf(fd, "\tread in: %" PRIu64 " ms\n",
+            (bta_gattc_warmup.end_us - bta_gattc_warmup.start_us) / 1000);
+  }
+  dprintf(fd, "\tread ahead, not connected yet: %zu\n",
+          bta_gattc_warmup.dbs.size());
+  for (const auto& entry : bta_gattc_warmup.ready_us) {
+    dprintf(fd, "\t * %s: usable after %" PRIu64 " ms\n",
+            entry.first.ToString().c_str(), entry.second / 1000);
+  }
+}
+
 /*******************************************************************************
  *
  * Function         bta_gattc_hash_remove_least_recently_used_if_possible
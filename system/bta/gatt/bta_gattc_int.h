@@ -150,8 +150,11 @@ typedef struct {
 typedef struct {
   BT_HDR_RIGID hdr;
   tGATT_AUTH_REQ auth_req;
+  bool variable_len;
   uint8_t num_attr;
   uint16_t handles[GATT_MAX_READ_MULTI_HANDLES];
+  GATT_READ_MULTI_OP_CB read_multi_cb;
+  void* read_multi_cb_data;
 } tBTA_GATTC_API_READ_MULTI;
 
 typedef struct {
@@ -219,6 +222,12 @@ typedef struct {
   uint8_t srvc_hdl_chg; /* service handle change indication pending */
   bool srvc_hdl_db_hash;   /* read db hash pending */
   uint8_t srvc_disc_count; /* current discovery retry count */
+  /* handle range of the pending service change indications, and the range
+   * being rediscovered, 0 when the whole database is */
+  uint16_t srvc_chg_s_handle;
+  uint16_t srvc_chg_e_handle;
+  uint16_t disc_s_handle;
+  uint16_t disc_e_handle;
   uint16_t attr_index;  /* cahce NV saving/loading attribute index */
 
   uint16_t mtu;
@@ -260,6 +269,7 @@ typedef struct {
 #define BTA_GATTC_DISCOVER_REQ_READ_EXT_PROP_DESC 1
 #define BTA_GATTC_DISCOVER_REQ_READ_DB_HASH 2
 #define BTA_GATTC_DISCOVER_REQ_READ_DB_HASH_FOR_SVC_CHG 3
+#define BTA_GATTC_DISCOVER_REQ_VERIFY_DB_HASH 4
 
   uint8_t request_during_discovery; /* request during discover state */
 
@@ -440,6 +450,7 @@ extern void bta_gattc_clear_notif_registration(tBTA_GATTC_SERV* p_srcb,
                                                uint16_t end_handle);
 extern tBTA_GATTC_SERV* bta_gattc_find_srvr_cache(const RawAddress& bda);
 extern bool bta_gattc_is_robust_caching_enabled();
+extern bool bta_gattc_is_scoped_rediscovery_enabled();
 
 /* discovery functions */
 extern void bta_gattc_disc_res_cback(uint16_t conn_id,
@@ -451,6 +462,9 @@ extern void bta_gattc_disc_cmpl_cback(uint16_t conn_id,
 extern tGATT_STATUS bta_gattc_discover_pri_service(uint16_t conn_id,
                                                    tBTA_GATTC_SERV* p_server_cb,
                                                    tGATT_DISC_TYPE disc_type);
+extern tGATT_STATUS bta_gattc_discover_changed_range(
+    uint16_t conn_id, tBTA_GATTC_SERV* p_server_cb,
+    const gatt::Database& cached);
 extern void bta_gattc_search_service(tBTA_GATTC_CLCB* p_clcb,
                                      bluetooth::Uuid* p_uuid);
 extern const std::list<gatt::Service>* bta_gattc_get_services(uint16_t conn_id);
@@ -491,5 +505,7 @@ extern void bta_gattc_cache_write(const RawAddress& server_bda,
 extern void bta_gattc_cache_link(const RawAddress& server_bda,
                                  const Octet16& hash);
 extern void bta_gattc_cache_reset(const RawAddress& server_bda);
+extern void bta_gattc_cache_warmup(std::vector<RawAddress> devices);
+extern void bta_gattc_cache_warmup_ready(const RawAddress& server_bda);
 
 #endif /* BTA_GATTC_INT_H */
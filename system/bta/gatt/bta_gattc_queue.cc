@@ -21,6 +21,8 @@
 #include <unordered_set>
 
 #include "osi/include/allocator.h"
+#include "stack/include/bt_types.h"
+#include "stack/include/gatt_api.h"
 
 #include <base/logging.h>
 
@@ -63,6 +65,65 @@ void BtaGattQueue::gatt_read_op_finished(uint16_t conn_id, tGATT_STATUS status,
   }
 }
 
+struct gatt_read_multi_op_data {
+  uint8_t types[GATT_MAX_READ_MULTI_HANDLES];
+  gatt_read_op_data ops[GATT_MAX_READ_MULTI_HANDLES];
+};
+
+void BtaGattQueue::gatt_read_multi_op_finished(uint16_t conn_id,
+                                               tGATT_STATUS status,
+                                               tBTA_GATTC_MULTI& handles,
+                                               uint16_t len, uint8_t* value,
+                                               void* data) {
+  gatt_read_multi_op_data tmp = *(gatt_read_multi_op_data*)data;
+  osi_free(data);
+
+  /* Each value is preceded by its length. The response is truncated to the
+   * MTU, so the last values might be missing or incomplete. */
+  uint16_t lens[GATT_MAX_READ_MULTI_HANDLES];
+  uint8_t* values[GATT_MAX_READ_MULTI_HANDLES];
+  uint8_t num_read = 0;
+  if (status == GATT_SUCCESS) {
+    uint8_t* p = value;
+    uint16_t remaining = len;
+    while (num_read < handles.num_attr && remaining >= 2) {
+      uint16_t attr_len;
+      STREAM_TO_UINT16(attr_len, p);
+      remaining -= 2;
+      if (attr_len > remaining) break;
+
+      lens[num_read] = attr_len;
+      values[num_read] = p;
+      num_read++;
+      p += attr_len;
+      remaining -= attr_len;
+    }
+  }
+
+  /* A failed read multiple does not tell which reads would succeed, read the
+   * values not received one by one */
+  auto map_ptr = gatt_op_queue.find(conn_id);
+  if (map_ptr != gatt_op_queue.end()) {
+    for (uint8_t i = handles.num_attr; i > num_read; i--) {
+      map_ptr->second.push_front({.type = tmp.types[i - 1],
+                                  .handle = handles.handles[i - 1],
+                                  .read_cb = tmp.ops[i - 1].cb,
+                                  .read_cb_data = tmp.ops[i - 1].cb_data,
+                                  .read_alone = true});
+    }
+  }
+
+  mark_as_not_executing(conn_id);
+  gatt_execute_next_op(conn_id);
+
+  for (uint8_t i = 0; i < num_read; i++) {
+    if (tmp.ops[i].cb) {
+      tmp.ops[i].cb(conn_id, GATT_SUCCESS, handles.handles[i], lens[i],
+                    values[i], tmp.ops[i].cb_data);
+    }
+  }
+}
+
 struct gatt_write_op_data {
   GATT_WRITE_OP_CB cb;
   void* cb_data;
@@ -134,6 +195,11 @@ void BtaGattQueue::gatt_execute_next_op(uint16_t conn_id) {
 
   gatt_operation& op = gatt_ops.front();
 
+  if ((op.type == GATT_READ_CHAR || op.type == GATT_READ_DESC) &&
+      gatt_execute_read_multi(conn_id, gatt_ops)) {
+    return;
+  }
+
   if (op.type == GATT_READ_CHAR) {
     gatt_read_op_data* data =
         (gatt_read_op_data*)osi_malloc(sizeof(gatt_read_op_data));
@@ -179,6 +245,41 @@ void BtaGattQueue::gatt_execute_next_op(uint16_t conn_id) {
   gatt_ops.pop_front();
 }
 
+/* Read the values of the consecutive reads at the front of |gatt_ops| at once,
+ * returns false if there are not at least two reads to merge */
+bool BtaGattQueue::gatt_execute_read_multi(
+    uint16_t conn_id, std::list<gatt_operation>& gatt_ops) {
+  auto end = gatt_ops.begin();
+  uint8_t num_attr = 0;
+  while (end != gatt_ops.end() && num_attr < GATT_MAX_READ_MULTI_HANDLES &&
+         (end->type == GATT_READ_CHAR || end->type == GATT_READ_DESC) &&
+         !end->read_alone) {
+    end++;
+    num_attr++;
+  }
+
+  if (num_attr < 2 || !GATTC_IsReadMultiVarLenSupported(conn_id)) return false;
+
+  gatt_read_multi_op_data* data =
+      (gatt_read_multi_op_data*)osi_malloc(sizeof(gatt_read_multi_op_data));
+  tBTA_GATTC_MULTI handles;
+  handles.num_attr = 0;
+  for (auto it = gatt_ops.begin(); it != end; it++) {
+    data->types[handles.num_attr] = it->type;
+    data->ops[handles.num_attr].cb = it->read_cb;
+    data->ops[handles.num_attr].cb_data = it->read_cb_data;
+    handles.handles[handles.num_attr++] = it->handle;
+  }
+  gatt_ops.erase(gatt_ops.begin(), end);
+
+  APPL_TRACE_DEBUG("%s: conn_id=0x%x, merged %d reads", __func__, conn_id,
+                   handles.num_attr);
+  BTA_GATTC_ReadMultiple(conn_id, &handles, true /* variable_len */,
+                         GATT_AUTH_REQ_NONE, gatt_read_multi_op_finished,
+                         data);
+  return true;
+}
+
 void BtaGattQueue::Clean(uint16_t conn_id) {
   gatt_op_queue.erase(conn_id);
   gatt_op_queue_executing.erase(conn_id);
@@ -31,6 +31,7 @@
 #include "device/include/controller.h"
 #include "gd/common/init_flags.h"
 #include "osi/include/allocator.h"
+#include "osi/include/properties.h"
 #include "types/bt_transport.h"
 #include "types/hci_role.h"
 #include "types/raw_address.h"
@@ -679,3 +680,10 @@ tBTA_GATTC_CLCB* bta_gattc_find_int_disconn_clcb(tBTA_GATTC_DATA* p_msg) {
 bool bta_gattc_is_robust_caching_enabled() {
   return bluetooth::common::init_flags::gatt_robust_caching_client_is_enabled();
 }
+
+/* Whether a service change rediscovers only the changed handle range */
+bool bta_gattc_is_scoped_rediscovery_enabled() {
+  static const bool enabled = osi_property_get_bool(
+      "bluetooth.gatt.scoped_rediscovery.enabled", false);
+  return enabled;
+}
@@ -141,6 +141,32 @@ void DatabaseBuilder::AddDescriptor(uint16_t handle, const Uuid& uuid) {
   }
 }
 
+std::pair<uint16_t, uint16_t> DatabaseBuilder::KeepServicesOutsideRange(
+    const Database& cached, uint16_t start_handle, uint16_t end_handle) {
+  bool widened = true;
+  while (widened) {
+    widened = false;
+    for (const Service& service : cached.services) {
+      if (service.handle > end_handle || service.end_handle < start_handle)
+        continue;
+      if (service.handle < start_handle || service.end_handle > end_handle) {
+        start_handle = std::min(start_handle, service.handle);
+        end_handle = std::max(end_handle, service.end_handle);
+        widened = true;
+      }
+    }
+  }
+
+  // Services are sorted, and kept ones are not added to services_to_discover
+  for (const Service& service : cached.services) {
+    if (service.handle > end_handle || service.end_handle < start_handle) {
+      database.services.push_back(service);
+    }
+  }
+
+  return {start_handle, end_handle};
+}
+
 bool DatabaseBuilder::StartNextServiceExploration() {
   while (!services_to_discover.empty()) {
     auto handle_range = services_to_discover.begin();
@@ -38,6 +38,14 @@ class DatabaseBuilder {
                          const bluetooth::Uuid& uuid, uint8_t properties);
   void AddDescriptor(uint16_t handle, const bluetooth::Uuid& uuid);
 
+  /* Keep the services of |database| lying outside of the handle range from
+   * |start_handle| to |end_handle|, so that only that range is left to
+   * discover. The range is widened to cover the services it overlaps.
+   * Returns the widened range.
+   */
+  std::pair<uint16_t, uint16_t> KeepServicesOutsideRange(
+      const Database& database, uint16_t start_handle, uint16_t end_handle);
+
   /* Returns true if next service exploration started, false if there are no
    * more services to explore. */
   bool StartNextServiceExploration();
@@ -440,6 +440,7 @@ class HasClientImpl : public HasClient {
                                     ErrorCode::OPERATION_NOT_SUPPORTED);
     }
 
+    device->is_reading_all_presets = device->isGattServiceValid();
     auto context = HasGattOpContext(operation);
 
     /* Journal update */
@@ -459,7 +460,8 @@ class HasClientImpl : public HasClient {
   }
 
   ErrorCode CpPresetIndexOperationWriteReq(HasDevice& device,
-                                           HasCtpOp& operation) {
+                                           HasCtpOp& operation,
+                                           bool check_only = false) {
     DLOG(INFO) << __func__ << " Operation: " << operation;
 
     if (!device.IsConnected()) return ErrorCode::OPERATION_NOT_POSSIBLE;
@@ -474,6 +476,8 @@ class HasClientImpl : public HasClient {
     if (!device.IsValidPreset(operation.index))
       return ErrorCode::INVALID_PRESET_INDEX;
 
+    if (check_only) return ErrorCode::NO_ERROR;
+
     auto context = HasGattOpContext(operation);
 
     /* Journal update */
@@ -507,7 +511,8 @@ class HasClientImpl : public HasClient {
 
   ErrorCode CpPresetOperationCaller(
       HasCtpOp operation,
-      std::function<ErrorCode(HasDevice& device, HasCtpOp& operation)>
+      std::function<ErrorCode(HasDevice& device, HasCtpOp& operation,
+                              bool check_only)>
           write_cb) {
     DLOG(INFO) << __func__ << " Operation: " << operation;
     auto status = ErrorCode::NO_ERROR;
@@ -544,7 +549,7 @@ class HasClientImpl : public HasClient {
               auto device = std::find_if(devices_.begin(), devices_.end(),
                                          HasDevice::MatchAddress(addr));
               if (device != devices_.end()) {
-                status = write_cb(*device, operation);
+                status = write_cb(*device, operation, false);
                 if (status == ErrorCode::NO_ERROR) {
                   was_sent = true;
                   break;
@@ -556,13 +561,21 @@ class HasClientImpl : public HasClient {
           } else {
             status = ErrorCode::GROUP_OPERATION_NOT_SUPPORTED;
 
-            for (auto& addr : addresses) {
-              auto device = std::find_if(devices_.begin(), devices_.end(),
-                                         HasDevice::MatchAddress(addr));
-              if (device != devices_.end()) {
-                status = write_cb(*device, operation);
-                if (status != ErrorCode::NO_ERROR) break;
+            /* Check the operation on all the set members before writing, so
+             * it is never applied to a part of the set. The writes then go
+             * to the GATT queues of all the members at once and the devices
+             * process them in parallel.
+             */
+            for (auto check_only : {true, false}) {
+              for (auto& addr : addresses) {
+                auto device = std::find_if(devices_.begin(), devices_.end(),
+                                           HasDevice::MatchAddress(addr));
+                if (device != devices_.end()) {
+                  status = write_cb(*device, operation, check_only);
+                  if (status != ErrorCode::NO_ERROR) break;
+                }
               }
+              if (status != ErrorCode::NO_ERROR) break;
             }
           }
 
@@ -578,7 +591,8 @@ class HasClientImpl : public HasClient {
                                  HasDevice::MatchAddress(std::get<RawAddress>(
                                      operation.addr_or_group)));
       status = ErrorCode::OPERATION_NOT_POSSIBLE;
-      if (device != devices_.end()) status = write_cb(*device, operation);
+      if (device != devices_.end())
+        status = write_cb(*device, operation, false);
     }
 
     return status;
@@ -588,9 +602,12 @@ class HasClientImpl : public HasClient {
     LOG(INFO) << __func__ << " Operation: " << operation;
 
     auto status = CpPresetOperationCaller(
-        operation, [](HasDevice& device, HasCtpOp operation) -> ErrorCode {
+        operation,
+        [](HasDevice& device, HasCtpOp operation,
+           bool check_only) -> ErrorCode {
           if (instance)
-            return instance->CpPresetIndexOperationWriteReq(device, operation);
+            return instance->CpPresetIndexOperationWriteReq(device, operation,
+                                                            check_only);
           return ErrorCode::OPERATION_NOT_POSSIBLE;
         });
 
@@ -617,7 +634,8 @@ class HasClientImpl : public HasClient {
   }
 
   ErrorCode CpPresetsCycleOperationWriteReq(HasDevice& device,
-                                            HasCtpOp& operation) {
+                                            HasCtpOp& operation,
+                                            bool check_only = false) {
     DLOG(INFO) << __func__ << " addr: " << device.addr
                << " operation: " << operation;
 
@@ -630,6 +648,8 @@ class HasClientImpl : public HasClient {
                  ? ErrorCode::GROUP_OPERATION_NOT_SUPPORTED
                  : ErrorCode::OPERATION_NOT_SUPPORTED;
 
+    if (check_only) return ErrorCode::NO_ERROR;
+
     auto context = HasGattOpContext(operation);
 
     /* Journal update */
@@ -653,9 +673,12 @@ class HasClientImpl : public HasClient {
     DLOG(INFO) << __func__ << " Operation: " << operation;
 
     auto status = CpPresetOperationCaller(
-        operation, [](HasDevice& device, HasCtpOp operation) -> ErrorCode {
+        operation,
+        [](HasDevice& device, HasCtpOp operation,
+           bool check_only) -> ErrorCode {
           if (instance)
-            return instance->CpPresetsCycleOperationWriteReq(device, operation);
+            return instance->CpPresetsCycleOperationWriteReq(device, operation,
+                                                             check_only);
           return ErrorCode::OPERATION_NOT_POSSIBLE;
         });
 
@@ -664,7 +687,8 @@ class HasClientImpl : public HasClient {
   }
 
   ErrorCode CpWritePresetNameOperationWriteReq(HasDevice& device,
-                                               HasCtpOp operation) {
+                                               HasCtpOp operation,
+                                               bool check_only = false) {
     DLOG(INFO) << __func__ << " addr: " << device.addr
                << " operation: " << operation;
 
@@ -684,6 +708,8 @@ class HasClientImpl : public HasClient {
         le_audio::has::HasPreset::kPresetNameLengthLimit)
       return ErrorCode::INVALID_PRESET_NAME_LENGTH;
 
+    if (check_only) return ErrorCode::NO_ERROR;
+
     auto context = HasGattOpContext(operation, operation.index);
 
     /* Journal update */
@@ -731,17 +757,22 @@ class HasClientImpl : public HasClient {
       addresses.clear();
     }
 
-    for (auto& addr : addresses) {
-      auto device = std::find_if(devices_.begin(), devices_.end(),
-                                 HasDevice::MatchAddress(addr));
-      if (device != devices_.end()) {
-        status = CpWritePresetNameOperationWriteReq(*device, operation);
-        if (status != ErrorCode::NO_ERROR) {
-          LOG(ERROR) << __func__
-                     << " Control point write error: " << (int)status;
-          break;
+    /* Like the other group operations, check all the devices first */
+    for (auto check_only : {true, false}) {
+      for (auto& addr : addresses) {
+        auto device = std::find_if(devices_.begin(), devices_.end(),
+                                   HasDevice::MatchAddress(addr));
+        if (device != devices_.end()) {
+          status =
+              CpWritePresetNameOperationWriteReq(*device, operation, check_only);
+          if (status != ErrorCode::NO_ERROR) {
+            LOG(ERROR) << __func__
+                       << " Control point write error: " << (int)status;
+            break;
+          }
         }
       }
+      if (status != ErrorCode::NO_ERROR) break;
     }
 
     if (status != ErrorCode::NO_ERROR) {
@@ -920,14 +951,32 @@ class HasClientImpl : public HasClient {
                                 device.active_preset_ccc_handle);
     }
 
-    if (osi_property_get_bool("persist.bluetooth.has.always_use_preset_cache",
-                              true) == false) {
+    if (!device.SupportsPresets()) return;
+
+    /* The server notifies the bonded client about the preset changes made
+     * while it was disconnected, so the cached presets are used right away.
+     * Only the servers with dynamic presets can change the list on their own,
+     * and have it validated by a single Read Presets request. The response is
+     * compared with the cache, which is replaced only if they differ.
+     */
+    if ((osi_property_get_bool("persist.bluetooth.has.always_use_preset_cache",
+                               true) == false) ||
+        (device.GetFeatures() & bluetooth::has::kFeatureBitDynamicPresets)) {
       CpReadAllPresetsOperation(HasCtpOp(
           device.addr, PresetCtpOpcode::READ_PRESETS,
           le_audio::has::kStartPresetIndex, le_audio::has::kMaxNumOfPresets));
     }
   }
 
+  void StorePresets(HasDevice& device) {
+    ++device.presets_change_counter;
+
+    std::vector<uint8_t> presets_bin;
+    if (device.SerializePresets(presets_bin)) {
+      btif_storage_set_leaudio_has_presets(device.addr, presets_bin);
+    }
+  }
+
   void OnEncrypted(HasDevice& device) {
     DLOG(INFO) << __func__ << ": " << device.addr;
 
@@ -1124,6 +1173,11 @@ class HasClientImpl : public HasClient {
   void OnHasPresetReadResponseNotification(HasDevice& device) {
     DLOG(INFO) << __func__;
 
+    /* All the presets read again are compared with the ones we had */
+    auto is_reading_all_presets = device.is_reading_all_presets;
+    std::set<HasPreset, HasPreset::ComparatorDesc> read_presets;
+    if (is_reading_all_presets) device.is_reading_all_presets = false;
+
     while (device.ctp_notifications_.size() != 0) {
       auto ntf = device.ctp_notifications_.front();
       /* Process only read response events */
@@ -1131,14 +1185,16 @@ class HasClientImpl : public HasClient {
 
       /* Update preset values */
       if (ntf.preset.has_value()) {
-        device.has_presets.erase(ntf.preset->GetIndex());
-        device.has_presets.insert(ntf.preset.value());
+        auto& presets =
+            is_reading_all_presets ? read_presets : device.has_presets;
+        presets.erase(ntf.preset->GetIndex());
+        presets.insert(ntf.preset.value());
       }
 
-      /* We currently do READ_ALL_PRESETS only during the service validation.
-       * If service is already valid, this must be the READ_PRESET_BY_INDEX.
+      /* Besides the service validation and the cache validation, the only
+       * read is the READ_PRESET_BY_INDEX.
        */
-      if (device.isGattServiceValid()) {
+      if (device.isGattServiceValid() && !is_reading_all_presets) {
         auto info = device.GetPresetInfo(ntf.preset.value().GetIndex());
         if (info.has_value())
           callbacks_->OnPresetInfo(
@@ -1154,8 +1210,23 @@ class HasClientImpl : public HasClient {
     auto in_svc_validation = !device.isGattServiceValid();
     MarkDeviceValidIfInInitialDiscovery(device);
 
-    /* We currently do READ_ALL_PRESETS only during the service validation.
-     * ALL_PRESET_INFO will be sent only during this initial phase.
+    if (is_reading_all_presets) {
+      if (read_presets == device.has_presets) {
+        DLOG(INFO) << __func__ << " Cached presets are up to date";
+        return;
+      }
+
+      LOG_WARN("%s: cached presets are stale, replacing them",
+               device.addr.ToString().c_str());
+      device.has_presets = std::move(read_presets);
+      StorePresets(device);
+      callbacks_->OnPresetInfo(device.addr, PresetInfoReason::ALL_PRESET_INFO,
+                               device.GetAllPresetInfo());
+      return;
+    }
+
+    /* ALL_PRESET_INFO is sent during the service validation, or when the
+     * cached presets were found stale.
      */
     if (in_svc_validation) {
       callbacks_->OnPresetInfo(device.addr, PresetInfoReason::ALL_PRESET_INFO,
@@ -1218,10 +1289,7 @@ class HasClientImpl : public HasClient {
 
     if (device.isGattServiceValid()) {
       /* Update preset values in the storage */
-      std::vector<uint8_t> presets_bin;
-      if (device.SerializePresets(presets_bin)) {
-        btif_storage_set_leaudio_has_presets(device.addr, presets_bin);
-      }
+      StorePresets(device);
 
       /* Check for the matching coordinated group op. to use group callbacks */
       for (auto it = pending_group_operation_timeouts_.rbegin();
@@ -1316,12 +1384,7 @@ class HasClientImpl : public HasClient {
     }
 
     /* Update preset storage */
-    if (device.isGattServiceValid()) {
-      std::vector<uint8_t> presets_bin;
-      if (device.SerializePresets(presets_bin)) {
-        btif_storage_set_leaudio_has_presets(device.addr, presets_bin);
-      }
-    }
+    if (device.isGattServiceValid()) StorePresets(device);
 
     callbacks_->OnPresetInfo(
         device.addr, PresetInfoReason::PRESET_AVAILABILITY_CHANGED, infos);
@@ -1356,12 +1419,7 @@ class HasClientImpl : public HasClient {
     }
 
     /* Update preset storage */
-    if (device.isGattServiceValid()) {
-      std::vector<uint8_t> presets_bin;
-      if (device.SerializePresets(presets_bin)) {
-        btif_storage_set_leaudio_has_presets(device.addr, presets_bin);
-      }
-    }
+    if (device.isGattServiceValid()) StorePresets(device);
 
     if (is_deleted)
       callbacks_->OnPresetInfo(device.addr, PresetInfoReason::PRESET_DELETED,
@@ -1411,6 +1411,111 @@ TEST_F(HasClientTest, test_load_from_storage_and_connect) {
   }
 }
 
+TEST_F(HasClientTest, test_load_from_storage_dynamic_presets_up_to_date) {
+  const RawAddress test_address = GetTestAddress(1);
+  std::set<HasPreset, HasPreset::ComparatorDesc> has_presets = {{
+      HasPreset(6, HasPreset::kPropertyAvailable, "Universal"),
+      HasPreset(55, HasPreset::kPropertyAvailable | HasPreset::kPropertyWritable,
+                "YourPreset55"),
+  }};
+  SetSampleDatabaseHasPresetsNtf(test_address, kFeatureBitDynamicPresets,
+                                 has_presets);
+  SetEncryptionResult(test_address, true);
+
+  ON_CALL(btif_storage_interface_, GetLeaudioHasPresets(test_address, _, _))
+      .WillByDefault([&has_presets](const RawAddress& address,
+                                    std::vector<uint8_t>& presets_bin,
+                                    uint8_t& active_preset) {
+        HasDevice device(address, 0);
+        device.has_presets = has_presets;
+        device.presets_change_counter = 7;
+        active_preset = 6;
+        return device.SerializePresets(presets_bin);
+      });
+
+  /* Only the cached presets are reported */
+  EXPECT_CALL(*callbacks,
+              OnPresetInfo(std::variant<RawAddress, int>(test_address),
+                           PresetInfoReason::ALL_PRESET_INFO, _))
+      .Times(1);
+  EXPECT_CALL(*callbacks,
+              OnPresetInfo(std::variant<RawAddress, int>(test_address),
+                           PresetInfoReason::PRESET_INFO_REQUEST_RESPONSE, _))
+      .Times(0);
+
+  /* A single read of all the presets validates the cache */
+  EXPECT_CALL(gatt_queue, ReadCharacteristic(1, _, _, _)).Times(0);
+  EXPECT_CALL(gatt_queue,
+              WriteCharacteristic(1, HasDbBuilder::kPresetsCtpValHdl, _,
+                                  GATT_WRITE, _, _))
+      .Times(1);
+
+  /* Matching presets are not stored again */
+  EXPECT_CALL(btif_storage_interface_, SetLeaudioHasPresets(test_address, _))
+      .Times(0);
+
+  TestAddFromStorage(test_address,
+                     kFeatureBitDynamicPresets | kFeatureBitWritablePresets |
+                         kFeatureBitHearingAidTypeBanded,
+                     true);
+}
+
+TEST_F(HasClientTest, test_load_from_storage_dynamic_presets_stale) {
+  const RawAddress test_address = GetTestAddress(1);
+  /* The remote has presets 6 and 55 */
+  SetSampleDatabaseHasPresetsNtf(test_address, kFeatureBitDynamicPresets);
+  SetEncryptionResult(test_address, true);
+
+  /* Load outdated persistent storage data */
+  ON_CALL(btif_storage_interface_, GetLeaudioHasPresets(test_address, _, _))
+      .WillByDefault([](const RawAddress& address,
+                        std::vector<uint8_t>& presets_bin,
+                        uint8_t& active_preset) {
+        HasDevice device(address, 0);
+        device.has_presets = {{
+            HasPreset(5, HasPreset::kPropertyAvailable, "YourPreset5"),
+            HasPreset(55, HasPreset::kPropertyAvailable, "YourPreset55"),
+        }};
+        device.presets_change_counter = 7;
+        active_preset = 55;
+        return device.SerializePresets(presets_bin);
+      });
+
+  /* The cached presets, then the ones read in one go */
+  std::vector<PresetInfo> preset_details;
+  EXPECT_CALL(*callbacks,
+              OnPresetInfo(std::variant<RawAddress, int>(test_address),
+                           PresetInfoReason::ALL_PRESET_INFO, _))
+      .Times(2)
+      .WillRepeatedly(SaveArg<2>(&preset_details));
+  EXPECT_CALL(*callbacks,
+              OnPresetInfo(std::variant<RawAddress, int>(test_address),
+                           PresetInfoReason::PRESET_INFO_REQUEST_RESPONSE, _))
+      .Times(0);
+
+  std::vector<uint8_t> serialized;
+  EXPECT_CALL(btif_storage_interface_, SetLeaudioHasPresets(test_address, _))
+      .WillOnce(SaveArg<1>(&serialized));
+
+  TestAddFromStorage(test_address,
+                     kFeatureBitDynamicPresets | kFeatureBitWritablePresets |
+                         kFeatureBitHearingAidTypeBanded,
+                     true);
+
+  ASSERT_EQ(2u, preset_details.size());
+  ASSERT_EQ(6, preset_details[0].preset_index);
+  ASSERT_EQ("Universal", preset_details[0].preset_name);
+  ASSERT_EQ(55, preset_details[1].preset_index);
+  ASSERT_TRUE(preset_details[1].writable);
+
+  HasDevice clone(test_address, 0);
+  ASSERT_TRUE(HasDevice::DeserializePresets(serialized.data(),
+                                            serialized.size(), clone));
+  ASSERT_EQ(8, clone.presets_change_counter);
+  ASSERT_NE(nullptr, clone.GetPreset(6));
+  ASSERT_EQ(nullptr, clone.GetPreset(5));
+}
+
 TEST_F(HasClientTest, test_load_from_storage) {
   const RawAddress test_address = GetTestAddress(1);
   SetSampleDatabaseHasPresetsNtf(test_address, kFeatureBitDynamicPresets, {{}});
@@ -2394,6 +2499,43 @@ TEST_F(HasClientTest, test_select_group_preset_valid_no_preset_sync_supported) {
   ASSERT_EQ(group_active_preset_index, 55);
 }
 
+TEST_F(HasClientTest, test_select_group_preset_not_on_all_devices) {
+  const RawAddress test_address1 = GetTestAddress(1);
+  SetSampleDatabaseHasPresetsNtf(
+      test_address1, bluetooth::has::kFeatureBitHearingAidTypeBinaural);
+
+  /* The other device does not have the preset */
+  const RawAddress test_address2 = GetTestAddress(2);
+  SetSampleDatabaseHasPresetsNtf(
+      test_address2, bluetooth::has::kFeatureBitHearingAidTypeBinaural,
+      {{
+          HasPreset(6, HasPreset::kPropertyAvailable, "Universal"),
+          HasPreset(56, HasPreset::kPropertyAvailable, "YourPreset56"),
+      }});
+
+  TestConnect(test_address1);
+  TestConnect(test_address2);
+
+  /* Mock the csis group with two devices */
+  uint8_t not_synced_group = 13;
+  ON_CALL(mock_csis_client_module_, GetDeviceList(not_synced_group))
+      .WillByDefault(
+          Return(std::vector<RawAddress>({{test_address1, test_address2}})));
+
+  EXPECT_CALL(*callbacks,
+              OnActivePresetSelectError(
+                  std::variant<RawAddress, int>(not_synced_group),
+                  ErrorCode::INVALID_PRESET_INDEX))
+      .Times(1);
+
+  /* Neither device gets the write, not only the one missing the preset */
+  EXPECT_CALL(gatt_queue, WriteCharacteristic(_, HasDbBuilder::kPresetsCtpValHdl,
+                                              _, GATT_WRITE, _, _))
+      .Times(0);
+
+  HasClient::Get()->SelectActivePreset(not_synced_group, 55);
+}
+
 TEST_F(HasClientTest, test_select_group_preset_valid_preset_sync_supported) {
   /* Only one of these devices support preset syncing */
   const RawAddress test_address1 = GetTestAddress(1);
@@ -3032,8 +3174,10 @@ TEST_F(HasTypesTest, test_has_presets_serialize) {
   has_device.has_presets.insert(preset);
   has_device.has_presets.insert(preset2);
 
+  has_device.presets_change_counter = 0x1234;
+
   auto out_buf_sz = has_device.SerializedPresetsSize();
-  ASSERT_EQ(out_buf_sz, preset.SerializedSize() + preset2.SerializedSize() + 2);
+  ASSERT_EQ(out_buf_sz, preset.SerializedSize() + preset2.SerializedSize() + 4);
 
   /* Serialize should append to the vector */
   std::vector<uint8_t> serialized;
@@ -3046,6 +3190,7 @@ TEST_F(HasTypesTest, test_has_presets_serialize) {
                                             serialized.size(), clone));
 
   /* Verify */
+  ASSERT_EQ(clone.presets_change_counter, has_device.presets_change_counter);
   ASSERT_EQ(clone.has_presets.size(), has_device.has_presets.size());
   ASSERT_NE(0u, clone.has_presets.count(0x01));
   ASSERT_NE(0u, clone.has_presets.count(0x02));
@@ -180,6 +180,11 @@ class HasDevice : public GattServiceDevice {
   std::set<HasPreset, HasPreset::ComparatorDesc> has_presets;
   uint8_t currently_active_preset = bluetooth::has::kHasPresetIndexInvalid;
 
+  /* Number of changes made to the stored presets, persisted with them */
+  uint16_t presets_change_counter = 0;
+  /* Set while all the presets are read again on an already valid service */
+  bool is_reading_all_presets = false;
+
   std::list<HasCtpNtf> ctp_notifications_;
   HasJournal has_journal_;
 
@@ -192,6 +197,7 @@ class HasDevice : public GattServiceDevice {
     conn_id = GATT_INVALID_CONN_ID;
     is_connecting_actively = false;
     ctp_notifications_.clear();
+    is_reading_all_presets = false;
   }
 
   using GattServiceDevice::GattServiceDevice;
@@ -291,12 +297,14 @@ class HasDevice : public GattServiceDevice {
 
   /* Calculates the buffer space that all the preset will use when serialized */
   uint8_t SerializedPresetsSize() const {
-    /* Two additional bytes are for the header and the number of presets */
+    /* Four additional bytes are for the header, the change counter and the
+     * number of presets.
+     */
     return std::accumulate(has_presets.begin(), has_presets.end(), 0,
                            [](uint8_t current, auto const& preset) {
                              return current + preset.SerializedSize();
                            }) +
-           2;
+           4;
   }
 
   /* Serializes all the presets into a binary blob for persistent storage */
@@ -308,6 +316,7 @@ class HasDevice : public GattServiceDevice {
     auto p_out = out.data() + buffer_offset;
 
     UINT8_TO_STREAM(p_out, kHasDeviceBinaryBlobHdr);
+    UINT16_TO_STREAM(p_out, presets_change_counter);
     UINT8_TO_STREAM(p_out, has_presets.size());
 
     auto* const p_end = p_out + buffer_size;
@@ -336,7 +345,16 @@ class HasDevice : public GattServiceDevice {
 
     uint8_t hdr;
     STREAM_TO_UINT8(hdr, p_in);
-    if (hdr != kHasDeviceBinaryBlobHdr) {
+    if (hdr == kHasDeviceBinaryBlobHdr) {
+      if (p_end - p_in < 2) {
+        LOG(ERROR) << "Deserialization error. Invalid input buffer size length.";
+        return false;
+      }
+      STREAM_TO_UINT16(device.presets_change_counter, p_in);
+    } else if (hdr == kHasDeviceBinaryBlobHdrNoCounter) {
+      /* Stored before the change counter was added */
+      device.presets_change_counter = 0;
+    } else {
       LOG(ERROR) << __func__ << " Deserialization error. Bad header.";
       return false;
     }
@@ -368,6 +386,7 @@ class HasDevice : public GattServiceDevice {
     os << ", \"features_notifications_enabled\": "
        << (features_notifications_enabled ? "\"Enabled\"" : "\"Disabled\"");
     os << ", \"ctp_notifications size\": " << ctp_notifications_.size();
+    os << ", \"presets_change_counter\": " << presets_change_counter;
     os << ",\n";
 
     os << "    "
@@ -413,7 +432,8 @@ class HasDevice : public GattServiceDevice {
   }
 
  private:
-  static constexpr int kHasDeviceBinaryBlobHdr = 0x55;
+  static constexpr int kHasDeviceBinaryBlobHdrNoCounter = 0x55;
+  static constexpr int kHasDeviceBinaryBlobHdr = 0x56;
 };
 
 }  // namespace has
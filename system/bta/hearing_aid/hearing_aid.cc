@@ -269,6 +269,18 @@ class HearingAidImpl : public HearingAid {
     VLOG(2) << __func__
             << ", default_data_interval_ms=" << default_data_interval_ms;
 
+    // Audio queued past the render delay budget would be heard late, so the
+    // target latency is capped to it
+    max_queue_delay_ms = (uint16_t)osi_property_get_int32(
+        "persist.bluetooth.hearingaid.max_queue_delay_ms", 0);
+    uint16_t max_allowed_ms =
+        ADD_RENDER_DELAY_INTERVALS * default_data_interval_ms;
+    if (max_queue_delay_ms > max_allowed_ms) {
+      LOG(ERROR) << __func__ << ": max_queue_delay_ms=" << max_queue_delay_ms
+                 << " is capped to " << max_allowed_ms;
+      max_queue_delay_ms = max_allowed_ms;
+    }
+
     overwrite_min_ce_len = (uint16_t)osi_property_get_int32(
         "persist.bluetooth.hearingaidmincelen", 0);
     if (overwrite_min_ce_len) {
@@ -1036,7 +1048,8 @@ class HearingAidImpl : public HearingAid {
       if (hearingDevice.render_delay != 0) {
         delay_report_ms =
             hearingDevice.render_delay +
-            (ADD_RENDER_DELAY_INTERVALS * default_data_interval_ms);
+            (ADD_RENDER_DELAY_INTERVALS * default_data_interval_ms) +
+            max_queue_delay_ms;
       }
 
       HearingAidAudioSource::Start(codec, audioReceiver, delay_report_ms);
@@ -1234,6 +1247,33 @@ class HearingAidImpl : public HearingAid {
     return diff_credit < (init_credit / 2 - 1);
   }
 
+  /* Returns the number of audio packets still queued in the LE CoC of
+   * |device|, and tracks the delay they make and the credits of the peer */
+  uint16_t GetQueuedPackets(HearingDevice* device) {
+    AudioStats& stats = device->audio_stats;
+    uint16_t cid = GAP_ConnGetL2CAPCid(device->gap_handle);
+    uint16_t packets_in_chans = L2CA_FlushChannel(cid, L2CAP_FLUSH_CHANS_GET);
+
+    size_t delay_ms = packets_in_chans * default_data_interval_ms;
+    stats.queue_delay_max_ms = std::max(stats.queue_delay_max_ms, delay_ms);
+    stats.queue_delay_sum_ms += delay_ms;
+    stats.queue_delay_count++;
+
+    uint16_t credit = L2CA_GetPeerLECocCredit(device->address, cid);
+    if (credit != L2CAP_LE_CREDIT_MAX) {
+      stats.credit_min = std::min(stats.credit_min, credit);
+    }
+    return packets_in_chans;
+  }
+
+  void FlushQueuedPackets(HearingDevice* device, uint16_t packets_in_chans) {
+    LOG(INFO) << device->address << " skipping " << packets_in_chans
+              << " packets";
+    device->audio_stats.packet_flush_count += packets_in_chans;
+    device->audio_stats.frame_flush_count++;
+    L2CA_FlushChannel(GAP_ConnGetL2CAPCid(device->gap_handle), 0xffff);
+  }
+
   void OnAudioDataReady(const std::vector<uint8_t>& data) {
     /* For now we assume data comes in as 16bit per sample 16kHz PCM stereo */
     DVLOG(2) << __func__;
@@ -1302,68 +1342,67 @@ class HearingAidImpl : public HearingAid {
     // reallocations
     // TODO: this should basically fit the encoded data, tune the size later
     std::vector<uint8_t> encoded_data_left;
-    if (left) {
-      // TODO: instead of a magic number, we need to figure out the correct
-      // buffer size
-      encoded_data_left.resize(4000);
+    std::vector<uint8_t> encoded_data_right;
+    // TODO: instead of a magic number, we need to figure out the correct
+    // buffer size
+    if (left) encoded_data_left.resize(4000);
+    if (right) encoded_data_right.resize(4000);
+    if (left && right) {
+      // Both sides are encoded in one pass, sharing the vector units
+      int encoded_size = g722_encode_dual(
+          encoder_state_left, encoder_state_right, encoded_data_left.data(),
+          encoded_data_right.data(), (const int16_t*)chan_left.data(),
+          (const int16_t*)chan_right.data(), chan_left.size());
+      encoded_data_left.resize(encoded_size);
+      encoded_data_right.resize(encoded_size);
+    } else if (left) {
       int encoded_size =
           g722_encode(encoder_state_left, encoded_data_left.data(),
                       (const int16_t*)chan_left.data(), chan_left.size());
       encoded_data_left.resize(encoded_size);
-
-      uint16_t cid = GAP_ConnGetL2CAPCid(left->gap_handle);
-      uint16_t packets_in_chans = L2CA_FlushChannel(cid, L2CAP_FLUSH_CHANS_GET);
-      if (packets_in_chans) {
-        // Compare the two sides LE CoC credit value to confirm need to drop or
-        // skip audio packet.
-        if (NeedToDropPacket(left, right)) {
-          LOG(INFO) << left->address << " triggers dropping, "
-                    << packets_in_chans << " packets in channel";
-          need_drop = true;
-          left->audio_stats.trigger_drop_count++;
-        } else {
-          LOG(INFO) << left->address << " skipping " << packets_in_chans
-                    << " packets";
-          left->audio_stats.packet_flush_count += packets_in_chans;
-          left->audio_stats.frame_flush_count++;
-          L2CA_FlushChannel(cid, 0xffff);
-        }
-        hearingDevices.StartRssiLog();
-      }
-      check_and_do_rssi_read(left);
-    }
-
-    std::vector<uint8_t> encoded_data_right;
-    if (right) {
-      // TODO: instead of a magic number, we need to figure out the correct
-      // buffer size
-      encoded_data_right.resize(4000);
+    } else if (right) {
       int encoded_size =
           g722_encode(encoder_state_right, encoded_data_right.data(),
                       (const int16_t*)chan_right.data(), chan_right.size());
       encoded_data_right.resize(encoded_size);
+    }
 
-      uint16_t cid = GAP_ConnGetL2CAPCid(right->gap_handle);
-      uint16_t packets_in_chans = L2CA_FlushChannel(cid, L2CAP_FLUSH_CHANS_GET);
-      if (packets_in_chans) {
-        // Compare the two sides LE CoC credit value to confirm need to drop or
-        // skip audio packet.
-        if (NeedToDropPacket(right, left)) {
-          LOG(INFO) << right->address << " triggers dropping, "
-                    << packets_in_chans << " packets in channel";
-          need_drop = true;
-          right->audio_stats.trigger_drop_count++;
-        } else {
-          LOG(INFO) << right->address << " skipping " << packets_in_chans
-                    << " packets";
-          right->audio_stats.packet_flush_count += packets_in_chans;
-          right->audio_stats.frame_flush_count++;
-          L2CA_FlushChannel(cid, 0xffff);
-        }
-        hearingDevices.StartRssiLog();
+    uint16_t left_queued = left ? GetQueuedPackets(left) : 0;
+    uint16_t right_queued = right ? GetQueuedPackets(right) : 0;
+    // Each packet queued holds one interval of audio. Up to the target latency
+    // the queue is left to drain, so short interference costs no frames.
+    uint16_t max_queued = max_queue_delay_ms / default_data_interval_ms;
+    bool left_over = left_queued > max_queued;
+    bool right_over = right_queued > max_queued;
+    if (left_queued && !left_over) left->audio_stats.queue_tolerated_count++;
+    if (right_queued && !right_over) right->audio_stats.queue_tolerated_count++;
+
+    // Compare the two sides LE CoC credit value to confirm need to drop or
+    // skip audio packet. A drop applies to both sides, a side that does not
+    // trigger it is still flushed.
+    if (left_over) {
+      if (NeedToDropPacket(left, right)) {
+        LOG(INFO) << left->address << " triggers dropping, " << left_queued
+                  << " packets in channel";
+        need_drop = true;
+        left->audio_stats.trigger_drop_count++;
+      } else {
+        FlushQueuedPackets(left, left_queued);
+      }
+    }
+    if (right_over) {
+      if (NeedToDropPacket(right, left)) {
+        LOG(INFO) << right->address << " triggers dropping, " << right_queued
+                  << " packets in channel";
+        need_drop = true;
+        right->audio_stats.trigger_drop_count++;
+      } else {
+        FlushQueuedPackets(right, right_queued);
       }
-      check_and_do_rssi_read(right);
     }
+    if (left_over || right_over) hearingDevices.StartRssiLog();
+    if (left) check_and_do_rssi_read(left);
+    if (right) check_and_do_rssi_read(right);
 
     size_t encoded_data_size =
         std::max(encoded_data_left.size(), encoded_data_right.size());
@@ -1578,7 +1617,23 @@ class HearingAidImpl : public HearingAid {
           << device.audio_stats.packet_flush_count
           << "\n    Frame counts (sent/flush)                              : "
           << device.audio_stats.frame_send_count << " / "
-          << device.audio_stats.frame_flush_count << std::endl;
+          << device.audio_stats.frame_flush_count
+          << "\n    Intervals with audio queued within target              : "
+          << device.audio_stats.queue_tolerated_count
+          << "\n    Queue delay ms (avg/max, target)                       : "
+          << (device.audio_stats.queue_delay_count
+                  ? device.audio_stats.queue_delay_sum_ms /
+                        device.audio_stats.queue_delay_count
+                  : 0)
+          << " / " << device.audio_stats.queue_delay_max_ms << ", "
+          << max_queue_delay_ms
+          << "\n    Lowest credit (init)                                   : ";
+      if (device.audio_stats.credit_min != UINT16_MAX) {
+        stream << device.audio_stats.credit_min;
+      } else {
+        stream << "-";
+      }
+      stream << " (" << init_credit << ")" << std::endl;
 
       DumpRssi(fd, device);
     }
@@ -1744,6 +1799,10 @@ class HearingAidImpl : public HearingAid {
 
   uint16_t default_data_interval_ms;
 
+  /* Delay of the audio that may stay queued in the LE CoC before it is flushed
+   * or dropped */
+  uint16_t max_queue_delay_ms;
+
   uint16_t init_credit;
 
   HearingDevices hearingDevices;
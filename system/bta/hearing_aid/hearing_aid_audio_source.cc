@@ -155,6 +155,9 @@ void hearing_aid_data_cb(tUIPC_CH_ID, tUIPC_EVENT event) {
                  UIPC_REG_REMOVE_ACTIVE_READSET, NULL);
       UIPC_Ioctl(*uipc_hearing_aid, UIPC_CH_ID_AV_AUDIO, UIPC_SET_READ_POLL_TMO,
                  reinterpret_cast<void*>(0));
+      UIPC_Ioctl(*uipc_hearing_aid, UIPC_CH_ID_AV_AUDIO,
+                 UIPC_SET_RX_BATCH_SIZE,
+                 reinterpret_cast<void*>(AUDIO_STREAM_OUTPUT_BUFFER_SZ));
 
       do_in_main_thread(FROM_HERE, base::BindOnce(start_audio_ticks));
       break;
@@ -0,0 +1,477 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <base/bind.h>
+#include <base/bind_helpers.h>
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "bta_gatt_api_mock.h"
+#include "bta_gatt_queue_mock.h"
+#include "bta_hearing_aid_api.h"
+#include "btm_api_mock.h"
+#include "mock_controller.h"
+#include "osi/include/allocator.h"
+#include "stack/include/gap_api.h"
+#include "stack/include/l2c_api.h"
+#include "types/raw_address.h"
+
+static std::map<std::string, int32_t> fake_osi_int32_props;
+
+int32_t osi_property_get_int32(const char* key, int32_t default_value) {
+  if (fake_osi_int32_props.count(key)) return fake_osi_int32_props.at(key);
+
+  return default_value;
+}
+
+void btif_storage_add_hearing_aid(const HearingDevice& dev_info) {}
+
+bool btif_storage_get_hearing_aid_prop(
+    const RawAddress& address, uint8_t* capabilities, uint64_t* hi_sync_id,
+    uint16_t* render_delay, uint16_t* preparation_delay, uint16_t* codecs) {
+  return false;
+}
+
+tBTM_STATUS BTM_SetBleDataLength(const RawAddress& bd_addr,
+                                 uint16_t tx_pdu_length) {
+  return BTM_SUCCESS;
+}
+
+tBTM_STATUS BTM_ReadRSSI(const RawAddress& remote_bda, tBTM_CMPL_CB* p_cb) {
+  return BTM_CMD_STARTED;
+}
+
+void BTM_BleSetConnScanParams(uint32_t scan_interval, uint32_t scan_window) {}
+
+namespace {
+
+/* The LE CoC of each hearing aid, as seen through the GAP and L2CAP APIs */
+struct FakeCoc {
+  RawAddress address;
+  uint16_t cid;
+  tGAP_CONN_CALLBACK* gap_callback = nullptr;
+  /* Audio packets still queued in the channel */
+  uint16_t queued_packets = 0;
+  uint16_t peer_credit = 0;
+  int flush_count = 0;
+  int sent_packet_count = 0;
+};
+
+std::map<uint16_t /* gap_handle */, FakeCoc> fake_cocs;
+
+/* The HearingAidAudioSource the profile started */
+HearingAidAudioReceiver* audio_receiver = nullptr;
+uint16_t audio_remote_delay_ms = 0;
+
+FakeCoc* FindCocByCid(uint16_t cid) {
+  for (auto& [gap_handle, coc] : fake_cocs) {
+    if (coc.cid == cid) return &coc;
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+uint16_t GAP_ConnOpen(const char* p_serv_name, uint8_t service_id,
+                      bool is_server, const RawAddress* p_rem_bda,
+                      uint16_t psm, uint16_t le_mps, tL2CAP_CFG_INFO* p_cfg,
+                      tL2CAP_ERTM_INFO* ertm_info, uint16_t security,
+                      tGAP_CONN_CALLBACK* p_cb, tBT_TRANSPORT transport) {
+  for (auto& [gap_handle, coc] : fake_cocs) {
+    if (coc.address != *p_rem_bda) continue;
+    coc.gap_callback = p_cb;
+    return gap_handle;
+  }
+  return GAP_INVALID_HANDLE;
+}
+
+uint16_t GAP_ConnClose(uint16_t gap_handle) { return BT_PASS; }
+
+uint16_t GAP_ConnReadData(uint16_t gap_handle, uint8_t* p_data,
+                          uint16_t max_len, uint16_t* p_len) {
+  *p_len = 0;
+  return BT_PASS;
+}
+
+int GAP_GetRxQueueCnt(uint16_t handle, uint32_t* p_rx_queue_count) {
+  *p_rx_queue_count = 0;
+  return BT_PASS;
+}
+
+uint16_t GAP_ConnWriteData(uint16_t gap_handle, BT_HDR* msg) {
+  fake_cocs.at(gap_handle).sent_packet_count++;
+  osi_free(msg);
+  return BT_PASS;
+}
+
+const RawAddress* GAP_ConnGetRemoteAddr(uint16_t gap_handle) {
+  return &fake_cocs.at(gap_handle).address;
+}
+
+uint16_t GAP_ConnGetRemMtuSize(uint16_t gap_handle) { return 512; }
+
+uint16_t GAP_ConnGetL2CAPCid(uint16_t gap_handle) {
+  return fake_cocs.at(gap_handle).cid;
+}
+
+uint16_t L2CA_FlushChannel(uint16_t lcid, uint16_t num_to_flush) {
+  FakeCoc* coc = FindCocByCid(lcid);
+  if (coc == nullptr) return 0;
+  if (num_to_flush == L2CAP_FLUSH_CHANS_GET) return coc->queued_packets;
+  coc->flush_count++;
+  coc->queued_packets = 0;
+  return 0;
+}
+
+uint16_t L2CA_GetPeerLECocCredit(const RawAddress& bd_addr, uint16_t lcid) {
+  FakeCoc* coc = FindCocByCid(lcid);
+  return coc ? coc->peer_credit : L2CAP_LE_CREDIT_MAX;
+}
+
+bool L2CA_UpdateBleConnParams(const RawAddress& rem_bda, uint16_t min_int,
+                              uint16_t max_int, uint16_t latency,
+                              uint16_t timeout, uint16_t min_ce_len,
+                              uint16_t max_ce_len) {
+  return true;
+}
+
+void HearingAidAudioSource::Start(const CodecConfiguration& codecConfiguration,
+                                  HearingAidAudioReceiver* audioReceiver,
+                                  uint16_t remote_delay_ms) {
+  audio_receiver = audioReceiver;
+  audio_remote_delay_ms = remote_delay_ms;
+}
+
+void HearingAidAudioSource::Stop() {}
+void HearingAidAudioSource::Initialize() {}
+void HearingAidAudioSource::CleanUp() {}
+void HearingAidAudioSource::DebugDump(int fd) {}
+
+namespace bluetooth {
+namespace hearing_aid {
+namespace internal {
+namespace {
+
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+using ::testing::Return;
+using ::testing::SaveArg;
+
+constexpr tGATT_IF kGattIf = 7;
+constexpr uint16_t kRenderDelayMs = 70;
+constexpr uint16_t kInitCredit = 8;
+constexpr uint16_t kConnectionIntervalParam = 0x0010;
+/* 20 ms of 16 kHz, 16 bit stereo audio */
+constexpr size_t kAudioFrameSize = 320 * 2 * 2;
+/* ADD_RENDER_DELAY_INTERVALS intervals of 20 ms */
+constexpr uint16_t kMaxQueueDelayMs = 4 * 20;
+
+// Handles of the cached ASHA service
+constexpr uint16_t kAudioControlPointHandle = 0x0010;
+constexpr uint16_t kAudioStatusHandle = 0x0012;
+constexpr uint16_t kAudioStatusCccHandle = 0x0013;
+constexpr uint16_t kVolumeHandle = 0x0014;
+constexpr uint16_t kReadPsmHandle = 0x0015;
+constexpr uint16_t kServiceChangedCccHandle = 0x0020;
+
+class MockHearingAidCallbacks : public HearingAidCallbacks {
+ public:
+  MOCK_METHOD((void), OnConnectionState,
+              (ConnectionState state, const RawAddress& address), (override));
+  MOCK_METHOD((void), OnDeviceAvailable,
+              (uint8_t capabilities, uint64_t hiSyncId,
+               const RawAddress& address),
+              (override));
+};
+
+class HearingAidTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    fake_osi_int32_props.clear();
+    fake_cocs.clear();
+    audio_receiver = nullptr;
+    audio_remote_delay_ms = 0;
+
+    bluetooth::manager::SetMockBtmInterface(&btm_interface_);
+    controller::SetMockControllerInterface(&controller_interface_);
+    gatt::SetMockBtaGattInterface(&gatt_interface_);
+    gatt::SetMockBtaGattQueue(&gatt_queue_);
+
+    ON_CALL(btm_interface_, BTM_IsEncrypted(_, _)).WillByDefault(Return(true));
+    ON_CALL(controller_interface_, SupportsBle2mPhy())
+        .WillByDefault(Return(false));
+    ON_CALL(gatt_interface_, RegisterForNotifications(kGattIf, _, _))
+        .WillByDefault(Return(GATT_SUCCESS));
+
+    // The PSM of every hearing aid
+    ON_CALL(gatt_queue_, ReadCharacteristic(_, kReadPsmHandle, _, _))
+        .WillByDefault(Invoke([](uint16_t conn_id, uint16_t handle,
+                                 GATT_READ_OP_CB cb, void* cb_data) {
+          uint8_t psm[] = {0x80, 0x00};
+          cb(conn_id, GATT_SUCCESS, handle, sizeof(psm), psm, cb_data);
+        }));
+    ON_CALL(gatt_queue_, WriteCharacteristic(_, _, _, _, _, _))
+        .WillByDefault(Invoke([](uint16_t conn_id, uint16_t handle,
+                                 std::vector<uint8_t> value,
+                                 tGATT_WRITE_TYPE write_type,
+                                 GATT_WRITE_OP_CB cb, void* cb_data) {
+          if (cb) {
+            cb(conn_id, GATT_SUCCESS, handle, value.size(), value.data(),
+               cb_data);
+          }
+        }));
+  }
+
+  void TearDown() override {
+    if (HearingAid::IsHearingAidRunning()) HearingAid::CleanUp();
+    gatt::SetMockBtaGattQueue(nullptr);
+    gatt::SetMockBtaGattInterface(nullptr);
+    controller::SetMockControllerInterface(nullptr);
+    bluetooth::manager::SetMockBtmInterface(nullptr);
+  }
+
+  void Initialize() {
+    BtaAppRegisterCallback app_register_callback;
+    EXPECT_CALL(gatt_interface_, AppRegister(_, _, _))
+        .WillOnce(DoAll(SaveArg<0>(&gatt_callback_),
+                        SaveArg<1>(&app_register_callback)));
+    HearingAid::Initialize(&callbacks_, base::DoNothing());
+    ASSERT_TRUE(gatt_callback_);
+    ASSERT_TRUE(app_register_callback);
+    app_register_callback.Run(kGattIf, GATT_SUCCESS);
+  }
+
+  /* Connects a bonded hearing aid with a cached ASHA service, up to its LE
+   * CoC being open */
+  void ConnectDevice(const RawAddress& address, uint16_t conn_id,
+                     uint16_t gap_handle, uint16_t cid, bool left) {
+    FakeCoc& coc = fake_cocs[gap_handle];
+    coc.address = address;
+    coc.cid = cid;
+    coc.peer_credit = kInitCredit;
+
+    uint8_t capabilities = CAPABILITY_BINAURAL | (left ? 0 : CAPABILITY_SIDE);
+    HearingAid::AddFromStorage(
+        HearingDevice(address, capabilities, 1 << 0x01 /* G722 16 kHz */,
+                      kAudioControlPointHandle, kAudioStatusHandle,
+                      kAudioStatusCccHandle, kServiceChangedCccHandle,
+                      kVolumeHandle, kReadPsmHandle, 0x1234 /* hi_sync_id */,
+                      kRenderDelayMs, 0 /* preparation_delay */),
+        true);
+
+    tBTA_GATTC event_data;
+    event_data.open = {.status = GATT_SUCCESS,
+                       .conn_id = conn_id,
+                       .client_if = kGattIf,
+                       .remote_bda = address,
+                       .transport = BT_TRANSPORT_LE,
+                       .mtu = 240};
+    gatt_callback_(BTA_GATTC_OPEN_EVT, &event_data);
+
+    ASSERT_NE(nullptr, coc.gap_callback);
+    coc.gap_callback(gap_handle, GAP_EVT_CONN_OPENED, nullptr);
+  }
+
+  void CompleteConnectionUpdate(uint16_t conn_id) {
+    tBTA_GATTC event_data;
+    event_data.conn_update = {.conn_id = conn_id,
+                              .interval = kConnectionIntervalParam,
+                              .status = GATT_SUCCESS};
+    gatt_callback_(BTA_GATTC_CONN_UPDATE_EVT, &event_data);
+  }
+
+  void AckAudioStatus(const RawAddress& address, uint16_t conn_id) {
+    tBTA_GATTC event_data;
+    event_data.notify.conn_id = conn_id;
+    event_data.notify.bda = address;
+    event_data.notify.handle = kAudioStatusHandle;
+    event_data.notify.len = 1;
+    event_data.notify.value[0] = 0x00;
+    event_data.notify.is_notify = true;
+    gatt_callback_(BTA_GATTC_NOTIF_EVT, &event_data);
+  }
+
+  /* Initializes the profile with |max_queue_delay_ms| as target latency, and
+   * streams to a left and a right hearing aid */
+  void StartStreaming(int32_t max_queue_delay_ms) {
+    fake_osi_int32_props["persist.bluetooth.hearingaid.max_queue_delay_ms"] =
+        max_queue_delay_ms;
+    Initialize();
+
+    ConnectDevice(kLeftAddress, kLeftConnId, kLeftGapHandle, 0x0040, true);
+    ConnectDevice(kRightAddress, kRightConnId, kRightGapHandle, 0x0041, false);
+    // The connection parameters of the two sides are updated one after another
+    CompleteConnectionUpdate(kLeftConnId);
+    CompleteConnectionUpdate(kRightConnId);
+    ASSERT_NE(nullptr, audio_receiver);
+
+    audio_receiver->OnAudioResume([]() {});
+    AckAudioStatus(kLeftAddress, kLeftConnId);
+    AckAudioStatus(kRightAddress, kRightConnId);
+
+    // Both sides stream
+    SendAudioFrame();
+    ASSERT_EQ(1, left().sent_packet_count);
+    ASSERT_EQ(1, right().sent_packet_count);
+    left().sent_packet_count = 0;
+    right().sent_packet_count = 0;
+  }
+
+  void SendAudioFrame() {
+    audio_receiver->OnAudioDataReady(std::vector<uint8_t>(kAudioFrameSize));
+  }
+
+  FakeCoc& left() { return fake_cocs.at(kLeftGapHandle); }
+  FakeCoc& right() { return fake_cocs.at(kRightGapHandle); }
+
+  const RawAddress kLeftAddress = RawAddress({0xC0, 0xDE, 0xC0, 0xDE, 0, 1});
+  const RawAddress kRightAddress = RawAddress({0xC0, 0xDE, 0xC0, 0xDE, 0, 2});
+  static constexpr uint16_t kLeftConnId = 1;
+  static constexpr uint16_t kRightConnId = 2;
+  static constexpr uint16_t kLeftGapHandle = 11;
+  static constexpr uint16_t kRightGapHandle = 12;
+
+  NiceMock<MockHearingAidCallbacks> callbacks_;
+  NiceMock<bluetooth::manager::MockBtmInterface> btm_interface_;
+  NiceMock<controller::MockControllerInterface> controller_interface_;
+  NiceMock<gatt::MockBtaGattInterface> gatt_interface_;
+  NiceMock<gatt::MockBtaGattQueue> gatt_queue_;
+  tBTA_GATTC_CBACK* gatt_callback_ = nullptr;
+};
+
+TEST_F(HearingAidTest, queued_audio_flushed_when_credits_differ) {
+  StartStreaming(0);
+
+  // The right side got its credits back, only the left one is behind
+  left().queued_packets = 1;
+  left().peer_credit = 0;
+  SendAudioFrame();
+
+  ASSERT_EQ(1, left().flush_count);
+  ASSERT_EQ(0, right().flush_count);
+  ASSERT_EQ(1, left().sent_packet_count);
+  ASSERT_EQ(1, right().sent_packet_count);
+}
+
+TEST_F(HearingAidTest, frame_dropped_on_both_sides_when_credits_are_close) {
+  StartStreaming(0);
+
+  // Both sides are behind, flushing one would make them play different frames
+  left().queued_packets = 1;
+  left().peer_credit = 2;
+  right().peer_credit = 1;
+  SendAudioFrame();
+
+  ASSERT_EQ(0, left().flush_count);
+  ASSERT_EQ(0, right().flush_count);
+  ASSERT_EQ(0, left().sent_packet_count);
+  ASSERT_EQ(0, right().sent_packet_count);
+}
+
+TEST_F(HearingAidTest, both_sides_over_target_with_close_credits_drop) {
+  StartStreaming(0);
+
+  left().queued_packets = 1;
+  right().queued_packets = 2;
+  SendAudioFrame();
+
+  ASSERT_EQ(0, left().flush_count);
+  ASSERT_EQ(0, right().flush_count);
+  ASSERT_EQ(0, left().sent_packet_count);
+  ASSERT_EQ(0, right().sent_packet_count);
+}
+
+TEST_F(HearingAidTest, both_sides_over_target_with_distant_credits_flush) {
+  StartStreaming(0);
+
+  left().queued_packets = 1;
+  left().peer_credit = 0;
+  right().queued_packets = 2;
+  SendAudioFrame();
+
+  ASSERT_EQ(1, left().flush_count);
+  ASSERT_EQ(1, right().flush_count);
+  ASSERT_EQ(1, left().sent_packet_count);
+  ASSERT_EQ(1, right().sent_packet_count);
+}
+
+TEST_F(HearingAidTest, queued_audio_within_target_left_to_drain) {
+  StartStreaming(40);
+
+  // Two intervals of 20 ms are within the target
+  left().queued_packets = 2;
+  left().peer_credit = 0;
+  SendAudioFrame();
+
+  ASSERT_EQ(0, left().flush_count);
+  ASSERT_EQ(1, left().sent_packet_count);
+  ASSERT_EQ(1, right().sent_packet_count);
+
+  // The third one is over it
+  left().queued_packets = 3;
+  SendAudioFrame();
+
+  ASSERT_EQ(1, left().flush_count);
+  ASSERT_EQ(0, right().flush_count);
+  ASSERT_EQ(2, left().sent_packet_count);
+  ASSERT_EQ(2, right().sent_packet_count);
+}
+
+TEST_F(HearingAidTest, frame_dropped_on_both_sides_when_one_is_over_target) {
+  StartStreaming(40);
+
+  // The right side is within the target, the left one over it, and their
+  // credits are close: the frame is dropped for both sides
+  left().queued_packets = 3;
+  right().queued_packets = 2;
+  SendAudioFrame();
+
+  ASSERT_EQ(0, left().flush_count);
+  ASSERT_EQ(0, right().flush_count);
+  ASSERT_EQ(0, left().sent_packet_count);
+  ASSERT_EQ(0, right().sent_packet_count);
+}
+
+TEST_F(HearingAidTest, target_added_to_reported_delay) {
+  StartStreaming(40);
+
+  ASSERT_EQ(kRenderDelayMs + 4 * 20 + 40, audio_remote_delay_ms);
+}
+
+TEST_F(HearingAidTest, target_capped_to_render_delay_budget) {
+  StartStreaming(1000);
+
+  ASSERT_EQ(kRenderDelayMs + 4 * 20 + kMaxQueueDelayMs, audio_remote_delay_ms);
+
+  // Audio queued up to the capped target is left to drain
+  left().queued_packets = kMaxQueueDelayMs / 20;
+  left().peer_credit = 0;
+  SendAudioFrame();
+
+  ASSERT_EQ(0, left().flush_count);
+  ASSERT_EQ(1, left().sent_packet_count);
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace hearing_aid
+}  // namespace bluetooth
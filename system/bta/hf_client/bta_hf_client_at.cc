@@ -22,6 +22,7 @@
 #include "bt_trace.h"  // Legacy trace logging
 
 #include "bta/hf_client/bta_hf_client_int.h"
+#include "bta/include/bta_at_table.h"
 #include "osi/include/allocator.h"
 #include "osi/include/compat.h"
 #include "osi/include/log.h"
@@ -1572,6 +1573,62 @@ static const tBTA_HF_CLIENT_PARSER_CALLBACK bta_hf_client_parser_cb[] = {
 static const uint16_t bta_hf_client_parser_cb_count =
     sizeof(bta_hf_client_parser_cb) / sizeof(bta_hf_client_parser_cb[0]);
 
+/* parser of each event, by name */
+typedef struct {
+  const char* p_name;
+  tBTA_HF_CLIENT_PARSER_CALLBACK p_parser;
+} tBTA_HF_CLIENT_PARSER;
+
+static constexpr tBTA_HF_CLIENT_PARSER bta_hf_client_parser_tbl[] = {
+    {"OK", bta_hf_client_parse_ok},
+    {"ERROR", bta_hf_client_parse_error},
+    {"RING", bta_hf_client_parse_ring},
+    {"+BRSF:", bta_hf_client_parse_brsf},
+    {"+CIND:", bta_hf_client_parse_cind},
+    {"+CIEV:", bta_hf_client_parse_ciev},
+    {"+CHLD:", bta_hf_client_parse_chld},
+    {"+BCS:", bta_hf_client_parse_bcs},
+    {"+BSIR:", bta_hf_client_parse_bsir},
+    {"+CME ERROR:", bta_hf_client_parse_cmeerror},
+    {"+VGM:", bta_hf_client_parse_vgm},
+    {"+VGM=", bta_hf_client_parse_vgme},
+    {"+VGS:", bta_hf_client_parse_vgs},
+    {"+VGS=", bta_hf_client_parse_vgse},
+    {"+BVRA:", bta_hf_client_parse_bvra},
+    {"+CLIP:", bta_hf_client_parse_clip},
+    {"+CCWA:", bta_hf_client_parse_ccwa},
+    {"+COPS:", bta_hf_client_parse_cops},
+    {"+BINP:", bta_hf_client_parse_binp},
+    {"+CLCC:", bta_hf_client_parse_clcc},
+    {"+CNUM:", bta_hf_client_parse_cnum},
+    {"+BTRH:", bta_hf_client_parse_btrh},
+    {"+BIND:", bta_hf_client_parse_bind},
+    {"BUSY", bta_hf_client_parse_busy},
+    {"DELAYED", bta_hf_client_parse_delayed},
+    {"NO CARRIER", bta_hf_client_parse_no_carrier},
+    {"NO ANSWER", bta_hf_client_parse_no_answer},
+    {"REJECTLISTED", bta_hf_client_parse_rejectlisted}};
+
+/* perfect hash index of the event names, built at compile time */
+static constexpr tBTA_AT_INDEX bta_hf_client_parser_idx = bta_at_make_index(
+    bta_hf_client_parser_tbl, &tBTA_HF_CLIENT_PARSER::p_name);
+static_assert(bta_hf_client_parser_idx.seed != 0,
+              "No perfect hash of the AT event names");
+
+/* run the parser of the event named at the start of buf, if any; same
+ * returned values as the parsers */
+static char* bta_hf_client_parse_by_name(tBTA_HF_CLIENT_CB* client_cb,
+                                         char* buf) {
+  if (buf[0] != '\r' || buf[1] != '\n') return buf;
+
+  uint8_t i = bta_at_find(&bta_hf_client_parser_idx, bta_hf_client_parser_tbl,
+                          &tBTA_HF_CLIENT_PARSER::p_name, buf + 2,
+                          bta_at_result_name_len(buf + 2));
+  if (i == BTA_AT_INDEX_NONE) return buf;
+
+  return bta_hf_client_parser_tbl[i].p_parser(client_cb, buf);
+}
+
 #ifdef BTA_HF_CLIENT_AT_DUMP
 static void bta_hf_client_dump_at(tBTA_HF_CLIENT_CB* client_cb) {
   char dump[(4 * BTA_HF_CLIENT_AT_PARSER_MAX_LEN) + 1];
@@ -1611,22 +1668,18 @@ static void bta_hf_client_at_parse_start(tBTA_HF_CLIENT_CB* client_cb) {
 
   while (*buf != '\0') {
     int i;
-    char* tmp = NULL;
+    /* most events are found by name, the others go through all parsers */
+    char* tmp = bta_hf_client_parse_by_name(client_cb, buf);
 
-    for (i = 0; i < bta_hf_client_parser_cb_count; i++) {
+    for (i = 0; tmp == buf && i < bta_hf_client_parser_cb_count; i++) {
       tmp = bta_hf_client_parser_cb[i](client_cb, buf);
-      if (tmp == NULL) {
-        APPL_TRACE_ERROR("HFPCient: AT event/reply parsing failed, skipping");
-        tmp = bta_hf_client_skip_unknown(client_cb, buf);
-        break;
-      }
+    }
 
-      /* matched or unknown skipped, if unknown failed tmp is NULL so
-         this is also handled */
-      if (tmp != buf) {
-        buf = tmp;
-        break;
-      }
+    /* matched or unknown skipped, if unknown failed tmp is NULL so
+       this is also handled */
+    if (tmp == NULL) {
+      APPL_TRACE_ERROR("HFPCient: AT event/reply parsing failed, skipping");
+      tmp = bta_hf_client_skip_unknown(client_cb, buf);
     }
 
     /* could not skip unknown (received garbage?)... disconnect */
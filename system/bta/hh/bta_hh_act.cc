@@ -33,6 +33,7 @@
 #include "bta/include/bta_hh_api.h"
 #include "bta/include/bta_hh_co.h"
 #include "bta/sys/bta_sys.h"
+#include "common/time_util.h"
 #include "main/shim/dumpsys.h"
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
@@ -58,6 +59,8 @@ constexpr char kBtmLogTag[] = "HIDH";
 static void bta_hh_cback(uint8_t dev_handle, const RawAddress& addr,
                          uint8_t event, uint32_t data, BT_HDR* pdata);
 static tBTA_HH_STATUS bta_hh_get_trans_status(uint32_t result);
+static void bta_hh_input_data(tBTA_HH_DEV_CB* p_cb, uint8_t dev_handle,
+                              BT_HDR* pdata, uint64_t rx_timestamp_us);
 
 static const char* bta_hh_get_w4_event(uint16_t event);
 static const char* bta_hh_hid_event_name(uint16_t event);
@@ -612,15 +615,39 @@ void bta_hh_open_act(tBTA_HH_DEV_CB* p_cb, const tBTA_HH_DATA* p_data) {
  ******************************************************************************/
 void bta_hh_data_act(tBTA_HH_DEV_CB* p_cb, const tBTA_HH_DATA* p_data) {
   BT_HDR* pdata = p_data->hid_cback.p_data;
-  uint8_t* p_rpt = (uint8_t*)(pdata + 1) + pdata->offset;
 
-  bta_hh_co_data((uint8_t)p_data->hid_cback.hdr.layer_specific, p_rpt,
-                 pdata->len, p_cb->mode, p_cb->sub_class,
-                 p_cb->dscp_info.ctry_code, p_cb->addr, p_cb->app_id);
+  bta_hh_input_data(p_cb, (uint8_t)p_data->hid_cback.hdr.layer_specific,
+                    pdata, p_data->hid_cback.rx_timestamp_us);
 
   osi_free_and_reset((void**)&pdata);
 }
 
+/*******************************************************************************
+ *
+ * Function         bta_hh_record_input_latency
+ *
+ * Description      Account an input report written to uhid in the latency
+ *                  histogram of the device.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_hh_record_input_latency(tBTA_HH_DEV_CB* p_cb,
+                                 uint64_t rx_timestamp_us) {
+  uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
+  uint32_t latency_us =
+      (now_us > rx_timestamp_us) ? (uint32_t)(now_us - rx_timestamp_us) : 0;
+  uint8_t bucket = 0;
+
+  while (bucket < BTA_HH_INPUT_LATENCY_BUCKETS - 1 &&
+         latency_us >= ((uint32_t)BTA_HH_INPUT_LATENCY_BASE_US << bucket)) {
+    bucket++;
+  }
+  p_cb->input_latency_hist[bucket]++;
+  if (latency_us > p_cb->input_latency_max_us)
+    p_cb->input_latency_max_us = latency_us;
+}
+
 /*******************************************************************************
  *
  * Function         bta_hh_handsk_act
@@ -1118,6 +1145,24 @@ void bta_hh_write_dev_act(tBTA_HH_DEV_CB* p_cb, const tBTA_HH_DATA* p_data) {
 /*****************************************************************************
  *  Static Function
  ****************************************************************************/
+/*******************************************************************************
+ *
+ * Function         bta_hh_input_data
+ *
+ * Description      Write an input report to uhid and account its latency.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_hh_input_data(tBTA_HH_DEV_CB* p_cb, uint8_t dev_handle,
+                              BT_HDR* pdata, uint64_t rx_timestamp_us) {
+  uint8_t* p_rpt = (uint8_t*)(pdata + 1) + pdata->offset;
+
+  bta_hh_co_data(dev_handle, p_rpt, pdata->len, p_cb->mode, p_cb->sub_class,
+                 p_cb->dscp_info.ctry_code, p_cb->addr, p_cb->app_id);
+  bta_hh_record_input_latency(p_cb, rx_timestamp_us);
+}
+
 /*******************************************************************************
  *
  * Function         bta_hh_cback
@@ -1132,6 +1177,8 @@ static void bta_hh_cback(uint8_t dev_handle, const RawAddress& addr,
                          uint8_t event, uint32_t data, BT_HDR* pdata) {
   uint16_t sm_event = BTA_HH_INVALID_EVT;
   uint8_t xx = 0;
+  uint64_t rx_timestamp_us = 0;
+  tBTA_HH_DEV_CB* p_cb = NULL;
 
   APPL_TRACE_DEBUG("%s::HID_event [%s]", __func__,
                    bta_hh_hid_event_name(event));
@@ -1144,6 +1191,20 @@ static void bta_hh_cback(uint8_t dev_handle, const RawAddress& addr,
       sm_event = BTA_HH_INT_CLOSE_EVT;
       break;
     case HID_HDEV_EVT_INTR_DATA:
+      rx_timestamp_us = bluetooth::common::time_get_os_boottime_us();
+      xx = bta_hh_dev_handle_to_cb_idx(dev_handle);
+      if (xx != BTA_HH_IDX_INVALID && bta_hh_cb.kdev[xx].in_use)
+        p_cb = &bta_hh_cb.kdev[xx];
+
+      /* The input reports of a connected device do not need the state
+       * machine, write them to uhid right away unless older ones are still
+       * queued, so that they are not reordered */
+      if (p_cb != NULL && p_cb->state == BTA_HH_CONN_ST &&
+          p_cb->queued_input_rpts == 0) {
+        bta_hh_input_data(p_cb, dev_handle, pdata, rx_timestamp_us);
+        osi_free_and_reset((void**)&pdata);
+        return;
+      }
       sm_event = BTA_HH_INT_DATA_EVT;
       break;
     case HID_HDEV_EVT_HANDSHAKE:
@@ -1177,7 +1238,9 @@ static void bta_hh_cback(uint8_t dev_handle, const RawAddress& addr,
     p_buf->data = data;
     p_buf->addr = addr;
     p_buf->p_data = pdata;
+    p_buf->rx_timestamp_us = rx_timestamp_us;
 
+    if (p_cb != NULL) p_cb->queued_input_rpts++;
     bta_sys_sendmsg(p_buf);
   }
 }
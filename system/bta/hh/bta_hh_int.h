@@ -105,6 +105,7 @@ typedef struct {
   RawAddress addr;
   uint32_t data;
   BT_HDR* p_data;
+  uint64_t rx_timestamp_us; /* when an input report came from L2CAP */
 } tBTA_HH_CBACK_DATA;
 
 typedef struct {
@@ -175,6 +176,10 @@ typedef struct {
   uint16_t ext_rpt_ref;
   tBTA_HH_DEV_DESCR descriptor;
 
+  /* indexes of the reports sorted by characteristic value handle, to find
+   * the report of a notification */
+  uint8_t rpt_idx_by_handle[BTA_HH_LE_RPT_MAX];
+  uint8_t num_rpt;
 } tBTA_HH_LE_HID_SRVC;
 
 /* convert a HID handle to the LE CB index */
@@ -226,6 +231,23 @@ typedef struct {
 #define BTA_HH_LE_SCPS_NOTIFY_ENB 0x02
   uint8_t scps_notify; /* scan refresh supported/notification enabled */
   bool security_pending;
+
+  /* connection parameters preferred by the device, 0 if it has none */
+  uint16_t pref_conn_int_min;
+  uint16_t pref_conn_int_max;
+  uint16_t pref_conn_latency;
+  uint16_t pref_conn_timeout;
+  bool le_input_active;       /* short connection interval requested */
+  uint64_t le_last_input_us;  /* last input report notification */
+
+  uint16_t queued_input_rpts; /* input reports waiting in the BTA queue */
+/* input reports latency from their reception to their write to uhid, bucket
+ * i counts the reports under (BTA_HH_INPUT_LATENCY_BASE_US << i), the last
+ * bucket all the slower ones */
+#define BTA_HH_INPUT_LATENCY_BUCKETS 8
+#define BTA_HH_INPUT_LATENCY_BASE_US 250
+  uint32_t input_latency_hist[BTA_HH_INPUT_LATENCY_BUCKETS];
+  uint32_t input_latency_max_us;
 } tBTA_HH_DEV_CB;
 
 /******************************************************************************
@@ -297,6 +319,8 @@ extern void bta_hh_update_di_info(tBTA_HH_DEV_CB* p_cb, uint16_t vendor_id,
 extern void bta_hh_cleanup_disable(tBTA_HH_STATUS status);
 
 extern uint8_t bta_hh_dev_handle_to_cb_idx(uint8_t dev_handle);
+extern void bta_hh_record_input_latency(tBTA_HH_DEV_CB* p_cb,
+                                        uint64_t rx_timestamp_us);
 
 /* action functions used outside state machine */
 extern void bta_hh_api_enable(const tBTA_HH_DATA* p_data);
@@ -27,6 +27,7 @@
 #include "bta/hh/bta_hh_int.h"
 #include "bta/include/bta_gatt_queue.h"
 #include "bta/include/bta_hh_co.h"
+#include "common/time_util.h"
 #include "device/include/interop.h"
 #include "main/shim/dumpsys.h"
 #include "main/shim/shim.h"
@@ -62,6 +63,11 @@ constexpr bool kBTA_HH_LE_RECONN = false;
 
 #define BTA_LE_HID_RTP_UUID_MAX 5
 
+/* connection interval requested while the user is actively using the device,
+ * until no input report was notified for the idle timeout */
+#define BTA_HH_LE_ACTIVE_CONN_INT BTM_BLE_CONN_INT_MIN_LIMIT
+#define BTA_HH_LE_ACTIVE_IDLE_TIMEOUT_MS 2000
+
 namespace {
 
 constexpr char kBtmLogTag[] = "HIDH";
@@ -77,6 +83,9 @@ static const uint16_t bta_hh_uuid_to_rtp_type[BTA_LE_HID_RTP_UUID_MAX][2] = {
 
 static void bta_hh_gattc_callback(tBTA_GATTC_EVT event, tBTA_GATTC* p_data);
 static void bta_hh_le_add_dev_bg_conn(tBTA_HH_DEV_CB* p_cb, bool check_bond);
+static void bta_hh_le_schedule_idle_check(tBTA_HH_DEV_CB* p_cb,
+                                          uint64_t delay_ms);
+static void bta_hh_le_input_active(tBTA_HH_DEV_CB* p_cb);
 static void bta_hh_process_cache_rpt(tBTA_HH_DEV_CB* p_cb,
                                      tBTA_HH_RPT_CACHE_ENTRY* p_rpt_cache,
                                      uint8_t num_rpt);
@@ -393,6 +402,53 @@ static tBTA_HH_LE_RPT* bta_hh_le_find_rpt_by_idtype(tBTA_HH_LE_RPT* p_head,
   return NULL;
 }
 
+/*******************************************************************************
+ *
+ * Function         bta_hh_le_index_report
+ *
+ * Description      add a new report entry to the reports sorted by
+ *                  characteristic value handle.
+ *
+ ******************************************************************************/
+static void bta_hh_le_index_report(tBTA_HH_LE_HID_SRVC* p_srvc,
+                                   const tBTA_HH_LE_RPT* p_rpt) {
+  uint8_t pos = p_srvc->num_rpt;
+
+  while (pos > 0 &&
+         p_srvc->report[p_srvc->rpt_idx_by_handle[pos - 1]].char_inst_id >
+             p_rpt->char_inst_id) {
+    p_srvc->rpt_idx_by_handle[pos] = p_srvc->rpt_idx_by_handle[pos - 1];
+    pos--;
+  }
+  p_srvc->rpt_idx_by_handle[pos] = p_rpt->index;
+  p_srvc->num_rpt++;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_hh_le_find_report_by_handle
+ *
+ * Description      find the report entry of a characteristic value handle.
+ *
+ ******************************************************************************/
+static tBTA_HH_LE_RPT* bta_hh_le_find_report_by_handle(tBTA_HH_DEV_CB* p_cb,
+                                                       uint16_t handle) {
+  tBTA_HH_LE_HID_SRVC* p_srvc = &p_cb->hid_srvc;
+  uint8_t low = 0, high = p_srvc->num_rpt;
+
+  while (low < high) {
+    uint8_t mid = low + (high - low) / 2;
+    tBTA_HH_LE_RPT* p_rpt = &p_srvc->report[p_srvc->rpt_idx_by_handle[mid]];
+
+    if (p_rpt->char_inst_id == handle) return p_rpt;
+    if (p_rpt->char_inst_id < handle)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+  return NULL;
+}
+
 /*******************************************************************************
  *
  * Function         bta_hh_le_find_alloc_report_entry
@@ -426,6 +482,7 @@ static tBTA_HH_LE_RPT* bta_hh_le_find_alloc_report_entry(tBTA_HH_DEV_CB* p_cb,
         p_rpt->srvc_inst_id = srvc_inst_id;
         p_rpt->char_inst_id = inst_id;
         p_rpt->uuid = rpt_uuid;
+        bta_hh_le_index_report(&p_cb->hid_srvc, p_rpt);
 
         /* assign report type */
         for (i = 0; i < BTA_LE_HID_RTP_UUID_MAX; i++) {
@@ -1358,8 +1415,15 @@ static void read_pref_conn_params_cb(uint16_t conn_id, tGATT_STATUS status,
     if (timeout < 300) timeout = 300;
   }
 
+  p_dev_cb->pref_conn_int_min = min_interval;
+  p_dev_cb->pref_conn_int_max = max_interval;
+  p_dev_cb->pref_conn_latency = latency;
+  p_dev_cb->pref_conn_timeout = timeout;
+
   BTM_BleSetPrefConnParams(p_dev_cb->addr, min_interval, max_interval, latency,
                            timeout);
+  /* keep the short interval until the user stops using the device */
+  if (p_dev_cb->le_input_active) return;
   L2CA_UpdateBleConnParams(p_dev_cb->addr, min_interval, max_interval, latency,
                            timeout, 0, 0);
 }
@@ -1528,9 +1592,11 @@ static void bta_hh_le_srvc_search_cmpl(tBTA_GATTC_SEARCH_CMPL* p_data) {
  *
  ******************************************************************************/
 static void bta_hh_le_input_rpt_notify(tBTA_GATTC_NOTIFY* p_data) {
+  uint64_t rx_timestamp_us = bluetooth::common::time_get_os_boottime_us();
   tBTA_HH_DEV_CB* p_dev_cb = bta_hh_le_find_dev_cb_by_conn_id(p_data->conn_id);
   uint8_t app_id;
   uint8_t* p_buf;
+  uint8_t rpt_buf[GATT_MAX_ATTR_LEN + 1];
   tBTA_HH_LE_RPT* p_rpt;
 
   if (p_dev_cb == NULL) {
@@ -1540,41 +1606,28 @@ static void bta_hh_le_input_rpt_notify(tBTA_GATTC_NOTIFY* p_data) {
     return;
   }
 
-  const gatt::Characteristic* p_char =
-      BTA_GATTC_GetCharacteristic(p_dev_cb->conn_id, p_data->handle);
-  if (p_char == NULL) {
+  p_rpt = bta_hh_le_find_report_by_handle(p_dev_cb, p_data->handle);
+  if (p_rpt == NULL) {
     APPL_TRACE_ERROR(
-        "%s: notification received for Unknown Characteristic, conn_id: "
-        "0x%04x, handle: 0x%04x",
+        "%s: notification received for Unknown Report, conn_id: 0x%04x, "
+        "handle: 0x%04x",
         __func__, p_dev_cb->conn_id, p_data->handle);
     return;
   }
 
   app_id = p_dev_cb->app_id;
-
-  const gatt::Service* p_svc =
-      BTA_GATTC_GetOwningService(p_dev_cb->conn_id, p_char->value_handle);
-
-  p_rpt = bta_hh_le_find_report_entry(
-      p_dev_cb, p_svc->handle, p_char->uuid.As16Bit(), p_char->value_handle);
-  if (p_rpt == NULL) {
-    APPL_TRACE_ERROR(
-        "%s: notification received for Unknown Report, uuid: %s, handle: "
-        "0x%04x",
-        __func__, p_char->uuid.ToString().c_str(), p_char->value_handle);
-    return;
-  }
-
-  if (p_char->uuid == Uuid::From16Bit(GATT_UUID_HID_BT_MOUSE_INPUT))
+  if (p_rpt->uuid == GATT_UUID_HID_BT_MOUSE_INPUT)
     app_id = BTA_HH_APP_ID_MI;
-  else if (p_char->uuid == Uuid::From16Bit(GATT_UUID_HID_BT_KB_INPUT))
+  else if (p_rpt->uuid == GATT_UUID_HID_BT_KB_INPUT)
     app_id = BTA_HH_APP_ID_KB;
 
   APPL_TRACE_DEBUG("Notification received on report ID: %d", p_rpt->rpt_id);
 
+  if (p_rpt->uuid != GATT_UUID_BATTERY_LEVEL) bta_hh_le_input_active(p_dev_cb);
+
   /* need to append report ID to the head of data */
   if (p_rpt->rpt_id != 0) {
-    p_buf = (uint8_t*)osi_malloc(p_data->len + 1);
+    p_buf = rpt_buf;
 
     p_buf[0] = p_rpt->rpt_id;
     memcpy(&p_buf[1], p_data->value, p_data->len);
@@ -1586,8 +1639,112 @@ static void bta_hh_le_input_rpt_notify(tBTA_GATTC_NOTIFY* p_data) {
   bta_hh_co_data((uint8_t)p_dev_cb->hid_handle, p_buf, p_data->len,
                  p_dev_cb->mode, 0, /* no sub class*/
                  p_dev_cb->dscp_info.ctry_code, p_dev_cb->addr, app_id);
+  bta_hh_record_input_latency(p_dev_cb, rx_timestamp_us);
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_hh_le_update_conn_params
+ *
+ * Description      Ask for the short connection interval while the device is
+ *                  in use, for the parameters it prefers otherwise.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_hh_le_update_conn_params(tBTA_HH_DEV_CB* p_cb) {
+  uint16_t min_interval = BTM_BLE_CONN_INT_MIN_DEF;
+  uint16_t max_interval = BTM_BLE_CONN_INT_MAX_DEF;
+  uint16_t latency = BTM_BLE_CONN_PERIPHERAL_LATENCY_DEF;
+  uint16_t timeout = BTM_BLE_CONN_TIMEOUT_DEF;
+
+  if (p_cb->pref_conn_int_min != 0) {
+    min_interval = p_cb->pref_conn_int_min;
+    max_interval = p_cb->pref_conn_int_max;
+    latency = p_cb->pref_conn_latency;
+    timeout = p_cb->pref_conn_timeout;
+  }
+
+  if (p_cb->le_input_active) {
+    min_interval = BTA_HH_LE_ACTIVE_CONN_INT;
+    max_interval = BTA_HH_LE_ACTIVE_CONN_INT;
+    latency = 0;
+  }
+
+  L2CA_UpdateBleConnParams(p_cb->addr, min_interval, max_interval, latency,
+                           timeout, 0, 0);
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_hh_le_check_input_idle
+ *
+ * Description      Go back to the preferred connection parameters once no
+ *                  input report was notified for the idle timeout.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_hh_le_check_input_idle(uint8_t index, uint8_t hid_handle) {
+  tBTA_HH_DEV_CB* p_cb = &bta_hh_cb.kdev[index];
+
+  if (!p_cb->in_use || p_cb->hid_handle != hid_handle ||
+      !p_cb->le_input_active)
+    return;
+
+  uint64_t idle_ms = (bluetooth::common::time_get_os_boottime_us() -
+                      p_cb->le_last_input_us) /
+                     1000;
+  if (idle_ms < BTA_HH_LE_ACTIVE_IDLE_TIMEOUT_MS) {
+    bta_hh_le_schedule_idle_check(p_cb,
+                                  BTA_HH_LE_ACTIVE_IDLE_TIMEOUT_MS - idle_ms);
+    return;
+  }
+
+  p_cb->le_input_active = false;
+  if (p_cb->state == BTA_HH_CONN_ST) bta_hh_le_update_conn_params(p_cb);
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_hh_le_schedule_idle_check
+ *
+ * Description      Check whether the device became idle after a delay.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_hh_le_schedule_idle_check(tBTA_HH_DEV_CB* p_cb,
+                                          uint64_t delay_ms) {
+  do_in_main_thread_delayed(
+      FROM_HERE,
+      base::BindOnce(&bta_hh_le_check_input_idle, p_cb->index,
+                     p_cb->hid_handle),
+#if BASE_VER < 931007
+      base::TimeDelta::FromMilliseconds(delay_ms)
+#else
+      base::Milliseconds(delay_ms)
+#endif
+  );
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_hh_le_input_active
+ *
+ * Description      Ask for a short connection interval when the user starts
+ *                  using the device.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void bta_hh_le_input_active(tBTA_HH_DEV_CB* p_cb) {
+  p_cb->le_last_input_us = bluetooth::common::time_get_os_boottime_us();
+  if (p_cb->le_input_active) return;
 
-  if (p_buf != p_data->value) osi_free(p_buf);
+  p_cb->le_input_active = true;
+  bta_hh_le_update_conn_params(p_cb);
+  bta_hh_le_schedule_idle_check(p_cb, BTA_HH_LE_ACTIVE_IDLE_TIMEOUT_MS);
 }
 
 /*******************************************************************************
@@ -1659,6 +1816,7 @@ void bta_hh_gatt_close(tBTA_HH_DEV_CB* p_cb, const tBTA_HH_DATA* p_data) {
 
   /* deregister all notification */
   bta_hh_le_deregister_input_notif(p_cb);
+  p_cb->le_input_active = false;
   /* finaliza device driver */
   bta_hh_co_close(p_cb->hid_handle, p_cb->app_id);
   /* update total conn number */
@@ -25,6 +25,7 @@
 #include <string.h>  // memset
 
 #include <cstdint>
+#include <cstdio>
 
 #include "bt_target.h"  // Must be first to define build configuration
 #include "bta/hh/bta_hh_int.h"
@@ -350,6 +351,11 @@ bool bta_hh_hdl_event(BT_HDR_RIGID* p_msg) {
 
       if (index != BTA_HH_IDX_INVALID) p_cb = &bta_hh_cb.kdev[index];
 
+      if (p_msg->event == BTA_HH_INT_DATA_EVT && p_cb != NULL &&
+          p_cb->queued_input_rpts > 0) {
+        p_cb->queued_input_rpts--;
+      }
+
       APPL_TRACE_DEBUG("bta_hh_hdl_event:: handle = %d dev_cb[%d] ",
                        p_msg->layer_specific, index);
       bta_hh_sm_execute(p_cb, p_msg->event, (tBTA_HH_DATA*)p_msg);
@@ -439,3 +445,36 @@ static const char* bta_hh_state_code(tBTA_HH_STATE state_code) {
       return "unknown HID Host state";
   }
 }
+
+/*******************************************************************************
+ *
+ * Function         bta_debug_hh_dump
+ *
+ * Description      Dump the input report latency histograms of the devices.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void bta_debug_hh_dump(int fd) {
+  dprintf(fd, "\nBTA HH input report latency:\n");
+  for (uint8_t i = 0; i < BTA_HH_MAX_DEVICE; i++) {
+    const tBTA_HH_DEV_CB* p_cb = &bta_hh_cb.kdev[i];
+    if (!p_cb->in_use) continue;
+
+    dprintf(fd, "  Device: %s handle: %d state: %s\n",
+            p_cb->addr.ToString().c_str(), p_cb->hid_handle,
+            bta_hh_state_code(p_cb->state));
+    for (uint8_t bucket = 0; bucket < BTA_HH_INPUT_LATENCY_BUCKETS;
+         bucket++) {
+      uint32_t bound_us = (uint32_t)BTA_HH_INPUT_LATENCY_BASE_US << bucket;
+      if (bucket < BTA_HH_INPUT_LATENCY_BUCKETS - 1) {
+        dprintf(fd, "    < %u us: %u\n", bound_us,
+                p_cb->input_latency_hist[bucket]);
+      } else {
+        dprintf(fd, "    >= %u us: %u\n", bound_us >> 1,
+                p_cb->input_latency_hist[bucket]);
+      }
+    }
+    dprintf(fd, "    Max: %u us\n", p_cb->input_latency_max_us);
+  }
+}
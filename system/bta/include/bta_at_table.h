@@ -0,0 +1,237 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  AT command and result code tables shared by the AG and the HF client:
+ *  the tokenizer of the command and result names, and the perfect hash
+ *  index of the tables built at compile time.
+ *
+ ******************************************************************************/
+#ifndef BTA_AT_TABLE_H
+#define BTA_AT_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+
+/*****************************************************************************
+ *  Constants
+ ****************************************************************************/
+
+/* Number of slots of an index, a table holds less than half of it */
+#define BTA_AT_INDEX_SLOTS 128
+
+/* Slot without table entry */
+#define BTA_AT_INDEX_NONE 0xff
+
+/*****************************************************************************
+ *  Data types
+ ****************************************************************************/
+
+/* Perfect hash index of the names of an AT table */
+typedef struct {
+  uint32_t seed;                      /* 0 if no perfect hash was found */
+  uint8_t slots[BTA_AT_INDEX_SLOTS];  /* table entry hashed to each slot */
+} tBTA_AT_INDEX;
+
+/*****************************************************************************
+ *  Functions
+ ****************************************************************************/
+
+constexpr char bta_at_toupper(char c) {
+  return (c >= 'a' && c <= 'z') ? (char)(c - 0x20) : c;
+}
+
+constexpr bool bta_at_isalpha(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+constexpr size_t bta_at_strlen(const char* p) {
+  size_t len = 0;
+  while (p[len] != 0) len++;
+  return len;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_at_hash
+ *
+ * Description      Case insensitive hash of an AT name.
+ *
+ * Returns          the slot of the name in an index of this seed
+ *
+ ******************************************************************************/
+constexpr uint8_t bta_at_hash(uint32_t seed, const char* p_name, size_t len) {
+  uint32_t h = 2166136261u ^ (seed * 0x9e3779b9u);
+  for (size_t i = 0; i < len; i++) {
+    h ^= (uint8_t)bta_at_toupper(p_name[i]);
+    h *= 16777619u;
+  }
+  h ^= h >> 16;
+  h *= 0x85ebca6bu;
+  h ^= h >> 13;
+  return (uint8_t)(h & (BTA_AT_INDEX_SLOTS - 1));
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_at_make_index
+ *
+ * Description      Build the perfect hash index of the names of a table, the
+ *                  first seed which gives each name its own slot. Entries
+ *                  with an empty name, as the end of table markers, are left
+ *                  out. Meant to be evaluated at compile time.
+ *
+ * Returns          the index, with a 0 seed if none was found
+ *
+ ******************************************************************************/
+template <typename T, size_t N>
+constexpr tBTA_AT_INDEX bta_at_make_index(const T (&tbl)[N],
+                                          const char* const T::*p_name) {
+  static_assert(2 * N <= BTA_AT_INDEX_SLOTS, "AT table too large");
+  tBTA_AT_INDEX index = {};
+
+  for (uint32_t seed = 1; seed < 0x10000; seed++) {
+    bool found = true;
+
+    for (size_t slot = 0; slot < BTA_AT_INDEX_SLOTS; slot++) {
+      index.slots[slot] = BTA_AT_INDEX_NONE;
+    }
+    for (size_t i = 0; i < N && found; i++) {
+      const char* p = tbl[i].*p_name;
+      if (p[0] == 0) continue;
+
+      uint8_t slot = bta_at_hash(seed, p, bta_at_strlen(p));
+      if (index.slots[slot] != BTA_AT_INDEX_NONE) found = false;
+      index.slots[slot] = (uint8_t)i;
+    }
+    if (found) {
+      index.seed = seed;
+      return index;
+    }
+  }
+  index.seed = 0;
+  return index;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_at_find
+ *
+ * Description      Find the entry of a table by name, case insensitive. The
+ *                  name does not need to be NUL terminated.
+ *
+ * Returns          the index of the entry, or BTA_AT_INDEX_NONE
+ *
+ ******************************************************************************/
+template <typename T>
+inline uint8_t bta_at_find(const tBTA_AT_INDEX* p_index, const T* p_tbl,
+                           const char* const T::*p_tbl_name,
+                           const char* p_name, size_t len) {
+  if (len == 0) return BTA_AT_INDEX_NONE;
+
+  uint8_t i = p_index->slots[bta_at_hash(p_index->seed, p_name, len)];
+  if (i == BTA_AT_INDEX_NONE) return BTA_AT_INDEX_NONE;
+
+  const char* p = p_tbl[i].*p_tbl_name;
+  for (size_t pos = 0; pos < len; pos++) {
+    if (p[pos] == 0 || p[pos] != bta_at_toupper(p_name[pos]))
+      return BTA_AT_INDEX_NONE;
+  }
+  return (p[len] == 0) ? i : BTA_AT_INDEX_NONE;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_at_cmd_name_len
+ *
+ * Description      Length of the name of the AT command starting at p, after
+ *                  the "AT" prefix: '+' and the letters which follow it for
+ *                  an extended command, the first letter for a basic one.
+ *
+ * Returns          the length of the name
+ *
+ ******************************************************************************/
+inline size_t bta_at_cmd_name_len(const char* p) {
+  if (p[0] != '+') return bta_at_isalpha(p[0]) ? 1 : 0;
+
+  size_t len = 1;
+  while (bta_at_isalpha(p[len])) len++;
+  return len;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_at_result_name_len
+ *
+ * Description      Length of the name of the AT result code starting at p,
+ *                  after its leading <cr><lf>: up to and including the ':'
+ *                  or '=' of an extended result code, up to the ending <cr>
+ *                  without the trailing spaces of a basic one.
+ *
+ * Returns          the length of the name, 0 if it has no end
+ *
+ ******************************************************************************/
+inline size_t bta_at_result_name_len(const char* p) {
+  size_t len = 0;
+
+  if (p[0] == '+') {
+    while (p[len] != 0 && p[len] != '\r' && p[len] != ':' && p[len] != '=')
+      len++;
+    return (p[len] == ':' || p[len] == '=') ? len + 1 : 0;
+  }
+
+  while (p[len] != 0 && p[len] != '\r') len++;
+  if (p[len] == 0) return 0;
+  while (len > 0 && p[len - 1] == ' ') len--;
+  return len;
+}
+
+/*******************************************************************************
+ *
+ * Function         bta_at_next_arg
+ *
+ * Description      In place tokenizer of the comma separated arguments of an
+ *                  AT command or result code. The argument is NUL terminated
+ *                  in the buffer and *pp_pos moved past it. Empty arguments
+ *                  are skipped, as strtok() does.
+ *
+ * Returns          the next argument, nullptr once there is none left
+ *
+ ******************************************************************************/
+inline char* bta_at_next_arg(char** pp_pos) {
+  char* p_arg = *pp_pos;
+  if (p_arg == nullptr) return nullptr;
+  while (*p_arg == ',') p_arg++;
+  if (*p_arg == 0) {
+    *pp_pos = p_arg;
+    return nullptr;
+  }
+
+  char* p = p_arg;
+  while (*p != 0 && *p != ',') p++;
+  if (*p == ',') {
+    *p = 0;
+    *pp_pos = p + 1;
+  } else {
+    *pp_pos = p;
+  }
+  return p_arg;
+}
+
+#endif /* BTA_AT_TABLE_H */
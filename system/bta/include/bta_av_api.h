@@ -728,6 +728,18 @@ void BTA_AvOffloadStartRsp(tBTA_AV_HNDL hndl, tBTA_AV_STATUS status);
  */
 int BTA_AvObtainPeerChannelIndex(const RawAddress& peer_address);
 
+/**
+ * Get the state of the link carrying the audio stream to a peer, as last
+ * seen by the data path.
+ *
+ * @param peer_address the peer address
+ * @param p_congested set to true if the AVDTP channel is congested
+ * @param p_l2c_bufs set to the number of buffers queued to L2CAP
+ * @return true if the peer has a started stream, otherwise false
+ */
+bool BTA_AvGetStreamLinkState(const RawAddress& peer_address, bool* p_congested,
+                              uint8_t* p_l2c_bufs);
+
 /**
  * Dump debug-related information for the BTA AV module.
  *
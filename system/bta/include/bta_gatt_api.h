@@ -586,6 +586,11 @@ extern void BTA_GATTC_GetGattDb(uint16_t conn_id, uint16_t start_handle,
 typedef void (*GATT_READ_OP_CB)(uint16_t conn_id, tGATT_STATUS status,
                                 uint16_t handle, uint16_t len, uint8_t* value,
                                 void* data);
+/* |value| holds the values of all the |handles|, each one preceded by its
+ * length for a variable length read */
+typedef void (*GATT_READ_MULTI_OP_CB)(uint16_t conn_id, tGATT_STATUS status,
+                                      tBTA_GATTC_MULTI& handles, uint16_t len,
+                                      uint8_t* value, void* data);
 typedef void (*GATT_WRITE_OP_CB)(uint16_t conn_id, tGATT_STATUS status,
                                  uint16_t handle, uint16_t len,
                                  const uint8_t* value, void* data);
@@ -763,13 +768,19 @@ extern void BTA_GATTC_ExecuteWrite(uint16_t conn_id, bool is_execute);
  *
  * Parameters       conn_id - connectino ID.
  *                    p_read_multi - read multiple parameters.
+ *                  variable_len - use the Read Multiple Variable Length
+ *                                 request, see
+ *                                 GATTC_IsReadMultiVarLenSupported.
+ *                  callback - called with the values once read.
  *
  * Returns          None
  *
  ******************************************************************************/
 extern void BTA_GATTC_ReadMultiple(uint16_t conn_id,
                                    tBTA_GATTC_MULTI* p_read_multi,
-                                   tGATT_AUTH_REQ auth_req);
+                                   bool variable_len, tGATT_AUTH_REQ auth_req,
+                                   GATT_READ_MULTI_OP_CB callback,
+                                   void* cb_data);
 
 /*******************************************************************************
  *
@@ -784,6 +795,23 @@ extern void BTA_GATTC_ReadMultiple(uint16_t conn_id,
  ******************************************************************************/
 extern void BTA_GATTC_Refresh(const RawAddress& remote_bda);
 
+/*******************************************************************************
+ *
+ * Function         BTA_GATTC_WarmupCache
+ *
+ * Description      Read the cached databases of the bonded devices ahead of
+ *                  their connection, off the main thread.
+ *
+ * Parameters       bonded_devices: BD addresses of the bonded devices.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+extern void BTA_GATTC_WarmupCache(std::vector<RawAddress> bonded_devices);
+
+/* Dump the result of the GATT client cache warmup */
+extern void bta_debug_gattc_cache_dump(int fd);
+
 /*******************************************************************************
  *
  * Function         BTA_GATTC_ConfigureMTU
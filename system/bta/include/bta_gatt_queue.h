@@ -32,6 +32,10 @@
  *
  * If you decide to use those methods in your app, make sure to not mix it with
  * existing BTA_GATTC_* API.
+ *
+ * Consecutive characteristic and descriptor reads waiting in the queue are
+ * merged into a single Read Multiple Variable Length request when the server
+ * supports it.
  */
 class BtaGattQueue {
  public:
@@ -56,6 +60,8 @@ class BtaGattQueue {
     uint16_t handle;
     GATT_READ_OP_CB read_cb;
     void* read_cb_data;
+    /* read-specific fields */
+    bool read_alone;
     GATT_WRITE_OP_CB write_cb;
     void* write_cb_data;
     GATT_CONFIGURE_MTU_OP_CB mtu_cb;
@@ -69,9 +75,16 @@ class BtaGattQueue {
  private:
   static void mark_as_not_executing(uint16_t conn_id);
   static void gatt_execute_next_op(uint16_t conn_id);
+  static bool gatt_execute_read_multi(uint16_t conn_id,
+                                      std::list<gatt_operation>& gatt_ops);
   static void gatt_read_op_finished(uint16_t conn_id, tGATT_STATUS status,
                                     uint16_t handle, uint16_t len,
                                     uint8_t* value, void* data);
+  static void gatt_read_multi_op_finished(uint16_t conn_id,
+                                          tGATT_STATUS status,
+                                          tBTA_GATTC_MULTI& handles,
+                                          uint16_t len, uint8_t* value,
+                                          void* data);
   static void gatt_write_op_finished(uint16_t conn_id, tGATT_STATUS status,
                                      uint16_t handle, uint16_t len,
                                      const uint8_t* value, void* data);
@@ -80,6 +80,15 @@ struct AudioStats {
   size_t packet_flush_count;
   size_t frame_send_count;
   size_t frame_flush_count;
+  /* Audio intervals with packets still queued in the LE CoC, but within the
+   * target latency, so left to drain */
+  size_t queue_tolerated_count;
+  /* Delay of the audio queued in the LE CoC at each audio interval */
+  size_t queue_delay_max_ms;
+  uint64_t queue_delay_sum_ms;
+  size_t queue_delay_count;
+  /* Lowest LE CoC credit of the peer seen while streaming */
+  uint16_t credit_min;
   std::deque<rssi_log> rssi_history;
 
   AudioStats() { Reset(); }
@@ -91,6 +100,11 @@ struct AudioStats {
     packet_flush_count = 0;
     frame_send_count = 0;
     frame_flush_count = 0;
+    queue_tolerated_count = 0;
+    queue_delay_max_ms = 0;
+    queue_delay_sum_ms = 0;
+    queue_delay_count = 0;
+    credit_min = UINT16_MAX;
   }
 };
 
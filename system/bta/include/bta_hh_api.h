@@ -520,4 +520,12 @@ extern void BTA_HhAddDev(const RawAddress& bda, tBTA_HH_ATTR_MASK attr_mask,
  ******************************************************************************/
 extern void BTA_HhRemoveDev(uint8_t dev_handle);
 
+/**
+ * Dump debug-related information for the BTA HH module.
+ *
+ * @param fd the file descriptor to use for writing the ASCII formatted
+ * information
+ */
+void bta_debug_hh_dump(int fd);
+
 #endif /* BTA_HH_API_H */
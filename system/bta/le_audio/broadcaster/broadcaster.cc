@@ -19,11 +19,11 @@
 
 #include "bta/include/bta_le_audio_api.h"
 #include "bta/include/bta_le_audio_broadcaster_api.h"
+#include "bta/le_audio/broadcaster/encoder_pipeline.h"
 #include "bta/le_audio/broadcaster/state_machine.h"
 #include "bta/le_audio/le_audio_types.h"
 #include "bta/le_audio/le_audio_utils.h"
 #include "device/include/controller.h"
-#include "embdrv/lc3/include/lc3.h"
 #include "gd/common/strings.h"
 #include "internal_include/stack_config.h"
 #include "osi/include/log.h"
@@ -44,6 +44,7 @@ using le_audio::broadcaster::BroadcastCodecWrapper;
 using le_audio::broadcaster::BroadcastQosConfig;
 using le_audio::broadcaster::BroadcastStateMachine;
 using le_audio::broadcaster::BroadcastStateMachineConfig;
+using le_audio::broadcaster::EncoderPipeline;
 using le_audio::broadcaster::IBroadcastStateMachineCallbacks;
 using le_audio::types::CodecLocation;
 using le_audio::types::kLeAudioCodingFormatLC3;
@@ -419,8 +420,10 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
     LOG_INFO("broadcast_id=%d", broadcast_id);
 
     if (broadcasts_.count(broadcast_id) != 0) {
-      LOG_INFO("Stopping LeAudioClientAudioSource");
-      leAudioClientAudioSource->Stop();
+      if (!IsAnyoneElseStreaming(broadcast_id)) {
+        LOG_INFO("Stopping LeAudioClientAudioSource");
+        leAudioClientAudioSource->Stop();
+      }
       broadcasts_[broadcast_id]->SetMuted(true);
       broadcasts_[broadcast_id]->ProcessMessage(
           BroadcastStateMachine::Message::SUSPEND, nullptr);
@@ -441,14 +444,24 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
     return (iter != instance->broadcasts_.cend());
   }
 
+  static bool IsAnyoneElseStreaming(uint32_t broadcast_id) {
+    if (!instance) return false;
+
+    return std::any_of(instance->broadcasts_.cbegin(),
+                       instance->broadcasts_.cend(),
+                       [broadcast_id](auto const& sm) {
+                         return (sm.first != broadcast_id) &&
+                                (sm.second->GetState() ==
+                                 BroadcastStateMachine::State::STREAMING);
+                       });
+  }
+
   void StartAudioBroadcast(uint32_t broadcast_id) override {
     LOG_INFO("Starting broadcast_id=%d", broadcast_id);
 
-    if (IsAnyoneStreaming()) {
-      LOG_ERROR("Stop the other broadcast first!");
-      return;
-    }
-
+    /* Concurrent broadcasts share the audio source already started by the
+     * first one, each one gets the encoding of its own codec configuration.
+     */
     if (broadcasts_.count(broadcast_id) != 0) {
       if (!audio_instance_) {
         audio_instance_ = leAudioClientAudioSource->Acquire();
@@ -471,9 +484,11 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
       return;
     }
 
-    LOG_INFO("Stopping LeAudioClientAudioSource, broadcast_id=%d",
-             broadcast_id);
-    leAudioClientAudioSource->Stop();
+    if (!IsAnyoneElseStreaming(broadcast_id)) {
+      LOG_INFO("Stopping LeAudioClientAudioSource, broadcast_id=%d",
+               broadcast_id);
+      leAudioClientAudioSource->Stop();
+    }
     broadcasts_[broadcast_id]->SetMuted(true);
     broadcasts_[broadcast_id]->ProcessMessage(
         BroadcastStateMachine::Message::STOP, nullptr);
@@ -681,32 +696,36 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
         case BroadcastStateMachine::State::CONFIGURED:
           /* Pass through */
         case BroadcastStateMachine::State::STOPPING:
-          /* Nothing to do here? */
+          audio_receiver_.RemoveBroadcast(broadcast_id);
           break;
         case BroadcastStateMachine::State::STREAMING:
+          if (instance->broadcasts_.count(broadcast_id) == 0) break;
+
           if (getStreamerCount() == 1) {
             LOG_INFO("Starting LeAudioClientAudioSource");
 
-            if (instance->broadcasts_.count(broadcast_id) != 0) {
-              const auto& broadcast = instance->broadcasts_.at(broadcast_id);
-
-              // Reconfigure encoder instance for the new stream requirements
-              audio_receiver_.setCurrentCodecConfig(
-                  broadcast->GetCodecConfig());
-              audio_receiver_.CheckAndReconfigureEncoders();
-
-              broadcast->SetMuted(false);
-              auto cfg = static_cast<const LeAudioCodecConfiguration*>(data);
-              auto is_started =
-                  leAudioClientAudioSource->Start(*cfg, &audio_receiver_);
-              if (!is_started) {
-                /* Audio Source setup failed - stop the broadcast */
-                instance->StopAudioBroadcast(broadcast_id);
-                return;
-              }
-
-              instance->audio_data_path_state_ = AudioDataPathState::ACTIVE;
+            const auto& broadcast = instance->broadcasts_.at(broadcast_id);
+            auto cfg = static_cast<const LeAudioCodecConfiguration*>(data);
+
+            // Reconfigure the encoders for the new stream requirements
+            audio_receiver_.SetInputConfig(*cfg);
+            audio_receiver_.AddBroadcast(broadcast);
+
+            broadcast->SetMuted(false);
+            auto is_started =
+                leAudioClientAudioSource->Start(*cfg, &audio_receiver_);
+            if (!is_started) {
+              /* Audio Source setup failed - stop the broadcast */
+              instance->StopAudioBroadcast(broadcast_id);
+              return;
             }
+
+            instance->audio_data_path_state_ = AudioDataPathState::ACTIVE;
+          } else {
+            /* Joins the audio source started by the first broadcast */
+            const auto& broadcast = instance->broadcasts_.at(broadcast_id);
+            audio_receiver_.AddBroadcast(broadcast);
+            broadcast->SetMuted(false);
           }
           break;
       };
@@ -733,68 +752,45 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
   static class LeAudioClientAudioSinkReceiverImpl
       : public LeAudioClientAudioSinkReceiver {
    public:
-    LeAudioClientAudioSinkReceiverImpl()
-        : codec_wrapper_(
-              le_audio::broadcaster::getStreamConfigForContext(
-                  static_cast<std::underlying_type<LeAudioContextType>::type>(
-                      le_audio::types::LeAudioContextType::UNSPECIFIED))
-                  .first) {}
-
-    void CheckAndReconfigureEncoders() {
-      auto const& codec_id = codec_wrapper_.GetLeAudioCodecId();
+    void SetInputConfig(const LeAudioCodecConfiguration& config) {
+      encoder_pipeline_.SetInput(config.num_channels, config.sample_rate,
+                                 config.data_interval_us);
+      broadcast_tiers_.clear();
+    }
+
+    void AddBroadcast(const std::unique_ptr<BroadcastStateMachine>& broadcast) {
+      const auto& codec_config = broadcast->GetCodecConfig();
+      auto const& codec_id = codec_config.GetLeAudioCodecId();
       if (codec_id.coding_format != kLeAudioCodingFormatLC3) {
         LOG_ERROR("Invalid codec ID: [%d:%d:%d]", codec_id.coding_format,
                   codec_id.vendor_company_id, codec_id.vendor_codec_id);
         return;
       }
 
-      if (enc_audio_buffers_.size() != codec_wrapper_.GetNumChannels()) {
-        enc_audio_buffers_.resize(codec_wrapper_.GetNumChannels());
-      }
-
-      const int dt_us = codec_wrapper_.GetDataIntervalUs();
-      const int sr_hz = codec_wrapper_.GetSampleRate();
-      const auto encoder_bytes = lc3_encoder_size(dt_us, sr_hz);
-      const auto channel_bytes = codec_wrapper_.GetMaxSduSizePerChannel();
-
-      /* TODO: We should act smart and reuse current configurations */
-      encoders_.clear();
-      encoders_mem_.clear();
-      while (encoders_.size() < codec_wrapper_.GetNumChannels()) {
-        auto& encoder_buf = enc_audio_buffers_.at(encoders_.size());
-        encoder_buf.resize(channel_bytes);
-
-        encoders_mem_.emplace_back(malloc(encoder_bytes), &std::free);
-        encoders_.emplace_back(
-            lc3_setup_encoder(dt_us, sr_hz, 0, encoders_mem_.back().get()));
+      /* Broadcasts with the same configuration share one set of encoders */
+      auto tier = encoder_pipeline_.AddTier(
+          {.num_channels = codec_config.GetNumChannels(),
+           .sample_rate = codec_config.GetSampleRate(),
+           .data_interval_us = codec_config.GetDataIntervalUs(),
+           .octets_per_frame = codec_config.GetMaxSduSizePerChannel()});
+      if (tier < 0) {
+        LOG_ERROR("broadcast_id=%d can't be encoded from the audio source",
+                  broadcast->GetBroadcastId());
+        return;
       }
-    }
 
-    const BroadcastCodecWrapper& getCurrentCodecConfig(void) const {
-      return codec_wrapper_;
+      LOG_INFO("broadcast_id=%d uses encoder tier=%d",
+               broadcast->GetBroadcastId(), tier);
+      broadcast_tiers_[broadcast->GetBroadcastId()] = tier;
     }
 
-    void setCurrentCodecConfig(BroadcastCodecWrapper const& config) {
-      codec_wrapper_ = config;
-    }
-
-    void encodeLc3Channel(lc3_encoder_t encoder,
-                          std::vector<uint8_t>& out_buffer,
-                          const std::vector<uint8_t>& data,
-                          int initial_channel_offset, int pitch_samples,
-                          int num_channels) {
-      auto encoder_status =
-          lc3_encode(encoder, LC3_PCM_FORMAT_S16,
-                     (int16_t*)(data.data() + initial_channel_offset),
-                     pitch_samples, out_buffer.size(), out_buffer.data());
-      if (encoder_status != 0) {
-        LOG_ERROR("Encoding error=%d", encoder_status);
-      }
+    void RemoveBroadcast(uint32_t broadcast_id) {
+      broadcast_tiers_.erase(broadcast_id);
     }
 
     static void sendBroadcastData(
         const std::unique_ptr<BroadcastStateMachine>& broadcast,
-        std::vector<std::vector<uint8_t>>& encoded_channels) {
+        const std::vector<std::vector<uint8_t>>& encoded_channels) {
       auto const& config = broadcast->GetBigConfig();
       if (config == std::nullopt) {
         LOG_ERROR(
@@ -822,27 +818,31 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
 
       LOG_VERBOSE("Received %zu bytes.", data.size());
 
-      /* Constants for the channel data configuration */
-      const auto num_channels = codec_wrapper_.GetNumChannels();
-      const auto bytes_per_sample = (codec_wrapper_.GetBitsPerSample() / 8);
-
-      /* Prepare encoded data for all channels */
-      for (uint8_t chan = 0; chan < num_channels; ++chan) {
-        /* TODO: Use encoder agnostic wrapper */
-        encodeLc3Channel(encoders_[chan], enc_audio_buffers_[chan], data,
-                         chan * bytes_per_sample, num_channels, num_channels);
-      }
-
-      /* Currently there is no way to broadcast multiple distinct streams.
-       * We just receive all system sounds mixed into a one stream and each
-       * broadcast gets the same data.
+      /* There is a single stream of all the system sounds mixed together.
+       * Each tier is encoded once, on the first broadcast needing it, and its
+       * frames are sent on the BISes of every broadcast using it.
        */
+      tier_status_.assign(encoder_pipeline_.GetTierCount(),
+                          TierStatus::NOT_ENCODED);
       for (auto& broadcast_pair : instance->broadcasts_) {
         auto& broadcast = broadcast_pair.second;
-        if ((broadcast->GetState() ==
-             BroadcastStateMachine::State::STREAMING) &&
-            !broadcast->IsMuted())
-          sendBroadcastData(broadcast, enc_audio_buffers_);
+        if ((broadcast->GetState() !=
+             BroadcastStateMachine::State::STREAMING) ||
+            broadcast->IsMuted())
+          continue;
+
+        auto tier_it = broadcast_tiers_.find(broadcast_pair.first);
+        if (tier_it == broadcast_tiers_.end()) continue;
+
+        auto tier = tier_it->second;
+        if (tier_status_[tier] == TierStatus::NOT_ENCODED) {
+          tier_status_[tier] = encoder_pipeline_.Encode(tier, data)
+                                   ? TierStatus::ENCODED
+                                   : TierStatus::FAILED;
+        }
+        if (tier_status_[tier] == TierStatus::ENCODED)
+          sendBroadcastData(broadcast,
+                            encoder_pipeline_.GetEncodedChannels(tier));
       }
       LOG_VERBOSE("All data sent.");
     }
@@ -893,10 +893,13 @@ class LeAudioBroadcasterImpl : public LeAudioBroadcaster, public BigCallbacks {
     }
 
    private:
-    BroadcastCodecWrapper codec_wrapper_;
-    std::vector<lc3_encoder_t> encoders_;
-    std::vector<std::unique_ptr<void, decltype(&std::free)>> encoders_mem_;
-    std::vector<std::vector<uint8_t>> enc_audio_buffers_;
+    enum class TierStatus : uint8_t { NOT_ENCODED, ENCODED, FAILED };
+
+    EncoderPipeline encoder_pipeline_;
+    /* Encoder tier of each streaming broadcast */
+    std::map<uint32_t, int> broadcast_tiers_;
+    /* Per frame encoding status of each tier, kept to reuse the allocation */
+    std::vector<TierStatus> tier_status_;
   } audio_receiver_;
 
   bluetooth::le_audio::LeAudioBroadcasterCallbacks* callbacks_;
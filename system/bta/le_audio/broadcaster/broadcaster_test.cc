@@ -353,6 +353,51 @@ TEST_F(BroadcasterTest, StartAudioBroadcastMedia) {
   audio_receiver->OnAudioDataReady(sample_data);
 }
 
+TEST_F(BroadcasterTest, StartConcurrentAudioBroadcasts) {
+  auto media_broadcast_id = InstantiateBroadcast(media_metadata);
+  auto media_broadcast = MockBroadcastStateMachine::GetLastInstance();
+  auto broadcast_id = InstantiateBroadcast();
+  auto broadcast = MockBroadcastStateMachine::GetLastInstance();
+  LeAudioBroadcaster::Get()->StopAudioBroadcast(media_broadcast_id);
+  LeAudioBroadcaster::Get()->StopAudioBroadcast(broadcast_id);
+
+  // The audio source is started once, for the first broadcast
+  LeAudioClientAudioSinkReceiver* audio_receiver;
+  EXPECT_CALL(*mock_audio_source_, Start)
+      .WillOnce(DoAll(SaveArg<1>(&audio_receiver), Return(true)));
+
+  LeAudioBroadcaster::Get()->StartAudioBroadcast(media_broadcast_id);
+  LeAudioBroadcaster::Get()->StartAudioBroadcast(broadcast_id);
+  ASSERT_NE(audio_receiver, nullptr);
+
+  BigConfig big_cfg;
+  big_cfg.big_id = media_broadcast->GetAdvertisingSid();
+  big_cfg.connection_handles = {0x10, 0x12};
+  big_cfg.max_pdu = 128;
+  media_broadcast->SetExpectedBigConfig(big_cfg);
+  big_cfg.big_id = broadcast->GetAdvertisingSid();
+  big_cfg.connection_handles = {0x14};
+  broadcast->SetExpectedBigConfig(big_cfg);
+
+  // The stereo 48kHz input feeds the stereo media BISes and, downsampled, the
+  // mono BIS of the other broadcast.
+  EXPECT_CALL(*MockIsoManager::GetInstance(), SendIsoData(0x10, _, _)).Times(1);
+  EXPECT_CALL(*MockIsoManager::GetInstance(), SendIsoData(0x12, _, _)).Times(1);
+  EXPECT_CALL(*MockIsoManager::GetInstance(), SendIsoData(0x14, _, _)).Times(1);
+  std::vector<uint8_t> sample_data(1920, 0);
+  audio_receiver->OnAudioDataReady(sample_data);
+
+  // The source keeps running for the remaining broadcast
+  EXPECT_CALL(*mock_audio_source_, Stop).Times(0);
+  LeAudioBroadcaster::Get()->StopAudioBroadcast(broadcast_id);
+  Mock::VerifyAndClearExpectations(mock_audio_source_);
+
+  EXPECT_CALL(*MockIsoManager::GetInstance(), SendIsoData(0x10, _, _)).Times(1);
+  EXPECT_CALL(*MockIsoManager::GetInstance(), SendIsoData(0x12, _, _)).Times(1);
+  EXPECT_CALL(*MockIsoManager::GetInstance(), SendIsoData(0x14, _, _)).Times(0);
+  audio_receiver->OnAudioDataReady(sample_data);
+}
+
 TEST_F(BroadcasterTest, StopAudioBroadcast) {
   auto broadcast_id = InstantiateBroadcast();
   LeAudioBroadcaster::Get()->StartAudioBroadcast(broadcast_id);
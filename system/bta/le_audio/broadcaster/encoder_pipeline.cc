@@ -0,0 +1,128 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bta/le_audio/broadcaster/encoder_pipeline.h"
+
+#include <algorithm>
+
+#include "osi/include/log.h"
+
+namespace le_audio {
+namespace broadcaster {
+
+void EncoderPipeline::SetInput(uint8_t num_channels, uint32_t sample_rate,
+                               uint32_t data_interval_us) {
+  input_num_channels_ = num_channels;
+  input_sample_rate_ = sample_rate;
+  input_data_interval_us_ = data_interval_us;
+  ClearTiers();
+}
+
+int EncoderPipeline::AddTier(const EncoderTierConfig& config) {
+  auto it = std::find_if(tiers_.begin(), tiers_.end(), [&config](auto& tier) {
+    return tier.config == config;
+  });
+  if (it != tiers_.end()) return std::distance(tiers_.begin(), it);
+
+  /* The input is read one frame interval at a time and LC3 can only
+   * downsample it.
+   */
+  if ((config.num_channels == 0) ||
+      (config.num_channels > input_num_channels_) ||
+      (config.sample_rate > input_sample_rate_) ||
+      (config.data_interval_us != input_data_interval_us_)) {
+    LOG_ERROR(
+        "Can't encode %d channels at %d Hz every %d us from %d channels at %d "
+        "Hz every %d us",
+        config.num_channels, config.sample_rate, config.data_interval_us,
+        input_num_channels_, input_sample_rate_, input_data_interval_us_);
+    return -1;
+  }
+
+  const int dt_us = config.data_interval_us;
+  const int sr_hz = config.sample_rate;
+  const int sr_pcm_hz = input_sample_rate_;
+  const auto encoder_bytes = lc3_encoder_size(dt_us, sr_pcm_hz);
+  if (encoder_bytes == 0) {
+    LOG_ERROR("Invalid LC3 configuration dt_us=%d sr_hz=%d", dt_us, sr_pcm_hz);
+    return -1;
+  }
+
+  Tier tier;
+  tier.config = config;
+  while (tier.encoders.size() < config.num_channels) {
+    tier.encoders_mem.emplace_back(malloc(encoder_bytes), &std::free);
+    tier.encoders.emplace_back(lc3_setup_encoder(
+        dt_us, sr_hz, sr_pcm_hz, tier.encoders_mem.back().get()));
+    if (tier.encoders.back() == nullptr) {
+      LOG_ERROR("Invalid LC3 configuration dt_us=%d sr_hz=%d", dt_us, sr_hz);
+      return -1;
+    }
+  }
+  tier.channels.resize(config.num_channels,
+                       std::vector<uint8_t>(config.octets_per_frame));
+  for (auto& channel : tier.channels) tier.outs.push_back(channel.data());
+
+  LOG_INFO("tier=%zu: %d channels at %d Hz, %d octets", tiers_.size(),
+           config.num_channels, config.sample_rate, config.octets_per_frame);
+  tiers_.push_back(std::move(tier));
+  return tiers_.size() - 1;
+}
+
+void EncoderPipeline::ClearTiers() { tiers_.clear(); }
+
+bool EncoderPipeline::Encode(size_t tier_idx,
+                             const std::vector<uint8_t>& pcm) {
+  if (tier_idx >= tiers_.size()) return false;
+  auto& tier = tiers_[tier_idx];
+
+  const size_t frame_bytes =
+      lc3_frame_samples(input_data_interval_us_, input_sample_rate_) *
+      input_num_channels_ * sizeof(int16_t);
+  if (pcm.size() < frame_bytes) {
+    LOG_ERROR("Incomplete frame: %zu bytes, expected %zu", pcm.size(),
+              frame_bytes);
+    return false;
+  }
+
+  const int nbytes = tier.config.octets_per_frame;
+  int encoder_status = 0;
+  if (tier.config.num_channels == input_num_channels_) {
+    /* All the channels of the input, encoded in one pass over the
+     * interleaved PCM data.
+     */
+    encoder_status = lc3_encode_channels(
+        tier.encoders.data(), tier.encoders.size(), LC3_PCM_FORMAT_S16,
+        pcm.data(), nbytes, tier.outs.data());
+  } else {
+    auto samples = reinterpret_cast<const int16_t*>(pcm.data());
+    for (size_t ch = 0; ch < tier.encoders.size() && encoder_status == 0;
+         ++ch) {
+      encoder_status = lc3_encode(tier.encoders[ch], LC3_PCM_FORMAT_S16,
+                                  samples + ch, input_num_channels_, nbytes,
+                                  tier.channels[ch].data());
+    }
+  }
+
+  if (encoder_status != 0) {
+    LOG_ERROR("Encoding error=%d", encoder_status);
+    return false;
+  }
+  return true;
+}
+
+}  // namespace broadcaster
+}  // namespace le_audio
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include "embdrv/lc3/include/lc3.h"
+
+namespace le_audio {
+namespace broadcaster {
+
+/* Encoding parameters of a quality tier. Broadcasts with the same tier share
+ * its encoded frames.
+ */
+struct EncoderTierConfig {
+  uint8_t num_channels;
+  uint32_t sample_rate;
+  uint32_t data_interval_us;
+  uint16_t octets_per_frame;
+
+  bool operator==(const EncoderTierConfig& other) const {
+    return (num_channels == other.num_channels) &&
+           (sample_rate == other.sample_rate) &&
+           (data_interval_us == other.data_interval_us) &&
+           (octets_per_frame == other.octets_per_frame);
+  }
+};
+
+/* Encodes one interleaved 16 bit PCM input for several concurrent broadcasts.
+ *
+ * Each tier is encoded once per frame interval, whatever the number of BIGs
+ * and BISes it feeds. A tier at a lower sample rate than the input is
+ * downsampled by the LC3 encoder itself. The encoded frames stay in buffers
+ * owned by the tier, which are reused from one interval to the next and read
+ * in place by every BIS sending them.
+ */
+class EncoderPipeline {
+ public:
+  /* Sets the format of the PCM input and drops all the tiers */
+  void SetInput(uint8_t num_channels, uint32_t sample_rate,
+                uint32_t data_interval_us);
+
+  /* Returns the index of the tier encoding |config|, adding it if needed, or
+   * -1 if it can't be encoded from the input.
+   */
+  int AddTier(const EncoderTierConfig& config);
+  void ClearTiers();
+  size_t GetTierCount() const { return tiers_.size(); }
+
+  /* Encodes a frame of the input for |tier|. Returns false on error. */
+  bool Encode(size_t tier, const std::vector<uint8_t>& pcm);
+
+  /* Encoded frame of each channel of |tier|, valid until the next Encode() */
+  const std::vector<std::vector<uint8_t>>& GetEncodedChannels(
+      size_t tier) const {
+    return tiers_[tier].channels;
+  }
+
+ private:
+  struct Tier {
+    EncoderTierConfig config;
+    std::vector<lc3_encoder_t> encoders;
+    std::vector<std::unique_ptr<void, decltype(&std::free)>> encoders_mem;
+    std::vector<std::vector<uint8_t>> channels;
+    /* Data of |channels|, which are never resized */
+    std::vector<void*> outs;
+  };
+
+  uint8_t input_num_channels_ = 0;
+  uint32_t input_sample_rate_ = 0;
+  uint32_t input_data_interval_us_ = 0;
+  std::vector<Tier> tiers_;
+};
+
+}  // namespace broadcaster
+}  // namespace le_audio
@@ -38,6 +38,7 @@
 #include "embdrv/lc3/include/lc3.h"
 #include "gatt/bta_gattc_int.h"
 #include "gd/common/strings.h"
+#include "gd/os/trace.h"
 #include "internal_include/stack_config.h"
 #include "le_audio_set_configuration_provider.h"
 #include "le_audio_types.h"
@@ -212,6 +213,8 @@ class LeAudioClientImpl : public LeAudioClient {
   ~LeAudioClientImpl() {
     alarm_free(suspend_timeout_);
     suspend_timeout_ = nullptr;
+    alarm_free(standby_timeout_);
+    standby_timeout_ = nullptr;
   };
 
   LeAudioClientImpl(
@@ -227,6 +230,7 @@ class LeAudioClientImpl : public LeAudioClient {
                 LeAudioContextType::MEDIA)),
         stream_setup_start_timestamp_(0),
         stream_setup_end_timestamp_(0),
+        stream_setup_warm_start_(false),
         audio_receiver_state_(AudioState::IDLE),
         audio_sender_state_(AudioState::IDLE),
         in_call_(false),
@@ -240,7 +244,8 @@ class LeAudioClientImpl : public LeAudioClient {
         lc3_decoder_right(nullptr),
         audio_source_instance_(nullptr),
         audio_sink_instance_(nullptr),
-        suspend_timeout_(alarm_new("LeAudioSuspendTimeout")) {
+        suspend_timeout_(alarm_new("LeAudioSuspendTimeout")),
+        standby_timeout_(alarm_new("LeAudioStandbyTimeout")) {
     LeAudioGroupStateMachine::Initialize(state_machine_callbacks_);
     groupStateMachine_ = LeAudioGroupStateMachine::Get();
 
@@ -738,13 +743,19 @@ class LeAudioClientImpl : public LeAudioClient {
       return false;
     }
 
+    bool warm_start =
+        (group->GetState() == AseState::BTA_LE_AUDIO_ASE_STATE_QOS_CONFIGURED);
     bool result = groupStateMachine_->StartStream(
         group, static_cast<LeAudioContextType>(final_context_type),
         adjusted_metadata_context_type,
         GetAllCcids(adjusted_metadata_context_type));
-    if (result)
+    if (result) {
+      if (alarm_is_scheduled(standby_timeout_)) alarm_cancel(standby_timeout_);
       stream_setup_start_timestamp_ =
           bluetooth::common::time_get_os_boottime_us();
+      stream_setup_end_timestamp_ = 0;
+      stream_setup_warm_start_ = warm_start;
+    }
 
     return result;
   }
@@ -785,6 +796,8 @@ class LeAudioClientImpl : public LeAudioClient {
   void GroupStop(const int group_id) override {
     LeAudioDeviceGroup* group = aseGroups_.FindById(group_id);
 
+    if (alarm_is_scheduled(standby_timeout_)) alarm_cancel(standby_timeout_);
+
     if (!group) {
       LOG(ERROR) << __func__ << ", unknown group id: " << group_id;
       return;
@@ -1897,6 +1910,7 @@ class LeAudioClientImpl : public LeAudioClient {
 
         leAudioDevice->snk_pacs_.push_back(std::make_tuple(
             hdl_pair, std::vector<struct le_audio::types::acs_ac_record>()));
+        leAudioDevice->InvalidatePacIndex();
 
         LOG(INFO) << "Found Sink PAC characteristic, handle: "
                   << loghex(charac.value_handle)
@@ -1927,6 +1941,7 @@ class LeAudioClientImpl : public LeAudioClient {
 
         leAudioDevice->src_pacs_.push_back(std::make_tuple(
             hdl_pair, std::vector<struct le_audio::types::acs_ac_record>()));
+        leAudioDevice->InvalidatePacIndex();
 
         LOG(INFO) << "Found Source PAC characteristic, handle: "
                   << loghex(charac.value_handle)
@@ -2285,9 +2300,9 @@ class LeAudioClientImpl : public LeAudioClient {
   }
 
   // mix stero signal into mono
-  std::vector<uint8_t> mono_blend(const std::vector<uint8_t>& buf,
-                                  int bytes_per_sample, size_t frames) {
-    std::vector<uint8_t> mono_out;
+  const std::vector<uint8_t>& mono_blend(const std::vector<uint8_t>& buf,
+                                         int bytes_per_sample, size_t frames) {
+    std::vector<uint8_t>& mono_out = mono_blend_buffer_;
     mono_out.resize(frames * bytes_per_sample);
 
     if (bytes_per_sample == 2) {
@@ -2349,28 +2364,30 @@ class LeAudioClientImpl : public LeAudioClient {
       return;
     }
 
-    std::vector<uint8_t> chan_left_enc(byte_count, 0);
-    std::vector<uint8_t> chan_right_enc(byte_count, 0);
+    /* Encode in place into the SDUs. The frames of a dropped SDU are still
+     * encoded, to keep the encoder state going.
+     */
+    uint8_t* chan_left_enc = GetSduBuffer(left_cis_handle, byte_count, 0);
+    uint8_t* chan_right_enc = GetSduBuffer(right_cis_handle, byte_count, 1);
 
     bool mono = (left_cis_handle == 0) || (right_cis_handle == 0);
 
     if (!mono) {
-      lc3_encode(lc3_encoder_left, bits_per_sample, data.data(), 2,
-                 chan_left_enc.size(), chan_left_enc.data());
-      lc3_encode(lc3_encoder_right, bits_per_sample,
-                 data.data() + bytes_per_sample, 2, chan_right_enc.size(),
-                 chan_right_enc.data());
+      lc3_encoder_t encoders[] = {lc3_encoder_left, lc3_encoder_right};
+      void* outs[] = {chan_left_enc, chan_right_enc};
+      lc3_encode_channels(encoders, 2, bits_per_sample, data.data(),
+                          byte_count, outs);
     } else {
-      std::vector<uint8_t> mono = mono_blend(
+      const std::vector<uint8_t>& mono = mono_blend(
           data, bytes_per_sample, number_of_required_samples_per_channel);
       if (left_cis_handle) {
         lc3_encode(lc3_encoder_left, bits_per_sample, mono.data(), 1,
-                   chan_left_enc.size(), chan_left_enc.data());
+                   byte_count, chan_left_enc);
       }
 
       if (right_cis_handle) {
         lc3_encode(lc3_encoder_right, bits_per_sample, mono.data(), 1,
-                   chan_right_enc.size(), chan_right_enc.data());
+                   byte_count, chan_right_enc);
       }
     }
 
@@ -2378,12 +2395,10 @@ class LeAudioClientImpl : public LeAudioClient {
                << " right_cis_handle: " << right_cis_handle;
     /* Send data to the controller */
     if (left_cis_handle)
-      IsoManager::GetInstance()->SendIsoData(
-          left_cis_handle, chan_left_enc.data(), chan_left_enc.size());
+      IsoManager::GetInstance()->SendIsoSduBuffer(left_cis_handle);
 
     if (right_cis_handle)
-      IsoManager::GetInstance()->SendIsoData(
-          right_cis_handle, chan_right_enc.data(), chan_right_enc.size());
+      IsoManager::GetInstance()->SendIsoSduBuffer(right_cis_handle);
   }
 
   void PrepareAndSendToSingleCis(
@@ -2407,31 +2422,44 @@ class LeAudioClientImpl : public LeAudioClient {
       LOG(ERROR) << __func__ << "Missing samples";
       return;
     }
-    std::vector<uint8_t> chan_encoded(num_channels * byte_count, 0);
+    uint8_t* chan_encoded =
+        GetSduBuffer(cis_handle, num_channels * byte_count, 0);
 
     if (num_channels == 1) {
       /* Since we always get two channels from framework, lets make it mono here
        */
-      std::vector<uint8_t> mono = mono_blend(
+      const std::vector<uint8_t>& mono = mono_blend(
           data, bytes_per_sample, number_of_required_samples_per_channel);
 
       auto err = lc3_encode(lc3_encoder_left, bits_per_sample, mono.data(), 1,
-                            byte_count, chan_encoded.data());
+                            byte_count, chan_encoded);
 
       if (err < 0) {
         LOG(ERROR) << " error while encoding, error code: " << +err;
       }
     } else {
-      lc3_encode(lc3_encoder_left, bits_per_sample, (const int16_t*)data.data(),
-                 2, byte_count, chan_encoded.data());
-      lc3_encode(lc3_encoder_right, bits_per_sample,
-                 (const int16_t*)data.data() + 1, 2, byte_count,
-                 chan_encoded.data() + byte_count);
+      lc3_encoder_t encoders[] = {lc3_encoder_left, lc3_encoder_right};
+      void* outs[] = {chan_encoded, chan_encoded + byte_count};
+      lc3_encode_channels(encoders, 2, bits_per_sample, data.data(),
+                          byte_count, outs);
     }
 
     /* Send data to the controller */
-    IsoManager::GetInstance()->SendIsoData(cis_handle, chan_encoded.data(),
-                                           chan_encoded.size());
+    IsoManager::GetInstance()->SendIsoSduBuffer(cis_handle);
+  }
+
+  /* Returns the buffer of the next SDU of |cis_handle|, or a scratch buffer
+   * if there's no CIS or the SDU would be dropped.
+   */
+  uint8_t* GetSduBuffer(uint16_t cis_handle, uint16_t len, int scratch_idx) {
+    uint8_t* buf = nullptr;
+    if (cis_handle)
+      buf = IsoManager::GetInstance()->GetIsoSduBuffer(cis_handle, len);
+    if (buf) return buf;
+
+    std::vector<uint8_t>& scratch = encoded_scratch_[scratch_idx];
+    scratch.resize(len);
+    return scratch.data();
   }
 
   const struct le_audio::stream_configuration* GetStreamSinkConfiguration(
@@ -2451,6 +2479,7 @@ class LeAudioClientImpl : public LeAudioClient {
     if ((active_group_id_ == bluetooth::groups::kGroupUnknown) ||
         (audio_sender_state_ != AudioState::STARTED))
       return;
+    OS_TRACE_SCOPE("LeAudioClient::IsoEncodeTick");
 
     LeAudioDeviceGroup* group = aseGroups_.FindById(active_group_id_);
     if (!group) {
@@ -2896,6 +2925,7 @@ class LeAudioClientImpl : public LeAudioClient {
 
   void Cleanup(base::Callback<void()> cleanupCb) {
     if (alarm_is_scheduled(suspend_timeout_)) alarm_cancel(suspend_timeout_);
+    if (alarm_is_scheduled(standby_timeout_)) alarm_cancel(standby_timeout_);
 
     if (active_group_id_ != bluetooth::groups::kGroupUnknown) {
       /* Bluetooth turned off while streaming */
@@ -3005,11 +3035,37 @@ class LeAudioClientImpl : public LeAudioClient {
     alarm_set_on_mloop(
         suspend_timeout_, timeoutMs,
         [](void* data) {
-          if (instance) instance->GroupStop(PTR_TO_INT(data));
+          if (instance) instance->OnSuspendTimeout(PTR_TO_INT(data));
         },
         INT_TO_PTR(active_group_id_));
   }
 
+  void OnSuspendTimeout(int group_id) {
+    uint64_t timeoutMs = kAudioStandbyTimeoutMs;
+    timeoutMs = osi_property_get_int32(kAudioStandbyTimeoutMsProp, timeoutMs);
+
+    LeAudioDeviceGroup* group = aseGroups_.FindById(group_id);
+    if (timeoutMs == 0 || group == nullptr || group->IsInTransition() ||
+        group->GetState() != AseState::BTA_LE_AUDIO_ASE_STATE_STREAMING) {
+      GroupStop(group_id);
+      return;
+    }
+
+    /* Warm standby: disable the ASEs but keep the CIG and the QoS
+     * configuration, so that the next stream only has to be enabled. The
+     * group is released if it stays unused.
+     */
+    LOG_DEBUG("Stream standby_timeout_ started: %d ms",
+              static_cast<int>(timeoutMs));
+    GroupSuspend(group_id);
+    alarm_set_on_mloop(
+        standby_timeout_, timeoutMs,
+        [](void* data) {
+          if (instance) instance->GroupStop(PTR_TO_INT(data));
+        },
+        INT_TO_PTR(group_id));
+  }
+
   void OnAudioSinkSuspend() {
     LOG_DEBUG(" IN: audio_receiver_state_: %s,  audio_sender_state_: %s",
               ToString(audio_receiver_state_).c_str(),
@@ -3379,12 +3435,17 @@ class LeAudioClientImpl : public LeAudioClient {
       return false;
     }
 
-    if (group->GetState() != AseState::BTA_LE_AUDIO_ASE_STATE_STREAMING) {
+    /* The QoS configuration of a suspended group belongs to the previous
+     * context as well.
+     */
+    if (group->GetState() != AseState::BTA_LE_AUDIO_ASE_STATE_STREAMING &&
+        group->GetState() != AseState::BTA_LE_AUDIO_ASE_STATE_QOS_CONFIGURED) {
       DLOG(INFO) << __func__ << " Group is not streaming ";
       return false;
     }
 
     if (alarm_is_scheduled(suspend_timeout_)) alarm_cancel(suspend_timeout_);
+    if (alarm_is_scheduled(standby_timeout_)) alarm_cancel(standby_timeout_);
 
     /* Need to reconfigure stream */
     group->SetPendingConfiguration();
@@ -3660,6 +3721,9 @@ class LeAudioClientImpl : public LeAudioClient {
         LeAudioDeviceGroup* group =
             aseGroups_.FindById(leAudioDevice->group_id_);
 
+        le_audio::MetricsCollector::Get()->OnIsoDataPathStats(
+            leAudioDevice->group_id_, event->data_path_stats);
+
         groupStateMachine_->ProcessHciNotifCisDisconnected(group, leAudioDevice,
                                                            event);
       } break;
@@ -3811,8 +3875,18 @@ class LeAudioClientImpl : public LeAudioClient {
         if (audio_receiver_state_ == AudioState::READY_TO_START)
           StartReceivingAudio(group_id);
 
-        stream_setup_end_timestamp_ =
-            bluetooth::common::time_get_os_boottime_us();
+        /* Record the setup time once per stream */
+        if (stream_setup_start_timestamp_ > 0 &&
+            stream_setup_end_timestamp_ == 0) {
+          stream_setup_end_timestamp_ =
+              bluetooth::common::time_get_os_boottime_us();
+          le_audio::MetricsCollector::Get()->OnStreamSetupCompleted(
+              group_id, stream_setup_warm_start_,
+              stream_setup_end_timestamp_ - stream_setup_start_timestamp_);
+        } else {
+          stream_setup_end_timestamp_ =
+              bluetooth::common::time_get_os_boottime_us();
+        }
         le_audio::MetricsCollector::Get()->OnStreamStarted(
             active_group_id_, configuration_context_type_);
         break;
@@ -3899,6 +3973,8 @@ class LeAudioClientImpl : public LeAudioClient {
   AudioContexts metadata_context_types_;
   uint64_t stream_setup_start_timestamp_;
   uint64_t stream_setup_end_timestamp_;
+  /* The stream was resumed from the QoS configured state */
+  bool stream_setup_warm_start_;
 
   /* Microphone (s) */
   AudioState audio_receiver_state_;
@@ -3943,12 +4019,21 @@ class LeAudioClientImpl : public LeAudioClient {
   lc3_decoder_t lc3_decoder_right;
 
   std::vector<uint8_t> encoded_data;
+  std::vector<uint8_t> mono_blend_buffer_;
+  std::vector<uint8_t> encoded_scratch_[2];
   const void* audio_source_instance_;
   const void* audio_sink_instance_;
   static constexpr uint64_t kAudioSuspentKeepIsoAliveTimeoutMs = 5000;
   static constexpr char kAudioSuspentKeepIsoAliveTimeoutMsProp[] =
       "persist.bluetooth.leaudio.audio.suspend.timeoutms";
   alarm_t* suspend_timeout_;
+  /* 0 disables the warm standby: the group is released at the end of the
+   * suspend timeout.
+   */
+  static constexpr uint64_t kAudioStandbyTimeoutMs = 0;
+  static constexpr char kAudioStandbyTimeoutMsProp[] =
+      "persist.bluetooth.leaudio.audio.standby.timeoutms";
+  alarm_t* standby_timeout_;
   static constexpr uint64_t kDeviceAttachDelayMs = 500;
 
   std::vector<int16_t> cached_channel_data_;
@@ -4274,6 +4359,7 @@ void LeAudioClient::DebugDump(int fd) {
   LeAudioUnicastClientAudioSource::DebugDump(fd);
   LeAudioUnicastClientAudioSink::DebugDump(fd);
   le_audio::AudioSetConfigurationProvider::Get()->DebugDump(fd);
+  le_audio::MetricsCollector::Get()->Dump(fd);
   IsoManager::GetInstance()->Dump(fd);
   dprintf(fd, "\n");
 }
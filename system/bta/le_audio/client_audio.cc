@@ -19,10 +19,13 @@
 
 #include "client_audio.h"
 
+#include <algorithm>
+
 #include "audio_hal_interface/le_audio_software.h"
 #include "bta/le_audio/codec_manager.h"
 #include "btu.h"
 #include "common/time_util.h"
+#include "osi/include/properties.h"
 #include "osi/include/wakelock.h"
 
 using bluetooth::audio::le_audio::LeAudioClientInterface;
@@ -32,6 +35,12 @@ using ::le_audio::types::CodecLocation;
 namespace {
 LeAudioClientInterface* leAudioClientInterface = nullptr;
 
+/* Encode each frame as soon as the audio HAL provided it in full, rather than
+ * reading whatever data it provided on each timer tick.
+ */
+constexpr char kEventDrivenTicksProp[] =
+    "persist.bluetooth.leaudio.source.event_driven_ticks";
+
 enum {
   HAL_UNINITIALIZED,
   HAL_STOPPED,
@@ -44,12 +53,30 @@ struct AudioHalStats {
   size_t media_read_total_underflow_count;
   uint64_t media_read_last_underflow_us;
 
+  /* Timing of the audio ticks, and of the encoding and sending of their data
+   * to the ISO channels.
+   */
+  size_t tick_count;
+  size_t tick_late_count;
+  uint64_t tick_max_jitter_us;
+  uint64_t last_tick_us;
+  uint64_t process_total_us;
+  uint64_t process_max_us;
+  size_t process_overrun_count;
+
   AudioHalStats() { Reset(); }
 
   void Reset() {
     media_read_total_underflow_bytes = 0;
     media_read_total_underflow_count = 0;
     media_read_last_underflow_us = 0;
+    tick_count = 0;
+    tick_late_count = 0;
+    tick_max_jitter_us = 0;
+    last_tick_us = 0;
+    process_total_us = 0;
+    process_max_us = 0;
+    process_overrun_count = 0;
   }
 };
 
@@ -82,17 +109,23 @@ bool LeAudioClientAudioSource::SinkOnResumeReq(bool start_media_task) {
 }
 
 void LeAudioClientAudioSource::SendAudioData() {
-  // 24 bit audio is aligned to 32bit
-  int bytes_per_sample = (source_codec_config_.bits_per_sample == 24)
-                             ? 4
-                             : (source_codec_config_.bits_per_sample / 8);
+  uint64_t tick_us = bluetooth::common::time_get_os_boottime_us();
+  uint64_t interval_us = source_codec_config_.data_interval_us;
+  if (stats.last_tick_us != 0) {
+    uint64_t period_us = tick_us - stats.last_tick_us;
+    uint64_t jitter_us = (period_us > interval_us) ? period_us - interval_us
+                                                   : interval_us - period_us;
+    stats.tick_max_jitter_us = std::max(stats.tick_max_jitter_us, jitter_us);
+    if (period_us > interval_us + interval_us / 2) stats.tick_late_count++;
+  }
+  stats.last_tick_us = tick_us;
+  stats.tick_count++;
 
-  uint32_t bytes_per_tick =
-      (source_codec_config_.num_channels * source_codec_config_.sample_rate *
-       source_codec_config_.data_interval_us / 1000 * bytes_per_sample) /
-      1000;
+  uint32_t bytes_per_tick = GetBytesPerTick();
 
-  std::vector<uint8_t> data(bytes_per_tick);
+  // Reused across the ticks, it is only reallocated if the codec config grows
+  std::vector<uint8_t>& data = audio_data_;
+  data.resize(bytes_per_tick);
 
   uint32_t bytes_read = 0;
   if (sinkClientInterface_ != nullptr) {
@@ -116,6 +149,12 @@ void LeAudioClientAudioSource::SendAudioData() {
   if (audioSinkReceiver_ != nullptr) {
     audioSinkReceiver_->OnAudioDataReady(data);
   }
+
+  /* The data must be encoded and sent before the next tick */
+  uint64_t process_us = bluetooth::common::time_get_os_boottime_us() - tick_us;
+  stats.process_total_us += process_us;
+  stats.process_max_us = std::max(stats.process_max_us, process_us);
+  if (process_us > interval_us) stats.process_overrun_count++;
 }
 
 bool LeAudioClientAudioSource::InitAudioSinkThread(const std::string name) {
@@ -136,8 +175,58 @@ bool LeAudioClientAudioSource::InitAudioSinkThread(const std::string name) {
   return true;
 }
 
+uint32_t LeAudioClientAudioSource::GetBytesPerTick() const {
+  // 24 bit audio is aligned to 32bit
+  int bytes_per_sample = (source_codec_config_.bits_per_sample == 24)
+                             ? 4
+                             : (source_codec_config_.bits_per_sample / 8);
+
+  return (source_codec_config_.num_channels * source_codec_config_.sample_rate *
+          source_codec_config_.data_interval_us / 1000 * bytes_per_sample) /
+         1000;
+}
+
+void LeAudioClientAudioSource::SendAudioDataWhenReady(uint64_t generation) {
+  if (generation != event_driven_generation_) return;
+
+  uint64_t wait_start_us = bluetooth::common::time_get_os_boottime_us();
+  uint64_t interval_us = source_codec_config_.data_interval_us;
+  bool frame_ready =
+      sinkClientInterface_ != nullptr &&
+      sinkClientInterface_->WaitForData(GetBytesPerTick(), interval_us / 1000);
+  SendAudioData();
+
+  auto next = base::BindOnce(&LeAudioClientAudioSource::SendAudioDataWhenReady,
+                             base::Unretained(this), generation);
+  if (frame_ready) {
+    // The next wait blocks until the HAL provided the next frame
+    worker_thread_->DoInThread(FROM_HERE, std::move(next));
+    return;
+  }
+  // The frame did not come in time, or the HAL cannot signal it: retry one
+  // interval after this wait started, as a timer tick would
+  uint64_t elapsed_us =
+      bluetooth::common::time_get_os_boottime_us() - wait_start_us;
+  uint64_t delay_us = elapsed_us < interval_us ? interval_us - elapsed_us : 0;
+  worker_thread_->DoInThreadDelayed(FROM_HERE, std::move(next),
+#if BASE_VER < 931007
+                                    base::TimeDelta::FromMicroseconds(delay_us));
+#else
+                                    base::Microseconds(delay_us));
+#endif
+}
+
 void LeAudioClientAudioSource::StartAudioTicks() {
   wakelock_acquire();
+  stats.last_tick_us = 0;
+  if (osi_property_get_bool(kEventDrivenTicksProp, false)) {
+    event_driven_ticks_ = true;
+    worker_thread_->DoInThread(
+        FROM_HERE,
+        base::BindOnce(&LeAudioClientAudioSource::SendAudioDataWhenReady,
+                       base::Unretained(this), ++event_driven_generation_));
+    return;
+  }
   audio_timer_.SchedulePeriodic(
       worker_thread_->GetWeakPtr(), FROM_HERE,
       base::Bind(&LeAudioClientAudioSource::SendAudioData,
@@ -150,7 +239,25 @@ void LeAudioClientAudioSource::StartAudioTicks() {
 }
 
 void LeAudioClientAudioSource::StopAudioTicks() {
-  audio_timer_.CancelAndWait();
+  if (event_driven_ticks_) {
+    event_driven_ticks_ = false;
+    // Stops the pending SendAudioDataWhenReady(), then waits for the one that
+    // may be running, as cancelling the timer would
+    event_driven_generation_++;
+    if (worker_thread_->GetThreadId() != base::PlatformThread::CurrentId()) {
+      std::promise<void> promise;
+      auto future = promise.get_future();
+      if (worker_thread_->DoInThread(
+              FROM_HERE,
+              base::BindOnce([](std::promise<void> promise) {
+                promise.set_value();
+              }, std::move(promise)))) {
+        future.wait();
+      }
+    }
+  } else {
+    audio_timer_.CancelAndWait();
+  }
   wakelock_release();
 }
 
@@ -496,7 +603,19 @@ void LeAudioClientAudioSource::DebugDump(int fd) {
                                         stats.media_read_last_underflow_us) /
                        1000
                  : 0)
-         << std::endl;
+         << "\n    Counts (audio ticks)                                    : "
+         << stats.tick_count
+         << "\n    Counts (late audio ticks)                               : "
+         << stats.tick_late_count
+         << "\n    Max. tick jitter in us                                  : "
+         << stats.tick_max_jitter_us
+         << "\n    Avg. encode and send time in us                         : "
+         << (stats.tick_count > 0 ? stats.process_total_us / stats.tick_count
+                                  : 0)
+         << "\n    Max. encode and send time in us                         : "
+         << stats.process_max_us
+         << "\n    Counts (encode and send past the tick interval)         : "
+         << stats.process_overrun_count << std::endl;
   dprintf(fd, "%s", stream.str().c_str());
 }
 
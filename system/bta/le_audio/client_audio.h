@@ -16,6 +16,7 @@
  */
 #pragma once
 
+#include <atomic>
 #include <future>
 
 #include "audio_hal_interface/le_audio_software.h"
@@ -143,13 +144,22 @@ class LeAudioClientAudioSource {
 
   void StartAudioTicks();
   void StopAudioTicks();
+  uint32_t GetBytesPerTick() const;
   void SendAudioData();
+  void SendAudioDataWhenReady(uint64_t generation);
 
   bluetooth::common::RepeatingTimer audio_timer_;
+  /* Ticks driven by the arrival of the frames instead of audio_timer_. The
+   * generation is bumped on each start and stop, to stop the pending tick.
+   */
+  bool event_driven_ticks_ = false;
+  std::atomic<uint64_t> event_driven_generation_{0};
   LeAudioCodecConfiguration source_codec_config_;
   LeAudioClientAudioSinkReceiver* audioSinkReceiver_ = nullptr;
   bluetooth::audio::le_audio::LeAudioClientInterface::Sink*
       sinkClientInterface_ = nullptr;
+  /* Audio data of the current tick, only accessed on the worker thread */
+  std::vector<uint8_t> audio_data_;
 
   /* Guard audio sink receiver mutual access from stack with internal mutex */
   std::mutex sinkInterfaceMutex_;
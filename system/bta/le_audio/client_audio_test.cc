@@ -198,6 +198,10 @@ size_t LeAudioClientInterface::Source::Write(const uint8_t* p_buf,
 size_t LeAudioClientInterface::Sink::Read(uint8_t* p_buf, uint32_t len) {
   return sink_mock->Read(p_buf, len);
 }
+
+bool LeAudioClientInterface::Sink::WaitForData(uint32_t len, int timeout_ms) {
+  return false;
+}
 }  // namespace le_audio
 }  // namespace audio
 }  // namespace bluetooth
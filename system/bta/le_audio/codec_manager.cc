@@ -134,7 +134,9 @@ struct codec_manager_impl {
 
   const AudioSetConfigurations* GetOffloadCodecConfig(
       types::LeAudioContextType ctx_type) {
-    return &context_type_offload_config_map_[ctx_type];
+    auto it = context_type_offload_config_map_.find(ctx_type);
+    if (it == context_type_offload_config_map_.end()) return nullptr;
+    return &it->second;
   }
 
   const broadcast_offload_config* GetBroadcastOffloadConfig() {
@@ -290,6 +292,11 @@ struct codec_manager_impl {
       }
     }
 
+    // The context types share most of their configurations, match each of
+    // them against the ADSP capabilities once
+    std::unordered_map<const AudioSetConfiguration*, bool>
+        offload_supported_confs;
+
     for (types::LeAudioContextType ctx_type :
          types::kLeAudioContextAllTypesArray) {
       // Gets the software supported context type and the corresponding config
@@ -298,9 +305,14 @@ struct codec_manager_impl {
           AudioSetConfigurationProvider::Get()->GetConfigurations(ctx_type);
 
       for (const auto& software_audio_set_conf : *software_audio_set_confs) {
-        if (IsAudioSetConfigurationMatched(software_audio_set_conf,
-                                           offload_preference_set,
-                                           adsp_capabilities)) {
+        auto [it, inserted] =
+            offload_supported_confs.emplace(software_audio_set_conf, false);
+        if (inserted) {
+          it->second = IsAudioSetConfigurationMatched(
+              software_audio_set_conf, offload_preference_set,
+              adsp_capabilities);
+        }
+        if (it->second) {
           LOG(INFO) << "Offload supported conf, context type: " << (int)ctx_type
                     << ", settings -> " << software_audio_set_conf->name;
           context_type_offload_config_map_[ctx_type].push_back(
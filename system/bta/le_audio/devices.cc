@@ -319,6 +319,30 @@ bool LeAudioDeviceGroup::HaveAllActiveDevicesAsesTheSameState(AseState state) {
   return iter == leAudioDevices_.end();
 }
 
+bool LeAudioDeviceGroup::HaveAnyActiveDeviceUnconfiguredAses(void) {
+  auto iter =
+      std::find_if(leAudioDevices_.begin(), leAudioDevices_.end(), [](auto& d) {
+        if (d.expired())
+          return false;
+        else
+          return ((d.lock()).get())->HaveAnyUnconfiguredAses();
+      });
+
+  return iter != leAudioDevices_.end();
+}
+
+bool LeAudioDeviceGroup::HaveAllActiveDevicesReadyToCreateStream(void) {
+  auto iter =
+      std::find_if(leAudioDevices_.begin(), leAudioDevices_.end(), [](auto& d) {
+        if (d.expired()) return false;
+
+        auto device = (d.lock()).get();
+        return device->HaveActiveAse() && !device->IsReadyToCreateStream();
+      });
+
+  return iter == leAudioDevices_.end();
+}
+
 LeAudioDevice* LeAudioDeviceGroup::GetFirstActiveDevice(void) {
   auto iter =
       std::find_if(leAudioDevices_.begin(), leAudioDevices_.end(), [](auto& d) {
@@ -1813,12 +1837,53 @@ bool LeAudioDeviceGroup::IsConfigurationSupported(
   return false;
 }
 
+LeAudioDeviceGroup::CapabilityKey LeAudioDeviceGroup::GetCapabilityKey(void) {
+  CapabilityKey key;
+  key.reserve(leAudioDevices_.size());
+  for (auto& iter : leAudioDevices_) {
+    auto device = iter.lock();
+    if (!device) {
+      key.emplace_back(nullptr, false, 0, 0, 0, 0, 0);
+      continue;
+    }
+    key.emplace_back(device.get(), device->conn_id_ != GATT_INVALID_CONN_ID,
+                     device->GetAvailableContexts().to_ulong(),
+                     device->GetPacGeneration(), device->ases_.size(),
+                     device->snk_audio_locations_.to_ulong(),
+                     device->src_audio_locations_.to_ulong());
+  }
+  return key;
+}
+
 const set_configurations::AudioSetConfiguration*
 LeAudioDeviceGroup::FindFirstSupportedConfiguration(
     LeAudioContextType context_type) {
   const set_configurations::AudioSetConfigurations* confs =
       AudioSetConfigurationProvider::Get()->GetConfigurations(context_type);
 
+  /* Answer from the index unless the devices have changed */
+  CapabilityKey key = GetCapabilityKey();
+  if (key != capability_key_) {
+    configuration_index_.clear();
+    capability_key_ = std::move(key);
+  }
+
+  auto index_it = configuration_index_.find(context_type);
+  if (index_it != configuration_index_.end() &&
+      index_it->second.confs == confs) {
+    return index_it->second.conf;
+  }
+
+  const set_configurations::AudioSetConfiguration* conf =
+      FindFirstSupportedConfiguration(context_type, confs);
+  configuration_index_[context_type] = {confs, conf};
+  return conf;
+}
+
+const set_configurations::AudioSetConfiguration*
+LeAudioDeviceGroup::FindFirstSupportedConfiguration(
+    LeAudioContextType context_type,
+    const set_configurations::AudioSetConfigurations* confs) {
   LOG_DEBUG("context type: %s,  number of connected devices: %d",
             bluetooth::common::ToString(context_type).c_str(),
             +NumOfConnected());
@@ -1950,6 +2015,14 @@ void LeAudioDeviceGroup::Dump(int fd) {
 void LeAudioDevice::ClearPACs(void) {
   snk_pacs_.clear();
   src_pacs_.clear();
+  InvalidatePacIndex();
+}
+
+void LeAudioDevice::InvalidatePacIndex(void) {
+  pac_index_.clear();
+  snk_lc3_channel_count_.reset();
+  src_lc3_channel_count_.reset();
+  pac_generation_++;
 }
 
 LeAudioDevice::~LeAudioDevice(void) {
@@ -1979,6 +2052,7 @@ void LeAudioDevice::RegisterPACs(
   }
 
   pac_db->insert(pac_db->begin(), pac_recs->begin(), pac_recs->end());
+  InvalidatePacIndex();
 }
 
 struct ase* LeAudioDevice::GetAseByValHandle(uint16_t val_hdl) {
@@ -2287,12 +2361,21 @@ uint8_t LeAudioDevice::GetMatchingBidirectionCisId(
 uint8_t LeAudioDevice::GetLc3SupportedChannelCount(uint8_t direction) {
   auto& pacs =
       direction == types::kLeAudioDirectionSink ? snk_pacs_ : src_pacs_;
+  auto& channel_count = direction == types::kLeAudioDirectionSink
+                            ? snk_lc3_channel_count_
+                            : src_lc3_channel_count_;
 
   if (pacs.size() == 0) {
     LOG(ERROR) << __func__ << " missing PAC for direction " << +direction;
     return 0;
   }
 
+  if (!channel_count) channel_count = FindLc3SupportedChannelCount(pacs);
+  return *channel_count;
+}
+
+uint8_t LeAudioDevice::FindLc3SupportedChannelCount(
+    const types::PublishedAudioCapabilities& pacs) {
   for (const auto& pac_tuple : pacs) {
     /* Get PAC records from tuple as second element from tuple */
     auto& pac_recs = std::get<1>(pac_tuple);
@@ -2322,6 +2405,25 @@ LeAudioDevice::GetCodecConfigurationSupportedPac(
     return nullptr;
   }
 
+  /* The same codec settings are looked up for many configurations, remember
+   * the matching PAC record until the PACs change.
+   */
+  for (const auto& entry : pac_index_) {
+    if (entry.direction == direction &&
+        entry.codec == codec_capability_setting)
+      return entry.pac;
+  }
+
+  const struct types::acs_ac_record* pac =
+      FindCodecConfigurationSupportedPac(pacs, codec_capability_setting);
+  pac_index_.push_back({direction, codec_capability_setting, pac});
+  return pac;
+}
+
+const struct types::acs_ac_record*
+LeAudioDevice::FindCodecConfigurationSupportedPac(
+    const types::PublishedAudioCapabilities& pacs,
+    const CodecCapabilitySetting& codec_capability_setting) {
   /* TODO: Validate channel locations */
 
   for (const auto& pac_tuple : pacs) {
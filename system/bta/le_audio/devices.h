@@ -99,12 +99,17 @@ class LeAudioDevice {
         group_id_(group_id),
         csis_member_(false),
         audio_directions_(0),
-        link_quality_timer(nullptr) {}
+        link_quality_timer(nullptr),
+        pac_generation_(0) {}
   ~LeAudioDevice(void);
 
   void ClearPACs(void);
   void RegisterPACs(std::vector<struct types::acs_ac_record>* apr_db,
                     std::vector<struct types::acs_ac_record>* apr);
+  /* Drops the index of the PAC records matching the codec settings. Must be
+   * called whenever snk_pacs_ or src_pacs_ are modified directly. */
+  void InvalidatePacIndex(void);
+  uint32_t GetPacGeneration(void) const { return pac_generation_; }
   struct types::ase* GetAseByValHandle(uint16_t val_hdl);
   int GetAseCount(uint8_t direction);
   struct types::ase* GetFirstActiveAse(void);
@@ -159,10 +164,29 @@ class LeAudioDevice {
                          const std::vector<uint8_t>& ccid_list);
 
  private:
+  static const struct types::acs_ac_record* FindCodecConfigurationSupportedPac(
+      const types::PublishedAudioCapabilities& pacs,
+      const set_configurations::CodecCapabilitySetting&
+          codec_capability_setting);
+  static uint8_t FindLc3SupportedChannelCount(
+      const types::PublishedAudioCapabilities& pacs);
+
   types::AudioContexts avail_snk_contexts_;
   types::AudioContexts avail_src_contexts_;
   types::AudioContexts supp_snk_context_;
   types::AudioContexts supp_src_context_;
+
+  /* PAC record supporting a codec setting, nullptr if none */
+  struct PacIndexEntry {
+    uint8_t direction;
+    set_configurations::CodecCapabilitySetting codec;
+    const struct types::acs_ac_record* pac;
+  };
+  std::vector<PacIndexEntry> pac_index_;
+  std::optional<uint8_t> snk_lc3_channel_count_;
+  std::optional<uint8_t> src_lc3_channel_count_;
+  /* Incremented each time the PACs change */
+  uint32_t pac_generation_;
 };
 
 /* LeAudioDevices class represents a wraper helper over all devices in le audio
@@ -252,6 +276,8 @@ class LeAudioDeviceGroup {
       types::AudioStreamDataPathState data_path_state);
   bool IsDeviceInTheGroup(LeAudioDevice* leAudioDevice);
   bool HaveAllActiveDevicesAsesTheSameState(types::AseState state);
+  bool HaveAnyActiveDeviceUnconfiguredAses(void);
+  bool HaveAllActiveDevicesReadyToCreateStream(void);
   bool IsGroupStreamReady(void);
   bool HaveAllActiveDevicesCisDisc(void);
   uint8_t GetFirstFreeCisId(void);
@@ -339,6 +365,10 @@ class LeAudioDeviceGroup {
 
   const set_configurations::AudioSetConfiguration*
   FindFirstSupportedConfiguration(types::LeAudioContextType context_type);
+  const set_configurations::AudioSetConfiguration*
+  FindFirstSupportedConfiguration(
+      types::LeAudioContextType context_type,
+      const set_configurations::AudioSetConfigurations* confs);
   bool ConfigureAses(
       const set_configurations::AudioSetConfiguration* audio_set_conf,
       types::LeAudioContextType context_type,
@@ -349,6 +379,15 @@ class LeAudioDeviceGroup {
       types::LeAudioContextType context_type);
   uint32_t GetTransportLatencyUs(uint8_t direction);
 
+  /* Device state the supported configurations depend on: the device, whether
+   * it is connected, its available contexts, PAC generation, number of ASEs
+   * and sink and source audio locations.
+   */
+  using CapabilityKey =
+      std::vector<std::tuple<const LeAudioDevice*, bool, uint16_t, uint32_t,
+                             size_t, uint32_t, uint32_t>>;
+  CapabilityKey GetCapabilityKey(void);
+
   /* Mask and table of currently supported contexts */
   types::LeAudioContextType active_context_type_;
   types::AudioContexts metadata_context_type_;
@@ -358,6 +397,18 @@ class LeAudioDeviceGroup {
            const set_configurations::AudioSetConfiguration*>
       active_context_to_configuration_map;
 
+  /* First supported configuration for each context type, among the set
+   * configurations of the context. Valid as long as the capabilities of the
+   * devices match |capability_key_|.
+   */
+  struct ConfigurationIndexEntry {
+    const set_configurations::AudioSetConfigurations* confs;
+    const set_configurations::AudioSetConfiguration* conf;
+  };
+  std::map<types::LeAudioContextType, ConfigurationIndexEntry>
+      configuration_index_;
+  CapabilityKey capability_key_;
+
   types::AseState target_state_;
   types::AseState current_state_;
   types::LeAudioContextType context_type_;
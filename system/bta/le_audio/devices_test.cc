@@ -511,6 +511,7 @@ class LeAudioAseConfigurationTest : public Test {
 
       data[i].device->snk_pacs_ = snk_pac_builder.Get();
       data[i].device->src_pacs_ = src_pac_builder.Get();
+      data[i].device->InvalidatePacIndex();
     }
 
     /* Stimulate update of active context map */
@@ -575,6 +576,7 @@ class LeAudioAseConfigurationTest : public Test {
 
           data[i].device->snk_pacs_ = snk_pac_builder.Get();
           data[i].device->src_pacs_ = src_pac_builder.Get();
+          data[i].device->InvalidatePacIndex();
         }
 
         /* Make sure configuration can satisfy number of expected active ASEs*/
@@ -687,6 +689,7 @@ class LeAudioAseConfigurationTest : public Test {
               parameters*/
               device->snk_pacs_ = pac_builder.Get();
               device->src_pacs_ = pac_builder.Get();
+              device->InvalidatePacIndex();
             }
 
             bool success_expected = is_lc3_setting_supported;
@@ -922,6 +925,7 @@ TEST_F(LeAudioAseConfigurationTest, test_unsupported_codec) {
                   GetOctetsPerCodecFrame(Lc3SettingId::LC3_16_2));
   device->snk_pacs_ = pac_builder.Get();
   device->src_pacs_ = pac_builder.Get();
+  device->InvalidatePacIndex();
 
   ASSERT_FALSE(group_->Configure(
       LeAudioContextType::RINGTONE,
@@ -929,6 +933,52 @@ TEST_F(LeAudioAseConfigurationTest, test_unsupported_codec) {
   TestAsesInactive();
 }
 
+TEST_F(LeAudioAseConfigurationTest, test_configuration_index_follows_pacs) {
+  const LeAudioCodecId UnsupportedCodecId = {
+      .coding_format = kLeAudioCodingFormatVendorSpecific,
+      .vendor_company_id = 0xBAD,
+      .vendor_codec_id = 0xC0DE,
+  };
+
+  LeAudioDevice* device = AddTestDevice(1, 0);
+
+  PublishedAudioCapabilitiesBuilder pac_builder;
+  pac_builder.Add(LeAudioCodecIdLc3,
+                  GetSamplingFrequency(Lc3SettingId::LC3_16_2),
+                  GetFrameDuration(Lc3SettingId::LC3_16_2),
+                  kLeAudioCodecLC3ChannelCountSingleChannel,
+                  GetOctetsPerCodecFrame(Lc3SettingId::LC3_16_2));
+  device->snk_pacs_ = pac_builder.Get();
+  device->src_pacs_ = pac_builder.Get();
+  device->InvalidatePacIndex();
+
+  AudioContexts media =
+      AudioContexts(static_cast<uint16_t>(LeAudioContextType::MEDIA));
+  group_->UpdateActiveContextsMap(media);
+  ASSERT_TRUE(group_->Configure(LeAudioContextType::MEDIA, media));
+  group_->Deactivate();
+
+  /* Nothing has changed, the index answers */
+  ASSERT_FALSE(group_->UpdateActiveContextsMap(media));
+  ASSERT_TRUE(group_->Configure(LeAudioContextType::MEDIA, media));
+  group_->Deactivate();
+
+  /* The PACs are updated with a codec no configuration uses */
+  PublishedAudioCapabilitiesBuilder unsupported_pac_builder;
+  unsupported_pac_builder.Add(UnsupportedCodecId,
+                              GetSamplingFrequency(Lc3SettingId::LC3_16_2),
+                              GetFrameDuration(Lc3SettingId::LC3_16_2),
+                              kLeAudioCodecLC3ChannelCountSingleChannel,
+                              GetOctetsPerCodecFrame(Lc3SettingId::LC3_16_2));
+  auto pac_recs = std::get<1>(unsupported_pac_builder.Get()[0]);
+  device->RegisterPACs(&std::get<1>(device->snk_pacs_[0]), &pac_recs);
+  device->RegisterPACs(&std::get<1>(device->src_pacs_[0]), &pac_recs);
+
+  ASSERT_TRUE(group_->UpdateActiveContextsMap(media));
+  ASSERT_FALSE(group_->Configure(LeAudioContextType::MEDIA, media));
+  TestAsesInactive();
+}
+
 TEST_F(LeAudioAseConfigurationTest, test_reconnection_media) {
   LeAudioDevice* left = AddTestDevice(2, 1);
   LeAudioDevice* right = AddTestDevice(2, 1);
@@ -15,6 +15,14 @@
  *
  */
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
 #include <string>
 #include <string_view>
 
@@ -26,6 +34,7 @@
 #include "le_audio_set_configuration_provider.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
+#include "osi/include/properties.h"
 
 using le_audio::set_configurations::AudioSetConfiguration;
 using le_audio::set_configurations::AudioSetConfigurations;
@@ -38,29 +47,42 @@ using le_audio::types::LeAudioContextType;
 namespace le_audio {
 using ::le_audio::CodecManager;
 
+/* The binary is compiled from the JSON content at build time, so that it is
+ * only mapped and verified here. The JSON content is parsed with its schema
+ * when the binary can't be used, or when kLeAudioSetConfigsFromJsonProperty
+ * is set, so that a developer can override the JSON files on the device.
+ */
+struct AudioSetConfigurationFiles {
+  const char* binary;
+  const char* schema;
+  const char* content;
+};
+
+static constexpr char kLeAudioSetConfigsFromJsonProperty[] =
+    "persist.bluetooth.leaudio.set_configurations_from_json";
+
 #ifdef OS_ANDROID
-static const std::vector<
-    std::pair<const char* /*schema*/, const char* /*content*/>>
-    kLeAudioSetConfigs = {
-        {"/apex/com.android.btservices/etc/bluetooth/le_audio/"
-         "audio_set_configurations.bfbs",
-         "/apex/com.android.btservices/etc/bluetooth/le_audio/"
-         "audio_set_configurations.json"}};
-static const std::vector<
-    std::pair<const char* /*schema*/, const char* /*content*/>>
-    kLeAudioSetScenarios = {{"/apex/com.android.btservices/etc/bluetooth/"
-                             "le_audio/audio_set_scenarios.bfbs",
-                             "/apex/com.android.btservices/etc/bluetooth/"
-                             "le_audio/audio_set_scenarios.json"}};
+static const std::vector<AudioSetConfigurationFiles> kLeAudioSetConfigs = {
+    {"/apex/com.android.btservices/etc/bluetooth/le_audio/"
+     "audio_set_configurations.bin",
+     "/apex/com.android.btservices/etc/bluetooth/le_audio/"
+     "audio_set_configurations.bfbs",
+     "/apex/com.android.btservices/etc/bluetooth/le_audio/"
+     "audio_set_configurations.json"}};
+static const std::vector<AudioSetConfigurationFiles> kLeAudioSetScenarios = {
+    {"/apex/com.android.btservices/etc/bluetooth/le_audio/"
+     "audio_set_scenarios.bin",
+     "/apex/com.android.btservices/etc/bluetooth/le_audio/"
+     "audio_set_scenarios.bfbs",
+     "/apex/com.android.btservices/etc/bluetooth/le_audio/"
+     "audio_set_scenarios.json"}};
 #else
-static const std::vector<
-    std::pair<const char* /*schema*/, const char* /*content*/>>
-    kLeAudioSetConfigs = {
-        {"audio_set_configurations.bfbs", "audio_set_configurations.json"}};
-static const std::vector<
-    std::pair<const char* /*schema*/, const char* /*content*/>>
-    kLeAudioSetScenarios = {
-        {"audio_set_scenarios.bfbs", "audio_set_scenarios.json"}};
+static const std::vector<AudioSetConfigurationFiles> kLeAudioSetConfigs = {
+    {"audio_set_configurations.bin", "audio_set_configurations.bfbs",
+     "audio_set_configurations.json"}};
+static const std::vector<AudioSetConfigurationFiles> kLeAudioSetScenarios = {
+    {"audio_set_scenarios.bin", "audio_set_scenarios.bfbs",
+     "audio_set_scenarios.json"}};
 #endif
 
 /** Provides a set configurations for the given context type */
@@ -68,8 +90,15 @@ struct AudioSetConfigurationProviderJson {
   static constexpr auto kDefaultScenario = "Media";
 
   AudioSetConfigurationProviderJson() {
-    ASSERT_LOG(LoadContent(kLeAudioSetConfigs, kLeAudioSetScenarios),
+    bool from_json =
+        osi_property_get_bool(kLeAudioSetConfigsFromJsonProperty, false);
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_LOG(LoadContent(kLeAudioSetConfigs, kLeAudioSetScenarios, from_json),
                ": Unable to load le audio set configuration files.");
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+    LOG_INFO(": Loaded the set configurations in %lld us, %d from JSON",
+             (long long)elapsed.count(), json_files_);
   }
 
   /* Use the same scenario configurations for different contexts to avoid
@@ -155,6 +184,9 @@ struct AudioSetConfigurationProviderJson {
   std::map<::le_audio::types::LeAudioContextType, AudioSetConfigurations>
       context_configurations_;
 
+  /* Files parsed from JSON instead of their binary, for the load time log */
+  int json_files_ = 0;
+
   static const bluetooth::le_audio::CodecSpecificConfiguration*
   LookupCodecSpecificParam(
       const flatbuffers::Vector<
@@ -390,6 +422,56 @@ struct AudioSetConfigurationProviderJson {
     return AudioSetConfiguration({flat_cfg->name()->c_str(), subconfigs});
   }
 
+  /* Maps |file| and passes its content to |load|, once verified by |verify| */
+  template <typename Verify, typename Load>
+  static bool LoadFromBinaryFile(const char* file, Verify verify, Load load) {
+    int fd = open(file, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+      LOG_WARN(": Can't open %s, error: %s", file, strerror(errno));
+      return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == -1 || st.st_size == 0) {
+      LOG_WARN(": Can't read %s", file);
+      close(fd);
+      return false;
+    }
+
+    size_t size = st.st_size;
+    void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+      LOG_WARN(": Can't map %s, error: %s", file, strerror(errno));
+      return false;
+    }
+
+    bool ok = false;
+    flatbuffers::Verifier verifier(static_cast<const uint8_t*>(map), size);
+    if (!verify(verifier)) {
+      LOG_WARN(": Invalid content in %s", file);
+    } else {
+      ok = load(map);
+    }
+
+    /* Everything is copied out of the buffer by |load| */
+    munmap(map, size);
+    return ok;
+  }
+
+  bool LoadConfigurationsFromBinary(const char* binary_file) {
+    return LoadFromBinaryFile(
+        binary_file,
+        [](flatbuffers::Verifier& verifier) {
+          return bluetooth::le_audio::VerifyAudioSetConfigurationsBuffer(
+              verifier);
+        },
+        [this](const void* buffer) {
+          return LoadConfigurations(
+              bluetooth::le_audio::GetAudioSetConfigurations(buffer));
+        });
+  }
+
   bool LoadConfigurationsFromFiles(const char* schema_file,
                                    const char* content_file) {
     flatbuffers::Parser configurations_parser_;
@@ -415,8 +497,12 @@ struct AudioSetConfigurationProviderJson {
     if (!ok) return ok;
 
     /* Import from flatbuffers */
-    auto configurations_root = bluetooth::le_audio::GetAudioSetConfigurations(
-        configurations_parser_.builder_.GetBufferPointer());
+    return LoadConfigurations(bluetooth::le_audio::GetAudioSetConfigurations(
+        configurations_parser_.builder_.GetBufferPointer()));
+  }
+
+  bool LoadConfigurations(
+      const bluetooth::le_audio::AudioSetConfigurations* configurations_root) {
     if (!configurations_root) return false;
 
     auto flat_qos_configs = configurations_root->qos_configurations();
@@ -468,6 +554,18 @@ struct AudioSetConfigurationProviderJson {
     return items;
   }
 
+  bool LoadScenariosFromBinary(const char* binary_file) {
+    return LoadFromBinaryFile(
+        binary_file,
+        [](flatbuffers::Verifier& verifier) {
+          return bluetooth::le_audio::VerifyAudioSetScenariosBuffer(verifier);
+        },
+        [this](const void* buffer) {
+          return LoadScenarios(
+              bluetooth::le_audio::GetAudioSetScenarios(buffer));
+        });
+  }
+
   bool LoadScenariosFromFiles(const char* schema_file,
                               const char* content_file) {
     flatbuffers::Parser scenarios_parser_;
@@ -492,8 +590,12 @@ struct AudioSetConfigurationProviderJson {
     if (!ok) return ok;
 
     /* Import from flatbuffers */
-    auto scenarios_root = bluetooth::le_audio::GetAudioSetScenarios(
-        scenarios_parser_.builder_.GetBufferPointer());
+    return LoadScenarios(bluetooth::le_audio::GetAudioSetScenarios(
+        scenarios_parser_.builder_.GetBufferPointer()));
+  }
+
+  bool LoadScenarios(
+      const bluetooth::le_audio::AudioSetScenarios* scenarios_root) {
     if (!scenarios_root) return false;
 
     auto flat_scenarios = scenarios_root->scenarios();
@@ -514,16 +616,19 @@ struct AudioSetConfigurationProviderJson {
   }
 
   bool LoadContent(
-      std::vector<std::pair<const char* /*schema*/, const char* /*content*/>>
-          config_files,
-      std::vector<std::pair<const char* /*schema*/, const char* /*content*/>>
-          scenario_files) {
-    for (auto [schema, content] : config_files) {
+      const std::vector<AudioSetConfigurationFiles>& config_files,
+      const std::vector<AudioSetConfigurationFiles>& scenario_files,
+      bool from_json) {
+    for (auto [binary, schema, content] : config_files) {
+      if (!from_json && LoadConfigurationsFromBinary(binary)) continue;
       if (!LoadConfigurationsFromFiles(schema, content)) return false;
+      json_files_++;
     }
 
-    for (auto [schema, content] : scenario_files) {
+    for (auto [binary, schema, content] : scenario_files) {
+      if (!from_json && LoadScenariosFromBinary(binary)) continue;
       if (!LoadScenariosFromFiles(schema, content)) return false;
+      json_files_++;
     }
     return true;
   }
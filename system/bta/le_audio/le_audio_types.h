@@ -469,6 +469,16 @@ struct LeAudioLc3Config {
     return 0;
   }
 
+  friend bool operator==(const LeAudioLc3Config& lhs,
+                         const LeAudioLc3Config& rhs) {
+    return lhs.sampling_frequency == rhs.sampling_frequency &&
+           lhs.frame_duration == rhs.frame_duration &&
+           lhs.audio_channel_allocation == rhs.audio_channel_allocation &&
+           lhs.octets_per_codec_frame == rhs.octets_per_codec_frame &&
+           lhs.codec_frames_blocks_per_sdu == rhs.codec_frames_blocks_per_sdu &&
+           lhs.channel_count == rhs.channel_count;
+  }
+
   LeAudioLtvMap GetAsLtvMap() const {
     std::map<uint8_t, std::vector<uint8_t>> values;
 
@@ -618,6 +628,11 @@ struct CodecCapabilitySetting {
   uint8_t GetConfigBitsPerSample() const;
   /* Audio channels number for stream */
   uint8_t GetConfigChannelCount() const;
+
+  friend bool operator==(const CodecCapabilitySetting& lhs,
+                         const CodecCapabilitySetting& rhs) {
+    return lhs.id == rhs.id && lhs.config == rhs.config;
+  }
 };
 
 struct QosConfigSetting {
@@ -16,6 +16,9 @@
 
 #include "metrics_collector.h"
 
+#include <stdio.h>
+
+#include <algorithm>
 #include <chrono>
 #include <memory>
 #include <vector>
@@ -283,6 +286,94 @@ void MetricsCollector::OnStreamEnded(int32_t group_id) {
   }
 }
 
+void MetricsCollector::OnIsoDataPathStats(
+    int32_t group_id,
+    const bluetooth::hci::iso_manager::iso_data_path_stats& stats) {
+  if (group_id <= 0 || stats.sent_sdus == 0) return;
+
+  auto& total = iso_data_path_stats_[group_id];
+  total.sent_sdus += stats.sent_sdus;
+  total.late_sdus += stats.late_sdus;
+  total.dropped_sdus += stats.dropped_sdus;
+  total.missed_intervals += stats.missed_intervals;
+  total.encode_us_total += stats.encode_us_total;
+  total.encode_us_max = std::max(total.encode_us_max, stats.encode_us_max);
+  total.queue_samples += stats.queue_samples;
+  total.queue_us_total += stats.queue_us_total;
+  total.queue_us_max = std::max(total.queue_us_max, stats.queue_us_max);
+  total.max_used_credits =
+      std::max(total.max_used_credits, stats.max_used_credits);
+  total.rx_seq_nb_gaps += stats.rx_seq_nb_gaps;
+
+  if (stats.late_sdus > 0 || stats.dropped_sdus > 0) {
+    LOG(WARNING) << __func__ << ", group_id " << group_id << ", "
+                 << stats.sent_sdus << " SDUs sent, " << stats.late_sdus
+                 << " late, " << stats.dropped_sdus << " dropped";
+  }
+}
+
+const bluetooth::hci::iso_manager::iso_data_path_stats*
+MetricsCollector::GetIsoDataPathStats(int32_t group_id) const {
+  auto it = iso_data_path_stats_.find(group_id);
+  return (it != iso_data_path_stats_.end()) ? &it->second : nullptr;
+}
+
+void MetricsCollector::OnStreamSetupCompleted(int32_t group_id,
+                                              bool warm_start,
+                                              uint64_t setup_us) {
+  LOG(INFO) << __func__ << ", group_id " << group_id << ", "
+            << (warm_start ? "warm" : "cold") << " start in "
+            << setup_us / 1000 << " ms";
+
+  auto& samples = stream_setup_us_[warm_start];
+  if (samples.size() == kMaxStreamSetupSamples) samples.pop_front();
+  samples.push_back(setup_us);
+}
+
+uint64_t MetricsCollector::GetStreamSetupPercentileUs(bool warm_start,
+                                                      int percentile) const {
+  auto const& samples = stream_setup_us_[warm_start];
+  if (samples.empty()) return 0;
+
+  std::vector<uint64_t> sorted(samples.begin(), samples.end());
+  auto nth = sorted.begin() + (sorted.size() - 1) * percentile / 100;
+  std::nth_element(sorted.begin(), nth, sorted.end());
+  return *nth;
+}
+
+void MetricsCollector::Dump(int fd) const {
+  for (bool warm_start : {false, true}) {
+    dprintf(fd,
+            "  LE Audio %s stream setups: %zu, p50/p95/max (ms): "
+            "%llu/%llu/%llu\n",
+            warm_start ? "warm" : "cold", stream_setup_us_[warm_start].size(),
+            (unsigned long long)GetStreamSetupPercentileUs(warm_start, 50) /
+                1000,
+            (unsigned long long)GetStreamSetupPercentileUs(warm_start, 95) /
+                1000,
+            (unsigned long long)GetStreamSetupPercentileUs(warm_start, 100) /
+                1000);
+  }
+  dprintf(fd, "  LE Audio ISO data path metrics:\n");
+  for (auto const& [group_id, stats] : iso_data_path_stats_) {
+    dprintf(fd,
+            "    group_id: %d, sent SDUs: %zu, late: %zu, dropped: %zu, "
+            "missed intervals: %zu, received gaps: %zu\n",
+            group_id, stats.sent_sdus, stats.late_sdus, stats.dropped_sdus,
+            stats.missed_intervals, stats.rx_seq_nb_gaps);
+    dprintf(fd,
+            "      encode avg/max (us): %llu/%llu, controller queueing "
+            "avg/max (us): %llu/%llu, max. used credits: %d\n",
+            (unsigned long long)(stats.encode_us_total / stats.sent_sdus),
+            (unsigned long long)stats.encode_us_max,
+            (unsigned long long)(stats.queue_samples > 0
+                                     ? stats.queue_us_total /
+                                           stats.queue_samples
+                                     : 0),
+            (unsigned long long)stats.queue_us_max, stats.max_used_credits);
+  }
+}
+
 void MetricsCollector::Flush() {
   LOG(INFO) << __func__;
   for (auto& p : opened_groups_) {
@@ -19,9 +19,11 @@
 #include <hardware/bt_le_audio.h>
 
 #include <cstdint>
+#include <deque>
 #include <memory>
 #include <unordered_map>
 
+#include "btm_iso_api_types.h"
 #include "le_audio_types.h"
 #include "types/raw_address.h"
 
@@ -116,6 +118,47 @@ class MetricsCollector {
    */
   void OnStreamEnded(int32_t group_id);
 
+  /**
+   * When an ISO channel of a group stops, with the timing of its SDUs
+   *
+   * @param group_id Group ID of the associated stream.
+   * @param stats Data path statistics of the ISO channel.
+   */
+  void OnIsoDataPathStats(
+      int32_t group_id,
+      const bluetooth::hci::iso_manager::iso_data_path_stats& stats);
+
+  /**
+   * Returns the data path statistics accumulated over the ISO channels of a
+   * group, nullptr if there are none.
+   *
+   * @param group_id Group ID of the associated stream.
+   */
+  const bluetooth::hci::iso_manager::iso_data_path_stats* GetIsoDataPathStats(
+      int32_t group_id) const;
+
+  /**
+   * When a stream of a group got set up, after the resume request of the
+   * audio framework
+   *
+   * @param group_id Group ID of the associated stream.
+   * @param warm_start The group was resumed from the QoS configured state.
+   * @param setup_us Time from the resume request to the streaming state.
+   */
+  void OnStreamSetupCompleted(int32_t group_id, bool warm_start,
+                              uint64_t setup_us);
+
+  /**
+   * Returns the given percentile of the recent stream setup times, 0 if
+   * there are none.
+   *
+   * @param warm_start The streams resumed from the QoS configured state.
+   * @param percentile Percentile, from 0 to 100.
+   */
+  uint64_t GetStreamSetupPercentileUs(bool warm_start, int percentile) const;
+
+  void Dump(int fd) const;
+
   /**
    * Flush all log to statsd
    *
@@ -127,10 +170,16 @@ class MetricsCollector {
   MetricsCollector() {}
 
  private:
+  static constexpr size_t kMaxStreamSetupSamples = 100;
+
   static MetricsCollector* instance;
 
   std::unordered_map<int32_t, std::unique_ptr<GroupMetrics>> opened_groups_;
   std::unordered_map<int32_t, int32_t> group_size_table_;
+  std::unordered_map<int32_t, bluetooth::hci::iso_manager::iso_data_path_stats>
+      iso_data_path_stats_;
+  /* Recent stream setup times, cold and warm starts */
+  std::deque<uint64_t> stream_setup_us_[2];
 };
 
 }  // namespace le_audio
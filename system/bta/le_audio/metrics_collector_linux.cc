@@ -40,6 +40,26 @@ void MetricsCollector::OnStreamStarted(
 
 void MetricsCollector::OnStreamEnded(int32_t group_id) {}
 
+void MetricsCollector::OnIsoDataPathStats(
+    int32_t group_id,
+    const bluetooth::hci::iso_manager::iso_data_path_stats& stats) {}
+
+const bluetooth::hci::iso_manager::iso_data_path_stats*
+MetricsCollector::GetIsoDataPathStats(int32_t group_id) const {
+  return nullptr;
+}
+
+void MetricsCollector::OnStreamSetupCompleted(int32_t group_id,
+                                              bool warm_start,
+                                              uint64_t setup_us) {}
+
+uint64_t MetricsCollector::GetStreamSetupPercentileUs(bool warm_start,
+                                                      int percentile) const {
+  return 0;
+}
+
+void MetricsCollector::Dump(int fd) const {}
+
 void MetricsCollector::Flush() {}
 
 }  // namespace le_audio
@@ -367,4 +367,62 @@ TEST_F(MetricsCollectorTest, StreamingSessions) {
             static_cast<int32_t>(LeAudioMetricsContextType::COMMUNICATION));
 }
 
+TEST_F(MetricsCollectorTest, IsoDataPathStatsAccumulated) {
+  bluetooth::hci::iso_manager::iso_data_path_stats left;
+  left.sent_sdus = 100;
+  left.late_sdus = 2;
+  left.dropped_sdus = 1;
+  left.encode_us_total = 100 * 300;
+  left.encode_us_max = 900;
+  left.queue_samples = 100;
+  left.queue_us_total = 100 * 5000;
+  left.queue_us_max = 12000;
+  left.max_used_credits = 3;
+
+  bluetooth::hci::iso_manager::iso_data_path_stats right = left;
+  right.late_sdus = 0;
+  right.encode_us_max = 1200;
+  right.max_used_credits = 4;
+  right.rx_seq_nb_gaps = 5;
+
+  ASSERT_EQ(collector->GetIsoDataPathStats(group_id1), nullptr);
+  collector->OnIsoDataPathStats(group_id1, left);
+  collector->OnIsoDataPathStats(group_id1, right);
+  // ISO channels which didn't send anything are ignored
+  collector->OnIsoDataPathStats(group_id1, {});
+
+  auto stats = collector->GetIsoDataPathStats(group_id1);
+  ASSERT_NE(stats, nullptr);
+  ASSERT_EQ(stats->sent_sdus, 200u);
+  ASSERT_EQ(stats->late_sdus, 2u);
+  ASSERT_EQ(stats->dropped_sdus, 2u);
+  ASSERT_EQ(stats->encode_us_max, 1200u);
+  ASSERT_EQ(stats->queue_samples, 200u);
+  ASSERT_EQ(stats->queue_us_max, 12000u);
+  ASSERT_EQ(stats->max_used_credits, 4);
+  ASSERT_EQ(stats->rx_seq_nb_gaps, 5u);
+  ASSERT_EQ(collector->GetIsoDataPathStats(group_id2), nullptr);
+}
+
+TEST_F(MetricsCollectorTest, StreamSetupPercentiles) {
+  ASSERT_EQ(collector->GetStreamSetupPercentileUs(false, 50), 0u);
+
+  for (uint64_t i = 1; i <= 100; i++) {
+    collector->OnStreamSetupCompleted(group_id1, false, i * 1000);
+  }
+  collector->OnStreamSetupCompleted(group_id1, true, 20000);
+  collector->OnStreamSetupCompleted(group_id1, true, 40000);
+
+  ASSERT_EQ(collector->GetStreamSetupPercentileUs(false, 50), 50000u);
+  ASSERT_EQ(collector->GetStreamSetupPercentileUs(false, 95), 95000u);
+  ASSERT_EQ(collector->GetStreamSetupPercentileUs(false, 100), 100000u);
+  ASSERT_EQ(collector->GetStreamSetupPercentileUs(true, 0), 20000u);
+  ASSERT_EQ(collector->GetStreamSetupPercentileUs(true, 100), 40000u);
+
+  // Only the recent samples are kept
+  collector->OnStreamSetupCompleted(group_id1, false, 200000);
+  ASSERT_EQ(collector->GetStreamSetupPercentileUs(false, 0), 2000u);
+  ASSERT_EQ(collector->GetStreamSetupPercentileUs(false, 100), 200000u);
+}
+
 }  // namespace le_audio
\ No newline at end of file
@@ -95,6 +95,16 @@ void IsoManager::SendIsoData(uint16_t iso_handle, const uint8_t* data,
   pimpl_->SendIsoData(iso_handle, data, data_len);
 }
 
+uint8_t* IsoManager::GetIsoSduBuffer(uint16_t iso_handle, uint16_t data_len) {
+  if (!pimpl_) return nullptr;
+  return pimpl_->GetIsoSduBuffer(iso_handle, data_len);
+}
+
+void IsoManager::SendIsoSduBuffer(uint16_t iso_handle) {
+  if (!pimpl_) return;
+  pimpl_->SendIsoSduBuffer(iso_handle);
+}
+
 void IsoManager::CreateBig(uint8_t big_id,
                            struct iso_manager::big_create_params big_params) {
   if (!pimpl_) return;
@@ -196,7 +196,7 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
         group->SetContextType(context_type);
         /* All ASEs should aim to achieve target state */
         SetTargetState(group, AseState::BTA_LE_AUDIO_ASE_STATE_STREAMING);
-        PrepareAndSendCodecConfigure(group, group->GetFirstActiveDevice());
+        PrepareAndSendCodecConfigToTheGroup(group);
         break;
 
       case AseState::BTA_LE_AUDIO_ASE_STATE_QOS_CONFIGURED: {
@@ -206,9 +206,34 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
           return false;
         }
 
+        /* The CIG and the QoS configuration are kept for the context the group
+         * was configured for, the others need a new configuration.
+         */
+        if (group->GetCurrentContextType() != context_type) {
+          LOG_ERROR("Group %d is configured for %s, not %s", group->group_id_,
+                    ToString(group->GetCurrentContextType()).c_str(),
+                    ToString(context_type).c_str());
+          return false;
+        }
+
+        /* The metadata is sent with the Enable operation */
+        for (; leAudioDevice;
+             leAudioDevice = group->GetNextActiveDevice(leAudioDevice)) {
+          if (!leAudioDevice->IsMetadataChanged(metadata_context_type,
+                                                ccid_list))
+            continue;
+
+          auto metadata =
+              leAudioDevice->GetMetadata(metadata_context_type, ccid_list);
+          for (struct ase* ase = leAudioDevice->GetFirstActiveAse();
+               ase != nullptr; ase = leAudioDevice->GetNextActiveAse(ase)) {
+            ase->metadata = metadata;
+          }
+        }
+
         /* All ASEs should aim to achieve target state */
         SetTargetState(group, AseState::BTA_LE_AUDIO_ASE_STATE_STREAMING);
-        PrepareAndSendEnable(leAudioDevice);
+        PrepareAndSendEnableToTheGroup(group);
         break;
       }
 
@@ -261,7 +286,7 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
 
     group->CigGenerateCisIds(context_type);
     SetTargetState(group, AseState::BTA_LE_AUDIO_ASE_STATE_CODEC_CONFIGURED);
-    PrepareAndSendCodecConfigure(group, group->GetFirstActiveDevice());
+    PrepareAndSendCodecConfigToTheGroup(group);
 
     return true;
   }
@@ -1471,10 +1496,34 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
       return;
     }
 
-    PrepareAndSendConfigQos(group, leAudioDevice);
+    /* The devices of the set don't depend on each other at this stage. Write
+     * to the control points of all of them at once, rather than waiting for
+     * the notifications of a device before configuring the next one: the
+     * GATT queue is per connection, so the writes are in flight in parallel
+     * and the setup time no longer scales with the number of devices.
+     */
+    auto target_state = group->GetTargetState();
+    do {
+      if (!PrepareAndSendConfigQos(group, leAudioDevice)) return;
+      /* The group may have been stopped by the notifications of the device */
+      if (group->GetTargetState() != target_state) return;
+    } while ((leAudioDevice = group->GetNextActiveDevice(leAudioDevice)));
   }
 
-  void PrepareAndSendCodecConfigure(LeAudioDeviceGroup* group,
+  void PrepareAndSendCodecConfigToTheGroup(LeAudioDeviceGroup* group) {
+    LeAudioDevice* leAudioDevice = group->GetFirstActiveDevice();
+    LOG_ASSERT(leAudioDevice)
+        << __func__ << " Shouldn't be called without an active device.";
+
+    /* See StartConfigQoSForTheGroup() */
+    auto target_state = group->GetTargetState();
+    do {
+      if (!PrepareAndSendCodecConfigure(group, leAudioDevice)) return;
+      if (group->GetTargetState() != target_state) return;
+    } while ((leAudioDevice = group->GetNextActiveDevice(leAudioDevice)));
+  }
+
+  bool PrepareAndSendCodecConfigure(LeAudioDeviceGroup* group,
                                     LeAudioDevice* leAudioDevice) {
     struct le_audio::client_parser::ascs::ctp_codec_conf conf;
     std::vector<struct le_audio::client_parser::ascs::ctp_codec_conf> confs;
@@ -1483,7 +1532,7 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
     if (!group->CigAssignCisIds(leAudioDevice)) {
       LOG_ERROR(" unable to assign CIS IDs");
       StopStream(group);
-      return;
+      return false;
     }
 
     if (group->GetCigState() == CigState::CREATED)
@@ -1507,6 +1556,7 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
     BtaGattQueue::WriteCharacteristic(leAudioDevice->conn_id_,
                                       leAudioDevice->ctp_hdls_.val_hdl, value,
                                       GATT_WRITE_NO_RSP, NULL, NULL);
+    return true;
   }
 
   void AseStateMachineProcessCodecConfigured(
@@ -1529,8 +1579,6 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
           ase->id = arh.id;
         }
 
-        LeAudioDevice* leAudioDeviceNext;
-
         struct le_audio::client_parser::ascs::ase_codec_configured_state_params
             rsp;
 
@@ -1604,45 +1652,43 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
           return;
         }
 
-        leAudioDeviceNext = group->GetNextActiveDevice(leAudioDevice);
+        /* The other devices of the group are configured in parallel */
+        if (group->HaveAnyActiveDeviceUnconfiguredAses()) {
+          LOG_DEBUG("Wait for the other devices of group %d",
+                    group->group_id_);
+          return;
+        }
 
-        /* Configure ASEs for next device in group */
-        if (leAudioDeviceNext) {
-          PrepareAndSendCodecConfigure(group, leAudioDeviceNext);
-        } else {
-          /* Last node configured, process group to codec configured state */
-          group->SetState(AseState::BTA_LE_AUDIO_ASE_STATE_CODEC_CONFIGURED);
+        /* Last node configured, process group to codec configured state */
+        group->SetState(AseState::BTA_LE_AUDIO_ASE_STATE_CODEC_CONFIGURED);
 
-          if (group->GetTargetState() ==
-              AseState::BTA_LE_AUDIO_ASE_STATE_STREAMING) {
-            if (!CigCreate(group)) {
-              LOG_ERROR("Could not create CIG. Stop the stream for group %d",
-                        group->group_id_);
-              StopStream(group);
-            }
-            return;
+        if (group->GetTargetState() ==
+            AseState::BTA_LE_AUDIO_ASE_STATE_STREAMING) {
+          if (!CigCreate(group)) {
+            LOG_ERROR("Could not create CIG. Stop the stream for group %d",
+                      group->group_id_);
+            StopStream(group);
           }
+          return;
+        }
 
-          if (group->GetTargetState() ==
-                  AseState::BTA_LE_AUDIO_ASE_STATE_CODEC_CONFIGURED &&
-              group->IsPendingConfiguration()) {
-            LOG_INFO(" Configured state completed ");
-            group->ClearPendingConfiguration();
-            state_machine_callbacks_->StatusReportCb(
-                group->group_id_, GroupStreamStatus::CONFIGURED_BY_USER);
-
-            /* No more transition for group */
-            alarm_cancel(watchdog_);
-            return;
-          }
+        if (group->GetTargetState() ==
+                AseState::BTA_LE_AUDIO_ASE_STATE_CODEC_CONFIGURED &&
+            group->IsPendingConfiguration()) {
+          LOG_INFO(" Configured state completed ");
+          group->ClearPendingConfiguration();
+          state_machine_callbacks_->StatusReportCb(
+              group->group_id_, GroupStreamStatus::CONFIGURED_BY_USER);
 
-          LOG_ERROR(", invalid state transition, from: %s to %s",
-                    ToString(group->GetState()).c_str(),
-                    ToString(group->GetTargetState()).c_str());
-          StopStream(group);
+          /* No more transition for group */
+          alarm_cancel(watchdog_);
           return;
         }
 
+        LOG_ERROR(", invalid state transition, from: %s to %s",
+                  ToString(group->GetState()).c_str(),
+                  ToString(group->GetTargetState()).c_str());
+        StopStream(group);
         break;
       }
       case AseState::BTA_LE_AUDIO_ASE_STATE_CODEC_CONFIGURED: {
@@ -1692,44 +1738,43 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
           return;
         }
 
-        LeAudioDevice* leAudioDeviceNext =
-            group->GetNextActiveDevice(leAudioDevice);
+        /* The other devices of the group are configured in parallel */
+        if (group->HaveAnyActiveDeviceUnconfiguredAses()) {
+          LOG_DEBUG("Wait for the other devices of group %d",
+                    group->group_id_);
+          return;
+        }
 
-        /* Configure ASEs for next device in group */
-        if (leAudioDeviceNext) {
-          PrepareAndSendCodecConfigure(group, leAudioDeviceNext);
-        } else {
-          /* Last node configured, process group to codec configured state */
-          group->SetState(AseState::BTA_LE_AUDIO_ASE_STATE_CODEC_CONFIGURED);
+        /* Last node configured, process group to codec configured state */
+        group->SetState(AseState::BTA_LE_AUDIO_ASE_STATE_CODEC_CONFIGURED);
 
-          if (group->GetTargetState() ==
-              AseState::BTA_LE_AUDIO_ASE_STATE_STREAMING) {
-            if (!CigCreate(group)) {
-              LOG_ERROR("Could not create CIG. Stop the stream for group %d",
-                        group->group_id_);
-              StopStream(group);
-            }
-            return;
+        if (group->GetTargetState() ==
+            AseState::BTA_LE_AUDIO_ASE_STATE_STREAMING) {
+          if (!CigCreate(group)) {
+            LOG_ERROR("Could not create CIG. Stop the stream for group %d",
+                      group->group_id_);
+            StopStream(group);
           }
+          return;
+        }
 
-          if (group->GetTargetState() ==
-                  AseState::BTA_LE_AUDIO_ASE_STATE_CODEC_CONFIGURED &&
-              group->IsPendingConfiguration()) {
-            LOG_INFO(" Configured state completed ");
-            group->ClearPendingConfiguration();
-            state_machine_callbacks_->StatusReportCb(
-                group->group_id_, GroupStreamStatus::CONFIGURED_BY_USER);
-
-            /* No more transition for group */
-            alarm_cancel(watchdog_);
-            return;
-          }
+        if (group->GetTargetState() ==
+                AseState::BTA_LE_AUDIO_ASE_STATE_CODEC_CONFIGURED &&
+            group->IsPendingConfiguration()) {
+          LOG_INFO(" Configured state completed ");
+          group->ClearPendingConfiguration();
+          state_machine_callbacks_->StatusReportCb(
+              group->group_id_, GroupStreamStatus::CONFIGURED_BY_USER);
 
-          LOG_ERROR(", Autonomouse change, from: %s to %s",
-                    ToString(group->GetState()).c_str(),
-                    ToString(group->GetTargetState()).c_str());
+          /* No more transition for group */
+          alarm_cancel(watchdog_);
+          return;
         }
 
+        LOG_ERROR(", Autonomouse change, from: %s to %s",
+                  ToString(group->GetState()).c_str(),
+                  ToString(group->GetTargetState()).c_str());
+
         break;
       }
       case AseState::BTA_LE_AUDIO_ASE_STATE_QOS_CONFIGURED:
@@ -1813,19 +1858,14 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
           return;
         }
 
-        LeAudioDevice* leAudioDeviceNext =
-            group->GetNextActiveDevice(leAudioDevice);
-
-        /* Configure ASEs qos for next device in group */
-        if (leAudioDeviceNext) {
-          PrepareAndSendConfigQos(group, leAudioDeviceNext);
-        } else {
-          leAudioDevice = group->GetFirstActiveDevice();
-          LOG_ASSERT(leAudioDevice)
-              << __func__ << " Shouldn't be called without an active device.";
-          PrepareAndSendEnable(leAudioDevice);
+        /* The other devices of the group are configured in parallel */
+        if (!group->HaveAllActiveDevicesAsesTheSameState(
+                AseState::BTA_LE_AUDIO_ASE_STATE_QOS_CONFIGURED)) {
+          return;
         }
 
+        PrepareAndSendEnableToTheGroup(group);
+
         break;
       }
       case AseState::BTA_LE_AUDIO_ASE_STATE_QOS_CONFIGURED:
@@ -1889,6 +1929,19 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
     }
   }
 
+  void PrepareAndSendEnableToTheGroup(LeAudioDeviceGroup* group) {
+    LeAudioDevice* leAudioDevice = group->GetFirstActiveDevice();
+    LOG_ASSERT(leAudioDevice)
+        << __func__ << " Shouldn't be called without an active device.";
+
+    /* See StartConfigQoSForTheGroup() */
+    auto target_state = group->GetTargetState();
+    do {
+      PrepareAndSendEnable(leAudioDevice);
+      if (group->GetTargetState() != target_state) return;
+    } while ((leAudioDevice = group->GetNextActiveDevice(leAudioDevice)));
+  }
+
   void PrepareAndSendEnable(LeAudioDevice* leAudioDevice) {
     struct le_audio::client_parser::ascs::ctp_enable conf;
     std::vector<struct le_audio::client_parser::ascs::ctp_enable> confs;
@@ -1944,7 +1997,7 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
                                       GATT_WRITE_NO_RSP, NULL, NULL);
   }
 
-  void PrepareAndSendConfigQos(LeAudioDeviceGroup* group,
+  bool PrepareAndSendConfigQos(LeAudioDeviceGroup* group,
                                LeAudioDevice* leAudioDevice) {
     std::vector<struct le_audio::client_parser::ascs::ctp_qos_conf> confs;
 
@@ -1962,14 +2015,14 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
       if (!group->GetPresentationDelay(&conf.pres_delay, ase->direction)) {
         LOG(ERROR) << __func__ << ", inconsistent presentation delay for group";
         StopStream(group);
-        return;
+        return false;
       }
 
       conf.sdu_interval = group->GetSduInterval(ase->direction);
       if (!conf.sdu_interval) {
         LOG(ERROR) << __func__ << ", unsupported SDU interval for group";
         StopStream(group);
-        return;
+        return false;
       }
 
       if (ase->direction == le_audio::types::kLeAudioDirectionSink) {
@@ -1989,6 +2042,7 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
     BtaGattQueue::WriteCharacteristic(leAudioDevice->conn_id_,
                                       leAudioDevice->ctp_hdls_.val_hdl, value,
                                       GATT_WRITE_NO_RSP, NULL, NULL);
+    return true;
   }
 
   void PrepareAndSendUpdateMetadata(LeAudioDeviceGroup* group,
@@ -2045,8 +2099,7 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
       case AseState::BTA_LE_AUDIO_ASE_STATE_QOS_CONFIGURED:
         ase->state = AseState::BTA_LE_AUDIO_ASE_STATE_ENABLING;
 
-        if (leAudioDevice->IsReadyToCreateStream())
-          ProcessGroupEnable(group, leAudioDevice);
+        if (leAudioDevice->IsReadyToCreateStream()) ProcessGroupEnable(group);
 
         break;
 
@@ -2100,8 +2153,7 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
           return;
         }
 
-        if (leAudioDevice->IsReadyToCreateStream())
-          ProcessGroupEnable(group, leAudioDevice);
+        if (leAudioDevice->IsReadyToCreateStream()) ProcessGroupEnable(group);
 
         break;
 
@@ -2276,13 +2328,9 @@ class LeAudioGroupStateMachineImpl : public LeAudioGroupStateMachine {
     }
   }
 
-  void ProcessGroupEnable(LeAudioDeviceGroup* group, LeAudioDevice* device) {
-    /* Enable ASEs for next device in group. */
-    LeAudioDevice* deviceNext = group->GetNextActiveDevice(device);
-    if (deviceNext) {
-      PrepareAndSendEnable(deviceNext);
-      return;
-    }
+  void ProcessGroupEnable(LeAudioDeviceGroup* group) {
+    /* The other devices of the group are enabled in parallel */
+    if (!group->HaveAllActiveDevicesReadyToCreateStream()) return;
 
     /* At this point all of the active ASEs within group are enabled. The server
      * might perform autonomous state transition for Sink ASE and skip Enabling
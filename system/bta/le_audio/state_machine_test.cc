@@ -1245,6 +1245,51 @@ TEST_F(StateMachineTest, testConfigureCodecMulti) {
             types::AseState::BTA_LE_AUDIO_ASE_STATE_CODEC_CONFIGURED);
 }
 
+TEST_F(StateMachineTest, testConfigureCodecMultiInParallel) {
+  const auto context_type = kContextTypeMedia;
+  const auto leaudio_group_id = 2;
+  const auto num_devices = 2;
+
+  // Prepare multiple fake connected devices in a group
+  auto* group =
+      PrepareSingleTestDeviceGroup(leaudio_group_id, context_type, num_devices);
+  ASSERT_EQ(group->Size(), num_devices);
+
+  // Hold the responses of the devices
+  PrepareConfigureCodecHandler(group);
+  auto codec_configure_handler =
+      ase_ctp_handlers[ascs::kAseCtpOpcodeConfigureCodec];
+  std::vector<std::pair<LeAudioDevice*, std::vector<uint8_t>>> writes;
+  ase_ctp_handlers[ascs::kAseCtpOpcodeConfigureCodec] =
+      [&writes](LeAudioDevice* device, std::vector<uint8_t> value,
+                GATT_WRITE_OP_CB cb, void* cb_data) {
+        writes.push_back({device, std::move(value)});
+      };
+
+  InjectInitialIdleNotification(group);
+
+  ON_CALL(*mock_iso_manager_, CreateCig).WillByDefault(Return());
+  EXPECT_CALL(*mock_iso_manager_, CreateCig).Times(1);
+
+  ASSERT_TRUE(LeAudioGroupStateMachine::Get()->StartStream(
+      group, static_cast<types::LeAudioContextType>(context_type),
+      context_type));
+
+  // All the devices are configured without waiting for each other
+  ASSERT_EQ(writes.size(), (size_t)num_devices);
+  ASSERT_NE(writes[0].first, writes[1].first);
+
+  // The group is configured once all the devices have responded
+  codec_configure_handler(writes[1].first, writes[1].second, nullptr,
+                          nullptr);
+  ASSERT_NE(group->GetState(),
+            types::AseState::BTA_LE_AUDIO_ASE_STATE_CODEC_CONFIGURED);
+  codec_configure_handler(writes[0].first, writes[0].second, nullptr,
+                          nullptr);
+  ASSERT_EQ(group->GetState(),
+            types::AseState::BTA_LE_AUDIO_ASE_STATE_CODEC_CONFIGURED);
+}
+
 TEST_F(StateMachineTest, testConfigureQosSingle) {
   const auto context_type = kContextTypeRingtone;
   const int leaudio_group_id = 3;
@@ -1671,6 +1716,57 @@ TEST_F(StateMachineTest, testDisableSingle) {
             types::AseState::BTA_LE_AUDIO_ASE_STATE_QOS_CONFIGURED);
 }
 
+TEST_F(StateMachineTest, testResumeFromQosConfiguredSingle) {
+  const auto context_type = kContextTypeRingtone;
+  const int leaudio_group_id = 4;
+
+  // Prepare fake connected device group
+  auto* group = PrepareSingleTestDeviceGroup(leaudio_group_id, context_type);
+
+  PrepareConfigureCodecHandler(group, 1);
+  PrepareConfigureQosHandler(group, 1);
+  PrepareEnableHandler(group, 1);
+  PrepareDisableHandler(group, 1);
+
+  /* Codec configuration, QoS configuration, enabling, disabling and enabling
+   * again.
+   */
+  auto* leAudioDevice = group->GetFirstDevice();
+  EXPECT_CALL(gatt_queue,
+              WriteCharacteristic(1, leAudioDevice->ctp_hdls_.val_hdl, _,
+                                  GATT_WRITE_NO_RSP, _, _))
+      .Times(5);
+
+  // The CIG is kept while suspended
+  EXPECT_CALL(*mock_iso_manager_, CreateCig(_, _)).Times(1);
+  EXPECT_CALL(*mock_iso_manager_, EstablishCis(_)).Times(2);
+  EXPECT_CALL(*mock_iso_manager_, RemoveCig(_, _)).Times(0);
+
+  InjectInitialIdleNotification(group);
+
+  LeAudioGroupStateMachine::Get()->StartStream(
+      group, static_cast<types::LeAudioContextType>(context_type),
+      context_type);
+  ASSERT_EQ(group->GetState(),
+            types::AseState::BTA_LE_AUDIO_ASE_STATE_STREAMING);
+
+  LeAudioGroupStateMachine::Get()->SuspendStream(group);
+  ASSERT_EQ(group->GetState(),
+            types::AseState::BTA_LE_AUDIO_ASE_STATE_QOS_CONFIGURED);
+
+  // The QoS configuration doesn't fit other contexts
+  ASSERT_FALSE(LeAudioGroupStateMachine::Get()->StartStream(
+      group, static_cast<types::LeAudioContextType>(kContextTypeMedia),
+      kContextTypeMedia));
+
+  // Resume directly with the Enable operation
+  ASSERT_TRUE(LeAudioGroupStateMachine::Get()->StartStream(
+      group, static_cast<types::LeAudioContextType>(context_type),
+      context_type));
+  ASSERT_EQ(group->GetState(),
+            types::AseState::BTA_LE_AUDIO_ASE_STATE_STREAMING);
+}
+
 TEST_F(StateMachineTest, testDisableMultiple) {
   const auto context_type = kContextTypeMedia;
   const auto leaudio_group_id = 4;
@@ -0,0 +1,165 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <map>
+#include <string>
+
+#include "bta/ag/bta_ag_at.h"
+#include "bta/include/bta_at_table.h"
+#include "stack/include/btm_api.h"
+
+using ::benchmark::State;
+
+std::map<std::string, int> mock_function_count_map;
+
+// Used by the device class helpers of utl.cc, not by the AT parser.
+tBTM_STATUS BTM_SetDeviceClass(DEV_CLASS /* dev_class */) {
+  return BTM_SUCCESS;
+}
+uint8_t* BTM_ReadDeviceClass(void) { return nullptr; }
+
+namespace {
+
+// Same commands and argument types as the HFP table of bta_ag_cmd.cc.
+constexpr tBTA_AG_AT_CMD kHfpCmd[] = {
+    {"A", 0, BTA_AG_AT_NONE, BTA_AG_AT_STR, 0, 0},
+    {"D", 1, BTA_AG_AT_NONE | BTA_AG_AT_FREE, BTA_AG_AT_STR, 0, 0},
+    {"+VGS", 2, BTA_AG_AT_SET, BTA_AG_AT_INT, 0, 15},
+    {"+VGM", 3, BTA_AG_AT_SET, BTA_AG_AT_INT, 0, 15},
+    {"+CCWA", 4, BTA_AG_AT_SET, BTA_AG_AT_INT, 0, 1},
+    {"+CHLD", 5, BTA_AG_AT_SET | BTA_AG_AT_TEST, BTA_AG_AT_STR, 0, 4},
+    {"+CHUP", 6, BTA_AG_AT_NONE, BTA_AG_AT_STR, 0, 0},
+    {"+CIND", 7, BTA_AG_AT_READ | BTA_AG_AT_TEST, BTA_AG_AT_STR, 0, 0},
+    {"+CLIP", 8, BTA_AG_AT_SET, BTA_AG_AT_INT, 0, 1},
+    {"+CMER", 9, BTA_AG_AT_SET, BTA_AG_AT_STR, 0, 0},
+    {"+VTS", 10, BTA_AG_AT_SET, BTA_AG_AT_STR, 0, 0},
+    {"+BINP", 11, BTA_AG_AT_SET, BTA_AG_AT_INT, 1, 1},
+    {"+BLDN", 12, BTA_AG_AT_NONE, BTA_AG_AT_STR, 0, 0},
+    {"+BVRA", 13, BTA_AG_AT_SET, BTA_AG_AT_INT, 0, 1},
+    {"+BRSF", 14, BTA_AG_AT_SET, BTA_AG_AT_INT, 0, 32767},
+    {"+NREC", 15, BTA_AG_AT_SET, BTA_AG_AT_INT, 0, 0},
+    {"+CNUM", 16, BTA_AG_AT_NONE, BTA_AG_AT_STR, 0, 0},
+    {"+BTRH", 17, BTA_AG_AT_READ | BTA_AG_AT_SET, BTA_AG_AT_INT, 0, 2},
+    {"+CLCC", 18, BTA_AG_AT_NONE, BTA_AG_AT_STR, 0, 0},
+    {"+COPS", 19, BTA_AG_AT_READ | BTA_AG_AT_SET, BTA_AG_AT_STR, 0, 0},
+    {"+CMEE", 20, BTA_AG_AT_SET, BTA_AG_AT_INT, 0, 1},
+    {"+BIA", 21, BTA_AG_AT_SET, BTA_AG_AT_STR, 0, 20},
+    {"+CBC", 22, BTA_AG_AT_SET, BTA_AG_AT_INT, 0, 100},
+    {"+BCC", 23, BTA_AG_AT_NONE, BTA_AG_AT_STR, 0, 0},
+    {"+BCS", 24, BTA_AG_AT_SET, BTA_AG_AT_INT, 0, 32767},
+    {"+BIND", 25, BTA_AG_AT_SET | BTA_AG_AT_READ | BTA_AG_AT_TEST,
+     BTA_AG_AT_STR, 0, 0},
+    {"+BIEV", 26, BTA_AG_AT_SET, BTA_AG_AT_STR, 0, 0},
+    {"+BAC", 27, BTA_AG_AT_SET, BTA_AG_AT_STR, 0, 0},
+    {"", 0, 0, 0, 0, 0}};
+
+constexpr tBTA_AT_INDEX kHfpIdx =
+    bta_at_make_index(kHfpCmd, &tBTA_AG_AT_CMD::p_cmd);
+static_assert(kHfpIdx.seed != 0, "No perfect hash of the HFP commands");
+
+// Commands sent by a HFP 1.8 hands-free unit to set up the service level
+// connection and its first volume settings.
+constexpr char kSlcSetup[] =
+    "AT+BRSF=959\r"
+    "AT+BAC=1,2\r"
+    "AT+CIND=?\r"
+    "AT+CIND?\r"
+    "AT+CMER=3,0,0,1\r"
+    "AT+CHLD=?\r"
+    "AT+BIND=1,2\r"
+    "AT+BIND=?\r"
+    "AT+BIND?\r"
+    "AT+CLIP=1\r"
+    "AT+CCWA=1\r"
+    "AT+CMEE=1\r"
+    "AT+BIA=0,0,0,1,1,1,0\r"
+    "AT+COPS=3,0\r"
+    "AT+VGS=10\r"
+    "AT+VGM=10\r";
+constexpr size_t kSlcSetupCommands = 16;
+constexpr uint16_t kCmdMaxLen = 256;
+
+size_t num_commands;
+size_t num_errors;
+
+void cmd_cback(tBTA_AG_SCB* /* p_user */, uint16_t command_id,
+               uint8_t /* arg_type */, char* p_arg, char* /* p_end */,
+               int16_t int_arg) {
+  ::benchmark::DoNotOptimize(command_id);
+  ::benchmark::DoNotOptimize(p_arg);
+  ::benchmark::DoNotOptimize(int_arg);
+  num_commands++;
+}
+
+void err_cback(tBTA_AG_SCB* /* p_user */, bool /* unknown */,
+               const char* /* p_arg */) {
+  num_errors++;
+}
+
+class AgAtBenchmark : public ::benchmark::Fixture {
+ public:
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    memset(&at_cb_, 0, sizeof(at_cb_));
+    at_cb_.p_at_tbl = kHfpCmd;
+    at_cb_.p_cmd_cback = cmd_cback;
+    at_cb_.p_err_cback = err_cback;
+    at_cb_.cmd_max_len = kCmdMaxLen;
+    bta_ag_at_init(&at_cb_);
+    num_commands = 0;
+    num_errors = 0;
+  }
+
+  void TearDown(State& st) override {
+    bta_ag_at_reinit(&at_cb_);
+    ::benchmark::Fixture::TearDown(st);
+  }
+
+  void ParseSlcSetup(State& state) {
+    char buf[sizeof(kSlcSetup)];
+    for (auto _ : state) {
+      memcpy(buf, kSlcSetup, sizeof(kSlcSetup));
+      bta_ag_at_parse(&at_cb_, buf, sizeof(kSlcSetup) - 1);
+    }
+    if (num_errors != 0 ||
+        num_commands != state.iterations() * kSlcSetupCommands) {
+      state.SkipWithError("SLC setup commands not all parsed");
+    }
+    state.SetItemsProcessed(state.iterations() * kSlcSetupCommands);
+  }
+
+  tBTA_AG_AT_CB at_cb_;
+};
+
+// Command lookup as it was done before the table index, for comparison.
+BENCHMARK_DEFINE_F(AgAtBenchmark, slc_setup_linear)(State& state) {
+  at_cb_.p_at_idx = nullptr;
+  ParseSlcSetup(state);
+}
+BENCHMARK_REGISTER_F(AgAtBenchmark, slc_setup_linear);
+
+BENCHMARK_DEFINE_F(AgAtBenchmark, slc_setup_indexed)(State& state) {
+  at_cb_.p_at_idx = &kHfpIdx;
+  ParseSlcSetup(state);
+}
+BENCHMARK_REGISTER_F(AgAtBenchmark, slc_setup_indexed);
+
+}  // namespace
+
+BENCHMARK_MAIN();
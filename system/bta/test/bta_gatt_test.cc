@@ -51,6 +51,29 @@ void bta_gatt_read_complete_callback(uint16_t conn_id, tGATT_STATUS status,
   param::bta_gatt_read_complete_callback.data = data;
 }
 
+namespace param {
+struct {
+  uint16_t conn_id;
+  tGATT_STATUS status;
+  tBTA_GATTC_MULTI handles;
+  uint16_t len;
+  uint8_t* value;
+  void* data;
+} bta_gatt_read_multi_complete_callback;
+}  // namespace param
+void bta_gatt_read_multi_complete_callback(uint16_t conn_id,
+                                           tGATT_STATUS status,
+                                           tBTA_GATTC_MULTI& handles,
+                                           uint16_t len, uint8_t* value,
+                                           void* data) {
+  param::bta_gatt_read_multi_complete_callback.conn_id = conn_id;
+  param::bta_gatt_read_multi_complete_callback.status = status;
+  param::bta_gatt_read_multi_complete_callback.handles = handles;
+  param::bta_gatt_read_multi_complete_callback.len = len;
+  param::bta_gatt_read_multi_complete_callback.value = value;
+  param::bta_gatt_read_multi_complete_callback.data = data;
+}
+
 namespace param {
 struct {
   uint16_t conn_id;
@@ -106,6 +129,7 @@ class BtaGattTest : public ::testing::Test {
   void SetUp() override {
     mock_function_count_map.clear();
     param::bta_gatt_read_complete_callback = {};
+    param::bta_gatt_read_multi_complete_callback = {};
     param::bta_gatt_write_complete_callback = {};
     param::bta_gatt_configure_mtu_complete_callback = {};
     param::bta_gattc_event_complete_callback = {};
@@ -177,6 +201,48 @@ TEST_F(BtaGattTest, bta_gattc_op_cmpl_read) {
   ASSERT_EQ(this, param::bta_gatt_read_complete_callback.data);
 }
 
+TEST_F(BtaGattTest, bta_gattc_op_cmpl_read_multi) {
+  command_queue = {
+      .api_read_multi =  // tBTA_GATTC_API_READ_MULTI
+      {
+          .hdr =
+              {
+                  .event = BTA_GATTC_API_READ_MULTI_EVT,
+              },
+          .variable_len = true,
+          .num_attr = 2,
+          .handles = {123, 124},
+          .read_multi_cb = bta_gatt_read_multi_complete_callback,
+          .read_multi_cb_data = static_cast<void*>(this),
+      },
+  };
+
+  client_channel_control_block.p_q_cmd = &command_queue;
+
+  tBTA_GATTC_DATA data = {
+      .op_cmpl =
+          {
+              .op_code = GATTC_OPTYPE_READ,
+              .status = GATT_SUCCESS,
+              .p_cmpl = &gatt_cl_complete,
+          },
+  };
+
+  bta_gattc_op_cmpl(&client_channel_control_block, &data);
+  ASSERT_EQ(1, mock_function_count_map["osi_free_and_reset"]);
+  ASSERT_EQ(0, param::bta_gatt_read_complete_callback.conn_id);
+  ASSERT_EQ(456, param::bta_gatt_read_multi_complete_callback.conn_id);
+  ASSERT_EQ(GATT_SUCCESS, param::bta_gatt_read_multi_complete_callback.status);
+  ASSERT_EQ(2, param::bta_gatt_read_multi_complete_callback.handles.num_attr);
+  ASSERT_EQ(123,
+            param::bta_gatt_read_multi_complete_callback.handles.handles[0]);
+  ASSERT_EQ(124,
+            param::bta_gatt_read_multi_complete_callback.handles.handles[1]);
+  ASSERT_EQ(4, param::bta_gatt_read_multi_complete_callback.len);
+  ASSERT_EQ(10, param::bta_gatt_read_multi_complete_callback.value[0]);
+  ASSERT_EQ(this, param::bta_gatt_read_multi_complete_callback.data);
+}
+
 TEST_F(BtaGattTest, bta_gattc_op_cmpl_write) {
   command_queue = {
       .api_write =  // tBTA_GATTC_API_WRITE
@@ -178,4 +178,47 @@ TEST(DatabaseBuilderTest, SecondaryServiceOutOfOrderTest) {
   ASSERT_EQ(service, result.Services().end());
 }
 
+/* Verify only the changed range is left to discover, the services outside of
+ * it being kept */
+TEST(DatabaseBuilderTest, KeepServicesOutsideRangeTest) {
+  DatabaseBuilder cached_builder;
+  cached_builder.AddService(0x0001, 0x000f, SERVICE_1_UUID, true);
+  cached_builder.AddCharacteristic(0x0002, 0x0003, SERVICE_1_CHAR_1_UUID,
+                                   0x02);
+  cached_builder.AddService(0x0010, 0x001f, SERVICE_2_UUID, true);
+  cached_builder.AddService(0x0020, 0x002f, SERVICE_3_UUID, true);
+  Database cached = cached_builder.Build();
+
+  DatabaseBuilder builder;
+  // The range overlaps the second service, which is rediscovered as a whole
+  ASSERT_EQ(builder.KeepServicesOutsideRange(cached, 0x0018, 0x001f),
+            make_pair_u16(0x0010, 0x001f));
+  EXPECT_TRUE(builder.InProgress());
+  EXPECT_FALSE(builder.StartNextServiceExploration());
+
+  // Rediscovered service
+  builder.AddService(0x0010, 0x0018, SERVICE_4_UUID, true);
+  EXPECT_TRUE(builder.StartNextServiceExploration());
+  ASSERT_EQ(builder.CurrentlyExploredService(), make_pair_u16(0x0010, 0x0018));
+  EXPECT_FALSE(builder.StartNextServiceExploration());
+
+  Database result = builder.Build();
+  auto service = result.Services().begin();
+  ASSERT_EQ(service->handle, 0x0001);
+  ASSERT_EQ(service->uuid, SERVICE_1_UUID);
+  ASSERT_EQ(service->characteristics.size(), (size_t)1);
+
+  service++;
+  ASSERT_EQ(service->handle, 0x0010);
+  ASSERT_EQ(service->end_handle, 0x0018);
+  ASSERT_EQ(service->uuid, SERVICE_4_UUID);
+
+  service++;
+  ASSERT_EQ(service->handle, 0x0020);
+  ASSERT_EQ(service->uuid, SERVICE_3_UUID);
+
+  service++;
+  ASSERT_EQ(service, result.Services().end());
+}
+
 }  // namespace gatt
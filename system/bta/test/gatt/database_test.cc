@@ -97,6 +97,35 @@ TEST(GattDatabaseTest, serialize_deserialize_binary_test) {
   EXPECT_EQ(serialized[5].value.characteristic_extended_properties, 0x0001);
 }
 
+/* This test makes sure that a database can be rebuilt from attributes stored
+ * contiguously, as they are in a mapped cache file */
+TEST(GattDatabaseTest, deserialize_from_buffer_test) {
+  DatabaseBuilder builder;
+  builder.AddService(0x0001, 0x000f, SERVICE_1_UUID, true);
+  builder.AddService(0x0010, 0x001f, SERVICE_2_UUID, false);
+  builder.AddIncludedService(0x0002, SERVICE_2_UUID, 0x0010, 0x001f);
+  builder.AddCharacteristic(0x0003, 0x0004, SERVICE_1_CHAR_1_UUID, 0x02);
+  builder.AddDescriptor(0x0005, SERVICE_1_CHAR_1_DESC_1_UUID);
+
+  Database db = builder.Build();
+  std::vector<StoredAttribute> serialized = db.Serialize();
+
+  std::vector<uint8_t> buf(serialized.size() * sizeof(StoredAttribute));
+  memcpy(buf.data(), serialized.data(), buf.size());
+
+  bool success = false;
+  Database result = Database::Deserialize(
+      (const StoredAttribute*)buf.data(), serialized.size(), &success);
+  EXPECT_TRUE(success);
+  EXPECT_EQ(result.Hash(), db.Hash());
+  EXPECT_EQ(result.ToString(), db.ToString());
+
+  // Without the first service, its attributes have no service to belong to.
+  result = Database::Deserialize((const StoredAttribute*)buf.data() + 1,
+                                 serialized.size() - 1, &success);
+  EXPECT_FALSE(success);
+}
+
 /* This test makes sure that Service represented in StoredAttribute have proper
  * binary format. */
 TEST(GattCacheTest, stored_attribute_to_binary_service_test) {
@@ -0,0 +1,150 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "bta/le_audio/broadcaster/encoder_pipeline.h"
+
+using ::benchmark::State;
+using le_audio::broadcaster::EncoderPipeline;
+using le_audio::broadcaster::EncoderTierConfig;
+
+namespace {
+
+constexpr uint8_t kInputChannels = 2;
+constexpr uint32_t kInputSampleRate = 48000;
+constexpr uint32_t kDataIntervalUs = 10000;
+constexpr size_t kInputSamples = kInputSampleRate / 100;
+
+// 48_2 and 16_2 broadcast configurations, one channel per BIS
+constexpr EncoderTierConfig kHighQuality = {
+    .num_channels = 2,
+    .sample_rate = 48000,
+    .data_interval_us = kDataIntervalUs,
+    .octets_per_frame = 100};
+constexpr EncoderTierConfig kLowQuality = {.num_channels = 2,
+                                           .sample_rate = 16000,
+                                           .data_interval_us = kDataIntervalUs,
+                                           .octets_per_frame = 40};
+
+// Sends the frames of a tier on |num_bis| BISes. The copy stands for the one
+// made into the ISO SDU by the IsoManager.
+void send(const std::vector<std::vector<uint8_t>>& channels, int num_bis,
+          std::vector<uint8_t>& sdu) {
+  for (int bis = 0; bis < num_bis; ++bis) {
+    const auto& frame = channels[bis % channels.size()];
+    memcpy(sdu.data(), frame.data(), frame.size());
+    ::benchmark::ClobberMemory();
+  }
+}
+
+class BroadcastEncoderBenchmark : public ::benchmark::Fixture {
+ public:
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    pcm_.resize(kInputSamples * kInputChannels * sizeof(int16_t));
+    auto samples = reinterpret_cast<int16_t*>(pcm_.data());
+    for (size_t i = 0; i < kInputSamples; ++i) {
+      samples[2 * i] = 8000 * sin(2 * M_PI * 440 * i / kInputSampleRate);
+      samples[2 * i + 1] = 8000 * sin(2 * M_PI * 1000 * i / kInputSampleRate);
+    }
+    sdu_.resize(kHighQuality.octets_per_frame);
+  }
+
+  void TearDown(State& st) override {
+    pipelines_.clear();
+    ::benchmark::Fixture::TearDown(st);
+  }
+
+  EncoderPipeline& NewPipeline() {
+    pipelines_.push_back(std::make_unique<EncoderPipeline>());
+    pipelines_.back()->SetInput(kInputChannels, kInputSampleRate,
+                                kDataIntervalUs);
+    return *pipelines_.back();
+  }
+
+  std::vector<uint8_t> pcm_;
+  std::vector<uint8_t> sdu_;
+  std::vector<std::unique_ptr<EncoderPipeline>> pipelines_;
+};
+
+// Each stereo BIG with its own encoders, as before the shared pipeline
+BENCHMARK_DEFINE_F(BroadcastEncoderBenchmark, encoder_per_big)
+(State& state) {
+  const int num_bis = state.range(0);
+  const int num_bigs = num_bis / kHighQuality.num_channels;
+  for (int big = 0; big < num_bigs; ++big) {
+    NewPipeline().AddTier(kHighQuality);
+  }
+
+  for (auto _ : state) {
+    for (auto& pipeline : pipelines_) {
+      pipeline->Encode(0, pcm_);
+      send(pipeline->GetEncodedChannels(0), kHighQuality.num_channels, sdu_);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_bis);
+}
+BENCHMARK_REGISTER_F(BroadcastEncoderBenchmark, encoder_per_big)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8);
+
+// All the BIGs in one tier, encoded once
+BENCHMARK_DEFINE_F(BroadcastEncoderBenchmark, shared_tier)(State& state) {
+  const int num_bis = state.range(0);
+  auto& pipeline = NewPipeline();
+  pipeline.AddTier(kHighQuality);
+
+  for (auto _ : state) {
+    pipeline.Encode(0, pcm_);
+    send(pipeline.GetEncodedChannels(0), num_bis, sdu_);
+  }
+  state.SetItemsProcessed(state.iterations() * num_bis);
+}
+BENCHMARK_REGISTER_F(BroadcastEncoderBenchmark, shared_tier)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8);
+
+// Half of the BISes in a high and half in a downsampled low quality tier
+BENCHMARK_DEFINE_F(BroadcastEncoderBenchmark, two_tiers)(State& state) {
+  const int num_bis = state.range(0);
+  auto& pipeline = NewPipeline();
+  auto high = pipeline.AddTier(kHighQuality);
+  auto low = pipeline.AddTier(kLowQuality);
+
+  for (auto _ : state) {
+    pipeline.Encode(high, pcm_);
+    send(pipeline.GetEncodedChannels(high), num_bis / 2, sdu_);
+    pipeline.Encode(low, pcm_);
+    send(pipeline.GetEncodedChannels(low), num_bis / 2, sdu_);
+  }
+  state.SetItemsProcessed(state.iterations() * num_bis);
+}
+BENCHMARK_REGISTER_F(BroadcastEncoderBenchmark, two_tiers)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -21,6 +21,7 @@
 #include <base/strings/string_util.h>
 #include <hardware/bt_vc.h>
 
+#include <set>
 #include <string>
 #include <vector>
 
@@ -650,6 +651,31 @@ class VolumeControlImpl : public VolumeControl {
     }
   }
 
+  /* A device already at the requested volume does not notify the write, so
+   * the operation would only wait for its timeout. Drops such devices unless
+   * an earlier operation may still change their volume.
+   */
+  void RemoveDevicesAtVolume(std::vector<RawAddress>& devices,
+                             uint8_t volume) {
+    for (auto it = devices.begin(); it != devices.end();) {
+      auto addr = *it;
+      bool is_busy = std::any_of(
+          ongoing_operations_.begin(), ongoing_operations_.end(),
+          [addr](auto& operation) {
+            return find(operation.devices_.begin(), operation.devices_.end(),
+                        addr) != operation.devices_.end();
+          });
+      auto dev = volume_control_devices_.FindByAddress(addr);
+      if (!is_busy && dev && dev->volume == volume) {
+        DLOG(INFO) << __func__ << " " << addr << " already at volume "
+                   << +volume;
+        it = devices.erase(it);
+      } else {
+        it++;
+      }
+    }
+  }
+
   void OnWriteControlResponse(uint16_t connection_id, tGATT_STATUS status,
                               uint16_t handle, void* data) {
     VolumeControlDevice* device =
@@ -680,23 +706,44 @@ class VolumeControlImpl : public VolumeControl {
       return;
     };
 
-    auto op = &ongoing_operations_.front();
-
-    LOG(INFO) << __func__ << " operation_id: " << op->operation_id_;
-
-    if (op->IsStarted()) {
-      LOG(INFO) << __func__ << " wait until operation " << op->operation_id_
-                << " is complete";
-      return;
+    /* Operations keep their order on each device, but an operation whose
+     * devices are not waiting for an earlier one starts right away. This way
+     * a device or set member is not held back by the others.
+     */
+    std::set<RawAddress> busy_devices;
+    std::vector<int> operations_to_start;
+    for (auto& op : ongoing_operations_) {
+      bool is_blocked = std::any_of(
+          op.devices_.begin(), op.devices_.end(),
+          [&busy_devices](auto& addr) { return busy_devices.count(addr); });
+      busy_devices.insert(op.devices_.begin(), op.devices_.end());
+
+      if (op.IsStarted()) continue;
+      if (is_blocked) {
+        LOG(INFO) << __func__ << " operation " << op.operation_id_
+                  << " waits for an earlier one";
+        continue;
+      }
+      operations_to_start.push_back(op.operation_id_);
     }
 
-    op->Start();
-
-    alarm_set_on_mloop(op->operation_timeout_, 3000, operation_callback,
-                       INT_TO_PTR(op->operation_id_));
-    devices_control_point_helper(
-        op->devices_, op->opcode_,
-        op->arguments_.size() == 0 ? nullptr : &(op->arguments_));
+    for (auto operation_id : operations_to_start) {
+      auto op = find_if(ongoing_operations_.begin(), ongoing_operations_.end(),
+                        [operation_id](auto& operation) {
+                          return operation.operation_id_ == operation_id;
+                        });
+      if (op == ongoing_operations_.end()) continue;
+
+      LOG(INFO) << __func__ << " operation_id: " << op->operation_id_;
+      op->Start();
+
+      alarm_set_on_mloop(op->operation_timeout_, 3000, operation_callback,
+                         INT_TO_PTR(op->operation_id_));
+      devices_control_point_helper(
+          op->devices_, op->opcode_,
+          op->arguments_.size() == 0 ? nullptr : &(op->arguments_),
+          op->operation_id_);
+    }
   }
 
   void CancelVolumeOperation(int operation_id) {
@@ -736,7 +783,8 @@ class VolumeControlImpl : public VolumeControl {
 
     alarm_set_on_mloop(op->operation_timeout_, 3000, operation_callback,
                        INT_TO_PTR(op->operation_id_));
-    devices_control_point_helper(op->devices_, op->opcode_, &(op->arguments_));
+    devices_control_point_helper(op->devices_, op->opcode_, &(op->arguments_),
+                                 op->operation_id_);
   }
 
   void PrepareVolumeControlOperation(std::vector<RawAddress>& devices,
@@ -821,6 +869,9 @@ class VolumeControlImpl : public VolumeControl {
 
       RemovePendingVolumeControlOperations(devices,
                                            bluetooth::groups::kGroupUnknown);
+      RemoveDevicesAtVolume(devices, volume);
+      if (devices.empty()) return;
+
       PrepareVolumeControlOperation(devices, bluetooth::groups::kGroupUnknown,
                                     false, opcode, arg);
     } else {
@@ -850,6 +901,9 @@ class VolumeControlImpl : public VolumeControl {
       }
 
       RemovePendingVolumeControlOperations(devices, group_id);
+      RemoveDevicesAtVolume(devices, volume);
+      if (devices.empty()) return;
+
       PrepareVolumeControlOperation(devices, group_id, false, opcode, arg);
     }
 
@@ -921,6 +921,12 @@ TEST_F(VolumeControlValueSetTest, test_set_volume) {
   VolumeControl::Get()->SetVolume(test_address, 0x10);
 }
 
+TEST_F(VolumeControlValueSetTest, test_set_volume_unchanged) {
+  /* The device is already at this volume and would not notify the write */
+  EXPECT_CALL(gatt_queue, WriteCharacteristic(_, _, _, _, _, _)).Times(0);
+  VolumeControl::Get()->SetVolume(test_address, 0x00);
+}
+
 TEST_F(VolumeControlValueSetTest, test_mute) {
   std::vector<uint8_t> mute({0x06, 0x00});
   EXPECT_CALL(gatt_queue,
@@ -1046,6 +1052,42 @@ TEST_F(VolumeControlCsis, test_set_volume) {
   GetNotificationEvent(conn_id_2, test_address_2, 0x0021, value);
 }
 
+TEST_F(VolumeControlCsis, test_set_volume_coalesced) {
+  std::vector<uint8_t> first({0x04, 0x00, 10});
+  std::vector<uint8_t> latest({0x04, 0x01, 30});
+  EXPECT_CALL(gatt_queue,
+              WriteCharacteristic(conn_id_1, 0x0024, first, GATT_WRITE, _, _));
+  EXPECT_CALL(gatt_queue,
+              WriteCharacteristic(conn_id_2, 0x0024, first, GATT_WRITE, _, _));
+  VolumeControl::Get()->SetVolume(group_id, 10);
+
+  /* Only the latest of the changes made meanwhile is written */
+  VolumeControl::Get()->SetVolume(group_id, 20);
+  VolumeControl::Get()->SetVolume(group_id, 30);
+  Mock::VerifyAndClearExpectations(&gatt_queue);
+
+  EXPECT_CALL(gatt_queue,
+              WriteCharacteristic(conn_id_1, 0x0024, latest, GATT_WRITE, _, _));
+  EXPECT_CALL(gatt_queue,
+              WriteCharacteristic(conn_id_2, 0x0024, latest, GATT_WRITE, _, _));
+  EXPECT_CALL(*callbacks, OnGroupVolumeStateChanged(group_id, 10, false, false));
+
+  std::vector<uint8_t> value({10, 0x00, 0x01});
+  GetNotificationEvent(conn_id_1, test_address_1, 0x0021, value);
+  GetNotificationEvent(conn_id_2, test_address_2, 0x0021, value);
+}
+
+TEST_F(VolumeControlCsis, test_set_volume_members_in_parallel) {
+  /* The second device does not wait for the first one to notify */
+  EXPECT_CALL(gatt_queue,
+              WriteCharacteristic(conn_id_1, 0x0024, _, GATT_WRITE, _, _));
+  EXPECT_CALL(gatt_queue,
+              WriteCharacteristic(conn_id_2, 0x0024, _, GATT_WRITE, _, _));
+
+  VolumeControl::Get()->SetVolume(test_address_1, 10);
+  VolumeControl::Get()->SetVolume(test_address_2, 20);
+}
+
 TEST_F(VolumeControlCsis, autonomus_test_set_volume) {
   /* Now inject notification and make sure callback is sent up to Java layer */
   EXPECT_CALL(*callbacks, OnGroupVolumeStateChanged(group_id, 0x03, false, true));
@@ -119,8 +119,10 @@ void btif_a2dp_sink_set_rx_flush(bool enable);
 
 // Enqueue a buffer to the A2DP Sink queue. If the queue has reached its
 // maximum size |MAX_INPUT_A2DP_FRAME_QUEUE_SZ|, the oldest buffer is
-// removed from the queue.
-// |p_buf| is the buffer to enqueue.
+// removed from the queue. The buffer is decoded to the jitter buffer on the
+// worker thread.
+// |p_buf| is the buffer to enqueue, with the RTP timestamp of the packet at
+// the start of its offset area.
 // Returns the number of buffers in the Sink queue after the enqueing.
 uint8_t btif_a2dp_sink_enqueue_buf(BT_HDR* p_buf);
 
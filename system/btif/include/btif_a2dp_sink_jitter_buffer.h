@@ -0,0 +1,122 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#ifndef BTIF_A2DP_SINK_JITTER_BUFFER_H
+#define BTIF_A2DP_SINK_JITTER_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Jitter buffer of the decoded A2DP Sink audio.
+//
+// The decoded audio is placed according to the RTP timestamp of its packet,
+// in units of frames at the sample rate of the stream. Missing audio is
+// replaced by silence and audio arriving after its playout time is dropped,
+// so that the latency doesn't creep up when the link stalls.
+//
+// The playout starts once the buffer holds the target delay, derived from
+// the packet duration and the inter-arrival jitter of the packets. The audio
+// is then played at the rate of the local clock. The difference between the
+// clocks of the peer and of the local device, as well as the changes of the
+// target delay, are absorbed by slowly dropping or repeating frames.
+class A2dpSinkJitterBuffer {
+ public:
+  // The weight of the arrival jitter in the target delay
+  static constexpr uint64_t kJitterMultiplier = 4;
+
+  // Max. drift compensation, in frames per thousand played frames
+  static constexpr uint64_t kMaxDriftPerMille = 5;
+
+  struct Stats {
+    size_t packets;
+    size_t late_packets;       // Received after their playout time
+    size_t resyncs;            // Timestamp discontinuities
+    size_t underruns;          // The buffer ran dry while playing
+    uint64_t concealed_frames; // Missing audio replaced by silence
+    uint64_t dropped_frames;   // Late audio and overflows
+    uint64_t skipped_frames;   // Dropped to compensate the drift
+    uint64_t repeated_frames;  // Repeated to compensate the drift
+    uint64_t max_depth_us;
+  };
+
+  A2dpSinkJitterBuffer();
+
+  // Start a new stream of frames of |frame_size| bytes at |sample_rate|.
+  // The target delay is bounded by |min_delay_us| and |max_delay_us|.
+  void Start(uint32_t sample_rate, size_t frame_size, uint64_t min_delay_us,
+             uint64_t max_delay_us);
+
+  // Drop the buffered audio. The playout restarts at the next packet.
+  void Flush();
+
+  // Record the arrival at |arrival_us| of the packet with the RTP timestamp
+  // |timestamp|. Its decoded audio is pushed next.
+  void OnPacket(uint32_t timestamp, uint64_t arrival_us);
+
+  // Add |len| bytes of decoded audio of the last packet.
+  void Push(const uint8_t* data, size_t len);
+
+  // Append to |out| the audio due for playout at |now_us|.
+  // Returns the number of frames appended.
+  size_t Pull(uint64_t now_us, std::vector<uint8_t>* out);
+
+  bool IsPlaying() const { return playing_; }
+  size_t DepthFrames() const;
+  uint64_t DepthUs() const { return FramesToUs(DepthFrames()); }
+  uint64_t TargetUs() const;
+  uint64_t JitterUs() const { return jitter_us_x16_ >> 4; }
+
+  Stats stats;
+
+ private:
+  uint64_t FramesToUs(uint64_t frames) const;
+  uint64_t UsToFrames(uint64_t us) const;
+  void Resync(uint32_t timestamp);
+  void Drop(size_t frames);
+  void Append(const uint8_t* data, size_t frames);
+
+  uint32_t sample_rate_;
+  size_t frame_size_;
+  uint64_t min_delay_us_;
+  uint64_t max_delay_us_;
+
+  std::vector<uint8_t> buffer_;
+  size_t head_;  // Offset of the first buffered byte
+
+  bool synced_;         // The timestamps of the buffer are known
+  uint32_t read_ts_;    // Timestamp of the next frame to play
+  uint32_t write_ts_;   // Timestamp of the next pushed frame
+  bool packet_late_;    // The last packet was counted as late
+
+  // Arrival jitter, RFC 3550 style
+  bool has_transit_;
+  uint32_t last_ts_;
+  uint64_t last_arrival_us_;
+  uint64_t jitter_us_x16_;
+  uint64_t packet_us_;
+
+  // Playout
+  bool playing_;
+  uint64_t clock_start_us_;
+  uint64_t clock_frames_;      // Frames due since |clock_start_us_|
+  uint64_t avg_depth_x32_;     // Smoothed depth, in frames
+  uint64_t underrun_frames_;   // Silence played by the current underrun
+};
+
+#endif  // BTIF_A2DP_SINK_JITTER_BUFFER_H
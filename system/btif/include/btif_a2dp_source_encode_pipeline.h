@@ -0,0 +1,141 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#ifndef BTIF_A2DP_SOURCE_ENCODE_PIPELINE_H
+#define BTIF_A2DP_SOURCE_ENCODE_PIPELINE_H
+
+#include <base/callback.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "common/message_loop_thread.h"
+#include "types/raw_address.h"
+
+// Deadline statistics of the A2DP Source encode jobs.
+class A2dpEncodeStats {
+ public:
+  A2dpEncodeStats() { Reset(); }
+  void Reset() {
+    total_jobs = 0;
+    deadline_miss_count = 0;
+    skipped_ticks = 0;
+    total_overrun_us = 0;
+    max_overrun_us = 0;
+    max_encode_time_us = 0;
+    last_deadline_miss_us = 0;
+  }
+  void Accumulate(const A2dpEncodeStats& src);
+
+  // Counter for completed encode jobs
+  size_t total_jobs;
+
+  // Counter for encode jobs that completed after their deadline
+  size_t deadline_miss_count;
+
+  // Counter for timer ticks dropped because the previous job of the same
+  // peer was still pending
+  size_t skipped_ticks;
+
+  // Accumulated deadline overruns (in us)
+  uint64_t total_overrun_us;
+
+  // Max. deadline overrun (in us)
+  uint64_t max_overrun_us;
+
+  // Max. time between the submission and the completion of a job (in us)
+  uint64_t max_encode_time_us;
+
+  // Last deadline miss timestamp (in us)
+  uint64_t last_deadline_miss_us;
+};
+
+// Pool of real-time worker threads running the A2DP Source encoder.
+//
+// Each streaming peer is pinned to one worker, so that the jobs of a given
+// peer are run in order, while the jobs of different peers run in parallel.
+// The media timer submits one job per peer and per tick, with the next tick
+// as deadline. A job submitted while the previous one of the same peer is
+// still pending is dropped: the encoders compute the number of frames to
+// send from the elapsed time, and catch up on the next tick.
+//
+// All methods must be called from the same thread, but for GetStats() and
+// CollectStats() which can be called from any thread.
+class A2dpEncodePipeline {
+ public:
+  explicit A2dpEncodePipeline(size_t num_workers);
+  ~A2dpEncodePipeline();
+
+  // Start the worker threads. When |real_time| is true the workers are
+  // switched to SCHED_FIFO, and false is returned if this fails.
+  bool StartUp(bool real_time);
+
+  // Run the pending jobs, and exit the worker threads.
+  void ShutDown();
+
+  bool IsRunning() const;
+  size_t NumWorkers() const { return workers_.size(); }
+
+  // Assign the peer |peer_address| to the least loaded worker.
+  // Returns the index of the worker.
+  size_t AddPeer(const RawAddress& peer_address);
+
+  // Release the worker of the peer |peer_address|. The peer must not have
+  // any pending job, see Flush().
+  void RemovePeer(const RawAddress& peer_address);
+
+  // Returns the index of the worker of the peer |peer_address|, or -1.
+  int WorkerOf(const RawAddress& peer_address) const;
+
+  // Submit the encode job |job| of peer |peer_address|, which should be
+  // completed before |deadline_us| (os boottime).
+  // Returns false when the job is dropped.
+  bool Submit(const RawAddress& peer_address, uint64_t deadline_us,
+              base::OnceClosure job);
+
+  // Block until all the submitted jobs are completed. The encoder state can
+  // be safely updated by the caller after this call.
+  void Flush();
+
+  A2dpEncodeStats GetStats() const;
+
+  // Accumulate the statistics into |dst|, and reset them.
+  void CollectStats(A2dpEncodeStats* dst);
+
+ private:
+  struct Peer {
+    size_t worker;
+    bool pending;
+  };
+
+  void RunJob(std::shared_ptr<Peer> peer, uint64_t submit_us,
+              uint64_t deadline_us, base::OnceClosure job);
+
+  std::vector<std::unique_ptr<bluetooth::common::MessageLoopThread>> workers_;
+  std::vector<size_t> worker_load_;
+  std::map<RawAddress, std::shared_ptr<Peer>> peers_;
+
+  mutable std::mutex mutex_;
+  A2dpEncodeStats stats_;
+};
+
+#endif  // BTIF_A2DP_SOURCE_ENCODE_PIPELINE_H
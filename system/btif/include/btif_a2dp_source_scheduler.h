@@ -0,0 +1,116 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#ifndef BTIF_A2DP_SOURCE_SCHEDULER_H
+#define BTIF_A2DP_SOURCE_SCHEDULER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Histogram with fixed buckets.
+class A2dpSourceHistogram {
+ public:
+  // |bounds| are the increasing exclusive upper bounds of the buckets. An
+  // extra bucket collects the values above the last bound.
+  explicit A2dpSourceHistogram(std::vector<uint64_t> bounds);
+
+  void Reset();
+  void Add(uint64_t value);
+  void Accumulate(const A2dpSourceHistogram& src);
+
+  size_t Total() const;
+  const std::vector<uint64_t>& Bounds() const { return bounds_; }
+  const std::vector<size_t>& Counts() const { return counts_; }
+
+  // Returns the buckets formatted as "[lo,hi):count ...", the bounds being
+  // divided by |scale|.
+  std::string ToString(uint64_t scale) const;
+
+ private:
+  std::vector<uint64_t> bounds_;
+  std::vector<size_t> counts_;
+};
+
+// State of the link carrying the audio stream sampled when polling the
+// scheduler.
+struct A2dpSourceLinkState {
+  size_t tx_queue_length;  // Packets waiting in the A2DP Source tx queue
+  uint8_t l2c_bufs;        // Packets queued in L2CAP, not sent yet
+  bool congested;          // The L2CAP channel is congested
+  uint64_t sink_delay_us;  // Delay reported by the sink, 0 if unknown
+};
+
+// Decides when the A2DP Source encoder is run.
+//
+// In the fixed mode the encoder runs on every tick of the media timer, one
+// encoder interval apart.
+//
+// In the deadline mode the media timer polls the scheduler a few times per
+// encoder interval. The encoder is run on the poll closest to the nominal
+// deadline, as long as the link drains the encoded packets. When the link is
+// congested, or it still has more than one packet queued, the encoding is
+// deferred to keep the latency low and avoid overflowing the tx queue. The
+// deferral is bounded by the delay the sink reported: the sink buffers at
+// least that much audio, and the encoders catch up on the elapsed time.
+class A2dpSourceScheduler {
+ public:
+  enum Decision {
+    kWait,              // Not due yet
+    kDeferCongested,    // Due, but the link is congested
+    kDeferQueued,       // Due, but the link has packets queued
+    kEncode,            // Run the encoder
+    kEncodeForced,      // Run the encoder, the deferral limit is reached
+  };
+
+  static constexpr size_t kPollsPerInterval = 4;
+
+  A2dpSourceScheduler();
+
+  // Start a new session with the encoder interval |interval_us|.
+  void Start(bool deadline_mode, uint64_t interval_us, uint64_t now_us);
+
+  bool IsDeadlineMode() const { return deadline_mode_; }
+
+  // Returns the period of the media timer.
+  uint64_t TimerPeriodUs() const;
+
+  // Returns the max. time the encoding can be deferred, for the delay
+  // |sink_delay_us| reported by the sink.
+  uint64_t MaxDeferUs(uint64_t sink_delay_us) const;
+
+  // Returns whether the encoder should run on the timer tick at |now_us|.
+  Decision Poll(uint64_t now_us, const A2dpSourceLinkState& link) const;
+
+  // Record that the encoder has run at |now_us|. Updates the histograms.
+  void OnEncode(uint64_t now_us, const A2dpSourceLinkState& link);
+
+  // Deviation of the encoding intervals from the encoder interval (in us)
+  A2dpSourceHistogram jitter_histogram;
+
+  // Packets queued on the link when encoding
+  A2dpSourceHistogram queueing_histogram;
+
+ private:
+  bool deadline_mode_;
+  uint64_t interval_us_;
+  uint64_t last_encode_us_;
+};
+
+#endif  // BTIF_A2DP_SOURCE_SCHEDULER_H
@@ -0,0 +1,121 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#ifndef BTIF_A2DP_SOURCE_TX_QUEUE_POLICY_H
+#define BTIF_A2DP_SOURCE_TX_QUEUE_POLICY_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Occupancy of the A2DP Source tx queue.
+struct A2dpSourceTxQueueLevel {
+  size_t packets;
+  size_t bytes;
+};
+
+// Decides which packets of the A2DP Source tx queue are dropped when the link
+// doesn't keep up with the encoder.
+//
+// The queue is bounded by high watermarks on the number of packets, on the
+// number of bytes and on the playout time of the queued audio. The playout
+// time is estimated from the rate at which the encoder produces data.
+//
+// In the flush mode the whole queue is dropped when a watermark is exceeded.
+// In the drop oldest mode only the oldest packets are dropped, until the
+// queue is back under the low watermarks: the audio keeps flowing with a
+// short gap instead of the queue being emptied at once.
+class A2dpSourceTxQueuePolicy {
+ public:
+  // The low watermarks, in percent of the high watermarks
+  static constexpr size_t kLowWatermarkPercent = 75;
+
+  // Drops and occupancy of the queue since the start of the session
+  struct Stats {
+    size_t drop_events;  // Overflows of the queue
+    size_t dropped_packets;
+    size_t dropped_bytes;
+    uint64_t dropped_playout_us;
+    size_t max_packets;  // Max. occupancy of the queue
+    size_t max_bytes;
+    uint64_t max_playout_us;
+  };
+
+  A2dpSourceTxQueuePolicy();
+
+  // Start a new session with the encoder interval |interval_us|.
+  void Start(bool drop_oldest, uint64_t interval_us, uint64_t now_us);
+
+  // Set the high watermarks of the queue. A watermark of 0 is not enforced.
+  void SetWatermarks(size_t max_packets, size_t max_bytes,
+                     uint64_t max_playout_us);
+
+  bool IsDropOldest() const { return drop_oldest_; }
+  size_t MaxPackets() const { return max_packets_; }
+  size_t MaxBytes() const { return max_bytes_; }
+  uint64_t MaxPlayoutUs() const { return max_playout_us_; }
+
+  // Returns the estimated rate of the encoded audio in bytes per second, 0 if
+  // not known yet.
+  uint64_t ByteRate() const { return byte_rate_; }
+
+  // Record that the encoder has produced |bytes| on the tick at |now_us|.
+  // Updates the rate estimate.
+  void OnEncoded(uint64_t now_us, size_t bytes);
+
+  // Returns the estimated playout time of |bytes| of encoded audio, 0 if the
+  // rate is not known yet.
+  uint64_t PlayoutUs(size_t bytes) const;
+
+  // Returns whether adding a packet of |packet_bytes| to the queue at |level|
+  // exceeds one of the high watermarks.
+  bool IsOverflow(const A2dpSourceTxQueueLevel& level,
+                  size_t packet_bytes) const;
+
+  // Returns whether the oldest packet of the queue at |level| must be dropped
+  // to absorb an overflow, before adding a packet of |packet_bytes|.
+  bool ShouldDrop(const A2dpSourceTxQueueLevel& level,
+                  size_t packet_bytes) const;
+
+  // Returns the queue length reported to the encoder for its bitrate
+  // adaptation: the number of queued packets, or the queued playout time in
+  // encoder intervals when it is larger.
+  size_t EncoderQueueLength(const A2dpSourceTxQueueLevel& level) const;
+
+  // Record the drop of |packets| packets of |bytes| in total.
+  void OnDrop(size_t packets, size_t bytes);
+
+  // Record the occupancy of the queue after a packet was added.
+  void OnEnqueue(const A2dpSourceTxQueueLevel& level);
+
+  Stats stats;
+
+ private:
+  bool IsAbove(const A2dpSourceTxQueueLevel& level, size_t percent) const;
+
+  bool drop_oldest_;
+  uint64_t interval_us_;
+  size_t max_packets_;
+  size_t max_bytes_;
+  uint64_t max_playout_us_;
+  uint64_t byte_rate_;
+  uint64_t last_encoded_us_;
+  size_t pending_bytes_;  // Encoded since the last rate update
+  uint64_t pending_us_;
+};
+
+#endif  // BTIF_A2DP_SOURCE_TX_QUEUE_POLICY_H
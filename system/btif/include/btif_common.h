@@ -22,6 +22,7 @@
 
 #include <base/bind.h>
 #include <base/location.h>
+#include <base/time/time.h>
 #include <hardware/bluetooth.h>
 #include <stdlib.h>
 
@@ -155,6 +156,9 @@ typedef struct {
 extern bt_status_t do_in_jni_thread(base::OnceClosure task);
 extern bt_status_t do_in_jni_thread(const base::Location& from_here,
                                     base::OnceClosure task);
+extern bt_status_t do_in_jni_thread_delayed(const base::Location& from_here,
+                                            base::OnceClosure task,
+                                            const base::TimeDelta& delay);
 extern bool is_on_jni_thread();
 extern btbase::AbstractMessageLoop* get_jni_message_loop();
 
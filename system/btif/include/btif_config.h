@@ -66,6 +66,9 @@ size_t btif_config_get_bin_length(const std::string& section,
                                   const std::string& key);
 
 std::vector<RawAddress> btif_config_get_paired_devices();
+// Changes each time the config of the paired devices or the adapter changes,
+// so that copies of their properties can be checked before being used
+uint64_t btif_config_get_persistent_generation(void);
 
 void btif_config_save(void);
 void btif_config_flush(void);
@@ -22,6 +22,8 @@
 #include <bluetooth/uuid.h>
 #include <hardware/bluetooth.h>
 
+#include <vector>
+
 #include "bt_target.h"
 #include "stack/include/bt_device_type.h"
 #include "stack/include/bt_octets.h"
@@ -276,6 +278,26 @@ Octet16 btif_storage_get_gatt_cl_db_hash(const RawAddress& bd_addr);
 /** Remove last server database hash for remote client */
 void btif_storage_remove_gatt_cl_db_hash(const RawAddress& bd_addr);
 
+/** Store the SEPs of an A2DP peer and their capabilities, as encoded by BTA AV
+ */
+void btif_storage_set_a2dp_sep_caps(const RawAddress& bd_addr,
+                                    std::vector<uint8_t> caps);
+
+/** Get the stored SEPs of an A2DP peer and their capabilities, empty if none */
+std::vector<uint8_t> btif_storage_get_a2dp_sep_caps(const RawAddress& bd_addr);
+
+/** Remove the stored SEPs of an A2DP peer and their capabilities */
+void btif_storage_remove_a2dp_sep_caps(const RawAddress& bd_addr);
+
+/** Store the mSBC eSCO settings, as tBTA_AG_SCO_MSBC_SETTINGS, the last HFP
+ * audio connection with the peer was opened with */
+void btif_storage_set_hfp_msbc_settings(const RawAddress& bd_addr,
+                                        uint8_t settings);
+
+/** Get the stored mSBC eSCO settings of an HFP peer, false if none */
+bool btif_storage_get_hfp_msbc_settings(const RawAddress& bd_addr,
+                                        uint8_t* settings);
+
 /** Get the hearing aid device properties. */
 bool btif_storage_get_hearing_aid_prop(
     const RawAddress& address, uint8_t* capabilities, uint64_t* hi_sync_id,
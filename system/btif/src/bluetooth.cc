@@ -48,12 +48,19 @@
 #include <string.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <mutex>
+#include <utility>
+#include <vector>
+
 #include "audio_hal_interface/a2dp_encoding.h"
 #include "bt_utils.h"
 #include "bta/include/bta_csis_api.h"
+#include "bta/include/bta_gatt_api.h"
 #include "bta/include/bta_has_api.h"
 #include "bta/include/bta_hearing_aid_api.h"
 #include "bta/include/bta_hf_client_api.h"
+#include "bta/include/bta_hh_api.h"
 #include "bta/include/bta_le_audio_api.h"
 #include "bta/include/bta_le_audio_broadcaster_api.h"
 #include "bta/include/bta_vc_api.h"
@@ -74,6 +81,7 @@
 #include "common/metric_id_allocator.h"
 #include "common/metrics.h"
 #include "common/os_utils.h"
+#include "common/startup_trace.h"
 #include "device/include/interop.h"
 #include "gd/common/init_flags.h"
 #include "gd/os/parameter_provider.h"
@@ -84,8 +92,10 @@
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
+#include "osi/include/properties.h"
 #include "osi/include/wakelock.h"
 #include "stack/gatt/connection_manager.h"
+#include "stack/include/gatt_api.h"
 #include "stack/include/avdt_api.h"
 #include "stack/include/btm_api.h"
 #include "stack/include/btu.h"
@@ -111,6 +121,10 @@ const int CONFIG_COMPARE_ALL_PASS = 0b11;
 int common_criteria_config_compare_result = CONFIG_COMPARE_ALL_PASS;
 bool is_local_device_atv = false;
 
+// Record one in this many osi allocations for leak tracking, 0 disables
+static const char* kAllocationSampleIntervalProperty =
+    "persist.bluetooth.allocsampleinterval";
+
 /*******************************************************************************
  *  Externs
  ******************************************************************************/
@@ -198,6 +212,9 @@ static int init(bt_callbacks_t* callbacks, bool start_restricted,
 #ifdef BLUEDROID_DEBUG
   allocation_tracker_init();
 #endif
+  // Field leak tracking, ignored if full tracking is on
+  allocation_tracker_init_sampling(
+      osi_property_get_int32(kAllocationSampleIntervalProperty, 0));
 
   set_hal_cbacks(callbacks);
 
@@ -441,6 +458,8 @@ static void dump(int fd, const char** arguments) {
   btif_debug_a2dp_dump(fd);
   btif_debug_av_dump(fd);
   bta_debug_av_dump(fd);
+  bta_debug_hh_dump(fd);
+  bta_debug_gattc_cache_dump(fd);
   stack_debug_avdtp_api_dump(fd);
   bluetooth::avrcp::AvrcpService::DebugDump(fd);
   btif_debug_config_dump(fd);
@@ -459,7 +478,10 @@ static void dump(int fd, const char** arguments) {
   VolumeControl::DebugDump(fd);
 #endif
   connection_manager::dump(fd);
+  gatt_debug_dump(fd);
   bluetooth::bqr::DebugDump(fd);
+  bluetooth::common::StartupTrace::GetInstance().Dump(fd);
+  get_main_thread()->DumpTaskStats(fd);
   bluetooth::shim::Dump(fd, arguments);
 }
 
@@ -724,7 +746,57 @@ bt_property_t* property_deep_copy_array(int num_properties,
   return copy;
 }
 
+namespace {
+
+/* An inquiry reports the same device several times, with the same properties
+ * and a fresh RSSI. The results are merged per device over a short window and
+ * handed to the JNI thread in one task, instead of one thread hop and one
+ * round of Java allocations per report. */
+constexpr int kDeviceFoundBatchWindowMs = 100;
+
+struct DeviceFoundResult {
+  RawAddress bd_addr;
+  /* Latest value of each property type, in first seen order */
+  std::vector<std::pair<bt_property_type_t, std::vector<uint8_t>>> properties;
+};
+
+std::mutex device_found_batch_mutex;
+std::vector<DeviceFoundResult> device_found_batch;
+
+void deliver_device_found_results(std::vector<DeviceFoundResult> results) {
+  for (auto& result : results) {
+    std::vector<bt_property_t> properties;
+    properties.reserve(result.properties.size());
+    for (auto& [type, value] : result.properties) {
+      properties.push_back({.type = type,
+                            .len = static_cast<int>(value.size()),
+                            .val = value.empty() ? nullptr : value.data()});
+    }
+    HAL_CBACK(bt_hal_cbacks, device_found_cb,
+              static_cast<int>(properties.size()), properties.data());
+  }
+}
+
+std::vector<DeviceFoundResult> take_device_found_batch() {
+  std::vector<DeviceFoundResult> results;
+  std::lock_guard<std::mutex> lock(device_found_batch_mutex);
+  results.swap(device_found_batch);
+  return results;
+}
+
+/* Deliver the pending results ahead of the next callback, so that the
+ * upper layers still see them in the order they were reported. */
+void flush_device_found_batch() {
+  auto results = take_device_found_batch();
+  if (results.empty()) return;
+  do_in_jni_thread(FROM_HERE, base::BindOnce(&deliver_device_found_results,
+                                             std::move(results)));
+}
+
+}  // namespace
+
 void invoke_adapter_state_changed_cb(bt_state_t state) {
+  flush_device_found_batch();
   do_in_jni_thread(FROM_HERE, base::BindOnce(
                                   [](bt_state_t state) {
                                     HAL_CBACK(bt_hal_cbacks,
@@ -752,6 +824,7 @@ void invoke_adapter_properties_cb(bt_status_t status, int num_properties,
 void invoke_remote_device_properties_cb(bt_status_t status, RawAddress bd_addr,
                                         int num_properties,
                                         bt_property_t* properties) {
+  flush_device_found_batch();
   do_in_jni_thread(
       FROM_HERE, base::BindOnce(
                      [](bt_status_t status, RawAddress bd_addr,
@@ -767,20 +840,77 @@ void invoke_remote_device_properties_cb(bt_status_t status, RawAddress bd_addr,
 }
 
 void invoke_device_found_cb(int num_properties, bt_property_t* properties) {
-  do_in_jni_thread(FROM_HERE,
-                   base::BindOnce(
-                       [](int num_properties, bt_property_t* properties) {
-                         HAL_CBACK(bt_hal_cbacks, device_found_cb,
-                                   num_properties, properties);
-                         if (properties) {
-                           osi_free(properties);
-                         }
-                       },
-                       num_properties,
-                       property_deep_copy_array(num_properties, properties)));
+  const bt_property_t* bd_addr_property = nullptr;
+  for (int i = 0; i < num_properties; i++) {
+    if (properties[i].type == BT_PROPERTY_BDADDR &&
+        properties[i].len == sizeof(RawAddress)) {
+      bd_addr_property = &properties[i];
+      break;
+    }
+  }
+
+  if (bd_addr_property == nullptr) {
+    flush_device_found_batch();
+    do_in_jni_thread(FROM_HERE,
+                     base::BindOnce(
+                         [](int num_properties, bt_property_t* properties) {
+                           HAL_CBACK(bt_hal_cbacks, device_found_cb,
+                                     num_properties, properties);
+                           if (properties) {
+                             osi_free(properties);
+                           }
+                         },
+                         num_properties,
+                         property_deep_copy_array(num_properties, properties)));
+    return;
+  }
+
+  const RawAddress& bd_addr =
+      *reinterpret_cast<const RawAddress*>(bd_addr_property->val);
+  std::lock_guard<std::mutex> lock(device_found_batch_mutex);
+  const bool start_window = device_found_batch.empty();
+
+  auto result = std::find_if(
+      device_found_batch.begin(), device_found_batch.end(),
+      [&bd_addr](const auto& result) { return result.bd_addr == bd_addr; });
+  if (result == device_found_batch.end()) {
+    result = device_found_batch.insert(device_found_batch.end(),
+                                       DeviceFoundResult{.bd_addr = bd_addr});
+  }
+  for (int i = 0; i < num_properties; i++) {
+    const uint8_t* val = static_cast<const uint8_t*>(properties[i].val);
+    std::vector<uint8_t> value;
+    if (properties[i].len > 0) {
+      value.assign(val, val + properties[i].len);
+    }
+    auto property = std::find_if(
+        result->properties.begin(), result->properties.end(),
+        [&](const auto& p) { return p.first == properties[i].type; });
+    if (property != result->properties.end()) {
+      property->second = std::move(value);
+    } else {
+      result->properties.emplace_back(properties[i].type, std::move(value));
+    }
+  }
+
+  /* The first result of a window schedules its delivery, results flushed
+   * early by another callback leave the task with nothing to deliver. */
+  if (start_window) {
+    do_in_jni_thread_delayed(
+        FROM_HERE,
+        base::BindOnce(
+            [] { deliver_device_found_results(take_device_found_batch()); }),
+#if BASE_VER < 931007
+        base::TimeDelta::FromMilliseconds(kDeviceFoundBatchWindowMs)
+#else
+        base::Milliseconds(kDeviceFoundBatchWindowMs)
+#endif
+    );
+  }
 }
 
 void invoke_discovery_state_changed_cb(bt_discovery_state_t state) {
+  flush_device_found_batch();
   do_in_jni_thread(FROM_HERE, base::BindOnce(
                                   [](bt_discovery_state_t state) {
                                     HAL_CBACK(bt_hal_cbacks,
@@ -33,11 +33,18 @@
 #include "btif_av_co.h"
 #include "btif_hf.h"
 #include "osi/include/osi.h"
+#include "osi/include/properties.h"
 #include "types/raw_address.h"
 #include "uipc.h"
 
 #define A2DP_DATA_READ_POLL_MS 10
 
+/**
+ * When true the audio data is exchanged with the audio HAL through a shared
+ * memory ring instead of the data socket.
+ */
+#define A2DP_DATA_SHM_RING_PROPERTY "persist.bluetooth.a2dp.uipc_shm_ring"
+
 struct {
   uint64_t total_bytes_read = 0;
   uint16_t audio_delay = 0;
@@ -63,6 +70,15 @@ void btif_a2dp_control_cleanup(void) {
   }
 }
 
+static void btif_a2dp_data_path_open() {
+  UIPC_Open(*a2dp_uipc, UIPC_CH_ID_AV_AUDIO, btif_a2dp_data_cb,
+            A2DP_DATA_PATH);
+  if (osi_property_get_bool(A2DP_DATA_SHM_RING_PROPERTY, false)) {
+    UIPC_OpenShmRing(*a2dp_uipc, UIPC_CH_ID_AV_AUDIO, A2DP_DATA_SHM_RING_PATH,
+                     AUDIO_STREAM_OUTPUT_BUFFER_SZ);
+  }
+}
+
 static tA2DP_CTRL_ACK btif_a2dp_control_on_check_ready() {
   if (btif_a2dp_source_media_task_is_shutting_down()) {
     APPL_TRACE_WARNING(
@@ -101,8 +117,7 @@ static tA2DP_CTRL_ACK btif_a2dp_control_on_start() {
 
   if (btif_av_stream_ready()) {
     /* Setup audio data channel listener */
-    UIPC_Open(*a2dp_uipc, UIPC_CH_ID_AV_AUDIO, btif_a2dp_data_cb,
-              A2DP_DATA_PATH);
+    btif_a2dp_data_path_open();
 
     /*
      * Post start event and wait for audio path to open.
@@ -118,8 +133,7 @@ static tA2DP_CTRL_ACK btif_a2dp_control_on_start() {
      * Already started, setup audio data channel listener and ACK
      * back immediately.
      */
-    UIPC_Open(*a2dp_uipc, UIPC_CH_ID_AV_AUDIO, btif_a2dp_data_cb,
-              A2DP_DATA_PATH);
+    btif_a2dp_data_path_open();
     return A2DP_CTRL_ACK_SUCCESS;
   }
   APPL_TRACE_WARNING("%s: A2DP command start while AV stream is not ready",
@@ -382,6 +396,9 @@ static void btif_a2dp_data_cb(UNUSED_ATTR tUIPC_CH_ID ch_id,
                  UIPC_REG_REMOVE_ACTIVE_READSET, NULL);
       UIPC_Ioctl(*a2dp_uipc, UIPC_CH_ID_AV_AUDIO, UIPC_SET_READ_POLL_TMO,
                  reinterpret_cast<void*>(A2DP_DATA_READ_POLL_MS));
+      /* The encoder reads one frame at a time: drain the socket once */
+      UIPC_Ioctl(*a2dp_uipc, UIPC_CH_ID_AV_AUDIO, UIPC_SET_RX_BATCH_SIZE,
+                 reinterpret_cast<void*>(AUDIO_STREAM_OUTPUT_BUFFER_SZ));
 
       if (btif_av_get_peer_sep() == AVDT_TSEP_SNK) {
         /* Start the media task to encode the audio */
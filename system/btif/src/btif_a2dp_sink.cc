@@ -27,18 +27,22 @@
 #include <atomic>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "bt_target.h"  // Must be first to define build configuration
+#include "btif/include/btif_a2dp_sink_jitter_buffer.h"
 #include "btif/include/btif_av.h"
 #include "btif/include/btif_av_co.h"
 #include "btif/include/btif_avrcp_audio_track.h"
 #include "btif/include/btif_util.h"  // CASE_RETURN_STR
 #include "common/message_loop_thread.h"
+#include "common/time_util.h"
 #include "osi/include/alarm.h"
 #include "osi/include/allocator.h"
 #include "osi/include/fixed_queue.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"  // UNUSED_ATTR
+#include "osi/include/properties.h"
 #include "stack/include/bt_hdr.h"
 #include "stack/include/bt_types.h"
 #include "types/raw_address.h"
@@ -51,10 +55,18 @@ using LockGuard = std::lock_guard<std::mutex>;
  */
 #define MAX_INPUT_A2DP_FRAME_QUEUE_SZ (MAX_PCM_FRAME_NUM_PER_TICK * 2)
 
+/* The period of the playout of the jitter buffer */
 #define BTIF_SINK_MEDIA_TIME_TICK_MS 20
 
-/* In case of A2DP Sink, we will delay start by 5 AVDTP Packets */
-#define MAX_A2DP_DELAYED_START_FRAME_COUNT 5
+/**
+ * The bounds of the adaptive playout delay of the jitter buffer.
+ */
+#define A2DP_SINK_JITTER_BUFFER_MIN_MS_PROPERTY \
+  "persist.bluetooth.a2dp_sink.jitter_buffer_min_ms"
+#define A2DP_SINK_JITTER_BUFFER_MAX_MS_PROPERTY \
+  "persist.bluetooth.a2dp_sink.jitter_buffer_max_ms"
+#define A2DP_SINK_JITTER_BUFFER_MIN_MS 40
+#define A2DP_SINK_JITTER_BUFFER_MAX_MS 200
 
 enum {
   BTIF_A2DP_SINK_STATE_OFF,
@@ -83,6 +95,12 @@ typedef struct {
   btif_a2dp_sink_focus_state_t focus_state;
 } tBTIF_MEDIA_SINK_FOCUS_UPDATE;
 
+/* Receive info, in the offset area of the packets of the rx queue */
+typedef struct {
+  uint32_t timestamp; /* RTP timestamp */
+  uint64_t arrival_us;
+} tBTIF_MEDIA_SINK_RX_INFO;
+
 /* BTIF A2DP Sink control block */
 class BtifA2dpSinkControlBlock {
  public:
@@ -90,7 +108,8 @@ class BtifA2dpSinkControlBlock {
       : worker_thread(thread_name),
         rx_audio_queue(nullptr),
         rx_flush(false),
-        decode_alarm(nullptr),
+        decode_pending(false),
+        playout_alarm(nullptr),
         sample_rate(0),
         channel_count(0),
 #if 0
@@ -110,9 +129,11 @@ class BtifA2dpSinkControlBlock {
     audio_track = nullptr;
     fixed_queue_free(rx_audio_queue, nullptr);
     rx_audio_queue = nullptr;
-    alarm_free(decode_alarm);
-    decode_alarm = nullptr;
+    alarm_free(playout_alarm);
+    playout_alarm = nullptr;
     rx_flush = false;
+    decode_pending = false;
+    jitter_buffer.Flush();
 #if 0
     rx_focus_state = BTIF_A2DP_SINK_FOCUS_NOT_GRANTED;
 #else
@@ -127,7 +148,10 @@ class BtifA2dpSinkControlBlock {
   MessageLoopThread worker_thread;
   fixed_queue_t* rx_audio_queue;
   bool rx_flush; /* discards any incoming data when true */
-  alarm_t* decode_alarm;
+  bool decode_pending; /* the rx queue is to be decoded */
+  alarm_t* playout_alarm;
+  A2dpSinkJitterBuffer jitter_buffer;
+  std::vector<uint8_t> playout_data;
   tA2DP_SAMPLE_RATE sample_rate;
   tA2DP_BITS_PER_SAMPLE bits_per_sample;
   tA2DP_CHANNEL_COUNT channel_count;
@@ -152,9 +176,10 @@ static void btif_a2dp_sink_shutdown_delayed();
 static void btif_a2dp_sink_cleanup_delayed();
 static void btif_a2dp_sink_command_ready(BT_HDR_RIGID* p_msg);
 static void btif_a2dp_sink_audio_handle_stop_decoding();
-static void btif_decode_alarm_cb(void* context);
+static void btif_playout_alarm_cb(void* context);
 static void btif_a2dp_sink_audio_handle_start_decoding();
 static void btif_a2dp_sink_avk_handle_timer();
+static void btif_a2dp_sink_decode_ready();
 static void btif_a2dp_sink_audio_rx_flush_req();
 /* Handle incoming media packets A2DP SINK streaming */
 static void btif_a2dp_sink_handle_inc_media(BT_HDR* p_msg);
@@ -313,7 +338,7 @@ static void btif_a2dp_sink_shutdown_delayed() {
 void btif_a2dp_sink_cleanup() {
   LOG_INFO("%s", __func__);
 
-  alarm_t* decode_alarm;
+  alarm_t* playout_alarm;
 
   // Make sure the sink is shutdown
   btif_a2dp_sink_shutdown();
@@ -327,12 +352,12 @@ void btif_a2dp_sink_cleanup() {
     // Make sure no channels are restarted while shutting down
     btif_a2dp_sink_state = BTIF_A2DP_SINK_STATE_SHUTTING_DOWN;
 
-    decode_alarm = btif_a2dp_sink_cb.decode_alarm;
-    btif_a2dp_sink_cb.decode_alarm = nullptr;
+    playout_alarm = btif_a2dp_sink_cb.playout_alarm;
+    btif_a2dp_sink_cb.playout_alarm = nullptr;
   }
 
   // Stop the timer
-  alarm_free(decode_alarm);
+  alarm_free(playout_alarm);
 
   // Exit the thread
   btif_a2dp_sink_cb.worker_thread.DoInThread(
@@ -474,14 +499,14 @@ static void btif_a2dp_sink_audio_handle_stop_decoding() {
     LockGuard lock(g_mutex);
     btif_a2dp_sink_cb.rx_flush = true;
     btif_a2dp_sink_audio_rx_flush_req();
-    old_alarm = btif_a2dp_sink_cb.decode_alarm;
-    btif_a2dp_sink_cb.decode_alarm = nullptr;
+    old_alarm = btif_a2dp_sink_cb.playout_alarm;
+    btif_a2dp_sink_cb.playout_alarm = nullptr;
   }
 
-  // Drop the lock here, btif_decode_alarm_cb may in the process of being called
-  // while we alarm free leading to deadlock.
+  // Drop the lock here, btif_playout_alarm_cb may in the process of being
+  // called while we alarm free leading to deadlock.
   //
-  // alarm_free waits for btif_decode_alarm_cb which is waiting for g_mutex.
+  // alarm_free waits for btif_playout_alarm_cb which is waiting for g_mutex.
   alarm_free(old_alarm);
 
   {
@@ -492,7 +517,7 @@ static void btif_a2dp_sink_audio_handle_stop_decoding() {
   }
 }
 
-static void btif_decode_alarm_cb(UNUSED_ATTR void* context) {
+static void btif_playout_alarm_cb(UNUSED_ATTR void* context) {
   LockGuard lock(g_mutex);
   btif_a2dp_sink_cb.worker_thread.DoInThread(
       FROM_HERE, base::BindOnce(btif_a2dp_sink_avk_handle_timer));
@@ -512,27 +537,26 @@ static void btif_a2dp_sink_clear_track_event() {
 // Must be called while locked.
 static void btif_a2dp_sink_audio_handle_start_decoding() {
   LOG_INFO("%s", __func__);
-  if (btif_a2dp_sink_cb.decode_alarm != nullptr)
+  if (btif_a2dp_sink_cb.playout_alarm != nullptr)
     return;  // Already started decoding
 
 #ifndef OS_GENERIC
   BtifAvrcpAudioTrackStart(btif_a2dp_sink_cb.audio_track);
 #endif
 
-  btif_a2dp_sink_cb.decode_alarm = alarm_new_periodic("btif.a2dp_sink_decode");
-  if (btif_a2dp_sink_cb.decode_alarm == nullptr) {
-    LOG_ERROR("%s: unable to allocate decode alarm", __func__);
+  btif_a2dp_sink_cb.playout_alarm =
+      alarm_new_periodic("btif.a2dp_sink_playout");
+  if (btif_a2dp_sink_cb.playout_alarm == nullptr) {
+    LOG_ERROR("%s: unable to allocate playout alarm", __func__);
     return;
   }
-  alarm_set(btif_a2dp_sink_cb.decode_alarm, BTIF_SINK_MEDIA_TIME_TICK_MS,
-            btif_decode_alarm_cb, nullptr);
+  alarm_set(btif_a2dp_sink_cb.playout_alarm, BTIF_SINK_MEDIA_TIME_TICK_MS,
+            btif_playout_alarm_cb, nullptr);
 }
 
+// Must be called while locked.
 static void btif_a2dp_sink_on_decode_complete(uint8_t* data, uint32_t len) {
-#ifndef OS_GENERIC
-  BtifAvrcpAudioTrackWriteData(btif_a2dp_sink_cb.audio_track,
-                               reinterpret_cast<void*>(data), len);
-#endif
+  btif_a2dp_sink_cb.jitter_buffer.Push(data, len);
 }
 
 // Must be called while locked.
@@ -544,14 +568,42 @@ static void btif_a2dp_sink_handle_inc_media(BT_HDR* p_msg) {
   }
 
   CHECK(btif_a2dp_sink_cb.decoder_interface != nullptr);
+  const tBTIF_MEDIA_SINK_RX_INFO* p_info =
+      reinterpret_cast<const tBTIF_MEDIA_SINK_RX_INFO*>(p_msg->data);
+  btif_a2dp_sink_cb.jitter_buffer.OnPacket(p_info->timestamp,
+                                           p_info->arrival_us);
   if (!btif_a2dp_sink_cb.decoder_interface->decode_packet(p_msg)) {
     LOG_ERROR("%s: decoding failed", __func__);
   }
 }
 
+// Plays the audio of the jitter buffer due on this tick
 static void btif_a2dp_sink_avk_handle_timer() {
   LockGuard lock(g_mutex);
 
+  if (btif_a2dp_sink_cb.rx_focus_state == BTIF_A2DP_SINK_FOCUS_NOT_GRANTED ||
+      btif_a2dp_sink_cb.rx_flush) {
+    return;
+  }
+
+  std::vector<uint8_t>& data = btif_a2dp_sink_cb.playout_data;
+  data.clear();
+  btif_a2dp_sink_cb.jitter_buffer.Pull(
+      bluetooth::common::time_get_os_boottime_us(), &data);
+  if (data.empty()) return;
+
+#ifndef OS_GENERIC
+  BtifAvrcpAudioTrackWriteData(btif_a2dp_sink_cb.audio_track,
+                               reinterpret_cast<void*>(data.data()),
+                               data.size());
+#endif
+}
+
+// Decodes the received packets to the jitter buffer
+static void btif_a2dp_sink_decode_ready() {
+  LockGuard lock(g_mutex);
+  btif_a2dp_sink_cb.decode_pending = false;
+
   BT_HDR* p_msg;
   if (fixed_queue_is_empty(btif_a2dp_sink_cb.rx_audio_queue)) {
     APPL_TRACE_DEBUG("%s: empty queue", __func__);
@@ -584,6 +636,10 @@ static void btif_a2dp_sink_avk_handle_timer() {
     osi_free(p_msg);
   }
   APPL_TRACE_DEBUG("%s: process frames end", __func__);
+
+  if (btif_a2dp_sink_cb.jitter_buffer.DepthFrames() > 0) {
+    btif_a2dp_sink_audio_handle_start_decoding();
+  }
 }
 
 /* when true media task discards any rx frames */
@@ -599,6 +655,7 @@ static void btif_a2dp_sink_audio_rx_flush_event() {
   LockGuard lock(g_mutex);
   // Flush all received encoded audio buffers
   fixed_queue_flush(btif_a2dp_sink_cb.rx_audio_queue, osi_free);
+  btif_a2dp_sink_cb.jitter_buffer.Flush();
 }
 
 static void btif_a2dp_sink_decoder_update_event(
@@ -634,6 +691,20 @@ static void btif_a2dp_sink_decoder_update_event(
   btif_a2dp_sink_cb.bits_per_sample = bits_per_sample;
   btif_a2dp_sink_cb.channel_count = channel_count;
 
+  int32_t min_delay_ms = osi_property_get_int32(
+      A2DP_SINK_JITTER_BUFFER_MIN_MS_PROPERTY, A2DP_SINK_JITTER_BUFFER_MIN_MS);
+  int32_t max_delay_ms = osi_property_get_int32(
+      A2DP_SINK_JITTER_BUFFER_MAX_MS_PROPERTY, A2DP_SINK_JITTER_BUFFER_MAX_MS);
+  if (min_delay_ms < 0 || max_delay_ms < min_delay_ms) {
+    LOG_WARN("%s: invalid jitter buffer delay %d-%d ms", __func__,
+             min_delay_ms, max_delay_ms);
+    min_delay_ms = A2DP_SINK_JITTER_BUFFER_MIN_MS;
+    max_delay_ms = A2DP_SINK_JITTER_BUFFER_MAX_MS;
+  }
+  btif_a2dp_sink_cb.jitter_buffer.Start(
+      sample_rate, channel_count * (bits_per_sample / 8),
+      min_delay_ms * 1000ULL, max_delay_ms * 1000ULL);
+
   btif_a2dp_sink_cb.rx_flush = false;
   APPL_TRACE_DEBUG("%s: reset to Sink role", __func__);
 
@@ -679,17 +750,25 @@ uint8_t btif_a2dp_sink_enqueue_buf(BT_HDR* p_pkt) {
   }
 
   BTIF_TRACE_VERBOSE("%s +", __func__);
-  /* Allocate and queue this buffer */
-  BT_HDR* p_msg =
-      reinterpret_cast<BT_HDR*>(osi_malloc(sizeof(*p_msg) + p_pkt->len));
+  /* Allocate and queue this buffer, with its receive info */
+  BT_HDR* p_msg = reinterpret_cast<BT_HDR*>(osi_malloc(
+      sizeof(*p_msg) + sizeof(tBTIF_MEDIA_SINK_RX_INFO) + p_pkt->len));
   memcpy(p_msg, p_pkt, sizeof(*p_msg));
-  p_msg->offset = 0;
-  memcpy(p_msg->data, p_pkt->data + p_pkt->offset, p_pkt->len);
+  tBTIF_MEDIA_SINK_RX_INFO* p_info =
+      reinterpret_cast<tBTIF_MEDIA_SINK_RX_INFO*>(p_msg->data);
+  /* The timestamp is in the offset area of the received packet */
+  p_info->timestamp = *reinterpret_cast<uint32_t*>(p_pkt + 1);
+  p_info->arrival_us = bluetooth::common::time_get_os_boottime_us();
+  p_msg->offset = sizeof(tBTIF_MEDIA_SINK_RX_INFO);
+  memcpy(p_msg->data + p_msg->offset, p_pkt->data + p_pkt->offset,
+         p_pkt->len);
   fixed_queue_enqueue(btif_a2dp_sink_cb.rx_audio_queue, p_msg);
-  if (fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue) ==
-      MAX_A2DP_DELAYED_START_FRAME_COUNT) {
-    BTIF_TRACE_DEBUG("%s: Initiate decoding", __func__);
-    btif_a2dp_sink_audio_handle_start_decoding();
+
+  /* Decode on the worker thread as soon as the packet is received */
+  if (!btif_a2dp_sink_cb.decode_pending) {
+    btif_a2dp_sink_cb.decode_pending = true;
+    btif_a2dp_sink_cb.worker_thread.DoInThread(
+        FROM_HERE, base::BindOnce(btif_a2dp_sink_decode_ready));
   }
 
   return fixed_queue_length(btif_a2dp_sink_cb.rx_audio_queue);
@@ -697,8 +776,9 @@ uint8_t btif_a2dp_sink_enqueue_buf(BT_HDR* p_pkt) {
 
 void btif_a2dp_sink_audio_rx_flush_req() {
   LOG_INFO("%s", __func__);
-  if (fixed_queue_is_empty(btif_a2dp_sink_cb.rx_audio_queue)) {
-    /* Queue is already empty */
+  if (fixed_queue_is_empty(btif_a2dp_sink_cb.rx_audio_queue) &&
+      btif_a2dp_sink_cb.jitter_buffer.DepthFrames() == 0) {
+    /* Queue and jitter buffer are already empty */
     return;
   }
 
@@ -709,8 +789,44 @@ void btif_a2dp_sink_audio_rx_flush_req() {
       FROM_HERE, base::BindOnce(btif_a2dp_sink_command_ready, p_buf));
 }
 
-void btif_a2dp_sink_debug_dump(UNUSED_ATTR int fd) {
-  // Nothing to do
+void btif_a2dp_sink_debug_dump(int fd) {
+  LockGuard lock(g_mutex);
+  const A2dpSinkJitterBuffer& jitter_buffer = btif_a2dp_sink_cb.jitter_buffer;
+  const A2dpSinkJitterBuffer::Stats& stats = jitter_buffer.stats;
+
+  dprintf(fd, "\nA2DP Sink State: %s\n",
+          jitter_buffer.IsPlaying() ? "Playing" : "Buffering");
+  dprintf(fd,
+          "  Jitter buffer depth / target (ms)                        : "
+          "%llu / %llu\n",
+          (unsigned long long)jitter_buffer.DepthUs() / 1000,
+          (unsigned long long)jitter_buffer.TargetUs() / 1000);
+  dprintf(fd,
+          "  Arrival jitter (ms)                                      : "
+          "%llu\n",
+          (unsigned long long)jitter_buffer.JitterUs() / 1000);
+  dprintf(fd,
+          "  Max. jitter buffer depth (ms)                            : "
+          "%llu\n",
+          (unsigned long long)stats.max_depth_us / 1000);
+  dprintf(fd,
+          "  Packets received / late                                  : "
+          "%zu / %zu\n",
+          stats.packets, stats.late_packets);
+  dprintf(fd,
+          "  Underruns / timestamp resyncs                            : "
+          "%zu / %zu\n",
+          stats.underruns, stats.resyncs);
+  dprintf(fd,
+          "  Frames concealed / dropped                               : "
+          "%llu / %llu\n",
+          (unsigned long long)stats.concealed_frames,
+          (unsigned long long)stats.dropped_frames);
+  dprintf(fd,
+          "  Drift compensation frames skipped / repeated             : "
+          "%llu / %llu\n",
+          (unsigned long long)stats.skipped_frames,
+          (unsigned long long)stats.repeated_frames);
 }
 
 void btif_a2dp_sink_set_focus_state_req(btif_a2dp_sink_focus_state_t state) {
@@ -734,6 +850,7 @@ static void btif_a2dp_sink_set_focus_state_event(
   btif_a2dp_sink_cb.rx_focus_state = state;
   if (btif_a2dp_sink_cb.rx_focus_state == BTIF_A2DP_SINK_FOCUS_NOT_GRANTED) {
     fixed_queue_flush(btif_a2dp_sink_cb.rx_audio_queue, osi_free);
+    btif_a2dp_sink_cb.jitter_buffer.Flush();
     btif_a2dp_sink_cb.rx_flush = true;
   } else if (btif_a2dp_sink_cb.rx_focus_state == BTIF_A2DP_SINK_FOCUS_GRANTED) {
     btif_a2dp_sink_cb.rx_flush = false;
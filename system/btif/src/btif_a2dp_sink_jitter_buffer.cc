@@ -0,0 +1,268 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "btif_a2dp_sink_jitter_buffer.h"
+
+#include <base/logging.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+// Weight of a new sample in the smoothed depth is 1/2^kDepthShift
+static constexpr int kDepthShift = 5;
+
+A2dpSinkJitterBuffer::A2dpSinkJitterBuffer()
+    : stats(),
+      sample_rate_(0),
+      frame_size_(0),
+      min_delay_us_(0),
+      max_delay_us_(0),
+      head_(0),
+      synced_(false),
+      read_ts_(0),
+      write_ts_(0),
+      packet_late_(false),
+      has_transit_(false),
+      last_ts_(0),
+      last_arrival_us_(0),
+      jitter_us_x16_(0),
+      packet_us_(0),
+      playing_(false),
+      clock_start_us_(0),
+      clock_frames_(0),
+      avg_depth_x32_(0),
+      underrun_frames_(0) {}
+
+void A2dpSinkJitterBuffer::Start(uint32_t sample_rate, size_t frame_size,
+                                 uint64_t min_delay_us,
+                                 uint64_t max_delay_us) {
+  CHECK(sample_rate > 0);
+  CHECK(frame_size > 0);
+  CHECK(min_delay_us <= max_delay_us);
+  sample_rate_ = sample_rate;
+  frame_size_ = frame_size;
+  min_delay_us_ = min_delay_us;
+  max_delay_us_ = max_delay_us;
+  jitter_us_x16_ = 0;
+  packet_us_ = 0;
+  stats = {};
+  Flush();
+}
+
+void A2dpSinkJitterBuffer::Flush() {
+  buffer_.clear();
+  head_ = 0;
+  synced_ = false;
+  playing_ = false;
+  has_transit_ = false;
+}
+
+uint64_t A2dpSinkJitterBuffer::FramesToUs(uint64_t frames) const {
+  if (sample_rate_ == 0) return 0;
+  return frames * 1000000 / sample_rate_;
+}
+
+uint64_t A2dpSinkJitterBuffer::UsToFrames(uint64_t us) const {
+  return us * sample_rate_ / 1000000;
+}
+
+size_t A2dpSinkJitterBuffer::DepthFrames() const {
+  if (frame_size_ == 0) return 0;
+  return (buffer_.size() - head_) / frame_size_;
+}
+
+uint64_t A2dpSinkJitterBuffer::TargetUs() const {
+  uint64_t target_us = packet_us_ + kJitterMultiplier * JitterUs();
+  return std::min(std::max(target_us, min_delay_us_), max_delay_us_);
+}
+
+void A2dpSinkJitterBuffer::Resync(uint32_t timestamp) {
+  Drop(DepthFrames());
+  synced_ = true;
+  playing_ = false;
+  read_ts_ = timestamp;
+  write_ts_ = timestamp;
+}
+
+void A2dpSinkJitterBuffer::Drop(size_t frames) {
+  head_ += frames * frame_size_;
+  read_ts_ += frames;
+  if (head_ >= buffer_.size()) {
+    buffer_.clear();
+    head_ = 0;
+  }
+}
+
+void A2dpSinkJitterBuffer::Append(const uint8_t* data, size_t frames) {
+  // Reclaim the played audio before it dominates the buffer
+  if (head_ > 0 && head_ >= buffer_.size() / 2) {
+    buffer_.erase(buffer_.begin(), buffer_.begin() + head_);
+    head_ = 0;
+  }
+  size_t len = frames * frame_size_;
+  if (data == nullptr) {
+    buffer_.insert(buffer_.end(), len, 0);
+  } else {
+    buffer_.insert(buffer_.end(), data, data + len);
+  }
+}
+
+void A2dpSinkJitterBuffer::OnPacket(uint32_t timestamp, uint64_t arrival_us) {
+  stats.packets++;
+  packet_late_ = false;
+  int64_t max_frames = UsToFrames(max_delay_us_);
+
+  if (has_transit_) {
+    int32_t delta_ts = static_cast<int32_t>(timestamp - last_ts_);
+    if (std::abs(static_cast<int64_t>(delta_ts)) <= 2 * max_frames) {
+      if (delta_ts > 0) packet_us_ = FramesToUs(delta_ts);
+      int64_t delta_us = static_cast<int64_t>(arrival_us - last_arrival_us_) -
+                         static_cast<int64_t>(delta_ts) * 1000000 /
+                             static_cast<int64_t>(sample_rate_);
+      uint64_t d = std::min<uint64_t>(std::abs(delta_us), max_delay_us_);
+      jitter_us_x16_ += d - ((jitter_us_x16_ + 8) >> 4);
+    }
+  }
+  has_transit_ = true;
+  last_ts_ = timestamp;
+  last_arrival_us_ = arrival_us;
+
+  if (!synced_) {
+    Resync(timestamp);
+    return;
+  }
+  int32_t gap = static_cast<int32_t>(timestamp - write_ts_);
+  if (std::abs(static_cast<int64_t>(gap)) > max_frames) {
+    stats.resyncs++;
+    Resync(timestamp);
+    return;
+  }
+  write_ts_ = timestamp;
+}
+
+void A2dpSinkJitterBuffer::Push(const uint8_t* data, size_t len) {
+  size_t frames = (frame_size_ == 0) ? 0 : len / frame_size_;
+  if (!synced_ || frames == 0) return;
+
+  uint32_t end_ts = read_ts_ + DepthFrames();
+  int32_t gap = static_cast<int32_t>(write_ts_ - end_ts);
+  write_ts_ += frames;
+
+  if (gap > 0) {
+    // Lost audio
+    stats.concealed_frames += gap;
+    Append(nullptr, gap);
+  } else if (gap < 0) {
+    // Audio past its playout time
+    size_t late = std::min<size_t>(-static_cast<int64_t>(gap), frames);
+    if (!packet_late_) {
+      packet_late_ = true;
+      stats.late_packets++;
+    }
+    stats.dropped_frames += late;
+    data += late * frame_size_;
+    frames -= late;
+  }
+  Append(data, frames);
+
+  // The link recovered from a stall faster than the audio is played
+  size_t depth = DepthFrames();
+  if (depth > UsToFrames(max_delay_us_)) {
+    size_t excess = depth - UsToFrames(TargetUs());
+    stats.dropped_frames += excess;
+    Drop(excess);
+  }
+  stats.max_depth_us = std::max(stats.max_depth_us, DepthUs());
+}
+
+size_t A2dpSinkJitterBuffer::Pull(uint64_t now_us, std::vector<uint8_t>* out) {
+  if (!synced_) return 0;
+
+  size_t depth = DepthFrames();
+  if (!playing_) {
+    if (depth == 0 || DepthUs() < TargetUs()) return 0;
+    playing_ = true;
+    clock_start_us_ = now_us;
+    clock_frames_ = 0;
+    avg_depth_x32_ = static_cast<uint64_t>(depth) << kDepthShift;
+    underrun_frames_ = 0;
+    return 0;
+  }
+
+  uint64_t clock_frames = UsToFrames(now_us - clock_start_us_);
+  size_t due = clock_frames - clock_frames_;
+  clock_frames_ = clock_frames;
+  if (due == 0) return 0;
+
+  avg_depth_x32_ += depth;
+  avg_depth_x32_ -= avg_depth_x32_ >> kDepthShift;
+
+  const uint8_t* src = buffer_.data() + head_;
+  if (depth < due) {
+    // Underrun: play what is left and keep the clock running, the audio
+    // received late is dropped.
+    if (underrun_frames_ == 0) stats.underruns++;
+    size_t missing = due - depth;
+    out->insert(out->end(), src, src + depth * frame_size_);
+    out->insert(out->end(), missing * frame_size_, 0);
+    stats.concealed_frames += missing;
+    underrun_frames_ += missing;
+    Drop(depth);
+    read_ts_ += missing;
+
+    // The stream stopped: restart the playout with the next packet
+    if (FramesToUs(underrun_frames_) >= max_delay_us_) {
+      synced_ = false;
+      playing_ = false;
+      has_transit_ = false;
+    }
+    return due;
+  }
+  underrun_frames_ = 0;
+
+  // Drift compensation
+  size_t consumed = due;
+  uint64_t avg_depth = avg_depth_x32_ >> kDepthShift;
+  uint64_t target = UsToFrames(TargetUs());
+  uint64_t hysteresis = target / 8;
+  size_t max_adjust = (due * kMaxDriftPerMille + 999) / 1000;
+  if (avg_depth > target + hysteresis) {
+    size_t adjust = std::min(max_adjust, depth - due);
+    consumed += adjust;
+    stats.skipped_frames += adjust;
+  } else if (avg_depth + hysteresis < target) {
+    size_t adjust = std::min(max_adjust, due - 1);
+    consumed -= adjust;
+    stats.repeated_frames += adjust;
+  }
+
+  if (consumed == due) {
+    out->insert(out->end(), src, src + due * frame_size_);
+    Drop(due);
+    return due;
+  }
+
+  // Spread the skipped or repeated frames over the played audio
+  out->reserve(out->size() + due * frame_size_);
+  for (size_t i = 0; i < due; i++) {
+    const uint8_t* frame = src + (i * consumed / due) * frame_size_;
+    out->insert(out->end(), frame, frame + frame_size_);
+  }
+  Drop(consumed);
+  return due;
+}
@@ -30,6 +30,7 @@
 #include <string.h>
 
 #include <algorithm>
+#include <atomic>
 
 #include "audio_a2dp_hw/include/audio_a2dp_hw.h"
 #include "audio_hal_interface/a2dp_encoding.h"
@@ -37,6 +38,9 @@
 #include "btif_a2dp.h"
 #include "btif_a2dp_control.h"
 #include "btif_a2dp_source.h"
+#include "btif_a2dp_source_encode_pipeline.h"
+#include "btif_a2dp_source_scheduler.h"
+#include "btif_a2dp_source_tx_queue_policy.h"
 #include "btif_av.h"
 #include "btif_av_co.h"
 #include "btif_metrics_logging.h"
@@ -45,10 +49,12 @@
 #include "common/metrics.h"
 #include "common/repeating_timer.h"
 #include "common/time_util.h"
+#include "gd/os/trace.h"
 #include "osi/include/allocator.h"
 #include "osi/include/fixed_queue.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
+#include "osi/include/properties.h"
 #include "osi/include/wakelock.h"
 #include "stack/include/acl_api.h"
 #include "stack/include/acl_api_types.h"
@@ -69,6 +75,36 @@ extern std::unique_ptr<tUIPC_STATE> a2dp_uipc;
  */
 #define MAX_OUTPUT_A2DP_FRAME_QUEUE_SZ (MAX_PCM_FRAME_NUM_PER_TICK * 2)
 
+/**
+ * Number of real-time threads running the encoder, one per streaming peer
+ * at most.
+ */
+#define A2DP_SOURCE_ENCODE_WORKERS_PROPERTY \
+  "persist.bluetooth.a2dp_source.encode_workers"
+#define MAX_A2DP_SOURCE_ENCODE_WORKERS 4
+
+/**
+ * When true the encoder is run just in time, depending on the state of the
+ * link and the delay reported by the sink, instead of on a fixed tick.
+ */
+#define A2DP_SOURCE_DEADLINE_SCHEDULING_PROPERTY \
+  "persist.bluetooth.a2dp_source.deadline_scheduling"
+
+/**
+ * When the tx queue overflows only the oldest packets are dropped, unless
+ * this property is false: the whole queue is flushed then.
+ */
+#define A2DP_SOURCE_TX_QUEUE_DROP_OLDEST_PROPERTY \
+  "persist.bluetooth.a2dp_source.tx_queue_drop_oldest"
+
+/**
+ * Max. playout time of the audio held in the tx queue (in ms), 0 for no
+ * limit. Older audio would be played too late by the sink anyway.
+ */
+#define A2DP_SOURCE_TX_QUEUE_MAX_MS_PROPERTY \
+  "persist.bluetooth.a2dp_source.tx_queue_max_ms"
+#define A2DP_SOURCE_TX_QUEUE_DEFAULT_MAX_MS 300
+
 class SchedulingStats {
  public:
   SchedulingStats() { Reset(); }
@@ -139,6 +175,10 @@ class BtifMediaStats {
     media_read_total_underflow_bytes = 0;
     media_read_total_underflow_count = 0;
     media_read_last_underflow_us = 0;
+    encode_stats.Reset();
+    deadline_deferred_congested_count = 0;
+    deadline_deferred_queued_count = 0;
+    deadline_forced_encode_count = 0;
     codec_index = -1;
   }
 
@@ -169,6 +209,12 @@ class BtifMediaStats {
   size_t media_read_total_underflow_count;
   uint64_t media_read_last_underflow_us;
 
+  A2dpEncodeStats encode_stats;
+
+  size_t deadline_deferred_congested_count;
+  size_t deadline_deferred_queued_count;
+  size_t deadline_forced_encode_count;
+
   int codec_index = -1;
 };
 
@@ -183,6 +229,8 @@ class BtifA2dpSource {
 
   BtifA2dpSource()
       : tx_audio_queue(nullptr),
+        tx_audio_queue_bytes(0),
+        tx_encoded_bytes(0),
         tx_flush(false),
         encoder_interface(nullptr),
         encoder_interval_ms(0),
@@ -191,9 +239,13 @@ class BtifA2dpSource {
   void Reset() {
     fixed_queue_free(tx_audio_queue, nullptr);
     tx_audio_queue = nullptr;
+    tx_audio_queue_bytes = 0;
+    tx_encoded_bytes = 0;
     tx_flush = false;
     media_alarm.CancelAndWait();
     wakelock_release();
+    encode_pipeline.reset();
+    encode_peer = RawAddress::kEmpty;
     encoder_interface = nullptr;
     encoder_interval_ms = 0;
     stats.Reset();
@@ -218,8 +270,14 @@ class BtifA2dpSource {
   void SetState(BtifA2dpSource::RunState state) { state_ = state; }
 
   fixed_queue_t* tx_audio_queue;
+  std::atomic<size_t> tx_audio_queue_bytes; /* Bytes held in tx_audio_queue */
+  size_t tx_encoded_bytes; /* Enqueued by the running encode job */
   bool tx_flush; /* Discards any outgoing data when true */
   RepeatingTimer media_alarm;
+  A2dpSourceScheduler scheduler;
+  A2dpSourceTxQueuePolicy tx_queue_policy;
+  std::unique_ptr<A2dpEncodePipeline> encode_pipeline;
+  RawAddress encode_peer; /* Peer the encoder is set up for */
   const tA2DP_ENCODER_INTERFACE* encoder_interface;
   uint64_t encoder_interval_ms; /* Local copy of the encoder interval */
   BtifMediaStats stats;
@@ -263,6 +321,13 @@ static void btif_a2dp_source_audio_feeding_update_event(
     const btav_a2dp_codec_config_t& codec_audio_config);
 static bool btif_a2dp_source_audio_tx_flush_req(void);
 static void btif_a2dp_source_audio_handle_timer(void);
+static void btif_a2dp_source_audio_encode(uint64_t timestamp_us);
+static void btif_a2dp_source_encode_flush(void);
+static A2dpSourceLinkState btif_a2dp_source_get_link_state(void);
+static A2dpSourceTxQueueLevel btif_a2dp_source_tx_queue_level(void);
+static BT_HDR* btif_a2dp_source_tx_queue_dequeue(void);
+static size_t btif_a2dp_source_tx_queue_flush(void);
+static void btif_a2dp_source_tx_queue_set_watermarks(void);
 static uint32_t btif_a2dp_source_read_callback(uint8_t* p_buf, uint32_t len);
 static bool btif_a2dp_source_enqueue_callback(BT_HDR* p_buf, size_t frames_n,
                                               uint32_t bytes_read);
@@ -336,6 +401,14 @@ void btif_a2dp_source_accumulate_stats(BtifMediaStats* src,
   dst->media_read_total_underflow_count +=
       src->media_read_total_underflow_count;
   dst->media_read_last_underflow_us = src->media_read_last_underflow_us;
+  if (btif_a2dp_source_cb.encode_pipeline != nullptr) {
+    btif_a2dp_source_cb.encode_pipeline->CollectStats(&src->encode_stats);
+  }
+  dst->encode_stats.Accumulate(src->encode_stats);
+  dst->deadline_deferred_congested_count +=
+      src->deadline_deferred_congested_count;
+  dst->deadline_deferred_queued_count += src->deadline_deferred_queued_count;
+  dst->deadline_forced_encode_count += src->deadline_forced_encode_count;
   if (dst->codec_index < 0) dst->codec_index = src->codec_index;
   btif_a2dp_source_accumulate_scheduling_stats(&src->tx_queue_enqueue_stats,
                                                &dst->tx_queue_enqueue_stats);
@@ -383,6 +456,18 @@ static void btif_a2dp_source_startup_delayed() {
   if (!btif_a2dp_source_thread.EnableRealTimeScheduling()) {
 #if defined(OS_ANDROID)
     LOG(FATAL) << __func__ << ": unable to enable real time scheduling";
+#endif
+  }
+  int num_workers =
+      osi_property_get_int32(A2DP_SOURCE_ENCODE_WORKERS_PROPERTY, 1);
+  num_workers =
+      std::min(std::max(num_workers, 1), MAX_A2DP_SOURCE_ENCODE_WORKERS);
+  btif_a2dp_source_cb.encode_pipeline =
+      std::make_unique<A2dpEncodePipeline>(num_workers);
+  if (!btif_a2dp_source_cb.encode_pipeline->StartUp(true)) {
+#if defined(OS_ANDROID)
+    LOG(FATAL) << __func__
+               << ": unable to enable real time scheduling of the encoder";
 #endif
   }
   if (!bluetooth::audio::a2dp::init(&btif_a2dp_source_thread)) {
@@ -522,6 +607,11 @@ static void btif_a2dp_source_shutdown_delayed(void) {
   // Stop the timer
   btif_a2dp_source_cb.media_alarm.CancelAndWait();
   wakelock_release();
+  if (btif_a2dp_source_cb.encode_pipeline != nullptr) {
+    btif_a2dp_source_cb.encode_pipeline->CollectStats(
+        &btif_a2dp_source_cb.stats.encode_stats);
+    btif_a2dp_source_cb.encode_pipeline->ShutDown();
+  }
 
   if (bluetooth::audio::a2dp::is_hal_enabled()) {
     bluetooth::audio::a2dp::cleanup();
@@ -605,6 +695,16 @@ static void btif_a2dp_source_setup_codec_delayed(
     return;
   }
 
+  // The encoder must be idle before being set up again
+  btif_a2dp_source_encode_flush();
+  if (btif_a2dp_source_cb.encode_pipeline != nullptr &&
+      btif_a2dp_source_cb.encode_peer != peer_address) {
+    btif_a2dp_source_cb.encode_pipeline->RemovePeer(
+        btif_a2dp_source_cb.encode_peer);
+    btif_a2dp_source_cb.encode_pipeline->AddPeer(peer_address);
+  }
+  btif_a2dp_source_cb.encode_peer = peer_address;
+
   btif_a2dp_source_cb.encoder_interface->encoder_init(
       &peer_params, a2dp_codec_config, btif_a2dp_source_read_callback,
       btif_a2dp_source_enqueue_callback);
@@ -630,6 +730,12 @@ static void btif_a2dp_source_cleanup_codec() {
 
 static void btif_a2dp_source_cleanup_codec_delayed() {
   LOG_INFO("%s: state=%s", __func__, btif_a2dp_source_cb.StateStr().c_str());
+  btif_a2dp_source_encode_flush();
+  if (btif_a2dp_source_cb.encode_pipeline != nullptr) {
+    btif_a2dp_source_cb.encode_pipeline->RemovePeer(
+        btif_a2dp_source_cb.encode_peer);
+  }
+  btif_a2dp_source_cb.encode_peer = RawAddress::kEmpty;
   if (btif_a2dp_source_cb.encoder_interface != nullptr) {
     btif_a2dp_source_cb.encoder_interface->encoder_cleanup();
     btif_a2dp_source_cb.encoder_interface = nullptr;
@@ -675,6 +781,7 @@ static void btif_a2dp_source_encoder_user_config_update_event(
     std::promise<void> peer_ready_promise) {
   bool restart_output = false;
   bool success = false;
+  btif_a2dp_source_encode_flush();
   for (auto codec_user_config : codec_user_preferences) {
     success = bta_av_co_set_codec_user_config(peer_address, codec_user_config,
                                               &restart_output);
@@ -717,6 +824,7 @@ void btif_a2dp_source_feeding_update_req(
 static void btif_a2dp_source_audio_feeding_update_event(
     const btav_a2dp_codec_config_t& codec_audio_config) {
   LOG_INFO("%s: state=%s", __func__, btif_a2dp_source_cb.StateStr().c_str());
+  btif_a2dp_source_encode_flush();
   if (!bta_av_co_set_codec_audio_config(codec_audio_config)) {
     LOG_ERROR("%s: cannot update codec audio feeding parameters", __func__);
   }
@@ -815,6 +923,7 @@ static void btif_a2dp_source_audio_tx_start_event(void) {
 
   /* Reset the media feeding state */
   CHECK(btif_a2dp_source_cb.encoder_interface != nullptr);
+  btif_a2dp_source_encode_flush();
   btif_a2dp_source_cb.encoder_interface->feeding_reset();
 
   APPL_TRACE_EVENT(
@@ -824,16 +933,26 @@ static void btif_a2dp_source_audio_tx_start_event(void) {
   /* audio engine starting, reset tx suspended flag */
   btif_a2dp_source_cb.tx_flush = false;
 
+  btif_a2dp_source_cb.scheduler.Start(
+      osi_property_get_bool(A2DP_SOURCE_DEADLINE_SCHEDULING_PROPERTY, false),
+      btif_a2dp_source_cb.encoder_interface->get_encoder_interval_ms() * 1000,
+      bluetooth::common::time_get_os_boottime_us());
+  btif_a2dp_source_cb.tx_queue_policy.Start(
+      osi_property_get_bool(A2DP_SOURCE_TX_QUEUE_DROP_OLDEST_PROPERTY, true),
+      btif_a2dp_source_cb.encoder_interface->get_encoder_interval_ms() * 1000,
+      bluetooth::common::time_get_os_boottime_us());
+  btif_a2dp_source_tx_queue_set_watermarks();
+
   wakelock_acquire();
   btif_a2dp_source_cb.media_alarm.SchedulePeriodic(
       btif_a2dp_source_thread.GetWeakPtr(), FROM_HERE,
       base::Bind(&btif_a2dp_source_audio_handle_timer),
 #if BASE_VER < 931007
-      base::TimeDelta::FromMilliseconds(
+      base::TimeDelta::FromMicroseconds(
 #else
-      base::Milliseconds(
+      base::Microseconds(
 #endif
-          btif_a2dp_source_cb.encoder_interface->get_encoder_interval_ms()));
+          btif_a2dp_source_cb.scheduler.TimerPeriodUs()));
 
   btif_a2dp_source_cb.stats.Reset();
   // Assign session_start_us to 1 when
@@ -860,6 +979,10 @@ static void btif_a2dp_source_audio_tx_stop_event(void) {
 
   if (btif_av_is_a2dp_offload_running()) return;
 
+  /* Stop the timer first, and wait for the encoder to be idle */
+  btif_a2dp_source_cb.media_alarm.CancelAndWait();
+  btif_a2dp_source_encode_flush();
+
   btif_a2dp_source_cb.stats.session_end_us =
       bluetooth::common::time_get_os_boottime_us();
   btif_a2dp_source_update_metrics();
@@ -877,8 +1000,6 @@ static void btif_a2dp_source_audio_tx_stop_event(void) {
         UIPC_Read(*a2dp_uipc, UIPC_CH_ID_AV_AUDIO, p_buf, sizeof(p_buf)));
   }
 
-  /* Stop the timer first */
-  btif_a2dp_source_cb.media_alarm.CancelAndWait();
   wakelock_release();
 
   if (bluetooth::audio::a2dp::is_hal_enabled()) {
@@ -912,6 +1033,7 @@ static void btif_a2dp_source_audio_tx_stop_event(void) {
 
 static void btif_a2dp_source_audio_handle_timer(void) {
   if (btif_av_is_a2dp_offload_running()) return;
+  OS_TRACE_SCOPE("A2dpSource::EncodeTick");
 
   uint64_t timestamp_us = bluetooth::common::time_get_os_boottime_us();
   log_tstamps_us("A2DP Source tx timer", timestamp_us);
@@ -921,21 +1043,121 @@ static void btif_a2dp_source_audio_handle_timer(void) {
     return;
   }
   CHECK(btif_a2dp_source_cb.encoder_interface != nullptr);
-  size_t transmit_queue_length =
-      fixed_queue_length(btif_a2dp_source_cb.tx_audio_queue);
+
+  A2dpSourceLinkState link = btif_a2dp_source_get_link_state();
+  switch (btif_a2dp_source_cb.scheduler.Poll(timestamp_us, link)) {
+    case A2dpSourceScheduler::kWait:
+      return;
+    case A2dpSourceScheduler::kDeferCongested:
+      btif_a2dp_source_cb.stats.deadline_deferred_congested_count++;
+      return;
+    case A2dpSourceScheduler::kDeferQueued:
+      btif_a2dp_source_cb.stats.deadline_deferred_queued_count++;
+      return;
+    case A2dpSourceScheduler::kEncodeForced:
+      btif_a2dp_source_cb.stats.deadline_forced_encode_count++;
+      break;
+    case A2dpSourceScheduler::kEncode:
+      break;
+  }
+
+  bool submitted = true;
+  if (btif_a2dp_source_cb.encode_pipeline != nullptr) {
+    // The job must be done before the next encoding
+    uint64_t deadline_us =
+        timestamp_us + btif_a2dp_source_cb.encoder_interval_ms * 1000;
+    submitted = btif_a2dp_source_cb.encode_pipeline->Submit(
+        btif_a2dp_source_cb.encode_peer, deadline_us,
+        base::BindOnce(&btif_a2dp_source_audio_encode, timestamp_us));
+  } else {
+    btif_a2dp_source_audio_encode(timestamp_us);
+  }
+  if (submitted) btif_a2dp_source_cb.scheduler.OnEncode(timestamp_us, link);
+  update_scheduling_stats(&btif_a2dp_source_cb.stats.tx_queue_enqueue_stats,
+                          timestamp_us,
+                          btif_a2dp_source_cb.encoder_interval_ms * 1000);
+}
+
+// Runs in the encode worker of the active peer
+static void btif_a2dp_source_audio_encode(uint64_t timestamp_us) {
+  // The media task may have been stopped while the job was pending
+  if (!btif_a2dp_source_cb.media_alarm.IsScheduled()) return;
+
+  A2dpSourceTxQueueLevel level = btif_a2dp_source_tx_queue_level();
 #ifndef OS_GENERIC
-  ATRACE_INT("btif TX queue", transmit_queue_length);
+  ATRACE_INT("btif TX queue", level.packets);
 #endif
+  // The encoders adapt their bitrate to the occupancy of the queue
   if (btif_a2dp_source_cb.encoder_interface->set_transmit_queue_length !=
       nullptr) {
     btif_a2dp_source_cb.encoder_interface->set_transmit_queue_length(
-        transmit_queue_length);
+        btif_a2dp_source_cb.tx_queue_policy.EncoderQueueLength(level));
   }
+  btif_a2dp_source_cb.tx_encoded_bytes = 0;
   btif_a2dp_source_cb.encoder_interface->send_frames(timestamp_us);
+  btif_a2dp_source_cb.tx_queue_policy.OnEncoded(
+      timestamp_us, btif_a2dp_source_cb.tx_encoded_bytes);
   bta_av_ci_src_data_ready(BTA_AV_CHNL_AUDIO);
-  update_scheduling_stats(&btif_a2dp_source_cb.stats.tx_queue_enqueue_stats,
-                          timestamp_us,
-                          btif_a2dp_source_cb.encoder_interval_ms * 1000);
+}
+
+static A2dpSourceTxQueueLevel btif_a2dp_source_tx_queue_level(void) {
+  A2dpSourceTxQueueLevel level;
+  level.packets = fixed_queue_length(btif_a2dp_source_cb.tx_audio_queue);
+  level.bytes = btif_a2dp_source_cb.tx_audio_queue_bytes;
+  return level;
+}
+
+// Dequeues the oldest packet of the tx queue, nullptr if empty
+static BT_HDR* btif_a2dp_source_tx_queue_dequeue(void) {
+  BT_HDR* p_buf =
+      (BT_HDR*)fixed_queue_try_dequeue(btif_a2dp_source_cb.tx_audio_queue);
+  if (p_buf != nullptr) btif_a2dp_source_cb.tx_audio_queue_bytes -= p_buf->len;
+  return p_buf;
+}
+
+// Drops all the packets of the tx queue. Returns the number of packets.
+static size_t btif_a2dp_source_tx_queue_flush(void) {
+  size_t flushed_n = 0;
+  BT_HDR* p_buf;
+  while ((p_buf = btif_a2dp_source_tx_queue_dequeue()) != nullptr) {
+    osi_free(p_buf);
+    flushed_n++;
+  }
+  return flushed_n;
+}
+
+static void btif_a2dp_source_tx_queue_set_watermarks(void) {
+  size_t max_packets = btif_a2dp_source_dynamic_audio_buffer_size;
+  int max_frame_size =
+      btif_a2dp_source_cb.encoder_interface->get_effective_frame_size();
+  size_t max_bytes = (max_frame_size > 0) ? max_packets * max_frame_size : 0;
+  int32_t max_playout_ms =
+      osi_property_get_int32(A2DP_SOURCE_TX_QUEUE_MAX_MS_PROPERTY,
+                             A2DP_SOURCE_TX_QUEUE_DEFAULT_MAX_MS);
+  if (max_playout_ms < 0) max_playout_ms = 0;
+  btif_a2dp_source_cb.tx_queue_policy.SetWatermarks(
+      max_packets, max_bytes, (uint64_t)max_playout_ms * 1000);
+}
+
+static A2dpSourceLinkState btif_a2dp_source_get_link_state(void) {
+  A2dpSourceLinkState link = {};
+  link.tx_queue_length = fixed_queue_length(btif_a2dp_source_cb.tx_audio_queue);
+  if (!BTA_AvGetStreamLinkState(btif_a2dp_source_cb.encode_peer,
+                                &link.congested, &link.l2c_bufs)) {
+    link.congested = false;
+    link.l2c_bufs = 0;
+  }
+  // The delay is reported in 1/10 ms
+  link.sink_delay_us = btif_av_get_audio_delay() * 100;
+  return link;
+}
+
+// Waits for the pending encode jobs. Must be called before touching the
+// encoder state from the A2DP Source thread.
+static void btif_a2dp_source_encode_flush(void) {
+  if (btif_a2dp_source_cb.encode_pipeline != nullptr) {
+    btif_a2dp_source_cb.encode_pipeline->Flush();
+  }
 }
 
 static uint32_t btif_a2dp_source_read_callback(uint8_t* p_buf, uint32_t len) {
@@ -994,42 +1216,48 @@ static bool btif_a2dp_source_enqueue_callback(BT_HDR* p_buf, size_t frames_n,
     LOG_VERBOSE("%s: tx suspended, discarded frame", __func__);
 
     btif_a2dp_source_cb.stats.tx_queue_total_flushed_messages +=
-        fixed_queue_length(btif_a2dp_source_cb.tx_audio_queue);
+        btif_a2dp_source_tx_queue_flush();
     btif_a2dp_source_cb.stats.tx_queue_last_flushed_us = now_us;
-    fixed_queue_flush(btif_a2dp_source_cb.tx_audio_queue, osi_free);
 
     osi_free(p_buf);
     return false;
   }
 
-  // Check for TX queue overflow
-  // TODO: Using frames_n here is probably wrong: should be "+ 1" instead.
-  if (fixed_queue_length(btif_a2dp_source_cb.tx_audio_queue) + frames_n >
+  // The packet bound may have been changed during the session
+  if (btif_a2dp_source_cb.tx_queue_policy.MaxPackets() !=
       btif_a2dp_source_dynamic_audio_buffer_size) {
-    LOG_WARN("%s: TX queue buffer size now=%u adding=%u max=%d", __func__,
-             (uint32_t)fixed_queue_length(btif_a2dp_source_cb.tx_audio_queue),
-             (uint32_t)frames_n, btif_a2dp_source_dynamic_audio_buffer_size);
+    btif_a2dp_source_tx_queue_set_watermarks();
+  }
+
+  // Check for TX queue overflow
+  A2dpSourceTxQueuePolicy& policy = btif_a2dp_source_cb.tx_queue_policy;
+  A2dpSourceTxQueueLevel level = btif_a2dp_source_tx_queue_level();
+  if (policy.IsOverflow(level, p_buf->len)) {
+    LOG_WARN("%s: TX queue buffer size now=%zu bytes=%zu adding=%u max=%zu",
+             __func__, level.packets, level.bytes, (uint32_t)frames_n,
+             policy.MaxPackets());
     // Keep track of drop-outs
     btif_a2dp_source_cb.stats.tx_queue_dropouts++;
     btif_a2dp_source_cb.stats.tx_queue_last_dropouts_us = now_us;
 
-    // Flush all queued buffers
-    size_t drop_n = fixed_queue_length(btif_a2dp_source_cb.tx_audio_queue);
-    btif_a2dp_source_cb.stats.tx_queue_max_dropped_messages = std::max(
-        drop_n, btif_a2dp_source_cb.stats.tx_queue_max_dropped_messages);
+    // Drop the oldest buffers: all of them, or until the queue is back under
+    // the low watermarks
+    size_t drop_n = 0;
     int num_dropped_encoded_bytes = 0;
     int num_dropped_encoded_frames = 0;
-    while (fixed_queue_length(btif_a2dp_source_cb.tx_audio_queue)) {
-      btif_a2dp_source_cb.stats.tx_queue_total_dropped_messages++;
-      void* p_data =
-          fixed_queue_try_dequeue(btif_a2dp_source_cb.tx_audio_queue);
-      if (p_data != nullptr) {
-        auto p_dropped_buf = static_cast<BT_HDR*>(p_data);
-        num_dropped_encoded_bytes += p_dropped_buf->len;
-        num_dropped_encoded_frames += p_dropped_buf->layer_specific;
-        osi_free(p_data);
-      }
+    while (policy.ShouldDrop(level, p_buf->len)) {
+      BT_HDR* p_dropped_buf = btif_a2dp_source_tx_queue_dequeue();
+      if (p_dropped_buf == nullptr) break;
+      drop_n++;
+      num_dropped_encoded_bytes += p_dropped_buf->len;
+      num_dropped_encoded_frames += p_dropped_buf->layer_specific;
+      osi_free(p_dropped_buf);
+      level = btif_a2dp_source_tx_queue_level();
     }
+    btif_a2dp_source_cb.stats.tx_queue_total_dropped_messages += drop_n;
+    btif_a2dp_source_cb.stats.tx_queue_max_dropped_messages = std::max(
+        drop_n, btif_a2dp_source_cb.stats.tx_queue_max_dropped_messages);
+    policy.OnDrop(drop_n, num_dropped_encoded_bytes);
     log_a2dp_audio_overrun_event(btif_av_source_active_peer(), drop_n,
                                  btif_a2dp_source_cb.encoder_interval_ms,
                                  num_dropped_encoded_frames,
@@ -1060,7 +1288,10 @@ static bool btif_a2dp_source_enqueue_callback(BT_HDR* p_buf, size_t frames_n,
       frames_n, btif_a2dp_source_cb.stats.tx_queue_max_frames_per_packet);
   CHECK(btif_a2dp_source_cb.encoder_interface != nullptr);
 
+  btif_a2dp_source_cb.tx_encoded_bytes += p_buf->len;
+  btif_a2dp_source_cb.tx_audio_queue_bytes += p_buf->len;
   fixed_queue_enqueue(btif_a2dp_source_cb.tx_audio_queue, p_buf);
+  policy.OnEnqueue(btif_a2dp_source_tx_queue_level());
 
   return true;
 }
@@ -1070,14 +1301,14 @@ static void btif_a2dp_source_audio_tx_flush_event(void) {
   LOG_INFO("%s: state=%s", __func__, btif_a2dp_source_cb.StateStr().c_str());
   if (btif_av_is_a2dp_offload_running()) return;
 
+  btif_a2dp_source_encode_flush();
   if (btif_a2dp_source_cb.encoder_interface != nullptr)
     btif_a2dp_source_cb.encoder_interface->feeding_flush();
 
   btif_a2dp_source_cb.stats.tx_queue_total_flushed_messages +=
-      fixed_queue_length(btif_a2dp_source_cb.tx_audio_queue);
+      btif_a2dp_source_tx_queue_flush();
   btif_a2dp_source_cb.stats.tx_queue_last_flushed_us =
       bluetooth::common::time_get_os_boottime_us();
-  fixed_queue_flush(btif_a2dp_source_cb.tx_audio_queue, osi_free);
 
   if (!bluetooth::audio::a2dp::is_hal_enabled() && a2dp_uipc != nullptr) {
     UIPC_Ioctl(*a2dp_uipc, UIPC_CH_ID_AV_AUDIO, UIPC_REQ_RX_FLUSH, nullptr);
@@ -1094,8 +1325,7 @@ static bool btif_a2dp_source_audio_tx_flush_req(void) {
 
 BT_HDR* btif_a2dp_source_audio_readbuf(void) {
   uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
-  BT_HDR* p_buf =
-      (BT_HDR*)fixed_queue_try_dequeue(btif_a2dp_source_cb.tx_audio_queue);
+  BT_HDR* p_buf = btif_a2dp_source_tx_queue_dequeue();
 
   btif_a2dp_source_cb.stats.tx_queue_total_readbuf_calls++;
   btif_a2dp_source_cb.stats.tx_queue_last_readbuf_us = now_us;
@@ -1228,6 +1458,34 @@ void btif_a2dp_source_debug_dump(int fd) {
                 1000
           : 0);
 
+  A2dpSourceTxQueuePolicy& policy = btif_a2dp_source_cb.tx_queue_policy;
+  dprintf(fd,
+          "  TxQueue overflow policy                                 : %s\n",
+          policy.IsDropOldest() ? "drop oldest" : "flush");
+
+  dprintf(fd,
+          "  Watermarks (packets/bytes/ms)                           : %zu / "
+          "%zu / %llu\n",
+          policy.MaxPackets(), policy.MaxBytes(),
+          (unsigned long long)policy.MaxPlayoutUs() / 1000);
+
+  dprintf(fd,
+          "  Encoded rate in kbps (current or last session)          : %llu\n",
+          (unsigned long long)policy.ByteRate() * 8 / 1000);
+
+  dprintf(fd,
+          "  Drops (events/packets/bytes/ms) (current or last)       : %zu / "
+          "%zu / %zu / %llu\n",
+          policy.stats.drop_events, policy.stats.dropped_packets,
+          policy.stats.dropped_bytes,
+          (unsigned long long)policy.stats.dropped_playout_us / 1000);
+
+  dprintf(fd,
+          "  Max. occupancy (packets/bytes/ms) (current or last)     : %zu / "
+          "%zu / %llu\n",
+          policy.stats.max_packets, policy.stats.max_bytes,
+          (unsigned long long)policy.stats.max_playout_us / 1000);
+
   dprintf(fd,
           "  Counts (underflow)                                      : %zu\n",
           accumulated_stats->media_read_total_underflow_count);
@@ -1245,6 +1503,60 @@ void btif_a2dp_source_debug_dump(int fd) {
                     1000
               : 0);
 
+  A2dpEncodeStats* encode_stats = &accumulated_stats->encode_stats;
+  dprintf(fd,
+          "  Counts (encode jobs/deadline misses/skipped ticks)      : %zu / "
+          "%zu / %zu\n",
+          encode_stats->total_jobs, encode_stats->deadline_miss_count,
+          encode_stats->skipped_ticks);
+
+  ave_time_us = 0;
+  if (encode_stats->deadline_miss_count != 0) {
+    ave_time_us =
+        encode_stats->total_overrun_us / encode_stats->deadline_miss_count;
+  }
+  dprintf(
+      fd,
+      "  Encode deadline overrun time in ms (total/max/ave)      : %llu / %llu "
+      "/ %llu\n",
+      (unsigned long long)encode_stats->total_overrun_us / 1000,
+      (unsigned long long)encode_stats->max_overrun_us / 1000,
+      (unsigned long long)ave_time_us / 1000);
+
+  dprintf(fd,
+          "  Encode max. job time in ms                              : %llu\n",
+          (unsigned long long)encode_stats->max_encode_time_us / 1000);
+
+  dprintf(fd,
+          "  Last update time ago in ms (deadline miss)              : %llu\n",
+          (encode_stats->last_deadline_miss_us > 0)
+              ? (unsigned long long)(now_us -
+                                     encode_stats->last_deadline_miss_us) /
+                    1000
+              : 0);
+
+  dprintf(fd,
+          "  Scheduling mode                                         : %s\n",
+          btif_a2dp_source_cb.scheduler.IsDeadlineMode() ? "deadline"
+                                                         : "fixed");
+
+  dprintf(fd,
+          "  Deadline counts (deferred congested/queued/forced)      : %zu / "
+          "%zu / %zu\n",
+          accumulated_stats->deadline_deferred_congested_count,
+          accumulated_stats->deadline_deferred_queued_count,
+          accumulated_stats->deadline_forced_encode_count);
+
+  dprintf(fd,
+          "  Encode jitter histogram in ms (current or last session) : %s\n",
+          btif_a2dp_source_cb.scheduler.jitter_histogram.ToString(1000)
+              .c_str());
+
+  dprintf(fd,
+          "  Queued packets histogram (current or last session)      : %s\n",
+          btif_a2dp_source_cb.scheduler.queueing_histogram.ToString(1)
+              .c_str());
+
   //
   // TxQueue enqueue stats
   //
@@ -0,0 +1,181 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#define LOG_TAG "bt_btif_a2dp_source_encode"
+
+#include "btif_a2dp_source_encode_pipeline.h"
+
+#include <base/bind.h>
+#include <base/logging.h>
+
+#include <algorithm>
+#include <future>
+#include <string>
+
+#include "common/time_util.h"
+#include "osi/include/log.h"
+
+using bluetooth::common::MessageLoopThread;
+
+void A2dpEncodeStats::Accumulate(const A2dpEncodeStats& src) {
+  total_jobs += src.total_jobs;
+  deadline_miss_count += src.deadline_miss_count;
+  skipped_ticks += src.skipped_ticks;
+  total_overrun_us += src.total_overrun_us;
+  max_overrun_us = std::max(max_overrun_us, src.max_overrun_us);
+  max_encode_time_us = std::max(max_encode_time_us, src.max_encode_time_us);
+  if (src.last_deadline_miss_us != 0)
+    last_deadline_miss_us = src.last_deadline_miss_us;
+}
+
+A2dpEncodePipeline::A2dpEncodePipeline(size_t num_workers) {
+  CHECK(num_workers > 0);
+  for (size_t i = 0; i < num_workers; i++) {
+    workers_.push_back(std::make_unique<MessageLoopThread>(
+        "bt_a2dp_encode_worker_" + std::to_string(i)));
+  }
+  worker_load_.resize(num_workers, 0);
+}
+
+A2dpEncodePipeline::~A2dpEncodePipeline() { ShutDown(); }
+
+bool A2dpEncodePipeline::StartUp(bool real_time) {
+  bool success = true;
+  for (auto& worker : workers_) {
+    if (worker->IsRunning()) continue;
+    worker->StartUp();
+    if (real_time && !worker->EnableRealTimeScheduling()) {
+      LOG_ERROR("%s: unable to enable real time scheduling for %s", __func__,
+                worker->GetName().c_str());
+      success = false;
+    }
+  }
+  return success;
+}
+
+void A2dpEncodePipeline::ShutDown() {
+  Flush();
+  for (auto& worker : workers_) worker->ShutDown();
+  peers_.clear();
+  std::fill(worker_load_.begin(), worker_load_.end(), 0);
+}
+
+bool A2dpEncodePipeline::IsRunning() const {
+  return std::all_of(workers_.begin(), workers_.end(),
+                     [](const auto& worker) { return worker->IsRunning(); });
+}
+
+size_t A2dpEncodePipeline::AddPeer(const RawAddress& peer_address) {
+  auto it = peers_.find(peer_address);
+  if (it != peers_.end()) return it->second->worker;
+
+  size_t worker = std::min_element(worker_load_.begin(), worker_load_.end()) -
+                  worker_load_.begin();
+  worker_load_[worker]++;
+  peers_[peer_address] = std::make_shared<Peer>(Peer{worker, false});
+  return worker;
+}
+
+void A2dpEncodePipeline::RemovePeer(const RawAddress& peer_address) {
+  auto it = peers_.find(peer_address);
+  if (it == peers_.end()) return;
+
+  worker_load_[it->second->worker]--;
+  peers_.erase(it);
+}
+
+int A2dpEncodePipeline::WorkerOf(const RawAddress& peer_address) const {
+  auto it = peers_.find(peer_address);
+  return (it != peers_.end()) ? static_cast<int>(it->second->worker) : -1;
+}
+
+bool A2dpEncodePipeline::Submit(const RawAddress& peer_address,
+                                uint64_t deadline_us, base::OnceClosure job) {
+  auto it = peers_.find(peer_address);
+  if (it == peers_.end()) {
+    LOG_ERROR("%s: peer %s has no worker", __func__,
+              peer_address.ToString().c_str());
+    return false;
+  }
+  std::shared_ptr<Peer> peer = it->second;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (peer->pending) {
+      stats_.skipped_ticks++;
+      return false;
+    }
+    peer->pending = true;
+  }
+
+  uint64_t submit_us = bluetooth::common::time_get_os_boottime_us();
+  if (!workers_[peer->worker]->DoInThread(
+          FROM_HERE,
+          base::BindOnce(&A2dpEncodePipeline::RunJob, base::Unretained(this),
+                         peer, submit_us, deadline_us, std::move(job)))) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    peer->pending = false;
+    return false;
+  }
+  return true;
+}
+
+void A2dpEncodePipeline::RunJob(std::shared_ptr<Peer> peer, uint64_t submit_us,
+                                uint64_t deadline_us, base::OnceClosure job) {
+  std::move(job).Run();
+  uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  peer->pending = false;
+  stats_.total_jobs++;
+  stats_.max_encode_time_us =
+      std::max(stats_.max_encode_time_us, now_us - submit_us);
+  if (now_us > deadline_us) {
+    uint64_t overrun_us = now_us - deadline_us;
+    stats_.deadline_miss_count++;
+    stats_.total_overrun_us += overrun_us;
+    stats_.max_overrun_us = std::max(stats_.max_overrun_us, overrun_us);
+    stats_.last_deadline_miss_us = now_us;
+  }
+}
+
+void A2dpEncodePipeline::Flush() {
+  std::vector<std::future<void>> futures;
+  for (auto& worker : workers_) {
+    std::promise<void> promise;
+    std::future<void> future = promise.get_future();
+    if (worker->DoInThread(
+            FROM_HERE,
+            base::BindOnce([](std::promise<void> p) { p.set_value(); },
+                           std::move(promise)))) {
+      futures.push_back(std::move(future));
+    }
+  }
+  for (auto& future : futures) future.wait();
+}
+
+A2dpEncodeStats A2dpEncodePipeline::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void A2dpEncodePipeline::CollectStats(A2dpEncodeStats* dst) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  dst->Accumulate(stats_);
+  stats_.Reset();
+}
@@ -0,0 +1,120 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "btif_a2dp_source_scheduler.h"
+
+#include <base/logging.h>
+
+#include <algorithm>
+#include <sstream>
+
+A2dpSourceHistogram::A2dpSourceHistogram(std::vector<uint64_t> bounds)
+    : bounds_(std::move(bounds)), counts_(bounds_.size() + 1, 0) {
+  CHECK(std::is_sorted(bounds_.begin(), bounds_.end()));
+}
+
+void A2dpSourceHistogram::Reset() {
+  std::fill(counts_.begin(), counts_.end(), 0);
+}
+
+void A2dpSourceHistogram::Add(uint64_t value) {
+  size_t bucket = std::upper_bound(bounds_.begin(), bounds_.end(), value) -
+                  bounds_.begin();
+  counts_[bucket]++;
+}
+
+void A2dpSourceHistogram::Accumulate(const A2dpSourceHistogram& src) {
+  CHECK(bounds_ == src.bounds_);
+  for (size_t i = 0; i < counts_.size(); i++) counts_[i] += src.counts_[i];
+}
+
+size_t A2dpSourceHistogram::Total() const {
+  size_t total = 0;
+  for (size_t count : counts_) total += count;
+  return total;
+}
+
+std::string A2dpSourceHistogram::ToString(uint64_t scale) const {
+  std::stringstream ss;
+  uint64_t lo = 0;
+  for (size_t i = 0; i < counts_.size(); i++) {
+    if (i > 0) ss << " ";
+    ss << "[" << lo / scale << ",";
+    if (i < bounds_.size()) {
+      ss << bounds_[i] / scale << ")";
+      lo = bounds_[i];
+    } else {
+      ss << "inf)";
+    }
+    ss << ":" << counts_[i];
+  }
+  return ss.str();
+}
+
+A2dpSourceScheduler::A2dpSourceScheduler()
+    : jitter_histogram({1000, 2000, 5000, 10000, 20000, 50000}),
+      queueing_histogram({1, 2, 3, 4, 8}),
+      deadline_mode_(false),
+      interval_us_(0),
+      last_encode_us_(0) {}
+
+void A2dpSourceScheduler::Start(bool deadline_mode, uint64_t interval_us,
+                                uint64_t now_us) {
+  CHECK(interval_us > 0);
+  deadline_mode_ = deadline_mode;
+  interval_us_ = interval_us;
+  last_encode_us_ = now_us;
+  jitter_histogram.Reset();
+  queueing_histogram.Reset();
+}
+
+uint64_t A2dpSourceScheduler::TimerPeriodUs() const {
+  if (!deadline_mode_) return interval_us_;
+  return std::max<uint64_t>(interval_us_ / kPollsPerInterval, 1000);
+}
+
+uint64_t A2dpSourceScheduler::MaxDeferUs(uint64_t sink_delay_us) const {
+  // A quarter of the sink buffer, up to one extra interval: the encoders
+  // limit the number of frames sent on a single tick.
+  return interval_us_ + std::min(sink_delay_us / 4, interval_us_);
+}
+
+A2dpSourceScheduler::Decision A2dpSourceScheduler::Poll(
+    uint64_t now_us, const A2dpSourceLinkState& link) const {
+  if (!deadline_mode_) return kEncode;
+
+  uint64_t elapsed_us = now_us - last_encode_us_;
+  if (elapsed_us >= MaxDeferUs(link.sink_delay_us)) return kEncodeForced;
+
+  // Encode on the poll closest to the nominal deadline
+  if (elapsed_us + TimerPeriodUs() / 2 < interval_us_) return kWait;
+
+  if (link.congested) return kDeferCongested;
+  if (link.tx_queue_length + link.l2c_bufs > 1) return kDeferQueued;
+  return kEncode;
+}
+
+void A2dpSourceScheduler::OnEncode(uint64_t now_us,
+                                   const A2dpSourceLinkState& link) {
+  uint64_t elapsed_us = now_us - last_encode_us_;
+  last_encode_us_ = now_us;
+
+  jitter_histogram.Add((elapsed_us > interval_us_) ? elapsed_us - interval_us_
+                                                   : interval_us_ - elapsed_us);
+  queueing_histogram.Add(link.tx_queue_length + link.l2c_bufs);
+}
@@ -0,0 +1,127 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "btif_a2dp_source_tx_queue_policy.h"
+
+#include <base/logging.h>
+
+#include <algorithm>
+
+// Weight of a new sample in the encoded rate estimate is 1/2^kRateShift
+static constexpr int kRateShift = 3;
+
+A2dpSourceTxQueuePolicy::A2dpSourceTxQueuePolicy()
+    : stats(),
+      drop_oldest_(false),
+      interval_us_(0),
+      max_packets_(0),
+      max_bytes_(0),
+      max_playout_us_(0),
+      byte_rate_(0),
+      last_encoded_us_(0),
+      pending_bytes_(0),
+      pending_us_(0) {}
+
+void A2dpSourceTxQueuePolicy::Start(bool drop_oldest, uint64_t interval_us,
+                                    uint64_t now_us) {
+  CHECK(interval_us > 0);
+  drop_oldest_ = drop_oldest;
+  interval_us_ = interval_us;
+  byte_rate_ = 0;
+  last_encoded_us_ = now_us;
+  pending_bytes_ = 0;
+  pending_us_ = 0;
+  stats = {};
+}
+
+void A2dpSourceTxQueuePolicy::SetWatermarks(size_t max_packets,
+                                            size_t max_bytes,
+                                            uint64_t max_playout_us) {
+  max_packets_ = max_packets;
+  max_bytes_ = max_bytes;
+  max_playout_us_ = max_playout_us;
+}
+
+void A2dpSourceTxQueuePolicy::OnEncoded(uint64_t now_us, size_t bytes) {
+  pending_bytes_ += bytes;
+  pending_us_ += now_us - last_encoded_us_;
+  last_encoded_us_ = now_us;
+
+  // The encoders may hold the frames of a tick to fill a packet: the rate is
+  // sampled over the ticks until data is produced.
+  if (pending_bytes_ == 0 || pending_us_ == 0) return;
+
+  int64_t sample = pending_bytes_ * 1000000 / pending_us_;
+  if (byte_rate_ == 0) {
+    byte_rate_ = sample;
+  } else {
+    int64_t rate = byte_rate_;
+    byte_rate_ = rate + ((sample - rate) >> kRateShift);
+  }
+  pending_bytes_ = 0;
+  pending_us_ = 0;
+}
+
+uint64_t A2dpSourceTxQueuePolicy::PlayoutUs(size_t bytes) const {
+  if (byte_rate_ == 0) return 0;
+  return bytes * 1000000 / byte_rate_;
+}
+
+bool A2dpSourceTxQueuePolicy::IsAbove(const A2dpSourceTxQueueLevel& level,
+                                      size_t percent) const {
+  if (max_packets_ != 0 && level.packets * 100 > max_packets_ * percent)
+    return true;
+  if (max_bytes_ != 0 && level.bytes * 100 > max_bytes_ * percent) return true;
+  if (max_playout_us_ != 0 &&
+      PlayoutUs(level.bytes) * 100 > max_playout_us_ * percent)
+    return true;
+  return false;
+}
+
+bool A2dpSourceTxQueuePolicy::IsOverflow(const A2dpSourceTxQueueLevel& level,
+                                         size_t packet_bytes) const {
+  return IsAbove({level.packets + 1, level.bytes + packet_bytes}, 100);
+}
+
+bool A2dpSourceTxQueuePolicy::ShouldDrop(const A2dpSourceTxQueueLevel& level,
+                                         size_t packet_bytes) const {
+  if (level.packets == 0) return false;
+  if (!drop_oldest_) return true;
+  return IsAbove({level.packets + 1, level.bytes + packet_bytes},
+                 kLowWatermarkPercent);
+}
+
+size_t A2dpSourceTxQueuePolicy::EncoderQueueLength(
+    const A2dpSourceTxQueueLevel& level) const {
+  if (interval_us_ == 0) return level.packets;
+  size_t intervals = PlayoutUs(level.bytes) / interval_us_;
+  return std::max(level.packets, intervals);
+}
+
+void A2dpSourceTxQueuePolicy::OnDrop(size_t packets, size_t bytes) {
+  stats.drop_events++;
+  stats.dropped_packets += packets;
+  stats.dropped_bytes += bytes;
+  stats.dropped_playout_us += PlayoutUs(bytes);
+}
+
+void A2dpSourceTxQueuePolicy::OnEnqueue(const A2dpSourceTxQueueLevel& level) {
+  stats.max_packets = std::max(stats.max_packets, level.packets);
+  stats.max_bytes = std::max(stats.max_bytes, level.bytes);
+  stats.max_playout_us = std::max(stats.max_playout_us, PlayoutUs(level.bytes));
+}
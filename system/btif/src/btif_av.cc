@@ -59,6 +59,8 @@
 #include "types/bluetooth/uuid.h"
 #include "types/raw_address.h"
 
+using bluetooth::common::MessageLoopThread;
+
 /*****************************************************************************
  *  Constants & Macros
  *****************************************************************************/
@@ -3402,10 +3404,12 @@ void btif_av_stream_start_with_latency(bool use_latency_mode) {
            btif_av_event.ToString().c_str(),
            use_latency_mode ? "true" : "false");
 
-  do_in_main_thread(FROM_HERE, base::Bind(&btif_av_handle_event,
-                                          AVDT_TSEP_SNK,  // peer_sep
-                                          btif_av_source_active_peer(),
-                                          kBtaHandleUnknown, btif_av_event));
+  do_in_main_thread_with_priority(
+      FROM_HERE,
+      base::Bind(&btif_av_handle_event, AVDT_TSEP_SNK,  // peer_sep
+                 btif_av_source_active_peer(), kBtaHandleUnknown,
+                 btif_av_event),
+      MessageLoopThread::Priority::HIGH);
 }
 
 void src_do_suspend_in_main_thread(btif_av_sm_event_t event) {
@@ -3426,7 +3430,9 @@ void src_do_suspend_in_main_thread(btif_av_sm_event_t event) {
     }
   };
   // switch to main thread to prevent a race condition of accessing peers
-  do_in_main_thread(FROM_HERE, base::Bind(src_do_stream_suspend, event));
+  do_in_main_thread_with_priority(FROM_HERE,
+                                  base::Bind(src_do_stream_suspend, event),
+                                  MessageLoopThread::Priority::HIGH);
 }
 
 void btif_av_stream_stop(const RawAddress& peer_address) {
@@ -3851,8 +3857,10 @@ void btif_av_set_low_latency(bool is_low_latency) {
   LOG_INFO("peer_address=%s event=%s",
            btif_av_source_active_peer().ToString().c_str(),
            btif_av_event.ToString().c_str());
-  do_in_main_thread(FROM_HERE, base::Bind(&btif_av_handle_event,
-                                          AVDT_TSEP_SNK,  // peer_sep
-                                          btif_av_source_active_peer(),
-                                          kBtaHandleUnknown, btif_av_event));
+  do_in_main_thread_with_priority(
+      FROM_HERE,
+      base::Bind(&btif_av_handle_event, AVDT_TSEP_SNK,  // peer_sep
+                 btif_av_source_active_peer(), kBtaHandleUnknown,
+                 btif_av_event),
+      MessageLoopThread::Priority::HIGH);
 }
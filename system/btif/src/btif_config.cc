@@ -293,6 +293,11 @@ bool btif_config_set_bin(const std::string& section, const std::string& key,
                                                       length);
 }
 
+uint64_t btif_config_get_persistent_generation(void) {
+  CHECK(bluetooth::shim::is_gd_stack_started_up());
+  return bluetooth::shim::BtifConfigInterface::GetPersistentGeneration();
+}
+
 std::vector<RawAddress> btif_config_get_paired_devices() {
   std::vector<std::string> names;
   CHECK(bluetooth::shim::is_gd_stack_started_up());
@@ -371,4 +376,7 @@ void btif_debug_config_dump(int fd) {
   dprintf(fd, "  Devices loaded: %zu\n", devices.size());
   dprintf(fd, "  File created/tagged: %s\n", btif_config_time_created);
   dprintf(fd, "  File source: %s\n", file_source->c_str());
+  if (bluetooth::shim::is_gd_stack_started_up()) {
+    bluetooth::shim::BtifConfigInterface::DumpTemporaryDevices(fd);
+  }
 }
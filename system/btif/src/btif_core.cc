@@ -48,6 +48,7 @@
 #include "btif/include/btif_storage.h"
 #include "btif/include/stack_manager.h"
 #include "common/message_loop_thread.h"
+#include "common/startup_trace.h"
 #include "device/include/controller.h"
 #include "osi/include/allocator.h"
 #include "osi/include/future.h"
@@ -62,6 +63,8 @@
 using base::PlatformThread;
 using bluetooth::Uuid;
 using bluetooth::common::MessageLoopThread;
+using bluetooth::common::ScopedStartupPhase;
+using bluetooth::common::StartupPhaseType;
 
 static void bt_jni_msg_ready(void* context);
 
@@ -172,6 +175,20 @@ bt_status_t do_in_jni_thread(base::OnceClosure task) {
   return do_in_jni_thread(FROM_HERE, std::move(task));
 }
 
+/**
+ * This function posts a task into the JNI message loop, to be executed after
+ * |delay|.
+ **/
+bt_status_t do_in_jni_thread_delayed(const base::Location& from_here,
+                                     base::OnceClosure task,
+                                     const base::TimeDelta& delay) {
+  if (!jni_thread.DoInThreadDelayed(from_here, std::move(task), delay)) {
+    LOG(ERROR) << __func__ << ": Post task to task runner failed!";
+    return BT_STATUS_FAIL;
+  }
+  return BT_STATUS_SUCCESS;
+}
+
 bool is_on_jni_thread() {
   return jni_thread.GetThreadId() == PlatformThread::CurrentId();
 }
@@ -306,16 +323,28 @@ void btif_enable_bluetooth_evt() {
   /* callback to HAL */
   uid_set = uid_set_create();
 
-  btif_dm_init(uid_set);
+  {
+    ScopedStartupPhase phase(StartupPhaseType::PROFILE, "btif_dm_init");
+    btif_dm_init(uid_set);
+  }
 
   /* init rfcomm & l2cap api */
-  btif_sock_init(uid_set);
+  {
+    ScopedStartupPhase phase(StartupPhaseType::PROFILE, "btif_sock_init");
+    btif_sock_init(uid_set);
+  }
 
   /* init pan */
-  btif_pan_init();
+  {
+    ScopedStartupPhase phase(StartupPhaseType::PROFILE, "btif_pan_init");
+    btif_pan_init();
+  }
 
   /* load did configuration */
-  bte_load_did_conf(BTE_DID_CONF_FILE);
+  {
+    ScopedStartupPhase phase(StartupPhaseType::PROFILE, "bte_load_did_conf");
+    bte_load_did_conf(BTE_DID_CONF_FILE);
+  }
 
 #ifdef BTIF_DM_OOB_TEST
   btif_dm_load_local_oob();
@@ -23,6 +23,7 @@
 #include <time.h>
 
 #include "common/time_util.h"
+#include "main/shim/dumpsys.h"
 #include "types/raw_address.h"
 
 #define NUM_CONNECTION_EVENTS 16
@@ -86,7 +87,8 @@ void btif_debug_conn_dump(int fd) {
   dprintf(fd, "\nConnection Events:\n");
   if (connection_events[dump_event].ts == 0) dprintf(fd, "  None\n");
 
-  while (connection_events[dump_event].ts) {
+  bluetooth::shim::DumpsysWriter writer(fd, "  Connection Events");
+  while (connection_events[dump_event].ts && !writer.Expired()) {
     conn_event_t* evt = &connection_events[dump_event];
     dprintf(fd, "  %s %s %s", format_ts(evt->ts, ts_buffer, sizeof(ts_buffer)),
             format_state(evt->state), evt->bda.ToString().c_str());
@@ -78,7 +78,7 @@
 #include "common/metrics.h"
 #include "device/include/controller.h"
 #include "device/include/interop.h"
-#include "gd/common/lru_cache.h"
+#include "gd/common/fixed_lru_cache.h"
 #include "internal_include/stack_config.h"
 #include "main/shim/dumpsys.h"
 #include "main/shim/shim.h"
@@ -214,7 +214,7 @@ typedef struct {
 
 #define MAX_NUM_DEVICES_IN_EIR_UUID_CACHE 128
 
-static bluetooth::common::LruCache<RawAddress, std::set<Uuid>> eir_uuids_cache(
+static bluetooth::common::FixedLruCache<RawAddress, std::set<Uuid>> eir_uuids_cache(
     MAX_NUM_DEVICES_IN_EIR_UUID_CACHE);
 
 static skip_sdp_entry_t sdp_rejectlist[] = {{76}};  // Apple Mouse and Keyboard
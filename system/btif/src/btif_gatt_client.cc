@@ -35,6 +35,8 @@
 #include <hardware/bt_gatt.h>
 
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "bta_api.h"
 #include "bta_gatt_api.h"
@@ -76,6 +78,7 @@ extern const btgatt_callbacks_t* bt_gatt_callbacks;
   do {                                                               \
     if (bt_gatt_callbacks && bt_gatt_callbacks->client->P_CBACK) {   \
       BTIF_TRACE_API("HAL bt_gatt_callbacks->client->%s", #P_CBACK); \
+      btif_gattc_flush_notifications();                              \
       do_in_jni_thread(P_CBACK_WRAP);                                \
     } else {                                                         \
       ASSERTC(0, "Callback is NULL", 0);                             \
@@ -86,6 +89,7 @@ extern const btgatt_callbacks_t* bt_gatt_callbacks;
   do {                                                                         \
     if (bt_gatt_callbacks && bt_gatt_callbacks->client->P_CBACK) {             \
       BTIF_TRACE_API("HAL bt_gatt_callbacks->client->%s", #P_CBACK);           \
+      btif_gattc_flush_notifications();                                        \
       do_in_jni_thread(Bind(bt_gatt_callbacks->client->P_CBACK, __VA_ARGS__)); \
     } else {                                                                   \
       ASSERTC(0, "Callback is NULL", 0);                                       \
@@ -106,6 +110,63 @@ namespace {
 
 uint8_t rssi_request_client_if;
 
+/* Upper bound of the notifications delivered with one notify_batch_cb */
+constexpr size_t kMaxNotifyBatchSize = 16;
+
+struct NotifyBatch {
+  std::vector<btgatt_notify_batch_entry_t> entries;
+  /* conn_id and cid of the indications to confirm once delivered */
+  std::vector<std::pair<uint16_t, uint16_t>> indications;
+};
+
+/* Notifications not yet handed to the JNI thread, only accessed on the main
+ * thread */
+NotifyBatch pending_notify_batch;
+
+void btif_gattc_deliver_notifications(NotifyBatch batch) {
+  HAL_CBACK(bt_gatt_callbacks, client->notify_batch_cb, batch.entries.data(),
+            static_cast<int>(batch.entries.size()));
+  for (const auto& [conn_id, cid] : batch.indications) {
+    BTA_GATTC_SendIndConfirm(conn_id, cid);
+  }
+}
+
+/* Hand the pending notifications to the JNI thread. Called before any other
+ * client callback is posted there, so that the callbacks keep the order in
+ * which the events were received. */
+void btif_gattc_flush_notifications() {
+  if (pending_notify_batch.entries.empty()) return;
+  do_in_jni_thread(FROM_HERE,
+                   base::BindOnce(&btif_gattc_deliver_notifications,
+                                  std::exchange(pending_notify_batch, {})));
+}
+
+/* The first notification of a batch schedules its flush on the main thread,
+ * behind the events already queued there: only the notifications received
+ * back to back are batched, and none waits for more traffic. */
+void btif_gattc_queue_notification(const tBTA_GATTC_NOTIFY& notify) {
+  if (pending_notify_batch.entries.empty()) {
+    do_in_main_thread(FROM_HERE,
+                      base::BindOnce(&btif_gattc_flush_notifications));
+  }
+
+  btgatt_notify_batch_entry_t entry;
+  entry.conn_id = notify.conn_id;
+  entry.params.bda = notify.bda;
+  entry.params.handle = notify.handle;
+  entry.params.is_notify = notify.is_notify;
+  entry.params.len = notify.len;
+  memcpy(entry.params.value, notify.value, notify.len);
+  pending_notify_batch.entries.push_back(entry);
+  if (!notify.is_notify) {
+    pending_notify_batch.indications.emplace_back(notify.conn_id, notify.cid);
+  }
+
+  if (pending_notify_batch.entries.size() >= kMaxNotifyBatchSize) {
+    btif_gattc_flush_notifications();
+  }
+}
+
 std::string bta_gattc_event_text(const tBTA_GATTC_EVT& event) {
   switch (event) {
     case BTA_GATTC_DEREG_EVT:
@@ -253,6 +314,12 @@ static void btif_gattc_upstreams_evt(uint16_t event, char* p_param) {
 static void bta_gattc_cback(tBTA_GATTC_EVT event, tBTA_GATTC* p_data) {
   LOG_DEBUG(" gatt client callback event:%s [%d]",
             gatt_client_event_text(event).c_str(), event);
+  if (event == BTA_GATTC_NOTIF_EVT && bt_gatt_callbacks &&
+      bt_gatt_callbacks->client->notify_batch_cb) {
+    btif_gattc_queue_notification(p_data->notify);
+    return;
+  }
+  btif_gattc_flush_notifications();
   bt_status_t status =
       btif_transfer_context(btif_gattc_upstreams_evt, (uint16_t)event,
                             (char*)p_data, sizeof(tBTA_GATTC), NULL);
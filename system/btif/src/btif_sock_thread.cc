@@ -20,7 +20,7 @@
  *
  *  Filename:      btif_sock_thread.cc
  *
- *  Description:   socket select thread
+ *  Description:   socket epoll thread
  *
  ******************************************************************************/
 
@@ -33,13 +33,12 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <features.h>
-#include <poll.h>
 #include <pthread.h>
 #include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <sys/select.h>
+#include <sys/epoll.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <sys/un.h>
@@ -49,6 +48,7 @@
 #include <mutex>
 #include <optional>
 #include <string>
+#include <unordered_map>
 
 #include "bta_api.h"
 #include "btif_common.h"
@@ -65,11 +65,12 @@
   } while (0)
 
 #define MAX_THREAD 8
-#define MAX_POLL 64
-#define POLL_EXCEPTION_EVENTS (POLLHUP | POLLRDHUP | POLLERR | POLLNVAL)
-#define IS_EXCEPTION(e) ((e)&POLL_EXCEPTION_EVENTS)
-#define IS_READ(e) ((e)&POLLIN)
-#define IS_WRITE(e) ((e)&POLLOUT)
+/* Number of ready fds handled per wake up, not a limit on the fds watched */
+#define MAX_EPOLL_EVENTS 64
+#define EPOLL_EXCEPTION_EVENTS (EPOLLHUP | EPOLLRDHUP | EPOLLERR)
+#define IS_EXCEPTION(e) ((e)&EPOLL_EXCEPTION_EVENTS)
+#define IS_READ(e) ((e)&EPOLLIN)
+#define IS_WRITE(e) ((e)&EPOLLOUT)
 /*cmd executes in socket poll thread */
 #define CMD_WAKEUP 1
 #define CMD_EXIT 2
@@ -78,16 +79,16 @@
 #define CMD_USER_PRIVATE 5
 
 struct poll_slot_t {
-  struct pollfd pfd;
   uint32_t user_id;
   int type;
   int flags;
 };
 struct thread_slot_t {
   int cmd_fdr, cmd_fdw;
-  int poll_count;
-  poll_slot_t ps[MAX_POLL];
-  int psi[MAX_POLL];  // index of poll slot
+  int epoll_fd;
+  /* Watched fds and the signals still expected from them, only touched in the
+   * socket poll thread */
+  std::unordered_map<int, poll_slot_t> poll_slots;
   std::optional<pthread_t> thread_id;
   btsock_signaled_cb callback;
   btsock_cmd_cb cmd_callback;
@@ -98,7 +99,7 @@ static thread_slot_t ts[MAX_THREAD];
 static void* sock_poll_thread(void* arg);
 static inline void close_cmd_fd(int h);
 
-static inline void add_poll(int h, int fd, int type, int flags,
+static inline bool add_poll(int h, int fd, int type, int flags,
                             uint32_t user_id);
 
 static std::recursive_mutex thread_slot_lock;
@@ -145,6 +146,11 @@ static int alloc_thread_slot() {
 static void free_thread_slot(int h) {
   if (0 <= h && h < MAX_THREAD) {
     close_cmd_fd(h);
+    if (ts[h].epoll_fd != -1) {
+      close(ts[h].epoll_fd);
+      ts[h].epoll_fd = -1;
+    }
+    ts[h].poll_slots.clear();
     ts[h].used = 0;
   } else
     APPL_TRACE_ERROR("invalid thread handle:%d", h);
@@ -156,9 +162,9 @@ void btsock_thread_init() {
     int h;
     for (h = 0; h < MAX_THREAD; h++) {
       ts[h].cmd_fdr = ts[h].cmd_fdw = -1;
+      ts[h].epoll_fd = -1;
       ts[h].used = 0;
       ts[h].thread_id = std::nullopt;
-      ts[h].poll_count = 0;
       ts[h].callback = NULL;
       ts[h].cmd_callback = NULL;
     }
@@ -170,6 +176,13 @@ int btsock_thread_create(btsock_signaled_cb callback,
   int h = alloc_thread_slot();
   if (h >= 0) {
     init_poll(h);
+    if (ts[h].epoll_fd == -1 || ts[h].cmd_fdr == -1) {
+      free_thread_slot(h);
+      return -1;
+    }
+    /* The callbacks are read by the socket poll thread as soon as it starts */
+    ts[h].callback = callback;
+    ts[h].cmd_callback = cmd_callback;
     pthread_t thread;
     int status = create_thread(sock_poll_thread, (void*)(uintptr_t)h, &thread);
     if (status) {
@@ -179,21 +192,25 @@ int btsock_thread_create(btsock_signaled_cb callback,
     }
 
     ts[h].thread_id = thread;
-    ts[h].callback = callback;
-    ts[h].cmd_callback = cmd_callback;
   }
   return h;
 }
 
-/* create dummy socket pair used to wake up select loop */
+/* create dummy socket pair used to wake up the poll loop */
 static inline void init_cmd_fd(int h) {
   asrt(ts[h].cmd_fdr == -1 && ts[h].cmd_fdw == -1);
   if (socketpair(AF_UNIX, SOCK_STREAM, 0, &ts[h].cmd_fdr) < 0) {
     APPL_TRACE_ERROR("socketpair failed: %s", strerror(errno));
     return;
   }
-  // add the cmd fd for read & write
-  add_poll(h, ts[h].cmd_fdr, 0, SOCK_THREAD_FD_RD, 0);
+  // the cmd fd is not a poll slot, it is only watched for read
+  struct epoll_event event = {};
+  event.events = EPOLLIN;
+  event.data.fd = ts[h].cmd_fdr;
+  if (epoll_ctl(ts[h].epoll_fd, EPOLL_CTL_ADD, ts[h].cmd_fdr, &event) == -1) {
+    APPL_TRACE_ERROR("epoll_ctl cmd fd failed: %s", strerror(errno));
+    close_cmd_fd(h);
+  }
 }
 static inline void close_cmd_fd(int h) {
   if (ts[h].cmd_fdr != -1) {
@@ -223,12 +240,11 @@ int btsock_thread_add_fd(int h, int fd, int type, int flags, uint32_t user_id) {
     return false;
   }
   if (flags & SOCK_THREAD_ADD_FD_SYNC) {
+    // cleanup one-time flags
+    flags &= ~SOCK_THREAD_ADD_FD_SYNC;
     // must executed in socket poll thread
     if (ts[h].thread_id.value() == pthread_self()) {
-      // cleanup one-time flags
-      flags &= ~SOCK_THREAD_ADD_FD_SYNC;
-      add_poll(h, fd, type, flags, user_id);
-      return true;
+      return add_poll(h, fd, type, flags, user_id);
     }
     LOG_WARN(
         "THREAD_ADD_FD_SYNC is not called in poll thread, fallback to async");
@@ -251,6 +267,8 @@ bool btsock_thread_remove_fd_and_close(int thread_handle, int fd) {
     return false;
   }
 
+  // closed in the socket poll thread, so that the fd is not reused while a
+  // signal of it is handled
   sock_cmd_t cmd = {CMD_REMOVE_FD, fd, 0, 0, 0};
 
   ssize_t ret;
@@ -332,73 +350,83 @@ int btsock_thread_exit(int h) {
   return false;
 }
 static void init_poll(int h) {
-  int i;
-  ts[h].poll_count = 0;
   ts[h].thread_id = std::nullopt;
   ts[h].callback = NULL;
   ts[h].cmd_callback = NULL;
-  for (i = 0; i < MAX_POLL; i++) {
-    ts[h].ps[i].pfd.fd = -1;
-    ts[h].psi[i] = -1;
+  ts[h].poll_slots.clear();
+  ts[h].epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (ts[h].epoll_fd == -1) {
+    APPL_TRACE_ERROR("epoll_create1 failed: %s", strerror(errno));
+    return;
   }
   init_cmd_fd(h);
 }
-static inline unsigned int flags2pevents(int flags) {
-  unsigned int pevents = 0;
-  if (flags & SOCK_THREAD_FD_WR) pevents |= POLLOUT;
-  if (flags & SOCK_THREAD_FD_RD) pevents |= POLLIN;
-  pevents |= POLL_EXCEPTION_EVENTS;
-  return pevents;
+static inline uint32_t flags2events(int flags) {
+  uint32_t events = EPOLL_EXCEPTION_EVENTS;
+  if (flags & SOCK_THREAD_FD_WR) events |= EPOLLOUT;
+  if (flags & SOCK_THREAD_FD_RD) events |= EPOLLIN;
+  return events;
 }
 
-static inline void set_poll(poll_slot_t* ps, int fd, int type, int flags,
+/* Watch |fd| for the signals of |flags|, |op| being EPOLL_CTL_ADD or
+ * EPOLL_CTL_MOD. An fd closed without being removed leaves the epoll set
+ * silently, and a new fd may come with the same number, so fall back to the
+ * other op */
+static bool set_poll(int h, int fd, int flags, int op) {
+  struct epoll_event event = {};
+  event.events = flags2events(flags);
+  event.data.fd = fd;
+  if (epoll_ctl(ts[h].epoll_fd, op, fd, &event) == 0) return true;
+  if (op == EPOLL_CTL_MOD && errno == ENOENT) {
+    op = EPOLL_CTL_ADD;
+  } else if (op == EPOLL_CTL_ADD && errno == EEXIST) {
+    op = EPOLL_CTL_MOD;
+  } else {
+    APPL_TRACE_ERROR("epoll_ctl fd:%d failed: %s", fd, strerror(errno));
+    return false;
+  }
+  if (epoll_ctl(ts[h].epoll_fd, op, fd, &event) == 0) return true;
+  APPL_TRACE_ERROR("epoll_ctl fd:%d failed: %s", fd, strerror(errno));
+  return false;
+}
+static inline bool add_poll(int h, int fd, int type, int flags,
                             uint32_t user_id) {
-  ps->pfd.fd = fd;
-  ps->user_id = user_id;
+  asrt(fd != -1);
+  auto it = ts[h].poll_slots.find(fd);
+  if (it == ts[h].poll_slots.end()) {
+    if (!set_poll(h, fd, flags, EPOLL_CTL_ADD)) return false;
+    ts[h].poll_slots[fd] = {user_id, type, flags};
+    return true;
+  }
+  poll_slot_t* ps = &it->second;
   if (ps->type != 0 && ps->type != type)
     APPL_TRACE_ERROR(
         "poll socket type should not changed! type was:%d, type now:%d",
         ps->type, type);
-  ps->type = type;
-  ps->flags = flags;
-  ps->pfd.events = flags2pevents(flags);
-  ps->pfd.revents = 0;
-}
-static inline void add_poll(int h, int fd, int type, int flags,
-                            uint32_t user_id) {
-  asrt(fd != -1);
-  int i;
-  int empty = -1;
-  poll_slot_t* ps = ts[h].ps;
-
-  for (i = 0; i < MAX_POLL; i++) {
-    if (ps[i].pfd.fd == fd) {
-      asrt(ts[h].poll_count < MAX_POLL);
-
-      set_poll(&ps[i], fd, type, flags | ps[i].flags, user_id);
-      return;
-    } else if (empty < 0 && ps[i].pfd.fd == -1)
-      empty = i;
-  }
-  if (empty >= 0) {
-    asrt(ts[h].poll_count < MAX_POLL);
-    set_poll(&ps[empty], fd, type, flags, user_id);
-    ++ts[h].poll_count;
-    return;
+  if (!set_poll(h, fd, flags | ps->flags, EPOLL_CTL_MOD)) {
+    ts[h].poll_slots.erase(it);
+    return false;
   }
-  APPL_TRACE_ERROR("exceeded max poll slot:%d!", MAX_POLL);
+  ps->user_id = user_id;
+  ps->type = type;
+  ps->flags |= flags;
+  return true;
 }
-static inline void remove_poll(int h, poll_slot_t* ps, int flags) {
-  if (flags == ps->flags) {
+/* Stop watching the signaled |flags| of |fd|, or the fd altogether once it has
+ * no signal left to watch */
+static inline void remove_poll(int h, int fd, int flags) {
+  auto it = ts[h].poll_slots.find(fd);
+  if (it == ts[h].poll_slots.end()) return;
+  poll_slot_t* ps = &it->second;
+  if ((ps->flags & ~flags) == 0) {
     // all monitored events signaled. To remove it, just clear the slot
-    --ts[h].poll_count;
-    memset(ps, 0, sizeof(*ps));
-    ps->pfd.fd = -1;
+    epoll_ctl(ts[h].epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+    ts[h].poll_slots.erase(it);
   } else {
     // one read or one write monitor event signaled, removed the accordding bit
     ps->flags &= ~flags;
     // update the poll events mask
-    ps->pfd.events = flags2pevents(ps->flags);
+    set_poll(h, fd, ps->flags, EPOLL_CTL_MOD);
   }
 }
 static int process_cmd_sock(int h) {
@@ -416,16 +444,14 @@ static int process_cmd_sock(int h) {
     case CMD_ADD_FD:
       add_poll(h, cmd.fd, cmd.type, cmd.flags, cmd.user_id);
       break;
-    case CMD_REMOVE_FD:
-      for (int i = 1; i < MAX_POLL; ++i) {
-        poll_slot_t* poll_slot = &ts[h].ps[i];
-        if (poll_slot->pfd.fd == cmd.fd) {
-          remove_poll(h, poll_slot, poll_slot->flags);
-          break;
-        }
+    case CMD_REMOVE_FD: {
+      auto it = ts[h].poll_slots.find(cmd.fd);
+      if (it != ts[h].poll_slots.end()) {
+        remove_poll(h, cmd.fd, it->second.flags);
       }
       close(cmd.fd);
       break;
+    }
     case CMD_WAKEUP:
       break;
     case CMD_USER_PRIVATE:
@@ -442,94 +468,58 @@ static int process_cmd_sock(int h) {
   return true;
 }
 
-static void process_data_sock(int h, struct pollfd* pfds, int pfds_count,
-                              int event_count) {
-  asrt(event_count <= pfds_count);
-  int i;
-  for (i = 1; i < pfds_count; i++) {
-    if (pfds[i].revents) {
-      int ps_i = ts[h].psi[i];
-      if (ts[h].ps[ps_i].pfd.fd == -1) {
-        LOG_INFO("Socket has been removed from poll set");
-        continue;
-      }
-      asrt(pfds[i].fd == ts[h].ps[ps_i].pfd.fd);
-      uint32_t user_id = ts[h].ps[ps_i].user_id;
-      int type = ts[h].ps[ps_i].type;
-      int flags = 0;
-      if (IS_READ(pfds[i].revents)) {
-        flags |= SOCK_THREAD_FD_RD;
-      }
-      if (IS_WRITE(pfds[i].revents)) {
-        flags |= SOCK_THREAD_FD_WR;
-      }
-      if (IS_EXCEPTION(pfds[i].revents)) {
-        flags |= SOCK_THREAD_FD_EXCEPTION;
-        // remove the whole slot not flags
-        remove_poll(h, &ts[h].ps[ps_i], ts[h].ps[ps_i].flags);
-      } else if (flags)
-        remove_poll(h, &ts[h].ps[ps_i],
-                    flags);  // remove the monitor flags that already processed
-      if (flags) ts[h].callback(pfds[i].fd, type, flags, user_id);
-    }
+static void process_data_sock(int h, int fd, uint32_t events) {
+  auto it = ts[h].poll_slots.find(fd);
+  if (it == ts[h].poll_slots.end()) {
+    LOG_INFO("Socket has been removed from poll set");
+    return;
   }
-}
-
-static void prepare_poll_fds(int h, struct pollfd* pfds) {
-  int count = 0;
-  int ps_i = 0;
-  int pfd_i = 0;
-  asrt(ts[h].poll_count <= MAX_POLL);
-  memset(pfds, 0, sizeof(pfds[0]) * ts[h].poll_count);
-  while (count < ts[h].poll_count) {
-    if (ps_i >= MAX_POLL) {
-      APPL_TRACE_ERROR(
-          "exceed max poll range, ps_i:%d, MAX_POLL:%d, count:%d, "
-          "ts[h].poll_count:%d",
-          ps_i, MAX_POLL, count, ts[h].poll_count);
-      return;
-    }
-    if (ts[h].ps[ps_i].pfd.fd >= 0) {
-      pfds[pfd_i] = ts[h].ps[ps_i].pfd;
-      ts[h].psi[pfd_i] = ps_i;
-      count++;
-      pfd_i++;
-    }
-    ps_i++;
+  poll_slot_t* ps = &it->second;
+  uint32_t user_id = ps->user_id;
+  int type = ps->type;
+  int flags = 0;
+  if (IS_READ(events) && (ps->flags & SOCK_THREAD_FD_RD)) {
+    flags |= SOCK_THREAD_FD_RD;
+  }
+  if (IS_WRITE(events) && (ps->flags & SOCK_THREAD_FD_WR)) {
+    flags |= SOCK_THREAD_FD_WR;
+  }
+  if (IS_EXCEPTION(events)) {
+    flags |= SOCK_THREAD_FD_EXCEPTION;
+    // remove the whole slot not flags
+    remove_poll(h, fd, ps->flags);
+  } else if (flags) {
+    // remove the monitor flags that already processed
+    remove_poll(h, fd, flags);
   }
+  // the fd may be added again from the callback
+  if (flags) ts[h].callback(fd, type, flags, user_id);
 }
+
 static void* sock_poll_thread(void* arg) {
-  struct pollfd pfds[MAX_POLL];
-  memset(pfds, 0, sizeof(pfds));
+  struct epoll_event events[MAX_EPOLL_EVENTS];
   int h = (intptr_t)arg;
   for (;;) {
-    prepare_poll_fds(h, pfds);
     int ret;
-    OSI_NO_INTR(ret = poll(pfds, ts[h].poll_count, -1));
+    OSI_NO_INTR(ret = epoll_wait(ts[h].epoll_fd, events, MAX_EPOLL_EVENTS, -1));
     if (ret == -1) {
-      APPL_TRACE_ERROR("poll ret -1, exit the thread, errno:%d, err:%s", errno,
-                       strerror(errno));
+      APPL_TRACE_ERROR("epoll_wait ret -1, exit the thread, errno:%d, err:%s",
+                       errno, strerror(errno));
       break;
     }
-    if (ret != 0) {
-      int need_process_data_fd = true;
-      int pfds_count = ts[h].poll_count;
-      if (pfds[0].revents)  // cmd fd always is the first one
-      {
-        asrt(pfds[0].fd == ts[h].cmd_fdr);
+    bool exit = false;
+    for (int i = 0; i < ret; i++) {
+      if (events[i].data.fd == ts[h].cmd_fdr) {
         if (!process_cmd_sock(h)) {
           LOG_INFO("h:%d, process_cmd_sock return false, exit...", h);
+          exit = true;
           break;
         }
-        if (ret == 1)
-          need_process_data_fd = false;
-        else
-          ret--;  // exclude the cmd fd
+      } else {
+        process_data_sock(h, events[i].data.fd, events[i].events);
       }
-      if (need_process_data_fd) process_data_sock(h, pfds, pfds_count, ret);
-    } else {
-      LOG_INFO("no data, select ret: %d", ret);
-    };
+    }
+    if (exit) break;
   }
   LOG_INFO("socket poll thread exiting, h:%d", h);
   return 0;
@@ -39,9 +39,15 @@
 #include <string.h>
 #include <time.h>
 
+#include <algorithm>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "bta_csis_api.h"
+#include "bta_gatt_api.h"
 #include "bta_groups.h"
 #include "bta_has_api.h"
 #include "bta_hd_api.h"
@@ -53,6 +59,7 @@
 #include "btif_hd.h"
 #include "btif_hh.h"
 #include "btif_util.h"
+#include "common/time_util.h"
 #include "device/include/controller.h"
 #include "gd/common/init_flags.h"
 #include "osi/include/allocator.h"
@@ -96,6 +103,8 @@ using bluetooth::groups::DeviceGroups;
 #define BTIF_STORAGE_KEY_GATT_CLIENT_SUPPORTED "GattClientSupportedFeatures"
 #define BTIF_STORAGE_KEY_GATT_CLIENT_DB_HASH "GattClientDatabaseHash"
 #define BTIF_STORAGE_KEY_GATT_SERVER_SUPPORTED "GattServerSupportedFeatures"
+#define BTIF_STORAGE_KEY_A2DP_SEP_CAPS_BIN "A2dpSepCapsBin"
+#define BTIF_STORAGE_KEY_HFP_MSBC_SETTINGS "HfpMsbcSettings"
 #define BTIF_STORAGE_DEVICE_GROUP_BIN "DeviceGroupBin"
 #define BTIF_STORAGE_CSIS_AUTOCONNECT "CsisAutoconnect"
 #define BTIF_STORAGE_CSIS_SET_INFO_BIN "CsisSetInfoBin"
@@ -202,6 +211,7 @@ static bt_status_t btif_in_fetch_bonded_ble_device(
     const std::string& remote_bd_addr, int add,
     btif_bonded_devices_t* p_bonded_devices);
 static bt_status_t btif_in_fetch_bonded_device(const std::string& bdstr);
+static bool has_sample_ltk(const RawAddress& bd_addr);
 
 static bool btif_has_ble_keys(const std::string& bdstr);
 
@@ -424,6 +434,259 @@ static int cfg2prop(const RawAddress* remote_bd_addr, bt_property_t* prop) {
   return ret;
 }
 
+/*******************************************************************************
+ *  Remote device property cache
+ ******************************************************************************/
+
+namespace {
+
+// Typed copy of the remote device properties of a bonded device, std::nullopt
+// when the property is not in the config
+struct RemoteDeviceProperties {
+  std::optional<int> timestamp;
+  std::optional<std::string> name;
+  std::optional<std::string> alias;
+  std::optional<int> class_of_device;
+  std::optional<int> device_type;
+  std::optional<std::vector<Uuid>> uuids;
+  std::optional<int> manufacturer;
+  std::optional<int> lmp_version;
+  std::optional<int> lmp_subversion;
+};
+
+// Return true if |type| is kept by RemoteDevicePropertyCache
+bool is_cached_remote_property(bt_property_type_t type) {
+  switch (static_cast<int>(type)) {
+    case BT_PROPERTY_REMOTE_DEVICE_TIMESTAMP:
+    case BT_PROPERTY_BDNAME:
+    case BT_PROPERTY_REMOTE_FRIENDLY_NAME:
+    case BT_PROPERTY_CLASS_OF_DEVICE:
+    case BT_PROPERTY_TYPE_OF_DEVICE:
+    case BT_PROPERTY_UUIDS:
+    case BT_PROPERTY_REMOTE_VERSION_INFO:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Parse a stored UUID list the way cfg2prop() always did
+std::vector<Uuid> parse_uuids(const char* value) {
+  char buffer[1280];
+  strlcpy(buffer, value, sizeof(buffer));
+  Uuid uuids[BT_MAX_NUM_UUIDS];
+  size_t num_uuids = btif_split_uuids_string(buffer, uuids, BT_MAX_NUM_UUIDS);
+  return std::vector<Uuid>(uuids, uuids + num_uuids);
+}
+
+// The config drops what follows a new line in the values it stores
+std::string trim_after_new_line(std::string value) {
+  size_t new_line = value.find('\n');
+  if (new_line != std::string::npos) value.erase(new_line);
+  return value;
+}
+
+// Copy of the remote device properties of the bonded devices, so that reading
+// them does not look them up and parse them in the config every time.
+//
+// The properties of a device are read from the config on first use. Writes go
+// through to the config and update the copy. Any other change of the bonded
+// devices or the adapter in the config, which the config generation tells,
+// makes the copies read again.
+class RemoteDevicePropertyCache {
+ public:
+  // Read |prop| of |bd_addr| from the cache. Return std::nullopt when
+  // |bd_addr| is not bonded, otherwise what cfg2prop() would have returned
+  std::optional<bool> Get(const RawAddress& bd_addr, bt_property_t* prop) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const RemoteDeviceProperties* properties = FindLocked(bd_addr);
+    if (properties == nullptr) return std::nullopt;
+    return CopyToProperty(*properties, prop);
+  }
+
+  // Write |prop| of |bd_addr| to the config with prop2cfg() and to the cache
+  bool Set(const RawAddress& bd_addr, bt_property_t* prop) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    RefreshLocked();
+    uint64_t generation = *generation_;
+    if (!prop2cfg(&bd_addr, prop)) return false;
+
+    auto entry = entries_.find(bd_addr);
+    if (entry == entries_.end() || !entry->second.has_value()) return true;
+    // Every config write of a bonded device changes the generation once, any
+    // other change means someone else wrote the config meanwhile
+    if (btif_config_get_persistent_generation() !=
+        generation + NumConfigWrites(prop->type)) {
+      return true;
+    }
+    generation_ = generation + NumConfigWrites(prop->type);
+    if (!UpdateFromProperty(*prop, &*entry->second)) entry->second.reset();
+    return true;
+  }
+
+ private:
+  // Return the properties of |bd_addr|, nullptr if it is not bonded
+  const RemoteDeviceProperties* FindLocked(const RawAddress& bd_addr) {
+    RefreshLocked();
+    auto entry = entries_.find(bd_addr);
+    if (entry == entries_.end()) return nullptr;
+    if (!entry->second.has_value()) entry->second = Load(bd_addr.ToString());
+    return &*entry->second;
+  }
+
+  // Forget the loaded properties if the config changed since they were read
+  void RefreshLocked() {
+    uint64_t generation = btif_config_get_persistent_generation();
+    if (generation_ == generation) return;
+    generation_ = generation;
+    entries_.clear();
+    for (const RawAddress& bd_addr : btif_config_get_paired_devices()) {
+      entries_.emplace(bd_addr, std::nullopt);
+    }
+  }
+
+  static RemoteDeviceProperties Load(const std::string& bdstr) {
+    RemoteDeviceProperties properties;
+    auto get_int = [&bdstr](const std::string& key) -> std::optional<int> {
+      int value;
+      if (!btif_config_get_int(bdstr, key, &value)) return std::nullopt;
+      return value;
+    };
+    char value[1280];
+    auto get_str =
+        [&bdstr, &value](const std::string& key) -> std::optional<std::string> {
+      int size = sizeof(value);
+      if (!btif_config_get_str(bdstr, key, value, &size)) return std::nullopt;
+      return std::string(value, size - 1);
+    };
+    properties.timestamp = get_int(BTIF_STORAGE_PATH_REMOTE_DEVTIME);
+    properties.name = get_str(BTIF_STORAGE_PATH_REMOTE_NAME);
+    properties.alias = get_str(BTIF_STORAGE_PATH_REMOTE_ALIASE);
+    properties.class_of_device = get_int(BTIF_STORAGE_PATH_REMOTE_DEVCLASS);
+    properties.device_type = get_int(BTIF_STORAGE_PATH_REMOTE_DEVTYPE);
+    auto uuids = get_str(BTIF_STORAGE_PATH_REMOTE_SERVICE);
+    if (uuids.has_value()) properties.uuids = parse_uuids(uuids->c_str());
+    properties.manufacturer = get_int(BT_CONFIG_KEY_REMOTE_VER_MFCT);
+    properties.lmp_version = get_int(BT_CONFIG_KEY_REMOTE_VER_VER);
+    properties.lmp_subversion = get_int(BT_CONFIG_KEY_REMOTE_VER_SUBVER);
+    return properties;
+  }
+
+  static bool CopyToProperty(const RemoteDeviceProperties& properties,
+                             bt_property_t* prop) {
+    auto copy_int = [prop](const std::optional<int>& value) {
+      if (prop->len < (int)sizeof(int) || !value.has_value()) return false;
+      *(int*)prop->val = *value;
+      return true;
+    };
+    auto copy_str = [prop](const std::optional<std::string>& value) {
+      if (!value.has_value()) {
+        prop->len = 0;
+        return false;
+      }
+      size_t len = std::min(value->size(), (size_t)prop->len - 1);
+      memcpy(prop->val, value->data(), len);
+      ((char*)prop->val)[len] = '\0';
+      prop->len = len;
+      return true;
+    };
+    switch (static_cast<int>(prop->type)) {
+      case BT_PROPERTY_REMOTE_DEVICE_TIMESTAMP:
+        return copy_int(properties.timestamp);
+      case BT_PROPERTY_BDNAME:
+        return copy_str(properties.name);
+      case BT_PROPERTY_REMOTE_FRIENDLY_NAME:
+        return copy_str(properties.alias);
+      case BT_PROPERTY_CLASS_OF_DEVICE:
+        return copy_int(properties.class_of_device);
+      case BT_PROPERTY_TYPE_OF_DEVICE:
+        return copy_int(properties.device_type);
+      case BT_PROPERTY_UUIDS:
+        if (!properties.uuids.has_value()) {
+          prop->val = NULL;
+          prop->len = 0;
+          return false;
+        }
+        std::copy(properties.uuids->begin(), properties.uuids->end(),
+                  reinterpret_cast<Uuid*>(prop->val));
+        prop->len = properties.uuids->size() * sizeof(Uuid);
+        return true;
+      case BT_PROPERTY_REMOTE_VERSION_INFO: {
+        if (prop->len < (int)sizeof(bt_remote_version_t)) return false;
+        bt_remote_version_t* info = (bt_remote_version_t*)prop->val;
+        if (!properties.manufacturer.has_value()) return false;
+        info->manufacturer = *properties.manufacturer;
+        if (!properties.lmp_version.has_value()) return false;
+        info->version = *properties.lmp_version;
+        if (!properties.lmp_subversion.has_value()) return false;
+        info->sub_ver = *properties.lmp_subversion;
+        return true;
+      }
+      default:
+        return false;
+    }
+  }
+
+  // Number of values prop2cfg() writes for a property of type |type|
+  static uint64_t NumConfigWrites(bt_property_type_t type) {
+    return type == BT_PROPERTY_REMOTE_VERSION_INFO ? 3 : 1;
+  }
+
+  // Apply the write of |prop| by prop2cfg() to |properties|. Return false if
+  // the value written is not known here, so that the device is read again
+  static bool UpdateFromProperty(const bt_property_t& prop,
+                                 RemoteDeviceProperties* properties) {
+    switch (static_cast<int>(prop.type)) {
+      case BT_PROPERTY_BDNAME:
+        properties->name = trim_after_new_line(std::string(
+            (char*)prop.val,
+            strnlen((char*)prop.val,
+                    std::min(prop.len, (int)BTM_MAX_LOC_BD_NAME_LEN))));
+        return true;
+      case BT_PROPERTY_REMOTE_FRIENDLY_NAME:
+        properties->alias = trim_after_new_line(
+            std::string((char*)prop.val, strnlen((char*)prop.val, prop.len)));
+        return true;
+      case BT_PROPERTY_CLASS_OF_DEVICE:
+        properties->class_of_device = *(int*)prop.val;
+        return true;
+      case BT_PROPERTY_TYPE_OF_DEVICE:
+        properties->device_type = *(int*)prop.val;
+        return true;
+      case BT_PROPERTY_UUIDS: {
+        std::string value;
+        size_t cnt = prop.len / sizeof(Uuid);
+        for (size_t i = 0; i < cnt; i++) {
+          value += (reinterpret_cast<Uuid*>(prop.val) + i)->ToString() + " ";
+        }
+        properties->uuids = parse_uuids(value.c_str());
+        return true;
+      }
+      case BT_PROPERTY_REMOTE_VERSION_INFO: {
+        bt_remote_version_t* info = (bt_remote_version_t*)prop.val;
+        properties->manufacturer = info->manufacturer;
+        properties->lmp_version = info->version;
+        properties->lmp_subversion = info->sub_ver;
+        return true;
+      }
+      default:
+        // The timestamp is taken by prop2cfg()
+        return false;
+    }
+  }
+
+  std::mutex mutex_;
+  // Config generation the entries were listed at
+  std::optional<uint64_t> generation_;
+  // Bonded devices, with their properties once they are loaded
+  std::unordered_map<RawAddress, std::optional<RemoteDeviceProperties>>
+      entries_;
+};
+
+RemoteDevicePropertyCache remote_device_property_cache;
+
+}  // namespace
+
 /*******************************************************************************
  *
  * Function         btif_in_fetch_bonded_devices
@@ -466,7 +729,8 @@ static bt_status_t btif_in_fetch_bonded_device(const std::string& bdstr) {
  *
  ******************************************************************************/
 static bt_status_t btif_in_fetch_bonded_devices(
-    btif_bonded_devices_t* p_bonded_devices, int add) {
+    btif_bonded_devices_t* p_bonded_devices, int add,
+    std::vector<RawAddress>* p_sample_ltk_devices = nullptr) {
   memset(p_bonded_devices, 0, sizeof(btif_bonded_devices_t));
 
   bool bt_linkkey_file_found = false;
@@ -476,6 +740,11 @@ static bt_status_t btif_in_fetch_bonded_devices(
     auto name = bd_addr.ToString();
 
     BTIF_TRACE_DEBUG("Remote device:%s", name.c_str());
+    if (p_sample_ltk_devices != nullptr && has_sample_ltk(bd_addr)) {
+      p_sample_ltk_devices->push_back(bd_addr);
+      continue;
+    }
+
     LinkKey link_key;
     size_t size = sizeof(link_key);
     if (btif_config_get_bin(name, "LinkKey", link_key.data(), &size)) {
@@ -780,6 +1049,12 @@ bt_status_t btif_storage_set_adapter_property(bt_property_t* property) {
  ******************************************************************************/
 bt_status_t btif_storage_get_remote_device_property(
     const RawAddress* remote_bd_addr, bt_property_t* property) {
+  if (remote_bd_addr != nullptr && property->len > 0 &&
+      is_cached_remote_property(property->type)) {
+    std::optional<bool> ret =
+        remote_device_property_cache.Get(*remote_bd_addr, property);
+    if (ret.has_value()) return *ret ? BT_STATUS_SUCCESS : BT_STATUS_FAIL;
+  }
   return cfg2prop(remote_bd_addr, property) ? BT_STATUS_SUCCESS
                                             : BT_STATUS_FAIL;
 }
@@ -796,6 +1071,11 @@ bt_status_t btif_storage_get_remote_device_property(
  ******************************************************************************/
 bt_status_t btif_storage_set_remote_device_property(
     const RawAddress* remote_bd_addr, bt_property_t* property) {
+  if (remote_bd_addr != nullptr && is_cached_remote_property(property->type)) {
+    return remote_device_property_cache.Set(*remote_bd_addr, property)
+               ? BT_STATUS_SUCCESS
+               : BT_STATUS_FAIL;
+  }
   return prop2cfg(remote_bd_addr, property) ? BT_STATUS_SUCCESS
                                             : BT_STATUS_FAIL;
 }
@@ -904,6 +1184,12 @@ bt_status_t btif_storage_remove_bonded_device(
   if (btif_config_exist(bdstr, BTIF_STORAGE_KEY_GATT_SERVER_SUPPORTED)) {
     ret &= btif_config_remove(bdstr, BTIF_STORAGE_KEY_GATT_SERVER_SUPPORTED);
   }
+  if (btif_config_exist(bdstr, BTIF_STORAGE_KEY_A2DP_SEP_CAPS_BIN)) {
+    ret &= btif_config_remove(bdstr, BTIF_STORAGE_KEY_A2DP_SEP_CAPS_BIN);
+  }
+  if (btif_config_exist(bdstr, BTIF_STORAGE_KEY_HFP_MSBC_SETTINGS)) {
+    ret &= btif_config_remove(bdstr, BTIF_STORAGE_KEY_HFP_MSBC_SETTINGS);
+  }
 
   /* write bonded info immediately */
   btif_config_flush();
@@ -925,23 +1211,19 @@ bt_status_t btif_storage_remove_bonded_device(
  * We still allow such devices to bond in order to give the user a chance to
  * update firmware.
  */
-static void remove_devices_with_sample_ltk() {
-  std::vector<RawAddress> bad_ltk;
-  for (const auto& bd_addr : btif_config_get_paired_devices()) {
-    auto name = bd_addr.ToString();
-
-    tBTA_LE_KEY_VALUE key;
-    memset(&key, 0, sizeof(key));
+static bool has_sample_ltk(const RawAddress& bd_addr) {
+  tBTA_LE_KEY_VALUE key;
+  memset(&key, 0, sizeof(key));
 
-    if (btif_storage_get_ble_bonding_key(
-            bd_addr, BTM_LE_KEY_PENC, (uint8_t*)&key,
-            sizeof(tBTM_LE_PENC_KEYS)) == BT_STATUS_SUCCESS) {
-      if (is_sample_ltk(key.penc_key.ltk)) {
-        bad_ltk.push_back(bd_addr);
-      }
-    }
-  }
+  return btif_storage_get_ble_bonding_key(bd_addr, BTM_LE_KEY_PENC,
+                                          (uint8_t*)&key,
+                                          sizeof(tBTM_LE_PENC_KEYS)) ==
+             BT_STATUS_SUCCESS &&
+         is_sample_ltk(key.penc_key.ltk);
+}
 
+static void remove_devices_with_sample_ltk(
+    const std::vector<RawAddress>& bad_ltk) {
   for (RawAddress address : bad_ltk) {
     android_errorWriteLog(0x534e4554, "128437297");
     LOG(ERROR) << __func__
@@ -951,6 +1233,30 @@ static void remove_devices_with_sample_ltk() {
   }
 }
 
+/* Bonded devices added to the stack by the last btif_in_load_bonded_devices().
+ * At enable, both btif_storage_load_le_devices() and
+ * btif_storage_load_bonded_devices() need them: the keys are read from NVRAM
+ * and handed to the stack only once, by the first of the two.
+ */
+static btif_bonded_devices_t loaded_bonded_devices;
+static bool bonded_devices_loaded = false;
+
+static void btif_in_load_bonded_devices(
+    btif_bonded_devices_t* p_bonded_devices) {
+  if (!bonded_devices_loaded) {
+    uint64_t start_ms = bluetooth::common::time_get_os_boottime_ms();
+    std::vector<RawAddress> bad_ltk;
+    btif_in_fetch_bonded_devices(&loaded_bonded_devices, 1, &bad_ltk);
+    remove_devices_with_sample_ltk(bad_ltk);
+    bonded_devices_loaded = true;
+    LOG_INFO("Loaded the keys of %u bonded devices in %llu ms",
+             loaded_bonded_devices.num_devices,
+             (unsigned long long)(bluetooth::common::time_get_os_boottime_ms() -
+                                  start_ms));
+  }
+  *p_bonded_devices = loaded_bonded_devices;
+}
+
 /*******************************************************************************
  *
  * Function         btif_storage_load_le_devices
@@ -965,7 +1271,7 @@ static void remove_devices_with_sample_ltk() {
  ******************************************************************************/
 void btif_storage_load_le_devices(void) {
   btif_bonded_devices_t bonded_devices;
-  btif_in_fetch_bonded_devices(&bonded_devices, 1);
+  btif_in_load_bonded_devices(&bonded_devices);
   std::unordered_set<RawAddress> bonded_addresses;
   for (uint16_t i = 0; i < bonded_devices.num_devices; i++) {
     bonded_addresses.insert(bonded_devices.devices[i]);
@@ -1048,9 +1354,14 @@ bt_status_t btif_storage_load_bonded_devices(void) {
   Uuid remote_uuids[BT_MAX_NUM_UUIDS];
   bt_status_t status;
 
-  remove_devices_with_sample_ltk();
+  btif_in_load_bonded_devices(&bonded_devices);
+  /* The next enable reads them again */
+  bonded_devices_loaded = false;
 
-  btif_in_fetch_bonded_devices(&bonded_devices, 1);
+  /* Read the GATT databases of LE devices before they get connected */
+  BTA_GATTC_WarmupCache(std::vector<RawAddress>(
+      bonded_devices.devices,
+      bonded_devices.devices + bonded_devices.num_devices));
 
   /* Now send the adapter_properties_cb with all adapter_properties */
   {
@@ -2515,6 +2826,79 @@ void btif_storage_remove_gatt_cl_db_hash(const RawAddress& bd_addr) {
                        bd_addr));
 }
 
+/** Store the SEPs of an A2DP peer and their capabilities */
+void btif_storage_set_a2dp_sep_caps(const RawAddress& bd_addr,
+                                    std::vector<uint8_t> caps) {
+  do_in_jni_thread(
+      FROM_HERE,
+      Bind(
+          [](const RawAddress& bd_addr, std::vector<uint8_t> caps) {
+            auto bdstr = bd_addr.ToString();
+            btif_config_set_bin(bdstr, BTIF_STORAGE_KEY_A2DP_SEP_CAPS_BIN,
+                                caps.data(), caps.size());
+            btif_config_save();
+          },
+          bd_addr, std::move(caps)));
+}
+
+/** Get the stored SEPs of an A2DP peer and their capabilities */
+std::vector<uint8_t> btif_storage_get_a2dp_sep_caps(const RawAddress& bd_addr) {
+  auto bdstr = bd_addr.ToString();
+
+  size_t size =
+      btif_config_get_bin_length(bdstr, BTIF_STORAGE_KEY_A2DP_SEP_CAPS_BIN);
+  std::vector<uint8_t> caps(size);
+  if (size == 0 ||
+      !btif_config_get_bin(bdstr, BTIF_STORAGE_KEY_A2DP_SEP_CAPS_BIN,
+                           caps.data(), &size)) {
+    return {};
+  }
+  caps.resize(size);
+  return caps;
+}
+
+/** Remove the stored SEPs of an A2DP peer and their capabilities */
+void btif_storage_remove_a2dp_sep_caps(const RawAddress& bd_addr) {
+  do_in_jni_thread(
+      FROM_HERE,
+      Bind(
+          [](const RawAddress& bd_addr) {
+            auto bdstr = bd_addr.ToString();
+            if (btif_config_exist(bdstr, BTIF_STORAGE_KEY_A2DP_SEP_CAPS_BIN)) {
+              btif_config_remove(bdstr, BTIF_STORAGE_KEY_A2DP_SEP_CAPS_BIN);
+              btif_config_save();
+            }
+          },
+          bd_addr));
+}
+
+/** Store the mSBC eSCO settings the last HFP audio connection opened with */
+void btif_storage_set_hfp_msbc_settings(const RawAddress& bd_addr,
+                                        uint8_t settings) {
+  do_in_jni_thread(
+      FROM_HERE, Bind(
+                     [](const RawAddress& bd_addr, uint8_t settings) {
+                       auto bdstr = bd_addr.ToString();
+                       btif_config_set_int(bdstr,
+                                           BTIF_STORAGE_KEY_HFP_MSBC_SETTINGS,
+                                           settings);
+                       btif_config_save();
+                     },
+                     bd_addr, settings));
+}
+
+/** Get the stored mSBC eSCO settings of an HFP peer */
+bool btif_storage_get_hfp_msbc_settings(const RawAddress& bd_addr,
+                                        uint8_t* settings) {
+  int value;
+  if (!btif_config_get_int(bd_addr.ToString(),
+                           BTIF_STORAGE_KEY_HFP_MSBC_SETTINGS, &value)) {
+    return false;
+  }
+  *settings = (uint8_t)value;
+  return true;
+}
+
 void btif_debug_linkkey_type_dump(int fd) {
   dprintf(fd, "\nLink Key Types:\n");
   for (const auto& bd_addr : btif_config_get_paired_devices()) {
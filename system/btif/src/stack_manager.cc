@@ -29,6 +29,7 @@
 #include "btif_api.h"
 #include "btif_common.h"
 #include "common/message_loop_thread.h"
+#include "common/startup_trace.h"
 #include "main/shim/shim.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
@@ -124,6 +125,9 @@ void BTA_dm_on_hw_on();
 void BTA_dm_on_hw_off();
 
 using bluetooth::common::MessageLoopThread;
+using bluetooth::common::ScopedStartupPhase;
+using bluetooth::common::StartupPhaseType;
+using bluetooth::common::StartupTrace;
 
 static MessageLoopThread management_thread("bt_stack_manager_thread");
 
@@ -278,6 +282,7 @@ static void event_start_up_stack(UNUSED_ATTR void* context) {
     return;
   }
 
+  StartupTrace::GetInstance().Begin();
   ensure_stack_is_initialized();
 
   LOG_INFO("%s is bringing up the stack", __func__);
@@ -286,55 +291,75 @@ static void event_start_up_stack(UNUSED_ATTR void* context) {
 
   LOG_INFO("%s Gd shim module enabled", __func__);
   module_shut_down(get_local_module(GD_IDLE_MODULE));
-  get_btm_client_interface().lifecycle.btm_init();
+  {
+    ScopedStartupPhase phase(StartupPhaseType::STACK, "btm_init");
+    get_btm_client_interface().lifecycle.btm_init();
+  }
   module_start_up(get_local_module(GD_SHIM_MODULE));
   module_start_up(get_local_module(BTIF_CONFIG_MODULE));
 
-  l2c_init();
-  sdp_init();
-  gatt_init();
-  SMP_Init();
-  get_btm_client_interface().lifecycle.btm_ble_init();
+  {
+    ScopedStartupPhase phase(StartupPhaseType::STACK, "stack protocols init");
+    l2c_init();
+    sdp_init();
+    gatt_init();
+    SMP_Init();
+    get_btm_client_interface().lifecycle.btm_ble_init();
 
-  RFCOMM_Init();
+    RFCOMM_Init();
 #if (BNEP_INCLUDED == TRUE)
-  BNEP_Init();
+    BNEP_Init();
 #if (PAN_INCLUDED == TRUE)
-  PAN_Init();
+    PAN_Init();
 #endif /* PAN */
 #endif /* BNEP Included */
-  A2DP_Init();
-  AVRC_Init();
-  GAP_Init();
+    A2DP_Init();
+    AVRC_Init();
+    GAP_Init();
 #if (HID_HOST_INCLUDED == TRUE)
-  HID_HostInit();
+    HID_HostInit();
 #endif
+  }
 
-  bta_sys_init();
-  bta_ar_init();
+  {
+    ScopedStartupPhase phase(StartupPhaseType::STACK, "bta init");
+    bta_sys_init();
+    bta_ar_init();
+  }
   module_init(get_local_module(BTE_LOGMSG_MODULE));
 
-  main_thread_start_up();
+  {
+    ScopedStartupPhase phase(StartupPhaseType::STACK, "main thread start up");
+    main_thread_start_up();
+  }
 
-  btif_init_ok();
-  BTA_dm_init();
-  bta_dm_enable(bte_dm_evt);
+  {
+    ScopedStartupPhase phase(StartupPhaseType::STACK, "bta dm enable");
+    btif_init_ok();
+    BTA_dm_init();
+    bta_dm_enable(bte_dm_evt);
+  }
 
   bta_set_forward_hw_failures(true);
   btm_acl_device_down();
   CHECK(module_start_up(get_local_module(GD_CONTROLLER_MODULE)));
-  BTM_reset_complete();
+  {
+    ScopedStartupPhase phase(StartupPhaseType::STACK, "reset complete");
+    BTM_reset_complete();
 
-  BTA_dm_on_hw_on();
+    BTA_dm_on_hw_on();
+  }
 
   if (future_await(local_hack_future) != FUTURE_SUCCESS) {
     LOG_ERROR("%s failed to start up the stack", __func__);
+    StartupTrace::GetInstance().End(false);
     stack_is_running = true;  // So stack shutdown actually happens
     event_shut_down_stack(nullptr);
     return;
   }
 
   stack_is_running = true;
+  StartupTrace::GetInstance().End(true);
   LOG_INFO("%s finished", __func__);
   do_in_jni_thread(FROM_HERE, base::Bind(event_signal_stack_up, nullptr));
 }
@@ -0,0 +1,201 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+#include "btif/include/btif_a2dp_sink_jitter_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+namespace {
+
+constexpr uint32_t kSampleRate = 48000;
+constexpr uint64_t kMinDelayUs = 40000;
+constexpr uint64_t kMaxDelayUs = 200000;
+
+// 10 ms packets, played every 20 ms
+constexpr uint32_t kPacketFrames = 480;
+constexpr uint64_t kPacketUs = 10000;
+constexpr uint64_t kTickUs = 20000;
+
+// Each frame holds its own timestamp, to check what is played
+void push_packet(A2dpSinkJitterBuffer* jb, uint32_t timestamp,
+                 uint64_t arrival_us, uint32_t frames = kPacketFrames) {
+  std::vector<uint32_t> pcm(frames);
+  for (uint32_t i = 0; i < frames; i++) pcm[i] = timestamp + i;
+  jb->OnPacket(timestamp, arrival_us);
+  jb->Push(reinterpret_cast<const uint8_t*>(pcm.data()),
+           pcm.size() * sizeof(uint32_t));
+}
+
+std::vector<uint32_t> pull(A2dpSinkJitterBuffer* jb, uint64_t now_us) {
+  std::vector<uint8_t> out;
+  size_t frames = jb->Pull(now_us, &out);
+  EXPECT_EQ(out.size(), frames * sizeof(uint32_t));
+  std::vector<uint32_t> pcm(frames);
+  if (frames > 0) memcpy(pcm.data(), out.data(), out.size());
+  return pcm;
+}
+
+void start(A2dpSinkJitterBuffer* jb) {
+  jb->Start(kSampleRate, sizeof(uint32_t), kMinDelayUs, kMaxDelayUs);
+}
+
+TEST(A2dpSinkJitterBufferTest, playout_starts_at_the_target_delay) {
+  A2dpSinkJitterBuffer jb;
+  start(&jb);
+  uint64_t now_us = 0;
+  for (uint32_t i = 0; i < 3; i++) {
+    push_packet(&jb, i * kPacketFrames, now_us);
+    EXPECT_TRUE(pull(&jb, now_us).empty());
+    now_us += kPacketUs;
+  }
+  EXPECT_FALSE(jb.IsPlaying());
+
+  push_packet(&jb, 3 * kPacketFrames, now_us);
+  EXPECT_EQ(jb.TargetUs(), kMinDelayUs);
+  EXPECT_TRUE(pull(&jb, now_us).empty());
+  EXPECT_TRUE(jb.IsPlaying());
+
+  // Played in order at the rate of the local clock
+  std::vector<uint32_t> pcm = pull(&jb, now_us + kTickUs);
+  ASSERT_EQ(pcm.size(), 2 * kPacketFrames);
+  for (uint32_t i = 0; i < pcm.size(); i++) EXPECT_EQ(pcm[i], i);
+  EXPECT_EQ(jb.DepthUs(), 2 * kPacketUs);
+}
+
+TEST(A2dpSinkJitterBufferTest, lost_audio_is_concealed) {
+  A2dpSinkJitterBuffer jb;
+  start(&jb);
+  push_packet(&jb, 0, 0);
+  // The second packet is lost
+  push_packet(&jb, 2 * kPacketFrames, 2 * kPacketUs);
+  EXPECT_EQ(jb.stats.concealed_frames, kPacketFrames);
+  EXPECT_EQ(jb.DepthFrames(), 3 * kPacketFrames);
+  push_packet(&jb, 3 * kPacketFrames, 3 * kPacketUs);
+
+  EXPECT_TRUE(pull(&jb, 3 * kPacketUs).empty());
+  std::vector<uint32_t> pcm = pull(&jb, 3 * kPacketUs + 3 * kPacketUs);
+  ASSERT_EQ(pcm.size(), 3 * kPacketFrames);
+  EXPECT_EQ(pcm[kPacketFrames - 1], kPacketFrames - 1);
+  EXPECT_EQ(pcm[kPacketFrames], 0u);
+  EXPECT_EQ(pcm[2 * kPacketFrames - 1], 0u);
+  EXPECT_EQ(pcm[2 * kPacketFrames], 2 * kPacketFrames);
+}
+
+TEST(A2dpSinkJitterBufferTest, late_audio_is_dropped) {
+  A2dpSinkJitterBuffer jb;
+  start(&jb);
+  uint64_t now_us = 0;
+  uint32_t timestamp = 0;
+  for (; timestamp < 4 * kPacketFrames; timestamp += kPacketFrames) {
+    push_packet(&jb, timestamp, now_us);
+    now_us += kPacketUs;
+  }
+  pull(&jb, now_us);
+  ASSERT_TRUE(jb.IsPlaying());
+
+  // The link stalls for 60 ms: the last 20 ms are played as silence
+  std::vector<uint32_t> pcm = pull(&jb, now_us + 3 * kTickUs);
+  ASSERT_EQ(pcm.size(), 6 * kPacketFrames);
+  EXPECT_EQ(pcm[4 * kPacketFrames], 0u);
+  EXPECT_EQ(jb.stats.underruns, 1u);
+  EXPECT_EQ(jb.stats.concealed_frames, 2 * kPacketFrames);
+
+  // The audio received during the stall is past its playout time
+  for (int i = 0; i < 3; i++) {
+    push_packet(&jb, timestamp, now_us + 3 * kTickUs);
+    timestamp += kPacketFrames;
+  }
+  EXPECT_EQ(jb.stats.late_packets, 2u);
+  EXPECT_EQ(jb.stats.dropped_frames, 2 * kPacketFrames);
+  EXPECT_EQ(jb.DepthFrames(), kPacketFrames);
+  pcm = pull(&jb, now_us + 3 * kTickUs + kPacketUs);
+  ASSERT_EQ(pcm.size(), kPacketFrames);
+  EXPECT_EQ(pcm[0], timestamp - kPacketFrames);
+}
+
+TEST(A2dpSinkJitterBufferTest, target_delay_follows_the_jitter) {
+  A2dpSinkJitterBuffer jb;
+  start(&jb);
+  uint64_t now_us = 0;
+  for (uint32_t i = 0; i < 100; i++) {
+    // The packets arrive in bursts of 4
+    if (i % 4 == 0) now_us += 4 * kPacketUs;
+    push_packet(&jb, i * kPacketFrames, now_us);
+  }
+  EXPECT_GT(jb.JitterUs(), kPacketUs);
+  EXPECT_GT(jb.TargetUs(), kMinDelayUs);
+  EXPECT_LE(jb.TargetUs(), kMaxDelayUs);
+}
+
+TEST(A2dpSinkJitterBufferTest, clock_drift_is_compensated) {
+  for (int64_t drift_ppm : {-2000, 2000}) {
+    A2dpSinkJitterBuffer jb;
+    start(&jb);
+    // The packets of the peer are produced at its own clock rate
+    uint64_t packet_us = kPacketUs * (1000000 - drift_ppm) / 1000000;
+    uint64_t arrival_us = 0;
+    uint32_t timestamp = 0;
+    for (uint64_t now_us = 0; now_us < 60000000; now_us += kTickUs) {
+      while (arrival_us <= now_us) {
+        push_packet(&jb, timestamp, arrival_us);
+        timestamp += kPacketFrames;
+        arrival_us += packet_us;
+      }
+      pull(&jb, now_us);
+    }
+    EXPECT_EQ(jb.stats.underruns, 0u);
+    EXPECT_EQ(jb.stats.dropped_frames, 0u);
+    EXPECT_LT(jb.DepthUs(), jb.TargetUs() + 2 * kTickUs);
+    EXPECT_GT(jb.DepthUs() + 2 * kTickUs, jb.TargetUs());
+    if (drift_ppm > 0) {
+      EXPECT_GT(jb.stats.skipped_frames, 0u);
+    } else {
+      EXPECT_GT(jb.stats.repeated_frames, 0u);
+    }
+  }
+}
+
+TEST(A2dpSinkJitterBufferTest, playout_restarts_after_discontinuities) {
+  A2dpSinkJitterBuffer jb;
+  start(&jb);
+  for (uint32_t i = 0; i < 4; i++) push_packet(&jb, i * kPacketFrames, 0);
+  pull(&jb, 0);
+  ASSERT_TRUE(jb.IsPlaying());
+
+  // Timestamp jump
+  push_packet(&jb, 1000000, 0);
+  EXPECT_EQ(jb.stats.resyncs, 1u);
+  EXPECT_FALSE(jb.IsPlaying());
+  EXPECT_EQ(jb.DepthFrames(), kPacketFrames);
+
+  // The stream stops for longer than the max. delay
+  for (uint32_t i = 1; i < 4; i++)
+    push_packet(&jb, 1000000 + i * kPacketFrames, 0);
+  pull(&jb, 0);
+  ASSERT_TRUE(jb.IsPlaying());
+  pull(&jb, kMaxDelayUs + 4 * kPacketUs);
+  EXPECT_FALSE(jb.IsPlaying());
+
+  // Restarted with the next packet, whatever its timestamp
+  push_packet(&jb, 1000000 + 4 * kPacketFrames, kMaxDelayUs);
+  EXPECT_EQ(jb.stats.late_packets, 0u);
+  EXPECT_EQ(jb.DepthFrames(), kPacketFrames);
+}
+
+}  // namespace
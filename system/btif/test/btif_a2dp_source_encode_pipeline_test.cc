@@ -0,0 +1,151 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+#include "btif/include/btif_a2dp_source_encode_pipeline.h"
+
+#include <base/bind.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <future>
+#include <thread>
+
+#include "common/time_util.h"
+#include "types/raw_address.h"
+
+namespace {
+
+const RawAddress kPeer1({0x11, 0x22, 0x33, 0x44, 0x55, 0x66});
+const RawAddress kPeer2({0x11, 0x22, 0x33, 0x44, 0x55, 0x77});
+const RawAddress kPeer3({0x11, 0x22, 0x33, 0x44, 0x55, 0x88});
+
+constexpr uint64_t kFarDeadlineUs = UINT64_MAX;
+
+class A2dpEncodePipelineTest : public ::testing::Test {
+ protected:
+  void SetUp() override { ASSERT_TRUE(pipeline_.StartUp(false)); }
+  void TearDown() override { pipeline_.ShutDown(); }
+
+  A2dpEncodePipeline pipeline_{2};
+};
+
+TEST_F(A2dpEncodePipelineTest, peers_are_spread_across_workers) {
+  EXPECT_EQ(pipeline_.AddPeer(kPeer1), 0u);
+  EXPECT_EQ(pipeline_.AddPeer(kPeer2), 1u);
+  EXPECT_EQ(pipeline_.AddPeer(kPeer1), 0u);
+  EXPECT_EQ(pipeline_.WorkerOf(kPeer2), 1);
+
+  pipeline_.RemovePeer(kPeer1);
+  EXPECT_EQ(pipeline_.WorkerOf(kPeer1), -1);
+  EXPECT_EQ(pipeline_.AddPeer(kPeer3), 0u);
+}
+
+TEST_F(A2dpEncodePipelineTest, jobs_of_different_peers_run_in_parallel) {
+  pipeline_.AddPeer(kPeer1);
+  pipeline_.AddPeer(kPeer2);
+
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+  std::promise<std::thread::id> peer1_thread, peer2_thread;
+  auto peer2_done = peer2_thread.get_future();
+  auto peer1_done = peer1_thread.get_future();
+
+  // The job of the first peer blocks its worker until the job of the second
+  // one has run.
+  EXPECT_TRUE(pipeline_.Submit(
+      kPeer1, kFarDeadlineUs,
+      base::BindOnce(
+          [](std::shared_future<void> released,
+             std::promise<std::thread::id>* p) {
+            released.wait();
+            p->set_value(std::this_thread::get_id());
+          },
+          released, &peer1_thread)));
+  EXPECT_TRUE(pipeline_.Submit(
+      kPeer2, kFarDeadlineUs,
+      base::BindOnce(
+          [](std::promise<std::thread::id>* p) {
+            p->set_value(std::this_thread::get_id());
+          },
+          &peer2_thread)));
+
+  std::thread::id peer2_id = peer2_done.get();
+  release.set_value();
+  EXPECT_NE(peer1_done.get(), peer2_id);
+}
+
+TEST_F(A2dpEncodePipelineTest, tick_is_skipped_while_job_is_pending) {
+  pipeline_.AddPeer(kPeer1);
+
+  std::promise<void> release;
+  std::shared_future<void> released = release.get_future().share();
+  std::atomic<int> runs(0);
+  auto job = [](std::shared_future<void> released, std::atomic<int>* runs) {
+    released.wait();
+    (*runs)++;
+  };
+
+  EXPECT_TRUE(pipeline_.Submit(kPeer1, kFarDeadlineUs,
+                               base::BindOnce(job, released, &runs)));
+  EXPECT_FALSE(pipeline_.Submit(kPeer1, kFarDeadlineUs,
+                                base::BindOnce(job, released, &runs)));
+  release.set_value();
+  pipeline_.Flush();
+  EXPECT_EQ(runs, 1);
+
+  EXPECT_TRUE(pipeline_.Submit(kPeer1, kFarDeadlineUs,
+                               base::BindOnce(job, released, &runs)));
+  pipeline_.Flush();
+  EXPECT_EQ(runs, 2);
+
+  A2dpEncodeStats stats = pipeline_.GetStats();
+  EXPECT_EQ(stats.total_jobs, 2u);
+  EXPECT_EQ(stats.skipped_ticks, 1u);
+  EXPECT_EQ(stats.deadline_miss_count, 0u);
+}
+
+TEST_F(A2dpEncodePipelineTest, late_jobs_are_counted_as_deadline_misses) {
+  pipeline_.AddPeer(kPeer1);
+
+  uint64_t deadline_us = bluetooth::common::time_get_os_boottime_us() + 1000;
+  EXPECT_TRUE(pipeline_.Submit(kPeer1, deadline_us, base::BindOnce([]() {
+                                 std::this_thread::sleep_for(
+                                     std::chrono::milliseconds(5));
+                               })));
+  pipeline_.Flush();
+
+  A2dpEncodeStats stats;
+  pipeline_.CollectStats(&stats);
+  EXPECT_EQ(stats.total_jobs, 1u);
+  EXPECT_EQ(stats.deadline_miss_count, 1u);
+  EXPECT_GE(stats.max_overrun_us, 4000u);
+  EXPECT_EQ(stats.total_overrun_us, stats.max_overrun_us);
+  EXPECT_NE(stats.last_deadline_miss_us, 0u);
+
+  // Collecting the statistics resets them
+  EXPECT_EQ(pipeline_.GetStats().total_jobs, 0u);
+  pipeline_.CollectStats(&stats);
+  EXPECT_EQ(stats.total_jobs, 1u);
+}
+
+TEST_F(A2dpEncodePipelineTest, jobs_of_unknown_peers_are_dropped) {
+  EXPECT_FALSE(pipeline_.Submit(kPeer1, kFarDeadlineUs,
+                                base::BindOnce([]() { FAIL(); })));
+  pipeline_.Flush();
+}
+
+}  // namespace
@@ -0,0 +1,123 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+#include "btif/include/btif_a2dp_source_scheduler.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+constexpr uint64_t kIntervalUs = 20000;
+constexpr uint64_t kPollUs =
+    kIntervalUs / A2dpSourceScheduler::kPollsPerInterval;
+constexpr uint64_t kStartUs = 1000000;
+
+const A2dpSourceLinkState kIdleLink = {0, 0, false, 0};
+
+TEST(A2dpSourceHistogramTest, values_are_bucketed) {
+  A2dpSourceHistogram histogram({10, 20});
+  histogram.Add(0);
+  histogram.Add(9);
+  histogram.Add(10);
+  histogram.Add(25);
+  EXPECT_EQ(histogram.Counts(), std::vector<size_t>({2, 1, 1}));
+  EXPECT_EQ(histogram.Total(), 4u);
+  EXPECT_EQ(histogram.ToString(10), "[0,1):2 [1,2):1 [2,inf):1");
+
+  A2dpSourceHistogram other({10, 20});
+  other.Add(15);
+  histogram.Accumulate(other);
+  EXPECT_EQ(histogram.Counts(), std::vector<size_t>({2, 2, 1}));
+
+  histogram.Reset();
+  EXPECT_EQ(histogram.Total(), 0u);
+}
+
+TEST(A2dpSourceSchedulerTest, fixed_mode_encodes_on_every_tick) {
+  A2dpSourceScheduler scheduler;
+  scheduler.Start(false, kIntervalUs, kStartUs);
+  EXPECT_EQ(scheduler.TimerPeriodUs(), kIntervalUs);
+
+  A2dpSourceLinkState congested = {4, 4, true, 0};
+  EXPECT_EQ(scheduler.Poll(kStartUs + kIntervalUs, congested),
+            A2dpSourceScheduler::kEncode);
+}
+
+TEST(A2dpSourceSchedulerTest, deadline_mode_encodes_on_nominal_deadline) {
+  A2dpSourceScheduler scheduler;
+  scheduler.Start(true, kIntervalUs, kStartUs);
+  EXPECT_EQ(scheduler.TimerPeriodUs(), kPollUs);
+
+  // Polls drifting after the start of the interval are not due yet
+  for (uint64_t poll = 1; poll < A2dpSourceScheduler::kPollsPerInterval;
+       poll++) {
+    EXPECT_EQ(scheduler.Poll(kStartUs + poll * kPollUs + 100, kIdleLink),
+              A2dpSourceScheduler::kWait);
+  }
+  // A poll slightly early on the deadline is due
+  uint64_t now_us = kStartUs + kIntervalUs - 100;
+  EXPECT_EQ(scheduler.Poll(now_us, kIdleLink), A2dpSourceScheduler::kEncode);
+  scheduler.OnEncode(now_us, kIdleLink);
+  EXPECT_EQ(scheduler.Poll(now_us + kPollUs, kIdleLink),
+            A2dpSourceScheduler::kWait);
+
+  EXPECT_EQ(scheduler.jitter_histogram.Counts()[0], 1u);
+  EXPECT_EQ(scheduler.queueing_histogram.Counts()[0], 1u);
+}
+
+TEST(A2dpSourceSchedulerTest, deadline_mode_defers_on_busy_link) {
+  A2dpSourceScheduler scheduler;
+  scheduler.Start(true, kIntervalUs, kStartUs);
+
+  A2dpSourceLinkState congested = {0, 0, true, 0};
+  A2dpSourceLinkState queued = {1, 1, false, 0};
+  A2dpSourceLinkState one_queued = {0, 1, false, 0};
+  uint64_t now_us = kStartUs + kIntervalUs - 100;
+  EXPECT_EQ(scheduler.Poll(now_us, congested),
+            A2dpSourceScheduler::kDeferCongested);
+  EXPECT_EQ(scheduler.Poll(now_us, queued), A2dpSourceScheduler::kDeferQueued);
+  EXPECT_EQ(scheduler.Poll(now_us, one_queued), A2dpSourceScheduler::kEncode);
+}
+
+TEST(A2dpSourceSchedulerTest, deferral_is_bounded_by_sink_delay) {
+  A2dpSourceScheduler scheduler;
+  scheduler.Start(true, kIntervalUs, kStartUs);
+
+  // Without delay report the encoding is deferred by one interval at most
+  EXPECT_EQ(scheduler.MaxDeferUs(0), kIntervalUs);
+  A2dpSourceLinkState congested = {0, 0, true, 0};
+  EXPECT_EQ(scheduler.Poll(kStartUs + kIntervalUs, congested),
+            A2dpSourceScheduler::kEncodeForced);
+
+  // A 40 ms sink buffer allows 10 ms more
+  congested.sink_delay_us = 40000;
+  EXPECT_EQ(scheduler.MaxDeferUs(congested.sink_delay_us), kIntervalUs + 10000);
+  EXPECT_EQ(scheduler.Poll(kStartUs + kIntervalUs + kPollUs, congested),
+            A2dpSourceScheduler::kDeferCongested);
+  EXPECT_EQ(scheduler.Poll(kStartUs + kIntervalUs + 2 * kPollUs, congested),
+            A2dpSourceScheduler::kEncodeForced);
+
+  // But never more than one extra interval
+  congested.sink_delay_us = 500000;
+  EXPECT_EQ(scheduler.MaxDeferUs(congested.sink_delay_us), 2 * kIntervalUs);
+
+  uint64_t now_us = kStartUs + 2 * kIntervalUs;
+  scheduler.OnEncode(now_us, congested);
+  EXPECT_EQ(scheduler.jitter_histogram.Counts()[5], 1u);
+}
+
+}  // namespace
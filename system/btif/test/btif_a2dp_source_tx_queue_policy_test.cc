@@ -0,0 +1,131 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+#include "btif/include/btif_a2dp_source_tx_queue_policy.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+
+constexpr uint64_t kIntervalUs = 20000;
+constexpr uint64_t kStartUs = 1000000;
+
+// 1000 bytes every 20 ms
+constexpr size_t kBytesPerTick = 1000;
+constexpr uint64_t kByteRate = 50000;
+
+// Starts a session with a known encoded rate
+void start_session(A2dpSourceTxQueuePolicy* policy, bool drop_oldest) {
+  policy->Start(drop_oldest, kIntervalUs, kStartUs);
+  policy->OnEncoded(kStartUs + kIntervalUs, kBytesPerTick);
+}
+
+TEST(A2dpSourceTxQueuePolicyTest, rate_is_estimated_from_encoded_bytes) {
+  A2dpSourceTxQueuePolicy policy;
+  policy.Start(true, kIntervalUs, kStartUs);
+  EXPECT_EQ(policy.ByteRate(), 0u);
+  EXPECT_EQ(policy.PlayoutUs(kBytesPerTick), 0u);
+
+  // Ticks without data are accounted to the next encoded packet
+  policy.OnEncoded(kStartUs + kIntervalUs, 0);
+  policy.OnEncoded(kStartUs + 2 * kIntervalUs, 2 * kBytesPerTick);
+  EXPECT_EQ(policy.ByteRate(), kByteRate);
+  EXPECT_EQ(policy.PlayoutUs(kBytesPerTick), kIntervalUs);
+
+  // New samples are smoothed
+  policy.OnEncoded(kStartUs + 3 * kIntervalUs, 9 * kBytesPerTick);
+  EXPECT_EQ(policy.ByteRate(), kByteRate * 2);
+}
+
+TEST(A2dpSourceTxQueuePolicyTest, watermarks_bound_the_queue) {
+  A2dpSourceTxQueuePolicy policy;
+  start_session(&policy, true);
+  ASSERT_EQ(policy.ByteRate(), kByteRate);
+
+  // Packets
+  policy.SetWatermarks(4, 0, 0);
+  EXPECT_FALSE(policy.IsOverflow({3, 3 * kBytesPerTick}, kBytesPerTick));
+  EXPECT_TRUE(policy.IsOverflow({4, 4 * kBytesPerTick}, kBytesPerTick));
+
+  // Bytes
+  policy.SetWatermarks(0, 2500, 0);
+  EXPECT_FALSE(policy.IsOverflow({1, 1500}, 1000));
+  EXPECT_TRUE(policy.IsOverflow({1, 1501}, 1000));
+
+  // Playout time
+  policy.SetWatermarks(0, 0, 5 * kIntervalUs);
+  EXPECT_FALSE(policy.IsOverflow({4, 4 * kBytesPerTick}, kBytesPerTick));
+  EXPECT_TRUE(policy.IsOverflow({5, 5 * kBytesPerTick}, kBytesPerTick));
+}
+
+TEST(A2dpSourceTxQueuePolicyTest, flush_mode_drops_all_packets) {
+  A2dpSourceTxQueuePolicy policy;
+  policy.Start(false, kIntervalUs, kStartUs);
+  policy.SetWatermarks(8, 0, 0);
+  EXPECT_TRUE(policy.ShouldDrop({1, kBytesPerTick}, kBytesPerTick));
+  EXPECT_FALSE(policy.ShouldDrop({0, 0}, kBytesPerTick));
+}
+
+TEST(A2dpSourceTxQueuePolicyTest, drop_oldest_mode_drops_to_low_watermark) {
+  A2dpSourceTxQueuePolicy policy;
+  start_session(&policy, true);
+  policy.SetWatermarks(0, 0, 8 * kIntervalUs);
+
+  // Dropped down to 6 intervals, including the new packet
+  A2dpSourceTxQueueLevel level = {8, 8 * kBytesPerTick};
+  ASSERT_TRUE(policy.IsOverflow(level, kBytesPerTick));
+  size_t dropped = 0;
+  while (policy.ShouldDrop(level, kBytesPerTick)) {
+    level.packets--;
+    level.bytes -= kBytesPerTick;
+    dropped++;
+  }
+  EXPECT_EQ(dropped, 3u);
+  policy.OnDrop(dropped, dropped * kBytesPerTick);
+  EXPECT_EQ(policy.stats.drop_events, 1u);
+  EXPECT_EQ(policy.stats.dropped_packets, 3u);
+  EXPECT_EQ(policy.stats.dropped_playout_us, 3 * kIntervalUs);
+}
+
+TEST(A2dpSourceTxQueuePolicyTest, encoder_queue_length_reflects_playout) {
+  A2dpSourceTxQueuePolicy policy;
+  policy.Start(true, kIntervalUs, kStartUs);
+  EXPECT_EQ(policy.EncoderQueueLength({2, 4 * kBytesPerTick}), 2u);
+
+  policy.OnEncoded(kStartUs + kIntervalUs, kBytesPerTick);
+  // Large packets: the queue holds more audio than packets
+  EXPECT_EQ(policy.EncoderQueueLength({2, 4 * kBytesPerTick}), 4u);
+  // Small packets
+  EXPECT_EQ(policy.EncoderQueueLength({4, 2 * kBytesPerTick}), 4u);
+}
+
+TEST(A2dpSourceTxQueuePolicyTest, occupancy_is_recorded) {
+  A2dpSourceTxQueuePolicy policy;
+  start_session(&policy, true);
+  policy.OnEnqueue({3, 3 * kBytesPerTick});
+  policy.OnEnqueue({1, kBytesPerTick});
+  EXPECT_EQ(policy.stats.max_packets, 3u);
+  EXPECT_EQ(policy.stats.max_bytes, 3 * kBytesPerTick);
+  EXPECT_EQ(policy.stats.max_playout_us, 3 * kIntervalUs);
+
+  // A new session starts over
+  policy.Start(true, kIntervalUs, kStartUs);
+  EXPECT_EQ(policy.stats.max_packets, 0u);
+  EXPECT_EQ(policy.ByteRate(), 0u);
+}
+
+}  // namespace
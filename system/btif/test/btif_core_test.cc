@@ -18,6 +18,8 @@
 
 #include <future>
 #include <map>
+#include <utility>
+#include <vector>
 
 #include "bta/include/bta_ag_api.h"
 #include "btcore/include/module.h"
@@ -54,8 +56,20 @@ void adapter_properties_callback(bt_status_t status, int num_properties,
 void remote_device_properties_callback(bt_status_t status, RawAddress* bd_addr,
                                        int num_properties,
                                        bt_property_t* properties) {}
-void device_found_callback(int num_properties, bt_property_t* properties) {}
-void discovery_state_changed_callback(bt_discovery_state_t state) {}
+std::vector<std::pair<RawAddress, int8_t>> devices_found_;
+void device_found_callback(int num_properties, bt_property_t* properties) {
+  RawAddress bd_addr = RawAddress::kEmpty;
+  int8_t rssi = 0;
+  for (int i = 0; i < num_properties; i++) {
+    if (properties[i].type == BT_PROPERTY_BDADDR) {
+      bd_addr = *static_cast<RawAddress*>(properties[i].val);
+    } else if (properties[i].type == BT_PROPERTY_REMOTE_RSSI) {
+      rssi = *static_cast<int8_t*>(properties[i].val);
+    }
+  }
+  devices_found_.emplace_back(bd_addr, rssi);
+}
+void discovery_state_changed_callback(bt_discovery_state_t state) { TESTCB; }
 void pin_request_callback(RawAddress* remote_bd_addr, bt_bdname_t* bd_name,
                           uint32_t cod, bool min_16_digit) {}
 void ssp_request_callback(RawAddress* remote_bd_addr, bt_bdname_t* bd_name,
@@ -174,3 +188,36 @@ TEST_F(BtifCoreTest, test_post_on_bt_jni_simple3) {
   ASSERT_EQ(std::future_status::ready, future.wait_for(timeout_time));
   ASSERT_EQ(val, future.get());
 }
+
+TEST_F(BtifCoreTest, test_device_found_batch) {
+  const RawAddress kAddr1 = {{0x11, 0x22, 0x33, 0x44, 0x55, 0x66}};
+  const RawAddress kAddr2 = {{0x66, 0x55, 0x44, 0x33, 0x22, 0x11}};
+  devices_found_.clear();
+
+  auto device_found = [](RawAddress bd_addr, int8_t rssi) {
+    bt_property_t properties[] = {
+        {BT_PROPERTY_BDADDR, sizeof(bd_addr), &bd_addr},
+        {BT_PROPERTY_REMOTE_RSSI, sizeof(rssi), &rssi},
+    };
+    invoke_device_found_cb(2, properties);
+  };
+  device_found(kAddr1, -40);
+  device_found(kAddr2, -70);
+  device_found(kAddr1, -50);
+
+  // Stopping the discovery delivers the pending results first
+  std::promise<void> promise;
+  auto future = promise.get_future();
+  callback_map_["discovery_state_changed_callback"] = [&promise]() {
+    promise.set_value();
+  };
+  invoke_discovery_state_changed_cb(BT_DISCOVERY_STOPPED);
+  ASSERT_EQ(std::future_status::ready, future.wait_for(timeout_time));
+  callback_map_.erase("discovery_state_changed_callback");
+
+  ASSERT_EQ(2u, devices_found_.size());
+  ASSERT_EQ(kAddr1, devices_found_[0].first);
+  ASSERT_EQ(-50, devices_found_[0].second);
+  ASSERT_EQ(kAddr2, devices_found_[1].first);
+  ASSERT_EQ(-70, devices_found_[1].second);
+}
@@ -0,0 +1,302 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "btif/include/btif_sock_thread.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "internal_include/bt_trace.h"
+
+uint8_t appl_trace_level = BT_TRACE_LEVEL_WARNING;
+void LogMsg(uint32_t trace_set_mask, const char* fmt_str, ...) {}
+
+namespace {
+
+constexpr int kType = BTSOCK_RFCOMM;
+constexpr auto kTimeout = std::chrono::seconds(5);
+
+struct Signal {
+  int fd;
+  int type;
+  int flags;
+  uint32_t user_id;
+};
+
+std::mutex lock;
+std::condition_variable signaled;
+std::vector<Signal> signals;
+int cmds_done;
+
+/* fds added back from the signal callback, as the sockets do */
+std::map<int, int> rearm_flags;
+int thread_handle = -1;
+
+void on_signaled(int fd, int type, int flags, uint32_t user_id) {
+  std::unique_lock<std::mutex> guard(lock);
+  signals.push_back({fd, type, flags, user_id});
+  auto it = rearm_flags.find(fd);
+  if (it != rearm_flags.end()) {
+    char byte;
+    read(fd, &byte, 1);
+    btsock_thread_add_fd(thread_handle, fd, type,
+                         it->second | SOCK_THREAD_ADD_FD_SYNC, user_id);
+  }
+  signaled.notify_all();
+}
+
+void on_cmd(int cmd_fd, int type, int size, uint32_t user_id) {
+  std::unique_lock<std::mutex> guard(lock);
+  cmds_done++;
+  signaled.notify_all();
+}
+
+class BtifSockThreadTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    signals.clear();
+    rearm_flags.clear();
+    cmds_done = 0;
+    btsock_thread_init();
+    thread_handle = btsock_thread_create(on_signaled, on_cmd);
+    ASSERT_GE(thread_handle, 0);
+  }
+
+  void TearDown() override {
+    btsock_thread_exit(thread_handle);
+    for (int fd : fds_) close(fd);
+  }
+
+  /* A connected socket pair, the first end to watch and the second to write */
+  void SocketPair(int* watched, int* peer) {
+    int fds[2];
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+    fds_.push_back(fds[1]);
+    *watched = fds[0];
+    *peer = fds[1];
+  }
+
+  bool WaitForSignals(size_t count) {
+    std::unique_lock<std::mutex> guard(lock);
+    return signaled.wait_for(guard, kTimeout,
+                             [count] { return signals.size() >= count; });
+  }
+
+  /* Returns once the socket poll thread has handled every signal pending
+   * before the call. A command is handled in the same wake up as the signals
+   * it was polled with, in any order, so the wake up of the second command
+   * starts after the one of the first is done. */
+  void Sync() {
+    for (int i = 0; i < 2; i++) {
+      std::unique_lock<std::mutex> guard(lock);
+      int target = cmds_done + 1;
+      guard.unlock();
+      ASSERT_TRUE(btsock_thread_post_cmd(thread_handle, 0, nullptr, 0, 0));
+      guard.lock();
+      ASSERT_TRUE(signaled.wait_for(
+          guard, kTimeout, [target] { return cmds_done >= target; }));
+    }
+  }
+
+  size_t SignalCount() {
+    std::unique_lock<std::mutex> guard(lock);
+    return signals.size();
+  }
+
+  std::vector<Signal> Signals() {
+    std::unique_lock<std::mutex> guard(lock);
+    return signals;
+  }
+
+  std::vector<int> fds_;
+};
+
+TEST_F(BtifSockThreadTest, read_is_signaled) {
+  int fd, peer;
+  SocketPair(&fd, &peer);
+  fds_.push_back(fd);
+
+  ASSERT_TRUE(btsock_thread_add_fd(thread_handle, fd, kType, SOCK_THREAD_FD_RD,
+                                   42));
+  ASSERT_EQ(1, write(peer, "x", 1));
+
+  ASSERT_TRUE(WaitForSignals(1));
+  ASSERT_EQ(fd, Signals()[0].fd);
+  ASSERT_EQ(kType, Signals()[0].type);
+  ASSERT_EQ(SOCK_THREAD_FD_RD, Signals()[0].flags);
+  ASSERT_EQ(42u, Signals()[0].user_id);
+}
+
+TEST_F(BtifSockThreadTest, write_is_signaled) {
+  int fd, peer;
+  SocketPair(&fd, &peer);
+  fds_.push_back(fd);
+
+  ASSERT_TRUE(btsock_thread_add_fd(thread_handle, fd, kType, SOCK_THREAD_FD_WR,
+                                   7));
+
+  ASSERT_TRUE(WaitForSignals(1));
+  ASSERT_EQ(fd, Signals()[0].fd);
+  ASSERT_EQ(SOCK_THREAD_FD_WR, Signals()[0].flags);
+  ASSERT_EQ(7u, Signals()[0].user_id);
+}
+
+TEST_F(BtifSockThreadTest, peer_close_is_signaled_as_exception) {
+  int fd, peer;
+  SocketPair(&fd, &peer);
+  fds_.push_back(fd);
+
+  ASSERT_TRUE(btsock_thread_add_fd(thread_handle, fd, kType,
+                                   SOCK_THREAD_FD_EXCEPTION, 3));
+  shutdown(peer, SHUT_RDWR);
+
+  ASSERT_TRUE(WaitForSignals(1));
+  ASSERT_EQ(fd, Signals()[0].fd);
+  ASSERT_TRUE(Signals()[0].flags & SOCK_THREAD_FD_EXCEPTION);
+
+  // the whole fd is removed on exception
+  Sync();
+  ASSERT_EQ(1u, SignalCount());
+}
+
+/* A read is signaled once, until the fd is added again */
+TEST_F(BtifSockThreadTest, read_is_signaled_once_until_added_again) {
+  int fd, peer;
+  SocketPair(&fd, &peer);
+  fds_.push_back(fd);
+
+  ASSERT_TRUE(btsock_thread_add_fd(thread_handle, fd, kType, SOCK_THREAD_FD_RD,
+                                   1));
+  ASSERT_EQ(2, write(peer, "xy", 2));
+  ASSERT_TRUE(WaitForSignals(1));
+
+  // the data is still there but the fd is no longer watched for read
+  Sync();
+  ASSERT_EQ(1u, SignalCount());
+
+  ASSERT_TRUE(btsock_thread_add_fd(thread_handle, fd, kType, SOCK_THREAD_FD_RD,
+                                   1));
+  ASSERT_TRUE(WaitForSignals(2));
+  ASSERT_EQ(fd, Signals()[1].fd);
+  ASSERT_EQ(SOCK_THREAD_FD_RD, Signals()[1].flags);
+}
+
+/* The sockets add the fd back from the signal callback, in the socket poll
+ * thread */
+TEST_F(BtifSockThreadTest, read_is_rearmed_from_the_callback) {
+  int fd, peer;
+  SocketPair(&fd, &peer);
+  fds_.push_back(fd);
+  rearm_flags[fd] = SOCK_THREAD_FD_RD;
+
+  ASSERT_TRUE(btsock_thread_add_fd(thread_handle, fd, kType, SOCK_THREAD_FD_RD,
+                                   1));
+  for (size_t i = 1; i <= 3; i++) {
+    ASSERT_EQ(1, write(peer, "x", 1));
+    ASSERT_TRUE(WaitForSignals(i));
+    Sync();
+    ASSERT_EQ(i, SignalCount());
+  }
+}
+
+/* Only the signaled half of a read and write watch is removed */
+TEST_F(BtifSockThreadTest, read_stays_watched_after_write_is_signaled) {
+  int fd, peer;
+  SocketPair(&fd, &peer);
+  fds_.push_back(fd);
+
+  ASSERT_TRUE(btsock_thread_add_fd(thread_handle, fd, kType,
+                                   SOCK_THREAD_FD_RD | SOCK_THREAD_FD_WR, 1));
+  ASSERT_TRUE(WaitForSignals(1));
+  ASSERT_EQ(SOCK_THREAD_FD_WR, Signals()[0].flags);
+
+  Sync();
+  ASSERT_EQ(1u, SignalCount());
+
+  ASSERT_EQ(1, write(peer, "x", 1));
+  ASSERT_TRUE(WaitForSignals(2));
+  ASSERT_EQ(SOCK_THREAD_FD_RD, Signals()[1].flags);
+}
+
+TEST_F(BtifSockThreadTest, remove_fd_and_close) {
+  int fd, peer;
+  SocketPair(&fd, &peer);
+
+  ASSERT_TRUE(btsock_thread_add_fd(thread_handle, fd, kType, SOCK_THREAD_FD_RD,
+                                   1));
+  ASSERT_TRUE(btsock_thread_remove_fd_and_close(thread_handle, fd));
+  Sync();
+
+  // closed by the socket poll thread
+  ASSERT_EQ(-1, fcntl(fd, F_GETFD));
+  ASSERT_EQ(EBADF, errno);
+  ASSERT_EQ(-1, send(peer, "x", 1, MSG_NOSIGNAL));
+
+  Sync();
+  ASSERT_EQ(0u, SignalCount());
+}
+
+/* Outside of the socket poll thread the add goes through the command socket,
+ * like any other add */
+TEST_F(BtifSockThreadTest, sync_add_off_the_poll_thread) {
+  int fd, peer;
+  SocketPair(&fd, &peer);
+  fds_.push_back(fd);
+
+  ASSERT_TRUE(btsock_thread_add_fd(thread_handle, fd, kType,
+                                   SOCK_THREAD_FD_RD | SOCK_THREAD_ADD_FD_SYNC,
+                                   1));
+  ASSERT_EQ(1, write(peer, "x", 1));
+
+  ASSERT_TRUE(WaitForSignals(1));
+  ASSERT_EQ(SOCK_THREAD_FD_RD, Signals()[0].flags);
+}
+
+TEST_F(BtifSockThreadTest, more_fds_than_a_wake_up_handles) {
+  constexpr int kFdCount = 150;
+  std::map<int, uint32_t> user_ids;
+  for (int i = 0; i < kFdCount; i++) {
+    int fd, peer;
+    SocketPair(&fd, &peer);
+    fds_.push_back(fd);
+    user_ids[fd] = 100 + i;
+    ASSERT_TRUE(btsock_thread_add_fd(thread_handle, fd, kType,
+                                     SOCK_THREAD_FD_RD, 100 + i));
+    ASSERT_EQ(1, write(peer, "x", 1));
+  }
+
+  ASSERT_TRUE(WaitForSignals(kFdCount));
+  Sync();
+  ASSERT_EQ(static_cast<size_t>(kFdCount), SignalCount());
+  for (const Signal& signal : Signals()) {
+    ASSERT_EQ(SOCK_THREAD_FD_RD, signal.flags);
+    ASSERT_EQ(user_ids[signal.fd], signal.user_id);
+    user_ids.erase(signal.fd);
+  }
+  ASSERT_TRUE(user_ids.empty());
+}
+
+}  // namespace
@@ -22,6 +22,7 @@
 #include <openssl/hmac.h>
 
 #include <algorithm>
+#include <mutex>
 
 #include "bt_trace.h"
 #include "types/raw_address.h"
@@ -35,25 +36,71 @@ bool AddressObfuscator::IsSaltValid(const Octet32& salt_256bit) {
 }
 
 void AddressObfuscator::Initialize(const Octet32& salt_256bit) {
-  std::lock_guard<std::recursive_mutex> lock(instance_mutex_);
+  std::unique_lock<std::shared_mutex> lock(instance_mutex_);
+  if (salt_256bit_ == salt_256bit) {
+    return;
+  }
   salt_256bit_ = salt_256bit;
+  salt_generation_++;
+  for (auto& entry : cache_) {
+    entry.valid = false;
+  }
 }
 
 bool AddressObfuscator::IsInitialized() {
-  std::lock_guard<std::recursive_mutex> lock(instance_mutex_);
+  std::shared_lock<std::shared_mutex> lock(instance_mutex_);
   return IsSaltValid(salt_256bit_);
 }
 
 std::string AddressObfuscator::Obfuscate(const RawAddress& address) {
-  std::lock_guard<std::recursive_mutex> lock(instance_mutex_);
-  CHECK(IsInitialized());
   std::array<uint8_t, EVP_MAX_MD_SIZE> result = {};
   unsigned int out_len = 0;
-  CHECK(::HMAC(EVP_sha256(), salt_256bit_.data(), salt_256bit_.size(),
-               address.address, address.kLength, result.data(),
-               &out_len) != nullptr);
+  uint64_t salt_generation;
+  {
+    std::shared_lock<std::shared_mutex> lock(instance_mutex_);
+    CHECK(IsSaltValid(salt_256bit_));
+    for (auto& entry : cache_) {
+      if (entry.valid && entry.address == address) {
+        entry.last_use.store(
+            use_count_.fetch_add(1, std::memory_order_relaxed) + 1,
+            std::memory_order_relaxed);
+        return entry.obfuscated_id;
+      }
+    }
+    salt_generation = salt_generation_;
+    CHECK(::HMAC(EVP_sha256(), salt_256bit_.data(), salt_256bit_.size(),
+                 address.address, address.kLength, result.data(),
+                 &out_len) != nullptr);
+  }
   CHECK_EQ(out_len, static_cast<unsigned int>(kOctet32Length));
-  return std::string(reinterpret_cast<const char*>(result.data()), out_len);
+  std::string obfuscated_id(reinterpret_cast<const char*>(result.data()),
+                            out_len);
+
+  std::unique_lock<std::shared_mutex> lock(instance_mutex_);
+  if (salt_generation != salt_generation_) {
+    return obfuscated_id;
+  }
+  CacheEntry* victim = &cache_[0];
+  for (auto& entry : cache_) {
+    if (entry.valid && entry.address == address) {
+      // Cached by a concurrent call in the meantime
+      return obfuscated_id;
+    }
+    if (!entry.valid) {
+      victim = &entry;
+      break;
+    }
+    if (entry.last_use.load(std::memory_order_relaxed) <
+        victim->last_use.load(std::memory_order_relaxed)) {
+      victim = &entry;
+    }
+  }
+  victim->valid = true;
+  victim->address = address;
+  victim->obfuscated_id = obfuscated_id;
+  victim->last_use.store(use_count_.fetch_add(1, std::memory_order_relaxed) + 1,
+                         std::memory_order_relaxed);
+  return obfuscated_id;
 }
 
 }  // namespace common
@@ -19,7 +19,8 @@
 #pragma once
 
 #include <array>
-#include <mutex>
+#include <atomic>
+#include <shared_mutex>
 #include <string>
 
 #include "raw_address.h"
@@ -31,6 +32,8 @@ class AddressObfuscator {
  public:
   static constexpr unsigned int kOctet32Length = 32;
   using Octet32 = std::array<uint8_t, kOctet32Length>;
+  // Number of recently obfuscated addresses whose ID is kept
+  static constexpr size_t kCacheSize = 16;
   static AddressObfuscator* GetInstance() {
     static auto instance = new AddressObfuscator();
     return instance;
@@ -61,15 +64,32 @@ class AddressObfuscator {
   /**
    * Obfuscate Bluetooth MAC address into an anonymous ID string
    *
+   * The IDs of the last kCacheSize addresses are cached until the salt
+   * changes. Concurrent lookups of cached addresses do not block each other.
+   *
    * @param address Bluetooth MAC address to be obfuscated
    * @return the obfuscated MAC address in 256 bit
    */
   std::string Obfuscate(const RawAddress& address);
 
  private:
+  struct CacheEntry {
+    bool valid = false;
+    RawAddress address;
+    std::string obfuscated_id;
+    // Value of use_count_ when the entry was last used, to evict the least
+    // recently used one. Updated under the shared lock, hence atomic
+    std::atomic<uint64_t> last_use{0};
+  };
+
   AddressObfuscator() : salt_256bit_({0}) {}
   Octet32 salt_256bit_;
-  std::recursive_mutex instance_mutex_;
+  std::shared_mutex instance_mutex_;
+  std::array<CacheEntry, kCacheSize> cache_;
+  std::atomic<uint64_t> use_count_{0};
+  // Incremented each time the salt changes, so that an ID computed with the
+  // previous salt is not cached
+  uint64_t salt_generation_ = 0;
 };
 
 }  // namespace common
@@ -120,3 +120,24 @@ TEST(AddressObfuscatorTest, test_obfuscate_address_key2_max_address) {
   EXPECT_EQ(result.size(), AddressObfuscator::kOctet32Length);
   EXPECT_EQ(result, kTestResult2_3);
 }
+
+TEST(AddressObfuscatorTest, test_obfuscate_address_cached_until_salt_changes) {
+  AddressObfuscator::GetInstance()->Initialize(kTestKey1);
+  EXPECT_EQ(AddressObfuscator::GetInstance()->Obfuscate(kTestData1),
+            kTestResult1);
+  EXPECT_EQ(AddressObfuscator::GetInstance()->Obfuscate(kTestData1),
+            kTestResult1);
+
+  AddressObfuscator::GetInstance()->Initialize(kTestKey2);
+  EXPECT_EQ(AddressObfuscator::GetInstance()->Obfuscate(kTestData2_2),
+            kTestResult2_2);
+  // Evict every cached ID, the results do not depend on the cache
+  for (uint8_t i = 1; i <= AddressObfuscator::kCacheSize; i++) {
+    RawAddress address = {{0x01, 0x02, 0x03, 0x04, 0x05, i}};
+    AddressObfuscator::GetInstance()->Obfuscate(address);
+  }
+  EXPECT_EQ(AddressObfuscator::GetInstance()->Obfuscate(kTestData2_1),
+            kTestResult2_1);
+  EXPECT_EQ(AddressObfuscator::GetInstance()->Obfuscate(kTestData2_2),
+            kTestResult2_2);
+}
@@ -0,0 +1,243 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/audio_resampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace bluetooth {
+namespace common {
+
+namespace {
+
+/* Zero crossings of the sinc on each side when upsampling, the filter is
+ * stretched by M/L when downsampling to keep its transition band */
+constexpr size_t kZeroCrossings = 16;
+constexpr size_t kMaxTaps = 128;
+/* Passband edge, as a fraction of the lower Nyquist frequency */
+constexpr double kRolloff = 0.91;
+/* About 80 dB of stopband attenuation */
+constexpr double kKaiserBeta = 8.0;
+constexpr int kCoefficientShift = 14;
+/* Input frames appended to the buffers at a time */
+constexpr size_t kBlockFrames = 1024;
+
+double BesselI0(double x) {
+  double sum = 1.0;
+  double term = 1.0;
+  for (int k = 1; k < 32; k++) {
+    term *= (x / (2 * k)) * (x / (2 * k));
+    sum += term;
+  }
+  return sum;
+}
+
+int16_t Saturate(int32_t acc) {
+  int32_t sample = (acc + (1 << (kCoefficientShift - 1))) >> kCoefficientShift;
+  return static_cast<int16_t>(
+      std::min<int32_t>(std::max<int32_t>(sample, INT16_MIN), INT16_MAX));
+}
+
+/* |taps| is a multiple of 8 */
+int32_t DotProduct(const int16_t* x, const int16_t* h, size_t taps) {
+  int32_t acc = 0;
+  for (size_t k = 0; k < taps; k++) {
+    acc += static_cast<int32_t>(x[k]) * h[k];
+  }
+  return acc;
+}
+
+#if defined(__ARM_NEON)
+int32_t DotProductSimd(const int16_t* x, const int16_t* h, size_t taps) {
+  int32x4_t acc = vdupq_n_s32(0);
+  for (size_t k = 0; k < taps; k += 8) {
+    int16x8_t a = vld1q_s16(x + k);
+    int16x8_t b = vld1q_s16(h + k);
+    acc = vmlal_s16(acc, vget_low_s16(a), vget_low_s16(b));
+    acc = vmlal_s16(acc, vget_high_s16(a), vget_high_s16(b));
+  }
+#if defined(__aarch64__)
+  return vaddvq_s32(acc);
+#else
+  int32x2_t sum = vadd_s32(vget_low_s32(acc), vget_high_s32(acc));
+  return vget_lane_s32(vpadd_s32(sum, sum), 0);
+#endif
+}
+#elif defined(__SSE2__)
+int32_t DotProductSimd(const int16_t* x, const int16_t* h, size_t taps) {
+  __m128i acc = _mm_setzero_si128();
+  for (size_t k = 0; k < taps; k += 8) {
+    __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + k));
+    __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + k));
+    acc = _mm_add_epi32(acc, _mm_madd_epi16(a, b));
+  }
+  acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+  acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(acc);
+}
+#else
+int32_t DotProductSimd(const int16_t* x, const int16_t* h, size_t taps) {
+  return DotProduct(x, h, taps);
+}
+#endif
+
+}  // namespace
+
+std::unique_ptr<AudioResampler> AudioResampler::Create(uint32_t src_rate,
+                                                       uint32_t dst_rate,
+                                                       size_t channels) {
+  if (src_rate == 0 || dst_rate == 0 || channels == 0 ||
+      channels > kMaxChannels) {
+    return nullptr;
+  }
+  const uint32_t gcd = std::gcd(src_rate, dst_rate);
+  const uint32_t l = dst_rate / gcd;
+  const uint32_t m = src_rate / gcd;
+  if (l > kMaxPhases) {
+    return nullptr;
+  }
+
+  size_t taps = 2 * kZeroCrossings;
+  if (m > l) {
+    taps = (taps * m + l - 1) / l;
+  }
+  taps = std::min((taps + 7) & ~size_t{7}, kMaxTaps);
+  return std::unique_ptr<AudioResampler>(
+      new AudioResampler(src_rate, dst_rate, channels, l, m, taps));
+}
+
+AudioResampler::AudioResampler(uint32_t src_rate, uint32_t dst_rate,
+                               size_t channels, uint32_t l, uint32_t m,
+                               size_t taps)
+    : src_rate_(src_rate),
+      dst_rate_(dst_rate),
+      channels_(channels),
+      l_(l),
+      m_(m),
+      taps_(taps) {
+  ComputeCoefficients();
+  for (size_t c = 0; c < channels_; c++) {
+    buffers_[c].resize(taps_ + kBlockFrames);
+  }
+  Reset();
+}
+
+void AudioResampler::ComputeCoefficients() {
+  /* Cutoff in cycles per input sample */
+  const double cutoff = 0.5 * kRolloff * std::min(1.0, double(l_) / m_);
+  const double half_length = taps_ / 2.0;
+
+  coefficients_.resize(l_ * taps_);
+  std::vector<double> phase(taps_);
+  for (uint32_t p = 0; p < l_; p++) {
+    /* Tap k weights the input k frames after the first one of the window,
+     * which is taps_ / 2 - 1 frames before the output */
+    double sum = 0;
+    for (size_t k = 0; k < taps_; k++) {
+      double d = half_length - 1 - k + double(p) / l_;
+      double x = 2 * cutoff * d;
+      double sinc = x == 0 ? 1.0 : std::sin(M_PI * x) / (M_PI * x);
+      double r = d / half_length;
+      double window =
+          r * r < 1 ? BesselI0(kKaiserBeta * std::sqrt(1 - r * r)) : 0;
+      phase[k] = 2 * cutoff * sinc * window;
+      sum += phase[k];
+    }
+
+    /* Unity DC gain after the quantization, the rounding error goes to the
+     * largest tap */
+    int16_t* coefficients = &coefficients_[p * taps_];
+    int32_t quantized_sum = 0;
+    size_t largest = 0;
+    for (size_t k = 0; k < taps_; k++) {
+      coefficients[k] = static_cast<int16_t>(
+          std::lround(phase[k] / sum * (1 << kCoefficientShift)));
+      quantized_sum += coefficients[k];
+      if (std::abs(coefficients[k]) > std::abs(coefficients[largest])) {
+        largest = k;
+      }
+    }
+    coefficients[largest] += (1 << kCoefficientShift) - quantized_sum;
+  }
+}
+
+void AudioResampler::Reset() {
+  /* Start with half a window of silence so that the first output frame is
+   * centered on the first input frame */
+  buffered_ = taps_ / 2 - 1;
+  for (size_t c = 0; c < channels_; c++) {
+    std::fill(buffers_[c].begin(), buffers_[c].begin() + buffered_, 0);
+  }
+  pos_ = 0;
+  phase_ = 0;
+}
+
+size_t AudioResampler::Resample(const int16_t* src, size_t src_frames,
+                                int16_t* dst, size_t dst_frames,
+                                size_t* src_used) {
+  auto dot_product = simd_enabled_ ? DotProductSimd : DotProduct;
+  size_t written = 0;
+  size_t used = 0;
+
+  while (true) {
+    while (written < dst_frames && pos_ + taps_ <= buffered_) {
+      const int16_t* coefficients = &coefficients_[phase_ * taps_];
+      for (size_t c = 0; c < channels_; c++) {
+        dst[written * channels_ + c] =
+            Saturate(dot_product(&buffers_[c][pos_], coefficients, taps_));
+      }
+      written++;
+      phase_ += m_;
+      pos_ += phase_ / l_;
+      phase_ %= l_;
+    }
+    if (written == dst_frames || used == src_frames) {
+      break;
+    }
+
+    /* Drop the input behind the window and append the next block */
+    const size_t drop = std::min(pos_, buffered_);
+    const size_t frames =
+        std::min(src_frames - used, buffers_[0].size() - (buffered_ - drop));
+    for (size_t c = 0; c < channels_; c++) {
+      int16_t* buffer = buffers_[c].data();
+      memmove(buffer, buffer + drop, (buffered_ - drop) * sizeof(int16_t));
+      buffer += buffered_ - drop;
+      const int16_t* input = src + used * channels_ + c;
+      for (size_t i = 0; i < frames; i++) {
+        buffer[i] = input[i * channels_];
+      }
+    }
+    buffered_ = buffered_ - drop + frames;
+    pos_ -= drop;
+    used += frames;
+  }
+
+  *src_used = used;
+  return written;
+}
+
+}  // namespace common
+}  // namespace bluetooth
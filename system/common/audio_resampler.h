@@ -0,0 +1,95 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace bluetooth {
+namespace common {
+
+/**
+ * Sample rate converter of interleaved 16 bit PCM, for the audio paths whose
+ * source rate differs from the rate of the codec.
+ *
+ * The rates are converted by a rational factor L/M with a polyphase FIR
+ * filter: a Kaiser windowed sinc cut off below the lower of the two Nyquist
+ * frequencies, split in L phases of Q14 taps whose DC gain is exactly one.
+ * The taps are applied with NEON or SSE2 when the target supports them, with
+ * the same integer arithmetic as the scalar code so that both paths produce
+ * identical samples.
+ *
+ * The input is buffered internally, the output lags it by half the filter.
+ */
+class AudioResampler {
+ public:
+  static constexpr size_t kMaxChannels = 2;
+  /* Largest L, enough for any pair of the Bluetooth audio rates */
+  static constexpr uint32_t kMaxPhases = 512;
+
+  /* Return nullptr when the rates or the channel count are not supported */
+  static std::unique_ptr<AudioResampler> Create(uint32_t src_rate,
+                                                uint32_t dst_rate,
+                                                size_t channels);
+
+  /* Convert up to |src_frames| frames of |src| into at most |dst_frames|
+   * frames of |dst|. The number of source frames consumed is returned in
+   * |*src_used|, the frames that were not are left to the next call.
+   *
+   * Returns the number of frames written to |dst|.
+   */
+  size_t Resample(const int16_t* src, size_t src_frames, int16_t* dst,
+                  size_t dst_frames, size_t* src_used);
+
+  /* Drop the buffered input, as at a discontinuity of the stream */
+  void Reset();
+
+  /* Use (default) or not the SIMD kernels, for tests and benchmarks */
+  void SetSimdEnabled(bool enabled) { simd_enabled_ = enabled; }
+
+  uint32_t GetSrcRate() const { return src_rate_; }
+  uint32_t GetDstRate() const { return dst_rate_; }
+  size_t GetTapsPerPhase() const { return taps_; }
+
+ private:
+  AudioResampler(uint32_t src_rate, uint32_t dst_rate, size_t channels,
+                 uint32_t l, uint32_t m, size_t taps);
+  void ComputeCoefficients();
+
+  const uint32_t src_rate_;
+  const uint32_t dst_rate_;
+  const size_t channels_;
+  /* Interpolation and decimation factors */
+  const uint32_t l_;
+  const uint32_t m_;
+  const size_t taps_;
+  bool simd_enabled_ = true;
+
+  /* |taps_| coefficients per phase */
+  std::vector<int16_t> coefficients_;
+  /* Input of each channel, de-interleaved */
+  std::vector<int16_t> buffers_[kMaxChannels];
+  size_t buffered_ = 0;
+  /* First input frame and phase of the next output frame */
+  size_t pos_ = 0;
+  uint32_t phase_ = 0;
+};
+
+}  // namespace common
+}  // namespace bluetooth
@@ -0,0 +1,180 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/audio_resampler.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+namespace testing {
+
+using bluetooth::common::AudioResampler;
+
+namespace {
+
+std::vector<int16_t> Sine(double frequency, uint32_t rate, size_t frames,
+                          size_t channels, double amplitude = 16384) {
+  std::vector<int16_t> pcm(frames * channels);
+  for (size_t i = 0; i < frames; i++) {
+    for (size_t c = 0; c < channels; c++) {
+      /* Phase shifted per channel to tell them apart */
+      pcm[i * channels + c] = static_cast<int16_t>(std::lround(
+          amplitude * std::sin(2 * M_PI * frequency * i / rate + c)));
+    }
+  }
+  return pcm;
+}
+
+std::vector<int16_t> ResampleAll(AudioResampler* resampler,
+                                 const std::vector<int16_t>& src,
+                                 size_t channels, size_t chunk_frames) {
+  std::vector<int16_t> dst;
+  std::vector<int16_t> out(4096 * channels);
+  size_t frames = src.size() / channels;
+  for (size_t offset = 0; offset < frames;) {
+    size_t used;
+    size_t n = std::min(chunk_frames, frames - offset);
+    size_t written = resampler->Resample(&src[offset * channels], n,
+                                         out.data(), 4096, &used);
+    dst.insert(dst.end(), out.begin(), out.begin() + written * channels);
+    offset += used;
+  }
+  return dst;
+}
+
+/* Power of |pcm| at |frequency|, over the frames past |skip| */
+double Power(const std::vector<int16_t>& pcm, size_t skip, double frequency,
+             uint32_t rate) {
+  double re = 0, im = 0;
+  for (size_t i = skip; i < pcm.size(); i++) {
+    re += pcm[i] * std::cos(2 * M_PI * frequency * i / rate);
+    im += pcm[i] * std::sin(2 * M_PI * frequency * i / rate);
+  }
+  double n = pcm.size() - skip;
+  return (re * re + im * im) / (n * n);
+}
+
+}  // namespace
+
+TEST(AudioResamplerTest, create) {
+  EXPECT_EQ(AudioResampler::Create(0, 48000, 2), nullptr);
+  EXPECT_EQ(AudioResampler::Create(44100, 0, 2), nullptr);
+  EXPECT_EQ(AudioResampler::Create(44100, 48000, 0), nullptr);
+  EXPECT_EQ(AudioResampler::Create(44100, 48000, 3), nullptr);
+  /* L = 48000 */
+  EXPECT_EQ(AudioResampler::Create(1, 48000, 2), nullptr);
+
+  auto resampler = AudioResampler::Create(44100, 48000, 2);
+  ASSERT_NE(resampler, nullptr);
+  EXPECT_EQ(resampler->GetTapsPerPhase(), 32u);
+  /* The filter stretches with the decimation */
+  resampler = AudioResampler::Create(48000, 16000, 1);
+  ASSERT_NE(resampler, nullptr);
+  EXPECT_EQ(resampler->GetTapsPerPhase(), 96u);
+}
+
+TEST(AudioResamplerTest, frame_count_follows_the_ratio) {
+  for (auto [src_rate, dst_rate] :
+       std::vector<std::pair<uint32_t, uint32_t>>{{44100, 48000},
+                                                  {48000, 44100},
+                                                  {16000, 48000},
+                                                  {48000, 16000},
+                                                  {32000, 44100}}) {
+    auto resampler = AudioResampler::Create(src_rate, dst_rate, 2);
+    ASSERT_NE(resampler, nullptr);
+    auto src = Sine(1000, src_rate, src_rate, 2);
+    auto dst = ResampleAll(resampler.get(), src, 2, 441);
+    /* Half a window of input is still buffered */
+    double expected = double(src_rate - resampler->GetTapsPerPhase() / 2) *
+                      dst_rate / src_rate;
+    EXPECT_NEAR(dst.size() / 2, expected, 2) << src_rate << "->" << dst_rate;
+  }
+}
+
+TEST(AudioResamplerTest, dc_is_preserved) {
+  auto resampler = AudioResampler::Create(44100, 48000, 1);
+  std::vector<int16_t> src(4410, 12345);
+  auto dst = ResampleAll(resampler.get(), src, 1, 4410);
+  ASSERT_GT(dst.size(), 100u);
+  for (size_t i = 32; i < dst.size(); i++) {
+    ASSERT_EQ(dst[i], 12345) << i;
+  }
+}
+
+TEST(AudioResamplerTest, sine_is_converted) {
+  auto resampler = AudioResampler::Create(44100, 48000, 2);
+  auto src = Sine(1000, 44100, 44100, 2);
+  auto dst = ResampleAll(resampler.get(), src, 2, 1024);
+  auto expected = Sine(1000, 48000, dst.size() / 2, 2);
+
+  double signal = 0, noise = 0;
+  for (size_t i = 64; i < dst.size(); i++) {
+    signal += double(expected[i]) * expected[i];
+    noise += double(dst[i] - expected[i]) * (dst[i] - expected[i]);
+  }
+  EXPECT_GT(10 * std::log10(signal / noise), 70);
+}
+
+TEST(AudioResamplerTest, images_are_rejected) {
+  auto resampler = AudioResampler::Create(48000, 16000, 1);
+  auto in_band = ResampleAll(resampler.get(), Sine(1000, 48000, 48000, 1), 1,
+                             480);
+  resampler->Reset();
+  /* Above the 8 kHz Nyquist frequency of the output, aliases to 4 kHz */
+  auto out_of_band = ResampleAll(resampler.get(),
+                                 Sine(12000, 48000, 48000, 1), 1, 480);
+
+  double attenuation = 10 * std::log10(Power(in_band, 64, 1000, 16000) /
+                                        Power(out_of_band, 64, 4000, 16000));
+  EXPECT_GT(attenuation, 60);
+}
+
+TEST(AudioResamplerTest, simd_matches_scalar) {
+  for (auto [src_rate, dst_rate] :
+       std::vector<std::pair<uint32_t, uint32_t>>{{44100, 48000},
+                                                  {48000, 16000}}) {
+    auto simd = AudioResampler::Create(src_rate, dst_rate, 2);
+    auto scalar = AudioResampler::Create(src_rate, dst_rate, 2);
+    scalar->SetSimdEnabled(false);
+    /* Full scale to exercise the saturation */
+    auto src = Sine(3000, src_rate, src_rate / 10, 2, 32767);
+    EXPECT_EQ(ResampleAll(simd.get(), src, 2, 480),
+              ResampleAll(scalar.get(), src, 2, 480));
+  }
+}
+
+TEST(AudioResamplerTest, chunking_does_not_change_the_output) {
+  auto src = Sine(440, 16000, 16000, 2);
+  auto one_shot = AudioResampler::Create(16000, 44100, 2);
+  auto chunked = AudioResampler::Create(16000, 44100, 2);
+  EXPECT_EQ(ResampleAll(one_shot.get(), src, 2, 16000),
+            ResampleAll(chunked.get(), src, 2, 7));
+}
+
+TEST(AudioResamplerTest, full_output_leaves_the_input) {
+  auto resampler = AudioResampler::Create(44100, 48000, 1);
+  std::vector<int16_t> src(4410);
+  std::vector<int16_t> dst(100);
+  size_t used;
+  EXPECT_EQ(resampler->Resample(src.data(), src.size(), dst.data(), dst.size(),
+                                &used),
+            dst.size());
+  EXPECT_LT(used, src.size());
+}
+
+}  // namespace testing
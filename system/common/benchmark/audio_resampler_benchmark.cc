@@ -0,0 +1,65 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "common/audio_resampler.h"
+
+using ::benchmark::Counter;
+using ::benchmark::State;
+using bluetooth::common::AudioResampler;
+
+// Stereo conversion of 10 ms blocks of white noise. The arguments are the
+// source rate, the destination rate and whether the SIMD kernels are used.
+static void BM_AudioResampler(State& state) {
+  const uint32_t src_rate = state.range(0);
+  const uint32_t dst_rate = state.range(1);
+  auto resampler = AudioResampler::Create(src_rate, dst_rate, 2);
+  if (resampler == nullptr) {
+    state.SkipWithError("Rates not supported");
+    return;
+  }
+  resampler->SetSimdEnabled(state.range(2));
+
+  const size_t src_frames = src_rate / 100;
+  std::vector<int16_t> src(src_frames * 2);
+  std::mt19937 gen(1);
+  std::uniform_int_distribution<int16_t> dist(INT16_MIN, INT16_MAX);
+  for (auto& sample : src) sample = dist(gen);
+  std::vector<int16_t> dst((dst_rate / 100 + 1) * 2);
+
+  uint64_t frames = 0;
+  for (auto _ : state) {
+    size_t used;
+    frames += resampler->Resample(src.data(), src_frames, dst.data(),
+                                  dst.size() / 2, &used);
+    benchmark::DoNotOptimize(dst.data());
+  }
+  state.counters["frames_per_s"] =
+      Counter(static_cast<double>(frames), Counter::kIsRate);
+  // CPU seconds spent per second of audio
+  state.counters["cpu_per_audio_s"] = Counter(
+      state.iterations() / 100.0, Counter::kIsRate | Counter::kInvert);
+}
+
+BENCHMARK(BM_AudioResampler)
+    ->ArgNames({"src", "dst", "simd"})
+    ->ArgsProduct({{16000, 44100, 48000}, {16000, 44100, 48000}, {0, 1}});
+
+BENCHMARK_MAIN();
@@ -0,0 +1,129 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <base/logging.h>
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "osi/include/config.h"
+
+using ::benchmark::State;
+
+#define NUM_DEVICES 200
+
+static const std::filesystem::path kConfigFile =
+    std::filesystem::temp_directory_path() / "config_benchmark.conf";
+
+static std::string device_section(int index) {
+  char name[18];
+  snprintf(name, sizeof(name), "00:11:22:33:%02x:%02x", (index >> 8) & 0xff,
+           index & 0xff);
+  return name;
+}
+
+// A bt_config.conf with |NUM_DEVICES| bonded devices
+static std::unique_ptr<config_t> make_config() {
+  std::unique_ptr<config_t> config = config_new_empty();
+  config_set_string(config.get(), "Info", "TimeCreated", "2026-01-01 00:00:00");
+  config_set_string(config.get(), "Adapter", "Address", "00:11:22:33:44:55");
+  for (int i = 0; i < NUM_DEVICES; i++) {
+    std::string section = device_section(i);
+    config_set_string(config.get(), section, "Name", "Device " + section);
+    config_set_int(config.get(), section, "DevClass", 0x240404);
+    config_set_int(config.get(), section, "DevType", 3);
+    config_set_int(config.get(), section, "AddrType", 0);
+    config_set_string(config.get(), section, "Service",
+                      "0000110b-0000-1000-8000-00805f9b34fb "
+                      "0000110e-0000-1000-8000-00805f9b34fb");
+    config_set_int(config.get(), section, "LinkKeyType", 5);
+    config_set_int(config.get(), section, "PinLength", 0);
+    config_set_string(config.get(), section, "LinkKey",
+                      "0123456789abcdef0123456789abcdef");
+    config_set_string(config.get(), section, "LE_KEY_PENC",
+                      "0123456789abcdef0123456789abcdef0123456789abcdef0123");
+    config_set_string(config.get(), section, "LE_KEY_PID",
+                      "0123456789abcdef0123456789abcdef0123456789abcdef");
+    config_set_int(config.get(), section, "Timestamp", 1700000000 + i);
+  }
+  return config;
+}
+
+class BM_Config : public ::benchmark::Fixture {
+ protected:
+  void SetUp(State& st) override {
+    benchmark::Fixture::SetUp(st);
+    config_ = make_config();
+    CHECK(config_save(*config_, kConfigFile.string()));
+    for (int i = 0; i < NUM_DEVICES; i++) {
+      sections_.push_back(device_section(i));
+    }
+  }
+  void TearDown(State& st) override {
+    std::filesystem::remove(kConfigFile);
+    config_.reset();
+    sections_.clear();
+    benchmark::Fixture::TearDown(st);
+  }
+  std::unique_ptr<config_t> config_;
+  std::vector<std::string> sections_;
+};
+
+BENCHMARK_DEFINE_F(BM_Config, config_new)(State& state) {
+  for (auto _ : state) {
+    std::unique_ptr<config_t> config = config_new(kConfigFile.c_str());
+    benchmark::DoNotOptimize(config);
+  }
+}
+BENCHMARK_REGISTER_F(BM_Config, config_new);
+
+BENCHMARK_DEFINE_F(BM_Config, config_get)(State& state) {
+  const std::string key = "Timestamp";
+  for (auto _ : state) {
+    for (const std::string& section : sections_) {
+      benchmark::DoNotOptimize(config_get_int(*config_, section, key, 0));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * NUM_DEVICES);
+}
+BENCHMARK_REGISTER_F(BM_Config, config_get);
+
+BENCHMARK_DEFINE_F(BM_Config, config_set)(State& state) {
+  const std::string key = "Timestamp";
+  int value = 0;
+  for (auto _ : state) {
+    for (const std::string& section : sections_) {
+      config_set_int(config_.get(), section, key, value++);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * NUM_DEVICES);
+}
+BENCHMARK_REGISTER_F(BM_Config, config_set);
+
+int main(int argc, char** argv) {
+  // Disable LOG() output from libchrome
+  logging::LoggingSettings log_settings;
+  log_settings.logging_dest = logging::LoggingDestination::LOG_NONE;
+  CHECK(logging::InitLogging(log_settings)) << "Failed to set up logging";
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  ::benchmark::RunSpecifiedBenchmarks();
+}
@@ -19,6 +19,7 @@
 #include <base/threading/thread.h>
 #include <benchmark/benchmark.h>
 #include <future>
+#include <vector>
 
 #include "common/message_loop_thread.h"
 #include "common/once_timer.h"
@@ -98,6 +99,45 @@ BENCHMARK_REGISTER_F(BM_OsiAlarmTimer, timer_performance_ms)
     ->Iterations(1)
     ->UseManualTime();
 
+class BM_OsiManyAlarms : public ::benchmark::Fixture {
+ protected:
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    for (int i = 0; i < st.range(0); i++) {
+      alarms_.push_back(alarm_new("osi_many_alarms_test"));
+    }
+  }
+
+  void TearDown(State& st) override {
+    for (alarm_t* alarm : alarms_) alarm_free(alarm);
+    alarms_.clear();
+    ::benchmark::Fixture::TearDown(st);
+  }
+
+  std::vector<alarm_t*> alarms_;
+};
+
+// Sets, re-arms and cancels many pending alarms. The intervals are long
+// enough that none of them fire, so this measures the cost of keeping the
+// pending alarms ordered.
+BENCHMARK_DEFINE_F(BM_OsiManyAlarms, set_reset_cancel)(State& state) {
+  for (auto _ : state) {
+    for (size_t i = 0; i < alarms_.size(); i++) {
+      alarm_set(alarms_[i], 10000 + 7 * i, &TimerFire, nullptr);
+    }
+    for (size_t i = 0; i < alarms_.size(); i++) {
+      alarm_set(alarms_[i], 20000 + 13 * i, &TimerFire, nullptr);
+    }
+    for (alarm_t* alarm : alarms_) alarm_cancel(alarm);
+  }
+  state.SetItemsProcessed(state.iterations() * alarms_.size() * 3);
+};
+
+BENCHMARK_REGISTER_F(BM_OsiManyAlarms, set_reset_cancel)
+    ->Arg(16)
+    ->Arg(1024)
+    ->Arg(4096);
+
 class BM_AlarmTaskTimer : public ::benchmark::Fixture {
  protected:
   void SetUp(State& st) override {
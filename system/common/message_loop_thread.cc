@@ -18,12 +18,14 @@
 
 #include <sys/syscall.h>
 #include <unistd.h>
+#include <mutex>
 #include <thread>
 
 #include <base/logging.h>
 #include <base/strings/stringprintf.h>
 
 #include "gd/common/init_flags.h"
+#include "gd/common/multi_priority_queue.h"
 #include "osi/include/log.h"
 
 namespace bluetooth {
@@ -32,6 +34,47 @@ namespace common {
 
 static constexpr int kRealTimeFifoSchedulingPriority = 1;
 
+class MessageLoopThread::TaskQueue {
+ public:
+  void Push(base::OnceClosure task, Priority priority) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push(std::move(task), static_cast<int>(priority));
+  }
+
+  void RunNext() {
+    base::OnceClosure task;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (queue_.empty()) return;
+      task = std::move(queue_.front());
+      queue_.pop();
+    }
+    std::move(task).Run();
+  }
+
+  static void RunNextOf(std::shared_ptr<TaskQueue> queue) { queue->RunNext(); }
+
+  // Closure posted for a delayed task, which starts waiting once it runs
+  static void PushAndRunNext(std::shared_ptr<TaskQueue> queue,
+                             Priority priority, base::OnceClosure task) {
+    queue->Push(std::move(task), priority);
+    queue->RunNext();
+  }
+
+ private:
+  std::mutex mutex_;
+  MultiPriorityQueue<base::OnceClosure, 3> queue_;
+};
+
+static void RunInstrumentedTask(
+    std::shared_ptr<TaskStats> task_stats, const base::Location& from_here,
+    std::chrono::steady_clock::time_point due_time, base::OnceClosure task) {
+  auto begin = std::chrono::steady_clock::now();
+  std::move(task).Run();
+  task_stats->RecordTask(from_here, begin - due_time,
+                         std::chrono::steady_clock::now() - begin);
+}
+
 MessageLoopThread::MessageLoopThread(const std::string& thread_name)
     : MessageLoopThread(thread_name, false) {}
 
@@ -78,13 +121,34 @@ void MessageLoopThread::StartUp() {
 
 bool MessageLoopThread::DoInThread(const base::Location& from_here,
                                    base::OnceClosure task) {
-  return DoInThreadDelayed(from_here, std::move(task), base::TimeDelta());
+  return DoInThreadDelayed(from_here, std::move(task), base::TimeDelta(),
+                           Priority::NORMAL);
+}
+
+bool MessageLoopThread::DoInThread(const base::Location& from_here,
+                                   base::OnceClosure task, Priority priority) {
+  return DoInThreadDelayed(from_here, std::move(task), base::TimeDelta(),
+                           priority);
 }
 
 bool MessageLoopThread::DoInThreadDelayed(const base::Location& from_here,
                                           base::OnceClosure task,
                                           const base::TimeDelta& delay) {
+  return DoInThreadDelayed(from_here, std::move(task), delay,
+                           Priority::NORMAL);
+}
+
+bool MessageLoopThread::DoInThreadDelayed(const base::Location& from_here,
+                                          base::OnceClosure task,
+                                          const base::TimeDelta& delay,
+                                          Priority priority) {
   std::lock_guard<std::recursive_mutex> api_lock(api_mutex_);
+  if (task_stats_ != nullptr) {
+    auto due_time = std::chrono::steady_clock::now() +
+                    std::chrono::microseconds(delay.InMicroseconds());
+    task = base::BindOnce(&RunInstrumentedTask, task_stats_, from_here,
+                          due_time, std::move(task));
+  }
   if (is_main_ && init_flags::gd_rust_is_enabled()) {
     if (rust_thread_ == nullptr) {
       LOG(ERROR) << __func__ << ": rust thread is null for thread " << *this
@@ -104,8 +168,19 @@ bool MessageLoopThread::DoInThreadDelayed(const base::Location& from_here,
                << ", from " << from_here.ToString();
     return false;
   }
-  if (!message_loop_->task_runner()->PostDelayedTask(from_here, std::move(task),
-                                                     delay)) {
+  bool posted;
+  if (delay.is_zero()) {
+    task_queue_->Push(std::move(task), priority);
+    posted = message_loop_->task_runner()->PostTask(
+        from_here, base::BindOnce(&TaskQueue::RunNextOf, task_queue_));
+  } else {
+    posted = message_loop_->task_runner()->PostDelayedTask(
+        from_here,
+        base::BindOnce(&TaskQueue::PushAndRunNext, task_queue_, priority,
+                       std::move(task)),
+        delay);
+  }
+  if (!posted) {
     LOG(ERROR) << __func__
                << ": failed to post task to message loop for thread " << *this
                << ", from " << from_here.ToString();
@@ -211,6 +286,26 @@ bool MessageLoopThread::EnableRealTimeScheduling() {
   return true;
 }
 
+void MessageLoopThread::EnableTaskStats(
+    std::chrono::milliseconds queueing_delay_alarm) {
+  std::lock_guard<std::recursive_mutex> api_lock(api_mutex_);
+  if (task_stats_ == nullptr) {
+    task_stats_ = std::make_shared<TaskStats>(thread_name_);
+  }
+  task_stats_->SetQueueingDelayAlarm(queueing_delay_alarm);
+}
+
+void MessageLoopThread::DumpTaskStats(int fd) const {
+  std::shared_ptr<TaskStats> task_stats;
+  {
+    std::lock_guard<std::recursive_mutex> api_lock(api_mutex_);
+    task_stats = task_stats_;
+  }
+  if (task_stats != nullptr) {
+    task_stats->Dump(fd);
+  }
+}
+
 base::WeakPtr<MessageLoopThread> MessageLoopThread::GetWeakPtr() {
   std::lock_guard<std::recursive_mutex> api_lock(api_mutex_);
   return weak_ptr_factory_.GetWeakPtr();
@@ -228,6 +323,7 @@ void MessageLoopThread::Run(std::promise<void> start_up_promise) {
     base::PlatformThread::SetName(thread_name_);
     message_loop_ = new btbase::AbstractMessageLoop();
     run_loop_ = new base::RunLoop();
+    task_queue_ = std::make_shared<TaskQueue>();
     thread_id_ = base::PlatformThread::CurrentId();
     linux_tid_ = static_cast<pid_t>(syscall(SYS_gettid));
     start_up_promise.set_value();
@@ -244,6 +340,7 @@ void MessageLoopThread::Run(std::promise<void> start_up_promise) {
     message_loop_ = nullptr;
     delete run_loop_;
     run_loop_ = nullptr;
+    task_queue_.reset();
     LOG(INFO) << __func__ << ": message loop finished for thread "
               << thread_name_;
   }
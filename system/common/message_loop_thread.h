@@ -17,6 +17,7 @@
 #pragma once
 
 #include <unistd.h>
+#include <chrono>
 #include <future>
 #include <memory>
 #include <string>
@@ -29,6 +30,7 @@
 #include "src/message_loop_thread.rs.h"
 
 #include "abstract_message_loop.h"
+#include "common/task_stats.h"
 
 namespace bluetooth {
 
@@ -48,6 +50,14 @@ class MessageLoopThread final {
   explicit MessageLoopThread(const std::string& thread_name);
   explicit MessageLoopThread(const std::string& thread_name, bool is_main);
 
+  /**
+   * Priority of a task among the ones waiting to run on this thread. A task
+   * runs before all the waiting tasks of lower priority, and after the ones of
+   * its priority that were posted before it. Delayed tasks start waiting once
+   * their delay expired.
+   */
+  enum class Priority : int { LOW = 0, NORMAL = 1, HIGH = 2 };
+
   MessageLoopThread(const MessageLoopThread&) = delete;
   MessageLoopThread& operator=(const MessageLoopThread&) = delete;
 
@@ -75,6 +85,18 @@ class MessageLoopThread final {
    */
   bool DoInThread(const base::Location& from_here, base::OnceClosure task);
 
+  /**
+   * Post a task to run on this thread with a given priority
+   *
+   * @param from_here location where this task is originated
+   * @param task task created through base::Bind()
+   * @param priority priority of the task over the other waiting tasks
+   * @return true if task is successfully scheduled, false if task cannot be
+   * scheduled
+   */
+  bool DoInThread(const base::Location& from_here, base::OnceClosure task,
+                  Priority priority);
+
   /**
    * Shutdown the current thread as if it is never started. IsRunning() and
    * DoInThread() will return false after this call. Blocks until the thread is
@@ -169,6 +191,38 @@ class MessageLoopThread final {
   bool DoInThreadDelayed(const base::Location& from_here,
                          base::OnceClosure task, const base::TimeDelta& delay);
 
+  /**
+   * Post a task to run on this thread with a given priority after a specified
+   * delay
+   *
+   * @param from_here location where this task is originated
+   * @param task task created through base::Bind()
+   * @param delay delay for the task to be executed
+   * @param priority priority of the task over the other waiting tasks
+   * @return true if task is successfully scheduled, false if task cannot be
+   * scheduled
+   */
+  bool DoInThreadDelayed(const base::Location& from_here,
+                         base::OnceClosure task, const base::TimeDelta& delay,
+                         Priority priority);
+
+  /**
+   * Instrument the tasks posted from now on: the time they wait in the queue
+   * and the time they run are aggregated by the location they were posted
+   * from, see TaskStats.
+   *
+   * @param queueing_delay_alarm log the tasks that waited longer than this,
+   * disabled when zero
+   */
+  void EnableTaskStats(std::chrono::milliseconds queueing_delay_alarm);
+
+  /**
+   * Dump the task stats of this thread, nothing when they are not enabled
+   *
+   * @param fd file descriptor to dump to
+   */
+  void DumpTaskStats(int fd) const;
+
  private:
   /**
    * Static method to run the thread
@@ -202,6 +256,14 @@ class MessageLoopThread final {
   bool shutting_down_;
   bool is_main_;
   ::rust::Box<shim::rust::MessageLoopThread>* rust_thread_ = nullptr;
+  // Shared with the instrumented tasks, which may outlive the thread
+  std::shared_ptr<TaskStats> task_stats_;
+  // Tasks waiting to run, by priority. Each one has a closure posted to the
+  // message loop, which runs the waiting task of highest priority. A new queue
+  // is made each time the thread starts, so that the tasks left when it shut
+  // down are dropped with their message loop
+  class TaskQueue;
+  std::shared_ptr<TaskQueue> task_queue_;
 };
 
 inline std::ostream& operator<<(std::ostream& os,
@@ -16,8 +16,10 @@
 #include "message_loop_thread.h"
 
 #include <condition_variable>
+#include <future>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -328,3 +330,42 @@ TEST_F(MessageLoopThreadTest, shut_down_start_up_multi_thread) {
   auto thread = std::thread(&MessageLoopThread::StartUp, &message_loop_thread);
   thread.join();
 }
+
+// Verify the waiting tasks run by priority, in posting order within a priority
+TEST_F(MessageLoopThreadTest, test_do_in_thread_with_priority) {
+  MessageLoopThread message_loop_thread("test_thread");
+  message_loop_thread.StartUp();
+
+  // Hold the thread until all the tasks are posted
+  std::promise<void> hold_promise;
+  std::shared_future<void> hold_future = hold_promise.get_future().share();
+  message_loop_thread.DoInThread(
+      FROM_HERE,
+      base::BindOnce([](std::shared_future<void> future) { future.wait(); },
+                     hold_future));
+
+  std::vector<int> order;
+  auto append = [](std::vector<int>* order, int value) {
+    order->push_back(value);
+  };
+  message_loop_thread.DoInThread(FROM_HERE, base::BindOnce(append, &order, 1),
+                                 MessageLoopThread::Priority::LOW);
+  message_loop_thread.DoInThread(FROM_HERE, base::BindOnce(append, &order, 2));
+  message_loop_thread.DoInThread(FROM_HERE, base::BindOnce(append, &order, 3),
+                                 MessageLoopThread::Priority::HIGH);
+  message_loop_thread.DoInThread(FROM_HERE, base::BindOnce(append, &order, 4));
+  message_loop_thread.DoInThread(FROM_HERE, base::BindOnce(append, &order, 5),
+                                 MessageLoopThread::Priority::HIGH);
+
+  std::promise<void> done_promise;
+  auto done_future = done_promise.get_future();
+  message_loop_thread.DoInThread(
+      FROM_HERE,
+      base::BindOnce([](std::promise<void> promise) { promise.set_value(); },
+                     std::move(done_promise)),
+      MessageLoopThread::Priority::LOW);
+  hold_promise.set_value();
+  done_future.wait();
+
+  EXPECT_EQ(std::vector<int>({3, 5, 2, 4, 1}), order);
+}
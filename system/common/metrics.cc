@@ -970,6 +970,18 @@ void LogLeAudioConnectionSessionReported(
   }
 }
 
+void LogBluetoothStartupPhase(int32_t phase_type, const std::string& phase_name,
+                              int64_t offset_nanos, int64_t duration_nanos) {
+  int ret = stats_write(BLUETOOTH_STARTUP_PHASE_REPORTED, phase_type,
+                        phase_name.c_str(), offset_nanos, duration_nanos);
+  if (ret < 0) {
+    LOG(WARNING) << __func__ << ": failed for phase " << phase_name
+                 << ", phase_type " << phase_type << ", offset_nanos "
+                 << offset_nanos << ", duration_nanos " << duration_nanos
+                 << ", error " << ret;
+  }
+}
+
 }  // namespace common
 
 }  // namespace bluetooth
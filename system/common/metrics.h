@@ -518,6 +518,17 @@ void LogLeAudioConnectionSessionReported(
     std::vector<int64_t>& streaming_duration_nanos,
     std::vector<int32_t>& streaming_context_type);
 
+/**
+ * Logs one phase of the last Bluetooth enable, see StartupTrace
+ *
+ * @param phase_type kind of work done by the phase
+ * @param phase_name name of the phase, or of the module it started
+ * @param offset_nanos time from the beginning of the enable to the phase
+ * @param duration_nanos time the phase took
+ */
+void LogBluetoothStartupPhase(int32_t phase_type, const std::string& phase_name,
+                              int64_t offset_nanos, int64_t duration_nanos);
+
 }  // namespace common
 
 }  // namespace bluetooth
@@ -167,6 +167,9 @@ void LogLeAudioConnectionSessionReported(
     std::vector<int64_t>& streaming_duration_nanos,
     std::vector<int32_t>& streaming_context_type) {}
 
+void LogBluetoothStartupPhase(int32_t phase_type, const std::string& phase_name,
+                              int64_t offset_nanos, int64_t duration_nanos) {}
+
 }  // namespace common
 
 }  // namespace bluetooth
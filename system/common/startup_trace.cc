@@ -0,0 +1,179 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "BtStartupTrace"
+
+#include "common/startup_trace.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <utility>
+
+#include "common/metrics.h"
+#include "osi/include/log.h"
+
+namespace bluetooth {
+namespace common {
+
+namespace {
+
+const char* phase_type_text(StartupPhaseType type) {
+  switch (type) {
+    case StartupPhaseType::STACK:
+      return "stack";
+    case StartupPhaseType::LEGACY_MODULE:
+      return "module";
+    case StartupPhaseType::GD_MODULE:
+      return "gd module";
+    case StartupPhaseType::PROFILE:
+      return "profile";
+  }
+  return "unknown";
+}
+
+double to_milliseconds(std::chrono::steady_clock::duration duration) {
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+int64_t to_nanoseconds(std::chrono::steady_clock::duration duration) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+}
+
+std::string timestamp_text(std::chrono::system_clock::time_point timestamp) {
+  auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    timestamp.time_since_epoch()) %
+                1000;
+  auto time_t_timestamp = std::chrono::system_clock::to_time_t(timestamp);
+  std::stringstream ss;
+  ss << std::put_time(std::localtime(&time_t_timestamp), "%Y-%m-%d %H:%M:%S");
+  ss << '.' << std::setfill('0') << std::setw(3) << millis.count();
+  return ss.str();
+}
+
+}  // namespace
+
+StartupTrace& StartupTrace::GetInstance() {
+  static StartupTrace instance;
+  return instance;
+}
+
+void StartupTrace::Begin() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  tracing_ = true;
+  timestamp_ = std::chrono::system_clock::now();
+  begin_ = std::chrono::steady_clock::now();
+  phases_.clear();
+}
+
+void StartupTrace::AddPhase(StartupPhaseType type, std::string name,
+                            std::chrono::steady_clock::time_point begin,
+                            std::chrono::steady_clock::time_point end) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!tracing_) {
+    return;
+  }
+  phases_.push_back(StartupPhase{type, std::move(name), begin, end});
+}
+
+void StartupTrace::End(bool success) {
+  std::vector<StartupPhase> phases;
+  std::chrono::steady_clock::time_point begin;
+  std::chrono::steady_clock::duration duration;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!tracing_) {
+      return;
+    }
+    tracing_ = false;
+    begin = begin_;
+    duration = std::chrono::steady_clock::now() - begin_;
+    enables_.push_back(Enable{timestamp_, duration, success});
+    if (enables_.size() > kEnableHistorySize) {
+      enables_.pop_front();
+    }
+    phases = phases_;
+  }
+
+  LOG_INFO("Bluetooth enable %s in %.1f ms, %zu phases",
+           success ? "completed" : "failed", to_milliseconds(duration),
+           phases.size());
+  if (!success) {
+    return;
+  }
+  LogBluetoothStartupPhase(static_cast<int32_t>(StartupPhaseType::STACK),
+                           "enable", 0, to_nanoseconds(duration));
+  for (const auto& phase : phases) {
+    LogBluetoothStartupPhase(static_cast<int32_t>(phase.type), phase.name,
+                             to_nanoseconds(phase.begin - begin),
+                             to_nanoseconds(phase.end - phase.begin));
+  }
+}
+
+std::vector<StartupPhase> StartupTrace::GetPhases() const {
+  std::vector<StartupPhase> phases;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    phases = phases_;
+  }
+  std::stable_sort(phases.begin(), phases.end(),
+                   [](const StartupPhase& a, const StartupPhase& b) {
+                     return a.begin < b.begin;
+                   });
+  return phases;
+}
+
+void StartupTrace::Dump(int fd) const {
+  std::chrono::steady_clock::time_point begin;
+  std::deque<Enable> enables;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    begin = begin_;
+    enables = enables_;
+  }
+  auto phases = GetPhases();
+
+  dprintf(fd, "\nBluetooth Startup Trace:\n");
+  dprintf(fd, "  Last enables:\n");
+  for (const auto& enable : enables) {
+    dprintf(fd, "    %s %s in %.1f ms\n",
+            timestamp_text(enable.timestamp).c_str(),
+            enable.success ? "completed" : "failed",
+            to_milliseconds(enable.duration));
+  }
+  dprintf(fd, "  Phases of the last enable (offset, duration, type, name):\n");
+  for (const auto& phase : phases) {
+    dprintf(fd, "    %9.1f ms %9.1f ms  %-9s  %s\n",
+            to_milliseconds(phase.begin - begin),
+            to_milliseconds(phase.end - phase.begin),
+            phase_type_text(phase.type), phase.name.c_str());
+  }
+}
+
+ScopedStartupPhase::ScopedStartupPhase(StartupPhaseType type, std::string name)
+    : type_(type),
+      name_(std::move(name)),
+      begin_(std::chrono::steady_clock::now()) {}
+
+ScopedStartupPhase::~ScopedStartupPhase() {
+  StartupTrace::GetInstance().AddPhase(type_, std::move(name_), begin_,
+                                       std::chrono::steady_clock::now());
+}
+
+}  // namespace common
+}  // namespace bluetooth
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace bluetooth {
+namespace common {
+
+// Kind of work done by a phase of the enable
+enum class StartupPhaseType : int32_t {
+  STACK = 1,          // A step of the legacy stack start up
+  LEGACY_MODULE = 2,  // The init or start up of a btcore module_t
+  GD_MODULE = 3,      // The Start() of a gd module
+  PROFILE = 4,        // The init of the profiles once the controller is up
+};
+
+struct StartupPhase {
+  StartupPhaseType type;
+  std::string name;
+  std::chrono::steady_clock::time_point begin;
+  std::chrono::steady_clock::time_point end;
+};
+
+/**
+ * Records where the time of the Bluetooth enable goes. The phases of the
+ * enable being traced are collected from Begin() to End(), then logged to
+ * statsd and kept for dumpsys until the next enable. Phases may overlap: the
+ * start up of a module includes the phases it runs itself.
+ */
+class StartupTrace {
+ public:
+  static StartupTrace& GetInstance();
+
+  // Drop the phases of the previous enable and start tracing a new one
+  void Begin();
+
+  // Add a phase to the enable being traced, ignored when none is
+  void AddPhase(StartupPhaseType type, std::string name,
+                std::chrono::steady_clock::time_point begin,
+                std::chrono::steady_clock::time_point end);
+
+  // End the enable being traced, |success| when the stack came up
+  void End(bool success);
+
+  // The phases of the last enable, ordered by their beginning
+  std::vector<StartupPhase> GetPhases() const;
+
+  void Dump(int fd) const;
+
+  // Durations of the last enables kept for dumpsys
+  static constexpr size_t kEnableHistorySize = 8;
+
+ private:
+  struct Enable {
+    std::chrono::system_clock::time_point timestamp;
+    std::chrono::steady_clock::duration duration;
+    bool success;
+  };
+
+  mutable std::mutex mutex_;
+  bool tracing_ = false;
+  std::chrono::system_clock::time_point timestamp_;
+  std::chrono::steady_clock::time_point begin_;
+  std::vector<StartupPhase> phases_;
+  std::deque<Enable> enables_;
+};
+
+// Adds the time from its construction to its destruction as a phase
+class ScopedStartupPhase {
+ public:
+  ScopedStartupPhase(StartupPhaseType type, std::string name);
+  ~ScopedStartupPhase();
+
+  ScopedStartupPhase(const ScopedStartupPhase&) = delete;
+  ScopedStartupPhase& operator=(const ScopedStartupPhase&) = delete;
+
+ private:
+  StartupPhaseType type_;
+  std::string name_;
+  std::chrono::steady_clock::time_point begin_;
+};
+
+}  // namespace common
+}  // namespace bluetooth
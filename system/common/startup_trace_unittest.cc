@@ -0,0 +1,58 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/startup_trace.h"
+
+#include <gtest/gtest.h>
+
+using bluetooth::common::ScopedStartupPhase;
+using bluetooth::common::StartupPhaseType;
+using bluetooth::common::StartupTrace;
+
+TEST(StartupTraceTest, phases_are_ignored_outside_of_an_enable) {
+  StartupTrace& trace = StartupTrace::GetInstance();
+  trace.Begin();
+  trace.End(true);
+  { ScopedStartupPhase phase(StartupPhaseType::STACK, "late"); }
+  EXPECT_TRUE(trace.GetPhases().empty());
+}
+
+TEST(StartupTraceTest, phases_are_ordered_by_beginning) {
+  StartupTrace& trace = StartupTrace::GetInstance();
+  trace.Begin();
+  auto now = std::chrono::steady_clock::now();
+  trace.AddPhase(StartupPhaseType::GD_MODULE, "second",
+                 now + std::chrono::milliseconds(2),
+                 now + std::chrono::milliseconds(3));
+  trace.AddPhase(StartupPhaseType::LEGACY_MODULE, "first", now,
+                 now + std::chrono::milliseconds(4));
+  trace.End(true);
+
+  auto phases = trace.GetPhases();
+  ASSERT_EQ(2u, phases.size());
+  EXPECT_EQ("first", phases[0].name);
+  EXPECT_EQ(StartupPhaseType::LEGACY_MODULE, phases[0].type);
+  EXPECT_EQ("second", phases[1].name);
+
+  // The next enable starts from scratch
+  trace.Begin();
+  { ScopedStartupPhase phase(StartupPhaseType::PROFILE, "profile"); }
+  phases = trace.GetPhases();
+  ASSERT_EQ(1u, phases.size());
+  EXPECT_EQ("profile", phases[0].name);
+  EXPECT_LE(phases[0].begin, phases[0].end);
+  trace.End(false);
+}
@@ -0,0 +1,149 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#define LOG_TAG "BtTaskStats"
+
+#include "common/task_stats.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "osi/include/log.h"
+
+namespace bluetooth {
+namespace common {
+
+namespace {
+
+double to_milliseconds(TaskStats::Duration duration) {
+  return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+void dump_table(int fd, const char* title,
+                const std::vector<TaskStats::LocationStats>& locations) {
+  dprintf(fd, "  %s:\n", title);
+  dprintf(fd,
+          "    %8s %12s %12s %12s %12s  %s\n", "count", "queue avg",
+          "queue max", "run avg", "run max", "posted from");
+  for (const auto& stats : locations) {
+    dprintf(fd, "    %8llu %9.3f ms %9.3f ms %9.3f ms %9.3f ms  %s\n",
+            static_cast<unsigned long long>(stats.count),
+            to_milliseconds(stats.total_queueing_delay) / stats.count,
+            to_milliseconds(stats.max_queueing_delay),
+            to_milliseconds(stats.total_run_time) / stats.count,
+            to_milliseconds(stats.max_run_time), stats.location.c_str());
+  }
+}
+
+}  // namespace
+
+TaskStats::TaskStats(std::string name) : name_(std::move(name)) {}
+
+void TaskStats::SetQueueingDelayAlarm(std::chrono::milliseconds threshold) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  queueing_delay_alarm_ = threshold;
+}
+
+void TaskStats::RecordTask(const base::Location& from_here,
+                           Duration queueing_delay, Duration run_time) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto key = std::make_tuple(from_here.function_name(), from_here.file_name(),
+                             from_here.line_number());
+  auto it = locations_.find(key);
+  if (it == locations_.end()) {
+    it = locations_.emplace(key, LocationStats{}).first;
+    it->second.location = from_here.ToString();
+  }
+  LocationStats& stats = it->second;
+  stats.count++;
+  stats.total_queueing_delay += queueing_delay;
+  stats.max_queueing_delay = std::max(stats.max_queueing_delay, queueing_delay);
+  stats.total_run_time += run_time;
+  stats.max_run_time = std::max(stats.max_run_time, run_time);
+
+  if (queueing_delay_alarm_ == Duration::zero()) {
+    return;
+  }
+  if (queueing_delay > queueing_delay_alarm_) {
+    alarm_count_++;
+    LOG_WARN(
+        "%s: task from %s waited %.1f ms, longest task since the last alarm "
+        "ran %.1f ms from %s",
+        name_.c_str(), stats.location.c_str(), to_milliseconds(queueing_delay),
+        to_milliseconds(longest_recent_run_time_),
+        longest_recent_location_ != nullptr ? longest_recent_location_->c_str()
+                                            : "none");
+    longest_recent_location_ = nullptr;
+    longest_recent_run_time_ = Duration::zero();
+  }
+  if (run_time > longest_recent_run_time_) {
+    longest_recent_location_ = &stats.location;
+    longest_recent_run_time_ = run_time;
+  }
+}
+
+std::vector<TaskStats::LocationStats> TaskStats::GetTopLocations(
+    Duration LocationStats::*key, size_t count) const {
+  std::vector<LocationStats> locations;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    locations.reserve(locations_.size());
+    for (const auto& location : locations_) {
+      locations.push_back(location.second);
+    }
+  }
+  count = std::min(count, locations.size());
+  std::partial_sort(locations.begin(), locations.begin() + count,
+                    locations.end(),
+                    [key](const LocationStats& a, const LocationStats& b) {
+                      return a.*key > b.*key;
+                    });
+  locations.resize(count);
+  return locations;
+}
+
+uint64_t TaskStats::GetAlarmCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return alarm_count_;
+}
+
+void TaskStats::Dump(int fd) const {
+  Duration alarm;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    alarm = queueing_delay_alarm_;
+  }
+  dprintf(fd, "\nTask stats of %s:\n", name_.c_str());
+  if (alarm != Duration::zero()) {
+    dprintf(fd, "  Tasks waiting more than %.0f ms: %llu\n",
+            to_milliseconds(alarm),
+            static_cast<unsigned long long>(GetAlarmCount()));
+  }
+  dump_table(fd, "Longest total run time",
+             GetTopLocations(&LocationStats::total_run_time,
+                             kDumpTopLocations));
+  dump_table(
+      fd, "Longest run",
+      GetTopLocations(&LocationStats::max_run_time, kDumpTopLocations));
+  dump_table(fd, "Longest queueing delay",
+             GetTopLocations(&LocationStats::max_queueing_delay,
+                             kDumpTopLocations));
+}
+
+}  // namespace common
+}  // namespace bluetooth
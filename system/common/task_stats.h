@@ -0,0 +1,86 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <base/location.h>
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace bluetooth {
+namespace common {
+
+/**
+ * Time the tasks of a message loop spend waiting in its queue and running,
+ * aggregated by the location they were posted from.
+ *
+ * When a queueing delay alarm is set, the tasks that waited longer than it are
+ * logged along with the longest task that ran since the previous alarm, which
+ * is most likely the one that held the loop.
+ */
+class TaskStats {
+ public:
+  using Duration = std::chrono::steady_clock::duration;
+
+  struct LocationStats {
+    std::string location;
+    uint64_t count = 0;
+    Duration total_queueing_delay{};
+    Duration max_queueing_delay{};
+    Duration total_run_time{};
+    Duration max_run_time{};
+  };
+
+  explicit TaskStats(std::string name);
+
+  // Log the tasks that waited longer than |threshold|, disabled when zero
+  void SetQueueingDelayAlarm(std::chrono::milliseconds threshold);
+
+  // Record a task posted from |from_here|, called once it ran
+  void RecordTask(const base::Location& from_here, Duration queueing_delay,
+                  Duration run_time);
+
+  // The |count| locations with the largest |key|, largest first
+  std::vector<LocationStats> GetTopLocations(
+      Duration LocationStats::*key, size_t count) const;
+
+  // Number of tasks that raised the queueing delay alarm
+  uint64_t GetAlarmCount() const;
+
+  static constexpr size_t kDumpTopLocations = 10;
+  void Dump(int fd) const;
+
+ private:
+  const std::string name_;
+  mutable std::mutex mutex_;
+  // Keyed by the function, file and line of the location, which are literals
+  std::map<std::tuple<const char*, const char*, int>, LocationStats>
+      locations_;
+  Duration queueing_delay_alarm_{};
+  uint64_t alarm_count_ = 0;
+  // Longest task that ran since the last alarm
+  const std::string* longest_recent_location_ = nullptr;
+  Duration longest_recent_run_time_{};
+};
+
+}  // namespace common
+}  // namespace bluetooth
@@ -0,0 +1,90 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/task_stats.h"
+
+#include <base/bind.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstring>
+#include <future>
+
+#include "common/message_loop_thread.h"
+
+using bluetooth::common::MessageLoopThread;
+using bluetooth::common::TaskStats;
+using std::chrono::milliseconds;
+
+TEST(TaskStatsTest, aggregated_by_location) {
+  TaskStats stats("test");
+  base::Location first = FROM_HERE;
+  base::Location second = FROM_HERE;
+  stats.RecordTask(first, milliseconds(1), milliseconds(10));
+  stats.RecordTask(first, milliseconds(3), milliseconds(20));
+  stats.RecordTask(second, milliseconds(5), milliseconds(15));
+
+  auto by_total_run_time =
+      stats.GetTopLocations(&TaskStats::LocationStats::total_run_time, 10);
+  ASSERT_EQ(2u, by_total_run_time.size());
+  EXPECT_EQ(2u, by_total_run_time[0].count);
+  EXPECT_EQ(milliseconds(30), by_total_run_time[0].total_run_time);
+  EXPECT_EQ(milliseconds(20), by_total_run_time[0].max_run_time);
+  EXPECT_EQ(milliseconds(4), by_total_run_time[0].total_queueing_delay);
+  EXPECT_EQ(milliseconds(3), by_total_run_time[0].max_queueing_delay);
+  EXPECT_EQ(first.ToString(), by_total_run_time[0].location);
+
+  auto by_max_queueing_delay =
+      stats.GetTopLocations(&TaskStats::LocationStats::max_queueing_delay, 1);
+  ASSERT_EQ(1u, by_max_queueing_delay.size());
+  EXPECT_EQ(second.ToString(), by_max_queueing_delay[0].location);
+}
+
+TEST(TaskStatsTest, queueing_delay_alarm) {
+  TaskStats stats("test");
+  stats.RecordTask(FROM_HERE, milliseconds(50), milliseconds(1));
+  EXPECT_EQ(0u, stats.GetAlarmCount());
+
+  stats.SetQueueingDelayAlarm(milliseconds(20));
+  stats.RecordTask(FROM_HERE, milliseconds(10), milliseconds(1));
+  stats.RecordTask(FROM_HERE, milliseconds(50), milliseconds(1));
+  EXPECT_EQ(1u, stats.GetAlarmCount());
+}
+
+TEST(TaskStatsTest, message_loop_thread_tasks) {
+  MessageLoopThread thread("task_stats_test_thread");
+  thread.StartUp();
+  thread.EnableTaskStats(milliseconds(0));
+
+  std::promise<void> promise;
+  auto future = promise.get_future();
+  base::Location from_here = FROM_HERE;
+  thread.DoInThread(from_here,
+                    base::BindOnce([](std::promise<void> promise) {
+                      promise.set_value();
+                    }, std::move(promise)));
+  future.wait();
+  thread.ShutDown();
+
+  // The stats are recorded once the task returned, which the shut down waits
+  int fd = fileno(tmpfile());
+  thread.DumpTaskStats(fd);
+  char buffer[4096] = {};
+  lseek(fd, 0, SEEK_SET);
+  ASSERT_GT(read(fd, buffer, sizeof(buffer) - 1), 0);
+  EXPECT_NE(nullptr, strstr(buffer, from_here.ToString().c_str()));
+}
@@ -46,6 +46,7 @@ typedef enum {
 #define ESCO_CODING_FORMAT_TRANSPNT ((uint8_t)0x03) /* Transparent  */
 #define ESCO_CODING_FORMAT_LINEAR ((uint8_t)0x04)   /* Linear PCM   */
 #define ESCO_CODING_FORMAT_MSBC ((uint8_t)0x05)     /* MSBC PCM   */
+#define ESCO_CODING_FORMAT_LC3 ((uint8_t)0x06)      /* LC3          */
 #define ESCO_CODING_FORMAT_VS ((uint8_t)0xFF)       /* Specifies VSC used */
 typedef uint8_t esco_coding_format_t;
 
@@ -21,13 +21,15 @@
 #include "device/include/interop.h"
 
 #include <base/logging.h>
-#include <string.h>  // For memcmp
+#include <string.h>  // For strncmp
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #include "btcore/include/module.h"
 #include "check.h"
 #include "device/include/interop_database.h"
-#include "osi/include/allocator.h"
-#include "osi/include/list.h"
 #include "osi/include/log.h"
 #include "types/raw_address.h"
 
@@ -35,15 +37,28 @@
   case const:                  \
     return #const;
 
-static list_t* interop_list = NULL;
+// Sources of an address prefix in the index
+#define INTEROP_SOURCE_FIXED 0x01
+#define INTEROP_SOURCE_DYNAMIC 0x02
+
+// All the address prefixes, fixed and dynamic, of all the features are hashed
+// in a single index keyed by feature, prefix length and prefix bytes. A lookup
+// costs one hash probe per prefix length in use, whatever the number of
+// entries.
+static std::mutex interop_mutex;
+static bool interop_fixed_indexed = false;
+static std::unordered_map<uint64_t, uint8_t /* sources */> interop_addr_index;
+// Bit |n| is set when a prefix of |n| bytes is in the index
+static uint8_t interop_addr_lengths = 0;
+static std::unordered_map<int, std::vector<const interop_name_entry_t*>>
+    interop_name_index;
 
 static const char* interop_feature_string_(const interop_feature_t feature);
-static void interop_free_entry_(void* data);
 static void interop_lazy_init_(void);
-static bool interop_match_fixed_(const interop_feature_t feature,
-                                 const RawAddress* addr);
-static bool interop_match_dynamic_(const interop_feature_t feature,
-                                   const RawAddress* addr);
+static uint64_t interop_addr_key_(uint16_t feature, const RawAddress* addr,
+                                  size_t length);
+static void interop_index_addr_(uint16_t feature, const RawAddress* addr,
+                                size_t length, uint8_t source);
 
 // Interface functions
 
@@ -51,32 +66,43 @@ bool interop_match_addr(const interop_feature_t feature,
                         const RawAddress* addr) {
   CHECK(addr);
 
-  if (interop_match_fixed_(feature, addr) ||
-      interop_match_dynamic_(feature, addr)) {
+  bool match = false;
+  {
+    std::lock_guard<std::mutex> lock(interop_mutex);
+    interop_lazy_init_();
+    for (size_t length = 1; length < RawAddress::kLength && !match;
+         ++length) {
+      if (interop_addr_lengths & (1 << length)) {
+        match = interop_addr_index.count(
+                    interop_addr_key_(feature, addr, length)) != 0;
+      }
+    }
+  }
+
+  if (match) {
     LOG_INFO("%s() Device %s is a match for interop workaround %s.", __func__,
              addr->ToString().c_str(), interop_feature_string_(feature));
-    return true;
   }
-
-  return false;
+  return match;
 }
 
 bool interop_match_name(const interop_feature_t feature, const char* name) {
   CHECK(name);
 
-  const size_t db_size =
-      sizeof(interop_name_database) / sizeof(interop_name_entry_t);
-  for (size_t i = 0; i != db_size; ++i) {
-    if (feature == interop_name_database[i].feature &&
-        strlen(name) >= interop_name_database[i].length &&
-        strncmp(name, interop_name_database[i].name,
-                interop_name_database[i].length) == 0) {
+  std::lock_guard<std::mutex> lock(interop_mutex);
+  interop_lazy_init_();
+  auto entries = interop_name_index.find(feature);
+  if (entries == interop_name_index.end()) return false;
+
+  const size_t name_length = strlen(name);
+  for (const interop_name_entry_t* entry : entries->second) {
+    if (name_length >= entry->length &&
+        strncmp(name, entry->name, entry->length) == 0) {
       LOG_INFO("%s() Device %s is a match for interop workaround %s.", __func__,
                name, interop_feature_string_(feature));
       return true;
     }
   }
-
   return false;
 }
 
@@ -86,25 +112,31 @@ void interop_database_add(uint16_t feature, const RawAddress* addr,
   CHECK(length > 0);
   CHECK(length < RawAddress::kLength);
 
-  interop_addr_entry_t* entry = static_cast<interop_addr_entry_t*>(
-      osi_calloc(sizeof(interop_addr_entry_t)));
-  memcpy(&entry->addr, addr, length);
-  entry->feature = static_cast<interop_feature_t>(feature);
-  entry->length = length;
-
+  std::lock_guard<std::mutex> lock(interop_mutex);
   interop_lazy_init_();
-  list_append(interop_list, entry);
+  interop_index_addr_(feature, addr, length, INTEROP_SOURCE_DYNAMIC);
 }
 
 void interop_database_clear() {
-  if (interop_list) list_clear(interop_list);
+  std::lock_guard<std::mutex> lock(interop_mutex);
+  for (auto it = interop_addr_index.begin(); it != interop_addr_index.end();) {
+    it->second &= ~INTEROP_SOURCE_DYNAMIC;
+    if (it->second == 0) {
+      it = interop_addr_index.erase(it);
+    } else {
+      ++it;
+    }
+  }
 }
 
 // Module life-cycle functions
 
 static future_t* interop_clean_up(void) {
-  list_free(interop_list);
-  interop_list = NULL;
+  std::lock_guard<std::mutex> lock(interop_mutex);
+  interop_addr_index.clear();
+  interop_addr_lengths = 0;
+  interop_name_index.clear();
+  interop_fixed_indexed = false;
   return future_new_immediate(FUTURE_SUCCESS);
 }
 
@@ -144,49 +176,33 @@ static const char* interop_feature_string_(const interop_feature_t feature) {
   return "UNKNOWN";
 }
 
-static void interop_free_entry_(void* data) {
-  interop_addr_entry_t* entry = (interop_addr_entry_t*)data;
-  osi_free(entry);
-}
-
+// Indexes the fixed database on first use. Must be called with
+// |interop_mutex| held.
 static void interop_lazy_init_(void) {
-  if (interop_list == NULL) {
-    interop_list = list_new(interop_free_entry_);
-  }
-}
-
-static bool interop_match_dynamic_(const interop_feature_t feature,
-                                   const RawAddress* addr) {
-  if (interop_list == NULL || list_length(interop_list) == 0) return false;
-
-  const list_node_t* node = list_begin(interop_list);
-  while (node != list_end(interop_list)) {
-    interop_addr_entry_t* entry =
-        static_cast<interop_addr_entry_t*>(list_node(node));
-    CHECK(entry);
+  if (interop_fixed_indexed) return;
+  interop_fixed_indexed = true;
 
-    if (feature == entry->feature &&
-        memcmp(addr, &entry->addr, entry->length) == 0)
-      return true;
-
-    node = list_next(node);
+  for (const auto& entry : interop_addr_database) {
+    interop_index_addr_(entry.feature, &entry.addr, entry.length,
+                        INTEROP_SOURCE_FIXED);
+  }
+  for (const auto& entry : interop_name_database) {
+    interop_name_index[entry.feature].push_back(&entry);
   }
-  return false;
 }
 
-static bool interop_match_fixed_(const interop_feature_t feature,
-                                 const RawAddress* addr) {
-  CHECK(addr);
-
-  const size_t db_size =
-      sizeof(interop_addr_database) / sizeof(interop_addr_entry_t);
-  for (size_t i = 0; i != db_size; ++i) {
-    if (feature == interop_addr_database[i].feature &&
-        memcmp(addr, &interop_addr_database[i].addr,
-               interop_addr_database[i].length) == 0) {
-      return true;
-    }
+static uint64_t interop_addr_key_(uint16_t feature, const RawAddress* addr,
+                                  size_t length) {
+  uint64_t key = feature;
+  key = (key << 8) | length;
+  for (size_t i = 0; i != length; ++i) {
+    key = (key << 8) | addr->address[i];
   }
+  return key;
+}
 
-  return false;
+static void interop_index_addr_(uint16_t feature, const RawAddress* addr,
+                                size_t length, uint8_t source) {
+  interop_addr_index[interop_addr_key_(feature, addr, length)] |= source;
+  interop_addr_lengths |= 1 << length;
 }
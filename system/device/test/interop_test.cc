@@ -82,3 +82,16 @@ TEST(InteropTest, test_name_miss) {
   EXPECT_FALSE(interop_match_name(INTEROP_DISABLE_AUTO_PAIRING, "audi"));
   EXPECT_FALSE(interop_match_name(INTEROP_AUTO_RETRY_PAIRING, "BMW M3"));
 }
+
+TEST(InteropTest, test_dynamic_clear_keeps_fixed) {
+  RawAddress test_address;
+  RawAddress::FromString("9c:df:03:12:34:56", test_address);
+
+  interop_database_add(INTEROP_AUTO_RETRY_PAIRING, &test_address, 3);
+  interop_database_add(INTEROP_AUTO_RETRY_PAIRING, &test_address, 5);
+  interop_database_clear();
+  EXPECT_TRUE(interop_match_addr(INTEROP_AUTO_RETRY_PAIRING, &test_address));
+
+  RawAddress::FromString("9c:df:04:12:34:56", test_address);
+  EXPECT_FALSE(interop_match_addr(INTEROP_AUTO_RETRY_PAIRING, &test_address));
+}
@@ -136,6 +136,15 @@ extern "C" {
 g722_encode_state_t *g722_encode_init(g722_encode_state_t *s, unsigned int rate, int options);
 int g722_encode_release(g722_encode_state_t *s);
 int g722_encode(g722_encode_state_t *s, uint8_t g722_data[], const int16_t amp[], int len);
+/* Encode the same number of samples for two devices in one pass, e.g. the
+   left and right hearing aids. The output is the same as two g722_encode()
+   calls, the number of bytes written for each device is returned. */
+int g722_encode_dual(g722_encode_state_t *s0, g722_encode_state_t *s1,
+                     uint8_t g722_data0[], uint8_t g722_data1[],
+                     const int16_t amp0[], const int16_t amp1[], int len);
+/* Allow (default) or forbid the vectorized QMF and predictor. The output is
+   the same either way, this lets tests and benchmarks compare the paths. */
+void g722_encode_enable_simd(int enable);
 
 g722_decode_state_t *g722_decode_init(g722_decode_state_t *s, unsigned int rate, int options);
 int g722_decode_release(g722_decode_state_t *s);
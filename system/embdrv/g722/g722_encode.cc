@@ -32,6 +32,24 @@
 #include "g722_typedefs.h"
 #include "g722_enc_dec.h"
 
+/* The transmit QMF and the predictor adaptation are vectorized with NEON or
+   SSE2, unless G722_SIMD is defined to 0 by the build. */
+#if !defined(G722_SIMD)
+#if defined(__ARM_NEON) || defined(__SSE2__)
+#define G722_SIMD 1
+#else
+#define G722_SIMD 0
+#endif
+#endif
+
+#if G722_SIMD
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#else
+#include <emmintrin.h>
+#endif
+#endif
+
 #if !defined(FALSE)
 #define FALSE 0
 #endif
@@ -263,26 +281,599 @@ static int16_t qmf_coeffs[12] =
 {
        3,  -11,   12,   32, -210,  951, 3876, -805,  362, -156,   53,  -11,
 };
+#if G722_SIMD
+/* Pairs of input samples filtered per QMF block, and the history needed */
+#define QMF_BLOCK   (80)
+#define QMF_HISTORY (11)
+
+#if !defined(__ARM_NEON)
+/* qmf_coeffs as pairs of taps for _mm_madd_epi16, the first one in the low
+   half */
+#define QMF_PAIR(a, b) ((int32_t) ((uint16_t) (a) | ((uint32_t) (b) << 16)))
+static const int32_t qmf_pairs_odd[6] =
+{
+    QMF_PAIR(3, -11), QMF_PAIR(12, 32), QMF_PAIR(-210, 951),
+    QMF_PAIR(3876, -805), QMF_PAIR(362, -156), QMF_PAIR(53, -11),
+};
+static const int32_t qmf_pairs_even[6] =
+{
+    QMF_PAIR(-11, 53), QMF_PAIR(-156, 362), QMF_PAIR(-805, 3876),
+    QMF_PAIR(951, -210), QMF_PAIR(32, 12), QMF_PAIR(-11, 3),
+};
+#undef QMF_PAIR
+#endif
+#endif
 static int16_t ihn[3] = {0, 1, 0};
 static int16_t ihp[3] = {0, 3, 2};
 static int16_t wh[3] = {0, -214, 798};
 static int16_t rh2[4] = {2, 1, 2, 1};
 
-int g722_encode(g722_encode_state_t *s, uint8_t g722_data[],
-                       const int16_t amp[], int len)
+/* Blocks 1L to 3L: quantize the low band against the prediction |sl|.
+   Updates the scale factor, returns the quantized difference signal. */
+static __inline int quantize_low(g722_band_t *band, int sl, int xlow,
+                                 int *ilow)
 {
-    int dlow;
-    int dhigh;
     int el;
     int wd;
     int wd1;
-    int ril;
     int wd2;
-    int il4;
-    int ih2;
     int wd3;
+    int ril;
+    int il4;
+    int i;
+    int hi;
+    int mid;
+
+    /* Block 1L, SUBTRA */
+    el = saturate(xlow - sl);
+
+    /* Block 1L, QUANTL */
+    wd = (el >= 0)  ?  el  :  -(el + 1);
+
+    /* The decision levels grow with i (det > 0): binary search for the first
+       one above wd, same result as the linear search of the reference. */
+    i = 1;
+    hi = 30;
+    while (i < hi)
+    {
+        mid = (i + hi) >> 1;
+        wd1 = (q6[mid]*band->det) >> 12;
+        if (wd < wd1)
+            hi = mid;
+        else
+            i = mid + 1;
+    }
+    *ilow = (el < 0)  ?  iln[i]  :  ilp[i];
+
+    /* Block 2L, INVQAL */
+    ril = *ilow >> 2;
+    wd2 = qm4[ril];
+    wd3 = (band->det*wd2) >> 15;
+
+    /* Block 3L, LOGSCL */
+    il4 = rl42[ril];
+    wd = (band->nb*127) >> 7;
+    band->nb = wd + wl[il4];
+    if (band->nb < 0)
+        band->nb = 0;
+    else if (band->nb > 18432)
+        band->nb = 18432;
+
+    /* Block 3L, SCALEL */
+    wd1 = (band->nb >> 6) & 31;
+    wd2 = 8 - (band->nb >> 11);
+    wd = (wd2 < 0)  ?  (ilb[wd1] << -wd2)  :  (ilb[wd1] >> wd2);
+    band->det = wd << 2;
+    return wd3;
+}
+/*- End of function --------------------------------------------------------*/
+
+/* Blocks 1H to 3H: quantize the high band against the prediction |sh|.
+   Updates the scale factor, returns the quantized difference signal. */
+static __inline int quantize_high(g722_band_t *band, int sh, int xhigh,
+                                  int *ihigh)
+{
     int eh;
+    int wd;
+    int wd1;
+    int wd2;
+    int wd3;
     int mih;
+    int ih2;
+    int nb;
+    int dhigh;
+
+    /* Block 1H, SUBTRA */
+    eh = saturate(xhigh - sh);
+
+    /* Block 1H, QUANTH */
+    wd = (eh >= 0)  ?  eh  :  -(eh + 1);
+    wd1 = (564*band->det) >> 12;
+    mih = (wd >= wd1)  ?  2  :  1;
+    *ihigh = (eh < 0)  ?  ihn[mih]  :  ihp[mih];
+
+    /* Block 2H, INVQAH */
+    wd2 = qm2[*ihigh];
+    dhigh = (band->det*wd2) >> 15;
+
+    /* Block 3H, LOGSCH */
+    ih2 = rh2[*ihigh];
+    wd = (band->nb*127) >> 7;
+
+    nb = wd + wh[ih2];
+    if (nb < 0)
+        nb = 0;
+    else if (nb > 22528)
+        nb = 22528;
+    band->nb = nb;
+
+    /* Block 3H, SCALEH */
+    wd1 = (band->nb >> 6) & 31;
+    wd2 = 10 - (band->nb >> 11);
+    wd3 = (wd2 < 0)  ?  (ilb[wd1] << -wd2)  :  (ilb[wd1] >> wd2);
+    band->det = wd3 << 2;
+    return dhigh;
+}
+/*- End of function --------------------------------------------------------*/
+
+static __inline int make_code(int ilow, int ihigh)
+{
+#if   BITS_PER_SAMPLE == 8
+    return ((ihigh << 6) | ilow);
+#elif BITS_PER_SAMPLE == 7
+    return ((ihigh << 6) | ilow) >> 1;
+#elif BITS_PER_SAMPLE == 6
+    return ((ihigh << 6) | ilow) >> 2;
+#endif
+}
+/*- End of function --------------------------------------------------------*/
+
+/* Blocks 1L to 4H: ADPCM encode one pair of low and high band samples */
+static __inline int encode_bands(g722_encode_state_t *s, int xlow, int xhigh)
+{
+    int dlow;
+    int dhigh;
+    int ilow;
+    int ihigh;
+
+    dlow = quantize_low(&s->band[0], s->band[0].s, xlow, &ilow);
+    block4(&s->band[0], dlow);
+    dhigh = quantize_high(&s->band[1], s->band[1].s, xhigh, &ihigh);
+    block4(&s->band[1], dhigh);
+    return make_code(ilow, ihigh);
+}
+/*- End of function --------------------------------------------------------*/
+
+static __inline int put_code(g722_encode_state_t *s, uint8_t g722_data[],
+                             int g722_bytes, int code)
+{
+#if PACKED_OUTPUT == 1
+    /* Pack the code bits */
+    s->out_buffer |= (code << s->out_bits);
+    s->out_bits += s->bits_per_sample;
+    if (s->out_bits >= 8)
+    {
+        g722_data[g722_bytes++] = (uint8_t) (s->out_buffer & 0xFF);
+        s->out_bits -= 8;
+        s->out_buffer >>= 8;
+    }
+#else
+    (void) s;
+    g722_data[g722_bytes++] = (uint8_t) code;
+#endif
+    return g722_bytes;
+}
+/*- End of function --------------------------------------------------------*/
+
+#if G722_SIMD
+static int simd_enabled = TRUE;
+
+void g722_encode_enable_simd(int enable)
+{
+    simd_enabled = enable;
+}
+/*- End of function --------------------------------------------------------*/
+
+/* 4 x 32 bit lanes. The ADPCM state only holds 16 bit values, the products
+   of two of them are exact in 32 bits. */
+#if defined(__ARM_NEON)
+typedef int32x4_t v4;
+
+static __inline v4 v_load(const int32_t *p) { return vld1q_s32(p); }
+static __inline void v_store(int32_t *p, v4 a) { vst1q_s32(p, a); }
+static __inline v4 v_dup(int32_t a) { return vdupq_n_s32(a); }
+static __inline v4 v_add(v4 a, v4 b) { return vaddq_s32(a, b); }
+static __inline v4 v_sub(v4 a, v4 b) { return vsubq_s32(a, b); }
+static __inline v4 v_mul16(v4 a, v4 b) { return vmulq_s32(a, b); }
+static __inline v4 v_min(v4 a, v4 b) { return vminq_s32(a, b); }
+static __inline v4 v_max(v4 a, v4 b) { return vmaxq_s32(a, b); }
+static __inline v4 v_eq(v4 a, v4 b)
+{
+    return vreinterpretq_s32_u32(vceqq_s32(a, b));
+}
+static __inline v4 v_select(v4 mask, v4 a, v4 b)
+{
+    return vbslq_s32(vreinterpretq_u32_s32(mask), a, b);
+}
+static __inline v4 v_sat(v4 a) { return vmovl_s16(vqmovn_s32(a)); }
+#define v_sra(a, n) vshrq_n_s32((a), (n))
+#define v_sll(a, n) vshlq_n_s32((a), (n))
+#else
+typedef __m128i v4;
+
+static __inline v4 v_load(const int32_t *p)
+{
+    return _mm_loadu_si128((const __m128i *) p);
+}
+static __inline void v_store(int32_t *p, v4 a)
+{
+    _mm_storeu_si128((__m128i *) p, a);
+}
+static __inline v4 v_dup(int32_t a) { return _mm_set1_epi32(a); }
+static __inline v4 v_add(v4 a, v4 b) { return _mm_add_epi32(a, b); }
+static __inline v4 v_sub(v4 a, v4 b) { return _mm_sub_epi32(a, b); }
+/* 16 x 16 bit multiply: the high half of |b| is cleared, so that
+   _mm_madd_epi16 only adds the product of the low halves */
+static __inline v4 v_mul16(v4 a, v4 b)
+{
+    return _mm_madd_epi16(a, _mm_and_si128(b, _mm_set1_epi32(0xFFFF)));
+}
+static __inline v4 v_eq(v4 a, v4 b) { return _mm_cmpeq_epi32(a, b); }
+static __inline v4 v_select(v4 mask, v4 a, v4 b)
+{
+    return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+static __inline v4 v_min(v4 a, v4 b)
+{
+    return v_select(_mm_cmpgt_epi32(a, b), b, a);
+}
+static __inline v4 v_max(v4 a, v4 b)
+{
+    return v_select(_mm_cmpgt_epi32(a, b), a, b);
+}
+static __inline v4 v_sat(v4 a)
+{
+    v4 a16 = _mm_packs_epi32(a, a);
+    return _mm_srai_epi32(_mm_unpacklo_epi16(a16, a16), 16);
+}
+#define v_sra(a, n) _mm_srai_epi32((a), (n))
+#define v_sll(a, n) _mm_slli_epi32((a), (n))
+#endif
+
+/* The part of g722_band_t updated by block4, for 4 bands in parallel */
+typedef struct
+{
+    v4 s;
+    v4 sp;
+    v4 sz;
+    v4 r[3];
+    v4 a[3];
+    v4 p[3];
+    v4 d[7];
+    v4 b[7];
+} band_lanes_t;
+
+#define LANES 4
+
+static void lanes_load(band_lanes_t *l, g722_band_t *band[LANES])
+{
+    int32_t t[LANES];
+    int i;
+    int k;
+
+#define LOAD(dst, field) \
+    do { \
+        for (k = 0;  k < LANES;  k++) \
+            t[k] = band[k]->field; \
+        dst = v_load(t); \
+    } while (0)
+
+    LOAD(l->s, s);
+    LOAD(l->sp, sp);
+    LOAD(l->sz, sz);
+    for (i = 0;  i < 3;  i++)
+    {
+        LOAD(l->r[i], r[i]);
+        LOAD(l->a[i], a[i]);
+        LOAD(l->p[i], p[i]);
+    }
+    for (i = 0;  i < 7;  i++)
+    {
+        LOAD(l->d[i], d[i]);
+        LOAD(l->b[i], b[i]);
+    }
+#undef LOAD
+}
+/*- End of function --------------------------------------------------------*/
+
+static void lanes_store(const band_lanes_t *l, g722_band_t *band[LANES])
+{
+    int32_t t[LANES];
+    int i;
+    int k;
+
+#define STORE(src, field) \
+    do { \
+        v_store(t, src); \
+        for (k = 0;  k < LANES;  k++) \
+            band[k]->field = t[k]; \
+    } while (0)
+
+    STORE(l->s, s);
+    STORE(l->sp, sp);
+    STORE(l->sz, sz);
+    for (i = 0;  i < 3;  i++)
+    {
+        STORE(l->r[i], r[i]);
+        STORE(l->a[i], a[i]);
+        STORE(l->p[i], p[i]);
+    }
+    for (i = 0;  i < 7;  i++)
+    {
+        STORE(l->d[i], d[i]);
+        STORE(l->b[i], b[i]);
+    }
+    /* block4 leaves the updated coefficients in both copies */
+    for (i = 1;  i < 3;  i++)
+        STORE(l->a[i], ap[i]);
+    for (i = 1;  i < 7;  i++)
+        STORE(l->b[i], bp[i]);
+#undef STORE
+}
+/*- End of function --------------------------------------------------------*/
+
+/* block4 on 4 bands, same arithmetic as the scalar version */
+static __inline void block4_lanes(band_lanes_t *l, v4 d)
+{
+    v4 wd1;
+    v4 wd2;
+    v4 wd3;
+    v4 sg0;
+    v4 sg1;
+    v4 sg2;
+    v4 ap1;
+    v4 ap2;
+    v4 sz;
+    v4 bp[7];
+    int i;
+
+    /* Block 4, RECONS */
+    l->d[0] = d;
+    l->r[0] = v_sat(v_add(l->s, d));
+
+    /* Block 4, PARREC */
+    l->p[0] = v_sat(v_add(l->sz, d));
+
+    /* Block 4, UPPOL2 */
+    sg0 = v_sra(l->p[0], 15);
+    sg1 = v_sra(l->p[1], 15);
+    sg2 = v_sra(l->p[2], 15);
+    wd1 = v_sat(v_sll(l->a[1], 2));
+
+    wd2 = v_select(v_eq(sg0, sg1), v_sub(v_dup(0), wd1), wd1);
+    wd2 = v_min(wd2, v_dup(32767));
+
+    ap2 = v_add(v_sra(wd2, 7),
+                v_select(v_eq(sg0, sg2), v_dup(128), v_dup(-128)));
+    ap2 = v_add(ap2, v_sra(v_mul16(l->a[2], v_dup(32512)), 15));
+    ap2 = v_max(v_min(ap2, v_dup(12288)), v_dup(-12288));
+
+    /* Block 4, UPPOL1 */
+    wd1 = v_select(v_eq(sg0, sg1), v_dup(192), v_dup(-192));
+    wd2 = v_sra(v_mul16(l->a[1], v_dup(32640)), 15);
+
+    ap1 = v_sat(v_add(wd1, wd2));
+    wd3 = v_sat(v_sub(v_dup(15360), ap2));
+    ap1 = v_max(v_min(ap1, wd3), v_sub(v_dup(0), wd3));
+
+    /* Block 4, UPZERO */
+    /* Block 4, FILTEZ */
+    wd1 = v_select(v_eq(d, v_dup(0)), v_dup(0), v_dup(128));
+
+    sg0 = v_sra(d, 15);
+    for (i = 1;  i < 7;  i++)
+    {
+        wd2 = v_select(v_eq(v_sra(l->d[i], 15), sg0), wd1,
+                       v_sub(v_dup(0), wd1));
+        wd3 = v_sra(v_mul16(l->b[i], v_dup(32640)), 15);
+        bp[i] = v_sat(v_add(wd2, wd3));
+    }
+
+    /* Block 4, DELAYA */
+    sz = v_dup(0);
+    for (i = 6;  i > 0;  i--)
+    {
+        l->d[i] = l->d[i - 1];
+        l->b[i] = bp[i];
+        wd1 = v_sat(v_add(l->d[i], l->d[i]));
+        sz = v_add(sz, v_sra(v_mul16(l->b[i], wd1), 15));
+    }
+    l->sz = sz;
+
+    for (i = 2;  i > 0;  i--)
+    {
+        l->r[i] = l->r[i - 1];
+        l->p[i] = l->p[i - 1];
+    }
+    l->a[2] = ap2;
+    l->a[1] = ap1;
+
+    /* Block 4, FILTEP */
+    wd1 = v_sat(v_add(l->r[1], l->r[1]));
+    wd1 = v_sra(v_mul16(l->a[1], wd1), 15);
+    wd2 = v_sat(v_add(l->r[2], l->r[2]));
+    wd2 = v_sra(v_mul16(l->a[2], wd2), 15);
+    l->sp = v_sat(v_add(wd1, wd2));
+
+    /* Block 4, PREDIC */
+    l->s = v_sat(v_add(l->sp, l->sz));
+}
+/*- End of function --------------------------------------------------------*/
+
+/* Apply the transmit QMF to |pairs| pairs of samples, up to QMF_BLOCK.
+ *
+ * The even and odd input samples are split in two sequences, so that each
+ * band is the sum and difference of two 12 tap FIR filters over contiguous
+ * samples: 4 outputs are computed per iteration. The products and sums are
+ * exact in 32 bits, the result is the same as the scalar filter. */
+static void tx_qmf_block(g722_encode_state_t *s, const int16_t amp[],
+                         int pairs, int xlow[], int xhigh[])
+{
+    int16_t even[QMF_HISTORY + QMF_BLOCK];
+    int16_t odd[QMF_HISTORY + QMF_BLOCK];
+    int sumeven;
+    int sumodd;
+    int i;
+    int k;
+
+    /* The history is the last 22 input samples */
+    for (i = 0;  i < QMF_HISTORY;  i++)
+    {
+        even[i] = (int16_t) s->x[2*i + 2];
+        odd[i] = (int16_t) s->x[2*i + 3];
+    }
+    for (i = 0;  i < pairs;  i++)
+    {
+        even[QMF_HISTORY + i] = amp[2*i];
+        odd[QMF_HISTORY + i] = amp[2*i + 1];
+    }
+
+    k = 0;
+#if defined(__ARM_NEON)
+    for (  ;  k + 4 <= pairs;  k += 4)
+    {
+        int32x4_t accodd = vdupq_n_s32(0);
+        int32x4_t acceven = vdupq_n_s32(0);
+
+        for (i = 0;  i < 12;  i++)
+        {
+            accodd = vmlal_n_s16(accodd, vld1_s16(even + k + i), qmf_coeffs[i]);
+            acceven = vmlal_n_s16(acceven, vld1_s16(odd + k + i),
+                                  qmf_coeffs[11 - i]);
+        }
+        vst1q_s32(xlow + k, vshrq_n_s32(vaddq_s32(acceven, accodd), 14));
+        vst1q_s32(xhigh + k, vshrq_n_s32(vsubq_s32(acceven, accodd), 14));
+    }
+#else
+    for (  ;  k + 4 <= pairs;  k += 4)
+    {
+        __m128i accodd = _mm_setzero_si128();
+        __m128i acceven = _mm_setzero_si128();
+
+        /* Two taps per multiply-add */
+        for (i = 0;  i < 12;  i += 2)
+        {
+            __m128i e = _mm_unpacklo_epi16(
+                _mm_loadl_epi64((const __m128i *) (even + k + i)),
+                _mm_loadl_epi64((const __m128i *) (even + k + i + 1)));
+            __m128i o = _mm_unpacklo_epi16(
+                _mm_loadl_epi64((const __m128i *) (odd + k + i)),
+                _mm_loadl_epi64((const __m128i *) (odd + k + i + 1)));
+
+            accodd = _mm_add_epi32(accodd,
+                _mm_madd_epi16(e, _mm_set1_epi32(qmf_pairs_odd[i/2])));
+            acceven = _mm_add_epi32(acceven,
+                _mm_madd_epi16(o, _mm_set1_epi32(qmf_pairs_even[i/2])));
+        }
+        _mm_storeu_si128((__m128i *) (xlow + k),
+                         _mm_srai_epi32(_mm_add_epi32(acceven, accodd), 14));
+        _mm_storeu_si128((__m128i *) (xhigh + k),
+                         _mm_srai_epi32(_mm_sub_epi32(acceven, accodd), 14));
+    }
+#endif
+    for (  ;  k < pairs;  k++)
+    {
+        sumeven = 0;
+        sumodd = 0;
+        for (i = 0;  i < 12;  i++)
+        {
+            sumodd += even[k + i]*qmf_coeffs[i];
+            sumeven += odd[k + i]*qmf_coeffs[11 - i];
+        }
+        xlow[k] = (sumeven + sumodd) >> 14;
+        xhigh[k] = (sumeven - sumodd) >> 14;
+    }
+
+    /* Keep the last 24 samples, as the scalar filter does */
+    for (i = 0;  i < 12;  i++)
+    {
+        s->x[2*i] = even[pairs - 1 + i];
+        s->x[2*i + 1] = odd[pairs - 1 + i];
+    }
+}
+/*- End of function --------------------------------------------------------*/
+
+/* Encode |pairs| pairs of samples for |n| (1 or 2) devices.
+ *
+ * The low and high bands of the devices are adapted in the lanes of the
+ * vectorized block4, only the quantizers run once per band. */
+static int encode_lanes(g722_encode_state_t *s[2], int n,
+                        uint8_t *g722_data[2], const int16_t *amp[2],
+                        int pairs)
+{
+    int xlow[2][QMF_BLOCK];
+    int xhigh[2][QMF_BLOCK];
+    g722_band_t unused[2];
+    g722_band_t *band[LANES];
+    band_lanes_t lanes;
+    int32_t sv[LANES];
+    int32_t dv[LANES];
+    int g722_bytes[2];
+    int ilow;
+    int ihigh;
+    int block;
+    int ch;
+    int i;
+    int j;
+
+    memset(unused, 0, sizeof(unused));
+    memset(dv, 0, sizeof(dv));
+    for (ch = 0;  ch < 2;  ch++)
+    {
+        band[2*ch] = (ch < n)  ?  &s[ch]->band[0]  :  &unused[0];
+        band[2*ch + 1] = (ch < n)  ?  &s[ch]->band[1]  :  &unused[1];
+        g722_bytes[ch] = 0;
+    }
+    lanes_load(&lanes, band);
+
+    for (j = 0;  j < pairs;  j += block)
+    {
+        block = (pairs - j < QMF_BLOCK)  ?  pairs - j  :  QMF_BLOCK;
+        for (ch = 0;  ch < n;  ch++)
+            tx_qmf_block(s[ch], amp[ch] + 2*j, block, xlow[ch], xhigh[ch]);
+
+        for (i = 0;  i < block;  i++)
+        {
+            v_store(sv, lanes.s);
+            for (ch = 0;  ch < n;  ch++)
+            {
+                dv[2*ch] = quantize_low(band[2*ch], sv[2*ch],
+                                        xlow[ch][i], &ilow);
+                dv[2*ch + 1] = quantize_high(band[2*ch + 1], sv[2*ch + 1],
+                                             xhigh[ch][i], &ihigh);
+                g722_bytes[ch] = put_code(s[ch], g722_data[ch],
+                                          g722_bytes[ch],
+                                          make_code(ilow, ihigh));
+            }
+            block4_lanes(&lanes, v_load(dv));
+        }
+    }
+
+    lanes_store(&lanes, band);
+    return g722_bytes[0];
+}
+/*- End of function --------------------------------------------------------*/
+#else
+void g722_encode_enable_simd(int enable)
+{
+    (void) enable;
+}
+/*- End of function --------------------------------------------------------*/
+#endif
+
+int g722_encode(g722_encode_state_t *s, uint8_t g722_data[],
+                       const int16_t amp[], int len)
+{
     int i;
     int j;
     /* Low and high band PCM from the QMF */
@@ -292,13 +883,22 @@ int g722_encode(g722_encode_state_t *s, uint8_t g722_data[],
     /* Even and odd tap accumulators */
     int sumeven;
     int sumodd;
-    int ihigh;
-    int ilow;
-    int code;
 
     g722_bytes = 0;
+    j = 0;
+#if G722_SIMD
+    if (simd_enabled  &&  !s->itu_test_mode)
+    {
+        g722_encode_state_t *states[2] = {s, NULL};
+        uint8_t *data[2] = {g722_data, NULL};
+        const int16_t *pcm[2] = {amp, NULL};
+
+        g722_bytes = encode_lanes(states, 1, data, pcm, len/2);
+        j = len & ~1;
+    }
+#endif
     xhigh = 0;
-    for (j = 0;  j < len;  )
+    for (  ;  j < len;  )
     {
         if (s->itu_test_mode)
         {
@@ -340,99 +940,30 @@ int g722_encode(g722_encode_state_t *s, uint8_t g722_data[],
 #endif
             }
         }
-        /* Block 1L, SUBTRA */
-        el = saturate(xlow - s->band[0].s);
-
-        /* Block 1L, QUANTL */
-        wd = (el >= 0)  ?  el  :  -(el + 1);
+        g722_bytes = put_code(s, g722_data, g722_bytes,
+                              encode_bands(s, xlow, xhigh));
+    }
+    return g722_bytes;
+}
+/*- End of function --------------------------------------------------------*/
 
-        for (i = 1;  i < 30;  i++)
-        {
-            wd1 = (q6[i]*s->band[0].det) >> 12;
-            if (wd < wd1)
-                break;
-        }
-        ilow = (el < 0)  ?  iln[i]  :  ilp[i];
-
-        /* Block 2L, INVQAL */
-        ril = ilow >> 2;
-        wd2 = qm4[ril];
-        dlow = (s->band[0].det*wd2) >> 15;
-
-        /* Block 3L, LOGSCL */
-        il4 = rl42[ril];
-        wd = (s->band[0].nb*127) >> 7;
-        s->band[0].nb = wd + wl[il4];
-        if (s->band[0].nb < 0)
-            s->band[0].nb = 0;
-        else if (s->band[0].nb > 18432)
-            s->band[0].nb = 18432;
-
-        /* Block 3L, SCALEL */
-        wd1 = (s->band[0].nb >> 6) & 31;
-        wd2 = 8 - (s->band[0].nb >> 11);
-        wd3 = (wd2 < 0)  ?  (ilb[wd1] << -wd2)  :  (ilb[wd1] >> wd2);
-        s->band[0].det = wd3 << 2;
-
-        block4(&s->band[0], dlow);
-        {
-	    int nb;
-
-            /* Block 1H, SUBTRA */
-            eh = saturate(xhigh - s->band[1].s);
-
-            /* Block 1H, QUANTH */
-            wd = (eh >= 0)  ?  eh  :  -(eh + 1);
-            wd1 = (564*s->band[1].det) >> 12;
-            mih = (wd >= wd1)  ?  2  :  1;
-            ihigh = (eh < 0)  ?  ihn[mih]  :  ihp[mih];
-
-            /* Block 2H, INVQAH */
-            wd2 = qm2[ihigh];
-            dhigh = (s->band[1].det*wd2) >> 15;
-
-            /* Block 3H, LOGSCH */
-            ih2 = rh2[ihigh];
-            wd = (s->band[1].nb*127) >> 7;
-
-            nb = wd + wh[ih2];
-            if (nb < 0)
-                nb = 0;
-            else if (nb > 22528)
-                nb = 22528;
-	    s->band[1].nb = nb;
-
-            /* Block 3H, SCALEH */
-            wd1 = (s->band[1].nb >> 6) & 31;
-            wd2 = 10 - (s->band[1].nb >> 11);
-            wd3 = (wd2 < 0)  ?  (ilb[wd1] << -wd2)  :  (ilb[wd1] >> wd2);
-            s->band[1].det = wd3 << 2;
-
-            block4(&s->band[1], dhigh);
-#if   BITS_PER_SAMPLE == 8
-            code = ((ihigh << 6) | ilow);
-#elif BITS_PER_SAMPLE == 7
-            code = ((ihigh << 6) | ilow) >> 1;
-#elif BITS_PER_SAMPLE == 6
-            code = ((ihigh << 6) | ilow) >> 2;
-#endif
-        }
+int g722_encode_dual(g722_encode_state_t *s0, g722_encode_state_t *s1,
+                     uint8_t g722_data0[], uint8_t g722_data1[],
+                     const int16_t amp0[], const int16_t amp1[], int len)
+{
+#if G722_SIMD
+    if (simd_enabled  &&  !s0->itu_test_mode  &&  !s1->itu_test_mode
+        &&  (len & 1) == 0)
+    {
+        g722_encode_state_t *states[2] = {s0, s1};
+        uint8_t *data[2] = {g722_data0, g722_data1};
+        const int16_t *pcm[2] = {amp0, amp1};
 
-#if PACKED_OUTPUT == 1
-            /* Pack the code bits */
-            s->out_buffer |= (code << s->out_bits);
-            s->out_bits += s->bits_per_sample;
-            if (s->out_bits >= 8)
-            {
-                g722_data[g722_bytes++] = (uint8_t) (s->out_buffer & 0xFF);
-                s->out_bits -= 8;
-                s->out_buffer >>= 8;
-            }
-#else
-            g722_data[g722_bytes++] = (uint8_t) code;
-#endif
+        return encode_lanes(states, 2, data, pcm, len/2);
     }
-    return g722_bytes;
+#endif
+    g722_encode(s1, g722_data1, amp1, len);
+    return g722_encode(s0, g722_data0, amp0, len);
 }
 /*- End of function --------------------------------------------------------*/
 /*- End of file ------------------------------------------------------------*/
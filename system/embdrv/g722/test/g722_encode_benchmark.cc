@@ -0,0 +1,108 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "embdrv/g722/g722_typedefs.h"
+#include "embdrv/g722/g722_enc_dec.h"
+
+using ::benchmark::State;
+
+namespace {
+
+// One hearing aid audio tick: 20 ms at 16 kHz for each side
+constexpr int kSamplesPerTick = 320;
+constexpr int kNumTicks = 16;
+
+class G722EncoderBenchmark : public ::benchmark::Fixture {
+ public:
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<int> dist(INT16_MIN / 2, INT16_MAX / 2);
+    for (auto* pcm : {&pcm_left_, &pcm_right_}) {
+      pcm->resize(kNumTicks * kSamplesPerTick);
+      for (auto& sample : *pcm) sample = dist(gen);
+    }
+    g722_encode_init(&left_, 64000, G722_PACKED);
+    g722_encode_init(&right_, 64000, G722_PACKED);
+  }
+
+  void TearDown(State& st) override {
+    g722_encode_enable_simd(1);
+    ::benchmark::Fixture::TearDown(st);
+  }
+
+  // Encode both sides, one after the other or in one pass
+  void Run(State& state, bool simd, bool dual) {
+    g722_encode_enable_simd(simd);
+    uint8_t encoded_left[kSamplesPerTick];
+    uint8_t encoded_right[kSamplesPerTick];
+    int tick = 0;
+    for (auto _ : state) {
+      const int16_t* left = pcm_left_.data() + tick * kSamplesPerTick;
+      const int16_t* right = pcm_right_.data() + tick * kSamplesPerTick;
+      if (dual) {
+        ::benchmark::DoNotOptimize(
+            g722_encode_dual(&left_, &right_, encoded_left, encoded_right,
+                             left, right, kSamplesPerTick));
+      } else {
+        ::benchmark::DoNotOptimize(
+            g722_encode(&left_, encoded_left, left, kSamplesPerTick));
+        ::benchmark::DoNotOptimize(
+            g722_encode(&right_, encoded_right, right, kSamplesPerTick));
+      }
+      tick = (tick + 1) % kNumTicks;
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * 2 * kSamplesPerTick *
+                            sizeof(int16_t));
+  }
+
+  g722_encode_state_t left_;
+  g722_encode_state_t right_;
+  std::vector<int16_t> pcm_left_;
+  std::vector<int16_t> pcm_right_;
+};
+
+BENCHMARK_DEFINE_F(G722EncoderBenchmark, encode_both_scalar)(State& state) {
+  Run(state, false, false);
+}
+BENCHMARK_REGISTER_F(G722EncoderBenchmark, encode_both_scalar);
+
+BENCHMARK_DEFINE_F(G722EncoderBenchmark, encode_both_simd)(State& state) {
+  Run(state, true, false);
+}
+BENCHMARK_REGISTER_F(G722EncoderBenchmark, encode_both_simd);
+
+BENCHMARK_DEFINE_F(G722EncoderBenchmark, encode_dual_simd)(State& state) {
+  Run(state, true, true);
+}
+BENCHMARK_REGISTER_F(G722EncoderBenchmark, encode_dual_simd);
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  ::benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "embdrv/g722/g722_typedefs.h"
+#include "embdrv/g722/g722_enc_dec.h"
+
+namespace {
+
+constexpr int kNumCalls = 200;
+
+class G722EncodeTest : public ::testing::Test {
+ protected:
+  void TearDown() override { g722_encode_enable_simd(1); }
+
+  // Random lengths cover partial QMF blocks, |scale| is the input amplitude
+  // in percent of the full scale.
+  std::vector<int16_t> Pcm(std::mt19937* gen, int scale) {
+    std::vector<int16_t> pcm(2 * (1 + (*gen)() % 200));
+    std::uniform_int_distribution<int> dist(INT16_MIN, INT16_MAX);
+    for (auto& sample : pcm) sample = dist(*gen) * scale / 100;
+    return pcm;
+  }
+};
+
+TEST_F(G722EncodeTest, simd_is_bit_exact) {
+  for (int scale : {100, 50, 1}) {
+    g722_encode_state_t scalar, simd;
+    g722_encode_init(&scalar, 64000, G722_PACKED);
+    g722_encode_init(&simd, 64000, G722_PACKED);
+    std::mt19937 gen(scale);
+    for (int call = 0; call < kNumCalls; call++) {
+      std::vector<int16_t> pcm = Pcm(&gen, scale);
+      std::vector<uint8_t> expected(pcm.size()), encoded(pcm.size());
+
+      g722_encode_enable_simd(0);
+      int expected_len =
+          g722_encode(&scalar, expected.data(), pcm.data(), pcm.size());
+      g722_encode_enable_simd(1);
+      int len = g722_encode(&simd, encoded.data(), pcm.data(), pcm.size());
+
+      ASSERT_EQ(len, expected_len);
+      ASSERT_EQ(encoded, expected) << "scale " << scale << " call " << call;
+    }
+  }
+}
+
+TEST_F(G722EncodeTest, dual_encode_matches_two_encodes) {
+  g722_encode_state_t left, right, dual_left, dual_right;
+  g722_encode_init(&left, 64000, G722_PACKED);
+  g722_encode_init(&right, 64000, G722_PACKED);
+  g722_encode_init(&dual_left, 64000, G722_PACKED);
+  g722_encode_init(&dual_right, 64000, G722_PACKED);
+  std::mt19937 gen(1);
+  for (int call = 0; call < kNumCalls; call++) {
+    std::vector<int16_t> pcm_left = Pcm(&gen, 100);
+    std::vector<int16_t> pcm_right(pcm_left.size());
+    for (size_t i = 0; i < pcm_right.size(); i++)
+      pcm_right[i] = 16000 * std::sin(0.01 * (call * 400 + i));
+
+    std::vector<uint8_t> expected_left(pcm_left.size());
+    std::vector<uint8_t> expected_right(pcm_left.size());
+    int expected_len = g722_encode(&left, expected_left.data(),
+                                   pcm_left.data(), pcm_left.size());
+    g722_encode(&right, expected_right.data(), pcm_right.data(),
+                pcm_right.size());
+
+    std::vector<uint8_t> encoded_left(pcm_left.size());
+    std::vector<uint8_t> encoded_right(pcm_left.size());
+    int len = g722_encode_dual(&dual_left, &dual_right, encoded_left.data(),
+                               encoded_right.data(), pcm_left.data(),
+                               pcm_right.data(), pcm_left.size());
+
+    ASSERT_EQ(len, expected_len);
+    ASSERT_EQ(encoded_left, expected_left) << "call " << call;
+    ASSERT_EQ(encoded_right, expected_right) << "call " << call;
+  }
+}
+
+}  // namespace
@@ -103,6 +103,12 @@
  *
  *   with `nch` as the number of channels in the PCM stream
  *
+ * When all the channels share the same frame duration and samplerate,
+ * `lc3_encode_channels()` encodes the frames of the `nch` channels in
+ * one call, with a single pass over the interleaved PCM stream :
+ *
+ *   | lc3_encode_channels(encoder, nch, pcm, ...);
+ *
  * ---
  *
  * Antoine SOULIER, Tempow / Google LLC
@@ -258,6 +264,22 @@ lc3_encoder_t lc3_setup_encoder(
 int lc3_encode(lc3_encoder_t encoder, enum lc3_pcm_format fmt,
     const void *pcm, int stride, int nbytes, void *out);
 
+/**
+ * Encode a frame of multiple channels
+ * encoders, nch   Handles of the `nch` encoders, one by channel
+ * fmt             PCM input format
+ * pcm             Input PCM samples, `nch` channels interleaved
+ * nbytes          Target size, in bytes, of the frame of each channel
+ * out             Output buffers of `nbytes` size, one by channel
+ * return          0: On success  -1: Wrong parameters
+ *
+ * The encoders shall be setup with the same frame duration, samplerate
+ * and input samplerate. The output is the same as calling `lc3_encode()`
+ * on each channel, with a stride of `nch`.
+ */
+int lc3_encode_channels(lc3_encoder_t const *encoders, int nch,
+    enum lc3_pcm_format fmt, const void *pcm, int nbytes, void * const *out);
+
 /**
  * Return size needed for an decoder
  * dt_us           Frame duration in us, 7500 or 10000
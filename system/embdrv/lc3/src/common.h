@@ -53,6 +53,17 @@
 #endif /* __clang__ */
 
 
+/**
+ * Fixed-point MDCT
+ * When set, the rotations and the FFT of the MDCT are computed on integers,
+ * for the cores without a fast FPU
+ */
+
+#ifndef LC3_FIXED_MDCT
+#define LC3_FIXED_MDCT 0
+#endif
+
+
 /**
  * Macros
  * MIN/MAX  Minimum and maximum between 2 values
@@ -144,5 +155,14 @@ struct lc3_complex
     float re, im;
 };
 
+/**
+ * Complex fixed-point number, Q31 or scaled by a block exponent
+ */
+
+struct lc3_complex_q31
+{
+    int32_t re, im;
+};
+
 
 #endif /* __LC3_COMMON_H */
@@ -19,6 +19,31 @@
 #include "energy.h"
 #include "tables.h"
 
+#include "energy_x86.h"
+
+
+/**
+ * Mean of the square of coefficients within bands
+ * x               Input MDCT coefficients
+ * lim, nb         Limits of the `nb` bands, `nb + 1` values
+ * e               Output energy estimation of the `nb` bands
+ */
+#ifndef energy_bands
+LC3_HOT static inline void energy_bands(
+    const float *x, const int *lim, int nb, float *e)
+{
+    for (int i = lim[0], ib = 0; ib < nb; ib++) {
+        int ie = lim[ib+1];
+        int n = ie - i;
+
+        float sx2 = x[i] * x[i];
+        for (i++; i < ie; i++)
+            sx2 += x[i] * x[i];
+
+        *(e++) = sx2 / n;
+    }
+}
+#endif /* energy_bands */
 
 /**
  * Energy estimation per band
@@ -34,13 +59,10 @@ bool lc3_energy_compute(
     /* First bands are 1 coefficient width */
 
     int n1 = n1_table[dt][sr];
-    float e_sum[2] = { 0, 0 };
     int iband;
 
-    for (iband = 0; iband < n1; iband++) {
-        *e = x[iband] * x[iband];
-        e_sum[0] += *(e++);
-    }
+    for (iband = 0; iband < n1; iband++)
+        e[iband] = x[iband] * x[iband];
 
     /* Mean the square of coefficients within each band,
      * note that 7.5ms 8KHz frame has more bands than samples */
@@ -49,22 +71,17 @@ bool lc3_energy_compute(
     int iband_h = nb - 2*(2 - dt);
     const int *lim = lc3_band_lim[dt][sr];
 
-    for (int i = lim[iband]; iband < nb; iband++) {
-        int ie = lim[iband+1];
-        int n = ie - i;
+    energy_bands(x, lim + n1, nb - n1, e + n1);
 
-        float sx2 = x[i] * x[i];
-        for (i++; i < ie; i++)
-            sx2 += x[i] * x[i];
+    for (iband = nb; iband < LC3_NUM_BANDS; iband++)
+        e[iband] = 0;
 
-        *e = sx2 / n;
-        e_sum[iband >= iband_h] += *(e++);
-    }
+    /* Return the near nyquist flag */
 
-    for (; iband < LC3_NUM_BANDS; iband++)
-        *(e++) = 0;
+    float e_sum[2] = { 0, 0 };
 
-    /* Return the near nyquist flag */
+    for (iband = 0; iband < nb; iband++)
+        e_sum[iband >= iband_h] += e[iband];
 
     return e_sum[1] > 30 * e_sum[0];
 }
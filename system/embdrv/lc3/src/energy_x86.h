@@ -0,0 +1,80 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#if __AVX2__
+
+#include <immintrin.h>
+
+
+/**
+ * Mean of the square of coefficients within bands
+ *
+ * The bands are processed by 8, one band by lane, so that the sum of each
+ * band is accumulated in the same order as the generic version, and the
+ * results are bit-exact. The coefficients are loaded by masked gathers,
+ * lanes of the bands already complete are left untouched.
+ */
+#ifndef energy_bands
+#ifndef TEST_X86
+#define energy_bands x86_energy_bands
+#endif /* TEST_X86 */
+LC3_HOT static inline void x86_energy_bands(
+    const float *x, const int *lim, int nb, float *e)
+{
+    int ib = 0;
+
+    for ( ; ib + 8 <= nb; ib += 8, lim += 8, e += 8) {
+        __m256i i0 = _mm256_loadu_si256((const __m256i *)(lim + 0));
+        __m256i ie = _mm256_loadu_si256((const __m256i *)(lim + 1));
+        __m256i n = _mm256_sub_epi32(ie, i0);
+
+        int nmax = 0;
+        for (int k = 0; k < 8; k++)
+            nmax = LC3_MAX(nmax, lim[k+1] - lim[k]);
+
+        __m256 xk = _mm256_i32gather_ps(x, i0, sizeof(float));
+        __m256 sx2 = _mm256_mul_ps(xk, xk);
+
+        for (int k = 1; k < nmax; k++) {
+            __m256i ik = _mm256_add_epi32(i0, _mm256_set1_epi32(k));
+            __m256 mask = _mm256_castsi256_ps(
+                _mm256_cmpgt_epi32(n, _mm256_set1_epi32(k)));
+
+            xk = _mm256_mask_i32gather_ps(
+                _mm256_setzero_ps(), x, ik, mask, sizeof(float));
+            sx2 = _mm256_blendv_ps(sx2,
+                _mm256_add_ps(sx2, _mm256_mul_ps(xk, xk)), mask);
+        }
+
+        _mm256_storeu_ps(e, _mm256_div_ps(sx2, _mm256_cvtepi32_ps(n)));
+    }
+
+    for (int i = lim[0]; ib < nb; ib++, lim++) {
+        int ie = lim[1];
+        int n = ie - i;
+
+        float sx2 = x[i] * x[i];
+        for (i++; i < ie; i++)
+            sx2 += x[i] * x[i];
+
+        *(e++) = sx2 / n;
+    }
+}
+#endif /* energy_bands */
+
+#endif /* __AVX2__ */
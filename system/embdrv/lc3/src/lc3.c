@@ -192,6 +192,50 @@ static void load_s24(
     }
 }
 
+/**
+ * Input interleaved PCM Samples of channels from signed 16 bits
+ * encoders, nch   Encoders states of the `nch` channels
+ * pcm             Input PCM samples, `nch` channels interleaved
+ */
+static void load_channels_s16(
+    struct lc3_encoder * const *encoders, int nch, const void *_pcm)
+{
+    const int16_t *pcm = _pcm;
+
+    enum lc3_dt dt = encoders[0]->dt;
+    enum lc3_srate sr = encoders[0]->sr_pcm;
+    int ns = LC3_NS(dt, sr);
+
+    for (int i = 0; i < ns; i++)
+        for (int ich = 0; ich < nch; ich++) {
+            int16_t in = *(pcm++);
+            encoders[ich]->xt[i] = in, encoders[ich]->xs[i] = in;
+        }
+}
+
+/**
+ * Input interleaved PCM Samples of channels from signed 24 bits
+ * encoders, nch   Encoders states of the `nch` channels
+ * pcm             Input PCM samples, `nch` channels interleaved
+ */
+static void load_channels_s24(
+    struct lc3_encoder * const *encoders, int nch, const void *_pcm)
+{
+    const int32_t *pcm = _pcm;
+
+    enum lc3_dt dt = encoders[0]->dt;
+    enum lc3_srate sr = encoders[0]->sr_pcm;
+    int ns = LC3_NS(dt, sr);
+
+    for (int i = 0; i < ns; i++)
+        for (int ich = 0; ich < nch; ich++) {
+            int32_t in = *(pcm++);
+
+            encoders[ich]->xt[i] = in >> 8;
+            encoders[ich]->xs[i] = ldexpf(in, -8);
+        }
+}
+
 /**
  * Frame Analysis
  * encoder         Encoder state
@@ -359,6 +403,48 @@ int lc3_encode(struct lc3_encoder *encoder, enum lc3_pcm_format fmt,
     return 0;
 }
 
+/**
+ * Encode a frame of multiple channels
+ */
+int lc3_encode_channels(struct lc3_encoder * const *encoders, int nch,
+    enum lc3_pcm_format fmt, const void *pcm, int nbytes, void * const *out)
+{
+    static void (* const load[])
+        (struct lc3_encoder * const *, int, const void *) =
+    {
+        [LC3_PCM_FORMAT_S16] = load_channels_s16,
+        [LC3_PCM_FORMAT_S24] = load_channels_s24,
+    };
+
+    /* --- Check parameters --- */
+
+    if (!encoders || nch <= 0 || !out || nbytes < LC3_MIN_FRAME_BYTES
+                                      || nbytes > LC3_MAX_FRAME_BYTES)
+        return -1;
+
+    for (int ich = 0; ich < nch; ich++)
+        if (!encoders[ich] || !out[ich] ||
+                encoders[ich]->dt != encoders[0]->dt ||
+                encoders[ich]->sr != encoders[0]->sr ||
+                encoders[ich]->sr_pcm != encoders[0]->sr_pcm)
+            return -1;
+
+    /* --- Processing --- */
+
+    struct side_data side;
+    uint16_t xq[LC3_NE(encoders[0]->dt, encoders[0]->sr)];
+
+    load[fmt](encoders, nch, pcm);
+
+    for (int ich = 0; ich < nch; ich++) {
+        analyze(encoders[ich], nbytes, &side, xq);
+
+        encode(encoders[ich], &side, xq, nbytes, out[ich]);
+    }
+
+    return 0;
+}
+
 
 /* ----------------------------------------------------------------------------
  *  Decoder
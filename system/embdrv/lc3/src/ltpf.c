@@ -21,6 +21,7 @@
 
 #include "ltpf_neon.h"
 #include "ltpf_arm.h"
+#include "ltpf_x86.h"
 
 
 /* ----------------------------------------------------------------------------
@@ -0,0 +1,352 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#if __SSE4_1__
+
+#include <immintrin.h>
+
+
+/**
+ * Import
+ */
+
+static inline int32_t filter_hp50(struct lc3_ltpf_hp50_state *, int32_t);
+
+
+/**
+ * Horizontal sums
+ */
+static inline int32_t x86_hadd_epi32(__m128i v)
+{
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(v);
+}
+
+static inline int64_t x86_hadd_epi64(__m128i v)
+{
+    int64_t alignas(16) u[2];
+
+    _mm_store_si128((__m128i *)u, v);
+    return u[0] + u[1];
+}
+
+/**
+ * Multiply and accumulate by pairs 8 samples, then widen to 64 bits
+ * As the `vmull_s16()` / `vmlal_s16()` pairs of the Neon version, the sum of
+ * 2 products overflows when the 4 samples are -32768.
+ */
+static inline __m128i x86_madd64_epi16(__m128i v, __m128i a, __m128i b)
+{
+    __m128i u = _mm_madd_epi16(a, b);
+
+    v = _mm_add_epi64(v, _mm_cvtepi32_epi64(u));
+    v = _mm_add_epi64(v, _mm_cvtepi32_epi64(_mm_unpackhi_epi64(u, u)));
+    return v;
+}
+
+#if __AVX2__
+static inline __m256i x86_madd64_epi16_256(__m256i v, __m256i a, __m256i b)
+{
+    __m256i u = _mm256_madd_epi16(a, b);
+
+    v = _mm256_add_epi64(v,
+            _mm256_cvtepi32_epi64(_mm256_castsi256_si128(u)));
+    v = _mm256_add_epi64(v,
+            _mm256_cvtepi32_epi64(_mm256_extracti128_si256(u, 1)));
+    return v;
+}
+
+static inline __m128i x86_fold_epi64(__m256i v)
+{
+    return _mm_add_epi64(
+        _mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+}
+#endif /* __AVX2__ */
+
+#define __x86_loadu(p) _mm_loadu_si128((const __m128i *)(p))
+#define __x86_loadl(p) _mm_loadl_epi64((const __m128i *)(p))
+
+
+/**
+ * Resample from 16 Khz to 12.8 KHz
+ */
+#ifndef resample_16k_12k8
+#ifndef TEST_X86
+#define resample_16k_12k8 x86_resample_16k_12k8
+#endif /* TEST_X86 */
+LC3_HOT static void x86_resample_16k_12k8(
+    struct lc3_ltpf_hp50_state *hp50, const int16_t *x, int16_t *y, int n)
+{
+    static const int16_t h[4][20] = {
+
+    {   -61,   214,  -398,   417,     0, -1052,  2686, -4529,  5997, 26233,
+       5997, -4529,  2686, -1052,     0,   417,  -398,   214,   -61,     0 },
+
+    {   -79,   180,  -213,     0,   598, -1522,  2389, -2427,     0, 24506,
+      13068, -5289,  1873,     0,  -752,   763,  -457,   156,     0,   -28 },
+
+    {   -61,    92,     0,  -323,   861, -1361,  1317,     0, -3885, 19741,
+      19741, -3885,     0,  1317, -1361,   861,  -323,     0,    92,   -61 },
+
+    {   -28,     0,   156,  -457,   763,  -752,     0,  1873, -5289, 13068,
+      24506,     0, -2427,  2389, -1522,   598,     0,  -213,   180,   -79 },
+
+    };
+
+    x -= 20 - 1;
+
+    for (int i = 0; i < 5*n; i += 5) {
+        const int16_t *hn = h[i & 3];
+        const int16_t *xn = x + (i >> 2);
+        __m128i un;
+
+        un = _mm_madd_epi16(__x86_loadu(xn + 0), __x86_loadu(hn + 0));
+        un = _mm_add_epi32(un,
+            _mm_madd_epi16(__x86_loadu(xn + 8), __x86_loadu(hn + 8)));
+        un = _mm_add_epi32(un,
+            _mm_madd_epi16(__x86_loadl(xn + 16), __x86_loadl(hn + 16)));
+
+        int32_t yn = filter_hp50(hp50, x86_hadd_epi32(un));
+        *(y++) = (yn + (1 << 15)) >> 16;
+    }
+}
+#endif /* resample_16k_12k8 */
+
+/**
+ * Resample from 32 Khz to 12.8 KHz
+ */
+#ifndef resample_32k_12k8
+#ifndef TEST_X86
+#define resample_32k_12k8 x86_resample_32k_12k8
+#endif /* TEST_X86 */
+LC3_HOT static void x86_resample_32k_12k8(
+    struct lc3_ltpf_hp50_state *hp50, const int16_t *x, int16_t *y, int n)
+{
+    x -= 40 - 1;
+
+    static const int16_t alignas(16) h[2][40] = {
+
+    {   -30,   -31,    46,   107,     0,  -199,  -162,   209,   430,     0,
+       -681,  -526,   658,  1343,     0, -2264, -1943,  2999,  9871, 13116,
+       9871,  2999, -1943, -2264,     0,  1343,   658,  -526,  -681,     0,
+        430,   209,  -162,  -199,     0,   107,    46,   -31,   -30,     0 },
+
+    {   -14,   -39,     0,    90,    78,  -106,  -229,     0,   382,   299,
+       -376,  -761,     0,  1194,   937, -1214, -2644,     0,  6534, 12253,
+      12253,  6534,     0, -2644, -1214,   937,  1194,     0,  -761,  -376,
+        299,   382,     0,  -229,  -106,    78,    90,     0,   -39,   -14 },
+
+    };
+
+    for (int i = 0; i < 5*n; i += 5) {
+        const int16_t *hn = h[i & 1];
+        const int16_t *xn = x + (i >> 1);
+        __m128i un;
+
+        un = _mm_madd_epi16(__x86_loadu(xn), __x86_loadu(hn));
+        xn += 8, hn += 8;
+
+        for (int k = 1; k < 5; k++, xn += 8, hn += 8)
+            un = _mm_add_epi32(un,
+                _mm_madd_epi16(__x86_loadu(xn), __x86_loadu(hn)));
+
+        int32_t yn = filter_hp50(hp50, x86_hadd_epi32(un));
+        *(y++) = (yn + (1 << 15)) >> 16;
+    }
+}
+#endif /* resample_32k_12k8 */
+
+/**
+ * Resample from 48 Khz to 12.8 KHz
+ */
+#ifndef resample_48k_12k8
+#ifndef TEST_X86
+#define resample_48k_12k8 x86_resample_48k_12k8
+#endif /* TEST_X86 */
+LC3_HOT static void x86_resample_48k_12k8(
+    struct lc3_ltpf_hp50_state *hp50, const int16_t *x, int16_t *y, int n)
+{
+    static const int16_t alignas(16) h[4][64] = {
+
+    {  -13,   -25,   -20,    10,    51,    71,    38,   -47,  -133,  -145,
+       -42,   139,   277,   242,     0,  -329,  -511,  -351,   144,   698,
+       895,   450,  -535, -1510, -1697,  -521,  1999,  5138,  7737,  8744,
+      7737,  5138,  1999,  -521, -1697, -1510,  -535,   450,   895,   698,
+       144,  -351,  -511,  -329,     0,   242,   277,   139,   -42,  -145,
+      -133,   -47,    38,    71,    51,    10,   -20,   -25,   -13,     0 },
+
+    {   -9,   -23,   -24,     0,    41,    71,    52,   -23,  -115,  -152,
+       -78,    92,   254,   272,    76,  -251,  -493,  -427,     0,   576,
+       900,   624,  -262, -1309, -1763,  -954,  1272,  4356,  7203,  8679,
+      8169,  5886,  2767,     0, -1542, -1660,  -809,   240,   848,   796,
+       292,  -252,  -507,  -398,   -82,   199,   288,   183,     0,  -130,
+      -145,   -71,    20,    69,    60,    20,   -15,   -26,   -17,    -3 },
+
+    {   -6,   -20,   -26,    -8,    31,    67,    62,     0,   -94,  -152,
+      -108,    45,   223,   287,   143,  -167,  -454,  -480,  -134,   439,
+       866,   758,     0, -1071, -1748, -1295,   601,  3559,  6580,  8485,
+      8485,  6580,  3559,   601, -1295, -1748, -1071,     0,   758,   866,
+       439,  -134,  -480,  -454,  -167,   143,   287,   223,    45,  -108,
+      -152,   -94,     0,    62,    67,    31,    -8,   -26,   -20,    -6 },
+
+    {   -3,   -17,   -26,   -15,    20,    60,    69,    20,   -71,  -145,
+      -130,     0,   183,   288,   199,   -82,  -398,  -507,  -252,   292,
+       796,   848,   240,  -809, -1660, -1542,     0,  2767,  5886,  8169,
+      8679,  7203,  4356,  1272,  -954, -1763, -1309,  -262,   624,   900,
+       576,     0,  -427,  -493,  -251,    76,   272,   254,    92,   -78,
+      -152,  -115,   -23,    52,    71,    41,     0,   -24,   -23,    -9 },
+
+    };
+
+    x -= 60 - 1;
+
+    for (int i = 0; i < 15*n; i += 15) {
+        const int16_t *hn = h[i & 3];
+        const int16_t *xn = x + (i >> 2);
+        __m128i un;
+
+#if __AVX2__
+        __m256i vn;
+
+        vn = _mm256_madd_epi16(
+            _mm256_loadu_si256((const __m256i *)(xn +  0)),
+            _mm256_loadu_si256((const __m256i *)(hn +  0)));
+        vn = _mm256_add_epi32(vn, _mm256_madd_epi16(
+            _mm256_loadu_si256((const __m256i *)(xn + 16)),
+            _mm256_loadu_si256((const __m256i *)(hn + 16))));
+        vn = _mm256_add_epi32(vn, _mm256_madd_epi16(
+            _mm256_loadu_si256((const __m256i *)(xn + 32)),
+            _mm256_loadu_si256((const __m256i *)(hn + 32))));
+
+        un = _mm_add_epi32(
+            _mm256_castsi256_si128(vn), _mm256_extracti128_si256(vn, 1));
+#else
+        un = _mm_madd_epi16(__x86_loadu(xn), __x86_loadu(hn));
+
+        for (int k = 8; k < 48; k += 8)
+            un = _mm_add_epi32(un,
+                _mm_madd_epi16(__x86_loadu(xn + k), __x86_loadu(hn + k)));
+#endif /* __AVX2__ */
+
+        un = _mm_add_epi32(un,
+            _mm_madd_epi16(__x86_loadu(xn + 48), __x86_loadu(hn + 48)));
+        un = _mm_add_epi32(un,
+            _mm_madd_epi16(__x86_loadl(xn + 56), __x86_loadl(hn + 56)));
+
+        int32_t yn = filter_hp50(hp50, x86_hadd_epi32(un));
+        *(y++) = (yn + (1 << 15)) >> 16;
+    }
+}
+#endif /* resample_48k_12k8 */
+
+/**
+ * Return dot product of 2 vectors
+ */
+#ifndef dot
+#ifndef TEST_X86
+#define dot x86_dot
+#endif /* TEST_X86 */
+LC3_HOT static inline float x86_dot(const int16_t *a, const int16_t *b, int n)
+{
+    __m128i v = _mm_setzero_si128();
+
+#if __AVX2__
+    __m256i v256 = _mm256_setzero_si256();
+
+    for (int i = 0; i < (n >> 4); i++, a += 16, b += 16)
+        v256 = x86_madd64_epi16_256(v256,
+            _mm256_loadu_si256((const __m256i *)a),
+            _mm256_loadu_si256((const __m256i *)b));
+
+    v = x86_fold_epi64(v256);
+#else
+    for (int i = 0; i < (n >> 4); i++, a += 16, b += 16) {
+        v = x86_madd64_epi16(v, __x86_loadu(a + 0), __x86_loadu(b + 0));
+        v = x86_madd64_epi16(v, __x86_loadu(a + 8), __x86_loadu(b + 8));
+    }
+#endif /* __AVX2__ */
+
+    int32_t v32 = (x86_hadd_epi64(v) + (1 << 5)) >> 6;
+    return (float)v32;
+}
+#endif /* dot */
+
+/**
+ * Return vector of correlations
+ */
+#ifndef correlate
+#ifndef TEST_X86
+#define correlate x86_correlate
+#endif /* TEST_X86 */
+LC3_HOT static void x86_correlate(
+    const int16_t *a, const int16_t *b, int n, float *y, int nc)
+{
+    /* The correlations are computed by 4, the samples of `a`
+     * are loaded once and shared by the 4 lags */
+
+    for ( ; nc >= 4; nc -= 4, b -= 4) {
+        const int16_t *an = a;
+        const int16_t *bn = b;
+
+#if __AVX2__
+        __m256i v0 = _mm256_setzero_si256(), v1 = v0, v2 = v0, v3 = v0;
+
+        for (int i = 0; i < (n >> 4); i++, an += 16, bn += 16) {
+            __m256i ax = _mm256_loadu_si256((const __m256i *)an);
+
+            v0 = x86_madd64_epi16_256(v0, ax,
+                _mm256_loadu_si256((const __m256i *)(bn - 0)));
+            v1 = x86_madd64_epi16_256(v1, ax,
+                _mm256_loadu_si256((const __m256i *)(bn - 1)));
+            v2 = x86_madd64_epi16_256(v2, ax,
+                _mm256_loadu_si256((const __m256i *)(bn - 2)));
+            v3 = x86_madd64_epi16_256(v3, ax,
+                _mm256_loadu_si256((const __m256i *)(bn - 3)));
+        }
+
+        __m128i u0 = x86_fold_epi64(v0), u1 = x86_fold_epi64(v1);
+        __m128i u2 = x86_fold_epi64(v2), u3 = x86_fold_epi64(v3);
+#else
+        __m128i u0 = _mm_setzero_si128(), u1 = u0, u2 = u0, u3 = u0;
+
+        for (int i = 0; i < (n >> 3); i++, an += 8, bn += 8) {
+            __m128i ax = __x86_loadu(an);
+
+            u0 = x86_madd64_epi16(u0, ax, __x86_loadu(bn - 0));
+            u1 = x86_madd64_epi16(u1, ax, __x86_loadu(bn - 1));
+            u2 = x86_madd64_epi16(u2, ax, __x86_loadu(bn - 2));
+            u3 = x86_madd64_epi16(u3, ax, __x86_loadu(bn - 3));
+        }
+#endif /* __AVX2__ */
+
+        *(y++) = (float)((int32_t)((x86_hadd_epi64(u0) + (1 << 5)) >> 6));
+        *(y++) = (float)((int32_t)((x86_hadd_epi64(u1) + (1 << 5)) >> 6));
+        *(y++) = (float)((int32_t)((x86_hadd_epi64(u2) + (1 << 5)) >> 6));
+        *(y++) = (float)((int32_t)((x86_hadd_epi64(u3) + (1 << 5)) >> 6));
+    }
+
+    for ( ; nc > 0; nc--)
+        *(y++) = x86_dot(a, b--, n);
+}
+#endif /* correlate */
+
+#undef __x86_loadu
+#undef __x86_loadl
+
+#endif /* __SSE4_1__ */
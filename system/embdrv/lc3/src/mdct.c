@@ -19,6 +19,7 @@
 #include "tables.h"
 
 #include "mdct_neon.h"
+#include "mdct_x86.h"
 
 
 /* ----------------------------------------------------------------------------
@@ -408,12 +409,423 @@ LC3_HOT static void imdct_window(enum lc3_dt dt, enum lc3_srate sr,
     }
 }
 
+#if LC3_FIXED_MDCT || defined(TEST_FIXED)
+
+/* ----------------------------------------------------------------------------
+ *  Fixed-point processing
+ *
+ *  The rotations and the FFT run on 32 bits integers, with a block exponent:
+ *  the coefficients are scaled down before each stage just enough to leave
+ *  room for its growth, so that they keep the precision of the signal.
+ *  The windows stay in float, as the conversions, which are linear in the
+ *  size of the transform.
+ * -------------------------------------------------------------------------- */
+
+/**
+ * Multiply by a Q31 factor
+ */
+static inline int32_t mul_q31(int32_t a, int32_t b)
+{
+    return (int32_t)(((int64_t)a * b) >> 31);
+}
+
+/**
+ * Scale down coefficients to leave room for a growth
+ * x, n            Coefficients, scaled in place, and their count
+ * bits            Growth in bits of the next stage
+ * return          The number of bits the coefficients were scaled down
+ */
+LC3_HOT static int fixed_headroom(struct lc3_complex_q31 *x, int n, int bits)
+{
+    uint32_t m = 0;
+
+    for (int i = 0; i < n; i++)
+        m |= (uint32_t)(x[i].re ^ (x[i].re >> 31)) |
+             (uint32_t)(x[i].im ^ (x[i].im >> 31));
+
+    int shift = 0;
+    while ((m >> shift) >= (UINT32_C(1) << (31 - bits)))
+        shift++;
+
+    if (shift > 0)
+        for (int i = 0; i < n; i++) {
+            x[i].re >>= shift;
+            x[i].im >>= shift;
+        }
+
+    return shift;
+}
+
+/**
+ * Convert samples to integers, with 2 bits of headroom
+ * x, n            Input samples and their count
+ * y               Output integers
+ * return          Exponent `e` of the integers, `x = y * 2^e`
+ */
+LC3_HOT static int fixed_from_float(const float *x, int n, int32_t *y)
+{
+    float m = 0;
+    int e;
+
+    for (int i = 0; i < n; i++) {
+        float a = fabsf(x[i]);
+        m = a > m ? a : m;
+    }
+
+    frexpf(m, &e);
+    e = LC3_MAX(e, -64) - 29;
+
+    float scale = ldexpf(1.f, -e);
+    for (int i = 0; i < n; i++)
+        y[i] = (int32_t)(x[i] * scale);
+
+    return e;
+}
+
+/**
+ * FFT 5 Points, fixed-point version of `fft_5()`
+ */
+LC3_HOT static inline void fixed_fft_5(
+    const struct lc3_complex_q31 *x, struct lc3_complex_q31 *y, int n)
+{
+    static const int32_t cos1 =   663608942;  /* cos(-2Pi 1/5) */
+    static const int32_t cos2 = -1737350766;  /* cos(-2Pi 2/5) */
+
+    static const int32_t sin1 = -2042378317;  /* sin(-2Pi 1/5) */
+    static const int32_t sin2 = -1262259218;  /* sin(-2Pi 2/5) */
+
+    for (int i = 0; i < n; i++, x++, y+= 5) {
+
+        struct lc3_complex_q31 s14 =
+            { x[1*n].re + x[4*n].re, x[1*n].im + x[4*n].im };
+        struct lc3_complex_q31 d14 =
+            { x[1*n].re - x[4*n].re, x[1*n].im - x[4*n].im };
+
+        struct lc3_complex_q31 s23 =
+            { x[2*n].re + x[3*n].re, x[2*n].im + x[3*n].im };
+        struct lc3_complex_q31 d23 =
+            { x[2*n].re - x[3*n].re, x[2*n].im - x[3*n].im };
+
+        int32_t s14_re1 = mul_q31(s14.re, cos1);
+        int32_t s14_re2 = mul_q31(s14.re, cos2);
+        int32_t s14_im1 = mul_q31(s14.im, cos1);
+        int32_t s14_im2 = mul_q31(s14.im, cos2);
+        int32_t s23_re1 = mul_q31(s23.re, cos1);
+        int32_t s23_re2 = mul_q31(s23.re, cos2);
+        int32_t s23_im1 = mul_q31(s23.im, cos1);
+        int32_t s23_im2 = mul_q31(s23.im, cos2);
+
+        int32_t d14_re1 = mul_q31(d14.re, sin1);
+        int32_t d14_re2 = mul_q31(d14.re, sin2);
+        int32_t d14_im1 = mul_q31(d14.im, sin1);
+        int32_t d14_im2 = mul_q31(d14.im, sin2);
+        int32_t d23_re1 = mul_q31(d23.re, sin1);
+        int32_t d23_re2 = mul_q31(d23.re, sin2);
+        int32_t d23_im1 = mul_q31(d23.im, sin1);
+        int32_t d23_im2 = mul_q31(d23.im, sin2);
+
+        y[0].re = x[0].re + s14.re + s23.re;
+
+        y[0].im = x[0].im + s14.im + s23.im;
+
+        y[1].re = x[0].re + s14_re1 - d14_im1 + s23_re2 - d23_im2;
+
+        y[1].im = x[0].im + s14_im1 + d14_re1 + s23_im2 + d23_re2;
+
+        y[2].re = x[0].re + s14_re2 - d14_im2 + s23_re1 + d23_im1;
+
+        y[2].im = x[0].im + s14_im2 + d14_re2 + s23_im1 - d23_re1;
+
+        y[3].re = x[0].re + s14_re2 + d14_im2 + s23_re1 - d23_im1;
+
+        y[3].im = x[0].im + s14_im2 - d14_re2 + s23_im1 + d23_re1;
+
+        y[4].re = x[0].re + s14_re1 + d14_im1 + s23_re2 + d23_im2;
+
+        y[4].im = x[0].im + s14_im1 - d14_re1 + s23_im2 - d23_re2;
+    }
+}
+
+/**
+ * FFT Butterfly 3 Points, fixed-point version of `fft_bf3()`
+ */
+LC3_HOT static inline void fixed_fft_bf3(
+    const struct lc3_fft_bf3_twiddles_q31 *twiddles,
+    const struct lc3_complex_q31 *x, struct lc3_complex_q31 *y, int n)
+{
+    int n3 = twiddles->n3;
+    const struct lc3_complex_q31 (*w0)[2] = twiddles->t;
+    const struct lc3_complex_q31 (*w1)[2] = w0 + n3, (*w2)[2] = w1 + n3;
+
+    const struct lc3_complex_q31 *x0 = x, *x1 = x0 + n*n3, *x2 = x1 + n*n3;
+    struct lc3_complex_q31 *y0 = y, *y1 = y0 + n3, *y2 = y1 + n3;
+
+    for (int i = 0; i < n; i++, y0 += 3*n3, y1 += 3*n3, y2 += 3*n3)
+        for (int j = 0; j < n3; j++, x0++, x1++, x2++) {
+
+            y0[j].re = x0->re + mul_q31(x1->re, w0[j][0].re)
+                              - mul_q31(x1->im, w0[j][0].im)
+                              + mul_q31(x2->re, w0[j][1].re)
+                              - mul_q31(x2->im, w0[j][1].im);
+
+            y0[j].im = x0->im + mul_q31(x1->im, w0[j][0].re)
+                              + mul_q31(x1->re, w0[j][0].im)
+                              + mul_q31(x2->im, w0[j][1].re)
+                              + mul_q31(x2->re, w0[j][1].im);
+
+            y1[j].re = x0->re + mul_q31(x1->re, w1[j][0].re)
+                              - mul_q31(x1->im, w1[j][0].im)
+                              + mul_q31(x2->re, w1[j][1].re)
+                              - mul_q31(x2->im, w1[j][1].im);
+
+            y1[j].im = x0->im + mul_q31(x1->im, w1[j][0].re)
+                              + mul_q31(x1->re, w1[j][0].im)
+                              + mul_q31(x2->im, w1[j][1].re)
+                              + mul_q31(x2->re, w1[j][1].im);
+
+            y2[j].re = x0->re + mul_q31(x1->re, w2[j][0].re)
+                              - mul_q31(x1->im, w2[j][0].im)
+                              + mul_q31(x2->re, w2[j][1].re)
+                              - mul_q31(x2->im, w2[j][1].im);
+
+            y2[j].im = x0->im + mul_q31(x1->im, w2[j][0].re)
+                              + mul_q31(x1->re, w2[j][0].im)
+                              + mul_q31(x2->im, w2[j][1].re)
+                              + mul_q31(x2->re, w2[j][1].im);
+        }
+}
+
+/**
+ * FFT Butterfly 2 Points, fixed-point version of `fft_bf2()`
+ */
+LC3_HOT static inline void fixed_fft_bf2(
+    const struct lc3_fft_bf2_twiddles_q31 *twiddles,
+    const struct lc3_complex_q31 *x, struct lc3_complex_q31 *y, int n)
+{
+    int n2 = twiddles->n2;
+    const struct lc3_complex_q31 *w = twiddles->t;
+
+    const struct lc3_complex_q31 *x0 = x, *x1 = x0 + n*n2;
+    struct lc3_complex_q31 *y0 = y, *y1 = y0 + n2;
+
+    for (int i = 0; i < n; i++, y0 += 2*n2, y1 += 2*n2) {
+
+        for (int j = 0; j < n2; j++, x0++, x1++) {
+
+            int32_t u_re = mul_q31(x1->re, w[j].re) - mul_q31(x1->im, w[j].im);
+            int32_t u_im = mul_q31(x1->im, w[j].re) + mul_q31(x1->re, w[j].im);
+
+            y0[j].re = x0->re + u_re;
+            y0[j].im = x0->im + u_im;
+
+            y1[j].re = x0->re - u_re;
+            y1[j].im = x0->im - u_im;
+        }
+    }
+}
+
+/**
+ * Perform FFT, fixed-point version of `fft()`
+ * x, y0, y1       Input, and 2 scratch buffers of size `n`
+ * n               Number of points 30, 40, 60, 80, 90, 120, 160, 180, 240
+ * e               Exponent of the input, updated to the one of the result
+ * return          The buffer `y0` or `y1` that hold the result
+ *
+ * Input `x` is scaled in place, and can be the same as `y0`
+ */
+static struct lc3_complex_q31 *fixed_fft(struct lc3_complex_q31 *x, int n,
+    struct lc3_complex_q31 *y0, struct lc3_complex_q31 *y1, int *e)
+{
+    struct lc3_complex_q31 *y[2] = { y1, y0 };
+    int i2, i3, is = 0, ns = n;
+
+    /* The real and imaginary parts of the twiddled inputs are up to
+     * sqrt(2) larger than the ones of the inputs, giving growths of
+     * 1 + 4 sqrt(2) < 2^3, 1 + 2 sqrt(2) < 2^2 and 1 + sqrt(2) < 2^2 */
+
+    *e += fixed_headroom(x, ns, 3);
+    fixed_fft_5(x, y[is], n /= 5);
+
+    for (i3 = 0; n & (n-1); i3++, is ^= 1) {
+        *e += fixed_headroom(y[is], ns, 2);
+        fixed_fft_bf3(lc3_fft_twiddles_bf3_q31[i3], y[is], y[is ^ 1], n /= 3);
+    }
+
+    for (i2 = 0; n > 1; i2++, is ^= 1) {
+        *e += fixed_headroom(y[is], ns, 2);
+        fixed_fft_bf2(lc3_fft_twiddles_bf2_q31[i2][i3],
+            y[is], y[is ^ 1], n >>= 1);
+    }
+
+    return y[is];
+}
+
+/**
+ * Pre-rotate MDCT coefficients, fixed-point version of `mdct_pre_fft()`
+ */
+LC3_HOT static void fixed_mdct_pre_fft(const struct lc3_mdct_rot_def_q31 *def,
+    const int32_t *x, struct lc3_complex_q31 *y)
+{
+    int n4 = def->n4;
+
+    const int32_t *x0 = x, *x1 = x0 + 2*n4;
+    const struct lc3_complex_q31 *w0 = def->w, *w1 = w0 + n4;
+    struct lc3_complex_q31 *y0 = y, *y1 = y0 + n4;
+
+    while (x0 < x1) {
+        struct lc3_complex_q31 u, uw = *(w0++);
+        u.re = - mul_q31(*(--x1), uw.re) + mul_q31(*x0, uw.im);
+        u.im =   mul_q31(*(x0++), uw.re) + mul_q31(*x1, uw.im);
+
+        struct lc3_complex_q31 v, vw = *(--w1);
+        v.re = - mul_q31(*(--x1), vw.im) + mul_q31(*x0, vw.re);
+        v.im = - mul_q31(*(x0++), vw.im) - mul_q31(*x1, vw.re);
+
+        *(y0++) = u;
+        *(--y1) = v;
+    }
+}
+
+/**
+ * Post-rotate FFT coefficients, fixed-point version of `mdct_post_fft()`
+ * The `scale` includes the exponent of the coefficients
+ */
+LC3_HOT static void fixed_mdct_post_fft(const struct lc3_mdct_rot_def_q31 *def,
+    const struct lc3_complex_q31 *x, float *y, float scale)
+{
+    int n4 = def->n4, n8 = n4 >> 1;
+
+    const struct lc3_complex_q31 *w0 = def->w + n8, *w1 = w0 - 1;
+    const struct lc3_complex_q31 *x0 = x + n8, *x1 = x0 - 1;
+
+    float *y0 = y + n4, *y1 = y0;
+
+    for ( ; y1 > y; x0++, x1--, w0++, w1--) {
+
+        int32_t u0 = mul_q31(x0->im, w0->im) + mul_q31(x0->re, w0->re);
+        int32_t u1 = mul_q31(x1->re, w1->im) - mul_q31(x1->im, w1->re);
+
+        int32_t v0 = mul_q31(x0->re, w0->im) - mul_q31(x0->im, w0->re);
+        int32_t v1 = mul_q31(x1->im, w1->im) + mul_q31(x1->re, w1->re);
+
+        *(y0++) = u0 * scale;  *(y0++) = u1 * scale;
+        *(--y1) = v0 * scale;  *(--y1) = v1 * scale;
+    }
+}
+
+/**
+ * Pre-rotate IMDCT coefficients, fixed-point version of `imdct_pre_fft()`
+ */
+LC3_HOT static void fixed_imdct_pre_fft(const struct lc3_mdct_rot_def_q31 *def,
+    const int32_t *x, struct lc3_complex_q31 *y)
+{
+    int n4 = def->n4;
+
+    const int32_t *x0 = x, *x1 = x0 + 2*n4;
+
+    const struct lc3_complex_q31 *w0 = def->w, *w1 = w0 + n4;
+    struct lc3_complex_q31 *y0 = y, *y1 = y0 + n4;
+
+    while (x0 < x1) {
+        int32_t u0 = *(x0++), u1 = *(--x1);
+        int32_t v0 = *(x0++), v1 = *(--x1);
+        struct lc3_complex_q31 uw = *(w0++), vw = *(--w1);
+
+        (y0  )->re = - mul_q31(u0, uw.re) - mul_q31(u1, uw.im);
+        (y0++)->im = - mul_q31(u1, uw.re) + mul_q31(u0, uw.im);
+
+        (--y1)->re = - mul_q31(v1, vw.re) - mul_q31(v0, vw.im);
+        (  y1)->im = - mul_q31(v0, vw.re) + mul_q31(v1, vw.im);
+    }
+}
+
+/**
+ * Post-rotate FFT coefficients, fixed-point version of `imdct_post_fft()`
+ * The `scale` includes the exponent of the coefficients
+ */
+LC3_HOT static void fixed_imdct_post_fft(
+    const struct lc3_mdct_rot_def_q31 *def,
+    const struct lc3_complex_q31 *x, float *y, float scale)
+{
+    int n4 = def->n4;
+
+    const struct lc3_complex_q31 *w0 = def->w, *w1 = w0 + n4;
+    const struct lc3_complex_q31 *x0 = x, *x1 = x0 + n4;
+
+    float *y0 = y, *y1 = y0 + 2*n4;
+
+    while (x0 < x1) {
+        struct lc3_complex_q31 uz = *(x0++), vz = *(--x1);
+        struct lc3_complex_q31 uw = *(w0++), vw = *(--w1);
+
+        *(y0++) = (mul_q31(uz.re, uw.im) - mul_q31(uz.im, uw.re)) * scale;
+        *(--y1) = (mul_q31(uz.re, uw.re) + mul_q31(uz.im, uw.im)) * scale;
+
+        *(--y1) = (mul_q31(vz.re, vw.im) - mul_q31(vz.im, vw.re)) * scale;
+        *(y0++) = (mul_q31(vz.re, vw.re) + mul_q31(vz.im, vw.im)) * scale;
+    }
+}
+
+/**
+ * Forward MDCT transformation, fixed-point version
+ */
+static void fixed_mdct_forward(enum lc3_dt dt, enum lc3_srate sr,
+    enum lc3_srate sr_dst, const float *x, float *d, float *y)
+{
+    const struct lc3_mdct_rot_def_q31 *rot = lc3_mdct_rot_q31[dt][sr];
+    int nf = LC3_NS(dt, sr_dst);
+    int ns = LC3_NS(dt, sr);
+
+    float buffer[ns];
+    struct lc3_complex_q31 z[2][ns/2];
+
+    mdct_window(dt, sr, x, d, buffer);
+
+    int e = fixed_from_float(buffer, ns, (int32_t *)z[0]);
+    fixed_mdct_pre_fft(rot, (const int32_t *)z[0], z[0]);
+    struct lc3_complex_q31 *u = fixed_fft(z[0], ns/2, z[0], z[1], &e);
+
+    e += fixed_headroom(u, ns/2, 1);
+    fixed_mdct_post_fft(rot, u, y,
+        ldexpf(sqrtf( (2.f*nf) / (ns*ns) ), e));
+}
+
+/**
+ * Inverse MDCT transformation, fixed-point version
+ */
+static void fixed_mdct_inverse(enum lc3_dt dt, enum lc3_srate sr,
+    enum lc3_srate sr_src, const float *x, float *d, float *y)
+{
+    const struct lc3_mdct_rot_def_q31 *rot = lc3_mdct_rot_q31[dt][sr];
+    int nf = LC3_NS(dt, sr_src);
+    int ns = LC3_NS(dt, sr);
+
+    float buffer[ns];
+    struct lc3_complex_q31 z[2][ns/2];
+
+    int e = fixed_from_float(x, ns, (int32_t *)z[1]);
+    fixed_imdct_pre_fft(rot, (const int32_t *)z[1], z[0]);
+    struct lc3_complex_q31 *u = fixed_fft(z[0], ns/2, z[0], z[1], &e);
+
+    e += fixed_headroom(u, ns/2, 1);
+    fixed_imdct_post_fft(rot, u, buffer, ldexpf(sqrtf(2.f / nf), e));
+
+    imdct_window(dt, sr, buffer, d, y);
+}
+
+#endif /* LC3_FIXED_MDCT || TEST_FIXED */
+
 /**
  * Forward MDCT transformation
  */
 void lc3_mdct_forward(enum lc3_dt dt, enum lc3_srate sr,
     enum lc3_srate sr_dst, const float *x, float *d, float *y)
 {
+#if LC3_FIXED_MDCT
+    fixed_mdct_forward(dt, sr, sr_dst, x, d, y);
+    return;
+#endif
+
     const struct lc3_mdct_rot_def *rot = lc3_mdct_rot[dt][sr];
     int nf = LC3_NS(dt, sr_dst);
     int ns = LC3_NS(dt, sr);
@@ -435,6 +847,11 @@ void lc3_mdct_forward(enum lc3_dt dt, enum lc3_srate sr,
 void lc3_mdct_inverse(enum lc3_dt dt, enum lc3_srate sr,
     enum lc3_srate sr_src, const float *x, float *d, float *y)
 {
+#if LC3_FIXED_MDCT
+    fixed_mdct_inverse(dt, sr, sr_src, x, d, y);
+    return;
+#endif
+
     const struct lc3_mdct_rot_def *rot = lc3_mdct_rot[dt][sr];
     int nf = LC3_NS(dt, sr_src);
     int ns = LC3_NS(dt, sr);
@@ -0,0 +1,373 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#if __SSE4_1__
+
+#include <immintrin.h>
+
+
+/**
+ * The kernels keep the evaluation order of the generic versions, and do not
+ * use fused multiply-add : results are bit-exact, as long as the generic
+ * code is not itself contracted or reassociated by the compiler.
+ *
+ * Complex values are processed by pairs in SSE registers, and by groups
+ * of 4 in AVX registers, as `re, im, re, im, ...`.
+ */
+
+/**
+ * FFT 5 Points
+ * The number of interleaved transform `n` assumed to be even
+ */
+#ifndef fft_5
+#ifndef TEST_X86
+#define fft_5 x86_fft_5
+#endif /* TEST_X86 */
+
+/* The `sinX_n` and `sinX_p` factors are taken from the calling scope */
+#define X86_FFT_5(_t, _set1, _add, _sub, _mul, _cswap, _x, _y)              \
+{                                                                           \
+    const _t cos1 = _set1( 0.3090169944);                                   \
+    const _t cos2 = _set1(-0.8090169944);                                   \
+                                                                            \
+    const _t x0 = _x[0], x1 = _x[1], x2 = _x[2], x3 = _x[3], x4 = _x[4];    \
+                                                                            \
+    _t s14 = _add(x1, x4), d14 = _sub(x1, x4);                              \
+    _t s23 = _add(x2, x3), d23 = _sub(x2, x3);                              \
+                                                                            \
+    _y[0] = _add(_add(x0, s14), s23);                                       \
+                                                                            \
+    _y[1] = _add(x0, _mul(s14, cos1));                                      \
+    _y[1] = _add(_y[1], _mul(_cswap(d14), sin1_n));                         \
+    _y[1] = _add(_y[1], _mul(s23, cos2));                                   \
+    _y[1] = _add(_y[1], _mul(_cswap(d23), sin2_n));                         \
+                                                                            \
+    _y[2] = _add(x0, _mul(s14, cos2));                                      \
+    _y[2] = _add(_y[2], _mul(_cswap(d14), sin2_n));                         \
+    _y[2] = _add(_y[2], _mul(s23, cos1));                                   \
+    _y[2] = _add(_y[2], _mul(_cswap(d23), sin1_p));                         \
+                                                                            \
+    _y[3] = _add(x0, _mul(s14, cos2));                                      \
+    _y[3] = _add(_y[3], _mul(_cswap(d14), sin2_p));                         \
+    _y[3] = _add(_y[3], _mul(s23, cos1));                                   \
+    _y[3] = _add(_y[3], _mul(_cswap(d23), sin1_n));                         \
+                                                                            \
+    _y[4] = _add(x0, _mul(s14, cos1));                                      \
+    _y[4] = _add(_y[4], _mul(_cswap(d14), sin1_p));                         \
+    _y[4] = _add(_y[4], _mul(s23, cos2));                                   \
+    _y[4] = _add(_y[4], _mul(_cswap(d23), sin2_p));                         \
+}
+
+#define __x86_cswap(x) _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 0, 1))
+#define __x86_cswap256(x) _mm256_permute_ps(x, _MM_SHUFFLE(2, 3, 0, 1))
+
+LC3_HOT static inline void x86_fft_5(
+    const struct lc3_complex *x, struct lc3_complex *y, int n)
+{
+    /* The `sinX_n` factors apply `-sin` on real parts and `sin` on
+     * imaginary part once swapped, `sinX_p` the opposite. */
+
+    int i = 0;
+
+#if __AVX2__
+    {
+        const __m256 sin1_n = _mm256_setr_ps(
+             0.9510565163, -0.9510565163,  0.9510565163, -0.9510565163,
+             0.9510565163, -0.9510565163,  0.9510565163, -0.9510565163);
+        const __m256 sin2_n = _mm256_setr_ps(
+             0.5877852523, -0.5877852523,  0.5877852523, -0.5877852523,
+             0.5877852523, -0.5877852523,  0.5877852523, -0.5877852523);
+        const __m256 sin1_p = _mm256_sub_ps(_mm256_setzero_ps(), sin1_n);
+        const __m256 sin2_p = _mm256_sub_ps(_mm256_setzero_ps(), sin2_n);
+
+        for ( ; i + 4 <= n; i += 4, x += 4, y += 20) {
+            __m256 xv[5], yv[5];
+
+            for (int k = 0; k < 5; k++)
+                xv[k] = _mm256_loadu_ps((const float *)(x + k*n));
+
+            X86_FFT_5(__m256, _mm256_set1_ps, _mm256_add_ps,
+                _mm256_sub_ps, _mm256_mul_ps, __x86_cswap256, xv, yv);
+
+            for (int k = 0; k < 5; k++) {
+                __m128 lo = _mm256_castps256_ps128(yv[k]);
+                __m128 hi = _mm256_extractf128_ps(yv[k], 1);
+                _mm_storel_pi((__m64 *)(y +  0 + k), lo);
+                _mm_storeh_pi((__m64 *)(y +  5 + k), lo);
+                _mm_storel_pi((__m64 *)(y + 10 + k), hi);
+                _mm_storeh_pi((__m64 *)(y + 15 + k), hi);
+            }
+        }
+    }
+#endif /* __AVX2__ */
+
+    const __m128 sin1_n = _mm_setr_ps(
+         0.9510565163, -0.9510565163,  0.9510565163, -0.9510565163);
+    const __m128 sin2_n = _mm_setr_ps(
+         0.5877852523, -0.5877852523,  0.5877852523, -0.5877852523);
+    const __m128 sin1_p = _mm_sub_ps(_mm_setzero_ps(), sin1_n);
+    const __m128 sin2_p = _mm_sub_ps(_mm_setzero_ps(), sin2_n);
+
+    for ( ; i < n; i += 2, x += 2, y += 10) {
+        __m128 xv[5], yv[5];
+
+        for (int k = 0; k < 5; k++)
+            xv[k] = _mm_loadu_ps((const float *)(x + k*n));
+
+        X86_FFT_5(__m128, _mm_set1_ps, _mm_add_ps,
+            _mm_sub_ps, _mm_mul_ps, __x86_cswap, xv, yv);
+
+        for (int k = 0; k < 5; k++) {
+            _mm_storel_pi((__m64 *)(y + 0 + k), yv[k]);
+            _mm_storeh_pi((__m64 *)(y + 5 + k), yv[k]);
+        }
+    }
+}
+
+#undef __x86_cswap
+#undef __x86_cswap256
+#undef X86_FFT_5
+
+#endif /* fft_5 */
+
+/**
+ * FFT Butterfly 3 Points
+ */
+#ifndef fft_bf3
+#ifndef TEST_X86
+#define fft_bf3 x86_fft_bf3
+#endif /* TEST_X86 */
+
+/**
+ * Expand twiddles of 2 points, `w0` and `w1`, for the input `r` (1 or 2)
+ * return          { w0[r-1].re, w0[r-1].re, w1[r-1].re, w1[r-1].re } in `wr`,
+ *                 { -w0[r-1].im, w0[r-1].im, -w1[r-1].im, w1[r-1].im } in `wi`
+ */
+static inline void x86_fft_bf3_twiddles(
+    const struct lc3_complex *w0, const struct lc3_complex *w1,
+    int r, __m128 sign, __m128 *wr, __m128 *wi)
+{
+    __m128 a = _mm_loadu_ps((const float *)w0);
+    __m128 b = _mm_loadu_ps((const float *)w1);
+
+    if (r == 1) {
+        *wr = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 0, 0));
+        *wi = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 1, 1));
+    } else {
+        *wr = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 2, 2, 2));
+        *wi = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+
+    *wi = _mm_xor_ps(*wi, sign);
+}
+
+LC3_HOT static inline void x86_fft_bf3(
+    const struct lc3_fft_bf3_twiddles *twiddles,
+    const struct lc3_complex *x, struct lc3_complex *y, int n)
+{
+    int n3 = twiddles->n3;
+    const struct lc3_complex (*w0_ptr)[2] = twiddles->t;
+    const struct lc3_complex (*w1_ptr)[2] = w0_ptr + n3;
+    const struct lc3_complex (*w2_ptr)[2] = w1_ptr + n3;
+
+    const struct lc3_complex *x0_ptr = x;
+    const struct lc3_complex *x1_ptr = x0_ptr + n*n3;
+    const struct lc3_complex *x2_ptr = x1_ptr + n*n3;
+
+    struct lc3_complex *y0_ptr = y;
+    struct lc3_complex *y1_ptr = y0_ptr + n3;
+    struct lc3_complex *y2_ptr = y1_ptr + n3;
+
+    const __m128 sign = _mm_castsi128_ps(
+        _mm_setr_epi32(0x80000000, 0, 0x80000000, 0));
+
+    const struct lc3_complex (*w_ptr[3])[2] = { w0_ptr, w1_ptr, w2_ptr };
+
+    for (int j, i = 0; i < n; i++,
+            y0_ptr += 3*n3, y1_ptr += 3*n3, y2_ptr += 3*n3) {
+
+        struct lc3_complex *yn_ptr[3] = { y0_ptr, y1_ptr, y2_ptr };
+
+        /* --- Process by pair --- */
+
+        for (j = 0; j + 2 <= n3; j += 2,
+                x0_ptr += 2, x1_ptr += 2, x2_ptr += 2) {
+
+            __m128 x0 = _mm_loadu_ps((const float *)x0_ptr);
+            __m128 x1 = _mm_loadu_ps((const float *)x1_ptr);
+            __m128 x2 = _mm_loadu_ps((const float *)x2_ptr);
+
+            __m128 x1r = _mm_shuffle_ps(x1, x1, _MM_SHUFFLE(2, 3, 0, 1));
+            __m128 x2r = _mm_shuffle_ps(x2, x2, _MM_SHUFFLE(2, 3, 0, 1));
+
+            for (int k = 0; k < 3; k++) {
+                const struct lc3_complex (*w)[2] = w_ptr[k] + j;
+                __m128 w1r, w1i, w2r, w2i, yn;
+
+                x86_fft_bf3_twiddles(w[0], w[1], 1, sign, &w1r, &w1i);
+                x86_fft_bf3_twiddles(w[0], w[1], 2, sign, &w2r, &w2i);
+
+                yn = _mm_add_ps(x0, _mm_mul_ps(x1 , w1r));
+                yn = _mm_add_ps(yn, _mm_mul_ps(x1r, w1i));
+                yn = _mm_add_ps(yn, _mm_mul_ps(x2 , w2r));
+                yn = _mm_add_ps(yn, _mm_mul_ps(x2r, w2i));
+                _mm_storeu_ps((float *)(yn_ptr[k] + j), yn);
+            }
+        }
+
+        /* --- Last iteration --- */
+
+        if (n3 & 1) {
+
+            __m128 x0 = _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)x0_ptr++);
+            __m128 x1 = _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)x1_ptr++);
+            __m128 x2 = _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)x2_ptr++);
+
+            __m128 x1r = _mm_shuffle_ps(x1, x1, _MM_SHUFFLE(2, 3, 0, 1));
+            __m128 x2r = _mm_shuffle_ps(x2, x2, _MM_SHUFFLE(2, 3, 0, 1));
+
+            for (int k = 0; k < 3; k++) {
+                const struct lc3_complex (*w)[2] = w_ptr[k] + j;
+                __m128 w1r, w1i, w2r, w2i, yn;
+
+                x86_fft_bf3_twiddles(w[0], w[0], 1, sign, &w1r, &w1i);
+                x86_fft_bf3_twiddles(w[0], w[0], 2, sign, &w2r, &w2i);
+
+                yn = _mm_add_ps(x0, _mm_mul_ps(x1 , w1r));
+                yn = _mm_add_ps(yn, _mm_mul_ps(x1r, w1i));
+                yn = _mm_add_ps(yn, _mm_mul_ps(x2 , w2r));
+                yn = _mm_add_ps(yn, _mm_mul_ps(x2r, w2i));
+                _mm_storel_pi((__m64 *)(yn_ptr[k] + j), yn);
+            }
+        }
+    }
+}
+
+#endif /* fft_bf3 */
+
+/**
+ * FFT Butterfly 2 Points
+ */
+#ifndef fft_bf2
+#ifndef TEST_X86
+#define fft_bf2 x86_fft_bf2
+#endif /* TEST_X86 */
+
+LC3_HOT static inline void x86_fft_bf2(
+    const struct lc3_fft_bf2_twiddles *twiddles,
+    const struct lc3_complex *x, struct lc3_complex *y, int n)
+{
+    int n2 = twiddles->n2;
+    const struct lc3_complex *w_ptr = twiddles->t;
+
+    const struct lc3_complex *x0_ptr = x;
+    const struct lc3_complex *x1_ptr = x0_ptr + n*n2;
+
+    struct lc3_complex *y0_ptr = y;
+    struct lc3_complex *y1_ptr = y0_ptr + n2;
+
+    const __m128 sign = _mm_castsi128_ps(
+        _mm_setr_epi32(0x80000000, 0, 0x80000000, 0));
+
+#if __AVX2__
+    const __m256 sign256 = _mm256_castsi256_ps(
+        _mm256_setr_epi32(0x80000000, 0, 0x80000000, 0,
+                          0x80000000, 0, 0x80000000, 0));
+#endif /* __AVX2__ */
+
+    for (int j, i = 0; i < n; i++, y0_ptr += 2*n2, y1_ptr += 2*n2) {
+
+        j = 0;
+
+        /* --- Process by 4 --- */
+
+#if __AVX2__
+        for ( ; j + 4 <= n2; j += 4, x0_ptr += 4, x1_ptr += 4) {
+
+            __m256 x0 = _mm256_loadu_ps((const float *)x0_ptr);
+            __m256 x1 = _mm256_loadu_ps((const float *)x1_ptr);
+            __m256 y0, y1;
+
+            __m256 x1r = _mm256_permute_ps(x1, _MM_SHUFFLE(2, 3, 0, 1));
+
+            __m256 w = _mm256_loadu_ps((const float *)(w_ptr + j));
+            __m256 w_re = _mm256_moveldup_ps(w);
+            __m256 w_im = _mm256_xor_ps(_mm256_movehdup_ps(w), sign256);
+
+            y0 = _mm256_add_ps(x0, _mm256_mul_ps(x1 , w_re));
+            y0 = _mm256_add_ps(y0, _mm256_mul_ps(x1r, w_im));
+            _mm256_storeu_ps((float *)(y0_ptr + j), y0);
+
+            y1 = _mm256_sub_ps(x0, _mm256_mul_ps(x1 , w_re));
+            y1 = _mm256_sub_ps(y1, _mm256_mul_ps(x1r, w_im));
+            _mm256_storeu_ps((float *)(y1_ptr + j), y1);
+        }
+#endif /* __AVX2__ */
+
+        /* --- Process by pair --- */
+
+        for ( ; j + 2 <= n2; j += 2, x0_ptr += 2, x1_ptr += 2) {
+
+            __m128 x0 = _mm_loadu_ps((const float *)x0_ptr);
+            __m128 x1 = _mm_loadu_ps((const float *)x1_ptr);
+            __m128 y0, y1;
+
+            __m128 x1r = _mm_shuffle_ps(x1, x1, _MM_SHUFFLE(2, 3, 0, 1));
+
+            __m128 w = _mm_loadu_ps((const float *)(w_ptr + j));
+            __m128 w_re = _mm_moveldup_ps(w);
+            __m128 w_im = _mm_xor_ps(_mm_movehdup_ps(w), sign);
+
+            y0 = _mm_add_ps(x0, _mm_mul_ps(x1 , w_re));
+            y0 = _mm_add_ps(y0, _mm_mul_ps(x1r, w_im));
+            _mm_storeu_ps((float *)(y0_ptr + j), y0);
+
+            y1 = _mm_sub_ps(x0, _mm_mul_ps(x1 , w_re));
+            y1 = _mm_sub_ps(y1, _mm_mul_ps(x1r, w_im));
+            _mm_storeu_ps((float *)(y1_ptr + j), y1);
+        }
+
+        /* --- Last iteration --- */
+
+        if (n2 & 1) {
+
+            __m128 x0 = _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)x0_ptr++);
+            __m128 x1 = _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)x1_ptr++);
+            __m128 y0, y1;
+
+            __m128 x1r = _mm_shuffle_ps(x1, x1, _MM_SHUFFLE(2, 3, 0, 1));
+
+            __m128 w = _mm_loadl_pi(_mm_setzero_ps(),
+                                    (const __m64 *)(w_ptr + j));
+            __m128 w_re = _mm_moveldup_ps(w);
+            __m128 w_im = _mm_xor_ps(_mm_movehdup_ps(w), sign);
+
+            y0 = _mm_add_ps(x0, _mm_mul_ps(x1 , w_re));
+            y0 = _mm_add_ps(y0, _mm_mul_ps(x1r, w_im));
+            _mm_storel_pi((__m64 *)(y0_ptr + j), y0);
+
+            y1 = _mm_sub_ps(x0, _mm_mul_ps(x1 , w_re));
+            y1 = _mm_sub_ps(y1, _mm_mul_ps(x1r, w_im));
+            _mm_storel_pi((__m64 *)(y1_ptr + j), y1);
+        }
+    }
+}
+
+#endif /* fft_bf2 */
+
+#endif /* __SSE4_1__ */
@@ -705,14 +705,18 @@ LC3_HOT static void spectral_shaping(enum lc3_dt dt, enum lc3_srate sr,
 
     /* --- Spectral shaping --- */
 
+    /* The gains are computed apart from the shaping loop,
+     * so that the exponentiations can be vectorized */
+
     const int *lim = lc3_band_lim[dt][sr];
+    float g_sns[LC3_NUM_BANDS];
 
-    for (int i = 0, ib = 0; ib < nb; ib++) {
-        float g_sns = fast_exp2f(-scf[ib]);
+    for (int ib = 0; ib < nb; ib++)
+        g_sns[ib] = fast_exp2f(-scf[ib]);
 
+    for (int i = 0, ib = 0; ib < nb; ib++)
         for ( ; i < lim[ib+1]; i++)
-            y[i] = x[i] * g_sns;
-    }
+            y[i] = x[i] * g_sns[ib];
 }
 
 
@@ -37,6 +37,22 @@ extern const struct lc3_mdct_rot_def *lc3_mdct_rot[LC3_NUM_DT][LC3_NUM_SRATE];
 
 extern const float *lc3_mdct_win[LC3_NUM_DT][LC3_NUM_SRATE];
 
+/**
+ * Q31 MDCT twiddles, of the fixed-point transform (`tables_q31.c`)
+ */
+
+struct lc3_fft_bf3_twiddles_q31 {
+    int n3; const struct lc3_complex_q31 (*t)[2]; };
+struct lc3_fft_bf2_twiddles_q31 {
+    int n2; const struct lc3_complex_q31 *t; };
+struct lc3_mdct_rot_def_q31 {
+    int n4; const struct lc3_complex_q31 *w; };
+
+extern const struct lc3_fft_bf3_twiddles_q31 *lc3_fft_twiddles_bf3_q31[];
+extern const struct lc3_fft_bf2_twiddles_q31 *lc3_fft_twiddles_bf2_q31[][3];
+extern const struct lc3_mdct_rot_def_q31
+    *lc3_mdct_rot_q31[LC3_NUM_DT][LC3_NUM_SRATE];
+
 
 /**
  * Limits of bands
@@ -0,0 +1,998 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "tables.h"
+
+
+/**
+ * Q31 versions of the MDCT twiddles, for the fixed-point transform.
+ * The values are the rounded float ones, as printed by `mktables.py`.
+ */
+
+
+/**
+ * Twiddles FFT 3 points
+ *
+ * T[0..N-1] =
+ *   { cos(-2Pi *  i/N) + j sin(-2Pi *  i/N),
+ *     cos(-2Pi * 2i/N) + j sin(-2Pi * 2i/N) } , N=15, 45
+ */
+
+static const struct lc3_fft_bf3_twiddles_q31 fft_twiddles_q31_15 = {
+    .n3 = 15/3, .t = (const struct lc3_complex_q31 [][2]){
+        { {  2147483647,           0 }, {  2147483647,           0 } },
+        { {  1961823932,  -873460290 }, {  1436947036, -1595891361 } },
+        { {  1436947036, -1595891361 }, {  -224473166, -2135719508 } },
+        { {   663608942, -2042378317 }, { -1737350766, -1262259218 } },
+        { {  -224473166, -2135719508 }, { -2100555978,   446486956 } },
+        { { -1073741824, -1859775393 }, { -1073741824,  1859775393 } },
+        { { -1737350766, -1262259218 }, {   663608942,  2042378317 } },
+        { { -2100555978,  -446486956 }, {  1961823932,   873460290 } },
+        { { -2100555978,   446486956 }, {  1961823932,  -873460290 } },
+        { { -1737350766,  1262259218 }, {   663608942, -2042378317 } },
+        { { -1073741824,  1859775393 }, { -1073741824, -1859775393 } },
+        { {  -224473166,  2135719508 }, { -2100555978,  -446486956 } },
+        { {   663608942,  2042378317 }, { -1737350766,  1262259218 } },
+        { {  1436947036,  1595891361 }, {  -224473166,  2135719508 } },
+        { {  1961823932,   873460290 }, {  1436947036,  1595891361 } },
+    }
+};
+
+static const struct lc3_fft_bf3_twiddles_q31 fft_twiddles_q31_45 = {
+    .n3 = 45/3, .t = (const struct lc3_complex_q31 [][2]){
+        { {  2147483647,           0 }, {  2147483647,           0 } },
+        { {  2126584485,  -298871959 }, {  2064293773,  -591926714 } },
+        { {  2064293773,  -591926714 }, {  1821169419, -1137992955 } },
+        { {  1961823932,  -873460290 }, {  1436947036, -1595891361 } },
+        { {  1821169419, -1137992955 }, {   941394869, -1930145517 } },
+        { {  1645067915, -1380375881 }, {   372906622, -2114858546 } },
+        { {  1436947036, -1595891361 }, {  -224473166, -2135719508 } },
+        { {  1200857616, -1780344631 }, {  -804461534, -1991112166 } },
+        { {   941394869, -1930145517 }, { -1322122951, -1692240208 } },
+        { {   663608942, -2042378317 }, { -1737350766, -1262259218 } },
+        { {   372906622, -2114858546 }, { -2017974537,  -734482665 } },
+        { {    74946098, -2146175459 }, { -2142252486,  -149800887 } },
+        { {  -224473166, -2135719508 }, { -2100555978,   446486956 } },
+        { {  -519523315, -2083694206 }, { -1896115518,  1008182504 } },
+        { {  -804461534, -1991112166 }, { -1544770459,  1491767492 } },
+        { { -1073741824, -1859775393 }, { -1073741824,  1859775393 } },
+        { { -1322122951, -1692240208 }, {  -519523315,  2083694206 } },
+        { { -1544770459, -1491767492 }, {    74946098,  2146175459 } },
+        { { -1737350766, -1262259218 }, {   663608942,  2042378317 } },
+        { { -1896115518, -1008182504 }, {  1200857616,  1780344631 } },
+        { { -2017974537,  -734482665 }, {  1645067915,  1380375881 } },
+        { { -2100555978,  -446486956 }, {  1961823932,   873460290 } },
+        { { -2142252486,  -149800887 }, {  2126584485,   298871959 } },
+        { { -2142252486,   149800887 }, {  2126584485,  -298871959 } },
+        { { -2100555978,   446486956 }, {  1961823932,  -873460290 } },
+        { { -2017974537,   734482665 }, {  1645067915, -1380375881 } },
+        { { -1896115518,  1008182504 }, {  1200857616, -1780344631 } },
+        { { -1737350766,  1262259218 }, {   663608942, -2042378317 } },
+        { { -1544770459,  1491767492 }, {    74946098, -2146175459 } },
+        { { -1322122951,  1692240208 }, {  -519523315, -2083694206 } },
+        { { -1073741824,  1859775393 }, { -1073741824, -1859775393 } },
+        { {  -804461534,  1991112166 }, { -1544770459, -1491767492 } },
+        { {  -519523315,  2083694206 }, { -1896115518, -1008182504 } },
+        { {  -224473166,  2135719508 }, { -2100555978,  -446486956 } },
+        { {    74946098,  2146175459 }, { -2142252486,   149800887 } },
+        { {   372906622,  2114858546 }, { -2017974537,   734482665 } },
+        { {   663608942,  2042378317 }, { -1737350766,  1262259218 } },
+        { {   941394869,  1930145517 }, { -1322122951,  1692240208 } },
+        { {  1200857616,  1780344631 }, {  -804461534,  1991112166 } },
+        { {  1436947036,  1595891361 }, {  -224473166,  2135719508 } },
+        { {  1645067915,  1380375881 }, {   372906622,  2114858546 } },
+        { {  1821169419,  1137992955 }, {   941394869,  1930145517 } },
+        { {  1961823932,   873460290 }, {  1436947036,  1595891361 } },
+        { {  2064293773,   591926714 }, {  1821169419,  1137992955 } },
+        { {  2126584485,   298871959 }, {  2064293773,   591926714 } },
+    }
+};
+
+const struct lc3_fft_bf3_twiddles_q31 *lc3_fft_twiddles_bf3_q31[] =
+    { &fft_twiddles_q31_15, &fft_twiddles_q31_45 };
+
+
+/**
+ * Twiddles FFT 2 points
+ *
+ * T[0..N/2-1] =
+ *   cos(-2Pi * i/N) + j sin(-2Pi * i/N) , N=10, 20, ...
+ */
+
+static const struct lc3_fft_bf2_twiddles_q31 fft_twiddles_q31_10 = {
+    .n2 = 10/2, .t = (const struct lc3_complex_q31 []){
+        {  2147483647,           0 }, {  1737350766, -1262259218 },
+        {   663608942, -2042378317 }, {  -663608942, -2042378317 },
+        { -1737350766, -1262259218 },
+    }
+};
+
+static const struct lc3_fft_bf2_twiddles_q31 fft_twiddles_q31_20 = {
+    .n2 = 20/2, .t = (const struct lc3_complex_q31 []){
+        {  2147483647,           0 }, {  2042378317,  -663608942 },
+        {  1737350766, -1262259218 }, {  1262259218, -1737350766 },
+        {   663608942, -2042378317 }, {           0, -2147483648 },
+        {  -663608942, -2042378317 }, { -1262259218, -1737350766 },
+        { -1737350766, -1262259218 }, { -2042378317,  -663608942 },
+    }
+};
+
+static const struct lc3_fft_bf2_twiddles_q31 fft_twiddles_q31_30 = {
+    .n2 = 30/2, .t = (const struct lc3_complex_q31 []){
+        {  2147483647,           0 }, {  2100555978,  -446486956 },
+        {  1961823932,  -873460290 }, {  1737350766, -1262259218 },
+        {  1436947036, -1595891361 }, {  1073741824, -1859775393 },
+        {   663608942, -2042378317 }, {   224473166, -2135719508 },
+        {  -224473166, -2135719508 }, {  -663608942, -2042378317 },
+        { -1073741824, -1859775393 }, { -1436947036, -1595891361 },
+        { -1737350766, -1262259218 }, { -1961823932,  -873460290 },
+        { -2100555978,  -446486956 },
+    }
+};
+
+static const struct lc3_fft_bf2_twiddles_q31 fft_twiddles_q31_40 = {
+    .n2 = 40/2, .t = (const struct lc3_complex_q31 []){
+        {  2147483647,           0 }, {  2121044561,  -335940456 },
+        {  2042378317,  -663608942 }, {  1913421941,  -974937175 },
+        {  1737350766, -1262259218 }, {  1518500250, -1518500250 },
+        {  1262259218, -1737350766 }, {   974937175, -1913421941 },
+        {   663608942, -2042378317 }, {   335940456, -2121044561 },
+        {           0, -2147483648 }, {  -335940456, -2121044561 },
+        {  -663608942, -2042378317 }, {  -974937175, -1913421941 },
+        { -1262259218, -1737350766 }, { -1518500250, -1518500250 },
+        { -1737350766, -1262259218 }, { -1913421941,  -974937175 },
+        { -2042378317,  -663608942 }, { -2121044561,  -335940456 },
+    }
+};
+
+static const struct lc3_fft_bf2_twiddles_q31 fft_twiddles_q31_60 = {
+    .n2 = 60/2, .t = (const struct lc3_complex_q31 []){
+        {  2147483647,           0 }, {  2135719508,  -224473166 },
+        {  2100555978,  -446486956 }, {  2042378317,  -663608942 },
+        {  1961823932,  -873460290 }, {  1859775393, -1073741824 },
+        {  1737350766, -1262259218 }, {  1595891361, -1436947036 },
+        {  1436947036, -1595891361 }, {  1262259218, -1737350766 },
+        {  1073741824, -1859775393 }, {   873460290, -1961823932 },
+        {   663608942, -2042378317 }, {   446486956, -2100555978 },
+        {   224473166, -2135719508 }, {           0, -2147483648 },
+        {  -224473166, -2135719508 }, {  -446486956, -2100555978 },
+        {  -663608942, -2042378317 }, {  -873460290, -1961823932 },
+        { -1073741824, -1859775393 }, { -1262259218, -1737350766 },
+        { -1436947036, -1595891361 }, { -1595891361, -1436947036 },
+        { -1737350766, -1262259218 }, { -1859775393, -1073741824 },
+        { -1961823932,  -873460290 }, { -2042378317,  -663608942 },
+        { -2100555978,  -446486956 }, { -2135719508,  -224473166 },
+    }
+};
+
+static const struct lc3_fft_bf2_twiddles_q31 fft_twiddles_q31_80 = {
+    .n2 = 80/2, .t = (const struct lc3_complex_q31 []){
+        {  2147483647,           0 }, {  2140863673,  -168489625 },
+        {  2121044561,  -335940456 }, {  2088148504,  -501320102 },
+        {  2042378317,  -663608942 }, {  1984016189,  -821806413 },
+        {  1913421941,  -974937175 }, {  1831030811, -1122057124 },
+        {  1737350766, -1262259218 }, {  1632959377, -1394679064 },
+        {  1518500250, -1518500250 }, {  1394679064, -1632959377 },
+        {  1262259218, -1737350766 }, {  1122057124, -1831030811 },
+        {   974937175, -1913421941 }, {   821806413, -1984016189 },
+        {   663608942, -2042378317 }, {   501320102, -2088148504 },
+        {   335940456, -2121044561 }, {   168489625, -2140863673 },
+        {           0, -2147483648 }, {  -168489625, -2140863673 },
+        {  -335940456, -2121044561 }, {  -501320102, -2088148504 },
+        {  -663608942, -2042378317 }, {  -821806413, -1984016189 },
+        {  -974937175, -1913421941 }, { -1122057124, -1831030811 },
+        { -1262259218, -1737350766 }, { -1394679064, -1632959377 },
+        { -1518500250, -1518500250 }, { -1632959377, -1394679064 },
+        { -1737350766, -1262259218 }, { -1831030811, -1122057124 },
+        { -1913421941,  -974937175 }, { -1984016189,  -821806413 },
+        { -2042378317,  -663608942 }, { -2088148504,  -501320102 },
+        { -2121044561,  -335940456 }, { -2140863673,  -168489625 },
+    }
+};
+
+static const struct lc3_fft_bf2_twiddles_q31 fft_twiddles_q31_90 = {
+    .n2 = 90/2, .t = (const struct lc3_complex_q31 []){
+        {  2147483647,           0 }, {  2142252486,  -149800887 },
+        {  2126584485,  -298871959 }, {  2100555978,  -446486956 },
+        {  2064293773,  -591926714 }, {  2017974537,  -734482665 },
+        {  1961823932,  -873460290 }, {  1896115518, -1008182504 },
+        {  1821169419, -1137992955 }, {  1737350766, -1262259218 },
+        {  1645067915, -1380375881 }, {  1544770459, -1491767492 },
+        {  1436947036, -1595891361 }, {  1322122951, -1692240208 },
+        {  1200857616, -1780344631 }, {  1073741824, -1859775393 },
+        {   941394869, -1930145517 }, {   804461534, -1991112166 },
+        {   663608942, -2042378317 }, {   519523315, -2083694206 },
+        {   372906622, -2114858546 }, {   224473166, -2135719508 },
+        {    74946098, -2146175459 }, {   -74946098, -2146175459 },
+        {  -224473166, -2135719508 }, {  -372906622, -2114858546 },
+        {  -519523315, -2083694206 }, {  -663608942, -2042378317 },
+        {  -804461534, -1991112166 }, {  -941394869, -1930145517 },
+        { -1073741824, -1859775393 }, { -1200857616, -1780344631 },
+        { -1322122951, -1692240208 }, { -1436947036, -1595891361 },
+        { -1544770459, -1491767492 }, { -1645067915, -1380375881 },
+        { -1737350766, -1262259218 }, { -1821169419, -1137992955 },
+        { -1896115518, -1008182504 }, { -1961823932,  -873460290 },
+        { -2017974537,  -734482665 }, { -2064293773,  -591926714 },
+        { -2100555978,  -446486956 }, { -2126584485,  -298871959 },
+        { -2142252486,  -149800887 },
+    }
+};
+
+static const struct lc3_fft_bf2_twiddles_q31 fft_twiddles_q31_120 = {
+    .n2 = 120/2, .t = (const struct lc3_complex_q31 []){
+        {  2147483647,           0 }, {  2144540596,  -112390610 },
+        {  2135719508,  -224473166 }, {  2121044561,  -335940456 },
+        {  2100555978,  -446486956 }, {  2074309917,  -555809667 },
+        {  2042378317,  -663608942 }, {  2004848700,  -769589312 },
+        {  1961823932,  -873460290 }, {  1913421941,  -974937175 },
+        {  1859775393, -1073741824 }, {  1801031331, -1169603422 },
+        {  1737350766, -1262259218 }, {  1668908244, -1351455249 },
+        {  1595891361, -1436947036 }, {  1518500250, -1518500250 },
+        {  1436947036, -1595891361 }, {  1351455249, -1668908244 },
+        {  1262259218, -1737350766 }, {  1169603422, -1801031331 },
+        {  1073741824, -1859775393 }, {   974937175, -1913421941 },
+        {   873460290, -1961823932 }, {   769589312, -2004848700 },
+        {   663608942, -2042378317 }, {   555809667, -2074309917 },
+        {   446486956, -2100555978 }, {   335940456, -2121044561 },
+        {   224473166, -2135719508 }, {   112390610, -2144540596 },
+        {           0, -2147483648 }, {  -112390610, -2144540596 },
+        {  -224473166, -2135719508 }, {  -335940456, -2121044561 },
+        {  -446486956, -2100555978 }, {  -555809667, -2074309917 },
+        {  -663608942, -2042378317 }, {  -769589312, -2004848700 },
+        {  -873460290, -1961823932 }, {  -974937175, -1913421941 },
+        { -1073741824, -1859775393 }, { -1169603422, -1801031331 },
+        { -1262259218, -1737350766 }, { -1351455249, -1668908244 },
+        { -1436947036, -1595891361 }, { -1518500250, -1518500250 },
+        { -1595891361, -1436947036 }, { -1668908244, -1351455249 },
+        { -1737350766, -1262259218 }, { -1801031331, -1169603422 },
+        { -1859775393, -1073741824 }, { -1913421941,  -974937175 },
+        { -1961823932,  -873460290 }, { -2004848700,  -769589312 },
+        { -2042378317,  -663608942 }, { -2074309917,  -555809667 },
+        { -2100555978,  -446486956 }, { -2121044561,  -335940456 },
+        { -2135719508,  -224473166 }, { -2144540596,  -112390610 },
+    }
+};
+
+static const struct lc3_fft_bf2_twiddles_q31 fft_twiddles_q31_160 = {
+    .n2 = 160/2, .t = (const struct lc3_complex_q31 []){
+        {  2147483647,           0 }, {  2145828016,   -84309812 },
+        {  2140863673,  -168489625 }, {  2132598273,  -252409639 },
+        {  2121044561,  -335940456 }, {  2106220352,  -418953276 },
+        {  2088148504,  -501320102 }, {  2066856882,  -582913927 },
+        {  2042378317,  -663608942 }, {  2014750553,  -743280720 },
+        {  1984016189,  -821806413 }, {  1950222616,  -899064940 },
+        {  1913421941,  -974937175 }, {  1873670908, -1049306126 },
+        {  1831030811, -1122057124 }, {  1785567396, -1193077991 },
+        {  1737350766, -1262259218 }, {  1686455268, -1329494133 },
+        {  1632959377, -1394679064 }, {  1576945581, -1457713501 },
+        {  1518500250, -1518500250 }, {  1457713501, -1576945581 },
+        {  1394679064, -1632959377 }, {  1329494133, -1686455268 },
+        {  1262259218, -1737350766 }, {  1193077991, -1785567396 },
+        {  1122057124, -1831030811 }, {  1049306126, -1873670908 },
+        {   974937175, -1913421941 }, {   899064940, -1950222616 },
+        {   821806413, -1984016189 }, {   743280720, -2014750553 },
+        {   663608942, -2042378317 }, {   582913927, -2066856882 },
+        {   501320102, -2088148504 }, {   418953276, -2106220352 },
+        {   335940456, -2121044561 }, {   252409639, -2132598273 },
+        {   168489625, -2140863673 }, {    84309812, -2145828016 },
+        {           0, -2147483648 }, {   -84309812, -2145828016 },
+        {  -168489625, -2140863673 }, {  -252409639, -2132598273 },
+        {  -335940456, -2121044561 }, {  -418953276, -2106220352 },
+        {  -501320102, -2088148504 }, {  -582913927, -2066856882 },
+        {  -663608942, -2042378317 }, {  -743280720, -2014750553 },
+        {  -821806413, -1984016189 }, {  -899064940, -1950222616 },
+        {  -974937175, -1913421941 }, { -1049306126, -1873670908 },
+        { -1122057124, -1831030811 }, { -1193077991, -1785567396 },
+        { -1262259218, -1737350766 }, { -1329494133, -1686455268 },
+        { -1394679064, -1632959377 }, { -1457713501, -1576945581 },
+        { -1518500250, -1518500250 }, { -1576945581, -1457713501 },
+        { -1632959377, -1394679064 }, { -1686455268, -1329494133 },
+        { -1737350766, -1262259218 }, { -1785567396, -1193077991 },
+        { -1831030811, -1122057124 }, { -1873670908, -1049306126 },
+        { -1913421941,  -974937175 }, { -1950222616,  -899064940 },
+        { -1984016189,  -821806413 }, { -2014750553,  -743280720 },
+        { -2042378317,  -663608942 }, { -2066856882,  -582913927 },
+        { -2088148504,  -501320102 }, { -2106220352,  -418953276 },
+        { -2121044561,  -335940456 }, { -2132598273,  -252409639 },
+        { -2140863673,  -168489625 }, { -2145828016,   -84309812 },
+    }
+};
+
+static const struct lc3_fft_bf2_twiddles_q31 fft_twiddles_q31_180 = {
+    .n2 = 180/2, .t = (const struct lc3_complex_q31 []){
+        {  2147483647,           0 }, {  2146175459,   -74946098 },
+        {  2142252486,  -149800887 }, {  2135719508,  -224473166 },
+        {  2126584485,  -298871959 }, {  2114858546,  -372906622 },
+        {  2100555978,  -446486956 }, {  2083694206,  -519523315 },
+        {  2064293773,  -591926714 }, {  2042378317,  -663608942 },
+        {  2017974537,  -734482665 }, {  1991112166,  -804461534 },
+        {  1961823932,  -873460290 }, {  1930145517,  -941394869 },
+        {  1896115518, -1008182504 }, {  1859775393, -1073741824 },
+        {  1821169419, -1137992955 }, {  1780344631, -1200857616 },
+        {  1737350766, -1262259218 }, {  1692240208, -1322122951 },
+        {  1645067915, -1380375881 }, {  1595891361, -1436947036 },
+        {  1544770459, -1491767492 }, {  1491767492, -1544770459 },
+        {  1436947036, -1595891361 }, {  1380375881, -1645067915 },
+        {  1322122951, -1692240208 }, {  1262259218, -1737350766 },
+        {  1200857616, -1780344631 }, {  1137992955, -1821169419 },
+        {  1073741824, -1859775393 }, {  1008182504, -1896115518 },
+        {   941394869, -1930145517 }, {   873460290, -1961823932 },
+        {   804461534, -1991112166 }, {   734482665, -2017974537 },
+        {   663608942, -2042378317 }, {   591926714, -2064293773 },
+        {   519523315, -2083694206 }, {   446486956, -2100555978 },
+        {   372906622, -2114858546 }, {   298871959, -2126584485 },
+        {   224473166, -2135719508 }, {   149800887, -2142252486 },
+        {    74946098, -2146175459 }, {           0, -2147483648 },
+        {   -74946098, -2146175459 }, {  -149800887, -2142252486 },
+        {  -224473166, -2135719508 }, {  -298871959, -2126584485 },
+        {  -372906622, -2114858546 }, {  -446486956, -2100555978 },
+        {  -519523315, -2083694206 }, {  -591926714, -2064293773 },
+        {  -663608942, -2042378317 }, {  -734482665, -2017974537 },
+        {  -804461534, -1991112166 }, {  -873460290, -1961823932 },
+        {  -941394869, -1930145517 }, { -1008182504, -1896115518 },
+        { -1073741824, -1859775393 }, { -1137992955, -1821169419 },
+        { -1200857616, -1780344631 }, { -1262259218, -1737350766 },
+        { -1322122951, -1692240208 }, { -1380375881, -1645067915 },
+        { -1436947036, -1595891361 }, { -1491767492, -1544770459 },
+        { -1544770459, -1491767492 }, { -1595891361, -1436947036 },
+        { -1645067915, -1380375881 }, { -1692240208, -1322122951 },
+        { -1737350766, -1262259218 }, { -1780344631, -1200857616 },
+        { -1821169419, -1137992955 }, { -1859775393, -1073741824 },
+        { -1896115518, -1008182504 }, { -1930145517,  -941394869 },
+        { -1961823932,  -873460290 }, { -1991112166,  -804461534 },
+        { -2017974537,  -734482665 }, { -2042378317,  -663608942 },
+        { -2064293773,  -591926714 }, { -2083694206,  -519523315 },
+        { -2100555978,  -446486956 }, { -2114858546,  -372906622 },
+        { -2126584485,  -298871959 }, { -2135719508,  -224473166 },
+        { -2142252486,  -149800887 }, { -2146175459,   -74946098 },
+    }
+};
+
+static const struct lc3_fft_bf2_twiddles_q31 fft_twiddles_q31_240 = {
+    .n2 = 240/2, .t = (const struct lc3_complex_q31 []){
+        {  2147483647,           0 }, {  2146747759,   -56214568 },
+        {  2144540596,  -112390610 }, {  2140863673,  -168489625 },
+        {  2135719508,  -224473166 }, {  2129111628,  -280302863 },
+        {  2121044561,  -335940456 }, {  2111523836,  -391347811 },
+        {  2100555978,  -446486956 }, {  2088148504,  -501320102 },
+        {  2074309917,  -555809667 }, {  2059049702,  -609918309 },
+        {  2042378317,  -663608942 }, {  2024307188,  -716844772 },
+        {  2004848700,  -769589312 }, {  1984016189,  -821806413 },
+        {  1961823932,  -873460290 }, {  1938287139,  -924515541 },
+        {  1913421941,  -974937175 }, {  1887245379, -1024690635 },
+        {  1859775393, -1073741824 }, {  1831030811, -1122057124 },
+        {  1801031331, -1169603422 }, {  1769797514, -1216348132 },
+        {  1737350766, -1262259218 }, {  1703713325, -1307305214 },
+        {  1668908244, -1351455249 }, {  1632959377, -1394679064 },
+        {  1595891361, -1436947036 }, {  1557729600, -1478230195 },
+        {  1518500250, -1518500250 }, {  1478230195, -1557729600 },
+        {  1436947036, -1595891361 }, {  1394679064, -1632959377 },
+        {  1351455249, -1668908244 }, {  1307305214, -1703713325 },
+        {  1262259218, -1737350766 }, {  1216348132, -1769797514 },
+        {  1169603422, -1801031331 }, {  1122057124, -1831030811 },
+        {  1073741824, -1859775393 }, {  1024690635, -1887245379 },
+        {   974937175, -1913421941 }, {   924515541, -1938287139 },
+        {   873460290, -1961823932 }, {   821806413, -1984016189 },
+        {   769589312, -2004848700 }, {   716844772, -2024307188 },
+        {   663608942, -2042378317 }, {   609918309, -2059049702 },
+        {   555809667, -2074309917 }, {   501320102, -2088148504 },
+        {   446486956, -2100555978 }, {   391347811, -2111523836 },
+        {   335940456, -2121044561 }, {   280302863, -2129111628 },
+        {   224473166, -2135719508 }, {   168489625, -2140863673 },
+        {   112390610, -2144540596 }, {    56214568, -2146747759 },
+        {           0, -2147483648 }, {   -56214568, -2146747759 },
+        {  -112390610, -2144540596 }, {  -168489625, -2140863673 },
+        {  -224473166, -2135719508 }, {  -280302863, -2129111628 },
+        {  -335940456, -2121044561 }, {  -391347811, -2111523836 },
+        {  -446486956, -2100555978 }, {  -501320102, -2088148504 },
+        {  -555809667, -2074309917 }, {  -609918309, -2059049702 },
+        {  -663608942, -2042378317 }, {  -716844772, -2024307188 },
+        {  -769589312, -2004848700 }, {  -821806413, -1984016189 },
+        {  -873460290, -1961823932 }, {  -924515541, -1938287139 },
+        {  -974937175, -1913421941 }, { -1024690635, -1887245379 },
+        { -1073741824, -1859775393 }, { -1122057124, -1831030811 },
+        { -1169603422, -1801031331 }, { -1216348132, -1769797514 },
+        { -1262259218, -1737350766 }, { -1307305214, -1703713325 },
+        { -1351455249, -1668908244 }, { -1394679064, -1632959377 },
+        { -1436947036, -1595891361 }, { -1478230195, -1557729600 },
+        { -1518500250, -1518500250 }, { -1557729600, -1478230195 },
+        { -1595891361, -1436947036 }, { -1632959377, -1394679064 },
+        { -1668908244, -1351455249 }, { -1703713325, -1307305214 },
+        { -1737350766, -1262259218 }, { -1769797514, -1216348132 },
+        { -1801031331, -1169603422 }, { -1831030811, -1122057124 },
+        { -1859775393, -1073741824 }, { -1887245379, -1024690635 },
+        { -1913421941,  -974937175 }, { -1938287139,  -924515541 },
+        { -1961823932,  -873460290 }, { -1984016189,  -821806413 },
+        { -2004848700,  -769589312 }, { -2024307188,  -716844772 },
+        { -2042378317,  -663608942 }, { -2059049702,  -609918309 },
+        { -2074309917,  -555809667 }, { -2088148504,  -501320102 },
+        { -2100555978,  -446486956 }, { -2111523836,  -391347811 },
+        { -2121044561,  -335940456 }, { -2129111628,  -280302863 },
+        { -2135719508,  -224473166 }, { -2140863673,  -168489625 },
+        { -2144540596,  -112390610 }, { -2146747759,   -56214568 },
+    }
+};
+
+const struct lc3_fft_bf2_twiddles_q31 *lc3_fft_twiddles_bf2_q31[][3] = {
+    { &fft_twiddles_q31_10 , &fft_twiddles_q31_30 , &fft_twiddles_q31_90  },
+    { &fft_twiddles_q31_20 , &fft_twiddles_q31_60 , &fft_twiddles_q31_180 },
+    { &fft_twiddles_q31_40 , &fft_twiddles_q31_120 },
+    { &fft_twiddles_q31_80 , &fft_twiddles_q31_240 },
+    { &fft_twiddles_q31_160  }
+};
+
+
+/**
+ * MDCT Rotation twiddles
+ *
+ *            2Pi (n + 1/8) / N
+ *   W[n] = e                   , n = [0..N/4-1]
+ */
+
+static const struct lc3_mdct_rot_def_q31 mdct_rot_q31_120 = {
+    .n4 = 120/4, .w = (const struct lc3_complex_q31 []){
+        {  2147437652,    14055147 }, {  2143759074,   126424088 },
+        {  2134204601,   238446509 }, {  2118800422,   349815365 },
+        {  2097588758,   460225402 }, {  2070627749,   569373992 },
+        {  2037991293,   676961968 }, {  1999768845,   782694439 },
+        {  1956065170,   886281598 }, {  1907000055,   987439521 },
+        {  1852707986,  1085890941 }, {  1793337774,  1181366009 },
+        {  1729052147,  1273603035 }, {  1660027308,  1362349204 },
+        {  1586452450,  1447361268 }, {  1508529236,  1528406216 },
+        {  1426471249,  1605261909 }, {  1340503402,  1677717690 },
+        {  1250861329,  1745574963 }, {  1157790732,  1808647737 },
+        {  1061546712,  1866763134 }, {   962393065,  1919761862 },
+        {   860601566,  1967498656 }, {   756451218,  2009842674 },
+        {   650227490,  2046677852 }, {   542221533,  2077903229 },
+        {   432729385,  2103433217 }, {   322051155,  2123197841 },
+        {   210490206,  2137142927 }, {    98352318,  2145230253 },
+    }
+};
+
+static const struct lc3_mdct_rot_def_q31 mdct_rot_q31_160 = {
+    .n4 = 160/4, .w = (const struct lc3_complex_q31 []){
+        {  2147457775,    10541393 }, {  2145388310,    94842063 },
+        {  2140010812,   178996493 }, {  2131333572,   262874923 },
+        {  2119369970,   346348020 }, {  2104138453,   429287072 },
+        {  2085662507,   511564196 }, {  2063970621,   593052524 },
+        {  2039096241,   673626408 }, {  2011077723,   753161609 },
+        {  1979958269,   831535490 }, {  1945785863,   908627203 },
+        {  1908613196,   984317879 }, {  1868497586,  1058490808 },
+        {  1825500888,  1131031621 }, {  1779689400,  1201828465 },
+        {  1731133759,  1270772177 }, {  1679908837,  1337756450 },
+        {  1626093616,  1402678000 }, {  1569771077,  1465436721 },
+        {  1511028065,  1525935846 }, {  1449955157,  1584082088 },
+        {  1386646523,  1639785791 }, {  1321199781,  1692961062 },
+        {  1253715844,  1743525911 }, {  1184298768,  1791402368 },
+        {  1113055590,  1836516614 }, {  1040096161,  1878799083 },
+        {   965532978,  1918184581 }, {   889481014,  1954612377 },
+        {   812057535,  1988026302 }, {   733381922,  2018374835 },
+        {   653575486,  2045611181 }, {   572761285,  2069693342 },
+        {   491063928,  2090584186 }, {   408609385,  2108251500 },
+        {   325524797,  2122668044 }, {   241938273,  2133811587 },
+        {   157978697,  2141664948 }, {    73775530,  2146216017 },
+    }
+};
+
+static const struct lc3_mdct_rot_def_q31 mdct_rot_q31_240 = {
+    .n4 = 240/4, .w = (const struct lc3_complex_q31 []){
+        {  2147472149,     7027611 }, {  2146552303,    63239471 },
+        {  2144161316,   119407989 }, {  2140300829,   175494670 },
+        {  2134973487,   231461077 }, {  2128182940,   287268852 },
+        {  2119933843,   342879747 }, {  2110231849,   398255649 },
+        {  2099083608,   453358607 }, {  2086496759,   508150855 },
+        {  2072479930,   562594842 }, {  2057042727,   616653255 },
+        {  2040195730,   670289044 }, {  2021950484,   723465451 },
+        {  2002319494,   776146031 }, {  1981316215,   828294679 },
+        {  1958955040,   879875655 }, {  1935251296,   930853609 },
+        {  1910221227,   981193602 }, {  1883881987,  1030861133 },
+        {  1856251629,  1079822164 }, {  1827349089,  1128043139 },
+        {  1797194176,  1175491010 }, {  1765807555,  1222133257 },
+        {  1733210737,  1267937916 }, {  1699426064,  1312873593 },
+        {  1664476689,  1356909492 }, {  1628386565,  1400015434 },
+        {  1591180426,  1442161874 }, {  1552883771,  1483319929 },
+        {  1513522847,  1523461391 }, {  1473124631,  1562558748 },
+        {  1431716808,  1600585205 }, {  1389327759,  1637514702 },
+        {  1345986533,  1673321927 }, {  1301722835,  1707982341 },
+        {  1256567002,  1741472190 }, {  1210549980,  1773768520 },
+        {  1163703308,  1804849198 }, {  1116059092,  1834692923 },
+        {  1067649985,  1863279241 }, {  1018509163,  1890588560 },
+        {   968670307,  1916602164 }, {   918167572,  1941302225 },
+        {   867035571,  1964671814 }, {   815309347,  1986694916 },
+        {   763024350,  2007356435 }, {   710216415,  2026642214 },
+        {   656921734,  2044539032 }, {   603176830,  2061034626 },
+        {   549018540,  2076117690 }, {   494483979,  2089777886 },
+        {   439610524,  2102005853 }, {   384435782,  2112793210 },
+        {   328997567,  2122132564 }, {   273333873,  2130017514 },
+        {   217482850,  2136442657 }, {   161482775,  2141403589 },
+        {   105372028,  2144896910 }, {    49189064,  2146920225 },
+    }
+};
+
+static const struct lc3_mdct_rot_def_q31 mdct_rot_q31_320 = {
+    .n4 = 320/4, .w = (const struct lc3_complex_q31 []){
+        {  2147477180,     5270713 }, {  2146959750,    47432603 },
+        {  2145614626,    89576207 }, {  2143442326,   131685278 },
+        {  2140443689,   173743582 }, {  2136619870,   215734905 },
+        {  2131972344,   257643057 }, {  2126502901,   299451883 },
+        {  2120213651,   341145265 }, {  2113107019,   382707129 },
+        {  2105185743,   424121452 }, {  2096452878,   465372268 },
+        {  2086911791,   506443674 }, {  2076566160,   547319836 },
+        {  2065419972,   587984997 }, {  2053477526,   628423478 },
+        {  2040743426,   668619689 }, {  2027222580,   708558135 },
+        {  2012920201,   748223418 }, {  1997841803,   787600247 },
+        {  1981993199,   826673442 }, {  1965380498,   865427937 },
+        {  1948010107,   903848794 }, {  1929888720,   941921200 },
+        {  1911023324,   979630477 }, {  1891421193,  1016962088 },
+        {  1871089883,  1053901641 }, {  1850037231,  1090434895 },
+        {  1828271356,  1126547765 }, {  1805800647,  1162226330 },
+        {  1782633767,  1197456835 }, {  1758779648,  1232225697 },
+        {  1734247486,  1266519512 }, {  1709046739,  1300325060 },
+        {  1683187122,  1333629308 }, {  1656678604,  1366419417 },
+        {  1629531405,  1398682745 }, {  1601755990,  1430406854 },
+        {  1573363068,  1461579514 }, {  1544363585,  1492188707 },
+        {  1514768720,  1522222633 }, {  1484589883,  1551669713 },
+        {  1453838708,  1580518595 }, {  1422527051,  1608758157 },
+        {  1390666982,  1636377513 }, {  1358270785,  1663366013 },
+        {  1325350949,  1689713254 }, {  1291920164,  1715409079 },
+        {  1257991320,  1740443581 }, {  1223577496,  1764807108 },
+        {  1188691960,  1788490269 }, {  1153348160,  1811483933 },
+        {  1117559723,  1833779235 }, {  1081340445,  1855367581 },
+        {  1044704290,  1876240647 }, {  1007665382,  1896390386 },
+        {   970237999,  1915809031 }, {   932436571,  1934489095 },
+        {   894275671,  1952423377 }, {   855770011,  1969604962 },
+        {   816934435,  1986027227 }, {   777783915,  2001683841 },
+        {   738333545,  2016568768 }, {   698598533,  2030676269 },
+        {   658594198,  2044000905 }, {   618335963,  2056537541 },
+        {   577839347,  2068281342 }, {   537119963,  2079227781 },
+        {   496193509,  2089372638 }, {   455075763,  2098712002 },
+        {   413782577,  2107242273 }, {   372329870,  2114960162 },
+        {   330733622,  2121862693 }, {   289009871,  2127947206 },
+        {   247174700,  2133211355 }, {   205244239,  2137653110 },
+        {   163234653,  2141270760 }, {   121162136,  2144062908 },
+        {    79042909,  2146028480 }, {    36893210,  2147166717 },
+    }
+};
+
+static const struct lc3_mdct_rot_def_q31 mdct_rot_q31_360 = {
+    .n4 = 360/4, .w = (const struct lc3_complex_q31 []){
+        {  2147478537,     4685079 }, {  2147069700,    42163034 },
+        {  2146006845,    79628145 }, {  2144290295,   117069001 },
+        {  2141920573,   154474196 }, {  2138898402,   191832338 },
+        {  2135224701,   229132045 }, {  2130900591,   266361956 },
+        {  2125927387,   303510731 }, {  2120306605,   340567054 },
+        {  2114039958,   377519637 }, {  2107129353,   414357223 },
+        {  2099576896,   451068592 }, {  2091384888,   487642562 },
+        {  2082555824,   524067990 }, {  2073092393,   560333783 },
+        {  2062997478,   596428893 }, {  2052274154,   632342324 },
+        {  2040925688,   668063138 }, {  2028955535,   703580453 },
+        {  2016367344,   738883451 }, {  2003164947,   773961378 },
+        {  1989352366,   808803549 }, {  1974933810,   843399350 },
+        {  1959913670,   877738244 }, {  1944296521,   911809770 },
+        {  1928087121,   945603550 }, {  1911290406,   979109290 },
+        {  1893911494,  1012316784 }, {  1875955678,  1045215916 },
+        {  1857428428,  1077796666 }, {  1838335387,  1110049108 },
+        {  1818682372,  1141963419 }, {  1798475368,  1173529876 },
+        {  1777720531,  1204738865 }, {  1756424183,  1235580878 },
+        {  1734592812,  1266046522 }, {  1712233066,  1296126516 },
+        {  1689351758,  1325811697 }, {  1665955857,  1355093023 },
+        {  1642052490,  1383961574 }, {  1617648937,  1412408558 },
+        {  1592752633,  1440425308 }, {  1567371161,  1468003290 },
+        {  1541512253,  1495134105 }, {  1515183785,  1521809487 },
+        {  1488393778,  1548021312 }, {  1461150391,  1573761594 },
+        {  1433461924,  1599022493 }, {  1405336810,  1623796314 },
+        {  1376783617,  1648075511 }, {  1347811043,  1671852688 },
+        {  1318427912,  1695120603 }, {  1288643175,  1717872168 },
+        {  1258465905,  1740100452 }, {  1227905295,  1761798685 },
+        {  1196970652,  1782960257 }, {  1165671401,  1803578721 },
+        {  1134017074,  1823647799 }, {  1102017315,  1843161375 },
+        {  1069681871,  1862113507 }, {  1037020592,  1880498421 },
+        {  1004043426,  1898310517 }, {   970760419,  1915544369 },
+        {   937181708,  1932194727 }, {   903317523,  1948256521 },
+        {   869178179,  1963724856 }, {   834774075,  1978595022 },
+        {   800115690,  1992862489 }, {   765213582,  2006522911 },
+        {   730078383,  2019572126 }, {   694720795,  2032006160 },
+        {   659151588,  2043821226 }, {   623381598,  2055013723 },
+        {   587421719,  2065580244 }, {   551282906,  2075517568 },
+        {   514976167,  2084822670 }, {   478512561,  2093492715 },
+        {   441903195,  2101525062 }, {   405159222,  2108917263 },
+        {   368291833,  2115667068 }, {   331312258,  2121772421 },
+        {   294231763,  2127231461 }, {   257061642,  2132042525 },
+        {   219813218,  2136204149 }, {   182497836,  2139715065 },
+        {   145126864,  2142574202 }, {   107711685,  2144780691 },
+        {    70263695,  2146333858 }, {    32794303,  2147233232 },
+    }
+};
+
+static const struct lc3_mdct_rot_def_q31 mdct_rot_q31_480 = {
+    .n4 = 480/4, .w = (const struct lc3_complex_q31 []){
+        {  2147480773,     3513810 }, {  2147250799,    31623164 },
+        {  2146652904,    59727099 }, {  2145687192,    87820801 },
+        {  2144353827,   115899455 }, {  2142653038,   143958250 },
+        {  2140585116,   171992378 }, {  2138150417,   199997036 },
+        {  2135349356,   227967426 }, {  2132182414,   255898755 },
+        {  2128650133,   283786237 }, {  2124753120,   311625094 },
+        {  2120492040,   339410555 }, {  2115867626,   367137861 },
+        {  2110880668,   394802258 }, {  2105532022,   422399009 },
+        {  2099822604,   449923384 }, {  2093753392,   477370666 },
+        {  2087325426,   504736154 }, {  2080539807,   532015158 },
+        {  2073397699,   559203003 }, {  2065900325,   586295032 },
+        {  2058048970,   613286603 }, {  2049844978,   640173090 },
+        {  2041289756,   666949886 }, {  2032384769,   693612404 },
+        {  2023131544,   720156076 }, {  2013531666,   746576352 },
+        {  2003586779,   772868706 }, {  1993298588,   799028633 },
+        {  1982668856,   825051651 }, {  1971699403,   850933300 },
+        {  1960392110,   876669146 }, {  1948748914,   902254780 },
+        {  1936771810,   927685817 }, {  1924462850,   952957899 },
+        {  1911824143,   978066697 }, {  1898857855,  1003007909 },
+        {  1885566207,  1027777260 }, {  1871951478,  1052370507 },
+        {  1858015999,  1076783436 }, {  1843762158,  1101011863 },
+        {  1829192399,  1125051638 }, {  1814309216,  1148898640 },
+        {  1799115162,  1172548785 }, {  1783612838,  1195998020 },
+        {  1767804901,  1219242327 }, {  1751694060,  1242277723 },
+        {  1735283075,  1265100260 }, {  1718574758,  1287706030 },
+        {  1701571972,  1310091157 }, {  1684277631,  1332251808 },
+        {  1666694698,  1354184184 }, {  1648826185,  1375884527 },
+        {  1630675154,  1397349119 }, {  1612244715,  1418574283 },
+        {  1593538026,  1439556382 }, {  1574558293,  1460291820 },
+        {  1555308768,  1480777044 }, {  1535792748,  1501008545 },
+        {  1516013578,  1520982856 }, {  1495974647,  1540696555 },
+        {  1475679389,  1560146263 }, {  1455131280,  1579328647 },
+        {  1434333842,  1598240423 }, {  1413290638,  1616878347 },
+        {  1392005275,  1635239228 }, {  1370481398,  1653319919 },
+        {  1348722696,  1671117323 }, {  1326732898,  1688628389 },
+        {  1304515771,  1705850117 }, {  1282075122,  1722779556 },
+        {  1259414796,  1739413807 }, {  1236538675,  1755750017 },
+        {  1213450681,  1771785389 }, {  1190154767,  1787517174 },
+        {  1166654927,  1802942678 }, {  1142955186,  1818059257 },
+        {  1119059606,  1832864320 }, {  1094972281,  1847355332 },
+        {  1070697338,  1861529809 }, {  1046238936,  1875385322 },
+        {  1021601267,  1888919498 }, {   996788551,  1902130017 },
+        {   971805042,  1915014616 }, {   946655018,  1927571087 },
+        {   921342790,  1939797279 }, {   895872694,  1951691096 },
+        {   870249095,  1963250501 }, {   844476384,  1974473513 },
+        {   818558976,  1985358210 }, {   792501312,  1995902725 },
+        {   766307857,  2006105253 }, {   739983099,  2015964045 },
+        {   713531549,  2025477412 }, {   686957739,  2034643724 },
+        {   660266222,  2043461410 }, {   633461572,  2051928960 },
+        {   606548381,  2060044922 }, {   579531262,  2067807906 },
+        {   552414843,  2075216581 }, {   525203770,  2082269679 },
+        {   497902707,  2088965991 }, {   470516330,  2095304370 },
+        {   443049333,  2101283728 }, {   415506422,  2106903043 },
+        {   387892316,  2112161350 }, {   360211746,  2117057750 },
+        {   332469456,  2121591402 }, {   304670200,  2125761531 },
+        {   276818739,  2129567422 }, {   248919847,  2133008422 },
+        {   220978304,  2136083942 }, {   192998897,  2138793455 },
+        {   164986421,  2141136497 }, {   136945676,  2143112666 },
+        {   108881465,  2144721624 }, {    80798598,  2145963095 },
+        {    52701887,  2146836866 }, {    24596146,  2147342788 },
+    }
+};
+
+static const struct lc3_mdct_rot_def_q31 mdct_rot_q31_640 = {
+    .n4 = 640/4, .w = (const struct lc3_complex_q31 []){
+        {  2147482031,     2635358 }, {  2147352669,    23717748 },
+        {  2147016342,    44797852 }, {  2146473080,    65873638 },
+        {  2145722936,    86943075 }, {  2144765984,   108004133 },
+        {  2143602314,   129054781 }, {  2142232040,   150092990 },
+        {  2140655293,   171116733 }, {  2138872225,   192123983 },
+        {  2136883008,   213112716 }, {  2134687834,   234080909 },
+        {  2132286914,   255026540 }, {  2129680480,   275947592 },
+        {  2126868782,   296842047 }, {  2123852093,   317707892 },
+        {  2120630703,   338543115 }, {  2117204921,   359345709 },
+        {  2113575080,   380113669 }, {  2109741527,   400844992 },
+        {  2105704633,   421537682 }, {  2101464787,   442189742 },
+        {  2097022397,   462799183 }, {  2092377892,   483364019 },
+        {  2087531719,   503882267 }, {  2082484346,   524351950 },
+        {  2077236258,   544771095 }, {  2071787962,   565137733 },
+        {  2066139983,   585449903 }, {  2060292865,   605705645 },
+        {  2054247172,   625903009 }, {  2048003486,   646040046 },
+        {  2041562409,   666114817 }, {  2034924562,   686125387 },
+        {  2028090585,   706069826 }, {  2021061136,   725946213 },
+        {  2013836893,   745752631 }, {  2006418552,   765487172 },
+        {  1998806829,   785147934 }, {  1991002456,   804733022 },
+        {  1983006187,   824240548 }, {  1974818791,   843668632 },
+        {  1966441058,   863015402 }, {  1957873796,   882278992 },
+        {  1949117829,   901457546 }, {  1940174002,   920549216 },
+        {  1931043178,   939552162 }, {  1921726235,   958464551 },
+        {  1912224073,   977284562 }, {  1902537606,   996010380 },
+        {  1892667769,  1014640200 }, {  1882615512,  1033172228 },
+        {  1872381805,  1051604676 }, {  1861967634,  1069935768 },
+        {  1851374003,  1088163737 }, {  1840601933,  1106286827 },
+        {  1829652461,  1124303291 }, {  1818526644,  1142211392 },
+        {  1807225553,  1160009405 }, {  1795750278,  1177695613 },
+        {  1784101925,  1195268313 }, {  1772281617,  1212725810 },
+        {  1760290492,  1230066422 }, {  1748129707,  1247288478 },
+        {  1735800433,  1264390317 }, {  1723303860,  1281370292 },
+        {  1710641191,  1298226766 }, {  1697813646,  1314958114 },
+        {  1684822463,  1331562723 }, {  1671668894,  1348038994 },
+        {  1658354205,  1364385338 }, {  1644879680,  1380600179 },
+        {  1631246619,  1396681956 }, {  1617456335,  1412629117 },
+        {  1603510157,  1428440127 }, {  1589409429,  1444113460 },
+        {  1575155511,  1459647607 }, {  1560749776,  1475041069 },
+        {  1546193612,  1490292364 }, {  1531488424,  1505400022 },
+        {  1516635627,  1520362586 }, {  1501636654,  1535178615 },
+        {  1486492949,  1549846679 }, {  1471205974,  1564365367 },
+        {  1455777201,  1578733277 }, {  1440208117,  1592949026 },
+        {  1424500222,  1607011243 }, {  1408655031,  1620918573 },
+        {  1392674072,  1634669676 }, {  1376558883,  1648263225 },
+        {  1360311019,  1661697912 }, {  1343932045,  1674972441 },
+        {  1327423540,  1688085532 }, {  1310787095,  1701035922 },
+        {  1294024314,  1713822363 }, {  1277136813,  1726443622 },
+        {  1260126218,  1738898483 }, {  1242994169,  1751185745 },
+        {  1225742318,  1763304224 }, {  1208372328,  1775252753 },
+        {  1190885872,  1787030178 }, {  1173284636,  1798635366 },
+        {  1155570317,  1810067198 }, {  1137744621,  1821324572 },
+        {  1119809267,  1832406403 }, {  1101765983,  1843311622 },
+        {  1083616509,  1854039180 }, {  1065362594,  1864588041 },
+        {  1047005996,  1874957189 }, {  1028548487,  1885145625 },
+        {  1009991843,  1895152367 }, {   991337855,  1904976450 },
+        {   972588319,  1914616928 }, {   953745043,  1924072871 },
+        {   934809843,  1933343367 }, {   915784545,  1942427524 },
+        {   896670981,  1951324466 }, {   877470994,  1960033335 },
+        {   858186435,  1968553292 }, {   838819161,  1976883515 },
+        {   819371041,  1985023203 }, {   799843948,  1992971570 },
+        {   780239764,  2000727850 }, {   760560380,  2008291295 },
+        {   740807690,  2015661178 }, {   720983601,  2022836787 },
+        {   701090021,  2029817430 }, {   681128869,  2036602436 },
+        {   661102068,  2043191150 }, {   641011549,  2049582936 },
+        {   620859248,  2055777180 }, {   600647107,  2061773283 },
+        {   580377074,  2067570669 }, {   560051104,  2073168777 },
+        {   539671154,  2078567070 }, {   519239190,  2083765026 },
+        {   498757181,  2088762144 }, {   478227100,  2093557943 },
+        {   457650927,  2098151960 }, {   437030645,  2102543753 },
+        {   416368240,  2106732899 }, {   395665706,  2110718993 },
+        {   374925036,  2114501652 }, {   354148230,  2118080511 },
+        {   333337290,  2121455224 }, {   312494223,  2124625468 },
+        {   291621037,  2127590936 }, {   270719744,  2130351342 },
+        {   249792358,  2132906420 }, {   228840897,  2135255924 },
+        {   207867379,  2137399628 }, {   186873827,  2139337325 },
+        {   165862264,  2141068828 }, {   144834714,  2142593971 },
+        {   123793205,  2143912606 }, {   102739765,  2145024606 },
+        {    81676422,  2145929864 }, {    60605208,  2146628293 },
+        {    39528151,  2147119825 }, {    18447286,  2147404414 },
+    }
+};
+
+static const struct lc3_mdct_rot_def_q31 mdct_rot_q31_720 = {
+    .n4 = 720/4, .w = (const struct lc3_complex_q31 []){
+        {  2147482370,     2342541 }, {  2147380159,    21082533 },
+        {  2147114415,    39820919 }, {  2146685161,    58556273 },
+        {  2146092429,    77287168 }, {  2145336263,    96012177 },
+        {  2144416721,   114729874 }, {  2143333874,   133438834 },
+        {  2142087804,   152137632 }, {  2140678605,   170824844 },
+        {  2139106386,   189499048 }, {  2137371265,   208158820 },
+        {  2135473375,   226802740 }, {  2133412861,   245429388 },
+        {  2131189878,   264037346 }, {  2128804598,   282625197 },
+        {  2126257201,   301191524 }, {  2123547881,   319734915 },
+        {  2120676845,   338253956 }, {  2117644311,   356747238 },
+        {  2114450510,   375213353 }, {  2111095685,   393650893 },
+        {  2107580093,   412058455 }, {  2103904000,   430434638 },
+        {  2100067687,   448778041 }, {  2096071445,   467087268 },
+        {  2091915579,   485360925 }, {  2087600406,   503597620 },
+        {  2083126254,   521795963 }, {  2078493464,   539954570 },
+        {  2073702389,   558072057 }, {  2068753393,   576147045 },
+        {  2063646854,   594178157 }, {  2058383159,   612164020 },
+        {  2052962711,   630103264 }, {  2047385922,   647994524 },
+        {  2041653217,   665836436 }, {  2035765032,   683627643 },
+        {  2029721815,   701366788 }, {  2023524027,   719052521 },
+        {  2017172141,   736683496 }, {  2010666638,   754258370 },
+        {  2004008016,   771775804 }, {  1997196780,   789234464 },
+        {  1990233451,   806633021 }, {  1983118557,   823970150 },
+        {  1975852641,   841244530 }, {  1968436256,   858454846 },
+        {  1960869968,   875599788 }, {  1953154351,   892678049 },
+        {  1945289994,   909688329 }, {  1937277496,   926629333 },
+        {  1929117467,   943499771 }, {  1920810528,   960298358 },
+        {  1912357311,   977023814 }, {  1903758462,   993674866 },
+        {  1895014633,  1010250245 }, {  1886126492,  1026748690 },
+        {  1877094716,  1043168945 }, {  1867919991,  1059509758 },
+        {  1858603016,  1075769885 }, {  1849144502,  1091948088 },
+        {  1839545169,  1108043135 }, {  1829805747,  1124053801 },
+        {  1819926978,  1139978865 }, {  1809909615,  1155817115 },
+        {  1799754420,  1171567346 }, {  1789462167,  1187228357 },
+        {  1779033639,  1202798956 }, {  1768469631,  1218277957 },
+        {  1757770948,  1233664182 }, {  1746938403,  1248956459 },
+        {  1735972822,  1264153622 }, {  1724875040,  1279254516 },
+        {  1713645902,  1294257989 }, {  1702286263,  1309162899 },
+        {  1690796989,  1323968112 }, {  1679178954,  1338672499 },
+        {  1667433043,  1353274941 }, {  1655560150,  1367774326 },
+        {  1643561180,  1382169550 }, {  1631437047,  1396459516 },
+        {  1619188673,  1410643137 }, {  1606816992,  1424719331 },
+        {  1594322946,  1438687028 }, {  1581707485,  1452545163 },
+        {  1568971572,  1466292681 }, {  1556116175,  1479928535 },
+        {  1543142274,  1493451687 }, {  1530050857,  1506861107 },
+        {  1516842920,  1520155773 }, {  1503519470,  1533334674 },
+        {  1490081521,  1546396805 }, {  1476530097,  1559341172 },
+        {  1462866229,  1572166790 }, {  1449090958,  1584872680 },
+        {  1435205334,  1597457877 }, {  1421210412,  1609921421 },
+        {  1407107261,  1622262363 }, {  1392896952,  1634479764 },
+        {  1378580569,  1646572693 }, {  1364159202,  1658540229 },
+        {  1349633949,  1670381460 }, {  1335005916,  1682095486 },
+        {  1320276217,  1693681413 }, {  1305445974,  1705138360 },
+        {  1290516316,  1716465454 }, {  1275488381,  1727661833 },
+        {  1260363312,  1738726644 }, {  1245142261,  1749659043 },
+        {  1229826388,  1760458200 }, {  1214416859,  1771123291 },
+        {  1198914847,  1781653504 }, {  1183321534,  1792048037 },
+        {  1167638106,  1802306098 }, {  1151865758,  1812426907 },
+        {  1136005690,  1822409693 }, {  1120059112,  1832253695 },
+        {  1104027237,  1841958164 }, {  1087911285,  1851522361 },
+        {  1071712485,  1860945557 }, {  1055432070,  1870227035 },
+        {  1039071280,  1879366088 }, {  1022631361,  1888362020 },
+        {  1006113564,  1897214146 }, {   989519147,  1905921792 },
+        {   972849375,  1914484294 }, {   956105517,  1922901001 },
+        {   939288848,  1931171271 }, {   922400648,  1939294476 },
+        {   905442204,  1947269995 }, {   888414806,  1955097223 },
+        {   871319753,  1962775562 }, {   854158345,  1970304428 },
+        {   836931890,  1977683248 }, {   819641699,  1984911460 },
+        {   802289089,  1991988513 }, {   784875382,  1998913868 },
+        {   767401904,  2005686999 }, {   749869984,  2012307388 },
+        {   732280960,  2018774533 }, {   714636169,  2025087940 },
+        {   696936956,  2031247129 }, {   679184669,  2037251630 },
+        {   661380659,  2043100987 }, {   643526282,  2048794754 },
+        {   625622899,  2054332497 }, {   607671871,  2059713794 },
+        {   589674567,  2064938237 }, {   571632358,  2070005427 },
+        {   553546616,  2074914977 }, {   535418719,  2079666515 },
+        {   517250048,  2084259678 }, {   499041987,  2088694117 },
+        {   480795922,  2092969493 }, {   462513242,  2097085482 },
+        {   444195340,  2101041770 }, {   425843611,  2104838055 },
+        {   407459452,  2108474049 }, {   389044264,  2111949474 },
+        {   370599448,  2115264066 }, {   352126410,  2118417572 },
+        {   333626556,  2121409753 }, {   315101295,  2124240380 },
+        {   296552037,  2126909238 }, {   277980197,  2129416124 },
+        {   259387187,  2131760846 }, {   240774423,  2133943227 },
+        {   222143324,  2135963099 }, {   203495308,  2137820310 },
+        {   184831794,  2139514717 }, {   166154205,  2141046193 },
+        {   147463963,  2142414619 }, {   128762491,  2143619892 },
+        {   110051213,  2144661920 }, {    91331554,  2145540623 },
+        {    72604940,  2146255936 }, {    53872797,  2146807802 },
+        {    35136551,  2147196181 }, {    16397630,  2147421043 },
+    }
+};
+
+static const struct lc3_mdct_rot_def_q31 mdct_rot_q31_960 = {
+    .n4 = 960/4, .w = (const struct lc3_complex_q31 []){
+        {  2147482929,     1756906 }, {  2147425435,    15812011 },
+        {  2147275952,    29866438 }, {  2147034487,    43919586 },
+        {  2146701050,    57970853 }, {  2146275656,    72019637 },
+        {  2145758322,    86065335 }, {  2145149071,   100107347 },
+        {  2144447929,   114145071 }, {  2143654926,   128177904 },
+        {  2142770096,   142205248 }, {  2141793477,   156226499 },
+        {  2140725111,   170241059 }, {  2139565043,   184248325 },
+        {  2138313323,   198247699 }, {  2136970005,   212238581 },
+        {  2135535146,   226220372 }, {  2134008809,   240192472 },
+        {  2132391057,   254154282 }, {  2130681961,   268105206 },
+        {  2128881593,   282044645 }, {  2126990031,   295972002 },
+        {  2125007356,   309886680 }, {  2122933653,   323788084 },
+        {  2120769010,   337675619 }, {  2118513521,   351548688 },
+        {  2116167282,   365406698 }, {  2113730393,   379249055 },
+        {  2111202959,   393075166 }, {  2108585087,   406884440 },
+        {  2105876892,   420676284 }, {  2103078487,   434450107 },
+        {  2100189994,   448205320 }, {  2097211535,   461941333 },
+        {  2094143239,   475657559 }, {  2090985237,   489353409 },
+        {  2087737664,   503028296 }, {  2084400659,   516681636 },
+        {  2080974365,   530312842 }, {  2077458929,   543921332 },
+        {  2073854502,   557506522 }, {  2070161238,   571067830 },
+        {  2066379295,   584604676 }, {  2062508835,   598116479 },
+        {  2058550025,   611602660 }, {  2054503033,   625062643 },
+        {  2050368032,   638495850 }, {  2046145201,   651901706 },
+        {  2041834720,   665279637 }, {  2037436773,   678629069 },
+        {  2032951550,   691949432 }, {  2028379241,   705240153 },
+        {  2023720043,   718500664 }, {  2018974156,   731730397 },
+        {  2014141783,   744928785 }, {  2009223131,   758095263 },
+        {  2004218410,   771229267 }, {  1999127836,   784330234 },
+        {  1993951625,   797397602 }, {  1988690000,   810430813 },
+        {  1983343186,   823429308 }, {  1977911412,   836392529 },
+        {  1972394912,   849319923 }, {  1966793920,   862210934 },
+        {  1961108677,   875065011 }, {  1955339428,   887881603 },
+        {  1949486417,   900660162 }, {  1943549898,   913400139 },
+        {  1937530123,   926100989 }, {  1931427351,   938762167 },
+        {  1925241843,   951383133 }, {  1918973864,   963963344 },
+        {  1912623682,   976502263 }, {  1906191570,   988999351 },
+        {  1899677803,  1001454074 }, {  1893082661,  1013865898 },
+        {  1886406424,  1026234291 }, {  1879649381,  1038558724 },
+        {  1872811820,  1050838668 }, {  1865894033,  1063073598 },
+        {  1858896318,  1075262990 }, {  1851818974,  1087406320 },
+        {  1844662304,  1099503070 }, {  1837426615,  1111552721 },
+        {  1830112217,  1123554757 }, {  1822719423,  1135508663 },
+        {  1815248550,  1147413928 }, {  1807699917,  1159270041 },
+        {  1800073849,  1171076495 }, {  1792370671,  1182832785 },
+        {  1784590714,  1194538405 }, {  1776734311,  1206192856 },
+        {  1768801799,  1217795637 }, {  1760793518,  1229346252 },
+        {  1752709809,  1240844206 }, {  1744551021,  1252289006 },
+        {  1736317502,  1263680162 }, {  1728009604,  1275017186 },
+        {  1719627685,  1286299593 }, {  1711172102,  1297526899 },
+        {  1702643219,  1308698624 }, {  1694041400,  1319814288 },
+        {  1685367013,  1330873416 }, {  1676620432,  1341875533 },
+        {  1667802029,  1352820169 }, {  1658912184,  1363706855 },
+        {  1649951276,  1374535124 }, {  1640919689,  1385304512 },
+        {  1631817811,  1396014559 }, {  1622646032,  1406664805 },
+        {  1613404744,  1417254794 }, {  1604094343,  1427784073 },
+        {  1594715227,  1438252190 }, {  1585267800,  1448658697 },
+        {  1575752465,  1459003149 }, {  1566169630,  1469285102 },
+        {  1556519705,  1479504115 }, {  1546803104,  1489659751 },
+        {  1537020244,  1499751576 }, {  1527171542,  1509779156 },
+        {  1517257422,  1519742062 }, {  1507278307,  1529639867 },
+        {  1497234626,  1539472148 }, {  1487126808,  1549238483 },
+        {  1476955286,  1558938453 }, {  1466720497,  1568571644 },
+        {  1456422878,  1578137643 }, {  1446062871,  1587636039 },
+        {  1435640919,  1597066426 }, {  1425157469,  1606428400 },
+        {  1414612971,  1615721561 }, {  1404007875,  1624945509 },
+        {  1393342636,  1634099849 }, {  1382617710,  1643184191 },
+        {  1371833558,  1652198144 }, {  1360990642,  1661141322 },
+        {  1350089425,  1670013342 }, {  1339130374,  1678813825 },
+        {  1328113960,  1687542393 }, {  1317040654,  1696198672 },
+        {  1305910930,  1704782292 }, {  1294725265,  1713292884 },
+        {  1283484138,  1721730085 }, {  1272188032,  1730093532 },
+        {  1260837429,  1738382868 }, {  1249432816,  1746597738 },
+        {  1237974681,  1754737789 }, {  1226463516,  1762802673 },
+        {  1214899813,  1770792044 }, {  1203284068,  1778705561 },
+        {  1191616778,  1786542883 }, {  1179898443,  1794303676 },
+        {  1168129565,  1801987607 }, {  1156310649,  1809594347 },
+        {  1144442200,  1817123570 }, {  1132524727,  1824574954 },
+        {  1120558740,  1831948179 }, {  1108544752,  1839242929 },
+        {  1096483278,  1846458892 }, {  1084374834,  1853595759 },
+        {  1072219940,  1860653224 }, {  1060019115,  1867630985 },
+        {  1047772882,  1874528743 }, {  1035481766,  1881346202 },
+        {  1023146293,  1888083070 }, {  1010766993,  1894739060 },
+        {   998344394,  1901313885 }, {   985879030,  1907807264 },
+        {   973371434,  1914218919 }, {   960822142,  1920548575 },
+        {   948231691,  1926795962 }, {   935600622,  1932960811 },
+        {   922929474,  1939042858 }, {   910218791,  1945041843 },
+        {   897469118,  1950957509 }, {   884680999,  1956789602 },
+        {   871854984,  1962537873 }, {   858991622,  1968202076 },
+        {   846091463,  1973781967 }, {   833155061,  1979277308 },
+        {   820182969,  1984687864 }, {   807175743,  1990013401 },
+        {   794133941,  1995253694 }, {   781058120,  2000408516 },
+        {   767948841,  2005477648 }, {   754806666,  2010460871 },
+        {   741632158,  2015357973 }, {   728425880,  2020168744 },
+        {   715188400,  2024892978 }, {   701920283,  2029530472 },
+        {   688622098,  2034081027 }, {   675294414,  2038544449 },
+        {   661937804,  2042920547 }, {   648552838,  2047209133 },
+        {   635140090,  2051410023 }, {   621700135,  2055523038 },
+        {   608233549,  2059548001 }, {   594740907,  2063484740 },
+        {   581222789,  2067333086 }, {   567679774,  2071092874 },
+        {   554112440,  2074763944 }, {   540521371,  2078346137 },
+        {   526907147,  2081839301 }, {   513270353,  2085243286 },
+        {   499611571,  2088557947 }, {   485931388,  2091783140 },
+        {   472230390,  2094918728 }, {   458509162,  2097964577 },
+        {   444768294,  2100920556 }, {   431008373,  2103786539 },
+        {   417229989,  2106562402 }, {   403433732,  2109248028 },
+        {   389620194,  2111843300 }, {   375789965,  2114348108 },
+        {   361943639,  2116762344 }, {   348081809,  2119085905 },
+        {   334205068,  2121318692 }, {   320314011,  2123460608 },
+        {   306409232,  2125511562 }, {   292491328,  2127471467 },
+        {   278560894,  2129340237 }, {   264618528,  2131117794 },
+        {   250664827,  2132804061 }, {   236700388,  2134398966 },
+        {   222725809,  2135902440 }, {   208741690,  2137314419 },
+        {   194748629,  2138634843 }, {   180747225,  2139863654 },
+        {   166738079,  2141000801 }, {   152721790,  2142046235 },
+        {   138698959,  2142999911 }, {   124670187,  2143861787 },
+        {   110636075,  2144631828 }, {    96597223,  2145310000 },
+        {    82554233,  2145896274 }, {    68507707,  2146390624 },
+        {    54458246,  2146793031 }, {    40406452,  2147103476 },
+        {    26352928,  2147321946 }, {    12298274,  2147448433 },
+    }
+};
+
+const struct lc3_mdct_rot_def_q31 *
+    lc3_mdct_rot_q31[LC3_NUM_DT][LC3_NUM_SRATE] = {
+    [LC3_DT_7M5] = { &mdct_rot_q31_120, &mdct_rot_q31_240, &mdct_rot_q31_360,
+                     &mdct_rot_q31_480, &mdct_rot_q31_720                    },
+    [LC3_DT_10M] = { &mdct_rot_q31_160, &mdct_rot_q31_320, &mdct_rot_q31_480,
+                     &mdct_rot_q31_640, &mdct_rot_q31_960                    }
+};
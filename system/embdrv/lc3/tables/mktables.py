@@ -130,6 +130,46 @@ def mdct_rot_twiddles():
                   end = '\n' if i%2 == 1 else ' ')
 
 
+def q31(v):
+
+    return int(np.clip(np.round(v * 2**31), -2**31, 2**31 - 1))
+
+
+def mdct_fft_twiddles_q31():
+
+    for n in (10, 20, 30, 40, 60, 80, 90, 120, 160, 180, 240):
+
+        print('\n--- fft bf2 twiddles q31 {:3d} ---'.format(n))
+
+        kv = -2 * np.pi * np.arange(n // 2) / n
+        for (i, k) in enumerate(kv):
+            print('{{ {:11d}, {:11d} }},'.format(q31(np.cos(k)), q31(np.sin(k))),
+                  end = '\n' if i%2 == 1 else ' ')
+
+    for n in (15, 45):
+
+        print('\n--- fft bf3 twiddles q31 {:3d} ---'.format(n))
+
+        kv = -2 * np.pi * np.arange(n) / n
+        for k in kv:
+            print(('{{ {{ {:11d}, {:11d} }},' +
+                     ' {{ {:11d}, {:11d} }} }},').format(
+                q31(np.cos(k)), q31(np.sin(k)),
+                q31(np.cos(2*k)), q31(np.sin(2*k))))
+
+
+def mdct_rot_twiddles_q31():
+
+    for n in (120, 160, 240, 320, 360, 480, 640, 720, 960):
+
+        print('\n--- mdct rot twiddles q31 {:3d} ---'.format(n))
+
+        kv = 2 * np.pi * (np.arange(n // 4) + 1/8) / n
+        for (i, k) in enumerate(kv):
+            print('{{ {:11d}, {:11d} }},'.format(q31(np.cos(k)), q31(np.sin(k))),
+                  end = '\n' if i%2 == 1 else ' ')
+
+
 def mdct_scaling():
 
     print('\n--- mdct scaling ---')
@@ -215,6 +255,8 @@ if __name__ == '__main__':
 
     mdct_fft_twiddles()
     mdct_rot_twiddles()
+    mdct_fft_twiddles_q31()
+    mdct_rot_twiddles_q31()
     mdct_scaling()
 
     inv_table()
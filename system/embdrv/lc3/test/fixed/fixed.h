@@ -0,0 +1,81 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#ifndef __LC3_TEST_FIXED_H
+#define __LC3_TEST_FIXED_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+
+/**
+ * Read a cycle counter, or a nanosecond clock when the target has no
+ * counter readable from user space
+ */
+static inline uint64_t fixed_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__has_builtin) && __has_builtin(__builtin_readcyclecounter)
+    return __builtin_readcyclecounter();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+/**
+ * Measure the cycles taken by a statement
+ * cycles          Output the minimum count of cycles, over the runs
+ * stmt            Statement to measure
+ */
+#define FIXED_CYCLES(cycles, stmt)                              \
+do {                                                            \
+    uint64_t __min = UINT64_MAX;                                \
+                                                                \
+    for (int __i = 0; __i < 1000; __i++) {                      \
+        uint64_t __t0 = fixed_cycles();                         \
+        stmt;                                                   \
+        __asm__ __volatile__("" ::: "memory");                  \
+        uint64_t __t = fixed_cycles() - __t0;                   \
+        __min = __t < __min ? __t : __min;                      \
+    }                                                           \
+                                                                \
+    (cycles) = __min;                                           \
+} while (0)
+
+/**
+ * Report the cycles of a per-frame processing
+ * name            Name of the processing
+ * ref, fixed      Cycles of the float and fixed-point versions
+ */
+static inline void fixed_report(const char *name, uint64_t ref, uint64_t fixed)
+{
+    printf("\n  %-24s %6llu -> %6llu cycles/frame (x%.2f)", name,
+        (unsigned long long)ref, (unsigned long long)fixed,
+        (double)ref / fixed);
+}
+
+
+#endif /* __LC3_TEST_FIXED_H */
@@ -0,0 +1,185 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "fixed.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/* -------------------------------------------------------------------------- */
+
+#define TEST_FIXED
+#include <mdct.c>
+
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Relative error of `y` to the reference `y_ref`, on `n` values
+ */
+static double relative_error(const float *y_ref, const float *y, int n)
+{
+    double e = 0, m = 0;
+
+    for (int i = 0; i < n; i++) {
+        e = fmax(e, fabs(y[i] - y_ref[i]));
+        m = fmax(m, fabs(y_ref[i]));
+    }
+
+    return m > 0 ? e / m : e;
+}
+
+static int check_fft(void)
+{
+    static const int fft_n[] =
+        { 30, 40, 60, 80, 90, 120, 160, 180, 240 };
+
+    struct lc3_complex x[240], y0[240], y1[240], y_fixed[240];
+    struct lc3_complex_q31 z[240], z0[240], z1[240];
+
+    for (int i = 0; i < 240; i++) {
+          x[i].re = 2 * (double)rand() / RAND_MAX - 1;
+          x[i].im = 2 * (double)rand() / RAND_MAX - 1;
+    }
+
+    for (int k = 0; k < (int)(sizeof(fft_n) / sizeof(*fft_n)); k++) {
+        int n = fft_n[k];
+        struct lc3_complex *y;
+        struct lc3_complex_q31 *u;
+
+        int e = fixed_from_float((const float *)x, 2*n, (int32_t *)z);
+        memcpy(z0, z, n * sizeof(*z));
+
+        y = fft(x, n, y0, y1);
+        u = fixed_fft(z0, n, z0, z1, &e);
+        for (int i = 0; i < n; i++) {
+            y_fixed[i].re = ldexpf(u[i].re, e);
+            y_fixed[i].im = ldexpf(u[i].im, e);
+        }
+
+        if (relative_error((const float *)y,
+                           (const float *)y_fixed, 2*n) > 0x1p-20)
+            return -1;
+    }
+
+    /* FFT of the MDCT, 10ms frames at 48 KHz */
+
+    uint64_t c_ref, c_fixed;
+    int e;
+
+    FIXED_CYCLES(c_ref, fft(x, 240, y0, y1));
+    FIXED_CYCLES(c_fixed, (memcpy(z0, z, sizeof(z)), e = 0,
+                           fixed_fft(z0, 240, z0, z1, &e)));
+    fixed_report("fft 240 (10ms 48KHz)", c_ref, c_fixed);
+
+    return 0;
+}
+
+static int check_mdct_transforms(void)
+{
+    float x[2][480], d[480], d_fixed[480];
+    float y[480], y_fixed[480];
+
+    for (int i = 0; i < 480; i++) {
+        x[0][i] = (2 * (double)rand() / RAND_MAX - 1) * 32768;
+        x[1][i] = (2 * (double)rand() / RAND_MAX - 1) * 32768;
+    }
+
+    for (int dt = 0; dt < LC3_NUM_DT; dt++)
+        for (int sr = 0; sr < LC3_NUM_SRATE; sr++) {
+            int ns = LC3_NS(dt, sr), nd = LC3_ND(dt, sr);
+
+            memset(d, 0, nd * sizeof(*d));
+            memset(d_fixed, 0, nd * sizeof(*d));
+
+            for (int i = 0; i < 2; i++) {
+                lc3_mdct_forward(dt, sr, sr, x[i], d, y);
+                fixed_mdct_forward(dt, sr, sr, x[i], d_fixed, y_fixed);
+                if (relative_error(y, y_fixed, ns) > 0x1p-20)
+                    return -1;
+            }
+
+            memset(d, 0, nd * sizeof(*d));
+            memset(d_fixed, 0, nd * sizeof(*d));
+
+            for (int i = 0; i < 2; i++) {
+                lc3_mdct_inverse(dt, sr, sr, x[i], d, y);
+                fixed_mdct_inverse(dt, sr, sr, x[i], d_fixed, y_fixed);
+                if (relative_error(y, y_fixed, ns) > 0x1p-20 ||
+                    relative_error(d, d_fixed, nd) > 0x1p-20)
+                    return -1;
+            }
+        }
+
+    /* Stages of the transforms, 10ms frames at 48 KHz */
+
+    enum lc3_dt dt = LC3_DT_10M;
+    enum lc3_srate sr = LC3_SRATE_48K;
+    int ns = LC3_NS(dt, sr);
+
+    const struct lc3_mdct_rot_def *rot = lc3_mdct_rot[dt][sr];
+    const struct lc3_mdct_rot_def_q31 *rot_q31 = lc3_mdct_rot_q31[dt][sr];
+
+    struct lc3_complex z[240];
+    struct lc3_complex_q31 z_q31[240];
+    uint64_t c_ref, c_fixed;
+
+    /* The windows are shared, the conversions to fixed-point are counted
+     * with the pre-rotations */
+
+    FIXED_CYCLES(c_ref, mdct_pre_fft(rot, y, z));
+    FIXED_CYCLES(c_fixed, (fixed_from_float(y, ns, (int32_t *)z_q31),
+        fixed_mdct_pre_fft(rot_q31, (const int32_t *)z_q31, z_q31)));
+    fixed_report("mdct pre-rotation", c_ref, c_fixed);
+
+    FIXED_CYCLES(c_ref, mdct_post_fft(rot, z, y, 1.f));
+    FIXED_CYCLES(c_fixed, fixed_mdct_post_fft(rot_q31, z_q31, y_fixed, 1.f));
+    fixed_report("mdct post-rotation", c_ref, c_fixed);
+
+    FIXED_CYCLES(c_ref, imdct_pre_fft(rot, x[0], z));
+    FIXED_CYCLES(c_fixed, (fixed_from_float(x[0], ns, (int32_t *)z_q31),
+        fixed_imdct_pre_fft(rot_q31, (const int32_t *)z_q31, z_q31)));
+    fixed_report("imdct pre-rotation", c_ref, c_fixed);
+
+    FIXED_CYCLES(c_ref, imdct_post_fft(rot, z, y, 1.f));
+    FIXED_CYCLES(c_fixed, fixed_imdct_post_fft(rot_q31, z_q31, y_fixed, 1.f));
+    fixed_report("imdct post-rotation", c_ref, c_fixed);
+
+    FIXED_CYCLES(c_ref, lc3_mdct_forward(dt, sr, sr, x[0], d, y));
+    FIXED_CYCLES(c_fixed, fixed_mdct_forward(dt, sr, sr, x[0], d, y));
+    fixed_report("mdct forward", c_ref, c_fixed);
+
+    FIXED_CYCLES(c_ref, lc3_mdct_inverse(dt, sr, sr, x[0], d, y));
+    FIXED_CYCLES(c_fixed, fixed_mdct_inverse(dt, sr, sr, x[0], d, y));
+    fixed_report("mdct inverse", c_ref, c_fixed);
+
+    return 0;
+}
+
+int check_mdct(void)
+{
+    int ret;
+
+    if ((ret = check_fft()) < 0)
+        return ret;
+
+    if ((ret = check_mdct_transforms()) < 0)
+        return ret;
+
+    return 0;
+}
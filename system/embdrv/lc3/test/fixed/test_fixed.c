@@ -0,0 +1,46 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/**
+ * Check the fixed-point MDCT against the float one, and report the
+ * cycles spent by frame, stage by stage.
+ *
+ * The float MDCT is the reference, the fixed-point one must stay within
+ * a relative error of 2^-20 of it, for example :
+ *
+ *   cc -O2 -Iinclude -Isrc \
+ *      test/fixed/{test,mdct}_fixed.c src/tables.c src/tables_q31.c -lm
+ *
+ * On the targets without a cycle counter readable from user space,
+ * the reports are in nanoseconds.
+ */
+
+#include <stdio.h>
+
+int check_mdct(void);
+
+int main()
+{
+    int r, ret = 0;
+
+    printf("Checking MDCT fixed-point... "); fflush(stdout);
+    printf("\n%s\n", (r = check_mdct()) == 0 ? "OK" : "Failed");
+    ret = ret || r;
+
+    return ret;
+}
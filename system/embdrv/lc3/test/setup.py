@@ -31,6 +31,13 @@ sources = glob.glob('*_py.c') + \
             SRC_DIR + os.sep + 'bits.c',
             SRC_DIR + os.sep + 'plc.c' ]
 
+define_macros = [ ('NPY_NO_DEPRECATED_API', 'NPY_1_7_API_VERSION') ]
+
+# Check the fixed point MDCT against the reference with LC3_FIXED_MDCT=1
+if os.environ.get('LC3_FIXED_MDCT', '0') != '0':
+  sources += [ SRC_DIR + os.sep + 'tables_q31.c' ]
+  define_macros += [ ('LC3_FIXED_MDCT', '1') ]
+
 depends = [ 'ctypes.h' ] + \
           glob.glob(INC_DIR + os.sep + '*.h') + \
           glob.glob(SRC_DIR + os.sep + '*.[c,h]')
@@ -39,7 +46,7 @@ includes = [ SRC_DIR, INC_DIR ]
 
 ctiming = Extension('lc3',
   extra_compile_args = ['-std=c11'],
-  define_macros = [ ('NPY_NO_DEPRECATED_API', 'NPY_1_7_API_VERSION') ],
+  define_macros = define_macros,
   sources = sources,
   depends = depends,
   include_dirs = includes)
@@ -0,0 +1,85 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "x86.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/* -------------------------------------------------------------------------- */
+
+#define TEST_X86
+#include <energy.c>
+
+/* -------------------------------------------------------------------------- */
+
+#if __AVX2__
+
+static int check_bands(void)
+{
+    float x[LC3_MAX_NE], e[LC3_NUM_BANDS], e_x86[LC3_NUM_BANDS];
+
+    for (int i = 0; i < LC3_MAX_NE; i++)
+        x[i] = 2e4 * ((double)rand() / RAND_MAX - 0.5);
+
+    for (int dt = 0; dt < LC3_NUM_DT; dt++)
+        for (int sr = 0; sr < LC3_NUM_SRATE; sr++) {
+            const int *lim = lc3_band_lim[dt][sr];
+            int nb = LC3_MIN(LC3_NUM_BANDS, LC3_NS(dt, sr));
+
+            for (int n1 = 0; n1 < nb; n1++) {
+                energy_bands(x, lim + n1, nb - n1, e);
+                x86_energy_bands(x, lim + n1, nb - n1, e_x86);
+                if (memcmp(e, e_x86, (nb - n1) * sizeof(*e)) != 0)
+                    return -1;
+            }
+        }
+
+    /* Energy of 10ms frames at 48 KHz, from the first band
+     * of more than one coefficient */
+
+    const int *lim = lc3_band_lim[LC3_DT_10M][LC3_SRATE_48K];
+    uint64_t c_ref, c_x86;
+
+    X86_CYCLES(c_ref, energy_bands(x, lim + 18, LC3_NUM_BANDS - 18, e));
+    X86_CYCLES(c_x86, x86_energy_bands(x, lim + 18, LC3_NUM_BANDS - 18, e));
+    x86_report("energy bands (10ms 48KHz)", c_ref, c_x86);
+
+    return 0;
+}
+
+#else
+
+static int check_bands(void)
+{
+    printf("\n  energy bands : AVX2 only");
+    return 0;
+}
+
+#endif /* __AVX2__ */
+
+int check_energy(void)
+{
+    int ret;
+
+    if ((ret = check_bands()) < 0)
+        return ret;
+
+    return 0;
+}
@@ -0,0 +1,147 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "x86.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/* -------------------------------------------------------------------------- */
+
+#define TEST_X86
+#include <ltpf.c>
+
+void lc3_put_bits_generic(lc3_bits_t *a, unsigned b, int c)
+{ (void)a, (void)b, (void)c; }
+
+unsigned lc3_get_bits_generic(struct lc3_bits *a, int b)
+{ return (void)a, (void)b, 0; }
+
+/* -------------------------------------------------------------------------- */
+
+static int check_resampler()
+{
+    int16_t __x[60+480], *x = __x + 60;
+    for (int i = -60; i < 480; i++)
+          x[i] = rand() & 0xffff;
+
+    struct lc3_ltpf_hp50_state hp50 = { 0 }, hp50_x86 = { 0 };
+    int16_t y[128], y_x86[128];
+
+    resample_16k_12k8(&hp50, x, y, 128);
+    x86_resample_16k_12k8(&hp50_x86, x, y_x86, 128);
+    if (memcmp(y, y_x86, 128 * sizeof(*y)) != 0)
+        return -1;
+
+    resample_32k_12k8(&hp50, x, y, 128);
+    x86_resample_32k_12k8(&hp50_x86, x, y_x86, 128);
+    if (memcmp(y, y_x86, 128 * sizeof(*y)) != 0)
+        return -1;
+
+    resample_48k_12k8(&hp50, x, y, 128);
+    x86_resample_48k_12k8(&hp50_x86, x, y_x86, 128);
+    if (memcmp(y, y_x86, 128 * sizeof(*y)) != 0)
+        return -1;
+
+    /* Resampling of 10ms frames */
+
+    uint64_t c_ref, c_x86;
+
+    X86_CYCLES(c_ref, resample_16k_12k8(&hp50, x, y, 128));
+    X86_CYCLES(c_x86, x86_resample_16k_12k8(&hp50_x86, x, y_x86, 128));
+    x86_report("resample 16K (10ms)", c_ref, c_x86);
+
+    X86_CYCLES(c_ref, resample_32k_12k8(&hp50, x, y, 128));
+    X86_CYCLES(c_x86, x86_resample_32k_12k8(&hp50_x86, x, y_x86, 128));
+    x86_report("resample 32K (10ms)", c_ref, c_x86);
+
+    X86_CYCLES(c_ref, resample_48k_12k8(&hp50, x, y, 128));
+    X86_CYCLES(c_x86, x86_resample_48k_12k8(&hp50_x86, x, y_x86, 128));
+    x86_report("resample 48K (10ms)", c_ref, c_x86);
+
+    return 0;
+}
+
+static int check_dot()
+{
+    int16_t x[200];
+    for (int i = 0; i < 200; i++)
+        x[i] = rand() & 0xffff;
+
+    for (int n = 16; n <= 128; n += 16) {
+        float y = dot(x, x+3, n);
+        float y_x86 = x86_dot(x, x+3, n);
+        if (y != y_x86)
+            return -1;
+    }
+
+    return 0;
+}
+
+static int check_correlate()
+{
+    int16_t alignas(4) a[500], b[500];
+    float y[100], y_x86[100];
+
+    for (int i = 0; i < 500; i++) {
+        a[i] = rand() & 0xffff;
+        b[i] = rand() & 0xffff;
+    }
+
+    correlate(a, b+200, 128, y, 100);
+    x86_correlate(a, b+200, 128, y_x86, 100);
+    if (memcmp(y, y_x86, 100 * sizeof(*y)) != 0)
+        return -1;
+
+    correlate(a, b+199, 128, y, 99);
+    x86_correlate(a, b+199, 128, y_x86, 99);
+    if (memcmp(y, y_x86, 99 * sizeof(*y)) != 0)
+        return -1;
+
+    correlate(a, b+199, 64, y, 17);
+    x86_correlate(a, b+199, 64, y_x86, 17);
+    if (memcmp(y, y_x86, 17 * sizeof(*y)) != 0)
+        return -1;
+
+    /* Pitch detection correlation of 10ms frames */
+
+    uint64_t c_ref, c_x86;
+
+    X86_CYCLES(c_ref, correlate(a, b+200, 128, y, 99));
+    X86_CYCLES(c_x86, x86_correlate(a, b+200, 128, y_x86, 99));
+    x86_report("correlate (10ms)", c_ref, c_x86);
+
+    return 0;
+}
+
+int check_ltpf(void)
+{
+    int ret;
+
+    if ((ret = check_resampler()) < 0)
+        return ret;
+
+    if ((ret = check_dot()) < 0)
+        return ret;
+
+    if ((ret = check_correlate()) < 0)
+        return ret;
+
+    return 0;
+}
@@ -0,0 +1,140 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#include "x86.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/* -------------------------------------------------------------------------- */
+
+#define TEST_X86
+#include <mdct.c>
+
+/* -------------------------------------------------------------------------- */
+
+static struct lc3_complex *x86_fft(const struct lc3_complex *x, int n,
+    struct lc3_complex *y0, struct lc3_complex *y1)
+{
+    struct lc3_complex *y[2] = { y1, y0 };
+    int i2, i3, is = 0;
+
+    x86_fft_5(x, y[is], n /= 5);
+
+    for (i3 = 0; n & (n-1); i3++, is ^= 1)
+        x86_fft_bf3(lc3_fft_twiddles_bf3[i3], y[is], y[is ^ 1], n /= 3);
+
+    for (i2 = 0; n > 1; i2++, is ^= 1)
+        x86_fft_bf2(lc3_fft_twiddles_bf2[i2][i3], y[is], y[is ^ 1], n >>= 1);
+
+    return y[is];
+}
+
+static int check_fft_kernels(void)
+{
+    struct lc3_complex x[240];
+    struct lc3_complex y[240], y_x86[240];
+
+    for (int i = 0; i < 240; i++) {
+          x[i].re = 2 * (double)rand() / RAND_MAX - 1;
+          x[i].im = 2 * (double)rand() / RAND_MAX - 1;
+    }
+
+    for (int n5 = 6; n5 <= 48; n5 += 2) {
+        fft_5(x, y, n5);
+        x86_fft_5(x, y_x86, n5);
+        if (memcmp(y, y_x86, 5*n5 * sizeof(*y)) != 0)
+            return -1;
+    }
+
+    for (int i3 = 0; i3 < 2; i3++) {
+        const struct lc3_fft_bf3_twiddles *t = lc3_fft_twiddles_bf3[i3];
+        int n = 240 / (3 * t->n3);
+
+        fft_bf3(t, x, y, n);
+        x86_fft_bf3(t, x, y_x86, n);
+        if (memcmp(y, y_x86, 3*n*t->n3 * sizeof(*y)) != 0)
+            return -1;
+    }
+
+    for (int i3 = 0; i3 < 3; i3++)
+        for (int i2 = 0; i2 < 5 && lc3_fft_twiddles_bf2[i2][i3]; i2++) {
+            const struct lc3_fft_bf2_twiddles *t =
+                lc3_fft_twiddles_bf2[i2][i3];
+            int n = 240 / (2 * t->n2);
+
+            fft_bf2(t, x, y, n);
+            x86_fft_bf2(t, x, y_x86, n);
+            if (memcmp(y, y_x86, 2*n*t->n2 * sizeof(*y)) != 0)
+                return -1;
+        }
+
+    return 0;
+}
+
+static int check_fft(void)
+{
+    static const int fft_n[] =
+        { 30, 40, 60, 80, 90, 120, 160, 180, 240 };
+
+    struct lc3_complex x[240], y0[240], y1[240];
+    struct lc3_complex y0_x86[240], y1_x86[240];
+
+    for (int i = 0; i < 240; i++) {
+          x[i].re = 2 * (double)rand() / RAND_MAX - 1;
+          x[i].im = 2 * (double)rand() / RAND_MAX - 1;
+    }
+
+    for (int k = 0; k < (int)(sizeof(fft_n) / sizeof(*fft_n)); k++) {
+        int n = fft_n[k];
+        struct lc3_complex *y, *y_x86;
+
+        y = fft(x, n, y0, y1);
+        y_x86 = x86_fft(x, n, y0_x86, y1_x86);
+        if (memcmp(y, y_x86, n * sizeof(*y)) != 0)
+            return -1;
+    }
+
+    /* FFT of the MDCT, 10ms frames at 48 KHz */
+
+    uint64_t c_ref, c_x86;
+
+    X86_CYCLES(c_ref, fft(x, 240, y0, y1));
+    X86_CYCLES(c_x86, x86_fft(x, 240, y0_x86, y1_x86));
+    x86_report("fft 240 (10ms 48KHz)", c_ref, c_x86);
+
+    X86_CYCLES(c_ref, fft(x, 180, y0, y1));
+    X86_CYCLES(c_x86, x86_fft(x, 180, y0_x86, y1_x86));
+    x86_report("fft 180 (7.5ms 48KHz)", c_ref, c_x86);
+
+    return 0;
+}
+
+int check_mdct(void)
+{
+    int ret;
+
+    if ((ret = check_fft_kernels()) < 0)
+        return ret;
+
+    if ((ret = check_fft()) < 0)
+        return ret;
+
+    return 0;
+}
@@ -0,0 +1,60 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/**
+ * Check the x86 kernels against the generic versions, and report
+ * the cycles spent by frame.
+ *
+ * The generic versions are the reference : the results are compared
+ * bit by bit, so the checks must be built without `-ffast-math` or FMA
+ * contraction, for example :
+ *
+ *   cc -O2 -msse4.1 (or -mavx2) -Iinclude -Isrc \
+ *      test/x86/{test,ltpf,mdct,energy}_x86.c src/tables.c -lm
+ */
+
+#include <stdio.h>
+
+int check_ltpf(void);
+int check_mdct(void);
+int check_energy(void);
+
+int main()
+{
+    int r, ret = 0;
+
+#if __AVX2__
+    printf("x86 kernels, AVX2\n");
+#else
+    printf("x86 kernels, SSE4.1\n");
+#endif
+
+    printf("Checking LTPF x86... "); fflush(stdout);
+    printf("\n%s\n", (r = check_ltpf()) == 0 ? "OK" : "Failed");
+    ret = ret || r;
+
+    printf("Checking MDCT x86... "); fflush(stdout);
+    printf("\n%s\n", (r = check_mdct()) == 0 ? "OK" : "Failed");
+    ret = ret || r;
+
+    printf("Checking Energy x86... "); fflush(stdout);
+    printf("\n%s\n", (r = check_energy()) == 0 ? "OK" : "Failed");
+    ret = ret || r;
+
+    return ret;
+}
@@ -0,0 +1,59 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+#ifndef __LC3_TEST_X86_H
+#define __LC3_TEST_X86_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <x86intrin.h>
+
+
+/**
+ * Measure the cycles taken by a statement
+ * cycles          Output the minimum count of TSC cycles, over the runs
+ * stmt            Statement to measure
+ */
+#define X86_CYCLES(cycles, stmt)                                \
+do {                                                            \
+    uint64_t __min = UINT64_MAX;                                \
+                                                                \
+    for (int __i = 0; __i < 1000; __i++) {                      \
+        uint64_t __t0 = __rdtsc();                              \
+        stmt;                                                   \
+        __asm__ __volatile__("" ::: "memory");                  \
+        uint64_t __t = __rdtsc() - __t0;                        \
+        __min = __t < __min ? __t : __min;                      \
+    }                                                           \
+                                                                \
+    (cycles) = __min;                                           \
+} while (0)
+
+/**
+ * Report the cycles of a per-frame processing
+ * name            Name of the processing
+ * ref, x86        Cycles of the generic and x86 versions
+ */
+static inline void x86_report(const char *name, uint64_t ref, uint64_t x86)
+{
+    printf("\n  %-24s %6llu -> %6llu cycles/frame (x%.2f)", name,
+        (unsigned long long)ref, (unsigned long long)x86, (double)ref / x86);
+}
+
+
+#endif /* __LC3_TEST_X86_H */
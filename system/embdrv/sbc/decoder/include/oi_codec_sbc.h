@@ -79,6 +79,12 @@ Declarations of codec functions, data types, and macros.
 
 #define OI_SBC_SYNCWORD 0x9c
 #define OI_SBC_ENHANCED_SYNCWORD 0x9d
+#define OI_mSBC_SYNCWORD 0xad
+
+/* mSBC frame parameters, HFP 1.6 Appendix A. The header only holds the
+ * syncword and the CRC, the other fields are reserved. */
+#define OI_mSBC_BLOCKS 15
+#define OI_mSBC_BITPOOL 26
 
 /**@name Sampling frequencies */
 /**@{*/
@@ -238,6 +244,8 @@ typedef struct {
   uint8_t restrictSubbands;
   uint8_t enhancedEnabled;
   uint8_t bufferedBlocks;
+  /* Boolean, set by OI_CODEC_mSBC_DecoderReset() */
+  uint8_t mSBCEnabled;
 } OI_CODEC_SBC_DECODER_CONTEXT;
 
 typedef struct {
@@ -275,6 +283,16 @@ OI_STATUS OI_CODEC_SBC_DecoderReset(OI_CODEC_SBC_DECODER_CONTEXT* context,
                                     uint8_t maxChannels, uint8_t pcmStride,
                                     OI_BOOL enhanced);
 
+/**
+ * This function resets the decoder for a mSBC stream, the wideband speech
+ * of HFP. Only mSBC frames are decoded from then on, into mono 16 kHz PCM.
+ *
+ * @param context   Pointer to the decoder context structure to be reset.
+ */
+OI_STATUS OI_CODEC_mSBC_DecoderReset(OI_CODEC_SBC_DECODER_CONTEXT* context,
+                                     uint32_t* decoderData,
+                                     uint32_t decoderDataBytes);
+
 /**
  * This function restricts the kind of SBC frames that the Decoder will
  * process.  Its use is optional.  If used, it must be called after
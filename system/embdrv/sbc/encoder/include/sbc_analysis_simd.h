@@ -0,0 +1,69 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  SIMD kernels for the analysis filterbank (windowing and fast DCT).
+ *
+ ******************************************************************************/
+
+#ifndef SBC_ANALYSIS_SIMD_H
+#define SBC_ANALYSIS_SIMD_H
+
+#include "sbc_encoder.h"
+
+/* The kernels reproduce the SBC_IPAQ_OPT arithmetic with 16 bit window
+ * coefficients and the 32x16 bit fast DCT, any other configuration keeps the
+ * scalar code. */
+#if ((SBC_SIMD_ANALYSIS == TRUE) && (SBC_ARM_ASM_OPT == FALSE) &&       \
+     (SBC_IPAQ_OPT == TRUE) && (SBC_IS_64_MULT_IN_WINDOW_ACCU == FALSE) && \
+     (SBC_FAST_DCT == TRUE) && (SBC_IS_64_MULT_IN_IDCT == FALSE) &&         \
+     (defined(__x86_64__) || defined(__i386__) || defined(__ARM_NEON)))
+#define SBC_SIMD_ANALYSIS_ENABLED TRUE
+#else
+#define SBC_SIMD_ANALYSIS_ENABLED FALSE
+#endif
+
+typedef struct SBC_ANALYSIS_KERNELS_TAG {
+  const char* name;
+  /* Window 5 taps of |ps16X| (s16X + ChOffset) into the 8 or 16 DCT inputs */
+  void (*Window4)(const int16_t* ps16X, int32_t* ps32Y);
+  void (*Window8)(const int16_t* ps16X, int32_t* ps32Y);
+  /* Run |s32Count| consecutive DCTs, same result as calling SBC_FastIDCT4/8
+   * on each 8/16 entry input vector */
+  void (*FastIDCT4)(int32_t* ps32In, int32_t* ps32Out, int32_t s32Count);
+  void (*FastIDCT8)(int32_t* ps32In, int32_t* ps32Out, int32_t s32Count);
+} SBC_ANALYSIS_KERNELS;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Return the fastest kernels the running CPU supports, NULL if none. */
+extern const SBC_ANALYSIS_KERNELS* SbcAnalysisSimdKernels(void);
+
+/* Allow (default) or forbid the SIMD kernels for the encoders initialized by
+ * SBC_Encoder_Init() afterwards. The encoded output is identical either way,
+ * this lets tests and benchmarks compare the two paths. */
+extern void SbcAnalysisEnableSimd(bool enable);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SBC_ANALYSIS_SIMD_H */
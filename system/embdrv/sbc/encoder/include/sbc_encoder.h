@@ -66,6 +66,11 @@
 #define SBC_BLOCK_2 12
 #define SBC_BLOCK_3 16
 
+/* mSBC frame parameters, HFP 1.6 Appendix A */
+#define SBC_MSBC_NUM_OF_BLOCKS 15
+#define SBC_MSBC_BITPOOL 26
+#define SBC_MSBC_SYNCWORD 0xAD
+
 #define SBC_NULL 0
 
 #ifndef SBC_MAX_NUM_FRAME
@@ -141,6 +146,13 @@
 #define SBC_FAST_DCT TRUE
 #endif /*SBC_FAST_DCT */
 
+/* Set SBC_SIMD_ANALYSIS to FALSE to always run the scalar analysis filterbank.
+ * When TRUE the NEON, SSE4.1 or AVX2 kernels are picked at init time if the
+ * CPU supports them, their output is bit exact with the scalar path. */
+#ifndef SBC_SIMD_ANALYSIS
+#define SBC_SIMD_ANALYSIS TRUE
+#endif /*SBC_SIMD_ANALYSIS */
+
 /* In case we do not use joint stereo mode the flag save some RAM and ROM in
  * case it is set to FALSE */
 #ifndef SBC_JOINT_STE_INCLUDED
@@ -167,7 +179,7 @@ typedef struct SBC_ENC_PARAMS_TAG {
   int16_t s16ChannelMode;   /* mono, dual, streo or joint streo*/
   int16_t s16NumOfSubBands; /* 4 or 8 */
   int16_t s16NumOfChannels;
-  int16_t s16NumOfBlocks;      /* 4, 8, 12 or 16*/
+  int16_t s16NumOfBlocks;      /* 4, 8, 12 or 16, 15 for mSBC*/
   int16_t s16AllocationMethod; /* loudness or SNR*/
   int16_t s16BitPool;          /* 16*numOfSb for mono & dual;
                                  32*numOfSb for stereo & joint stereo */
@@ -188,6 +200,9 @@ typedef struct SBC_ENC_PARAMS_TAG {
 
   uint16_t FrameHeader;
 
+  uint8_t mSBCEnabled; /* TRUE to encode mSBC frames, the other parameters
+                          are then set by SBC_Encoder_Init */
+
 } SBC_ENC_PARAMS;
 
 #ifdef __cplusplus
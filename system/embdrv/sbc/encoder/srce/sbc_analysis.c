@@ -23,6 +23,7 @@
  *
  ******************************************************************************/
 #include <string.h>
+#include "sbc_analysis_simd.h"
 #include "sbc_enc_func_declare.h"
 #include "sbc_encoder.h"
 /*#include <math.h>*/
@@ -1187,6 +1188,14 @@ static int16_t* s16X =
 
 static int16_t ShiftCounter = 0;
 extern int16_t EncMaxShiftCounter;
+
+#if (SBC_SIMD_ANALYSIS_ENABLED == TRUE)
+/* Window outputs of a whole frame, the DCTs then run on all blocks at once */
+static int32_t s32SimdDCTY[SBC_MAX_NUM_OF_BLOCKS * SBC_MAX_NUM_OF_CHANNELS *
+                           2 * SBC_MAX_NUM_OF_SUBBANDS];
+static const SBC_ANALYSIS_KERNELS* pstrKernels = NULL;
+static bool SimdAllowed = true;
+#endif
 /****************************************************************************
 * SbcAnalysisFilter - performs Analysis of the input audio stream
 *
@@ -1199,6 +1208,9 @@ void SbcAnalysisFilter4(SBC_ENC_PARAMS* pstrEncParams, int16_t* input) {
   int32_t s32NumOfChannels, s32NumOfBlocks;
   int32_t i, *ps32X, *ps32X2;
   int32_t Offset, Offset2, ChOffset;
+#if (SBC_SIMD_ANALYSIS_ENABLED == TRUE)
+  int32_t* ps32Y = s32SimdDCTY;
+#endif
 #if (SBC_ARM_ASM_OPT == TRUE)
   register int32_t s32Hi, s32Hi2;
 #else
@@ -1257,9 +1269,17 @@ void SbcAnalysisFilter4(SBC_ENC_PARAMS* pstrEncParams, int16_t* input) {
     for (s32Ch = 0; s32Ch < s32NumOfChannels; s32Ch++) {
       ChOffset = s32Ch * Offset2 + Offset;
 
-      WINDOW_PARTIAL_4
+#if (SBC_SIMD_ANALYSIS_ENABLED == TRUE)
+      if (pstrKernels != NULL) {
+        pstrKernels->Window4(&s16X[ChOffset], ps32Y);
+        ps32Y += 2 * SUB_BANDS_4;
+      } else
+#endif
+      {
+        WINDOW_PARTIAL_4
 
-      SBC_FastIDCT4(s32DCTY, ps32SbBuf);
+        SBC_FastIDCT4(s32DCTY, ps32SbBuf);
+      }
 
       ps32SbBuf += SUB_BANDS_4;
     }
@@ -1279,6 +1299,11 @@ void SbcAnalysisFilter4(SBC_ENC_PARAMS* pstrEncParams, int16_t* input) {
       }
     }
   }
+#if (SBC_SIMD_ANALYSIS_ENABLED == TRUE)
+  if (pstrKernels != NULL)
+    pstrKernels->FastIDCT4(s32SimdDCTY, pstrEncParams->s32SbBuffer,
+                           s32NumOfBlocks * s32NumOfChannels);
+#endif
 }
 
 /* ////////////////////////////////////////////////////////////////////////// */
@@ -1290,6 +1315,9 @@ void SbcAnalysisFilter8(SBC_ENC_PARAMS* pstrEncParams, int16_t* input) {
   int32_t s32NumOfChannels, s32NumOfBlocks;
   int32_t i, *ps32X, *ps32X2;
   int32_t ChOffset;
+#if (SBC_SIMD_ANALYSIS_ENABLED == TRUE)
+  int32_t* ps32Y = s32SimdDCTY;
+#endif
 #if (SBC_ARM_ASM_OPT == TRUE)
   register int32_t s32Hi, s32Hi2;
 #else
@@ -1370,9 +1398,17 @@ void SbcAnalysisFilter8(SBC_ENC_PARAMS* pstrEncParams, int16_t* input) {
     for (s32Ch = 0; s32Ch < s32NumOfChannels; s32Ch++) {
       ChOffset = s32Ch * Offset2 + Offset;
 
-      WINDOW_PARTIAL_8
+#if (SBC_SIMD_ANALYSIS_ENABLED == TRUE)
+      if (pstrKernels != NULL) {
+        pstrKernels->Window8(&s16X[ChOffset], ps32Y);
+        ps32Y += 2 * SUB_BANDS_8;
+      } else
+#endif
+      {
+        WINDOW_PARTIAL_8
 
-      SBC_FastIDCT8(s32DCTY, ps32SbBuf);
+        SBC_FastIDCT8(s32DCTY, ps32SbBuf);
+      }
 
       ps32SbBuf += SUB_BANDS_8;
     }
@@ -1392,9 +1428,23 @@ void SbcAnalysisFilter8(SBC_ENC_PARAMS* pstrEncParams, int16_t* input) {
       }
     }
   }
+#if (SBC_SIMD_ANALYSIS_ENABLED == TRUE)
+  if (pstrKernels != NULL)
+    pstrKernels->FastIDCT8(s32SimdDCTY, pstrEncParams->s32SbBuffer,
+                           s32NumOfBlocks * s32NumOfChannels);
+#endif
 }
 
 void SbcAnalysisInit(void) {
   memset(s16X, 0, ENC_VX_BUFFER_SIZE * sizeof(int16_t));
   ShiftCounter = 0;
+#if (SBC_SIMD_ANALYSIS_ENABLED == TRUE)
+  pstrKernels = SimdAllowed ? SbcAnalysisSimdKernels() : NULL;
+#endif
+}
+
+void SbcAnalysisEnableSimd(bool enable) {
+#if (SBC_SIMD_ANALYSIS_ENABLED == TRUE)
+  SimdAllowed = enable;
+#endif
 }
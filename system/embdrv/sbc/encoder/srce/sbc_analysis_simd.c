@@ -0,0 +1,528 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/******************************************************************************
+ *
+ *  This file contains the NEON, SSE4.1 and AVX2 versions of the analysis
+ *  window and of the fast DCT. They are bit exact with the SBC_IPAQ_OPT
+ *  macros of sbc_analysis.c and with SBC_FastIDCT4/8.
+ *
+ ******************************************************************************/
+
+#include "sbc_analysis_simd.h"
+#include "sbc_dct.h"
+#include "sbc_enc_func_declare.h"
+#include "sbc_encoder.h"
+
+#if (SBC_SIMD_ANALYSIS_ENABLED == TRUE)
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SBC_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define SBC_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#include <arm_neon.h>
+#endif
+
+/* Window taps: for 2 * N = 8 or 16 the DCT input i is the sum over t = 0..4
+ * of gas16WindowTapsN[t * 2 * N + i] * s16X[ChOffset + t * 2 * N + i]. These
+ * are the WIND_4_SUBBANDS_* and WIND_8_SUBBANDS_* constants laid out the way
+ * WINDOW_ACCU_4_* and WINDOW_ACCU_8_* apply them, so loads are contiguous. */
+static const int16_t gas16WindowTaps4[5 * 8] = {
+    0,     18,    49,   90,   126,  128,  61,   -100,  /* t = 0 */
+    358,   670,   946,  1055, 848,  201,  -944, -2544, /* t = 1 */
+    4443,  6389,  8081, 9235, 9644, 9235, 8081, 6389,  /* t = 2 */
+    -4443, -2544, -944, 201,  848,  1055, 946,  670,   /* t = 3 */
+    -358,  -100,  61,   128,  126,  90,   49,   18,    /* t = 4 */
+};
+
+static const int16_t gas16WindowTaps8[5 * 16] = {
+    /* t = 0 */
+    0, 5, 11, 18, 27, 37, 48, 58, 66, 69, 65, 53, 30, -6, -54, -115,
+    /* t = 1 */
+    185, 263, 343, 418, 480, 521, 532, 502, 424, 290, 96, -161, -480, -856,
+    -1280, -1743,
+    /* t = 2 */
+    2228, 2719, 3197, 3644, 4039, 4367, 4612, 4764, 4815, 4764, 4612, 4367,
+    4039, 3644, 3197, 2719,
+    /* t = 3 */
+    -2228, -1743, -1280, -856, -480, -161, 96, 290, 424, 502, 532, 521, 480,
+    418, 343, 263,
+    /* t = 4 */
+    -185, -115, -54, -6, 30, 53, 65, 69, 66, 58, 48, 37, 27, 18, 11, 5,
+};
+
+/* SBC_FastIDCT8 and SBC_FastIDCT4 written on vectors, each lane runs the DCT
+ * of a different block. SBC_VEC, V_ADD, V_SUB, V_SRA, V_SLL and V_MULT are
+ * defined for each instruction set before use; V_MULT(c, x) must return the
+ * SBC_MULT_32_16_SIMPLIFIED result (int32_t)(((int64_t)c * x) >> 15). */
+#define SBC_SIMD_FAST_IDCT8(in, out)                                     \
+  {                                                                      \
+    SBC_VEC x0, x1, x2, x3, x4, x5, x6, x7, temp;                        \
+    SBC_VEC res_even[4], res_odd[4];                                     \
+    x0 = V_MULT(SBC_COS_PI_SUR_4, in[4]);                                \
+    x1 = V_SRA(V_ADD(in[3], in[5]), 1);                                  \
+    x2 = V_SRA(V_ADD(in[2], in[6]), 1);                                  \
+    x3 = V_SRA(V_ADD(in[1], in[7]), 1);                                  \
+    x4 = V_SRA(V_ADD(in[0], in[8]), 1);                                  \
+    x5 = V_SRA(V_SUB(in[9], in[15]), 1);                                 \
+    x6 = V_SRA(V_SUB(in[10], in[14]), 1);                                \
+    x7 = V_SRA(V_SUB(in[11], in[13]), 1);                                \
+    temp = x0;                                                           \
+    x0 = V_MULT(SBC_COS_PI_SUR_4, V_ADD(x0, x4));                        \
+    x4 = V_MULT(SBC_COS_PI_SUR_4, V_SUB(temp, x4));                      \
+    x2 = V_SUB(x2, x6);                                                  \
+    x6 = V_SLL(x6, 1);                                                   \
+    x6 = V_MULT(SBC_COS_PI_SUR_4, x6);                                   \
+    temp = x2;                                                           \
+    x2 = V_MULT(SBC_COS_PI_SUR_8, V_ADD(x2, x6));                        \
+    x6 = V_MULT(SBC_COS_3PI_SUR_8, V_SUB(temp, x6));                     \
+    res_even[0] = V_ADD(x0, x2);                                         \
+    res_even[1] = V_ADD(x4, x6);                                         \
+    res_even[2] = V_SUB(x4, x6);                                         \
+    res_even[3] = V_SUB(x0, x2);                                         \
+    x7 = V_SLL(x7, 1);                                                   \
+    x5 = V_SUB(V_SLL(x5, 1), x7);                                        \
+    x3 = V_SUB(V_SLL(x3, 1), x5);                                        \
+    x1 = V_SUB(x1, V_SRA(x3, 1));                                        \
+    x5 = V_MULT(SBC_COS_PI_SUR_4, x5);                                   \
+    temp = x1;                                                           \
+    x1 = V_ADD(x1, x5);                                                  \
+    x5 = V_SUB(temp, x5);                                                \
+    x3 = V_SUB(x3, x7);                                                  \
+    x7 = V_SLL(x7, 1);                                                   \
+    x7 = V_MULT(SBC_COS_PI_SUR_4, x7);                                   \
+    temp = x3;                                                           \
+    x3 = V_MULT(SBC_COS_PI_SUR_8, V_ADD(x3, x7));                        \
+    x7 = V_MULT(SBC_COS_3PI_SUR_8, V_SUB(temp, x7));                     \
+    res_odd[0] = V_MULT(SBC_COS_PI_SUR_16, V_ADD(x1, x3));               \
+    res_odd[1] = V_MULT(SBC_COS_3PI_SUR_16, V_ADD(x5, x7));              \
+    res_odd[2] = V_MULT(SBC_COS_5PI_SUR_16, V_SUB(x5, x7));              \
+    res_odd[3] = V_MULT(SBC_COS_7PI_SUR_16, V_SUB(x1, x3));              \
+    out[0] = V_ADD(res_even[0], res_odd[0]);                             \
+    out[1] = V_ADD(res_even[1], res_odd[1]);                             \
+    out[2] = V_ADD(res_even[2], res_odd[2]);                             \
+    out[3] = V_ADD(res_even[3], res_odd[3]);                             \
+    out[7] = V_SUB(res_even[0], res_odd[0]);                             \
+    out[6] = V_SUB(res_even[1], res_odd[1]);                             \
+    out[5] = V_SUB(res_even[2], res_odd[2]);                             \
+    out[4] = V_SUB(res_even[3], res_odd[3]);                             \
+  }
+
+#define SBC_SIMD_FAST_IDCT4(in, out)                      \
+  {                                                       \
+    SBC_VEC temp, x2;                                     \
+    SBC_VEC tmp[8];                                       \
+    x2 = V_SRA(in[2], 1);                                 \
+    temp = V_ADD(in[0], in[4]);                           \
+    tmp[0] = V_MULT((SBC_COS_PI_SUR_4 >> 1), temp);       \
+    tmp[1] = V_SUB(x2, tmp[0]);                           \
+    tmp[0] = V_ADD(tmp[0], x2);                           \
+    temp = V_ADD(in[1], in[3]);                           \
+    tmp[3] = V_MULT((SBC_COS_3PI_SUR_8 >> 1), temp);      \
+    tmp[2] = V_MULT((SBC_COS_PI_SUR_8 >> 1), temp);       \
+    temp = V_SUB(in[5], in[7]);                           \
+    tmp[5] = V_MULT((SBC_COS_3PI_SUR_8 >> 1), temp);      \
+    tmp[4] = V_MULT((SBC_COS_PI_SUR_8 >> 1), temp);       \
+    tmp[6] = V_ADD(tmp[2], tmp[5]);                       \
+    tmp[7] = V_SUB(tmp[3], tmp[4]);                       \
+    out[0] = V_ADD(tmp[0], tmp[6]);                       \
+    out[1] = V_ADD(tmp[1], tmp[7]);                       \
+    out[2] = V_SUB(tmp[1], tmp[7]);                       \
+    out[3] = V_SUB(tmp[0], tmp[6]);                       \
+  }
+
+#if defined(__x86_64__) || defined(__i386__)
+
+/* 4x4 transpose of 32 bit lanes, within each 128 bit lane for AVX2 */
+#define SBC_X86_TRANSPOSE4(pre, r0, r1, r2, r3)   \
+  {                                               \
+    SBC_VEC t0 = pre##_unpacklo_epi32(r0, r1);    \
+    SBC_VEC t1 = pre##_unpacklo_epi32(r2, r3);    \
+    SBC_VEC t2 = pre##_unpackhi_epi32(r0, r1);    \
+    SBC_VEC t3 = pre##_unpackhi_epi32(r2, r3);    \
+    r0 = pre##_unpacklo_epi64(t0, t1);            \
+    r1 = pre##_unpackhi_epi64(t0, t1);            \
+    r2 = pre##_unpacklo_epi64(t2, t3);            \
+    r3 = pre##_unpackhi_epi64(t2, t3);            \
+  }
+
+/* (int64_t)c * x >> 15 with c < 0x8000, using x = (x >> 16) * 0x10000 +
+ * (x & 0xFFFF) so that both partial products fit in 32 bits. */
+static inline SBC_TARGET_SSE41 __m128i SbcMult32x16Sse41(__m128i x,
+                                                         int32_t c) {
+  const __m128i vc = _mm_set1_epi32(c);
+  __m128i hi = _mm_mullo_epi32(_mm_srai_epi32(x, 16), vc);
+  __m128i lo = _mm_mullo_epi32(_mm_and_si128(x, _mm_set1_epi32(0xFFFF)), vc);
+  return _mm_add_epi32(_mm_slli_epi32(hi, 1), _mm_srli_epi32(lo, 15));
+}
+
+static inline SBC_TARGET_AVX2 __m256i SbcMult32x16Avx2(__m256i x, int32_t c) {
+  const __m256i vc = _mm256_set1_epi32(c);
+  __m256i hi = _mm256_mullo_epi32(_mm256_srai_epi32(x, 16), vc);
+  __m256i lo =
+      _mm256_mullo_epi32(_mm256_and_si256(x, _mm256_set1_epi32(0xFFFF)), vc);
+  return _mm256_add_epi32(_mm256_slli_epi32(hi, 1), _mm256_srli_epi32(lo, 15));
+}
+
+/* Windows 8 consecutive DCT inputs, |s32Stride| is the distance between two
+ * taps in both |ps16X| and |ps16Taps|. */
+static inline SBC_TARGET_SSE41 void SbcWindowAccuSse41(const int16_t* ps16X,
+                                                       const int16_t* ps16Taps,
+                                                       int32_t s32Stride,
+                                                       int32_t* ps32Y) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i x[5], c[5], lo, hi;
+  int32_t t;
+
+  for (t = 0; t < 5; t++) {
+    x[t] = _mm_loadu_si128((const __m128i*)(ps16X + t * s32Stride));
+    c[t] = _mm_loadu_si128((const __m128i*)(ps16Taps + t * s32Stride));
+  }
+  lo = _mm_madd_epi16(_mm_unpacklo_epi16(x[0], x[1]),
+                      _mm_unpacklo_epi16(c[0], c[1]));
+  hi = _mm_madd_epi16(_mm_unpackhi_epi16(x[0], x[1]),
+                      _mm_unpackhi_epi16(c[0], c[1]));
+  lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(x[2], x[3]),
+                                        _mm_unpacklo_epi16(c[2], c[3])));
+  hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(x[2], x[3]),
+                                        _mm_unpackhi_epi16(c[2], c[3])));
+  lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(x[4], zero),
+                                        _mm_unpacklo_epi16(c[4], zero)));
+  hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(x[4], zero),
+                                        _mm_unpackhi_epi16(c[4], zero)));
+  _mm_storeu_si128((__m128i*)ps32Y, lo);
+  _mm_storeu_si128((__m128i*)(ps32Y + 4), hi);
+}
+
+static SBC_TARGET_SSE41 void SbcWindow4Sse41(const int16_t* ps16X,
+                                             int32_t* ps32Y) {
+  SbcWindowAccuSse41(ps16X, gas16WindowTaps4, 8, ps32Y);
+}
+
+static SBC_TARGET_SSE41 void SbcWindow8Sse41(const int16_t* ps16X,
+                                             int32_t* ps32Y) {
+  SbcWindowAccuSse41(ps16X, gas16WindowTaps8, 16, ps32Y);
+  SbcWindowAccuSse41(ps16X + 8, gas16WindowTaps8 + 8, 16, ps32Y + 8);
+}
+
+#define SBC_VEC __m128i
+#define V_ADD(a, b) _mm_add_epi32(a, b)
+#define V_SUB(a, b) _mm_sub_epi32(a, b)
+#define V_SRA(a, n) _mm_srai_epi32(a, n)
+#define V_SLL(a, n) _mm_slli_epi32(a, n)
+#define V_MULT(c, a) SbcMult32x16Sse41(a, c)
+
+static SBC_TARGET_SSE41 void SbcFastIDCT4Sse41(int32_t* ps32In,
+                                               int32_t* ps32Out,
+                                               int32_t s32Count) {
+  __m128i in[8], out[4];
+  int32_t k, v;
+
+  for (; s32Count >= 4; s32Count -= 4) {
+    for (k = 0; k < 8; k += 4) {
+      for (v = 0; v < 4; v++)
+        in[k + v] = _mm_loadu_si128((const __m128i*)(ps32In + v * 8 + k));
+      SBC_X86_TRANSPOSE4(_mm, in[k], in[k + 1], in[k + 2], in[k + 3]);
+    }
+    SBC_SIMD_FAST_IDCT4(in, out);
+    SBC_X86_TRANSPOSE4(_mm, out[0], out[1], out[2], out[3]);
+    for (v = 0; v < 4; v++)
+      _mm_storeu_si128((__m128i*)(ps32Out + v * 4), out[v]);
+    ps32In += 4 * 8;
+    ps32Out += 4 * 4;
+  }
+  for (; s32Count > 0; s32Count--) {
+    SBC_FastIDCT4(ps32In, ps32Out);
+    ps32In += 8;
+    ps32Out += 4;
+  }
+}
+
+static SBC_TARGET_SSE41 void SbcFastIDCT8Sse41(int32_t* ps32In,
+                                               int32_t* ps32Out,
+                                               int32_t s32Count) {
+  __m128i in[16], out[8];
+  int32_t k, v;
+
+  for (; s32Count >= 4; s32Count -= 4) {
+    for (k = 0; k < 16; k += 4) {
+      for (v = 0; v < 4; v++)
+        in[k + v] = _mm_loadu_si128((const __m128i*)(ps32In + v * 16 + k));
+      SBC_X86_TRANSPOSE4(_mm, in[k], in[k + 1], in[k + 2], in[k + 3]);
+    }
+    SBC_SIMD_FAST_IDCT8(in, out);
+    for (k = 0; k < 8; k += 4) {
+      SBC_X86_TRANSPOSE4(_mm, out[k], out[k + 1], out[k + 2], out[k + 3]);
+      for (v = 0; v < 4; v++)
+        _mm_storeu_si128((__m128i*)(ps32Out + v * 8 + k), out[k + v]);
+    }
+    ps32In += 4 * 16;
+    ps32Out += 4 * 8;
+  }
+  for (; s32Count > 0; s32Count--) {
+    SBC_FastIDCT8(ps32In, ps32Out);
+    ps32In += 16;
+    ps32Out += 8;
+  }
+}
+
+#undef SBC_VEC
+#undef V_ADD
+#undef V_SUB
+#undef V_SRA
+#undef V_SLL
+#undef V_MULT
+
+static SBC_TARGET_AVX2 void SbcWindow8Avx2(const int16_t* ps16X,
+                                           int32_t* ps32Y) {
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i x[5], c[5], lo, hi;
+  int32_t t;
+
+  for (t = 0; t < 5; t++) {
+    x[t] = _mm256_loadu_si256((const __m256i*)(ps16X + t * 16));
+    c[t] = _mm256_loadu_si256((const __m256i*)(gas16WindowTaps8 + t * 16));
+  }
+  /* lo holds the inputs 0-3 and 8-11, hi the inputs 4-7 and 12-15 */
+  lo = _mm256_madd_epi16(_mm256_unpacklo_epi16(x[0], x[1]),
+                         _mm256_unpacklo_epi16(c[0], c[1]));
+  hi = _mm256_madd_epi16(_mm256_unpackhi_epi16(x[0], x[1]),
+                         _mm256_unpackhi_epi16(c[0], c[1]));
+  lo = _mm256_add_epi32(
+      lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(x[2], x[3]),
+                            _mm256_unpacklo_epi16(c[2], c[3])));
+  hi = _mm256_add_epi32(
+      hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(x[2], x[3]),
+                            _mm256_unpackhi_epi16(c[2], c[3])));
+  lo = _mm256_add_epi32(
+      lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(x[4], zero),
+                            _mm256_unpacklo_epi16(c[4], zero)));
+  hi = _mm256_add_epi32(
+      hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(x[4], zero),
+                            _mm256_unpackhi_epi16(c[4], zero)));
+  _mm256_storeu_si256((__m256i*)ps32Y,
+                      _mm256_permute2x128_si256(lo, hi, 0x20));
+  _mm256_storeu_si256((__m256i*)(ps32Y + 8),
+                      _mm256_permute2x128_si256(lo, hi, 0x31));
+}
+
+#define SBC_VEC __m256i
+#define V_ADD(a, b) _mm256_add_epi32(a, b)
+#define V_SUB(a, b) _mm256_sub_epi32(a, b)
+#define V_SRA(a, n) _mm256_srai_epi32(a, n)
+#define V_SLL(a, n) _mm256_slli_epi32(a, n)
+#define V_MULT(c, a) SbcMult32x16Avx2(a, c)
+
+/* Lanes 0-3 run the DCTs of vectors v, lanes 4-7 the ones of vectors v + 4 */
+#define SBC_AVX2_LOAD2(p, q)                                              \
+  _mm256_inserti128_si256(                                                \
+      _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(p))),       \
+      _mm_loadu_si128((const __m128i*)(q)), 1)
+#define SBC_AVX2_STORE2(p, q, a)                                          \
+  {                                                                       \
+    _mm_storeu_si128((__m128i*)(p), _mm256_castsi256_si128(a));           \
+    _mm_storeu_si128((__m128i*)(q), _mm256_extracti128_si256(a, 1));      \
+  }
+
+static SBC_TARGET_AVX2 void SbcFastIDCT4Avx2(int32_t* ps32In,
+                                             int32_t* ps32Out,
+                                             int32_t s32Count) {
+  __m256i in[8], out[4];
+  int32_t k, v;
+
+  for (; s32Count >= 8; s32Count -= 8) {
+    for (k = 0; k < 8; k += 4) {
+      for (v = 0; v < 4; v++)
+        in[k + v] =
+            SBC_AVX2_LOAD2(ps32In + v * 8 + k, ps32In + (v + 4) * 8 + k);
+      SBC_X86_TRANSPOSE4(_mm256, in[k], in[k + 1], in[k + 2], in[k + 3]);
+    }
+    SBC_SIMD_FAST_IDCT4(in, out);
+    SBC_X86_TRANSPOSE4(_mm256, out[0], out[1], out[2], out[3]);
+    for (v = 0; v < 4; v++)
+      SBC_AVX2_STORE2(ps32Out + v * 4, ps32Out + (v + 4) * 4, out[v]);
+    ps32In += 8 * 8;
+    ps32Out += 8 * 4;
+  }
+  SbcFastIDCT4Sse41(ps32In, ps32Out, s32Count);
+}
+
+static SBC_TARGET_AVX2 void SbcFastIDCT8Avx2(int32_t* ps32In,
+                                             int32_t* ps32Out,
+                                             int32_t s32Count) {
+  __m256i in[16], out[8];
+  int32_t k, v;
+
+  for (; s32Count >= 8; s32Count -= 8) {
+    for (k = 0; k < 16; k += 4) {
+      for (v = 0; v < 4; v++)
+        in[k + v] =
+            SBC_AVX2_LOAD2(ps32In + v * 16 + k, ps32In + (v + 4) * 16 + k);
+      SBC_X86_TRANSPOSE4(_mm256, in[k], in[k + 1], in[k + 2], in[k + 3]);
+    }
+    SBC_SIMD_FAST_IDCT8(in, out);
+    for (k = 0; k < 8; k += 4) {
+      SBC_X86_TRANSPOSE4(_mm256, out[k], out[k + 1], out[k + 2], out[k + 3]);
+      for (v = 0; v < 4; v++)
+        SBC_AVX2_STORE2(ps32Out + v * 8 + k, ps32Out + (v + 4) * 8 + k,
+                        out[k + v]);
+    }
+    ps32In += 8 * 16;
+    ps32Out += 8 * 8;
+  }
+  SbcFastIDCT8Sse41(ps32In, ps32Out, s32Count);
+}
+
+static const SBC_ANALYSIS_KERNELS strSse41Kernels = {
+    "sse4.1", SbcWindow4Sse41, SbcWindow8Sse41, SbcFastIDCT4Sse41,
+    SbcFastIDCT8Sse41,
+};
+
+/* The 4 subband window is only 8 inputs wide, AVX2 brings nothing there */
+static const SBC_ANALYSIS_KERNELS strAvx2Kernels = {
+    "avx2", SbcWindow4Sse41, SbcWindow8Avx2, SbcFastIDCT4Avx2,
+    SbcFastIDCT8Avx2,
+};
+
+const SBC_ANALYSIS_KERNELS* SbcAnalysisSimdKernels(void) {
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) return &strAvx2Kernels;
+  if (__builtin_cpu_supports("sse4.1")) return &strSse41Kernels;
+  return NULL;
+}
+
+#else /* NEON */
+
+/* 4x4 transpose of 32 bit lanes */
+#define SBC_NEON_TRANSPOSE4(r0, r1, r2, r3)                            \
+  {                                                                    \
+    int32x4x2_t t01 = vtrnq_s32(r0, r1);                               \
+    int32x4x2_t t23 = vtrnq_s32(r2, r3);                               \
+    r0 = vcombine_s32(vget_low_s32(t01.val[0]), vget_low_s32(t23.val[0])); \
+    r1 = vcombine_s32(vget_low_s32(t01.val[1]), vget_low_s32(t23.val[1])); \
+    r2 = vcombine_s32(vget_high_s32(t01.val[0]), vget_high_s32(t23.val[0])); \
+    r3 = vcombine_s32(vget_high_s32(t01.val[1]), vget_high_s32(t23.val[1])); \
+  }
+
+/* (int64_t)c * x >> 15 with c < 0x8000, using x = (x >> 16) * 0x10000 +
+ * (x & 0xFFFF) so that both partial products fit in 32 bits. */
+static inline int32x4_t SbcMult32x16Neon(int32x4_t x, int32_t c) {
+  int32x4_t hi = vmulq_n_s32(vshrq_n_s32(x, 16), c);
+  uint32x4_t lo = vmulq_n_u32(
+      vandq_u32(vreinterpretq_u32_s32(x), vdupq_n_u32(0xFFFF)), (uint32_t)c);
+  return vaddq_s32(vshlq_n_s32(hi, 1),
+                   vreinterpretq_s32_u32(vshrq_n_u32(lo, 15)));
+}
+
+/* Windows |s32Count| consecutive DCT inputs, |s32Stride| is the distance
+ * between two taps in both |ps16X| and |ps16Taps|. */
+static inline void SbcWindowAccuNeon(const int16_t* ps16X,
+                                     const int16_t* ps16Taps,
+                                     int32_t s32Stride, int32_t s32Count,
+                                     int32_t* ps32Y) {
+  int32x4_t acc;
+  int32_t i, t;
+
+  for (i = 0; i < s32Count; i += 4) {
+    acc = vmull_s16(vld1_s16(ps16X + i), vld1_s16(ps16Taps + i));
+    for (t = 1; t < 5; t++)
+      acc = vmlal_s16(acc, vld1_s16(ps16X + t * s32Stride + i),
+                      vld1_s16(ps16Taps + t * s32Stride + i));
+    vst1q_s32(ps32Y + i, acc);
+  }
+}
+
+static void SbcWindow4Neon(const int16_t* ps16X, int32_t* ps32Y) {
+  SbcWindowAccuNeon(ps16X, gas16WindowTaps4, 8, 8, ps32Y);
+}
+
+static void SbcWindow8Neon(const int16_t* ps16X, int32_t* ps32Y) {
+  SbcWindowAccuNeon(ps16X, gas16WindowTaps8, 16, 16, ps32Y);
+}
+
+#define SBC_VEC int32x4_t
+#define V_ADD(a, b) vaddq_s32(a, b)
+#define V_SUB(a, b) vsubq_s32(a, b)
+#define V_SRA(a, n) vshrq_n_s32(a, n)
+#define V_SLL(a, n) vshlq_n_s32(a, n)
+#define V_MULT(c, a) SbcMult32x16Neon(a, c)
+
+static void SbcFastIDCT4Neon(int32_t* ps32In, int32_t* ps32Out,
+                             int32_t s32Count) {
+  int32x4_t in[8], out[4];
+  int32_t k, v;
+
+  for (; s32Count >= 4; s32Count -= 4) {
+    for (k = 0; k < 8; k += 4) {
+      for (v = 0; v < 4; v++) in[k + v] = vld1q_s32(ps32In + v * 8 + k);
+      SBC_NEON_TRANSPOSE4(in[k], in[k + 1], in[k + 2], in[k + 3]);
+    }
+    SBC_SIMD_FAST_IDCT4(in, out);
+    SBC_NEON_TRANSPOSE4(out[0], out[1], out[2], out[3]);
+    for (v = 0; v < 4; v++) vst1q_s32(ps32Out + v * 4, out[v]);
+    ps32In += 4 * 8;
+    ps32Out += 4 * 4;
+  }
+  for (; s32Count > 0; s32Count--) {
+    SBC_FastIDCT4(ps32In, ps32Out);
+    ps32In += 8;
+    ps32Out += 4;
+  }
+}
+
+static void SbcFastIDCT8Neon(int32_t* ps32In, int32_t* ps32Out,
+                             int32_t s32Count) {
+  int32x4_t in[16], out[8];
+  int32_t k, v;
+
+  for (; s32Count >= 4; s32Count -= 4) {
+    for (k = 0; k < 16; k += 4) {
+      for (v = 0; v < 4; v++) in[k + v] = vld1q_s32(ps32In + v * 16 + k);
+      SBC_NEON_TRANSPOSE4(in[k], in[k + 1], in[k + 2], in[k + 3]);
+    }
+    SBC_SIMD_FAST_IDCT8(in, out);
+    for (k = 0; k < 8; k += 4) {
+      SBC_NEON_TRANSPOSE4(out[k], out[k + 1], out[k + 2], out[k + 3]);
+      for (v = 0; v < 4; v++) vst1q_s32(ps32Out + v * 8 + k, out[k + v]);
+    }
+    ps32In += 4 * 16;
+    ps32Out += 4 * 8;
+  }
+  for (; s32Count > 0; s32Count--) {
+    SBC_FastIDCT8(ps32In, ps32Out);
+    ps32In += 16;
+    ps32Out += 8;
+  }
+}
+
+static const SBC_ANALYSIS_KERNELS strNeonKernels = {
+    "neon", SbcWindow4Neon, SbcWindow8Neon, SbcFastIDCT4Neon, SbcFastIDCT8Neon,
+};
+
+const SBC_ANALYSIS_KERNELS* SbcAnalysisSimdKernels(void) {
+  return &strNeonKernels;
+}
+
+#endif
+
+#else /* SBC_SIMD_ANALYSIS_ENABLED == FALSE */
+
+const SBC_ANALYSIS_KERNELS* SbcAnalysisSimdKernels(void) { return NULL; }
+
+#endif
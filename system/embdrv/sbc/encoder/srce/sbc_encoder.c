@@ -167,6 +167,15 @@ void SBC_Encoder_Init(SBC_ENC_PARAMS* pstrEncParams) {
   int16_t s16FrameLen;      /*to store frame length*/
   uint16_t HeaderParams;
 
+  /* mSBC has fixed parameters */
+  if (pstrEncParams->mSBCEnabled) {
+    pstrEncParams->s16SamplingFreq = SBC_sf16000;
+    pstrEncParams->s16ChannelMode = SBC_MONO;
+    pstrEncParams->s16NumOfSubBands = SUB_BANDS_8;
+    pstrEncParams->s16NumOfBlocks = SBC_MSBC_NUM_OF_BLOCKS;
+    pstrEncParams->s16AllocationMethod = SBC_LOUDNESS;
+  }
+
   /* Required number of channels */
   if (pstrEncParams->s16ChannelMode == SBC_MONO)
     pstrEncParams->s16NumOfChannels = 1;
@@ -228,6 +237,7 @@ void SBC_Encoder_Init(SBC_ENC_PARAMS* pstrEncParams) {
   }
 
   if (pstrEncParams->s16BitPool < 0) pstrEncParams->s16BitPool = 0;
+  if (pstrEncParams->mSBCEnabled) pstrEncParams->s16BitPool = SBC_MSBC_BITPOOL;
   /* sampling freq */
   HeaderParams = ((pstrEncParams->s16SamplingFreq & 3) << 6);
 
@@ -240,7 +250,8 @@ void SBC_Encoder_Init(SBC_ENC_PARAMS* pstrEncParams) {
   /* Loudness or SNR */
   HeaderParams |= ((pstrEncParams->s16AllocationMethod & 1) << 1);
   HeaderParams |= ((pstrEncParams->s16NumOfSubBands >> 3) & 1); /*4 or 8*/
-  pstrEncParams->FrameHeader = HeaderParams;
+  /* The header fields of mSBC frames are reserved */
+  pstrEncParams->FrameHeader = pstrEncParams->mSBCEnabled ? 0 : HeaderParams;
 
   if (pstrEncParams->s16NumOfSubBands == 4) {
     if (pstrEncParams->s16NumOfChannels == 1)
@@ -137,7 +137,8 @@ struct ActivityAttribution::impl {
   }
 
   void on_hci_packet(hal::HciPacket packet, hal::SnoopLogger::PacketType type, uint16_t length) {
-    attribution_processor_.OnBtaaPackets(std::move(hci_processor_.OnHciPacket(std::move(packet), type, length)));
+    hci_processor_.OnHciPacket(std::move(packet), type, length, btaa_hci_packets_);
+    attribution_processor_.OnBtaaPackets(btaa_hci_packets_);
   }
 
   void on_wakelock_acquired() {
@@ -173,6 +174,8 @@ struct ActivityAttribution::impl {
   ActivityAttributionCallback* callback_;
   AttributionProcessor attribution_processor_;
   HciProcessor hci_processor_;
+  // Reused for each packet, so that its storage is only allocated once
+  std::vector<BtaaHciPacket> btaa_hci_packets_;
   WakelockProcessor wakelock_processor_;
 };
 
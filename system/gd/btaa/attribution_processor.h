@@ -17,6 +17,8 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
+#include <string>
 #include <unordered_map>
 
 #include "hci_processor.h"
@@ -38,24 +40,27 @@ struct AddressActivityKey {
 struct AddressActivityKeyHasher {
   std::size_t operator()(const AddressActivityKey& key) const {
     return (
-        (std::hash<std::string>()(key.address.ToString()) ^
+        (std::hash<hci::Address>()(key.address) ^
          (std::hash<unsigned char>()(static_cast<unsigned char>(key.activity)))));
   }
 };
 
+// Package info shared by the entries of an app, so that they are made without copying strings
+using PackageInfo = std::shared_ptr<const std::string>;
+
 struct AppActivityKey {
-  std::string app;
+  PackageInfo app;
   Activity activity;
 
   bool operator==(const AppActivityKey& other) const {
-    return (app == other.app && activity == other.activity);
+    return (*app == *other.app && activity == other.activity);
   }
 };
 
 struct AppActivityKeyHasher {
   std::size_t operator()(const AppActivityKey& key) const {
     return (
-        (std::hash<std::string>()(key.app) ^ (std::hash<unsigned char>()(static_cast<unsigned char>(key.activity)))));
+        (std::hash<std::string>()(*key.app) ^ (std::hash<unsigned char>()(static_cast<unsigned char>(key.activity)))));
   }
 };
 
@@ -68,14 +73,15 @@ struct DeviceWakeupDescriptor {
 
 struct AppWakeupDescriptor {
   Activity activity_;
-  std::string package_info_;
-  AppWakeupDescriptor(Activity activity, std::string package_info) : activity_(activity), package_info_(package_info) {}
+  PackageInfo package_info_;
+  AppWakeupDescriptor(Activity activity, PackageInfo package_info)
+      : activity_(activity), package_info_(std::move(package_info)) {}
   virtual ~AppWakeupDescriptor() {}
 };
 
 class AttributionProcessor {
  public:
-  void OnBtaaPackets(std::vector<BtaaHciPacket> btaa_packets);
+  void OnBtaaPackets(const std::vector<BtaaHciPacket>& btaa_packets);
   void OnWakelockReleased(uint32_t duration_ms);
   void OnWakeup();
   void NotifyActivityAttributionInfo(int uid, const std::string& package_name, const std::string& device_address);
@@ -86,13 +92,14 @@ class AttributionProcessor {
   bool wakeup_ = false;
   std::unordered_map<AddressActivityKey, BtaaAggregationEntry, AddressActivityKeyHasher> btaa_aggregator_;
   std::unordered_map<AddressActivityKey, BtaaAggregationEntry, AddressActivityKeyHasher> wakelock_duration_aggregator_;
-  std::unordered_map<std::string, std::string> address_app_map_;
+  std::unordered_map<hci::Address, PackageInfo> address_app_map_;
   std::unordered_map<AppActivityKey, BtaaAggregationEntry, AppActivityKeyHasher> app_activity_aggregator_;
   common::TimestampedCircularBuffer<DeviceWakeupDescriptor> device_wakeup_aggregator_ =
       common::TimestampedCircularBuffer<DeviceWakeupDescriptor>(kWakeupAggregatorSize);
   common::TimestampedCircularBuffer<AppWakeupDescriptor> app_wakeup_aggregator_ =
       common::TimestampedCircularBuffer<AppWakeupDescriptor>(kWakeupAggregatorSize);
   const char* ActivityToString(Activity activity);
+  const PackageInfo& GetPackageInfo(const hci::Address& address) const;
 };
 
 }  // namespace activity_attribution
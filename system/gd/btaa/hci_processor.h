@@ -16,6 +16,9 @@
 
 #pragma once
 
+#include <unordered_map>
+#include <vector>
+
 #include "btaa/activity_attribution.h"
 #include "btaa/cmd_evt_classification.h"
 #include "hal/snoop_logger.h"
@@ -39,7 +42,7 @@ class DeviceParser {
   void match_handle_with_address(uint16_t connection_handle, hci::Address& address);
 
  private:
-  std::map<uint16_t, hci::Address> connection_lookup_table_;
+  std::unordered_map<uint16_t, hci::Address> connection_lookup_table_;
 };
 
 struct PendingCommand {
@@ -49,7 +52,12 @@ struct PendingCommand {
 
 class HciProcessor {
  public:
-  std::vector<BtaaHciPacket> OnHciPacket(hal::HciPacket packet, hal::SnoopLogger::PacketType type, uint16_t length);
+  // Replaces the content of |btaa_hci_packets|, which the caller reuses across packets to keep its capacity
+  void OnHciPacket(
+      hal::HciPacket packet,
+      hal::SnoopLogger::PacketType type,
+      uint16_t length,
+      std::vector<BtaaHciPacket>& btaa_hci_packets);
 
  private:
   void process_le_event(std::vector<BtaaHciPacket>& btaa_hci_packets, int16_t byte_count, hci::EventView& event);
@@ -23,7 +23,7 @@ namespace bluetooth {
 namespace activity_attribution {
 
 constexpr char kActivityAttributionTimeFormat[] = "%Y-%m-%d %H:%M:%S";
-static const std::string kUnknownPackageInfo = "UNKNOWN";
+static const PackageInfo kUnknownPackageInfo = std::make_shared<const std::string>("UNKNOWN");
 // A device-activity aggregation entry expires after two days (172800 seconds)
 static const int kDurationToKeepDeviceActivityEntrySecs = 172800;
 // A transient device-activity aggregation entry is defined as an entry with very few Byte count
@@ -32,27 +32,29 @@ static const int kByteCountTransientDeviceActivityEntry = 200;
 static const int kDurationTransientDeviceActivityEntrySecs = 900;
 static const int kMapSizeTrimDownAggregationEntry = 200;
 
-void AttributionProcessor::OnBtaaPackets(std::vector<BtaaHciPacket> btaa_packets) {
+const PackageInfo& AttributionProcessor::GetPackageInfo(const hci::Address& address) const {
+  auto it = address_app_map_.find(address);
+  if (it == address_app_map_.end()) {
+    return kUnknownPackageInfo;
+  }
+  return it->second;
+}
+
+void AttributionProcessor::OnBtaaPackets(const std::vector<BtaaHciPacket>& btaa_packets) {
   AddressActivityKey key;
 
   for (auto& btaa_packet : btaa_packets) {
     key.address = btaa_packet.address;
     key.activity = btaa_packet.activity;
 
-    if (wakelock_duration_aggregator_.find(key) == wakelock_duration_aggregator_.end()) {
-      wakelock_duration_aggregator_[key] = {};
-    }
-    wakelock_duration_aggregator_[key].byte_count += btaa_packet.byte_count;
+    // Value initialized on insertion, the entries are then updated in place
+    auto& entry = wakelock_duration_aggregator_[key];
+    entry.byte_count += btaa_packet.byte_count;
 
     if (wakeup_) {
-      wakelock_duration_aggregator_[key].wakeup_count += 1;
-      device_wakeup_aggregator_.Push(std::move(DeviceWakeupDescriptor(btaa_packet.activity, btaa_packet.address)));
-      std::string package_info = kUnknownPackageInfo;
-      std::string address = btaa_packet.address.ToString();
-      if (address_app_map_.find(address) != address_app_map_.end()) {
-        package_info = address_app_map_[address];
-      }
-      app_wakeup_aggregator_.Push(std::move(AppWakeupDescriptor(btaa_packet.activity, package_info)));
+      entry.wakeup_count += 1;
+      device_wakeup_aggregator_.Push(DeviceWakeupDescriptor(btaa_packet.activity, btaa_packet.address));
+      app_wakeup_aggregator_.Push(AppWakeupDescriptor(btaa_packet.activity, GetPackageInfo(btaa_packet.address)));
     }
   }
   wakeup_ = false;
@@ -90,13 +92,8 @@ void AttributionProcessor::OnWakelockReleased(uint32_t duration_ms) {
     btaa_aggregator_[it.first].byte_count += it.second.byte_count;
     btaa_aggregator_[it.first].wakelock_duration_ms += it.second.wakelock_duration_ms;
 
-    std::string address = it.first.address.ToString();
-    std::string package_info = kUnknownPackageInfo;
-    if (address_app_map_.find(address) != address_app_map_.end()) {
-      package_info = address_app_map_[address];
-    }
     AppActivityKey key;
-    key.app = package_info;
+    key.app = GetPackageInfo(it.first.address);
     key.activity = it.first.activity;
 
     if (app_activity_aggregator_.find(key) == app_activity_aggregator_.end()) {
@@ -126,23 +123,27 @@ void AttributionProcessor::OnWakelockReleased(uint32_t duration_ms) {
   }
   // Trim down the transient entries in the aggregator to avoid that it overgrows
   if (btaa_aggregator_.size() > kMapSizeTrimDownAggregationEntry) {
-    for (auto& it : btaa_aggregator_) {
+    for (auto it = btaa_aggregator_.begin(); it != btaa_aggregator_.end();) {
       auto elapsed_time_sec =
-          std::chrono::duration_cast<std::chrono::seconds>(cur_time - it.second.creation_time).count();
+          std::chrono::duration_cast<std::chrono::seconds>(cur_time - it->second.creation_time).count();
       if (elapsed_time_sec > kDurationTransientDeviceActivityEntrySecs &&
-          it.second.byte_count < kByteCountTransientDeviceActivityEntry) {
-        btaa_aggregator_.erase(it.first);
+          it->second.byte_count < kByteCountTransientDeviceActivityEntry) {
+        it = btaa_aggregator_.erase(it);
+      } else {
+        ++it;
       }
     }
   }
 
   if (app_activity_aggregator_.size() > kMapSizeTrimDownAggregationEntry) {
-    for (auto& it : app_activity_aggregator_) {
+    for (auto it = app_activity_aggregator_.begin(); it != app_activity_aggregator_.end();) {
       auto elapsed_time_sec =
-          std::chrono::duration_cast<std::chrono::seconds>(cur_time - it.second.creation_time).count();
+          std::chrono::duration_cast<std::chrono::seconds>(cur_time - it->second.creation_time).count();
       if (elapsed_time_sec > kDurationTransientDeviceActivityEntrySecs &&
-          it.second.byte_count < kByteCountTransientDeviceActivityEntry) {
-        app_activity_aggregator_.erase(it.first);
+          it->second.byte_count < kByteCountTransientDeviceActivityEntry) {
+        it = app_activity_aggregator_.erase(it);
+      } else {
+        ++it;
       }
     }
   }
@@ -161,7 +162,12 @@ void AttributionProcessor::NotifyActivityAttributionInfo(
     LOG_INFO("The map from device address and app info overflows.");
     return;
   }
-  address_app_map_[device_address] = package_name + "/" + std::to_string(uid);
+  hci::Address address;
+  if (!hci::Address::FromString(device_address, address)) {
+    LOG_WARN("Ignoring invalid device address");
+    return;
+  }
+  address_app_map_[address] = std::make_shared<const std::string>(package_name + "/" + std::to_string(uid));
 }
 
 void AttributionProcessor::Dump(
@@ -211,7 +217,7 @@ void AttributionProcessor::Dump(
     wakeup_entry_builder.add_wakeup_time(fb_builder->CreateString(
         bluetooth::common::StringFormatTimeWithMilliseconds(kActivityAttributionTimeFormat, wakeup_time).c_str()));
     wakeup_entry_builder.add_activity(fb_builder->CreateString((ActivityToString(it.entry.activity_))));
-    wakeup_entry_builder.add_package_info(fb_builder->CreateString(it.entry.package_info_));
+    wakeup_entry_builder.add_package_info(fb_builder->CreateString(*it.entry.package_info_));
     app_wakeup_entry_offsets.push_back(wakeup_entry_builder.Finish());
   }
   auto app_wakeup_entries = fb_builder->CreateVector(app_wakeup_entry_offsets);
@@ -221,7 +227,7 @@ void AttributionProcessor::Dump(
   std::vector<flatbuffers::Offset<ActivityAggregationEntry>> app_aggregation_entry_offsets;
   for (auto& it : app_activity_aggregator_) {
     ActivityAggregationEntryBuilder app_entry_builder(*fb_builder);
-    app_entry_builder.add_package_info(fb_builder->CreateString(it.first.app));
+    app_entry_builder.add_package_info(fb_builder->CreateString(*it.first.app));
     app_entry_builder.add_activity(fb_builder->CreateString((ActivityToString(it.first.activity))));
     app_entry_builder.add_wakeup_count(it.second.wakeup_count);
     app_entry_builder.add_byte_count(it.second.byte_count);
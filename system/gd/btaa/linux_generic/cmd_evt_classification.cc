@@ -16,9 +16,30 @@
 
 #include "btaa/cmd_evt_classification.h"
 
+#include <array>
+
 namespace bluetooth {
 namespace activity_attribution {
 
+namespace {
+
+// Event and LE subevent codes are a byte, so that their classifications are precomputed in a table indexed by code
+using ClassificationTable = std::array<CmdEvtActivityClassification, 256>;
+
+template <typename Code>
+ClassificationTable make_classification_table(CmdEvtActivityClassification (*classify)(Code code)) {
+  ClassificationTable table;
+  for (size_t code = 0; code < table.size(); code++) {
+    table[code] = classify(static_cast<Code>(code));
+  }
+  return table;
+}
+
+CmdEvtActivityClassification classify_event(hci::EventCode event_code);
+CmdEvtActivityClassification classify_le_event(hci::SubeventCode subevent_code);
+
+}  // namespace
+
 CmdEvtActivityClassification lookup_cmd(hci::OpCode opcode) {
   CmdEvtActivityClassification classification = {};
   switch (opcode) {
@@ -328,6 +349,18 @@ CmdEvtActivityClassification lookup_cmd(hci::OpCode opcode) {
 }
 
 CmdEvtActivityClassification lookup_event(hci::EventCode event_code) {
+  static const ClassificationTable table = make_classification_table(&classify_event);
+  return table[static_cast<uint8_t>(event_code)];
+}
+
+CmdEvtActivityClassification lookup_le_event(hci::SubeventCode subevent_code) {
+  static const ClassificationTable table = make_classification_table(&classify_le_event);
+  return table[static_cast<uint8_t>(subevent_code)];
+}
+
+namespace {
+
+CmdEvtActivityClassification classify_event(hci::EventCode event_code) {
   CmdEvtActivityClassification classification = {};
   switch (event_code) {
     case hci::EventCode::INQUIRY_COMPLETE:
@@ -397,7 +430,7 @@ CmdEvtActivityClassification lookup_event(hci::EventCode event_code) {
   return classification;
 }
 
-CmdEvtActivityClassification lookup_le_event(hci::SubeventCode subevent_code) {
+CmdEvtActivityClassification classify_le_event(hci::SubeventCode subevent_code) {
   CmdEvtActivityClassification classification = {};
   switch (subevent_code) {
     case hci::SubeventCode::CONNECTION_COMPLETE:
@@ -461,5 +494,7 @@ CmdEvtActivityClassification lookup_le_event(hci::SubeventCode subevent_code) {
   return classification;
 }
 
+}  // namespace
+
 }  // namespace activity_attribution
 }  // namespace bluetooth
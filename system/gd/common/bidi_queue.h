@@ -28,6 +28,7 @@ template <typename TENQUEUE, typename TDEQUEUE>
 class BidiQueueEnd : public ::bluetooth::os::IQueueEnqueue<TENQUEUE>, public ::bluetooth::os::IQueueDequeue<TDEQUEUE> {
  public:
   using EnqueueCallback = Callback<std::unique_ptr<TENQUEUE>()>;
+  using BatchEnqueueCallback = Callback<std::vector<std::unique_ptr<TENQUEUE>>(size_t max_count)>;
   using DequeueCallback = Callback<void()>;
 
   BidiQueueEnd(::bluetooth::os::IQueueEnqueue<TENQUEUE>* tx, ::bluetooth::os::IQueueDequeue<TDEQUEUE>* rx)
@@ -37,6 +38,10 @@ class BidiQueueEnd : public ::bluetooth::os::IQueueEnqueue<TENQUEUE>, public ::b
     tx_->RegisterEnqueue(handler, callback);
   }
 
+  void RegisterBatchEnqueue(::bluetooth::os::Handler* handler, BatchEnqueueCallback callback) override {
+    tx_->RegisterBatchEnqueue(handler, callback);
+  }
+
   void UnregisterEnqueue() override {
     tx_->UnregisterEnqueue();
   }
@@ -53,6 +58,10 @@ class BidiQueueEnd : public ::bluetooth::os::IQueueEnqueue<TENQUEUE>, public ::b
     return rx_->TryDequeue();
   }
 
+  std::vector<std::unique_ptr<TDEQUEUE>> TryDequeueBatch(size_t max_count) override {
+    return rx_->TryDequeueBatch(max_count);
+  }
+
  private:
   ::bluetooth::os::IQueueEnqueue<TENQUEUE>* tx_;
   ::bluetooth::os::IQueueDequeue<TDEQUEUE>* rx_;
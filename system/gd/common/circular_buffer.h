@@ -16,7 +16,9 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <iterator>
 #include <memory>
 #include <mutex>
@@ -34,12 +36,18 @@ class CircularBuffer {
   void Push(T item);
   // Take a snapshot of the circular buffer and return it as a vector
   std::vector<T> Pull() const;
+  // Return up to |max_items| items starting from the |*next| pushed item, or from the oldest remaining one when it was
+  // already evicted, and set |*next| after the last returned item. Starting from 0, this takes a snapshot in slices
+  // without holding the lock for long
+  std::vector<T> Pull(uint64_t* next, size_t max_items) const;
   // Drain everything from the circular buffer and return them as a vector
   std::vector<T> Drain();
 
  private:
   const size_t size_;
   std::deque<T> queue_;
+  // Number of items ever pushed
+  uint64_t pushed_{0};
   mutable std::mutex mutex_;
 };
 
@@ -72,6 +80,7 @@ class TimestampedCircularBuffer : public CircularBuffer<TimestampedEntry<T>> {
 
   void Push(T item);
   std::vector<TimestampedEntry<T>> Pull() const;
+  std::vector<TimestampedEntry<T>> Pull(uint64_t* next, size_t max_items) const;
   std::vector<TimestampedEntry<T>> Drain();
 
  private:
@@ -88,6 +97,7 @@ template <typename T>
 void bluetooth::common::CircularBuffer<T>::Push(const T item) {
   std::unique_lock<std::mutex> lock(mutex_);
   queue_.push_back(item);
+  pushed_++;
   while (queue_.size() > size_) {
     queue_.pop_front();
   }
@@ -99,6 +109,19 @@ std::vector<T> bluetooth::common::CircularBuffer<T>::Pull() const {
   return std::vector<T>(queue_.cbegin(), queue_.cend());
 }
 
+template <typename T>
+std::vector<T> bluetooth::common::CircularBuffer<T>::Pull(uint64_t* next, size_t max_items) const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  uint64_t oldest = pushed_ - queue_.size();
+  if (*next < oldest) {
+    *next = oldest;
+  }
+  auto begin = queue_.cbegin() + std::min<uint64_t>(*next - oldest, queue_.size());
+  auto end = begin + std::min<size_t>(max_items, queue_.cend() - begin);
+  *next += end - begin;
+  return std::vector<T>(begin, end);
+}
+
 template <typename T>
 std::vector<T> bluetooth::common::CircularBuffer<T>::Drain() {
   std::unique_lock<std::mutex> lock(mutex_);
@@ -124,6 +147,12 @@ std::vector<struct bluetooth::common::TimestampedEntry<T>> bluetooth::common::Ti
   return bluetooth::common::CircularBuffer<TimestampedEntry<T>>::Pull();
 }
 
+template <typename T>
+std::vector<struct bluetooth::common::TimestampedEntry<T>> bluetooth::common::TimestampedCircularBuffer<T>::Pull(
+    uint64_t* next, size_t max_items) const {
+  return bluetooth::common::CircularBuffer<TimestampedEntry<T>>::Pull(next, max_items);
+}
+
 template <typename T>
 std::vector<struct bluetooth::common::TimestampedEntry<T>> bluetooth::common::TimestampedCircularBuffer<T>::Drain() {
   return bluetooth::common::CircularBuffer<TimestampedEntry<T>>::Drain();
@@ -103,4 +103,29 @@ TEST(CircularBufferTest, max_timestamps) {
   }
 }
 
+TEST(CircularBufferTest, pull_in_slices) {
+  bluetooth::common::CircularBuffer<int> buffer(5);
+  for (int i = 0; i < 7; i++) {
+    buffer.Push(i);
+  }
+
+  // Starts from the oldest remaining item
+  uint64_t next = 0;
+  ASSERT_THAT(buffer.Pull(&next, 2), ElementsAre(2, 3));
+  ASSERT_EQ(4ul, next);
+
+  // Items evicted between two slices are skipped
+  buffer.Push(7);
+  buffer.Push(8);
+  buffer.Push(9);
+  ASSERT_THAT(buffer.Pull(&next, 2), ElementsAre(5, 6));
+  ASSERT_THAT(buffer.Pull(&next, 10), ElementsAre(7, 8, 9));
+  ASSERT_EQ(10ul, next);
+  ASSERT_TRUE(buffer.Pull(&next, 10).empty());
+
+  buffer.Drain();
+  buffer.Push(10);
+  ASSERT_THAT(buffer.Pull(&next, 10), ElementsAre(10));
+}
+
 }  // namespace testing
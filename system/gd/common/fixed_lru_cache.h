@@ -0,0 +1,435 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "os/log.h"
+
+namespace bluetooth {
+namespace common {
+
+// An LRU map-cache with a fixed capacity, evicting the oldest item when reaching capacity. Same interface and same
+// usage rules as LruCache:
+//   - keys are sorted from warmest to coldest
+//   - iterating through the cache won't warm up keys
+//   - operations on iterators won't warm up keys
+//   - find(), contains(), insert_or_assign(), try_emplace() will warm up the key
+//   - peek() won't warm up the key and doesn't write to the cache, hence can be called concurrently with other const
+//     methods except find() and contains(), e.g. with readers sharing a lock
+//   - insert_or_assign() will evict coldest key when cache reaches capacity
+//   - NOT THREAD SAFE
+//
+// Implementation:
+//   - all the slots are allocated at construction, inserting and evicting never allocate besides what Key and T do
+//   - the recency list links slots by index, keys are found through an open-addressed table of slot indices with
+//     linear probing, kept at most half full
+//   - iterators stay valid until the item they point to is removed or evicted
+//
+// Performance:
+//   - Key look-up and modification is O(1)
+//   - Memory consumption is:
+//     O(capacity*(sizeof(K)+sizeof(T)+sizeof(size_t)+3*sizeof(uint32_t)))
+//
+// Template:
+//   - Key key type
+//   - T value type
+//   - Hash hash function for Key
+//   - KeyEqual equality function for Key
+template <typename Key, typename T, typename Hash = std::hash<Key>, typename KeyEqual = std::equal_to<Key>>
+class FixedLruCache {
+  static constexpr uint32_t kNone = std::numeric_limits<uint32_t>::max();
+
+  template <bool kConst>
+  class Iterator;
+
+ public:
+  using value_type = std::pair<const Key, T>;
+  // different from c++17 node_type on purpose as we want node to be copyable
+  using node_type = std::pair<Key, T>;
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  // Constructor a LRU cache with |capacity|
+  explicit FixedLruCache(size_t capacity) : slots_(capacity) {
+    ASSERT_LOG(capacity != 0, "Unable to have 0 LRU Cache capacity");
+    ASSERT_LOG(capacity < kNone / 2, "LRU Cache capacity %zu is too large", capacity);
+    size_t bucket_bits = 1;
+    while ((size_t{1} << bucket_bits) < 2 * capacity) {
+      bucket_bits++;
+    }
+    buckets_.assign(size_t{1} << bucket_bits, kNone);
+    bucket_shift_ = 64 - bucket_bits;
+    InitFreeList();
+  }
+
+  // for move, the moved-from cache can only be assigned to or destroyed
+  FixedLruCache(FixedLruCache&& other) noexcept = default;
+  FixedLruCache& operator=(FixedLruCache&& other) noexcept = default;
+
+  // slots and buckets refer to each other by index, hence can be copied as they are
+  FixedLruCache(const FixedLruCache& other) = default;
+  FixedLruCache& operator=(const FixedLruCache& other) {
+    if (&other != this) {
+      // values are not assignable as their key is const
+      *this = FixedLruCache(other);
+    }
+    return *this;
+  }
+
+  // comparison operators
+  bool operator==(const FixedLruCache& rhs) const {
+    return capacity() == rhs.capacity() && size_ == rhs.size_ && std::equal(begin(), end(), rhs.begin());
+  }
+  bool operator!=(const FixedLruCache& rhs) const {
+    return !(*this == rhs);
+  }
+
+  // Clear the cache
+  void clear() {
+    for (uint32_t slot = head_; slot != kNone; slot = slots_[slot].next) {
+      slots_[slot].value.reset();
+    }
+    std::fill(buckets_.begin(), buckets_.end(), kNone);
+    size_ = 0;
+    InitFreeList();
+  }
+
+  // Find the value of a key, and move the key to the head of cache, if there is one. Return iterator to value if key
+  // exists, end() if not. Iterator might be invalidated when removed or evicted. Const version.
+  //
+  // LRU: Will warm up key
+  // LRU: Access to returned iterator won't move key in LRU
+  const_iterator find(const Key& key) const {
+    return const_cast<FixedLruCache*>(this)->find(key);
+  }
+
+  // Find the value of a key, and move the key to the head of cache, if there is one. Return iterator to value if key
+  // exists, end() if not. Iterator might be invalidated when removed or evicted
+  //
+  // LRU: Will warm up key
+  // LRU: Access to returned iterator won't move key in LRU
+  iterator find(const Key& key) {
+    uint32_t slot = FindSlot(key, hash_(key));
+    if (slot == kNone) {
+      return end();
+    }
+    MoveToFront(slot);
+    return iterator(this, slot);
+  }
+
+  // Find the value of a key without moving the key in the cache. Return iterator to value if key exists, end() if not.
+  //
+  // LRU: Won't warm up key
+  const_iterator peek(const Key& key) const {
+    return const_iterator(this, FindSlot(key, hash_(key)));
+  }
+
+  // Check if key exist in the cache. Return true if key exist in cache, false, if not
+  //
+  // LRU: Will warm up key
+  bool contains(const Key& key) const {
+    return find(key) != end();
+  }
+
+  // Put a key-value pair to the head of cache, evict the oldest key if cache is at capacity. Eviction is based on key
+  // ONLY. Hence, updating a key will not evict the oldest key. Return evicted value if old value was evicted,
+  // std::nullopt if not. The return value will be evaluated to true in a boolean context if a value is contained by
+  // std::optional, false otherwise.
+  //
+  // LRU: Will warm up key
+  std::optional<node_type> insert_or_assign(const Key& key, T value) {
+    size_t hash = hash_(key);
+    uint32_t slot = FindSlot(key, hash);
+    if (slot != kNone) {
+      MoveToFront(slot);
+      slots_[slot].value->second = std::move(value);
+      return std::nullopt;
+    }
+    std::optional<node_type> evicted_node = EvictIfFull();
+    Insert(hash, key, std::move(value));
+    return evicted_node;
+  }
+
+  // Put a key-value pair to the head of cache, evict the oldest key if cache is at capacity. Eviction is based on key
+  // ONLY. Hence, updating a key will not evict the oldest key. This method tries to construct the value in-place. If
+  // the key already exist, this method only warms it up and returns end(). Return inserted iterator, whether insertion
+  // happens, and evicted value if old value was evicted or std::nullopt
+  //
+  // LRU: Will warm up key
+  template <class... Args>
+  std::tuple<iterator, bool, std::optional<node_type>> try_emplace(const Key& key, Args&&... args) {
+    size_t hash = hash_(key);
+    uint32_t slot = FindSlot(key, hash);
+    if (slot != kNone) {
+      MoveToFront(slot);
+      return std::make_tuple(end(), false, std::nullopt);
+    }
+    std::optional<node_type> evicted_node = EvictIfFull();
+    slot = Insert(hash, key, std::forward<Args>(args)...);
+    return std::make_tuple(iterator(this, slot), true, std::move(evicted_node));
+  }
+
+  // Delete a key from cache, return removed value if old value was evicted, std::nullopt if not. The return value will
+  // be evaluated to true in a boolean context if a value is contained by std::optional, false otherwise.
+  std::optional<node_type> extract(const Key& key) {
+    uint32_t slot = FindSlot(key, hash_(key));
+    if (slot == kNone) {
+      return std::nullopt;
+    }
+    return Remove(slot);
+  }
+
+  /// Remove an iterator pointed item from the lru cache and return the iterator immediately after the erased item
+  iterator erase(const_iterator iter) {
+    uint32_t next = slots_[iter.slot_].next;
+    Remove(iter.slot_);
+    return iterator(this, next);
+  }
+
+  // Return size of the cache
+  size_t size() const {
+    return size_;
+  }
+
+  // Return the number of items the cache holds before evicting
+  size_t capacity() const {
+    return slots_.size();
+  }
+
+  // Iterator interface for begin
+  iterator begin() {
+    return iterator(this, head_);
+  }
+
+  // Return iterator interface for begin, const
+  const_iterator begin() const {
+    return const_iterator(this, head_);
+  }
+
+  // Return iterator interface for end
+  iterator end() {
+    return iterator(this, kNone);
+  }
+
+  // Iterator interface for end, const
+  const_iterator end() const {
+    return const_iterator(this, kNone);
+  }
+
+ private:
+  struct Slot {
+    std::optional<value_type> value;
+    size_t hash = 0;
+    // Neighbours in the recency list, |next| links the free slots
+    uint32_t prev = kNone;
+    uint32_t next = kNone;
+  };
+
+  // Bidirectional iterator from the warmest to the coldest item, end() is kNone
+  template <bool kConst>
+  class Iterator {
+    using Cache = std::conditional_t<kConst, const FixedLruCache, FixedLruCache>;
+
+   public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using value_type = FixedLruCache::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<kConst, const value_type*, value_type*>;
+    using reference = std::conditional_t<kConst, const value_type&, value_type&>;
+
+    Iterator() = default;
+
+    // iterator converts to const_iterator
+    template <bool kOtherConst, typename = std::enable_if_t<kConst && !kOtherConst>>
+    Iterator(const Iterator<kOtherConst>& other) : cache_(other.cache_), slot_(other.slot_) {}
+
+    reference operator*() const {
+      return *cache_->slots_[slot_].value;
+    }
+    pointer operator->() const {
+      return &*cache_->slots_[slot_].value;
+    }
+
+    Iterator& operator++() {
+      slot_ = cache_->slots_[slot_].next;
+      return *this;
+    }
+    Iterator operator++(int) {
+      Iterator iter = *this;
+      ++*this;
+      return iter;
+    }
+    Iterator& operator--() {
+      slot_ = slot_ == kNone ? cache_->tail_ : cache_->slots_[slot_].prev;
+      return *this;
+    }
+    Iterator operator--(int) {
+      Iterator iter = *this;
+      --*this;
+      return iter;
+    }
+
+    template <bool kOtherConst>
+    bool operator==(const Iterator<kOtherConst>& rhs) const {
+      return slot_ == rhs.slot_;
+    }
+    template <bool kOtherConst>
+    bool operator!=(const Iterator<kOtherConst>& rhs) const {
+      return slot_ != rhs.slot_;
+    }
+
+   private:
+    friend class FixedLruCache;
+    template <bool>
+    friend class Iterator;
+
+    Iterator(Cache* cache, uint32_t slot) : cache_(cache), slot_(slot) {}
+
+    Cache* cache_ = nullptr;
+    uint32_t slot_ = kNone;
+  };
+
+  void InitFreeList() {
+    for (size_t i = 0; i < slots_.size(); i++) {
+      slots_[i].next = i + 1 < slots_.size() ? i + 1 : kNone;
+    }
+    free_ = 0;
+    head_ = kNone;
+    tail_ = kNone;
+  }
+
+  // Fibonacci hashing, so that identity hashes of small integers spread over the table
+  size_t HomeBucket(size_t hash) const {
+    return (static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ull) >> bucket_shift_;
+  }
+
+  size_t NextBucket(size_t bucket) const {
+    return (bucket + 1) & (buckets_.size() - 1);
+  }
+
+  uint32_t FindSlot(const Key& key, size_t hash) const {
+    for (size_t bucket = HomeBucket(hash); buckets_[bucket] != kNone; bucket = NextBucket(bucket)) {
+      const Slot& slot = slots_[buckets_[bucket]];
+      if (slot.hash == hash && key_equal_(slot.value->first, key)) {
+        return buckets_[bucket];
+      }
+    }
+    return kNone;
+  }
+
+  // Empty the bucket holding |slot|, shifting back the entries probed past it so that lookups don't stop early
+  void RemoveFromBuckets(uint32_t slot) {
+    size_t hole = HomeBucket(slots_[slot].hash);
+    while (buckets_[hole] != slot) {
+      hole = NextBucket(hole);
+    }
+    size_t mask = buckets_.size() - 1;
+    for (size_t bucket = NextBucket(hole); buckets_[bucket] != kNone; bucket = NextBucket(bucket)) {
+      size_t home = HomeBucket(slots_[buckets_[bucket]].hash);
+      // Entries between their home bucket and the hole stay where they are
+      if (((bucket - home) & mask) >= ((bucket - hole) & mask)) {
+        buckets_[hole] = buckets_[bucket];
+        hole = bucket;
+      }
+    }
+    buckets_[hole] = kNone;
+  }
+
+  void Unlink(uint32_t slot) {
+    Slot& s = slots_[slot];
+    (s.prev != kNone ? slots_[s.prev].next : head_) = s.next;
+    (s.next != kNone ? slots_[s.next].prev : tail_) = s.prev;
+  }
+
+  void PushFront(uint32_t slot) {
+    Slot& s = slots_[slot];
+    s.prev = kNone;
+    s.next = head_;
+    (head_ != kNone ? slots_[head_].prev : tail_) = slot;
+    head_ = slot;
+  }
+
+  void MoveToFront(uint32_t slot) {
+    if (slot != head_) {
+      Unlink(slot);
+      PushFront(slot);
+    }
+  }
+
+  template <class... Args>
+  uint32_t Insert(size_t hash, const Key& key, Args&&... args) {
+    uint32_t slot = free_;
+    Slot& s = slots_[slot];
+    free_ = s.next;
+    s.value.emplace(
+        std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+    s.hash = hash;
+    PushFront(slot);
+
+    size_t bucket = HomeBucket(hash);
+    while (buckets_[bucket] != kNone) {
+      bucket = NextBucket(bucket);
+    }
+    buckets_[bucket] = slot;
+    size_++;
+    return slot;
+  }
+
+  node_type Remove(uint32_t slot) {
+    RemoveFromBuckets(slot);
+    Unlink(slot);
+    Slot& s = slots_[slot];
+    node_type node(s.value->first, std::move(s.value->second));
+    s.value.reset();
+    s.next = free_;
+    free_ = slot;
+    size_--;
+    return node;
+  }
+
+  std::optional<node_type> EvictIfFull() {
+    if (size_ < slots_.size()) {
+      return std::nullopt;
+    }
+    return Remove(tail_);
+  }
+
+  std::vector<Slot> slots_;
+  // Index in |slots_| of the item hashed to each bucket, or kNone
+  std::vector<uint32_t> buckets_;
+  size_t bucket_shift_ = 0;
+  size_t size_ = 0;
+  uint32_t head_ = kNone;
+  uint32_t tail_ = kNone;
+  uint32_t free_ = kNone;
+  Hash hash_;
+  KeyEqual key_equal_;
+};
+
+}  // namespace common
+}  // namespace bluetooth
@@ -0,0 +1,217 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "common/fixed_lru_cache.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <random>
+#include <string>
+
+#include "common/lru_cache.h"
+
+namespace testing {
+
+using bluetooth::common::FixedLruCache;
+using bluetooth::common::LruCache;
+
+TEST(FixedLruCacheTest, empty_test) {
+  FixedLruCache<int, int> cache(3);  // capacity = 3;
+  EXPECT_EQ(cache.size(), 0ul);
+  EXPECT_EQ(cache.capacity(), 3ul);
+  EXPECT_EQ(cache.find(42), cache.end());
+  cache.clear();  // should not crash
+  EXPECT_EQ(cache.find(42), cache.end());
+  EXPECT_FALSE(cache.contains(42));
+  EXPECT_FALSE(cache.extract(42));
+  EXPECT_EQ(cache.begin(), cache.end());
+}
+
+TEST(FixedLruCacheTest, comparison_test) {
+  FixedLruCache<int, int> cache_1(2);
+  cache_1.insert_or_assign(1, 10);
+  cache_1.insert_or_assign(2, 20);
+  FixedLruCache<int, int> cache_2(2);
+  cache_2.insert_or_assign(1, 10);
+  cache_2.insert_or_assign(2, 20);
+  EXPECT_EQ(cache_1, cache_2);
+  // Cache with different order should not be equal
+  cache_2.find(1);
+  EXPECT_NE(cache_1, cache_2);
+  cache_1.find(1);
+  EXPECT_EQ(cache_1, cache_2);
+  // Cache with different value should be different
+  cache_2.insert_or_assign(1, 11);
+  EXPECT_NE(cache_1, cache_2);
+  // Cache with different capacity should not be equal
+  FixedLruCache<int, int> cache_3(3);
+  cache_3.insert_or_assign(1, 10);
+  cache_3.insert_or_assign(2, 20);
+  EXPECT_NE(cache_1, cache_3);
+  // Empty caches should be equal
+  FixedLruCache<int, int> cache_4(2);
+  FixedLruCache<int, int> cache_5(2);
+  EXPECT_NE(cache_1, cache_4);
+  EXPECT_EQ(cache_4, cache_5);
+}
+
+TEST(FixedLruCacheTest, insert_evicts_coldest_test) {
+  FixedLruCache<int, int> cache(3);
+  EXPECT_FALSE(cache.insert_or_assign(1, 10));
+  EXPECT_FALSE(cache.insert_or_assign(2, 20));
+  EXPECT_FALSE(cache.insert_or_assign(3, 30));
+  // Updating a key does not evict
+  EXPECT_FALSE(cache.insert_or_assign(1, 11));
+  ASSERT_THAT(cache, ElementsAre(Pair(1, 11), Pair(3, 30), Pair(2, 20)));
+  EXPECT_EQ(cache.insert_or_assign(4, 40), std::make_pair(2, 20));
+  ASSERT_THAT(cache, ElementsAre(Pair(4, 40), Pair(1, 11), Pair(3, 30)));
+  EXPECT_EQ(cache.size(), 3ul);
+}
+
+TEST(FixedLruCacheTest, try_emplace_test) {
+  FixedLruCache<int, int> cache(2);
+  cache.insert_or_assign(1, 10);
+  cache.insert_or_assign(2, 20);
+  auto result = cache.try_emplace(42, 420);
+  // 1, 10 evicted
+  EXPECT_EQ(std::get<2>(result), std::make_pair(1, 10));
+  EXPECT_TRUE(std::get<1>(result));
+  auto iter = cache.find(42);
+  EXPECT_EQ(iter->second, 420);
+  EXPECT_EQ(iter, std::get<0>(result));
+  // Existing key is only warmed up
+  result = cache.try_emplace(2, 200);
+  EXPECT_EQ(std::get<0>(result), cache.end());
+  EXPECT_FALSE(std::get<1>(result));
+  ASSERT_THAT(cache, ElementsAre(Pair(2, 20), Pair(42, 420)));
+}
+
+TEST(FixedLruCacheTest, peek_test) {
+  FixedLruCache<int, int> cache(2);
+  cache.insert_or_assign(1, 10);
+  cache.insert_or_assign(2, 20);
+  auto iter = cache.peek(1);
+  EXPECT_EQ(iter->second, 10);
+  EXPECT_EQ(cache.peek(3), cache.end());
+  // 1, 10 is still the coldest
+  ASSERT_THAT(cache, ElementsAre(Pair(2, 20), Pair(1, 10)));
+  cache.insert_or_assign(3, 30);
+  ASSERT_THAT(cache, ElementsAre(Pair(3, 30), Pair(2, 20)));
+}
+
+TEST(FixedLruCacheTest, copy_test) {
+  FixedLruCache<int, std::shared_ptr<int>> cache(2);
+  cache.insert_or_assign(1, std::make_shared<int>(100));
+  FixedLruCache<int, std::shared_ptr<int>> new_cache = cache;
+  auto iter = new_cache.find(1);
+  EXPECT_EQ(*iter->second, 100);
+  // Since copy is used, shared_ptr should increase count
+  EXPECT_EQ(iter->second.use_count(), 2);
+  // The copy is independent from the original
+  new_cache.insert_or_assign(2, std::make_shared<int>(200));
+  EXPECT_EQ(cache.size(), 1ul);
+  cache = new_cache;
+  EXPECT_EQ(cache, new_cache);
+}
+
+TEST(FixedLruCacheTest, move_insert_unique_ptr_test) {
+  FixedLruCache<int, std::unique_ptr<int>> cache(2);
+  cache.insert_or_assign(1, std::make_unique<int>(100));
+  cache.insert_or_assign(1, std::make_unique<int>(400));
+  auto iter = cache.find(1);
+  EXPECT_EQ(*iter->second, 400);
+  FixedLruCache<int, std::unique_ptr<int>> new_cache = std::move(cache);
+  EXPECT_EQ(*new_cache.find(1)->second, 400);
+}
+
+TEST(FixedLruCacheTest, erase_in_for_loop_test) {
+  FixedLruCache<int, int> cache(3);
+  cache.insert_or_assign(1, 10);
+  cache.insert_or_assign(2, 20);
+  cache.insert_or_assign(3, 30);
+  for (auto iter = cache.begin(); iter != cache.end();) {
+    if (iter->first == 2) {
+      iter = cache.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+  EXPECT_THAT(cache, ElementsAre(Pair(3, 30), Pair(1, 10)));
+  // Erased slots are reused
+  cache.insert_or_assign(4, 40);
+  EXPECT_THAT(cache, ElementsAre(Pair(4, 40), Pair(3, 30), Pair(1, 10)));
+}
+
+TEST(FixedLruCacheTest, coldest_from_end_test) {
+  FixedLruCache<std::string, int> cache(3);
+  cache.insert_or_assign("a", 1);
+  cache.insert_or_assign("b", 2);
+  cache.insert_or_assign("c", 3);
+  auto coldest = std::prev(cache.end());
+  EXPECT_EQ(coldest->first, "a");
+  cache.erase(coldest);
+  EXPECT_EQ(std::prev(cache.end())->first, "b");
+}
+
+struct CollidingHash {
+  size_t operator()(int key) const {
+    return key % 4;
+  }
+};
+
+TEST(FixedLruCacheTest, colliding_keys_test) {
+  // Long probe sequences, removing from the middle of them must keep the others reachable
+  FixedLruCache<int, int, CollidingHash> cache(16);
+  for (int i = 0; i < 16; i++) {
+    cache.insert_or_assign(i, i * 10);
+  }
+  for (int i = 0; i < 16; i += 3) {
+    EXPECT_TRUE(cache.extract(i));
+  }
+  for (int i = 0; i < 16; i++) {
+    EXPECT_EQ(cache.peek(i) != cache.end(), i % 3 != 0) << i;
+  }
+}
+
+TEST(FixedLruCacheTest, same_as_lru_cache_test) {
+  // Random operations give the same cache content and order as LruCache
+  FixedLruCache<int, int> cache(50);
+  LruCache<int, int> reference(50);
+  std::mt19937 gen(1);
+  std::uniform_int_distribution<int> key_dist(0, 200);
+  std::uniform_int_distribution<int> op_dist(0, 3);
+  for (int i = 0; i < 20000; i++) {
+    int key = key_dist(gen);
+    switch (op_dist(gen)) {
+      case 0:
+      case 1:
+        ASSERT_EQ(cache.insert_or_assign(key, i), reference.insert_or_assign(key, i));
+        break;
+      case 2:
+        ASSERT_EQ(cache.find(key) == cache.end(), reference.find(key) == reference.end());
+        break;
+      case 3:
+        ASSERT_EQ(cache.extract(key), reference.extract(key));
+        break;
+    }
+    ASSERT_EQ(cache.size(), reference.size());
+  }
+  ASSERT_TRUE(std::equal(cache.begin(), cache.end(), reference.begin(), reference.end()));
+}
+
+}  // namespace testing
@@ -37,6 +37,7 @@ namespace common {
 //   - iterating through the cache won't warm up keys
 //   - operations on iterators won't warm up keys
 //   - find(), contains(), insert_or_assign() will warm up the key
+//   - peek() won't warm up the key, and can hence be called concurrently with other const methods except find()
 //   - insert_or_assign() will evict coldest key when cache reaches capacity
 //   - NOT THREAD SAFE
 //
@@ -123,6 +124,13 @@ class LruCache {
     return iter;
   }
 
+  // Find the value of a key without moving the key in the cache. Return iterator to value if key exists, end() if not.
+  //
+  // LRU: Won't warm up key
+  const_iterator peek(const Key& key) const {
+    return list_map_.find(key);
+  }
+
   // Check if key exist in the cache. Return true if key exist in cache, false, if not
   //
   // LRU: Will warm up key
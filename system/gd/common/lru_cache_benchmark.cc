@@ -0,0 +1,81 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "common/fixed_lru_cache.h"
+#include "common/lru_cache.h"
+#include "hci/address.h"
+
+using ::benchmark::State;
+using bluetooth::common::FixedLruCache;
+using bluetooth::common::LruCache;
+using bluetooth::hci::Address;
+
+namespace {
+
+// Random device addresses, |count| times the cache capacity so that lookups miss and inserts evict
+std::vector<Address> MakeAddresses(size_t count) {
+  std::mt19937 gen(1);
+  std::uniform_int_distribution<int> dist(0, 255);
+  std::vector<Address> addresses(count);
+  for (auto& address : addresses) {
+    for (auto& byte : address.address) {
+      byte = dist(gen);
+    }
+  }
+  return addresses;
+}
+
+// Devices seen over and over while scanning, all of them cached
+template <typename Cache>
+void BM_LookUp(State& state) {
+  const size_t capacity = state.range(0);
+  Cache cache(capacity);
+  auto addresses = MakeAddresses(capacity);
+  for (const auto& address : addresses) {
+    cache.insert_or_assign(address, 1);
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(cache.find(addresses[i]));
+    i = (i + 1) % addresses.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// New devices found while scanning, every insert evicts the least recently used one
+template <typename Cache>
+void BM_InsertEvict(State& state) {
+  const size_t capacity = state.range(0);
+  Cache cache(capacity);
+  auto addresses = MakeAddresses(4 * capacity);
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(cache.insert_or_assign(addresses[i], 1));
+    i = (i + 1) % addresses.size();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_LookUp, LruCache<Address, int>)->Arg(16)->Arg(200)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_LookUp, FixedLruCache<Address, int>)->Arg(16)->Arg(200)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_InsertEvict, LruCache<Address, int>)->Arg(16)->Arg(200)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_InsertEvict, FixedLruCache<Address, int>)->Arg(16)->Arg(200)->Arg(1000);
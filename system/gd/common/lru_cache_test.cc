@@ -81,6 +81,19 @@ TEST(LruCacheTest, try_emplace_test) {
   ASSERT_THAT(cache, ElementsAre(Pair(42, 420), Pair(2, 20)));
 }
 
+TEST(LruCacheTest, peek_test) {
+  LruCache<int, int> cache(2);
+  cache.insert_or_assign(1, 10);
+  cache.insert_or_assign(2, 20);
+  auto iter = cache.peek(1);
+  EXPECT_EQ(iter->second, 10);
+  EXPECT_EQ(cache.peek(3), cache.end());
+  // 1, 10 is still the coldest
+  ASSERT_THAT(cache, ElementsAre(Pair(2, 20), Pair(1, 10)));
+  cache.insert_or_assign(3, 30);
+  ASSERT_THAT(cache, ElementsAre(Pair(3, 30), Pair(2, 20)));
+}
+
 TEST(LruCacheTest, copy_test) {
   LruCache<int, std::shared_ptr<int>> cache(2);
   cache.insert_or_assign(1, std::make_shared<int>(100));
@@ -0,0 +1,77 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+namespace bluetooth {
+namespace common {
+
+// Unbounded lock-free multi-producer single-consumer FIFO queue.
+// push() may be called from any thread; try_pop() and the destructor must only be called from a single consumer
+// thread at a time. T must be default constructible and movable.
+template <typename T>
+class MpscQueue {
+ public:
+  MpscQueue() : head_(new Node()), tail_(head_.load(std::memory_order_relaxed)) {}
+
+  MpscQueue(const MpscQueue&) = delete;
+  MpscQueue& operator=(const MpscQueue&) = delete;
+
+  ~MpscQueue() {
+    while (tail_ != nullptr) {
+      Node* next = tail_->next.load(std::memory_order_acquire);
+      delete tail_;
+      tail_ = next;
+    }
+  }
+
+  void push(T data) {
+    Node* node = new Node(std::move(data));
+    Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+  }
+
+  // Returns false if the queue is empty, or if the oldest producer has not finished linking its element yet. In the
+  // latter case the element becomes visible as soon as that producer returns from push().
+  bool try_pop(T* data) {
+    Node* next = tail_->next.load(std::memory_order_acquire);
+    if (next == nullptr) {
+      return false;
+    }
+    *data = std::move(next->data);
+    delete tail_;
+    tail_ = next;
+    return true;
+  }
+
+ private:
+  struct Node {
+    Node() = default;
+    explicit Node(T data) : data(std::move(data)) {}
+    T data;
+    std::atomic<Node*> next{nullptr};
+  };
+
+  // Producers swap themselves in at the head, the consumer pops from the tail, which is always a drained stub node
+  std::atomic<Node*> head_;
+  Node* tail_;
+};
+
+}  // namespace common
+}  // namespace bluetooth
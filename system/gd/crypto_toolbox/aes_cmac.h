@@ -0,0 +1,44 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <openssl/aes.h>
+
+#include <array>
+#include <cstdint>
+
+/* AES-128 and AES-CMAC of BoringSSL, built once in libbluetooth-crypto-aes and
+ * shared by the GD and the legacy stack crypto toolboxes. Keys, messages and
+ * outputs are in the little endian byte order of the Bluetooth specification.
+ */
+
+namespace bluetooth {
+namespace crypto {
+
+using Octet16 = std::array<uint8_t, 16>;
+
+/* Key schedule of |key|, for the callers encrypting many messages with the same key.
+ * AES_128(key, message) is aes_128(aes_128_key_schedule(key), message). */
+using Aes128KeySchedule = AES_KEY;
+
+Aes128KeySchedule aes_128_key_schedule(const Octet16& key);
+Octet16 aes_128(const Aes128KeySchedule& key_schedule, const Octet16& message);
+Octet16 aes_128(const Octet16& key, const Octet16& message);
+Octet16 aes_cmac(const Octet16& key, const uint8_t* message, uint16_t length);
+
+}  // namespace crypto
+}  // namespace bluetooth
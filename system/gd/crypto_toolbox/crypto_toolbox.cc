@@ -20,8 +20,6 @@
 
 #include <algorithm>
 
-#include "crypto_toolbox/aes.h"
-
 namespace bluetooth {
 namespace crypto_toolbox {
 
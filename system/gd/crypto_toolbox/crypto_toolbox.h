@@ -20,6 +20,8 @@
 #include <cstdint>
 #include <cstring>
 
+#include "crypto_toolbox/aes_cmac.h"
+
 namespace bluetooth {
 namespace crypto_toolbox {
 
@@ -37,8 +39,8 @@ Octet16 c1(
     const uint8_t* ra);
 Octet16 s1(const Octet16& k, const Octet16& r1, const Octet16& r2);
 
-extern Octet16 aes_128(const Octet16& key, const Octet16& message);
-extern Octet16 aes_cmac(const Octet16& key, const uint8_t* message, uint16_t length);
+using crypto::aes_128;
+using crypto::aes_cmac;
 extern Octet16 f4(uint8_t* u, uint8_t* v, const Octet16& x, uint8_t z);
 extern void f5(
     uint8_t* w, const Octet16& n1, const Octet16& n2, uint8_t* a1, uint8_t* a2, Octet16* mac_key, Octet16* ltk);
@@ -20,10 +20,9 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <vector>
 
-#include "crypto_toolbox/aes.h"
-
 namespace bluetooth {
 namespace crypto_toolbox {
 
@@ -36,12 +35,15 @@ TEST(CryptoToolboxTest, bt_spec_test_d_1_test) {
   uint8_t aes_cmac_k_m[] = {
       0x7d, 0xf7, 0x6b, 0x0c, 0x1a, 0xb8, 0x99, 0xb3, 0x3e, 0x42, 0xf0, 0x47, 0xb9, 0x1b, 0x54, 0x6f};
 
-  uint8_t output[16];
-  aes_context ctx;
-  aes_set_key(k, sizeof(k), &ctx);
-  aes_encrypt(m, output, &ctx); /* outputs in byte 48 to byte 63 */
+  /* The vector is big endian, aes_128() works on little endian blocks */
+  Octet16 key;
+  Octet16 message;
+  std::reverse_copy(k, k + OCTET16_LEN, key.begin());
+  std::reverse_copy(m, m + OCTET16_LEN, message.begin());
+  Octet16 output = aes_128(key, message);
+  std::reverse(output.begin(), output.end());
 
-  EXPECT_TRUE(memcmp(output, aes_cmac_k_m, OCTET16_LEN) == 0);
+  EXPECT_TRUE(memcmp(output.data(), aes_cmac_k_m, OCTET16_LEN) == 0);
 
   // useful for debugging
   // LOG(INFO) << "k " << base::HexEncode(k, OCTET16_LEN);
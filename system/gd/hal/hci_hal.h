@@ -16,9 +16,11 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "module.h"
+#include "packet/scatter_gather_list.h"
 
 namespace bluetooth {
 namespace hal {
@@ -51,6 +53,25 @@ class HciHalCallbacks {
   // Send an ISO data packet from the controller to the host
   // @param data the ISO HCI packet to be passed to the host stack
   virtual void isoDataReceived(HciPacket data) = 0;
+
+  // Zero-copy variants for HALs that receive into pooled buffers (see hal/hci_packet_pool.h). The buffer may be shared
+  // with the snoop logger and is recycled once the last reference is dropped, so it must not be modified. The default
+  // implementations copy into an HciPacket for callbacks that don't care.
+  virtual void hciEventBufferReceived(std::shared_ptr<HciPacket> event) {
+    hciEventReceived(*event);
+  }
+
+  virtual void aclDataBufferReceived(std::shared_ptr<HciPacket> data) {
+    aclDataReceived(*data);
+  }
+
+  virtual void scoDataBufferReceived(std::shared_ptr<HciPacket> data) {
+    scoDataReceived(*data);
+  }
+
+  virtual void isoDataBufferReceived(std::shared_ptr<HciPacket> data) {
+    isoDataReceived(*data);
+  }
 };
 
 // Mirrors hardware/interfaces/bluetooth/1.0/IBluetoothHci.hal in Android
@@ -88,6 +109,20 @@ class HciHal : public ::bluetooth::Module {
   // Packets must be processed in order.
   virtual void sendAclData(HciPacket data) = 0;
 
+  // Send several HCI ACL data packets, in order. Transports that can hand them to the controller in a single write
+  // should override this, by default they are sent one at a time.
+  virtual void sendAclDataBatch(std::vector<HciPacket> packets) {
+    for (auto& packet : packets) {
+      sendAclData(std::move(packet));
+    }
+  }
+
+  // Send an HCI ACL data packet serialized as a scatter-gather list. The list can reference memory owned by the
+  // builder it came from, so it must be consumed before returning. By default it is flattened into an HciPacket.
+  virtual void sendAclDataFragments(const packet::ScatterGatherList& data) {
+    sendAclData(data.Flatten());
+  }
+
   // Send an SCO data packet (as specified in the Bluetooth Specification
   // V4.2, Vol 2, Part 5, Section 5.4.3) to the Bluetooth controller.
   // Packets must be processed in order.
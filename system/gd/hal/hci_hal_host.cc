@@ -21,14 +21,17 @@
 #include <poll.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <chrono>
 #include <csignal>
 #include <mutex>
-#include <queue>
 
 #include "hal/hci_hal.h"
+#include "hal/hci_outgoing_queue.h"
+#include "hal/hci_packet_pool.h"
 #include "hal/snoop_logger.h"
 #include "metrics/counter_metrics.h"
 #include "os/log.h"
@@ -50,6 +53,12 @@ constexpr uint8_t kHciScoHeaderSize = 3;
 constexpr uint8_t kHciEvtHeaderSize = 2;
 constexpr uint8_t kHciIsoHeaderSize = 4;
 constexpr int kBufSize = 1024 + 4 + 1;  // DeviceProperties::acl_data_packet_size_ + ACL header + H4 header
+// Enough idle receive buffers to absorb the packets queued between the HAL thread and the HCI layer
+constexpr size_t kMaxFreeReceiveBuffers = 32;
+// Upper bound on the packets read per reactor wakeup, so a busy socket can't starve the HAL thread's other work
+constexpr size_t kMaxPacketsPerWakeup = 8;
+// Upper bound on the queued outgoing packets written per reactor wakeup
+constexpr size_t kMaxPacketsPerWrite = 16;
 
 constexpr uint8_t BTPROTO_HCI = 1;
 constexpr uint16_t HCI_CHANNEL_USER = 1;
@@ -243,6 +252,17 @@ class HciHalHost : public HciHal {
     write_to_fd(packet);
   }
 
+  void sendAclDataBatch(std::vector<HciPacket> packets) override {
+    std::lock_guard<std::mutex> lock(api_mutex_);
+    ASSERT(sock_fd_ != INVALID_FD);
+    for (auto& data : packets) {
+      std::vector<uint8_t> packet = std::move(data);
+      btsnoop_logger_->Capture(packet, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::ACL);
+      packet.insert(packet.cbegin(), kH4Acl);
+      write_to_fd(std::move(packet));
+    }
+  }
+
   void sendScoData(HciPacket data) override {
     std::lock_guard<std::mutex> lock(api_mutex_);
     ASSERT(sock_fd_ != INVALID_FD);
@@ -312,13 +332,19 @@ class HciHalHost : public HciHal {
   bluetooth::os::Thread hci_incoming_thread_ =
       bluetooth::os::Thread("hci_incoming_thread", bluetooth::os::Thread::Priority::NORMAL);
   bluetooth::os::Reactor::Reactable* reactable_ = nullptr;
-  std::queue<std::vector<uint8_t>> hci_outgoing_queue_;
+  HciOutgoingQueue hci_outgoing_queue_{kMaxPacketsPerWrite};
   SnoopLogger* btsnoop_logger_ = nullptr;
+  std::shared_ptr<HciPacketPool> packet_pool_ =
+      HciPacketPool::Create(kBufSize - kH4HeaderSize, kMaxFreeReceiveBuffers);
+  // recvmmsg() slots of incoming_packet_received(), a null buffer marks a slot to refill
+  std::unique_ptr<HciPacket> receive_buffers_[kMaxPacketsPerWakeup];
+  uint8_t receive_h4_types_[kMaxPacketsPerWakeup] = {};
+  struct iovec receive_iovs_[kMaxPacketsPerWakeup][2] = {};
+  struct mmsghdr receive_messages_[kMaxPacketsPerWakeup] = {};
 
   void write_to_fd(HciPacket packet) {
     // TODO: replace this with new queue when it's ready
-    hci_outgoing_queue_.emplace(packet);
-    if (hci_outgoing_queue_.size() == 1) {
+    if (hci_outgoing_queue_.Enqueue(std::move(packet))) {
       hci_incoming_thread_.GetReactor()->ModifyRegistration(
           reactable_,
           common::Bind(&HciHalHost::incoming_packet_received, common::Unretained(this)),
@@ -328,13 +354,8 @@ class HciHalHost : public HciHal {
 
   void send_packet_ready() {
     std::lock_guard<std::mutex> lock(this->api_mutex_);
-    auto packet_to_send = this->hci_outgoing_queue_.front();
-    auto bytes_written = write(this->sock_fd_, (void*)packet_to_send.data(), packet_to_send.size());
-    this->hci_outgoing_queue_.pop();
-    if (bytes_written == -1) {
-      abort();
-    }
-    if (hci_outgoing_queue_.empty()) {
+    // The user channel takes one HCI packet per write, drain what the socket accepts without blocking
+    if (hci_outgoing_queue_.Send(this->sock_fd_)) {
       this->hci_incoming_thread_.GetReactor()->ModifyRegistration(
           this->reactable_,
           common::Bind(&HciHalHost::incoming_packet_received, common::Unretained(this)),
@@ -350,21 +371,43 @@ class HciHalHost : public HciHal {
         return;
       }
     }
-    uint8_t buf[kBufSize] = {};
-
-    ssize_t received_size;
-    RUN_NO_INTR(received_size = read(sock_fd_, buf, kBufSize));
-    ASSERT_LOG(received_size != -1, "Can't receive from socket: %s", strerror(errno));
-    if (received_size == 0) {
-      LOG_WARN("Can't read H4 header. EOF received");
-      raise(SIGINT);
-      return;
+    // Drain up to kMaxPacketsPerWakeup packets with a single recvmmsg(). The H4 type of each packet is read separately
+    // so the HCI packet lands directly in a pooled buffer that is handed upward as is. The receive slots are kept
+    // across wakeups, and only the ones whose buffer went upward get a new one.
+    for (size_t i = 0; i < kMaxPacketsPerWakeup; i++) {
+      if (receive_buffers_[i] == nullptr) {
+        receive_buffers_[i] = packet_pool_->Acquire();
+        receive_iovs_[i][0] = {&receive_h4_types_[i], kH4HeaderSize};
+        receive_iovs_[i][1] = {receive_buffers_[i]->data(), receive_buffers_[i]->size()};
+        receive_messages_[i].msg_hdr.msg_iov = receive_iovs_[i];
+        receive_messages_[i].msg_hdr.msg_iovlen = 2;
+      }
     }
 
-    if (buf[0] == kH4Event) {
+    int received_count;
+    RUN_NO_INTR(received_count = recvmmsg(sock_fd_, receive_messages_, kMaxPacketsPerWakeup, MSG_DONTWAIT, nullptr));
+    ASSERT_LOG(
+        received_count != -1 || errno == EAGAIN || errno == EWOULDBLOCK,
+        "Can't receive from socket: %s",
+        strerror(errno));
+    for (int i = 0; i < received_count; i++) {
+      if (receive_messages_[i].msg_len == 0) {
+        LOG_WARN("Can't read H4 header. EOF received");
+        raise(SIGINT);
+        return;
+      }
+      handle_incoming_packet(receive_h4_types_[i], std::move(receive_buffers_[i]), receive_messages_[i].msg_len);
+    }
+  }
+
+  void handle_incoming_packet(uint8_t h4_type, std::unique_ptr<HciPacket> buffer, ssize_t received_size) {
+    buffer->resize(received_size - kH4HeaderSize);
+    const HciPacket& packet = *buffer;
+
+    if (h4_type == kH4Event) {
       ASSERT_LOG(
           received_size >= kH4HeaderSize + kHciEvtHeaderSize, "Received bad HCI_EVT packet size: %zu", received_size);
-      uint8_t hci_evt_parameter_total_length = buf[2];
+      uint8_t hci_evt_parameter_total_length = packet[1];
       ssize_t payload_size = received_size - (kH4HeaderSize + kHciEvtHeaderSize);
       ASSERT_LOG(
           payload_size == hci_evt_parameter_total_length,
@@ -372,24 +415,22 @@ class HciHalHost : public HciHal {
           payload_size,
           hci_evt_parameter_total_length);
 
-      HciPacket receivedHciPacket;
-      receivedHciPacket.assign(buf + kH4HeaderSize, buf + kH4HeaderSize + kHciEvtHeaderSize + payload_size);
-      btsnoop_logger_->Capture(receivedHciPacket, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::EVT);
+      btsnoop_logger_->Capture(packet, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::EVT);
       {
         std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
         if (incoming_packet_callback_ == nullptr) {
           LOG_INFO("Dropping an event after processing");
           return;
         }
-        incoming_packet_callback_->hciEventReceived(receivedHciPacket);
+        incoming_packet_callback_->hciEventBufferReceived(packet_pool_->Share(std::move(buffer)));
       }
     }
 
-    if (buf[0] == kH4Acl) {
+    if (h4_type == kH4Acl) {
       ASSERT_LOG(
           received_size >= kH4HeaderSize + kHciAclHeaderSize, "Received bad HCI_ACL packet size: %zu", received_size);
       int payload_size = received_size - (kH4HeaderSize + kHciAclHeaderSize);
-      uint16_t hci_acl_data_total_length = (buf[4] << 8) + buf[3];
+      uint16_t hci_acl_data_total_length = (packet[3] << 8) + packet[2];
       ASSERT_LOG(
           payload_size == hci_acl_data_total_length,
           "malformed ACL length received: %d != %d",
@@ -397,67 +438,60 @@ class HciHalHost : public HciHal {
           hci_acl_data_total_length);
       ASSERT_LOG(hci_acl_data_total_length <= kBufSize - kH4HeaderSize - kHciAclHeaderSize, "packet too long");
 
-      HciPacket receivedHciPacket;
-      receivedHciPacket.assign(buf + kH4HeaderSize, buf + kH4HeaderSize + kHciAclHeaderSize + payload_size);
-      btsnoop_logger_->Capture(receivedHciPacket, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::ACL);
+      btsnoop_logger_->Capture(packet, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::ACL);
       {
         std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
         if (incoming_packet_callback_ == nullptr) {
           LOG_INFO("Dropping an ACL packet after processing");
           return;
         }
-        incoming_packet_callback_->aclDataReceived(receivedHciPacket);
+        incoming_packet_callback_->aclDataBufferReceived(packet_pool_->Share(std::move(buffer)));
       }
     }
 
-    if (buf[0] == kH4Sco) {
+    if (h4_type == kH4Sco) {
       ASSERT_LOG(
           received_size >= kH4HeaderSize + kHciScoHeaderSize, "Received bad HCI_SCO packet size: %zu", received_size);
       int payload_size = received_size - (kH4HeaderSize + kHciScoHeaderSize);
-      uint8_t hci_sco_data_total_length = buf[3];
+      uint8_t hci_sco_data_total_length = packet[2];
       ASSERT_LOG(
           payload_size == hci_sco_data_total_length,
           "malformed SCO length received: %d != %d",
           payload_size,
           hci_sco_data_total_length);
 
-      HciPacket receivedHciPacket;
-      receivedHciPacket.assign(buf + kH4HeaderSize, buf + kH4HeaderSize + kHciScoHeaderSize + payload_size);
-      btsnoop_logger_->Capture(receivedHciPacket, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::SCO);
+      btsnoop_logger_->Capture(packet, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::SCO);
       {
         std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
         if (incoming_packet_callback_ == nullptr) {
           LOG_INFO("Dropping a SCO packet after processing");
           return;
         }
-        incoming_packet_callback_->scoDataReceived(receivedHciPacket);
+        incoming_packet_callback_->scoDataBufferReceived(packet_pool_->Share(std::move(buffer)));
       }
     }
 
-    if (buf[0] == kH4Iso) {
+    if (h4_type == kH4Iso) {
       ASSERT_LOG(
           received_size >= kH4HeaderSize + kHciIsoHeaderSize, "Received bad HCI_ISO packet size: %zu", received_size);
       int payload_size = received_size - (kH4HeaderSize + kHciIsoHeaderSize);
-      uint16_t hci_iso_data_total_length = ((buf[4] & 0x3f) << 8) + buf[3];
+      uint16_t hci_iso_data_total_length = ((packet[3] & 0x3f) << 8) + packet[2];
       ASSERT_LOG(
           payload_size == hci_iso_data_total_length,
           "malformed ISO length received: %d != %d",
           payload_size,
           hci_iso_data_total_length);
 
-      HciPacket receivedHciPacket;
-      receivedHciPacket.assign(buf + kH4HeaderSize, buf + kH4HeaderSize + kHciIsoHeaderSize + payload_size);
-      btsnoop_logger_->Capture(receivedHciPacket, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::ISO);
+      btsnoop_logger_->Capture(packet, SnoopLogger::Direction::INCOMING, SnoopLogger::PacketType::ISO);
       {
         std::lock_guard<std::mutex> incoming_packet_callback_lock(incoming_packet_callback_mutex_);
         if (incoming_packet_callback_ == nullptr) {
           LOG_INFO("Dropping a ISO packet after processing");
           return;
         }
-        incoming_packet_callback_->isoDataReceived(receivedHciPacket);
+        incoming_packet_callback_->isoDataBufferReceived(packet_pool_->Share(std::move(buffer)));
       }
     }
-    memset(buf, 0, kBufSize);
   }
 };
 
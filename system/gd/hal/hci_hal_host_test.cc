@@ -399,6 +399,25 @@ TEST_F(HciHalRootcanalTest, send_multiple_acl_batch) {
   }
 }
 
+TEST_F(HciHalRootcanalTest, send_acl_data_batch) {
+  uint8_t acl_payload_size = 200;
+  int num_packets = 100;
+  std::vector<HciPacket> acl_packets;
+  for (int i = 0; i < num_packets; i++) {
+    HciPacket acl_packet = make_sample_hci_acl_pkt(acl_payload_size);
+    acl_packet.back() = static_cast<uint8_t>(i);
+    acl_packets.push_back(acl_packet);
+  }
+  hal_->sendAclDataBatch(acl_packets);
+  H4Packet read_buf(1 + 2 + 2 + acl_payload_size);
+  SetFakeServerSocketToBlocking();
+  for (int i = 0; i < num_packets; i++) {
+    auto size_read = read_with_retry(fake_server_socket_, read_buf.data(), read_buf.size());
+    ASSERT_EQ(size_read, 1 + acl_packets[i].size());
+    check_packet_equal({kH4Acl, acl_packets[i]}, read_buf);
+  }
+}
+
 TEST_F(HciHalRootcanalTest, send_multiple_acl_sequential) {
   uint8_t acl_payload_size = 200;
   int num_packets = 1000;
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/hci_outgoing_queue.h"
+
+#include <sys/socket.h>
+#include <sys/types.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include "os/log.h"
+#include "os/utils.h"
+
+namespace bluetooth {
+namespace hal {
+
+HciOutgoingQueue::HciOutgoingQueue(size_t max_packets_per_send) : max_packets_per_send_(max_packets_per_send) {}
+
+bool HciOutgoingQueue::Enqueue(HciPacket h4_packet) {
+  packets_.emplace_back(std::move(h4_packet));
+  return packets_.size() == 1;
+}
+
+bool HciOutgoingQueue::Send(int fd) {
+  for (size_t i = 0; i < max_packets_per_send_ && !packets_.empty(); i++) {
+    const HciPacket& packet = packets_.front();
+    ssize_t bytes_written;
+    RUN_NO_INTR(bytes_written = send(fd, packet.data(), packet.size(), MSG_DONTWAIT));
+    if (bytes_written == -1) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        break;
+      }
+      LOG_ERROR("Can't write to HCI socket: %s", strerror(errno));
+      abort();
+    }
+    packets_.pop_front();
+  }
+  return packets_.empty();
+}
+
+}  // namespace hal
+}  // namespace bluetooth
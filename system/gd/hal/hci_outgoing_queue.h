@@ -0,0 +1,53 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <deque>
+
+#include "hal/hci_hal.h"
+
+namespace bluetooth {
+namespace hal {
+
+// H4 packets waiting for a message oriented HCI socket to become writable. Every packet goes out in its own write(),
+// since that is what delimits HCI packets on such a socket; only the writability wakeup is shared by a batch.
+// Not thread safe.
+class HciOutgoingQueue {
+ public:
+  // |max_packets_per_send| bounds the packets written by one Send(), so a long batch can't starve the HAL thread
+  explicit HciOutgoingQueue(size_t max_packets_per_send);
+
+  // Queue |h4_packet|. Returns true if the queue was empty, in which case the caller has to start waiting for the
+  // socket to become writable
+  bool Enqueue(HciPacket h4_packet);
+
+  // Write the queued packets to |fd| until it would block or max_packets_per_send packets are written. Returns true
+  // once the queue is empty, in which case the caller can stop waiting for the socket to become writable
+  bool Send(int fd);
+
+  size_t size() const {
+    return packets_.size();
+  }
+
+ private:
+  const size_t max_packets_per_send_;
+  std::deque<HciPacket> packets_;
+};
+
+}  // namespace hal
+}  // namespace bluetooth
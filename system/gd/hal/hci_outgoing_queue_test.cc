@@ -0,0 +1,131 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/hci_outgoing_queue.h"
+
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <vector>
+
+namespace bluetooth {
+namespace hal {
+namespace {
+
+constexpr size_t kMaxPacketsPerSend = 4;
+
+// The HCI user channel is message oriented, a SOCK_SEQPACKET socket pair keeps the packet boundaries the same way
+class HciOutgoingQueueTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    int fds[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_SEQPACKET, 0, fds), 0);
+    hal_fd_ = fds[0];
+    controller_fd_ = fds[1];
+  }
+
+  void TearDown() override {
+    close(hal_fd_);
+    close(controller_fd_);
+  }
+
+  // The next packet received by the controller, empty if there is none
+  HciPacket ReceivePacket() {
+    HciPacket packet(2048);
+    ssize_t received = recv(controller_fd_, packet.data(), packet.size(), MSG_DONTWAIT);
+    packet.resize(received < 0 ? 0 : received);
+    return packet;
+  }
+
+  static HciPacket MakePacket(uint8_t tag, size_t size) {
+    HciPacket packet(size, tag);
+    packet[0] = 0x02;  // H4 ACL
+    return packet;
+  }
+
+  HciOutgoingQueue queue_{kMaxPacketsPerSend};
+  int hal_fd_ = -1;
+  int controller_fd_ = -1;
+};
+
+TEST_F(HciOutgoingQueueTest, only_the_first_packet_asks_for_a_wakeup) {
+  EXPECT_TRUE(queue_.Enqueue(MakePacket(1, 10)));
+  EXPECT_FALSE(queue_.Enqueue(MakePacket(2, 10)));
+  EXPECT_TRUE(queue_.Send(hal_fd_));
+  EXPECT_TRUE(queue_.Enqueue(MakePacket(3, 10)));
+}
+
+TEST_F(HciOutgoingQueueTest, batch_keeps_packet_boundaries) {
+  std::vector<HciPacket> sent;
+  for (uint8_t i = 0; i < kMaxPacketsPerSend; i++) {
+    sent.push_back(MakePacket(i, 5 + 100 * i));
+    queue_.Enqueue(sent.back());
+  }
+  EXPECT_TRUE(queue_.Send(hal_fd_));
+
+  for (const auto& packet : sent) {
+    EXPECT_EQ(ReceivePacket(), packet);
+  }
+  EXPECT_TRUE(ReceivePacket().empty());
+}
+
+TEST_F(HciOutgoingQueueTest, send_is_bounded_per_wakeup) {
+  std::vector<HciPacket> sent;
+  for (uint8_t i = 0; i < 2 * kMaxPacketsPerSend + 1; i++) {
+    sent.push_back(MakePacket(i, 20 + i));
+    queue_.Enqueue(sent.back());
+  }
+  EXPECT_FALSE(queue_.Send(hal_fd_));
+  EXPECT_EQ(queue_.size(), kMaxPacketsPerSend + 1);
+  EXPECT_FALSE(queue_.Send(hal_fd_));
+  EXPECT_TRUE(queue_.Send(hal_fd_));
+
+  for (const auto& packet : sent) {
+    EXPECT_EQ(ReceivePacket(), packet);
+  }
+  EXPECT_TRUE(ReceivePacket().empty());
+}
+
+TEST_F(HciOutgoingQueueTest, full_socket_keeps_the_rest_queued) {
+  int send_buffer_size = 4096;
+  ASSERT_EQ(setsockopt(hal_fd_, SOL_SOCKET, SO_SNDBUF, &send_buffer_size, sizeof(send_buffer_size)), 0);
+  HciOutgoingQueue queue(1000);
+  std::vector<HciPacket> sent;
+  for (int i = 0; i < 100; i++) {
+    sent.push_back(MakePacket(i, 1021));
+    queue.Enqueue(sent.back());
+  }
+
+  size_t received = 0;
+  while (!queue.Send(hal_fd_)) {
+    ASSERT_GT(queue.size(), 0u);
+    // The controller reads whatever made it through, one whole packet at a time
+    for (HciPacket packet = ReceivePacket(); !packet.empty(); packet = ReceivePacket()) {
+      ASSERT_LT(received, sent.size());
+      EXPECT_EQ(packet, sent[received++]);
+    }
+  }
+  for (HciPacket packet = ReceivePacket(); !packet.empty(); packet = ReceivePacket()) {
+    ASSERT_LT(received, sent.size());
+    EXPECT_EQ(packet, sent[received++]);
+  }
+  EXPECT_EQ(received, sent.size());
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace bluetooth
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/hci_packet_pool.h"
+
+namespace bluetooth {
+namespace hal {
+
+std::shared_ptr<HciPacketPool> HciPacketPool::Create(size_t buffer_size, size_t max_free_buffers) {
+  return std::shared_ptr<HciPacketPool>(new HciPacketPool(buffer_size, max_free_buffers));
+}
+
+HciPacketPool::HciPacketPool(size_t buffer_size, size_t max_free_buffers)
+    : buffer_size_(buffer_size), max_free_buffers_(max_free_buffers) {
+  free_buffers_.reserve(max_free_buffers_);
+  for (size_t i = 0; i < max_free_buffers_; i++) {
+    free_buffers_.push_back(std::make_unique<HciPacket>(buffer_size_));
+  }
+}
+
+std::unique_ptr<HciPacket> HciPacketPool::Acquire() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!free_buffers_.empty()) {
+      auto buffer = std::move(free_buffers_.back());
+      free_buffers_.pop_back();
+      return buffer;
+    }
+  }
+  return std::make_unique<HciPacket>(buffer_size_);
+}
+
+std::shared_ptr<HciPacket> HciPacketPool::Share(std::unique_ptr<HciPacket> buffer) {
+  std::weak_ptr<HciPacketPool> weak_pool = weak_from_this();
+  return std::shared_ptr<HciPacket>(buffer.release(), [weak_pool](HciPacket* released) {
+    std::unique_ptr<HciPacket> owned(released);
+    if (auto pool = weak_pool.lock()) {
+      pool->Release(std::move(owned));
+    }
+  });
+}
+
+size_t HciPacketPool::GetFreeBufferCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return free_buffers_.size();
+}
+
+void HciPacketPool::Release(std::unique_ptr<HciPacket> buffer) {
+  // Someone may have grown the buffer past the slab size, don't keep oversized buffers around
+  if (buffer->capacity() > buffer_size_ * 2) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (free_buffers_.size() < max_free_buffers_) {
+    // Shrinking a buffer to the received length is free, growing it back fills the tail once here
+    buffer->resize(buffer_size_);
+    free_buffers_.push_back(std::move(buffer));
+  }
+}
+
+}  // namespace hal
+}  // namespace bluetooth
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "hal/hci_hal.h"
+
+namespace bluetooth {
+namespace hal {
+
+// A slab of reusable receive buffers for HALs reading packets from a socket. Buffers handed out by Share() go back to
+// the pool when the last reference is dropped, which is usually when the last PacketView of the packet goes away.
+// The pool may be destroyed while buffers are still in flight; those are then simply freed.
+// Buffers are sized to buffer_size() when the pool allocates them and when they come back, so a HAL can receive into
+// them directly and only has to shrink them to the received length.
+class HciPacketPool : public std::enable_shared_from_this<HciPacketPool> {
+ public:
+  // |buffer_size| is the size of every buffer, |max_free_buffers| idle buffers are allocated upfront and kept at most
+  static std::shared_ptr<HciPacketPool> Create(size_t buffer_size, size_t max_free_buffers);
+
+  HciPacketPool(const HciPacketPool&) = delete;
+  HciPacketPool& operator=(const HciPacketPool&) = delete;
+
+  // Get a buffer of buffer_size() bytes, with unspecified contents
+  std::unique_ptr<HciPacket> Acquire();
+
+  // Give up exclusive ownership of |buffer| and get a shared handle that returns it to this pool when released
+  std::shared_ptr<HciPacket> Share(std::unique_ptr<HciPacket> buffer);
+
+  // Hand back a buffer from Acquire() that was never shared
+  void Release(std::unique_ptr<HciPacket> buffer);
+
+  size_t buffer_size() const {
+    return buffer_size_;
+  }
+
+  size_t GetFreeBufferCount() const;
+
+ private:
+  HciPacketPool(size_t buffer_size, size_t max_free_buffers);
+
+  const size_t buffer_size_;
+  const size_t max_free_buffers_;
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<HciPacket>> free_buffers_;
+};
+
+}  // namespace hal
+}  // namespace bluetooth
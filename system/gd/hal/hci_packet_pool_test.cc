@@ -0,0 +1,91 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/hci_packet_pool.h"
+
+#include <gtest/gtest.h>
+
+namespace bluetooth {
+namespace hal {
+namespace {
+
+constexpr size_t kBufferSize = 64;
+constexpr size_t kMaxFreeBuffers = 2;
+
+TEST(HciPacketPoolTest, buffers_are_allocated_upfront) {
+  auto pool = HciPacketPool::Create(kBufferSize, kMaxFreeBuffers);
+  EXPECT_EQ(pool->GetFreeBufferCount(), kMaxFreeBuffers);
+  for (size_t i = 0; i < kMaxFreeBuffers + 1; i++) {
+    auto buffer = pool->Acquire();
+    ASSERT_NE(buffer, nullptr);
+    EXPECT_EQ(buffer->size(), kBufferSize);
+    pool->Share(std::move(buffer)).reset();
+  }
+}
+
+TEST(HciPacketPoolTest, shared_buffer_returns_to_pool) {
+  auto pool = HciPacketPool::Create(kBufferSize, kMaxFreeBuffers);
+  auto buffer = pool->Acquire();
+  HciPacket* raw = buffer.get();
+  // Received packets are shrunk to their length before going upward
+  buffer->resize(3);
+  auto shared = pool->Share(std::move(buffer));
+  auto other_reference = shared;
+  EXPECT_EQ(pool->GetFreeBufferCount(), kMaxFreeBuffers - 1);
+  shared.reset();
+  EXPECT_EQ(pool->GetFreeBufferCount(), kMaxFreeBuffers - 1);
+  other_reference.reset();
+  EXPECT_EQ(pool->GetFreeBufferCount(), kMaxFreeBuffers);
+
+  auto reused = pool->Acquire();
+  EXPECT_EQ(reused.get(), raw);
+  EXPECT_EQ(reused->size(), kBufferSize);
+}
+
+TEST(HciPacketPoolTest, unshared_buffer_returns_to_pool) {
+  auto pool = HciPacketPool::Create(kBufferSize, kMaxFreeBuffers);
+  auto buffer = pool->Acquire();
+  HciPacket* raw = buffer.get();
+  pool->Release(std::move(buffer));
+  EXPECT_EQ(pool->GetFreeBufferCount(), kMaxFreeBuffers);
+
+  auto reused = pool->Acquire();
+  EXPECT_EQ(reused.get(), raw);
+  EXPECT_EQ(reused->size(), kBufferSize);
+}
+
+TEST(HciPacketPoolTest, free_buffers_are_capped) {
+  auto pool = HciPacketPool::Create(kBufferSize, kMaxFreeBuffers);
+  std::vector<std::shared_ptr<HciPacket>> shared;
+  for (size_t i = 0; i < kMaxFreeBuffers + 2; i++) {
+    shared.push_back(pool->Share(pool->Acquire()));
+  }
+  shared.clear();
+  EXPECT_EQ(pool->GetFreeBufferCount(), kMaxFreeBuffers);
+}
+
+TEST(HciPacketPoolTest, buffer_outlives_pool) {
+  auto pool = HciPacketPool::Create(kBufferSize, kMaxFreeBuffers);
+  auto shared = pool->Share(pool->Acquire());
+  shared->at(0) = 0x42;
+  pool.reset();
+  EXPECT_EQ(shared->at(0), 0x42);
+  shared.reset();
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace bluetooth
@@ -0,0 +1,136 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/mapped_snoop_log_file.h"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+#include "hal/snoop_logger.h"
+#include "os/log.h"
+#include "os/utils.h"
+
+namespace bluetooth {
+namespace hal {
+
+std::unique_ptr<MappedSnoopLogFile> MappedSnoopLogFile::Create(
+    const std::string& path, size_t capacity, const void* file_header, size_t file_header_size) {
+  ASSERT(capacity > file_header_size);
+  int fd;
+  RUN_NO_INTR(fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0666));
+  if (fd == -1) {
+    LOG_ERROR("Unable to open snoop log at \"%s\", error: \"%s\"", path.c_str(), strerror(errno));
+    return nullptr;
+  }
+  // Reserve the blocks up front so that writing through the mapping can't fail with SIGBUS on a full disk
+  int result;
+  RUN_NO_INTR(result = fallocate(fd, 0, 0, capacity));
+  if (result == -1) {
+    LOG_WARN("fallocate failed for \"%s\", error: \"%s\", falling back to ftruncate", path.c_str(), strerror(errno));
+    RUN_NO_INTR(result = ftruncate(fd, capacity));
+    if (result == -1) {
+      LOG_ERROR("Unable to size snoop log \"%s\", error: \"%s\"", path.c_str(), strerror(errno));
+      close(fd);
+      return nullptr;
+    }
+  }
+  void* mapping = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (mapping == MAP_FAILED) {
+    LOG_ERROR("Unable to map snoop log \"%s\", error: \"%s\"", path.c_str(), strerror(errno));
+    close(fd);
+    return nullptr;
+  }
+  std::unique_ptr<MappedSnoopLogFile> file(new MappedSnoopLogFile(fd, static_cast<uint8_t*>(mapping), capacity));
+  std::memcpy(file->mapping_, file_header, file_header_size);
+  file->size_ = file_header_size;
+  return file;
+}
+
+MappedSnoopLogFile::MappedSnoopLogFile(int fd, uint8_t* mapping, size_t capacity)
+    : fd_(fd), mapping_(mapping), capacity_(capacity) {}
+
+MappedSnoopLogFile::~MappedSnoopLogFile() {
+  munmap(mapping_, capacity_);
+  int result;
+  RUN_NO_INTR(result = ftruncate(fd_, size_));
+  if (result == -1) {
+    LOG_ERROR("Unable to truncate snoop log, error: \"%s\"", strerror(errno));
+  }
+  close(fd_);
+}
+
+bool MappedSnoopLogFile::Append(const void* header, size_t header_size, const uint8_t* payload, size_t payload_size) {
+  if (size_ + header_size + payload_size > capacity_) {
+    return false;
+  }
+  std::memcpy(mapping_ + size_ + header_size, payload, payload_size);
+  std::atomic_thread_fence(std::memory_order_release);
+  std::memcpy(mapping_ + size_, header, header_size);
+  size_ += header_size + payload_size;
+  return true;
+}
+
+size_t MappedSnoopLogFile::RecoverSnoopLogFile(const std::string& path) {
+  int fd;
+  RUN_NO_INTR(fd = open(path.c_str(), O_RDWR | O_CLOEXEC));
+  if (fd == -1) {
+    return 0;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) == -1 || static_cast<size_t>(file_stat.st_size) < sizeof(SnoopLogger::FileHeaderType)) {
+    close(fd);
+    return 0;
+  }
+  size_t file_size = file_stat.st_size;
+  void* mapping = mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+  if (mapping == MAP_FAILED) {
+    close(fd);
+    return 0;
+  }
+  const uint8_t* data = static_cast<const uint8_t*>(mapping);
+  size_t offset = sizeof(SnoopLogger::FileHeaderType);
+  while (offset + sizeof(SnoopLogger::PacketHeaderType) <= file_size) {
+    SnoopLogger::PacketHeaderType header;
+    std::memcpy(&header, data + offset, sizeof(header));
+    // length_captured includes the type byte, which is part of the packet header
+    uint32_t length_captured = ntohl(header.length_captured);
+    if (length_captured == 0 || offset + sizeof(header) + length_captured - 1 > file_size) {
+      break;
+    }
+    offset += sizeof(header) + length_captured - 1;
+  }
+  munmap(mapping, file_size);
+  if (offset != file_size) {
+    LOG_INFO("Recovered snoop log \"%s\", truncating from %zu to %zu bytes", path.c_str(), file_size, offset);
+    int result;
+    RUN_NO_INTR(result = ftruncate(fd, offset));
+    if (result == -1) {
+      LOG_ERROR("Unable to truncate snoop log \"%s\", error: \"%s\"", path.c_str(), strerror(errno));
+    }
+  }
+  close(fd);
+  return offset;
+}
+
+}  // namespace hal
+}  // namespace bluetooth
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace bluetooth {
+namespace hal {
+
+// A btsnoop log file preallocated to a fixed size and written through a shared memory mapping, so appending a record
+// is a memcpy instead of a syscall. A record's payload is copied before its header, so a record whose header is
+// visible is always complete; after a crash, RecoverSnoopLogFile() cuts the file at the first missing header.
+class MappedSnoopLogFile {
+ public:
+  // Create |path|, preallocate |capacity| bytes and write |file_header|. Returns nullptr on failure.
+  static std::unique_ptr<MappedSnoopLogFile> Create(
+      const std::string& path, size_t capacity, const void* file_header, size_t file_header_size);
+
+  MappedSnoopLogFile(const MappedSnoopLogFile&) = delete;
+  MappedSnoopLogFile& operator=(const MappedSnoopLogFile&) = delete;
+
+  // Unmap and truncate the file to the records actually written
+  ~MappedSnoopLogFile();
+
+  // Append one record. Returns false without writing anything if it does not fit, the caller should rotate.
+  bool Append(const void* header, size_t header_size, const uint8_t* payload, size_t payload_size);
+
+  size_t GetSize() const {
+    return size_;
+  }
+
+  // Truncate a btsnoop log left behind by a writer that did not shut down cleanly to its last complete record.
+  // Returns the resulting file size, or 0 if the file could not be opened or is too short to be a btsnoop log.
+  static size_t RecoverSnoopLogFile(const std::string& path);
+
+ private:
+  MappedSnoopLogFile(int fd, uint8_t* mapping, size_t capacity);
+
+  const int fd_;
+  uint8_t* const mapping_;
+  const size_t capacity_;
+  size_t size_ = 0;
+};
+
+}  // namespace hal
+}  // namespace bluetooth
@@ -0,0 +1,118 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/mapped_snoop_log_file.h"
+
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "hal/snoop_logger.h"
+
+namespace bluetooth {
+namespace hal {
+namespace {
+
+constexpr size_t kCapacity = 256;
+
+const SnoopLogger::FileHeaderType kFileHeader = {
+    .identification_pattern = {'b', 't', 's', 'n', 'o', 'o', 'p', 0x00},
+    .version_number = 0,
+    .datalink_type = 0};
+
+SnoopLogger::PacketHeaderType MakeHeader(const std::vector<uint8_t>& payload) {
+  uint32_t length = htonl(payload.size() + /* type byte */ 1);
+  return {.length_original = length,
+          .length_captured = length,
+          .flags = 0,
+          .dropped_packets = 0,
+          .timestamp = 0,
+          .type = SnoopLogger::PacketType::CMD};
+}
+
+class MappedSnoopLogFileTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    path_ = std::filesystem::temp_directory_path() / "btsnoop_mapped_test.log";
+    std::filesystem::remove(path_);
+  }
+
+  void TearDown() override {
+    std::filesystem::remove(path_);
+  }
+
+  std::filesystem::path path_;
+  std::vector<uint8_t> payload_ = {0x01, 0x02, 0x03, 0x04};
+};
+
+TEST_F(MappedSnoopLogFileTest, file_is_preallocated_then_truncated) {
+  {
+    auto file = MappedSnoopLogFile::Create(path_.string(), kCapacity, &kFileHeader, sizeof(kFileHeader));
+    ASSERT_NE(file, nullptr);
+    EXPECT_EQ(std::filesystem::file_size(path_), kCapacity);
+    auto header = MakeHeader(payload_);
+    ASSERT_TRUE(file->Append(&header, sizeof(header), payload_.data(), payload_.size()));
+    EXPECT_EQ(file->GetSize(), sizeof(kFileHeader) + sizeof(header) + payload_.size());
+  }
+  EXPECT_EQ(
+      std::filesystem::file_size(path_),
+      sizeof(kFileHeader) + sizeof(SnoopLogger::PacketHeaderType) + payload_.size());
+}
+
+TEST_F(MappedSnoopLogFileTest, append_fails_when_full) {
+  auto file = MappedSnoopLogFile::Create(path_.string(), kCapacity, &kFileHeader, sizeof(kFileHeader));
+  ASSERT_NE(file, nullptr);
+  auto header = MakeHeader(payload_);
+  size_t record_size = sizeof(header) + payload_.size();
+  size_t expected_records = (kCapacity - sizeof(kFileHeader)) / record_size;
+  for (size_t i = 0; i < expected_records; i++) {
+    ASSERT_TRUE(file->Append(&header, sizeof(header), payload_.data(), payload_.size()));
+  }
+  EXPECT_FALSE(file->Append(&header, sizeof(header), payload_.data(), payload_.size()));
+  EXPECT_EQ(file->GetSize(), sizeof(kFileHeader) + expected_records * record_size);
+}
+
+TEST_F(MappedSnoopLogFileTest, recover_drops_preallocated_tail_and_partial_record) {
+  auto header = MakeHeader(payload_);
+  {
+    std::ofstream out(path_, std::ios::binary);
+    out.write(reinterpret_cast<const char*>(&kFileHeader), sizeof(kFileHeader));
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(payload_.data()), payload_.size());
+    // A record whose header made it but not all of its payload, as left by a truncated write
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(payload_.data()), 1);
+  }
+  size_t expected_size = sizeof(kFileHeader) + sizeof(header) + payload_.size();
+  EXPECT_EQ(MappedSnoopLogFile::RecoverSnoopLogFile(path_.string()), expected_size);
+  EXPECT_EQ(std::filesystem::file_size(path_), expected_size);
+
+  // Zero filled preallocated space left by a crashed mapped writer
+  std::filesystem::resize_file(path_, kCapacity);
+  EXPECT_EQ(MappedSnoopLogFile::RecoverSnoopLogFile(path_.string()), expected_size);
+  EXPECT_EQ(std::filesystem::file_size(path_), expected_size);
+}
+
+TEST_F(MappedSnoopLogFileTest, recover_missing_file) {
+  EXPECT_EQ(MappedSnoopLogFile::RecoverSnoopLogFile(path_.string()), 0u);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace bluetooth
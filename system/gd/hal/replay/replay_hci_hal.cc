@@ -0,0 +1,316 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/replay/replay_hci_hal.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <thread>
+
+#include "hci/hci_packets.h"
+#include "os/log.h"
+
+namespace bluetooth {
+namespace hal {
+namespace replay {
+
+namespace {
+
+constexpr uint8_t kBtSnoopIdentification[] = {'b', 't', 's', 'n', 'o', 'o', 'p', '\0'};
+constexpr uint32_t kBtSnoopVersion = 1;
+// HCI UART (H4), the packets start with their type
+constexpr uint32_t kBtSnoopDatalinkH4 = 1002;
+constexpr size_t kFileHeaderSize = 16;
+constexpr size_t kRecordHeaderSize = 24;
+
+constexpr uint8_t kCommandCompleteCode = 0x0e;
+constexpr uint8_t kCommandStatusCode = 0x0f;
+constexpr uint8_t kNumberOfCompletedPacketsCode = 0x13;
+constexpr size_t kMaxEventParametersSize = 255;
+
+// Commands answered with a Command Status, their outcome coming in a later event
+constexpr hci::OpCode kStatusOpCodes[] = {
+    hci::OpCode::INQUIRY,
+    hci::OpCode::CREATE_CONNECTION,
+    hci::OpCode::DISCONNECT,
+    hci::OpCode::ACCEPT_CONNECTION_REQUEST,
+    hci::OpCode::REJECT_CONNECTION_REQUEST,
+    hci::OpCode::AUTHENTICATION_REQUESTED,
+    hci::OpCode::SET_CONNECTION_ENCRYPTION,
+    hci::OpCode::CHANGE_CONNECTION_LINK_KEY,
+    hci::OpCode::CENTRAL_LINK_KEY,
+    hci::OpCode::REMOTE_NAME_REQUEST,
+    hci::OpCode::READ_REMOTE_SUPPORTED_FEATURES,
+    hci::OpCode::READ_REMOTE_EXTENDED_FEATURES,
+    hci::OpCode::READ_REMOTE_VERSION_INFORMATION,
+    hci::OpCode::READ_CLOCK_OFFSET,
+    hci::OpCode::SETUP_SYNCHRONOUS_CONNECTION,
+    hci::OpCode::ACCEPT_SYNCHRONOUS_CONNECTION,
+    hci::OpCode::REJECT_SYNCHRONOUS_CONNECTION,
+    hci::OpCode::ENHANCED_SETUP_SYNCHRONOUS_CONNECTION,
+    hci::OpCode::ENHANCED_ACCEPT_SYNCHRONOUS_CONNECTION,
+    hci::OpCode::HOLD_MODE,
+    hci::OpCode::SNIFF_MODE,
+    hci::OpCode::EXIT_SNIFF_MODE,
+    hci::OpCode::QOS_SETUP,
+    hci::OpCode::SWITCH_ROLE,
+    hci::OpCode::FLOW_SPECIFICATION,
+    hci::OpCode::LE_CREATE_CONNECTION,
+    hci::OpCode::LE_CONNECTION_UPDATE,
+    hci::OpCode::LE_READ_REMOTE_FEATURES,
+    hci::OpCode::LE_READ_LOCAL_P_256_PUBLIC_KEY_COMMAND,
+    hci::OpCode::LE_GENERATE_DHKEY_COMMAND_V1,
+    hci::OpCode::LE_SET_PHY,
+    hci::OpCode::LE_EXTENDED_CREATE_CONNECTION,
+    hci::OpCode::LE_PERIODIC_ADVERTISING_CREATE_SYNC,
+    hci::OpCode::LE_GENERATE_DHKEY_COMMAND,
+    hci::OpCode::LE_CREATE_CIS,
+    hci::OpCode::LE_CREATE_BIG,
+    hci::OpCode::LE_TERMINATE_BIG,
+    hci::OpCode::LE_BIG_CREATE_SYNC,
+    hci::OpCode::LE_REQUEST_PEER_SCA,
+    hci::OpCode::LE_READ_REMOTE_TRANSMIT_POWER_LEVEL,
+};
+
+uint32_t read_be32(const uint8_t* p) {
+  return (uint32_t{p[0]} << 24) | (uint32_t{p[1]} << 16) | (uint32_t{p[2]} << 8) | p[3];
+}
+
+uint64_t read_be64(const uint8_t* p) {
+  return (uint64_t{read_be32(p)} << 32) | read_be32(p + 4);
+}
+
+bool uses_command_status(uint16_t opcode) {
+  return std::any_of(std::begin(kStatusOpCodes), std::end(kStatusOpCodes), [opcode](hci::OpCode status_opcode) {
+    return static_cast<uint16_t>(status_opcode) == opcode;
+  });
+}
+
+}  // namespace
+
+bool ReadSnoopLog(const std::string& path, std::vector<SnoopRecord>* records) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    LOG_ERROR("Unable to open %s", path.c_str());
+    return false;
+  }
+  std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  if (data.size() < kFileHeaderSize ||
+      memcmp(data.data(), kBtSnoopIdentification, sizeof(kBtSnoopIdentification)) != 0 ||
+      read_be32(data.data() + 8) != kBtSnoopVersion || read_be32(data.data() + 12) != kBtSnoopDatalinkH4) {
+    LOG_ERROR("%s is not a btsnoop log of H4 packets", path.c_str());
+    return false;
+  }
+
+  size_t offset = kFileHeaderSize;
+  uint64_t first_timestamp_us = 0;
+  size_t truncated = 0;
+  while (data.size() - offset >= kRecordHeaderSize) {
+    const uint8_t* header = data.data() + offset;
+    uint32_t length_original = read_be32(header);
+    uint32_t length_captured = read_be32(header + 4);
+    uint32_t flags = read_be32(header + 8);
+    uint64_t timestamp_us = read_be64(header + 16);
+    offset += kRecordHeaderSize;
+    if (data.size() - offset < length_captured) {
+      LOG_WARN("Last record of %s cut short", path.c_str());
+      break;
+    }
+    const uint8_t* payload = data.data() + offset;
+    offset += length_captured;
+
+    // The type byte alone is no packet
+    if (length_captured < 2) {
+      continue;
+    }
+    if (length_captured < length_original) {
+      truncated++;
+      continue;
+    }
+    uint8_t type = payload[0];
+    if (type < SnoopLogger::PacketType::CMD || type > SnoopLogger::PacketType::ISO) {
+      continue;
+    }
+    if (records->empty()) {
+      first_timestamp_us = timestamp_us;
+    }
+    records->push_back(SnoopRecord{
+        .timestamp_us = timestamp_us > first_timestamp_us ? timestamp_us - first_timestamp_us : 0,
+        .type = static_cast<SnoopLogger::PacketType>(type),
+        .received = (flags & 0x01) != 0,
+        .packet = HciPacket(payload + 1, payload + length_captured),
+    });
+  }
+  if (truncated != 0) {
+    LOG_WARN("Left out %zu truncated records of %s", truncated, path.c_str());
+  }
+  return true;
+}
+
+ReplayHciHal::ReplayHciHal(std::vector<SnoopRecord> records) {
+  for (auto& record : records) {
+    if (!record.received) {
+      continue;
+    }
+    if (record.type == SnoopLogger::PacketType::EVT && !record.packet.empty()) {
+      uint8_t code = record.packet[0];
+      // The credits of the commands and the ACL packets are given back as the stack sends them
+      if (code == kCommandCompleteCode && record.packet.size() >= 5) {
+        uint16_t opcode = record.packet[3] | (record.packet[4] << 8);
+        record.packet[2] = 1;
+        if (opcode != 0) {
+          responses_[opcode].push_back(std::move(record.packet));
+        }
+        continue;
+      }
+      if (code == kCommandStatusCode && record.packet.size() >= 6) {
+        uint16_t opcode = record.packet[4] | (record.packet[5] << 8);
+        record.packet[3] = 1;
+        if (opcode != 0) {
+          responses_[opcode].push_back(std::move(record.packet));
+        }
+        continue;
+      }
+      if (code == kNumberOfCompletedPacketsCode) {
+        continue;
+      }
+    }
+    records_.push_back(std::move(record));
+  }
+}
+
+void ReplayHciHal::registerIncomingPacketCallback(HciHalCallbacks* callbacks) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ASSERT(callbacks_ == nullptr && callbacks != nullptr);
+  callbacks_ = callbacks;
+}
+
+void ReplayHciHal::unregisterIncomingPacketCallback() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  callbacks_ = nullptr;
+}
+
+void ReplayHciHal::sendHciCommand(HciPacket command) {
+  if (command.size() < 3) {
+    LOG_WARN("Dropping a command of %zu bytes", command.size());
+    return;
+  }
+  answer_command(std::move(command));
+}
+
+void ReplayHciHal::answer_command(HciPacket command) {
+  uint16_t opcode = command[0] | (command[1] << 8);
+  std::lock_guard<std::mutex> lock(mutex_);
+  HciPacket event;
+  auto responses = responses_.find(opcode);
+  if (responses != responses_.end() && !responses->second.empty()) {
+    event = std::move(responses->second.front());
+    responses->second.pop_front();
+    stats_.commands_answered++;
+  } else if (uses_command_status(opcode)) {
+    event = {kCommandStatusCode, 4, /* status */ 0, /* num_hci_command_packets */ 1, command[0], command[1]};
+    stats_.commands_synthesized++;
+  } else {
+    // Zeroed return parameters as long as any, so that the view of the complete is valid whatever the command
+    event.resize(2 + kMaxEventParametersSize);
+    event[0] = kCommandCompleteCode;
+    event[1] = kMaxEventParametersSize;
+    event[2] = /* num_hci_command_packets */ 1;
+    event[3] = command[0];
+    event[4] = command[1];
+    stats_.commands_synthesized++;
+  }
+  if (callbacks_ != nullptr) {
+    callbacks_->hciEventReceived(std::move(event));
+  }
+}
+
+void ReplayHciHal::sendAclData(HciPacket packet) {
+  if (packet.size() < 2) {
+    LOG_WARN("Dropping an ACL packet of %zu bytes", packet.size());
+    return;
+  }
+  complete_acl((packet[0] | (packet[1] << 8)) & 0x0fff);
+}
+
+void ReplayHciHal::complete_acl(uint16_t handle) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_.acl_sent++;
+  if (callbacks_ != nullptr) {
+    callbacks_->hciEventReceived({kNumberOfCompletedPacketsCode,
+                                  5,
+                                  /* num_handles */ 1,
+                                  static_cast<uint8_t>(handle),
+                                  static_cast<uint8_t>(handle >> 8),
+                                  /* num_completed_packets */ 1,
+                                  0});
+  }
+}
+
+void ReplayHciHal::Replay(double speed) {
+  LOG_INFO("Replaying %zu packets at speed %.1f", records_.size(), speed);
+  auto begin = std::chrono::steady_clock::now();
+  for (const auto& record : records_) {
+    if (speed > 0) {
+      std::this_thread::sleep_until(
+          begin + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                      std::chrono::duration<double, std::micro>(record.timestamp_us / speed)));
+    }
+    inject(record);
+  }
+  auto replay_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_.replay_us = replay_us.count();
+}
+
+void ReplayHciHal::inject(const SnoopRecord& record) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (callbacks_ == nullptr) {
+    return;
+  }
+  switch (record.type) {
+    case SnoopLogger::PacketType::EVT:
+      stats_.events_injected++;
+      callbacks_->hciEventReceived(record.packet);
+      break;
+    case SnoopLogger::PacketType::ACL:
+      stats_.acl_injected++;
+      callbacks_->aclDataReceived(record.packet);
+      break;
+    case SnoopLogger::PacketType::SCO:
+      stats_.sco_injected++;
+      callbacks_->scoDataReceived(record.packet);
+      break;
+    case SnoopLogger::PacketType::ISO:
+      stats_.iso_injected++;
+      callbacks_->isoDataReceived(record.packet);
+      break;
+    case SnoopLogger::PacketType::CMD:
+      break;
+  }
+}
+
+ReplayHciHal::Stats ReplayHciHal::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+}  // namespace replay
+}  // namespace hal
+}  // namespace bluetooth
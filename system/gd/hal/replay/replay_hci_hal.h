@@ -0,0 +1,112 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "hal/hci_hal.h"
+#include "hal/snoop_logger.h"
+
+namespace bluetooth {
+namespace hal {
+namespace replay {
+
+// One complete packet of a btsnoop log
+struct SnoopRecord {
+  // Microseconds since the start of the log
+  uint64_t timestamp_us;
+  SnoopLogger::PacketType type;
+  // Sent by the controller
+  bool received;
+  HciPacket packet;
+};
+
+// Read the packets of a btsnoop log written with the H4 datalink type, as SnoopLogger does. The records that were
+// truncated, e.g. by the filtered mode, are left out. Returns false if |path| is not such a log; the records read
+// before a record cut short by the end of the file are kept.
+bool ReadSnoopLog(const std::string& path, std::vector<SnoopRecord>* records);
+
+// An HciHal playing the controller side of a btsnoop log to the stack, to reproduce and profile its load offline.
+//
+// The stack does not send the commands of the log, so the controller packets answering the host are not replayed as
+// is: each command of the stack is answered with the next Command Complete or Command Status the log has for its
+// opcode, or a successful one with zeroed return parameters when the log has none left, and each ACL packet it sends
+// is completed right away. All the other events and the ACL, SCO and ISO data of the controller are injected by
+// Replay(), at the pace of the log.
+class ReplayHciHal : public HciHal {
+ public:
+  struct Stats {
+    uint64_t events_injected;
+    uint64_t acl_injected;
+    uint64_t sco_injected;
+    uint64_t iso_injected;
+    uint64_t commands_answered;
+    // Commands the log had no Command Complete or Command Status left for
+    uint64_t commands_synthesized;
+    uint64_t acl_sent;
+    // Time Replay() took
+    uint64_t replay_us;
+  };
+
+  explicit ReplayHciHal(std::vector<SnoopRecord> records);
+
+  void registerIncomingPacketCallback(HciHalCallbacks* callbacks) override;
+  void unregisterIncomingPacketCallback() override;
+
+  void sendHciCommand(HciPacket command) override;
+  void sendAclData(HciPacket packet) override;
+  void sendScoData(HciPacket packet) override {}
+  void sendIsoData(HciPacket packet) override {}
+
+  // Inject the controller packets of the log from the calling thread, returning once they all were. A |speed| of 1
+  // keeps the timing of the log, 2 plays it twice as fast and so on; 0 injects the packets back to back.
+  void Replay(double speed);
+
+  Stats GetStats() const;
+
+  std::string ToString() const override {
+    return "ReplayHciHal";
+  }
+
+ protected:
+  void ListDependencies(ModuleList* list) const override {}
+  void Start() override {}
+  void Stop() override {}
+
+ private:
+  void answer_command(HciPacket command);
+  void complete_acl(uint16_t handle);
+  void inject(const SnoopRecord& record);
+
+  // Records injected by Replay()
+  std::vector<SnoopRecord> records_;
+  // Command Complete and Command Status events of the log for each opcode, oldest first
+  std::map<uint16_t, std::deque<HciPacket>> responses_;
+
+  mutable std::mutex mutex_;
+  HciHalCallbacks* callbacks_ = nullptr;
+  Stats stats_ = {};
+};
+
+}  // namespace replay
+}  // namespace hal
+}  // namespace bluetooth
@@ -0,0 +1,203 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/replay/replay_hci_hal.h"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace bluetooth {
+namespace hal {
+namespace replay {
+namespace {
+
+// Commands of the stack, and controller packets of the log
+const HciPacket kResetCommand = {0x03, 0x0c, 0x00};
+const HciPacket kLeCreateConnectionCommand = {0x0d, 0x20, 0x00};
+const HciPacket kReadBdAddrCommand = {0x09, 0x10, 0x00};
+const HciPacket kResetComplete = {0x0e, 0x04, 0x05, 0x03, 0x0c, 0x00};
+const HciPacket kNumberOfCompletedPackets = {0x13, 0x05, 0x01, 0x40, 0x00, 0x01, 0x00};
+const HciPacket kLeAdvertisingReport = {0x3e, 0x02, 0x02, 0x00};
+const HciPacket kAclData = {0x40, 0x20, 0x01, 0x00, 0xaa};
+
+class TestCallbacks : public HciHalCallbacks {
+ public:
+  void hciEventReceived(HciPacket event) override {
+    events_.push_back(std::move(event));
+  }
+  void aclDataReceived(HciPacket data) override {
+    acl_.push_back(std::move(data));
+  }
+  void scoDataReceived(HciPacket data) override {}
+  void isoDataReceived(HciPacket data) override {}
+
+  std::vector<HciPacket> events_;
+  std::vector<HciPacket> acl_;
+};
+
+class ReplayHciHalTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    path_ = std::filesystem::temp_directory_path() / "btsnoop_replay_test.log";
+    out_.open(path_, std::ios::binary);
+    const uint8_t file_header[] = {'b', 't', 's', 'n', 'o', 'o', 'p', 0x00, 0, 0, 0, 1, 0, 0, 0x03, 0xea};
+    out_.write(reinterpret_cast<const char*>(file_header), sizeof(file_header));
+  }
+
+  void TearDown() override {
+    std::filesystem::remove(path_);
+  }
+
+  void WriteBe(uint64_t value, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+      out_.put(static_cast<char>(value >> (8 * (size - 1 - i))));
+    }
+  }
+
+  void WriteRecord(
+      SnoopLogger::PacketType type, bool received, uint64_t timestamp_us, const HciPacket& packet, bool cut = false) {
+    uint32_t length = packet.size() + 1;
+    WriteBe(length + (cut ? 1 : 0), 4);
+    WriteBe(length, 4);
+    WriteBe((received ? 0x01 : 0x00) | (type == SnoopLogger::CMD || type == SnoopLogger::EVT ? 0x02 : 0x00), 4);
+    WriteBe(0, 4);
+    WriteBe(timestamp_us, 8);
+    out_.put(static_cast<char>(type));
+    out_.write(reinterpret_cast<const char*>(packet.data()), packet.size());
+  }
+
+  std::vector<SnoopRecord> WriteLog() {
+    WriteRecord(SnoopLogger::CMD, false, 1000, kResetCommand);
+    WriteRecord(SnoopLogger::EVT, true, 1100, kResetComplete);
+    WriteRecord(SnoopLogger::EVT, true, 1200, kLeAdvertisingReport);
+    WriteRecord(SnoopLogger::ACL, true, 1300, kAclData);
+    WriteRecord(SnoopLogger::EVT, true, 1400, kNumberOfCompletedPackets);
+    // Filtered out of the log
+    WriteRecord(SnoopLogger::ACL, true, 1500, kAclData, /* cut */ true);
+    out_.close();
+    std::vector<SnoopRecord> records;
+    EXPECT_TRUE(ReadSnoopLog(path_.string(), &records));
+    return records;
+  }
+
+  std::filesystem::path path_;
+  std::ofstream out_;
+};
+
+TEST_F(ReplayHciHalTest, read_snoop_log) {
+  auto records = WriteLog();
+  ASSERT_EQ(records.size(), 5u);
+  EXPECT_EQ(records[0].type, SnoopLogger::CMD);
+  EXPECT_FALSE(records[0].received);
+  EXPECT_EQ(records[0].timestamp_us, 0u);
+  EXPECT_EQ(records[0].packet, kResetCommand);
+  EXPECT_EQ(records[3].type, SnoopLogger::ACL);
+  EXPECT_TRUE(records[3].received);
+  EXPECT_EQ(records[3].timestamp_us, 300u);
+  EXPECT_EQ(records[3].packet, kAclData);
+}
+
+TEST_F(ReplayHciHalTest, read_not_a_snoop_log) {
+  out_.close();
+  std::filesystem::resize_file(path_, 8);
+  std::vector<SnoopRecord> records;
+  EXPECT_FALSE(ReadSnoopLog(path_.string(), &records));
+}
+
+TEST_F(ReplayHciHalTest, commands_answered_from_the_log) {
+  ReplayHciHal hal(WriteLog());
+  TestCallbacks callbacks;
+  hal.registerIncomingPacketCallback(&callbacks);
+
+  hal.sendHciCommand(kResetCommand);
+  ASSERT_EQ(callbacks.events_.size(), 1u);
+  // The credits of the log are replaced by a single one
+  HciPacket expected = kResetComplete;
+  expected[2] = 1;
+  EXPECT_EQ(callbacks.events_[0], expected);
+
+  // No response left in the log
+  hal.sendHciCommand(kResetCommand);
+  hal.sendHciCommand(kLeCreateConnectionCommand);
+  ASSERT_EQ(callbacks.events_.size(), 3u);
+  EXPECT_EQ(callbacks.events_[1][0], 0x0e);
+  EXPECT_EQ(callbacks.events_[1].size(), 257u);
+  EXPECT_EQ(callbacks.events_[2], HciPacket({0x0f, 0x04, 0x00, 0x01, 0x0d, 0x20}));
+
+  hal.sendHciCommand(kReadBdAddrCommand);
+  ASSERT_EQ(callbacks.events_.size(), 4u);
+  EXPECT_EQ(callbacks.events_[3][3], 0x09);
+  EXPECT_EQ(callbacks.events_[3][4], 0x10);
+
+  auto stats = hal.GetStats();
+  EXPECT_EQ(stats.commands_answered, 1u);
+  EXPECT_EQ(stats.commands_synthesized, 3u);
+  hal.unregisterIncomingPacketCallback();
+}
+
+TEST_F(ReplayHciHalTest, acl_of_the_stack_completed) {
+  ReplayHciHal hal(WriteLog());
+  TestCallbacks callbacks;
+  hal.registerIncomingPacketCallback(&callbacks);
+
+  hal.sendAclData({0x41, 0x20, 0x01, 0x00, 0xbb});
+  ASSERT_EQ(callbacks.events_.size(), 1u);
+  EXPECT_EQ(callbacks.events_[0], HciPacket({0x13, 0x05, 0x01, 0x41, 0x00, 0x01, 0x00}));
+  EXPECT_EQ(hal.GetStats().acl_sent, 1u);
+  hal.unregisterIncomingPacketCallback();
+}
+
+TEST_F(ReplayHciHalTest, replay_controller_packets) {
+  ReplayHciHal hal(WriteLog());
+  TestCallbacks callbacks;
+  hal.registerIncomingPacketCallback(&callbacks);
+
+  hal.Replay(0);
+  // Neither the commands, their completion nor the completed packets of the log are replayed
+  ASSERT_EQ(callbacks.events_.size(), 1u);
+  EXPECT_EQ(callbacks.events_[0], kLeAdvertisingReport);
+  ASSERT_EQ(callbacks.acl_.size(), 1u);
+  EXPECT_EQ(callbacks.acl_[0], kAclData);
+
+  auto stats = hal.GetStats();
+  EXPECT_EQ(stats.events_injected, 1u);
+  EXPECT_EQ(stats.acl_injected, 1u);
+  hal.unregisterIncomingPacketCallback();
+}
+
+TEST_F(ReplayHciHalTest, replay_keeps_the_timing) {
+  std::vector<SnoopRecord> records;
+  records.push_back(SnoopRecord{
+      .timestamp_us = 0, .type = SnoopLogger::EVT, .received = true, .packet = kLeAdvertisingReport});
+  records.push_back(SnoopRecord{
+      .timestamp_us = 20000, .type = SnoopLogger::EVT, .received = true, .packet = kLeAdvertisingReport});
+  ReplayHciHal hal(std::move(records));
+  TestCallbacks callbacks;
+  hal.registerIncomingPacketCallback(&callbacks);
+
+  hal.Replay(2);
+  EXPECT_EQ(callbacks.events_.size(), 2u);
+  EXPECT_GE(hal.GetStats().replay_us, 10000u);
+  hal.unregisterIncomingPacketCallback();
+}
+
+}  // namespace
+}  // namespace replay
+}  // namespace hal
+}  // namespace bluetooth
@@ -0,0 +1,176 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "hal/hci_hal.h"
+#include "hal/replay/replay_hci_hal.h"
+#include "hci/acl_manager.h"
+#include "hci/le_advertising_manager.h"
+#include "hci/le_scanning_manager.h"
+#include "l2cap/classic/l2cap_classic_module.h"
+#include "l2cap/le/l2cap_le_module.h"
+#include "module.h"
+#include "os/log.h"
+#include "os/parameter_provider.h"
+#include "os/task_profiler.h"
+
+using ::bluetooth::ModuleList;
+using ::bluetooth::TestModuleRegistry;
+using ::bluetooth::hal::replay::ReadSnoopLog;
+using ::bluetooth::hal::replay::ReplayHciHal;
+using ::bluetooth::hal::replay::SnoopRecord;
+using ::bluetooth::os::TaskProfiler;
+
+// Every allocation of the process goes through here, so that the allocations of each module are counted. This does
+// not work with the sanitizers replacing operator new, the binary is built without them.
+void* operator new(size_t size) {
+  TaskProfiler::CountAllocation();
+  void* p = malloc(size == 0 ? 1 : size);
+  if (p == nullptr) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void operator delete(void* p) noexcept {
+  free(p);
+}
+
+namespace {
+
+// Time given to the stack to handle the last packets injected
+constexpr std::chrono::milliseconds kDrainTimeout = std::chrono::seconds(10);
+
+void print_usage(const char* name) {
+  fprintf(
+      stderr,
+      "Usage: %s --btsnoop=<path> [--speed=<factor>] [--btconfig=<path>]\n"
+      "  Replays the controller packets of a btsnoop log through the stack and reports the CPU time and the\n"
+      "  allocations of each module. A speed of 1 keeps the timing of the log, 0 replays it as fast as possible.\n",
+      name);
+}
+
+void print_report(const ReplayHciHal::Stats& hal_stats) {
+  printf(
+      "Replayed %lu events, %lu ACL, %lu SCO and %lu ISO packets in %.1f ms\n",
+      (unsigned long)hal_stats.events_injected,
+      (unsigned long)hal_stats.acl_injected,
+      (unsigned long)hal_stats.sco_injected,
+      (unsigned long)hal_stats.iso_injected,
+      hal_stats.replay_us / 1000.0);
+  printf(
+      "Answered %lu commands from the log and %lu without, completed %lu ACL packets of the stack\n\n",
+      (unsigned long)hal_stats.commands_answered,
+      (unsigned long)hal_stats.commands_synthesized,
+      (unsigned long)hal_stats.acl_sent);
+
+  auto stats = TaskProfiler::GetStats();
+  std::vector<std::pair<std::string, TaskProfiler::Stats>> modules(stats.begin(), stats.end());
+  std::sort(modules.begin(), modules.end(), [](const auto& a, const auto& b) {
+    return a.second.cpu_ns > b.second.cpu_ns;
+  });
+  TaskProfiler::Stats total;
+  printf("%-32s %10s %12s %10s %12s\n", "module", "tasks", "cpu_ms", "us/task", "allocations");
+  for (const auto& [name, module] : modules) {
+    printf(
+        "%-32s %10lu %12.3f %10.2f %12lu\n",
+        name.c_str(),
+        (unsigned long)module.tasks,
+        module.cpu_ns / 1e6,
+        module.tasks != 0 ? module.cpu_ns / 1e3 / module.tasks : 0.0,
+        (unsigned long)module.allocations);
+    total.tasks += module.tasks;
+    total.cpu_ns += module.cpu_ns;
+    total.allocations += module.allocations;
+  }
+  printf(
+      "%-32s %10lu %12.3f %10s %12lu\n",
+      "total",
+      (unsigned long)total.tasks,
+      total.cpu_ns / 1e6,
+      "",
+      (unsigned long)total.allocations);
+}
+
+}  // namespace
+
+// Replays a btsnoop log through the gd stack, from HCI up to L2CAP, to reproduce and profile its load offline
+int main(int argc, const char** argv) {
+  std::string btsnoop_path;
+  double speed = 1;
+  const std::string arg_btsnoop_path = "--btsnoop=";
+  const std::string arg_speed = "--speed=";
+  const std::string arg_btconfig_path = "--btconfig=";
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg.find(arg_btsnoop_path) == 0) {
+      btsnoop_path = arg.substr(arg_btsnoop_path.size());
+    } else if (arg.find(arg_speed) == 0) {
+      speed = std::stod(arg.substr(arg_speed.size()));
+    } else if (arg.find(arg_btconfig_path) == 0) {
+      ::bluetooth::os::ParameterProvider::OverrideConfigFilePath(arg.substr(arg_btconfig_path.size()));
+    } else {
+      print_usage(argv[0]);
+      return 1;
+    }
+  }
+  if (btsnoop_path.empty() || speed < 0) {
+    print_usage(argv[0]);
+    return 1;
+  }
+
+  std::vector<SnoopRecord> records;
+  if (!ReadSnoopLog(btsnoop_path, &records)) {
+    return 1;
+  }
+
+  // Enabled before the modules start, so that their handlers are named
+  TaskProfiler::SetEnabled(true);
+  auto* hal = new ReplayHciHal(std::move(records));
+  TestModuleRegistry registry;
+  registry.InjectTestModule(&::bluetooth::hal::HciHal::Factory, hal);
+
+  ModuleList modules;
+  modules.add<::bluetooth::hci::LeAdvertisingManager>();
+  modules.add<::bluetooth::hci::LeScanningManager>();
+  modules.add<::bluetooth::l2cap::classic::L2capClassicModule>();
+  modules.add<::bluetooth::l2cap::le::L2capLeModule>();
+  registry.Start(&modules, &registry.GetTestThread());
+  auto* reactor = registry.GetTestThread().GetReactor();
+  if (!reactor->WaitForIdle(kDrainTimeout)) {
+    LOG_WARN("Stack still busy after starting up");
+  }
+  // Only the replay is reported
+  TaskProfiler::Clear();
+
+  hal->Replay(speed);
+  if (!reactor->WaitForIdle(kDrainTimeout)) {
+    LOG_WARN("Stack still busy after the replay, the report is partial");
+  }
+  print_report(hal->GetStats());
+
+  TaskProfiler::SetEnabled(false);
+  registry.StopAll();
+  return 0;
+}
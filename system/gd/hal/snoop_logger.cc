@@ -17,14 +17,15 @@
 #include "hal/snoop_logger.h"
 
 #include <arpa/inet.h>
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
 
 #include <algorithm>
 #include <bitset>
 #include <chrono>
-#include <sstream>
 
-#include "common/circular_buffer.h"
 #include "common/init_flags.h"
 #include "common/strings.h"
 #include "os/fake_timer/fake_timerfd.h"
@@ -32,6 +33,7 @@
 #include "os/log.h"
 #include "os/parameter_provider.h"
 #include "os/system_properties.h"
+#include "os/utils.h"
 
 namespace bluetooth {
 #ifdef USE_FAKE_TIMERS
@@ -76,6 +78,20 @@ constexpr size_t kDefaultBtSnoozMaxBytesPerPacket = 150;
 constexpr size_t kDefaultBtSnoozMaxPayloadBytesPerPacket =
     kDefaultBtSnoozMaxBytesPerPacket - sizeof(SnoopLogger::PacketHeaderType);
 
+// Async write mode: bound memory held by records waiting for the writer thread, and the number of records written
+// per wakeup so the writer thread issues large writev() calls without building unbounded iovec arrays
+constexpr size_t kMaxPendingAsyncRecords = 4096;
+constexpr size_t kMaxAsyncRecordsPerWrite = 256;
+constexpr size_t kMaxIovecsPerWrite = 64;
+
+// Live streaming: bound the memory held for a client that does not keep up, about a second of busy HCI traffic
+constexpr size_t kMaxNetClients = 4;
+constexpr size_t kMaxQueuedBytesPerNetClient = 1024 * 1024;
+// Live streaming clients: adb shell, system and root, on top of the Bluetooth stack itself
+constexpr uid_t kAidRoot = 0;
+constexpr uid_t kAidSystem = 1000;
+constexpr uid_t kAidShell = 2000;
+
 using namespace std::chrono_literals;
 constexpr std::chrono::hours kBtSnoozLogLifeTime = 12h;
 constexpr std::chrono::hours kBtSnoozLogDeleteRepeatingAlarmInterval = 1h;
@@ -202,6 +218,10 @@ const std::string SnoopLogger::kIsDebuggableProperty = "ro.debuggable";
 const std::string SnoopLogger::kBtSnoopLogModeProperty = "persist.bluetooth.btsnooplogmode";
 const std::string SnoopLogger::kBtSnoopDefaultLogModeProperty = "persist.bluetooth.btsnoopdefaultmode";
 const std::string SnoopLogger::kSoCManufacturerProperty = "ro.soc.manufacturer";
+const std::string SnoopLogger::kBtSnoopAsyncWriteProperty = "persist.bluetooth.btsnoopasyncwrite";
+const std::string SnoopLogger::kBtSnoopMappedFileSizeProperty = "persist.bluetooth.btsnoopmappedfilesize";
+const std::string SnoopLogger::kBtSnoopNetProperty = "persist.bluetooth.btsnoopnet";
+const std::string SnoopLogger::kBtSnoopNetSocketName = "bluetooth_btsnoop";
 
 SnoopLogger::SnoopLogger(
     std::string snoop_log_path,
@@ -211,14 +231,20 @@ SnoopLogger::SnoopLogger(
     const std::string& btsnoop_mode,
     bool qualcomm_debug_log_enabled,
     const std::chrono::milliseconds snooz_log_life_time,
-    const std::chrono::milliseconds snooz_log_delete_alarm_interval)
+    const std::chrono::milliseconds snooz_log_delete_alarm_interval,
+    bool async_write_enabled,
+    size_t mapped_file_size,
+    bool net_enabled)
     : snoop_log_path_(std::move(snoop_log_path)),
       snooz_log_path_(std::move(snooz_log_path)),
       max_packets_per_file_(max_packets_per_file),
-      btsnooz_buffer_(max_packets_per_buffer),
+      btsnooz_buffer_(max_packets_per_buffer * kDefaultBtSnoozMaxBytesPerPacket),
       qualcomm_debug_log_enabled_(qualcomm_debug_log_enabled),
       snooz_log_life_time_(snooz_log_life_time),
-      snooz_log_delete_alarm_interval_(snooz_log_delete_alarm_interval) {
+      snooz_log_delete_alarm_interval_(snooz_log_delete_alarm_interval),
+      async_write_enabled_(async_write_enabled || net_enabled),
+      mapped_file_size_(mapped_file_size),
+      net_enabled_(net_enabled) {
   if (false && btsnoop_mode == kBtSnoopLogModeFiltered) {
     // TODO(b/163733538): implement filtered snoop log in GD, currently filtered == disabled
     LOG_INFO("Filtered Snoop Logs enabled");
@@ -250,9 +276,15 @@ SnoopLogger::SnoopLogger(
 
 void SnoopLogger::CloseCurrentSnoopLogFile() {
   std::lock_guard<std::recursive_mutex> lock(file_mutex_);
-  if (btsnoop_ostream_.is_open()) {
-    btsnoop_ostream_.flush();
-    btsnoop_ostream_.close();
+  // Unmapping truncates the preallocated file to the records actually written
+  mapped_snoop_log_file_.reset();
+  if (btsnoop_fd_ != -1) {
+    int close_status;
+    RUN_NO_INTR(close_status = close(btsnoop_fd_));
+    if (close_status == -1) {
+      LOG_ERROR("Failed to close snoop log, error: \"%s\"", strerror(errno));
+    }
+    btsnoop_fd_ = -1;
   }
   packet_counter_ = 0;
 }
@@ -275,20 +307,114 @@ void SnoopLogger::OpenNextSnoopLogFile() {
   }
 
   mode_t prevmask = umask(0);
-  // do not use std::ios::app as we want override the existing file
-  btsnoop_ostream_.open(snoop_log_path_, std::ios::binary | std::ios::out);
+  if (mapped_file_size_ > 0) {
+    mapped_snoop_log_file_ =
+        MappedSnoopLogFile::Create(snoop_log_path_, mapped_file_size_, &kBtSnoopFileHeader, sizeof(FileHeaderType));
+#ifdef USE_FAKE_TIMERS
+    file_creation_time = fake_timerfd_get_clock();
+#endif
+    if (mapped_snoop_log_file_ == nullptr) {
+      LOG_ALWAYS_FATAL("Unable to create mapped snoop log at \"%s\"", snoop_log_path_.c_str());
+    }
+    umask(prevmask);
+    return;
+  }
+  // do not use O_APPEND as we want override the existing file
+  RUN_NO_INTR(btsnoop_fd_ = open(snoop_log_path_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666));
 #ifdef USE_FAKE_TIMERS
   file_creation_time = fake_timerfd_get_clock();
 #endif
-  if (!btsnoop_ostream_.good()) {
+  if (btsnoop_fd_ == -1) {
     LOG_ALWAYS_FATAL("Unable to open snoop log at \"%s\", error: \"%s\"", snoop_log_path_.c_str(), strerror(errno));
   }
   umask(prevmask);
-  if (!btsnoop_ostream_.write(reinterpret_cast<const char*>(&kBtSnoopFileHeader), sizeof(FileHeaderType))) {
+  ssize_t written;
+  RUN_NO_INTR(written = write(btsnoop_fd_, &kBtSnoopFileHeader, sizeof(FileHeaderType)));
+  if (written != sizeof(FileHeaderType)) {
     LOG_ALWAYS_FATAL("Unable to write file header to \"%s\", error: \"%s\"", snoop_log_path_.c_str(), strerror(errno));
   }
-  if (!btsnoop_ostream_.flush()) {
-    LOG_ERROR("Failed to flush, error: \"%s\"", strerror(errno));
+}
+
+void SnoopLogger::AppendMappedSnoopLogRecord(const void* header, const uint8_t* payload, size_t payload_size) {
+  if (mapped_snoop_log_file_->Append(header, sizeof(PacketHeaderType), payload, payload_size)) {
+    return;
+  }
+  OpenNextSnoopLogFile();
+  if (!mapped_snoop_log_file_->Append(header, sizeof(PacketHeaderType), payload, payload_size)) {
+    LOG_ERROR("Packet of %zu bytes does not fit in a mapped snoop log file, dropping it", payload_size);
+  }
+}
+
+void SnoopLogger::WriteSnoopLogRecords(const std::string* records, size_t count) {
+  if (mapped_snoop_log_file_ != nullptr) {
+    for (size_t i = 0; i < count; i++) {
+      auto payload = reinterpret_cast<const uint8_t*>(records[i].data()) + sizeof(PacketHeaderType);
+      AppendMappedSnoopLogRecord(records[i].data(), payload, records[i].size() - sizeof(PacketHeaderType));
+    }
+    return;
+  }
+  struct iovec iov[kMaxIovecsPerWrite];
+  size_t iov_count = 0;
+  size_t iov_bytes = 0;
+  auto flush_iov = [&]() {
+    if (iov_count == 0) {
+      return;
+    }
+    ssize_t written;
+    RUN_NO_INTR(written = writev(btsnoop_fd_, iov, iov_count));
+    if (written != static_cast<ssize_t>(iov_bytes)) {
+      LOG_ERROR("Failed to write %zu packets for btsnoop, error: \"%s\"", iov_count, strerror(errno));
+    }
+    iov_count = 0;
+    iov_bytes = 0;
+  };
+  for (size_t i = 0; i < count; i++) {
+    packet_counter_++;
+    if (packet_counter_ > max_packets_per_file_) {
+      flush_iov();
+      OpenNextSnoopLogFile();
+    }
+    iov[iov_count++] = {const_cast<char*>(records[i].data()), records[i].size()};
+    iov_bytes += records[i].size();
+    if (iov_count == kMaxIovecsPerWrite) {
+      flush_iov();
+    }
+  }
+  flush_iov();
+}
+
+size_t SnoopLogger::WritePendingRecords(size_t max_records) {
+  std::vector<std::string> records;
+  records.reserve(std::min(max_records, pending_record_count_.load()));
+  std::string record;
+  while (records.size() < max_records && pending_records_.try_pop(&record)) {
+    records.push_back(std::move(record));
+  }
+  {
+    std::lock_guard<std::recursive_mutex> lock(file_mutex_);
+    if (btsnoop_fd_ != -1 || mapped_snoop_log_file_ != nullptr) {
+      WriteSnoopLogRecords(records.data(), records.size());
+    }
+  }
+  // Only set while the writer thread runs, which is where this is called from then
+  if (net_server_ != nullptr) {
+    net_server_->Send(records.data(), records.size());
+  }
+  return records.size();
+}
+
+void SnoopLogger::OnPendingRecordsReady() {
+  os::Reactor::Event* writer_event;
+  {
+    // Stop() unregisters this callback before resetting the event, it stays valid until we return
+    std::lock_guard<std::mutex> lock(writer_event_mutex_);
+    writer_event = writer_event_.get();
+  }
+  writer_event->Read();
+  size_t written = WritePendingRecords(kMaxAsyncRecordsPerWrite);
+  // Records left behind, including ones whose producers are still queueing them, need another pass
+  if (pending_record_count_.fetch_sub(written) != written) {
+    writer_event->Notify();
   }
 }
 
@@ -320,43 +446,62 @@ void SnoopLogger::Capture(const HciPacket& packet, Direction direction, PacketTy
                              .dropped_packets = 0,
                              .timestamp = htonll(timestamp_us + kBtSnoopEpochDelta),
                              .type = static_cast<uint8_t>(type)};
-  {
+  if (!is_enabled_) {
+    // btsnoop disabled, log in-memory btsnooz log only
+    size_t included_length = get_btsnooz_packet_length_to_write(packet, type, qualcomm_debug_log_enabled_);
+    header.length_captured = htonl(included_length + /* type byte */ 1);
     std::lock_guard<std::recursive_mutex> lock(file_mutex_);
-    if (!is_enabled_) {
-      // btsnoop disabled, log in-memory btsnooz log only
-      std::stringstream ss;
-      size_t included_length = get_btsnooz_packet_length_to_write(packet, type, qualcomm_debug_log_enabled_);
-      header.length_captured = htonl(included_length + /* type byte */ 1);
-      if (!ss.write(reinterpret_cast<const char*>(&header), sizeof(PacketHeaderType))) {
-        LOG_ERROR("Failed to write packet header for btsnooz, error: \"%s\"", strerror(errno));
-      }
-      if (!ss.write(reinterpret_cast<const char*>(packet.data()), included_length)) {
-        LOG_ERROR("Failed to write packet payload for btsnooz, error: \"%s\"", strerror(errno));
-      }
-      btsnooz_buffer_.Push(ss.str());
+    btsnooz_buffer_.Push(&header, sizeof(PacketHeaderType), packet.data(), included_length);
+    return;
+  }
+  if (!async_write_enabled_) {
+    std::lock_guard<std::recursive_mutex> lock(file_mutex_);
+    if (mapped_snoop_log_file_ != nullptr) {
+      // Records land directly in the page cache, with the same durability as writev() below
+      AppendMappedSnoopLogRecord(&header, packet.data(), packet.size());
       return;
     }
     packet_counter_++;
     if (packet_counter_ > max_packets_per_file_) {
       OpenNextSnoopLogFile();
     }
-    if (!btsnoop_ostream_.write(reinterpret_cast<const char*>(&header), sizeof(PacketHeaderType))) {
-      LOG_ERROR("Failed to write packet header for btsnoop, error: \"%s\"", strerror(errno));
+    // writev() pushes user data into kernel memory. The data will be written even if this process crashes.
+    // However, data will be lost if there is a kernel panic, which is out of scope of BT snoop log.
+    struct iovec iov[] = {{&header, sizeof(PacketHeaderType)}, {const_cast<uint8_t*>(packet.data()), packet.size()}};
+    ssize_t written;
+    RUN_NO_INTR(written = writev(btsnoop_fd_, iov, 2));
+    if (written != static_cast<ssize_t>(sizeof(PacketHeaderType) + packet.size())) {
+      LOG_ERROR("Failed to write packet for btsnoop, error: \"%s\"", strerror(errno));
     }
-    if (!btsnoop_ostream_.write(reinterpret_cast<const char*>(packet.data()), packet.size())) {
-      LOG_ERROR("Failed to write packet payload for btsnoop, error: \"%s\"", strerror(errno));
-    }
-    // std::ofstream::flush() pushes user data into kernel memory. The data will be written even if this process
-    // crashes. However, data will be lost if there is a kernel panic, which is out of scope of BT snoop log.
-    // NOTE: std::ofstream::write() followed by std::ofstream::flush() has similar effect as UNIX write(fd, data, len)
-    //       as write() syscall dumps data into kernel memory directly
-    if (!btsnoop_ostream_.flush()) {
-      LOG_ERROR("Failed to flush, error: \"%s\"", strerror(errno));
+    return;
+  }
+  // btsnoop records carry the cumulative number of packets dropped so far
+  header.dropped_packets = htonl(dropped_packets_.load());
+  size_t pending_before = pending_record_count_.fetch_add(1);
+  if (pending_before >= kMaxPendingAsyncRecords) {
+    pending_record_count_.fetch_sub(1);
+    dropped_packets_++;
+    return;
+  }
+  std::string record;
+  record.reserve(sizeof(PacketHeaderType) + packet.size());
+  record.append(reinterpret_cast<const char*>(&header), sizeof(PacketHeaderType));
+  record.append(reinterpret_cast<const char*>(packet.data()), packet.size());
+  pending_records_.push(std::move(record));
+  if (pending_before == 0) {
+    // Stop() may be tearing the writer down at the same time
+    std::lock_guard<std::mutex> lock(writer_event_mutex_);
+    if (writer_event_ != nullptr) {
+      writer_event_->Notify();
     }
   }
 }
 
-void SnoopLogger::DumpSnoozLogToFile(const std::vector<std::string>& data) const {
+uint32_t SnoopLogger::GetDroppedPacketCount() const {
+  return dropped_packets_.load();
+}
+
+void SnoopLogger::DumpSnoozLogToFile() const {
   std::lock_guard<std::recursive_mutex> lock(file_mutex_);
   if (is_enabled_) {
     LOG_DEBUG("btsnoop log is enabled, skip dumping btsnooz log");
@@ -386,11 +531,11 @@ void SnoopLogger::DumpSnoozLogToFile(const std::vector<std::string>& data) const
   if (!btsnooz_ostream.write(reinterpret_cast<const char*>(&kBtSnoopFileHeader), sizeof(FileHeaderType))) {
     LOG_ALWAYS_FATAL("Unable to write file header to \"%s\", error: \"%s\"", snooz_log_path_.c_str(), strerror(errno));
   }
-  for (const auto& packet : data) {
-    if (!btsnooz_ostream.write(packet.data(), packet.size())) {
+  btsnooz_buffer_.ForEachSpan([&btsnooz_ostream](const uint8_t* data, size_t size) {
+    if (!btsnooz_ostream.write(reinterpret_cast<const char*>(data), size)) {
       LOG_ERROR("Failed to write packet payload for btsnooz, error: \"%s\"", strerror(errno));
     }
-  }
+  });
   if (!btsnooz_ostream.flush()) {
     LOG_ERROR("Failed to flush, error: \"%s\"", strerror(errno));
   }
@@ -403,7 +548,37 @@ void SnoopLogger::ListDependencies(ModuleList* list) const {
 void SnoopLogger::Start() {
   std::lock_guard<std::recursive_mutex> lock(file_mutex_);
   if (is_enabled_) {
+    if (mapped_file_size_ > 0) {
+      // A mapped log from a session that did not stop cleanly ends with preallocated space and maybe a torn record
+      MappedSnoopLogFile::RecoverSnoopLogFile(snoop_log_path_);
+    }
     OpenNextSnoopLogFile();
+    if (async_write_enabled_) {
+      writer_thread_ = std::make_unique<os::Thread>("snoop_writer_thread", os::Thread::Priority::NORMAL);
+      auto writer_event = writer_thread_->GetReactor()->NewEvent();
+      writer_reactable_ = writer_thread_->GetReactor()->Register(
+          writer_event->Id(),
+          common::Bind(&SnoopLogger::OnPendingRecordsReady, common::Unretained(this)),
+          common::Closure());
+      {
+        std::lock_guard<std::mutex> event_lock(writer_event_mutex_);
+        writer_event_ = std::move(writer_event);
+        // Records queued while no writer was running did not raise the event
+        if (pending_record_count_.load() > 0) {
+          writer_event_->Notify();
+        }
+      }
+      if (net_enabled_) {
+        net_server_ = SnoopNetServer::Create(
+            writer_thread_->GetReactor(),
+            kBtSnoopNetSocketName,
+            {kAidRoot, kAidSystem, kAidShell, getuid()},
+            kMaxNetClients,
+            kMaxQueuedBytesPerNetClient,
+            &kBtSnoopFileHeader,
+            sizeof(FileHeaderType));
+      }
+    }
   }
   alarm_ = std::make_unique<os::RepeatingAlarm>(GetHandler());
   alarm_->Schedule(
@@ -413,6 +588,28 @@ void SnoopLogger::Start() {
 void SnoopLogger::Stop() {
   std::lock_guard<std::recursive_mutex> lock(file_mutex_);
   LOG_DEBUG("Closing btsnoop log data at %s", snoop_log_path_.c_str());
+  if (writer_thread_ != nullptr) {
+    writer_thread_->GetReactor()->Unregister(writer_reactable_);
+    writer_thread_->GetReactor()->WaitForUnregisteredReactable(std::chrono::milliseconds(1000));
+    writer_reactable_ = nullptr;
+    // The clients are serviced on the writer thread, disconnect them once it is done
+    writer_thread_->Stop();
+    net_server_.reset();
+    {
+      // Producers racing with Stop() now queue without notifying, their records are flushed below or by the next
+      // Start()
+      std::lock_guard<std::mutex> event_lock(writer_event_mutex_);
+      writer_event_.reset();
+    }
+    // Flush whatever the writer left behind from here
+    while (size_t written = WritePendingRecords(kMaxAsyncRecordsPerWrite)) {
+      pending_record_count_.fetch_sub(written);
+    }
+    writer_thread_.reset();
+    if (dropped_packets_ > 0) {
+      LOG_WARN("%u packets dropped from btsnoop log", dropped_packets_.load());
+    }
+  }
   CloseCurrentSnoopLogFile();
   // Cancel the alarm
   alarm_->Cancel();
@@ -423,7 +620,7 @@ void SnoopLogger::Stop() {
 
 DumpsysDataFinisher SnoopLogger::GetDumpsysData(flatbuffers::FlatBufferBuilder* builder) const {
   LOG_DEBUG("Dumping btsnooz log data to %s", snooz_log_path_.c_str());
-  DumpSnoozLogToFile(btsnooz_buffer_.Pull());
+  DumpSnoozLogToFile();
   return Module::GetDumpsysData(builder);
 }
 
@@ -477,6 +674,32 @@ std::string SnoopLogger::GetBtSnoopMode() {
   return btsnoop_mode;
 }
 
+size_t SnoopLogger::GetMappedFileSize() {
+  auto mapped_file_size_prop = os::GetSystemProperty(kBtSnoopMappedFileSizeProperty);
+  if (mapped_file_size_prop) {
+    auto mapped_file_size = common::Uint64FromString(mapped_file_size_prop.value());
+    if (mapped_file_size && mapped_file_size.value() > sizeof(FileHeaderType)) {
+      return mapped_file_size.value();
+    }
+  }
+  return 0;
+}
+
+bool SnoopLogger::IsNetEnabled() {
+  // The stream carries link keys and pairing material, never serve it on user builds
+  auto is_debuggable = os::GetSystemProperty(kIsDebuggableProperty);
+  if (!is_debuggable.has_value() || common::StringTrim(is_debuggable.value()) != "1") {
+    return false;
+  }
+  auto net_prop = os::GetSystemProperty(kBtSnoopNetProperty);
+  return net_prop.has_value() && common::StringTrim(net_prop.value()) == "true";
+}
+
+bool SnoopLogger::IsAsyncWriteEnabled() {
+  auto async_write_prop = os::GetSystemProperty(kBtSnoopAsyncWriteProperty);
+  return async_write_prop.has_value() && common::StringTrim(async_write_prop.value()) == "true";
+}
+
 bool SnoopLogger::IsQualcommDebugLogEnabled() {
   // Check system prop if the soc manufacturer is Qualcomm
   bool qualcomm_debug_log_enabled = false;
@@ -497,7 +720,10 @@ const ModuleFactory SnoopLogger::Factory = ModuleFactory([]() {
       GetBtSnoopMode(),
       IsQualcommDebugLogEnabled(),
       kBtSnoozLogLifeTime,
-      kBtSnoozLogDeleteRepeatingAlarmInterval);
+      kBtSnoozLogDeleteRepeatingAlarmInterval,
+      IsAsyncWriteEnabled(),
+      GetMappedFileSize(),
+      IsNetEnabled());
 });
 
 }  // namespace hal
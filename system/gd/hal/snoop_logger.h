@@ -16,15 +16,21 @@
 
 #pragma once
 
+#include <atomic>
 #include <fstream>
 #include <iostream>
 #include <mutex>
 #include <string>
 
-#include "common/circular_buffer.h"
+#include "common/mpsc_queue.h"
 #include "hal/hci_hal.h"
+#include "hal/mapped_snoop_log_file.h"
+#include "hal/snoop_net_server.h"
+#include "hal/snooz_buffer.h"
 #include "module.h"
+#include "os/reactor.h"
 #include "os/repeating_alarm.h"
+#include "os/thread.h"
 
 namespace bluetooth {
 namespace hal {
@@ -47,6 +53,10 @@ class SnoopLogger : public ::bluetooth::Module {
   static const std::string kBtSnoopLogModeProperty;
   static const std::string kBtSnoopDefaultLogModeProperty;
   static const std::string kSoCManufacturerProperty;
+  static const std::string kBtSnoopAsyncWriteProperty;
+  static const std::string kBtSnoopMappedFileSizeProperty;
+  static const std::string kBtSnoopNetProperty;
+  static const std::string kBtSnoopNetSocketName;
 
   // Put in header for test
   struct PacketHeaderType {
@@ -79,6 +89,20 @@ class SnoopLogger : public ::bluetooth::Module {
   // Changes to this value is only effective after restarting Bluetooth
   static bool IsQualcommDebugLogEnabled();
 
+  // Returns whether btsnoop records are written to file from a dedicated thread instead of the capturing thread
+  // Changes to this value is only effective after restarting Bluetooth
+  static bool IsAsyncWriteEnabled();
+
+  // Returns the size of the preallocated, memory mapped btsnoop log files, or 0 to write them through a file
+  // descriptor. When set, files are rotated by size instead of by packet count.
+  // Changes to this value is only effective after restarting Bluetooth
+  static size_t GetMappedFileSize();
+
+  // Returns whether btsnoop records are streamed to live clients on the abstract socket kBtSnoopNetSocketName, which
+  // is only allowed on debuggable builds. Streaming implies the async write mode, the clients are fed from its queue.
+  // Changes to this value is only effective after restarting Bluetooth
+  static bool IsNetEnabled();
+
   // Has to be defined from 1 to 4 per btsnoop format
   enum PacketType {
     CMD = 1,
@@ -95,6 +119,9 @@ class SnoopLogger : public ::bluetooth::Module {
 
   void Capture(const HciPacket& packet, Direction direction, PacketType type);
 
+  // Number of packets left out of the btsnoop log because the async write queue was full
+  uint32_t GetDroppedPacketCount() const;
+
  protected:
   void ListDependencies(ModuleList* list) const override;
   void Start() override;
@@ -113,25 +140,59 @@ class SnoopLogger : public ::bluetooth::Module {
       const std::string& btsnoop_mode,
       bool qualcomm_debug_log_enabled,
       const std::chrono::milliseconds snooz_log_life_time,
-      const std::chrono::milliseconds snooz_log_delete_alarm_interval);
+      const std::chrono::milliseconds snooz_log_delete_alarm_interval,
+      bool async_write_enabled = false,
+      size_t mapped_file_size = 0,
+      bool net_enabled = false);
   void CloseCurrentSnoopLogFile();
   void OpenNextSnoopLogFile();
-  void DumpSnoozLogToFile(const std::vector<std::string>& data) const;
+  void DumpSnoozLogToFile() const;
 
  private:
+  // Write |count| serialized records (packet header followed by payload) to the btsnoop log with as few writev()
+  // calls as possible, rotating files as needed. Must hold file_mutex_.
+  void WriteSnoopLogRecords(const std::string* records, size_t count);
+  // Append one record to mapped_snoop_log_file_, rotating to the next file when it is full. Must hold file_mutex_.
+  void AppendMappedSnoopLogRecord(const void* header, const uint8_t* payload, size_t payload_size);
+  // Runs on writer_thread_ when writer_event_ is notified
+  void OnPendingRecordsReady();
+  // Pop and write up to |max_records| pending records, returns how many were written
+  size_t WritePendingRecords(size_t max_records);
+
   std::string snoop_log_path_;
   std::string snooz_log_path_;
-  std::ofstream btsnoop_ostream_;
+  int btsnoop_fd_ = -1;
+  // Replaces btsnoop_fd_ when mapped_file_size_ is set
+  std::unique_ptr<MappedSnoopLogFile> mapped_snoop_log_file_;
   bool is_enabled_ = false;
   bool is_filtered_ = false;
   size_t max_packets_per_file_;
-  common::CircularBuffer<std::string> btsnooz_buffer_;
+  SnoozBuffer btsnooz_buffer_;
   bool qualcomm_debug_log_enabled_ = false;
   size_t packet_counter_ = 0;
   mutable std::recursive_mutex file_mutex_;
   std::unique_ptr<os::RepeatingAlarm> alarm_;
   std::chrono::milliseconds snooz_log_life_time_;
   std::chrono::milliseconds snooz_log_delete_alarm_interval_;
+
+  // Async write mode: Capture() only serializes the record and queues it, writer_thread_ batches them to the file
+  const bool async_write_enabled_;
+  common::MpscQueue<std::string> pending_records_;
+  // Raised from Capture() when the queue becomes non-empty, so a burst costs a single wakeup of the writer
+  std::atomic_size_t pending_record_count_{0};
+  std::atomic_uint32_t dropped_packets_{0};
+  std::unique_ptr<os::Thread> writer_thread_;
+  // Guards writer_event_ between the producers notifying it and Start()/Stop() replacing it. Producers only take it
+  // when the queue becomes non-empty.
+  std::mutex writer_event_mutex_;
+  std::unique_ptr<os::Reactor::Event> writer_event_;
+  os::Reactor::Reactable* writer_reactable_ = nullptr;
+
+  const size_t mapped_file_size_;
+
+  // Streams the records written by writer_thread_ to live clients, serviced on its reactor
+  const bool net_enabled_;
+  std::unique_ptr<SnoopNetServer> net_server_;
 };
 
 }  // namespace hal
@@ -19,6 +19,9 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <thread>
+
 #include "os/fake_timer/fake_timerfd.h"
 
 namespace testing {
@@ -69,7 +72,9 @@ class TestSnoopLoggerModule : public SnoopLogger {
       std::string snooz_log_path,
       size_t max_packets_per_file,
       const std::string& btsnoop_mode,
-      bool qualcomm_debug_log_enabled)
+      bool qualcomm_debug_log_enabled,
+      bool async_write_enabled = false,
+      size_t mapped_file_size = 0)
       : SnoopLogger(
             std::move(snoop_log_path),
             std::move(snooz_log_path),
@@ -78,7 +83,9 @@ class TestSnoopLoggerModule : public SnoopLogger {
             btsnoop_mode,
             qualcomm_debug_log_enabled,
             20ms,
-            5ms) {}
+            5ms,
+            async_write_enabled,
+            mapped_file_size) {}
 
   std::string ToString() const override {
     return std::string("TestSnoopLoggerModule");
@@ -87,6 +94,11 @@ class TestSnoopLoggerModule : public SnoopLogger {
   void CallGetDumpsysData(flatbuffers::FlatBufferBuilder* builder) {
     GetDumpsysData(builder);
   }
+
+  void Restart() {
+    Stop();
+    Start();
+  }
 };
 
 class SnoopLoggerModuleTest : public Test {
@@ -359,6 +371,89 @@ TEST_F(SnoopLoggerModuleTest, rotate_file_after_full_test) {
       sizeof(SnoopLogger::FileHeaderType) + (sizeof(SnoopLogger::PacketHeaderType) + kInformationRequest.size()) * 10);
 }
 
+TEST_F(SnoopLoggerModuleTest, async_capture_packets_flushed_on_stop_test) {
+  // Actual test
+  auto* snoop_logger = new TestSnoopLoggerModule(
+      temp_snoop_log_.string(), temp_snooz_log_.string(), 10, SnoopLogger::kBtSnoopLogModeFull, false, true);
+  TestModuleRegistry test_registry;
+  test_registry.InjectTestModule(&SnoopLogger::Factory, snoop_logger);
+
+  for (int i = 0; i < 11; i++) {
+    snoop_logger->Capture(kInformationRequest, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::CMD);
+  }
+  ASSERT_EQ(snoop_logger->GetDroppedPacketCount(), 0u);
+
+  test_registry.StopAll();
+
+  // Verify states after test
+  ASSERT_TRUE(std::filesystem::exists(temp_snoop_log_));
+  ASSERT_TRUE(std::filesystem::exists(temp_snoop_log_last_));
+  ASSERT_EQ(
+      std::filesystem::file_size(temp_snoop_log_),
+      sizeof(SnoopLogger::FileHeaderType) + (sizeof(SnoopLogger::PacketHeaderType) + kInformationRequest.size()) * 1);
+  ASSERT_EQ(
+      std::filesystem::file_size(temp_snoop_log_last_),
+      sizeof(SnoopLogger::FileHeaderType) + (sizeof(SnoopLogger::PacketHeaderType) + kInformationRequest.size()) * 10);
+}
+
+TEST_F(SnoopLoggerModuleTest, async_capture_racing_restart_test) {
+  // Actual test
+  auto* snoop_logger = new TestSnoopLoggerModule(
+      temp_snoop_log_.string(), temp_snooz_log_.string(), 1000000, SnoopLogger::kBtSnoopLogModeFull, false, true);
+  TestModuleRegistry test_registry;
+  test_registry.InjectTestModule(&SnoopLogger::Factory, snoop_logger);
+
+  // The producer keeps queueing, and notifying the writer, while it is torn down and brought back
+  std::atomic_bool capturing = true;
+  std::thread producer([snoop_logger, &capturing]() {
+    while (capturing) {
+      snoop_logger->Capture(kInformationRequest, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::CMD);
+    }
+  });
+  for (int i = 0; i < 20; i++) {
+    snoop_logger->Restart();
+  }
+  capturing = false;
+  producer.join();
+
+  test_registry.StopAll();
+
+  // Verify states after test: the log only holds whole records
+  ASSERT_TRUE(std::filesystem::exists(temp_snoop_log_));
+  auto records_size = std::filesystem::file_size(temp_snoop_log_) - sizeof(SnoopLogger::FileHeaderType);
+  ASSERT_EQ(records_size % (sizeof(SnoopLogger::PacketHeaderType) + kInformationRequest.size()), 0u);
+}
+
+TEST_F(SnoopLoggerModuleTest, mapped_file_rotate_by_size_test) {
+  // Room for exactly 10 packets per file
+  size_t mapped_file_size = sizeof(SnoopLogger::FileHeaderType) +
+                            (sizeof(SnoopLogger::PacketHeaderType) + kInformationRequest.size()) * 10;
+  auto* snoop_logger = new TestSnoopLoggerModule(
+      temp_snoop_log_.string(),
+      temp_snooz_log_.string(),
+      SnoopLogger::GetMaxPacketsPerFile(),
+      SnoopLogger::kBtSnoopLogModeFull,
+      false,
+      false,
+      mapped_file_size);
+  TestModuleRegistry test_registry;
+  test_registry.InjectTestModule(&SnoopLogger::Factory, snoop_logger);
+
+  for (int i = 0; i < 11; i++) {
+    snoop_logger->Capture(kInformationRequest, SnoopLogger::Direction::OUTGOING, SnoopLogger::PacketType::CMD);
+  }
+
+  test_registry.StopAll();
+
+  // Closing the mapped file truncates the preallocated space
+  ASSERT_TRUE(std::filesystem::exists(temp_snoop_log_));
+  ASSERT_TRUE(std::filesystem::exists(temp_snoop_log_last_));
+  ASSERT_EQ(
+      std::filesystem::file_size(temp_snoop_log_),
+      sizeof(SnoopLogger::FileHeaderType) + (sizeof(SnoopLogger::PacketHeaderType) + kInformationRequest.size()) * 1);
+  ASSERT_EQ(std::filesystem::file_size(temp_snoop_log_last_), mapped_file_size);
+}
+
 TEST_F(SnoopLoggerModuleTest, qualcomm_debug_log_test) {
   auto* snoop_logger = new TestSnoopLoggerModule(
       temp_snoop_log_.string(), temp_snooz_log_.string(), 10, SnoopLogger::kBtSnoopLogModeDisabled, true);
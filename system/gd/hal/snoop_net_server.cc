@@ -0,0 +1,257 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/snoop_net_server.h"
+
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+#include "common/bind.h"
+#include "os/log.h"
+#include "os/utils.h"
+
+namespace bluetooth {
+namespace hal {
+
+struct SnoopNetServer::Client {
+  int fd;
+  os::Reactor::Reactable* reactable = nullptr;
+  // Chunks shared between the clients, the first one is sent from |offset|
+  std::deque<std::shared_ptr<const std::string>> queue;
+  size_t offset = 0;
+  size_t queued_bytes = 0;
+  uint64_t dropped_records = 0;
+};
+
+std::unique_ptr<SnoopNetServer> SnoopNetServer::Create(
+    os::Reactor* reactor,
+    const std::string& socket_name,
+    std::vector<uid_t> allowed_uids,
+    size_t max_clients,
+    size_t max_queued_bytes_per_client,
+    const void* file_header,
+    size_t file_header_size) {
+  struct sockaddr_un addr = {};
+  addr.sun_family = AF_UNIX;
+  // The abstract namespace, starting with a null byte, is not bound to a file
+  if (socket_name.empty() || socket_name.size() + 1 > sizeof(addr.sun_path)) {
+    LOG_ERROR("Invalid btsnoop socket name \"%s\"", socket_name.c_str());
+    return nullptr;
+  }
+  memcpy(addr.sun_path + 1, socket_name.data(), socket_name.size());
+  socklen_t addr_len = offsetof(struct sockaddr_un, sun_path) + 1 + socket_name.size();
+
+  int fd;
+  RUN_NO_INTR(fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0));
+  if (fd == -1) {
+    LOG_ERROR("Unable to create btsnoop server socket, error: \"%s\"", strerror(errno));
+    return nullptr;
+  }
+  if (bind(fd, reinterpret_cast<struct sockaddr*>(&addr), addr_len) == -1 || listen(fd, 4) == -1) {
+    LOG_ERROR(
+        "Unable to listen for btsnoop clients on @%s, error: \"%s\"", socket_name.c_str(), strerror(errno));
+    close(fd);
+    return nullptr;
+  }
+  LOG_INFO("Streaming btsnoop to clients on @%s", socket_name.c_str());
+  return std::unique_ptr<SnoopNetServer>(new SnoopNetServer(
+      reactor,
+      fd,
+      socket_name,
+      std::move(allowed_uids),
+      max_clients,
+      max_queued_bytes_per_client,
+      file_header,
+      file_header_size));
+}
+
+SnoopNetServer::SnoopNetServer(
+    os::Reactor* reactor,
+    int listen_fd,
+    std::string socket_name,
+    std::vector<uid_t> allowed_uids,
+    size_t max_clients,
+    size_t max_queued_bytes_per_client,
+    const void* file_header,
+    size_t file_header_size)
+    : reactor_(reactor),
+      listen_fd_(listen_fd),
+      socket_name_(std::move(socket_name)),
+      allowed_uids_(std::move(allowed_uids)),
+      max_clients_(max_clients),
+      max_queued_bytes_per_client_(max_queued_bytes_per_client),
+      file_header_(std::make_shared<const std::string>(static_cast<const char*>(file_header), file_header_size)) {
+  listen_reactable_ = reactor_->Register(
+      listen_fd_, common::Bind(&SnoopNetServer::OnAccept, common::Unretained(this)), common::Closure());
+}
+
+SnoopNetServer::~SnoopNetServer() {
+  while (!clients_.empty()) {
+    CloseClient(clients_.front().get());
+  }
+  reactor_->Unregister(listen_reactable_);
+  close(listen_fd_);
+  if (dropped_records_ > 0) {
+    LOG_WARN("%llu btsnoop records were not streamed to slow clients",
+             static_cast<unsigned long long>(dropped_records_.load()));
+  }
+}
+
+void SnoopNetServer::OnAccept() {
+  closed_clients_.clear();
+  int fd;
+  RUN_NO_INTR(fd = accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC));
+  if (fd == -1) {
+    if (errno != EAGAIN && errno != EWOULDBLOCK) {
+      LOG_ERROR("Unable to accept btsnoop client, error: \"%s\"", strerror(errno));
+    }
+    return;
+  }
+  if (!IsAllowedPeer(fd)) {
+    close(fd);
+    return;
+  }
+  if (clients_.size() >= max_clients_) {
+    LOG_WARN("Refusing btsnoop client, already streaming to %zu", clients_.size());
+    close(fd);
+    return;
+  }
+
+  auto client = std::make_unique<Client>();
+  client->fd = fd;
+  client->queue.push_back(file_header_);
+  client->queued_bytes = file_header_->size();
+  // Edge triggered, so write readiness is only reported once the socket drains after a send() that would block.
+  // Reads only notice the client going away.
+  client->reactable = reactor_->Register(
+      fd,
+      common::Bind(&SnoopNetServer::OnClientReadable, common::Unretained(this), client.get()),
+      common::Bind(&SnoopNetServer::FlushClient, common::Unretained(this), client.get()),
+      os::Reactor::Priority::LOW,
+      os::Reactor::Trigger::EDGE);
+  clients_.push_back(std::move(client));
+  client_count_ = clients_.size();
+  LOG_INFO("btsnoop client connected, %zu streaming", clients_.size());
+  FlushClient(clients_.back().get());
+}
+
+bool SnoopNetServer::IsAllowedPeer(int fd) const {
+  struct ucred credentials = {};
+  socklen_t credentials_len = sizeof(credentials);
+  if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &credentials_len) == -1) {
+    LOG_ERROR("Unable to get the credentials of btsnoop client, error: \"%s\"", strerror(errno));
+    return false;
+  }
+  if (std::find(allowed_uids_.begin(), allowed_uids_.end(), credentials.uid) == allowed_uids_.end()) {
+    LOG_WARN("Refusing btsnoop client of uid %u", static_cast<unsigned>(credentials.uid));
+    return false;
+  }
+  return true;
+}
+
+void SnoopNetServer::OnClientReadable(Client* client) {
+  if (client->fd == -1) {
+    return;
+  }
+  char buffer[256];
+  ssize_t received;
+  do {
+    RUN_NO_INTR(received = recv(client->fd, buffer, sizeof(buffer), MSG_DONTWAIT));
+  } while (received > 0);
+  if (received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+    CloseClient(client);
+  }
+}
+
+void SnoopNetServer::Send(const std::string* records, size_t count) {
+  closed_clients_.clear();
+  if (clients_.empty() || count == 0) {
+    return;
+  }
+  // One copy of the batch is shared by all the clients
+  auto chunk = std::make_shared<std::string>();
+  for (size_t i = 0; i < count; i++) {
+    chunk->append(records[i]);
+  }
+
+  for (auto it = clients_.begin(); it != clients_.end();) {
+    // Flushing may close the client
+    Client* client = (it++)->get();
+    if (client->queued_bytes + chunk->size() > max_queued_bytes_per_client_) {
+      client->dropped_records += count;
+      dropped_records_ += count;
+      continue;
+    }
+    bool was_empty = client->queue.empty();
+    client->queue.push_back(chunk);
+    client->queued_bytes += chunk->size();
+    // Otherwise the socket is full, the rest is sent when it reports write readiness
+    if (was_empty) {
+      FlushClient(client);
+    }
+  }
+}
+
+void SnoopNetServer::FlushClient(Client* client) {
+  if (client->fd == -1) {
+    return;
+  }
+  while (!client->queue.empty()) {
+    const std::string& chunk = *client->queue.front();
+    ssize_t sent;
+    RUN_NO_INTR(sent = send(client->fd, chunk.data() + client->offset, chunk.size() - client->offset,
+                            MSG_DONTWAIT | MSG_NOSIGNAL));
+    if (sent == -1) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        break;
+      }
+      CloseClient(client);
+      return;
+    }
+    client->offset += sent;
+    client->queued_bytes -= sent;
+    if (client->offset == chunk.size()) {
+      client->queue.pop_front();
+      client->offset = 0;
+    }
+  }
+}
+
+void SnoopNetServer::CloseClient(Client* client) {
+  reactor_->Unregister(client->reactable);
+  close(client->fd);
+  client->fd = -1;
+  if (client->dropped_records > 0) {
+    LOG_WARN("btsnoop client disconnected, %llu records were dropped for it",
+             static_cast<unsigned long long>(client->dropped_records));
+  } else {
+    LOG_INFO("btsnoop client disconnected");
+  }
+  // The reactor may still run the other callback of |client| in this wakeup, it is freed from the next one
+  auto it = std::find_if(
+      clients_.begin(), clients_.end(), [client](const std::unique_ptr<Client>& c) { return c.get() == client; });
+  closed_clients_.splice(closed_clients_.end(), clients_, it);
+  client_count_ = clients_.size();
+}
+
+}  // namespace hal
+}  // namespace bluetooth
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <sys/types.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "os/reactor.h"
+
+namespace bluetooth {
+namespace hal {
+
+// Streams btsnoop records live to the clients connected on an abstract Unix socket. Each client gets the file header,
+// then the records captured from the time it connected. The log holds pairing material, so only the clients running
+// as one of the allowed uids, checked with SO_PEERCRED, are served.
+//
+// The sockets are non-blocking and serviced on the reactor of the thread that feeds the records, so the capture never
+// waits for a client. Each client has a bounded queue: a client that does not keep up loses the records that do not
+// fit, which are counted, instead of slowing down the others.
+class SnoopNetServer {
+ public:
+  // Listen on the abstract Unix socket |socket_name| for clients running as one of |allowed_uids|, with sockets
+  // serviced on |reactor|. Returns nullptr on failure.
+  static std::unique_ptr<SnoopNetServer> Create(
+      os::Reactor* reactor,
+      const std::string& socket_name,
+      std::vector<uid_t> allowed_uids,
+      size_t max_clients,
+      size_t max_queued_bytes_per_client,
+      const void* file_header,
+      size_t file_header_size);
+
+  SnoopNetServer(const SnoopNetServer&) = delete;
+  SnoopNetServer& operator=(const SnoopNetServer&) = delete;
+
+  // Disconnect the clients. Must not race with the reactor: call it from the reactor thread or once it stopped.
+  ~SnoopNetServer();
+
+  // Queue |count| serialized records (packet header followed by payload) for all the clients, from the reactor thread
+  void Send(const std::string* records, size_t count);
+
+  const std::string& GetSocketName() const {
+    return socket_name_;
+  }
+
+  size_t GetClientCount() const {
+    return client_count_.load();
+  }
+
+  // Records not sent to a client because its queue was full, summed over all the clients
+  uint64_t GetDroppedRecordCount() const {
+    return dropped_records_.load();
+  }
+
+ private:
+  struct Client;
+
+  SnoopNetServer(
+      os::Reactor* reactor,
+      int listen_fd,
+      std::string socket_name,
+      std::vector<uid_t> allowed_uids,
+      size_t max_clients,
+      size_t max_queued_bytes_per_client,
+      const void* file_header,
+      size_t file_header_size);
+
+  void OnAccept();
+  bool IsAllowedPeer(int fd) const;
+  void OnClientReadable(Client* client);
+  // Send as much of the queue of |client| as the socket takes
+  void FlushClient(Client* client);
+  void CloseClient(Client* client);
+
+  os::Reactor* const reactor_;
+  const int listen_fd_;
+  const std::string socket_name_;
+  const std::vector<uid_t> allowed_uids_;
+  const size_t max_clients_;
+  const size_t max_queued_bytes_per_client_;
+  const std::shared_ptr<const std::string> file_header_;
+  os::Reactor::Reactable* listen_reactable_ = nullptr;
+  std::list<std::unique_ptr<Client>> clients_;
+  // Disconnected, kept until the reactor is done with their callbacks
+  std::list<std::unique_ptr<Client>> closed_clients_;
+  std::atomic_size_t client_count_{0};
+  std::atomic_uint64_t dropped_records_{0};
+};
+
+}  // namespace hal
+}  // namespace bluetooth
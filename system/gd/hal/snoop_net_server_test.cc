@@ -0,0 +1,248 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/snoop_net_server.h"
+
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "common/bind.h"
+#include "hal/snoop_logger.h"
+#include "os/handler.h"
+#include "os/thread.h"
+
+namespace bluetooth {
+namespace hal {
+namespace {
+
+using namespace std::chrono_literals;
+
+const SnoopLogger::FileHeaderType kFileHeader = {
+    .identification_pattern = {'b', 't', 's', 'n', 'o', 'o', 'p', 0x00},
+    .version_number = 0,
+    .datalink_type = 0};
+
+std::string MakeRecord(size_t payload_size, uint8_t fill) {
+  uint32_t length = htonl(payload_size + /* type byte */ 1);
+  SnoopLogger::PacketHeaderType header = {
+      .length_original = length,
+      .length_captured = length,
+      .flags = 0,
+      .dropped_packets = 0,
+      .timestamp = 0,
+      .type = SnoopLogger::PacketType::ACL};
+  std::string record(reinterpret_cast<const char*>(&header), sizeof(header));
+  record.append(payload_size, fill);
+  return record;
+}
+
+class SnoopNetServerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    thread_ = std::make_unique<os::Thread>("snoop_net_server_test", os::Thread::Priority::NORMAL);
+    handler_ = std::make_unique<os::Handler>(thread_.get());
+  }
+
+  void TearDown() override {
+    for (int fd : fds_) {
+      close(fd);
+    }
+    // The server must not race with its reactor
+    RunOnReactor([this]() { server_.reset(); });
+    handler_->Clear();
+    handler_->WaitUntilStopped(1000ms);
+    handler_.reset();
+    thread_.reset();
+  }
+
+  void CreateServer(size_t max_clients, size_t max_queued_bytes_per_client, uid_t allowed_uid = getuid()) {
+    // Unique across the test processes running at once
+    std::string socket_name = "snoop_net_server_test_" + std::to_string(getpid());
+    server_ = SnoopNetServer::Create(
+        thread_->GetReactor(),
+        socket_name,
+        {allowed_uid},
+        max_clients,
+        max_queued_bytes_per_client,
+        &kFileHeader,
+        sizeof(kFileHeader));
+    ASSERT_NE(server_, nullptr);
+    ASSERT_EQ(server_->GetSocketName(), socket_name);
+  }
+
+  void RunOnReactor(std::function<void()> task) {
+    std::promise<void> done;
+    handler_->Post(common::BindOnce(
+        [](std::function<void()> task, std::promise<void>* done) {
+          task();
+          done->set_value();
+        },
+        std::move(task),
+        &done));
+    ASSERT_EQ(done.get_future().wait_for(1s), std::future_status::ready);
+  }
+
+  void Send(const std::vector<std::string>& records) {
+    RunOnReactor([this, &records]() { server_->Send(records.data(), records.size()); });
+  }
+
+  int Connect(int receive_buffer_size = 0) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    EXPECT_NE(fd, -1);
+    fds_.push_back(fd);
+    if (receive_buffer_size > 0) {
+      setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &receive_buffer_size, sizeof(receive_buffer_size));
+    }
+    struct timeval timeout = {.tv_sec = 1, .tv_usec = 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    struct sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    const std::string& name = server_->GetSocketName();
+    memcpy(addr.sun_path + 1, name.data(), name.size());
+    socklen_t addr_len = offsetof(struct sockaddr_un, sun_path) + 1 + name.size();
+    EXPECT_EQ(connect(fd, reinterpret_cast<struct sockaddr*>(&addr), addr_len), 0);
+    return fd;
+  }
+
+  bool WaitForClientCount(size_t count) {
+    for (int i = 0; i < 100 && server_->GetClientCount() != count; i++) {
+      std::this_thread::sleep_for(10ms);
+    }
+    return server_->GetClientCount() == count;
+  }
+
+  // Empty if the stream ends or times out first
+  static std::string Receive(int fd, size_t size) {
+    std::string data(size, '\0');
+    size_t received = 0;
+    while (received < size) {
+      ssize_t n = recv(fd, data.data() + received, size - received, 0);
+      if (n <= 0) {
+        return std::string();
+      }
+      received += n;
+    }
+    return data;
+  }
+
+  static std::string FileHeader() {
+    return std::string(reinterpret_cast<const char*>(&kFileHeader), sizeof(kFileHeader));
+  }
+
+  std::unique_ptr<os::Thread> thread_;
+  std::unique_ptr<os::Handler> handler_;
+  std::unique_ptr<SnoopNetServer> server_;
+  std::vector<int> fds_;
+};
+
+TEST_F(SnoopNetServerTest, streams_file_header_then_records) {
+  CreateServer(4, 64 * 1024);
+  int fd = Connect();
+  ASSERT_TRUE(WaitForClientCount(1));
+
+  std::vector<std::string> records = {MakeRecord(10, 0x01), MakeRecord(300, 0x02)};
+  Send(records);
+  ASSERT_EQ(Receive(fd, sizeof(kFileHeader)), FileHeader());
+  ASSERT_EQ(Receive(fd, records[0].size()), records[0]);
+  ASSERT_EQ(Receive(fd, records[1].size()), records[1]);
+  ASSERT_EQ(server_->GetDroppedRecordCount(), 0u);
+}
+
+TEST_F(SnoopNetServerTest, records_are_streamed_to_every_client) {
+  CreateServer(4, 64 * 1024);
+  int fd1 = Connect();
+  int fd2 = Connect();
+  ASSERT_TRUE(WaitForClientCount(2));
+
+  std::vector<std::string> records = {MakeRecord(20, 0x03)};
+  Send(records);
+  for (int fd : {fd1, fd2}) {
+    ASSERT_EQ(Receive(fd, sizeof(kFileHeader)), FileHeader());
+    ASSERT_EQ(Receive(fd, records[0].size()), records[0]);
+  }
+}
+
+TEST_F(SnoopNetServerTest, clients_over_the_limit_are_refused) {
+  CreateServer(1, 64 * 1024);
+  Connect();
+  ASSERT_TRUE(WaitForClientCount(1));
+  int refused = Connect();
+  ASSERT_EQ(Receive(refused, 1), std::string());
+  ASSERT_EQ(server_->GetClientCount(), 1u);
+}
+
+TEST_F(SnoopNetServerTest, clients_of_other_uids_are_refused) {
+  CreateServer(4, 64 * 1024, getuid() + 1);
+  int refused = Connect();
+  ASSERT_EQ(Receive(refused, 1), std::string());
+  ASSERT_EQ(server_->GetClientCount(), 0u);
+}
+
+TEST_F(SnoopNetServerTest, socket_name_is_exclusive) {
+  CreateServer(4, 64 * 1024);
+  ASSERT_EQ(
+      SnoopNetServer::Create(
+          thread_->GetReactor(), server_->GetSocketName(), {getuid()}, 4, 64 * 1024, &kFileHeader, sizeof(kFileHeader)),
+      nullptr);
+}
+
+TEST_F(SnoopNetServerTest, disconnected_clients_are_removed) {
+  CreateServer(4, 64 * 1024);
+  int fd = Connect();
+  ASSERT_TRUE(WaitForClientCount(1));
+  close(fd);
+  fds_.clear();
+  ASSERT_TRUE(WaitForClientCount(0));
+}
+
+TEST_F(SnoopNetServerTest, slow_client_drops_whole_records) {
+  constexpr size_t kPayloadSize = 16 * 1024;
+  CreateServer(4, 4 * kPayloadSize);
+  // The client does not read until the server had to drop records
+  int fd = Connect(4096);
+  ASSERT_TRUE(WaitForClientCount(1));
+
+  std::vector<std::string> records = {MakeRecord(kPayloadSize, 0x04)};
+  size_t sent = 0;
+  while (server_->GetDroppedRecordCount() == 0 && sent < 10000) {
+    Send(records);
+    sent++;
+  }
+  ASSERT_GT(server_->GetDroppedRecordCount(), 0u);
+
+  // What was queued still arrives as a valid stream, and the client keeps streaming
+  ASSERT_EQ(Receive(fd, sizeof(kFileHeader)), FileHeader());
+  for (size_t i = 0; i < sent - server_->GetDroppedRecordCount(); i++) {
+    ASSERT_EQ(Receive(fd, records[0].size()), records[0]) << i;
+  }
+  Send(records);
+  ASSERT_EQ(Receive(fd, records[0].size()), records[0]);
+  ASSERT_EQ(server_->GetClientCount(), 1u);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace bluetooth
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/snooz_buffer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace bluetooth {
+namespace hal {
+
+SnoozBuffer::SnoozBuffer(size_t capacity_bytes) : arena_(capacity_bytes) {}
+
+void SnoozBuffer::Push(const void* header, size_t header_size, const uint8_t* payload, size_t payload_size) {
+  size_t record_size = header_size + payload_size;
+  if (record_size > std::numeric_limits<RecordLength>::max() || sizeof(RecordLength) + record_size > arena_.size()) {
+    return;
+  }
+  while (arena_.size() - used_ < sizeof(RecordLength) + record_size) {
+    EvictOldest();
+  }
+  size_t tail = (head_ + used_) % arena_.size();
+  RecordLength length = record_size;
+  Write(tail, &length, sizeof(length));
+  tail = (tail + sizeof(length)) % arena_.size();
+  Write(tail, header, header_size);
+  tail = (tail + header_size) % arena_.size();
+  Write(tail, payload, payload_size);
+  used_ += sizeof(RecordLength) + record_size;
+  record_count_++;
+}
+
+void SnoozBuffer::ForEachSpan(const std::function<void(const uint8_t* data, size_t size)>& visitor) const {
+  size_t offset = head_;
+  for (size_t i = 0; i < record_count_; i++) {
+    RecordLength length;
+    Read(offset, &length, sizeof(length));
+    offset = (offset + sizeof(length)) % arena_.size();
+    size_t first = std::min<size_t>(length, arena_.size() - offset);
+    visitor(arena_.data() + offset, first);
+    if (first < length) {
+      visitor(arena_.data(), length - first);
+    }
+    offset = (offset + length) % arena_.size();
+  }
+}
+
+void SnoozBuffer::Clear() {
+  head_ = 0;
+  used_ = 0;
+  record_count_ = 0;
+}
+
+void SnoozBuffer::Write(size_t offset, const void* data, size_t size) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  size_t first = std::min(size, arena_.size() - offset);
+  std::memcpy(arena_.data() + offset, bytes, first);
+  std::memcpy(arena_.data(), bytes + first, size - first);
+}
+
+void SnoozBuffer::Read(size_t offset, void* data, size_t size) const {
+  uint8_t* bytes = static_cast<uint8_t*>(data);
+  size_t first = std::min(size, arena_.size() - offset);
+  std::memcpy(bytes, arena_.data() + offset, first);
+  std::memcpy(bytes + first, arena_.data(), size - first);
+}
+
+void SnoozBuffer::EvictOldest() {
+  RecordLength length;
+  Read(head_, &length, sizeof(length));
+  head_ = (head_ + sizeof(length) + length) % arena_.size();
+  used_ -= sizeof(length) + length;
+  record_count_--;
+}
+
+}  // namespace hal
+}  // namespace bluetooth
@@ -0,0 +1,62 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace bluetooth {
+namespace hal {
+
+// Fixed size byte arena holding variable length records back to back, used for the in-memory btsnooz log. Pushing a
+// record evicts the oldest ones until it fits, so memory use is capped and no allocation happens after construction.
+// Not thread safe, callers must serialize access.
+class SnoozBuffer {
+ public:
+  explicit SnoozBuffer(size_t capacity_bytes);
+
+  // Append a record made of |header| followed by |payload|. Records that can never fit are dropped.
+  void Push(const void* header, size_t header_size, const uint8_t* payload, size_t payload_size);
+
+  // Visit the stored record bytes from oldest to newest. A record wrapping around the end of the arena is visited as
+  // two consecutive spans.
+  void ForEachSpan(const std::function<void(const uint8_t* data, size_t size)>& visitor) const;
+
+  size_t GetRecordCount() const {
+    return record_count_;
+  }
+
+  void Clear();
+
+ private:
+  // Every record is prefixed in the arena with its length
+  using RecordLength = uint16_t;
+
+  void Write(size_t offset, const void* data, size_t size);
+  void Read(size_t offset, void* data, size_t size) const;
+  void EvictOldest();
+
+  std::vector<uint8_t> arena_;
+  size_t head_ = 0;
+  size_t used_ = 0;
+  size_t record_count_ = 0;
+};
+
+}  // namespace hal
+}  // namespace bluetooth
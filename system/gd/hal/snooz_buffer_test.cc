@@ -0,0 +1,91 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hal/snooz_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace bluetooth {
+namespace hal {
+namespace {
+
+std::string Dump(const SnoozBuffer& buffer) {
+  std::string dump;
+  buffer.ForEachSpan(
+      [&dump](const uint8_t* data, size_t size) { dump.append(reinterpret_cast<const char*>(data), size); });
+  return dump;
+}
+
+void PushString(SnoozBuffer* buffer, const std::string& header, const std::string& payload) {
+  buffer->Push(header.data(), header.size(), reinterpret_cast<const uint8_t*>(payload.data()), payload.size());
+}
+
+TEST(SnoozBufferTest, empty) {
+  SnoozBuffer buffer(32);
+  EXPECT_EQ(buffer.GetRecordCount(), 0u);
+  EXPECT_EQ(Dump(buffer), "");
+}
+
+TEST(SnoozBufferTest, records_are_concatenated_in_order) {
+  SnoozBuffer buffer(32);
+  PushString(&buffer, "h1", "abc");
+  PushString(&buffer, "h2", "de");
+  EXPECT_EQ(buffer.GetRecordCount(), 2u);
+  EXPECT_EQ(Dump(buffer), "h1abch2de");
+}
+
+TEST(SnoozBufferTest, oldest_records_are_evicted) {
+  // Each record takes 2 bytes of length prefix + 6 bytes
+  SnoozBuffer buffer(20);
+  PushString(&buffer, "h1", "aaaa");
+  PushString(&buffer, "h2", "bbbb");
+  PushString(&buffer, "h3", "cccc");
+  EXPECT_EQ(buffer.GetRecordCount(), 2u);
+  EXPECT_EQ(Dump(buffer), "h2bbbbh3cccc");
+}
+
+TEST(SnoozBufferTest, records_wrap_around_arena) {
+  SnoozBuffer buffer(20);
+  for (int i = 0; i < 10; i++) {
+    PushString(&buffer, "h" + std::to_string(i), "xyz");
+  }
+  // 7 bytes per record, at most 2 fit
+  EXPECT_EQ(buffer.GetRecordCount(), 2u);
+  EXPECT_EQ(Dump(buffer), "h8xyzh9xyz");
+}
+
+TEST(SnoozBufferTest, oversized_record_is_dropped) {
+  SnoozBuffer buffer(8);
+  PushString(&buffer, "h", "a");
+  PushString(&buffer, "header", "payload");
+  EXPECT_EQ(buffer.GetRecordCount(), 1u);
+  EXPECT_EQ(Dump(buffer), "ha");
+}
+
+TEST(SnoozBufferTest, clear) {
+  SnoozBuffer buffer(32);
+  PushString(&buffer, "h1", "abc");
+  buffer.Clear();
+  EXPECT_EQ(buffer.GetRecordCount(), 0u);
+  PushString(&buffer, "h2", "de");
+  EXPECT_EQ(Dump(buffer), "h2de");
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace bluetooth
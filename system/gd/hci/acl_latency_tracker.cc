@@ -0,0 +1,260 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/acl_latency_tracker.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "hci/hci_packets.h"
+
+namespace bluetooth {
+namespace hci {
+
+namespace {
+constexpr uint16_t kHandleMask = 0x0fff;
+constexpr uint16_t kUnknownHandle = 0xffff;
+constexpr uint64_t kMaxValue = (uint64_t{1} << LatencyHistogram::kMaxValueBits) - 1;
+constexpr double kReportedPercentiles[] = {50.0, 90.0, 99.0, 99.9};
+
+// Read from the raw header on both sides, so that packets AclManager finds invalid are matched too
+uint16_t HandleOf(uint8_t low, uint8_t high) {
+  return (low | (high << 8)) & kHandleMask;
+}
+}  // namespace
+
+size_t LatencyHistogram::BucketIndex(uint64_t value) {
+  value = std::min(value, kMaxValue);
+  if (value < kSubBucketCount) {
+    return value;
+  }
+  size_t msb = 63 - __builtin_clzll(value);
+  size_t shift = msb - kSubBucketBits;
+  return (shift + 1) * kSubBucketCount + ((value >> shift) - kSubBucketCount);
+}
+
+uint64_t LatencyHistogram::BucketHighestEquivalentValue(size_t index) {
+  if (index < kSubBucketCount) {
+    return index;
+  }
+  size_t shift = index / kSubBucketCount - 1;
+  uint64_t lowest = (kSubBucketCount + index % kSubBucketCount) << shift;
+  return lowest + (uint64_t{1} << shift) - 1;
+}
+
+void LatencyHistogram::Record(std::chrono::microseconds latency) {
+  uint64_t value = latency.count() < 0 ? 0 : std::min(static_cast<uint64_t>(latency.count()), kMaxValue);
+  counts_[BucketIndex(value)]++;
+  count_++;
+  total_ += value;
+  min_ = std::min(min_, value);
+  max_ = std::max(max_, value);
+}
+
+void LatencyHistogram::Reset() {
+  *this = LatencyHistogram();
+}
+
+uint64_t LatencyHistogram::ValueAtPercentile(double percentile) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  percentile = std::clamp(percentile, 0.0, 100.0);
+  uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(percentile / 100.0 * count_ + 0.5));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBucketCount; i++) {
+    seen += counts_[i];
+    if (seen >= target) {
+      return std::min(BucketHighestEquivalentValue(i), max_);
+    }
+  }
+  return max_;
+}
+
+std::string AclLatencyTracker::StageText(Stage stage) {
+  switch (stage) {
+    case Stage::HCI_LAYER:
+      return "hal_to_acl_queue_end";
+    case Stage::ACL_MANAGER:
+      return "acl_queue_end_to_connection";
+    case Stage::TOTAL:
+      return "hal_to_connection";
+  }
+  return "unknown";
+}
+
+void AclLatencyTracker::SetEnabled(bool enabled) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  enabled_ = enabled;
+  in_flight_.clear();
+  current_valid_ = false;
+}
+
+void AclLatencyTracker::OnHalReceive(const uint8_t* data, size_t size) {
+  if (!enabled_) {
+    return;
+  }
+  uint16_t handle = size < sizeof(uint16_t) ? kUnknownHandle : HandleOf(data[0], data[1]);
+  auto now = Clock::now();
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& stamps = in_flight_[handle];
+  if (stamps.size() >= kMaxInFlightPerHandle) {
+    stamps.pop_front();
+    dropped_++;
+  }
+  stamps.push_back(Stamp{handle, now, now});
+}
+
+void AclLatencyTracker::OnQueueEndDequeue(const AclView& packet) {
+  if (!enabled_) {
+    return;
+  }
+  uint16_t handle = packet.size() < sizeof(uint16_t) ? kUnknownHandle : HandleOf(packet[0], packet[1]);
+  auto now = Clock::now();
+  std::lock_guard<std::mutex> lock(mutex_);
+  current_valid_ = false;
+  auto stamps = in_flight_.find(handle);
+  if (stamps == in_flight_.end() || stamps->second.empty()) {
+    unmatched_++;
+    return;
+  }
+  current_ = stamps->second.front();
+  stamps->second.pop_front();
+  current_.queue_end = now;
+  current_valid_ = true;
+  record(current_.handle, Stage::HCI_LAYER, current_.queue_end - current_.hal_receive);
+}
+
+void AclLatencyTracker::OnDelivered() {
+  if (!enabled_) {
+    return;
+  }
+  auto now = Clock::now();
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!current_valid_) {
+    return;
+  }
+  current_valid_ = false;
+  record(current_.handle, Stage::ACL_MANAGER, now - current_.queue_end);
+  record(current_.handle, Stage::TOTAL, now - current_.hal_receive);
+}
+
+void AclLatencyTracker::Flush() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  in_flight_.clear();
+  current_valid_ = false;
+}
+
+void AclLatencyTracker::OnDisconnect(uint16_t handle) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  in_flight_.erase(handle);
+  connections_.erase(handle);
+  if (current_valid_ && current_.handle == handle) {
+    current_valid_ = false;
+  }
+}
+
+void AclLatencyTracker::Reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  in_flight_.clear();
+  current_valid_ = false;
+  unmatched_ = 0;
+  dropped_ = 0;
+  for (auto& histogram : stages_) {
+    histogram.Reset();
+  }
+  connections_.clear();
+}
+
+void AclLatencyTracker::record(uint16_t handle, Stage stage, Clock::duration latency) {
+  auto latency_us = std::chrono::duration_cast<std::chrono::microseconds>(latency);
+  stages_[static_cast<size_t>(stage)].Record(latency_us);
+  connections_[handle][static_cast<size_t>(stage)].Record(latency_us);
+}
+
+LatencyHistogram AclLatencyTracker::GetStageHistogram(Stage stage) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stages_[static_cast<size_t>(stage)];
+}
+
+LatencyHistogram AclLatencyTracker::GetConnectionStageHistogram(uint16_t handle, Stage stage) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = connections_.find(handle);
+  if (it == connections_.end()) {
+    return LatencyHistogram();
+  }
+  return it->second[static_cast<size_t>(stage)];
+}
+
+uint64_t AclLatencyTracker::GetUnmatchedCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return unmatched_;
+}
+
+uint64_t AclLatencyTracker::GetDroppedCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return dropped_;
+}
+
+namespace {
+flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<LatencyHistogramData>>> CreateStagesData(
+    flatbuffers::FlatBufferBuilder* fb_builder,
+    const std::array<LatencyHistogram, AclLatencyTracker::kStageCount>& stages) {
+  std::vector<flatbuffers::Offset<LatencyHistogramData>> stages_data;
+  for (size_t i = 0; i < AclLatencyTracker::kStageCount; i++) {
+    const auto& histogram = stages[i];
+    auto stage = fb_builder->CreateString(AclLatencyTracker::StageText(static_cast<AclLatencyTracker::Stage>(i)));
+    LatencyHistogramDataBuilder builder(*fb_builder);
+    builder.add_stage(stage);
+    builder.add_count(histogram.Count());
+    builder.add_min_us(histogram.Min());
+    builder.add_mean_us(histogram.Mean());
+    builder.add_p50_us(histogram.ValueAtPercentile(kReportedPercentiles[0]));
+    builder.add_p90_us(histogram.ValueAtPercentile(kReportedPercentiles[1]));
+    builder.add_p99_us(histogram.ValueAtPercentile(kReportedPercentiles[2]));
+    builder.add_p999_us(histogram.ValueAtPercentile(kReportedPercentiles[3]));
+    builder.add_max_us(histogram.Max());
+    stages_data.push_back(builder.Finish());
+  }
+  return fb_builder->CreateVector(stages_data);
+}
+}  // namespace
+
+flatbuffers::Offset<AclLatencyData> AclLatencyTracker::GetDumpsysData(flatbuffers::FlatBufferBuilder* fb_builder) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto stages = CreateStagesData(fb_builder, stages_);
+
+  std::vector<flatbuffers::Offset<ConnectionLatencyData>> connections_data;
+  for (const auto& [handle, histograms] : connections_) {
+    auto connection_stages = CreateStagesData(fb_builder, histograms);
+    ConnectionLatencyDataBuilder builder(*fb_builder);
+    builder.add_handle(handle);
+    builder.add_stages(connection_stages);
+    connections_data.push_back(builder.Finish());
+  }
+  auto connections = fb_builder->CreateVector(connections_data);
+
+  AclLatencyDataBuilder builder(*fb_builder);
+  builder.add_enabled(enabled_.load());
+  builder.add_unmatched_count(unmatched_);
+  builder.add_dropped_count(dropped_);
+  builder.add_stages(stages);
+  builder.add_connections(connections);
+  return builder.Finish();
+}
+
+}  // namespace hci
+}  // namespace bluetooth
@@ -0,0 +1,150 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <flatbuffers/flatbuffers.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+
+#include "hci_acl_manager_generated.h"
+
+namespace bluetooth {
+namespace hci {
+
+class AclView;
+
+// Log-linear latency histogram in the spirit of HdrHistogram: every power of two range is split into
+// kSubBucketCount linear sub-buckets, so the recorded value is always known to within 1/kSubBucketCount of its
+// magnitude while the memory footprint stays fixed regardless of the observed range.
+class LatencyHistogram {
+ public:
+  static constexpr size_t kSubBucketBits = 3;
+  static constexpr uint64_t kSubBucketCount = 1 << kSubBucketBits;
+  // Values are clamped to 32 bits of microseconds (a little over an hour), which is plenty for packet latencies.
+  static constexpr size_t kMaxValueBits = 32;
+  static constexpr size_t kBucketCount = (kMaxValueBits - kSubBucketBits + 1) * kSubBucketCount;
+
+  void Record(std::chrono::microseconds latency);
+  void Reset();
+
+  uint64_t Count() const {
+    return count_;
+  }
+  uint64_t Min() const {
+    return count_ == 0 ? 0 : min_;
+  }
+  uint64_t Max() const {
+    return max_;
+  }
+  uint64_t Mean() const {
+    return count_ == 0 ? 0 : total_ / count_;
+  }
+
+  // Returns the highest value equivalent to the bucket holding |percentile| (0 - 100) of the recorded samples
+  uint64_t ValueAtPercentile(double percentile) const;
+
+  static size_t BucketIndex(uint64_t value);
+  static uint64_t BucketHighestEquivalentValue(size_t index);
+
+ private:
+  std::array<uint64_t, kBucketCount> counts_{};
+  uint64_t count_ = 0;
+  uint64_t total_ = 0;
+  uint64_t min_ = UINT64_MAX;
+  uint64_t max_ = 0;
+};
+
+// Opt-in tracker timing incoming ACL packets across the stack. Packets are stamped when the HAL hands them to
+// HciLayer, when AclManager dequeues them from the HciLayer queue end, and when AclManager has delivered them to
+// the connection they belong to. Both queues in between are FIFO, so the stamps are queued per connection handle
+// and matched up in arrival order rather than carried inside the packets. This only holds if tracking is enabled
+// before any ACL traffic flows, so HciLayer decides whether to enable it when it starts, and drops the stamps of
+// the packets it discards so that the following ones are matched to their own stamps again.
+class AclLatencyTracker {
+ public:
+  enum class Stage : size_t {
+    HCI_LAYER = 0,    // HAL receipt -> AclManager dequeue from the HciLayer queue end
+    ACL_MANAGER = 1,  // AclManager dequeue -> delivered to the connection
+    TOTAL = 2,        // HAL receipt -> delivered to the connection
+  };
+  static constexpr size_t kStageCount = 3;
+
+  static std::string StageText(Stage stage);
+
+  // Stamps kept per connection handle for packets not dequeued yet. Beyond this the dequeue side is stuck or has
+  // lost packets, so the oldest stamps are dropped rather than growing without bound.
+  static constexpr size_t kMaxInFlightPerHandle = 256;
+
+  void SetEnabled(bool enabled);
+  bool IsEnabled() const {
+    return enabled_;
+  }
+
+  // Called on the HAL thread for every incoming ACL packet
+  void OnHalReceive(const uint8_t* data, size_t size);
+  // Called by AclManager for every packet taken off the HciLayer queue end
+  void OnQueueEndDequeue(const AclView& packet);
+  // Called by AclManager once the packet last dequeued has been handed to its connection
+  void OnDelivered();
+  // Called by HciLayer when it discards the incoming ACL packets not delivered to AclManager yet
+  void Flush();
+  // Called by HciLayer when |handle| is disconnected, forgetting its stamps and histograms
+  void OnDisconnect(uint16_t handle);
+
+  void Reset();
+
+  LatencyHistogram GetStageHistogram(Stage stage) const;
+  LatencyHistogram GetConnectionStageHistogram(uint16_t handle, Stage stage) const;
+  // Number of dequeued packets for which no HAL receipt stamp was found
+  uint64_t GetUnmatchedCount() const;
+  // Number of HAL receipt stamps dropped because kMaxInFlightPerHandle was reached
+  uint64_t GetDroppedCount() const;
+
+  flatbuffers::Offset<AclLatencyData> GetDumpsysData(flatbuffers::FlatBufferBuilder* fb_builder) const;
+
+ private:
+  using Clock = std::chrono::steady_clock;
+  using Histograms = std::array<LatencyHistogram, kStageCount>;
+
+  struct Stamp {
+    uint16_t handle;
+    Clock::time_point hal_receive;
+    Clock::time_point queue_end;
+  };
+
+  void record(uint16_t handle, Stage stage, Clock::duration latency);
+
+  std::atomic_bool enabled_ = false;
+  mutable std::mutex mutex_;
+  std::map<uint16_t, std::deque<Stamp>> in_flight_;
+  Stamp current_{};
+  bool current_valid_ = false;
+  uint64_t unmatched_ = 0;
+  uint64_t dropped_ = 0;
+  Histograms stages_;
+  std::map<uint16_t, Histograms> connections_;
+};
+
+}  // namespace hci
+}  // namespace bluetooth
@@ -0,0 +1,298 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/acl_latency_tracker.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "hci/hci_packets.h"
+
+namespace bluetooth {
+namespace hci {
+namespace {
+
+using std::chrono::microseconds;
+using Stage = AclLatencyTracker::Stage;
+
+TEST(LatencyHistogramTest, empty_histogram) {
+  LatencyHistogram histogram;
+  ASSERT_EQ(histogram.Count(), 0u);
+  ASSERT_EQ(histogram.Min(), 0u);
+  ASSERT_EQ(histogram.Max(), 0u);
+  ASSERT_EQ(histogram.Mean(), 0u);
+  ASSERT_EQ(histogram.ValueAtPercentile(50.0), 0u);
+}
+
+TEST(LatencyHistogramTest, small_values_are_exact) {
+  for (uint64_t value = 0; value < LatencyHistogram::kSubBucketCount; value++) {
+    auto index = LatencyHistogram::BucketIndex(value);
+    ASSERT_EQ(LatencyHistogram::BucketHighestEquivalentValue(index), value);
+  }
+}
+
+TEST(LatencyHistogramTest, bucket_precision_is_bounded) {
+  for (uint64_t value = 1; value < (uint64_t{1} << LatencyHistogram::kMaxValueBits); value = value * 3 + 1) {
+    auto index = LatencyHistogram::BucketIndex(value);
+    ASSERT_LT(index, LatencyHistogram::kBucketCount);
+    auto highest = LatencyHistogram::BucketHighestEquivalentValue(index);
+    ASSERT_GE(highest, value);
+    ASSERT_LE(highest - value, value / LatencyHistogram::kSubBucketCount);
+  }
+}
+
+TEST(LatencyHistogramTest, bucket_indexes_are_contiguous) {
+  size_t previous = LatencyHistogram::BucketIndex(0);
+  for (uint64_t value = 1; value < 100000; value++) {
+    auto index = LatencyHistogram::BucketIndex(value);
+    ASSERT_TRUE(index == previous || index == previous + 1);
+    previous = index;
+  }
+}
+
+TEST(LatencyHistogramTest, huge_values_are_clamped) {
+  LatencyHistogram histogram;
+  histogram.Record(microseconds(INT64_MAX));
+  ASSERT_EQ(histogram.Count(), 1u);
+  ASSERT_EQ(histogram.Max(), (uint64_t{1} << LatencyHistogram::kMaxValueBits) - 1);
+  ASSERT_EQ(histogram.ValueAtPercentile(100.0), histogram.Max());
+}
+
+TEST(LatencyHistogramTest, percentiles) {
+  LatencyHistogram histogram;
+  for (int i = 1; i <= 1000; i++) {
+    histogram.Record(microseconds(i));
+  }
+  ASSERT_EQ(histogram.Count(), 1000u);
+  ASSERT_EQ(histogram.Min(), 1u);
+  ASSERT_EQ(histogram.Max(), 1000u);
+  ASSERT_EQ(histogram.Mean(), 500u);
+  auto p50 = histogram.ValueAtPercentile(50.0);
+  ASSERT_GE(p50, 500u);
+  ASSERT_LE(p50, 500u + 500u / LatencyHistogram::kSubBucketCount);
+  auto p99 = histogram.ValueAtPercentile(99.0);
+  ASSERT_GE(p99, 990u);
+  ASSERT_LE(p99, 1000u);
+  ASSERT_EQ(histogram.ValueAtPercentile(100.0), 1000u);
+}
+
+TEST(LatencyHistogramTest, reset) {
+  LatencyHistogram histogram;
+  histogram.Record(microseconds(42));
+  histogram.Reset();
+  ASSERT_EQ(histogram.Count(), 0u);
+  ASSERT_EQ(histogram.ValueAtPercentile(99.0), 0u);
+}
+
+std::vector<uint8_t> AclPacketForHandle(uint16_t handle) {
+  // Handle with packet boundary and broadcast flags set, to check that they are masked off
+  return {static_cast<uint8_t>(handle & 0xff), static_cast<uint8_t>(((handle >> 8) & 0x0f) | 0x20), 0x00, 0x00};
+}
+
+AclView AclViewOf(const std::vector<uint8_t>& packet) {
+  return AclView::Create(packet::PacketView<packet::kLittleEndian>(std::make_shared<std::vector<uint8_t>>(packet)));
+}
+
+TEST(AclLatencyTrackerTest, disabled_by_default) {
+  AclLatencyTracker tracker;
+  ASSERT_FALSE(tracker.IsEnabled());
+  auto packet = AclPacketForHandle(0x123);
+  tracker.OnHalReceive(packet.data(), packet.size());
+  tracker.OnQueueEndDequeue(AclViewOf(packet));
+  tracker.OnDelivered();
+  ASSERT_EQ(tracker.GetStageHistogram(Stage::TOTAL).Count(), 0u);
+  ASSERT_EQ(tracker.GetUnmatchedCount(), 0u);
+}
+
+TEST(AclLatencyTrackerTest, records_each_stage) {
+  AclLatencyTracker tracker;
+  tracker.SetEnabled(true);
+  auto packet = AclPacketForHandle(0x123);
+  tracker.OnHalReceive(packet.data(), packet.size());
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  tracker.OnQueueEndDequeue(AclViewOf(packet));
+  tracker.OnDelivered();
+
+  auto hci_layer = tracker.GetStageHistogram(Stage::HCI_LAYER);
+  ASSERT_EQ(hci_layer.Count(), 1u);
+  ASSERT_GE(hci_layer.Max(), 2000u);
+  ASSERT_EQ(tracker.GetStageHistogram(Stage::ACL_MANAGER).Count(), 1u);
+  auto total = tracker.GetStageHistogram(Stage::TOTAL);
+  ASSERT_EQ(total.Count(), 1u);
+  ASSERT_GE(total.Max(), hci_layer.Max());
+}
+
+TEST(AclLatencyTrackerTest, per_connection_histograms) {
+  AclLatencyTracker tracker;
+  tracker.SetEnabled(true);
+  auto first = AclPacketForHandle(0x001);
+  auto second = AclPacketForHandle(0x002);
+  tracker.OnHalReceive(first.data(), first.size());
+  tracker.OnHalReceive(second.data(), second.size());
+  tracker.OnHalReceive(second.data(), second.size());
+  for (const auto& packet : {first, second, second}) {
+    tracker.OnQueueEndDequeue(AclViewOf(packet));
+    tracker.OnDelivered();
+  }
+
+  ASSERT_EQ(tracker.GetConnectionStageHistogram(0x001, Stage::TOTAL).Count(), 1u);
+  ASSERT_EQ(tracker.GetConnectionStageHistogram(0x002, Stage::TOTAL).Count(), 2u);
+  ASSERT_EQ(tracker.GetConnectionStageHistogram(0x003, Stage::TOTAL).Count(), 0u);
+  ASSERT_EQ(tracker.GetStageHistogram(Stage::TOTAL).Count(), 3u);
+}
+
+TEST(AclLatencyTrackerTest, undelivered_packet_only_records_hci_layer_stage) {
+  AclLatencyTracker tracker;
+  tracker.SetEnabled(true);
+  auto packet = AclPacketForHandle(0x040);
+  tracker.OnHalReceive(packet.data(), packet.size());
+  tracker.OnQueueEndDequeue(AclViewOf(packet));
+  tracker.OnHalReceive(packet.data(), packet.size());
+  tracker.OnQueueEndDequeue(AclViewOf(packet));
+  tracker.OnDelivered();
+  // A stray delivery notification without a matching dequeue is ignored
+  tracker.OnDelivered();
+
+  ASSERT_EQ(tracker.GetStageHistogram(Stage::HCI_LAYER).Count(), 2u);
+  ASSERT_EQ(tracker.GetStageHistogram(Stage::ACL_MANAGER).Count(), 1u);
+  ASSERT_EQ(tracker.GetStageHistogram(Stage::TOTAL).Count(), 1u);
+}
+
+TEST(AclLatencyTrackerTest, unmatched_dequeue) {
+  AclLatencyTracker tracker;
+  tracker.SetEnabled(true);
+  tracker.OnQueueEndDequeue(AclViewOf(AclPacketForHandle(0x123)));
+  tracker.OnDelivered();
+  ASSERT_EQ(tracker.GetUnmatchedCount(), 1u);
+  ASSERT_EQ(tracker.GetStageHistogram(Stage::TOTAL).Count(), 0u);
+}
+
+TEST(AclLatencyTrackerTest, reset) {
+  AclLatencyTracker tracker;
+  tracker.SetEnabled(true);
+  auto packet = AclPacketForHandle(0x123);
+  tracker.OnHalReceive(packet.data(), packet.size());
+  tracker.OnQueueEndDequeue(AclViewOf(packet));
+  tracker.OnDelivered();
+  tracker.OnQueueEndDequeue(AclViewOf(packet));
+  tracker.Reset();
+  ASSERT_TRUE(tracker.IsEnabled());
+  ASSERT_EQ(tracker.GetUnmatchedCount(), 0u);
+  ASSERT_EQ(tracker.GetStageHistogram(Stage::TOTAL).Count(), 0u);
+  ASSERT_EQ(tracker.GetConnectionStageHistogram(0x123, Stage::TOTAL).Count(), 0u);
+}
+
+TEST(AclLatencyTrackerTest, stamps_are_matched_per_connection) {
+  AclLatencyTracker tracker;
+  tracker.SetEnabled(true);
+  auto first = AclPacketForHandle(0x001);
+  auto second = AclPacketForHandle(0x002);
+  tracker.OnHalReceive(first.data(), first.size());
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  tracker.OnHalReceive(second.data(), second.size());
+
+  // The packet of the second connection overtakes the first one, and is still matched to its own stamp
+  tracker.OnQueueEndDequeue(AclViewOf(second));
+  tracker.OnDelivered();
+  tracker.OnQueueEndDequeue(AclViewOf(first));
+  tracker.OnDelivered();
+
+  ASSERT_LT(tracker.GetConnectionStageHistogram(0x002, Stage::HCI_LAYER).Max(), 5000u);
+  ASSERT_GE(tracker.GetConnectionStageHistogram(0x001, Stage::HCI_LAYER).Max(), 5000u);
+  ASSERT_EQ(tracker.GetUnmatchedCount(), 0u);
+}
+
+TEST(AclLatencyTrackerTest, packets_without_stamps_of_their_connection_are_unmatched) {
+  AclLatencyTracker tracker;
+  tracker.SetEnabled(true);
+  auto first = AclPacketForHandle(0x001);
+  tracker.OnHalReceive(first.data(), first.size());
+  tracker.OnQueueEndDequeue(AclViewOf(AclPacketForHandle(0x002)));
+  tracker.OnDelivered();
+
+  ASSERT_EQ(tracker.GetUnmatchedCount(), 1u);
+  ASSERT_EQ(tracker.GetStageHistogram(Stage::HCI_LAYER).Count(), 0u);
+  tracker.OnQueueEndDequeue(AclViewOf(first));
+  ASSERT_EQ(tracker.GetConnectionStageHistogram(0x001, Stage::HCI_LAYER).Count(), 1u);
+}
+
+TEST(AclLatencyTrackerTest, in_flight_stamps_are_capped) {
+  AclLatencyTracker tracker;
+  tracker.SetEnabled(true);
+  auto packet = AclPacketForHandle(0x001);
+  for (size_t i = 0; i < AclLatencyTracker::kMaxInFlightPerHandle + 3; i++) {
+    tracker.OnHalReceive(packet.data(), packet.size());
+  }
+  ASSERT_EQ(tracker.GetDroppedCount(), 3u);
+
+  for (size_t i = 0; i < AclLatencyTracker::kMaxInFlightPerHandle + 1; i++) {
+    tracker.OnQueueEndDequeue(AclViewOf(packet));
+  }
+  ASSERT_EQ(tracker.GetStageHistogram(Stage::HCI_LAYER).Count(), AclLatencyTracker::kMaxInFlightPerHandle);
+  ASSERT_EQ(tracker.GetUnmatchedCount(), 1u);
+}
+
+TEST(AclLatencyTrackerTest, flush_resyncs_stamps) {
+  AclLatencyTracker tracker;
+  tracker.SetEnabled(true);
+  auto packet = AclPacketForHandle(0x001);
+  tracker.OnHalReceive(packet.data(), packet.size());
+  tracker.OnHalReceive(packet.data(), packet.size());
+  tracker.OnQueueEndDequeue(AclViewOf(packet));
+  tracker.Flush();
+  // Delivery of the packet dequeued before the flush is not recorded either
+  tracker.OnDelivered();
+  ASSERT_EQ(tracker.GetStageHistogram(Stage::TOTAL).Count(), 0u);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  tracker.OnHalReceive(packet.data(), packet.size());
+  tracker.OnQueueEndDequeue(AclViewOf(packet));
+  tracker.OnDelivered();
+  ASSERT_EQ(tracker.GetStageHistogram(Stage::TOTAL).Count(), 1u);
+  ASSERT_LT(tracker.GetStageHistogram(Stage::HCI_LAYER).Max(), 5000u);
+  ASSERT_EQ(tracker.GetUnmatchedCount(), 0u);
+}
+
+TEST(AclLatencyTrackerTest, disconnect_forgets_connection) {
+  AclLatencyTracker tracker;
+  tracker.SetEnabled(true);
+  auto first = AclPacketForHandle(0x001);
+  auto second = AclPacketForHandle(0x002);
+  tracker.OnHalReceive(first.data(), first.size());
+  tracker.OnQueueEndDequeue(AclViewOf(first));
+  tracker.OnDelivered();
+  tracker.OnHalReceive(first.data(), first.size());
+  tracker.OnHalReceive(second.data(), second.size());
+
+  tracker.OnDisconnect(0x001);
+  ASSERT_EQ(tracker.GetConnectionStageHistogram(0x001, Stage::TOTAL).Count(), 0u);
+  ASSERT_EQ(tracker.GetStageHistogram(Stage::TOTAL).Count(), 1u);
+
+  // A new connection reusing the handle does not inherit the stamps of the old one
+  tracker.OnQueueEndDequeue(AclViewOf(first));
+  ASSERT_EQ(tracker.GetUnmatchedCount(), 1u);
+  tracker.OnQueueEndDequeue(AclViewOf(second));
+  tracker.OnDelivered();
+  ASSERT_EQ(tracker.GetConnectionStageHistogram(0x002, Stage::TOTAL).Count(), 1u);
+}
+
+}  // namespace
+}  // namespace hci
+}  // namespace bluetooth
@@ -20,8 +20,11 @@
 #include <future>
 #include <mutex>
 #include <set>
+#include <vector>
 
 #include "common/bidi_queue.h"
+#include "common/strings.h"
+#include "hci/acl_latency_tracker.h"
 #include "hci/acl_manager/classic_impl.h"
 #include "hci/acl_manager/connection_management_callbacks.h"
 #include "hci/acl_manager/le_acl_connection.h"
@@ -30,6 +33,7 @@
 #include "hci/controller.h"
 #include "hci/hci_layer.h"
 #include "hci_acl_manager_generated.h"
+#include "os/system_properties.h"
 #include "security/security_module.h"
 #include "storage/storage_module.h"
 
@@ -37,6 +41,8 @@ namespace bluetooth {
 namespace hci {
 
 constexpr uint16_t kQualcommDebugHandle = 0xedc;
+constexpr char kAclSchedulerProperty[] = "persist.bluetooth.aclscheduler";
+constexpr char kAclFragmentBurstsProperty[] = "persist.bluetooth.aclfragmentbursts";
 
 using acl_manager::AclConnection;
 using common::Bind;
@@ -59,7 +65,18 @@ struct AclManager::impl {
     hci_layer_ = acl_manager_.GetDependency<HciLayer>();
     handler_ = acl_manager_.GetHandler();
     controller_ = acl_manager_.GetDependency<Controller>();
-    round_robin_scheduler_ = new RoundRobinScheduler(handler_, controller_, hci_layer_->GetAclQueueEnd());
+    auto scheduling_mode = RoundRobinScheduler::SchedulingMode::ROUND_ROBIN;
+    auto scheduler_prop = os::GetSystemProperty(kAclSchedulerProperty);
+    if (scheduler_prop.has_value() && common::StringTrim(scheduler_prop.value()) == "deficit_round_robin") {
+      scheduling_mode = RoundRobinScheduler::SchedulingMode::DEFICIT_ROUND_ROBIN;
+    }
+    round_robin_scheduler_ =
+        new RoundRobinScheduler(handler_, controller_, hci_layer_->GetAclQueueEnd(), scheduling_mode);
+    auto fragment_bursts_prop = os::GetSystemProperty(kAclFragmentBurstsProperty);
+    if (fragment_bursts_prop.has_value() && common::StringTrim(fragment_bursts_prop.value()) == "true") {
+      round_robin_scheduler_->SetFragmentBurstCallback(
+          common::Bind(&HciLayer::SendAclBurst, common::Unretained(hci_layer_)));
+    }
 
     hci_queue_end_ = hci_layer_->GetAclQueueEnd();
     hci_queue_end_->RegisterDequeue(
@@ -67,6 +84,7 @@ struct AclManager::impl {
     bool crash_on_unknown_handle = false;
     {
       const std::lock_guard<std::mutex> lock(dumpsys_mutex_);
+      acl_latency_tracker_ = hci_layer_->GetAclLatencyTracker();
       classic_impl_ =
           new classic_impl(hci_layer_, controller_, handler_, round_robin_scheduler_, crash_on_unknown_handle);
       le_impl_ = new le_impl(hci_layer_, controller_, handler_, round_robin_scheduler_, crash_on_unknown_handle);
@@ -80,6 +98,7 @@ struct AclManager::impl {
       delete classic_impl_;
       le_impl_ = nullptr;
       classic_impl_ = nullptr;
+      acl_latency_tracker_ = nullptr;
     }
 
     hci_queue_end_->UnregisterDequeue();
@@ -96,6 +115,7 @@ struct AclManager::impl {
   void dequeue_and_route_acl_packet_to_connection() {
     auto packet = hci_queue_end_->TryDequeue();
     ASSERT(packet != nullptr);
+    acl_latency_tracker_->OnQueueEndDequeue(*packet);
     if (!packet->IsValid()) {
       LOG_INFO("Dropping invalid packet of size %zu", packet->size());
       return;
@@ -103,11 +123,15 @@ struct AclManager::impl {
     uint16_t handle = packet->GetHandle();
     if (handle == kQualcommDebugHandle) return;
     if (classic_impl_->send_packet_upward(
-            handle, [&packet](struct acl_manager::assembler* assembler) { assembler->on_incoming_packet(*packet); }))
+            handle, [&packet](struct acl_manager::assembler* assembler) { assembler->on_incoming_packet(*packet); })) {
+      acl_latency_tracker_->OnDelivered();
       return;
+    }
     if (le_impl_->send_packet_upward(
-            handle, [&packet](struct acl_manager::assembler* assembler) { assembler->on_incoming_packet(*packet); }))
+            handle, [&packet](struct acl_manager::assembler* assembler) { assembler->on_incoming_packet(*packet); })) {
+      acl_latency_tracker_->OnDelivered();
       return;
+    }
     LOG_INFO("Dropping packet of size %zu to unknown connection 0x%0hx", packet->size(), packet->GetHandle());
   }
 
@@ -121,6 +145,7 @@ struct AclManager::impl {
   os::Handler* handler_ = nullptr;
   Controller* controller_ = nullptr;
   HciLayer* hci_layer_ = nullptr;
+  AclLatencyTracker* acl_latency_tracker_ = nullptr;
   RoundRobinScheduler* round_robin_scheduler_ = nullptr;
   common::BidiQueueEnd<AclBuilder, AclView>* hci_queue_end_ = nullptr;
   std::atomic_bool enqueue_registered_ = false;
@@ -307,6 +332,10 @@ void AclManager::HACK_SetNonAclDisconnectCallback(std::function<void(uint16_t, u
   pimpl_->classic_impl_->HACK_SetNonAclDisconnectCallback(callback);
 }
 
+void AclManager::SetAclTrafficClass(uint16_t handle, acl_manager::DeficitRoundRobin::TrafficClass traffic_class) {
+  CallOn(pimpl_->round_robin_scheduler_, &RoundRobinScheduler::SetLinkTrafficClass, handle, traffic_class);
+}
+
 void AclManager::HACK_SetAclTxPriority(uint8_t handle, bool high_priority) {
   CallOn(pimpl_->round_robin_scheduler_, &RoundRobinScheduler::SetLinkPriority, handle, high_priority);
 }
@@ -352,6 +381,24 @@ void AclManager::impl::Dump(
     strings[cnt++] = fb_builder->CreateString(it.ToString());
   }
   auto vecofstrings = fb_builder->CreateVector(strings, connect_list.size());
+  auto acl_latency_data = (acl_latency_tracker_ != nullptr) ? acl_latency_tracker_->GetDumpsysData(fb_builder)
+                                                             : flatbuffers::Offset<AclLatencyData>();
+
+  const auto le_waiting_connect_list_count =
+      (le_impl_ != nullptr) ? (int)le_impl_->waiting_connect_list_.size() : 0;
+  std::vector<flatbuffers::Offset<LeConnectLatencyData>> le_connect_latencies;
+  if (le_impl_ != nullptr) {
+    for (const auto& it : le_impl_->connect_latencies_) {
+      auto address = fb_builder->CreateString(it.address_with_type.ToString());
+      auto status = fb_builder->CreateString(ErrorCodeText(it.status));
+      LeConnectLatencyDataBuilder latency_builder(*fb_builder);
+      latency_builder.add_address(address);
+      latency_builder.add_latency_ms(it.latency.count());
+      latency_builder.add_status(status);
+      le_connect_latencies.push_back(latency_builder.Finish());
+    }
+  }
+  auto le_connect_latencies_vector = fb_builder->CreateVector(le_connect_latencies);
 
   AclManagerDataBuilder builder(*fb_builder);
   builder.add_title(title);
@@ -359,6 +406,9 @@ void AclManager::impl::Dump(
   builder.add_le_filter_accept_list(vecofstrings);
   builder.add_le_connectability_state(le_connectability_state);
   builder.add_le_create_connection_timeout_alarms_count(le_create_connection_timeout_alarms_count);
+  builder.add_acl_latency_data(acl_latency_data);
+  builder.add_le_waiting_connect_list_count(le_waiting_connect_list_count);
+  builder.add_le_connect_latencies(le_connect_latencies_vector);
 
   flatbuffers::Offset<AclManagerData> dumpsys_data = builder.Finish();
   promise.set_value(dumpsys_data);
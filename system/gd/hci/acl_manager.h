@@ -23,6 +23,7 @@
 #include "common/bidi_queue.h"
 #include "common/callback.h"
 #include "hci/acl_manager/connection_callbacks.h"
+#include "hci/acl_manager/deficit_round_robin.h"
 #include "hci/acl_manager/le_connection_callbacks.h"
 #include "hci/address.h"
 #include "hci/address_with_type.h"
@@ -125,6 +126,9 @@ public:
  virtual uint16_t ReadDefaultLinkPolicySettings();
  virtual void WriteDefaultLinkPolicySettings(uint16_t default_link_policy_settings);
 
+ // Traffic class of the packets sent over the connection, to share the controller buffers between connections
+ virtual void SetAclTrafficClass(uint16_t handle, acl_manager::DeficitRoundRobin::TrafficClass traffic_class);
+
  // Callback from Advertising Manager to notify the advitiser (local) address
  virtual void OnAdvertisingSetTerminated(ErrorCode status, uint16_t conn_handle, hci::AddressWithType adv_address);
 
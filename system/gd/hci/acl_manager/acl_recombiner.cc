@@ -0,0 +1,99 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/acl_manager/acl_recombiner.h"
+
+#include "os/log.h"
+#include "packet/packet_buffer_pool.h"
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+
+namespace {
+
+void AppendPayload(std::vector<uint8_t>& buffer, const packet::PacketView<packet::kLittleEndian>& payload) {
+  const uint8_t* data = payload.GetContiguousData();
+  if (data != nullptr) {
+    buffer.insert(buffer.end(), data, data + payload.size());
+  } else {
+    buffer.insert(buffer.end(), payload.begin(), payload.end());
+  }
+}
+
+}  // namespace
+
+std::optional<packet::PacketView<packet::kLittleEndian>> AclRecombiner::OnIncomingPacket(AclView packet) {
+  packet::PacketView<packet::kLittleEndian> payload = packet.GetPayload();
+  size_t payload_size = payload.size();
+  if (packet.GetBroadcastFlag() == BroadcastFlag::ACTIVE_PERIPHERAL_BROADCAST) {
+    LOG_WARN("Dropping broadcast from remote");
+    return std::nullopt;
+  }
+  auto packet_boundary_flag = packet.GetPacketBoundaryFlag();
+  if (packet_boundary_flag == PacketBoundaryFlag::FIRST_NON_AUTOMATICALLY_FLUSHABLE) {
+    LOG_ERROR("Controller is not allowed to send FIRST_NON_AUTOMATICALLY_FLUSHABLE to host except loopback mode");
+    return std::nullopt;
+  }
+
+  if (packet_boundary_flag == PacketBoundaryFlag::CONTINUING_FRAGMENT) {
+    if (!IsRecombining() || remaining_size_ < payload_size) {
+      LOG_WARN("Remote sent unexpected L2CAP PDU. Drop the entire L2CAP PDU");
+      Reset();
+      return std::nullopt;
+    }
+    AppendPayload(*buffer_, payload);
+    remaining_size_ -= payload_size;
+    if (remaining_size_ != 0) {
+      return std::nullopt;
+    }
+    packet::PacketView<packet::kLittleEndian> pdu(std::move(buffer_));
+    Reset();
+    return pdu;
+  }
+
+  if (IsRecombining()) {
+    LOG_ERROR("Controller sent a starting packet without finishing previous packet. Drop previous one.");
+    Reset();
+  }
+  // Per spec 5.1 Vol 2 Part B 5.3, ACL link shall carry L2CAP data, so a starting packet begins with the L2CAP
+  // basic header
+  if (payload_size < kL2capBasicFrameHeaderSize) {
+    LOG_ERROR("Controller sent an invalid L2CAP starting packet!");
+    return std::nullopt;
+  }
+  size_t pdu_size = kL2capBasicFrameHeaderSize + ((payload.at(1) << 8u) | payload.at(0));
+  if (payload_size > pdu_size) {
+    LOG_WARN("Remote sent a starting packet longer than its L2CAP PDU. Drop the entire L2CAP PDU");
+    return std::nullopt;
+  }
+  if (payload_size == pdu_size) {
+    return payload;
+  }
+  buffer_ = packet::PacketBufferPool::Get().Acquire(pdu_size);
+  AppendPayload(*buffer_, payload);
+  remaining_size_ = pdu_size - payload_size;
+  return std::nullopt;
+}
+
+void AclRecombiner::Reset() {
+  buffer_.reset();
+  remaining_size_ = 0;
+}
+
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
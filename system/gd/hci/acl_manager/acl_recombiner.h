@@ -0,0 +1,57 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "hci/hci_packets.h"
+#include "packet/packet_view.h"
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+
+constexpr size_t kL2capBasicFrameHeaderSize = 4;
+
+// Recombines the L2CAP PDUs received over one ACL connection from their ACL fragments. A PDU that fits in its first
+// fragment is passed on as is. The fragments of a longer PDU are copied into a single buffer from the packet buffer
+// pool, sized from the length in the L2CAP basic header, so L2CAP gets one contiguous PDU.
+class AclRecombiner {
+ public:
+  // Returns the L2CAP PDU completed by |packet|, if any. Invalid fragments are dropped, together with the PDU they
+  // belong to.
+  std::optional<packet::PacketView<packet::kLittleEndian>> OnIncomingPacket(AclView packet);
+
+  // Whether a PDU is waiting for continuation fragments
+  bool IsRecombining() const {
+    return buffer_ != nullptr;
+  }
+
+ private:
+  void Reset();
+
+  std::shared_ptr<std::vector<uint8_t>> buffer_;
+  size_t remaining_size_ = 0;
+};
+
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
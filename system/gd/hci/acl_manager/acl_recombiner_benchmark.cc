@@ -0,0 +1,93 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "hci/acl_manager/acl_recombiner.h"
+#include "hci/hci_packets.h"
+#include "packet/bit_inserter.h"
+#include "packet/raw_builder.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+namespace {
+
+// Recombines L2CAP PDUs of state.range(0) bytes, including the basic header, received in ACL packets of at most
+// state.range(1) bytes of payload. The fragments are built once, outside of the timed loop.
+void BM_AclRecombination(State& state) {
+  const size_t pdu_size = state.range(0);
+  const size_t mtu = state.range(1);
+  std::vector<uint8_t> pdu(pdu_size);
+  pdu[0] = static_cast<uint8_t>(pdu_size - kL2capBasicFrameHeaderSize);
+  pdu[1] = static_cast<uint8_t>((pdu_size - kL2capBasicFrameHeaderSize) >> 8);
+  pdu[2] = 0x40;
+
+  std::vector<AclView> fragments;
+  for (size_t offset = 0; offset < pdu_size; offset += mtu) {
+    size_t end = std::min(pdu_size, offset + mtu);
+    auto payload = std::make_unique<packet::RawBuilder>();
+    payload->AddOctets(std::vector<uint8_t>(pdu.begin() + offset, pdu.begin() + end));
+    auto builder = AclBuilder::Create(
+        0x0040,
+        offset == 0 ? PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE : PacketBoundaryFlag::CONTINUING_FRAGMENT,
+        BroadcastFlag::POINT_TO_POINT,
+        std::move(payload));
+    auto bytes = std::make_shared<std::vector<uint8_t>>();
+    packet::BitInserter it(*bytes);
+    builder->Serialize(it);
+    fragments.push_back(AclView::Create(packet::PacketView<packet::kLittleEndian>(bytes)));
+    if (!fragments.back().IsValid()) {
+      state.SkipWithError("Invalid ACL fragment");
+      return;
+    }
+  }
+
+  AclRecombiner recombiner;
+  for (auto _ : state) {
+    for (const auto& fragment : fragments) {
+      auto result = recombiner.OnIncomingPacket(fragment);
+      if (result) {
+        // L2CAP reads the basic header of every PDU
+        benchmark::DoNotOptimize(result->at(2));
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetBytesProcessed(state.iterations() * pdu_size);
+}
+
+}  // namespace
+
+// Unfragmented LE signaling and ATT PDUs, ATT writes over LE Data Length Extension packets, A2DP media over 2-DH5
+// and 3-DH5 packets, and the largest L2CAP PDU over 3-DH5 packets
+BENCHMARK(BM_AclRecombination)
+    ->Args({27, 27})
+    ->Args({251, 251})
+    ->Args({517, 251})
+    ->Args({895, 679})
+    ->Args({1021, 1021})
+    ->Args({2048, 1021})
+    ->Args({65535, 1021});
+
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
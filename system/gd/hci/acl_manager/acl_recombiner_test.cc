@@ -0,0 +1,173 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/acl_manager/acl_recombiner.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "packet/bit_inserter.h"
+#include "packet/packet_buffer_pool.h"
+#include "packet/raw_builder.h"
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+namespace {
+
+constexpr uint16_t kHandle = 0x0040;
+
+// An L2CAP basic frame on channel 0x0040 with |payload_size| counting bytes
+std::vector<uint8_t> MakePdu(uint16_t payload_size) {
+  std::vector<uint8_t> pdu = {static_cast<uint8_t>(payload_size), static_cast<uint8_t>(payload_size >> 8), 0x40, 0x00};
+  for (uint16_t i = 0; i < payload_size; i++) {
+    pdu.push_back(static_cast<uint8_t>(i));
+  }
+  return pdu;
+}
+
+AclView MakeAcl(
+    std::vector<uint8_t> payload,
+    PacketBoundaryFlag packet_boundary_flag,
+    BroadcastFlag broadcast_flag = BroadcastFlag::POINT_TO_POINT) {
+  auto payload_builder = std::make_unique<packet::RawBuilder>();
+  payload_builder->AddOctets(payload);
+  auto builder = AclBuilder::Create(kHandle, packet_boundary_flag, broadcast_flag, std::move(payload_builder));
+  auto bytes = std::make_shared<std::vector<uint8_t>>();
+  packet::BitInserter it(*bytes);
+  builder->Serialize(it);
+  auto view = AclView::Create(packet::PacketView<packet::kLittleEndian>(bytes));
+  EXPECT_TRUE(view.IsValid());
+  return view;
+}
+
+// Split |pdu| into ACL packets of at most |mtu| bytes
+std::vector<AclView> Fragment(const std::vector<uint8_t>& pdu, size_t mtu) {
+  std::vector<AclView> fragments;
+  for (size_t offset = 0; offset < pdu.size(); offset += mtu) {
+    size_t end = std::min(pdu.size(), offset + mtu);
+    fragments.push_back(MakeAcl(
+        std::vector<uint8_t>(pdu.begin() + offset, pdu.begin() + end),
+        offset == 0 ? PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE : PacketBoundaryFlag::CONTINUING_FRAGMENT));
+  }
+  return fragments;
+}
+
+std::vector<uint8_t> ToVector(const packet::PacketView<packet::kLittleEndian>& view) {
+  return std::vector<uint8_t>(view.begin(), view.end());
+}
+
+TEST(AclRecombinerTest, unfragmented_pdu_is_passed_on) {
+  AclRecombiner recombiner;
+  auto pdu = MakePdu(20);
+  auto result = recombiner.OnIncomingPacket(MakeAcl(pdu, PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE));
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(ToVector(*result), pdu);
+  EXPECT_FALSE(recombiner.IsRecombining());
+}
+
+TEST(AclRecombinerTest, fragmented_pdu_is_contiguous) {
+  AclRecombiner recombiner;
+  auto pdu = MakePdu(1000);
+  auto fragments = Fragment(pdu, 27);
+  for (size_t i = 0; i + 1 < fragments.size(); i++) {
+    ASSERT_FALSE(recombiner.OnIncomingPacket(fragments[i]).has_value());
+    ASSERT_TRUE(recombiner.IsRecombining());
+  }
+  auto result = recombiner.OnIncomingPacket(fragments.back());
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(ToVector(*result), pdu);
+  EXPECT_NE(result->GetContiguousData(), nullptr);
+  EXPECT_FALSE(recombiner.IsRecombining());
+}
+
+TEST(AclRecombinerTest, recombination_buffer_comes_from_pool) {
+  packet::PacketBufferPool::Get().Clear();
+  AclRecombiner recombiner;
+  auto pdu = MakePdu(600);
+  {
+    std::optional<packet::PacketView<packet::kLittleEndian>> result;
+    for (auto& fragment : Fragment(pdu, 251)) {
+      result = recombiner.OnIncomingPacket(fragment);
+    }
+    ASSERT_TRUE(result.has_value());
+  }
+  // The 604 byte PDU buffer went back to the BR/EDR ACL size class
+  EXPECT_EQ(packet::PacketBufferPool::Get().GetFreeBufferCount(2), 1u);
+  packet::PacketBufferPool::Get().Clear();
+}
+
+TEST(AclRecombinerTest, unexpected_continuation_is_dropped) {
+  AclRecombiner recombiner;
+  EXPECT_FALSE(recombiner.OnIncomingPacket(MakeAcl({1, 2, 3}, PacketBoundaryFlag::CONTINUING_FRAGMENT)).has_value());
+  EXPECT_FALSE(recombiner.IsRecombining());
+}
+
+TEST(AclRecombinerTest, overlong_continuation_drops_pdu) {
+  AclRecombiner recombiner;
+  auto pdu = MakePdu(30);
+  auto fragments = Fragment(pdu, 20);
+  ASSERT_FALSE(recombiner.OnIncomingPacket(fragments[0]).has_value());
+  EXPECT_FALSE(
+      recombiner.OnIncomingPacket(MakeAcl(std::vector<uint8_t>(40), PacketBoundaryFlag::CONTINUING_FRAGMENT))
+          .has_value());
+  EXPECT_FALSE(recombiner.IsRecombining());
+  // The rest of the dropped PDU is dropped too
+  EXPECT_FALSE(recombiner.OnIncomingPacket(fragments[1]).has_value());
+}
+
+TEST(AclRecombinerTest, new_start_drops_unfinished_pdu) {
+  AclRecombiner recombiner;
+  auto first = Fragment(MakePdu(100), 50);
+  auto second = MakePdu(10);
+  ASSERT_FALSE(recombiner.OnIncomingPacket(first[0]).has_value());
+  auto result = recombiner.OnIncomingPacket(MakeAcl(second, PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE));
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(ToVector(*result), second);
+  EXPECT_FALSE(recombiner.IsRecombining());
+}
+
+TEST(AclRecombinerTest, invalid_starting_packets_are_dropped) {
+  AclRecombiner recombiner;
+  // Shorter than the L2CAP basic header
+  EXPECT_FALSE(
+      recombiner.OnIncomingPacket(MakeAcl({0x01, 0x00}, PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE))
+          .has_value());
+  // Longer than the PDU length it announces
+  auto pdu = MakePdu(4);
+  pdu.push_back(0xff);
+  EXPECT_FALSE(
+      recombiner.OnIncomingPacket(MakeAcl(pdu, PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE)).has_value());
+  EXPECT_FALSE(
+      recombiner.OnIncomingPacket(MakeAcl(MakePdu(4), PacketBoundaryFlag::FIRST_NON_AUTOMATICALLY_FLUSHABLE))
+          .has_value());
+  EXPECT_FALSE(recombiner
+                   .OnIncomingPacket(MakeAcl(
+                       MakePdu(4),
+                       PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE,
+                       BroadcastFlag::ACTIVE_PERIPHERAL_BROADCAST))
+                   .has_value());
+  EXPECT_FALSE(recombiner.IsRecombining());
+}
+
+}  // namespace
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
@@ -16,11 +16,15 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <optional>
 
 #include "hci/acl_manager/acl_connection.h"
+#include "hci/acl_manager/acl_recombiner.h"
 #include "hci/address_with_type.h"
 #include "os/handler.h"
 #include "os/log.h"
@@ -31,29 +35,6 @@ namespace hci {
 namespace acl_manager {
 
 constexpr size_t kMaxQueuedPacketsPerConnection = 10;
-constexpr size_t kL2capBasicFrameHeaderSize = 4;
-
-namespace {
-class PacketViewForRecombination : public packet::PacketView<packet::kLittleEndian> {
- public:
-  PacketViewForRecombination(const PacketView& packetView) : PacketView(packetView) {}
-  void AppendPacketView(packet::PacketView<packet::kLittleEndian> to_append) {
-    Append(to_append);
-  }
-};
-
-// Per spec 5.1 Vol 2 Part B 5.3, ACL link shall carry L2CAP data. Therefore, an ACL packet shall contain L2CAP PDU.
-// This function returns the PDU size of the L2CAP data if it's a starting packet. Returns 0 if it's invalid.
-uint16_t GetL2capPduSize(AclView packet) {
-  auto l2cap_payload = packet.GetPayload();
-  if (l2cap_payload.size() < kL2capBasicFrameHeaderSize) {
-    LOG_ERROR("Controller sent an invalid L2CAP starting packet!");
-    return 0;
-  }
-  return (l2cap_payload.at(1) << 8u) + l2cap_payload.at(0);
-}
-
-}  // namespace
 
 struct assembler {
   assembler(AddressWithType address_with_type, AclConnection::QueueDownEnd* down_end, os::Handler* handler)
@@ -61,11 +42,12 @@ struct assembler {
   AddressWithType address_with_type_;
   AclConnection::QueueDownEnd* down_end_;
   os::Handler* handler_;
-  PacketViewForRecombination recombination_stage_{
-      PacketView<packet::kLittleEndian>(std::make_shared<std::vector<uint8_t>>())};
-  size_t remaining_sdu_continuation_packet_size_ = 0;
+  AclRecombiner recombiner_;
   std::shared_ptr<std::atomic_bool> enqueue_registered_ = std::make_shared<std::atomic_bool>(false);
-  std::queue<packet::PacketView<packet::kLittleEndian>> incoming_queue_;
+  // Complete L2CAP PDUs waiting for the connection queue, in a fixed ring so queueing them does not allocate
+  std::array<std::optional<packet::PacketView<packet::kLittleEndian>>, kMaxQueuedPacketsPerConnection> incoming_queue_;
+  size_t incoming_queue_head_ = 0;
+  size_t incoming_queue_size_ = 0;
 
   ~assembler() {
     if (enqueue_registered_->exchange(false)) {
@@ -75,61 +57,29 @@ struct assembler {
 
   // Invoked from some external Queue Reactable context
   std::unique_ptr<packet::PacketView<packet::kLittleEndian>> on_le_incoming_data_ready() {
-    auto packet = incoming_queue_.front();
-    incoming_queue_.pop();
-    if (incoming_queue_.empty() && enqueue_registered_->exchange(false)) {
+    auto& slot = incoming_queue_[incoming_queue_head_];
+    auto packet = std::make_unique<packet::PacketView<packet::kLittleEndian>>(std::move(*slot));
+    slot.reset();
+    incoming_queue_head_ = (incoming_queue_head_ + 1) % incoming_queue_.size();
+    incoming_queue_size_--;
+    if (incoming_queue_size_ == 0 && enqueue_registered_->exchange(false)) {
       down_end_->UnregisterEnqueue();
     }
-    return std::make_unique<PacketView<packet::kLittleEndian>>(packet);
+    return packet;
   }
 
   void on_incoming_packet(AclView packet) {
-    PacketView<packet::kLittleEndian> payload = packet.GetPayload();
-    auto payload_size = payload.size();
-    auto broadcast_flag = packet.GetBroadcastFlag();
-    if (broadcast_flag == BroadcastFlag::ACTIVE_PERIPHERAL_BROADCAST) {
-      LOG_WARN("Dropping broadcast from remote");
-      return;
-    }
-    auto packet_boundary_flag = packet.GetPacketBoundaryFlag();
-    if (packet_boundary_flag == PacketBoundaryFlag::FIRST_NON_AUTOMATICALLY_FLUSHABLE) {
-      LOG_ERROR("Controller is not allowed to send FIRST_NON_AUTOMATICALLY_FLUSHABLE to host except loopback mode");
+    auto pdu = recombiner_.OnIncomingPacket(packet);
+    if (!pdu) {
       return;
     }
-    if (packet_boundary_flag == PacketBoundaryFlag::CONTINUING_FRAGMENT) {
-      if (remaining_sdu_continuation_packet_size_ < payload_size) {
-        LOG_WARN("Remote sent unexpected L2CAP PDU. Drop the entire L2CAP PDU");
-        recombination_stage_ =
-            PacketViewForRecombination(PacketView<packet::kLittleEndian>(std::make_shared<std::vector<uint8_t>>()));
-        remaining_sdu_continuation_packet_size_ = 0;
-        return;
-      }
-      remaining_sdu_continuation_packet_size_ -= payload_size;
-      recombination_stage_.AppendPacketView(payload);
-      if (remaining_sdu_continuation_packet_size_ != 0) {
-        return;
-      } else {
-        payload = recombination_stage_;
-        recombination_stage_ =
-            PacketViewForRecombination(PacketView<packet::kLittleEndian>(std::make_shared<std::vector<uint8_t>>()));
-      }
-    } else if (packet_boundary_flag == PacketBoundaryFlag::FIRST_AUTOMATICALLY_FLUSHABLE) {
-      if (recombination_stage_.size() > 0) {
-        LOG_ERROR("Controller sent a starting packet without finishing previous packet. Drop previous one.");
-      }
-      auto l2cap_pdu_size = GetL2capPduSize(packet);
-      remaining_sdu_continuation_packet_size_ = l2cap_pdu_size - (payload_size - kL2capBasicFrameHeaderSize);
-      if (remaining_sdu_continuation_packet_size_ > 0) {
-        recombination_stage_ = payload;
-        return;
-      }
-    }
-    if (incoming_queue_.size() > kMaxQueuedPacketsPerConnection) {
+    if (incoming_queue_size_ == incoming_queue_.size()) {
       LOG_ERROR("Dropping packet from %s due to congestion", address_with_type_.ToString().c_str());
       return;
     }
 
-    incoming_queue_.push(payload);
+    incoming_queue_[(incoming_queue_head_ + incoming_queue_size_) % incoming_queue_.size()].emplace(std::move(*pdu));
+    incoming_queue_size_++;
     if (!enqueue_registered_->exchange(true)) {
       down_end_->RegisterEnqueue(handler_,
                                  common::Bind(&assembler::on_le_incoming_data_ready, common::Unretained(this)));
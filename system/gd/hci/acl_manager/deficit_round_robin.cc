@@ -0,0 +1,194 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/acl_manager/deficit_round_robin.h"
+
+#include <algorithm>
+
+#include "os/log.h"
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+
+namespace {
+constexpr uint8_t kNoBudgetLimit = 100;
+}  // namespace
+
+DeficitRoundRobin::DeficitRoundRobin(size_t quantum) : quantum_(quantum) {
+  ASSERT(quantum_ > 0);
+  class_budgets_.fill(kNoBudgetLimit);
+}
+
+void DeficitRoundRobin::AddLink(uint16_t handle, size_t buffer, TrafficClass traffic_class) {
+  ASSERT(buffer < kBufferCount);
+  ASSERT_LOG(links_.count(handle) == 0, "handle 0x%hx is already scheduled", handle);
+  Link link;
+  link.buffer = buffer;
+  link.traffic_class = traffic_class;
+  links_.emplace(handle, link);
+}
+
+void DeficitRoundRobin::RemoveLink(uint16_t handle) {
+  auto it = links_.find(handle);
+  if (it == links_.end()) {
+    return;
+  }
+  auto& link = it->second;
+  class_outstanding_[static_cast<size_t>(link.traffic_class)][link.buffer] -= link.outstanding;
+  links_.erase(it);
+  if (current_ == handle) {
+    current_.reset();
+  }
+}
+
+bool DeficitRoundRobin::HasLink(uint16_t handle) const {
+  return links_.count(handle) != 0;
+}
+
+void DeficitRoundRobin::SetWeight(uint16_t handle, uint16_t weight) {
+  auto it = links_.find(handle);
+  if (it == links_.end()) {
+    LOG_WARN("handle 0x%hx is not scheduled", handle);
+    return;
+  }
+  it->second.weight = std::max<uint16_t>(weight, 1);
+}
+
+void DeficitRoundRobin::SetTrafficClass(uint16_t handle, TrafficClass traffic_class) {
+  auto it = links_.find(handle);
+  if (it == links_.end()) {
+    LOG_WARN("handle 0x%hx is not scheduled", handle);
+    return;
+  }
+  auto& link = it->second;
+  class_outstanding_[static_cast<size_t>(link.traffic_class)][link.buffer] -= link.outstanding;
+  class_outstanding_[static_cast<size_t>(traffic_class)][link.buffer] += link.outstanding;
+  link.traffic_class = traffic_class;
+}
+
+void DeficitRoundRobin::SetBufferSize(size_t buffer, uint16_t num_packets) {
+  ASSERT(buffer < kBufferCount);
+  buffer_sizes_[buffer] = num_packets;
+}
+
+void DeficitRoundRobin::SetClassBudget(TrafficClass traffic_class, uint8_t percent) {
+  class_budgets_[static_cast<size_t>(traffic_class)] = std::min(percent, kNoBudgetLimit);
+}
+
+void DeficitRoundRobin::SetPendingPacketSize(uint16_t handle, size_t size) {
+  auto it = links_.find(handle);
+  ASSERT(it != links_.end());
+  it->second.pending_size = size;
+}
+
+bool DeficitRoundRobin::HasPendingPacket(uint16_t handle) const {
+  auto it = links_.find(handle);
+  return it != links_.end() && it->second.pending_size != 0;
+}
+
+std::optional<uint16_t> DeficitRoundRobin::SelectNext(const std::function<bool(uint16_t handle)>& has_credits) {
+  if (links_.empty()) {
+    return std::nullopt;
+  }
+  auto it = current_.has_value() ? links_.lower_bound(current_.value()) : links_.begin();
+  if (it == links_.end()) {
+    it = links_.begin();
+  }
+
+  // Packets bigger than the quantum take several rounds of deficit to send, so keep going around as long as at
+  // least one backlogged link is allowed to send.
+  bool found_eligible_link = true;
+  while (found_eligible_link) {
+    found_eligible_link = false;
+    for (size_t count = links_.size(); count > 0; count--, it = next_link(it)) {
+      auto& link = it->second;
+      if (link.pending_size == 0) {
+        // Idle links do not bank deficit
+        link.deficit = 0;
+        link.quantum_granted = false;
+        continue;
+      }
+      if (!has_credits(it->first) || is_over_budget(link)) {
+        continue;
+      }
+      found_eligible_link = true;
+      if (!link.quantum_granted) {
+        link.deficit += static_cast<int64_t>(link.weight) * quantum_;
+        link.quantum_granted = true;
+      }
+      if (link.deficit >= static_cast<int64_t>(link.pending_size)) {
+        link.deficit -= link.pending_size;
+        link.pending_size = 0;
+        // Stay on this link so that it can use the rest of its deficit for its next packet
+        current_ = it->first;
+        return it->first;
+      }
+      link.quantum_granted = false;
+    }
+  }
+  return std::nullopt;
+}
+
+void DeficitRoundRobin::OnFragmentsSent(uint16_t handle, uint16_t num_fragments) {
+  auto it = links_.find(handle);
+  if (it == links_.end()) {
+    return;
+  }
+  auto& link = it->second;
+  link.outstanding += num_fragments;
+  class_outstanding_[static_cast<size_t>(link.traffic_class)][link.buffer] += num_fragments;
+}
+
+void DeficitRoundRobin::OnFragmentsCompleted(uint16_t handle, uint16_t num_fragments) {
+  auto it = links_.find(handle);
+  if (it == links_.end()) {
+    return;
+  }
+  auto& link = it->second;
+  num_fragments = std::min(num_fragments, link.outstanding);
+  link.outstanding -= num_fragments;
+  class_outstanding_[static_cast<size_t>(link.traffic_class)][link.buffer] -= num_fragments;
+}
+
+uint16_t DeficitRoundRobin::GetClassOutstanding(TrafficClass traffic_class, size_t buffer) const {
+  ASSERT(buffer < kBufferCount);
+  return class_outstanding_[static_cast<size_t>(traffic_class)][buffer];
+}
+
+int64_t DeficitRoundRobin::GetDeficit(uint16_t handle) const {
+  auto it = links_.find(handle);
+  return it == links_.end() ? 0 : it->second.deficit;
+}
+
+bool DeficitRoundRobin::is_over_budget(const Link& link) const {
+  uint8_t percent = class_budgets_[static_cast<size_t>(link.traffic_class)];
+  if (percent >= kNoBudgetLimit) {
+    return false;
+  }
+  uint16_t limit = std::max<uint16_t>(1, buffer_sizes_[link.buffer] * percent / 100);
+  return class_outstanding_[static_cast<size_t>(link.traffic_class)][link.buffer] >= limit;
+}
+
+std::map<uint16_t, DeficitRoundRobin::Link>::iterator DeficitRoundRobin::next_link(
+    std::map<uint16_t, Link>::iterator it) {
+  it = std::next(it);
+  return it == links_.end() ? links_.begin() : it;
+}
+
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
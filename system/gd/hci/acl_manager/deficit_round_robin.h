@@ -0,0 +1,98 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <array>
+#include <functional>
+#include <map>
+#include <optional>
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+
+// Deficit round-robin selection of the next link allowed to send an ACL packet.
+//
+// Every link earns |weight| * quantum bytes each time its turn comes around and may send packets for as long as
+// its deficit covers them, so links share the controller buffers in proportion to their weights whatever their
+// packet sizes. Links are also assigned a traffic class, and each class can be limited to a percentage of each
+// controller buffer so one class of traffic cannot hold all the credits.
+//
+// The policy only keeps the accounting. The caller tells it the size of the packet waiting at the head of each
+// link, asks it which link should go next, and reports fragments sent to and completed by the controller.
+class DeficitRoundRobin {
+ public:
+  enum class TrafficClass { BULK = 0, INTERACTIVE = 1, AUDIO = 2 };
+  static constexpr size_t kTrafficClassCount = 3;
+  // Controller buffers are indexed by the caller, one entry per buffer (e.g. BR/EDR and LE)
+  static constexpr size_t kBufferCount = 2;
+  static constexpr uint16_t kDefaultWeight = 1;
+
+  explicit DeficitRoundRobin(size_t quantum);
+
+  void AddLink(uint16_t handle, size_t buffer, TrafficClass traffic_class = TrafficClass::BULK);
+  void RemoveLink(uint16_t handle);
+  bool HasLink(uint16_t handle) const;
+
+  void SetWeight(uint16_t handle, uint16_t weight);
+  void SetTrafficClass(uint16_t handle, TrafficClass traffic_class);
+  // Number of packets |buffer| can hold in the controller, used to turn class budgets into packet counts
+  void SetBufferSize(size_t buffer, uint16_t num_packets);
+  // Limit links of |traffic_class| to |percent| of every controller buffer. 100 (the default) means no limit.
+  void SetClassBudget(TrafficClass traffic_class, uint8_t percent);
+
+  // Size of the packet waiting at the head of the link queue, 0 if there is none
+  void SetPendingPacketSize(uint16_t handle, size_t size);
+  bool HasPendingPacket(uint16_t handle) const;
+
+  // Pick the link to send its pending packet next and charge the packet to its deficit. Links for which
+  // |has_credits| returns false, or whose class is over budget, are skipped without losing their deficit.
+  std::optional<uint16_t> SelectNext(const std::function<bool(uint16_t handle)>& has_credits);
+
+  void OnFragmentsSent(uint16_t handle, uint16_t num_fragments);
+  void OnFragmentsCompleted(uint16_t handle, uint16_t num_fragments);
+
+  uint16_t GetClassOutstanding(TrafficClass traffic_class, size_t buffer) const;
+  int64_t GetDeficit(uint16_t handle) const;
+
+ private:
+  struct Link {
+    size_t buffer;
+    TrafficClass traffic_class;
+    uint16_t weight = kDefaultWeight;
+    int64_t deficit = 0;
+    size_t pending_size = 0;
+    bool quantum_granted = false;
+    uint16_t outstanding = 0;
+  };
+
+  bool is_over_budget(const Link& link) const;
+  std::map<uint16_t, Link>::iterator next_link(std::map<uint16_t, Link>::iterator it);
+
+  size_t quantum_;
+  std::map<uint16_t, Link> links_;
+  std::optional<uint16_t> current_;
+  std::array<uint16_t, kBufferCount> buffer_sizes_{};
+  std::array<uint8_t, kTrafficClassCount> class_budgets_;
+  std::array<std::array<uint16_t, kBufferCount>, kTrafficClassCount> class_outstanding_{};
+};
+
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
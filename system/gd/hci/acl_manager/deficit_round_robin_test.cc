@@ -0,0 +1,232 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/acl_manager/deficit_round_robin.h"
+
+#include <gtest/gtest.h>
+
+#include <deque>
+#include <map>
+#include <vector>
+
+namespace bluetooth {
+namespace hci {
+namespace acl_manager {
+namespace {
+
+using TrafficClass = DeficitRoundRobin::TrafficClass;
+
+constexpr size_t kClassic = 0;
+constexpr size_t kLe = 1;
+constexpr size_t kQuantum = 1000;
+
+auto always_has_credits = [](uint16_t) { return true; };
+
+TEST(DeficitRoundRobinTest, no_links) {
+  DeficitRoundRobin drr(kQuantum);
+  ASSERT_FALSE(drr.SelectNext(always_has_credits).has_value());
+}
+
+TEST(DeficitRoundRobinTest, idle_links_are_not_selected) {
+  DeficitRoundRobin drr(kQuantum);
+  drr.AddLink(0x01, kClassic);
+  drr.AddLink(0x02, kClassic);
+  ASSERT_FALSE(drr.SelectNext(always_has_credits).has_value());
+  drr.SetPendingPacketSize(0x02, 100);
+  ASSERT_EQ(drr.SelectNext(always_has_credits), 0x02);
+  ASSERT_FALSE(drr.HasPendingPacket(0x02));
+  ASSERT_FALSE(drr.SelectNext(always_has_credits).has_value());
+}
+
+TEST(DeficitRoundRobinTest, idle_links_do_not_bank_deficit) {
+  DeficitRoundRobin drr(kQuantum);
+  drr.AddLink(0x01, kClassic);
+  drr.SetPendingPacketSize(0x01, 100);
+  ASSERT_EQ(drr.SelectNext(always_has_credits), 0x01);
+  ASSERT_EQ(drr.GetDeficit(0x01), 900);
+  ASSERT_FALSE(drr.SelectNext(always_has_credits).has_value());
+  ASSERT_EQ(drr.GetDeficit(0x01), 0);
+}
+
+TEST(DeficitRoundRobinTest, large_packets_accumulate_deficit) {
+  DeficitRoundRobin drr(kQuantum);
+  drr.AddLink(0x01, kClassic);
+  drr.SetPendingPacketSize(0x01, 3 * kQuantum + 1);
+  ASSERT_EQ(drr.SelectNext(always_has_credits), 0x01);
+  ASSERT_EQ(drr.GetDeficit(0x01), static_cast<int64_t>(kQuantum - 1));
+}
+
+TEST(DeficitRoundRobinTest, equal_weights_alternate) {
+  DeficitRoundRobin drr(kQuantum);
+  drr.AddLink(0x01, kClassic);
+  drr.AddLink(0x02, kClassic);
+  std::vector<uint16_t> order;
+  for (int i = 0; i < 6; i++) {
+    drr.SetPendingPacketSize(0x01, kQuantum);
+    drr.SetPendingPacketSize(0x02, kQuantum);
+    auto first = drr.SelectNext(always_has_credits);
+    ASSERT_TRUE(first.has_value());
+    order.push_back(first.value());
+  }
+  ASSERT_EQ(order, std::vector<uint16_t>({0x01, 0x02, 0x01, 0x02, 0x01, 0x02}));
+}
+
+TEST(DeficitRoundRobinTest, links_without_credits_keep_their_turn) {
+  DeficitRoundRobin drr(kQuantum);
+  drr.AddLink(0x01, kClassic);
+  drr.AddLink(0x02, kLe);
+  drr.SetPendingPacketSize(0x01, 10);
+  drr.SetPendingPacketSize(0x02, 10);
+  auto le_only = [](uint16_t handle) { return handle == 0x02; };
+  ASSERT_EQ(drr.SelectNext(le_only), 0x02);
+  ASSERT_FALSE(drr.SelectNext(le_only).has_value());
+  ASSERT_EQ(drr.SelectNext(always_has_credits), 0x01);
+}
+
+TEST(DeficitRoundRobinTest, class_budget) {
+  DeficitRoundRobin drr(kQuantum);
+  drr.SetBufferSize(kClassic, 10);
+  drr.SetClassBudget(TrafficClass::BULK, 50);
+  drr.AddLink(0x01, kClassic);
+  drr.AddLink(0x02, kClassic, TrafficClass::AUDIO);
+
+  for (int i = 0; i < 5; i++) {
+    drr.SetPendingPacketSize(0x01, 10);
+    ASSERT_EQ(drr.SelectNext(always_has_credits), 0x01);
+    drr.OnFragmentsSent(0x01, 1);
+  }
+  ASSERT_EQ(drr.GetClassOutstanding(TrafficClass::BULK, kClassic), 5);
+  drr.SetPendingPacketSize(0x01, 10);
+  ASSERT_FALSE(drr.SelectNext(always_has_credits).has_value());
+
+  // Other classes are not affected by the bulk budget
+  drr.SetPendingPacketSize(0x02, 10);
+  ASSERT_EQ(drr.SelectNext(always_has_credits), 0x02);
+
+  drr.OnFragmentsCompleted(0x01, 1);
+  ASSERT_EQ(drr.SelectNext(always_has_credits), 0x01);
+}
+
+TEST(DeficitRoundRobinTest, changing_class_moves_outstanding_packets) {
+  DeficitRoundRobin drr(kQuantum);
+  drr.AddLink(0x01, kLe);
+  drr.OnFragmentsSent(0x01, 3);
+  drr.SetTrafficClass(0x01, TrafficClass::INTERACTIVE);
+  ASSERT_EQ(drr.GetClassOutstanding(TrafficClass::BULK, kLe), 0);
+  ASSERT_EQ(drr.GetClassOutstanding(TrafficClass::INTERACTIVE, kLe), 3);
+  drr.RemoveLink(0x01);
+  ASSERT_EQ(drr.GetClassOutstanding(TrafficClass::INTERACTIVE, kLe), 0);
+}
+
+// Saturate the controller with several backlogged links and check that they share it according to their weights
+// and that no controller buffer is left unused while a link has data. Each simulated tick the controller completes
+// one packet, after which the scheduler is allowed to refill the buffer.
+class DeficitRoundRobinFairnessTest : public ::testing::Test {
+ protected:
+  struct SimulatedLink {
+    size_t packet_size;
+    size_t buffer;
+    uint64_t bytes_sent = 0;
+  };
+
+  void AddLink(uint16_t handle, size_t packet_size, uint16_t weight, TrafficClass traffic_class = TrafficClass::BULK) {
+    links_[handle] = SimulatedLink{packet_size, kClassic};
+    drr_.AddLink(handle, kClassic, traffic_class);
+    drr_.SetWeight(handle, weight);
+    drr_.SetPendingPacketSize(handle, packet_size);
+  }
+
+  void Run(size_t ticks) {
+    for (size_t tick = 0; tick < ticks; tick++) {
+      while (in_flight_.size() < kControllerBuffers) {
+        auto handle = drr_.SelectNext([this](uint16_t) { return in_flight_.size() < kControllerBuffers; });
+        if (!handle.has_value()) {
+          break;
+        }
+        auto& link = links_[handle.value()];
+        link.bytes_sent += link.packet_size;
+        drr_.OnFragmentsSent(handle.value(), 1);
+        in_flight_.push_back(handle.value());
+        drr_.SetPendingPacketSize(handle.value(), link.packet_size);
+      }
+      busy_buffer_ticks_ += in_flight_.size();
+      if (!in_flight_.empty()) {
+        drr_.OnFragmentsCompleted(in_flight_.front(), 1);
+        in_flight_.pop_front();
+      }
+    }
+    total_ticks_ += ticks;
+  }
+
+  double Share(uint16_t handle) const {
+    uint64_t total = 0;
+    for (const auto& [_, link] : links_) {
+      total += link.bytes_sent;
+    }
+    return static_cast<double>(links_.at(handle).bytes_sent) / total;
+  }
+
+  double Utilization() const {
+    return static_cast<double>(busy_buffer_ticks_) / (total_ticks_ * kControllerBuffers);
+  }
+
+  static constexpr size_t kControllerBuffers = 8;
+  DeficitRoundRobin drr_{kQuantum};
+  std::map<uint16_t, SimulatedLink> links_;
+  std::deque<uint16_t> in_flight_;
+  uint64_t busy_buffer_ticks_ = 0;
+  uint64_t total_ticks_ = 0;
+};
+
+TEST_F(DeficitRoundRobinFairnessTest, mixed_packet_sizes_share_equally) {
+  // Bulk link with full sized packets against small interactive packets
+  AddLink(0x01, 1000, 1);
+  AddLink(0x02, 50, 1, TrafficClass::INTERACTIVE);
+  Run(20000);
+  EXPECT_NEAR(Share(0x01), 0.5, 0.02);
+  EXPECT_NEAR(Share(0x02), 0.5, 0.02);
+  EXPECT_GT(Utilization(), 0.99);
+}
+
+TEST_F(DeficitRoundRobinFairnessTest, weighted_audio_sinks_and_bulk) {
+  AddLink(0x01, 700, 2, TrafficClass::AUDIO);
+  AddLink(0x02, 700, 2, TrafficClass::AUDIO);
+  AddLink(0x03, 60, 1, TrafficClass::INTERACTIVE);
+  AddLink(0x04, 1021, 1);
+  Run(50000);
+  EXPECT_NEAR(Share(0x01), 2.0 / 6, 0.02);
+  EXPECT_NEAR(Share(0x02), 2.0 / 6, 0.02);
+  EXPECT_NEAR(Share(0x03), 1.0 / 6, 0.02);
+  EXPECT_NEAR(Share(0x04), 1.0 / 6, 0.02);
+  EXPECT_GT(Utilization(), 0.99);
+}
+
+TEST_F(DeficitRoundRobinFairnessTest, bulk_budget_leaves_buffers_for_audio) {
+  drr_.SetBufferSize(kClassic, kControllerBuffers);
+  drr_.SetClassBudget(TrafficClass::BULK, 50);
+  AddLink(0x01, 1021, 8);
+  AddLink(0x02, 700, 1, TrafficClass::AUDIO);
+  Run(1000);
+  ASSERT_LE(drr_.GetClassOutstanding(TrafficClass::BULK, kClassic), kControllerBuffers / 2);
+  // The audio link fills whatever bulk is not allowed to use
+  EXPECT_GT(Utilization(), 0.99);
+  EXPECT_GT(Share(0x02), 0.3);
+}
+
+}  // namespace
+}  // namespace acl_manager
+}  // namespace hci
+}  // namespace bluetooth
@@ -18,11 +18,15 @@
 
 #include <base/strings/stringprintf.h>
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "common/bind.h"
@@ -55,6 +59,12 @@ constexpr uint16_t kScanWindow2mFast = 0x0018;    /* 15 ms = 24 *0.625 */
 constexpr uint16_t kScanWindowCodedFast = 0x0018; /* 15 ms = 24 *0.625 */
 constexpr uint16_t kScanIntervalSlow = 0x0800;    /* 1.28 s = 2048 *0.625 */
 constexpr uint16_t kScanWindowSlow = 0x0030;      /* 30 ms = 48 *0.625 */
+// When connecting to many devices at once, LE 1M and LE Coded are scanned for the whole interval
+constexpr size_t kManyDirectConnections = 3;
+constexpr uint16_t kScanWindowManyFast = 0x0040;      /* 40 ms = 64 *0.625 */
+constexpr uint16_t kScanWindow2mManyFast = 0x0020;    /* 20 ms = 32 *0.625 */
+constexpr uint16_t kScanWindowCodedManyFast = 0x0020; /* 20 ms = 32 *0.625 */
+constexpr size_t kMaxConnectLatencies = 32;
 constexpr std::chrono::milliseconds kCreateConnectionTimeoutMs = std::chrono::milliseconds(30 * 1000);
 constexpr uint8_t PHY_LE_NO_PACKET = 0x00;
 constexpr uint8_t PHY_LE_1M = 0x01;
@@ -310,6 +320,7 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
         return;
       }
 
+      record_connect_latency(remote_address, status);
       arm_on_resume_ = false;
       ready_to_unregister = true;
       remove_device_from_connect_list(remote_address);
@@ -423,6 +434,7 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
         return;
       }
 
+      record_connect_latency(remote_address, status);
       arm_on_resume_ = false;
       ready_to_unregister = true;
       remove_device_from_connect_list(remote_address);
@@ -618,23 +630,95 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
       return;
     }
 
-    if (connect_list.find(address_with_type) != connect_list.end()) {
+    if (connect_list.find(address_with_type) != connect_list.end() ||
+        waiting_connect_list_.find(address_with_type) != waiting_connect_list_.end()) {
       LOG_WARN(
           "Device already exists in acceptlist and cannot be added:%s", PRIVATE_ADDRESS_WITH_TYPE(address_with_type));
       return;
     }
 
+    connect_request_times_[address_with_type] = std::chrono::steady_clock::now();
+    if (is_connect_list_full()) {
+      LOG_INFO("Acceptlist full, %s waits for a free entry", PRIVATE_ADDRESS_WITH_TYPE(address_with_type));
+      waiting_connect_list_.insert(address_with_type);
+      return;
+    }
     connect_list.insert(address_with_type);
     register_with_address_manager();
     le_address_manager_->AddDeviceToFilterAcceptList(
         address_with_type.ToFilterAcceptListAddressType(), address_with_type.GetAddress());
   }
 
+  // A controller reporting no size is not limited
+  bool is_connect_list_full() const {
+    uint8_t size = controller_->GetLeFilterAcceptListSize();
+    return size != 0 && connect_list.size() >= size;
+  }
+
+  // Whether |address_with_type| gets a free acceptlist entry before |other|: the direct connections first, then the
+  // devices which connected the most recently, being the most likely to be around
+  bool connects_before(const AddressWithType& address_with_type, const AddressWithType& other) const {
+    bool is_direct = direct_connections_.find(address_with_type) != direct_connections_.end();
+    bool other_is_direct = direct_connections_.find(other) != direct_connections_.end();
+    if (is_direct != other_is_direct) {
+      return is_direct;
+    }
+    auto last_connection = last_connection_times_.find(address_with_type);
+    auto other_last_connection = last_connection_times_.find(other);
+    if (last_connection == last_connection_times_.end()) {
+      return false;
+    }
+    return other_last_connection == last_connection_times_.end() ||
+           last_connection->second > other_last_connection->second;
+  }
+
+  void add_waiting_devices_to_connect_list() {
+    while (!waiting_connect_list_.empty() && !is_connect_list_full()) {
+      auto next = std::min_element(
+          waiting_connect_list_.begin(),
+          waiting_connect_list_.end(),
+          [this](const AddressWithType& a, const AddressWithType& b) { return connects_before(a, b); });
+      AddressWithType address_with_type = *next;
+      waiting_connect_list_.erase(next);
+      connect_list.insert(address_with_type);
+      le_address_manager_->AddDeviceToFilterAcceptList(
+          address_with_type.ToFilterAcceptListAddressType(), address_with_type.GetAddress());
+    }
+  }
+
+  // Called once the connection to a device initiated by the stack either completes or times out
+  void record_connect_latency(AddressWithType address_with_type, ErrorCode status) {
+    auto request = connect_request_times_.find(address_with_type);
+    if (request == connect_request_times_.end()) {
+      return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    auto latency = std::chrono::duration_cast<std::chrono::milliseconds>(now - request->second);
+    connect_request_times_.erase(request);
+    if (status == ErrorCode::SUCCESS) {
+      last_connection_times_[address_with_type] = now;
+    }
+    LOG_INFO(
+        "Connection to %s completed in %d ms with status %s",
+        PRIVATE_ADDRESS_WITH_TYPE(address_with_type),
+        static_cast<int>(latency.count()),
+        ErrorCodeText(status).c_str());
+    connect_latencies_.push_back({address_with_type, latency, status});
+    if (connect_latencies_.size() > kMaxConnectLatencies) {
+      connect_latencies_.pop_front();
+    }
+  }
+
   bool is_device_in_connect_list(AddressWithType address_with_type) {
     return (connect_list.find(address_with_type) != connect_list.end());
   }
 
   void remove_device_from_connect_list(AddressWithType address_with_type) {
+    if (waiting_connect_list_.erase(address_with_type) != 0) {
+      connect_request_times_.erase(address_with_type);
+      direct_connections_.erase(address_with_type);
+      return;
+    }
     if (connect_list.find(address_with_type) == connect_list.end()) {
       LOG_WARN("Device not in acceptlist and cannot be removed:%s", PRIVATE_ADDRESS_WITH_TYPE(address_with_type));
       return;
@@ -642,13 +726,17 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
     connect_list.erase(address_with_type);
     connecting_le_.erase(address_with_type);
     direct_connections_.erase(address_with_type);
+    connect_request_times_.erase(address_with_type);
     register_with_address_manager();
     le_address_manager_->RemoveDeviceFromFilterAcceptList(
         address_with_type.ToFilterAcceptListAddressType(), address_with_type.GetAddress());
+    add_waiting_devices_to_connect_list();
   }
 
   void clear_connect_list() {
     connect_list.clear();
+    waiting_connect_list_.clear();
+    connect_request_times_.clear();
     register_with_address_manager();
     le_address_manager_->ClearFilterAcceptList();
   }
@@ -717,6 +805,11 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
       le_scan_window = kScanWindowFast;
       le_scan_window_2m = kScanWindow2mFast;
       le_scan_window_coded = kScanWindowCodedFast;
+      if (direct_connections_.size() >= kManyDirectConnections) {
+        le_scan_window = kScanWindowManyFast;
+        le_scan_window_2m = kScanWindow2mManyFast;
+        le_scan_window_coded = kScanWindowCodedManyFast;
+      }
     }
     InitiatorFilterPolicy initiator_filter_policy = InitiatorFilterPolicy::USE_FILTER_ACCEPT_LIST;
     OwnAddressType own_address_type =
@@ -885,6 +978,7 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
     if (create_connection_timeout_alarms_.find(address_with_type) != create_connection_timeout_alarms_.end()) {
       create_connection_timeout_alarms_.at(address_with_type).Cancel();
       create_connection_timeout_alarms_.erase(address_with_type);
+      record_connect_latency(address_with_type, ErrorCode::CONNECTION_ACCEPT_TIMEOUT);
       if (background_connections_.find(address_with_type) != background_connections_.end()) {
         direct_connections_.erase(address_with_type);
         disarm_connectability();
@@ -1071,6 +1165,18 @@ struct le_impl : public bluetooth::hci::LeAddressManagerCallback {
   // Set of devices that will not be removed from connect list after direct connect timeout
   std::unordered_set<AddressWithType> background_connections_;
   std::unordered_set<AddressWithType> connect_list;
+  // Devices to connect to that did not fit in the filter accept list, added as entries are freed
+  std::unordered_set<AddressWithType> waiting_connect_list_;
+  // When the connection to each device was requested
+  std::unordered_map<AddressWithType, std::chrono::steady_clock::time_point> connect_request_times_;
+  std::unordered_map<AddressWithType, std::chrono::steady_clock::time_point> last_connection_times_;
+  struct ConnectLatency {
+    AddressWithType address_with_type;
+    std::chrono::milliseconds latency;
+    ErrorCode status;
+  };
+  // Most recent connect latencies, oldest first
+  std::deque<ConnectLatency> connect_latencies_;
   AddressWithType connection_peer_address_with_type_;  // Direct peer address UNSUPPORTEDD
   bool address_manager_registered = false;
   bool ready_to_unregister = false;
@@ -71,6 +71,10 @@ class TestController : public Controller {
     return hci_mtu_;
   }
 
+  uint8_t GetLeFilterAcceptListSize() const override {
+    return le_filter_accept_list_size_;
+  }
+
   LeBufferSize GetLeBufferSize() const {
     LeBufferSize le_buffer_size;
     le_buffer_size.le_data_packet_length_ = le_hci_mtu_;
@@ -94,6 +98,7 @@ class TestController : public Controller {
   const uint16_t hci_mtu_ = 1024;
   const uint16_t le_max_acl_packet_credits_ = 15;
   const uint16_t le_hci_mtu_ = 27;
+  uint8_t le_filter_accept_list_size_ = 0;
 
  private:
   CompletedAclPacketsCallback acl_credits_callback_;
@@ -369,6 +374,31 @@ TEST_F(LeImplTest, remove_device_from_connect_list) {
   ASSERT_EQ(0UL, le_impl_->connect_list.size());
 }
 
+TEST_F(LeImplTest, add_device_to_full_connect_list) {
+  controller_->le_filter_accept_list_size_ = 2;
+  AddressWithType device_1({0x01, 0x02, 0x03, 0x04, 0x05, 0x06}, AddressType::PUBLIC_DEVICE_ADDRESS);
+  AddressWithType device_2({0x11, 0x12, 0x13, 0x14, 0x15, 0x16}, AddressType::PUBLIC_DEVICE_ADDRESS);
+  AddressWithType device_3({0x21, 0x22, 0x23, 0x24, 0x25, 0x26}, AddressType::PUBLIC_DEVICE_ADDRESS);
+  le_impl_->add_device_to_connect_list(device_1);
+  le_impl_->add_device_to_connect_list(device_2);
+  le_impl_->add_device_to_connect_list(device_3);
+  ASSERT_EQ(2UL, le_impl_->connect_list.size());
+  ASSERT_EQ(1UL, le_impl_->waiting_connect_list_.size());
+
+  // The waiting device takes the freed entry
+  le_impl_->remove_device_from_connect_list(device_1);
+  ASSERT_EQ(2UL, le_impl_->connect_list.size());
+  ASSERT_EQ(1UL, le_impl_->connect_list.count(device_3));
+  ASSERT_TRUE(le_impl_->waiting_connect_list_.empty());
+
+  // A waiting device is removed without touching the acceptlist
+  le_impl_->add_device_to_connect_list(device_1);
+  ASSERT_EQ(1UL, le_impl_->waiting_connect_list_.size());
+  le_impl_->remove_device_from_connect_list(device_1);
+  ASSERT_EQ(2UL, le_impl_->connect_list.size());
+  ASSERT_TRUE(le_impl_->waiting_connect_list_.empty());
+}
+
 TEST_F(LeImplTest, connection_complete_with_periperal_role) {
   // Create connection
   hci_layer_->SetCommandFuture();
@@ -477,6 +507,8 @@ TEST_F(LeImplTest, connection_complete_with_central_role) {
 
   // Check state is DISARMED
   ASSERT_EQ(ConnectabilityState::DISARMED, le_impl_->connectability_state_);
+  ASSERT_EQ(1UL, le_impl_->connect_latencies_.size());
+  ASSERT_EQ(ErrorCode::SUCCESS, le_impl_->connect_latencies_.front().status);
 }
 
 TEST_F(LeImplTest, enhanced_connection_complete_with_central_role) {
@@ -515,6 +547,8 @@ TEST_F(LeImplTest, enhanced_connection_complete_with_central_role) {
 
   // Check state is DISARMED
   ASSERT_EQ(ConnectabilityState::DISARMED, le_impl_->connectability_state_);
+  ASSERT_EQ(1UL, le_impl_->connect_latencies_.size());
+  ASSERT_EQ(ErrorCode::SUCCESS, le_impl_->connect_latencies_.front().status);
 }
 
 }  // namespace acl_manager
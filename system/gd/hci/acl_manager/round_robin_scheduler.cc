@@ -15,6 +15,9 @@
  */
 
 #include "hci/acl_manager/round_robin_scheduler.h"
+
+#include <algorithm>
+
 #include "hci/acl_manager/acl_fragmenter.h"
 
 namespace bluetooth {
@@ -22,8 +25,15 @@ namespace hci {
 namespace acl_manager {
 
 RoundRobinScheduler::RoundRobinScheduler(
-    os::Handler* handler, Controller* controller, common::BidiQueueEnd<AclBuilder, AclView>* hci_queue_end)
-    : handler_(handler), controller_(controller), hci_queue_end_(hci_queue_end) {
+    os::Handler* handler,
+    Controller* controller,
+    common::BidiQueueEnd<AclBuilder, AclView>* hci_queue_end,
+    SchedulingMode scheduling_mode)
+    : handler_(handler),
+      controller_(controller),
+      scheduling_mode_(scheduling_mode),
+      deficit_round_robin_(std::max<size_t>(1, controller->GetAclPacketLength())),
+      hci_queue_end_(hci_queue_end) {
   max_acl_packet_credits_ = controller_->GetNumAclPacketBuffers();
   acl_packet_credits_ = max_acl_packet_credits_;
   hci_mtu_ = controller_->GetAclPacketLength();
@@ -31,6 +41,8 @@ RoundRobinScheduler::RoundRobinScheduler(
   le_max_acl_packet_credits_ = le_buffer_size.total_num_le_packets_;
   le_acl_packet_credits_ = le_max_acl_packet_credits_;
   le_hci_mtu_ = le_buffer_size.le_data_packet_length_;
+  deficit_round_robin_.SetBufferSize(ConnectionType::CLASSIC, max_acl_packet_credits_);
+  deficit_round_robin_.SetBufferSize(ConnectionType::LE, le_max_acl_packet_credits_);
   controller_->RegisterCompletedAclPacketsCallback(handler->BindOn(this, &RoundRobinScheduler::incoming_acl_credits));
 }
 
@@ -43,6 +55,7 @@ void RoundRobinScheduler::Register(ConnectionType connection_type, uint16_t hand
                                    std::shared_ptr<acl_manager::AclConnection::Queue> queue) {
   acl_queue_handler acl_queue_handler = {connection_type, std::move(queue), false, 0};
   acl_queue_handlers_.insert(std::pair<uint16_t, RoundRobinScheduler::acl_queue_handler>(handle, acl_queue_handler));
+  deficit_round_robin_.AddLink(handle, connection_type);
   if (fragments_to_send_.size() == 0) {
     start_round_robin();
   }
@@ -50,7 +63,7 @@ void RoundRobinScheduler::Register(ConnectionType connection_type, uint16_t hand
 
 void RoundRobinScheduler::Unregister(uint16_t handle) {
   ASSERT(acl_queue_handlers_.count(handle) == 1);
-  auto acl_queue_handler = acl_queue_handlers_.find(handle)->second;
+  auto& acl_queue_handler = acl_queue_handlers_.find(handle)->second;
   // Reclaim outstanding packets
   if (acl_queue_handler.connection_type_ == ConnectionType::CLASSIC) {
     acl_packet_credits_ += acl_queue_handler.number_of_sent_packets_;
@@ -64,6 +77,8 @@ void RoundRobinScheduler::Unregister(uint16_t handle) {
     acl_queue_handler.queue_->GetDownEnd()->UnregisterDequeue();
   }
   acl_queue_handlers_.erase(handle);
+  pending_packets_.erase(handle);
+  deficit_round_robin_.RemoveLink(handle);
   starting_point_ = acl_queue_handlers_.begin();
 }
 
@@ -74,6 +89,39 @@ void RoundRobinScheduler::SetLinkPriority(uint16_t handle, bool high_priority) {
     return;
   }
   acl_queue_handler->second.high_priority_ = high_priority;
+  deficit_round_robin_.SetTrafficClass(handle, high_priority ? TrafficClass::AUDIO : TrafficClass::BULK);
+}
+
+void RoundRobinScheduler::SetLinkWeight(uint16_t handle, uint16_t weight) {
+  if (acl_queue_handlers_.count(handle) == 0) {
+    LOG_WARN("handle %d is invalid", handle);
+    return;
+  }
+  deficit_round_robin_.SetWeight(handle, weight);
+}
+
+void RoundRobinScheduler::SetLinkTrafficClass(uint16_t handle, TrafficClass traffic_class) {
+  if (acl_queue_handlers_.count(handle) == 0) {
+    LOG_WARN("handle %d is invalid", handle);
+    return;
+  }
+  deficit_round_robin_.SetTrafficClass(handle, traffic_class);
+}
+
+void RoundRobinScheduler::SetTrafficClassBudget(TrafficClass traffic_class, uint8_t percent) {
+  deficit_round_robin_.SetClassBudget(traffic_class, percent);
+  if (fragments_to_send_.empty()) {
+    start_round_robin();
+  }
+}
+
+RoundRobinScheduler::SchedulingMode RoundRobinScheduler::GetSchedulingMode() const {
+  return scheduling_mode_;
+}
+
+void RoundRobinScheduler::SetFragmentBurstCallback(FragmentBurstCallback callback) {
+  ASSERT(acl_queue_handlers_.empty());
+  fragment_burst_callback_ = std::move(callback);
 }
 
 uint16_t RoundRobinScheduler::GetCredits() {
@@ -103,6 +151,10 @@ void RoundRobinScheduler::start_round_robin() {
     LOG_INFO("No any acl connection");
     return;
   }
+  if (scheduling_mode_ == SchedulingMode::DEFICIT_ROUND_ROBIN) {
+    start_deficit_round_robin();
+    return;
+  }
 
   if (acl_queue_handlers_.size() == 1 || starting_point_ == acl_queue_handlers_.end()) {
     starting_point_ = acl_queue_handlers_.begin();
@@ -129,12 +181,70 @@ void RoundRobinScheduler::start_round_robin() {
   starting_point_ = std::next(starting_point_);
 }
 
+void RoundRobinScheduler::start_deficit_round_robin() {
+  // Keep one packet of look ahead per link so the policy can see which links are backlogged
+  for (auto it = acl_queue_handlers_.begin(); it != acl_queue_handlers_.end(); it++) {
+    if (!it->second.dequeue_is_registered_ && pending_packets_.count(it->first) == 0) {
+      it->second.dequeue_is_registered_ = true;
+      it->second.queue_->GetDownEnd()->RegisterDequeue(
+          handler_, common::Bind(&RoundRobinScheduler::buffer_pending_packet, common::Unretained(this), it));
+    }
+  }
+
+  auto handle = deficit_round_robin_.SelectNext([this](uint16_t handle) {
+    return has_credits(acl_queue_handlers_.find(handle)->second.connection_type_);
+  });
+  if (!handle.has_value()) {
+    return;
+  }
+  auto acl_queue_handler = acl_queue_handlers_.find(handle.value());
+  auto pending_packet = pending_packets_.find(handle.value());
+  ASSERT(acl_queue_handler != acl_queue_handlers_.end() && pending_packet != pending_packets_.end());
+  auto packet = std::move(pending_packet->second);
+  pending_packets_.erase(pending_packet);
+
+  // Start fetching the next packet of this link while the current one is sent
+  acl_queue_handler->second.dequeue_is_registered_ = true;
+  acl_queue_handler->second.queue_->GetDownEnd()->RegisterDequeue(
+      handler_,
+      common::Bind(&RoundRobinScheduler::buffer_pending_packet, common::Unretained(this), acl_queue_handler));
+
+  push_fragments(acl_queue_handler, std::move(packet));
+  send_next_fragment();
+}
+
+void RoundRobinScheduler::buffer_pending_packet(std::map<uint16_t, acl_queue_handler>::iterator acl_queue_handler) {
+  uint16_t handle = acl_queue_handler->first;
+  auto packet = acl_queue_handler->second.queue_->GetDownEnd()->TryDequeue();
+  ASSERT(packet != nullptr);
+  acl_queue_handler->second.dequeue_is_registered_ = false;
+  acl_queue_handler->second.queue_->GetDownEnd()->UnregisterDequeue();
+
+  deficit_round_robin_.SetPendingPacketSize(handle, std::max<size_t>(1, packet->size()));
+  pending_packets_[handle] = std::move(packet);
+  if (fragments_to_send_.empty()) {
+    start_round_robin();
+  }
+}
+
+bool RoundRobinScheduler::has_credits(ConnectionType connection_type) const {
+  return connection_type == ConnectionType::CLASSIC ? acl_packet_credits_ > 0 : le_acl_packet_credits_ > 0;
+}
+
 void RoundRobinScheduler::buffer_packet(std::map<uint16_t, acl_queue_handler>::iterator acl_queue_handler) {
+  auto packet = acl_queue_handler->second.queue_->GetDownEnd()->TryDequeue();
+  ASSERT(packet != nullptr);
+  push_fragments(acl_queue_handler, std::move(packet));
+  unregister_all_connections();
+  send_next_fragment();
+}
+
+void RoundRobinScheduler::push_fragments(
+    std::map<uint16_t, acl_queue_handler>::iterator acl_queue_handler,
+    std::unique_ptr<packet::BasePacketBuilder> packet) {
   BroadcastFlag broadcast_flag = BroadcastFlag::POINT_TO_POINT;
   // Wrap packet and enqueue it
   uint16_t handle = acl_queue_handler->first;
-  auto packet = acl_queue_handler->second.queue_->GetDownEnd()->TryDequeue();
-  ASSERT(packet != nullptr);
 
   ConnectionType connection_type = acl_queue_handler->second.connection_type_;
   size_t mtu = connection_type == ConnectionType::CLASSIC ? hci_mtu_ : le_hci_mtu_;
@@ -160,10 +270,9 @@ void RoundRobinScheduler::buffer_packet(std::map<uint16_t, acl_queue_handler>::i
     }
   }
   ASSERT(fragments_to_send_.size() > 0);
-  unregister_all_connections();
 
   acl_queue_handler->second.number_of_sent_packets_ += fragments_to_send_.size();
-  send_next_fragment();
+  deficit_round_robin_.OnFragmentsSent(handle, fragments_to_send_.size());
 }
 
 void RoundRobinScheduler::unregister_all_connections() {
@@ -177,12 +286,36 @@ void RoundRobinScheduler::unregister_all_connections() {
 }
 
 void RoundRobinScheduler::send_next_fragment() {
+  if (!fragment_burst_callback_.is_null()) {
+    send_fragment_burst();
+    return;
+  }
   if (!enqueue_registered_.exchange(true)) {
     hci_queue_end_->RegisterEnqueue(
         handler_, common::Bind(&RoundRobinScheduler::handle_enqueue_next_fragment, common::Unretained(this)));
   }
 }
 
+void RoundRobinScheduler::send_fragment_burst() {
+  std::vector<std::unique_ptr<AclBuilder>> burst;
+  while (!fragments_to_send_.empty() && has_credits(fragments_to_send_.front().first)) {
+    if (fragments_to_send_.front().first == ConnectionType::CLASSIC) {
+      acl_packet_credits_ -= 1;
+    } else {
+      le_acl_packet_credits_ -= 1;
+    }
+    burst.push_back(std::move(fragments_to_send_.front().second));
+    fragments_to_send_.pop();
+  }
+  if (!burst.empty()) {
+    fragment_burst_callback_.Run(std::move(burst));
+  }
+  // Fragments left without credits wait for incoming_acl_credits() to restart the round robin
+  if (fragments_to_send_.empty()) {
+    handler_->Post(common::BindOnce(&RoundRobinScheduler::start_round_robin, common::Unretained(this)));
+  }
+}
+
 // Invoked from some external Queue Reactable context 1
 std::unique_ptr<AclBuilder> RoundRobinScheduler::handle_enqueue_next_fragment() {
   ConnectionType connection_type = fragments_to_send_.front().first;
@@ -224,6 +357,7 @@ void RoundRobinScheduler::incoming_acl_credits(uint16_t handle, uint16_t credits
     LOG_WARN("receive more credits than we sent");
     acl_queue_handler->second.number_of_sent_packets_ = 0;
   }
+  deficit_round_robin_.OnFragmentsCompleted(handle, credits);
 
   bool credit_was_zero = false;
   if (acl_queue_handler->second.connection_type_ == ConnectionType::CLASSIC) {
@@ -245,7 +379,9 @@ void RoundRobinScheduler::incoming_acl_credits(uint16_t handle, uint16_t credits
       LOG_WARN("le acl packet credits overflow due to receive %hx credits", credits);
     }
   }
-  if (credit_was_zero) {
+  // Completed packets may also bring a traffic class back under its budget
+  bool budget_released = scheduling_mode_ == SchedulingMode::DEFICIT_ROUND_ROBIN && fragments_to_send_.empty();
+  if (credit_was_zero || budget_released) {
     start_round_robin();
   }
 }
@@ -21,6 +21,7 @@
 #include "common/bidi_queue.h"
 #include "common/multi_priority_queue.h"
 #include "hci/acl_manager.h"
+#include "hci/acl_manager/deficit_round_robin.h"
 #include "hci/controller.h"
 #include "hci/hci_packets.h"
 #include "os/handler.h"
@@ -31,11 +32,20 @@ namespace acl_manager {
 
 class RoundRobinScheduler {
  public:
+  // ROUND_ROBIN hands the controller buffers to whichever link has data first, one packet at a time.
+  // DEFICIT_ROUND_ROBIN looks ahead one packet per link and shares the buffers according to the link weights and
+  // traffic class budgets, see DeficitRoundRobin.
+  enum class SchedulingMode { ROUND_ROBIN, DEFICIT_ROUND_ROBIN };
+
   RoundRobinScheduler(
-      os::Handler* handler, Controller* controller, common::BidiQueueEnd<AclBuilder, AclView>* hci_queue_end);
+      os::Handler* handler,
+      Controller* controller,
+      common::BidiQueueEnd<AclBuilder, AclView>* hci_queue_end,
+      SchedulingMode scheduling_mode = SchedulingMode::ROUND_ROBIN);
   ~RoundRobinScheduler();
 
   enum ConnectionType { CLASSIC, LE };
+  using TrafficClass = DeficitRoundRobin::TrafficClass;
 
   struct acl_queue_handler {
     ConnectionType connection_type_;
@@ -49,20 +59,41 @@ class RoundRobinScheduler {
                 std::shared_ptr<acl_manager::AclConnection::Queue> queue);
   void Unregister(uint16_t handle);
   void SetLinkPriority(uint16_t handle, bool high_priority);
+  // Only used in DEFICIT_ROUND_ROBIN mode
+  void SetLinkWeight(uint16_t handle, uint16_t weight);
+  void SetLinkTrafficClass(uint16_t handle, TrafficClass traffic_class);
+  void SetTrafficClassBudget(TrafficClass traffic_class, uint8_t percent);
+  SchedulingMode GetSchedulingMode() const;
+
+  // When set, fragments are no longer enqueued one by one on the HCI queue end. Instead, as many fragments as there
+  // are controller credits for are handed to |callback| at once. Must be set before any connection is registered.
+  using FragmentBurstCallback = common::Callback<void(std::vector<std::unique_ptr<AclBuilder>>)>;
+  void SetFragmentBurstCallback(FragmentBurstCallback callback);
   uint16_t GetCredits();
   uint16_t GetLeCredits();
 
  private:
   void start_round_robin();
   void buffer_packet(std::map<uint16_t, acl_queue_handler>::iterator acl_queue_handler);
+  void push_fragments(
+      std::map<uint16_t, acl_queue_handler>::iterator acl_queue_handler,
+      std::unique_ptr<packet::BasePacketBuilder> packet);
+  void start_deficit_round_robin();
+  void buffer_pending_packet(std::map<uint16_t, acl_queue_handler>::iterator acl_queue_handler);
+  bool has_credits(ConnectionType connection_type) const;
   void unregister_all_connections();
   void send_next_fragment();
+  void send_fragment_burst();
   std::unique_ptr<AclBuilder> handle_enqueue_next_fragment();
   void incoming_acl_credits(uint16_t handle, uint16_t credits);
 
   os::Handler* handler_ = nullptr;
   Controller* controller_ = nullptr;
+  SchedulingMode scheduling_mode_;
   std::map<uint16_t, acl_queue_handler> acl_queue_handlers_;
+  // Packets taken off the link queues ahead of time, only used in DEFICIT_ROUND_ROBIN mode
+  std::map<uint16_t, std::unique_ptr<packet::BasePacketBuilder>> pending_packets_;
+  DeficitRoundRobin deficit_round_robin_;
   common::MultiPriorityQueue<std::pair<ConnectionType, std::unique_ptr<AclBuilder>>, 2> fragments_to_send_;
   uint16_t max_acl_packet_credits_ = 0;
   uint16_t acl_packet_credits_ = 0;
@@ -71,6 +102,7 @@ class RoundRobinScheduler {
   size_t hci_mtu_{0};
   size_t le_hci_mtu_{0};
   std::atomic_bool enqueue_registered_ = false;
+  FragmentBurstCallback fragment_burst_callback_;
   common::BidiQueueEnd<AclBuilder, AclView>* hci_queue_end_ = nullptr;
   // first register queue end for the Round-robin schedule
   std::map<uint16_t, acl_queue_handler>::iterator starting_point_;
@@ -94,6 +94,11 @@ class RoundRobinSchedulerTest : public ::testing::Test {
     delete thread_;
   }
 
+  void UseSchedulingMode(RoundRobinScheduler::SchedulingMode scheduling_mode) {
+    delete round_robin_scheduler_;
+    round_robin_scheduler_ = new RoundRobinScheduler(handler_, controller_, hci_queue_.GetUpEnd(), scheduling_mode);
+  }
+
   void sync_handler() {
     std::promise<void> promise;
     auto future = promise.get_future();
@@ -122,7 +127,17 @@ class RoundRobinSchedulerTest : public ::testing::Test {
   };
 
   void HciDownEndDequeue() {
-    auto packet = hci_queue_.GetDownEnd()->TryDequeue();
+    RecordSentPacket(hci_queue_.GetDownEnd()->TryDequeue());
+  }
+
+  void HciBurst(std::vector<std::unique_ptr<AclBuilder>> fragments) {
+    burst_sizes_.push_back(fragments.size());
+    for (auto& fragment : fragments) {
+      RecordSentPacket(std::move(fragment));
+    }
+  }
+
+  void RecordSentPacket(std::unique_ptr<AclBuilder> packet) {
     // Convert from a Builder to a View
     auto bytes = std::make_shared<std::vector<uint8_t>>();
     bluetooth::packet::BitInserter i(*bytes);
@@ -164,6 +179,7 @@ class RoundRobinSchedulerTest : public ::testing::Test {
   TestController* controller_;
   RoundRobinScheduler* round_robin_scheduler_;
   std::queue<AclView> sent_acl_packets_;
+  std::vector<size_t> burst_sizes_;
   uint16_t packet_count_;
   std::unique_ptr<std::promise<void>> packet_promise_;
   std::unique_ptr<std::future<void>> packet_future_;
@@ -410,6 +426,143 @@ TEST_F(RoundRobinSchedulerTest, receive_le_credit_when_next_fragment_is_classic)
   round_robin_scheduler_->Unregister(le_handle);
 }
 
+TEST_F(RoundRobinSchedulerTest, deficit_round_robin_buffer_packet_from_two_connections) {
+  UseSchedulingMode(RoundRobinScheduler::SchedulingMode::DEFICIT_ROUND_ROBIN);
+  ASSERT_EQ(round_robin_scheduler_->GetSchedulingMode(), RoundRobinScheduler::SchedulingMode::DEFICIT_ROUND_ROBIN);
+  uint16_t handle = 0x01;
+  uint16_t le_handle = 0x02;
+  auto connection_queue = std::make_shared<AclConnection::Queue>(10);
+  auto le_connection_queue = std::make_shared<AclConnection::Queue>(10);
+
+  round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::CLASSIC, handle, connection_queue);
+  round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::LE, le_handle, le_connection_queue);
+  round_robin_scheduler_->SetLinkWeight(handle, 2);
+  round_robin_scheduler_->SetLinkTrafficClass(le_handle, RoundRobinScheduler::TrafficClass::INTERACTIVE);
+
+  SetPacketFuture(2);
+  std::vector<uint8_t> packet = {0x01, 0x02, 0x03};
+  std::vector<uint8_t> le_packet = {0x04, 0x05, 0x06};
+  EnqueueAclUpEnd(le_connection_queue->GetUpEnd(), le_packet);
+  EnqueueAclUpEnd(connection_queue->GetUpEnd(), packet);
+
+  packet_future_->wait();
+  VerifyPacket(le_handle, le_packet);
+  VerifyPacket(handle, packet);
+  ASSERT_EQ(round_robin_scheduler_->GetCredits(), controller_->max_acl_packet_credits_ - 1);
+  ASSERT_EQ(round_robin_scheduler_->GetLeCredits(), controller_->le_max_acl_packet_credits_ - 1);
+
+  round_robin_scheduler_->Unregister(handle);
+  round_robin_scheduler_->Unregister(le_handle);
+}
+
+TEST_F(RoundRobinSchedulerTest, deficit_round_robin_stops_when_credits_is_zero) {
+  UseSchedulingMode(RoundRobinScheduler::SchedulingMode::DEFICIT_ROUND_ROBIN);
+  uint16_t handle = 0x01;
+  auto connection_queue = std::make_shared<AclConnection::Queue>(15);
+  round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::CLASSIC, handle, connection_queue);
+
+  SetPacketFuture(10);
+  AclConnection::QueueUpEnd* queue_up_end = connection_queue->GetUpEnd();
+  for (uint8_t i = 0; i < 15; i++) {
+    std::vector<uint8_t> packet = {0x01, 0x02, 0x03, i};
+    EnqueueAclUpEnd(queue_up_end, packet);
+  }
+
+  packet_future_->wait();
+  for (uint8_t i = 0; i < 10; i++) {
+    std::vector<uint8_t> packet = {0x01, 0x02, 0x03, i};
+    VerifyPacket(handle, packet);
+  }
+  ASSERT_EQ(round_robin_scheduler_->GetCredits(), 0);
+
+  SetPacketFuture(5);
+  controller_->SendCompletedAclPacketsCallback(0x01, 10);
+  sync_handler();
+  packet_future_->wait();
+  for (uint8_t i = 10; i < 15; i++) {
+    std::vector<uint8_t> packet = {0x01, 0x02, 0x03, i};
+    VerifyPacket(handle, packet);
+  }
+  ASSERT_EQ(round_robin_scheduler_->GetCredits(), 5);
+
+  round_robin_scheduler_->Unregister(handle);
+}
+
+TEST_F(RoundRobinSchedulerTest, deficit_round_robin_class_budget) {
+  UseSchedulingMode(RoundRobinScheduler::SchedulingMode::DEFICIT_ROUND_ROBIN);
+  round_robin_scheduler_->SetTrafficClassBudget(RoundRobinScheduler::TrafficClass::BULK, 50);
+  uint16_t handle = 0x01;
+  auto connection_queue = std::make_shared<AclConnection::Queue>(15);
+  round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::CLASSIC, handle, connection_queue);
+
+  SetPacketFuture(controller_->max_acl_packet_credits_ / 2);
+  AclConnection::QueueUpEnd* queue_up_end = connection_queue->GetUpEnd();
+  for (uint8_t i = 0; i < controller_->max_acl_packet_credits_; i++) {
+    std::vector<uint8_t> packet = {0x01, 0x02, 0x03, i};
+    EnqueueAclUpEnd(queue_up_end, packet);
+  }
+
+  packet_future_->wait();
+  sync_handler();
+  ASSERT_EQ(round_robin_scheduler_->GetCredits(), controller_->max_acl_packet_credits_ / 2);
+
+  // Completed packets bring the bulk class back under its budget
+  SetPacketFuture(1);
+  controller_->SendCompletedAclPacketsCallback(0x01, 1);
+  packet_future_->wait();
+
+  round_robin_scheduler_->Unregister(handle);
+}
+
+TEST_F(RoundRobinSchedulerTest, send_fragments_in_bursts) {
+  round_robin_scheduler_->SetFragmentBurstCallback(
+      common::Bind(&RoundRobinSchedulerTest::HciBurst, common::Unretained(this)));
+  uint16_t le_handle = 0x02;
+  auto le_connection_queue = std::make_shared<AclConnection::Queue>(10);
+  round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::LE, le_handle, le_connection_queue);
+
+  // Three fragments with credits for all of them go out in a single burst
+  std::vector<uint8_t> le_packet(controller_->le_hci_mtu_ * 3, 0x42);
+  std::vector<uint8_t> le_packet_part(controller_->le_hci_mtu_, 0x42);
+  SetPacketFuture(3);
+  EnqueueAclUpEnd(le_connection_queue->GetUpEnd(), le_packet);
+  packet_future_->wait();
+  for (int i = 0; i < 3; i++) {
+    VerifyPacket(le_handle, le_packet_part);
+  }
+  sync_handler();
+  ASSERT_EQ(burst_sizes_, std::vector<size_t>({3}));
+  ASSERT_EQ(round_robin_scheduler_->GetLeCredits(), controller_->le_max_acl_packet_credits_ - 3);
+
+  round_robin_scheduler_->Unregister(le_handle);
+}
+
+TEST_F(RoundRobinSchedulerTest, fragment_bursts_are_limited_by_credits) {
+  round_robin_scheduler_->SetFragmentBurstCallback(
+      common::Bind(&RoundRobinSchedulerTest::HciBurst, common::Unretained(this)));
+  uint16_t le_handle = 0x02;
+  auto le_connection_queue = std::make_shared<AclConnection::Queue>(10);
+  round_robin_scheduler_->Register(RoundRobinScheduler::ConnectionType::LE, le_handle, le_connection_queue);
+
+  // Twenty fragments, but only fifteen LE credits
+  std::vector<uint8_t> le_packet(controller_->le_hci_mtu_ * 20, 0x42);
+  SetPacketFuture(controller_->le_max_acl_packet_credits_);
+  EnqueueAclUpEnd(le_connection_queue->GetUpEnd(), le_packet);
+  packet_future_->wait();
+  sync_handler();
+  ASSERT_EQ(burst_sizes_, std::vector<size_t>({controller_->le_max_acl_packet_credits_}));
+  ASSERT_EQ(round_robin_scheduler_->GetLeCredits(), 0);
+
+  SetPacketFuture(5);
+  controller_->SendCompletedAclPacketsCallback(le_handle, 5);
+  packet_future_->wait();
+  sync_handler();
+  ASSERT_EQ(burst_sizes_, std::vector<size_t>({controller_->le_max_acl_packet_credits_, 5}));
+  ASSERT_EQ(round_robin_scheduler_->GetLeCredits(), 0);
+
+  round_robin_scheduler_->Unregister(le_handle);
+}
+
 }  // namespace acl_manager
 }  // namespace hci
 }  // namespace bluetooth
@@ -74,6 +74,11 @@ class MockAclManager : public AclManager {
   MOCK_METHOD(void, CreateConnection, (Address address), (override));
   MOCK_METHOD(void, CreateLeConnection, (AddressWithType address_with_type, bool is_direct), (override));
   MOCK_METHOD(void, CancelConnect, (Address address), (override));
+  MOCK_METHOD(
+      void,
+      SetAclTrafficClass,
+      (uint16_t handle, acl_manager::DeficitRoundRobin::TrafficClass traffic_class),
+      (override));
   MOCK_METHOD(
       void,
       SetPrivacyPolicyForInitiatorAddress,
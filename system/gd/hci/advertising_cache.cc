@@ -0,0 +1,147 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/advertising_cache.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "os/log.h"
+
+namespace bluetooth {
+namespace hci {
+
+AdvertisingCache::AdvertisingCache() {
+  ClearAll();
+}
+
+std::vector<uint8_t> AdvertisingCache::Set(const AddressWithType& address_with_type, const std::vector<uint8_t>& data) {
+  Entry& entry = GetOrCreate(address_with_type);
+  FreeBlocks(entry);
+  AppendToEntry(entry, data);
+  return ReadEntry(entry);
+}
+
+bool AdvertisingCache::Exist(const AddressWithType& address_with_type) {
+  return entries_.find(address_with_type) != entries_.end();
+}
+
+std::vector<uint8_t> AdvertisingCache::Append(
+    const AddressWithType& address_with_type, const std::vector<uint8_t>& data) {
+  Entry& entry = GetOrCreate(address_with_type);
+  AppendToEntry(entry, data);
+  return ReadEntry(entry);
+}
+
+void AdvertisingCache::Clear(const AddressWithType& address_with_type) {
+  auto node = entries_.extract(address_with_type);
+  if (node) {
+    FreeBlocks(node->second);
+  }
+}
+
+void AdvertisingCache::ClearAll() {
+  entries_.clear();
+  for (size_t i = 0; i < kNumBlocks; i++) {
+    next_block_[i] = i + 1 < kNumBlocks ? i + 1 : kNoBlock;
+  }
+  free_list_ = 0;
+  free_block_count_ = kNumBlocks;
+}
+
+size_t AdvertisingCache::GetEntryCount() const {
+  return entries_.size();
+}
+
+size_t AdvertisingCache::GetFreeBlockCount() const {
+  return free_block_count_;
+}
+
+AdvertisingCache::Entry& AdvertisingCache::GetOrCreate(const AddressWithType& address_with_type) {
+  auto it = entries_.find(address_with_type);
+  if (it != entries_.end()) {
+    return it->second;
+  }
+  auto evicted = entries_.insert_or_assign(address_with_type, Entry{});
+  if (evicted) {
+    FreeBlocks(evicted->second);
+  }
+  return entries_.begin()->second;
+}
+
+void AdvertisingCache::AppendToEntry(Entry& entry, const std::vector<uint8_t>& data) {
+  size_t to_copy = std::min(data.size(), kMaxDataLength - entry.length);
+  size_t copied = 0;
+  while (copied < to_copy) {
+    size_t offset_in_block = entry.length % kBlockSize;
+    if (offset_in_block == 0) {
+      uint16_t block = AllocateBlock(entry);
+      if (entry.first_block == kNoBlock) {
+        entry.first_block = block;
+      } else {
+        next_block_[entry.last_block] = block;
+      }
+      entry.last_block = block;
+    }
+    size_t chunk = std::min(to_copy - copied, kBlockSize - offset_in_block);
+    std::copy_n(data.begin() + copied, chunk, blocks_[entry.last_block].begin() + offset_in_block);
+    copied += chunk;
+    entry.length += chunk;
+  }
+}
+
+std::vector<uint8_t> AdvertisingCache::ReadEntry(const Entry& entry) const {
+  std::vector<uint8_t> data;
+  data.reserve(entry.length);
+  uint16_t block = entry.first_block;
+  while (data.size() < entry.length) {
+    size_t chunk = std::min<size_t>(entry.length - data.size(), kBlockSize);
+    data.insert(data.end(), blocks_[block].begin(), blocks_[block].begin() + chunk);
+    block = next_block_[block];
+  }
+  return data;
+}
+
+uint16_t AdvertisingCache::AllocateBlock(const Entry& keep) {
+  while (free_list_ == kNoBlock) {
+    // |keep| was just looked up so it is the warmest entry, the coldest one is at the back.
+    ASSERT_LOG(entries_.size() > 1, "Advertising cache arena is too small for a single entry");
+    auto coldest = std::prev(entries_.end());
+    ASSERT(&coldest->second != &keep);
+    FreeBlocks(coldest->second);
+    entries_.erase(coldest);
+  }
+  uint16_t block = free_list_;
+  free_list_ = next_block_[block];
+  next_block_[block] = kNoBlock;
+  free_block_count_--;
+  return block;
+}
+
+void AdvertisingCache::FreeBlocks(Entry& entry) {
+  uint16_t block = entry.first_block;
+  while (block != kNoBlock) {
+    uint16_t next = next_block_[block];
+    next_block_[block] = free_list_;
+    free_list_ = block;
+    free_block_count_++;
+    block = next;
+  }
+  entry = Entry{};
+}
+
+}  // namespace hci
+}  // namespace bluetooth
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "common/fixed_lru_cache.h"
+#include "hci/address_with_type.h"
+
+namespace bluetooth {
+namespace hci {
+
+// Advertising data waiting for its scan response or the rest of its extended advertising chain, per advertiser.
+//
+// Entries are found through a hash map and evicted least recently used first once kMaxEntries advertisers are cached.
+// The data itself lives in a fixed arena of kBlockSize blocks, chained per entry, so memory does not grow with the
+// number of advertisers nearby. When the arena is full the least recently used entries are evicted to make room.
+class AdvertisingCache {
+ public:
+  static constexpr size_t kMaxEntries = 1000;
+  static constexpr size_t kBlockSize = 64;
+  static constexpr size_t kNumBlocks = 1024;
+  // Largest advertising data allowed by the specification (Core 5.3, Vol 4, Part E, 7.8.54), longer data is cut off.
+  static constexpr size_t kMaxDataLength = 1650;
+
+  AdvertisingCache();
+  AdvertisingCache(const AdvertisingCache&) = delete;
+  AdvertisingCache& operator=(const AdvertisingCache&) = delete;
+
+  // Replace the data cached for |address_with_type| and return everything now cached for it.
+  std::vector<uint8_t> Set(const AddressWithType& address_with_type, const std::vector<uint8_t>& data);
+
+  bool Exist(const AddressWithType& address_with_type);
+
+  // Add |data| to what is cached for |address_with_type| and return everything now cached for it.
+  std::vector<uint8_t> Append(const AddressWithType& address_with_type, const std::vector<uint8_t>& data);
+
+  /* Clear data for device |addr_type, addr| */
+  void Clear(const AddressWithType& address_with_type);
+
+  void ClearAll();
+
+  size_t GetEntryCount() const;
+
+  size_t GetFreeBlockCount() const;
+
+ private:
+  static constexpr uint16_t kNoBlock = 0xffff;
+  static_assert(kNumBlocks < kNoBlock, "Block indices must fit in 16 bits");
+  static_assert(kMaxDataLength <= kBlockSize * kNumBlocks, "A single entry must fit in the arena");
+
+  struct Entry {
+    uint16_t first_block = kNoBlock;
+    uint16_t last_block = kNoBlock;
+    uint16_t length = 0;
+  };
+
+  // Return the entry for |address_with_type|, creating an empty one if there is none.
+  Entry& GetOrCreate(const AddressWithType& address_with_type);
+
+  void AppendToEntry(Entry& entry, const std::vector<uint8_t>& data);
+
+  std::vector<uint8_t> ReadEntry(const Entry& entry) const;
+
+  // Take a block from the free list, evicting least recently used entries when it is empty. |keep| is never evicted.
+  uint16_t AllocateBlock(const Entry& keep);
+
+  void FreeBlocks(Entry& entry);
+
+  common::FixedLruCache<AddressWithType, Entry> entries_{kMaxEntries};
+  std::array<std::array<uint8_t, kBlockSize>, kNumBlocks> blocks_;
+  std::array<uint16_t, kNumBlocks> next_block_;
+  uint16_t free_list_ = kNoBlock;
+  size_t free_block_count_ = 0;
+};
+
+}  // namespace hci
+}  // namespace bluetooth
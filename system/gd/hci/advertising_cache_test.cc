@@ -0,0 +1,123 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/advertising_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace bluetooth {
+namespace hci {
+namespace {
+
+AddressWithType address_for(size_t i) {
+  return AddressWithType(
+      Address({static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8), 0x00, 0x00, 0x00, 0xc0}),
+      AddressType::RANDOM_DEVICE_ADDRESS);
+}
+
+std::vector<uint8_t> data_of_length(size_t length, uint8_t seed = 0) {
+  std::vector<uint8_t> data(length);
+  for (size_t i = 0; i < length; i++) {
+    data[i] = static_cast<uint8_t>(seed + i);
+  }
+  return data;
+}
+
+class AdvertisingCacheTest : public ::testing::Test {
+ protected:
+  AdvertisingCache cache_;
+};
+
+TEST_F(AdvertisingCacheTest, set_append_clear) {
+  auto address = address_for(1);
+  ASSERT_FALSE(cache_.Exist(address));
+  ASSERT_EQ(std::vector<uint8_t>({0x01, 0x02}), cache_.Set(address, {0x01, 0x02}));
+  ASSERT_TRUE(cache_.Exist(address));
+  ASSERT_EQ(std::vector<uint8_t>({0x01, 0x02, 0x03}), cache_.Append(address, {0x03}));
+  ASSERT_EQ(std::vector<uint8_t>({0x04}), cache_.Set(address, {0x04}));
+  cache_.Clear(address);
+  ASSERT_FALSE(cache_.Exist(address));
+  ASSERT_EQ(AdvertisingCache::kNumBlocks, cache_.GetFreeBlockCount());
+}
+
+TEST_F(AdvertisingCacheTest, append_creates_entry) {
+  auto address = address_for(1);
+  ASSERT_EQ(std::vector<uint8_t>({0x01}), cache_.Append(address, {0x01}));
+  ASSERT_TRUE(cache_.Exist(address));
+  ASSERT_TRUE(cache_.Set(address_for(2), {}).empty());
+  ASSERT_TRUE(cache_.Exist(address_for(2)));
+}
+
+TEST_F(AdvertisingCacheTest, address_type_is_part_of_key) {
+  AddressWithType public_address(address_for(1).GetAddress(), AddressType::PUBLIC_DEVICE_ADDRESS);
+  cache_.Set(address_for(1), {0x01});
+  ASSERT_FALSE(cache_.Exist(public_address));
+}
+
+TEST_F(AdvertisingCacheTest, data_spanning_blocks) {
+  auto address = address_for(1);
+  std::vector<uint8_t> expected;
+  for (size_t i = 0; i < 20; i++) {
+    auto chunk = data_of_length(31, i);
+    expected.insert(expected.end(), chunk.begin(), chunk.end());
+    ASSERT_EQ(expected, cache_.Append(address, chunk));
+  }
+  size_t blocks_used = (expected.size() + AdvertisingCache::kBlockSize - 1) / AdvertisingCache::kBlockSize;
+  ASSERT_EQ(AdvertisingCache::kNumBlocks - blocks_used, cache_.GetFreeBlockCount());
+  cache_.Set(address, {0x01});
+  ASSERT_EQ(AdvertisingCache::kNumBlocks - 1, cache_.GetFreeBlockCount());
+}
+
+TEST_F(AdvertisingCacheTest, data_is_capped) {
+  auto address = address_for(1);
+  auto data = data_of_length(AdvertisingCache::kMaxDataLength + 10);
+  auto cached = cache_.Set(address, data);
+  ASSERT_EQ(AdvertisingCache::kMaxDataLength, cached.size());
+  ASSERT_EQ(AdvertisingCache::kMaxDataLength, cache_.Append(address, {0x01}).size());
+}
+
+TEST_F(AdvertisingCacheTest, least_recently_used_entry_is_evicted) {
+  for (size_t i = 0; i < AdvertisingCache::kMaxEntries; i++) {
+    cache_.Set(address_for(i), {0x01});
+  }
+  ASSERT_TRUE(cache_.Exist(address_for(0)));
+  cache_.Set(address_for(AdvertisingCache::kMaxEntries), {0x02});
+  ASSERT_EQ(AdvertisingCache::kMaxEntries, cache_.GetEntryCount());
+  ASSERT_TRUE(cache_.Exist(address_for(0)));
+  ASSERT_FALSE(cache_.Exist(address_for(1)));
+  ASSERT_EQ(AdvertisingCache::kNumBlocks - AdvertisingCache::kMaxEntries, cache_.GetFreeBlockCount());
+}
+
+TEST_F(AdvertisingCacheTest, full_arena_evicts_coldest_entries) {
+  auto full_entry = data_of_length(AdvertisingCache::kMaxDataLength);
+  size_t blocks_per_entry = (full_entry.size() + AdvertisingCache::kBlockSize - 1) / AdvertisingCache::kBlockSize;
+  size_t entries_that_fit = AdvertisingCache::kNumBlocks / blocks_per_entry;
+  for (size_t i = 0; i < entries_that_fit * 3; i++) {
+    ASSERT_EQ(full_entry, cache_.Set(address_for(i), full_entry));
+    ASSERT_LE(cache_.GetEntryCount(), entries_that_fit);
+  }
+  ASSERT_TRUE(cache_.Exist(address_for(entries_that_fit * 3 - 1)));
+  ASSERT_FALSE(cache_.Exist(address_for(0)));
+  cache_.ClearAll();
+  ASSERT_EQ(0u, cache_.GetEntryCount());
+  ASSERT_EQ(AdvertisingCache::kNumBlocks, cache_.GetFreeBlockCount());
+}
+
+}  // namespace
+}  // namespace hci
+}  // namespace bluetooth
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/advertising_report_deduplicator.h"
+
+namespace bluetooth {
+namespace hci {
+
+namespace {
+
+constexpr uint16_t kScanResponseBit = 1 << 3;
+
+static_assert(
+    (AdvertisingReportDeduplicator::kCapacity & (AdvertisingReportDeduplicator::kCapacity - 1)) == 0,
+    "Capacity must be a power of two");
+
+uint64_t make_key(const Address& address, uint8_t address_type, uint8_t advertising_sid, uint16_t event_type) {
+  uint64_t key = 0;
+  for (size_t i = 0; i < Address::kLength; i++) {
+    key |= static_cast<uint64_t>(address.address[i]) << (8 * i);
+  }
+  key |= static_cast<uint64_t>(address_type & 0x0f) << 48;
+  key |= static_cast<uint64_t>(advertising_sid) << 52;
+  key |= static_cast<uint64_t>((event_type & kScanResponseBit) ? 1 : 0) << 60;
+  return key;
+}
+
+// FNV-1a
+uint64_t hash_data(uint16_t event_type, const uint8_t* data, size_t length) {
+  uint64_t hash = 0xcbf29ce484222325ull;
+  auto add = [&hash](uint8_t byte) {
+    hash ^= byte;
+    hash *= 0x100000001b3ull;
+  };
+  add(static_cast<uint8_t>(event_type));
+  add(static_cast<uint8_t>(event_type >> 8));
+  for (size_t i = 0; i < length; i++) {
+    add(data[i]);
+  }
+  return hash;
+}
+
+size_t slot_index(uint64_t key) {
+  // Fibonacci hashing spreads the mostly sequential low address bytes over the table.
+  return static_cast<size_t>((key * 0x9e3779b97f4a7c15ull) >> 40) & (AdvertisingReportDeduplicator::kCapacity - 1);
+}
+
+}  // namespace
+
+AdvertisingReportDeduplicator::AdvertisingReportDeduplicator(std::chrono::milliseconds window) : window_(window) {}
+
+bool AdvertisingReportDeduplicator::IsDuplicate(
+    const Address& address,
+    uint8_t address_type,
+    uint8_t advertising_sid,
+    uint16_t event_type,
+    const uint8_t* data,
+    size_t length,
+    Clock::time_point now) {
+  uint64_t key = make_key(address, address_type, advertising_sid, event_type);
+  uint64_t data_hash = hash_data(event_type, data, length);
+
+  Slot* victim = nullptr;
+  size_t index = slot_index(key);
+  for (size_t probe = 0; probe < kMaxProbes; probe++) {
+    Slot& slot = slots_[(index + probe) & (kCapacity - 1)];
+    if (!slot.in_use) {
+      // Slots are never freed, so the key can't be further along the probe sequence.
+      victim = &slot;
+      break;
+    }
+    if (slot.key == key) {
+      if (slot.data_hash == data_hash && now - slot.last_reported < window_) {
+        duplicate_count_++;
+        return true;
+      }
+      slot.data_hash = data_hash;
+      slot.last_reported = now;
+      return false;
+    }
+    if (victim == nullptr || slot.last_reported < victim->last_reported) {
+      victim = &slot;
+    }
+  }
+
+  *victim = {.key = key, .data_hash = data_hash, .last_reported = now, .in_use = true};
+  return false;
+}
+
+void AdvertisingReportDeduplicator::Clear() {
+  slots_.fill({});
+  duplicate_count_ = 0;
+}
+
+size_t AdvertisingReportDeduplicator::GetDuplicateCount() const {
+  return duplicate_count_;
+}
+
+}  // namespace hci
+}  // namespace bluetooth
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "hci/address.h"
+
+namespace bluetooth {
+namespace hci {
+
+// Remembers the last advertising data reported by each advertiser so repeats (the same PDU on each primary channel,
+// fast advertisers) can be dropped before anything is allocated for them. Advertisers are keyed by address, address
+// type, SID and whether the report is a scan response.
+//
+// Storage is a fixed size open-addressed table with linear probing, so memory stays constant. When every slot in a
+// probe sequence is in use the least recently seen advertiser in it is evicted.
+class AdvertisingReportDeduplicator {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  static constexpr size_t kCapacity = 512;
+  static constexpr size_t kMaxProbes = 8;
+
+  explicit AdvertisingReportDeduplicator(std::chrono::milliseconds window);
+
+  // Return true if the same advertiser reported the same event type and data less than |window| ago. Otherwise the
+  // report is recorded and false is returned. A duplicate does not extend the window, so a steady advertiser is still
+  // reported once per window.
+  bool IsDuplicate(
+      const Address& address,
+      uint8_t address_type,
+      uint8_t advertising_sid,
+      uint16_t event_type,
+      const uint8_t* data,
+      size_t length,
+      Clock::time_point now);
+
+  void Clear();
+
+  size_t GetDuplicateCount() const;
+
+ private:
+  struct Slot {
+    uint64_t key;
+    uint64_t data_hash;
+    Clock::time_point last_reported;
+    bool in_use;
+  };
+
+  std::chrono::milliseconds window_;
+  std::array<Slot, kCapacity> slots_{};
+  size_t duplicate_count_{0};
+};
+
+}  // namespace hci
+}  // namespace bluetooth
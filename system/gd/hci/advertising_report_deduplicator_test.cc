@@ -0,0 +1,105 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/advertising_report_deduplicator.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace bluetooth {
+namespace hci {
+namespace {
+
+using std::chrono::milliseconds;
+using Clock = AdvertisingReportDeduplicator::Clock;
+
+constexpr uint16_t kAdvInd = 0x13;
+constexpr uint16_t kScanResponse = 0x1b;
+
+const Address kAddress({0x01, 0x02, 0x03, 0x04, 0x05, 0x06});
+const std::vector<uint8_t> kData = {0x02, 0x01, 0x06};
+const std::vector<uint8_t> kOtherData = {0x02, 0x01, 0x04};
+
+class AdvertisingReportDeduplicatorTest : public ::testing::Test {
+ protected:
+  bool IsDuplicate(
+      const Address& address,
+      uint16_t event_type,
+      const std::vector<uint8_t>& data,
+      milliseconds elapsed,
+      uint8_t advertising_sid = 0xff) {
+    return deduplicator_.IsDuplicate(
+        address, 0x00, advertising_sid, event_type, data.data(), data.size(), start_ + elapsed);
+  }
+
+  AdvertisingReportDeduplicator deduplicator_{milliseconds(100)};
+  Clock::time_point start_ = Clock::now();
+};
+
+TEST_F(AdvertisingReportDeduplicatorTest, repeat_within_window_is_duplicate) {
+  ASSERT_FALSE(IsDuplicate(kAddress, kAdvInd, kData, milliseconds(0)));
+  ASSERT_TRUE(IsDuplicate(kAddress, kAdvInd, kData, milliseconds(1)));
+  ASSERT_TRUE(IsDuplicate(kAddress, kAdvInd, kData, milliseconds(99)));
+  ASSERT_EQ(2u, deduplicator_.GetDuplicateCount());
+}
+
+TEST_F(AdvertisingReportDeduplicatorTest, duplicates_do_not_extend_window) {
+  ASSERT_FALSE(IsDuplicate(kAddress, kAdvInd, kData, milliseconds(0)));
+  ASSERT_TRUE(IsDuplicate(kAddress, kAdvInd, kData, milliseconds(60)));
+  ASSERT_FALSE(IsDuplicate(kAddress, kAdvInd, kData, milliseconds(100)));
+  ASSERT_TRUE(IsDuplicate(kAddress, kAdvInd, kData, milliseconds(150)));
+}
+
+TEST_F(AdvertisingReportDeduplicatorTest, changed_data_is_reported) {
+  ASSERT_FALSE(IsDuplicate(kAddress, kAdvInd, kData, milliseconds(0)));
+  ASSERT_FALSE(IsDuplicate(kAddress, kAdvInd, kOtherData, milliseconds(1)));
+  ASSERT_FALSE(IsDuplicate(kAddress, kAdvInd, kData, milliseconds(2)));
+  ASSERT_FALSE(IsDuplicate(kAddress, 0x10, kData, milliseconds(3)));
+}
+
+TEST_F(AdvertisingReportDeduplicatorTest, scan_response_and_sid_are_separate) {
+  ASSERT_FALSE(IsDuplicate(kAddress, kAdvInd, kData, milliseconds(0)));
+  ASSERT_FALSE(IsDuplicate(kAddress, kScanResponse, kData, milliseconds(1)));
+  ASSERT_FALSE(IsDuplicate(kAddress, kAdvInd, kData, milliseconds(2), 1));
+  ASSERT_TRUE(IsDuplicate(kAddress, kAdvInd, kData, milliseconds(3)));
+  ASSERT_TRUE(IsDuplicate(kAddress, kScanResponse, kData, milliseconds(4)));
+  ASSERT_TRUE(IsDuplicate(kAddress, kAdvInd, kData, milliseconds(5), 1));
+}
+
+TEST_F(AdvertisingReportDeduplicatorTest, more_advertisers_than_capacity) {
+  constexpr size_t kAdvertisers = AdvertisingReportDeduplicator::kCapacity * 4;
+  auto address_for = [](size_t i) {
+    return Address({static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8), 0x00, 0x00, 0x00, 0xc0});
+  };
+  for (size_t i = 0; i < kAdvertisers; i++) {
+    ASSERT_FALSE(IsDuplicate(address_for(i), kAdvInd, kData, milliseconds(i / 64)));
+  }
+  // The most recent advertiser can't have been evicted yet.
+  ASSERT_TRUE(IsDuplicate(address_for(kAdvertisers - 1), kAdvInd, kData, milliseconds(kAdvertisers / 64)));
+}
+
+TEST_F(AdvertisingReportDeduplicatorTest, clear) {
+  ASSERT_FALSE(IsDuplicate(kAddress, kAdvInd, kData, milliseconds(0)));
+  ASSERT_TRUE(IsDuplicate(kAddress, kAdvInd, kData, milliseconds(1)));
+  deduplicator_.Clear();
+  ASSERT_EQ(0u, deduplicator_.GetDuplicateCount());
+  ASSERT_FALSE(IsDuplicate(kAddress, kAdvInd, kData, milliseconds(2)));
+}
+
+}  // namespace
+}  // namespace hci
+}  // namespace bluetooth
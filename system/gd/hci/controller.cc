@@ -16,83 +16,192 @@
 
 #include "hci/controller.h"
 
+#include <algorithm>
 #include <future>
+#include <list>
+#include <map>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "common/init_flags.h"
+#include "common/strings.h"
 #include "hci/hci_layer.h"
+#include "packet/bit_inserter.h"
+#include "storage/storage_module.h"
 
 namespace bluetooth {
 namespace hci {
 
 using os::Handler;
 
+// Version of the capability snapshot, to be bumped whenever the capability reads change
+constexpr uint8_t kCapabilitiesVersion = 1;
+
+// The reads of the capabilities that only depend on the controller firmware, replayed from the snapshot persisted by
+// the previous bring-up when the firmware is the same
+static bool is_capability_read(OpCode op_code) {
+  switch (op_code) {
+    case OpCode::READ_LOCAL_SUPPORTED_COMMANDS:
+    case OpCode::READ_LOCAL_EXTENDED_FEATURES:
+    case OpCode::READ_BUFFER_SIZE:
+    case OpCode::LE_READ_LOCAL_SUPPORTED_FEATURES:
+    case OpCode::LE_READ_SUPPORTED_STATES:
+    case OpCode::LE_READ_BUFFER_SIZE_V1:
+    case OpCode::LE_READ_BUFFER_SIZE_V2:
+    case OpCode::LE_READ_FILTER_ACCEPT_LIST_SIZE:
+    case OpCode::LE_READ_RESOLVING_LIST_SIZE:
+    case OpCode::LE_READ_MAXIMUM_DATA_LENGTH:
+    case OpCode::LE_READ_SUGGESTED_DEFAULT_DATA_LENGTH:
+    case OpCode::LE_READ_MAXIMUM_ADVERTISING_DATA_LENGTH:
+    case OpCode::LE_READ_NUMBER_OF_SUPPORTED_ADVERTISING_SETS:
+    case OpCode::LE_READ_PERIODIC_ADVERTISING_LIST_SIZE:
+    case OpCode::LE_GET_VENDOR_CAPABILITIES:
+      return true;
+    default:
+      return false;
+  }
+}
+
+static OpCode get_op_code(const CommandBuilder& command) {
+  auto bytes = std::make_shared<std::vector<uint8_t>>();
+  packet::BitInserter bi(*bytes);
+  command.Serialize(bi);
+  auto view = CommandView::Create(packet::PacketView<packet::kLittleEndian>(bytes));
+  ASSERT(view.IsValid());
+  return view.GetOpCode();
+}
+
+static CommandCompleteView make_command_complete_view(std::vector<uint8_t> bytes) {
+  return CommandCompleteView::Create(EventView::Create(
+      packet::PacketView<packet::kLittleEndian>(std::make_shared<std::vector<uint8_t>>(std::move(bytes)))));
+}
+
+template <class CompleteView>
+static bool is_successful_complete(CommandCompleteView view) {
+  auto complete_view = CompleteView::Create(view);
+  return complete_view.IsValid() && complete_view.GetStatus() == ErrorCode::SUCCESS;
+}
+
+// Whether a capability read response of the snapshot is one its handler accepts: the snapshot is persisted, a response
+// failing the checks of the handler would fail every bring-up
+static bool is_valid_capability(OpCode op_code, const std::vector<uint8_t>& bytes) {
+  auto view = make_command_complete_view(bytes);
+  if (!view.IsValid() || view.GetCommandOpCode() != op_code) {
+    return false;
+  }
+  switch (op_code) {
+    case OpCode::READ_LOCAL_SUPPORTED_COMMANDS:
+      return is_successful_complete<ReadLocalSupportedCommandsCompleteView>(view);
+    case OpCode::READ_LOCAL_EXTENDED_FEATURES:
+      return is_successful_complete<ReadLocalExtendedFeaturesCompleteView>(view);
+    case OpCode::READ_BUFFER_SIZE:
+      return is_successful_complete<ReadBufferSizeCompleteView>(view);
+    case OpCode::LE_READ_LOCAL_SUPPORTED_FEATURES:
+      return is_successful_complete<LeReadLocalSupportedFeaturesCompleteView>(view);
+    case OpCode::LE_READ_SUPPORTED_STATES:
+      return is_successful_complete<LeReadSupportedStatesCompleteView>(view);
+    case OpCode::LE_READ_BUFFER_SIZE_V1:
+      return is_successful_complete<LeReadBufferSizeV1CompleteView>(view);
+    case OpCode::LE_READ_BUFFER_SIZE_V2:
+      return is_successful_complete<LeReadBufferSizeV2CompleteView>(view);
+    case OpCode::LE_READ_FILTER_ACCEPT_LIST_SIZE:
+      return is_successful_complete<LeReadFilterAcceptListSizeCompleteView>(view);
+    case OpCode::LE_READ_RESOLVING_LIST_SIZE:
+      return is_successful_complete<LeReadResolvingListSizeCompleteView>(view);
+    case OpCode::LE_READ_MAXIMUM_DATA_LENGTH:
+      return is_successful_complete<LeReadMaximumDataLengthCompleteView>(view);
+    case OpCode::LE_READ_SUGGESTED_DEFAULT_DATA_LENGTH:
+      return is_successful_complete<LeReadSuggestedDefaultDataLengthCompleteView>(view);
+    case OpCode::LE_READ_MAXIMUM_ADVERTISING_DATA_LENGTH:
+      return is_successful_complete<LeReadMaximumAdvertisingDataLengthCompleteView>(view);
+    case OpCode::LE_READ_NUMBER_OF_SUPPORTED_ADVERTISING_SETS:
+      return is_successful_complete<LeReadNumberOfSupportedAdvertisingSetsCompleteView>(view);
+    case OpCode::LE_READ_PERIODIC_ADVERTISING_LIST_SIZE:
+      return is_successful_complete<LeReadPeriodicAdvertiserListSizeCompleteView>(view);
+    case OpCode::LE_GET_VENDOR_CAPABILITIES:
+      // A failed read tells that the controller has no vendor capabilities, the handler accepts any response
+      return true;
+    default:
+      return false;
+  }
+}
+
 struct Controller::impl {
   impl(Controller& module) : module_(module) {}
 
-  void Start(hci::HciLayer* hci) {
+  void Start(hci::HciLayer* hci, storage::StorageModule* storage) {
     hci_ = hci;
     Handler* handler = module_.GetHandler();
     hci_->RegisterEventHandler(
         EventCode::NUMBER_OF_COMPLETED_PACKETS, handler->BindOn(this, &Controller::impl::NumberOfCompletedPackets));
 
+    // The bring-up reads go out in batches, whose commands do not depend on each other and are all in flight at once
+    // when the HCI layer pipelines commands: the first batch reads the firmware version, which tells whether the
+    // capabilities can be replayed from the last snapshot, the second one what the third one depends on, the
+    // supported commands and features.
+    std::vector<std::future<void>> batch;
     le_set_event_mask(kDefaultLeEventMask);
     set_event_mask(kDefaultEventMask);
     write_le_host_support(Enable::ENABLED, Enable::DISABLED);
-    hci_->EnqueueCommand(ReadLocalNameBuilder::Create(),
-                         handler->BindOnceOn(this, &Controller::impl::read_local_name_complete_handler));
-    hci_->EnqueueCommand(ReadLocalVersionInformationBuilder::Create(),
-                         handler->BindOnceOn(this, &Controller::impl::read_local_version_information_complete_handler));
-    hci_->EnqueueCommand(ReadLocalSupportedCommandsBuilder::Create(),
-                         handler->BindOnceOn(this, &Controller::impl::read_local_supported_commands_complete_handler));
-
-    hci_->EnqueueCommand(
-        LeReadLocalSupportedFeaturesBuilder::Create(),
-        handler->BindOnceOn(this, &Controller::impl::le_read_local_supported_features_handler));
-
-    hci_->EnqueueCommand(
-        LeReadSupportedStatesBuilder::Create(),
-        handler->BindOnceOn(this, &Controller::impl::le_read_supported_states_handler));
-
-    // Wait for all extended features read
+    enqueue_batch_command(ReadLocalNameBuilder::Create(), &impl::read_local_name_complete_handler, &batch);
+    enqueue_batch_command(
+        ReadLocalVersionInformationBuilder::Create(), &impl::read_local_version_information_complete_handler, &batch);
+    enqueue_batch_command(ReadBdAddrBuilder::Create(), &impl::read_controller_mac_address_handler, &batch);
+    wait_for_batch(&batch);
+
+    storage::AdapterConfig adapter_config = storage->GetAdapterConfig();
+    std::string snapshot = adapter_config.GetControllerCapabilities().value_or("");
+    load_capabilities(snapshot);
+
+    enqueue_batch_command(
+        ReadLocalSupportedCommandsBuilder::Create(), &impl::read_local_supported_commands_complete_handler, &batch);
+    enqueue_batch_command(
+        LeReadLocalSupportedFeaturesBuilder::Create(), &impl::le_read_local_supported_features_handler, &batch);
+    enqueue_batch_command(LeReadSupportedStatesBuilder::Create(), &impl::le_read_supported_states_handler, &batch);
+
+    // Done once all extended features read
     std::promise<void> features_promise;
-    auto features_future = features_promise.get_future();
-    hci_->EnqueueCommand(ReadLocalExtendedFeaturesBuilder::Create(0x00),
-                         handler->BindOnceOn(this, &Controller::impl::read_local_extended_features_complete_handler,
-                                             std::move(features_promise)));
-    features_future.wait();
+    batch.push_back(features_promise.get_future());
+    auto cached_features = cached_capabilities_.find(OpCode::READ_LOCAL_EXTENDED_FEATURES);
+    if (cached_features != cached_capabilities_.end()) {
+      std::vector<std::vector<uint8_t>> pages(cached_features->second.begin(), cached_features->second.end());
+      cached_capabilities_.erase(cached_features);
+      handler
+          ->BindOnceOn(
+              this, &Controller::impl::replay_extended_features, std::move(pages), std::move(features_promise))
+          .Invoke();
+    } else {
+      hci_->EnqueueCommand(
+          ReadLocalExtendedFeaturesBuilder::Create(0x00),
+          handler->BindOnceOn(
+              this, &Controller::impl::read_local_extended_features_complete_handler, std::move(features_promise)));
+    }
 
-    hci_->EnqueueCommand(ReadBufferSizeBuilder::Create(),
-                         handler->BindOnceOn(this, &Controller::impl::read_buffer_size_complete_handler));
+    enqueue_batch_command(ReadBufferSizeBuilder::Create(), &impl::read_buffer_size_complete_handler, &batch);
+    enqueue_batch_command(
+        LeReadFilterAcceptListSizeBuilder::Create(), &impl::le_read_connect_list_size_handler, &batch);
+    enqueue_batch_command(LeGetVendorCapabilitiesBuilder::Create(), &impl::le_get_vendor_capabilities_handler, &batch);
+    wait_for_batch(&batch);
 
     if (is_supported(OpCode::LE_READ_BUFFER_SIZE_V2)) {
-      hci_->EnqueueCommand(
-          LeReadBufferSizeV2Builder::Create(),
-          handler->BindOnceOn(this, &Controller::impl::le_read_buffer_size_v2_handler));
+      enqueue_batch_command(LeReadBufferSizeV2Builder::Create(), &impl::le_read_buffer_size_v2_handler, &batch);
     } else {
-      hci_->EnqueueCommand(
-          LeReadBufferSizeV1Builder::Create(),
-          handler->BindOnceOn(this, &Controller::impl::le_read_buffer_size_handler));
+      enqueue_batch_command(LeReadBufferSizeV1Builder::Create(), &impl::le_read_buffer_size_handler, &batch);
     }
 
-    hci_->EnqueueCommand(
-        LeReadFilterAcceptListSizeBuilder::Create(),
-        handler->BindOnceOn(this, &Controller::impl::le_read_connect_list_size_handler));
-
     if (is_supported(OpCode::LE_READ_RESOLVING_LIST_SIZE) && module_.SupportsBlePrivacy()) {
-      hci_->EnqueueCommand(
-          LeReadResolvingListSizeBuilder::Create(),
-          handler->BindOnceOn(this, &Controller::impl::le_read_resolving_list_size_handler));
+      enqueue_batch_command(
+          LeReadResolvingListSizeBuilder::Create(), &impl::le_read_resolving_list_size_handler, &batch);
     } else {
       LOG_INFO("LE_READ_RESOLVING_LIST_SIZE not supported, defaulting to 0");
       le_resolving_list_size_ = 0;
     }
 
     if (is_supported(OpCode::LE_READ_MAXIMUM_DATA_LENGTH) && module_.SupportsBleDataPacketLengthExtension()) {
-      hci_->EnqueueCommand(LeReadMaximumDataLengthBuilder::Create(),
-                           handler->BindOnceOn(this, &Controller::impl::le_read_maximum_data_length_handler));
+      enqueue_batch_command(
+          LeReadMaximumDataLengthBuilder::Create(), &impl::le_read_maximum_data_length_handler, &batch);
     } else {
       LOG_INFO("LE_READ_MAXIMUM_DATA_LENGTH not supported, defaulting to 0");
       le_maximum_data_length_.supported_max_rx_octets_ = 0;
@@ -105,24 +214,27 @@ struct Controller::impl {
     if (!common::init_flags::gd_security_is_enabled()) {
       write_simple_pairing_mode(Enable::ENABLED);
       if (module_.SupportsSecureConnections()) {
-        hci_->EnqueueCommand(
+        enqueue_batch_command(
             WriteSecureConnectionsHostSupportBuilder::Create(Enable::ENABLED),
-            handler->BindOnceOn(this, &Controller::impl::write_secure_connections_host_support_complete_handler));
+            &impl::write_secure_connections_host_support_complete_handler,
+            &batch);
       }
     }
     if (is_supported(OpCode::LE_READ_SUGGESTED_DEFAULT_DATA_LENGTH) && module_.SupportsBleDataPacketLengthExtension()) {
-      hci_->EnqueueCommand(
+      enqueue_batch_command(
           LeReadSuggestedDefaultDataLengthBuilder::Create(),
-          handler->BindOnceOn(this, &Controller::impl::le_read_suggested_default_data_length_handler));
+          &impl::le_read_suggested_default_data_length_handler,
+          &batch);
     } else {
       LOG_INFO("LE_READ_SUGGESTED_DEFAULT_DATA_LENGTH not supported, defaulting to 27 (0x1B)");
       le_suggested_default_data_length_ = 27;
     }
 
     if (is_supported(OpCode::LE_READ_MAXIMUM_ADVERTISING_DATA_LENGTH) && module_.SupportsBleExtendedAdvertising()) {
-      hci_->EnqueueCommand(
+      enqueue_batch_command(
           LeReadMaximumAdvertisingDataLengthBuilder::Create(),
-          handler->BindOnceOn(this, &Controller::impl::le_read_maximum_advertising_data_length_handler));
+          &impl::le_read_maximum_advertising_data_length_handler,
+          &batch);
     } else {
       LOG_INFO("LE_READ_MAXIMUM_ADVERTISING_DATA_LENGTH not supported, defaulting to 31 (0x1F)");
       le_maximum_advertising_data_length_ = 31;
@@ -130,38 +242,156 @@ struct Controller::impl {
 
     if (is_supported(OpCode::LE_READ_NUMBER_OF_SUPPORTED_ADVERTISING_SETS) &&
         module_.SupportsBleExtendedAdvertising()) {
-      hci_->EnqueueCommand(
+      enqueue_batch_command(
           LeReadNumberOfSupportedAdvertisingSetsBuilder::Create(),
-          handler->BindOnceOn(this, &Controller::impl::le_read_number_of_supported_advertising_sets_handler));
+          &impl::le_read_number_of_supported_advertising_sets_handler,
+          &batch);
     } else {
       LOG_INFO("LE_READ_NUMBER_OF_SUPPORTED_ADVERTISING_SETS not supported, defaulting to 1");
       le_number_supported_advertising_sets_ = 1;
     }
 
     if (is_supported(OpCode::LE_READ_PERIODIC_ADVERTISING_LIST_SIZE) && module_.SupportsBlePeriodicAdvertising()) {
-      hci_->EnqueueCommand(
+      enqueue_batch_command(
           LeReadPeriodicAdvertiserListSizeBuilder::Create(),
-          handler->BindOnceOn(this, &Controller::impl::le_read_periodic_advertiser_list_size_handler));
+          &impl::le_read_periodic_advertiser_list_size_handler,
+          &batch);
     } else {
       LOG_INFO("LE_READ_PERIODIC_ADVERTISING_LIST_SIZE not supported, defaulting to 0");
       le_periodic_advertiser_list_size_ = 0;
     }
     if (is_supported(OpCode::LE_SET_HOST_FEATURE) && module_.SupportsBleConnectedIsochronousStreamCentral()) {
-      hci_->EnqueueCommand(
+      enqueue_batch_command(
           LeSetHostFeatureBuilder::Create(LeHostFeatureBits::CONNECTED_ISO_STREAM_HOST_SUPPORT, Enable::ENABLED),
-          handler->BindOnceOn(this, &Controller::impl::le_set_host_feature_handler));
+          &impl::le_set_host_feature_handler,
+          &batch);
     }
+    wait_for_batch(&batch);
+
+    cached_capabilities_.clear();
+    std::string new_snapshot = serialize_capabilities();
+    recorded_capabilities_.clear();
+    if (new_snapshot != snapshot) {
+      LOG_INFO("Saving the controller capabilities");
+      auto mutation = storage->Modify();
+      mutation.Add(adapter_config.SetControllerCapabilities(new_snapshot));
+      mutation.Commit();
+    }
+  }
 
-    hci_->EnqueueCommand(LeGetVendorCapabilitiesBuilder::Create(),
-                         handler->BindOnceOn(this, &Controller::impl::le_get_vendor_capabilities_handler));
-
-    // We only need to synchronize the last read. Make BD_ADDR to be the last one.
+  // Enqueue a command of a bring-up batch, whose response may come at any time until the batch is waited for. The
+  // capability reads are answered from the snapshot when it holds their response
+  void enqueue_batch_command(
+      std::unique_ptr<CommandBuilder> command,
+      void (impl::*handler)(CommandCompleteView),
+      std::vector<std::future<void>>* batch) {
     std::promise<void> promise;
-    auto future = promise.get_future();
-    hci_->EnqueueCommand(
-        ReadBdAddrBuilder::Create(),
-        handler->BindOnceOn(this, &Controller::impl::read_controller_mac_address_handler, std::move(promise)));
-    future.wait();
+    batch->push_back(promise.get_future());
+    OpCode op_code = get_op_code(*command);
+    auto callback = module_.GetHandler()->BindOnceOn(
+        this, &Controller::impl::batch_command_complete, op_code, handler, std::move(promise));
+    auto cached = cached_capabilities_.find(op_code);
+    if (cached != cached_capabilities_.end() && !cached->second.empty()) {
+      std::vector<uint8_t> bytes = std::move(cached->second.front());
+      cached->second.pop_front();
+      callback.Invoke(make_command_complete_view(std::move(bytes)));
+      return;
+    }
+    hci_->EnqueueCommand(std::move(command), std::move(callback));
+  }
+
+  void batch_command_complete(
+      OpCode op_code,
+      void (impl::*handler)(CommandCompleteView),
+      std::promise<void> promise,
+      CommandCompleteView view) {
+    if (is_capability_read(op_code)) {
+      record_capability(op_code, view);
+    }
+    (this->*handler)(std::move(view));
+    promise.set_value();
+  }
+
+  void record_capability(OpCode op_code, const CommandCompleteView& view) {
+    recorded_capabilities_.emplace_back(op_code, std::vector<uint8_t>(view.begin(), view.end()));
+  }
+
+  // The snapshot is made of its version, the version information of the controller, then the capability read
+  // responses, each one with its opcode and length
+  void append_version_information(std::vector<uint8_t>* data) const {
+    data->push_back(kCapabilitiesVersion);
+    data->push_back(static_cast<uint8_t>(local_version_information_.hci_version_));
+    data->push_back(static_cast<uint8_t>(local_version_information_.hci_revision_));
+    data->push_back(static_cast<uint8_t>(local_version_information_.hci_revision_ >> 8));
+    data->push_back(static_cast<uint8_t>(local_version_information_.lmp_version_));
+    data->push_back(static_cast<uint8_t>(local_version_information_.manufacturer_name_));
+    data->push_back(static_cast<uint8_t>(local_version_information_.manufacturer_name_ >> 8));
+    data->push_back(static_cast<uint8_t>(local_version_information_.lmp_subversion_));
+    data->push_back(static_cast<uint8_t>(local_version_information_.lmp_subversion_ >> 8));
+  }
+
+  std::string serialize_capabilities() const {
+    std::vector<uint8_t> data;
+    append_version_information(&data);
+    for (const auto& capability : recorded_capabilities_) {
+      uint16_t op_code = static_cast<uint16_t>(capability.first);
+      uint16_t size = static_cast<uint16_t>(capability.second.size());
+      data.insert(data.end(), {static_cast<uint8_t>(op_code), static_cast<uint8_t>(op_code >> 8)});
+      data.insert(data.end(), {static_cast<uint8_t>(size), static_cast<uint8_t>(size >> 8)});
+      data.insert(data.end(), capability.second.begin(), capability.second.end());
+    }
+    return common::ToHexString(data);
+  }
+
+  // Only keep the snapshot taken with the same controller firmware
+  void load_capabilities(const std::string& snapshot) {
+    cached_capabilities_.clear();
+    auto data = common::FromHexString(snapshot);
+    std::vector<uint8_t> version_information;
+    append_version_information(&version_information);
+    if (!data || data->size() < version_information.size() ||
+        !std::equal(version_information.begin(), version_information.end(), data->begin())) {
+      LOG_INFO("No controller capabilities for this firmware, reading them");
+      return;
+    }
+    std::map<OpCode, std::list<std::vector<uint8_t>>> capabilities;
+    size_t offset = version_information.size();
+    while (offset < data->size()) {
+      if (data->size() - offset < 4) {
+        LOG_WARN("Truncated controller capabilities");
+        return;
+      }
+      OpCode op_code = static_cast<OpCode>((*data)[offset] | (*data)[offset + 1] << 8);
+      size_t size = (*data)[offset + 2] | (*data)[offset + 3] << 8;
+      offset += 4;
+      if (data->size() - offset < size || !is_capability_read(op_code)) {
+        LOG_WARN("Invalid controller capabilities");
+        return;
+      }
+      std::vector<uint8_t> bytes(data->begin() + offset, data->begin() + offset + size);
+      if (!is_valid_capability(op_code, bytes)) {
+        LOG_WARN("Invalid controller capability %s, reading them", OpCodeText(op_code).c_str());
+        return;
+      }
+      capabilities[op_code].push_back(std::move(bytes));
+      offset += size;
+    }
+    LOG_INFO("Replaying the controller capabilities");
+    cached_capabilities_ = std::move(capabilities);
+  }
+
+  void replay_extended_features(std::vector<std::vector<uint8_t>> pages, std::promise<void> promise) {
+    for (auto& page : pages) {
+      read_local_extended_features_page_handler(make_command_complete_view(std::move(page)));
+    }
+    promise.set_value();
+  }
+
+  void wait_for_batch(std::vector<std::future<void>>* batch) {
+    for (auto& future : *batch) {
+      future.wait();
+    }
+    batch->clear();
   }
 
   void Stop() {
@@ -255,6 +485,7 @@ struct Controller::impl {
   }
 
   void read_local_extended_features_complete_handler(std::promise<void> promise, CommandCompleteView view) {
+    record_capability(OpCode::READ_LOCAL_EXTENDED_FEATURES, view);
     auto complete_view = ReadLocalExtendedFeaturesCompleteView::Create(view);
     ASSERT(complete_view.IsValid());
     ErrorCode status = complete_view.GetStatus();
@@ -262,11 +493,16 @@ struct Controller::impl {
     uint8_t page_number = complete_view.GetPageNumber();
     extended_lmp_features_array_.push_back(complete_view.GetExtendedLmpFeatures());
 
-    // Query all extended features
-    if (page_number < complete_view.GetMaximumPageNumber()) {
-      page_number++;
+    // Query all the other extended features at once, the responses to the same command come in order
+    uint8_t maximum_page_number = complete_view.GetMaximumPageNumber();
+    if (page_number == 0 && maximum_page_number > 0) {
+      for (uint8_t page = 1; page < maximum_page_number; page++) {
+        hci_->EnqueueCommand(
+            ReadLocalExtendedFeaturesBuilder::Create(page),
+            module_.GetHandler()->BindOnceOn(this, &Controller::impl::read_local_extended_features_page_handler));
+      }
       hci_->EnqueueCommand(
-          ReadLocalExtendedFeaturesBuilder::Create(page_number),
+          ReadLocalExtendedFeaturesBuilder::Create(maximum_page_number),
           module_.GetHandler()->BindOnceOn(this, &Controller::impl::read_local_extended_features_complete_handler,
                                            std::move(promise)));
     } else {
@@ -274,6 +510,15 @@ struct Controller::impl {
     }
   }
 
+  void read_local_extended_features_page_handler(CommandCompleteView view) {
+    record_capability(OpCode::READ_LOCAL_EXTENDED_FEATURES, view);
+    auto complete_view = ReadLocalExtendedFeaturesCompleteView::Create(view);
+    ASSERT(complete_view.IsValid());
+    ErrorCode status = complete_view.GetStatus();
+    ASSERT_LOG(status == ErrorCode::SUCCESS, "Status 0x%02hhx, %s", status, ErrorCodeText(status).c_str());
+    extended_lmp_features_array_.push_back(complete_view.GetExtendedLmpFeatures());
+  }
+
   void read_buffer_size_complete_handler(CommandCompleteView view) {
     auto complete_view = ReadBufferSizeCompleteView::Create(view);
     ASSERT(complete_view.IsValid());
@@ -286,13 +531,12 @@ struct Controller::impl {
     sco_buffers_ = complete_view.GetTotalNumSynchronousDataPackets();
   }
 
-  void read_controller_mac_address_handler(std::promise<void> promise, CommandCompleteView view) {
+  void read_controller_mac_address_handler(CommandCompleteView view) {
     auto complete_view = ReadBdAddrCompleteView::Create(view);
     ASSERT(complete_view.IsValid());
     ErrorCode status = complete_view.GetStatus();
     ASSERT_LOG(status == ErrorCode::SUCCESS, "Status 0x%02hhx, %s", status, ErrorCodeText(status).c_str());
     mac_address_ = complete_view.GetBdAddr();
-    promise.set_value();
   }
 
   void le_read_buffer_size_handler(CommandCompleteView view) {
@@ -882,6 +1126,10 @@ struct Controller::impl {
   LocalVersionInformation local_version_information_;
   std::array<uint8_t, 64> local_supported_commands_;
   std::vector<uint64_t> extended_lmp_features_array_;
+  // Capability read responses of the snapshot by opcode, in response order, until replayed
+  std::map<OpCode, std::list<std::vector<uint8_t>>> cached_capabilities_;
+  // Capability read responses of this bring-up, for the next snapshot
+  std::vector<std::pair<OpCode, std::vector<uint8_t>>> recorded_capabilities_;
   uint16_t acl_buffer_length_ = 0;
   uint16_t acl_buffers_ = 0;
   uint8_t sco_buffer_length_ = 0;
@@ -1170,10 +1418,11 @@ const ModuleFactory Controller::Factory = ModuleFactory([]() { return new Contro
 
 void Controller::ListDependencies(ModuleList* list) const {
   list->add<hci::HciLayer>();
+  list->add<storage::StorageModule>();
 }
 
 void Controller::Start() {
-  impl_->Start(GetDependency<hci::HciLayer>());
+  impl_->Start(GetDependency<hci::HciLayer>(), GetDependency<storage::StorageModule>());
 }
 
 void Controller::Stop() {
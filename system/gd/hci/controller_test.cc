@@ -18,6 +18,8 @@
 
 #include <algorithm>
 #include <chrono>
+#include <filesystem>
+#include <functional>
 #include <future>
 #include <map>
 
@@ -26,10 +28,12 @@
 #include "common/bind.h"
 #include "common/callback.h"
 #include "common/init_flags.h"
+#include "common/strings.h"
 #include "hci/address.h"
 #include "hci/hci_layer.h"
 #include "os/thread.h"
 #include "packet/raw_builder.h"
+#include "storage/storage_module.h"
 
 namespace bluetooth {
 namespace hci {
@@ -76,6 +80,10 @@ class TestHciLayer : public HciLayer {
     auto packet_view = GetPacketView(std::move(command_builder));
     CommandView command = CommandView::Create(packet_view);
     ASSERT_TRUE(command.IsValid());
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      sent_commands_[command.GetOpCode()]++;
+    }
 
     uint8_t num_packets = 1;
     std::unique_ptr<packet::BasePacketBuilder> event_builder;
@@ -249,6 +257,11 @@ class TestHciLayer : public HciLayer {
     return command;
   }
 
+  int GetSentCount(OpCode op_code) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return sent_commands_[op_code];
+  }
+
   void ListDependencies(ModuleList* list) const {}
   void Start() override {}
   void Stop() override {}
@@ -263,27 +276,101 @@ class TestHciLayer : public HciLayer {
  private:
   common::ContextualCallback<void(EventView)> number_of_completed_packets_callback_;
   std::queue<CommandView> command_queue_;
+  std::map<OpCode, int> sent_commands_;
   mutable std::mutex mutex_;
   std::condition_variable not_empty_;
 };
 
+class TestStorageModule : public storage::StorageModule {
+ public:
+  TestStorageModule(std::string config_file_path)
+      : StorageModule(std::move(config_file_path), std::chrono::milliseconds(100), 10, false, false) {}
+};
+
 class ControllerTest : public ::testing::Test {
  protected:
   void SetUp() override {
     bluetooth::common::InitFlags::SetAllForTesting();
+    temp_dir_ = std::filesystem::temp_directory_path() /
+                ("controller_test_" + std::string(::testing::UnitTest::GetInstance()->current_test_info()->name()));
+    std::filesystem::create_directories(temp_dir_);
+    StartController();
+  }
+
+  void TearDown() override {
+    fake_registry_.StopAll();
+    std::filesystem::remove_all(temp_dir_);
+  }
+
+  void StartController() {
+    InjectModules();
+    fake_registry_.Start<Controller>(&thread_);
+    controller_ = static_cast<Controller*>(fake_registry_.GetModuleUnderTest(&Controller::Factory));
+  }
+
+  void InjectModules() {
     test_hci_layer_ = new TestHciLayer;
     fake_registry_.InjectTestModule(&HciLayer::Factory, test_hci_layer_);
+    storage_ = new TestStorageModule((temp_dir_ / "config.conf").string());
+    fake_registry_.InjectTestModule(&storage::StorageModule::Factory, storage_);
     client_handler_ = fake_registry_.GetTestModuleHandler(&HciLayer::Factory);
+  }
+
+  // Restart the controller once |modify| has been applied to each capability read response of the snapshot saved by
+  // the previous bring-up
+  void RestartWithModifiedSnapshot(std::function<void(OpCode* op_code, std::vector<uint8_t>* response)> modify) {
+    fake_registry_.StopAll();
+    InjectModules();
+
+    storage::AdapterConfig adapter_config = storage_->GetAdapterConfig();
+    auto data = common::FromHexString(adapter_config.GetControllerCapabilities().value_or(""));
+    ASSERT_TRUE(data);
+    // The version of the snapshot and the version information of the controller come first
+    constexpr size_t kVersionInformationSize = 9;
+    ASSERT_GT(data->size(), kVersionInformationSize);
+    std::vector<uint8_t> snapshot(data->begin(), data->begin() + kVersionInformationSize);
+    size_t offset = kVersionInformationSize;
+    while (offset < data->size()) {
+      ASSERT_GE(data->size() - offset, 4u);
+      OpCode op_code = static_cast<OpCode>((*data)[offset] | (*data)[offset + 1] << 8);
+      size_t size = (*data)[offset + 2] | (*data)[offset + 3] << 8;
+      offset += 4;
+      ASSERT_GE(data->size() - offset, size);
+      std::vector<uint8_t> response(data->begin() + offset, data->begin() + offset + size);
+      offset += size;
+
+      modify(&op_code, &response);
+      uint16_t raw_op_code = static_cast<uint16_t>(op_code);
+      snapshot.insert(snapshot.end(), {static_cast<uint8_t>(raw_op_code), static_cast<uint8_t>(raw_op_code >> 8)});
+      snapshot.insert(
+          snapshot.end(), {static_cast<uint8_t>(response.size()), static_cast<uint8_t>(response.size() >> 8)});
+      snapshot.insert(snapshot.end(), response.begin(), response.end());
+    }
+    auto mutation = storage_->Modify();
+    mutation.Add(adapter_config.SetControllerCapabilities(common::ToHexString(snapshot)));
+    mutation.Commit();
+
     fake_registry_.Start<Controller>(&thread_);
     controller_ = static_cast<Controller*>(fake_registry_.GetModuleUnderTest(&Controller::Factory));
   }
 
-  void TearDown() override {
-    fake_registry_.StopAll();
+  // The snapshot was discarded, all the capabilities were read again
+  void ExpectCapabilitiesRead() {
+    EXPECT_EQ(test_hci_layer_->GetSentCount(OpCode::READ_LOCAL_SUPPORTED_COMMANDS), 1);
+    EXPECT_GT(test_hci_layer_->GetSentCount(OpCode::READ_LOCAL_EXTENDED_FEATURES), 0);
+    EXPECT_EQ(test_hci_layer_->GetSentCount(OpCode::READ_BUFFER_SIZE), 1);
+    EXPECT_EQ(test_hci_layer_->GetSentCount(OpCode::LE_READ_LOCAL_SUPPORTED_FEATURES), 1);
+    EXPECT_EQ(test_hci_layer_->GetSentCount(OpCode::LE_READ_SUPPORTED_STATES), 1);
+    EXPECT_EQ(test_hci_layer_->GetSentCount(OpCode::LE_GET_VENDOR_CAPABILITIES), 1);
+
+    EXPECT_EQ(controller_->GetAclPacketLength(), test_hci_layer_->acl_data_packet_length);
+    EXPECT_EQ(controller_->GetLeSupportedStates(), 0x001f123456789abe);
   }
 
+  std::filesystem::path temp_dir_;
   TestModuleRegistry fake_registry_;
   TestHciLayer* test_hci_layer_ = nullptr;
+  TestStorageModule* storage_ = nullptr;
   os::Thread& thread_ = fake_registry_.GetTestThread();
   Controller* controller_ = nullptr;
   os::Handler* client_handler_ = nullptr;
@@ -314,6 +401,83 @@ TEST_F(ControllerTest, read_controller_info) {
   ASSERT_EQ(controller_->GetLeNumberOfSupportedAdverisingSets(), 0xF0);
 }
 
+TEST_F(ControllerTest, capabilities_replayed_on_restart) {
+  ASSERT_EQ(test_hci_layer_->GetSentCount(OpCode::LE_READ_SUPPORTED_STATES), 1);
+  auto acl_packet_length = controller_->GetAclPacketLength();
+  auto le_supported_states = controller_->GetLeSupportedStates();
+  auto local_features = controller_->GetLocalFeatures(1);
+  auto vendor_capabilities = controller_->GetVendorCapabilities();
+
+  // The storage module saves the snapshot when stopped
+  fake_registry_.StopAll();
+  StartController();
+
+  // The firmware is the same, only its version and the identity of the controller are read again
+  EXPECT_EQ(test_hci_layer_->GetSentCount(OpCode::READ_LOCAL_VERSION_INFORMATION), 1);
+  EXPECT_EQ(test_hci_layer_->GetSentCount(OpCode::READ_LOCAL_NAME), 1);
+  EXPECT_EQ(test_hci_layer_->GetSentCount(OpCode::READ_BD_ADDR), 1);
+  EXPECT_EQ(test_hci_layer_->GetSentCount(OpCode::LE_SET_EVENT_MASK), 1);
+  EXPECT_EQ(test_hci_layer_->GetSentCount(OpCode::READ_LOCAL_SUPPORTED_COMMANDS), 0);
+  EXPECT_EQ(test_hci_layer_->GetSentCount(OpCode::READ_LOCAL_EXTENDED_FEATURES), 0);
+  EXPECT_EQ(test_hci_layer_->GetSentCount(OpCode::READ_BUFFER_SIZE), 0);
+  EXPECT_EQ(test_hci_layer_->GetSentCount(OpCode::LE_READ_SUPPORTED_STATES), 0);
+  EXPECT_EQ(test_hci_layer_->GetSentCount(OpCode::LE_GET_VENDOR_CAPABILITIES), 0);
+
+  EXPECT_EQ(controller_->GetAclPacketLength(), acl_packet_length);
+  EXPECT_EQ(controller_->GetLeSupportedStates(), le_supported_states);
+  EXPECT_EQ(controller_->GetLocalFeatures(1), local_features);
+  EXPECT_EQ(controller_->GetVendorCapabilities().max_advt_instances_, vendor_capabilities.max_advt_instances_);
+  EXPECT_EQ(controller_->GetLocalVersionInformation().lmp_subversion_, 0x5678);
+}
+
+// The offset of the status in a command complete event: event code, parameter length, number of packets and opcode
+constexpr size_t kCommandCompleteStatusOffset = 5;
+
+TEST_F(ControllerTest, capabilities_read_again_when_snapshot_has_failed_response) {
+  RestartWithModifiedSnapshot([](OpCode* op_code, std::vector<uint8_t>* response) {
+    if (*op_code == OpCode::LE_READ_SUPPORTED_STATES) {
+      (*response)[kCommandCompleteStatusOffset] = static_cast<uint8_t>(ErrorCode::UNKNOWN_HCI_COMMAND);
+    }
+  });
+  ExpectCapabilitiesRead();
+}
+
+TEST_F(ControllerTest, capabilities_read_again_when_snapshot_has_response_of_other_command) {
+  RestartWithModifiedSnapshot([](OpCode* op_code, std::vector<uint8_t>* response) {
+    if (*op_code == OpCode::LE_READ_SUPPORTED_STATES) {
+      *op_code = OpCode::LE_READ_LOCAL_SUPPORTED_FEATURES;
+    }
+  });
+  ExpectCapabilitiesRead();
+}
+
+TEST_F(ControllerTest, capabilities_read_again_when_snapshot_has_truncated_response) {
+  RestartWithModifiedSnapshot([](OpCode* op_code, std::vector<uint8_t>* response) {
+    if (*op_code == OpCode::READ_BUFFER_SIZE) {
+      // Still a valid event, too short for its return parameters
+      response->pop_back();
+      (*response)[1]--;
+    }
+  });
+  ExpectCapabilitiesRead();
+}
+
+TEST_F(ControllerTest, capabilities_replayed_after_discarded_snapshot) {
+  RestartWithModifiedSnapshot([](OpCode* op_code, std::vector<uint8_t>* response) {
+    if (*op_code == OpCode::READ_BUFFER_SIZE) {
+      (*response)[kCommandCompleteStatusOffset] = static_cast<uint8_t>(ErrorCode::HARDWARE_FAILURE);
+    }
+  });
+  ExpectCapabilitiesRead();
+
+  // The snapshot of the capabilities read again replaced the invalid one
+  fake_registry_.StopAll();
+  StartController();
+  EXPECT_EQ(test_hci_layer_->GetSentCount(OpCode::READ_BUFFER_SIZE), 0);
+  EXPECT_EQ(test_hci_layer_->GetSentCount(OpCode::LE_READ_SUPPORTED_STATES), 0);
+  EXPECT_EQ(controller_->GetAclPacketLength(), test_hci_layer_->acl_data_packet_length);
+}
+
 TEST_F(ControllerTest, read_write_local_name) {
   ASSERT_EQ(controller_->GetLocalName(), "DUT");
   controller_->WriteLocalName("New name");
@@ -16,14 +16,23 @@
 
 #include "hci/hci_layer.h"
 
+#include <algorithm>
+#include <chrono>
+
 #include "common/bind.h"
 #include "common/init_flags.h"
 #include "common/stop_watch.h"
-#include "hci/hci_metrics_logging.h"
+#include "common/strings.h"
+#include "hci/acl_latency_tracker.h"
+#include "hci/hci_metrics_logger.h"
 #include "os/alarm.h"
 #include "os/metrics.h"
 #include "os/queue.h"
+#include "os/system_properties.h"
+#include "os/trace.h"
+#include "packet/packet_buffer_pool.h"
 #include "packet/packet_builder.h"
+#include "packet/scatter_gather_inserter.h"
 #include "storage/storage_module.h"
 
 namespace bluetooth {
@@ -58,6 +67,13 @@ static void abort_after_time_out(OpCode op_code) {
   ASSERT_LOG(false, "Done waiting for debug information after HCI timeout (%s)", OpCodeText(op_code).c_str());
 }
 
+// Commands that may be sent while others are in flight. The other commands, whose effect on the controller state is
+// not known or global, are only sent alone
+static bool is_pipelinable(OpCode op_code) {
+  bool is_vendor_specific = static_cast<int>(op_code) & (0x3f << 10);
+  return !is_vendor_specific && op_code != OpCode::RESET && op_code != OpCode::CONTROLLER_DEBUG_INFO;
+}
+
 class CommandQueueEntry {
  public:
   CommandQueueEntry(
@@ -71,6 +87,12 @@ class CommandQueueEntry {
   unique_ptr<CommandBuilder> command;
   unique_ptr<CommandView> command_view;
 
+  // Set once sent
+  OpCode op_code{OpCode::NONE};
+  std::chrono::steady_clock::time_point sent_time;
+  // When the round trip is traced
+  uint64_t trace_begin_ns{0};
+
   bool waiting_for_status_;
   ContextualOnceCallback<void(CommandStatusView)> on_status;
   ContextualOnceCallback<void(CommandCompleteView)> on_complete;
@@ -98,6 +120,7 @@ struct HciLayer::impl {
 
   ~impl() {
     incoming_acl_buffer_.Clear();
+    module_.acl_latency_tracker_->Flush();
     incoming_sco_buffer_.Clear();
     incoming_iso_buffer_.Clear();
     if (hci_timeout_alarm_ != nullptr) {
@@ -107,6 +130,7 @@ struct HciLayer::impl {
       delete hci_abort_alarm_;
     }
     command_queue_.clear();
+    sent_commands_.clear();
   }
 
   void drop(EventView event) {
@@ -115,15 +139,29 @@ struct HciLayer::impl {
 
   void on_outbound_acl_ready() {
     auto packet = acl_queue_.GetDownEnd()->TryDequeue();
-    std::vector<uint8_t> bytes;
-    BitInserter bi(bytes);
-    packet->Serialize(bi);
-    hal_->sendAclData(bytes);
+    packet::ScatterGatherList fragments;
+    packet::ScatterGatherInserter inserter(fragments);
+    packet->Serialize(inserter);
+    hal_->sendAclDataFragments(fragments);
+  }
+
+  void send_acl_burst(std::vector<std::unique_ptr<AclBuilder>> fragments) {
+    std::vector<hal::HciPacket> packets;
+    packets.reserve(fragments.size());
+    for (auto& fragment : fragments) {
+      std::vector<uint8_t> bytes;
+      bytes.reserve(fragment->size());
+      BitInserter bi(bytes);
+      fragment->Serialize(bi);
+      packets.push_back(std::move(bytes));
+    }
+    hal_->sendAclDataBatch(std::move(packets));
   }
 
   void on_outbound_sco_ready() {
     auto packet = sco_queue_.GetDownEnd()->TryDequeue();
     std::vector<uint8_t> bytes;
+    bytes.reserve(packet->size());
     BitInserter bi(bytes);
     packet->Serialize(bi);
     hal_->sendScoData(bytes);
@@ -132,6 +170,7 @@ struct HciLayer::impl {
   void on_outbound_iso_ready() {
     auto packet = iso_queue_.GetDownEnd()->TryDequeue();
     std::vector<uint8_t> bytes;
+    bytes.reserve(packet->size());
     BitInserter bi(bytes);
     packet->Serialize(bi);
     hal_->sendIsoData(bytes);
@@ -143,6 +182,17 @@ struct HciLayer::impl {
     send_next_command();
   }
 
+  void enqueue_command_batch(std::vector<BatchedCommand> commands) {
+    for (auto& batched : commands) {
+      std::visit(
+          [this, &batched](auto& on_response) {
+            command_queue_.emplace_back(move(batched.command), move(on_response));
+          },
+          batched.on_response);
+    }
+    send_next_command();
+  }
+
   void on_command_status(EventView event) {
     CommandStatusView response_view = CommandStatusView::Create(event);
     ASSERT(response_view.IsValid());
@@ -174,18 +224,21 @@ struct HciLayer::impl {
     }
     bool is_status = logging_id == "status";
 
-    ASSERT_LOG(!command_queue_.empty(), "Unexpected %s event with OpCode 0x%02hx (%s)", logging_id.c_str(), op_code,
+    ASSERT_LOG(!sent_commands_.empty(), "Unexpected %s event with OpCode 0x%02hx (%s)", logging_id.c_str(), op_code,
                OpCodeText(op_code).c_str());
-    if (waiting_command_ == OpCode::CONTROLLER_DEBUG_INFO && op_code != OpCode::CONTROLLER_DEBUG_INFO) {
+    OpCode oldest_op_code = sent_commands_.front().op_code;
+    if (oldest_op_code == OpCode::CONTROLLER_DEBUG_INFO && op_code != OpCode::CONTROLLER_DEBUG_INFO) {
       LOG_ERROR("Discarding event that came after timeout 0x%02hx (%s)", op_code, OpCodeText(op_code).c_str());
       return;
     }
-    ASSERT_LOG(waiting_command_ == op_code, "Waiting for 0x%02hx (%s), got 0x%02hx (%s)", waiting_command_,
-               OpCodeText(waiting_command_).c_str(), op_code, OpCodeText(op_code).c_str());
+    // The responses to the commands of the same opcode come in order
+    auto command = find_sent_command(op_code);
+    ASSERT_LOG(command != sent_commands_.end(), "Waiting for 0x%02hx (%s), got 0x%02hx (%s)", oldest_op_code,
+               OpCodeText(oldest_op_code).c_str(), op_code, OpCodeText(op_code).c_str());
 
     bool is_vendor_specific = static_cast<int>(op_code) & (0x3f << 10);
     CommandStatusView status_view = CommandStatusView::Create(event);
-    if (is_vendor_specific && (is_status && !command_queue_.front().waiting_for_status_) &&
+    if (is_vendor_specific && (is_status && !command->waiting_for_status_) &&
         (status_view.IsValid() && status_view.GetStatus() == ErrorCode::UNKNOWN_HCI_COMMAND)) {
       // If this is a command status of a vendor specific command, and command complete is expected, we can't treat
       // this as hard failure since we have no way of probing this lack of support at earlier time. Instead we let
@@ -193,35 +246,59 @@ struct HciLayer::impl {
       // response.
       CommandCompleteView command_complete_view = CommandCompleteView::Create(
           EventView::Create(PacketView<kLittleEndian>(std::make_shared<std::vector<uint8_t>>(std::vector<uint8_t>()))));
-      command_queue_.front().GetCallback<CommandCompleteView>()->Invoke(move(command_complete_view));
+      command->GetCallback<CommandCompleteView>()->Invoke(move(command_complete_view));
     } else {
-      if (command_queue_.front().waiting_for_status_ == is_status) {
-        command_queue_.front().GetCallback<TResponse>()->Invoke(move(response_view));
+      if (command->waiting_for_status_ == is_status) {
+        command->GetCallback<TResponse>()->Invoke(move(response_view));
       } else {
         CommandCompleteView command_complete_view = CommandCompleteView::Create(
             EventView::Create(PacketView<kLittleEndian>(std::make_shared<std::vector<uint8_t>>(std::vector<uint8_t>()))));
-        command_queue_.front().GetCallback<CommandCompleteView>()->Invoke(move(command_complete_view));
+        command->GetCallback<CommandCompleteView>()->Invoke(move(command_complete_view));
       }
     }
 
-    command_queue_.pop_front();
-    waiting_command_ = OpCode::NONE;
+    if (command->trace_begin_ns != 0) {
+      os::Trace::RecordAsync(
+          "HciLayer::Command", command->trace_begin_ns, os::Trace::Now(), static_cast<int64_t>(op_code));
+    }
+
+    sent_commands_.erase(command);
     if (hci_timeout_alarm_ != nullptr) {
-      hci_timeout_alarm_->Cancel();
+      schedule_hci_timeout();
       send_next_command();
     }
   }
 
+  std::list<CommandQueueEntry>::iterator find_sent_command(OpCode op_code) {
+    return std::find_if(sent_commands_.begin(), sent_commands_.end(), [op_code](const CommandQueueEntry& entry) {
+      return entry.op_code == op_code;
+    });
+  }
+
+  // Time out on the oldest command in flight
+  void schedule_hci_timeout() {
+    if (sent_commands_.empty()) {
+      hci_timeout_alarm_->Cancel();
+      return;
+    }
+    const CommandQueueEntry& oldest = sent_commands_.front();
+    auto elapsed =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - oldest.sent_time);
+    // A zero delay would disarm the alarm
+    auto delay = std::max(kHciTimeoutMs - elapsed, std::chrono::milliseconds(1));
+    hci_timeout_alarm_->Schedule(BindOnce(&impl::on_hci_timeout, common::Unretained(this), oldest.op_code), delay);
+  }
+
   void on_hci_timeout(OpCode op_code) {
     common::StopWatch::DumpStopWatchLog();
     LOG_ERROR("Timed out waiting for 0x%02hx (%s)", op_code, OpCodeText(op_code).c_str());
     // TODO: LogMetricHciTimeoutEvent(static_cast<uint32_t>(op_code));
 
-    LOG_ERROR("Flushing %zd waiting commands", command_queue_.size());
+    LOG_ERROR("Flushing %zd waiting commands", command_queue_.size() + sent_commands_.size());
     // Clear any waiting commands (there is an abort coming anyway)
     command_queue_.clear();
+    sent_commands_.clear();
     command_credits_ = 1;
-    waiting_command_ = OpCode::NONE;
     enqueue_command(
         ControllerDebugInfoBuilder::Create(), module_.GetHandler()->BindOnce(&fail_if_reset_complete_not_success));
     // Don't time out for this one;
@@ -239,32 +316,37 @@ struct HciLayer::impl {
   }
 
   void send_next_command() {
-    if (command_credits_ == 0) {
-      return;
-    }
-    if (waiting_command_ != OpCode::NONE) {
-      return;
-    }
-    if (command_queue_.size() == 0) {
-      return;
-    }
-    std::shared_ptr<std::vector<uint8_t>> bytes = std::make_shared<std::vector<uint8_t>>();
-    BitInserter bi(*bytes);
-    command_queue_.front().command->Serialize(bi);
-    hal_->sendHciCommand(*bytes);
-
-    auto cmd_view = CommandView::Create(PacketView<kLittleEndian>(bytes));
-    ASSERT(cmd_view.IsValid());
-    OpCode op_code = cmd_view.GetOpCode();
-    command_queue_.front().command_view = std::make_unique<CommandView>(std::move(cmd_view));
-    log_link_layer_connection_command(command_queue_.front().command_view);
-    log_classic_pairing_command_status(command_queue_.front().command_view, ErrorCode::STATUS_UNKNOWN);
-    waiting_command_ = op_code;
-    command_credits_ = 0;  // Only allow one outstanding command
-    if (hci_timeout_alarm_ != nullptr) {
-      hci_timeout_alarm_->Schedule(BindOnce(&impl::on_hci_timeout, common::Unretained(this), op_code), kHciTimeoutMs);
-    } else {
-      LOG_WARN("%s sent without an hci-timeout timer", OpCodeText(op_code).c_str());
+    while (command_credits_ > 0 && !command_queue_.empty()) {
+      if (!sent_commands_.empty() && (!pipelined_ || !is_pipelinable(sent_commands_.back().op_code))) {
+        return;
+      }
+      auto bytes = packet::PacketBufferPool::Get().Acquire(command_queue_.front().command->size());
+      BitInserter bi(*bytes);
+      command_queue_.front().command->Serialize(bi);
+      auto cmd_view = CommandView::Create(PacketView<kLittleEndian>(bytes));
+      ASSERT(cmd_view.IsValid());
+      OpCode op_code = cmd_view.GetOpCode();
+      if (!sent_commands_.empty() && !is_pipelinable(op_code)) {
+        return;
+      }
+      hal_->sendHciCommand(*bytes);
+
+      sent_commands_.splice(sent_commands_.end(), command_queue_, command_queue_.begin());
+      CommandQueueEntry& command = sent_commands_.back();
+      command.op_code = op_code;
+      command.sent_time = std::chrono::steady_clock::now();
+      command.trace_begin_ns = os::Trace::IsEnabled() && os::Trace::Sample() ? os::Trace::Now() : 0;
+      command.command_view = std::make_unique<CommandView>(std::move(cmd_view));
+      metrics_logger_->OnCommandSent(command.command_view);
+      // Only allow one outstanding command unless pipelined
+      command_credits_ = pipelined_ ? command_credits_ - 1 : 0;
+      if (hci_timeout_alarm_ != nullptr) {
+        if (sent_commands_.size() == 1) {
+          schedule_hci_timeout();
+        }
+      } else {
+        LOG_WARN("%s sent without an hci-timeout timer", OpCodeText(op_code).c_str());
+      }
     }
   }
 
@@ -330,7 +412,7 @@ struct HciLayer::impl {
 
   void on_hci_event(EventView event) {
     ASSERT(event.IsValid());
-    if (command_queue_.empty()) {
+    if (sent_commands_.empty()) {
       auto event_code = event.GetEventCode();
       // BT Core spec 5.2 (Volume 4, Part E section 4.4) allows anytime
       // COMMAND_COMPLETE and COMMAND_STATUS with opcode 0x0 for flow control
@@ -353,9 +435,9 @@ struct HciLayer::impl {
             EventCodeText(event_code).c_str(), op_code, OpCodeText(op_code).c_str());
       }
       std::unique_ptr<CommandView> no_waiting_command{nullptr};
-      log_hci_event(no_waiting_command, event, module_.GetDependency<storage::StorageModule>());
+      metrics_logger_->OnEvent(no_waiting_command, event);
     } else {
-      log_hci_event(command_queue_.front().command_view, event, module_.GetDependency<storage::StorageModule>());
+      metrics_logger_->OnEvent(get_command_view(event), event);
     }
     EventCode event_code = event.GetEventCode();
     // Root Inflamation is a special case, since it aborts here
@@ -378,6 +460,20 @@ struct HciLayer::impl {
     event_handlers_[event_code].Invoke(event);
   }
 
+  // The command an event is about, the oldest one in flight unless the event tells
+  std::unique_ptr<CommandView>& get_command_view(EventView event) {
+    OpCode op_code = OpCode::NONE;
+    if (event.GetEventCode() == EventCode::COMMAND_COMPLETE) {
+      auto view = CommandCompleteView::Create(event);
+      op_code = view.IsValid() ? view.GetCommandOpCode() : OpCode::NONE;
+    } else if (event.GetEventCode() == EventCode::COMMAND_STATUS) {
+      auto view = CommandStatusView::Create(event);
+      op_code = view.IsValid() ? view.GetCommandOpCode() : OpCode::NONE;
+    }
+    auto command = find_sent_command(op_code);
+    return command != sent_commands_.end() ? command->command_view : sent_commands_.front().command_view;
+  }
+
   void on_le_meta_event(EventView event) {
     LeMetaEventView meta_event_view = LeMetaEventView::Create(event);
     ASSERT(meta_event_view.IsValid());
@@ -394,10 +490,14 @@ struct HciLayer::impl {
 
   // Command Handling
   std::list<CommandQueueEntry> command_queue_;
+  // Oldest first
+  std::list<CommandQueueEntry> sent_commands_;
+  // Whether independent commands are sent while others are in flight, up to the credits of the controller
+  bool pipelined_{false};
+  std::unique_ptr<HciMetricsLogger> metrics_logger_;
 
   std::map<EventCode, ContextualCallback<void(EventView)>> event_handlers_;
   std::map<SubeventCode, ContextualCallback<void(LeMetaEventView)>> subevent_handlers_;
-  OpCode waiting_command_{OpCode::NONE};
   uint8_t command_credits_{1};  // Send reset first
   Alarm* hci_timeout_alarm_{nullptr};
   Alarm* hci_abort_alarm_{nullptr};
@@ -420,25 +520,42 @@ struct HciLayer::hal_callbacks : public hal::HciHalCallbacks {
   hal_callbacks(HciLayer& module) : module_(module) {}
 
   void hciEventReceived(hal::HciPacket event_bytes) override {
-    auto packet = packet::PacketView<packet::kLittleEndian>(std::make_shared<std::vector<uint8_t>>(event_bytes));
+    hciEventBufferReceived(std::make_shared<std::vector<uint8_t>>(move(event_bytes)));
+  }
+
+  void aclDataReceived(hal::HciPacket data_bytes) override {
+    aclDataBufferReceived(std::make_shared<std::vector<uint8_t>>(move(data_bytes)));
+  }
+
+  void scoDataReceived(hal::HciPacket data_bytes) override {
+    scoDataBufferReceived(std::make_shared<std::vector<uint8_t>>(move(data_bytes)));
+  }
+
+  void isoDataReceived(hal::HciPacket data_bytes) override {
+    isoDataBufferReceived(std::make_shared<std::vector<uint8_t>>(move(data_bytes)));
+  }
+
+  void hciEventBufferReceived(std::shared_ptr<hal::HciPacket> event_bytes) override {
+    auto packet = packet::PacketView<packet::kLittleEndian>(move(event_bytes));
     EventView event = EventView::Create(packet);
     module_.CallOn(module_.impl_, &impl::on_hci_event, move(event));
   }
 
-  void aclDataReceived(hal::HciPacket data_bytes) override {
-    auto packet = packet::PacketView<packet::kLittleEndian>(std::make_shared<std::vector<uint8_t>>(move(data_bytes)));
+  void aclDataBufferReceived(std::shared_ptr<hal::HciPacket> data_bytes) override {
+    module_.acl_latency_tracker_->OnHalReceive(data_bytes->data(), data_bytes->size());
+    auto packet = packet::PacketView<packet::kLittleEndian>(move(data_bytes));
     auto acl = std::make_unique<AclView>(AclView::Create(packet));
     module_.impl_->incoming_acl_buffer_.Enqueue(move(acl), module_.GetHandler());
   }
 
-  void scoDataReceived(hal::HciPacket data_bytes) override {
-    auto packet = packet::PacketView<packet::kLittleEndian>(std::make_shared<std::vector<uint8_t>>(move(data_bytes)));
+  void scoDataBufferReceived(std::shared_ptr<hal::HciPacket> data_bytes) override {
+    auto packet = packet::PacketView<packet::kLittleEndian>(move(data_bytes));
     auto sco = std::make_unique<ScoView>(ScoView::Create(packet));
     module_.impl_->incoming_sco_buffer_.Enqueue(move(sco), module_.GetHandler());
   }
 
-  void isoDataReceived(hal::HciPacket data_bytes) override {
-    auto packet = packet::PacketView<packet::kLittleEndian>(std::make_shared<std::vector<uint8_t>>(move(data_bytes)));
+  void isoDataBufferReceived(std::shared_ptr<hal::HciPacket> data_bytes) override {
+    auto packet = packet::PacketView<packet::kLittleEndian>(move(data_bytes));
     auto iso = std::make_unique<IsoView>(IsoView::Create(packet));
     module_.impl_->incoming_iso_buffer_.Enqueue(move(iso), module_.GetHandler());
   }
@@ -446,7 +563,12 @@ struct HciLayer::hal_callbacks : public hal::HciHalCallbacks {
   HciLayer& module_;
 };
 
-HciLayer::HciLayer() : impl_(nullptr), hal_callbacks_(nullptr) {}
+const std::string HciLayer::kAclLatencyTrackingProperty = "persist.bluetooth.acllatencytracking";
+const std::string HciLayer::kPipelinedCommandsProperty = "persist.bluetooth.hci.pipelined_commands";
+const std::string HciLayer::kDeferredMetricsProperty = "persist.bluetooth.hci.deferred_metrics";
+
+HciLayer::HciLayer()
+    : impl_(nullptr), hal_callbacks_(nullptr), acl_latency_tracker_(std::make_unique<AclLatencyTracker>()) {}
 
 HciLayer::~HciLayer() {
 }
@@ -455,6 +577,14 @@ common::BidiQueueEnd<AclBuilder, AclView>* HciLayer::GetAclQueueEnd() {
   return impl_->acl_queue_.GetUpEnd();
 }
 
+void HciLayer::SendAclBurst(std::vector<std::unique_ptr<AclBuilder>> fragments) {
+  CallOn(impl_, &impl::send_acl_burst, std::move(fragments));
+}
+
+AclLatencyTracker* HciLayer::GetAclLatencyTracker() {
+  return acl_latency_tracker_.get();
+}
+
 common::BidiQueueEnd<ScoBuilder, ScoView>* HciLayer::GetScoQueueEnd() {
   return impl_->sco_queue_.GetUpEnd();
 }
@@ -473,6 +603,10 @@ void HciLayer::EnqueueCommand(
   CallOn(impl_, &impl::enqueue_command<CommandStatusView>, move(command), move(on_status));
 }
 
+void HciLayer::EnqueueCommandBatch(std::vector<BatchedCommand> commands) {
+  CallOn(impl_, &impl::enqueue_command_batch, move(commands));
+}
+
 void HciLayer::RegisterEventHandler(EventCode event, ContextualCallback<void(EventView)> handler) {
   CallOn(impl_, &impl::register_event, event, handler);
 }
@@ -506,6 +640,7 @@ void HciLayer::on_disconnection_complete(EventView event_view) {
 }
 
 void HciLayer::Disconnect(uint16_t handle, ErrorCode reason) {
+  acl_latency_tracker_->OnDisconnect(handle);
   std::unique_lock<std::mutex> lock(callback_handlers_guard_);
   for (auto callback : disconnect_handlers_) {
     callback.Invoke(handle, reason);
@@ -634,6 +769,17 @@ void HciLayer::Start() {
   impl_ = new impl(hal, *this);
   hal_callbacks_ = new hal_callbacks(*this);
 
+  auto latency_tracking_prop = os::GetSystemProperty(kAclLatencyTrackingProperty);
+  acl_latency_tracker_->SetEnabled(
+      latency_tracking_prop.has_value() && common::StringTrim(latency_tracking_prop.value()) == "true");
+  auto pipelined_commands_prop = os::GetSystemProperty(kPipelinedCommandsProperty);
+  impl_->pipelined_ =
+      pipelined_commands_prop.has_value() && common::StringTrim(pipelined_commands_prop.value()) == "true";
+  auto deferred_metrics_prop = os::GetSystemProperty(kDeferredMetricsProperty);
+  impl_->metrics_logger_ = std::make_unique<HciMetricsLogger>(
+      deferred_metrics_prop.has_value() && common::StringTrim(deferred_metrics_prop.value()) == "true",
+      GetDependency<storage::StorageModule>());
+
   Handler* handler = GetHandler();
   impl_->acl_queue_.GetDownEnd()->RegisterDequeue(handler, BindOn(impl_, &impl::on_outbound_acl_ready));
   impl_->sco_queue_.GetDownEnd()->RegisterDequeue(handler, BindOn(impl_, &impl::on_outbound_sco_ready));
@@ -662,6 +808,7 @@ void HciLayer::Stop() {
   impl_->sco_queue_.GetDownEnd()->UnregisterDequeue();
   impl_->iso_queue_.GetDownEnd()->UnregisterDequeue();
   delete impl_;
+  acl_latency_tracker_->SetEnabled(false);
 }
 
 }  // namespace hci
@@ -18,6 +18,9 @@
 
 #include <chrono>
 #include <map>
+#include <memory>
+#include <variant>
+#include <vector>
 
 #include "address.h"
 #include "class_of_device.h"
@@ -39,6 +42,8 @@
 namespace bluetooth {
 namespace hci {
 
+class AclLatencyTracker;
+
 class HciLayer : public Module, public CommandInterface<CommandBuilder> {
   // LINT.IfChange
  public:
@@ -56,8 +61,27 @@ class HciLayer : public Module, public CommandInterface<CommandBuilder> {
       std::unique_ptr<CommandBuilder> command,
       common::ContextualOnceCallback<void(CommandStatusView)> on_status) override;
 
+  // A command with the callback for the command complete or the command status it expects
+  struct BatchedCommand {
+    std::unique_ptr<CommandBuilder> command;
+    std::variant<
+        common::ContextualOnceCallback<void(CommandCompleteView)>,
+        common::ContextualOnceCallback<void(CommandStatusView)>>
+        on_response;
+  };
+
+  // Enqueue |commands| in order, in a single hop to the HCI thread
+  virtual void EnqueueCommandBatch(std::vector<BatchedCommand> commands);
+
   virtual common::BidiQueueEnd<AclBuilder, AclView>* GetAclQueueEnd();
 
+  // Send ACL fragments to the HAL in one batch, bypassing the ACL queue. Callers must not mix this with the queue
+  // end, as the two paths are not ordered with respect to each other.
+  virtual void SendAclBurst(std::vector<std::unique_ptr<AclBuilder>> fragments);
+
+  // Incoming ACL latency instrumentation, only collecting samples when kAclLatencyTrackingProperty is set
+  AclLatencyTracker* GetAclLatencyTracker();
+
   virtual common::BidiQueueEnd<ScoBuilder, ScoView>* GetScoQueueEnd();
 
   virtual common::BidiQueueEnd<IsoBuilder, IsoView>* GetIsoQueueEnd();
@@ -118,6 +142,12 @@ class HciLayer : public Module, public CommandInterface<CommandBuilder> {
       hci::ErrorCode hci_status, uint16_t handle, uint8_t version, uint16_t manufacturer_name, uint16_t sub_version);
   virtual void RegisterLeMetaEventHandler(common::ContextualCallback<void(EventView)> event_handler);
 
+  static const std::string kAclLatencyTrackingProperty;
+  // Keep several independent commands in flight, up to the Num_HCI_Command_Packets of the controller
+  static const std::string kPipelinedCommandsProperty;
+  // Log the HCI metrics from a normal priority thread rather than from the HCI thread, see HciMetricsLogger
+  static const std::string kDeferredMetricsProperty;
+
   std::list<common::ContextualCallback<void(uint16_t, ErrorCode)>> disconnect_handlers_;
   std::list<common::ContextualCallback<void(hci::ErrorCode, uint16_t, uint8_t, uint16_t, uint16_t)>>
       read_remote_version_handlers_;
@@ -127,6 +157,7 @@ class HciLayer : public Module, public CommandInterface<CommandBuilder> {
   struct hal_callbacks;
   impl* impl_;
   hal_callbacks* hal_callbacks_;
+  std::unique_ptr<AclLatencyTracker> acl_latency_tracker_;
 
   template <typename T>
   class CommandInterfaceImpl : public CommandInterface<T> {
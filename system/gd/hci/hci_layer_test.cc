@@ -24,6 +24,7 @@
 #include "hci/hci_packets.h"
 #include "module.h"
 #include "os/log.h"
+#include "os/system_properties.h"
 #include "os/thread.h"
 #include "packet/bit_inserter.h"
 #include "packet/raw_builder.h"
@@ -621,6 +622,95 @@ TEST_F(HciTest, creditsTest) {
       ReadLocalSupportedFeaturesCompleteView::Create(CommandCompleteView::Create(EventView::Create(event))).IsValid());
 }
 
+class HciPipelinedTest : public HciTest {
+ public:
+  void SetUp() override {
+    os::SetSystemProperty(HciLayerForTest::kPipelinedCommandsProperty, "true");
+    HciTest::SetUp();
+  }
+
+  void TearDown() override {
+    HciTest::TearDown();
+    os::ClearSystemPropertiesForHost();
+  }
+
+  class HciLayerForTest : public HciLayer {
+   public:
+    using HciLayer::kPipelinedCommandsProperty;
+  };
+
+  void Synchronize() {
+    ASSERT_TRUE(fake_registry_.SynchronizeModuleHandler(&HciLayer::Factory, kTimeout));
+    ASSERT_TRUE(fake_registry_.SynchronizeModuleHandler(&DependsOnHci::Factory, kTimeout));
+  }
+};
+
+TEST_F(HciPipelinedTest, commandsInFlightUpToCredits) {
+  uint8_t num_packets = 2;
+  hal->callbacks->hciEventReceived(GetPacketBytes(NoCommandCompleteBuilder::Create(num_packets)));
+  Synchronize();
+
+  upper->SendHciCommandExpectingComplete(ReadLocalVersionInformationBuilder::Create());
+  upper->SendHciCommandExpectingComplete(ReadLocalSupportedCommandsBuilder::Create());
+  upper->SendHciCommandExpectingComplete(ReadLocalSupportedFeaturesBuilder::Create());
+  Synchronize();
+
+  // Two commands are in flight
+  ASSERT_EQ(2, hal->GetNumSentCommands());
+  ASSERT_TRUE(ReadLocalVersionInformationView::Create(hal->GetSentCommand()).IsValid());
+  ASSERT_TRUE(ReadLocalSupportedCommandsView::Create(hal->GetSentCommand()).IsValid());
+
+  // The second one completes first, the third one is sent with the new credit
+  num_packets = 1;
+  ErrorCode error_code = ErrorCode::SUCCESS;
+  std::array<uint8_t, 64> supported_commands = {};
+  hal->callbacks->hciEventReceived(
+      GetPacketBytes(ReadLocalSupportedCommandsCompleteBuilder::Create(num_packets, error_code, supported_commands)));
+  Synchronize();
+  auto event = upper->GetReceivedEvent();
+  ASSERT_TRUE(
+      ReadLocalSupportedCommandsCompleteView::Create(CommandCompleteView::Create(EventView::Create(event))).IsValid());
+  ASSERT_EQ(1, hal->GetNumSentCommands());
+  ASSERT_TRUE(ReadLocalSupportedFeaturesView::Create(hal->GetSentCommand()).IsValid());
+
+  hal->callbacks->hciEventReceived(
+      GetPacketBytes(ReadLocalSupportedFeaturesCompleteBuilder::Create(num_packets, error_code, 0x012345678abcdef)));
+  LocalVersionInformation local_version_information;
+  hal->callbacks->hciEventReceived(GetPacketBytes(
+      ReadLocalVersionInformationCompleteBuilder::Create(num_packets, error_code, local_version_information)));
+  Synchronize();
+  event = upper->GetReceivedEvent();
+  ASSERT_TRUE(
+      ReadLocalSupportedFeaturesCompleteView::Create(CommandCompleteView::Create(EventView::Create(event))).IsValid());
+  event = upper->GetReceivedEvent();
+  ASSERT_TRUE(
+      ReadLocalVersionInformationCompleteView::Create(CommandCompleteView::Create(EventView::Create(event))).IsValid());
+  ASSERT_EQ(0, hal->GetNumSentCommands());
+}
+
+TEST_F(HciPipelinedTest, resetIsSentAlone) {
+  uint8_t num_packets = 2;
+  hal->callbacks->hciEventReceived(GetPacketBytes(NoCommandCompleteBuilder::Create(num_packets)));
+  Synchronize();
+
+  upper->SendHciCommandExpectingComplete(ReadLocalVersionInformationBuilder::Create());
+  upper->SendHciCommandExpectingComplete(ResetBuilder::Create());
+  Synchronize();
+
+  // Reset waits for the command in flight
+  ASSERT_EQ(1, hal->GetNumSentCommands());
+  ASSERT_TRUE(ReadLocalVersionInformationView::Create(hal->GetSentCommand()).IsValid());
+
+  LocalVersionInformation local_version_information;
+  hal->callbacks->hciEventReceived(GetPacketBytes(ReadLocalVersionInformationCompleteBuilder::Create(
+      num_packets, ErrorCode::SUCCESS, local_version_information)));
+  Synchronize();
+  ASSERT_EQ(1, hal->GetNumSentCommands());
+  ASSERT_TRUE(ResetView::Create(hal->GetSentCommand()).IsValid());
+  hal->callbacks->hciEventReceived(GetPacketBytes(ResetCompleteBuilder::Create(num_packets, ErrorCode::SUCCESS)));
+  Synchronize();
+}
+
 TEST_F(HciTest, leSecurityInterfaceTest) {
   // Send LeRand to the controller
   auto command_future = hal->GetSentCommandFuture();
@@ -0,0 +1,249 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/hci_metrics_logger.h"
+
+#include <sstream>
+
+#include "common/bind.h"
+#include "hci/hci_metrics_logging.h"
+#include "os/log.h"
+
+namespace bluetooth {
+namespace hci {
+
+namespace {
+
+bool IsCommandResponse(const EventView& event) {
+  EventCode event_code = event.GetEventCode();
+  return event_code == EventCode::COMMAND_COMPLETE || event_code == EventCode::COMMAND_STATUS;
+}
+
+// Status of a command status event, or first return parameter of a command complete event, which is the status of
+// nearly all of them
+ErrorCode GetResponseStatus(EventView event) {
+  if (event.GetEventCode() == EventCode::COMMAND_STATUS) {
+    auto status_view = CommandStatusView::Create(event);
+    return status_view.IsValid() ? status_view.GetStatus() : ErrorCode::STATUS_UNKNOWN;
+  }
+  auto complete_view = CommandCompleteView::Create(event);
+  if (!complete_view.IsValid() || complete_view.GetPayload().size() == 0) {
+    return ErrorCode::STATUS_UNKNOWN;
+  }
+  return static_cast<ErrorCode>(complete_view.GetPayload().at(0));
+}
+
+}  // namespace
+
+HciMetricsLogger::HciMetricsLogger(bool deferred, storage::StorageModule* storage_module)
+    : HciMetricsLogger(
+          deferred, [storage_module](std::unique_ptr<CommandView>& command_view, std::optional<EventView> event) {
+            if (event.has_value()) {
+              log_hci_event(command_view, *event, storage_module);
+            } else {
+              log_link_layer_connection_command(command_view);
+              log_classic_pairing_command_status(command_view, ErrorCode::STATUS_UNKNOWN);
+            }
+          }) {}
+
+HciMetricsLogger::HciMetricsLogger(bool deferred, LogFunction log) : log_(std::move(log)) {
+  if (!deferred) {
+    return;
+  }
+  batch_.reserve(kRingSize);
+  window_start_ = Clock::now();
+  worker_thread_ = std::make_unique<os::Thread>("hci_metrics_thread", os::Thread::Priority::NORMAL);
+  worker_event_ = worker_thread_->GetReactor()->NewEvent();
+  worker_reactable_ = worker_thread_->GetReactor()->Register(
+      worker_event_->Id(),
+      common::Bind(&HciMetricsLogger::OnRecordsReady, common::Unretained(this)),
+      common::Closure());
+}
+
+HciMetricsLogger::~HciMetricsLogger() {
+  if (worker_thread_ == nullptr) {
+    return;
+  }
+  worker_thread_->GetReactor()->Unregister(worker_reactable_);
+  worker_thread_->GetReactor()->WaitForUnregisteredReactable(std::chrono::milliseconds(1000));
+  worker_thread_->Stop();
+  // Log what the worker left behind from here
+  LogRecords();
+  {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    EndAggregationWindow(Clock::now());
+  }
+  worker_event_.reset();
+  worker_thread_.reset();
+  if (dropped_count_ > 0) {
+    LOG_WARN("%llu HCI metrics records dropped", static_cast<unsigned long long>(dropped_count_));
+  }
+}
+
+void HciMetricsLogger::OnCommandSent(std::unique_ptr<CommandView>& command_view) {
+  if (!IsDeferred()) {
+    log_(command_view, std::nullopt);
+    return;
+  }
+  if (is_logged_command(command_view->GetOpCode())) {
+    Capture(command_view, std::nullopt);
+  }
+}
+
+void HciMetricsLogger::OnEvent(std::unique_ptr<CommandView>& command_view, EventView event) {
+  if (!IsDeferred()) {
+    log_(command_view, event);
+    return;
+  }
+  bool logged = IsCommandResponse(event) ? command_view != nullptr && is_logged_command(command_view->GetOpCode())
+                                         : is_logged_event(event);
+  if (logged) {
+    Capture(command_view, event);
+  }
+}
+
+void HciMetricsLogger::Capture(std::unique_ptr<CommandView>& command_view, std::optional<EventView> event) {
+  bool was_empty;
+  {
+    std::lock_guard<std::mutex> lock(ring_mutex_);
+    if (ring_size_ == ring_.size()) {
+      dropped_count_++;
+      return;
+    }
+    Record& record = ring_[(ring_head_ + ring_size_) % ring_.size()];
+    record.command_view = command_view != nullptr ? std::make_unique<CommandView>(*command_view) : nullptr;
+    record.event = std::move(event);
+    record.captured = Clock::now();
+    was_empty = ring_size_ == 0;
+    ring_size_++;
+    captured_count_++;
+  }
+  // A burst costs a single wakeup of the worker
+  if (was_empty) {
+    worker_event_->Notify();
+  }
+}
+
+void HciMetricsLogger::OnRecordsReady() {
+  worker_event_->Read();
+  LogRecords();
+}
+
+void HciMetricsLogger::LogRecords() {
+  std::lock_guard<std::mutex> stats_lock(stats_mutex_);
+  {
+    std::lock_guard<std::mutex> lock(ring_mutex_);
+    for (; ring_size_ > 0; ring_size_--) {
+      batch_.push_back(std::move(ring_[ring_head_]));
+      ring_[ring_head_] = Record();
+      ring_head_ = (ring_head_ + 1) % ring_.size();
+    }
+  }
+  auto now = Clock::now();
+  for (auto& record : batch_) {
+    delay_histogram_.Record(std::chrono::duration_cast<std::chrono::microseconds>(now - record.captured));
+    if (!Aggregate(record, now)) {
+      log_(record.command_view, std::move(record.event));
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(ring_mutex_);
+    logged_count_ += batch_.size();
+  }
+  batch_.clear();
+  flushed_.notify_all();
+}
+
+bool HciMetricsLogger::Aggregate(const Record& record, Clock::time_point now) {
+  if (now - window_start_ >= kAggregationWindow) {
+    EndAggregationWindow(now);
+  }
+  if (record.event.has_value() && !IsCommandResponse(*record.event)) {
+    return false;
+  }
+  if (++window_command_count_ <= kMaxLoggedCommandsPerSecond || record.command_view == nullptr) {
+    return false;
+  }
+  AggregatedCounts& counts = window_counts_[record.command_view->GetOpCode()];
+  if (record.event.has_value()) {
+    counts.responses[GetResponseStatus(*record.event)]++;
+  } else {
+    counts.sent++;
+  }
+  return true;
+}
+
+void HciMetricsLogger::EndAggregationWindow(Clock::time_point now) {
+  if (!window_counts_.empty()) {
+    std::stringstream summary;
+    uint64_t aggregated = 0;
+    for (const auto& [op_code, counts] : window_counts_) {
+      summary << " " << OpCodeText(op_code) << " sent:" << counts.sent;
+      aggregated += counts.sent;
+      for (const auto& [status, count] : counts.responses) {
+        summary << " " << ErrorCodeText(status) << ":" << count;
+        aggregated += count;
+      }
+      AggregatedCounts& total = total_counts_[op_code];
+      total.sent += counts.sent;
+      for (const auto& [status, count] : counts.responses) {
+        total.responses[status] += count;
+      }
+    }
+    LOG_INFO(
+        "%llu HCI commands and responses in %lld ms, not logged one by one:%s",
+        static_cast<unsigned long long>(aggregated),
+        static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(now - window_start_).count()),
+        summary.str().c_str());
+    window_counts_.clear();
+  }
+  window_start_ = now;
+  window_command_count_ = 0;
+}
+
+void HciMetricsLogger::Flush() {
+  if (!IsDeferred()) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(ring_mutex_);
+  uint64_t captured = captured_count_;
+  flushed_.wait(lock, [this, captured] { return logged_count_ >= captured; });
+}
+
+uint64_t HciMetricsLogger::GetDroppedCount() const {
+  std::lock_guard<std::mutex> lock(ring_mutex_);
+  return dropped_count_;
+}
+
+std::map<OpCode, HciMetricsLogger::AggregatedCounts> HciMetricsLogger::GetAggregatedCounts() const {
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  auto counts = total_counts_;
+  for (const auto& [op_code, window] : window_counts_) {
+    counts[op_code].sent += window.sent;
+    for (const auto& [status, count] : window.responses) {
+      counts[op_code].responses[status] += count;
+    }
+  }
+  return counts;
+}
+
+LatencyHistogram HciMetricsLogger::GetDelayHistogram() const {
+  std::lock_guard<std::mutex> lock(stats_mutex_);
+  return delay_histogram_;
+}
+
+}  // namespace hci
+}  // namespace bluetooth
@@ -0,0 +1,137 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "hci/acl_latency_tracker.h"
+#include "hci/hci_packets.h"
+#include "os/reactor.h"
+#include "os/thread.h"
+
+namespace bluetooth {
+namespace storage {
+class StorageModule;
+}  // namespace storage
+
+namespace hci {
+
+// Logs the HCI metrics of hci_metrics_logging.h for the commands HciLayer sends and the events it receives.
+//
+// By default the metrics are decoded and logged right away, on the HCI thread. Deferred, the HCI thread only copies
+// the views of the commands and events that have metrics into a fixed ring, and a normal priority thread decodes and
+// logs them. Past kMaxLoggedCommandsPerSecond commands and command responses in a second, as during connection
+// storms, the others of that second are only counted per opcode and response status, and the counts are logged
+// together with the first record after the second is over. Other events are always logged one by one.
+class HciMetricsLogger {
+ public:
+  static constexpr size_t kRingSize = 256;
+  static constexpr size_t kMaxLoggedCommandsPerSecond = 50;
+  static constexpr std::chrono::seconds kAggregationWindow = std::chrono::seconds(1);
+
+  // Logs a command sent, with no event, or an event with the command it answers, if any
+  using LogFunction = std::function<void(std::unique_ptr<CommandView>& command_view, std::optional<EventView> event)>;
+
+  // Counts of the commands with one opcode that were not logged one by one
+  struct AggregatedCounts {
+    uint64_t sent = 0;
+    // Responses, by status
+    std::map<ErrorCode, uint64_t> responses;
+  };
+
+  HciMetricsLogger(bool deferred, storage::StorageModule* storage_module);
+  // Logs with |log| instead, for tests
+  HciMetricsLogger(bool deferred, LogFunction log);
+  HciMetricsLogger(const HciMetricsLogger&) = delete;
+  HciMetricsLogger& operator=(const HciMetricsLogger&) = delete;
+  // Logs whatever is still captured
+  ~HciMetricsLogger();
+
+  bool IsDeferred() const {
+    return worker_thread_ != nullptr;
+  }
+
+  // Called on the HCI thread for every command sent
+  void OnCommandSent(std::unique_ptr<CommandView>& command_view);
+  // Called on the HCI thread for every event, with the command it answers when commands are in flight
+  void OnEvent(std::unique_ptr<CommandView>& command_view, EventView event);
+
+  // Wait until the records captured so far are logged
+  void Flush();
+
+  // Records not captured as the ring was full
+  uint64_t GetDroppedCount() const;
+  // Commands counted instead of logged since the logger started, by opcode
+  std::map<OpCode, AggregatedCounts> GetAggregatedCounts() const;
+  // Time from capture to logging of the deferred records
+  LatencyHistogram GetDelayHistogram() const;
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Record {
+    std::unique_ptr<CommandView> command_view;
+    std::optional<EventView> event;
+    Clock::time_point captured;
+  };
+
+  void Capture(std::unique_ptr<CommandView>& command_view, std::optional<EventView> event);
+  // Runs on worker_thread_ when worker_event_ is notified
+  void OnRecordsReady();
+  void LogRecords();
+  // Whether |record| is counted in the current aggregation window instead of being logged
+  bool Aggregate(const Record& record, Clock::time_point now);
+  // Log the counts of the aggregation window that ended and start a new one
+  void EndAggregationWindow(Clock::time_point now);
+
+  LogFunction log_;
+
+  // Capture ring, filled by the HCI thread and drained by worker_thread_
+  mutable std::mutex ring_mutex_;
+  std::condition_variable flushed_;
+  std::array<Record, kRingSize> ring_;
+  size_t ring_head_ = 0;
+  size_t ring_size_ = 0;
+  uint64_t captured_count_ = 0;
+  uint64_t logged_count_ = 0;
+  uint64_t dropped_count_ = 0;
+
+  // Only used by the thread logging the records, taken for the getters
+  mutable std::mutex stats_mutex_;
+  std::vector<Record> batch_;
+  Clock::time_point window_start_;
+  size_t window_command_count_ = 0;
+  std::map<OpCode, AggregatedCounts> window_counts_;
+  std::map<OpCode, AggregatedCounts> total_counts_;
+  LatencyHistogram delay_histogram_;
+
+  std::unique_ptr<os::Thread> worker_thread_;
+  std::unique_ptr<os::Reactor::Event> worker_event_;
+  os::Reactor::Reactable* worker_reactable_ = nullptr;
+};
+
+}  // namespace hci
+}  // namespace bluetooth
@@ -0,0 +1,192 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/hci_metrics_logger.h"
+
+#include <gtest/gtest.h>
+
+#include <future>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "packet/bit_inserter.h"
+
+namespace bluetooth {
+namespace hci {
+namespace {
+
+const Address kAddress({0x01, 0x02, 0x03, 0x04, 0x05, 0x06});
+
+std::shared_ptr<std::vector<uint8_t>> Serialize(std::unique_ptr<packet::BasePacketBuilder> builder) {
+  auto bytes = std::make_shared<std::vector<uint8_t>>();
+  packet::BitInserter it(*bytes);
+  builder->Serialize(it);
+  return bytes;
+}
+
+std::unique_ptr<CommandView> MakeCommand(std::unique_ptr<CommandBuilder> builder) {
+  auto command = std::make_unique<CommandView>(CommandView::Create(packet::PacketView<packet::kLittleEndian>(
+      Serialize(std::move(builder)))));
+  EXPECT_TRUE(command->IsValid());
+  return command;
+}
+
+std::unique_ptr<CommandView> MakeAddToFilterAcceptList() {
+  return MakeCommand(LeAddDeviceToFilterAcceptListBuilder::Create(FilterAcceptListAddressType::PUBLIC, kAddress));
+}
+
+EventView MakeEvent(std::unique_ptr<EventBuilder> builder) {
+  auto event = EventView::Create(packet::PacketView<packet::kLittleEndian>(Serialize(std::move(builder))));
+  EXPECT_TRUE(event.IsValid());
+  return event;
+}
+
+class HciMetricsLoggerTest : public ::testing::Test {
+ protected:
+  HciMetricsLogger::LogFunction GetLogFunction() {
+    return [this](std::unique_ptr<CommandView>& command_view, std::optional<EventView> event) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      logged_.push_back({command_view != nullptr ? command_view->GetOpCode() : OpCode::NONE,
+                         event.has_value() ? std::optional<EventCode>(event->GetEventCode()) : std::nullopt,
+                         std::this_thread::get_id()});
+    };
+  }
+
+  struct Logged {
+    OpCode op_code;
+    std::optional<EventCode> event_code;
+    std::thread::id thread;
+  };
+
+  std::vector<Logged> GetLogged() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return logged_;
+  }
+
+  std::mutex mutex_;
+  std::vector<Logged> logged_;
+};
+
+TEST_F(HciMetricsLoggerTest, synchronous_logs_everything_inline) {
+  HciMetricsLogger logger(false, GetLogFunction());
+  ASSERT_FALSE(logger.IsDeferred());
+  auto command = MakeCommand(ReadLocalVersionInformationBuilder::Create());
+  logger.OnCommandSent(command);
+  logger.OnEvent(command, MakeEvent(LeAddDeviceToFilterAcceptListCompleteBuilder::Create(1, ErrorCode::SUCCESS)));
+
+  auto logged = GetLogged();
+  ASSERT_EQ(logged.size(), 2u);
+  EXPECT_EQ(logged[0].op_code, OpCode::READ_LOCAL_VERSION_INFORMATION);
+  EXPECT_FALSE(logged[0].event_code.has_value());
+  EXPECT_EQ(logged[1].event_code, EventCode::COMMAND_COMPLETE);
+  EXPECT_EQ(logged[1].thread, std::this_thread::get_id());
+}
+
+TEST_F(HciMetricsLoggerTest, deferred_logs_records_with_metrics_from_worker) {
+  HciMetricsLogger logger(true, GetLogFunction());
+  ASSERT_TRUE(logger.IsDeferred());
+  // No metrics for this command and this event
+  auto version = MakeCommand(ReadLocalVersionInformationBuilder::Create());
+  logger.OnCommandSent(version);
+  std::unique_ptr<CommandView> no_command;
+  logger.OnEvent(no_command, MakeEvent(ConnectionPacketTypeChangedBuilder::Create(ErrorCode::SUCCESS, 0x0001, 0x0018)));
+
+  auto add = MakeAddToFilterAcceptList();
+  logger.OnCommandSent(add);
+  logger.OnEvent(add, MakeEvent(LeAddDeviceToFilterAcceptListCompleteBuilder::Create(1, ErrorCode::SUCCESS)));
+  logger.OnEvent(
+      no_command,
+      MakeEvent(LeConnectionCompleteBuilder::Create(
+          ErrorCode::SUCCESS,
+          0x0001,
+          Role::CENTRAL,
+          AddressType::PUBLIC_DEVICE_ADDRESS,
+          kAddress,
+          0x0018,
+          0,
+          0x01f4,
+          ClockAccuracy::PPM_500)));
+  logger.Flush();
+
+  auto logged = GetLogged();
+  ASSERT_EQ(logged.size(), 3u);
+  EXPECT_EQ(logged[0].op_code, OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST);
+  EXPECT_FALSE(logged[0].event_code.has_value());
+  EXPECT_EQ(logged[1].op_code, OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST);
+  EXPECT_EQ(logged[1].event_code, EventCode::COMMAND_COMPLETE);
+  EXPECT_EQ(logged[2].event_code, EventCode::LE_META_EVENT);
+  for (const auto& record : logged) {
+    EXPECT_NE(record.thread, std::this_thread::get_id());
+  }
+  EXPECT_EQ(logger.GetDelayHistogram().Count(), 3u);
+}
+
+TEST_F(HciMetricsLoggerTest, deferred_aggregates_command_storm) {
+  HciMetricsLogger logger(true, GetLogFunction());
+  constexpr size_t kExtra = 20;
+  for (size_t i = 0; i < HciMetricsLogger::kMaxLoggedCommandsPerSecond / 2 + kExtra; i++) {
+    auto add = MakeAddToFilterAcceptList();
+    logger.OnCommandSent(add);
+    ErrorCode status = i % 2 == 0 ? ErrorCode::SUCCESS : ErrorCode::MEMORY_CAPACITY_EXCEEDED;
+    logger.OnEvent(add, MakeEvent(LeAddDeviceToFilterAcceptListCompleteBuilder::Create(1, status)));
+  }
+  logger.Flush();
+
+  // Unless the loop took more than a second, the commands and responses past the limit were only counted
+  auto counts = logger.GetAggregatedCounts();
+  ASSERT_EQ(counts.size(), 1u);
+  auto& add_counts = counts[OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST];
+  EXPECT_EQ(add_counts.sent, kExtra);
+  EXPECT_EQ(
+      add_counts.responses[ErrorCode::SUCCESS] + add_counts.responses[ErrorCode::MEMORY_CAPACITY_EXCEEDED], kExtra);
+  EXPECT_EQ(GetLogged().size(), HciMetricsLogger::kMaxLoggedCommandsPerSecond);
+}
+
+TEST_F(HciMetricsLoggerTest, deferred_drops_records_when_ring_is_full) {
+  std::promise<void> logging;
+  std::promise<void> unblock;
+  auto unblocked = unblock.get_future().share();
+  bool first = true;
+  auto log = GetLogFunction();
+  HciMetricsLogger logger(
+      true, [&](std::unique_ptr<CommandView>& command_view, std::optional<EventView> event) {
+        if (first) {
+          first = false;
+          logging.set_value();
+          unblocked.wait();
+        }
+        log(command_view, std::move(event));
+      });
+  auto add = MakeAddToFilterAcceptList();
+  logger.OnCommandSent(add);
+  // The worker is stuck logging the first record, with the ring empty behind it
+  logging.get_future().wait();
+  for (size_t i = 0; i < HciMetricsLogger::kRingSize + 5; i++) {
+    logger.OnCommandSent(add);
+  }
+  EXPECT_EQ(logger.GetDroppedCount(), 5u);
+  unblock.set_value();
+  logger.Flush();
+  EXPECT_EQ(
+      GetLogged().size(),
+      std::min(HciMetricsLogger::kRingSize + 1, HciMetricsLogger::kMaxLoggedCommandsPerSecond));
+}
+
+}  // namespace
+}  // namespace hci
+}  // namespace bluetooth
@@ -1096,5 +1096,79 @@ void log_remote_device_information(
       device.GetLmpSubVersion().value_or(-1));
 }
 
+bool is_logged_command(OpCode op_code) {
+  switch (op_code) {
+    case OpCode::CREATE_CONNECTION:
+    case OpCode::CREATE_CONNECTION_CANCEL:
+    case OpCode::DISCONNECT:
+    case OpCode::SETUP_SYNCHRONOUS_CONNECTION:
+    case OpCode::ENHANCED_SETUP_SYNCHRONOUS_CONNECTION:
+    case OpCode::ACCEPT_CONNECTION_REQUEST:
+    case OpCode::ACCEPT_SYNCHRONOUS_CONNECTION:
+    case OpCode::ENHANCED_ACCEPT_SYNCHRONOUS_CONNECTION:
+    case OpCode::REJECT_CONNECTION_REQUEST:
+    case OpCode::REJECT_SYNCHRONOUS_CONNECTION:
+    case OpCode::LE_CREATE_CONNECTION:
+    case OpCode::LE_EXTENDED_CREATE_CONNECTION:
+    case OpCode::LE_CREATE_CONNECTION_CANCEL:
+    case OpCode::LE_CLEAR_FILTER_ACCEPT_LIST:
+    case OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST:
+    case OpCode::LE_REMOVE_DEVICE_FROM_FILTER_ACCEPT_LIST:
+    case OpCode::READ_LOCAL_OOB_DATA:
+    case OpCode::WRITE_SIMPLE_PAIRING_MODE:
+    case OpCode::WRITE_SECURE_CONNECTIONS_HOST_SUPPORT:
+    case OpCode::AUTHENTICATION_REQUESTED:
+    case OpCode::SET_CONNECTION_ENCRYPTION:
+    case OpCode::DELETE_STORED_LINK_KEY:
+    case OpCode::REMOTE_NAME_REQUEST:
+    case OpCode::REMOTE_NAME_REQUEST_CANCEL:
+    case OpCode::LINK_KEY_REQUEST_REPLY:
+    case OpCode::LINK_KEY_REQUEST_NEGATIVE_REPLY:
+    case OpCode::IO_CAPABILITY_REQUEST_REPLY:
+    case OpCode::USER_CONFIRMATION_REQUEST_REPLY:
+    case OpCode::USER_CONFIRMATION_REQUEST_NEGATIVE_REPLY:
+    case OpCode::USER_PASSKEY_REQUEST_REPLY:
+    case OpCode::USER_PASSKEY_REQUEST_NEGATIVE_REPLY:
+    case OpCode::REMOTE_OOB_DATA_REQUEST_REPLY:
+    case OpCode::REMOTE_OOB_DATA_REQUEST_NEGATIVE_REPLY:
+    case OpCode::IO_CAPABILITY_REQUEST_NEGATIVE_REPLY:
+    case OpCode::READ_ENCRYPTION_KEY_SIZE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool is_logged_event(EventView event_view) {
+  EventCode event_code = event_view.GetEventCode();
+  switch (event_code) {
+    case EventCode::LE_META_EVENT: {
+      LeMetaEventView le_meta_event_view = LeMetaEventView::Create(event_view);
+      return le_meta_event_view.IsValid() && le_meta_event_view.GetSubeventCode() == SubeventCode::CONNECTION_COMPLETE;
+    }
+    case EventCode::CONNECTION_COMPLETE:
+    case EventCode::CONNECTION_REQUEST:
+    case EventCode::DISCONNECTION_COMPLETE:
+    case EventCode::SYNCHRONOUS_CONNECTION_COMPLETE:
+    case EventCode::SYNCHRONOUS_CONNECTION_CHANGED:
+    case EventCode::IO_CAPABILITY_REQUEST:
+    case EventCode::IO_CAPABILITY_RESPONSE:
+    case EventCode::LINK_KEY_REQUEST:
+    case EventCode::LINK_KEY_NOTIFICATION:
+    case EventCode::USER_PASSKEY_REQUEST:
+    case EventCode::USER_PASSKEY_NOTIFICATION:
+    case EventCode::USER_CONFIRMATION_REQUEST:
+    case EventCode::KEYPRESS_NOTIFICATION:
+    case EventCode::REMOTE_OOB_DATA_REQUEST:
+    case EventCode::SIMPLE_PAIRING_COMPLETE:
+    case EventCode::REMOTE_NAME_REQUEST_COMPLETE:
+    case EventCode::AUTHENTICATION_COMPLETE:
+    case EventCode::ENCRYPTION_CHANGE:
+      return true;
+    default:
+      return false;
+  }
+}
+
 }  // namespace hci
 }  // namespace bluetooth
@@ -40,5 +40,10 @@ void log_remote_device_information(
     uint32_t connection_handle,
     ErrorCode status,
     storage::StorageModule* storage_module);
+
+// Whether the functions above log anything for a command with |op_code|, or for the events answering it
+bool is_logged_command(OpCode op_code);
+// Whether log_hci_event() logs anything for |event_view|, which is not a command complete or status event
+bool is_logged_event(EventView event_view);
 }  // namespace hci
 }  // namespace bluetooth
\ No newline at end of file
@@ -0,0 +1,340 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/host_advertising_filter.h"
+
+#include <algorithm>
+
+#include "hci/address_with_type.h"
+#include "hci/uuid.h"
+#include "os/log.h"
+
+namespace bluetooth {
+namespace hci {
+
+namespace {
+
+constexpr uint8_t kUuid16Incomplete = 0x02;
+constexpr uint8_t kUuid16Complete = 0x03;
+constexpr uint8_t kUuid32Incomplete = 0x04;
+constexpr uint8_t kUuid32Complete = 0x05;
+constexpr uint8_t kUuid128Incomplete = 0x06;
+constexpr uint8_t kUuid128Complete = 0x07;
+constexpr uint8_t kShortenedLocalName = 0x08;
+constexpr uint8_t kCompleteLocalName = 0x09;
+constexpr uint8_t kSolicitationUuid16 = 0x14;
+constexpr uint8_t kSolicitationUuid128 = 0x15;
+constexpr uint8_t kServiceData16 = 0x16;
+constexpr uint8_t kSolicitationUuid32 = 0x1f;
+constexpr uint8_t kServiceData32 = 0x20;
+constexpr uint8_t kServiceData128 = 0x21;
+constexpr uint8_t kManufacturerData = 0xff;
+
+// Features evaluated on the host, the others (service data change) always match
+constexpr ApcfFilterType kEmulatedFeatures[] = {
+    ApcfFilterType::BROADCASTER_ADDRESS,
+    ApcfFilterType::SERVICE_UUID,
+    ApcfFilterType::SERVICE_SOLICITATION_UUID,
+    ApcfFilterType::LOCAL_NAME,
+    ApcfFilterType::MANUFACTURER_DATA,
+    ApcfFilterType::SERVICE_DATA,
+    ApcfFilterType::AD_TYPE,
+};
+
+bool is_empty_128bit(const std::array<uint8_t, 16>& data) {
+  return std::all_of(data.begin(), data.end(), [](uint8_t byte) { return byte == 0; });
+}
+
+// A missing mask compares every byte
+std::vector<uint8_t> make_mask(const std::vector<uint8_t>& mask, size_t length) {
+  return mask.empty() ? std::vector<uint8_t>(length, 0xff) : mask;
+}
+
+}  // namespace
+
+void HostAdvertisingFilter::Enable(bool enable) {
+  enabled_ = enable;
+}
+
+bool HostAdvertisingFilter::IsEnabled() const {
+  return enabled_;
+}
+
+bool HostAdvertisingFilter::SetParameters(uint8_t filter_index, const AdvertisingFilterParameter& parameter) {
+  auto it = filters_.find(filter_index);
+  if (it == filters_.end()) {
+    if (filters_.size() >= kMaxFilterIndexes) {
+      return false;
+    }
+    it = filters_.emplace(filter_index, Filter{}).first;
+  }
+  it->second.has_parameters = true;
+  it->second.feature_selection = parameter.feature_selection;
+  it->second.rssi_threshold = static_cast<int8_t>(parameter.rssi_high_thresh);
+  return true;
+}
+
+void HostAdvertisingFilter::DeleteParameters(uint8_t filter_index) {
+  auto it = filters_.find(filter_index);
+  if (it == filters_.end()) {
+    return;
+  }
+  condition_count_ -= it->second.conditions.size();
+  filters_.erase(it);
+}
+
+void HostAdvertisingFilter::ClearParameters() {
+  filters_.clear();
+  condition_count_ = 0;
+}
+
+uint8_t HostAdvertisingFilter::GetAvailableFilterIndexes() const {
+  return static_cast<uint8_t>(kMaxFilterIndexes - filters_.size());
+}
+
+bool HostAdvertisingFilter::AddCondition(uint8_t filter_index, const AdvertisingPacketContentFilterCommand& command) {
+  if (condition_count_ >= kMaxConditions) {
+    return false;
+  }
+  Condition condition{};
+  condition.type = command.filter_type;
+  switch (command.filter_type) {
+    case ApcfFilterType::BROADCASTER_ADDRESS:
+      condition.address = command.address;
+      condition.has_irk = !is_empty_128bit(command.irk);
+      condition.irk = command.irk;
+      break;
+    case ApcfFilterType::SERVICE_UUID:
+    case ApcfFilterType::SERVICE_SOLICITATION_UUID:
+      condition.uuid = command.uuid.To128BitLE();
+      if (command.uuid_mask.IsEmpty()) {
+        condition.uuid_mask.fill(0xff);
+      } else {
+        condition.uuid_mask = command.uuid_mask.To128BitLE();
+      }
+      break;
+    case ApcfFilterType::LOCAL_NAME:
+      condition.pattern.bytes = command.name;
+      break;
+    case ApcfFilterType::MANUFACTURER_DATA: {
+      if (!command.data_mask.empty() && command.data.size() != command.data_mask.size()) {
+        LOG_ERROR("manufacturer data mask should have the same length as manufacturer data");
+        return false;
+      }
+      uint16_t company_mask = command.company_mask != 0 ? command.company_mask : 0xffff;
+      condition.pattern.bytes = {static_cast<uint8_t>(command.company), static_cast<uint8_t>(command.company >> 8)};
+      condition.pattern.bytes.insert(condition.pattern.bytes.end(), command.data.begin(), command.data.end());
+      condition.pattern.mask = {static_cast<uint8_t>(company_mask), static_cast<uint8_t>(company_mask >> 8)};
+      auto data_mask = make_mask(command.data_mask, command.data.size());
+      condition.pattern.mask.insert(condition.pattern.mask.end(), data_mask.begin(), data_mask.end());
+      break;
+    }
+    case ApcfFilterType::SERVICE_DATA:
+    case ApcfFilterType::AD_TYPE:
+      if (!command.data_mask.empty() && command.data.size() != command.data_mask.size()) {
+        LOG_ERROR("data mask should have the same length as data");
+        return false;
+      }
+      condition.ad_type = command.ad_type;
+      condition.pattern.bytes = command.data;
+      condition.pattern.mask = make_mask(command.data_mask, command.data.size());
+      break;
+    default:
+      LOG_WARN("Filter type %s is not emulated", ApcfFilterTypeText(command.filter_type).c_str());
+      return false;
+  }
+
+  auto it = filters_.find(filter_index);
+  if (it == filters_.end()) {
+    if (filters_.size() >= kMaxFilterIndexes) {
+      return false;
+    }
+    it = filters_.emplace(filter_index, Filter{}).first;
+  }
+  it->second.conditions.push_back(std::move(condition));
+  condition_count_++;
+  return true;
+}
+
+uint8_t HostAdvertisingFilter::GetAvailableConditions() const {
+  return static_cast<uint8_t>(kMaxConditions - condition_count_);
+}
+
+bool HostAdvertisingFilter::Matches(
+    const Address& address, uint8_t address_type, int8_t rssi, const uint8_t* data, size_t length) {
+  if (!enabled_) {
+    return true;
+  }
+  bool has_active_filter = false;
+  for (const auto& filter : filters_) {
+    has_active_filter |= filter.second.has_parameters;
+  }
+  if (!has_active_filter) {
+    return true;
+  }
+
+  // Split the AD structures once for all the conditions, a malformed tail is ignored
+  fields_.clear();
+  size_t offset = 0;
+  while (offset < length) {
+    uint8_t field_length = data[offset];
+    if (field_length == 0 || offset + 1 + field_length > length) {
+      break;
+    }
+    fields_.push_back(Field{data[offset + 1], &data[offset + 2], static_cast<uint8_t>(field_length - 1)});
+    offset += 1 + field_length;
+  }
+
+  for (const auto& filter : filters_) {
+    if (filter.second.has_parameters && matches_filter(filter.second, address, address_type, rssi)) {
+      return true;
+    }
+  }
+  rejected_count_++;
+  return false;
+}
+
+size_t HostAdvertisingFilter::GetRejectedCount() const {
+  return rejected_count_;
+}
+
+bool HostAdvertisingFilter::matches_filter(
+    const Filter& filter, const Address& address, uint8_t address_type, int8_t rssi) const {
+  if (rssi < filter.rssi_threshold) {
+    return false;
+  }
+  for (ApcfFilterType feature : kEmulatedFeatures) {
+    if (!(filter.feature_selection & (1 << static_cast<uint8_t>(feature)))) {
+      continue;
+    }
+    bool has_condition = false;
+    bool matched = false;
+    for (const auto& condition : filter.conditions) {
+      if (condition.type != feature) {
+        continue;
+      }
+      has_condition = true;
+      if (matches_condition(condition, address, address_type)) {
+        matched = true;
+        break;
+      }
+    }
+    if (has_condition && !matched) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool HostAdvertisingFilter::matches_condition(
+    const Condition& condition, const Address& address, uint8_t address_type) const {
+  switch (condition.type) {
+    case ApcfFilterType::BROADCASTER_ADDRESS:
+      if (address == condition.address) {
+        return true;
+      }
+      return condition.has_irk &&
+             AddressWithType(address, static_cast<AddressType>(address_type)).IsRpaThatMatchesIrk(condition.irk);
+    case ApcfFilterType::SERVICE_UUID:
+      return matches_uuid(condition, false);
+    case ApcfFilterType::SERVICE_SOLICITATION_UUID:
+      return matches_uuid(condition, true);
+    case ApcfFilterType::LOCAL_NAME:
+      return matches_local_name(condition);
+    case ApcfFilterType::MANUFACTURER_DATA:
+      return matches_pattern(condition.pattern, {kManufacturerData});
+    case ApcfFilterType::SERVICE_DATA:
+      return matches_pattern(condition.pattern, {kServiceData16, kServiceData32, kServiceData128});
+    case ApcfFilterType::AD_TYPE:
+      return matches_pattern(condition.pattern, {condition.ad_type});
+    default:
+      return true;
+  }
+}
+
+bool HostAdvertisingFilter::matches_uuid(const Condition& condition, bool solicitation) const {
+  for (const auto& field : fields_) {
+    size_t uuid_length;
+    if (field.type == (solicitation ? kSolicitationUuid16 : kUuid16Incomplete) ||
+        (!solicitation && field.type == kUuid16Complete)) {
+      uuid_length = Uuid::kNumBytes16;
+    } else if (
+        field.type == (solicitation ? kSolicitationUuid32 : kUuid32Incomplete) ||
+        (!solicitation && field.type == kUuid32Complete)) {
+      uuid_length = Uuid::kNumBytes32;
+    } else if (
+        field.type == (solicitation ? kSolicitationUuid128 : kUuid128Incomplete) ||
+        (!solicitation && field.type == kUuid128Complete)) {
+      uuid_length = Uuid::kNumBytes128;
+    } else {
+      continue;
+    }
+    for (size_t i = 0; i + uuid_length <= field.length; i += uuid_length) {
+      const uint8_t* bytes = field.data + i;
+      Uuid::UUID128Bit advertised;
+      if (uuid_length == Uuid::kNumBytes16) {
+        advertised = Uuid::From16Bit(bytes[0] | (bytes[1] << 8)).To128BitLE();
+      } else if (uuid_length == Uuid::kNumBytes32) {
+        advertised = Uuid::From32Bit(bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (bytes[3] << 24)).To128BitLE();
+      } else {
+        std::copy(bytes, bytes + Uuid::kNumBytes128, advertised.begin());
+      }
+      bool matched = true;
+      for (size_t j = 0; j < Uuid::kNumBytes128 && matched; j++) {
+        matched = (advertised[j] & condition.uuid_mask[j]) == (condition.uuid[j] & condition.uuid_mask[j]);
+      }
+      if (matched) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+// A shortened name only has to be the beginning of the filtered one, and the other way around
+bool HostAdvertisingFilter::matches_local_name(const Condition& condition) const {
+  const auto& name = condition.pattern.bytes;
+  for (const auto& field : fields_) {
+    if (field.type != kShortenedLocalName && field.type != kCompleteLocalName) {
+      continue;
+    }
+    size_t length = std::min(name.size(), static_cast<size_t>(field.length));
+    if (std::equal(name.begin(), name.begin() + length, field.data)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool HostAdvertisingFilter::matches_pattern(const Pattern& pattern, std::initializer_list<uint8_t> ad_types) const {
+  for (const auto& field : fields_) {
+    if (std::find(ad_types.begin(), ad_types.end(), field.type) == ad_types.end() ||
+        field.length < pattern.bytes.size()) {
+      continue;
+    }
+    bool matched = true;
+    for (size_t i = 0; i < pattern.bytes.size() && matched; i++) {
+      matched = (field.data[i] & pattern.mask[i]) == (pattern.bytes[i] & pattern.mask[i]);
+    }
+    if (matched) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace hci
+}  // namespace bluetooth
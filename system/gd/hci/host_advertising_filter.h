@@ -0,0 +1,116 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <map>
+#include <vector>
+
+#include "hci/address.h"
+#include "hci/le_scanning_callback.h"
+
+namespace bluetooth {
+namespace hci {
+
+// Evaluates advertising packet content filters (APCF) on the host, for controllers without the vendor offload. The
+// filters are compiled into masked byte patterns when they are added, so matching a report only walks its AD
+// structures once and compares bytes.
+//
+// A filter index matches a report when, for every feature selected in its parameters, at least one of its
+// conditions of that feature matches. A report passes when any filter index matches it. The engine is meant to
+// reject reports before they are handed to the upper layers, which still apply the exact filters: where the host
+// can't tell (features it does not emulate), the report passes.
+class HostAdvertisingFilter {
+ public:
+  // Limits reported as the available spaces, like the controller would
+  static constexpr size_t kMaxFilterIndexes = 32;
+  static constexpr size_t kMaxConditions = 128;
+
+  HostAdvertisingFilter() = default;
+  HostAdvertisingFilter(const HostAdvertisingFilter&) = delete;
+  HostAdvertisingFilter& operator=(const HostAdvertisingFilter&) = delete;
+
+  void Enable(bool enable);
+  bool IsEnabled() const;
+
+  // Return false if there is no room left for a new filter index
+  bool SetParameters(uint8_t filter_index, const AdvertisingFilterParameter& parameter);
+  // Remove the parameters and the conditions of |filter_index|
+  void DeleteParameters(uint8_t filter_index);
+  void ClearParameters();
+  uint8_t GetAvailableFilterIndexes() const;
+
+  // Return false if the condition is invalid or there is no room left for it
+  bool AddCondition(uint8_t filter_index, const AdvertisingPacketContentFilterCommand& command);
+  uint8_t GetAvailableConditions() const;
+
+  // Return true if the report should be delivered. |data| is the significant part of the advertising data.
+  bool Matches(const Address& address, uint8_t address_type, int8_t rssi, const uint8_t* data, size_t length);
+
+  size_t GetRejectedCount() const;
+
+ private:
+  struct Pattern {
+    std::vector<uint8_t> bytes;
+    std::vector<uint8_t> mask;
+  };
+
+  struct Condition {
+    ApcfFilterType type;
+    Address address;
+    bool has_irk;
+    std::array<uint8_t, 16> irk;
+    // Full 128 bit UUID, little endian
+    std::array<uint8_t, 16> uuid;
+    std::array<uint8_t, 16> uuid_mask;
+    uint8_t ad_type;
+    // Compared with the beginning of the AD structure data
+    Pattern pattern;
+  };
+
+  struct Filter {
+    bool has_parameters;
+    uint16_t feature_selection;
+    int8_t rssi_threshold;
+    std::vector<Condition> conditions;
+  };
+
+  struct Field {
+    uint8_t type;
+    const uint8_t* data;
+    uint8_t length;
+  };
+
+  bool matches_filter(const Filter& filter, const Address& address, uint8_t address_type, int8_t rssi) const;
+  bool matches_condition(const Condition& condition, const Address& address, uint8_t address_type) const;
+  bool matches_uuid(const Condition& condition, bool solicitation) const;
+  bool matches_local_name(const Condition& condition) const;
+  bool matches_pattern(const Pattern& pattern, std::initializer_list<uint8_t> ad_types) const;
+
+  bool enabled_{false};
+  std::map<uint8_t, Filter> filters_;
+  size_t condition_count_{0};
+  // AD structures of the report being matched, kept to reuse the allocation
+  std::vector<Field> fields_;
+  size_t rejected_count_{0};
+};
+
+}  // namespace hci
+}  // namespace bluetooth
@@ -0,0 +1,158 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/host_advertising_filter.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace bluetooth {
+namespace hci {
+namespace {
+
+constexpr uint8_t kPublic = 0x00;
+constexpr uint8_t kFilterIndex = 1;
+
+const Address kAddress({0x01, 0x02, 0x03, 0x04, 0x05, 0x06});
+const Address kOtherAddress({0x06, 0x05, 0x04, 0x03, 0x02, 0x01});
+
+// Flags, complete list of 16 bit UUIDs (0x180d), manufacturer data (company 0x00e0, 0xaa 0xbb)
+const std::vector<uint8_t> kData = {
+    0x02, 0x01, 0x06, 0x03, 0x03, 0x0d, 0x18, 0x05, 0xff, 0xe0, 0x00, 0xaa, 0xbb};
+
+uint16_t feature(ApcfFilterType type) {
+  return 1 << static_cast<uint8_t>(type);
+}
+
+AdvertisingFilterParameter make_parameter(uint16_t feature_selection, int8_t rssi_threshold = -128) {
+  AdvertisingFilterParameter parameter{};
+  parameter.feature_selection = feature_selection;
+  parameter.rssi_high_thresh = static_cast<uint8_t>(rssi_threshold);
+  return parameter;
+}
+
+AdvertisingPacketContentFilterCommand make_address(const Address& address) {
+  AdvertisingPacketContentFilterCommand command{};
+  command.filter_type = ApcfFilterType::BROADCASTER_ADDRESS;
+  command.address = address;
+  return command;
+}
+
+AdvertisingPacketContentFilterCommand make_uuid(const Uuid& uuid) {
+  AdvertisingPacketContentFilterCommand command{};
+  command.filter_type = ApcfFilterType::SERVICE_UUID;
+  command.uuid = uuid;
+  return command;
+}
+
+AdvertisingPacketContentFilterCommand make_manufacturer_data(
+    uint16_t company, std::vector<uint8_t> data, std::vector<uint8_t> data_mask) {
+  AdvertisingPacketContentFilterCommand command{};
+  command.filter_type = ApcfFilterType::MANUFACTURER_DATA;
+  command.company = company;
+  command.data = std::move(data);
+  command.data_mask = std::move(data_mask);
+  return command;
+}
+
+class HostAdvertisingFilterTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    filter_.Enable(true);
+  }
+
+  bool Matches(const Address& address, int8_t rssi = -50, const std::vector<uint8_t>& data = kData) {
+    return filter_.Matches(address, kPublic, rssi, data.data(), data.size());
+  }
+
+  HostAdvertisingFilter filter_;
+};
+
+TEST_F(HostAdvertisingFilterTest, everything_passes_without_filters) {
+  ASSERT_TRUE(Matches(kAddress));
+  filter_.Enable(false);
+  ASSERT_TRUE(filter_.AddCondition(kFilterIndex, make_address(kOtherAddress)));
+  ASSERT_TRUE(filter_.SetParameters(kFilterIndex, make_parameter(feature(ApcfFilterType::BROADCASTER_ADDRESS))));
+  ASSERT_TRUE(Matches(kAddress));
+  ASSERT_EQ(0u, filter_.GetRejectedCount());
+}
+
+TEST_F(HostAdvertisingFilterTest, conditions_need_parameters) {
+  ASSERT_TRUE(filter_.AddCondition(kFilterIndex, make_address(kOtherAddress)));
+  ASSERT_TRUE(Matches(kAddress));
+  ASSERT_TRUE(filter_.SetParameters(kFilterIndex, make_parameter(feature(ApcfFilterType::BROADCASTER_ADDRESS))));
+  ASSERT_FALSE(Matches(kAddress));
+  ASSERT_TRUE(Matches(kOtherAddress));
+  ASSERT_EQ(1u, filter_.GetRejectedCount());
+}
+
+TEST_F(HostAdvertisingFilterTest, features_are_and_conditions_are_or) {
+  ASSERT_TRUE(filter_.AddCondition(kFilterIndex, make_address(kAddress)));
+  ASSERT_TRUE(filter_.AddCondition(kFilterIndex, make_uuid(Uuid::From16Bit(0x180f))));
+  ASSERT_TRUE(filter_.AddCondition(kFilterIndex, make_uuid(Uuid::From16Bit(0x180d))));
+  ASSERT_TRUE(filter_.SetParameters(
+      kFilterIndex,
+      make_parameter(feature(ApcfFilterType::BROADCASTER_ADDRESS) | feature(ApcfFilterType::SERVICE_UUID))));
+  ASSERT_TRUE(Matches(kAddress));
+  ASSERT_FALSE(Matches(kOtherAddress));
+
+  // The flags alone do not advertise the UUID
+  ASSERT_FALSE(Matches(kAddress, -50, {0x02, 0x01, 0x06}));
+}
+
+TEST_F(HostAdvertisingFilterTest, any_filter_index_passes) {
+  ASSERT_TRUE(filter_.AddCondition(kFilterIndex, make_address(kOtherAddress)));
+  ASSERT_TRUE(filter_.SetParameters(kFilterIndex, make_parameter(feature(ApcfFilterType::BROADCASTER_ADDRESS))));
+  ASSERT_TRUE(filter_.AddCondition(kFilterIndex + 1, make_uuid(Uuid::From16Bit(0x180d))));
+  ASSERT_TRUE(filter_.SetParameters(kFilterIndex + 1, make_parameter(feature(ApcfFilterType::SERVICE_UUID))));
+  ASSERT_TRUE(Matches(kAddress));
+
+  filter_.DeleteParameters(kFilterIndex + 1);
+  ASSERT_FALSE(Matches(kAddress));
+  filter_.ClearParameters();
+  ASSERT_TRUE(Matches(kAddress));
+  ASSERT_EQ(HostAdvertisingFilter::kMaxConditions, filter_.GetAvailableConditions());
+}
+
+TEST_F(HostAdvertisingFilterTest, manufacturer_data_is_masked) {
+  ASSERT_TRUE(filter_.AddCondition(kFilterIndex, make_manufacturer_data(0x00e0, {0xaa, 0x00}, {0xff, 0x00})));
+  ASSERT_TRUE(filter_.SetParameters(kFilterIndex, make_parameter(feature(ApcfFilterType::MANUFACTURER_DATA))));
+  ASSERT_TRUE(Matches(kAddress));
+
+  filter_.ClearParameters();
+  ASSERT_TRUE(filter_.AddCondition(kFilterIndex, make_manufacturer_data(0x00e0, {0xab}, {})));
+  ASSERT_TRUE(filter_.SetParameters(kFilterIndex, make_parameter(feature(ApcfFilterType::MANUFACTURER_DATA))));
+  ASSERT_FALSE(Matches(kAddress));
+
+  ASSERT_FALSE(filter_.AddCondition(kFilterIndex, make_manufacturer_data(0x00e0, {0xaa}, {0xff, 0xff})));
+}
+
+TEST_F(HostAdvertisingFilterTest, rssi_threshold) {
+  ASSERT_TRUE(filter_.SetParameters(kFilterIndex, make_parameter(0, -60)));
+  ASSERT_TRUE(Matches(kAddress, -60));
+  ASSERT_FALSE(Matches(kAddress, -61));
+}
+
+TEST_F(HostAdvertisingFilterTest, malformed_data_is_not_read_past_its_end) {
+  ASSERT_TRUE(filter_.AddCondition(kFilterIndex, make_uuid(Uuid::From16Bit(0x180d))));
+  ASSERT_TRUE(filter_.SetParameters(kFilterIndex, make_parameter(feature(ApcfFilterType::SERVICE_UUID))));
+  ASSERT_FALSE(Matches(kAddress, -50, {0x02, 0x01, 0x06, 0x05, 0x03, 0x0d, 0x18}));
+}
+
+}  // namespace
+}  // namespace hci
+}  // namespace bluetooth
@@ -16,6 +16,9 @@
 
 #include "hci/le_address_manager.h"
 
+#include <iterator>
+#include <vector>
+
 #include "common/init_flags.h"
 #include "os/log.h"
 #include "os/rand.h"
@@ -230,11 +233,6 @@ void LeAddressManager::pause_registered_clients() {
   }
 }
 
-void LeAddressManager::push_command(Command command) {
-  pause_registered_clients();
-  cached_commands_.push(std::move(command));
-}
-
 void LeAddressManager::ack_pause(LeAddressManagerCallback* callback) {
   if (registered_clients_.find(callback) == registered_clients_.end()) {
     return;
@@ -278,7 +276,7 @@ void LeAddressManager::ack_resume(LeAddressManagerCallback* callback) {
 
 void LeAddressManager::prepare_to_rotate() {
   Command command = {CommandType::ROTATE_RANDOM_ADDRESS, RotateRandomAddressCommand{}};
-  cached_commands_.push(std::move(command));
+  cached_commands_.push_back(std::move(command));
   pause_registered_clients();
 }
 
@@ -319,7 +317,7 @@ void LeAddressManager::rotate_random_address() {
 
 void LeAddressManager::prepare_to_update_irk(UpdateIRKCommand update_irk_command) {
   Command command = {CommandType::UPDATE_IRK, update_irk_command};
-  cached_commands_.push(std::move(command));
+  cached_commands_.push_back(std::move(command));
   if (registered_clients_.empty()) {
     handle_next_command();
   } else {
@@ -415,7 +413,7 @@ void LeAddressManager::handle_next_command() {
 
   ASSERT(!cached_commands_.empty());
   auto command = std::move(cached_commands_.front());
-  cached_commands_.pop();
+  cached_commands_.pop_front();
 
   std::visit(
       [this](auto&& command) {
@@ -426,6 +424,8 @@ void LeAddressManager::handle_next_command() {
           rotate_random_address();
         } else if constexpr (std::is_same_v<T, HCICommand>) {
           enqueue_command_.Run(std::move(command.command));
+        } else if constexpr (std::is_same_v<T, UpdateListsCommand>) {
+          update_lists();
         } else {
           static_assert(!sizeof(T*), "non-exhaustive visitor!");
         }
@@ -435,9 +435,8 @@ void LeAddressManager::handle_next_command() {
 
 void LeAddressManager::AddDeviceToFilterAcceptList(
     FilterAcceptListAddressType connect_list_address_type, bluetooth::hci::Address address) {
-  auto packet_builder = hci::LeAddDeviceToFilterAcceptListBuilder::Create(connect_list_address_type, address);
-  Command command = {CommandType::ADD_DEVICE_TO_CONNECT_LIST, HCICommand{std::move(packet_builder)}};
-  handler_->BindOnceOn(this, &LeAddressManager::push_command, std::move(command)).Invoke();
+  handler_->BindOnceOn(this, &LeAddressManager::add_device_to_filter_accept_list, connect_list_address_type, address)
+      .Invoke();
 }
 
 void LeAddressManager::AddDeviceToResolvingList(
@@ -445,88 +444,186 @@ void LeAddressManager::AddDeviceToResolvingList(
     Address peer_identity_address,
     const std::array<uint8_t, 16>& peer_irk,
     const std::array<uint8_t, 16>& local_irk) {
-  // Disable Address resolution
-  auto disable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::DISABLED);
-  Command disable = {CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(disable_builder)}};
-  cached_commands_.push(std::move(disable));
+  handler_
+      ->BindOnceOn(
+          this,
+          &LeAddressManager::add_device_to_resolving_list,
+          peer_identity_address_type,
+          peer_identity_address,
+          peer_irk,
+          local_irk)
+      .Invoke();
+}
 
-  auto packet_builder = hci::LeAddDeviceToResolvingListBuilder::Create(
-      peer_identity_address_type, peer_identity_address, peer_irk, local_irk);
-  Command command = {CommandType::ADD_DEVICE_TO_RESOLVING_LIST, HCICommand{std::move(packet_builder)}};
-  cached_commands_.push(std::move(command));
+void LeAddressManager::RemoveDeviceFromFilterAcceptList(
+    FilterAcceptListAddressType connect_list_address_type, bluetooth::hci::Address address) {
+  handler_
+      ->BindOnceOn(this, &LeAddressManager::remove_device_from_filter_accept_list, connect_list_address_type, address)
+      .Invoke();
+}
 
-  if (supports_ble_privacy_) {
-    auto packet_builder =
-        hci::LeSetPrivacyModeBuilder::Create(peer_identity_address_type, peer_identity_address, PrivacyMode::DEVICE);
-    Command command = {CommandType::LE_SET_PRIVACY_MODE, HCICommand{std::move(packet_builder)}};
-    cached_commands_.push(std::move(command));
-  }
+void LeAddressManager::RemoveDeviceFromResolvingList(
+    PeerAddressType peer_identity_address_type, Address peer_identity_address) {
+  handler_
+      ->BindOnceOn(
+          this, &LeAddressManager::remove_device_from_resolving_list, peer_identity_address_type, peer_identity_address)
+      .Invoke();
+}
 
-  // Enable Address resolution
-  auto enable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::ENABLED);
-  Command enable = {CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(enable_builder)}};
-  cached_commands_.push(std::move(enable));
+void LeAddressManager::ClearFilterAcceptList() {
+  handler_->BindOnceOn(this, &LeAddressManager::clear_filter_accept_list).Invoke();
+}
 
-  if (registered_clients_.empty()) {
-    handler_->BindOnceOn(this, &LeAddressManager::handle_next_command).Invoke();
+void LeAddressManager::ClearResolvingList() {
+  handler_->BindOnceOn(this, &LeAddressManager::clear_resolving_list).Invoke();
+}
+
+// The clients only add the devices not in the filter accept list and only remove the ones in it, so that an add and
+// a remove of the same device cancel each other
+void LeAddressManager::add_device_to_filter_accept_list(
+    FilterAcceptListAddressType connect_list_address_type, Address address) {
+  auto key = std::make_pair(connect_list_address_type, address);
+  auto pending = pending_connect_list_.find(key);
+  if (pending != pending_connect_list_.end() && pending->second == ListOperation::REMOVE) {
+    pending_connect_list_.erase(pending);
   } else {
-    handler_->BindOnceOn(this, &LeAddressManager::pause_registered_clients).Invoke();
+    pending_connect_list_[key] = ListOperation::ADD;
   }
+  queue_list_update();
 }
 
-void LeAddressManager::RemoveDeviceFromFilterAcceptList(
-    FilterAcceptListAddressType connect_list_address_type, bluetooth::hci::Address address) {
-  auto packet_builder = hci::LeRemoveDeviceFromFilterAcceptListBuilder::Create(connect_list_address_type, address);
-  Command command = {CommandType::REMOVE_DEVICE_FROM_CONNECT_LIST, HCICommand{std::move(packet_builder)}};
-  handler_->BindOnceOn(this, &LeAddressManager::push_command, std::move(command)).Invoke();
+void LeAddressManager::remove_device_from_filter_accept_list(
+    FilterAcceptListAddressType connect_list_address_type, Address address) {
+  auto key = std::make_pair(connect_list_address_type, address);
+  auto pending = pending_connect_list_.find(key);
+  if (pending_clear_connect_list_ ||
+      (pending != pending_connect_list_.end() && pending->second == ListOperation::ADD)) {
+    pending_connect_list_.erase(key);
+  } else {
+    pending_connect_list_[key] = ListOperation::REMOVE;
+  }
+  queue_list_update();
 }
 
-void LeAddressManager::RemoveDeviceFromResolvingList(
-    PeerAddressType peer_identity_address_type, Address peer_identity_address) {
-  // Disable Address resolution
-  auto disable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::DISABLED);
-  Command disable = {CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(disable_builder)}};
-  cached_commands_.push(std::move(disable));
+void LeAddressManager::clear_filter_accept_list() {
+  pending_connect_list_.clear();
+  pending_clear_connect_list_ = true;
+  queue_list_update();
+}
 
-  auto packet_builder =
-      hci::LeRemoveDeviceFromResolvingListBuilder::Create(peer_identity_address_type, peer_identity_address);
-  Command command = {CommandType::REMOVE_DEVICE_FROM_RESOLVING_LIST, HCICommand{std::move(packet_builder)}};
-  cached_commands_.push(std::move(command));
+// Whether a device is in the resolving list is not known unless the list is cleared first: a device removed then added
+// again is replaced, to update its keys, and a removal is only dropped when the list is cleared first
+void LeAddressManager::add_device_to_resolving_list(
+    PeerAddressType peer_identity_address_type,
+    Address peer_identity_address,
+    std::array<uint8_t, 16> peer_irk,
+    std::array<uint8_t, 16> local_irk) {
+  auto key = std::make_pair(peer_identity_address_type, peer_identity_address);
+  auto pending = pending_resolving_list_.find(key);
+  ListOperation operation = ListOperation::ADD;
+  if (!pending_clear_resolving_list_ && pending != pending_resolving_list_.end() &&
+      pending->second.operation != ListOperation::ADD) {
+    operation = ListOperation::REPLACE;
+  }
+  pending_resolving_list_[key] = ResolvingListOperation{operation, peer_irk, local_irk};
+  queue_list_update();
+}
+
+void LeAddressManager::remove_device_from_resolving_list(
+    PeerAddressType peer_identity_address_type, Address peer_identity_address) {
+  auto key = std::make_pair(peer_identity_address_type, peer_identity_address);
+  if (pending_clear_resolving_list_) {
+    pending_resolving_list_.erase(key);
+  } else {
+    pending_resolving_list_[key] = ResolvingListOperation{ListOperation::REMOVE, {}, {}};
+  }
+  queue_list_update();
+}
 
-  // Enable Address resolution
-  auto enable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::ENABLED);
-  Command enable = {CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(enable_builder)}};
-  cached_commands_.push(std::move(enable));
+void LeAddressManager::clear_resolving_list() {
+  pending_resolving_list_.clear();
+  pending_clear_resolving_list_ = true;
+  queue_list_update();
+}
 
+// All the list operations made until the clients are paused are applied at once
+void LeAddressManager::queue_list_update() {
+  if (list_update_queued_) {
+    return;
+  }
+  list_update_queued_ = true;
+  Command command = {CommandType::UPDATE_LISTS, UpdateListsCommand{}};
+  cached_commands_.push_back(std::move(command));
   if (registered_clients_.empty()) {
     handler_->BindOnceOn(this, &LeAddressManager::handle_next_command).Invoke();
   } else {
-    handler_->BindOnceOn(this, &LeAddressManager::pause_registered_clients).Invoke();
+    pause_registered_clients();
   }
 }
 
-void LeAddressManager::ClearFilterAcceptList() {
-  auto packet_builder = hci::LeClearFilterAcceptListBuilder::Create();
-  Command command = {CommandType::CLEAR_CONNECT_LIST, HCICommand{std::move(packet_builder)}};
-  handler_->BindOnceOn(this, &LeAddressManager::push_command, std::move(command)).Invoke();
-}
+void LeAddressManager::update_lists() {
+  list_update_queued_ = false;
+  std::vector<Command> commands;
 
-void LeAddressManager::ClearResolvingList() {
-  // Disable Address resolution
-  auto disable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::DISABLED);
-  Command disable = {CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(disable_builder)}};
-  cached_commands_.push(std::move(disable));
+  if (pending_clear_connect_list_) {
+    auto packet_builder = hci::LeClearFilterAcceptListBuilder::Create();
+    commands.push_back({CommandType::CLEAR_CONNECT_LIST, HCICommand{std::move(packet_builder)}});
+  }
+  // Removing first makes room for the devices added
+  for (const auto& [key, operation] : pending_connect_list_) {
+    if (operation == ListOperation::REMOVE) {
+      auto packet_builder = hci::LeRemoveDeviceFromFilterAcceptListBuilder::Create(key.first, key.second);
+      commands.push_back({CommandType::REMOVE_DEVICE_FROM_CONNECT_LIST, HCICommand{std::move(packet_builder)}});
+    }
+  }
+  for (const auto& [key, operation] : pending_connect_list_) {
+    if (operation == ListOperation::ADD) {
+      auto packet_builder = hci::LeAddDeviceToFilterAcceptListBuilder::Create(key.first, key.second);
+      commands.push_back({CommandType::ADD_DEVICE_TO_CONNECT_LIST, HCICommand{std::move(packet_builder)}});
+    }
+  }
+
+  // The address resolution is disabled once around all the resolving list changes
+  if (pending_clear_resolving_list_ || !pending_resolving_list_.empty()) {
+    auto disable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::DISABLED);
+    commands.push_back({CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(disable_builder)}});
+
+    if (pending_clear_resolving_list_) {
+      auto packet_builder = hci::LeClearResolvingListBuilder::Create();
+      commands.push_back({CommandType::CLEAR_RESOLVING_LIST, HCICommand{std::move(packet_builder)}});
+    }
+    for (const auto& [key, pending] : pending_resolving_list_) {
+      if (pending.operation != ListOperation::ADD) {
+        auto packet_builder = hci::LeRemoveDeviceFromResolvingListBuilder::Create(key.first, key.second);
+        commands.push_back({CommandType::REMOVE_DEVICE_FROM_RESOLVING_LIST, HCICommand{std::move(packet_builder)}});
+      }
+    }
+    for (const auto& [key, pending] : pending_resolving_list_) {
+      if (pending.operation == ListOperation::REMOVE) {
+        continue;
+      }
+      auto packet_builder =
+          hci::LeAddDeviceToResolvingListBuilder::Create(key.first, key.second, pending.peer_irk, pending.local_irk);
+      commands.push_back({CommandType::ADD_DEVICE_TO_RESOLVING_LIST, HCICommand{std::move(packet_builder)}});
+      if (supports_ble_privacy_) {
+        auto privacy_builder = hci::LeSetPrivacyModeBuilder::Create(key.first, key.second, PrivacyMode::DEVICE);
+        commands.push_back({CommandType::LE_SET_PRIVACY_MODE, HCICommand{std::move(privacy_builder)}});
+      }
+    }
 
-  auto packet_builder = hci::LeClearResolvingListBuilder::Create();
-  Command command = {CommandType::CLEAR_RESOLVING_LIST, HCICommand{std::move(packet_builder)}};
-  cached_commands_.push(std::move(command));
+    auto enable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::ENABLED);
+    commands.push_back({CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(enable_builder)}});
+  }
 
-  // Enable Address resolution
-  auto enable_builder = hci::LeSetAddressResolutionEnableBuilder::Create(hci::Enable::ENABLED);
-  Command enable = {CommandType::SET_ADDRESS_RESOLUTION_ENABLE, HCICommand{std::move(enable_builder)}};
-  cached_commands_.push(std::move(enable));
+  pending_connect_list_.clear();
+  pending_clear_connect_list_ = false;
+  pending_resolving_list_.clear();
+  pending_clear_resolving_list_ = false;
 
-  handler_->BindOnceOn(this, &LeAddressManager::pause_registered_clients).Invoke();
+  LOG_INFO("Updating the filter accept list and resolving list with %zu commands", commands.size());
+  cached_commands_.insert(
+      cached_commands_.begin(), std::make_move_iterator(commands.begin()), std::make_move_iterator(commands.end()));
+  check_cached_commands();
 }
 
 template <class View>
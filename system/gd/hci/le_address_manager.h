@@ -15,6 +15,7 @@
  */
 #pragma once
 
+#include <deque>
 #include <map>
 #include <mutex>
 #include <set>
@@ -115,10 +116,14 @@ class LeAddressManager {
     SET_ADDRESS_RESOLUTION_ENABLE,
     LE_SET_PRIVACY_MODE,
     UPDATE_IRK,
+    UPDATE_LISTS,
   };
 
   struct RotateRandomAddressCommand {};
 
+  // Apply the net change of the pending filter accept list and resolving list operations
+  struct UpdateListsCommand {};
+
   struct UpdateIRKCommand {
     crypto_toolbox::Octet16 rotation_irk;
     std::chrono::milliseconds minimum_rotation_time;
@@ -131,11 +136,23 @@ class LeAddressManager {
 
   struct Command {
     CommandType command_type;  // Note that this field is only intended for logging, not control flow
-    std::variant<RotateRandomAddressCommand, UpdateIRKCommand, HCICommand> contents;
+    std::variant<RotateRandomAddressCommand, UpdateIRKCommand, HCICommand, UpdateListsCommand> contents;
+  };
+
+  enum ListOperation {
+    ADD,
+    REMOVE,
+    // Remove then add again, with new keys
+    REPLACE,
+  };
+
+  struct ResolvingListOperation {
+    ListOperation operation;
+    std::array<uint8_t, 16> peer_irk;
+    std::array<uint8_t, 16> local_irk;
   };
 
   void pause_registered_clients();
-  void push_command(Command command);
   void ack_pause(LeAddressManagerCallback* callback);
   void resume_registered_clients();
   void ack_resume(LeAddressManagerCallback* callback);
@@ -147,6 +164,18 @@ class LeAddressManager {
   void set_random_address();
   void prepare_to_update_irk(UpdateIRKCommand command);
   void update_irk(UpdateIRKCommand command);
+  void add_device_to_filter_accept_list(FilterAcceptListAddressType connect_list_address_type, Address address);
+  void remove_device_from_filter_accept_list(FilterAcceptListAddressType connect_list_address_type, Address address);
+  void clear_filter_accept_list();
+  void add_device_to_resolving_list(
+      PeerAddressType peer_identity_address_type,
+      Address peer_identity_address,
+      std::array<uint8_t, 16> peer_irk,
+      std::array<uint8_t, 16> local_irk);
+  void remove_device_from_resolving_list(PeerAddressType peer_identity_address_type, Address peer_identity_address);
+  void clear_resolving_list();
+  void queue_list_update();
+  void update_lists();
   hci::Address generate_rpa();
   hci::Address generate_nrpa();
   void handle_next_command();
@@ -168,7 +197,13 @@ class LeAddressManager {
   std::chrono::milliseconds maximum_rotation_time_;
   uint8_t connect_list_size_;
   uint8_t resolving_list_size_;
-  std::queue<Command> cached_commands_;
+  std::deque<Command> cached_commands_;
+  // The filter accept list and resolving list operations not sent yet, merged by device
+  std::map<std::pair<FilterAcceptListAddressType, Address>, ListOperation> pending_connect_list_;
+  bool pending_clear_connect_list_{false};
+  std::map<std::pair<PeerAddressType, Address>, ResolvingListOperation> pending_resolving_list_;
+  bool pending_clear_resolving_list_{false};
+  bool list_update_queued_{false};
   bool supports_ble_privacy_{false};
 };
 
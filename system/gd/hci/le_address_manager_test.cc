@@ -439,6 +439,82 @@ TEST_F(LeAddressManagerWithSingleClientTest, clear_resolving_list) {
   clients[0].get()->WaitForResume();
 }
 
+TEST_F(LeAddressManagerWithSingleClientTest, coalesce_connect_list_updates) {
+  Address address_1;
+  Address::FromString("01:02:03:04:05:01", address_1);
+  Address address_2;
+  Address::FromString("01:02:03:04:05:02", address_2);
+  Address address_3;
+  Address::FromString("01:02:03:04:05:03", address_3);
+
+  // Hold the handler so that all the updates are made before the client pauses
+  std::promise<void> promise;
+  auto future = promise.get_future();
+  handler_->Post(common::BindOnce(&std::future<void>::wait, common::Unretained(&future)));
+  test_hci_layer_->SetCommandFuture();
+  le_address_manager_->AddDeviceToFilterAcceptList(FilterAcceptListAddressType::RANDOM, address_1);
+  le_address_manager_->AddDeviceToFilterAcceptList(FilterAcceptListAddressType::RANDOM, address_2);
+  le_address_manager_->RemoveDeviceFromFilterAcceptList(FilterAcceptListAddressType::RANDOM, address_1);
+  le_address_manager_->AddDeviceToFilterAcceptList(FilterAcceptListAddressType::RANDOM, address_3);
+  promise.set_value();
+
+  // Only the net change is sent, in a single pause
+  auto packet = test_hci_layer_->GetCommand(OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST);
+  auto packet_view = LeAddDeviceToFilterAcceptListView::Create(
+      LeConnectionManagementCommandView::Create(AclCommandView::Create(packet)));
+  ASSERT_TRUE(packet_view.IsValid());
+  ASSERT_EQ(address_2, packet_view.GetAddress());
+  test_hci_layer_->SetCommandFuture();
+  test_hci_layer_->IncomingEvent(LeAddDeviceToFilterAcceptListCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+  EXPECT_TRUE(clients[0].get()->paused);
+
+  packet = test_hci_layer_->GetCommand(OpCode::LE_ADD_DEVICE_TO_FILTER_ACCEPT_LIST);
+  packet_view = LeAddDeviceToFilterAcceptListView::Create(
+      LeConnectionManagementCommandView::Create(AclCommandView::Create(packet)));
+  ASSERT_TRUE(packet_view.IsValid());
+  ASSERT_EQ(address_3, packet_view.GetAddress());
+  test_hci_layer_->IncomingEvent(LeAddDeviceToFilterAcceptListCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+  clients[0].get()->WaitForResume();
+}
+
+TEST_F(LeAddressManagerWithSingleClientTest, coalesce_resolving_list_updates) {
+  Address address_1;
+  Address::FromString("01:02:03:04:05:01", address_1);
+  Address address_2;
+  Address::FromString("01:02:03:04:05:02", address_2);
+  Octet16 peer_irk = {0xec, 0x02, 0x34, 0xa3, 0x57, 0xc8, 0xad, 0x05, 0x34, 0x10, 0x10, 0xa6, 0x0a, 0x39, 0x7d, 0x9b};
+  Octet16 local_irk = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10};
+
+  std::promise<void> promise;
+  auto future = promise.get_future();
+  handler_->Post(common::BindOnce(&std::future<void>::wait, common::Unretained(&future)));
+  test_hci_layer_->SetCommandFuture();
+  le_address_manager_->ClearResolvingList();
+  le_address_manager_->AddDeviceToResolvingList(
+      PeerAddressType::RANDOM_DEVICE_OR_IDENTITY_ADDRESS, address_1, peer_irk, local_irk);
+  le_address_manager_->AddDeviceToResolvingList(
+      PeerAddressType::RANDOM_DEVICE_OR_IDENTITY_ADDRESS, address_2, peer_irk, local_irk);
+  le_address_manager_->RemoveDeviceFromResolvingList(PeerAddressType::RANDOM_DEVICE_OR_IDENTITY_ADDRESS, address_1);
+  promise.set_value();
+
+  // The address resolution is only disabled once
+  test_hci_layer_->GetCommand(OpCode::LE_SET_ADDRESS_RESOLUTION_ENABLE);
+  test_hci_layer_->SetCommandFuture();
+  test_hci_layer_->IncomingEvent(LeSetAddressResolutionEnableCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+  test_hci_layer_->GetCommand(OpCode::LE_CLEAR_RESOLVING_LIST);
+  test_hci_layer_->SetCommandFuture();
+  test_hci_layer_->IncomingEvent(LeClearResolvingListCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+  auto packet = test_hci_layer_->GetCommand(OpCode::LE_ADD_DEVICE_TO_RESOLVING_LIST);
+  auto packet_view = LeAddDeviceToResolvingListView::Create(LeSecurityCommandView::Create(packet));
+  ASSERT_TRUE(packet_view.IsValid());
+  ASSERT_EQ(address_2, packet_view.GetPeerIdentityAddress());
+  test_hci_layer_->SetCommandFuture();
+  test_hci_layer_->IncomingEvent(LeAddDeviceToResolvingListCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+  test_hci_layer_->GetCommand(OpCode::LE_SET_ADDRESS_RESOLUTION_ENABLE);
+  test_hci_layer_->IncomingEvent(LeSetAddressResolutionEnableCompleteBuilder::Create(0x01, ErrorCode::SUCCESS));
+  clients[0].get()->WaitForResume();
+}
+
 TEST_F(LeAddressManagerWithSingleClientTest, register_during_command_complete) {
   Address address;
   Address::FromString("01:02:03:04:05:06", address);
@@ -925,6 +925,65 @@ struct LeAdvertisingManager::impl : public bluetooth::hci::LeAddressManagerCallb
     }
   }
 
+  // Enable several advertising sets, in a single command with the extended advertising API
+  void enable_advertisers(std::vector<EnabledSet> enabled_sets) {
+    if (advertising_api_type_ != AdvertisingApiType::EXTENDED) {
+      for (const auto& enabled_set : enabled_sets) {
+        enable_advertiser(
+            enabled_set.advertising_handle_,
+            true,
+            enabled_set.duration_,
+            enabled_set.max_extended_advertising_events_);
+      }
+      return;
+    }
+
+    le_advertising_interface_->EnqueueCommand(
+        hci::LeSetExtendedAdvertisingEnableBuilder::Create(Enable::ENABLED, enabled_sets),
+        module_handler_->BindOnceOn(
+            this,
+            &impl::on_set_extended_advertising_enable_complete<LeSetExtendedAdvertisingEnableCompleteView>,
+            true,
+            enabled_sets));
+
+    for (const auto& enabled_set : enabled_sets) {
+      AdvertiserId advertiser_id = enabled_set.advertising_handle_;
+      enabled_sets_[advertiser_id].advertising_handle_ = advertiser_id;
+      advertising_sets_[advertiser_id].duration = enabled_set.duration_;
+      advertising_sets_[advertiser_id].max_extended_advertising_events = enabled_set.max_extended_advertising_events_;
+    }
+  }
+
+  void update_advertising_sets(std::vector<AdvertisingSetUpdate> updates) {
+    std::vector<EnabledSet> enabled_sets;
+    for (auto& update : updates) {
+      AdvertiserId advertiser_id = update.advertiser_id;
+      if (advertising_sets_.find(advertiser_id) == advertising_sets_.end()) {
+        LOG_WARN("Unknown advertiser %d", advertiser_id);
+        continue;
+      }
+      if (update.advertisement) {
+        set_data(advertiser_id, false, std::move(*update.advertisement));
+      }
+      if (update.scan_response) {
+        set_data(advertiser_id, true, std::move(*update.scan_response));
+      }
+      if (update.periodic_data) {
+        set_periodic_data(advertiser_id, std::move(*update.periodic_data));
+      }
+      if (update.enable) {
+        EnabledSet enabled_set;
+        enabled_set.advertising_handle_ = advertiser_id;
+        enabled_set.duration_ = update.duration;
+        enabled_set.max_extended_advertising_events_ = update.max_extended_advertising_events;
+        enabled_sets.push_back(enabled_set);
+      }
+    }
+    if (!enabled_sets.empty()) {
+      enable_advertisers(std::move(enabled_sets));
+    }
+  }
+
   void set_periodic_parameter(
       AdvertiserId advertiser_id, PeriodicAdvertisingParameters periodic_advertising_parameters) {
     uint8_t include_tx_power = periodic_advertising_parameters.properties >>
@@ -1568,6 +1627,10 @@ void LeAdvertisingManager::EnablePeriodicAdvertising(AdvertiserId advertiser_id,
   CallOn(pimpl_.get(), &impl::enable_periodic_advertising, advertiser_id, enable);
 }
 
+void LeAdvertisingManager::UpdateAdvertisingSets(std::vector<AdvertisingSetUpdate> updates) {
+  CallOn(pimpl_.get(), &impl::update_advertising_sets, std::move(updates));
+}
+
 void LeAdvertisingManager::RemoveAdvertiser(AdvertiserId advertiser_id) {
   CallOn(pimpl_.get(), &impl::remove_advertiser, advertiser_id);
 }
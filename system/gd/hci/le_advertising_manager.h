@@ -16,6 +16,8 @@
 #pragma once
 
 #include <memory>
+#include <optional>
+#include <vector>
 
 #include "common/callback.h"
 #include "hci/address_with_type.h"
@@ -70,6 +72,19 @@ class ExtendedAdvertisingConfig : public AdvertisingConfig {
 
 using AdvertiserId = uint8_t;
 
+// Update of an advertising set in a bulk update, only the data given is set
+class AdvertisingSetUpdate {
+ public:
+  AdvertiserId advertiser_id;
+  std::optional<std::vector<GapData>> advertisement;
+  std::optional<std::vector<GapData>> scan_response;
+  std::optional<std::vector<GapData>> periodic_data;
+  // Enable the set once its data is set
+  bool enable = false;
+  uint16_t duration = 0;
+  uint8_t max_extended_advertising_events = 0;
+};
+
 class AdvertisingCallback {
  public:
   enum AdvertisingStatus {
@@ -143,6 +158,10 @@ class LeAdvertisingManager : public bluetooth::Module {
 
   void EnablePeriodicAdvertising(AdvertiserId advertiser_id, bool enable);
 
+  // Set the data of several advertising sets at once, their commands being queued back to back, then enable the sets
+  // in a single command with the extended advertising API
+  void UpdateAdvertisingSets(std::vector<AdvertisingSetUpdate> updates);
+
   void RemoveAdvertiser(AdvertiserId advertiser_id);
 
   void RegisterAdvertisingCallback(AdvertisingCallback* advertising_callback);
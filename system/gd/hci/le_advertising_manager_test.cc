@@ -539,8 +539,10 @@ class LeExtendedAdvertisingAPITest : public LeExtendedAdvertisingManagerTest {
  protected:
   void SetUp() override {
     LeExtendedAdvertisingManagerTest::SetUp();
+    advertiser_id_ = start_advertising_set(0x00);
+  }
 
-    // start advertising set
+  AdvertiserId start_advertising_set(int reg_id) {
     ExtendedAdvertisingConfig advertising_config{};
     advertising_config.advertising_type = AdvertisingType::ADV_IND;
     advertising_config.own_address_type = OwnAddressType::PUBLIC_DEVICE_ADDRESS;
@@ -558,12 +560,12 @@ class LeExtendedAdvertisingAPITest : public LeExtendedAdvertisingManagerTest {
     advertising_config.sid = 0x01;
 
     test_hci_layer_->SetCommandFuture(4);
-    advertiser_id_ = le_advertising_manager_->ExtendedCreateAdvertiser(
-        0x00, advertising_config, scan_callback, set_terminated_callback, 0, 0, client_handler_);
-    ASSERT_NE(LeAdvertisingManager::kInvalidId, advertiser_id_);
+    auto advertiser_id = le_advertising_manager_->ExtendedCreateAdvertiser(
+        reg_id, advertising_config, scan_callback, set_terminated_callback, 0, 0, client_handler_);
+    EXPECT_NE(LeAdvertisingManager::kInvalidId, advertiser_id);
     EXPECT_CALL(
         mock_advertising_callback_,
-        OnAdvertisingSetStarted(0x00, advertiser_id_, -23, AdvertisingCallback::AdvertisingStatus::SUCCESS));
+        OnAdvertisingSetStarted(reg_id, advertiser_id, -23, AdvertisingCallback::AdvertisingStatus::SUCCESS));
     std::vector<OpCode> adv_opcodes = {
         OpCode::LE_SET_EXTENDED_ADVERTISING_PARAMETERS,
         OpCode::LE_SET_EXTENDED_SCAN_RESPONSE_DATA,
@@ -572,7 +574,7 @@ class LeExtendedAdvertisingAPITest : public LeExtendedAdvertisingManagerTest {
     };
     std::vector<uint8_t> success_vector{static_cast<uint8_t>(ErrorCode::SUCCESS)};
     for (size_t i = 0; i < adv_opcodes.size(); i++) {
-      ASSERT_EQ(adv_opcodes[i], test_hci_layer_->GetCommand().GetOpCode());
+      EXPECT_EQ(adv_opcodes[i], test_hci_layer_->GetCommand().GetOpCode());
       if (adv_opcodes[i] == OpCode::LE_SET_EXTENDED_ADVERTISING_PARAMETERS) {
         test_hci_layer_->IncomingEvent(LeSetExtendedAdvertisingParametersCompleteBuilder::Create(
             uint8_t{1}, ErrorCode::SUCCESS, static_cast<uint8_t>(-23)));
@@ -582,6 +584,7 @@ class LeExtendedAdvertisingAPITest : public LeExtendedAdvertisingManagerTest {
       }
     }
     sync_client_handler();
+    return advertiser_id;
   }
 
   AdvertiserId advertiser_id_;
@@ -1093,6 +1096,55 @@ TEST_F(LeExtendedAdvertisingAPITest, disable_enable_advertiser_test) {
   test_hci_layer_->IncomingEvent(LeSetExtendedAdvertisingEnableCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
 }
 
+TEST_F(LeExtendedAdvertisingAPITest, update_advertising_sets_test) {
+  auto second_advertiser_id = start_advertising_set(0x01);
+  ASSERT_NE(LeAdvertisingManager::kInvalidId, second_advertiser_id);
+
+  std::vector<GapData> gap_data{};
+  GapData data_item{};
+  data_item.data_type_ = GapDataType::COMPLETE_LOCAL_NAME;
+  data_item.data_ = {'t', 'e', 's', 't', ' ', 'd', 'e', 'v', 'i', 'c', 'e'};
+  gap_data.push_back(data_item);
+  std::vector<AdvertisingSetUpdate> updates(2);
+  updates[0].advertiser_id = advertiser_id_;
+  updates[0].advertisement = gap_data;
+  updates[0].enable = true;
+  updates[1].advertiser_id = second_advertiser_id;
+  updates[1].scan_response = gap_data;
+  updates[1].enable = true;
+  test_hci_layer_->SetCommandFuture(3);
+  le_advertising_manager_->UpdateAdvertisingSets(updates);
+  ASSERT_EQ(OpCode::LE_SET_EXTENDED_ADVERTISING_DATA, test_hci_layer_->GetCommand().GetOpCode());
+  ASSERT_EQ(OpCode::LE_SET_EXTENDED_SCAN_RESPONSE_DATA, test_hci_layer_->GetCommand().GetOpCode());
+
+  // Both sets are enabled at once
+  auto packet = test_hci_layer_->GetCommand();
+  auto enable_view = LeSetExtendedAdvertisingEnableView::Create(LeAdvertisingCommandView::Create(packet));
+  ASSERT_TRUE(enable_view.IsValid());
+  ASSERT_EQ(Enable::ENABLED, enable_view.GetEnable());
+  auto enabled_sets = enable_view.GetEnabledSets();
+  ASSERT_EQ(2u, enabled_sets.size());
+  ASSERT_EQ(advertiser_id_, enabled_sets[0].advertising_handle_);
+  ASSERT_EQ(second_advertiser_id, enabled_sets[1].advertising_handle_);
+
+  EXPECT_CALL(
+      mock_advertising_callback_,
+      OnAdvertisingDataSet(advertiser_id_, AdvertisingCallback::AdvertisingStatus::SUCCESS));
+  EXPECT_CALL(
+      mock_advertising_callback_,
+      OnScanResponseDataSet(second_advertiser_id, AdvertisingCallback::AdvertisingStatus::SUCCESS));
+  EXPECT_CALL(
+      mock_advertising_callback_,
+      OnAdvertisingEnabled(advertiser_id_, true, AdvertisingCallback::AdvertisingStatus::SUCCESS));
+  EXPECT_CALL(
+      mock_advertising_callback_,
+      OnAdvertisingEnabled(second_advertiser_id, true, AdvertisingCallback::AdvertisingStatus::SUCCESS));
+  test_hci_layer_->IncomingEvent(LeSetExtendedAdvertisingDataCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
+  test_hci_layer_->IncomingEvent(LeSetExtendedScanResponseDataCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
+  test_hci_layer_->IncomingEvent(LeSetExtendedAdvertisingEnableCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
+  sync_client_handler();
+}
+
 TEST_F(LeExtendedAdvertisingAPITest, set_periodic_parameter) {
   PeriodicAdvertisingParameters advertising_config{};
   advertising_config.max_interval = 0x1000;
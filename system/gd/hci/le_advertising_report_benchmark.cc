@@ -0,0 +1,149 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "hci/advertising_report_deduplicator.h"
+#include "hci/hci_packets.h"
+#include "hci/le_advertising_report_parser.h"
+#include "packet/packet_view.h"
+
+using ::benchmark::State;
+
+namespace bluetooth {
+namespace hci {
+
+// A synthetic scan storm: kAdvertisers legacy advertisers with full 31 byte payloads, each advertising event
+// reported once per primary advertising channel.
+constexpr size_t kAdvertisers = 200;
+constexpr size_t kChannels = 3;
+constexpr size_t kDataLength = 31;
+// Time between two reports in the trace.
+constexpr std::chrono::microseconds kReportSpacing(50);
+
+class BM_LeAdvertisingReport : public ::benchmark::Fixture {
+ protected:
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    trace_.clear();
+    for (size_t advertiser = 0; advertiser < kAdvertisers; advertiser++) {
+      auto event = BuildEvent(advertiser);
+      for (size_t channel = 0; channel < kChannels; channel++) {
+        trace_.push_back(event);
+      }
+    }
+  }
+
+  static std::vector<uint8_t> BuildEvent(size_t advertiser) {
+    std::vector<uint8_t> event = {
+        static_cast<uint8_t>(EventCode::LE_META_EVENT),
+        static_cast<uint8_t>(12 + kDataLength),
+        static_cast<uint8_t>(SubeventCode::ADVERTISING_REPORT),
+        0x01,
+        static_cast<uint8_t>(AdvertisingEventType::ADV_IND),
+        0x01,
+        static_cast<uint8_t>(advertiser),
+        static_cast<uint8_t>(advertiser >> 8),
+        0x00,
+        0x00,
+        0x00,
+        0xc0,
+        static_cast<uint8_t>(kDataLength),
+    };
+    // Flags, then manufacturer specific data filling the rest of the payload.
+    event.insert(event.end(), {0x02, 0x01, 0x06, static_cast<uint8_t>(kDataLength - 4), 0xff});
+    for (size_t i = 5; i < kDataLength; i++) {
+      event.push_back(static_cast<uint8_t>(advertiser + i));
+    }
+    event.push_back(0xc4);
+    return event;
+  }
+
+  std::vector<std::vector<uint8_t>> trace_;
+};
+
+BENCHMARK_DEFINE_F(BM_LeAdvertisingReport, pdl_views)(State& state) {
+  size_t delivered = 0;
+  for (auto _ : state) {
+    for (const auto& event : trace_) {
+      auto bytes = std::make_shared<std::vector<uint8_t>>(event);
+      auto view = LeAdvertisingReportView::Create(
+          LeMetaEventView::Create(EventView::Create(packet::PacketView<packet::kLittleEndian>(bytes))));
+      if (!view.IsValid()) {
+        continue;
+      }
+      for (const auto& report : view.GetResponses()) {
+        std::vector<uint8_t> significant_data;
+        for (const auto& datum : report.advertising_data_) {
+          if (!datum.data_.empty()) {
+            significant_data.push_back(static_cast<uint8_t>(datum.data_.size()));
+            significant_data.insert(significant_data.end(), datum.data_.begin(), datum.data_.end());
+          }
+        }
+        ::benchmark::DoNotOptimize(significant_data.data());
+        delivered++;
+      }
+    }
+  }
+  state.counters["delivered_per_trace"] = ::benchmark::Counter(delivered, ::benchmark::Counter::kAvgIterations);
+  state.SetItemsProcessed(state.iterations() * trace_.size());
+}
+BENCHMARK_REGISTER_F(BM_LeAdvertisingReport, pdl_views);
+
+BENCHMARK_DEFINE_F(BM_LeAdvertisingReport, in_place_with_deduplication)(State& state) {
+  AdvertisingReportDeduplicator deduplicator(std::chrono::milliseconds(100));
+  auto now = AdvertisingReportDeduplicator::Clock::now();
+  size_t delivered = 0;
+  for (auto _ : state) {
+    // Each pass over the trace starts a new window, as a real storm would after an advertising interval.
+    now += std::chrono::milliseconds(100);
+    auto report_time = now;
+    for (const auto& event : trace_) {
+      report_time += kReportSpacing;
+      LeAdvertisingReportParser parser(LeAdvertisingReportParser::Format::LEGACY, event.data(), event.size());
+      if (!parser.IsValid()) {
+        continue;
+      }
+      RawAdvertisingReport report;
+      while (parser.Next(&report)) {
+        if (deduplicator.IsDuplicate(
+                report.address,
+                report.address_type,
+                report.advertising_sid,
+                report.event_type,
+                report.data,
+                report.data_length,
+                report_time)) {
+          continue;
+        }
+        auto significant_data = LeAdvertisingReportParser::GetSignificantData(report.data, report.data_length);
+        ::benchmark::DoNotOptimize(significant_data.data());
+        delivered++;
+      }
+    }
+  }
+  state.counters["delivered_per_trace"] = ::benchmark::Counter(delivered, ::benchmark::Counter::kAvgIterations);
+  state.counters["duplicates_per_trace"] =
+      ::benchmark::Counter(deduplicator.GetDuplicateCount(), ::benchmark::Counter::kAvgIterations);
+  state.SetItemsProcessed(state.iterations() * trace_.size());
+}
+BENCHMARK_REGISTER_F(BM_LeAdvertisingReport, in_place_with_deduplication);
+
+}  // namespace hci
+}  // namespace bluetooth
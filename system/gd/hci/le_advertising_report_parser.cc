@@ -0,0 +1,168 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/le_advertising_report_parser.h"
+
+#include <cstring>
+
+#include "hci/hci_packets.h"
+#include "hci/le_scanning_manager.h"
+
+namespace bluetooth {
+namespace hci {
+
+namespace {
+
+constexpr size_t kLegacyReportHeaderSize = 10;
+constexpr size_t kExtendedReportHeaderSize = 24;
+
+// Extended event type bits (Core 5.3, Vol 4, Part E, 7.7.65.13), the two data status bits start at bit 5.
+constexpr uint16_t kConnectable = 1 << 0;
+constexpr uint16_t kScannable = 1 << 1;
+constexpr uint16_t kDirected = 1 << 2;
+constexpr uint16_t kScanResponse = 1 << 3;
+constexpr uint16_t kLegacy = 1 << 4;
+constexpr uint16_t kExtendedEventTypeMask = 0x7f;
+
+uint16_t extract_uint16(const uint8_t* bytes) {
+  return static_cast<uint16_t>(bytes[0] | (bytes[1] << 8));
+}
+
+}  // namespace
+
+LeAdvertisingReportParser::LeAdvertisingReportParser(Format format, const uint8_t* event, size_t length)
+    : format_(format), event_(event), length_(length), offset_(kLeMetaEventHeaderSize + 1) {}
+
+size_t LeAdvertisingReportParser::GetReportHeaderSize() const {
+  return format_ == Format::LEGACY ? kLegacyReportHeaderSize : kExtendedReportHeaderSize;
+}
+
+bool LeAdvertisingReportParser::IsValid() {
+  if (validated_) {
+    return valid_;
+  }
+  validated_ = true;
+  if (length_ <= kLeMetaEventHeaderSize) {
+    return false;
+  }
+  size_t header_size = GetReportHeaderSize();
+  // Offset of the data length within a report.
+  size_t data_length_offset = header_size - (format_ == Format::LEGACY ? 2 : 1);
+  size_t offset = kLeMetaEventHeaderSize + 1;
+  for (uint8_t i = 0; i < GetNumReports(); i++) {
+    if (offset + header_size > length_) {
+      return false;
+    }
+    offset += header_size + event_[offset + data_length_offset];
+    if (offset > length_) {
+      return false;
+    }
+  }
+  valid_ = true;
+  remaining_reports_ = GetNumReports();
+  return true;
+}
+
+uint8_t LeAdvertisingReportParser::GetNumReports() const {
+  return length_ > kLeMetaEventHeaderSize ? event_[kLeMetaEventHeaderSize] : 0;
+}
+
+bool LeAdvertisingReportParser::Next(RawAdvertisingReport* report) {
+  if (!IsValid() || remaining_reports_ == 0) {
+    return false;
+  }
+  const uint8_t* raw_report = event_ + offset_;
+  if (format_ == Format::LEGACY) {
+    if (!ParseLegacyReport(raw_report, report)) {
+      remaining_reports_ = 0;
+      return false;
+    }
+  } else {
+    ParseExtendedReport(raw_report, report);
+  }
+  offset_ += GetReportHeaderSize() + report->data_length;
+  remaining_reports_--;
+  return true;
+}
+
+bool LeAdvertisingReportParser::ParseLegacyReport(const uint8_t* report, RawAdvertisingReport* to_fill) const {
+  switch (static_cast<AdvertisingEventType>(report[0])) {
+    case AdvertisingEventType::ADV_IND:
+      to_fill->event_type = kConnectable | kScannable | kLegacy;
+      break;
+    case AdvertisingEventType::ADV_DIRECT_IND:
+      to_fill->event_type = kConnectable | kDirected | kLegacy;
+      break;
+    case AdvertisingEventType::ADV_SCAN_IND:
+      to_fill->event_type = kScannable | kLegacy;
+      break;
+    case AdvertisingEventType::ADV_NONCONN_IND:
+      to_fill->event_type = kLegacy;
+      break;
+    case AdvertisingEventType::SCAN_RESPONSE:
+      to_fill->event_type = kConnectable | kScannable | kScanResponse | kLegacy;
+      break;
+    default:
+      return false;
+  }
+  to_fill->address_type = report[1];
+  std::memcpy(to_fill->address.address.data(), report + 2, Address::kLength);
+  to_fill->data_length = report[8];
+  to_fill->data = report + 9;
+  to_fill->rssi = static_cast<int8_t>(report[9 + to_fill->data_length]);
+  to_fill->primary_phy = static_cast<uint8_t>(PrimaryPhyType::LE_1M);
+  to_fill->secondary_phy = static_cast<uint8_t>(SecondaryPhyType::NO_PACKETS);
+  to_fill->advertising_sid = LeScanningManager::kAdvertisingDataInfoNotPresent;
+  to_fill->tx_power = LeScanningManager::kTxPowerInformationNotPresent;
+  to_fill->periodic_advertising_interval = LeScanningManager::kNotPeriodicAdvertisement;
+  return true;
+}
+
+void LeAdvertisingReportParser::ParseExtendedReport(const uint8_t* report, RawAdvertisingReport* to_fill) const {
+  to_fill->event_type = extract_uint16(report) & kExtendedEventTypeMask;
+  to_fill->address_type = report[2];
+  std::memcpy(to_fill->address.address.data(), report + 3, Address::kLength);
+  to_fill->primary_phy = report[9];
+  to_fill->secondary_phy = report[10];
+  to_fill->advertising_sid = report[11];
+  to_fill->tx_power = static_cast<int8_t>(report[12]);
+  to_fill->rssi = static_cast<int8_t>(report[13]);
+  to_fill->periodic_advertising_interval = extract_uint16(report + 14);
+  // Direct address type and direct address (7 bytes) are not reported to the scanning callbacks.
+  to_fill->data_length = report[23];
+  to_fill->data = report + kExtendedReportHeaderSize;
+}
+
+std::vector<uint8_t> LeAdvertisingReportParser::GetSignificantData(const uint8_t* data, size_t length) {
+  std::vector<uint8_t> significant_data;
+  significant_data.reserve(length);
+  size_t offset = 0;
+  while (offset < length) {
+    size_t field_length = data[offset];
+    if (offset + 1 + field_length > length) {
+      // Truncated AD structure
+      break;
+    }
+    if (field_length != 0) {
+      significant_data.insert(significant_data.end(), data + offset, data + offset + 1 + field_length);
+    }
+    offset += 1 + field_length;
+  }
+  return significant_data;
+}
+
+}  // namespace hci
+}  // namespace bluetooth
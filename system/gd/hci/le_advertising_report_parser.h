@@ -0,0 +1,86 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "hci/address.h"
+
+namespace bluetooth {
+namespace hci {
+
+// One report from an LE Advertising Report or LE Extended Advertising Report event. |data| points into the event
+// buffer, so a report is only valid while that buffer is.
+struct RawAdvertisingReport {
+  // Extended advertising event type bits, legacy PDU types are converted.
+  uint16_t event_type;
+  uint8_t address_type;
+  Address address;
+  uint8_t primary_phy;
+  uint8_t secondary_phy;
+  uint8_t advertising_sid;
+  int8_t tx_power;
+  int8_t rssi;
+  uint16_t periodic_advertising_interval;
+  const uint8_t* data;
+  uint8_t data_length;
+};
+
+// Walks the reports of an advertising report event in place, without building PDL views or copying anything.
+class LeAdvertisingReportParser {
+ public:
+  enum class Format { LEGACY, EXTENDED };
+
+  // Size of the event code, parameter length and subevent code in front of the reports.
+  static constexpr size_t kLeMetaEventHeaderSize = 3;
+
+  // |event| holds the whole LE Meta event, starting with the event code.
+  LeAdvertisingReportParser(Format format, const uint8_t* event, size_t length);
+
+  // Check every report header and length. Reports are only returned by Next() for valid events.
+  bool IsValid();
+
+  uint8_t GetNumReports() const;
+
+  // Fill |report| with the next report. Return false once all of them were returned, or if the event is invalid or
+  // contains a legacy PDU type that can't be converted.
+  bool Next(RawAdvertisingReport* report);
+
+  // The advertising data with zero length AD structures removed, as handed to the scanning callbacks.
+  static std::vector<uint8_t> GetSignificantData(const uint8_t* data, size_t length);
+
+ private:
+  // Size of a report without its advertising data.
+  size_t GetReportHeaderSize() const;
+
+  bool ParseLegacyReport(const uint8_t* report, RawAdvertisingReport* to_fill) const;
+
+  void ParseExtendedReport(const uint8_t* report, RawAdvertisingReport* to_fill) const;
+
+  Format format_;
+  const uint8_t* event_;
+  size_t length_;
+  size_t offset_;
+  uint8_t remaining_reports_{0};
+  bool validated_{false};
+  bool valid_{false};
+};
+
+}  // namespace hci
+}  // namespace bluetooth
@@ -0,0 +1,137 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hci/le_advertising_report_parser.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace bluetooth {
+namespace hci {
+namespace {
+
+using Format = LeAdvertisingReportParser::Format;
+
+// LE Meta event with two legacy reports: ADV_IND from 11:22:33:44:55:66 and SCAN_RESPONSE from 01:02:03:04:05:06.
+const std::vector<uint8_t> kLegacyEvent = {
+    0x3e, 0x1c, 0x02, 0x02,                                                  // header, two reports
+    0x00, 0x00, 0x66, 0x55, 0x44, 0x33, 0x22, 0x11, 0x05,                    // ADV_IND, public
+    0x02, 0x01, 0x06, 0x00, 0x00,                                            // flags and an empty AD structure
+    0xc4,                                                                    // rssi -60
+    0x04, 0x01, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01, 0x01, 0x00, 0xb0,        // SCAN_RESPONSE, one empty AD structure
+};
+
+// LE Meta event with one extended report carrying a complete name.
+const std::vector<uint8_t> kExtendedEvent = {
+    0x3e, 0x1e, 0x0d, 0x01,                          // header, one report
+    0x13, 0x00,                                      // connectable, scannable, legacy, complete
+    0x01,                                            // random
+    0x06, 0x05, 0x04, 0x03, 0x02, 0xc1,              // address
+    0x01, 0x02, 0x03,                                // 1M, 2M, sid 3
+    0x7f, 0xd8,                                      // tx power not present, rssi -40
+    0x20, 0x00,                                      // periodic advertising interval
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,        // direct address
+    0x04, 0x03, 0x09, 'a', 'b',                      // complete local name
+};
+
+TEST(LeAdvertisingReportParserTest, legacy_reports) {
+  LeAdvertisingReportParser parser(Format::LEGACY, kLegacyEvent.data(), kLegacyEvent.size());
+  ASSERT_TRUE(parser.IsValid());
+  ASSERT_EQ(2, parser.GetNumReports());
+
+  RawAdvertisingReport report;
+  ASSERT_TRUE(parser.Next(&report));
+  ASSERT_EQ(0x13, report.event_type);
+  ASSERT_EQ(0, report.address_type);
+  ASSERT_EQ(Address({0x66, 0x55, 0x44, 0x33, 0x22, 0x11}), report.address);
+  ASSERT_EQ(-60, report.rssi);
+  ASSERT_EQ(5, report.data_length);
+  ASSERT_EQ(kLegacyEvent.data() + 13, report.data);
+
+  ASSERT_TRUE(parser.Next(&report));
+  ASSERT_EQ(0x1b, report.event_type);
+  ASSERT_EQ(1, report.address_type);
+  ASSERT_EQ(Address({0x06, 0x05, 0x04, 0x03, 0x02, 0x01}), report.address);
+  ASSERT_EQ(1, report.data_length);
+  ASSERT_EQ(-80, report.rssi);
+
+  ASSERT_FALSE(parser.Next(&report));
+}
+
+TEST(LeAdvertisingReportParserTest, extended_report) {
+  LeAdvertisingReportParser parser(Format::EXTENDED, kExtendedEvent.data(), kExtendedEvent.size());
+  ASSERT_TRUE(parser.IsValid());
+  ASSERT_EQ(1, parser.GetNumReports());
+
+  RawAdvertisingReport report;
+  ASSERT_TRUE(parser.Next(&report));
+  ASSERT_EQ(0x13, report.event_type);
+  ASSERT_EQ(1, report.address_type);
+  ASSERT_EQ(Address({0x06, 0x05, 0x04, 0x03, 0x02, 0xc1}), report.address);
+  ASSERT_EQ(1, report.primary_phy);
+  ASSERT_EQ(2, report.secondary_phy);
+  ASSERT_EQ(3, report.advertising_sid);
+  ASSERT_EQ(0x7f, report.tx_power);
+  ASSERT_EQ(-40, report.rssi);
+  ASSERT_EQ(0x20, report.periodic_advertising_interval);
+  ASSERT_EQ(4, report.data_length);
+  ASSERT_EQ(std::vector<uint8_t>({0x03, 0x09, 'a', 'b'}), std::vector<uint8_t>(report.data, report.data + 4));
+
+  ASSERT_FALSE(parser.Next(&report));
+}
+
+TEST(LeAdvertisingReportParserTest, truncated_events_are_invalid) {
+  for (size_t length = 0; length < kLegacyEvent.size(); length++) {
+    LeAdvertisingReportParser parser(Format::LEGACY, kLegacyEvent.data(), length);
+    ASSERT_FALSE(parser.IsValid()) << "length " << length;
+    RawAdvertisingReport report;
+    ASSERT_FALSE(parser.Next(&report));
+  }
+  for (size_t length = 0; length < kExtendedEvent.size(); length++) {
+    LeAdvertisingReportParser parser(Format::EXTENDED, kExtendedEvent.data(), length);
+    ASSERT_FALSE(parser.IsValid()) << "length " << length;
+  }
+}
+
+TEST(LeAdvertisingReportParserTest, data_length_past_end_is_invalid) {
+  auto event = kExtendedEvent;
+  event[27] = 5;
+  LeAdvertisingReportParser parser(Format::EXTENDED, event.data(), event.size());
+  ASSERT_FALSE(parser.IsValid());
+}
+
+TEST(LeAdvertisingReportParserTest, unknown_legacy_event_type_stops_parsing) {
+  auto event = kLegacyEvent;
+  event[19] = 0x05;
+  LeAdvertisingReportParser parser(Format::LEGACY, event.data(), event.size());
+  ASSERT_TRUE(parser.IsValid());
+  RawAdvertisingReport report;
+  ASSERT_TRUE(parser.Next(&report));
+  ASSERT_FALSE(parser.Next(&report));
+}
+
+TEST(LeAdvertisingReportParserTest, significant_data) {
+  const std::vector<uint8_t> data = {0x02, 0x01, 0x06, 0x00, 0x00, 0x03, 0x09, 'a', 'b', 0x05, 0xff};
+  ASSERT_EQ(
+      std::vector<uint8_t>({0x02, 0x01, 0x06, 0x03, 0x09, 'a', 'b'}),
+      LeAdvertisingReportParser::GetSignificantData(data.data(), data.size()));
+  ASSERT_TRUE(LeAdvertisingReportParser::GetSignificantData(data.data(), 0).empty());
+}
+
+}  // namespace
+}  // namespace hci
+}  // namespace bluetooth
@@ -15,9 +15,13 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <chrono>
+#include <list>
 #include <memory>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "common/callback.h"
 #include "common/init_flags.h"
@@ -35,6 +39,11 @@ namespace hci {
 
 constexpr std::chrono::duration kPeriodicSyncTimeout = std::chrono::seconds(30);
 constexpr int kMaxSyncTransactions = 16;
+// Pending and established syncs, the controller rejects the ones it has no room for
+constexpr int kMaxPeriodicSyncs = 64;
+// Largest periodic advertising data, longer chains are delivered truncated
+constexpr size_t kMaxPeriodicAdvertisingDataSize = 1650;
+constexpr size_t kMaxPooledReassemblyBuffers = 16;
 
 enum PeriodicSyncState : int {
   PERIODIC_SYNC_STATE_IDLE = 0,
@@ -90,8 +99,20 @@ class PeriodicSyncManager {
     callbacks_ = callbacks;
   }
 
+  // Create the syncs through the periodic advertiser list, up to |list_size| at once, instead of one advertiser
+  // after the other. The controller then syncs to whichever listed train it receives first, so an advertiser out of
+  // range no longer holds up the others until its timeout. Zero creates the syncs one at a time.
+  void SetPeriodicAdvertiserListSize(uint8_t list_size) {
+    periodic_advertiser_list_size_ = list_size;
+  }
+
+  // Reassemble the fragmented reports of each sync and deliver the whole data once, instead of each fragment.
+  void SetReassembleReports(bool reassemble) {
+    reassemble_reports_ = reassemble;
+  }
+
   void StartSync(const PeriodicSyncStates& request, uint16_t skip, uint16_t sync_timeout) {
-    if (periodic_syncs_.size() >= kMaxSyncTransactions) {
+    if (periodic_syncs_.size() >= kMaxPeriodicSyncs) {
       int status = static_cast<int>(ErrorCode::CONNECTION_REJECTED_LIMITED_RESOURCES);
       callbacks_->OnPeriodicSyncStarted(
           request.request_id, status, 0, request.advertiser_sid, request.address_with_type, 0, 0);
@@ -106,6 +127,10 @@ class PeriodicSyncManager {
     LOG_DEBUG("address = %s, sid = %d", request.address_with_type.ToString().c_str(), request.advertiser_sid);
     pending_sync_requests_.emplace_back(
         request.advertiser_sid, request.address_with_type, skip, sync_timeout, handler_);
+    if (UsePeriodicAdvertiserList()) {
+      HandleNextListRequests();
+      return;
+    }
     HandleNextRequest();
   }
 
@@ -120,7 +145,7 @@ class PeriodicSyncManager {
               this, &PeriodicSyncManager::check_status<LePeriodicAdvertisingTerminateSyncCompleteView>));
       return;
     };
-    periodic_syncs_.erase(periodic_sync);
+    EraseSync(periodic_sync);
     le_scanning_interface_->EnqueueCommand(
         hci::LePeriodicAdvertisingTerminateSyncBuilder::Create(handle),
         handler_->BindOnceOn(this, &PeriodicSyncManager::check_status<LePeriodicAdvertisingTerminateSyncCompleteView>));
@@ -134,6 +159,21 @@ class PeriodicSyncManager {
       return;
     }
 
+    if (UsePeriodicAdvertiserList() && periodic_sync->sync_state != PERIODIC_SYNC_STATE_ESTABLISHED) {
+      // The create sync is only cancelled to take the advertiser out of the list, the others keep waiting
+      LOG_DEBUG("[PSync]: Removing Sync request from the periodic advertiser list");
+      auto pending_sync_request = GetPendingSyncFromAddressAndSid(address, adv_sid);
+      if (pending_sync_request != pending_sync_requests_.end()) {
+        if (pending_sync_request->busy) {
+          list_removals_.emplace_back(pending_sync_request->address_with_type, adv_sid);
+        }
+        pending_sync_requests_.erase(pending_sync_request);
+      }
+      EraseSync(periodic_sync);
+      HandleNextListRequests();
+      return;
+    }
+
     if (periodic_sync->sync_state == PERIODIC_SYNC_STATE_PENDING) {
       LOG_WARN("[PSync]: Sync state is pending");
       le_scanning_interface_->EnqueueCommand(
@@ -143,7 +183,7 @@ class PeriodicSyncManager {
       LOG_DEBUG("[PSync]: Removing Sync request from queue");
       CleanUpRequest(adv_sid, address);
     }
-    periodic_syncs_.erase(periodic_sync);
+    EraseSync(periodic_sync);
   }
 
   void TransferSync(
@@ -265,10 +305,26 @@ class PeriodicSyncManager {
         event_view.GetPeriodicAdvertisingInterval(),
         (uint16_t)event_view.GetAdvertiserClockAccuracy());
 
+    if (UsePeriodicAdvertiserList()) {
+      list_create_sync_pending_ = false;
+      list_cancel_pending_ = false;
+      if (event_view.GetStatus() == ErrorCode::OPERATION_CANCELLED_BY_HOST) {
+        // Cancelled to update the list
+        HandleNextListRequests();
+        return;
+      }
+    }
+
     auto pending_sync_request =
         GetPendingSyncFromAddressAndSid(event_view.GetAdvertiserAddress(), event_view.GetAdvertisingSid());
     if (pending_sync_request != pending_sync_requests_.end()) {
       pending_sync_request->sync_timeout_alarm.Cancel();
+      if (UsePeriodicAdvertiserList()) {
+        if (pending_sync_request->busy) {
+          list_removals_.emplace_back(pending_sync_request->address_with_type, pending_sync_request->advertiser_sid);
+        }
+        pending_sync_requests_.erase(pending_sync_request);
+      }
     }
 
     auto address_with_type = AddressWithType(event_view.GetAdvertiserAddress(), event_view.GetAdvertiserAddressType());
@@ -290,11 +346,9 @@ class PeriodicSyncManager {
             handler_->BindOnceOn(
                 this, &PeriodicSyncManager::check_status<LePeriodicAdvertisingTerminateSyncCompleteView>));
       }
-      AdvanceRequest();
+      OnCreateSyncDone();
       return;
     }
-    periodic_sync->sync_handle = event_view.GetSyncHandle();
-    periodic_sync->sync_state = PERIODIC_SYNC_STATE_ESTABLISHED;
     callbacks_->OnPeriodicSyncStarted(
         periodic_sync->request_id,
         (uint8_t)event_view.GetStatus(),
@@ -303,7 +357,14 @@ class PeriodicSyncManager {
         address_with_type,
         (uint16_t)event_view.GetAdvertiserPhy(),
         event_view.GetPeriodicAdvertisingInterval());
-    AdvanceRequest();
+    if (event_view.GetStatus() == ErrorCode::SUCCESS) {
+      periodic_sync->sync_handle = event_view.GetSyncHandle();
+      periodic_sync->sync_state = PERIODIC_SYNC_STATE_ESTABLISHED;
+      established_syncs_[periodic_sync->sync_handle] = EstablishedSync{periodic_sync, {}};
+    } else {
+      EraseSync(periodic_sync);
+    }
+    OnCreateSyncDone();
   }
 
   void HandleLePeriodicAdvertisingReport(LePeriodicAdvertisingReportView event_view) {
@@ -319,11 +380,15 @@ class PeriodicSyncManager {
         (uint16_t)event_view.GetData().size());
 
     uint16_t sync_handle = event_view.GetSyncHandle();
-    auto periodic_sync = GetEstablishedSyncFromHandle(sync_handle);
-    if (periodic_sync == periodic_syncs_.end()) {
+    auto established_sync = established_syncs_.find(sync_handle);
+    if (established_sync == established_syncs_.end()) {
       LOG_ERROR("[PSync]: index not found for handle %u", sync_handle);
       return;
     }
+    if (reassemble_reports_) {
+      ReassembleReport(established_sync->second, event_view);
+      return;
+    }
     LOG_DEBUG("%s", "[PSync]: invoking callback");
     callbacks_->OnPeriodicSyncReport(
         sync_handle,
@@ -339,7 +404,11 @@ class PeriodicSyncManager {
     LOG_DEBUG("[PSync]: sync_handle = %d", sync_handle);
     callbacks_->OnPeriodicSyncLost(sync_handle);
     auto periodic_sync = GetEstablishedSyncFromHandle(sync_handle);
-    periodic_syncs_.erase(periodic_sync);
+    if (periodic_sync == periodic_syncs_.end()) {
+      LOG_ERROR("[PSync]: index not found for handle %u", sync_handle);
+      return;
+    }
+    EraseSync(periodic_sync);
   }
 
   void HandleLePeriodicAdvertisingSyncTransferReceived(LePeriodicAdvertisingSyncTransferReceivedView event_view) {
@@ -391,14 +460,96 @@ class PeriodicSyncManager {
     RemoveSyncRequest(sync);
   }
 
+  void OnListSyncTimeout(uint8_t adv_sid, AddressWithType address_with_type) {
+    auto request = GetPendingSyncFromAddressAndSid(address_with_type.GetAddress(), adv_sid);
+    if (request == pending_sync_requests_.end()) {
+      return;
+    }
+    LOG_WARN("%s: sync timeout SID=%04X, bd_addr=%s", __func__, adv_sid, address_with_type.ToString().c_str());
+    if (request->busy) {
+      list_removals_.emplace_back(address_with_type, adv_sid);
+    }
+    pending_sync_requests_.erase(request);
+    auto sync = GetSyncFromAddressWithTypeAndSid(address_with_type, adv_sid);
+    if (sync != periodic_syncs_.end()) {
+      int status = static_cast<int>(ErrorCode::ADVERTISING_TIMEOUT);
+      callbacks_->OnPeriodicSyncStarted(sync->request_id, status, 0, adv_sid, address_with_type, 0, 0);
+      EraseSync(sync);
+    }
+    HandleNextListRequests();
+  }
+
  private:
+  struct EstablishedSync {
+    std::list<PeriodicSyncStates>::iterator sync;
+    // Fragments of the report being reassembled, taken from the pool while the sync is established
+    std::vector<uint8_t> reassembly_buffer;
+  };
+
+  bool UsePeriodicAdvertiserList() const {
+    return periodic_advertiser_list_size_ != 0;
+  }
+
   std::list<PeriodicSyncStates>::iterator GetEstablishedSyncFromHandle(uint16_t handle) {
-    for (auto it = periodic_syncs_.begin(); it != periodic_syncs_.end(); it++) {
-      if (it->sync_handle == handle && it->sync_state == PeriodicSyncState::PERIODIC_SYNC_STATE_ESTABLISHED) {
-        return it;
+    auto it = established_syncs_.find(handle);
+    if (it == established_syncs_.end()) {
+      return periodic_syncs_.end();
+    }
+    return it->second.sync;
+  }
+
+  void EraseSync(std::list<PeriodicSyncStates>::iterator it) {
+    if (it->sync_state == PERIODIC_SYNC_STATE_ESTABLISHED) {
+      auto established_sync = established_syncs_.find(it->sync_handle);
+      if (established_sync != established_syncs_.end() && established_sync->second.sync == it) {
+        ReleaseReassemblyBuffer(std::move(established_sync->second.reassembly_buffer));
+        established_syncs_.erase(established_sync);
       }
     }
-    return periodic_syncs_.end();
+    periodic_syncs_.erase(it);
+  }
+
+  void ReassembleReport(EstablishedSync& established_sync, LePeriodicAdvertisingReportView event_view) {
+    auto& buffer = established_sync.reassembly_buffer;
+    if (buffer.capacity() == 0) {
+      buffer = AcquireReassemblyBuffer();
+    }
+    auto data_status = event_view.GetDataStatus();
+    // Once too long, the remaining fragments are dropped and the data is delivered truncated
+    bool truncated = buffer.size() > kMaxPeriodicAdvertisingDataSize;
+    if (!truncated) {
+      auto data = event_view.GetData();
+      buffer.insert(buffer.end(), data.begin(), data.end());
+    }
+    if (data_status == PeriodicAdvertisingDataStatus::DATA_INCOMPLETE_MORE_TO_COME) {
+      return;
+    }
+    if (truncated || buffer.size() > kMaxPeriodicAdvertisingDataSize) {
+      buffer.resize(kMaxPeriodicAdvertisingDataSize);
+      data_status = PeriodicAdvertisingDataStatus::DATA_INCOMPLETE_TRUNCATED_NO_MORE_DATA;
+    }
+    callbacks_->OnPeriodicSyncReport(
+        event_view.GetSyncHandle(), event_view.GetTxPower(), event_view.GetRssi(), (uint16_t)data_status, buffer);
+    buffer.clear();
+  }
+
+  std::vector<uint8_t> AcquireReassemblyBuffer() {
+    if (reassembly_buffer_pool_.empty()) {
+      std::vector<uint8_t> buffer;
+      buffer.reserve(kMaxPeriodicAdvertisingDataSize);
+      return buffer;
+    }
+    auto buffer = std::move(reassembly_buffer_pool_.back());
+    reassembly_buffer_pool_.pop_back();
+    return buffer;
+  }
+
+  void ReleaseReassemblyBuffer(std::vector<uint8_t> buffer) {
+    if (buffer.capacity() == 0 || reassembly_buffer_pool_.size() >= kMaxPooledReassemblyBuffers) {
+      return;
+    }
+    buffer.clear();
+    reassembly_buffer_pool_.push_back(std::move(buffer));
   }
 
   std::list<PeriodicSyncStates>::iterator GetSyncFromAddressWithTypeAndSid(
@@ -431,7 +582,7 @@ class PeriodicSyncManager {
   }
 
   void RemoveSyncRequest(std::list<PeriodicSyncStates>::iterator it) {
-    periodic_syncs_.erase(it);
+    EraseSync(it);
   }
 
   std::list<PeriodicSyncTransferStates>::iterator GetSyncTransferRequestFromConnectionHandle(
@@ -481,6 +632,107 @@ class PeriodicSyncManager {
         base::BindOnce(&PeriodicSyncManager::OnStartSyncTimeout, base::Unretained(this)), kPeriodicSyncTimeout);
   }
 
+  void OnCreateSyncDone() {
+    if (UsePeriodicAdvertiserList()) {
+      HandleNextListRequests();
+      return;
+    }
+    AdvanceRequest();
+  }
+
+  // Bring the periodic advertiser list up to date with the pending requests and create the sync from it. The list
+  // can't be changed while a create sync is pending, so it is cancelled first and this is called again once the
+  // cancellation is reported.
+  void HandleNextListRequests() {
+    size_t listed = std::count_if(
+        pending_sync_requests_.begin(), pending_sync_requests_.end(), [](const PendingPeriodicSyncRequest& request) {
+          return request.busy;
+        });
+    bool has_unlisted = listed < pending_sync_requests_.size() && listed < periodic_advertiser_list_size_;
+    if (list_create_sync_pending_) {
+      if ((has_unlisted || !list_removals_.empty()) && !list_cancel_pending_) {
+        list_cancel_pending_ = true;
+        le_scanning_interface_->EnqueueCommand(
+            hci::LePeriodicAdvertisingCreateSyncCancelBuilder::Create(),
+            handler_->BindOnceOn(this, &PeriodicSyncManager::HandlePeriodicAdvertisingCreateSyncCancelStatus));
+      }
+      return;
+    }
+
+    for (const auto& removal : list_removals_) {
+      le_scanning_interface_->EnqueueCommand(
+          hci::LeRemoveDeviceFromPeriodicAdvertisingListBuilder::Create(
+              static_cast<AdvertisingAddressType>(removal.first.GetAddressType()),
+              removal.first.GetAddress(),
+              removal.second),
+          handler_->BindOnceOn(
+              this, &PeriodicSyncManager::check_status<LeRemoveDeviceFromPeriodicAdvertisingListCompleteView>));
+    }
+    list_removals_.clear();
+
+    for (auto& request : pending_sync_requests_) {
+      if (listed >= periodic_advertiser_list_size_) {
+        break;
+      }
+      if (request.busy) {
+        continue;
+      }
+      LOG_INFO(
+          "adding sync request SID=%04X, bd_addr=%s to the periodic advertiser list",
+          request.advertiser_sid,
+          request.address_with_type.ToString().c_str());
+      le_scanning_interface_->EnqueueCommand(
+          hci::LeAddDeviceToPeriodicAdvertisingListBuilder::Create(
+              static_cast<AdvertisingAddressType>(request.address_with_type.GetAddressType()),
+              request.address_with_type.GetAddress(),
+              request.advertiser_sid),
+          handler_->BindOnceOn(
+              this, &PeriodicSyncManager::check_status<LeAddDeviceToPeriodicAdvertisingListCompleteView>));
+      request.busy = true;
+      listed++;
+      auto sync = GetSyncFromAddressWithTypeAndSid(request.address_with_type, request.advertiser_sid);
+      if (sync != periodic_syncs_.end()) {
+        sync->sync_state = PERIODIC_SYNC_STATE_PENDING;
+      }
+      request.sync_timeout_alarm.Schedule(
+          base::BindOnce(
+              &PeriodicSyncManager::PostListSyncTimeout,
+              base::Unretained(this),
+              request.advertiser_sid,
+              request.address_with_type),
+          kPeriodicSyncTimeout);
+    }
+    if (listed == 0) {
+      return;
+    }
+
+    // The skip and sync timeout apply to the whole list, the ones of the oldest request are used
+    auto first_listed = std::find_if(
+        pending_sync_requests_.begin(), pending_sync_requests_.end(), [](const PendingPeriodicSyncRequest& request) {
+          return request.busy;
+        });
+    auto sync_cte_type = static_cast<PeriodicSyncCteType>(
+        static_cast<uint8_t>(PeriodicSyncCteType::AVOID_AOA_CONSTANT_TONE_EXTENSION) |
+        static_cast<uint8_t>(PeriodicSyncCteType::AVOID_AOD_CONSTANT_TONE_EXTENSION_WITH_ONE_US_SLOTS) |
+        static_cast<uint8_t>(PeriodicSyncCteType::AVOID_AOD_CONSTANT_TONE_EXTENSION_WITH_TWO_US_SLOTS));
+    le_scanning_interface_->EnqueueCommand(
+        hci::LePeriodicAdvertisingCreateSyncBuilder::Create(
+            PeriodicAdvertisingOptions::USE_PERIODIC_ADVERTISER_LIST_SELECT_ADVERTISER,
+            0,
+            AdvertisingAddressType::PUBLIC_ADDRESS,
+            Address::kEmpty,
+            first_listed->skip,
+            first_listed->sync_timeout,
+            sync_cte_type),
+        handler_->BindOnceOn(this, &PeriodicSyncManager::HandlePeriodicAdvertisingCreateSyncStatus));
+    list_create_sync_pending_ = true;
+  }
+
+  // The alarm fires on the reactor, the request owning it is only removed from the handler
+  void PostListSyncTimeout(uint8_t adv_sid, AddressWithType address_with_type) {
+    handler_->CallOn(this, &PeriodicSyncManager::OnListSyncTimeout, adv_sid, address_with_type);
+  }
+
   void AdvanceRequest() {
     LOG_DEBUG("AdvanceRequest");
     if (pending_sync_requests_.empty()) {
@@ -514,6 +766,15 @@ class PeriodicSyncManager {
   std::list<PendingPeriodicSyncRequest> pending_sync_requests_;
   std::list<PeriodicSyncStates> periodic_syncs_;
   std::list<PeriodicSyncTransferStates> periodic_sync_transfers_;
+  // Established syncs by sync handle, the reports are looked up there
+  std::unordered_map<uint16_t, EstablishedSync> established_syncs_;
+  std::vector<std::vector<uint8_t>> reassembly_buffer_pool_;
+  bool reassemble_reports_ = false;
+  uint8_t periodic_advertiser_list_size_ = 0;
+  bool list_create_sync_pending_ = false;
+  bool list_cancel_pending_ = false;
+  // Listed advertisers to remove once the pending create sync is over
+  std::vector<std::pair<AddressWithType, uint8_t>> list_removals_;
   bool sync_received_callback_registered_ = false;
   int sync_received_callback_id{};
 };
@@ -545,6 +545,136 @@ TEST_F(PeriodicSyncManagerTest, handle_periodic_advertising_report_test) {
   sync_handler();
 }
 
+TEST_F(PeriodicSyncManagerTest, start_syncs_through_periodic_advertiser_list_test) {
+  periodic_sync_manager_->SetPeriodicAdvertiserListSize(2);
+  Address address;
+  Address::FromString("00:11:22:33:44:55", address);
+  Address other_address;
+  Address::FromString("00:11:22:33:44:66", other_address);
+  uint8_t advertiser_sid = 0x02;
+  AddressWithType address_with_type = AddressWithType(address, AddressType::PUBLIC_DEVICE_ADDRESS);
+  AddressWithType other_address_with_type = AddressWithType(other_address, AddressType::PUBLIC_DEVICE_ADDRESS);
+  PeriodicSyncStates request{
+      .request_id = 0x01,
+      .advertiser_sid = advertiser_sid,
+      .address_with_type = address_with_type,
+      .sync_handle = 0,
+      .sync_state = PeriodicSyncState::PERIODIC_SYNC_STATE_IDLE,
+  };
+  PeriodicSyncStates other_request = request;
+  other_request.request_id = 0x02;
+  other_request.address_with_type = other_address_with_type;
+
+  test_le_scanning_interface_->SetCommandFuture();
+  periodic_sync_manager_->StartSync(request, 0x04, 0x0A);
+  test_le_scanning_interface_->GetCommand(OpCode::LE_ADD_DEVICE_TO_PERIODIC_ADVERTISING_LIST);
+  auto packet = test_le_scanning_interface_->GetCommand(OpCode::LE_PERIODIC_ADVERTISING_CREATE_SYNC);
+  auto packet_view = LePeriodicAdvertisingCreateSyncView::Create(LeScanningCommandView::Create(packet));
+  ASSERT_TRUE(packet_view.IsValid());
+  ASSERT_EQ(
+      PeriodicAdvertisingOptions::USE_PERIODIC_ADVERTISER_LIST_SELECT_ADVERTISER, packet_view.GetOptions());
+
+  // The list can only be updated once the pending create sync is cancelled
+  test_le_scanning_interface_->SetCommandFuture();
+  periodic_sync_manager_->StartSync(other_request, 0x04, 0x0A);
+  test_le_scanning_interface_->GetCommand(OpCode::LE_PERIODIC_ADVERTISING_CREATE_SYNC_CANCEL);
+  auto cancelled = LePeriodicAdvertisingSyncEstablishedBuilder::Create(
+      ErrorCode::OPERATION_CANCELLED_BY_HOST,
+      0,
+      0,
+      AddressType::PUBLIC_DEVICE_ADDRESS,
+      Address::kEmpty,
+      SecondaryPhyType::LE_1M,
+      0,
+      ClockAccuracy::PPM_250);
+  test_le_scanning_interface_->SetCommandFuture();
+  periodic_sync_manager_->HandleLePeriodicAdvertisingSyncEstablished(LePeriodicAdvertisingSyncEstablishedView::Create(
+      LeMetaEventView::Create(EventView::Create(GetPacketView(std::move(cancelled))))));
+  packet = test_le_scanning_interface_->GetCommand(OpCode::LE_ADD_DEVICE_TO_PERIODIC_ADVERTISING_LIST);
+  auto add_view = LeAddDeviceToPeriodicAdvertisingListView::Create(LeScanningCommandView::Create(packet));
+  ASSERT_TRUE(add_view.IsValid());
+  ASSERT_EQ(other_address, add_view.GetAdvertiserAddress());
+  test_le_scanning_interface_->GetCommand(OpCode::LE_PERIODIC_ADVERTISING_CREATE_SYNC);
+
+  // The advertiser synced first leaves the list, the sync is created again for the other one
+  EXPECT_CALL(mock_callbacks_, OnPeriodicSyncStarted);
+  auto established = LePeriodicAdvertisingSyncEstablishedBuilder::Create(
+      ErrorCode::SUCCESS,
+      0x12,
+      advertiser_sid,
+      other_address_with_type.GetAddressType(),
+      other_address,
+      SecondaryPhyType::LE_1M,
+      0xFF,
+      ClockAccuracy::PPM_250);
+  test_le_scanning_interface_->SetCommandFuture();
+  periodic_sync_manager_->HandleLePeriodicAdvertisingSyncEstablished(LePeriodicAdvertisingSyncEstablishedView::Create(
+      LeMetaEventView::Create(EventView::Create(GetPacketView(std::move(established))))));
+  packet = test_le_scanning_interface_->GetCommand(OpCode::LE_REMOVE_DEVICE_FROM_PERIODIC_ADVERTISING_LIST);
+  auto remove_view = LeRemoveDeviceFromPeriodicAdvertisingListView::Create(LeScanningCommandView::Create(packet));
+  ASSERT_TRUE(remove_view.IsValid());
+  ASSERT_EQ(other_address, remove_view.GetAdvertiserAddress());
+  test_le_scanning_interface_->GetCommand(OpCode::LE_PERIODIC_ADVERTISING_CREATE_SYNC);
+  sync_handler();
+}
+
+TEST_F(PeriodicSyncManagerTest, reassemble_periodic_advertising_report_test) {
+  periodic_sync_manager_->SetReassembleReports(true);
+  uint16_t sync_handle = 0x12;
+  uint8_t advertiser_sid = 0x02;
+  Address address;
+  Address::FromString("00:11:22:33:44:55", address);
+  AddressWithType address_with_type = AddressWithType(address, AddressType::PUBLIC_DEVICE_ADDRESS);
+  PeriodicSyncStates request{
+      .request_id = 0x01,
+      .advertiser_sid = advertiser_sid,
+      .address_with_type = address_with_type,
+      .sync_handle = sync_handle,
+      .sync_state = PeriodicSyncState::PERIODIC_SYNC_STATE_IDLE,
+  };
+  test_le_scanning_interface_->SetCommandFuture();
+  periodic_sync_manager_->StartSync(request, 0x04, 0x0A);
+  test_le_scanning_interface_->GetCommand(OpCode::LE_PERIODIC_ADVERTISING_CREATE_SYNC);
+
+  EXPECT_CALL(mock_callbacks_, OnPeriodicSyncStarted);
+  auto builder = LePeriodicAdvertisingSyncEstablishedBuilder::Create(
+      ErrorCode::SUCCESS,
+      sync_handle,
+      advertiser_sid,
+      address_with_type.GetAddressType(),
+      address_with_type.GetAddress(),
+      SecondaryPhyType::LE_1M,
+      0xFF,
+      ClockAccuracy::PPM_250);
+  periodic_sync_manager_->HandleLePeriodicAdvertisingSyncEstablished(LePeriodicAdvertisingSyncEstablishedView::Create(
+      LeMetaEventView::Create(EventView::Create(GetPacketView(std::move(builder))))));
+
+  std::vector<uint8_t> expected = {0x01, 0x02, 0x03, 0x04};
+  EXPECT_CALL(
+      mock_callbacks_,
+      OnPeriodicSyncReport(sync_handle, 0x1a, 0x1a, (uint8_t)PeriodicAdvertisingDataStatus::DATA_COMPLETE, expected))
+      .Times(1);
+  auto first = LePeriodicAdvertisingReportBuilder::Create(
+      sync_handle,
+      0x1a,
+      0x1a,
+      CteType::AOA_CONSTANT_TONE_EXTENSION,
+      PeriodicAdvertisingDataStatus::DATA_INCOMPLETE_MORE_TO_COME,
+      std::vector<uint8_t>{0x01, 0x02});
+  periodic_sync_manager_->HandleLePeriodicAdvertisingReport(LePeriodicAdvertisingReportView::Create(
+      LeMetaEventView::Create(EventView::Create(GetPacketView(std::move(first))))));
+  auto last = LePeriodicAdvertisingReportBuilder::Create(
+      sync_handle,
+      0x1a,
+      0x1a,
+      CteType::AOA_CONSTANT_TONE_EXTENSION,
+      PeriodicAdvertisingDataStatus::DATA_COMPLETE,
+      std::vector<uint8_t>{0x03, 0x04});
+  periodic_sync_manager_->HandleLePeriodicAdvertisingReport(LePeriodicAdvertisingReportView::Create(
+      LeMetaEventView::Create(EventView::Create(GetPacketView(std::move(last))))));
+  sync_handler();
+}
+
 }  // namespace
 }  // namespace hci
 }  // namespace bluetooth
@@ -15,19 +15,27 @@
  */
 #include "hci/le_scanning_manager.h"
 
+#include <array>
+#include <chrono>
 #include <memory>
 #include <unordered_map>
 
+#include "common/strings.h"
 #include "hci/acl_manager.h"
+#include "hci/advertising_cache.h"
+#include "hci/advertising_report_deduplicator.h"
 #include "hci/controller.h"
 #include "hci/hci_layer.h"
 #include "hci/hci_packets.h"
+#include "hci/host_advertising_filter.h"
+#include "hci/le_advertising_report_parser.h"
 #include "hci/le_periodic_sync_manager.h"
 #include "hci/le_scanning_interface.h"
 #include "hci/vendor_specific_event_manager.h"
 #include "module.h"
 #include "os/handler.h"
 #include "os/log.h"
+#include "os/system_properties.h"
 #include "storage/storage_module.h"
 
 namespace bluetooth {
@@ -48,6 +56,24 @@ constexpr uint8_t kScanResponseBit = 3;
 constexpr uint8_t kLegacyBit = 4;
 constexpr uint8_t kDataStatusBits = 5;
 
+// Parse advertising reports in place and drop repeated reports before they are copied, see
+// handle_advertising_report_in_place().
+constexpr char kLeScanFastPathProperty[] = "persist.bluetooth.lescanfastpath";
+// Identical reports from one advertiser within this window are only delivered once on the fast path.
+constexpr std::chrono::milliseconds kDuplicateReportWindow(100);
+// Event code, parameter length and up to 255 bytes of parameters.
+constexpr size_t kMaxEventSize = 257;
+// Deliver batch scan results in chunks of at most kBatchScanReportChunkSize bytes while they are read from the
+// controller, instead of once all of them were read.
+constexpr char kBatchScanStreamingProperty[] = "persist.bluetooth.batchscanstreaming";
+// Evaluate the advertising packet content filters on the host when the controller does not support them, so the
+// reports they reject are dropped before reaching the upper layers.
+constexpr char kHostAdvertisingFilterProperty[] = "persist.bluetooth.hostadvfilter";
+// Create the periodic syncs through the periodic advertiser list, see PeriodicSyncManager.
+constexpr char kPeriodicSyncBulkProperty[] = "persist.bluetooth.periodicsyncbulk";
+// Deliver the periodic advertising data once reassembled instead of each fragment.
+constexpr char kPeriodicSyncReassemblyProperty[] = "persist.bluetooth.periodicsyncreassembly";
+
 const ModuleFactory LeScanningManager::Factory = ModuleFactory([]() { return new LeScanningManager(); });
 
 enum class ScanApiType {
@@ -61,80 +87,6 @@ struct Scanner {
   bool in_use;
 };
 
-class AdvertisingCache {
- public:
-  const std::vector<uint8_t>& Set(const AddressWithType& address_with_type, std::vector<uint8_t> data) {
-    auto it = Find(address_with_type);
-    if (it != items.end()) {
-      it->data = std::move(data);
-      return it->data;
-    }
-
-    if (items.size() > cache_max) {
-      items.pop_back();
-    }
-
-    items.emplace_front(address_with_type, std::move(data));
-    return items.front().data;
-  }
-
-  bool Exist(const AddressWithType& address_with_type) {
-    auto it = Find(address_with_type);
-    if (it == items.end()) {
-      return false;
-    }
-    return true;
-  }
-
-  const std::vector<uint8_t>& Append(const AddressWithType& address_with_type, std::vector<uint8_t> data) {
-    auto it = Find(address_with_type);
-    if (it != items.end()) {
-      it->data.insert(it->data.end(), data.begin(), data.end());
-      return it->data;
-    }
-
-    if (items.size() > cache_max) {
-      items.pop_back();
-    }
-
-    items.emplace_front(address_with_type, std::move(data));
-    return items.front().data;
-  }
-
-  /* Clear data for device |addr_type, addr| */
-  void Clear(AddressWithType address_with_type) {
-    auto it = Find(address_with_type);
-    if (it != items.end()) {
-      items.erase(it);
-    }
-  }
-
-  void ClearAll() {
-    items.clear();
-  }
-
-  struct Item {
-    AddressWithType address_with_type;
-    std::vector<uint8_t> data;
-
-    Item(const AddressWithType& address_with_type, std::vector<uint8_t> data)
-        : address_with_type(address_with_type), data(data) {}
-  };
-
-  std::list<Item>::iterator Find(const AddressWithType& address_with_type) {
-    for (auto it = items.begin(); it != items.end(); it++) {
-      if (it->address_with_type == address_with_type) {
-        return it;
-      }
-    }
-    return items.end();
-  }
-
-  /* we keep maximum 7 devices in the cache */
-  const size_t cache_max = 1000;
-  std::list<Item> items;
-};
-
 class NullScanningCallback : public ScanningCallback {
   void OnScannerRegistered(const bluetooth::hci::Uuid app_uuid, ScannerId scanner_id, ScanningStatus status) override {
     LOG_INFO("OnScannerRegistered in NullScanningCallback");
@@ -248,6 +200,15 @@ struct LeScanningManager::impl : public bluetooth::hci::LeAddressManagerCallback
     le_scanning_interface_ = hci_layer_->GetLeScanningInterface(
         module_handler_->BindOn(this, &LeScanningManager::impl::handle_scan_results));
     periodic_sync_manager_.Init(le_scanning_interface_, module_handler_);
+    auto bulk_prop = os::GetSystemProperty(kPeriodicSyncBulkProperty);
+    if (bulk_prop && common::StringTrim(bulk_prop.value()) == "true" &&
+        controller_->IsSupported(OpCode::LE_ADD_DEVICE_TO_PERIODIC_ADVERTISING_LIST)) {
+      LOG_INFO("Creating periodic syncs through the periodic advertiser list");
+      periodic_sync_manager_.SetPeriodicAdvertiserListSize(controller_->GetLePeriodicAdvertiserListSize());
+    }
+    auto reassembly_prop = os::GetSystemProperty(kPeriodicSyncReassemblyProperty);
+    periodic_sync_manager_.SetReassembleReports(
+        reassembly_prop && common::StringTrim(reassembly_prop.value()) == "true");
     /* Check to see if the opcode is supported and C19 (support for extended advertising). */
     if (controller_->IsSupported(OpCode::LE_SET_EXTENDED_SCAN_PARAMETERS) &&
         controller->SupportsBleExtendedAdvertising()) {
@@ -277,6 +238,20 @@ struct LeScanningManager::impl : public bluetooth::hci::LeAddressManagerCallback
     }
     batch_scan_config_.current_state = BatchScanState::DISABLED_STATE;
     batch_scan_config_.ref_value = kInvalidScannerId;
+    auto fast_path_prop = os::GetSystemProperty(kLeScanFastPathProperty);
+    use_fast_path_ = fast_path_prop && common::StringTrim(fast_path_prop.value()) == "true";
+    if (use_fast_path_) {
+      LOG_INFO("Parsing advertising reports in place");
+    }
+    auto streaming_prop = os::GetSystemProperty(kBatchScanStreamingProperty);
+    stream_batch_scan_results_ = streaming_prop && common::StringTrim(streaming_prop.value()) == "true";
+    if (!is_filter_support_) {
+      auto host_filter_prop = os::GetSystemProperty(kHostAdvertisingFilterProperty);
+      use_host_filter_ = host_filter_prop && common::StringTrim(host_filter_prop.value()) == "true";
+      if (use_host_filter_) {
+        LOG_INFO("Advertising filters are evaluated on the host");
+      }
+    }
     configure_scan();
   }
 
@@ -298,12 +273,20 @@ struct LeScanningManager::impl : public bluetooth::hci::LeAddressManagerCallback
   void handle_scan_results(LeMetaEventView event) {
     switch (event.GetSubeventCode()) {
       case hci::SubeventCode::ADVERTISING_REPORT:
+        if (use_fast_path_) {
+          handle_advertising_report_in_place(event, LeAdvertisingReportParser::Format::LEGACY);
+          break;
+        }
         handle_advertising_report(LeAdvertisingReportView::Create(event));
         break;
       case hci::SubeventCode::DIRECTED_ADVERTISING_REPORT:
         handle_directed_advertising_report(LeDirectedAdvertisingReportView::Create(event));
         break;
       case hci::SubeventCode::EXTENDED_ADVERTISING_REPORT:
+        if (use_fast_path_) {
+          handle_advertising_report_in_place(event, LeAdvertisingReportParser::Format::EXTENDED);
+          break;
+        }
         handle_extended_advertising_report(LeExtendedAdvertisingReportView::Create(event));
         break;
       case hci::SubeventCode::PERIODIC_ADVERTISING_SYNC_ESTABLISHED:
@@ -394,7 +377,7 @@ struct LeScanningManager::impl : public bluetooth::hci::LeAddressManagerCallback
           kTxPowerInformationNotPresent,
           report.rssi_,
           kNotPeriodicAdvertisement,
-          report.advertising_data_);
+          get_significant_data(report.advertising_data_));
     }
   }
 
@@ -438,8 +421,91 @@ struct LeScanningManager::impl : public bluetooth::hci::LeAddressManagerCallback
           report.tx_power_,
           report.rssi_,
           report.periodic_advertising_interval_,
-          report.advertising_data_);
+          get_significant_data(report.advertising_data_));
+    }
+  }
+
+  // Same as handle_advertising_report() and handle_extended_advertising_report(), but reads the reports straight
+  // from the event bytes. Reports are filtered before their data is copied, and repeats are dropped.
+  void handle_advertising_report_in_place(LeMetaEventView event, LeAdvertisingReportParser::Format format) {
+    if (event.size() > kMaxEventSize) {
+      LOG_INFO("Dropping oversized advertising event");
+      return;
+    }
+    std::array<uint8_t, kMaxEventSize> event_copy;
+    const uint8_t* event_bytes = event.GetContiguousData();
+    if (event_bytes == nullptr) {
+      for (size_t i = 0; i < event.size(); i++) {
+        event_copy[i] = event[i];
+      }
+      event_bytes = event_copy.data();
+    }
+
+    LeAdvertisingReportParser parser(format, event_bytes, event.size());
+    if (!parser.IsValid()) {
+      LOG_INFO("Dropping invalid advertising event");
+      return;
+    }
+    if (parser.GetNumReports() == 0) {
+      LOG_INFO("Zero results in advertising event");
+      return;
     }
+
+    auto now = AdvertisingReportDeduplicator::Clock::now();
+    RawAdvertisingReport report;
+    while (parser.Next(&report)) {
+      if (report.address_type != (uint8_t)DirectAdvertisingAddressType::NO_ADDRESS) {
+        if (report.address == Address::kEmpty) {
+          LOG_WARN("Receive non-anonymous advertising report with empty address, skip!");
+          continue;
+        }
+        if (is_duplicate_report(report, now)) {
+          continue;
+        }
+      }
+      process_advertising_package_content(
+          report.event_type,
+          report.address_type,
+          report.address,
+          report.primary_phy,
+          report.secondary_phy,
+          report.advertising_sid,
+          report.tx_power,
+          report.rssi,
+          report.periodic_advertising_interval,
+          LeAdvertisingReportParser::GetSignificantData(report.data, report.data_length));
+    }
+  }
+
+  bool is_duplicate_report(const RawAdvertisingReport& report, AdvertisingReportDeduplicator::Clock::time_point now) {
+    bool is_legacy = report.event_type & (1 << kLegacyBit);
+    uint8_t data_status = report.event_type >> kDataStatusBits;
+    // Only whole advertisements can be dropped, fragments of a chain still being reassembled have to be cached.
+    if (data_status != (uint8_t)DataStatus::COMPLETE) {
+      return false;
+    }
+    if (!is_legacy && advertising_cache_.Exist(AddressWithType(report.address, (AddressType)report.address_type))) {
+      return false;
+    }
+    return report_deduplicator_.IsDuplicate(
+        report.address,
+        report.address_type,
+        report.advertising_sid,
+        report.event_type,
+        report.data,
+        report.data_length,
+        now);
+  }
+
+  static std::vector<uint8_t> get_significant_data(const std::vector<LengthAndData>& advertising_data) {
+    auto significant_data = std::vector<uint8_t>{};
+    for (const auto& datum : advertising_data) {
+      if (!datum.data_.empty()) {
+        significant_data.push_back(static_cast<uint8_t>(datum.data_.size()));
+        significant_data.insert(significant_data.end(), datum.data_.begin(), datum.data_.end());
+      }
+    }
+    return significant_data;
   }
 
   void process_advertising_package_content(
@@ -452,20 +518,16 @@ struct LeScanningManager::impl : public bluetooth::hci::LeAddressManagerCallback
       int8_t tx_power,
       int8_t rssi,
       uint16_t periodic_advertising_interval,
-      std::vector<bluetooth::hci::LengthAndData> advertising_data) {
+      std::vector<uint8_t> significant_data) {
     bool is_scannable = event_type & (1 << kScannableBit);
     bool is_scan_response = event_type & (1 << kScanResponseBit);
     bool is_legacy = event_type & (1 << kLegacyBit);
 
-    auto significant_data = std::vector<uint8_t>{};
-    for (const auto& datum : advertising_data) {
-      if (!datum.data_.empty()) {
-        significant_data.push_back(static_cast<uint8_t>(datum.data_.size()));
-        significant_data.insert(significant_data.end(), datum.data_.begin(), datum.data_.end());
-      }
-    }
-
     if (address_type == (uint8_t)DirectAdvertisingAddressType::NO_ADDRESS) {
+      if (use_host_filter_ &&
+          !host_filter_.Matches(address, address_type, rssi, significant_data.data(), significant_data.size())) {
+        return;
+      }
       scanning_callbacks_->OnScanResult(
           event_type,
           address_type,
@@ -491,8 +553,8 @@ struct LeScanningManager::impl : public bluetooth::hci::LeAddressManagerCallback
 
     bool is_start = is_legacy && is_scannable && !is_scan_response;
 
-    std::vector<uint8_t> const& adv_data = is_start ? advertising_cache_.Set(address_with_type, significant_data)
-                                                    : advertising_cache_.Append(address_with_type, significant_data);
+    std::vector<uint8_t> adv_data = is_start ? advertising_cache_.Set(address_with_type, significant_data)
+                                             : advertising_cache_.Append(address_with_type, significant_data);
 
     uint8_t data_status = event_type >> kDataStatusBits;
     if (data_status == (uint8_t)DataStatus::CONTINUING) {
@@ -515,6 +577,12 @@ struct LeScanningManager::impl : public bluetooth::hci::LeAddressManagerCallback
         address_type = (uint8_t)AddressType::RANDOM_DEVICE_ADDRESS;
         break;
     }
+    if (use_host_filter_ &&
+        !host_filter_.Matches(
+            address, (uint8_t)address_with_type.GetAddressType(), rssi, adv_data.data(), adv_data.size())) {
+      advertising_cache_.Clear(address_with_type);
+      return;
+    }
     scanning_callbacks_->OnScanResult(
         event_type,
         address_type,
@@ -525,7 +593,7 @@ struct LeScanningManager::impl : public bluetooth::hci::LeAddressManagerCallback
         tx_power,
         rssi,
         periodic_advertising_interval,
-        adv_data);
+        std::move(adv_data));
 
     advertising_cache_.Clear(address_with_type);
   }
@@ -627,6 +695,7 @@ struct LeScanningManager::impl : public bluetooth::hci::LeAddressManagerCallback
       return;
     }
     is_scanning_ = true;
+    report_deduplicator_.Clear();
     if (!address_manager_registered_) {
       le_address_manager_->Register(this);
       address_manager_registered_ = true;
@@ -704,6 +773,11 @@ struct LeScanningManager::impl : public bluetooth::hci::LeAddressManagerCallback
   }
 
   void scan_filter_enable(bool enable) {
+    if (use_host_filter_) {
+      host_filter_.Enable(enable);
+      scanning_callbacks_->OnFilterEnable(enable ? Enable::ENABLED : Enable::DISABLED, (uint8_t)ErrorCode::SUCCESS);
+      return;
+    }
     if (!is_filter_support_) {
       LOG_WARN("Advertising filter is not supported");
       return;
@@ -728,6 +802,10 @@ struct LeScanningManager::impl : public bluetooth::hci::LeAddressManagerCallback
 
   void scan_filter_parameter_setup(
       ApcfAction action, uint8_t filter_index, AdvertisingFilterParameter advertising_filter_parameter) {
+    if (use_host_filter_) {
+      host_filter_parameter_setup(action, filter_index, advertising_filter_parameter);
+      return;
+    }
     if (!is_filter_support_) {
       LOG_WARN("Advertising filter is not supported");
       return;
@@ -790,7 +868,38 @@ struct LeScanningManager::impl : public bluetooth::hci::LeAddressManagerCallback
     }
   }
 
+  void host_filter_parameter_setup(
+      ApcfAction action, uint8_t filter_index, const AdvertisingFilterParameter& advertising_filter_parameter) {
+    ErrorCode status = ErrorCode::SUCCESS;
+    switch (action) {
+      case ApcfAction::ADD:
+        if (!host_filter_.SetParameters(filter_index, advertising_filter_parameter)) {
+          status = ErrorCode::MEMORY_CAPACITY_EXCEEDED;
+        }
+        break;
+      case ApcfAction::DELETE:
+        host_filter_.DeleteParameters(filter_index);
+        break;
+      case ApcfAction::CLEAR:
+        host_filter_.ClearParameters();
+        break;
+      default:
+        LOG_ERROR("Unknown action type: %d", (uint16_t)action);
+        return;
+    }
+    scanning_callbacks_->OnFilterParamSetup(host_filter_.GetAvailableFilterIndexes(), action, (uint8_t)status);
+  }
+
   void scan_filter_add(uint8_t filter_index, std::vector<AdvertisingPacketContentFilterCommand> filters) {
+    if (use_host_filter_) {
+      for (const auto& filter : filters) {
+        ErrorCode status =
+            host_filter_.AddCondition(filter_index, filter) ? ErrorCode::SUCCESS : ErrorCode::MEMORY_CAPACITY_EXCEEDED;
+        scanning_callbacks_->OnFilterConfigCallback(
+            filter.filter_type, host_filter_.GetAvailableConditions(), ApcfAction::ADD, (uint8_t)status);
+      }
+      return;
+    }
     if (!is_filter_support_) {
       LOG_WARN("Advertising filter is not supported");
       return;
@@ -1464,12 +1573,24 @@ struct LeScanningManager::impl : public bluetooth::hci::LeAddressManagerCallback
     auto report_format = complete_view.GetBatchScanDataRead();
     if (num_of_records == 0) {
       scanning_callbacks_->OnBatchScanReports(
-          scanner_id, 0x00, (int)report_format, total_num_of_records, batch_scan_result_cache_[scanner_id]);
+          scanner_id,
+          0x00,
+          (int)report_format,
+          total_num_of_records,
+          std::move(batch_scan_result_cache_[scanner_id]));
       batch_scan_result_cache_.erase(scanner_id);
     } else {
       auto raw_data = complete_view.GetRawData();
-      batch_scan_result_cache_[scanner_id].insert(
-          batch_scan_result_cache_[scanner_id].end(), raw_data.begin(), raw_data.end());
+      auto& cached_data = batch_scan_result_cache_[scanner_id];
+      // |total_num_of_records| only counts the records still cached when streaming.
+      if (stream_batch_scan_results_ && !cached_data.empty() &&
+          cached_data.size() + raw_data.size() > kBatchScanReportChunkSize) {
+        scanning_callbacks_->OnBatchScanReports(
+            scanner_id, 0x00, (int)report_format, total_num_of_records, std::move(cached_data));
+        cached_data.clear();
+        total_num_of_records = 0;
+      }
+      cached_data.insert(cached_data.end(), raw_data.begin(), raw_data.end());
       total_num_of_records += num_of_records;
       batch_scan_read_results(scanner_id, total_num_of_records, static_cast<BatchScanMode>(report_format));
     }
@@ -1555,6 +1676,11 @@ struct LeScanningManager::impl : public bluetooth::hci::LeAddressManagerCallback
   bool scan_on_resume_ = false;
   bool paused_ = false;
   AdvertisingCache advertising_cache_;
+  bool use_fast_path_ = false;
+  bool stream_batch_scan_results_ = false;
+  bool use_host_filter_ = false;
+  HostAdvertisingFilter host_filter_;
+  AdvertisingReportDeduplicator report_deduplicator_{kDuplicateReportWindow};
   bool is_filter_support_ = false;
   bool is_batch_scan_support_ = false;
   bool is_periodic_advertising_sync_transfer_sender_support_ = false;
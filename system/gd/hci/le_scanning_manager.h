@@ -41,6 +41,8 @@ class LeScanningManager : public bluetooth::Module {
   static constexpr uint8_t kTxPowerInformationNotPresent = 0x7f;
   static constexpr uint8_t kNotPeriodicAdvertisement = 0x00;
   static constexpr ScannerId kInvalidScannerId = 0xFF;
+  // Largest batch of batch scan records handed to OnBatchScanReports() at once when batch scan results are streamed.
+  static constexpr size_t kBatchScanReportChunkSize = 1024;
   LeScanningManager();
   LeScanningManager(const LeScanningManager&) = delete;
   LeScanningManager& operator=(const LeScanningManager&) = delete;
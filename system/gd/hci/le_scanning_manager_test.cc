@@ -28,6 +28,7 @@
 #include "hci/controller.h"
 #include "hci/hci_layer.h"
 #include "hci/le_scanning_manager.h"
+#include "os/system_properties.h"
 #include "os/thread.h"
 #include "packet/raw_builder.h"
 
@@ -386,6 +387,19 @@ class LeAndroidHciScanningManagerTest : public LeScanningManagerTest {
   }
 };
 
+class LeAndroidHciStreamingBatchScanTest : public LeAndroidHciScanningManagerTest {
+ protected:
+  void SetUp() override {
+    os::SetSystemProperty("persist.bluetooth.batchscanstreaming", "true");
+    LeAndroidHciScanningManagerTest::SetUp();
+  }
+
+  void TearDown() override {
+    LeAndroidHciScanningManagerTest::TearDown();
+    os::ClearSystemPropertiesForHost();
+  }
+};
+
 class LeExtendedScanningManagerTest : public LeScanningManagerTest {
  protected:
   void SetUp() override {
@@ -659,6 +673,57 @@ TEST_F(LeAndroidHciScanningManagerTest, read_batch_scan_result) {
       uint8_t{1}, ErrorCode::SUCCESS, BatchScanDataRead::FULL_MODE_DATA, 0, {}));
 }
 
+TEST_F(LeAndroidHciStreamingBatchScanTest, read_batch_scan_result_in_chunks) {
+  test_hci_layer_->SetCommandFuture(2);
+  le_scanning_manager->BatchScanConifgStorage(100, 0, 95, 0x00);
+  ASSERT_EQ(OpCode::LE_BATCH_SCAN, test_hci_layer_->GetCommand().GetOpCode());
+  test_hci_layer_->IncomingEvent(LeBatchScanEnableCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
+  ASSERT_EQ(OpCode::LE_BATCH_SCAN, test_hci_layer_->GetCommand().GetOpCode());
+  test_hci_layer_->IncomingEvent(
+      LeBatchScanSetStorageParametersCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
+
+  test_hci_layer_->SetCommandFuture(1);
+  le_scanning_manager->BatchScanEnable(BatchScanMode::FULL, 2400, 2400, BatchScanDiscardRule::OLDEST);
+  ASSERT_EQ(OpCode::LE_BATCH_SCAN, test_hci_layer_->GetCommand().GetOpCode());
+  test_hci_layer_->IncomingEvent(LeBatchScanEnableCompleteBuilder::Create(uint8_t{1}, ErrorCode::SUCCESS));
+
+  test_hci_layer_->SetCommandFuture(1);
+  le_scanning_manager->BatchScanReadReport(0x01, BatchScanMode::FULL);
+  ASSERT_EQ(OpCode::LE_BATCH_SCAN, test_hci_layer_->GetCommand().GetOpCode());
+
+  // Each read returns two records of 100 bytes, the first five reads fill a chunk.
+  constexpr size_t kReadSize = 200;
+  constexpr size_t kReadsPerChunk = LeScanningManager::kBatchScanReportChunkSize / kReadSize;
+  std::vector<uint8_t> raw_data(kReadSize, 0x42);
+  for (size_t i = 0; i < kReadsPerChunk; i++) {
+    test_hci_layer_->SetCommandFuture(1);
+    test_hci_layer_->IncomingEvent(LeBatchScanReadResultParametersCompleteRawBuilder::Create(
+        uint8_t{1}, ErrorCode::SUCCESS, BatchScanDataRead::FULL_MODE_DATA, 2, raw_data));
+    ASSERT_EQ(OpCode::LE_BATCH_SCAN, test_hci_layer_->GetCommand().GetOpCode());
+  }
+
+  // The next read doesn't fit, so the full chunk is delivered before it is cached.
+  EXPECT_CALL(
+      mock_callbacks_,
+      OnBatchScanReports(
+          0x01,
+          0x00,
+          static_cast<int>(BatchScanDataRead::FULL_MODE_DATA),
+          2 * kReadsPerChunk,
+          std::vector<uint8_t>(kReadSize * kReadsPerChunk, 0x42)));
+  test_hci_layer_->SetCommandFuture(1);
+  test_hci_layer_->IncomingEvent(LeBatchScanReadResultParametersCompleteRawBuilder::Create(
+      uint8_t{1}, ErrorCode::SUCCESS, BatchScanDataRead::FULL_MODE_DATA, 2, raw_data));
+  ASSERT_EQ(OpCode::LE_BATCH_SCAN, test_hci_layer_->GetCommand().GetOpCode());
+
+  // The rest is delivered once the controller has no more records.
+  EXPECT_CALL(
+      mock_callbacks_,
+      OnBatchScanReports(0x01, 0x00, static_cast<int>(BatchScanDataRead::FULL_MODE_DATA), 2, raw_data));
+  test_hci_layer_->IncomingEvent(LeBatchScanReadResultParametersCompleteRawBuilder::Create(
+      uint8_t{1}, ErrorCode::SUCCESS, BatchScanDataRead::FULL_MODE_DATA, 0, {}));
+}
+
 TEST_F(LeExtendedScanningManagerTest, startup_teardown) {}
 
 TEST_F(LeExtendedScanningManagerTest, start_scan_test) {
@@ -251,10 +251,13 @@ void IsoManagerImpl::RemoveCigComplete(hci::CommandCompleteView command_complete
 }
 
 void IsoManagerImpl::SendIsoPacket(uint16_t cis_handle, std::vector<uint8_t> packet) {
+  auto& stats = data_path_stats_[cis_handle];
+  stats.sent_sdus++;
+  stats.sent_bytes += packet.size();
   auto builder = hci::IsoWithoutTimestampBuilder::Create(
       cis_handle,
       hci::IsoPacketBoundaryFlag::COMPLETE_SDU,
-      0 /* sequence_number*/,
+      stats.next_sequence_number++,
       hci::IsoPacketStatusFlag::VALID,
       std::make_unique<bluetooth::packet::RawBuilder>(packet));
   LOG_INFO("%c%c", packet[0], packet[1]);
@@ -263,9 +266,41 @@ void IsoManagerImpl::SendIsoPacket(uint16_t cis_handle, std::vector<uint8_t> pac
 
 void IsoManagerImpl::OnIncomingPacket() {
   std::unique_ptr<hci::IsoView> packet = hci_layer_->GetIsoQueueEnd()->TryDequeue();
+  if (packet != nullptr && packet->IsValid()) {
+    UpdateReceivedSequenceNumber(*packet);
+  }
   iso_data_callback.Invoke(std::move(packet));
 }
 
+void IsoManagerImpl::UpdateReceivedSequenceNumber(hci::IsoView packet) {
+  // Only the first fragment of an SDU has a sequence number
+  auto pb_flag = packet.GetPbFlag();
+  if (pb_flag != hci::IsoPacketBoundaryFlag::FIRST_FRAGMENT &&
+      pb_flag != hci::IsoPacketBoundaryFlag::COMPLETE_SDU) {
+    return;
+  }
+
+  uint16_t sequence_number;
+  if (packet.GetTsFlag() == hci::TimeStampFlag::PRESENT) {
+    auto view = hci::IsoWithTimestampView::Create(packet);
+    if (!view.IsValid()) return;
+    sequence_number = view.GetPacketSequenceNumber();
+  } else {
+    auto view = hci::IsoWithoutTimestampView::Create(packet);
+    if (!view.IsValid()) return;
+    sequence_number = view.GetPacketSequenceNumber();
+  }
+
+  auto& stats = data_path_stats_[packet.GetConnectionHandle()];
+  stats.received_sdus++;
+  if (stats.has_received_sequence_number) {
+    uint16_t gap = sequence_number - stats.last_received_sequence_number - 1;
+    if (gap != 0 && gap < 0x8000) stats.received_sequence_number_gaps += gap;
+  }
+  stats.has_received_sequence_number = true;
+  stats.last_received_sequence_number = sequence_number;
+}
+
 }  // namespace internal
 }  // namespace iso
 }  // namespace bluetooth
@@ -22,6 +22,7 @@
 #include "os/handler.h"
 
 #include <list>
+#include <map>
 
 namespace bluetooth {
 namespace iso {
@@ -37,6 +38,17 @@ struct IsochronousConnection {
   uint8_t cis_id;
 };
 
+struct IsoDataPathStats {
+  size_t sent_sdus = 0;
+  size_t sent_bytes = 0;
+  uint16_t next_sequence_number = 0;
+  size_t received_sdus = 0;
+  // SDUs missing from the sequence numbers reported by the controller
+  size_t received_sequence_number_gaps = 0;
+  bool has_received_sequence_number = false;
+  uint16_t last_received_sequence_number = 0;
+};
+
 class IsoManagerImpl {
  public:
   explicit IsoManagerImpl(os::Handler* iso_handler, hci::HciLayer* hci_layer, hci::Controller* controller);
@@ -96,6 +108,12 @@ class IsoManagerImpl {
 
   void SendIsoPacket(uint16_t cis_handle, std::vector<uint8_t> packet);
   void OnIncomingPacket();
+  void UpdateReceivedSequenceNumber(hci::IsoView packet);
+
+  const IsoDataPathStats* GetDataPathStats(uint16_t cis_handle) const {
+    auto it = data_path_stats_.find(cis_handle);
+    return it != data_path_stats_.end() ? &it->second : nullptr;
+  }
 
   bool IsKnownCig(uint8_t cig_id) {
     return find_if(iso_connections_.begin(), iso_connections_.end(), [cig_id](const IsochronousConnection& c) {
@@ -110,6 +128,7 @@ class IsoManagerImpl {
   std::unique_ptr<os::EnqueueBuffer<bluetooth::hci::IsoBuilder>> iso_enqueue_buffer_;
   hci::Controller* controller_ __attribute__((unused));
   std::list<IsochronousConnection> iso_connections_;
+  std::map<uint16_t, IsoDataPathStats> data_path_stats_;
   CisEstablishedCallback cis_established_callback;
   IsoDataCallback iso_data_callback;
 };
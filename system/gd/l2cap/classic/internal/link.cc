@@ -468,6 +468,12 @@ void Link::OnPendingPacketChange(Cid local_cid, bool has_packet) {
   }
 }
 
+void Link::OnTrafficClassChange(hci::acl_manager::DeficitRoundRobin::TrafficClass traffic_class) {
+  if (link_manager_ != nullptr) {
+    link_manager_->OnTrafficClassChange(GetAclHandle(), traffic_class);
+  }
+}
+
 }  // namespace internal
 }  // namespace classic
 }  // namespace l2cap
@@ -206,6 +206,8 @@ class Link : public l2cap::internal::ILink, public hci::acl_manager::ConnectionM
 
   void OnPendingPacketChange(Cid local_cid, bool has_packet) override;
 
+  void OnTrafficClassChange(hci::acl_manager::DeficitRoundRobin::TrafficClass traffic_class) override;
+
  private:
   friend class DumpsysHelper;
   void connect_to_pending_dynamic_channels();
@@ -135,6 +135,11 @@ void LinkManager::OnPendingPacketChange(hci::Address remote, int num_packets) {
   }
 }
 
+void LinkManager::OnTrafficClassChange(
+    uint16_t handle, hci::acl_manager::DeficitRoundRobin::TrafficClass traffic_class) {
+  acl_manager_->SetAclTrafficClass(handle, traffic_class);
+}
+
 Link* LinkManager::GetLink(const hci::Address device) {
   if (links_.find(device) == links_.end()) {
     return nullptr;
@@ -121,6 +121,9 @@ class LinkManager : public hci::acl_manager::ConnectionCallbacks {
   // If there is anything outstanding, don't delete link
   void OnPendingPacketChange(hci::Address remote, int num_packets);
 
+  // Reported by link when the highest traffic class of its pending packets changes
+  void OnTrafficClassChange(uint16_t handle, hci::acl_manager::DeficitRoundRobin::TrafficClass traffic_class);
+
  private:
   // Handles requests from LinkSecurityInterface
   friend class LinkSecurityInterfaceImpl;
@@ -62,6 +62,12 @@ void DataPipelineManager::SetChannelTxPriority(Cid cid, bool high_priority) {
   scheduler_->SetChannelTxPriority(cid, high_priority);
 }
 
+void DataPipelineManager::OnLinkTrafficClassChange(Scheduler::TrafficClass traffic_class) {
+  if (link_ != nullptr) {
+    link_->OnTrafficClassChange(traffic_class);
+  }
+}
+
 }  // namespace internal
 }  // namespace l2cap
 }  // namespace bluetooth
@@ -37,6 +37,7 @@ class MockDataPipelineManager : public DataPipelineManager {
   MOCK_METHOD(void, DetachChannel, (Cid), (override));
   MOCK_METHOD(DataController*, GetDataController, (Cid), (override));
   MOCK_METHOD(void, OnPacketSent, (Cid), (override));
+  MOCK_METHOD(void, OnLinkTrafficClassChange, (Scheduler::TrafficClass), (override));
 };
 
 }  // namespace testing
@@ -94,6 +94,42 @@ TEST_F(ErtmDataControllerTest, transmit_no_fcs) {
   EXPECT_EQ(i_frame_view.GetReqSeq(), 0);
 }
 
+TEST_F(ErtmDataControllerTest, transmit_segmented_sdu) {
+  common::BidiQueue<Scheduler::UpperEnqueue, Scheduler::UpperDequeue> channel_queue{10};
+  testing::MockScheduler scheduler;
+  testing::MockILink link;
+  ErtmController controller{&link, 1, 1, channel_queue.GetDownEnd(), queue_handler_, &scheduler};
+  // Default MPS of 1010 bytes, less the I-frame headers
+  constexpr size_t kSegmentSize = 1002;
+  std::vector<uint8_t> sdu(2 * kSegmentSize + 10);
+  for (size_t i = 0; i < sdu.size(); i++) {
+    sdu[i] = static_cast<uint8_t>(i);
+  }
+  EXPECT_CALL(scheduler, OnPacketsReady(1, 1)).Times(3);
+  controller.OnSdu(CreateSdu(sdu));
+
+  auto start_view = GetPacketView(controller.GetNextPacket());
+  auto start_frame_view = EnhancedInformationStartFrameView::Create(
+      EnhancedInformationFrameView::Create(StandardFrameView::Create(BasicFrameView::Create(start_view))));
+  ASSERT_TRUE(start_frame_view.IsValid());
+  EXPECT_EQ(start_frame_view.GetSar(), SegmentationAndReassembly::START);
+  EXPECT_EQ(start_frame_view.GetL2capSduLength(), sdu.size());
+  std::vector<uint8_t> received;
+  auto start_payload = start_frame_view.GetPayload();
+  EXPECT_EQ(start_payload.size(), kSegmentSize);
+  received.insert(received.end(), start_payload.begin(), start_payload.end());
+
+  for (auto sar : {SegmentationAndReassembly::CONTINUATION, SegmentationAndReassembly::END}) {
+    auto view = GetPacketView(controller.GetNextPacket());
+    auto i_frame_view = EnhancedInformationFrameView::Create(StandardFrameView::Create(BasicFrameView::Create(view)));
+    ASSERT_TRUE(i_frame_view.IsValid());
+    EXPECT_EQ(i_frame_view.GetSar(), sar);
+    auto payload = i_frame_view.GetPayload();
+    received.insert(received.end(), payload.begin(), payload.end());
+  }
+  EXPECT_EQ(received, sdu);
+}
+
 TEST_F(ErtmDataControllerTest, receive_no_fcs) {
   common::BidiQueue<Scheduler::UpperEnqueue, Scheduler::UpperDequeue> channel_queue{10};
   testing::MockScheduler scheduler;
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include "hci/acl_manager/deficit_round_robin.h"
 #include "hci/address_with_type.h"
 #include "l2cap/cid.h"
 
@@ -41,6 +42,10 @@ class ILink {
 
   // Used by A2dp software encoding
   virtual void SetChannelTxPriority(Cid local_cid, bool high_priority) {}
+
+  // Used by scheduler to indicate the highest traffic class of the pending packets, for the ACL scheduler to share the
+  // controller buffers between links accordingly
+  virtual void OnTrafficClassChange(hci::acl_manager::DeficitRoundRobin::TrafficClass traffic_class) {}
 };
 }  // namespace internal
 }  // namespace l2cap
@@ -16,6 +16,8 @@
 
 #include "l2cap/internal/le_credit_based_channel_data_controller.h"
 
+#include <algorithm>
+
 #include "l2cap/l2cap_packets.h"
 #include "l2cap/le/internal/link.h"
 #include "packet/fragmenting_inserter.h"
@@ -74,6 +76,7 @@ void LeCreditBasedDataController::OnPdu(packet::PacketView<true> pdu) {
     LOG_WARN("Received frame size %d > mps %d, dropping the packet", static_cast<int>(basic_frame_view.size()), mps_);
     return;
   }
+  bool sdu_too_large = false;
   if (remaining_sdu_continuation_packet_size_ == 0) {
     auto start_frame_view = FirstLeInformationFrameView::Create(basic_frame_view);
     if (!start_frame_view.IsValid()) {
@@ -82,23 +85,33 @@ void LeCreditBasedDataController::OnPdu(packet::PacketView<true> pdu) {
     }
     auto payload = start_frame_view.GetPayload();
     auto sdu_size = start_frame_view.GetL2capSduLength();
+    sdu_too_large = sdu_size > mtu_ || payload.size() > sdu_size;
     remaining_sdu_continuation_packet_size_ = sdu_size - payload.size();
     reassembly_stage_ = payload;
   } else {
     auto payload = basic_frame_view.GetPayload();
+    sdu_too_large = payload.size() > remaining_sdu_continuation_packet_size_;
     remaining_sdu_continuation_packet_size_ -= payload.size();
-    reassembly_stage_.AppendPacketView(payload);
+    reassembly_continuations_.push_back(payload);
   }
-  if (remaining_sdu_continuation_packet_size_ == 0) {
-    enqueue_buffer_.Enqueue(std::make_unique<PacketView<kLittleEndian>>(reassembly_stage_), handler_);
-  } else if (remaining_sdu_continuation_packet_size_ < 0 || reassembly_stage_.size() > mtu_) {
+  if (sdu_too_large) {
     LOG_WARN("Received larger SDU size than expected");
     reassembly_stage_ = PacketViewForReassembly(PacketView<kLittleEndian>(std::make_shared<std::vector<uint8_t>>()));
+    reassembly_continuations_.clear();
     remaining_sdu_continuation_packet_size_ = 0;
     link_->SendDisconnectionRequest(cid_, remote_cid_);
+  } else if (remaining_sdu_continuation_packet_size_ == 0) {
+    // The SDU references the buffers of the K-frames, nothing is copied
+    reassembly_stage_.AppendPacketViews(reassembly_continuations_);
+    reassembly_continuations_.clear();
+    enqueue_buffer_.Enqueue(std::make_unique<PacketView<kLittleEndian>>(reassembly_stage_), handler_);
   }
   // TODO: Improve the logic by sending credit only after user dequeued the SDU
-  link_->SendLeCredit(cid_, 1);
+  pending_credits_++;
+  if (pending_credits_ >= credit_return_threshold_) {
+    link_->SendLeCredit(cid_, pending_credits_);
+    pending_credits_ = 0;
+  }
 }
 
 std::unique_ptr<packet::BasePacketBuilder> LeCreditBasedDataController::GetNextPacket() {
@@ -116,6 +129,11 @@ void LeCreditBasedDataController::SetMps(uint16_t mps) {
   mps_ = mps;
 }
 
+void LeCreditBasedDataController::SetInitialRxCredits(uint16_t credits) {
+  // Returning credits once half of them are used keeps the remote sending without a credit packet per K-frame
+  credit_return_threshold_ = std::max<uint16_t>(credits / 2, 1);
+}
+
 void LeCreditBasedDataController::OnCredit(uint16_t credits) {
   int total_credits = credits_ + credits;
   if (total_credits > 0xffff) {
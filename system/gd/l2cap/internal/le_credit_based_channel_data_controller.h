@@ -19,6 +19,7 @@
 #include <memory>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "common/bidi_queue.h"
 #include "l2cap/cid.h"
@@ -55,6 +56,9 @@ class LeCreditBasedDataController : public DataController {
   // TODO: Set MTU and MPS from signalling channel
   void SetMtu(Mtu mtu);
   void SetMps(uint16_t mps);
+  // Credits granted to the remote when the channel was opened. Received K-frames are credited back in batches of half
+  // of them, instead of one credit packet per K-frame.
+  void SetInitialRxCredits(uint16_t credits);
   // TODO: Handle credits
   void OnCredit(uint16_t credits);
 
@@ -70,15 +74,19 @@ class LeCreditBasedDataController : public DataController {
   uint16_t mps_ = 251;
   uint16_t credits_ = 0;
   uint16_t pending_frames_count_ = 0;
+  uint16_t pending_credits_ = 0;
+  uint16_t credit_return_threshold_ = 1;
 
   class PacketViewForReassembly : public packet::PacketView<kLittleEndian> {
    public:
     PacketViewForReassembly(const PacketView& packetView) : PacketView(packetView) {}
-    void AppendPacketView(packet::PacketView<kLittleEndian> to_append) {
+    void AppendPacketViews(const std::vector<packet::PacketView<kLittleEndian>>& to_append) {
       Append(to_append);
     }
   };
   PacketViewForReassembly reassembly_stage_{PacketView<kLittleEndian>(std::make_shared<std::vector<uint8_t>>())};
+  // Payloads of the continuation K-frames, appended to |reassembly_stage_| at once when the SDU is complete
+  std::vector<PacketView<kLittleEndian>> reassembly_continuations_;
   uint16_t remaining_sdu_continuation_packet_size_ = 0;
 };
 
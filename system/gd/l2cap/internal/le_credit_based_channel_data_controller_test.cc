@@ -179,6 +179,53 @@ TEST_F(LeCreditBasedDataControllerTest, receive_segmented_with_wrong_sdu_length)
   EXPECT_EQ(payload, nullptr);
 }
 
+TEST_F(LeCreditBasedDataControllerTest, receive_segmented_sdu_of_many_k_frames) {
+  common::BidiQueue<Scheduler::UpperEnqueue, Scheduler::UpperDequeue> channel_queue{10};
+  testing::MockScheduler scheduler;
+  testing::MockILink link;
+  LeCreditBasedDataController controller{&link, 0x41, 0x41, channel_queue.GetDownEnd(), queue_handler_, &scheduler};
+  controller.SetMtu(1000);
+  controller.OnCredit(10);
+  std::string expected;
+  for (size_t i = 0; i < 100; i++) {
+    std::vector<uint8_t> segment(10, 'a' + i % 26);
+    expected.append(segment.begin(), segment.end());
+    std::unique_ptr<BasicFrameBuilder> builder;
+    if (i == 0) {
+      builder = FirstLeInformationFrameBuilder::Create(0x41, 1000, CreateSdu(segment));
+    } else {
+      builder = BasicFrameBuilder::Create(0x41, CreateSdu(segment));
+    }
+    controller.OnPdu(GetPacketView(std::move(builder)));
+  }
+  sync_handler(queue_handler_);
+  auto payload = channel_queue.GetUpEnd()->TryDequeue();
+  EXPECT_NE(payload, nullptr);
+  std::string data = std::string(payload->begin(), payload->end());
+  EXPECT_EQ(data, expected);
+}
+
+TEST_F(LeCreditBasedDataControllerTest, receive_returns_credits_in_batches) {
+  common::BidiQueue<Scheduler::UpperEnqueue, Scheduler::UpperDequeue> channel_queue{10};
+  testing::MockScheduler scheduler;
+  testing::MockILink link;
+  LeCreditBasedDataController controller{&link, 0x41, 0x41, channel_queue.GetDownEnd(), queue_handler_, &scheduler};
+  controller.SetInitialRxCredits(8);
+  controller.OnCredit(10);
+  // Half of the initial credits are returned at once
+  EXPECT_CALL(link, SendLeCredit(0x41, 4)).Times(2);
+  for (size_t i = 0; i < 9; i++) {
+    auto builder = FirstLeInformationFrameBuilder::Create(0x41, 1, CreateSdu({static_cast<uint8_t>(i)}));
+    controller.OnPdu(GetPacketView(std::move(builder)));
+  }
+  sync_handler(queue_handler_);
+  for (size_t i = 0; i < 9; i++) {
+    auto payload = channel_queue.GetUpEnd()->TryDequeue();
+    ASSERT_NE(payload, nullptr);
+    EXPECT_EQ(payload->at(0), i);
+  }
+}
+
 }  // namespace
 }  // namespace internal
 }  // namespace l2cap
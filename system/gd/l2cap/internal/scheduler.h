@@ -19,6 +19,7 @@
 #include <cstdint>
 
 #include "common/bidi_queue.h"
+#include "hci/acl_manager/deficit_round_robin.h"
 #include "l2cap/cid.h"
 #include "l2cap/classic/dynamic_channel_configuration_option.h"
 #include "l2cap/internal/channel_impl.h"
@@ -48,6 +49,8 @@ class Scheduler {
   using LowerEnqueue = UpperDequeue;
   using LowerDequeue = UpperEnqueue;
   using LowerQueueUpEnd = common::BidiQueueEnd<LowerEnqueue, LowerDequeue>;
+  // Same classes as the ACL links, in increasing order of priority
+  using TrafficClass = hci::acl_manager::DeficitRoundRobin::TrafficClass;
 
   /**
    * Callback from the sender to indicate that the scheduler could dequeue number_packets from it
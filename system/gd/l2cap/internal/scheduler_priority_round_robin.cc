@@ -0,0 +1,219 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "l2cap/internal/scheduler_priority_round_robin.h"
+
+#include <algorithm>
+
+#include "common/bind.h"
+#include "l2cap/internal/data_pipeline_manager.h"
+#include "os/log.h"
+
+namespace bluetooth {
+namespace l2cap {
+namespace internal {
+
+PriorityRoundRobin::PriorityRoundRobin(
+    DataPipelineManager* data_pipeline_manager, LowerQueueUpEnd* link_queue_up_end, os::Handler* handler)
+    : data_pipeline_manager_(data_pipeline_manager), link_queue_up_end_(link_queue_up_end), handler_(handler) {
+  ASSERT(link_queue_up_end_ != nullptr && handler_ != nullptr);
+}
+
+// Invoked from some external Handler context
+PriorityRoundRobin::~PriorityRoundRobin() {
+  if (link_queue_enqueue_registered_.exchange(false)) {
+    link_queue_up_end_->UnregisterEnqueue();
+  }
+}
+
+Scheduler::TrafficClass PriorityRoundRobin::GetDefaultTrafficClass(Cid cid) {
+  return cid <= kLastFixedChannel ? TrafficClass::INTERACTIVE : TrafficClass::BULK;
+}
+
+// Invoked within L2CAP Handler context
+void PriorityRoundRobin::OnPacketsReady(Cid cid, int number_packets) {
+  if (number_packets == 0) {
+    return;
+  }
+  auto& channel = get_channel(cid);
+  if (channel.num_packets == 0) {
+    ready_channels_[static_cast<size_t>(channel.GetTrafficClass())].push_back(cid);
+  }
+  channel.num_packets += number_packets;
+  update_link_traffic_class();
+  try_register_link_queue_enqueue();
+}
+
+// Invoked within L2CAP Handler context
+void PriorityRoundRobin::SetChannelTxPriority(Cid cid, bool high_priority) {
+  // Channels are forgotten once removed, don't bring them back when their priority is reset
+  if (!high_priority && channels_.count(cid) == 0) {
+    return;
+  }
+  auto& channel = get_channel(cid);
+  auto old_traffic_class = channel.GetTrafficClass();
+  channel.high_priority = high_priority;
+  set_channel_traffic_class(cid, channel, old_traffic_class);
+}
+
+void PriorityRoundRobin::SetChannelTrafficClass(Cid cid, TrafficClass traffic_class) {
+  auto& channel = get_channel(cid);
+  auto old_traffic_class = channel.GetTrafficClass();
+  channel.traffic_class = traffic_class;
+  set_channel_traffic_class(cid, channel, old_traffic_class);
+}
+
+void PriorityRoundRobin::SetChannelWeight(Cid cid, uint16_t weight) {
+  ASSERT(weight != 0);
+  get_channel(cid).weight = weight;
+}
+
+void PriorityRoundRobin::SetBurstLimit(uint16_t burst_limit) {
+  burst_limit_ = burst_limit;
+}
+
+Scheduler::TrafficClass PriorityRoundRobin::GetLinkTrafficClass() const {
+  return link_traffic_class_;
+}
+
+void PriorityRoundRobin::RemoveChannel(Cid cid) {
+  auto it = channels_.find(cid);
+  if (it == channels_.end()) {
+    return;
+  }
+  if (it->second.num_packets != 0) {
+    remove_ready_channel(cid, it->second.GetTrafficClass());
+  }
+  channels_.erase(it);
+  update_link_traffic_class();
+  try_unregister_link_queue_enqueue();
+}
+
+PriorityRoundRobin::Channel& PriorityRoundRobin::get_channel(Cid cid) {
+  auto it = channels_.find(cid);
+  if (it == channels_.end()) {
+    Channel channel;
+    channel.traffic_class = GetDefaultTrafficClass(cid);
+    it = channels_.emplace(cid, channel).first;
+  }
+  return it->second;
+}
+
+void PriorityRoundRobin::set_channel_traffic_class(Cid cid, Channel& channel, TrafficClass old_traffic_class) {
+  auto traffic_class = channel.GetTrafficClass();
+  if (traffic_class == old_traffic_class || channel.num_packets == 0) {
+    return;
+  }
+  remove_ready_channel(cid, old_traffic_class);
+  channel.sent_in_turn = 0;
+  ready_channels_[static_cast<size_t>(traffic_class)].push_back(cid);
+  update_link_traffic_class();
+}
+
+void PriorityRoundRobin::remove_ready_channel(Cid cid, TrafficClass traffic_class) {
+  auto& ready_channels = ready_channels_[static_cast<size_t>(traffic_class)];
+  auto it = std::find(ready_channels.begin(), ready_channels.end(), cid);
+  ASSERT(it != ready_channels.end());
+  ready_channels.erase(it);
+}
+
+bool PriorityRoundRobin::has_ready_channels() const {
+  return std::any_of(ready_channels_.begin(), ready_channels_.end(), [](const auto& ready_channels) {
+    return !ready_channels.empty();
+  });
+}
+
+size_t PriorityRoundRobin::select_traffic_class() {
+  size_t highest = kTrafficClassCount - 1;
+  while (ready_channels_[highest].empty()) {
+    ASSERT(highest != 0);
+    highest--;
+  }
+  // The lowest class held back for too long goes first
+  size_t selected = highest;
+  for (size_t traffic_class = 0; burst_limit_ != 0 && traffic_class < highest; traffic_class++) {
+    if (!ready_channels_[traffic_class].empty() && bursts_[traffic_class] >= burst_limit_) {
+      selected = traffic_class;
+      break;
+    }
+  }
+  for (size_t traffic_class = 0; traffic_class < selected; traffic_class++) {
+    if (ready_channels_[traffic_class].empty()) {
+      bursts_[traffic_class] = 0;
+    } else {
+      bursts_[traffic_class]++;
+    }
+  }
+  bursts_[selected] = 0;
+  return selected;
+}
+
+void PriorityRoundRobin::update_link_traffic_class() {
+  auto traffic_class = TrafficClass::BULK;
+  for (size_t i = kTrafficClassCount; i > 0; i--) {
+    if (!ready_channels_[i - 1].empty()) {
+      traffic_class = static_cast<TrafficClass>(i - 1);
+      break;
+    }
+  }
+  if (traffic_class == link_traffic_class_) {
+    return;
+  }
+  link_traffic_class_ = traffic_class;
+  data_pipeline_manager_->OnLinkTrafficClassChange(traffic_class);
+}
+
+// Invoked from some external Queue Reactable context
+std::unique_ptr<Scheduler::UpperDequeue> PriorityRoundRobin::link_queue_enqueue_callback() {
+  ASSERT(has_ready_channels());
+  auto& ready_channels = ready_channels_[select_traffic_class()];
+  auto channel_id = ready_channels.front();
+  auto& channel = channels_.find(channel_id)->second;
+  channel.num_packets--;
+  channel.sent_in_turn++;
+  if (channel.num_packets == 0 || channel.sent_in_turn >= channel.weight) {
+    // Move on to the next channel of the class, this one going last if it has more to send
+    channel.sent_in_turn = 0;
+    ready_channels.pop_front();
+    if (channel.num_packets != 0) {
+      ready_channels.push_back(channel_id);
+    }
+  }
+  auto packet = data_pipeline_manager_->GetDataController(channel_id)->GetNextPacket();
+
+  data_pipeline_manager_->OnPacketSent(channel_id);
+  update_link_traffic_class();
+  try_unregister_link_queue_enqueue();
+  return packet;
+}
+
+void PriorityRoundRobin::try_register_link_queue_enqueue() {
+  if (link_queue_enqueue_registered_.exchange(true)) {
+    return;
+  }
+  link_queue_up_end_->RegisterEnqueue(
+      handler_, common::Bind(&PriorityRoundRobin::link_queue_enqueue_callback, common::Unretained(this)));
+}
+
+void PriorityRoundRobin::try_unregister_link_queue_enqueue() {
+  if (!has_ready_channels() && link_queue_enqueue_registered_.exchange(false)) {
+    link_queue_up_end_->UnregisterEnqueue();
+  }
+}
+
+}  // namespace internal
+}  // namespace l2cap
+}  // namespace bluetooth
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <deque>
+#include <unordered_map>
+
+#include "l2cap/cid.h"
+#include "l2cap/internal/scheduler.h"
+#include "os/handler.h"
+
+namespace bluetooth {
+namespace l2cap {
+namespace internal {
+class DataPipelineManager;
+
+/**
+ * Serve the channels by traffic class, then round robin within a class.
+ *
+ * Fixed channels (signalling, ATT, SMP) are INTERACTIVE, dynamic channels are BULK, and the channels given a high
+ * Tx priority are AUDIO. Within a class, each channel with pending packets sends up to its weight of packets in a row
+ * before the next one gets its turn. Once higher classes sent burst limit packets in a row, a waiting lower class is
+ * let through for one packet so that it is never starved.
+ *
+ * The highest class with pending packets is reported to the link as its traffic class, so that the ACL scheduler
+ * shares the controller buffers between links accordingly.
+ */
+class PriorityRoundRobin : public Scheduler {
+ public:
+  static constexpr size_t kTrafficClassCount = hci::acl_manager::DeficitRoundRobin::kTrafficClassCount;
+  static constexpr uint16_t kDefaultWeight = 1;
+  static constexpr uint16_t kDefaultBurstLimit = 8;
+
+  PriorityRoundRobin(
+      DataPipelineManager* data_pipeline_manager, LowerQueueUpEnd* link_queue_up_end, os::Handler* handler);
+  ~PriorityRoundRobin();
+  void OnPacketsReady(Cid cid, int number_packets) override;
+  void SetChannelTxPriority(Cid cid, bool high_priority) override;
+  void RemoveChannel(Cid cid) override;
+
+  void SetChannelTrafficClass(Cid cid, TrafficClass traffic_class);
+  // Number of packets the channel sends in a row when its turn comes, at least 1
+  void SetChannelWeight(Cid cid, uint16_t weight);
+  // Number of packets higher classes send in a row before a waiting lower class sends one, 0 for no limit
+  void SetBurstLimit(uint16_t burst_limit);
+  TrafficClass GetLinkTrafficClass() const;
+
+  static TrafficClass GetDefaultTrafficClass(Cid cid);
+
+ private:
+  struct Channel {
+    TrafficClass traffic_class;
+    bool high_priority = false;
+    uint16_t weight = kDefaultWeight;
+    int num_packets = 0;
+    uint16_t sent_in_turn = 0;
+
+    TrafficClass GetTrafficClass() const {
+      return high_priority ? TrafficClass::AUDIO : traffic_class;
+    }
+  };
+
+  DataPipelineManager* data_pipeline_manager_;
+  LowerQueueUpEnd* link_queue_up_end_;
+  os::Handler* handler_;
+  std::unordered_map<Cid, Channel> channels_;
+  // Channels with pending packets of each class, the front one sending next
+  std::array<std::deque<Cid>, kTrafficClassCount> ready_channels_;
+  // Packets sent by higher classes since each class last sent one while it was waiting
+  std::array<uint16_t, kTrafficClassCount> bursts_ = {};
+  uint16_t burst_limit_ = kDefaultBurstLimit;
+  TrafficClass link_traffic_class_ = TrafficClass::BULK;
+  std::atomic_bool link_queue_enqueue_registered_ = false;
+
+  Channel& get_channel(Cid cid);
+  void set_channel_traffic_class(Cid cid, Channel& channel, TrafficClass old_traffic_class);
+  void remove_ready_channel(Cid cid, TrafficClass traffic_class);
+  bool has_ready_channels() const;
+  size_t select_traffic_class();
+  void update_link_traffic_class();
+  void try_register_link_queue_enqueue();
+  void try_unregister_link_queue_enqueue();
+  std::unique_ptr<LowerEnqueue> link_queue_enqueue_callback();
+};
+
+}  // namespace internal
+}  // namespace l2cap
+}  // namespace bluetooth
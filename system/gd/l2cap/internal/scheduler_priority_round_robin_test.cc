@@ -0,0 +1,209 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "l2cap/internal/scheduler_priority_round_robin.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <map>
+#include <queue>
+#include <vector>
+
+#include "l2cap/internal/data_controller_mock.h"
+#include "l2cap/internal/data_pipeline_manager_mock.h"
+#include "os/handler.h"
+#include "os/mock_queue.h"
+#include "os/thread.h"
+#include "packet/raw_builder.h"
+
+namespace bluetooth {
+namespace l2cap {
+namespace internal {
+namespace {
+
+using ::testing::_;
+using ::testing::ElementsAre;
+using ::testing::Invoke;
+
+using TrafficClass = Scheduler::TrafficClass;
+
+constexpr Cid kDynamicCid1 = kFirstDynamicChannel;
+constexpr Cid kDynamicCid2 = kFirstDynamicChannel + 1;
+
+PacketView<kLittleEndian> GetPacketView(std::unique_ptr<packet::BasePacketBuilder> packet) {
+  auto bytes = std::make_shared<std::vector<uint8_t>>();
+  BitInserter i(*bytes);
+  bytes->reserve(packet->size());
+  packet->Serialize(i);
+  return packet::PacketView<packet::kLittleEndian>(bytes);
+}
+
+class MyDataController : public testing::MockDataController {
+ public:
+  std::unique_ptr<BasePacketBuilder> GetNextPacket() override {
+    auto next = std::move(next_packets.front());
+    next_packets.pop();
+    return next;
+  }
+
+  std::queue<std::unique_ptr<BasePacketBuilder>> next_packets;
+};
+
+class L2capSchedulerPriorityRoundRobinTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    thread_ = new os::Thread("test_thread", os::Thread::Priority::NORMAL);
+    queue_handler_ = new os::Handler(thread_);
+    mock_data_pipeline_manager_ = new testing::MockDataPipelineManager(queue_handler_, &queue_end_);
+    EXPECT_CALL(*mock_data_pipeline_manager_, GetDataController(_)).WillRepeatedly(Invoke([this](Cid cid) {
+      return &data_controllers_[cid];
+    }));
+    EXPECT_CALL(*mock_data_pipeline_manager_, OnPacketSent(_)).Times(::testing::AnyNumber());
+    scheduler_ = new PriorityRoundRobin(mock_data_pipeline_manager_, &queue_end_, queue_handler_);
+  }
+
+  void TearDown() override {
+    delete scheduler_;
+    delete mock_data_pipeline_manager_;
+    queue_handler_->Clear();
+    delete queue_handler_;
+    delete thread_;
+  }
+
+  void QueuePackets(Cid cid, int number_packets) {
+    for (int i = 0; i < number_packets; i++) {
+      auto raw_builder = std::make_unique<packet::RawBuilder>();
+      raw_builder->AddOctets({'a', 'b', 'c'});
+      data_controllers_[cid].next_packets.push(BasicFrameBuilder::Create(cid, std::move(raw_builder)));
+    }
+    scheduler_->OnPacketsReady(cid, number_packets);
+  }
+
+  // Channels of the packets sent to the link, in order
+  std::vector<Cid> SendPackets(unsigned number_packets) {
+    enqueue_.run_enqueue(number_packets);
+    std::vector<Cid> cids;
+    while (!enqueue_.enqueued.empty()) {
+      auto packet_view = GetPacketView(std::move(enqueue_.enqueued.front()));
+      enqueue_.enqueued.pop();
+      auto basic_frame_view = BasicFrameView::Create(packet_view);
+      EXPECT_TRUE(basic_frame_view.IsValid());
+      cids.push_back(basic_frame_view.GetChannelId());
+    }
+    return cids;
+  }
+
+  os::Thread* thread_ = nullptr;
+  os::Handler* queue_handler_ = nullptr;
+  os::MockIQueueDequeue<Scheduler::LowerDequeue> dequeue_;
+  os::MockIQueueEnqueue<Scheduler::LowerEnqueue> enqueue_;
+  common::BidiQueueEnd<Scheduler::LowerEnqueue, Scheduler::LowerDequeue> queue_end_{&enqueue_, &dequeue_};
+  testing::MockDataPipelineManager* mock_data_pipeline_manager_ = nullptr;
+  std::map<Cid, MyDataController> data_controllers_;
+  PriorityRoundRobin* scheduler_ = nullptr;
+};
+
+TEST_F(L2capSchedulerPriorityRoundRobinTest, send_packet) {
+  QueuePackets(kDynamicCid1, 1);
+  EXPECT_THAT(SendPackets(2), ElementsAre(kDynamicCid1));
+  // Nothing left to send
+  EXPECT_EQ(enqueue_.registered_handler, nullptr);
+}
+
+TEST_F(L2capSchedulerPriorityRoundRobinTest, fixed_channel_before_dynamic_channel) {
+  QueuePackets(kDynamicCid1, 2);
+  QueuePackets(kLeAttributeCid, 1);
+  QueuePackets(kLeSignallingCid, 1);
+  EXPECT_THAT(SendPackets(4), ElementsAre(kLeAttributeCid, kLeSignallingCid, kDynamicCid1, kDynamicCid1));
+}
+
+TEST_F(L2capSchedulerPriorityRoundRobinTest, prioritize_channel) {
+  scheduler_->SetChannelTxPriority(kDynamicCid2, true);
+  QueuePackets(kLeAttributeCid, 1);
+  QueuePackets(kDynamicCid1, 1);
+  QueuePackets(kDynamicCid2, 1);
+  EXPECT_THAT(SendPackets(3), ElementsAre(kDynamicCid2, kLeAttributeCid, kDynamicCid1));
+
+  // Back to a regular dynamic channel, including its pending packets
+  QueuePackets(kDynamicCid1, 1);
+  QueuePackets(kDynamicCid2, 1);
+  scheduler_->SetChannelTxPriority(kDynamicCid2, false);
+  QueuePackets(kLeAttributeCid, 1);
+  EXPECT_THAT(SendPackets(3), ElementsAre(kLeAttributeCid, kDynamicCid1, kDynamicCid2));
+}
+
+TEST_F(L2capSchedulerPriorityRoundRobinTest, weighted_round_robin) {
+  scheduler_->SetChannelWeight(kDynamicCid1, 2);
+  QueuePackets(kDynamicCid1, 5);
+  QueuePackets(kDynamicCid2, 2);
+  EXPECT_THAT(
+      SendPackets(7),
+      ElementsAre(kDynamicCid1, kDynamicCid1, kDynamicCid2, kDynamicCid1, kDynamicCid1, kDynamicCid2, kDynamicCid1));
+}
+
+TEST_F(L2capSchedulerPriorityRoundRobinTest, burst_limit) {
+  scheduler_->SetBurstLimit(2);
+  scheduler_->SetChannelTrafficClass(kDynamicCid2, TrafficClass::AUDIO);
+  QueuePackets(kDynamicCid1, 2);
+  QueuePackets(kLeAttributeCid, 3);
+  QueuePackets(kDynamicCid2, 5);
+  EXPECT_THAT(
+      SendPackets(10),
+      ElementsAre(
+          kDynamicCid2,
+          kDynamicCid2,
+          kDynamicCid1,
+          kLeAttributeCid,
+          kDynamicCid2,
+          kDynamicCid1,
+          kDynamicCid2,
+          kLeAttributeCid,
+          kDynamicCid2,
+          kLeAttributeCid));
+}
+
+TEST_F(L2capSchedulerPriorityRoundRobinTest, link_traffic_class) {
+  {
+    ::testing::InSequence s;
+    EXPECT_CALL(*mock_data_pipeline_manager_, OnLinkTrafficClassChange(TrafficClass::INTERACTIVE));
+    EXPECT_CALL(*mock_data_pipeline_manager_, OnLinkTrafficClassChange(TrafficClass::BULK));
+  }
+  QueuePackets(kDynamicCid1, 1);
+  EXPECT_EQ(scheduler_->GetLinkTrafficClass(), TrafficClass::BULK);
+  QueuePackets(kLeAttributeCid, 1);
+  EXPECT_EQ(scheduler_->GetLinkTrafficClass(), TrafficClass::INTERACTIVE);
+  EXPECT_THAT(SendPackets(1), ElementsAre(kLeAttributeCid));
+  EXPECT_EQ(scheduler_->GetLinkTrafficClass(), TrafficClass::BULK);
+  EXPECT_THAT(SendPackets(1), ElementsAre(kDynamicCid1));
+  EXPECT_EQ(scheduler_->GetLinkTrafficClass(), TrafficClass::BULK);
+}
+
+TEST_F(L2capSchedulerPriorityRoundRobinTest, remove_channel) {
+  QueuePackets(kDynamicCid1, 1);
+  QueuePackets(kDynamicCid2, 1);
+  scheduler_->RemoveChannel(kDynamicCid1);
+  EXPECT_THAT(SendPackets(2), ElementsAre(kDynamicCid2));
+
+  QueuePackets(kDynamicCid2, 1);
+  scheduler_->RemoveChannel(kDynamicCid2);
+  EXPECT_EQ(enqueue_.registered_handler, nullptr);
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace l2cap
+}  // namespace bluetooth
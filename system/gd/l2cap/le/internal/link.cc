@@ -305,6 +305,10 @@ void Link::OnPendingPacketChange(Cid local_cid, bool has_packet) {
   link_manager_->OnPendingPacketChange(GetDevice(), remaining_packets_to_be_sent_);
 }
 
+void Link::OnTrafficClassChange(hci::acl_manager::DeficitRoundRobin::TrafficClass traffic_class) {
+  link_manager_->OnTrafficClassChange(GetAclConnection()->GetHandle(), traffic_class);
+}
+
 }  // namespace internal
 }  // namespace le
 }  // namespace l2cap
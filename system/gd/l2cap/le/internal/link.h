@@ -157,6 +157,8 @@ class Link : public l2cap::internal::ILink, public hci::acl_manager::LeConnectio
 
   void OnPendingPacketChange(Cid local_cid, bool has_packet) override;
 
+  void OnTrafficClassChange(hci::acl_manager::DeficitRoundRobin::TrafficClass traffic_class) override;
+
  private:
   os::Handler* l2cap_handler_;
   l2cap::internal::FixedChannelAllocator<FixedChannelImpl, Link> fixed_channel_allocator_{this, l2cap_handler_};
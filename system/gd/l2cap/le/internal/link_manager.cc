@@ -211,6 +211,11 @@ void LinkManager::OnPendingPacketChange(hci::AddressWithType remote, int num_pac
   }
 }
 
+void LinkManager::OnTrafficClassChange(
+    uint16_t handle, hci::acl_manager::DeficitRoundRobin::TrafficClass traffic_class) {
+  acl_manager_->SetAclTrafficClass(handle, traffic_class);
+}
+
 }  // namespace internal
 }  // namespace le
 }  // namespace l2cap
@@ -102,6 +102,9 @@ class LinkManager : public hci::acl_manager::LeConnectionCallbacks {
   // If there is anything outstanding, don't delete link
   void OnPendingPacketChange(hci::AddressWithType remote, int num_packets);
 
+  // Reported by link when the highest traffic class of its pending packets changes
+  void OnTrafficClassChange(uint16_t handle, hci::acl_manager::DeficitRoundRobin::TrafficClass traffic_class);
+
  private:
   // Dependencies
   os::Handler* l2cap_handler_;
@@ -17,6 +17,9 @@
 
 #include "metrics/counter_metrics.h"
 
+#include <algorithm>
+#include <climits>
+
 #include "common/bind.h"
 #include "os/log.h"
 #include "os/metrics.h"
@@ -26,8 +29,47 @@ namespace metrics {
 
 const int COUNTER_METRICS_PERDIOD_MINUTES = 360; // Drain counters every 6 hours
 
+namespace {
+
+std::atomic<uint64_t> next_counter_metrics_id{0};
+
+int64_t SaturatingAdd(int64_t total, int64_t count) {
+  return (LLONG_MAX - total < count) ? LLONG_MAX : total + count;
+}
+
+}  // namespace
+
 const ModuleFactory CounterMetrics::Factory = ModuleFactory([]() { return new CounterMetrics(); });
 
+CounterMetrics::CounterMetrics() : id_(next_counter_metrics_id++) {}
+
+std::optional<size_t> CounterMetrics::GetLockFreeIndex(int32_t key) {
+  auto it = std::find(kLockFreeKeys.begin(), kLockFreeKeys.end(), key);
+  if (it == kLockFreeKeys.end()) {
+    return std::nullopt;
+  }
+  return it - kLockFreeKeys.begin();
+}
+
+CounterMetrics::ThreadCounters* CounterMetrics::GetThreadCounters() {
+  // The thread keeps its counters of each instance, the lock is only taken the first time
+  thread_local std::unordered_map<uint64_t, std::shared_ptr<ThreadCounters>> counters;
+  thread_local uint64_t last_id = UINT64_MAX;
+  thread_local ThreadCounters* last_counters = nullptr;
+  if (last_id == id_) {
+    return last_counters;
+  }
+  auto& thread_counters = counters[id_];
+  if (thread_counters == nullptr) {
+    thread_counters = std::make_shared<ThreadCounters>();
+    std::lock_guard<std::mutex> lock(mutex_);
+    thread_counters_.push_back(thread_counters);
+  }
+  last_id = id_;
+  last_counters = thread_counters.get();
+  return last_counters;
+}
+
 void CounterMetrics::ListDependencies(ModuleList* list) const {
 }
 
@@ -58,6 +100,21 @@ bool CounterMetrics::Count(int32_t key, int64_t count) {
     LOG_WARN("count is not larger than 0. count: %s, key: %d", std::to_string(count).c_str(), key);
     return false;
   }
+  auto index = GetLockFreeIndex(key);
+  if (index) {
+    // Only this thread adds to the slot, the drain resets it concurrently
+    std::atomic<int64_t>& slot = GetThreadCounters()->counts[*index];
+    int64_t total = slot.load(std::memory_order_relaxed);
+    while (!slot.compare_exchange_weak(
+        total, SaturatingAdd(total, count), std::memory_order_relaxed, std::memory_order_relaxed)) {
+    }
+    if (LLONG_MAX - total < count) {
+      LOG_WARN("Counter metric overflows. count %s current total: %s key: %d",
+               std::to_string(count).c_str(), std::to_string(total).c_str(), key);
+      return false;
+    }
+    return true;
+  }
   int64_t total = 0;
   std::lock_guard<std::mutex> lock(mutex_);
   if (counters_.find(key) != counters_.end()) {
@@ -84,6 +141,17 @@ void CounterMetrics::DrainBufferedCounters() {
   }
   std::lock_guard<std::mutex> lock(mutex_);
   LOG_INFO("Draining buffered counters");
+  for (auto it = thread_counters_.begin(); it != thread_counters_.end();) {
+    // Checked first, the counters of a thread that exited are not filled anymore
+    bool exited = it->use_count() == 1;
+    for (size_t i = 0; i < kLockFreeKeys.size(); i++) {
+      int64_t count = (*it)->counts[i].exchange(0, std::memory_order_relaxed);
+      if (count > 0) {
+        counters_[kLockFreeKeys[i]] = SaturatingAdd(counters_[kLockFreeKeys[i]], count);
+      }
+    }
+    it = exited ? thread_counters_.erase(it) : it + 1;
+  }
   for (auto const& pair : counters_) {
     WriteCounter(pair.first, pair.second);
   }
@@ -15,7 +15,16 @@
  */
 #pragma once
 
+#include <frameworks/proto_logging/stats/enums/bluetooth/enums.pb.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <unordered_map>
+#include <vector>
 
 #include "module.h"
 #include "os/repeating_alarm.h"
@@ -25,6 +34,46 @@ namespace metrics {
 
 class CounterMetrics : public bluetooth::Module {
  public:
+  // Keys counted without taking a lock: each thread counting them adds to its own slots, which are merged when the
+  // counters are drained. The other keys are counted under a lock
+  static constexpr std::array<int32_t, 33> kLockFreeKeys = {
+      android::bluetooth::CodePathCounterKeyEnum::L2CAP_CONNECT_CONFIRM_NEG,
+      android::bluetooth::CodePathCounterKeyEnum::L2CAP_NO_COMPATIBLE_CHANNEL_AT_CSM_CLOSED,
+      android::bluetooth::CodePathCounterKeyEnum::L2CAP_SECURITY_NEG_AT_CSM_CLOSED,
+      android::bluetooth::CodePathCounterKeyEnum::L2CAP_TIMEOUT_AT_CSM_CLOSED,
+      android::bluetooth::CodePathCounterKeyEnum::L2CAP_CREDIT_BASED_CONNECT_RSP_NEG,
+      android::bluetooth::CodePathCounterKeyEnum::L2CAP_CONNECT_RSP_NEG,
+      android::bluetooth::CodePathCounterKeyEnum::L2CAP_INFO_NO_COMPATIBLE_CHANNEL_AT_RSP,
+      android::bluetooth::CodePathCounterKeyEnum::L2CAP_CONFIG_REQ_FAILURE,
+      android::bluetooth::CodePathCounterKeyEnum::L2CAP_CONFIG_RSP_NEG,
+      android::bluetooth::CodePathCounterKeyEnum::L2CAP_NO_COMPATIBLE_CHANNEL_AT_W4_SEC,
+      android::bluetooth::CodePathCounterKeyEnum::L2CAP_SECURITY_NEG_AT_W4_SEC,
+      android::bluetooth::CodePathCounterKeyEnum::L2CAP_TIMEOUT_AT_CONNECT_RSP,
+      android::bluetooth::CodePathCounterKeyEnum::L2CAP_CONN_OTHER_ERROR_AT_CONNECT_RSP,
+      android::bluetooth::CodePathCounterKeyEnum::SDP_FAILURE,
+      android::bluetooth::CodePathCounterKeyEnum::SDP_SUCCESS,
+      android::bluetooth::CodePathCounterKeyEnum::RFCOMM_CONNECTION_SUCCESS_IND,
+      android::bluetooth::CodePathCounterKeyEnum::RFCOMM_CONNECTION_SUCCESS_CNF,
+      android::bluetooth::CodePathCounterKeyEnum::RFCOMM_PORT_START_CNF_FAILED,
+      android::bluetooth::CodePathCounterKeyEnum::RFCOMM_PORT_START_CLOSE,
+      android::bluetooth::CodePathCounterKeyEnum::RFCOMM_PORT_START_FAILED,
+      android::bluetooth::CodePathCounterKeyEnum::RFCOMM_PORT_NEG_FAILED,
+      android::bluetooth::CodePathCounterKeyEnum::RFCOMM_PORT_CLOSED,
+      android::bluetooth::CodePathCounterKeyEnum::RFCOMM_PORT_PEER_CONNECTION_FAILED,
+      android::bluetooth::CodePathCounterKeyEnum::RFCOMM_PORT_PEER_TIMEOUT,
+      android::bluetooth::CodePathCounterKeyEnum::A2DP_CONNECTION_SUCCESS,
+      android::bluetooth::CodePathCounterKeyEnum::A2DP_CONNECTION_ACL_DISCONNECTED,
+      android::bluetooth::CodePathCounterKeyEnum::A2DP_CONNECTION_REJECT_EVT,
+      android::bluetooth::CodePathCounterKeyEnum::A2DP_CONNECTION_FAILURE,
+      android::bluetooth::CodePathCounterKeyEnum::A2DP_CONNECTION_DISCONNECTED,
+      android::bluetooth::CodePathCounterKeyEnum::A2DP_CONNECTION_UNKNOWN_EVENT,
+      android::bluetooth::CodePathCounterKeyEnum::A2DP_ALREADY_CONNECTING,
+      android::bluetooth::CodePathCounterKeyEnum::A2DP_OFFLOAD_START_REQ_FAILURE,
+      android::bluetooth::CodePathCounterKeyEnum::A2DP_CONNECTION_CLOSE,
+  };
+
+  CounterMetrics();
+
   bool Count(int32_t key, int64_t value);
   void Stop() override;
   static const ModuleFactory Factory;
@@ -42,11 +91,23 @@ class CounterMetrics : public bluetooth::Module {
   }
 
  private:
+  // Counts of the lock free keys by a single thread, only ever reset by the drain
+  struct alignas(64) ThreadCounters {
+    std::array<std::atomic<int64_t>, kLockFreeKeys.size()> counts{};
+  };
+
+  static std::optional<size_t> GetLockFreeIndex(int32_t key);
+  ThreadCounters* GetThreadCounters();
+
   std::unordered_map<int32_t, int64_t> counters_;
+  // Counters of all the threads that counted a lock free key, kept after they exit until drained
+  std::vector<std::shared_ptr<ThreadCounters>> thread_counters_;
   mutable std::mutex mutex_;
+  // Distinguishes the instances in the thread local counters
+  const uint64_t id_;
   std::unique_ptr<os::RepeatingAlarm> alarm_;
   bool initialized_ {false};
 };
 
 }  // namespace metrics
-}  // namespace bluetooth
\ No newline at end of file
+}  // namespace bluetooth
@@ -16,7 +16,9 @@
 
 #include "metrics/counter_metrics.h"
 
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -86,6 +88,50 @@ TEST_F(CounterMetricsTest, non_positive) {
   ASSERT_EQ(testable_counter_metrics_.test_counters_[1], 5);
 }
 
+TEST_F(CounterMetricsTest, lock_free_keys) {
+  const int32_t key = CounterMetrics::kLockFreeKeys[0];
+  const int32_t other_key = CounterMetrics::kLockFreeKeys[1];
+  ASSERT_TRUE(testable_counter_metrics_.Count(key, 2));
+  ASSERT_TRUE(testable_counter_metrics_.Count(key, 3));
+  ASSERT_TRUE(testable_counter_metrics_.Count(other_key, 4));
+  testable_counter_metrics_.DrainBuffer();
+  ASSERT_EQ(testable_counter_metrics_.test_counters_[key], 5);
+  ASSERT_EQ(testable_counter_metrics_.test_counters_[other_key], 4);
+  testable_counter_metrics_.test_counters_.clear();
+  testable_counter_metrics_.DrainBuffer();
+  ASSERT_TRUE(testable_counter_metrics_.test_counters_.empty());
+
+  ASSERT_TRUE(testable_counter_metrics_.Count(key, LLONG_MAX));
+  ASSERT_FALSE(testable_counter_metrics_.Count(key, 1));
+  testable_counter_metrics_.DrainBuffer();
+  ASSERT_EQ(testable_counter_metrics_.test_counters_[key], LLONG_MAX);
+}
+
+TEST_F(CounterMetricsTest, lock_free_keys_across_threads) {
+  const int32_t key = CounterMetrics::kLockFreeKeys[0];
+  const int kNumThreads = 4;
+  const int kNumCounts = 10000;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; i++) {
+    threads.emplace_back([this, key]() {
+      for (int j = 0; j < kNumCounts; j++) {
+        ASSERT_TRUE(testable_counter_metrics_.Count(key, 1));
+      }
+    });
+  }
+  // Draining while counting loses nothing
+  testable_counter_metrics_.DrainBuffer();
+  int64_t total = testable_counter_metrics_.test_counters_[key];
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  // The counts of the threads that exited are kept until drained
+  testable_counter_metrics_.test_counters_.clear();
+  ASSERT_TRUE(testable_counter_metrics_.Count(key, 1));
+  testable_counter_metrics_.DrainBuffer();
+  ASSERT_EQ(total + testable_counter_metrics_.test_counters_[key], kNumThreads * kNumCounts + 1);
+}
+
 }  // namespace
 }  // namespace metrics
 }  // namespace bluetooth
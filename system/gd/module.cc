@@ -16,8 +16,20 @@
 #define LOG_TAG "BtGdModule"
 
 #include "module.h"
+
+#include <flatbuffers/reflection.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <set>
+#include <thread>
+#include <unordered_map>
+
 #include "common/init_flags.h"
 #include "dumpsys/init_flags.h"
+#include "os/system_properties.h"
+#include "os/task_profiler.h"
 #include "os/wakelock_manager.h"
 
 using ::bluetooth::os::Handler;
@@ -27,6 +39,15 @@ using ::bluetooth::os::WakelockManager;
 namespace bluetooth {
 
 constexpr std::chrono::milliseconds kModuleStopTimeout = std::chrono::milliseconds(2000);
+constexpr char kStartThreadsProperty[] = "persist.bluetooth.module_start_threads";
+
+namespace {
+
+double milliseconds_since(std::chrono::steady_clock::time_point begin) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+}
+
+}  // namespace
 
 ModuleFactory::ModuleFactory(std::function<Module*()> ctor) : ctor_(ctor) {
 }
@@ -41,6 +62,10 @@ DumpsysDataFinisher Module::GetDumpsysData(flatbuffers::FlatBufferBuilder* build
   return EmptyDumpsysDataFinisher;
 }
 
+uint64_t Module::GetDumpsysDataVersion() const {
+  return kDumpsysDataUnversioned;
+}
+
 const ModuleRegistry* Module::GetModuleRegistry() const {
   return registry_;
 }
@@ -56,48 +81,172 @@ Module* Module::GetDependency(const ModuleFactory* module) const {
 }
 
 Module* ModuleRegistry::Get(const ModuleFactory* module) const {
+  std::lock_guard<std::mutex> lock(started_modules_mutex_);
   auto instance = started_modules_.find(module);
   ASSERT_LOG(instance != started_modules_.end(), "Request for module not started up, maybe not in Start(ModuleList)?");
   return instance->second;
 }
 
 bool ModuleRegistry::IsStarted(const ModuleFactory* module) const {
+  std::lock_guard<std::mutex> lock(started_modules_mutex_);
   return started_modules_.find(module) != started_modules_.end();
 }
 
-void ModuleRegistry::Start(ModuleList* modules, Thread* thread) {
-  for (auto it = modules->list_.begin(); it != modules->list_.end(); it++) {
-    Start(*it, thread);
-  }
+void ModuleRegistry::SetStartThreads(size_t num_threads) {
+  ASSERT_LOG(num_threads > 0, "Modules need a thread to start on");
+  start_threads_ = num_threads;
 }
 
-void ModuleRegistry::set_registry_and_handler(Module* instance, Thread* thread) const {
-  instance->registry_ = this;
-  instance->handler_ = new Handler(thread);
+void ModuleRegistry::SetStartThreadsFromSystemProperty() {
+  auto value = os::GetSystemProperty(kStartThreadsProperty);
+  if (!value) {
+    SetStartThreads(kDefaultStartThreads);
+    return;
+  }
+  char* end = nullptr;
+  unsigned long num_threads = std::strtoul(value->c_str(), &end, 10);
+  if (value->empty() || *end != '\0' || num_threads == 0) {
+    LOG_WARN("Invalid %s:%s", kStartThreadsProperty, value->c_str());
+    SetStartThreads(kDefaultStartThreads);
+    return;
+  }
+  SetStartThreads(num_threads);
 }
 
-Module* ModuleRegistry::Start(const ModuleFactory* module, Thread* thread) {
-  auto started_instance = started_modules_.find(module);
-  if (started_instance != started_modules_.end()) {
-    return started_instance->second;
+struct ModuleRegistry::PendingModule {
+  const ModuleFactory* factory;
+  Module* instance;
+  // Dependencies not started yet
+  size_t waiting_for;
+  // Position of the modules depending on this one in the pending list
+  std::vector<size_t> dependents;
+};
+
+namespace {
+
+template <typename PendingModule>
+size_t find_pending(const std::vector<PendingModule>& pending, const ModuleFactory* module) {
+  for (size_t i = 0; i < pending.size(); i++) {
+    if (pending[i].factory == module) {
+      return i;
+    }
   }
+  return pending.size();
+}
+
+}  // namespace
 
+void ModuleRegistry::construct_pending(
+    const ModuleFactory* module, Thread* thread, std::vector<PendingModule>* pending) {
   LOG_DEBUG("Constructing next module");
   Module* instance = module->ctor_();
-  last_instance_ = "starting " + instance->ToString();
   set_registry_and_handler(instance, thread);
-
-  LOG_DEBUG("Starting dependencies of %s", instance->ToString().c_str());
   instance->ListDependencies(&instance->dependencies_);
-  Start(&instance->dependencies_, thread);
+  for (auto dependency : instance->dependencies_.list_) {
+    if (!IsStarted(dependency) && find_pending(*pending, dependency) == pending->size()) {
+      construct_pending(dependency, thread, pending);
+    }
+  }
+
+  size_t position = pending->size();
+  pending->push_back(PendingModule{module, instance, 0, {}});
+  for (auto dependency : instance->dependencies_.list_) {
+    if (!IsStarted(dependency)) {
+      (*pending)[find_pending(*pending, dependency)].dependents.push_back(position);
+      (*pending)[position].waiting_for++;
+    }
+  }
+}
+
+void ModuleRegistry::Start(ModuleList* modules, Thread* thread) {
+  // The modules are constructed on the calling thread, dependencies first
+  std::vector<PendingModule> pending;
+  for (auto module : modules->list_) {
+    if (!IsStarted(module) && find_pending(pending, module) == pending.size()) {
+      construct_pending(module, thread, &pending);
+    }
+  }
+  if (pending.empty()) {
+    return;
+  }
+
+  auto begin = std::chrono::steady_clock::now();
+  std::mutex mutex;
+  std::condition_variable ready_changed;
+  // Position of the modules whose dependencies all started. The lowest is started first, so that a single thread
+  // starts the modules in the order they were constructed.
+  std::set<size_t> ready;
+  for (size_t i = 0; i < pending.size(); i++) {
+    if (pending[i].waiting_for == 0) {
+      ready.insert(i);
+    }
+  }
+  size_t remaining = pending.size();
+  size_t running = 0;
+
+  auto start_ready_modules = [&]() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      ready_changed.wait(lock, [&] { return remaining == 0 || !ready.empty() || running == 0; });
+      if (remaining == 0) {
+        return;
+      }
+      ASSERT_LOG(!ready.empty(), "Dependency cycle between the %zu modules left to start", remaining);
+      PendingModule& next = pending[*ready.begin()];
+      ready.erase(ready.begin());
+      running++;
+      last_instance_ = "starting " + next.instance->ToString();
+      lock.unlock();
+
+      auto module_begin = std::chrono::steady_clock::now();
+      next.instance->Start();
+      auto module_end = std::chrono::steady_clock::now();
+      LOG_INFO("Started %s in %.1f ms", next.instance->ToString().c_str(), milliseconds_since(module_begin));
+      {
+        std::lock_guard<std::mutex> started_lock(started_modules_mutex_);
+        start_order_.push_back(next.factory);
+        start_times_.push_back(ModuleStartTime{next.instance->ToString(), module_begin, module_end});
+        started_modules_[next.factory] = next.instance;
+      }
+
+      lock.lock();
+      running--;
+      remaining--;
+      for (size_t dependent : next.dependents) {
+        if (--pending[dependent].waiting_for == 0) {
+          ready.insert(dependent);
+        }
+      }
+      ready_changed.notify_all();
+    }
+  };
+
+  size_t num_threads = std::min(start_threads_, pending.size());
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < num_threads; i++) {
+    threads.emplace_back(start_ready_modules);
+  }
+  start_ready_modules();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  LOG_INFO(
+      "Started %zu modules in %.1f ms on %zu threads", pending.size(), milliseconds_since(begin), num_threads);
+}
 
-  LOG_DEBUG("Finished starting dependencies and calling Start() of %s", instance->ToString().c_str());
+void ModuleRegistry::set_registry_and_handler(Module* instance, Thread* thread) const {
+  instance->registry_ = this;
+  instance->handler_ = new Handler(thread);
+  if (os::TaskProfiler::IsEnabled()) {
+    os::TaskProfiler::SetName(instance->handler_, instance->ToString());
+  }
+}
 
-  instance->Start();
-  start_order_.push_back(module);
-  started_modules_[module] = instance;
-  LOG_DEBUG("Started %s", instance->ToString().c_str());
-  return instance;
+Module* ModuleRegistry::Start(const ModuleFactory* module, Thread* thread) {
+  ModuleList modules;
+  modules.list_.push_back(module);
+  Start(&modules, thread);
+  return Get(module);
 }
 
 void ModuleRegistry::StopAll() {
@@ -124,9 +273,16 @@ void ModuleRegistry::StopAll() {
 
   ASSERT(started_modules_.empty());
   start_order_.clear();
+  start_times_.clear();
+}
+
+std::vector<ModuleRegistry::ModuleStartTime> ModuleRegistry::GetStartTimes() const {
+  std::lock_guard<std::mutex> lock(started_modules_mutex_);
+  return start_times_;
 }
 
 os::Handler* ModuleRegistry::GetModuleHandler(const ModuleFactory* module) const {
+  std::lock_guard<std::mutex> lock(started_modules_mutex_);
   auto started_instance = started_modules_.find(module);
   if (started_instance != started_modules_.end()) {
     return started_instance->second->GetHandler();
@@ -164,4 +320,78 @@ void ModuleDumper::DumpState(std::string* output) const {
   *output = std::string(builder.GetBufferPointer(), builder.GetBufferPointer() + builder.GetSize());
 }
 
+void ModuleDumper::DumpSnapshots(DumpsysSnapshots* snapshots) const {
+  ASSERT(snapshots != nullptr);
+
+  std::unordered_map<const Module*, DumpsysSnapshot> previous_snapshots;
+  for (auto& snapshot : *snapshots) {
+    previous_snapshots.emplace(snapshot.instance, std::move(snapshot));
+  }
+  snapshots->clear();
+
+  for (auto it = module_registry_.start_order_.rbegin(); it != module_registry_.start_order_.rend(); it++) {
+    auto instance = module_registry_.started_modules_.find(*it);
+    ASSERT(instance != module_registry_.started_modules_.end());
+    uint64_t version = instance->second->GetDumpsysDataVersion();
+
+    // A module restarted at the same address is a different module
+    auto previous = previous_snapshots.find(instance->second);
+    if (version != Module::kDumpsysDataUnversioned && previous != previous_snapshots.end() &&
+        previous->second.module == *it && previous->second.version == version) {
+      snapshots->push_back(std::move(previous->second));
+      continue;
+    }
+
+    flatbuffers::FlatBufferBuilder builder(1024);
+    auto finisher = instance->second->GetDumpsysData(&builder);
+    DumpsysDataBuilder data_builder(builder);
+    finisher(&data_builder);
+    builder.Finish(data_builder.Finish());
+    auto data =
+        std::make_shared<const std::string>(builder.GetBufferPointer(), builder.GetBufferPointer() + builder.GetSize());
+    snapshots->push_back(DumpsysSnapshot{*it, instance->second, version, std::move(data)});
+  }
+}
+
+void ModuleDumper::DumpState(
+    const DumpsysSnapshots& snapshots, const reflection::Schema& schema, std::string* output) const {
+  ASSERT(output != nullptr);
+  const reflection::Object* root_table = schema.root_table();
+  ASSERT(root_table != nullptr);
+
+  flatbuffers::FlatBufferBuilder builder(1024);
+  auto title = builder.CreateString(title_);
+
+  auto init_flags_offset = dumpsys::InitFlags::Dump(&builder);
+  auto wakelock_offset = WakelockManager::Get().GetDumpsysData(&builder);
+
+  // The tables must all be copied before starting to build the root table
+  std::vector<std::pair<flatbuffers::voffset_t, flatbuffers::Offset<const flatbuffers::Table*>>> tables;
+  for (const auto& snapshot : snapshots) {
+    auto data = flatbuffers::GetAnyRoot(reinterpret_cast<const uint8_t*>(snapshot.data->data()));
+    for (const reflection::Field* field : *root_table->fields()) {
+      if (field->type()->base_type() != reflection::Obj || !data->CheckField(field->offset())) {
+        continue;
+      }
+      const reflection::Object* object = schema.objects()->Get(field->type()->index());
+      if (object->is_struct()) {
+        continue;
+      }
+      tables.emplace_back(
+          field->offset(), flatbuffers::CopyTable(builder, schema, *object, *flatbuffers::GetFieldT(*data, *field)));
+    }
+  }
+
+  DumpsysDataBuilder data_builder(builder);
+  data_builder.add_title(title);
+  data_builder.add_init_flags(init_flags_offset);
+  data_builder.add_wakelock_manager_data(wakelock_offset);
+  for (const auto& table : tables) {
+    data_builder.fbb_.AddOffset(table.first, table.second);
+  }
+
+  builder.Finish(data_builder.Finish());
+  *output = std::string(builder.GetBufferPointer(), builder.GetBufferPointer() + builder.GetSize());
+}
+
 }  // namespace bluetooth
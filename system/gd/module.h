@@ -17,9 +17,13 @@
 #pragma once
 
 #include <flatbuffers/flatbuffers.h>
+#include <chrono>
+#include <cstdint>
 #include <functional>
 #include <future>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -29,6 +33,10 @@
 #include "os/log.h"
 #include "os/thread.h"
 
+namespace reflection {
+struct Schema;
+}  // namespace reflection
+
 namespace bluetooth {
 
 class Module;
@@ -64,6 +72,15 @@ public:
 
 using DumpsysDataFinisher = std::function<void(DumpsysDataBuilder* dumpsys_data_builder)>;
 
+// Dumpsys data of a started module, as a DumpsysData buffer holding only the fields the module populates
+struct DumpsysSnapshot {
+  const ModuleFactory* module;
+  const Module* instance;
+  uint64_t version;
+  std::shared_ptr<const std::string> data;
+};
+using DumpsysSnapshots = std::vector<DumpsysSnapshot>;
+
 // Each leaf node module must have a factory like so:
 //
 // static const ModuleFactory Factory;
@@ -92,6 +109,11 @@ class Module {
   // Get relevant state data from the module
   virtual DumpsysDataFinisher GetDumpsysData(flatbuffers::FlatBufferBuilder* builder) const;
 
+  // Version of the state returned by GetDumpsysData(), which must change whenever that state does. The last dumpsys
+  // data of the module is reused as long as its version stays the same, unless it is kDumpsysDataUnversioned
+  static constexpr uint64_t kDumpsysDataUnversioned = 0;
+  virtual uint64_t GetDumpsysDataVersion() const;
+
   virtual std::string ToString() const = 0;
 
   ::bluetooth::os::Handler* GetHandler() const;
@@ -133,6 +155,16 @@ class ModuleRegistry {
 
   bool IsStarted(const ModuleFactory* factory) const;
 
+  // Number of threads Start() calls the Start() of the modules on. A module only starts once all its dependencies
+  // did, the modules that do not depend on each other may start concurrently. With a single thread, the default, the
+  // modules start one at a time in the order of their dependencies.
+  void SetStartThreads(size_t num_threads);
+  // Read the number of threads from the persist.bluetooth.module_start_threads system property, kDefaultStartThreads
+  // when it is not set. The modules are not audited for undeclared ordering dependencies or thread affinity in their
+  // Start() yet: by default they start one at a time on the calling thread, starting them concurrently is opt-in.
+  static constexpr size_t kDefaultStartThreads = 1;
+  void SetStartThreadsFromSystemProperty();
+
   // Start all the modules on this list and their dependencies
   // in dependency order
   void Start(ModuleList* modules, ::bluetooth::os::Thread* thread);
@@ -147,6 +179,15 @@ class ModuleRegistry {
   // Stop all running modules in reverse order of start
   void StopAll();
 
+  // Time the Start() of a module took, kept until the modules are stopped
+  struct ModuleStartTime {
+    std::string name;
+    std::chrono::steady_clock::time_point begin;
+    std::chrono::steady_clock::time_point end;
+  };
+  // The start times of the started modules, in the order they started
+  std::vector<ModuleStartTime> GetStartTimes() const;
+
  protected:
   Module* Get(const ModuleFactory* module) const;
 
@@ -154,9 +195,20 @@ class ModuleRegistry {
 
   os::Handler* GetModuleHandler(const ModuleFactory* module) const;
 
+  // Guards started_modules_ and start_order_ while modules start concurrently
+  mutable std::mutex started_modules_mutex_;
   std::map<const ModuleFactory*, Module*> started_modules_;
   std::vector<const ModuleFactory*> start_order_;
+  std::vector<ModuleStartTime> start_times_;
   std::string last_instance_;
+
+ private:
+  struct PendingModule;
+  // Construct |module| and the dependencies not started yet, adding them to |pending| dependencies first
+  void construct_pending(
+      const ModuleFactory* module, ::bluetooth::os::Thread* thread, std::vector<PendingModule>* pending);
+
+  size_t start_threads_ = 1;
 };
 
 class ModuleDumper {
@@ -165,6 +217,14 @@ class ModuleDumper {
       : module_registry_(module_registry), title_(title) {}
   void DumpState(std::string* output) const;
 
+  // Get the dumpsys data of the started modules, in the same order as DumpState(). The data is only collected again
+  // from the modules whose version changed since |snapshots| were taken, the other ones are kept as they are
+  void DumpSnapshots(DumpsysSnapshots* snapshots) const;
+
+  // Same as DumpState(), from the module |snapshots|. The module tables are copied using |schema|, the reflection
+  // schema of DumpsysData, so this does not need to run on the module handlers
+  void DumpState(const DumpsysSnapshots& snapshots, const reflection::Schema& schema, std::string* output) const;
+
  private:
   const ModuleRegistry& module_registry_;
   const std::string title_;
@@ -21,9 +21,12 @@
 
 #include "gtest/gtest.h"
 
+#include <atomic>
+#include <chrono>
 #include <functional>
 #include <future>
 #include <string>
+#include <thread>
 
 using ::bluetooth::os::Thread;
 
@@ -179,6 +182,7 @@ class TestModuleDumpState : public Module {
   static const ModuleFactory Factory;
 
   std::string test_string_{"Initial Test String"};
+  uint64_t test_version_{Module::kDumpsysDataUnversioned};
 
  protected:
   void ListDependencies(ModuleList* list) const {
@@ -213,6 +217,10 @@ class TestModuleDumpState : public Module {
 
     return [table](DumpsysDataBuilder* builder) { builder->add_module_unittest_data(table); };
   }
+
+  uint64_t GetDumpsysDataVersion() const override {
+    return test_version_;
+  }
 };
 
 const ModuleFactory TestModuleDumpState::Factory = ModuleFactory([]() { return new TestModuleDumpState(); });
@@ -253,6 +261,22 @@ TEST_F(ModuleTest, one_dependency) {
   EXPECT_FALSE(registry_->IsStarted<TestModuleTwoDependencies>());
 }
 
+TEST_F(ModuleTest, start_times) {
+  ModuleList list;
+  list.add<TestModuleOneDependency>();
+  registry_->Start(&list, thread_);
+
+  auto start_times = registry_->GetStartTimes();
+  ASSERT_EQ(2u, start_times.size());
+  EXPECT_EQ("TestModuleNoDependency", start_times[0].name);
+  EXPECT_EQ("TestModuleOneDependency", start_times[1].name);
+  EXPECT_LE(start_times[0].begin, start_times[0].end);
+  EXPECT_LE(start_times[0].end, start_times[1].begin);
+
+  registry_->StopAll();
+  EXPECT_TRUE(registry_->GetStartTimes().empty());
+}
+
 TEST_F(ModuleTest, two_dependencies) {
   ModuleList list;
   list.add<TestModuleTwoDependencies>();
@@ -271,6 +295,157 @@ TEST_F(ModuleTest, two_dependencies) {
   EXPECT_FALSE(registry_->IsStarted<TestModuleTwoDependencies>());
 }
 
+// Modules whose Start() only returns once they both are in it, or after a timeout
+std::atomic<int> concurrent_modules_starting{0};
+std::atomic<bool> concurrent_modules_overlapped{false};
+
+void start_concurrently() {
+  concurrent_modules_starting++;
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+  while (concurrent_modules_starting < 2 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  if (concurrent_modules_starting == 2) {
+    concurrent_modules_overlapped = true;
+  }
+}
+
+class TestModuleConcurrentOne : public Module {
+ public:
+  static const ModuleFactory Factory;
+
+ protected:
+  void ListDependencies(ModuleList* list) const {}
+
+  void Start() override {
+    start_concurrently();
+  }
+
+  void Stop() override {}
+
+  std::string ToString() const override {
+    return std::string("TestModuleConcurrentOne");
+  }
+};
+
+const ModuleFactory TestModuleConcurrentOne::Factory = ModuleFactory([]() { return new TestModuleConcurrentOne(); });
+
+class TestModuleConcurrentTwo : public Module {
+ public:
+  static const ModuleFactory Factory;
+
+ protected:
+  void ListDependencies(ModuleList* list) const {}
+
+  void Start() override {
+    start_concurrently();
+  }
+
+  void Stop() override {}
+
+  std::string ToString() const override {
+    return std::string("TestModuleConcurrentTwo");
+  }
+};
+
+const ModuleFactory TestModuleConcurrentTwo::Factory = ModuleFactory([]() { return new TestModuleConcurrentTwo(); });
+
+class TestModuleAfterConcurrent : public Module {
+ public:
+  static const ModuleFactory Factory;
+
+ protected:
+  void ListDependencies(ModuleList* list) const {
+    list->add<TestModuleConcurrentOne>();
+    list->add<TestModuleConcurrentTwo>();
+  }
+
+  void Start() override {
+    // Only started once both dependencies are
+    EXPECT_TRUE(GetModuleRegistry()->IsStarted<TestModuleConcurrentOne>());
+    EXPECT_TRUE(GetModuleRegistry()->IsStarted<TestModuleConcurrentTwo>());
+  }
+
+  void Stop() override {}
+
+  std::string ToString() const override {
+    return std::string("TestModuleAfterConcurrent");
+  }
+};
+
+const ModuleFactory TestModuleAfterConcurrent::Factory =
+    ModuleFactory([]() { return new TestModuleAfterConcurrent(); });
+
+TEST_F(ModuleTest, independent_modules_start_concurrently) {
+  concurrent_modules_starting = 0;
+  concurrent_modules_overlapped = false;
+  registry_->SetStartThreads(2);
+  ModuleList list;
+  list.add<TestModuleAfterConcurrent>();
+  registry_->Start(&list, thread_);
+
+  EXPECT_TRUE(concurrent_modules_overlapped);
+  EXPECT_TRUE(registry_->IsStarted<TestModuleConcurrentOne>());
+  EXPECT_TRUE(registry_->IsStarted<TestModuleConcurrentTwo>());
+  EXPECT_TRUE(registry_->IsStarted<TestModuleAfterConcurrent>());
+
+  registry_->StopAll();
+  EXPECT_FALSE(registry_->IsStarted<TestModuleAfterConcurrent>());
+}
+
+TEST_F(ModuleTest, two_dependencies_on_several_threads) {
+  registry_->SetStartThreads(4);
+  ModuleList list;
+  list.add<TestModuleTwoDependencies>();
+  registry_->Start(&list, thread_);
+
+  EXPECT_TRUE(registry_->IsStarted<TestModuleNoDependency>());
+  EXPECT_TRUE(registry_->IsStarted<TestModuleOneDependency>());
+  EXPECT_TRUE(registry_->IsStarted<TestModuleNoDependencyTwo>());
+  EXPECT_TRUE(registry_->IsStarted<TestModuleTwoDependencies>());
+
+  registry_->StopAll();
+  EXPECT_FALSE(registry_->IsStarted<TestModuleTwoDependencies>());
+}
+
+std::thread::id test_module_start_thread_id;
+
+class TestModuleRecordingStartThread : public Module {
+ public:
+  static const ModuleFactory Factory;
+
+ protected:
+  void ListDependencies(ModuleList* list) const {
+    list->add<TestModuleNoDependency>();
+  }
+
+  void Start() override {
+    test_module_start_thread_id = std::this_thread::get_id();
+  }
+
+  void Stop() override {}
+
+  std::string ToString() const override {
+    return std::string("TestModuleRecordingStartThread");
+  }
+};
+
+const ModuleFactory TestModuleRecordingStartThread::Factory =
+    ModuleFactory([]() { return new TestModuleRecordingStartThread(); });
+
+TEST_F(ModuleTest, modules_start_on_the_calling_thread_by_default) {
+  test_module_start_thread_id = std::thread::id();
+  registry_->SetStartThreadsFromSystemProperty();
+  ModuleList list;
+  list.add<TestModuleRecordingStartThread>();
+  registry_->Start(&list, thread_);
+
+  EXPECT_EQ(test_module_start_thread_id, std::this_thread::get_id());
+  EXPECT_TRUE(registry_->IsStarted<TestModuleNoDependency>());
+
+  registry_->StopAll();
+}
+
 void post_to_module_one_handler() {
   std::this_thread::sleep_for(std::chrono::milliseconds(100));
   test_module_one_dependency_handler->Post(common::BindOnce([] { FAIL(); }));
@@ -314,5 +489,45 @@ TEST_F(ModuleTest, dump_state) {
   registry_->StopAll();
 }
 
+TEST_F(ModuleTest, dump_snapshots) {
+  ModuleList list;
+  list.add<TestModuleDumpState>();
+  registry_->Start(&list, thread_);
+  TestModuleDumpState* test_module =
+      static_cast<TestModuleDumpState*>(registry_->Start(&TestModuleDumpState::Factory, nullptr));
+
+  ModuleDumper dumper(*registry_, "Test Dump Title");
+  DumpsysSnapshots snapshots;
+  dumper.DumpSnapshots(&snapshots);
+  ASSERT_EQ(2u, snapshots.size());
+  EXPECT_EQ(&TestModuleDumpState::Factory, snapshots[0].module);
+  EXPECT_EQ(&TestModuleNoDependency::Factory, snapshots[1].module);
+  auto data = flatbuffers::GetRoot<DumpsysData>(snapshots[0].data->data());
+  EXPECT_STREQ("Initial Test String", data->module_unittest_data()->title()->c_str());
+  EXPECT_EQ(nullptr, data->title());
+  data = flatbuffers::GetRoot<DumpsysData>(snapshots[1].data->data());
+  EXPECT_EQ(nullptr, data->module_unittest_data());
+
+  // The data of unversioned modules is collected at each dump
+  test_module->test_string_ = "A Second Test String";
+  dumper.DumpSnapshots(&snapshots);
+  data = flatbuffers::GetRoot<DumpsysData>(snapshots[0].data->data());
+  EXPECT_STREQ("A Second Test String", data->module_unittest_data()->title()->c_str());
+
+  // And only when their version changed otherwise
+  test_module->test_version_ = 1;
+  dumper.DumpSnapshots(&snapshots);
+  auto snapshot_data = snapshots[0].data;
+  test_module->test_string_ = "A Third Test String";
+  dumper.DumpSnapshots(&snapshots);
+  EXPECT_EQ(snapshot_data, snapshots[0].data);
+  test_module->test_version_ = 2;
+  dumper.DumpSnapshots(&snapshots);
+  data = flatbuffers::GetRoot<DumpsysData>(snapshots[0].data->data());
+  EXPECT_STREQ("A Third Test String", data->module_unittest_data()->title()->c_str());
+
+  registry_->StopAll();
+}
+
 }  // namespace
 }  // namespace bluetooth
@@ -17,7 +17,12 @@
 
 #include "neighbor/name_db.h"
 
+#include <algorithm>
+#include <deque>
+#include <list>
 #include <memory>
+#include <optional>
+#include <string>
 #include <unordered_map>
 #include <utility>
 
@@ -26,6 +31,7 @@
 #include "neighbor/name.h"
 #include "os/handler.h"
 #include "os/log.h"
+#include "storage/storage_module.h"
 
 namespace bluetooth {
 namespace neighbor {
@@ -35,10 +41,26 @@ struct PendingRemoteNameRead {
   ReadRemoteNameDbCallback callback_;
   os::Handler* handler_;
 };
+
+struct PageScanInfo {
+  hci::PageScanRepetitionMode page_scan_repetition_mode_;
+  uint16_t clock_offset_;
+};
+
+struct CachedName {
+  RemoteName name_;
+  std::chrono::system_clock::time_point read_time_;
+};
+
+bool IsFresh(std::chrono::system_clock::time_point read_time) {
+  return std::chrono::system_clock::now() - read_time < NameDbModule::kNameCacheTtl;
+}
 }  // namespace
 
 struct NameDbModule::impl {
   void ReadRemoteNameRequest(hci::Address address, ReadRemoteNameDbCallback callback, os::Handler* handler);
+  void SetPageScanInfo(
+      hci::Address address, hci::PageScanRepetitionMode page_scan_repetition_mode, uint16_t clock_offset);
 
   bool IsNameCached(hci::Address address) const;
   RemoteName ReadCachedRemoteName(hci::Address address) const;
@@ -50,11 +72,19 @@ struct NameDbModule::impl {
 
  private:
   std::unordered_map<hci::Address, std::list<PendingRemoteNameRead>> address_to_pending_read_map_;
-  std::unordered_map<hci::Address, RemoteName> address_to_name_map_;
-
+  std::unordered_map<hci::Address, CachedName> address_to_name_map_;
+  std::unordered_map<hci::Address, PageScanInfo> address_to_page_scan_info_map_;
+  // Addresses of the reads waiting for a free slot, the oldest first
+  std::deque<hci::Address> queued_reads_;
+  size_t active_reads_ = 0;
+
+  std::optional<RemoteName> GetFreshName(hci::Address address) const;
+  void SendQueuedReads();
+  void SaveName(hci::Address address, const RemoteName& name, std::chrono::system_clock::time_point read_time);
   void OnRemoteNameResponse(hci::ErrorCode status, hci::Address address, RemoteName name);
 
   neighbor::NameModule* name_module_;
+  storage::StorageModule* storage_module_;
 
   const NameDbModule& module_;
   os::Handler* handler_;
@@ -72,42 +102,105 @@ void neighbor::NameDbModule::impl::ReadRemoteNameRequest(
     return;
   }
 
+  if (GetFreshName(address)) {
+    LOG_DEBUG("Name of %s is cached", address.ToString().c_str());
+    handler->Call(std::move(callback), address, true);
+    return;
+  }
+
   std::list<PendingRemoteNameRead> tmp;
   address_to_pending_read_map_[address] = std::move(tmp);
   address_to_pending_read_map_[address].push_back({std::move(callback), handler});
+  queued_reads_.push_back(address);
+  SendQueuedReads();
+}
 
-  // TODO(cmanton) Use remote name request defaults for now
-  hci::PageScanRepetitionMode page_scan_repetition_mode = hci::PageScanRepetitionMode::R1;
-  uint16_t clock_offset = 0;
-  hci::ClockOffsetValid clock_offset_valid = hci::ClockOffsetValid::INVALID;
-  name_module_->ReadRemoteNameRequest(
-      address,
-      page_scan_repetition_mode,
-      clock_offset,
-      clock_offset_valid,
-      common::BindOnce(&NameDbModule::impl::OnRemoteNameResponse, common::Unretained(this)),
-      handler_);
+void neighbor::NameDbModule::impl::SetPageScanInfo(
+    hci::Address address, hci::PageScanRepetitionMode page_scan_repetition_mode, uint16_t clock_offset) {
+  address_to_page_scan_info_map_[address] = {page_scan_repetition_mode, clock_offset};
+}
+
+void neighbor::NameDbModule::impl::SendQueuedReads() {
+  while (active_reads_ < kMaxConcurrentNameReads && !queued_reads_.empty()) {
+    hci::Address address = queued_reads_.front();
+    queued_reads_.pop_front();
+    active_reads_++;
+
+    // Use remote name request defaults unless the device was found by an inquiry
+    hci::PageScanRepetitionMode page_scan_repetition_mode = hci::PageScanRepetitionMode::R1;
+    uint16_t clock_offset = 0;
+    hci::ClockOffsetValid clock_offset_valid = hci::ClockOffsetValid::INVALID;
+    auto page_scan_info = address_to_page_scan_info_map_.find(address);
+    if (page_scan_info != address_to_page_scan_info_map_.end()) {
+      page_scan_repetition_mode = page_scan_info->second.page_scan_repetition_mode_;
+      clock_offset = page_scan_info->second.clock_offset_;
+      clock_offset_valid = hci::ClockOffsetValid::VALID;
+      address_to_page_scan_info_map_.erase(page_scan_info);
+    }
+    name_module_->ReadRemoteNameRequest(
+        address,
+        page_scan_repetition_mode,
+        clock_offset,
+        clock_offset_valid,
+        common::BindOnce(&NameDbModule::impl::OnRemoteNameResponse, common::Unretained(this)),
+        handler_);
+  }
 }
 
 void neighbor::NameDbModule::impl::OnRemoteNameResponse(hci::ErrorCode status, hci::Address address, RemoteName name) {
   ASSERT(address_to_pending_read_map_.find(address) != address_to_pending_read_map_.end());
+  ASSERT(active_reads_ > 0);
+  active_reads_--;
   if (status == hci::ErrorCode::SUCCESS) {
-    address_to_name_map_[address] = name;
+    auto read_time = std::chrono::system_clock::now();
+    address_to_name_map_[address] = {name, read_time};
+    SaveName(address, name, read_time);
   }
   auto& callback_list = address_to_pending_read_map_.at(address);
   for (auto& it : callback_list) {
     it.handler_->Call(std::move(it.callback_), address, status == hci::ErrorCode::SUCCESS);
   }
   address_to_pending_read_map_.erase(address);
+  SendQueuedReads();
+}
+
+void neighbor::NameDbModule::impl::SaveName(
+    hci::Address address, const RemoteName& name, std::chrono::system_clock::time_point read_time) {
+  auto name_end = std::find(name.begin(), name.end(), 0);
+  auto device = storage_module_->GetDeviceByClassicMacAddress(address);
+  auto mutation = storage_module_->Modify();
+  mutation.Add(device.SetName(std::string(name.begin(), name_end)));
+  mutation.Add(device.SetNameUnixTimestamp(
+      std::chrono::duration_cast<std::chrono::seconds>(read_time.time_since_epoch()).count()));
+  mutation.Commit();
+}
+
+std::optional<RemoteName> neighbor::NameDbModule::impl::GetFreshName(hci::Address address) const {
+  auto cached_name = address_to_name_map_.find(address);
+  if (cached_name != address_to_name_map_.end() && IsFresh(cached_name->second.read_time_)) {
+    return cached_name->second.name_;
+  }
+  // Names read before the stack was restarted
+  auto device = storage_module_->GetDeviceByClassicMacAddress(address);
+  auto saved_name = device.GetName();
+  auto saved_timestamp = device.GetNameUnixTimestamp();
+  if (!saved_name || !saved_timestamp ||
+      !IsFresh(std::chrono::system_clock::time_point(std::chrono::seconds(*saved_timestamp)))) {
+    return std::nullopt;
+  }
+  RemoteName name{};
+  std::copy_n(saved_name->begin(), std::min(saved_name->size(), name.size()), name.begin());
+  return name;
 }
 
 bool neighbor::NameDbModule::impl::IsNameCached(hci::Address address) const {
-  return address_to_name_map_.count(address) == 1;
+  return GetFreshName(address).has_value();
 }
 
 RemoteName neighbor::NameDbModule::impl::ReadCachedRemoteName(hci::Address address) const {
-  ASSERT(IsNameCached(address));
-  return address_to_name_map_.at(address);
+  auto name = GetFreshName(address);
+  ASSERT(name.has_value());
+  return *name;
 }
 
 /**
@@ -129,6 +222,16 @@ void neighbor::NameDbModule::ReadRemoteNameRequest(
       handler));
 }
 
+void neighbor::NameDbModule::SetPageScanInfo(
+    hci::Address address, hci::PageScanRepetitionMode page_scan_repetition_mode, uint16_t clock_offset) {
+  GetHandler()->Post(common::BindOnce(
+      &NameDbModule::impl::SetPageScanInfo,
+      common::Unretained(pimpl_.get()),
+      address,
+      page_scan_repetition_mode,
+      clock_offset));
+}
+
 bool neighbor::NameDbModule::IsNameCached(hci::Address address) const {
   return pimpl_->IsNameCached(address);
 }
@@ -139,16 +242,21 @@ RemoteName neighbor::NameDbModule::ReadCachedRemoteName(hci::Address address) co
 
 void neighbor::NameDbModule::impl::Start() {
   name_module_ = module_.GetDependency<neighbor::NameModule>();
+  storage_module_ = module_.GetDependency<storage::StorageModule>();
   handler_ = module_.GetHandler();
 }
 
-void neighbor::NameDbModule::impl::Stop() {}
+void neighbor::NameDbModule::impl::Stop() {
+  queued_reads_.clear();
+  active_reads_ = 0;
+}
 
 /**
  * Module methods here
  */
 void neighbor::NameDbModule::ListDependencies(ModuleList* list) const {
   list->add<neighbor::NameModule>();
+  list->add<storage::StorageModule>();
 }
 
 void neighbor::NameDbModule::Start() {
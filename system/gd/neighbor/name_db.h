@@ -16,6 +16,7 @@
 #pragma once
 
 #include <array>
+#include <chrono>
 #include <cstdint>
 #include <memory>
 
@@ -30,10 +31,20 @@ namespace neighbor {
 
 using ReadRemoteNameDbCallback = common::OnceCallback<void(hci::Address address, bool success)>;
 
+// Names read less than |kNameCacheTtl| ago, including the ones saved in storage, are served from the cache. At most
+// |kMaxConcurrentNameReads| remote name requests are sent to the controller at a time, the other ones are queued
 class NameDbModule : public bluetooth::Module {
  public:
+  static constexpr size_t kMaxConcurrentNameReads = 2;
+  static constexpr std::chrono::seconds kNameCacheTtl = std::chrono::hours(24);
+
   virtual void ReadRemoteNameRequest(hci::Address address, ReadRemoteNameDbCallback callback, os::Handler* handler);
 
+  // Page the device with the paging information of its inquiry result, instead of the defaults, to read its name
+  // while the inquiry is still running
+  void SetPageScanInfo(
+      hci::Address address, hci::PageScanRepetitionMode page_scan_repetition_mode, uint16_t clock_offset);
+
   bool IsNameCached(hci::Address address) const;
   RemoteName ReadCachedRemoteName(hci::Address address) const;
 
@@ -0,0 +1,93 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <set>
+#include <utility>
+
+#include "common/callback.h"
+#include "os/handler.h"
+#include "os/thread.h"
+#include "os/utils.h"
+
+namespace bluetooth {
+namespace os {
+
+// Multiplexes many single-shot alarms for a reactor-based thread over a single Linux timerfd, so that the alarms of a
+// thread cost one fd and one reactor registration instead of one each. When it's constructed, it will register a
+// reactable on the specified thread; when it's destroyed, it will unregister itself from the thread and drop the
+// pending alarms.
+//
+// Each alarm may be given a slack, the time it may fire after its deadline. The timerfd is armed for the earliest
+// deadline plus slack, and every alarm whose deadline has passed runs on that wakeup, so alarms that don't need to be
+// precise (inquiry, cache expiry, metrics, ...) share their wakeups with each other and with precise alarms.
+class AlarmManager {
+ public:
+  // Identifies a scheduled alarm, never kInvalidAlarmId
+  using AlarmId = uint64_t;
+  static constexpr AlarmId kInvalidAlarmId = 0;
+
+  // Create and register an alarm manager on a given handler
+  explicit AlarmManager(Handler* handler);
+
+  AlarmManager(const AlarmManager&) = delete;
+  AlarmManager& operator=(const AlarmManager&) = delete;
+
+  // Unregister this alarm manager from the thread and release resource. Pending alarms are not run.
+  ~AlarmManager();
+
+  // Schedule a task to run on the handler thread once |delay| has elapsed, and at most |slack| later
+  AlarmId Schedule(
+      common::OnceClosure task,
+      std::chrono::milliseconds delay,
+      std::chrono::milliseconds slack = std::chrono::milliseconds(0));
+
+  // Cancel the alarm. Return false if it already ran, was already cancelled or is unknown.
+  bool Cancel(AlarmId id);
+
+  // Return the number of alarms that are scheduled and haven't run yet
+  size_t GetPendingCount() const;
+
+ private:
+  struct PendingAlarm {
+    common::OnceClosure task;
+    uint64_t deadline_ms;
+    uint64_t latest_ms;
+  };
+
+  Handler* handler_;
+  int fd_ = 0;
+  Reactor::Reactable* token_;
+  mutable std::mutex mutex_;
+  AlarmId next_id_ = kInvalidAlarmId + 1;
+  std::map<AlarmId, PendingAlarm> alarms_;
+  // Pending alarms ordered by the time they become due, and by the time they must have run
+  std::set<std::pair<uint64_t, AlarmId>> by_deadline_;
+  std::set<std::pair<uint64_t, AlarmId>> by_latest_;
+  // Expiration the timerfd is armed for, 0 if disarmed
+  uint64_t armed_ms_ = 0;
+  void rearm(uint64_t now_ms);
+  void on_fire();
+};
+
+}  // namespace os
+}  // namespace bluetooth
@@ -0,0 +1,202 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace bluetooth {
+namespace os {
+
+// Debug logs formatted only when dumped
+//
+// A log is recorded as its format string, location and raw arguments in a fixed size ring buffer of the logging
+// thread, without taking any lock, the oldest records being overwritten. String arguments are copied, truncated to what
+// is left of the kStringBytes of the record, and the arguments beyond kMaxArgs are dropped. Binary logging is disabled
+// by default and then only costs a relaxed load per log.
+//
+// The recording path is in this header so that every user of os/log.h can record without a new link dependency.
+class BinaryLog {
+ public:
+  // Number of records kept per thread
+  static constexpr size_t kBufferSize = 256;
+  static constexpr size_t kMaxArgs = 8;
+  static constexpr size_t kStringBytes = 64;
+
+  enum class ArgType : uint8_t { SIGNED, UNSIGNED, DOUBLE, STRING, POINTER, UNSUPPORTED };
+
+  struct Record {
+    std::atomic<uint64_t> timestamp_ns{0};
+    std::atomic<const char*> tag{nullptr};
+    std::atomic<const char*> file{nullptr};
+    std::atomic<int> line{0};
+    std::atomic<const char*> function{nullptr};
+    std::atomic<const char*> format{nullptr};
+    std::atomic<uint8_t> num_args{0};
+    std::array<std::atomic<ArgType>, kMaxArgs> types;
+    // Size in bytes of the integer arguments
+    std::array<std::atomic<uint8_t>, kMaxArgs> sizes;
+    // Integers, bits of the doubles, pointers, or offset in |strings| of the string arguments
+    std::array<std::atomic<uint64_t>, kMaxArgs> args;
+    std::array<std::atomic<char>, kStringBytes> strings;
+  };
+
+  // Written by its thread only. A record is reserved before being written then published, so that readers can tell the
+  // records that may have been overwritten while they were read
+  struct ThreadBuffer {
+    const pid_t tid = static_cast<pid_t>(syscall(SYS_gettid));
+    std::atomic<uint64_t> reserved{0};
+    std::atomic<uint64_t> published{0};
+    // Records before are dropped
+    std::atomic<uint64_t> cleared{0};
+    std::array<Record, kBufferSize> records;
+  };
+
+  static void SetEnabled(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+  }
+  // Read whether to record from the persist.bluetooth.binary_log.enabled system property
+  static void SetEnabledFromSystemProperty();
+  static bool IsEnabled() {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  // CLOCK_REALTIME time in nanoseconds, to line the records up with the other logs
+  static uint64_t Now() {
+    struct timespec ts = {};
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+  }
+
+  // Record a log of the calling thread. |tag|, |file|, |function| and |format| must outlive the record, as string
+  // literals do
+  template <typename... Args>
+  static void Log(const char* tag, const char* file, int line, const char* function, const char* format, Args... args) {
+    ThreadBuffer* buffer = GetThreadBuffer();
+    uint64_t index = buffer->reserved.load(std::memory_order_relaxed);
+    buffer->reserved.store(index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    Record& record = buffer->records[index % kBufferSize];
+    record.timestamp_ns.store(Now(), std::memory_order_relaxed);
+    record.tag.store(tag, std::memory_order_relaxed);
+    record.file.store(file, std::memory_order_relaxed);
+    record.line.store(line, std::memory_order_relaxed);
+    record.function.store(function, std::memory_order_relaxed);
+    record.format.store(format, std::memory_order_relaxed);
+    size_t arg_index = 0;
+    size_t string_offset = 0;
+    (PutArg(&record, &arg_index, &string_offset, args), ...);
+    record.num_args.store(static_cast<uint8_t>(arg_index), std::memory_order_relaxed);
+    buffer->published.store(index + 1, std::memory_order_release);
+  }
+
+  // Format the records of all threads, oldest first, and write them to |fd|
+  static void Write(int fd);
+  static std::string ToString();
+
+  // Drop the records
+  static void Clear();
+
+ private:
+  // Buffers kept for the threads that exited, beyond which the oldest ones are dropped
+  static constexpr size_t kMaxExitedThreadBuffers = 16;
+
+  // The buffer of a thread is only allocated once it records a log
+  static ThreadBuffer* GetThreadBuffer() {
+    static thread_local std::shared_ptr<ThreadBuffer> buffer;
+    if (buffer == nullptr) {
+      buffer = std::make_shared<ThreadBuffer>();
+      std::lock_guard<std::mutex> lock(registry_mutex_);
+      size_t exited = std::count_if(registry_.begin(), registry_.end(), [](const std::shared_ptr<ThreadBuffer>& buffer) {
+        return buffer.use_count() == 1;
+      });
+      for (auto it = registry_.begin(); it != registry_.end() && exited > kMaxExitedThreadBuffers;) {
+        if (it->use_count() == 1) {
+          it = registry_.erase(it);
+          exited--;
+        } else {
+          it++;
+        }
+      }
+      registry_.push_back(buffer);
+    }
+    return buffer.get();
+  }
+
+  static void PutString(Record* record, size_t* string_offset, const char* string, uint64_t* value) {
+    *value = *string_offset;
+    if (string == nullptr) {
+      string = "(null)";
+    }
+    while (*string_offset + 1 < kStringBytes && *string != '\0') {
+      record->strings[(*string_offset)++].store(*string++, std::memory_order_relaxed);
+    }
+    if (*string_offset < kStringBytes) {
+      record->strings[(*string_offset)++].store('\0', std::memory_order_relaxed);
+    }
+  }
+
+  template <typename T>
+  static void PutArg(Record* record, size_t* arg_index, size_t* string_offset, T arg) {
+    if (*arg_index >= kMaxArgs) {
+      return;
+    }
+    size_t index = (*arg_index)++;
+    ArgType type = ArgType::UNSUPPORTED;
+    uint64_t value = 0;
+    if constexpr (std::is_enum_v<T>) {
+      (*arg_index)--;
+      PutArg(record, arg_index, string_offset, static_cast<std::underlying_type_t<T>>(arg));
+      return;
+    } else if constexpr (std::is_same_v<T, const char*> || std::is_same_v<T, char*>) {
+      type = ArgType::STRING;
+      PutString(record, string_offset, arg, &value);
+    } else if constexpr (
+        (std::is_pointer_v<T> && !std::is_function_v<std::remove_pointer_t<T>>) || std::is_null_pointer_v<T>) {
+      type = ArgType::POINTER;
+      value = reinterpret_cast<uintptr_t>(static_cast<const volatile void*>(arg));
+    } else if constexpr (std::is_floating_point_v<T>) {
+      type = ArgType::DOUBLE;
+      double d = arg;
+      std::memcpy(&value, &d, sizeof(value));
+    } else if constexpr (std::is_integral_v<T>) {
+      type = std::is_signed_v<T> ? ArgType::SIGNED : ArgType::UNSIGNED;
+      value = static_cast<uint64_t>(arg);
+    }
+    record->types[index].store(type, std::memory_order_relaxed);
+    record->sizes[index].store(static_cast<uint8_t>(sizeof(T)), std::memory_order_relaxed);
+    record->args[index].store(value, std::memory_order_relaxed);
+  }
+
+  static inline std::atomic<bool> enabled_{false};
+  static inline std::mutex registry_mutex_;
+  static inline std::vector<std::shared_ptr<ThreadBuffer>> registry_;
+};
+
+}  // namespace os
+}  // namespace bluetooth
@@ -17,51 +17,77 @@
 #include "os/handler.h"
 
 #include <cstring>
+#include <thread>
+#include <vector>
 
 #include "common/bind.h"
 #include "common/callback.h"
 #include "os/log.h"
 #include "os/reactor.h"
+#include "os/task_profiler.h"
+#include "os/trace.h"
 #include "os/utils.h"
 
 namespace bluetooth {
 namespace os {
 using common::OnceClosure;
 
-Handler::Handler(Thread* thread) : tasks_(new std::queue<OnceClosure>()), thread_(thread) {
+Handler::Handler(Thread* thread) : thread_(thread), max_batch_size_(0) {
   event_ = thread_->GetReactor()->NewEvent();
   reactable_ = thread_->GetReactor()->Register(
       event_->Id(), common::Bind(&Handler::handle_next_event, common::Unretained(this)), common::Closure());
 }
 
+Handler::Handler(Thread* thread, size_t max_batch_size) : thread_(thread), max_batch_size_(max_batch_size) {
+  ASSERT_LOG(max_batch_size_ > 0, "Batch size must be positive");
+  event_ = thread_->GetReactor()->NewEvent();
+  reactable_ = thread_->GetReactor()->Register(
+      event_->Id(), common::Bind(&Handler::handle_next_batch, common::Unretained(this)), common::Closure());
+}
+
 Handler::~Handler() {
-  {
-    std::lock_guard<std::mutex> lock(mutex_);
-    ASSERT_LOG(was_cleared(), "Handlers must be cleared before they are destroyed");
-  }
+  ASSERT_LOG(was_cleared(), "Handlers must be cleared before they are destroyed");
   event_->Close();
+  if (TaskProfiler::IsEnabled()) {
+    TaskProfiler::Forget(this);
+  }
 }
 
 void Handler::Post(OnceClosure closure) {
-  {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (was_cleared()) {
-      LOG_WARN("Posting to a handler which has been cleared");
-      return;
-    }
-    tasks_->emplace(std::move(closure));
+  if (was_cleared()) {
+    LOG_WARN("Posting to a handler which has been cleared");
+    return;
+  }
+  if (max_batch_size_ == 0) {
+    tasks_.push(std::move(closure));
+    event_->Notify();
+    return;
+  }
+  // In batch mode the event counter is at most one: it is raised when the queue becomes non-empty and re-raised by
+  // handle_next_batch() when it leaves work behind
+  size_t pending_before = pending_.fetch_add(1, std::memory_order_acq_rel);
+  tasks_.push(std::move(closure));
+  if (pending_before == 0) {
+    event_->Notify();
   }
-  event_->Notify();
 }
 
 void Handler::Clear() {
-  std::queue<OnceClosure>* tmp = nullptr;
+  bool already_cleared = cleared_.exchange(true, std::memory_order_acq_rel);
+  ASSERT_LOG(!already_cleared, "Handlers must only be cleared once");
+
+  // The closures may own objects that must not outlive their module, release them now. thread_ stops popping as soon
+  // as it sees cleared_, and is kept out of the queue meanwhile.
+  std::vector<common::OnceClosure> discarded;
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    ASSERT_LOG(!was_cleared(), "Handlers must only be cleared once");
-    std::swap(tasks_, tmp);
+    std::lock_guard<std::mutex> lock(consumer_mutex_);
+    common::OnceClosure closure;
+    while (tasks_.try_pop(&closure)) {
+      discarded.push_back(std::move(closure));
+    }
   }
-  delete tmp;
+  // Outside of the lock, their destructors may post to this handler
+  discarded.clear();
 
   event_->Clear();
 
@@ -74,22 +100,58 @@ void Handler::WaitUntilStopped(std::chrono::milliseconds timeout) {
   ASSERT(thread_->GetReactor()->WaitForUnregisteredReactable(timeout));
 }
 
+bool Handler::pop_task(common::OnceClosure* closure) {
+  std::lock_guard<std::mutex> lock(consumer_mutex_);
+  return !was_cleared() && tasks_.try_pop(closure);
+}
+
 void Handler::handle_next_event() {
+  if (was_cleared()) {
+    event_->Read();
+    return;
+  }
   common::OnceClosure closure;
-  {
-    std::lock_guard<std::mutex> lock(mutex_);
-    bool has_data = event_->Read();
-
+  // The event is only notified once the closure is pushed, but an earlier producer may have claimed its node and not
+  // linked it yet, hiding the rest of the queue. It is about to finish: yield to it and retry, returning with the
+  // event still set would have the level-triggered reactor call us again right away, spinning until it does.
+  while (!pop_task(&closure)) {
     if (was_cleared()) {
+      event_->Read();
       return;
     }
-    ASSERT_LOG(has_data, "Notified for work but no work available");
-
-    closure = std::move(tasks_->front());
-    tasks_->pop();
+    std::this_thread::yield();
   }
+  bool has_data = event_->Read();
+  ASSERT_LOG(has_data, "Notified for work but no work available");
+  OS_TRACE_SCOPE("Handler::Task");
+  TaskProfilerScope profile(this);
   std::move(closure).Run();
 }
 
+void Handler::handle_next_batch() {
+  bool has_data = event_->Read();
+  if (was_cleared()) {
+    return;
+  }
+  ASSERT_LOG(has_data, "Notified for work but no work available");
+
+  size_t popped = 0;
+  common::OnceClosure closure;
+  while (popped < max_batch_size_ && pop_task(&closure)) {
+    popped++;
+    OS_TRACE_SCOPE("Handler::Task");
+    TaskProfilerScope profile(this);
+    std::move(closure).Run();
+  }
+  if (was_cleared()) {
+    return;
+  }
+  // Anything left, including closures whose producers are still linking them, needs another wakeup. Going back
+  // through the reactor also keeps other reactables on this thread from being starved.
+  if (pending_.fetch_sub(popped, std::memory_order_acq_rel) != popped) {
+    event_->Notify();
+  }
+}
+
 }  // namespace os
 }  // namespace bluetooth
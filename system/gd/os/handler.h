@@ -16,14 +16,15 @@
 
 #pragma once
 
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <mutex>
-#include <queue>
 
 #include "common/bind.h"
 #include "common/callback.h"
 #include "common/contextual_callback.h"
+#include "common/mpsc_queue.h"
 #include "os/thread.h"
 #include "os/utils.h"
 
@@ -38,16 +39,22 @@ class Handler : public common::IPostableContext {
   // Create and register a handler on given thread
   explicit Handler(Thread* thread);
 
+  // Create and register a handler on given thread that runs up to |max_batch_size| pending closures per wakeup.
+  // The reactor event is only notified when the queue goes from empty to non-empty, so a burst of posts costs a single
+  // eventfd write, epoll wakeup and lock acquisition on the handler thread instead of one per closure.
+  Handler(Thread* thread, size_t max_batch_size);
+
   Handler(const Handler&) = delete;
   Handler& operator=(const Handler&) = delete;
 
   // Unregister this handler from the thread and release resource. Unhandled events will be discarded and not executed.
   virtual ~Handler();
 
-  // Enqueue a closure to the queue of this handler
+  // Enqueue a closure to the queue of this handler. Lock-free, safe to call from any thread.
   virtual void Post(common::OnceClosure closure) override;
 
-  // Remove all pending events from the queue of this handler
+  // Stop running pending events from the queue of this handler and release them. Closures posted concurrently with
+  // Clear() may only be released when the handler is destroyed.
   void Clear();
 
   // Die if the current reactable doesn't stop before the timeout.  Must be called after Clear()
@@ -97,16 +104,27 @@ class Handler : public common::IPostableContext {
 
   friend class RepeatingAlarm;
 
+  friend class AlarmManager;
+
  private:
   inline bool was_cleared() const {
-    return tasks_ == nullptr;
+    return cleared_.load(std::memory_order_acquire);
   };
-  std::queue<common::OnceClosure>* tasks_;
+  // Posted from any thread, popped on thread_ and by Clear() under consumer_mutex_
+  common::MpscQueue<common::OnceClosure> tasks_;
+  // Keeps the queue single-consumer. Only taken around each pop, never while a closure runs.
+  std::mutex consumer_mutex_;
+  std::atomic_bool cleared_{false};
+  // Number of posted closures not yet popped, only maintained in batch mode to notify only on the empty to non-empty transition
+  std::atomic_size_t pending_{0};
   Thread* thread_;
+  // Zero when batching is disabled, in which case each closure is paired with one event notification
+  const size_t max_batch_size_;
   std::unique_ptr<Reactor::Event> event_;
   Reactor::Reactable* reactable_;
-  mutable std::mutex mutex_;
+  bool pop_task(common::OnceClosure* closure);
   void handle_next_event();
+  void handle_next_batch();
 };
 
 }  // namespace os
@@ -16,8 +16,10 @@
 
 #include "os/handler.h"
 
+#include <atomic>
 #include <future>
 #include <thread>
+#include <vector>
 
 #include "common/bind.h"
 #include "common/callback.h"
@@ -86,6 +88,29 @@ TEST_F(HandlerTest, post_task_cleared) {
   ASSERT_EQ(val, 1);
 }
 
+TEST_F(HandlerTest, clear_releases_pending_tasks) {
+  std::promise<void> closure_started;
+  auto closure_started_future = closure_started.get_future();
+  std::promise<void> closure_can_continue;
+  handler_->Post(common::BindOnce(
+      [](std::promise<void> closure_started, std::future<void> can_continue_future) {
+        closure_started.set_value();
+        can_continue_future.wait();
+      },
+      std::move(closure_started),
+      closure_can_continue.get_future()));
+  auto owned = std::make_shared<int>(0);
+  for (int i = 0; i < 3; i++) {
+    handler_->Post(common::BindOnce([](std::shared_ptr<int> owned) { ASSERT_TRUE(false); }, owned));
+  }
+  closure_started_future.wait();
+  ASSERT_EQ(owned.use_count(), 4);
+  handler_->Clear();
+  ASSERT_EQ(owned.use_count(), 1);
+  closure_can_continue.set_value();
+  handler_->WaitUntilStopped(std::chrono::milliseconds(2000));
+}
+
 void check_int(std::unique_ptr<int> number, std::shared_ptr<int> to_change) {
   *to_change = *number;
 }
@@ -108,6 +133,137 @@ TEST_F(HandlerTest, callback_with_promise) {
   handler_->Clear();
 }
 
+// Producers racing each other leave the queue briefly unlinked while the event is set
+TEST_F(HandlerTest, post_from_several_threads_all_invoked) {
+  constexpr int kThreads = 4;
+  constexpr int kTasksPerThread = 1000;
+  std::atomic<int> count(0);
+  std::promise<void> all_ran;
+  auto future = all_ran.get_future();
+  std::vector<std::thread> producers;
+  for (int i = 0; i < kThreads; i++) {
+    producers.emplace_back([this, &count, &all_ran] {
+      for (int j = 0; j < kTasksPerThread; j++) {
+        handler_->Post(common::BindOnce(
+            [](std::atomic<int>* count, std::promise<void>* all_ran) {
+              if (++*count == kThreads * kTasksPerThread) {
+                all_ran->set_value();
+              }
+            },
+            common::Unretained(&count),
+            common::Unretained(&all_ran)));
+      }
+    });
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  future.wait();
+  EXPECT_EQ(count, kThreads * kTasksPerThread);
+  handler_->Clear();
+}
+
+class BatchHandlerTest : public ::testing::Test {
+ protected:
+  static constexpr size_t kMaxBatchSize = 4;
+
+  void SetUp() override {
+    thread_ = new Thread("test_thread", Thread::Priority::NORMAL);
+    handler_ = new Handler(thread_, kMaxBatchSize);
+  }
+  void TearDown() override {
+    delete handler_;
+    delete thread_;
+  }
+
+  Handler* handler_;
+  Thread* thread_;
+};
+
+TEST_F(BatchHandlerTest, post_tasks_invoked_in_order) {
+  constexpr int kNumTasks = 37;
+  std::vector<int> order;
+  std::promise<void> all_ran;
+  auto future = all_ran.get_future();
+  for (int i = 0; i < kNumTasks; i++) {
+    handler_->Post(common::BindOnce([](std::vector<int>* order, int i) { order->push_back(i); }, &order, i));
+  }
+  handler_->Post(common::BindOnce(&std::promise<void>::set_value, common::Unretained(&all_ran)));
+  future.wait();
+  ASSERT_EQ(order.size(), static_cast<size_t>(kNumTasks));
+  for (int i = 0; i < kNumTasks; i++) {
+    ASSERT_EQ(order[i], i);
+  }
+  handler_->Clear();
+}
+
+TEST_F(BatchHandlerTest, post_from_running_task) {
+  std::promise<void> nested_ran;
+  auto future = nested_ran.get_future();
+  handler_->Post(common::BindOnce(
+      [](Handler* handler, std::promise<void> nested_ran) {
+        handler->Post(common::BindOnce(&std::promise<void>::set_value, std::move(nested_ran)));
+      },
+      common::Unretained(handler_),
+      std::move(nested_ran)));
+  future.wait();
+  handler_->Clear();
+}
+
+TEST_F(BatchHandlerTest, clear_stops_dequeued_batch) {
+  int val = 0;
+  std::promise<void> closure_started;
+  auto closure_started_future = closure_started.get_future();
+  std::promise<void> closure_can_continue;
+  auto can_continue_future = closure_can_continue.get_future();
+  std::promise<void> closure_finished;
+  auto closure_finished_future = closure_finished.get_future();
+  handler_->Post(common::BindOnce(
+      [](int* val,
+         std::promise<void> closure_started,
+         std::future<void> can_continue_future,
+         std::promise<void> closure_finished) {
+        closure_started.set_value();
+        *val = *val + 1;
+        can_continue_future.wait();
+        closure_finished.set_value();
+      },
+      common::Unretained(&val),
+      std::move(closure_started),
+      std::move(can_continue_future),
+      std::move(closure_finished)));
+  handler_->Post(common::BindOnce([]() { ASSERT_TRUE(false); }));
+  closure_started_future.wait();
+  handler_->Clear();
+  closure_can_continue.set_value();
+  closure_finished_future.wait();
+  handler_->WaitUntilStopped(std::chrono::milliseconds(2000));
+  ASSERT_EQ(val, 1);
+}
+
+TEST_F(BatchHandlerTest, clear_releases_pending_tasks) {
+  std::promise<void> closure_started;
+  auto closure_started_future = closure_started.get_future();
+  std::promise<void> closure_can_continue;
+  handler_->Post(common::BindOnce(
+      [](std::promise<void> closure_started, std::future<void> can_continue_future) {
+        closure_started.set_value();
+        can_continue_future.wait();
+      },
+      std::move(closure_started),
+      closure_can_continue.get_future()));
+  auto owned = std::make_shared<int>(0);
+  // More than one batch worth
+  for (size_t i = 0; i < 2 * kMaxBatchSize; i++) {
+    handler_->Post(common::BindOnce([](std::shared_ptr<int> owned) { ASSERT_TRUE(false); }, owned));
+  }
+  closure_started_future.wait();
+  handler_->Clear();
+  ASSERT_EQ(owned.use_count(), 1);
+  closure_can_continue.set_value();
+  handler_->WaitUntilStopped(std::chrono::milliseconds(2000));
+}
+
 // For Death tests, all the threading needs to be done in the ASSERT_DEATH call
 class HandlerDeathTest : public ::testing::Test {
  protected:
@@ -24,6 +24,7 @@
 #include "common/bind.h"
 #include "os/linux_generic/linux.h"
 #include "os/log.h"
+#include "os/task_profiler.h"
 #include "os/utils.h"
 
 #ifdef OS_ANDROID
@@ -75,7 +76,10 @@ void Alarm::on_fire() {
   uint64_t times_invoked;
   auto bytes_read = read(fd_, &times_invoked, sizeof(uint64_t));
   lock.unlock();
-  std::move(task).Run();
+  {
+    TaskProfilerScope profile(handler_);
+    std::move(task).Run();
+  }
   ASSERT(bytes_read == static_cast<ssize_t>(sizeof(uint64_t)));
   ASSERT_LOG(
       times_invoked == static_cast<uint64_t>(1),
@@ -0,0 +1,135 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "os/alarm_manager.h"
+
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "common/bind.h"
+#include "os/linux_generic/linux.h"
+#include "os/log.h"
+#include "os/utils.h"
+
+#ifdef OS_ANDROID
+#define ALARM_CLOCK CLOCK_BOOTTIME_ALARM
+#else
+#define ALARM_CLOCK CLOCK_BOOTTIME
+#endif
+
+namespace bluetooth {
+namespace os {
+using common::Closure;
+using common::OnceClosure;
+
+AlarmManager::AlarmManager(Handler* handler) : handler_(handler), fd_(TIMERFD_CREATE(ALARM_CLOCK, TFD_NONBLOCK)) {
+  ASSERT_LOG(fd_ != -1, "cannot create timerfd: %s", strerror(errno));
+
+  token_ = handler_->thread_->GetReactor()->Register(
+      fd_, common::Bind(&AlarmManager::on_fire, common::Unretained(this)), Closure());
+}
+
+AlarmManager::~AlarmManager() {
+  handler_->thread_->GetReactor()->Unregister(token_);
+
+  int close_status;
+  RUN_NO_INTR(close_status = TIMERFD_CLOSE(fd_));
+  ASSERT(close_status != -1);
+}
+
+AlarmManager::AlarmId AlarmManager::Schedule(
+    OnceClosure task, std::chrono::milliseconds delay, std::chrono::milliseconds slack) {
+  ASSERT(delay.count() >= 0 && slack.count() >= 0);
+  std::lock_guard<std::mutex> lock(mutex_);
+  uint64_t now_ms = TIMERFD_GET_CLOCK_MS();
+  AlarmId id = next_id_++;
+  uint64_t deadline_ms = now_ms + delay.count();
+  uint64_t latest_ms = deadline_ms + slack.count();
+  alarms_.emplace(id, PendingAlarm{std::move(task), deadline_ms, latest_ms});
+  by_deadline_.emplace(deadline_ms, id);
+  by_latest_.emplace(latest_ms, id);
+  if (armed_ms_ == 0 || latest_ms < armed_ms_) {
+    rearm(now_ms);
+  }
+  return id;
+}
+
+bool AlarmManager::Cancel(AlarmId id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = alarms_.find(id);
+  if (it == alarms_.end()) {
+    return false;
+  }
+  by_deadline_.erase({it->second.deadline_ms, id});
+  by_latest_.erase({it->second.latest_ms, id});
+  alarms_.erase(it);
+  // Leave the timer armed for a later wakeup than needed rather than paying a syscall per cancel, unless nothing is
+  // left to wait for
+  if (alarms_.empty()) {
+    rearm(TIMERFD_GET_CLOCK_MS());
+  }
+  return true;
+}
+
+size_t AlarmManager::GetPendingCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return alarms_.size();
+}
+
+// Must be called with |mutex_| held
+void AlarmManager::rearm(uint64_t now_ms) {
+  itimerspec timer_itimerspec{/* disarm timer */};
+  armed_ms_ = 0;
+  if (!by_latest_.empty()) {
+    armed_ms_ = by_latest_.begin()->first;
+    // A zero expiration would disarm the timer, fire overdue alarms as soon as possible instead
+    long delay_ms = armed_ms_ > now_ms ? static_cast<long>(armed_ms_ - now_ms) : 1;
+    timer_itimerspec.it_value = {delay_ms / 1000, delay_ms % 1000 * 1000000};
+  }
+  int result = TIMERFD_SETTIME(fd_, 0, &timer_itimerspec, nullptr);
+  ASSERT(result == 0);
+}
+
+void AlarmManager::on_fire() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  uint64_t times_invoked;
+  auto bytes_read = read(fd_, &times_invoked, sizeof(uint64_t));
+  // The timer may have been re-armed after it became readable
+  ASSERT(bytes_read == static_cast<ssize_t>(sizeof(uint64_t)) || errno == EAGAIN);
+
+  // Run every alarm that is due, including the ones with slack left, one at a time so that a task can still cancel
+  // the ones behind it
+  uint64_t now_ms = TIMERFD_GET_CLOCK_MS();
+  while (!by_deadline_.empty() && by_deadline_.begin()->first <= now_ms) {
+    AlarmId id = by_deadline_.begin()->second;
+    auto it = alarms_.find(id);
+    auto task = std::move(it->second.task);
+    by_deadline_.erase(by_deadline_.begin());
+    by_latest_.erase({it->second.latest_ms, id});
+    alarms_.erase(it);
+    lock.unlock();
+    std::move(task).Run();
+    lock.lock();
+  }
+  rearm(TIMERFD_GET_CLOCK_MS());
+}
+
+}  // namespace os
+}  // namespace bluetooth
@@ -0,0 +1,173 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "os/alarm_manager.h"
+
+#include <future>
+#include <vector>
+
+#include "common/bind.h"
+#include "gtest/gtest.h"
+#include "os/fake_timer/fake_timerfd.h"
+
+namespace bluetooth {
+namespace os {
+namespace {
+
+using common::BindOnce;
+using fake_timer::fake_timerfd_advance;
+using fake_timer::fake_timerfd_reset;
+using std::chrono::milliseconds;
+
+class AlarmManagerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    thread_ = new Thread("test_thread", Thread::Priority::NORMAL);
+    handler_ = new Handler(thread_);
+    alarm_manager_ = new AlarmManager(handler_);
+  }
+
+  void TearDown() override {
+    delete alarm_manager_;
+    handler_->Clear();
+    delete handler_;
+    delete thread_;
+    fake_timerfd_reset();
+  }
+
+  void fake_timer_advance(uint64_t ms) {
+    handler_->Post(common::BindOnce(fake_timerfd_advance, ms));
+  }
+
+  // Wait until everything posted to, or woken up on, the handler thread so far has run
+  void sync_handler() {
+    for (int i = 0; i < 2; i++) {
+      std::promise<void> promise;
+      auto future = promise.get_future();
+      handler_->Post(BindOnce(&std::promise<void>::set_value, common::Unretained(&promise)));
+      future.get();
+    }
+  }
+
+  void record(int value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    fired_.push_back(value);
+  }
+
+  std::vector<int> fired() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return fired_;
+  }
+
+  AlarmManager* alarm_manager_;
+
+ private:
+  Handler* handler_;
+  Thread* thread_;
+  std::mutex mutex_;
+  std::vector<int> fired_;
+};
+
+TEST_F(AlarmManagerTest, cancel_unknown) {
+  ASSERT_FALSE(alarm_manager_->Cancel(AlarmManager::kInvalidAlarmId));
+  ASSERT_FALSE(alarm_manager_->Cancel(42));
+}
+
+TEST_F(AlarmManagerTest, schedule) {
+  std::promise<void> promise;
+  auto future = promise.get_future();
+  alarm_manager_->Schedule(
+      BindOnce(&std::promise<void>::set_value, common::Unretained(&promise)), milliseconds(10));
+  ASSERT_EQ(alarm_manager_->GetPendingCount(), 1u);
+  fake_timer_advance(10);
+  future.get();
+  ASSERT_EQ(alarm_manager_->GetPendingCount(), 0u);
+}
+
+TEST_F(AlarmManagerTest, fire_in_deadline_order) {
+  for (int i : {3, 1, 2}) {
+    alarm_manager_->Schedule(BindOnce(&AlarmManagerTest::record, common::Unretained(this), i), milliseconds(10 * i));
+  }
+  fake_timer_advance(10);
+  sync_handler();
+  ASSERT_EQ(fired(), std::vector<int>({1}));
+  fake_timer_advance(20);
+  sync_handler();
+  ASSERT_EQ(fired(), std::vector<int>({1, 2, 3}));
+}
+
+TEST_F(AlarmManagerTest, cancel_alarm) {
+  auto id = alarm_manager_->Schedule(
+      BindOnce([]() { ASSERT_TRUE(false) << "Should not happen"; }), milliseconds(3));
+  alarm_manager_->Schedule(BindOnce(&AlarmManagerTest::record, common::Unretained(this), 1), milliseconds(5));
+  ASSERT_TRUE(alarm_manager_->Cancel(id));
+  ASSERT_FALSE(alarm_manager_->Cancel(id));
+  fake_timer_advance(5);
+  sync_handler();
+  ASSERT_EQ(fired(), std::vector<int>({1}));
+}
+
+TEST_F(AlarmManagerTest, slack_defers_until_latest) {
+  alarm_manager_->Schedule(
+      BindOnce(&AlarmManagerTest::record, common::Unretained(this), 1), milliseconds(10), milliseconds(40));
+  fake_timer_advance(30);
+  sync_handler();
+  ASSERT_TRUE(fired().empty());
+  fake_timer_advance(20);
+  sync_handler();
+  ASSERT_EQ(fired(), std::vector<int>({1}));
+}
+
+TEST_F(AlarmManagerTest, slack_alarms_coalesce_with_precise_alarm) {
+  alarm_manager_->Schedule(
+      BindOnce(&AlarmManagerTest::record, common::Unretained(this), 1), milliseconds(10), milliseconds(1000));
+  alarm_manager_->Schedule(
+      BindOnce(&AlarmManagerTest::record, common::Unretained(this), 2), milliseconds(20), milliseconds(1000));
+  alarm_manager_->Schedule(BindOnce(&AlarmManagerTest::record, common::Unretained(this), 3), milliseconds(30));
+  alarm_manager_->Schedule(
+      BindOnce(&AlarmManagerTest::record, common::Unretained(this), 4), milliseconds(40), milliseconds(1000));
+  fake_timer_advance(30);
+  sync_handler();
+  ASSERT_EQ(fired(), std::vector<int>({1, 2, 3}));
+  ASSERT_EQ(alarm_manager_->GetPendingCount(), 1u);
+}
+
+TEST_F(AlarmManagerTest, cancel_from_earlier_callback) {
+  auto id = alarm_manager_->Schedule(
+      BindOnce([]() { ASSERT_TRUE(false) << "Should not happen"; }), milliseconds(10));
+  alarm_manager_->Schedule(
+      BindOnce(
+          [](AlarmManager* alarm_manager, AlarmManager::AlarmId id) { ASSERT_TRUE(alarm_manager->Cancel(id)); },
+          common::Unretained(alarm_manager_),
+          id),
+      milliseconds(5));
+  fake_timer_advance(10);
+  sync_handler();
+  ASSERT_EQ(alarm_manager_->GetPendingCount(), 0u);
+}
+
+TEST_F(AlarmManagerTest, delete_while_alarm_armed) {
+  alarm_manager_->Schedule(BindOnce([]() { ASSERT_TRUE(false) << "Should not happen"; }), milliseconds(1));
+  delete alarm_manager_;
+  alarm_manager_ = nullptr;
+  fake_timer_advance(10);
+  sync_handler();
+}
+
+}  // namespace
+}  // namespace os
+}  // namespace bluetooth
@@ -0,0 +1,339 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "os/binary_log.h"
+
+#include <unistd.h>
+
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#include "os/log.h"
+#include "os/system_properties.h"
+#include "os/utils.h"
+
+namespace bluetooth {
+namespace os {
+
+namespace {
+
+constexpr char kEnabledProperty[] = "persist.bluetooth.binary_log.enabled";
+constexpr char kMissingArg[] = "<?>";
+
+struct ArgCopy {
+  BinaryLog::ArgType type;
+  uint8_t size;
+  uint64_t value;
+};
+
+struct RecordCopy {
+  pid_t tid;
+  uint64_t timestamp_ns;
+  const char* tag;
+  const char* file;
+  int line;
+  const char* function;
+  const char* format;
+  std::vector<ArgCopy> args;
+  std::array<char, BinaryLog::kStringBytes> strings;
+};
+
+// Copy the records of |buffer| that were not overwritten while being read, oldest first
+std::vector<RecordCopy> CopyRecords(const BinaryLog::ThreadBuffer& buffer) {
+  uint64_t published = buffer.published.load(std::memory_order_acquire);
+  uint64_t begin = published > BinaryLog::kBufferSize ? published - BinaryLog::kBufferSize : 0;
+  begin = std::min(std::max(begin, buffer.cleared.load(std::memory_order_relaxed)), published);
+  std::vector<RecordCopy> records;
+  records.reserve(published - begin);
+  for (uint64_t i = begin; i < published; i++) {
+    const BinaryLog::Record& record = buffer.records[i % BinaryLog::kBufferSize];
+    RecordCopy copy{
+        buffer.tid,
+        record.timestamp_ns.load(std::memory_order_relaxed),
+        record.tag.load(std::memory_order_relaxed),
+        record.file.load(std::memory_order_relaxed),
+        record.line.load(std::memory_order_relaxed),
+        record.function.load(std::memory_order_relaxed),
+        record.format.load(std::memory_order_relaxed),
+        {},
+        {}};
+    size_t num_args = std::min<size_t>(record.num_args.load(std::memory_order_relaxed), BinaryLog::kMaxArgs);
+    for (size_t arg = 0; arg < num_args; arg++) {
+      copy.args.push_back(ArgCopy{
+          record.types[arg].load(std::memory_order_relaxed),
+          record.sizes[arg].load(std::memory_order_relaxed),
+          record.args[arg].load(std::memory_order_relaxed)});
+    }
+    for (size_t c = 0; c < BinaryLog::kStringBytes; c++) {
+      copy.strings[c] = record.strings[c].load(std::memory_order_relaxed);
+    }
+    records.push_back(std::move(copy));
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+  // The writer may be overwriting any record before reserved - kBufferSize
+  uint64_t reserved = buffer.reserved.load(std::memory_order_relaxed);
+  uint64_t valid = reserved > BinaryLog::kBufferSize ? reserved - BinaryLog::kBufferSize : 0;
+  if (valid > begin) {
+    records.erase(records.begin(), records.begin() + std::min<uint64_t>(valid - begin, records.size()));
+  }
+  return records;
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wformat-nonliteral"
+template <typename T>
+void AppendFormatted(std::string* output, const std::string& spec, T value) {
+  char buf[256];
+  int length = snprintf(buf, sizeof(buf), spec.c_str(), value);
+  if (length < 0) {
+    output->append(kMissingArg);
+  } else if (static_cast<size_t>(length) < sizeof(buf)) {
+    output->append(buf, length);
+  } else {
+    std::string large(length + 1, '\0');
+    snprintf(large.data(), large.size(), spec.c_str(), value);
+    output->append(large.data(), length);
+  }
+}
+#pragma clang diagnostic pop
+
+// Integer argument as printf would read it, promoted to int if smaller
+size_t PromotedSize(const ArgCopy& arg) {
+  return std::max<size_t>(arg.size, sizeof(int));
+}
+
+uint64_t UnsignedValue(const ArgCopy& arg) {
+  if (arg.type == BinaryLog::ArgType::DOUBLE || PromotedSize(arg) >= sizeof(uint64_t)) {
+    return arg.value;
+  }
+  return arg.value & ((uint64_t{1} << (8 * PromotedSize(arg))) - 1);
+}
+
+int64_t SignedValue(const ArgCopy& arg) {
+  if (arg.type == BinaryLog::ArgType::DOUBLE || PromotedSize(arg) >= sizeof(uint64_t)) {
+    return static_cast<int64_t>(arg.value);
+  }
+  uint64_t sign = uint64_t{1} << (8 * PromotedSize(arg) - 1);
+  return static_cast<int64_t>((UnsignedValue(arg) ^ sign) - sign);
+}
+
+double DoubleValue(const ArgCopy& arg) {
+  switch (arg.type) {
+    case BinaryLog::ArgType::DOUBLE: {
+      double value;
+      std::memcpy(&value, &arg.value, sizeof(value));
+      return value;
+    }
+    case BinaryLog::ArgType::SIGNED:
+      return static_cast<double>(static_cast<int64_t>(arg.value));
+    default:
+      return static_cast<double>(arg.value);
+  }
+}
+
+// printf the arguments of |record| into its format string. The length modifiers are replaced by the ones of the
+// recorded values, and any conversion without a matching argument prints kMissingArg
+std::string FormatMessage(const RecordCopy& record) {
+  std::string message;
+  size_t next_arg = 0;
+  auto next = [&record, &next_arg]() -> const ArgCopy* {
+    return next_arg < record.args.size() ? &record.args[next_arg++] : nullptr;
+  };
+
+  const char* p = record.format;
+  while (*p != '\0') {
+    if (*p != '%') {
+      message.push_back(*p++);
+      continue;
+    }
+    const char* conversion_begin = p++;
+    if (*p == '%') {
+      message.push_back(*p++);
+      continue;
+    }
+
+    std::string spec = "%";
+    while (*p != '\0' && strchr("-+ #0", *p) != nullptr) {
+      spec.push_back(*p++);
+    }
+    // Width then precision
+    for (int part = 0; part < 2; part++) {
+      if (part == 1) {
+        if (*p != '.') {
+          break;
+        }
+        spec.push_back(*p++);
+      }
+      if (*p == '*') {
+        p++;
+        const ArgCopy* arg = next();
+        int value = arg != nullptr ? static_cast<int>(arg->value) : 0;
+        if (part == 1 && value < 0) {
+          // A negative precision is taken as if omitted
+          spec.pop_back();
+        } else {
+          spec += std::to_string(value);
+        }
+      } else {
+        while (isdigit(static_cast<unsigned char>(*p))) {
+          spec.push_back(*p++);
+        }
+      }
+    }
+    while (*p != '\0' && strchr("hljztLq", *p) != nullptr) {
+      p++;
+    }
+    if (*p == '\0') {
+      message.append(conversion_begin);
+      break;
+    }
+
+    const char conversion = *p++;
+    if (strchr("diouxXcfFeEgGaAspn", conversion) == nullptr) {
+      message.append(conversion_begin, p - conversion_begin);
+      continue;
+    }
+    const ArgCopy* arg = next();
+    if (arg == nullptr) {
+      message.append(kMissingArg);
+      continue;
+    }
+    switch (conversion) {
+      case 'd':
+      case 'i':
+        AppendFormatted(&message, spec + "ll" + conversion, static_cast<long long>(SignedValue(*arg)));
+        break;
+      case 'o':
+      case 'u':
+      case 'x':
+      case 'X':
+        AppendFormatted(&message, spec + "ll" + conversion, static_cast<unsigned long long>(UnsignedValue(*arg)));
+        break;
+      case 'c':
+        AppendFormatted(&message, spec + conversion, static_cast<int>(arg->value));
+        break;
+      case 's':
+        if (arg->type != BinaryLog::ArgType::STRING) {
+          message.append(kMissingArg);
+        } else if (arg->value >= record.strings.size()) {
+          AppendFormatted(&message, spec + conversion, "");
+        } else {
+          std::string string(record.strings.data() + arg->value, record.strings.size() - arg->value);
+          AppendFormatted(&message, spec + conversion, string.c_str());
+        }
+        break;
+      case 'p':
+        AppendFormatted(&message, spec + conversion, reinterpret_cast<void*>(static_cast<uintptr_t>(arg->value)));
+        break;
+      case 'n':
+        break;
+      default:
+        AppendFormatted(&message, spec + conversion, DoubleValue(*arg));
+        break;
+    }
+  }
+  return message;
+}
+
+void AppendLine(std::string* output, const RecordCopy& record) {
+  time_t seconds = static_cast<time_t>(record.timestamp_ns / 1000000000);
+  struct tm tm = {};
+  localtime_r(&seconds, &tm);
+  char timestamp[32];
+  size_t length = strftime(timestamp, sizeof(timestamp), "%m-%d %H:%M:%S", &tm);
+  snprintf(
+      timestamp + length,
+      sizeof(timestamp) - length,
+      ".%03u",
+      static_cast<unsigned int>((record.timestamp_ns % 1000000000) / 1000000));
+  char prefix[96];
+  snprintf(prefix, sizeof(prefix), "%s %7d D ", timestamp, static_cast<int>(record.tid));
+  output->append(prefix);
+  output->append(std::string(record.tag) + ": " + record.file + ":" + std::to_string(record.line) + " " +
+                 record.function + ": " + FormatMessage(record) + "\n");
+}
+
+}  // namespace
+
+void BinaryLog::SetEnabledFromSystemProperty() {
+  auto value = GetSystemProperty(kEnabledProperty);
+  if (!value) {
+    return;
+  }
+  if (*value != "true" && *value != "false") {
+    LOG_WARN("Invalid %s:%s", kEnabledProperty, value->c_str());
+    return;
+  }
+  LOG_INFO("Binary logging %s", *value == "true" ? "enabled" : "disabled");
+  SetEnabled(*value == "true");
+}
+
+std::string BinaryLog::ToString() {
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  {
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    buffers = registry_;
+  }
+
+  std::vector<RecordCopy> records;
+  for (const auto& buffer : buffers) {
+    auto thread_records = CopyRecords(*buffer);
+    records.insert(
+        records.end(), std::make_move_iterator(thread_records.begin()), std::make_move_iterator(thread_records.end()));
+  }
+  std::stable_sort(records.begin(), records.end(), [](const RecordCopy& a, const RecordCopy& b) {
+    return a.timestamp_ns < b.timestamp_ns;
+  });
+
+  std::string output;
+  for (const auto& record : records) {
+    AppendLine(&output, record);
+  }
+  return output;
+}
+
+void BinaryLog::Write(int fd) {
+  std::string output = ToString();
+  size_t written = 0;
+  while (written < output.size()) {
+    ssize_t result;
+    RUN_NO_INTR(result = write(fd, output.data() + written, output.size() - written));
+    if (result <= 0) {
+      LOG_WARN("Unable to write the binary log: %s", strerror(errno));
+      return;
+    }
+    written += result;
+  }
+}
+
+void BinaryLog::Clear() {
+  std::lock_guard<std::mutex> lock(registry_mutex_);
+  registry_.erase(
+      std::remove_if(
+          registry_.begin(),
+          registry_.end(),
+          [](const std::shared_ptr<ThreadBuffer>& buffer) { return buffer.use_count() == 1; }),
+      registry_.end());
+  for (const auto& buffer : registry_) {
+    buffer->cleared.store(buffer->published.load(std::memory_order_acquire), std::memory_order_relaxed);
+  }
+}
+
+}  // namespace os
+}  // namespace bluetooth
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "os/binary_log.h"
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace bluetooth {
+namespace os {
+namespace {
+
+enum class TestEnum : uint8_t { VALUE = 7 };
+
+std::vector<std::string> LogLines() {
+  std::vector<std::string> lines;
+  std::istringstream stream(BinaryLog::ToString());
+  std::string line;
+  while (std::getline(stream, line)) {
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+// Message of the line, after the location and function
+std::string Message(const std::string& line) {
+  auto pos = line.find(": ", line.find("binary_log_unittest.cc:"));
+  return pos == std::string::npos ? line : line.substr(pos + 2);
+}
+
+#define TEST_BINARY_LOG(fmt, args...) BinaryLog::Log("BinaryLogTest", __FILE__, __LINE__, __func__, fmt, ##args)
+
+class BinaryLogTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    BinaryLog::Clear();
+  }
+
+  void TearDown() override {
+    BinaryLog::SetEnabled(false);
+    BinaryLog::Clear();
+  }
+};
+
+TEST_F(BinaryLogTest, disabled_by_default) {
+  EXPECT_FALSE(BinaryLog::IsEnabled());
+  BinaryLog::SetEnabled(true);
+  EXPECT_TRUE(BinaryLog::IsEnabled());
+}
+
+TEST_F(BinaryLogTest, formats_when_dumped) {
+  TEST_BINARY_LOG("no argument");
+  TEST_BINARY_LOG("handle:0x%04x status:%d name:%s", 0x40, -3, "device");
+  auto lines = LogLines();
+  ASSERT_EQ(lines.size(), 2u);
+  EXPECT_NE(lines[0].find(" D BinaryLogTest: "), std::string::npos);
+  EXPECT_NE(lines[0].find("binary_log_unittest.cc:"), std::string::npos);
+  EXPECT_EQ(Message(lines[0]), "no argument");
+  EXPECT_EQ(Message(lines[1]), "handle:0x0040 status:-3 name:device");
+}
+
+TEST_F(BinaryLogTest, formats_like_printf) {
+  uint8_t byte = 0xc8;
+  int8_t negative = -1;
+  uint64_t large = UINT64_MAX;
+  int value = 42;
+  TEST_BINARY_LOG("%u %x %d %llu", byte, negative, negative, static_cast<unsigned long long>(large));
+  TEST_BINARY_LOG("%5.2f|%-4d|%*d|%.*s|%c|%%", 3.14159, 7, 3, 1, 2, "abc", 'z');
+  TEST_BINARY_LOG("%d %s %p", TestEnum::VALUE, true ? "yes" : "no", &value);
+  auto lines = LogLines();
+  ASSERT_EQ(lines.size(), 3u);
+  EXPECT_EQ(Message(lines[0]), "200 ffffffff -1 18446744073709551615");
+  EXPECT_EQ(Message(lines[1]), " 3.14|7   |  1|ab|z|%");
+  char pointer[32];
+  snprintf(pointer, sizeof(pointer), "%p", &value);
+  EXPECT_EQ(Message(lines[2]), std::string("7 yes ") + pointer);
+}
+
+TEST_F(BinaryLogTest, strings_are_copied_and_truncated) {
+  std::string name = "first";
+  std::string long_name(2 * BinaryLog::kStringBytes, 'a');
+  TEST_BINARY_LOG("%s %s %s", name.c_str(), long_name.c_str(), "dropped");
+  name = "overwritten";
+  auto lines = LogLines();
+  ASSERT_EQ(lines.size(), 1u);
+  // "first" and the long name fill the strings of the record, each with its null terminator
+  EXPECT_EQ(Message(lines[0]), "first " + std::string(BinaryLog::kStringBytes - 7, 'a') + " ");
+}
+
+TEST_F(BinaryLogTest, missing_arguments_are_marked) {
+  TEST_BINARY_LOG("%d %d %d %d %d %d %d %d %d", 1, 2, 3, 4, 5, 6, 7, 8, 9);
+  TEST_BINARY_LOG("%s", 1);
+  auto lines = LogLines();
+  ASSERT_EQ(lines.size(), 2u);
+  EXPECT_EQ(Message(lines[0]), "1 2 3 4 5 6 7 8 <?>");
+  EXPECT_EQ(Message(lines[1]), "<?>");
+}
+
+TEST_F(BinaryLogTest, keeps_the_latest_records_of_each_thread) {
+  for (size_t i = 0; i < BinaryLog::kBufferSize + 10; i++) {
+    TEST_BINARY_LOG("main %zu", i);
+  }
+  std::thread thread([]() { TEST_BINARY_LOG("other thread"); });
+  thread.join();
+  auto lines = LogLines();
+  ASSERT_EQ(lines.size(), BinaryLog::kBufferSize + 1);
+  EXPECT_EQ(Message(lines[0]), "main 10");
+  EXPECT_EQ(Message(lines.back()), "other thread");
+}
+
+TEST_F(BinaryLogTest, clear_drops_the_records) {
+  TEST_BINARY_LOG("before clear");
+  BinaryLog::Clear();
+  TEST_BINARY_LOG("after clear");
+  auto lines = LogLines();
+  ASSERT_EQ(lines.size(), 1u);
+  EXPECT_EQ(Message(lines[0]), "after clear");
+}
+
+}  // namespace
+}  // namespace os
+}  // namespace bluetooth
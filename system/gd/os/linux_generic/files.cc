@@ -126,14 +126,14 @@ bool WriteToFile(const std::string& path, const std::string& data) {
     return false;
   }
 
-  FILE* fp = std::fopen(temp_path.c_str(), "wt");
+  FILE* fp = std::fopen(temp_path.c_str(), "wb");
   if (!fp) {
     LOG_ERROR("unable to write to file '%s', error: %s", temp_path.c_str(), strerror(errno));
     HandleError(temp_path, &dir_fd, &fp);
     return false;
   }
 
-  if (std::fprintf(fp, "%s", data.c_str()) < 0) {
+  if (std::fwrite(data.data(), 1, data.size(), fp) != data.size()) {
     LOG_ERROR("unable to write to file '%s', error: %s", temp_path.c_str(), strerror(errno));
     HandleError(temp_path, &dir_fd, &fp);
     return false;
@@ -187,6 +187,51 @@ bool WriteToFile(const std::string& path, const std::string& data) {
   return true;
 }
 
+bool AppendToFile(const std::string& path, const std::string& data) {
+  ASSERT(!path.empty());
+  bool created = !FileExists(path);
+  int fd = open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP);
+  if (fd < 0) {
+    LOG_ERROR("unable to open file '%s', error: %s", path.c_str(), strerror(errno));
+    return false;
+  }
+  size_t written = 0;
+  while (written < data.size()) {
+    ssize_t ret = write(fd, data.data() + written, data.size() - written);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      LOG_ERROR("unable to write to file '%s', error: %s", path.c_str(), strerror(errno));
+      close(fd);
+      return false;
+    }
+    written += ret;
+  }
+  if (fsync(fd) != 0) {
+    LOG_WARN("unable to fsync file '%s', error: %s", path.c_str(), strerror(errno));
+  }
+  if (close(fd) != 0) {
+    LOG_ERROR("unable to close file '%s', error: %s", path.c_str(), strerror(errno));
+    return false;
+  }
+  if (created) {
+    // A new file also needs its directory entry on disk
+    std::string temp_path_for_dir(path);
+    std::string directory_path(dirname(temp_path_for_dir.data()));
+    int dir_fd = open(directory_path.c_str(), O_RDONLY | O_DIRECTORY);
+    if (dir_fd < 0) {
+      LOG_WARN("unable to open dir '%s', error: %s", directory_path.c_str(), strerror(errno));
+      return true;
+    }
+    if (fsync(dir_fd) != 0) {
+      LOG_WARN("unable to fsync dir '%s', error: %s", directory_path.c_str(), strerror(errno));
+    }
+    close(dir_fd);
+  }
+  return true;
+}
+
 bool RemoveFile(const std::string& path) {
   if (remove(path.c_str()) != 0) {
     LOG_ERROR("unable to remove file '%s', error: %s", path.c_str(), strerror(errno));
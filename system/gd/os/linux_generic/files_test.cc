@@ -23,6 +23,7 @@
 
 namespace testing {
 
+using bluetooth::os::AppendToFile;
 using bluetooth::os::FileExists;
 using bluetooth::os::ReadSmallFile;
 using bluetooth::os::RenameFile;
@@ -61,6 +62,15 @@ TEST(FilesTest, write_read_loopback_test) {
   EXPECT_TRUE(std::filesystem::remove(temp_file));
 }
 
+TEST(FilesTest, write_read_binary_test) {
+  auto temp_dir = std::filesystem::temp_directory_path();
+  auto temp_file = temp_dir / "file_1.bin";
+  std::string data("\x01\x00\x02\n\xff", 5);
+  ASSERT_TRUE(WriteToFile(temp_file.string(), data));
+  EXPECT_THAT(ReadSmallFile(temp_file.string()), Optional(Eq(data)));
+  EXPECT_TRUE(std::filesystem::remove(temp_file));
+}
+
 TEST(FilesTest, overwrite_test) {
   auto temp_dir = std::filesystem::temp_directory_path();
   auto temp_file = temp_dir / "file_1.txt";
@@ -73,6 +83,17 @@ TEST(FilesTest, overwrite_test) {
   EXPECT_TRUE(std::filesystem::remove(temp_file));
 }
 
+TEST(FilesTest, append_test) {
+  auto temp_dir = std::filesystem::temp_directory_path();
+  auto temp_file = temp_dir / "file_1.txt";
+  ASSERT_FALSE(FileExists(temp_file.string()));
+  ASSERT_TRUE(AppendToFile(temp_file.string(), "Hello "));
+  EXPECT_THAT(ReadSmallFile(temp_file.string()), Optional(StrEq("Hello ")));
+  ASSERT_TRUE(AppendToFile(temp_file.string(), "world!\n"));
+  EXPECT_THAT(ReadSmallFile(temp_file.string()), Optional(StrEq("Hello world!\n")));
+  EXPECT_TRUE(std::filesystem::remove(temp_file));
+}
+
 TEST(FilesTest, write_read_empty_string_test) {
   auto temp_dir = std::filesystem::temp_directory_path();
   auto temp_file = temp_dir / "file_1.txt";
@@ -25,8 +25,21 @@
 #define TIMERFD_CREATE ::bluetooth::os::fake_timer::fake_timerfd_create
 #define TIMERFD_SETTIME ::bluetooth::os::fake_timer::fake_timerfd_settime
 #define TIMERFD_CLOSE ::bluetooth::os::fake_timer::fake_timerfd_close
+#define TIMERFD_GET_CLOCK_MS ::bluetooth::os::fake_timer::fake_timerfd_get_clock
 #else
+#include <time.h>
+
+#include <cstdint>
+
+// Time on the clock relative timerfd timers are measured against
+inline uint64_t timerfd_get_clock_ms() {
+  timespec now;
+  clock_gettime(CLOCK_BOOTTIME, &now);
+  return static_cast<uint64_t>(now.tv_sec) * 1000 + now.tv_nsec / 1000000;
+}
+
 #define TIMERFD_CREATE timerfd_create
 #define TIMERFD_SETTIME timerfd_settime
 #define TIMERFD_CLOSE close
+#define TIMERFD_GET_CLOCK_MS timerfd_get_clock_ms
 #endif
@@ -15,7 +15,7 @@
  */
 
 template <typename T>
-Queue<T>::Queue(size_t capacity) : enqueue_(capacity), dequeue_(0){};
+Queue<T>::Queue(size_t capacity) : capacity_(capacity), enqueue_(capacity > 0 ? 1 : 0), dequeue_(0){};
 
 template <typename T>
 Queue<T>::~Queue() {
@@ -31,7 +31,24 @@ void Queue<T>::RegisterEnqueue(Handler* handler, EnqueueCallback callback) {
   enqueue_.handler_ = handler;
   enqueue_.reactable_ = enqueue_.handler_->thread_->GetReactor()->Register(
       enqueue_.reactive_semaphore_.GetFd(),
-      base::Bind(&Queue<T>::EnqueueCallbackInternal, base::Unretained(this), std::move(callback)),
+      base::Bind(
+          &Queue<T>::EnqueueCallbackInternal, base::Unretained(this), base::Unretained(handler), std::move(callback)),
+      base::Closure());
+}
+
+template <typename T>
+void Queue<T>::RegisterBatchEnqueue(Handler* handler, BatchEnqueueCallback callback) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ASSERT(enqueue_.handler_ == nullptr);
+  ASSERT(enqueue_.reactable_ == nullptr);
+  enqueue_.handler_ = handler;
+  enqueue_.reactable_ = enqueue_.handler_->thread_->GetReactor()->Register(
+      enqueue_.reactive_semaphore_.GetFd(),
+      base::Bind(
+          &Queue<T>::BatchEnqueueCallbackInternal,
+          base::Unretained(this),
+          base::Unretained(handler),
+          std::move(callback)),
       base::Closure());
 }
 
@@ -62,7 +79,10 @@ void Queue<T>::RegisterDequeue(Handler* handler, DequeueCallback callback) {
   ASSERT(dequeue_.reactable_ == nullptr);
   dequeue_.handler_ = handler;
   dequeue_.reactable_ = dequeue_.handler_->thread_->GetReactor()->Register(
-      dequeue_.reactive_semaphore_.GetFd(), callback, base::Closure());
+      dequeue_.reactive_semaphore_.GetFd(),
+      base::Bind(
+          &Queue<T>::DequeueCallbackInternal, base::Unretained(this), base::Unretained(handler), std::move(callback)),
+      base::Closure());
 }
 
 template <typename T>
@@ -93,22 +113,74 @@ std::unique_ptr<T> Queue<T>::TryDequeue() {
     return nullptr;
   }
 
-  dequeue_.reactive_semaphore_.Decrease();
-
-  std::unique_ptr<T> data = std::move(queue_.front());
-  queue_.pop();
+  return Pop();
+}
 
-  enqueue_.reactive_semaphore_.Increase();
+template <typename T>
+std::vector<std::unique_ptr<T>> Queue<T>::TryDequeueBatch(size_t max_count) {
+  std::lock_guard<std::mutex> lock(mutex_);
 
+  std::vector<std::unique_ptr<T>> data;
+  while (!queue_.empty() && data.size() < max_count) {
+    data.push_back(Pop());
+  }
   return data;
 }
 
 template <typename T>
-void Queue<T>::EnqueueCallbackInternal(EnqueueCallback callback) {
+void Queue<T>::EnqueueCallbackInternal(const Handler* handler, EnqueueCallback callback) {
+  TaskProfilerScope profile(handler);
   std::unique_ptr<T> data = callback.Run();
   ASSERT(data != nullptr);
   std::lock_guard<std::mutex> lock(mutex_);
-  enqueue_.reactive_semaphore_.Decrease();
+  Push(std::move(data));
+}
+
+template <typename T>
+void Queue<T>::BatchEnqueueCallbackInternal(const Handler* handler, BatchEnqueueCallback callback) {
+  TaskProfilerScope profile(handler);
+  size_t room;
+  {
+    // Only this callback enqueues, the room left can only grow until it returns
+    std::lock_guard<std::mutex> lock(mutex_);
+    room = capacity_ - queue_.size();
+  }
+  std::vector<std::unique_ptr<T>> data = callback.Run(room);
+  ASSERT(!data.empty() && data.size() <= room);
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& item : data) {
+    ASSERT(item != nullptr);
+    Push(std::move(item));
+  }
+}
+
+template <typename T>
+void Queue<T>::Push(std::unique_ptr<T> data) {
+  ASSERT(queue_.size() < capacity_);
+  if (queue_.empty()) {
+    dequeue_.reactive_semaphore_.Increase();
+  }
   queue_.push(std::move(data));
-  dequeue_.reactive_semaphore_.Increase();
+  if (queue_.size() == capacity_) {
+    enqueue_.reactive_semaphore_.Decrease();
+  }
+}
+
+template <typename T>
+std::unique_ptr<T> Queue<T>::Pop() {
+  if (queue_.size() == capacity_) {
+    enqueue_.reactive_semaphore_.Increase();
+  }
+  std::unique_ptr<T> data = std::move(queue_.front());
+  queue_.pop();
+  if (queue_.empty()) {
+    dequeue_.reactive_semaphore_.Decrease();
+  }
+  return data;
+}
+
+template <typename T>
+void Queue<T>::DequeueCallbackInternal(const Handler* handler, DequeueCallback callback) {
+  TaskProfilerScope profile(handler);
+  callback.Run();
 }
@@ -21,6 +21,7 @@
 #include <atomic>
 #include <future>
 #include <unordered_map>
+#include <vector>
 
 #include "common/bind.h"
 #include "gtest/gtest.h"
@@ -732,6 +733,62 @@ TEST_F(QueueTest, pass_smart_pointer_and_unregister) {
   future.wait();
 }
 
+TEST_F(QueueTest, enqueue_buffer_batch_and_try_dequeue_batch) {
+  Queue<int> queue(kQueueSize);
+  EnqueueBuffer<int> enqueue_buffer(&queue);
+
+  std::promise<void> promise;
+  auto future = promise.get_future();
+  enqueue_buffer.NotifyOnEmpty(
+      common::BindOnce([](std::promise<void>* promise) { promise->set_value(); }, common::Unretained(&promise)));
+  for (int i = 0; i < kHalfOfQueueSize; i++) {
+    enqueue_buffer.Enqueue(std::make_unique<int>(i), enqueue_handler_);
+  }
+  future.wait();
+
+  auto data = queue.TryDequeueBatch(kHalfOfQueueSize - 1);
+  ASSERT_EQ(data.size(), static_cast<size_t>(kHalfOfQueueSize - 1));
+  for (int i = 0; i < kHalfOfQueueSize - 1; i++) {
+    ASSERT_EQ(*data[i], i);
+  }
+  data = queue.TryDequeueBatch(kQueueSize);
+  ASSERT_EQ(data.size(), 1u);
+  ASSERT_EQ(*data[0], kHalfOfQueueSize - 1);
+  ASSERT_TRUE(queue.TryDequeueBatch(kQueueSize).empty());
+}
+
+TEST_F(QueueTest, batch_enqueue_more_than_capacity) {
+  Queue<int> queue(kQueueSize);
+  EnqueueBuffer<int> enqueue_buffer(&queue);
+
+  std::vector<int> dequeued;
+  std::promise<void> promise;
+  auto future = promise.get_future();
+  queue.RegisterDequeue(
+      dequeue_handler_,
+      common::Bind(
+          [](Queue<int>* queue, std::vector<int>* dequeued, std::promise<void>* promise) {
+            for (auto& item : queue->TryDequeueBatch(kQueueSize)) {
+              dequeued->push_back(*item);
+            }
+            if (dequeued->size() == static_cast<size_t>(kDoubleOfQueueSize)) {
+              queue->UnregisterDequeue();
+              promise->set_value();
+            }
+          },
+          common::Unretained(&queue),
+          common::Unretained(&dequeued),
+          common::Unretained(&promise)));
+  for (int i = 0; i < kDoubleOfQueueSize; i++) {
+    enqueue_buffer.Enqueue(std::make_unique<int>(i), enqueue_handler_);
+  }
+  future.wait();
+
+  for (int i = 0; i < kDoubleOfQueueSize; i++) {
+    ASSERT_EQ(dequeued[i], i);
+  }
+}
+
 std::unique_ptr<std::string> sleep_and_enqueue_callback(int* to_increase) {
   std::this_thread::sleep_for(std::chrono::milliseconds(100));
   (*to_increase)++;
@@ -27,6 +27,7 @@
 #include <cstring>
 
 #include "os/log.h"
+#include "os/trace.h"
 
 namespace {
 
@@ -35,6 +36,10 @@ constexpr int kEpollMaxEvents = 64;
 constexpr uint64_t kStopReactor = 1 << 0;
 constexpr uint64_t kWaitForIdle = 1 << 1;
 
+// The priority of a reactable is stored in the low bits of its pointer in epoll_event.data, so that ready events can
+// be ordered without touching reactables that may have been unregistered in the meantime
+constexpr uintptr_t kPriorityMask = 0x3;
+
 }  // namespace
 
 namespace bluetooth {
@@ -82,15 +87,48 @@ void Reactor::Event::Notify() {
   ASSERT(write_result != -1);
 }
 
-class Reactor::Reactable {
+class alignas(kPriorityMask + 1) Reactor::Reactable {
  public:
-  Reactable(int fd, Closure on_read_ready, Closure on_write_ready)
+  Reactable(int fd, Closure on_read_ready, Closure on_write_ready, Priority priority, Trigger trigger)
       : fd_(fd),
+        priority_(priority),
+        trigger_(trigger),
         on_read_ready_(std::move(on_read_ready)),
         on_write_ready_(std::move(on_write_ready)),
         is_executing_(false),
         removed_(false) {}
+
+  uint32_t poll_event_type() const {
+    uint32_t poll_event_type = trigger_ == Trigger::EDGE ? EPOLLET : 0;
+    if (!on_read_ready_.is_null()) {
+      poll_event_type |= (EPOLLIN | EPOLLRDHUP);
+    }
+    if (!on_write_ready_.is_null()) {
+      poll_event_type |= EPOLLOUT;
+    }
+    return poll_event_type;
+  }
+
+  void* tagged_ptr() {
+    return reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(this) | static_cast<uintptr_t>(priority_));
+  }
+
+  static Reactable* FromTaggedPtr(void* ptr) {
+    return reinterpret_cast<Reactable*>(reinterpret_cast<uintptr_t>(ptr) & ~kPriorityMask);
+  }
+
+  // The control fd has no reactable and is ordered like a NORMAL one, so that the batch is unchanged when every
+  // reactable uses the default priority
+  static uintptr_t PriorityOfTaggedPtr(void* ptr) {
+    if (ptr == nullptr) {
+      return static_cast<uintptr_t>(Priority::NORMAL);
+    }
+    return reinterpret_cast<uintptr_t>(ptr) & kPriorityMask;
+  }
+
   const int fd_;
+  const Priority priority_;
+  const Trigger trigger_;
   Closure on_read_ready_;
   Closure on_write_ready_;
   bool is_executing_;
@@ -139,6 +177,13 @@ void Reactor::Run() {
     int count;
     RUN_NO_INTR(count = epoll_wait(epoll_fd_, events, kEpollMaxEvents, timeout_ms));
     ASSERT(count != -1);
+    OS_TRACE_SCOPE_ARG("Reactor::Wakeup", count);
+    if (count > 1) {
+      // Service higher priority reactables first, keeping the kernel's order within a priority
+      std::stable_sort(events, events + count, [](const epoll_event& a, const epoll_event& b) {
+        return Reactable::PriorityOfTaggedPtr(a.data.ptr) < Reactable::PriorityOfTaggedPtr(b.data.ptr);
+      });
+    }
     if (waiting_for_idle && count == 0) {
       timeout_ms = -1;
       waiting_for_idle = false;
@@ -166,7 +211,7 @@ void Reactor::Run() {
           continue;
         }
       }
-      auto* reactable = static_cast<Reactor::Reactable*>(event.data.ptr);
+      auto* reactable = Reactable::FromTaggedPtr(event.data.ptr);
       std::unique_lock<std::mutex> lock(mutex_);
       executing_reactable_finished_ = nullptr;
       // See if this reactable has been removed in the meantime.
@@ -211,17 +256,15 @@ std::unique_ptr<Reactor::Event> Reactor::NewEvent() const {
 }
 
 Reactor::Reactable* Reactor::Register(int fd, Closure on_read_ready, Closure on_write_ready) {
-  uint32_t poll_event_type = 0;
-  if (!on_read_ready.is_null()) {
-    poll_event_type |= (EPOLLIN | EPOLLRDHUP);
-  }
-  if (!on_write_ready.is_null()) {
-    poll_event_type |= EPOLLOUT;
-  }
-  auto* reactable = new Reactable(fd, on_read_ready, on_write_ready);
+  return Register(fd, std::move(on_read_ready), std::move(on_write_ready), Priority::NORMAL, Trigger::LEVEL);
+}
+
+Reactor::Reactable* Reactor::Register(
+    int fd, Closure on_read_ready, Closure on_write_ready, Priority priority, Trigger trigger) {
+  auto* reactable = new Reactable(fd, on_read_ready, on_write_ready, priority, trigger);
   epoll_event event = {
-      .events = poll_event_type,
-      .data = {.ptr = reactable},
+      .events = reactable->poll_event_type(),
+      .data = {.ptr = reactable->tagged_ptr()},
   };
   int register_fd;
   RUN_NO_INTR(register_fd = epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event));
@@ -291,22 +334,16 @@ bool Reactor::WaitForIdle(std::chrono::milliseconds timeout) {
 void Reactor::ModifyRegistration(Reactor::Reactable* reactable, Closure on_read_ready, Closure on_write_ready) {
   ASSERT(reactable != nullptr);
 
-  uint32_t poll_event_type = 0;
-  if (!on_read_ready.is_null()) {
-    poll_event_type |= (EPOLLIN | EPOLLRDHUP);
-  }
-  if (!on_write_ready.is_null()) {
-    poll_event_type |= EPOLLOUT;
-  }
+  epoll_event event;
   {
     std::lock_guard<std::mutex> reactable_lock(reactable->mutex_);
     reactable->on_read_ready_ = std::move(on_read_ready);
     reactable->on_write_ready_ = std::move(on_write_ready);
+    event = {
+        .events = reactable->poll_event_type(),
+        .data = {.ptr = reactable->tagged_ptr()},
+    };
   }
-  epoll_event event = {
-      .events = poll_event_type,
-      .data = {.ptr = reactable},
-  };
   int modify_fd;
   RUN_NO_INTR(modify_fd = epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, reactable->fd_, &event));
   ASSERT(modify_fd != -1);
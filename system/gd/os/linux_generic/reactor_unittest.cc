@@ -18,9 +18,11 @@
 
 #include <sys/eventfd.h>
 
+#include <atomic>
 #include <chrono>
 #include <future>
 #include <thread>
+#include <vector>
 
 #include "common/bind.h"
 #include "common/callback.h"
@@ -165,6 +167,60 @@ class FakeRunningReactable {
   std::promise<void> finished;
 };
 
+class OrderRecordingReactable {
+ public:
+  OrderRecordingReactable(std::vector<int>* order, int id, size_t expected)
+      : fd_(eventfd(0, EFD_NONBLOCK)), order_(order), id_(id), expected_(expected) {
+    EXPECT_NE(fd_, -1);
+  }
+
+  ~OrderRecordingReactable() {
+    close(fd_);
+  }
+
+  void OnReadReady() {
+    uint64_t value = 0;
+    auto read_result = eventfd_read(fd_, &value);
+    EXPECT_EQ(read_result, 0);
+    order_->push_back(id_);
+    if (order_->size() == expected_) {
+      g_promise->set_value(kReadReadyValue);
+    }
+  }
+
+  int fd_;
+
+ private:
+  std::vector<int>* order_;
+  int id_;
+  size_t expected_;
+};
+
+class EdgeCountingReactable {
+ public:
+  EdgeCountingReactable() : fd_(eventfd(0, EFD_NONBLOCK)) {
+    EXPECT_NE(fd_, -1);
+  }
+
+  ~EdgeCountingReactable() {
+    close(fd_);
+  }
+
+  // Deliberately leaves the fd readable, so a level-triggered registration would be invoked again right away
+  void OnReadReady() {
+    if (++count_ == 1) {
+      first_.set_value();
+    } else if (count_ == 2) {
+      second_.set_value();
+    }
+  }
+
+  int fd_;
+  std::atomic_int count_{0};
+  std::promise<void> first_;
+  std::promise<void> second_;
+};
+
 TEST_F(ReactorTest, start_and_stop) {
   auto reactor_thread = std::thread(&Reactor::Run, reactor_);
   reactor_->Stop();
@@ -432,6 +488,65 @@ TEST_F(ReactorTest, modify_registration) {
   reactor_->Unregister(reactable);
 }
 
+TEST_F(ReactorTest, higher_priority_reactables_run_first) {
+  std::vector<int> order;
+  OrderRecordingReactable low(&order, 2, 3);
+  OrderRecordingReactable normal(&order, 1, 3);
+  OrderRecordingReactable high(&order, 0, 3);
+  auto* low_reactable = reactor_->Register(
+      low.fd_,
+      Bind(&OrderRecordingReactable::OnReadReady, common::Unretained(&low)),
+      common::Closure(),
+      Reactor::Priority::LOW,
+      Reactor::Trigger::LEVEL);
+  auto* normal_reactable = reactor_->Register(
+      normal.fd_, Bind(&OrderRecordingReactable::OnReadReady, common::Unretained(&normal)), common::Closure());
+  auto* high_reactable = reactor_->Register(
+      high.fd_,
+      Bind(&OrderRecordingReactable::OnReadReady, common::Unretained(&high)),
+      common::Closure(),
+      Reactor::Priority::HIGH,
+      Reactor::Trigger::LEVEL);
+
+  // Make all of them ready before the reactor polls, so they are reported together
+  for (int fd : {low.fd_, normal.fd_, high.fd_}) {
+    EXPECT_EQ(eventfd_write(fd, 1), 0);
+  }
+  auto future = g_promise->get_future();
+  auto reactor_thread = std::thread(&Reactor::Run, reactor_);
+  EXPECT_EQ(future.get(), kReadReadyValue);
+  reactor_->Stop();
+  reactor_thread.join();
+
+  EXPECT_EQ(order, std::vector<int>({0, 1, 2}));
+  reactor_->Unregister(low_reactable);
+  reactor_->Unregister(normal_reactable);
+  reactor_->Unregister(high_reactable);
+}
+
+TEST_F(ReactorTest, edge_triggered_reactable_runs_once_per_edge) {
+  EdgeCountingReactable edge;
+  auto* reactable = reactor_->Register(
+      edge.fd_,
+      Bind(&EdgeCountingReactable::OnReadReady, common::Unretained(&edge)),
+      common::Closure(),
+      Reactor::Priority::NORMAL,
+      Reactor::Trigger::EDGE);
+  auto reactor_thread = std::thread(&Reactor::Run, reactor_);
+
+  EXPECT_EQ(eventfd_write(edge.fd_, 1), 0);
+  edge.first_.get_future().wait();
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(edge.count_, 1);
+
+  EXPECT_EQ(eventfd_write(edge.fd_, 1), 0);
+  edge.second_.get_future().wait();
+
+  reactor_->Stop();
+  reactor_thread.join();
+  reactor_->Unregister(reactable);
+}
+
 }  // namespace
 }  // namespace os
 }  // namespace bluetooth
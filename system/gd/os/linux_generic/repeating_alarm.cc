@@ -19,11 +19,13 @@
 #include <sys/timerfd.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cstring>
 
 #include "common/bind.h"
 #include "os/linux_generic/linux.h"
 #include "os/log.h"
+#include "os/task_profiler.h"
 #include "os/utils.h"
 
 #ifdef OS_ANDROID
@@ -51,11 +53,33 @@ RepeatingAlarm::~RepeatingAlarm() {
   ASSERT(close_status != -1);
 }
 
-void RepeatingAlarm::Schedule(Closure task, std::chrono::milliseconds period) {
+namespace {
+
+// Largest power of two that is at most |slack_ms| and divides |period_ms|, so that expiries moved onto a multiple of
+// it stay there for every period
+uint64_t get_alignment_ms(uint64_t period_ms, uint64_t slack_ms) {
+  if (period_ms == 0 || slack_ms == 0) {
+    return 1;
+  }
+  uint64_t slack_alignment_ms = uint64_t{1} << (63 - __builtin_clzll(slack_ms));
+  uint64_t period_alignment_ms = period_ms & -period_ms;
+  return std::min(slack_alignment_ms, period_alignment_ms);
+}
+
+}  // namespace
+
+void RepeatingAlarm::Schedule(Closure task, std::chrono::milliseconds period, std::chrono::milliseconds slack) {
   std::lock_guard<std::mutex> lock(mutex_);
   long period_ms = period.count();
+  long delay_ms = period_ms;
+  uint64_t alignment_ms = get_alignment_ms(period_ms, slack.count());
+  if (alignment_ms > 1) {
+    uint64_t now_ms = TIMERFD_GET_CLOCK_MS();
+    uint64_t expiry_ms = (now_ms + period_ms + alignment_ms - 1) & ~(alignment_ms - 1);
+    delay_ms = static_cast<long>(expiry_ms - now_ms);
+  }
   itimerspec timer_itimerspec{{period_ms / 1000, period_ms % 1000 * 1000000},
-                              {period_ms / 1000, period_ms % 1000 * 1000000}};
+                              {delay_ms / 1000, delay_ms % 1000 * 1000000}};
   int result = TIMERFD_SETTIME(fd_, 0, &timer_itimerspec, nullptr);
   ASSERT(result == 0);
 
@@ -75,7 +99,10 @@ void RepeatingAlarm::on_fire() {
   uint64_t times_invoked;
   auto bytes_read = read(fd_, &times_invoked, sizeof(uint64_t));
   lock.unlock();
-  task.Run();
+  {
+    TaskProfilerScope profile(handler_);
+    task.Run();
+  }
   ASSERT(bytes_read == static_cast<ssize_t>(sizeof(uint64_t)));
 }
 
@@ -16,6 +16,7 @@
 
 #include "os/repeating_alarm.h"
 
+#include <atomic>
 #include <future>
 
 #include "common/bind.h"
@@ -83,6 +84,16 @@ class RepeatingAlarmTest : public ::testing::Test {
     handler_->Post(common::BindOnce(fake_timerfd_advance, ms));
   }
 
+  // Wait until everything posted to, or woken up on, the handler thread so far has run
+  void sync_handler() {
+    for (int i = 0; i < 2; i++) {
+      std::promise<void> promise;
+      auto future = promise.get_future();
+      handler_->Post(common::BindOnce(&std::promise<void>::set_value, common::Unretained(&promise)));
+      future.get();
+    }
+  }
+
   RepeatingAlarm* alarm_;
 
   common::Closure should_not_happen_ = common::Bind([] { ASSERT_TRUE(false); });
@@ -131,6 +142,27 @@ TEST_F(RepeatingAlarmTest, schedule_while_alarm_armed) {
   alarm_->Cancel();
 }
 
+TEST_F(RepeatingAlarmTest, schedule_with_slack_aligns_expiries) {
+  std::atomic_int counter{0};
+  fake_timer_advance(5);
+  sync_handler();
+  // Due at 133ms, moved onto the next multiple of 64ms
+  alarm_->Schedule(
+      common::Bind([](std::atomic_int* counter) { (*counter)++; }, common::Unretained(&counter)),
+      std::chrono::milliseconds(128),
+      std::chrono::milliseconds(64));
+  fake_timer_advance(186);
+  sync_handler();
+  ASSERT_EQ(counter, 0);
+  fake_timer_advance(1);
+  sync_handler();
+  ASSERT_EQ(counter, 1);
+  fake_timer_advance(128);
+  sync_handler();
+  ASSERT_EQ(counter, 2);
+  alarm_->Cancel();
+}
+
 TEST_F(RepeatingAlarmTest, delete_while_alarm_armed) {
   alarm_->Schedule(should_not_happen_, std::chrono::milliseconds(1));
   delete alarm_;
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "os/task_profiler.h"
+
+#include <time.h>
+
+#include <mutex>
+#include <unordered_map>
+
+namespace bluetooth {
+namespace os {
+
+namespace {
+
+std::mutex profiler_mutex;
+// Name of each handler, and the stats of each name, guarded by profiler_mutex
+std::unordered_map<const Handler*, std::string> handler_names;
+std::map<std::string, TaskProfiler::Stats> stats_by_name;
+
+}  // namespace
+
+std::atomic<bool> TaskProfiler::enabled_{false};
+thread_local uint64_t TaskProfiler::thread_allocations_ = 0;
+
+void TaskProfiler::SetEnabled(bool enabled) {
+  enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+void TaskProfiler::SetName(const Handler* handler, const std::string& name) {
+  std::lock_guard<std::mutex> lock(profiler_mutex);
+  handler_names[handler] = name;
+}
+
+void TaskProfiler::Forget(const Handler* handler) {
+  std::lock_guard<std::mutex> lock(profiler_mutex);
+  handler_names.erase(handler);
+}
+
+std::map<std::string, TaskProfiler::Stats> TaskProfiler::GetStats() {
+  std::lock_guard<std::mutex> lock(profiler_mutex);
+  return stats_by_name;
+}
+
+void TaskProfiler::Clear() {
+  std::lock_guard<std::mutex> lock(profiler_mutex);
+  stats_by_name.clear();
+}
+
+uint64_t TaskProfiler::ThreadCpuNs() {
+  timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+void TaskProfiler::Account(const Handler* handler, uint64_t cpu_ns, uint64_t allocations) {
+  std::lock_guard<std::mutex> lock(profiler_mutex);
+  static const std::string* unnamed = new std::string(kUnnamed);
+  auto name = handler_names.find(handler);
+  // Only the first task of a name allocates
+  const std::string& key = name != handler_names.end() ? name->second : *unnamed;
+  auto it = stats_by_name.find(key);
+  if (it == stats_by_name.end()) {
+    it = stats_by_name.emplace(key, Stats{}).first;
+  }
+  it->second.tasks++;
+  it->second.cpu_ns += cpu_ns;
+  it->second.allocations += allocations;
+}
+
+}  // namespace os
+}  // namespace bluetooth
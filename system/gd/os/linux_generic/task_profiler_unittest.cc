@@ -0,0 +1,109 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "os/task_profiler.h"
+
+#include <future>
+
+#include "common/bind.h"
+#include "gtest/gtest.h"
+#include "os/handler.h"
+#include "os/thread.h"
+
+namespace bluetooth {
+namespace os {
+namespace {
+
+class TaskProfilerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    TaskProfiler::Clear();
+    TaskProfiler::SetEnabled(true);
+    thread_ = new Thread("test_thread", Thread::Priority::NORMAL);
+    handler_ = new Handler(thread_);
+  }
+
+  void TearDown() override {
+    handler_->Clear();
+    delete handler_;
+    delete thread_;
+    TaskProfiler::SetEnabled(false);
+    TaskProfiler::Clear();
+  }
+
+  // Run a task counting |allocations| allocations on the handler, and wait for it to be accounted
+  void RunTask(int allocations) {
+    std::promise<void> done;
+    auto future = done.get_future();
+    handler_->Post(common::BindOnce(
+        [](int allocations) {
+          for (int i = 0; i < allocations; i++) {
+            TaskProfiler::CountAllocation();
+          }
+        },
+        allocations));
+    handler_->Post(common::BindOnce(&std::promise<void>::set_value, common::Unretained(&done)));
+    future.wait();
+  }
+
+  Thread* thread_;
+  Handler* handler_;
+};
+
+TEST_F(TaskProfilerTest, disabled_accounts_nothing) {
+  TaskProfiler::SetEnabled(false);
+  RunTask(3);
+  EXPECT_TRUE(TaskProfiler::GetStats().empty());
+}
+
+TEST_F(TaskProfilerTest, tasks_of_named_handler) {
+  TaskProfiler::SetName(handler_, "TestModule");
+  RunTask(3);
+  RunTask(4);
+  // Let the last task be accounted, it is only done once the closure returns
+  RunTask(0);
+
+  auto stats = TaskProfiler::GetStats();
+  ASSERT_EQ(stats.count("TestModule"), 1u);
+  EXPECT_EQ(stats["TestModule"].allocations, 7u);
+  EXPECT_GE(stats["TestModule"].tasks, 5u);
+  EXPECT_EQ(stats.count(TaskProfiler::kUnnamed), 0u);
+}
+
+TEST_F(TaskProfilerTest, forgotten_handler_is_unnamed) {
+  TaskProfiler::SetName(handler_, "TestModule");
+  TaskProfiler::Forget(handler_);
+  RunTask(2);
+  RunTask(0);
+
+  auto stats = TaskProfiler::GetStats();
+  EXPECT_EQ(stats.count("TestModule"), 0u);
+  ASSERT_EQ(stats.count(TaskProfiler::kUnnamed), 1u);
+  EXPECT_EQ(stats[TaskProfiler::kUnnamed].allocations, 2u);
+}
+
+TEST_F(TaskProfilerTest, thread_cpu_time_increases) {
+  uint64_t begin_ns = TaskProfiler::ThreadCpuNs();
+  volatile uint64_t sum = 0;
+  for (int i = 0; i < 1000000; i++) {
+    sum = sum + i;
+  }
+  EXPECT_GT(TaskProfiler::ThreadCpuNs(), begin_ns);
+}
+
+}  // namespace
+}  // namespace os
+}  // namespace bluetooth
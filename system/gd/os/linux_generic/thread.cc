@@ -24,6 +24,7 @@
 #include <cstring>
 
 #include "os/log.h"
+#include "os/trace.h"
 
 namespace bluetooth {
 namespace os {
@@ -36,6 +37,7 @@ Thread::Thread(const std::string& name, const Priority priority)
     : name_(name), reactor_(), running_thread_(&Thread::run, this, priority) {}
 
 void Thread::run(Priority priority) {
+  Trace::SetThreadName(name_);
   if (priority == Priority::REAL_TIME) {
     struct sched_param rt_params = {.sched_priority = kRealTimeFifoSchedulingPriority};
     auto linux_tid = static_cast<pid_t>(syscall(SYS_gettid));
@@ -0,0 +1,290 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "os/trace.h"
+
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+#include "os/log.h"
+#include "os/system_properties.h"
+#include "os/utils.h"
+
+namespace bluetooth {
+namespace os {
+
+namespace {
+
+constexpr char kSamplePeriodProperty[] = "persist.bluetooth.trace.sample_period";
+// Buffers kept for the threads that exited, beyond which the oldest ones are dropped
+constexpr size_t kMaxExitedThreadBuffers = 16;
+
+struct TraceEvent {
+  std::atomic<const char*> name{nullptr};
+  std::atomic<uint64_t> begin_ns{0};
+  std::atomic<uint64_t> end_ns{0};
+  std::atomic<int64_t> arg{Trace::kNoArg};
+  std::atomic<bool> async{false};
+};
+
+// Written by its thread only. An event is reserved before being written then published, so that readers can tell the
+// events that may have been overwritten while they were read
+struct ThreadBuffer {
+  const pid_t tid = static_cast<pid_t>(syscall(SYS_gettid));
+  // Guarded by the registry lock
+  std::string name = std::to_string(tid);
+  std::atomic<uint64_t> reserved{0};
+  std::atomic<uint64_t> published{0};
+  // Events before are dropped
+  std::atomic<uint64_t> cleared{0};
+  std::array<TraceEvent, Trace::kBufferSize> events;
+};
+
+struct EventCopy {
+  const char* name;
+  uint64_t begin_ns;
+  uint64_t end_ns;
+  int64_t arg;
+  bool async;
+};
+
+std::mutex registry_mutex;
+std::vector<std::shared_ptr<ThreadBuffer>> registry;
+
+// The buffer of a thread is only allocated once it records an event
+thread_local std::shared_ptr<ThreadBuffer> thread_buffer;
+thread_local std::string thread_name;
+
+ThreadBuffer* GetThreadBuffer() {
+  std::shared_ptr<ThreadBuffer>& buffer = thread_buffer;
+  if (buffer == nullptr) {
+    buffer = std::make_shared<ThreadBuffer>();
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    if (!thread_name.empty()) {
+      buffer->name = thread_name;
+    }
+    size_t exited = std::count_if(registry.begin(), registry.end(), [](const std::shared_ptr<ThreadBuffer>& buffer) {
+      return buffer.use_count() == 1;
+    });
+    for (auto it = registry.begin(); it != registry.end() && exited > kMaxExitedThreadBuffers;) {
+      if (it->use_count() == 1) {
+        it = registry.erase(it);
+        exited--;
+      } else {
+        it++;
+      }
+    }
+    registry.push_back(buffer);
+  }
+  return buffer.get();
+}
+
+// Copy the events of |buffer| that were not overwritten while being read, oldest first
+std::vector<EventCopy> CopyEvents(const ThreadBuffer& buffer) {
+  uint64_t published = buffer.published.load(std::memory_order_acquire);
+  uint64_t begin = published > Trace::kBufferSize ? published - Trace::kBufferSize : 0;
+  begin = std::min(std::max(begin, buffer.cleared.load(std::memory_order_relaxed)), published);
+  std::vector<EventCopy> events;
+  events.reserve(published - begin);
+  for (uint64_t i = begin; i < published; i++) {
+    const TraceEvent& event = buffer.events[i % Trace::kBufferSize];
+    events.push_back(EventCopy{
+        event.name.load(std::memory_order_relaxed),
+        event.begin_ns.load(std::memory_order_relaxed),
+        event.end_ns.load(std::memory_order_relaxed),
+        event.arg.load(std::memory_order_relaxed),
+        event.async.load(std::memory_order_relaxed)});
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+  // The writer may be overwriting any event before reserved - kBufferSize
+  uint64_t reserved = buffer.reserved.load(std::memory_order_relaxed);
+  uint64_t valid = reserved > Trace::kBufferSize ? reserved - Trace::kBufferSize : 0;
+  if (valid > begin) {
+    events.erase(events.begin(), events.begin() + std::min<uint64_t>(valid - begin, events.size()));
+  }
+  return events;
+}
+
+std::string EventName(const EventCopy& event) {
+  if (event.arg == Trace::kNoArg) {
+    return event.name;
+  }
+  return std::string(event.name) + " " + std::to_string(event.arg);
+}
+
+void AppendLine(
+    std::string* output, const std::string& task, pid_t tid, uint64_t timestamp_ns, const std::string& message) {
+  char buf[64];
+  snprintf(
+      buf,
+      sizeof(buf),
+      " [000] .... %" PRIu64 ".%06" PRIu64 ": tracing_mark_write: ",
+      timestamp_ns / 1000000000,
+      (timestamp_ns % 1000000000) / 1000);
+  output->append(task + "-" + std::to_string(tid) + buf + message + "\n");
+}
+
+}  // namespace
+
+std::atomic<uint32_t> Trace::sample_period_{0};
+
+void Trace::SetSamplePeriod(uint32_t sample_period) {
+  sample_period_.store(sample_period, std::memory_order_relaxed);
+}
+
+void Trace::SetSamplePeriodFromSystemProperty() {
+  auto value = GetSystemProperty(kSamplePeriodProperty);
+  if (!value) {
+    return;
+  }
+  char* end = nullptr;
+  unsigned long sample_period = std::strtoul(value->c_str(), &end, 10);
+  if (value->empty() || *end != '\0' || sample_period > UINT32_MAX) {
+    LOG_WARN("Invalid %s:%s", kSamplePeriodProperty, value->c_str());
+    return;
+  }
+  LOG_INFO("Tracing one in %lu events", sample_period);
+  SetSamplePeriod(static_cast<uint32_t>(sample_period));
+}
+
+uint64_t Trace::Now() {
+  struct timespec ts = {};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+void Trace::SetThreadName(const std::string& name) {
+  thread_name = name;
+  std::replace(thread_name.begin(), thread_name.end(), ' ', '_');
+  if (thread_buffer != nullptr) {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    thread_buffer->name = thread_name;
+  }
+}
+
+bool Trace::Sample() {
+  thread_local uint32_t count = 0;
+  if (++count < sample_period_.load(std::memory_order_relaxed)) {
+    return false;
+  }
+  count = 0;
+  return true;
+}
+
+void Trace::Record(const char* name, uint64_t begin_ns, uint64_t end_ns, int64_t arg) {
+  RecordEvent(name, begin_ns, end_ns, arg, false);
+}
+
+void Trace::RecordAsync(const char* name, uint64_t begin_ns, uint64_t end_ns, int64_t cookie) {
+  RecordEvent(name, begin_ns, end_ns, cookie, true);
+}
+
+void Trace::RecordEvent(const char* name, uint64_t begin_ns, uint64_t end_ns, int64_t arg, bool async) {
+  ThreadBuffer* buffer = GetThreadBuffer();
+  uint64_t index = buffer->reserved.load(std::memory_order_relaxed);
+  buffer->reserved.store(index + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  TraceEvent& event = buffer->events[index % kBufferSize];
+  event.name.store(name, std::memory_order_relaxed);
+  event.begin_ns.store(begin_ns, std::memory_order_relaxed);
+  event.end_ns.store(end_ns, std::memory_order_relaxed);
+  event.arg.store(arg, std::memory_order_relaxed);
+  event.async.store(async, std::memory_order_relaxed);
+  buffer->published.store(index + 1, std::memory_order_release);
+}
+
+std::string Trace::ToFtrace() {
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  std::vector<std::string> names;
+  {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    buffers = registry;
+    for (const auto& buffer : buffers) {
+      names.push_back(buffer->name);
+    }
+  }
+
+  const pid_t pid = getpid();
+  std::string output = "# tracer: nop\n#\n";
+  for (size_t i = 0; i < buffers.size(); i++) {
+    // Begin and end markers must be nested: at the same time, the events end before others begin, the longest events
+    // begin first and end last
+    std::vector<std::tuple<uint64_t, bool, uint64_t, const EventCopy*>> markers;
+    auto events = CopyEvents(*buffers[i]);
+    for (const auto& event : events) {
+      // Ending strictly after beginning
+      uint64_t duration = std::max<uint64_t>(event.end_ns - event.begin_ns, 1);
+      markers.emplace_back(event.begin_ns, true, UINT64_MAX - duration, &event);
+      markers.emplace_back(event.begin_ns + duration, false, duration, &event);
+    }
+    std::sort(markers.begin(), markers.end());
+    for (const auto& marker : markers) {
+      const EventCopy* event = std::get<3>(marker);
+      bool begin = std::get<1>(marker);
+      std::string message;
+      if (event->async) {
+        message = std::string(begin ? "S|" : "F|") + std::to_string(pid) + "|" + event->name + "|" +
+                  std::to_string(event->arg);
+      } else {
+        message = begin ? "B|" + std::to_string(pid) + "|" + EventName(*event) : "E|" + std::to_string(pid);
+      }
+      AppendLine(&output, names[i], buffers[i]->tid, std::get<0>(marker), message);
+    }
+  }
+  return output;
+}
+
+void Trace::WriteFtrace(int fd) {
+  std::string output = ToFtrace();
+  size_t written = 0;
+  while (written < output.size()) {
+    ssize_t result;
+    RUN_NO_INTR(result = write(fd, output.data() + written, output.size() - written));
+    if (result <= 0) {
+      LOG_WARN("Unable to write the trace: %s", strerror(errno));
+      return;
+    }
+    written += result;
+  }
+}
+
+void Trace::Clear() {
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  registry.erase(
+      std::remove_if(
+          registry.begin(),
+          registry.end(),
+          [](const std::shared_ptr<ThreadBuffer>& buffer) { return buffer.use_count() == 1; }),
+      registry.end());
+  for (const auto& buffer : registry) {
+    buffer->cleared.store(buffer->published.load(std::memory_order_acquire), std::memory_order_relaxed);
+  }
+}
+
+}  // namespace os
+}  // namespace bluetooth
@@ -0,0 +1,184 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "os/trace.h"
+
+#include <unistd.h>
+
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace bluetooth {
+namespace os {
+namespace {
+
+std::vector<std::string> TraceLines() {
+  std::vector<std::string> lines;
+  std::istringstream stream(Trace::ToFtrace());
+  std::string line;
+  while (std::getline(stream, line)) {
+    if (!line.empty() && line[0] != '#') {
+      lines.push_back(line);
+    }
+  }
+  return lines;
+}
+
+size_t CountLines(const std::vector<std::string>& lines, const std::string& text) {
+  size_t count = 0;
+  for (const auto& line : lines) {
+    if (line.find(text) != std::string::npos) {
+      count++;
+    }
+  }
+  return count;
+}
+
+bool EndsWith(const std::string& line, const std::string& suffix) {
+  return line.size() >= suffix.size() && line.compare(line.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+class TraceTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    Trace::Clear();
+    Trace::SetSamplePeriod(1);
+  }
+
+  void TearDown() override {
+    Trace::SetSamplePeriod(0);
+    Trace::Clear();
+  }
+};
+
+TEST_F(TraceTest, disabled_by_default_records_nothing) {
+  Trace::SetSamplePeriod(0);
+  EXPECT_FALSE(Trace::IsEnabled());
+  for (int i = 0; i < 10; i++) {
+    OS_TRACE_SCOPE("TraceTest::Disabled");
+  }
+  EXPECT_EQ(CountLines(TraceLines(), "TraceTest::Disabled"), 0u);
+}
+
+TEST_F(TraceTest, sample_period) {
+  Trace::SetSamplePeriod(4);
+  for (int i = 0; i < 40; i++) {
+    OS_TRACE_SCOPE("TraceTest::Sampled");
+  }
+  auto lines = TraceLines();
+  EXPECT_EQ(CountLines(lines, "B|" + std::to_string(getpid()) + "|TraceTest::Sampled"), 10u);
+  EXPECT_EQ(CountLines(lines, "E|"), 10u);
+}
+
+TEST_F(TraceTest, newest_events_are_kept) {
+  for (size_t i = 0; i < Trace::kBufferSize + 10; i++) {
+    Trace::Record("TraceTest::Event", 1000 * (i + 1), 1000 * (i + 1) + 10, static_cast<int64_t>(i));
+  }
+  auto lines = TraceLines();
+  EXPECT_EQ(CountLines(lines, "TraceTest::Event "), Trace::kBufferSize);
+  // The oldest events were overwritten
+  EXPECT_TRUE(EndsWith(lines.front(), "|TraceTest::Event 10")) << lines.front();
+  EXPECT_TRUE(EndsWith(lines[lines.size() - 2], "|TraceTest::Event " + std::to_string(Trace::kBufferSize + 9)));
+}
+
+TEST_F(TraceTest, nested_events) {
+  // The outer event is recorded last, when it ends
+  Trace::Record("Inner", 2000000, 3000000);
+  Trace::Record("Empty", 3000000, 3000000);
+  Trace::Record("Outer", 2000000, 5000000, 7);
+  auto lines = TraceLines();
+  ASSERT_EQ(lines.size(), 6u);
+  std::string pid = std::to_string(getpid());
+  EXPECT_NE(lines[0].find(" 0.002000: tracing_mark_write: B|" + pid + "|Outer 7"), std::string::npos) << lines[0];
+  EXPECT_NE(lines[1].find(" 0.002000: tracing_mark_write: B|" + pid + "|Inner"), std::string::npos) << lines[1];
+  EXPECT_NE(lines[2].find(" 0.003000: tracing_mark_write: E|" + pid), std::string::npos) << lines[2];
+  EXPECT_NE(lines[3].find(" 0.003000: tracing_mark_write: B|" + pid + "|Empty"), std::string::npos) << lines[3];
+  EXPECT_NE(lines[4].find(" 0.003000: tracing_mark_write: E|" + pid), std::string::npos) << lines[4];
+  EXPECT_NE(lines[5].find(" 0.005000: tracing_mark_write: E|" + pid), std::string::npos) << lines[5];
+}
+
+TEST_F(TraceTest, async_events) {
+  Trace::RecordAsync("Command", 2000000, 5000000, 3);
+  Trace::Record("Task", 3000000, 6000000);
+  auto lines = TraceLines();
+  ASSERT_EQ(lines.size(), 4u);
+  std::string pid = std::to_string(getpid());
+  EXPECT_NE(lines[0].find("S|" + pid + "|Command|3"), std::string::npos) << lines[0];
+  EXPECT_NE(lines[1].find("B|" + pid + "|Task"), std::string::npos) << lines[1];
+  EXPECT_NE(lines[2].find("F|" + pid + "|Command|3"), std::string::npos) << lines[2];
+  EXPECT_NE(lines[3].find("E|" + pid), std::string::npos) << lines[3];
+}
+
+TEST_F(TraceTest, thread_name) {
+  std::thread thread([]() {
+    Trace::SetThreadName("trace test");
+    Trace::Record("TraceTest::Named", 1000, 2000);
+  });
+  thread.join();
+  auto lines = TraceLines();
+  EXPECT_EQ(CountLines(lines, "trace_test-"), 2u);
+}
+
+TEST_F(TraceTest, clear) {
+  Trace::Record("TraceTest::Cleared", 1000, 2000);
+  Trace::Clear();
+  Trace::Record("TraceTest::Kept", 3000, 4000);
+  auto lines = TraceLines();
+  EXPECT_EQ(CountLines(lines, "TraceTest::Cleared"), 0u);
+  EXPECT_EQ(CountLines(lines, "TraceTest::Kept"), 1u);
+}
+
+TEST_F(TraceTest, concurrent_writers_and_reader) {
+  constexpr int kNumThreads = 4;
+  constexpr int kNumEvents = 10000;
+  std::atomic<bool> done = false;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; i++) {
+    threads.emplace_back([]() {
+      for (int j = 0; j < kNumEvents; j++) {
+        OS_TRACE_SCOPE_ARG("TraceTest::Concurrent", j);
+      }
+    });
+  }
+  std::thread reader([&done]() {
+    while (!done) {
+      auto lines = TraceLines();
+      // Each event has its begin and end markers
+      EXPECT_EQ(lines.size() % 2, 0u);
+    }
+  });
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  done = true;
+  reader.join();
+  auto lines = TraceLines();
+  EXPECT_EQ(CountLines(lines, "B|"), kNumThreads * Trace::kBufferSize);
+  size_t last_events = 0;
+  for (const auto& line : lines) {
+    last_events += EndsWith(line, "|TraceTest::Concurrent " + std::to_string(kNumEvents - 1));
+  }
+  EXPECT_EQ(last_events, static_cast<size_t>(kNumThreads));
+}
+
+}  // namespace
+}  // namespace os
+}  // namespace bluetooth
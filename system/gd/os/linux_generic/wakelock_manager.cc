@@ -21,10 +21,14 @@
 #include "os/wakelock_manager.h"
 
 #include <cerrno>
+#include <cstdlib>
 #include <mutex>
 
+#include "common/bind.h"
+#include "os/alarm.h"
 #include "os/internal/wakelock_native.h"
 #include "os/log.h"
+#include "os/system_properties.h"
 
 namespace bluetooth {
 namespace os {
@@ -43,6 +47,8 @@ uint64_t now_ms() {
 
 const std::string WakelockManager::kBtWakelockId = "bluetooth_gd_timer";
 
+constexpr char kReleaseTailProperty[] = "persist.bluetooth.wakelock.release_tail_ms";
+
 // Wakelock statistics for the "bluetooth_timer"
 struct WakelockManager::Stats {
   bool is_acquired = false;
@@ -59,6 +65,11 @@ struct WakelockManager::Stats {
   uint64_t last_reset_timestamp_ms = now_ms();
   StatusCode last_acquired_error = StatusCode::SUCCESS;
   StatusCode last_released_error = StatusCode::SUCCESS;
+  // Acquire() and Release() calls, the counts above are those that reached the OS
+  size_t acquire_calls = 0;
+  size_t release_calls = 0;
+  // Acquire() calls served by a wakelock still held in its release tail
+  size_t tail_reuses = 0;
 
   void Reset() {
     is_acquired = false;
@@ -75,6 +86,9 @@ struct WakelockManager::Stats {
     last_reset_timestamp_ms = now_ms();
     last_acquired_error = StatusCode::SUCCESS;
     last_released_error = StatusCode::SUCCESS;
+    acquire_calls = 0;
+    release_calls = 0;
+    tail_reuses = 0;
   }
 
   // Update the Bluetooth acquire wakelock statistics.
@@ -131,7 +145,7 @@ struct WakelockManager::Stats {
   }
 
   flatbuffers::Offset<WakelockManagerData> GetDumpsysData(
-      flatbuffers::FlatBufferBuilder* fb_builder, bool is_native) const {
+      flatbuffers::FlatBufferBuilder* fb_builder, bool is_native, std::chrono::milliseconds release_tail) const {
     const uint64_t just_now_ms = now_ms();
     // Compute the last acquired interval if the wakelock is still acquired
     uint64_t delta_ms = 0;
@@ -174,6 +188,10 @@ struct WakelockManager::Stats {
     builder.add_avg_interval_millis(avg_interval_ms);
     builder.add_total_interval_millis(total_interval_ms);
     builder.add_total_time_since_reset_millis(just_now_ms - last_reset_timestamp_ms);
+    builder.add_acquire_call_count(acquire_calls);
+    builder.add_release_call_count(release_calls);
+    builder.add_tail_reuse_count(tail_reuses);
+    builder.add_release_tail_millis(release_tail.count());
     return builder.Finish();
   }
 };
@@ -192,15 +210,101 @@ void WakelockManager::SetOsCallouts(OsCallouts* callouts, Handler* handler) {
   LOG_INFO("set to %s", is_native_ ? "native" : "non-native");
 }
 
-bool WakelockManager::Acquire() {
+void WakelockManager::SetReleaseTail(std::chrono::milliseconds tail, Handler* handler) {
+  // Destroyed once |mutex_| is unlocked, as the alarm may be waiting on it from the handler thread
+  std::unique_ptr<Alarm> previous_alarm;
   std::lock_guard<std::recursive_mutex> lock_guard(mutex_);
+  if (release_tail_.count() > 0 && ref_count_ == 0 && pstats_->is_acquired) {
+    // Only its tail was holding the wakelock
+    ReleaseWakelock();
+  }
+  previous_alarm = std::move(release_alarm_);
+  if (tail.count() > 0) {
+    ASSERT_LOG(handler != nullptr, "handler must not be null with a release tail");
+    if (release_tail_.count() == 0 && pstats_->is_acquired) {
+      LOG_WARN("Release tail set while the wakelock is held, counting it as one caller");
+      ref_count_ = 1;
+    }
+    release_alarm_ = std::make_unique<Alarm>(handler);
+  } else {
+    ref_count_ = 0;
+  }
+  tail_generation_++;
+  release_tail_ = tail;
+  LOG_INFO("release tail set to %lld ms", static_cast<long long>(tail.count()));
+}
+
+void WakelockManager::SetReleaseTailFromSystemProperty(Handler* handler) {
+  auto value = GetSystemProperty(kReleaseTailProperty);
+  if (!value) {
+    return;
+  }
+  char* end = nullptr;
+  unsigned long tail_ms = std::strtoul(value->c_str(), &end, 10);
+  if (value->empty() || *end != '\0' || tail_ms > INT32_MAX) {
+    LOG_WARN("Invalid %s:%s", kReleaseTailProperty, value->c_str());
+    return;
+  }
+  SetReleaseTail(std::chrono::milliseconds(tail_ms), handler);
+}
+
+void WakelockManager::Initialize() {
   if (!initialized_) {
     if (is_native_) {
       WakelockNative::Get().Initialize();
     }
     initialized_ = true;
   }
+}
+
+bool WakelockManager::Acquire() {
+  std::lock_guard<std::recursive_mutex> lock_guard(mutex_);
+  Initialize();
+  pstats_->acquire_calls++;
+
+  if (release_tail_.count() > 0) {
+    if (ref_count_++ > 0) {
+      return true;
+    }
+    if (pstats_->is_acquired) {
+      // Still held in its tail, the pending release is dropped
+      tail_generation_++;
+      pstats_->tail_reuses++;
+      return true;
+    }
+  }
+  return AcquireWakelock();
+}
+
+bool WakelockManager::Release() {
+  std::lock_guard<std::recursive_mutex> lock_guard(mutex_);
+  Initialize();
+  pstats_->release_calls++;
+
+  if (release_tail_.count() > 0) {
+    if (ref_count_ == 0) {
+      LOG_WARN("Release without a matching acquire, ignored");
+      return false;
+    }
+    if (--ref_count_ == 0) {
+      release_alarm_->Schedule(
+          common::BindOnce(&WakelockManager::OnReleaseTail, common::Unretained(this), ++tail_generation_),
+          release_tail_);
+    }
+    return true;
+  }
+  return ReleaseWakelock();
+}
 
+void WakelockManager::OnReleaseTail(uint64_t generation) {
+  std::lock_guard<std::recursive_mutex> lock_guard(mutex_);
+  if (generation != tail_generation_ || ref_count_ > 0 || !pstats_->is_acquired) {
+    return;
+  }
+  ReleaseWakelock();
+}
+
+bool WakelockManager::AcquireWakelock() {
   StatusCode status;
   if (is_native_) {
     status = WakelockNative::Get().Acquire(kBtWakelockId);
@@ -218,15 +322,7 @@ bool WakelockManager::Acquire() {
   return status == StatusCode ::SUCCESS;
 }
 
-bool WakelockManager::Release() {
-  std::lock_guard<std::recursive_mutex> lock_guard(mutex_);
-  if (!initialized_) {
-    if (is_native_) {
-      WakelockNative::Get().Initialize();
-    }
-    initialized_ = true;
-  }
-
+bool WakelockManager::ReleaseWakelock() {
   StatusCode status;
   if (is_native_) {
     status = WakelockNative::Get().Release(kBtWakelockId);
@@ -251,9 +347,14 @@ void WakelockManager::CleanUp() {
     return;
   }
   if (pstats_->is_acquired) {
-    LOG_ERROR("Releasing wake lock as part of cleanup");
-    Release();
+    // Expected when only the release tail holds it
+    if (release_tail_.count() == 0 || ref_count_ > 0) {
+      LOG_ERROR("Releasing wake lock as part of cleanup");
+    }
+    ReleaseWakelock();
   }
+  ref_count_ = 0;
+  tail_generation_++;
   if (is_native_) {
     WakelockNative::Get().CleanUp();
   }
@@ -263,7 +364,7 @@ void WakelockManager::CleanUp() {
 
 flatbuffers::Offset<WakelockManagerData> WakelockManager::GetDumpsysData(flatbuffers::FlatBufferBuilder* fb_builder) {
   std::lock_guard<std::recursive_mutex> lock_guard(mutex_);
-  return pstats_->GetDumpsysData(fb_builder, is_native_);
+  return pstats_->GetDumpsysData(fb_builder, is_native_, release_tail_);
 }
 
 WakelockManager::WakelockManager() : pstats_(std::make_unique<Stats>()) {}
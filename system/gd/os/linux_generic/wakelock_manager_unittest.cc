@@ -15,7 +15,9 @@
  *  limitations under the License.
  *
  ******************************************************************************/
+#include <chrono>
 #include <optional>
+#include <thread>
 #include <unordered_map>
 
 #include <gmock/gmock.h>
@@ -189,4 +191,76 @@ TEST_F(WakelockManagerTest, test_with_os_callouts_in_a_loop_and_dump) {
   }
 }
 
+TEST_F(WakelockManagerTest, test_release_tail_counts_callers_and_holds_the_wakelock) {
+  TestOsCallouts os_callouts;
+  WakelockManager::Get().SetOsCallouts(&os_callouts, handler_);
+  WakelockManager::Get().SetReleaseTail(std::chrono::milliseconds(100), handler_);
+
+  // Nested callers share one OS wakelock
+  ASSERT_TRUE(WakelockManager::Get().Acquire());
+  ASSERT_TRUE(WakelockManager::Get().Acquire());
+  ASSERT_TRUE(WakelockManager::Get().Release());
+  SyncHandler();
+  ASSERT_THAT(os_callouts.GetNetAcquiredCount(WakelockManager::kBtWakelockId), Optional(Eq(1)));
+
+  // Activity within the tail reuses the wakelock
+  ASSERT_TRUE(WakelockManager::Get().Release());
+  ASSERT_TRUE(WakelockManager::Get().Acquire());
+  ASSERT_TRUE(WakelockManager::Get().Release());
+  SyncHandler();
+  ASSERT_THAT(os_callouts.GetNetAcquiredCount(WakelockManager::kBtWakelockId), Optional(Eq(1)));
+
+  // Unbalanced releases are ignored
+  ASSERT_FALSE(WakelockManager::Get().Release());
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  SyncHandler();
+  ASSERT_THAT(os_callouts.GetNetAcquiredCount(WakelockManager::kBtWakelockId), Optional(Eq(0)));
+
+  {
+    flatbuffers::FlatBufferBuilder builder(1024);
+    auto offset = WakelockManager::Get().GetDumpsysData(&builder);
+    FinishWakelockManagerDataBuffer(builder, offset);
+    auto data = GetWakelockManagerData(builder.GetBufferPointer());
+
+    ASSERT_FALSE(data->is_acquired());
+    ASSERT_EQ(data->acquired_count(), 1);
+    ASSERT_EQ(data->released_count(), 1);
+    ASSERT_EQ(data->acquire_call_count(), 3);
+    ASSERT_EQ(data->release_call_count(), 4);
+    ASSERT_EQ(data->tail_reuse_count(), 1);
+    ASSERT_EQ(data->release_tail_millis(), 100);
+    ASSERT_GE(data->total_interval_millis(), 100);
+  }
+
+  WakelockManager::Get().CleanUp();
+  WakelockManager::Get().SetReleaseTail(std::chrono::milliseconds(0), nullptr);
+  SyncHandler();
+}
+
+TEST_F(WakelockManagerTest, test_clean_up_releases_wakelock_held_in_tail) {
+  TestOsCallouts os_callouts;
+  WakelockManager::Get().SetOsCallouts(&os_callouts, handler_);
+  WakelockManager::Get().SetReleaseTail(std::chrono::seconds(10), handler_);
+
+  WakelockManager::Get().Acquire();
+  WakelockManager::Get().Release();
+  SyncHandler();
+  ASSERT_THAT(os_callouts.GetNetAcquiredCount(WakelockManager::kBtWakelockId), Optional(Eq(1)));
+
+  WakelockManager::Get().CleanUp();
+  SyncHandler();
+  ASSERT_THAT(os_callouts.GetNetAcquiredCount(WakelockManager::kBtWakelockId), Optional(Eq(0)));
+
+  // Disabling the tail goes back to passing every call through
+  WakelockManager::Get().SetReleaseTail(std::chrono::milliseconds(0), nullptr);
+  WakelockManager::Get().Acquire();
+  WakelockManager::Get().Acquire();
+  SyncHandler();
+  ASSERT_THAT(os_callouts.GetNetAcquiredCount(WakelockManager::kBtWakelockId), Optional(Eq(2)));
+
+  WakelockManager::Get().CleanUp();
+  SyncHandler();
+}
+
 }  // namespace testing
@@ -26,6 +26,12 @@
 
 static_assert(LOG_TAG != nullptr, "LOG_TAG should never be NULL");
 
+#include "os/binary_log.h"
+
+// Record a debug log to be formatted only when dumped, see os/binary_log.h
+#define BINARY_LOG(fmt, args...) \
+  bluetooth::os::BinaryLog::Log(LOG_TAG, __FILE__, __LINE__, __func__, fmt, ##args)
+
 #if defined(OS_ANDROID)
 
 #include <log/log.h>
@@ -53,8 +59,9 @@ static_assert(LOG_TAG != nullptr, "LOG_TAG is null after header inclusion");
   do {                                                                        \
     if (bluetooth::common::InitFlags::IsDebugLoggingEnabledForTag(LOG_TAG)) { \
       ALOGD("%s:%d %s: " fmt, __FILE__, __LINE__, __func__, ##args);          \
-    }                                                                         \
-    else {                                                                    \
+    } else if (bluetooth::os::BinaryLog::IsEnabled()) {                       \
+      BINARY_LOG(fmt, ##args);                                                \
+    } else {                                                                  \
       ALOGD("DBG: " fmt, ##args);                                             \
     }                                                                         \
   } while (false)
@@ -104,6 +111,8 @@ static_assert(LOG_TAG != nullptr, "LOG_TAG is null after header inclusion");
   do {                                                                        \
     if (bluetooth::common::InitFlags::IsDebugLoggingEnabledForTag(LOG_TAG)) { \
       LOGWRAPPER(LOG_TAG_DEBUG, __VA_ARGS__);                                 \
+    } else if (bluetooth::os::BinaryLog::IsEnabled()) {                       \
+      BINARY_LOG(__VA_ARGS__);                                                \
     }                                                                         \
   } while (false)
 #define LOG_INFO(...) LOGWRAPPER(LOG_TAG_INFO, __VA_ARGS__)
@@ -180,6 +189,8 @@ static_assert(LOG_TAG != nullptr, "LOG_TAG is null after header inclusion");
   do {                                                                        \
     if (bluetooth::common::InitFlags::IsDebugLoggingEnabledForTag(LOG_TAG)) { \
       LOGWRAPPER(fmt, ##args);                                                \
+    } else if (bluetooth::os::BinaryLog::IsEnabled()) {                       \
+      BINARY_LOG(fmt, ##args);                                                \
     }                                                                         \
   } while (false)
 #define LOG_INFO(...) LOGWRAPPER(__VA_ARGS__)
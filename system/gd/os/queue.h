@@ -21,6 +21,7 @@
 #include <functional>
 #include <mutex>
 #include <queue>
+#include <vector>
 
 #include "common/bind.h"
 #include "common/callback.h"
@@ -29,6 +30,7 @@
 #include "os/linux_generic/reactive_semaphore.h"
 #endif
 #include "os/log.h"
+#include "os/task_profiler.h"
 
 namespace bluetooth {
 namespace os {
@@ -38,9 +40,21 @@ template <typename T>
 class IQueueEnqueue {
  public:
   using EnqueueCallback = common::Callback<std::unique_ptr<T>()>;
+  using BatchEnqueueCallback = common::Callback<std::vector<std::unique_ptr<T>>(size_t max_count)>;
   virtual ~IQueueEnqueue() = default;
   virtual void RegisterEnqueue(Handler* handler, EnqueueCallback callback) = 0;
+  // By default, the batch callback is asked for one piece of data at a time
+  virtual void RegisterBatchEnqueue(Handler* handler, BatchEnqueueCallback callback) {
+    RegisterEnqueue(handler, common::Bind(&IQueueEnqueue<T>::EnqueueOne, callback));
+  }
   virtual void UnregisterEnqueue() = 0;
+
+ private:
+  static std::unique_ptr<T> EnqueueOne(const BatchEnqueueCallback& callback) {
+    std::vector<std::unique_ptr<T>> data = callback.Run(1);
+    ASSERT(data.size() == 1);
+    return std::move(data.front());
+  }
 };
 
 // See documentation for |Queue|
@@ -52,6 +66,17 @@ class IQueueDequeue {
   virtual void RegisterDequeue(Handler* handler, DequeueCallback callback) = 0;
   virtual void UnregisterDequeue() = 0;
   virtual std::unique_ptr<T> TryDequeue() = 0;
+  virtual std::vector<std::unique_ptr<T>> TryDequeueBatch(size_t max_count) {
+    std::vector<std::unique_ptr<T>> data;
+    while (data.size() < max_count) {
+      std::unique_ptr<T> item = TryDequeue();
+      if (item == nullptr) {
+        break;
+      }
+      data.push_back(std::move(item));
+    }
+    return data;
+  }
 };
 
 template <typename T>
@@ -60,6 +85,9 @@ class Queue : public IQueueEnqueue<T>, public IQueueDequeue<T> {
   // A function moving data from enqueue end buffer to queue, it will be continually be invoked until queue
   // is full. Enqueue end should make sure buffer isn't empty and UnregisterEnqueue when buffer become empty.
   using EnqueueCallback = common::Callback<std::unique_ptr<T>()>;
+  // A function moving at most |max_count| pieces of data from enqueue end buffer to queue at once. It must return at
+  // least one piece of data, and is otherwise used like EnqueueCallback.
+  using BatchEnqueueCallback = common::Callback<std::vector<std::unique_ptr<T>>(size_t max_count)>;
   // A function moving data form queue to dequeue end buffer, it will be continually be invoked until queue
   // is empty. TryDequeue should be use in this function to get data from queue.
   using DequeueCallback = common::Callback<void()>;
@@ -69,7 +97,9 @@ class Queue : public IQueueEnqueue<T>, public IQueueDequeue<T> {
   // Register |callback| that will be called on |handler| when the queue is able to enqueue one piece of data.
   // This will cause a crash if handler or callback has already been registered before.
   void RegisterEnqueue(Handler* handler, EnqueueCallback callback) override;
-  // Unregister current EnqueueCallback from this queue, this will cause a crash if not registered yet.
+  // Same as RegisterEnqueue, but |callback| fills all the room left in the queue each time it is called.
+  void RegisterBatchEnqueue(Handler* handler, BatchEnqueueCallback callback) override;
+  // Unregister current EnqueueCallback or BatchEnqueueCallback from this queue, this will cause a crash if not registered yet.
   void UnregisterEnqueue() override;
   // Register |callback| that will be called on |handler| when the queue has at least one piece of data ready
   // for dequeue. This will cause a crash if handler or callback has already been registered before.
@@ -79,9 +109,19 @@ class Queue : public IQueueEnqueue<T>, public IQueueDequeue<T> {
 
   // Try to dequeue an item from this queue. Return nullptr when there is nothing in the queue.
   std::unique_ptr<T> TryDequeue() override;
+  // Try to dequeue up to |max_count| items from this queue, taking the lock once. Return an empty vector when there is
+  // nothing in the queue.
+  std::vector<std::unique_ptr<T>> TryDequeueBatch(size_t max_count) override;
 
  private:
-  void EnqueueCallbackInternal(EnqueueCallback callback);
+  // The callbacks run on the reactor of |handler|, they are accounted as its tasks
+  void EnqueueCallbackInternal(const Handler* handler, EnqueueCallback callback);
+  void BatchEnqueueCallbackInternal(const Handler* handler, BatchEnqueueCallback callback);
+  void DequeueCallbackInternal(const Handler* handler, DequeueCallback callback);
+  // Must be called with |mutex_| held
+  void Push(std::unique_ptr<T> data);
+  std::unique_ptr<T> Pop();
+  const size_t capacity_;
   // An internal queue that holds at most |capacity| pieces of data
   std::queue<std::unique_ptr<T>> queue_;
   // A mutex that guards data in this queue
@@ -92,6 +132,8 @@ class Queue : public IQueueEnqueue<T>, public IQueueDequeue<T> {
 #ifdef OS_LINUX_GENERIC
     explicit QueueEndpoint(unsigned int initial_value)
         : reactive_semaphore_(initial_value), handler_(nullptr), reactable_(nullptr) {}
+    // Set while the queue can be enqueued to (resp. dequeued from). It is only written when the queue stops or starts
+    // being full (resp. empty), not for every piece of data.
     ReactiveSemaphore reactive_semaphore_;
 #endif
     Handler* handler_;
@@ -117,7 +159,8 @@ class EnqueueBuffer {
     std::lock_guard<std::mutex> lock(mutex_);
     buffer_.push(std::move(t));
     if (!enqueue_registered_.exchange(true)) {
-      queue_->RegisterEnqueue(handler, common::Bind(&EnqueueBuffer<T>::enqueue_callback, common::Unretained(this)));
+      queue_->RegisterBatchEnqueue(
+          handler, common::Bind(&EnqueueBuffer<T>::enqueue_callback, common::Unretained(this)));
     }
   }
 
@@ -141,10 +184,13 @@ class EnqueueBuffer {
   }
 
  private:
-  std::unique_ptr<T> enqueue_callback() {
+  std::vector<std::unique_ptr<T>> enqueue_callback(size_t max_count) {
     std::lock_guard<std::mutex> lock(mutex_);
-    std::unique_ptr<T> enqueued_t = std::move(buffer_.front());
-    buffer_.pop();
+    std::vector<std::unique_ptr<T>> enqueued_t;
+    while (!buffer_.empty() && enqueued_t.size() < max_count) {
+      enqueued_t.push_back(std::move(buffer_.front()));
+      buffer_.pop();
+    }
     if (buffer_.empty() && enqueue_registered_.exchange(false)) {
       queue_->UnregisterEnqueue();
       if (!callback_on_empty_.is_null()) {
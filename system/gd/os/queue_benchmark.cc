@@ -137,6 +137,40 @@ class TestDequeueEnd {
   }
 };
 
+class TestBatchDequeueEnd {
+ public:
+  explicit TestBatchDequeueEnd(int64_t count, Queue<std::string>* queue, Handler* handler, std::promise<void>* promise)
+      : count_(count), handler_(handler), queue_(queue), promise_(promise) {}
+
+  void RegisterDequeue() {
+    handler_->Post(common::BindOnce(&TestBatchDequeueEnd::handle_register_dequeue, common::Unretained(this)));
+  }
+
+  void DequeueCallbackForTest() {
+    for (auto& data : queue_->TryDequeueBatch(count_)) {
+      buffer_.push(std::move(*data));
+      count_--;
+    }
+    if (count_ == 0) {
+      queue_->UnregisterDequeue();
+      promise_->set_value();
+    }
+  }
+
+  std::queue<std::string> buffer_;
+  int64_t count_;
+
+ private:
+  Handler* handler_;
+  Queue<std::string>* queue_;
+  std::promise<void>* promise_;
+
+  void handle_register_dequeue() {
+    queue_->RegisterDequeue(
+        handler_, common::Bind(&TestBatchDequeueEnd::DequeueCallbackForTest, common::Unretained(this)));
+  }
+};
+
 BENCHMARK_DEFINE_F(BM_QueuePerformance, send_packet_vary_by_packet_num)(State& state) {
   for (auto _ : state) {
     int64_t num_data_to_send_ = state.range(0);
@@ -202,5 +236,38 @@ BENCHMARK_REGISTER_F(BM_QueuePerformance, send_10000_packet_vary_by_packet_size)
     ->Iterations(100)
     ->UseRealTime();
 
+// The packets go through an EnqueueBuffer, which fills the queue in batches, and are drained in batches
+BENCHMARK_DEFINE_F(BM_QueuePerformance, send_packet_vary_by_packet_num_batched)(State& state) {
+  for (auto _ : state) {
+    int64_t num_data_to_send_ = state.range(0);
+    int64_t capacity = state.range(1);
+    Queue<std::string> queue(capacity);
+
+    // register dequeue
+    std::promise<void> dequeue_promise;
+    auto dequeue_future = dequeue_promise.get_future();
+    TestBatchDequeueEnd test_dequeue_end(num_data_to_send_, &queue, dequeue_handler_, &dequeue_promise);
+    test_dequeue_end.RegisterDequeue();
+
+    // Push data to enqueue buffer, which registers enqueue
+    EnqueueBuffer<std::string> enqueue_buffer(&queue);
+    for (int i = 0; i < num_data_to_send_; i++) {
+      enqueue_buffer.Enqueue(std::make_unique<std::string>(std::to_string(1)), enqueue_handler_);
+    }
+    dequeue_future.wait();
+  }
+
+  state.SetBytesProcessed(static_cast<int_fast64_t>(state.iterations()) * state.range(0));
+};
+
+BENCHMARK_REGISTER_F(BM_QueuePerformance, send_packet_vary_by_packet_num_batched)
+    ->Args({1000, 1})
+    ->Args({1000, 10})
+    ->Args({1000, 100})
+    ->Args({100000, 10})
+    ->Args({100000, 100})
+    ->Iterations(100)
+    ->UseRealTime();
+
 }  // namespace os
 }  // namespace bluetooth
@@ -57,10 +57,29 @@ class Reactor {
   // by Stop(). If the reactor is not running, it will be stopped once it's started.
   void Stop();
 
+  // Order in which reactables that became ready in the same poll are serviced. HIGH is meant for latency sensitive
+  // fds like HCI or audio, LOW for bulk work that can wait for everything else.
+  enum class Priority {
+    HIGH,
+    NORMAL,
+    LOW,
+  };
+
+  // How readiness is reported. A LEVEL reactable is invoked as long as its fd is ready. An EDGE reactable is only
+  // invoked when its fd becomes ready again, so its callbacks must drain the fd until it would block.
+  enum class Trigger {
+    LEVEL,
+    EDGE,
+  };
+
   // Register a reactable fd to this reactor. Returns a pointer to a Reactable. Caller must use this object to
   // unregister or modify registration. Ownership of the memory space is NOT transferred to user.
   Reactable* Register(int fd, common::Closure on_read_ready, common::Closure on_write_ready);
 
+  // Same as above, with a priority and trigger mode that are kept for the lifetime of the reactable
+  Reactable* Register(
+      int fd, common::Closure on_read_ready, common::Closure on_write_ready, Priority priority, Trigger trigger);
+
   // Unregister a reactable from this reactor
   void Unregister(Reactable* reactable);
 
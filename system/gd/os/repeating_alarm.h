@@ -42,8 +42,12 @@ class RepeatingAlarm {
   // Unregister this alarm from the thread and release resource
   ~RepeatingAlarm();
 
-  // Schedule a repeating alarm with given period
-  void Schedule(common::Closure task, std::chrono::milliseconds period);
+  // Schedule a repeating alarm with given period. With a non-zero |slack|, every expiry may be up to |slack| late: it
+  // is moved onto a boundary of the boot clock shared by alarms with similar slack, so they wake the thread together.
+  void Schedule(
+      common::Closure task,
+      std::chrono::milliseconds period,
+      std::chrono::milliseconds slack = std::chrono::milliseconds(0));
 
   // Cancel the alarm. No-op if it's not armed.
   void Cancel();
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace bluetooth {
+namespace os {
+
+class Handler;
+
+// Accounting of the CPU time and the allocations of the closures, alarms and queue callbacks run on behalf of each
+// handler, for the benchmarks and the HCI replay tool
+//
+// Profiling is disabled by default and then only costs a relaxed load per task. When enabled, each task reads the
+// thread CPU clock twice and takes a lock once. The handlers must be named while profiling is enabled, the module
+// handlers are named after their module; the tasks of the other handlers are accounted together.
+class TaskProfiler {
+ public:
+  struct Stats {
+    uint64_t tasks = 0;
+    uint64_t cpu_ns = 0;
+    uint64_t allocations = 0;
+  };
+
+  static constexpr char kUnnamed[] = "(unnamed)";
+
+  static void SetEnabled(bool enabled);
+  static bool IsEnabled() {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  // Account the tasks of |handler| as |name|, several handlers may share a name
+  static void SetName(const Handler* handler, const std::string& name);
+  // Called when |handler| goes away, so that a handler reusing its address is not accounted under its name
+  static void Forget(const Handler* handler);
+
+  // Stats of each name since the last Clear()
+  static std::map<std::string, Stats> GetStats();
+  static void Clear();
+
+  // Count one allocation of the task running on this thread. Meant for an allocation hook installed by the binary, e.g.
+  // a replacement of operator new, so it must not allocate itself.
+  static void CountAllocation() {
+    thread_allocations_++;
+  }
+  static uint64_t ThreadAllocations() {
+    return thread_allocations_;
+  }
+
+  // CPU time used by the calling thread, in nanoseconds
+  static uint64_t ThreadCpuNs();
+
+  // Account one task of |handler|
+  static void Account(const Handler* handler, uint64_t cpu_ns, uint64_t allocations);
+
+ private:
+  static std::atomic<bool> enabled_;
+  static thread_local uint64_t thread_allocations_;
+};
+
+// Accounts the scope as one task of |handler| when profiling is enabled
+class TaskProfilerScope {
+ public:
+  explicit TaskProfilerScope(const Handler* handler)
+      : handler_(TaskProfiler::IsEnabled() ? handler : nullptr),
+        begin_cpu_ns_(handler_ != nullptr ? TaskProfiler::ThreadCpuNs() : 0),
+        begin_allocations_(handler_ != nullptr ? TaskProfiler::ThreadAllocations() : 0) {}
+  TaskProfilerScope(const TaskProfilerScope&) = delete;
+  TaskProfilerScope& operator=(const TaskProfilerScope&) = delete;
+
+  ~TaskProfilerScope() {
+    if (handler_ != nullptr) {
+      TaskProfiler::Account(
+          handler_,
+          TaskProfiler::ThreadCpuNs() - begin_cpu_ns_,
+          TaskProfiler::ThreadAllocations() - begin_allocations_);
+    }
+  }
+
+ private:
+  const Handler* const handler_;
+  const uint64_t begin_cpu_ns_;
+  const uint64_t begin_allocations_;
+};
+
+}  // namespace os
+}  // namespace bluetooth
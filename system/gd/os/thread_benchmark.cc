@@ -17,6 +17,7 @@
 #include <future>
 #include <memory>
 #include <thread>
+#include <vector>
 
 #include "benchmark/benchmark.h"
 #include "common/bind.h"
@@ -115,3 +116,36 @@ BENCHMARK_REGISTER_F(BM_ReactorThread, sequential_execution)
     ->Arg(100000)
     ->Iterations(1)
     ->UseRealTime();
+
+BENCHMARK_DEFINE_F(BM_ReactorThread, contended_post)(State& state) {
+  for (auto _ : state) {
+    int num_producers = state.range(0);
+    num_messages_to_send_ = state.range(1);
+    int64_t messages_per_producer = num_messages_to_send_ / num_producers;
+    num_messages_to_send_ = messages_per_producer * num_producers;
+    counter_ = 0;
+    counter_promise_ = std::promise<void>();
+    std::future<void> counter_future = counter_promise_.get_future();
+    std::vector<std::thread> producers;
+    for (int p = 0; p < num_producers; p++) {
+      producers.emplace_back([this, messages_per_producer]() {
+        for (int64_t i = 0; i < messages_per_producer; i++) {
+          handler_->Post(BindOnce(
+              &BM_ReactorThread_contended_post_Benchmark::callback_batch, bluetooth::common::Unretained(this)));
+        }
+      });
+    }
+    for (auto& producer : producers) {
+      producer.join();
+    }
+    counter_future.wait();
+  }
+  state.SetItemsProcessed(state.iterations() * num_messages_to_send_);
+};
+
+BENCHMARK_REGISTER_F(BM_ReactorThread, contended_post)
+    ->Args({1, 100000})
+    ->Args({4, 100000})
+    ->Args({8, 100000})
+    ->Iterations(1)
+    ->UseRealTime();
@@ -0,0 +1,114 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace bluetooth {
+namespace os {
+
+// Low overhead tracing of the stack hot paths
+//
+// Each thread records its events in its own fixed size ring buffer without taking any lock, the oldest events being
+// overwritten. Tracing is disabled by default and then only costs a relaxed load per event. When enabled, one event in
+// every sample period of each thread is recorded. Defining OS_TRACE_DISABLED compiles the trace points out entirely.
+class Trace {
+ public:
+  // Number of events kept per thread
+  static constexpr size_t kBufferSize = 1024;
+  static constexpr int64_t kNoArg = INT64_MIN;
+
+  // Record one in |sample_period| events of each thread, 0 disables tracing
+  static void SetSamplePeriod(uint32_t sample_period);
+  // Read the sample period from the persist.bluetooth.trace.sample_period system property
+  static void SetSamplePeriodFromSystemProperty();
+  static bool IsEnabled() {
+#ifdef OS_TRACE_DISABLED
+    return false;
+#else
+    return sample_period_.load(std::memory_order_relaxed) != 0;
+#endif
+  }
+
+  // CLOCK_MONOTONIC time in nanoseconds, as used by ftrace
+  static uint64_t Now();
+
+  // Name of the calling thread in the trace, its tid by default
+  static void SetThreadName(const std::string& name);
+
+  // Whether the calling thread should record its next event
+  static bool Sample();
+
+  // Record an event of the calling thread from |begin_ns| to |end_ns|. |name| must be a string literal, |arg| is
+  // appended to it in the trace unless kNoArg
+  static void Record(const char* name, uint64_t begin_ns, uint64_t end_ns, int64_t arg = kNoArg);
+  // Same as Record() for an event that does not nest with the other events of the thread, e.g. a round trip spanning
+  // several tasks. |cookie| tells apart the overlapping events of the same name
+  static void RecordAsync(const char* name, uint64_t begin_ns, uint64_t end_ns, int64_t cookie);
+
+  // Write the recorded events of all threads to |fd| in the ftrace text format, which perfetto and systrace import
+  static void WriteFtrace(int fd);
+  static std::string ToFtrace();
+
+  // Drop the recorded events
+  static void Clear();
+
+ private:
+  static void RecordEvent(const char* name, uint64_t begin_ns, uint64_t end_ns, int64_t arg, bool async);
+
+  static std::atomic<uint32_t> sample_period_;
+};
+
+// Records the lifetime of the scope as an event when sampled
+class TraceScope {
+ public:
+  explicit TraceScope(const char* name, int64_t arg = Trace::kNoArg)
+      : name_(name), arg_(arg), begin_ns_(Trace::IsEnabled() && Trace::Sample() ? Trace::Now() : 0) {}
+  TraceScope(const TraceScope&) = delete;
+  TraceScope& operator=(const TraceScope&) = delete;
+
+  ~TraceScope() {
+    if (begin_ns_ != 0) {
+      Trace::Record(name_, begin_ns_, Trace::Now(), arg_);
+    }
+  }
+
+ private:
+  const char* name_;
+  const int64_t arg_;
+  const uint64_t begin_ns_;
+};
+
+}  // namespace os
+}  // namespace bluetooth
+
+#define OS_TRACE_CONCAT_INTERNAL(a, b) a##b
+#define OS_TRACE_CONCAT(a, b) OS_TRACE_CONCAT_INTERNAL(a, b)
+
+#ifdef OS_TRACE_DISABLED
+#define OS_TRACE_SCOPE(name) \
+  do {                       \
+  } while (false)
+#define OS_TRACE_SCOPE_ARG(name, arg) \
+  do {                                \
+  } while (false)
+#else
+#define OS_TRACE_SCOPE(name) ::bluetooth::os::TraceScope OS_TRACE_CONCAT(os_trace_scope_, __LINE__)(name)
+#define OS_TRACE_SCOPE_ARG(name, arg) \
+  ::bluetooth::os::TraceScope OS_TRACE_CONCAT(os_trace_scope_, __LINE__)(name, arg)
+#endif
@@ -18,6 +18,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <mutex>
 #include <string>
@@ -30,6 +31,8 @@
 namespace bluetooth {
 namespace os {
 
+class Alarm;
+
 class WakelockManager {
  public:
   static const std::string kBtWakelockId;
@@ -58,6 +61,16 @@ class WakelockManager {
   // This method must be called before calling Acquire() or Release()
   void SetOsCallouts(OsCallouts* callouts, Handler* handler);
 
+  // Keep the wakelock for |tail| after it is last released instead of releasing it right away, so that bursts of
+  // activity close together cost a single acquire and release. Acquire() and Release() are then reference counted
+  // across callers: the wakelock is acquired by the first Acquire() and released |tail| after the matching last
+  // Release(), on |handler|. A zero |tail| restores the default, where every call goes to the OS.
+  //
+  // |handler| must outlive this setting: disable the tail before destroying it.
+  void SetReleaseTail(std::chrono::milliseconds tail, Handler* handler);
+  // Read the tail from the persist.bluetooth.wakelock.release_tail_ms system property, nothing is changed when unset
+  void SetReleaseTailFromSystemProperty(Handler* handler);
+
   // Acquire the Bluetooth wakelock.
   // Return true on success, otherwise false.
   // The function is thread safe.
@@ -68,8 +81,8 @@ class WakelockManager {
   // The function is thread safe.
   bool Release();
 
-  // Cleanup the wakelock internal runtime state.
-  // This will NOT clean up the callouts
+  // Cleanup the wakelock internal runtime state, releasing the wakelock if it is held.
+  // This will NOT clean up the callouts nor the release tail
   void CleanUp();
 
   // Dump wakelock-related debug info to a flat buffer defined in wakelock_manager.fbs
@@ -80,11 +93,24 @@ class WakelockManager {
  private:
   WakelockManager();
 
+  void Initialize();
+  // Acquire and release the OS wakelock, |mutex_| must be held
+  bool AcquireWakelock();
+  bool ReleaseWakelock();
+  // Release the wakelock if nothing acquired it again since the tail was scheduled as |generation|
+  void OnReleaseTail(uint64_t generation);
+
   std::recursive_mutex mutex_;
   bool initialized_ = false;
   OsCallouts* os_callouts_ = nullptr;
   Handler* os_callouts_handler_ = nullptr;
   bool is_native_ = true;
+  std::chrono::milliseconds release_tail_{0};
+  std::unique_ptr<Alarm> release_alarm_;
+  // Callers holding the wakelock, only counted with a release tail
+  size_t ref_count_ = 0;
+  // Bumped to drop the release scheduled by a previous tail
+  uint64_t tail_generation_ = 0;
 
   struct Stats;
   std::unique_ptr<Stats> pstats_;
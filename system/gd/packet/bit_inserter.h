@@ -35,6 +35,10 @@ class BitInserter : public ByteInserter {
 
   void insert_byte(uint8_t byte) override;
 
+  // Insert |length| whole bytes. Subclasses that override insert_bits() must override this too, the default writes
+  // straight into the vector when there are no pending bits.
+  virtual void insert_bytes(const uint8_t* data, size_t length);
+
  protected:
   size_t num_saved_bits_{0};
   uint8_t saved_bits_{0};
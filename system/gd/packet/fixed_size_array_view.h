@@ -0,0 +1,114 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+
+#include "packet/custom_field_fixed_size_interface.h"
+#include "packet/iterator.h"
+
+namespace bluetooth {
+namespace packet {
+
+// A lazily parsed array of fixed-size elements inside a packet. Generated views return it instead of a
+// std::vector<T> in fixed offset accessor mode, so reading an array field copies and allocates nothing until an
+// element is actually used. Elements are parsed on access and returned by value.
+template <typename T, size_t kElementSize, bool little_endian>
+class FixedSizeArrayView {
+ public:
+  static_assert(kElementSize > 0, "Array elements must have a size");
+
+  class ConstIterator {
+   public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = T;
+
+    ConstIterator(const FixedSizeArrayView* array, size_t index) : array_(array), index_(index) {}
+
+    T operator*() const {
+      return (*array_)[index_];
+    }
+
+    ConstIterator& operator++() {
+      index_++;
+      return *this;
+    }
+
+    bool operator==(const ConstIterator& other) const {
+      return array_ == other.array_ && index_ == other.index_;
+    }
+
+    bool operator!=(const ConstIterator& other) const {
+      return !(*this == other);
+    }
+
+   private:
+    const FixedSizeArrayView* array_;
+    size_t index_;
+  };
+
+  // |max_count| comes from the count field when there is one. Like the vector getters, the array is truncated to
+  // the number of whole elements that are actually present.
+  FixedSizeArrayView(Iterator<little_endian> begin, size_t max_count) : begin_(begin) {
+    size_t available = begin_.NumBytesRemaining() / kElementSize;
+    count_ = max_count < available ? max_count : available;
+  }
+
+  size_t size() const {
+    return count_;
+  }
+
+  bool empty() const {
+    return count_ == 0;
+  }
+
+  T operator[](size_t index) const {
+    Iterator<little_endian> it = begin_;
+    it += static_cast<int>(index * kElementSize);
+    if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>) {
+      static_assert(sizeof(T) == kElementSize, "Scalar elements must fill their type");
+      return it.template extract<T>();
+    } else if constexpr (std::is_base_of_v<CustomFieldFixedSizeInterface<T>, T>) {
+      return it.template extract<T>();
+    } else {
+      T element{};
+      T::Parse(&element, it);
+      return element;
+    }
+  }
+
+  ConstIterator begin() const {
+    return ConstIterator(this, 0);
+  }
+
+  ConstIterator end() const {
+    return ConstIterator(this, count_);
+  }
+
+ private:
+  Iterator<little_endian> begin_;
+  size_t count_;
+};
+
+}  // namespace packet
+}  // namespace bluetooth
@@ -16,6 +16,8 @@
 
 #include "packet/fragmenting_inserter.h"
 
+#include <algorithm>
+
 #include "os/log.h"
 
 namespace bluetooth {
@@ -46,6 +48,27 @@ void FragmentingInserter::insert_bits(uint8_t byte, size_t num_bits) {
   saved_bits_ = static_cast<uint8_t>(new_value) & mask;
 }
 
+void FragmentingInserter::insert_bytes(const uint8_t* data, size_t length) {
+  ASSERT(curr_packet_ != nullptr);
+  if (num_saved_bits_ != 0) {
+    for (size_t i = 0; i < length; i++) {
+      insert_bits(data[i], 8);
+    }
+    return;
+  }
+  on_bytes(data, length);
+  while (length > 0) {
+    size_t chunk = std::min(length, mtu_ - curr_packet_->size());
+    curr_packet_->AddOctets(data, chunk);
+    if (curr_packet_->size() >= mtu_) {
+      iterator_ = std::move(curr_packet_);
+      curr_packet_ = std::make_unique<RawBuilder>(mtu_);
+    }
+    data += chunk;
+    length -= chunk;
+  }
+}
+
 void FragmentingInserter::finalize() {
   if (curr_packet_->size() != 0) {
     iterator_ = std::move(curr_packet_);
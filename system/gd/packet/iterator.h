@@ -31,7 +31,7 @@ namespace packet {
 template <bool little_endian>
 class Iterator : public std::iterator<std::random_access_iterator_tag, uint8_t> {
  public:
-  Iterator(const std::forward_list<View>& data, size_t offset);
+  Iterator(const FragmentList& data, size_t offset);
   Iterator(const Iterator& itr) = default;
   virtual ~Iterator() = default;
 
@@ -89,7 +89,7 @@ class Iterator : public std::iterator<std::random_access_iterator_tag, uint8_t>
   }
 
  private:
-  std::forward_list<View> data_;
+  FragmentList data_;
   size_t index_;
   size_t begin_;
   size_t end_;
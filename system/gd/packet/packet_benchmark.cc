@@ -0,0 +1,153 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <forward_list>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "packet/bit_inserter.h"
+#include "packet/packet_buffer_pool.h"
+#include "packet/packet_view.h"
+#include "packet/raw_builder.h"
+
+using ::benchmark::State;
+
+namespace {
+
+// Counts heap allocations made by this binary so the benchmarks below can report allocations per packet.
+std::atomic<uint64_t> allocation_count{0};
+
+}  // namespace
+
+void* operator new(size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  void* ptr = std::malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+namespace bluetooth {
+namespace packet {
+
+constexpr size_t kAclPacketSize = 1021 + 4;
+
+class BM_PacketAllocation : public ::benchmark::Fixture {
+ protected:
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    PacketBufferPool::Get().Clear();
+    payload_ = std::vector<uint8_t>(kAclPacketSize, 0x42);
+  }
+
+  void TearDown(State& st) override {
+    PacketBufferPool::Get().Clear();
+    ::benchmark::Fixture::TearDown(st);
+  }
+
+  void ReportAllocations(State& state, uint64_t start) {
+    state.counters["allocs_per_packet"] = ::benchmark::Counter(
+        static_cast<double>(allocation_count.load() - start), ::benchmark::Counter::kAvgIterations);
+  }
+
+  std::vector<uint8_t> payload_;
+};
+
+BENCHMARK_DEFINE_F(BM_PacketAllocation, serialize_unpooled)(State& state) {
+  RawBuilder builder(payload_);
+  auto start = allocation_count.load();
+  for (auto _ : state) {
+    auto bytes = std::make_shared<std::vector<uint8_t>>();
+    bytes->reserve(builder.size());
+    BitInserter it(*bytes);
+    builder.Serialize(it);
+    PacketView<kLittleEndian> view(bytes);
+    ::benchmark::DoNotOptimize(view.size());
+  }
+  ReportAllocations(state, start);
+}
+BENCHMARK_REGISTER_F(BM_PacketAllocation, serialize_unpooled);
+
+BENCHMARK_DEFINE_F(BM_PacketAllocation, serialize_pooled)(State& state) {
+  RawBuilder builder(payload_);
+  auto start = allocation_count.load();
+  for (auto _ : state) {
+    auto bytes = PacketBufferPool::Get().Acquire(builder.size());
+    BitInserter it(*bytes);
+    builder.Serialize(it);
+    PacketView<kLittleEndian> view(bytes);
+    ::benchmark::DoNotOptimize(view.size());
+  }
+  ReportAllocations(state, start);
+}
+BENCHMARK_REGISTER_F(BM_PacketAllocation, serialize_pooled);
+
+BENCHMARK_DEFINE_F(BM_PacketAllocation, copy_std_fragment_list)(State& state) {
+  auto bytes = std::make_shared<std::vector<uint8_t>>(payload_);
+  std::forward_list<View> fragments;
+  for (size_t i = 0; i < 4; i++) {
+    fragments.emplace_front(bytes, i * 16, (i + 1) * 16);
+  }
+  auto start = allocation_count.load();
+  for (auto _ : state) {
+    std::forward_list<View> copy = fragments;
+    ::benchmark::DoNotOptimize(copy.front().size());
+  }
+  ReportAllocations(state, start);
+}
+BENCHMARK_REGISTER_F(BM_PacketAllocation, copy_std_fragment_list);
+
+BENCHMARK_DEFINE_F(BM_PacketAllocation, copy_pooled_fragment_list)(State& state) {
+  auto bytes = std::make_shared<std::vector<uint8_t>>(payload_);
+  FragmentList fragments;
+  for (size_t i = 0; i < 4; i++) {
+    fragments.emplace_front(bytes, i * 16, (i + 1) * 16);
+  }
+  auto start = allocation_count.load();
+  for (auto _ : state) {
+    FragmentList copy = fragments;
+    ::benchmark::DoNotOptimize(copy.front().size());
+  }
+  ReportAllocations(state, start);
+}
+BENCHMARK_REGISTER_F(BM_PacketAllocation, copy_pooled_fragment_list);
+
+BENCHMARK_DEFINE_F(BM_PacketAllocation, packet_view_subview)(State& state) {
+  PacketView<kLittleEndian> view(std::make_shared<std::vector<uint8_t>>(payload_));
+  auto start = allocation_count.load();
+  for (auto _ : state) {
+    auto subview = view.GetLittleEndianSubview(4, view.size());
+    ::benchmark::DoNotOptimize(subview[0]);
+  }
+  ReportAllocations(state, start);
+}
+BENCHMARK_REGISTER_F(BM_PacketAllocation, packet_view_subview);
+
+}  // namespace packet
+}  // namespace bluetooth
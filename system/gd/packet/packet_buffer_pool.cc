@@ -0,0 +1,98 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "packet/packet_buffer_pool.h"
+
+#include "packet/pooled_allocator.h"
+
+namespace bluetooth {
+namespace packet {
+
+PacketBufferPool& PacketBufferPool::Get() {
+  // Never destroyed, buffers may be released by static objects after the pool would have gone away
+  static PacketBufferPool* instance = new PacketBufferPool();
+  return *instance;
+}
+
+PacketBufferPool::PacketBufferPool() {
+  for (auto& size_class : size_classes_) {
+    size_class.free_buffers.reserve(kMaxFreeBuffersPerClass);
+  }
+}
+
+size_t PacketBufferPool::size_class_index(size_t size) {
+  for (size_t i = 0; i < kSizeClasses.size(); i++) {
+    if (size <= kSizeClasses[i]) {
+      return i;
+    }
+  }
+  return kSizeClasses.size();
+}
+
+std::shared_ptr<std::vector<uint8_t>> PacketBufferPool::Acquire(size_t size) {
+  size_t index = size_class_index(size);
+  if (index == kSizeClasses.size()) {
+    unpooled_allocations_++;
+    auto buffer = std::make_shared<Buffer>();
+    buffer->reserve(size);
+    return buffer;
+  }
+
+  std::unique_ptr<Buffer> buffer;
+  {
+    auto& size_class = size_classes_[index];
+    std::lock_guard<std::mutex> lock(size_class.mutex);
+    if (!size_class.free_buffers.empty()) {
+      buffer = std::move(size_class.free_buffers.back());
+      size_class.free_buffers.pop_back();
+    }
+  }
+  if (buffer == nullptr) {
+    buffer = std::make_unique<Buffer>();
+    buffer->reserve(kSizeClasses[index]);
+  }
+  return std::shared_ptr<Buffer>(
+      buffer.release(), [this, index](Buffer* released) { release(index, released); }, PooledAllocator<Buffer>());
+}
+
+void PacketBufferPool::release(size_t index, Buffer* buffer) {
+  std::unique_ptr<Buffer> owned(buffer);
+  // Grown well past its size class, don't keep it around
+  if (owned->capacity() > kSizeClasses[index] * 2) {
+    return;
+  }
+  owned->clear();
+  auto& size_class = size_classes_[index];
+  std::lock_guard<std::mutex> lock(size_class.mutex);
+  if (size_class.free_buffers.size() < kMaxFreeBuffersPerClass) {
+    size_class.free_buffers.push_back(std::move(owned));
+  }
+}
+
+size_t PacketBufferPool::GetFreeBufferCount(size_t size_class) const {
+  std::lock_guard<std::mutex> lock(size_classes_[size_class].mutex);
+  return size_classes_[size_class].free_buffers.size();
+}
+
+void PacketBufferPool::Clear() {
+  for (auto& size_class : size_classes_) {
+    std::lock_guard<std::mutex> lock(size_class.mutex);
+    size_class.free_buffers.clear();
+  }
+}
+
+}  // namespace packet
+}  // namespace bluetooth
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace bluetooth {
+namespace packet {
+
+// Process wide pool of packet buffers, in size classes matching the HCI packets that go through the stack. A
+// buffer returns to its size class when the last shared_ptr to it is dropped, and its shared_ptr control block is
+// recycled as well, so serializing a packet into a pooled buffer does not touch the heap once the pool is warm.
+class PacketBufferPool {
+ public:
+  // Capacities include the HCI packet header, the H4 packet type and some slack:
+  // - HCI commands and most HCI events
+  // - LE ACL packets with a 251 byte payload, and the largest HCI events
+  // - BR/EDR ACL packets with a 1021 byte (3-DH5) payload
+  // - ISO data packets with the largest (4095 byte) SDU fragment
+  static constexpr std::array<size_t, 4> kSizeClasses = {64, 264, 1032, 4104};
+  static constexpr size_t kMaxFreeBuffersPerClass = 32;
+
+  static PacketBufferPool& Get();
+
+  // Get an empty buffer with room for |size| bytes. Buffers bigger than the largest size class are allocated from
+  // the heap and not recycled.
+  std::shared_ptr<std::vector<uint8_t>> Acquire(size_t size);
+
+  size_t GetFreeBufferCount(size_t size_class) const;
+  uint64_t GetUnpooledAllocationCount() const {
+    return unpooled_allocations_;
+  }
+
+  // Drop all idle buffers
+  void Clear();
+
+ private:
+  using Buffer = std::vector<uint8_t>;
+
+  struct SizeClass {
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<Buffer>> free_buffers;
+  };
+
+  PacketBufferPool();
+
+  static size_t size_class_index(size_t size);
+  void release(size_t index, Buffer* buffer);
+
+  std::array<SizeClass, kSizeClasses.size()> size_classes_;
+  std::atomic_uint64_t unpooled_allocations_ = 0;
+};
+
+}  // namespace packet
+}  // namespace bluetooth
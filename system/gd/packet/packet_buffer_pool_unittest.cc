@@ -0,0 +1,136 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "packet/packet_buffer_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <forward_list>
+#include <thread>
+
+#include "packet/bit_inserter.h"
+#include "packet/packet_view.h"
+#include "packet/pooled_allocator.h"
+#include "packet/raw_builder.h"
+
+namespace bluetooth {
+namespace packet {
+
+class PacketBufferPoolTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    PacketBufferPool::Get().Clear();
+  }
+
+  void TearDown() override {
+    PacketBufferPool::Get().Clear();
+  }
+};
+
+TEST_F(PacketBufferPoolTest, buffers_fit_their_size_class) {
+  for (size_t i = 0; i < PacketBufferPool::kSizeClasses.size(); i++) {
+    auto size = PacketBufferPool::kSizeClasses[i];
+    auto buffer = PacketBufferPool::Get().Acquire(size);
+    ASSERT_TRUE(buffer->empty());
+    ASSERT_GE(buffer->capacity(), size);
+  }
+}
+
+TEST_F(PacketBufferPoolTest, released_buffers_are_reused) {
+  auto buffer = PacketBufferPool::Get().Acquire(1021 + 4);
+  auto* raw_buffer = buffer.get();
+  buffer->push_back(0x42);
+  ASSERT_EQ(PacketBufferPool::Get().GetFreeBufferCount(2), 0u);
+  buffer.reset();
+  ASSERT_EQ(PacketBufferPool::Get().GetFreeBufferCount(2), 1u);
+
+  auto reused = PacketBufferPool::Get().Acquire(600);
+  ASSERT_EQ(reused.get(), raw_buffer);
+  ASSERT_TRUE(reused->empty());
+  ASSERT_EQ(PacketBufferPool::Get().GetFreeBufferCount(2), 0u);
+}
+
+TEST_F(PacketBufferPoolTest, buffer_is_released_with_last_view) {
+  auto buffer = PacketBufferPool::Get().Acquire(10);
+  buffer->assign({1, 2, 3, 4});
+  PacketView<kLittleEndian> view(buffer);
+  auto subview = view.GetLittleEndianSubview(1, 3);
+  buffer.reset();
+  view = PacketView<kLittleEndian>(std::make_shared<std::vector<uint8_t>>());
+  ASSERT_EQ(PacketBufferPool::Get().GetFreeBufferCount(0), 0u);
+  ASSERT_EQ(subview[0], 2);
+  subview = PacketView<kLittleEndian>(std::make_shared<std::vector<uint8_t>>());
+  ASSERT_EQ(PacketBufferPool::Get().GetFreeBufferCount(0), 1u);
+}
+
+TEST_F(PacketBufferPoolTest, oversized_buffers_are_not_pooled) {
+  auto before = PacketBufferPool::Get().GetUnpooledAllocationCount();
+  auto buffer = PacketBufferPool::Get().Acquire(PacketBufferPool::kSizeClasses.back() + 1);
+  ASSERT_GE(buffer->capacity(), PacketBufferPool::kSizeClasses.back() + 1);
+  ASSERT_EQ(PacketBufferPool::Get().GetUnpooledAllocationCount(), before + 1);
+}
+
+TEST_F(PacketBufferPoolTest, grown_buffers_are_dropped) {
+  auto buffer = PacketBufferPool::Get().Acquire(8);
+  buffer->resize(PacketBufferPool::kSizeClasses[0] * 4);
+  buffer.reset();
+  ASSERT_EQ(PacketBufferPool::Get().GetFreeBufferCount(0), 0u);
+}
+
+TEST_F(PacketBufferPoolTest, free_buffers_are_capped) {
+  std::vector<std::shared_ptr<std::vector<uint8_t>>> buffers;
+  for (size_t i = 0; i < PacketBufferPool::kMaxFreeBuffersPerClass + 5; i++) {
+    buffers.push_back(PacketBufferPool::Get().Acquire(100));
+  }
+  buffers.clear();
+  ASSERT_EQ(PacketBufferPool::Get().GetFreeBufferCount(1), PacketBufferPool::kMaxFreeBuffersPerClass);
+}
+
+TEST_F(PacketBufferPoolTest, serialize_builder) {
+  std::vector<uint8_t> payload = {1, 2, 3, 4, 5};
+  RawBuilder builder(payload);
+  auto buffer = PacketBufferPool::Get().Acquire(builder.size());
+  BitInserter it(*buffer);
+  builder.Serialize(it);
+  ASSERT_EQ(*buffer, payload);
+}
+
+TEST_F(PacketBufferPoolTest, buffer_released_on_another_thread) {
+  auto buffer = PacketBufferPool::Get().Acquire(10);
+  std::thread([buffer = std::move(buffer)]() mutable { buffer.reset(); }).join();
+  ASSERT_EQ(PacketBufferPool::Get().GetFreeBufferCount(0), 1u);
+}
+
+TEST(PooledAllocatorTest, nodes_are_recycled) {
+  std::thread([]() {
+    using List = std::forward_list<uint64_t, PooledAllocator<uint64_t>>;
+    { List list = {1, 2, 3}; }
+    auto cached = internal::BlockCache<sizeof(uint64_t) * 2>::CachedBlockCount();
+    ASSERT_EQ(cached, 3u);
+    List list = {4, 5};
+    ASSERT_EQ(internal::BlockCache<sizeof(uint64_t) * 2>::CachedBlockCount(), 1u);
+  }).join();
+}
+
+TEST(PooledAllocatorTest, array_allocations_use_heap) {
+  PooledAllocator<uint32_t> allocator;
+  auto* array = allocator.allocate(16);
+  array[15] = 42;
+  allocator.deallocate(array, 16);
+}
+
+}  // namespace packet
+}  // namespace bluetooth
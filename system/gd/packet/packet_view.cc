@@ -24,7 +24,7 @@ namespace bluetooth {
 namespace packet {
 
 template <bool little_endian>
-PacketView<little_endian>::PacketView(const std::forward_list<class View> fragments)
+PacketView<little_endian>::PacketView(const FragmentList fragments)
     : fragments_(fragments), length_(0) {
   for (auto fragment : fragments_) {
     length_ += fragment.size();
@@ -69,12 +69,20 @@ size_t PacketView<little_endian>::size() const {
 }
 
 template <bool little_endian>
-std::forward_list<View> PacketView<little_endian>::GetSubviewList(size_t begin, size_t end) const {
+const uint8_t* PacketView<little_endian>::GetContiguousData() const {
+  if (fragments_.empty() || fragments_.front().size() != length_) {
+    return nullptr;
+  }
+  return fragments_.front().data();
+}
+
+template <bool little_endian>
+FragmentList PacketView<little_endian>::GetSubviewList(size_t begin, size_t end) const {
   ASSERT(begin <= end);
   ASSERT(end <= length_);
 
-  std::forward_list<View> view_list;
-  std::forward_list<View>::iterator it = view_list.before_begin();
+  FragmentList view_list;
+  FragmentList::iterator it = view_list.before_begin();
   size_t length = end - begin;
   for (const auto& fragment : fragments_) {
     if (begin >= fragment.size()) {
@@ -100,16 +108,22 @@ PacketView<false> PacketView<little_endian>::GetBigEndianSubview(size_t begin, s
 }
 
 template <bool little_endian>
-void PacketView<little_endian>::Append(PacketView to_add) {
-  auto insertion_point = fragments_.begin();
+FragmentList::iterator PacketView<little_endian>::GetLastFragment() {
+  auto last = fragments_.begin();
   size_t remaining_length = length_;
   while (remaining_length > 0) {
-    remaining_length -= insertion_point->size();
+    remaining_length -= last->size();
     if (remaining_length > 0) {
-      insertion_point++;
+      last++;
     }
   }
-  ASSERT(insertion_point != fragments_.end());
+  ASSERT(last != fragments_.end());
+  return last;
+}
+
+template <bool little_endian>
+void PacketView<little_endian>::Append(PacketView to_add) {
+  auto insertion_point = GetLastFragment();
   for (const auto& fragment : to_add.fragments_) {
     fragments_.insert_after(insertion_point, fragment);
     insertion_point++;
@@ -117,6 +131,18 @@ void PacketView<little_endian>::Append(PacketView to_add) {
   length_ += to_add.length_;
 }
 
+template <bool little_endian>
+void PacketView<little_endian>::Append(const std::vector<PacketView>& to_add) {
+  auto insertion_point = GetLastFragment();
+  for (const auto& view : to_add) {
+    for (const auto& fragment : view.fragments_) {
+      fragments_.insert_after(insertion_point, fragment);
+      insertion_point++;
+    }
+    length_ += view.length_;
+  }
+}
+
 // Explicit instantiations for both types of PacketViews.
 template class PacketView<true>;
 template class PacketView<false>;
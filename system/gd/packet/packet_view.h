@@ -18,6 +18,7 @@
 
 #include <cstdint>
 #include <forward_list>
+#include <vector>
 
 #include "packet/iterator.h"
 #include "packet/view.h"
@@ -33,7 +34,7 @@ static const bool kLittleEndian = true;
 template <bool little_endian>
 class PacketView {
  public:
-  explicit PacketView(std::forward_list<View> fragments);
+  explicit PacketView(FragmentList fragments);
   PacketView(const PacketView& PacketView) = default;
   explicit PacketView(std::shared_ptr<std::vector<uint8_t>> packet);
   PacketView<little_endian>() = delete;
@@ -49,17 +50,50 @@ class PacketView {
 
   size_t size() const;
 
+  // Pointer to the bytes of the packet when they are all in one fragment, nullptr otherwise.
+  const uint8_t* GetContiguousData() const;
+
   PacketView<true> GetLittleEndianSubview(size_t begin, size_t end) const;
 
   PacketView<false> GetBigEndianSubview(size_t begin, size_t end) const;
 
+  // Read the |kWidth| bit field starting |kBitOffset| bits into the packet. Offsets are checked at compile time, the
+  // caller must have checked that the packet is long enough (generated views do so in IsValid()).
+  template <typename T, size_t kBitOffset, size_t kWidth>
+  T GetFixedField() const {
+    static_assert(little_endian, "Fixed offset fields are only generated for little-endian packets");
+    static_assert(kWidth > 0 && kWidth <= sizeof(T) * 8, "Field does not fit in its type");
+    static_assert(kBitOffset % 8 + kWidth <= 64, "Field spans more than 8 bytes");
+    constexpr size_t kFirstByte = kBitOffset / 8;
+    constexpr size_t kNumBytes = (kBitOffset % 8 + kWidth + 7) / 8;
+    uint64_t value = 0;
+    if (!fragments_.empty() && fragments_.front().size() >= kFirstByte + kNumBytes) {
+      const uint8_t* bytes = fragments_.front().data() + kFirstByte;
+      for (size_t i = 0; i < kNumBytes; i++) {
+        value |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+      }
+    } else {
+      for (size_t i = 0; i < kNumBytes; i++) {
+        value |= static_cast<uint64_t>(at(kFirstByte + i)) << (8 * i);
+      }
+    }
+    value >>= kBitOffset % 8;
+    if constexpr (kWidth < 64) {
+      value &= (static_cast<uint64_t>(1) << kWidth) - 1;
+    }
+    return static_cast<T>(value);
+  }
+
  protected:
   void Append(PacketView to_add);
+  // Append each of |to_add| in order, walking the fragments of this view only once
+  void Append(const std::vector<PacketView>& to_add);
 
  private:
-  std::forward_list<View> fragments_;
+  FragmentList fragments_;
   size_t length_;
-  std::forward_list<View> GetSubviewList(size_t begin, size_t end) const;
+  FragmentList GetSubviewList(size_t begin, size_t end) const;
+  FragmentList::iterator GetLastFragment();
 };
 
 }  // namespace packet
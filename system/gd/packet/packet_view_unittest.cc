@@ -21,6 +21,7 @@
 #include <memory>
 
 #include "hci/address.h"
+#include "packet/fixed_size_array_view.h"
 
 using bluetooth::hci::Address;
 using bluetooth::packet::PacketView;
@@ -614,6 +615,42 @@ TEST(ViewTest, earlySubSubviewTest) {
   ASSERT_EQ(sub_2_view.size(), 1u);
 }
 
+TEST_F(PacketViewMultiViewAppendTest, fixedFieldTest) {
+  for (const auto& view : {single_view, multi_view}) {
+    ASSERT_EQ(0x100, (view.GetFixedField<uint16_t, 0, 12>()));
+    ASSERT_EQ(0x20, (view.GetFixedField<uint8_t, 12, 8>()));
+    ASSERT_EQ(0x0302, (view.GetFixedField<uint16_t, 16, 16>()));
+    ASSERT_EQ(0x07060504u, (view.GetFixedField<uint32_t, 32, 32>()));
+    ASSERT_EQ(0x1f1e1d1c1b1a1918u, (view.GetFixedField<uint64_t, 24 * 8, 64>()));
+  }
+}
+
+TEST_F(PacketViewMultiViewAppendTest, contiguousDataTest) {
+  const uint8_t* data = single_view.GetContiguousData();
+  ASSERT_NE(nullptr, data);
+  for (size_t i = 0; i < single_view.size(); i++) {
+    ASSERT_EQ(single_view[i], data[i]);
+  }
+  ASSERT_EQ(nullptr, multi_view.GetContiguousData());
+}
+
+TEST_F(PacketViewMultiViewAppendTest, fixedSizeArrayViewTest) {
+  for (const auto& view : {single_view, multi_view}) {
+    FixedSizeArrayView<uint16_t, 2, kLittleEndian> counted(view.begin() + 2, 4);
+    ASSERT_EQ(4u, counted.size());
+    ASSERT_EQ(0x0302, counted[0]);
+    ASSERT_EQ(0x0908, counted[3]);
+
+    FixedSizeArrayView<uint16_t, 2, kLittleEndian> uncounted(view.begin() + 1, SIZE_MAX);
+    ASSERT_EQ(15u, uncounted.size());
+    uint16_t expected = 0x0201;
+    for (auto element : uncounted) {
+      ASSERT_EQ(expected, element);
+      expected += 0x0202;
+    }
+  }
+}
+
 TEST(ViewTest, subSubviewTest) {
   View view(std::make_shared<const vector<uint8_t>>(count_all), 0, count_all.size());
   std::vector<View> sub_views{view};
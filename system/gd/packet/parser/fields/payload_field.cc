@@ -149,4 +149,14 @@ void PayloadField::GenRustGetter(std::ostream& s, Size start_offset, Size, std::
   }
 }
 
+void PayloadField::GenRustSliceGetter(std::ostream& s, Size start_offset) const {
+  s << "let " << GetName() << ": &[u8] = ";
+  if (size_field_ == nullptr) {
+    s << "&bytes[" << start_offset.bytes() << "..];";
+  } else {
+    s << "&bytes[" << start_offset.bytes() << "..(";
+    s << start_offset.bytes() << " + " << size_field_->GetName() << " as usize)];";
+  }
+}
+
 void PayloadField::GenRustWriter(std::ostream&, Size, Size) const {}
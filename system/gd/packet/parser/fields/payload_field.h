@@ -60,6 +60,9 @@ class PayloadField : public PacketField {
 
   void GenRustGetter(std::ostream& s, Size start_offset, Size end_offset, std::string) const override;
 
+  // Borrow the payload from the bytes instead of copying it, for the Rust views.
+  void GenRustSliceGetter(std::ostream& s, Size start_offset) const;
+
   void GenRustWriter(std::ostream& s, Size start_offset, Size end_offset) const override;
 
   void GenBoundsCheck(std::ostream&, Size, Size, std::string) const override;
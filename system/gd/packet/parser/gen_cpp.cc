@@ -55,7 +55,8 @@ bool generate_cpp_headers_one_file(
     const std::filesystem::path& input_file,
     const std::filesystem::path& include_dir,
     const std::filesystem::path& out_dir,
-    const std::string& root_namespace) {
+    const std::string& root_namespace,
+    bool fixed_offset_accessors) {
   auto gen_relative_path = input_file.lexically_relative(include_dir).parent_path();
 
   auto input_filename = input_file.filename().string().substr(0, input_file.filename().string().find(".pdl"));
@@ -88,6 +89,7 @@ bool generate_cpp_headers_one_file(
 #include "packet/base_packet_builder.h"
 #include "packet/bit_inserter.h"
 #include "packet/custom_field_fixed_size_interface.h"
+#include "packet/fixed_size_array_view.h"
 #include "packet/iterator.h"
 #include "packet/packet_builder.h"
 #include "packet/packet_struct.h"
@@ -193,7 +195,7 @@ using ::bluetooth::packet::parser::ChecksumTypeChecker;
   }
 
   for (const auto& packet_def : decls.packet_defs_queue_) {
-    packet_def.second->GenParserDefinition(out_file);
+    packet_def.second->GenParserDefinition(out_file, fixed_offset_accessors);
     out_file << "\n\n";
   }
 
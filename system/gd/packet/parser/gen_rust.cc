@@ -48,6 +48,12 @@ pub enum Error {
     wanted: usize,
     got: usize,
   },
+  #[error("{obj} needs a buffer of {wanted} bytes but got {got}")]
+  BufferTooSmallError {
+    obj: String,
+    wanted: usize,
+    got: usize,
+  },
   #[error("Due to size restrictions a struct could not be parsed.")]
   ImpossibleStructError,
   #[error("when parsing field {obj}.{field}, {value} is not a valid {type_} value")]
@@ -76,7 +82,8 @@ bool generate_rust_source_one_file(
     const std::filesystem::path& input_file,
     const std::filesystem::path& include_dir,
     const std::filesystem::path& out_dir,
-    __attribute__((unused)) const std::string& root_namespace) {
+    __attribute__((unused)) const std::string& root_namespace,
+    bool views) {
   auto gen_relative_path = input_file.lexically_relative(include_dir).parent_path();
 
   auto input_filename = input_file.filename().string().substr(0, input_file.filename().string().find(".pdl"));
@@ -223,7 +230,7 @@ bool generate_rust_source_one_file(
   }
 
   for (const auto& packet_def : decls.packet_defs_queue_) {
-    packet_def.second->GenRustDef(out_file);
+    packet_def.second->GenRustDef(out_file, views);
     out_file << "\n\n";
   }
 
@@ -42,7 +42,8 @@ bool generate_cpp_headers_one_file(
     const std::filesystem::path& input_file,
     const std::filesystem::path& include_dir,
     const std::filesystem::path& out_dir,
-    const std::string& root_namespace);
+    const std::string& root_namespace,
+    bool fixed_offset_accessors);
 
 bool generate_pybind11_sources_one_file(
     const Declarations& decls,
@@ -57,7 +58,8 @@ bool generate_rust_source_one_file(
     const std::filesystem::path& input_file,
     const std::filesystem::path& include_dir,
     const std::filesystem::path& out_dir,
-    const std::string& root_namespace);
+    const std::string& root_namespace,
+    bool views);
 
 bool parse_declarations_one_file(const std::filesystem::path& input_file, Declarations* declarations) {
   void* scanner;
@@ -123,6 +125,12 @@ void usage(const char* prog) {
 
   ofs << std::setw(24) << "--num_shards= ";
   ofs << "Number of shards per output pybind11 cc file." << std::endl;
+
+  ofs << std::setw(24) << "--fixed_offset_accessors ";
+  ofs << "Read fixed offset fields directly and generate array spans in C++ views." << std::endl;
+
+  ofs << std::setw(24) << "--rust_views ";
+  ofs << "Also generate Rust views borrowing the packet bytes (with --rust)." << std::endl;
 }
 
 int main(int argc, const char** argv) {
@@ -134,6 +142,8 @@ int main(int argc, const char** argv) {
   // Number of shards per output pybind11 cc file
   size_t num_shards = 1;
   bool generate_rust = false;
+  bool rust_views = false;
+  bool fixed_offset_accessors = false;
   std::queue<std::filesystem::path> input_files;
 
   const std::string arg_out = "--out=";
@@ -141,7 +151,9 @@ int main(int argc, const char** argv) {
   const std::string arg_namespace = "--root_namespace=";
   const std::string arg_num_shards = "--num_shards=";
   const std::string arg_rust = "--rust";
+  const std::string arg_rust_views = "--rust_views";
   const std::string arg_source_root = "--source_root=";
+  const std::string arg_fixed_offset_accessors = "--fixed_offset_accessors";
 
   // Parse the source root first (if it exists) since it will be used for other
   // paths.
@@ -162,8 +174,12 @@ int main(int argc, const char** argv) {
       root_namespace = arg.substr(arg_namespace.size());
     } else if (arg.find(arg_num_shards) == 0) {
       num_shards = std::stoul(arg.substr(arg_num_shards.size()));
+    } else if (arg.find(arg_rust_views) == 0) {
+      rust_views = true;
     } else if (arg.find(arg_rust) == 0) {
       generate_rust = true;
+    } else if (arg.find(arg_fixed_offset_accessors) == 0) {
+      fixed_offset_accessors = true;
     } else if (arg.find(arg_source_root) == 0) {
       // Do nothing (just don't treat it as input_files)
     } else {
@@ -186,13 +202,15 @@ int main(int argc, const char** argv) {
     }
     if (generate_rust) {
       std::cout << "generating rust" << std::endl;
-      if (!generate_rust_source_one_file(declarations, input_files.front(), include_dir, out_dir, root_namespace)) {
+      if (!generate_rust_source_one_file(
+              declarations, input_files.front(), include_dir, out_dir, root_namespace, rust_views)) {
         std::cerr << "Didn't generate rust source for " << input_files.front() << std::endl;
         return 5;
       }
     } else {
       std::cout << "generating c++ and pybind11" << std::endl;
-      if (!generate_cpp_headers_one_file(declarations, input_files.front(), include_dir, out_dir, root_namespace)) {
+      if (!generate_cpp_headers_one_file(
+              declarations, input_files.front(), include_dir, out_dir, root_namespace, fixed_offset_accessors)) {
         std::cerr << "Didn't generate cpp headers for " << input_files.front() << std::endl;
         return 3;
       }
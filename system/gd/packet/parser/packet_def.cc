@@ -31,7 +31,7 @@ PacketField* PacketDef::GetNewField(const std::string&, ParseLocation) const {
   return nullptr;  // Packets can't be fields
 }
 
-void PacketDef::GenParserDefinition(std::ostream& s) const {
+void PacketDef::GenParserDefinition(std::ostream& s, bool fixed_offset_accessors) const {
   s << "class " << name_ << "View";
   if (parent_ != nullptr) {
     s << " : public " << parent_->name_ << "View {";
@@ -60,7 +60,12 @@ void PacketDef::GenParserDefinition(std::ostream& s) const {
   const auto& public_fields = fields_.GetFieldsWithoutTypes(fixed_types);
   bool has_fixed_fields = public_fields.size() != fields_.size();
   for (const auto& field : public_fields) {
-    GenParserFieldGetter(s, field);
+    if (!fixed_offset_accessors || !GenFixedOffsetFieldGetter(s, field)) {
+      GenParserFieldGetter(s, field);
+    }
+    if (fixed_offset_accessors) {
+      GenArraySpanGetter(s, field);
+    }
     s << "\n";
   }
   GenValidator(s);
@@ -164,6 +169,76 @@ void PacketDef::GenParserFieldGetter(std::ostream& s, const PacketField* field)
   field->GenGetter(s, start_field_offset, end_field_offset);
 }
 
+bool PacketDef::GenFixedOffsetFieldGetter(std::ostream& s, const PacketField* field) const {
+  if (!is_little_endian_) {
+    return false;
+  }
+  if (field->GetFieldType() != ScalarField::kFieldType && field->GetFieldType() != EnumField::kFieldType) {
+    return false;
+  }
+  auto offset = GetOffsetForField(field->GetName(), false);
+  auto size = field->GetSize();
+  if (offset.empty() || offset.has_dynamic() || size.empty() || size.has_dynamic()) {
+    return false;
+  }
+  if (offset.bits() % 8 + size.bits() > 64) {
+    return false;
+  }
+
+  // IsValid() already checks that all of the fixed size fields are present.
+  s << field->GetDataType() << " " << field->GetGetterFunctionName() << "() const {";
+  s << "ASSERT(was_validated_);";
+  s << "return GetFixedField<" << field->GetDataType() << ", " << offset.bits() << ", " << size.bits() << ">();";
+  s << "}";
+  return true;
+}
+
+void PacketDef::GenArraySpanGetter(std::ostream& s, const PacketField* field) const {
+  if (!is_little_endian_ || field->GetFieldType() != VectorField::kFieldType) {
+    return;
+  }
+  const auto* vector_field = static_cast<const VectorField*>(field);
+  const auto* element_field = vector_field->GetElementField();
+  auto element_size = element_field->GetSize();
+  if (element_size.empty() || element_size.has_dynamic()) {
+    return;
+  }
+  const auto& element_type = element_field->GetFieldType();
+  if (element_type == ScalarField::kFieldType || element_type == EnumField::kFieldType) {
+    // Scalars are extracted as their whole C++ type.
+    int bits = element_size.bits();
+    if (bits != 8 && bits != 16 && bits != 32 && bits != 64) {
+      return;
+    }
+  } else if (element_type != StructField::kFieldType && element_type != CustomFieldFixedSize::kFieldType) {
+    return;
+  }
+
+  auto start_field_offset = GetOffsetForField(field->GetName(), false);
+  auto end_field_offset = GetOffsetForField(field->GetName(), true);
+  if (start_field_offset.empty() && end_field_offset.empty()) {
+    return;
+  }
+
+  std::stringstream span_type;
+  span_type << "::bluetooth::packet::FixedSizeArrayView<" << element_field->GetDataType() << ", "
+            << element_size.bytes() << ", kLittleEndian>";
+
+  s << span_type.str() << " " << field->GetGetterFunctionName() << "Span() const {";
+  s << "ASSERT(was_validated_);";
+  s << "size_t end_index = size();";
+  s << "auto to_bound = begin();";
+  field->GenBounds(s, start_field_offset, end_field_offset, field->GetSize());
+  s << "return " << span_type.str() << "(" << field->GetName() << "_it, ";
+  if (vector_field->size_field_ != nullptr && vector_field->size_field_->GetFieldType() == CountField::kFieldType) {
+    s << "Get" << util::UnderscoreToCamelCase(vector_field->size_field_->GetName()) << "()";
+  } else {
+    s << "SIZE_MAX";
+  }
+  s << ");";
+  s << "}\n";
+}
+
 TypeDef::Type PacketDef::GetDefinitionType() const {
   return TypeDef::Type::PACKET;
 }
@@ -883,6 +958,106 @@ void PacketDef::GenRustStructFieldNames(std::ostream& s) const {
   }
 }
 
+std::vector<std::string> PacketDef::GetRustChildMatchVariables() const {
+  auto packet_dep = PacketDependency(GetRootDef());
+  auto match_on_variables = packet_dep.GetChildrenDependencies(name_);
+  // If match_on_variables is empty, this means there are multiple abstract packets which will
+  // specialize to a child down the packet tree.
+  // In this case match variables will be the union of parent fields and parse params of children.
+  if (match_on_variables.empty()) {
+    for (auto& field : fields_) {
+      if (std::any_of(children_.begin(), children_.end(), [&](auto child) {
+            auto pass_me = packet_dep.GetDependencies(child->name_);
+            return std::find(pass_me.begin(), pass_me.end(), field->GetName()) != pass_me.end();
+          })) {
+        match_on_variables.push_back(field->GetName());
+      }
+    }
+  }
+  return match_on_variables;
+}
+
+void PacketDef::GenRustChildMatch(
+    std::ostream& s, const std::function<void(const ParentDef* child)>& gen_child) const {
+  auto match_on_variables = GetRustChildMatchVariables();
+  s << "let child = match (";
+
+  for (auto var : match_on_variables) {
+    if (var == match_on_variables[match_on_variables.size() - 1]) {
+      s << var;
+    } else {
+      s << var << ", ";
+    }
+  }
+  s << ") {";
+
+  auto get_match_val = [&](
+      std::string& match_var,
+      std::variant<int64_t,
+      std::string> constraint) -> std::string {
+    auto constraint_field = GetParamList().GetField(match_var);
+    auto constraint_type = constraint_field->GetFieldType();
+
+    if (constraint_type == EnumField::kFieldType) {
+      auto type = std::get<std::string>(constraint);
+      auto variant_name = type.substr(type.find("::") + 2, type.length());
+      auto enum_type = type.substr(0, type.find("::"));
+      return enum_type + "::" + util::UnderscoreToCamelCase(util::ToLowerCase(variant_name));
+    }
+    if (constraint_type == ScalarField::kFieldType) {
+      return std::to_string(std::get<int64_t>(constraint));
+    }
+    return "_";
+  };
+
+  for (auto& child : children_) {
+    s << "(";
+    for (auto var : match_on_variables) {
+      std::string match_val = "_";
+
+      if (child->parent_constraints_.find(var) != child->parent_constraints_.end()) {
+        match_val = get_match_val(var, child->parent_constraints_[var]);
+      } else {
+        auto dcs = child->FindDescendantsWithConstraint(var);
+        std::vector<std::string> all_match_vals;
+        for (auto& desc : dcs) {
+          all_match_vals.push_back(get_match_val(var, desc.second));
+        }
+        match_val = "";
+        for (std::size_t i = 0; i < all_match_vals.size(); ++i) {
+          match_val += all_match_vals[i];
+          if (i != all_match_vals.size() - 1) {
+            match_val += " | ";
+          }
+        }
+        match_val = (match_val == "") ? "_" : match_val;
+      }
+
+      if (var == match_on_variables[match_on_variables.size() - 1]) {
+        s << match_val << ")";
+      } else {
+        s << match_val << ", ";
+      }
+    }
+    s << " if " << child->name_ << "Data::conforms(&bytes[..])";
+    s << " => {";
+    gen_child(child);
+    s << "}\n";
+  }
+
+  s << "(";
+  for (int i = 1; i <= match_on_variables.size(); i++) {
+    if (i == match_on_variables.size()) {
+      s << "_";
+    } else {
+      s << "_, ";
+    }
+  }
+  s << ")";
+  s << " => return Err(Error::InvalidPacketError),";
+  s << "};\n";
+}
+
 void PacketDef::GenRustStructImpls(std::ostream& s) const {
   auto packet_dep = PacketDependency(GetRootDef());
 
@@ -943,82 +1118,7 @@ void PacketDef::GenRustStructImpls(std::ostream& s) const {
   }
 
   if (children_.size() > 1) {
-    auto match_on_variables = packet_dep.GetChildrenDependencies(name_);
-    // If match_on_variables is empty, this means there are multiple abstract packets which will
-    // specialize to a child down the packet tree.
-    // In this case match variables will be the union of parent fields and parse params of children.
-    if (match_on_variables.empty()) {
-      for (auto& field : fields_) {
-        if (std::any_of(children_.begin(), children_.end(), [&](auto child) {
-              auto pass_me = packet_dep.GetDependencies(child->name_);
-              return std::find(pass_me.begin(), pass_me.end(), field->GetName()) != pass_me.end();
-            })) {
-          match_on_variables.push_back(field->GetName());
-        }
-      }
-    }
-
-    s << "let child = match (";
-
-    for (auto var : match_on_variables) {
-      if (var == match_on_variables[match_on_variables.size() - 1]) {
-        s << var;
-      } else {
-        s << var << ", ";
-      }
-    }
-    s << ") {";
-
-    auto get_match_val = [&](
-        std::string& match_var,
-        std::variant<int64_t,
-        std::string> constraint) -> std::string {
-      auto constraint_field = GetParamList().GetField(match_var);
-      auto constraint_type = constraint_field->GetFieldType();
-
-      if (constraint_type == EnumField::kFieldType) {
-        auto type = std::get<std::string>(constraint);
-        auto variant_name = type.substr(type.find("::") + 2, type.length());
-        auto enum_type = type.substr(0, type.find("::"));
-        return enum_type + "::" + util::UnderscoreToCamelCase(util::ToLowerCase(variant_name));
-      }
-      if (constraint_type == ScalarField::kFieldType) {
-        return std::to_string(std::get<int64_t>(constraint));
-      }
-      return "_";
-    };
-
-    for (auto& child : children_) {
-      s << "(";
-      for (auto var : match_on_variables) {
-        std::string match_val = "_";
-
-        if (child->parent_constraints_.find(var) != child->parent_constraints_.end()) {
-          match_val = get_match_val(var, child->parent_constraints_[var]);
-        } else {
-          auto dcs = child->FindDescendantsWithConstraint(var);
-          std::vector<std::string> all_match_vals;
-          for (auto& desc : dcs) {
-            all_match_vals.push_back(get_match_val(var, desc.second));
-          }
-          match_val = "";
-          for (std::size_t i = 0; i < all_match_vals.size(); ++i) {
-            match_val += all_match_vals[i];
-            if (i != all_match_vals.size() - 1) {
-              match_val += " | ";
-            }
-          }
-          match_val = (match_val == "") ? "_" : match_val;
-        }
-
-        if (var == match_on_variables[match_on_variables.size() - 1]) {
-          s << match_val << ")";
-        } else {
-          s << match_val << ", ";
-        }
-      }
-      s << " if " << child->name_ << "Data::conforms(&bytes[..])";
-      s << " => {";
+    GenRustChildMatch(s, [&](const ParentDef* child) {
       s << name_ << "DataChild::";
       s << child->name_ << "(Arc::new(";
 
@@ -1037,20 +1137,7 @@ void PacketDef::GenRustStructImpls(std::ostream& s) const {
         }
       }
       s << ")?))";
-      s << "}\n";
-    }
-
-    s << "(";
-    for (int i = 1; i <= match_on_variables.size(); i++) {
-      if (i == match_on_variables.size()) {
-        s << "_";
-      } else {
-        s << "_, ";
-      }
-    }
-    s << ")";
-    s << " => return Err(Error::InvalidPacketError),";
-    s << "};\n";
+    });
   } else if (children_.size() == 1) {
     auto child = children_.at(0);
     auto params = packet_dep.GetDependencies(child->name_);
@@ -1099,7 +1186,7 @@ void PacketDef::GenRustStructImpls(std::ostream& s) const {
   s << "}\n";
 
   // write_to function
-  s << "fn write_to(&self, buffer: &mut BytesMut) {";
+  s << "fn write_to(&self, buffer: &mut [u8]) {";
   GenRustWriteToFields(s);
 
   if (HasChildEnums()) {
@@ -1191,6 +1278,25 @@ void PacketDef::GenRustAccessStructImpls(std::ostream& s) const {
     s << "}";
   }
 
+  s << "pub fn get_total_size(&self) -> usize {";
+  s << " self." << root_accessor << ".get_total_size()";
+  s << "}\n";
+
+  // The buffer may be larger than the packet, or reused: the writers OR the bit fields into it.
+  s << "pub fn write_to_slice(&self, buffer: &mut [u8]) -> Result<usize> {";
+  s << " let size = self." << root_accessor << ".get_total_size();";
+  s << " if buffer.len() < size {";
+  s << " return Err(Error::BufferTooSmallError {";
+  s << "    obj: \"" << name_ << "\".to_string(),";
+  s << "    wanted: size,";
+  s << "    got: buffer.len()});";
+  s << " }";
+  s << " let buffer = &mut buffer[..size];";
+  s << " buffer.fill(0);";
+  s << " self." << root_accessor << ".write_to(buffer);";
+  s << " Ok(size)";
+  s << "}\n";
+
   if (HasChildEnums()) {
     s << " pub fn specialize(&self) -> " << name_ << "Child {";
     s << " match &self." << util::CamelCaseToUnderScore(name_) << ".child {";
@@ -1352,7 +1458,196 @@ void PacketDef::GenRustBuilderStructImpls(std::ostream& s) const {
   }
 }
 
-void PacketDef::GenRustBuilderTest(std::ostream& s) const {
+// Fields at a fixed offset, read by value. The views check them when they are created, so that their accessors can
+// not fail.
+static bool IsRustViewEagerField(const PacketField* field) {
+  auto field_type = field->GetFieldType();
+  return field_type != ArrayField::kFieldType && field_type != BodyField::kFieldType &&
+         field_type != PayloadField::kFieldType && field_type != StructField::kFieldType &&
+         field_type != VariableLengthStructField::kFieldType && field_type != VectorField::kFieldType;
+}
+
+void PacketDef::GenRustViewDeclarations(std::ostream& s) const {
+  s << "#[derive(Debug, Clone, Copy)] ";
+  s << "pub struct " << name_ << "View<'a> {";
+  s << "bytes: &'a [u8],";
+  s << "}\n";
+
+  if (HasChildEnums()) {
+    s << "#[derive(Debug, Clone, Copy)] ";
+    s << "pub enum " << name_ << "ViewChild<'a> {";
+    for (const auto& child : children_) {
+      s << child->name_ << "(" << child->name_ << "View<'a>),";
+    }
+    if (fields_.HasPayload()) {
+      s << "Payload(&'a [u8]),";
+    }
+    s << "None,";
+    s << "}\n";
+  }
+}
+
+void PacketDef::GenRustViewImpls(std::ostream& s) const {
+  auto root = GetRootDef();
+  auto lineage = GetAncestors();
+  lineage.push_back(this);
+
+  // The sizes and counts the vectors and the payload of |def| are read with.
+  auto gen_size_getters = [&](const ParentDef* def) {
+    auto fields = def->fields_.GetFieldsWithTypes({
+        CountField::kFieldType,
+        SizeField::kFieldType,
+    });
+    for (auto const& field : fields) {
+      field->GenRustGetter(
+          s, def->GetOffsetForField(field->GetName(), false), def->GetOffsetForField(field->GetName(), true),
+          def->name_);
+    }
+  };
+
+  s << "impl<'a> " << name_ << "View<'a> {";
+
+  // The fields of the parents were checked by the views of the parents.
+  s << "fn new(bytes: &'a [u8]) -> Result<Self> {";
+  auto fields = fields_.GetFieldsWithoutTypes({
+      BodyField::kFieldType,
+  });
+  for (auto const& field : fields) {
+    auto start_field_offset = GetOffsetForField(field->GetName(), false);
+    auto end_field_offset = GetOffsetForField(field->GetName(), true);
+
+    field->GenBoundsCheck(s, start_field_offset, end_field_offset, name_);
+    if (IsRustViewEagerField(field)) {
+      field->GenRustGetter(s, start_field_offset, end_field_offset, name_);
+      if (field->GetFieldType() == CustomFieldFixedSize::kFieldType) {
+        // The custom type is otherwise inferred from the field of the struct it is stored in.
+        s << "let _: " << field->GetRustDataType() << " = " << field->GetName() << ";";
+      }
+    }
+  }
+  s << "Ok(Self { bytes })";
+  s << "}\n";
+
+  if (parent_ == nullptr) {
+    s << "pub fn parse(bytes: &'a [u8]) -> Result<Self> {";
+    s << " Self::new(bytes)";
+    s << "}\n";
+  }
+
+  s << "pub fn as_bytes(&self) -> &'a [u8] {";
+  s << " self.bytes";
+  s << "}\n";
+
+  s << "pub fn to_packet(&self) -> Result<" << name_ << "Packet> {";
+  s << " let root = Arc::new(" << root->name_ << "Data::parse(self.bytes)?);";
+  s << " " << name_ << "Packet::new(root).map_err(|_| Error::InvalidPacketError)";
+  s << "}\n";
+
+  if (HasChildEnums()) {
+    s << "pub fn specialize(&self) -> Result<" << name_ << "ViewChild<'a>> {";
+    s << "let bytes = self.bytes;";
+    if (children_.size() > 1) {
+      for (auto var : GetRustChildMatchVariables()) {
+        s << "let " << var << " = self.get_" << var << "();";
+      }
+      GenRustChildMatch(s, [&](const ParentDef* child) {
+        s << name_ << "ViewChild::" << child->name_ << "(" << child->name_ << "View::new(bytes)?)";
+      });
+    } else if (children_.size() == 1) {
+      auto child = children_.at(0);
+      s << "let child = match " << child->name_ << "View::new(bytes) {";
+      s << " Ok(c) if " << child->name_ << "Data::conforms(bytes) => {";
+      s << name_ << "ViewChild::" << child->name_ << "(c)";
+      s << " },";
+      s << " Err(Error::InvalidLengthError { .. }) => " << name_ << "ViewChild::None,";
+      s << " _ => return Err(Error::InvalidPacketError),";
+      s << "};";
+    } else {
+      s << "let payload = self.get_payload();";
+      s << "let child = if payload.len() > 0 {";
+      s << name_ << "ViewChild::Payload(payload)";
+      s << "} else {";
+      s << name_ << "ViewChild::None";
+      s << "};";
+    }
+    s << "Ok(child)";
+    s << "}\n";
+  }
+
+  if (fields_.HasPayload()) {
+    auto payload_field = fields_.GetFieldsWithTypes({
+        PayloadField::kFieldType,
+    })[0];
+    s << "pub fn get_payload(&self) -> &'a [u8] {";
+    s << "let bytes = self.bytes;";
+    gen_size_getters(this);
+    static_cast<const PayloadField*>(payload_field)
+        ->GenRustSliceGetter(s, GetOffsetForField(payload_field->GetName(), false));
+    s << "payload";
+    s << "}\n";
+  }
+
+  for (auto def : lineage) {
+    auto fields = def->fields_.GetFieldsWithoutTypes({
+        BodyField::kFieldType,
+        CountField::kFieldType,
+        PaddingField::kFieldType,
+        ReservedField::kFieldType,
+        SizeField::kFieldType,
+        PayloadField::kFieldType,
+        FixedScalarField::kFieldType,
+    });
+
+    for (auto const& field : fields) {
+      auto start_field_offset = def->GetOffsetForField(field->GetName(), false);
+      auto end_field_offset = def->GetOffsetForField(field->GetName(), true);
+      auto field_type = field->GetFieldType();
+
+      if (field_type == StructField::kFieldType || field_type == VariableLengthStructField::kFieldType ||
+          field_type == VectorField::kFieldType) {
+        s << "pub fn get_" << field->GetName() << "(&self) -> Result<" << field->GetRustDataType() << "> {";
+        s << "let bytes = self.bytes;";
+        gen_size_getters(def);
+        field->GenRustGetter(s, start_field_offset, end_field_offset, def->name_);
+        s << "Ok(" << field->GetName() << ")";
+        s << "}\n";
+      } else {
+        s << "pub fn get_" << field->GetName() << "(&self) -> " << field->GetRustDataType() << " {";
+        s << "let bytes = self.bytes;";
+        s << "let get = || -> Result<" << field->GetRustDataType() << "> {";
+        field->GenRustGetter(s, start_field_offset, end_field_offset, def->name_);
+        s << "Ok(" << field->GetName() << ")";
+        s << "};";
+        s << "get().unwrap()";
+        s << "}\n";
+      }
+    }
+  }
+  s << "}\n";
+
+  if (root != this) {
+    s << "impl<'a> TryFrom<" << root->name_ << "View<'a>> for " << name_ << "View<'a> {";
+    s << "type Error = Error;";
+    s << "fn try_from(view: " << root->name_ << "View<'a>) -> Result<Self> {";
+    for (size_t i = 1; i < lineage.size(); i++) {
+      s << "let view = match view.specialize()? {";
+      s << lineage[i - 1]->name_ << "ViewChild::" << lineage[i]->name_ << "(view) => view,";
+      s << "_ => return Err(Error::InvalidPacketError),";
+      s << "};";
+    }
+    s << "Ok(view)";
+    s << "}\n";
+    s << "}\n";
+  }
+
+  for (const auto ancestor : GetAncestors()) {
+    s << "impl<'a> From<" << name_ << "View<'a>> for " << ancestor->name_ << "View<'a> {";
+    s << " fn from(view: " << name_ << "View<'a>) -> Self { Self { bytes: view.bytes } }";
+    s << "}\n";
+  }
+}
+
+void PacketDef::GenRustBuilderTest(std::ostream& s, bool views) const {
   auto lineage = GetAncestors();
   lineage.push_back(this);
   if (!lineage.empty() && !test_cases_.empty()) {
@@ -1401,6 +1696,18 @@ void PacketDef::GenRustBuilderTest(std::ostream& s) const {
         s << "let rebuilder_base : " << lineage[0]->name_ << "Packet = rebuilder.into();";
         s << "let rebuilder_bytes : &[u8] = &rebuilder_base.to_bytes();";
         s << "assert_eq!(rebuilder_bytes, raw_bytes);";
+        if (views) {
+          auto root_name = lineage[0]->name_;
+          s << "let " << util::CamelCaseToUnderScore(root_name) << "_view = " << root_name << "View::parse(raw_bytes)";
+          s << ".unwrap_or_else(|e| panic!(\"could not parse " << root_name << "View: {:?} {:02x?}\", e, raw_bytes));";
+          s << "let view = " << name_ << "View::try_from(" << util::CamelCaseToUnderScore(root_name) << "_view)";
+          s << ".unwrap_or_else(|e| panic!(\"could not specialize " << name_ << "View: {:?} {:02x?}\", e, raw_bytes));";
+          s << "let view_packet = view.to_packet().unwrap();";
+          s << "assert_eq!(view_packet.clone().to_bytes(), &raw_bytes[..]);";
+          s << "let mut buffer = vec![0xffu8; raw_bytes.len() + 1];";
+          s << "assert_eq!(view_packet.write_to_slice(&mut buffer).unwrap(), raw_bytes.len());";
+          s << "assert_eq!(&buffer[..raw_bytes.len()], &raw_bytes[..]);";
+        }
         s << "}";
       }
     }
@@ -1431,11 +1738,15 @@ void PacketDef::GenRustBuilderTest(std::ostream& s) const {
   }
 }
 
-void PacketDef::GenRustDef(std::ostream& s) const {
+void PacketDef::GenRustDef(std::ostream& s, bool views) const {
   GenRustChildEnums(s);
   GenRustStructDeclarations(s);
   GenRustStructImpls(s);
   GenRustAccessStructImpls(s);
   GenRustBuilderStructImpls(s);
-  GenRustBuilderTest(s);
+  if (views) {
+    GenRustViewDeclarations(s);
+    GenRustViewImpls(s);
+  }
+  GenRustBuilderTest(s, views);
 }
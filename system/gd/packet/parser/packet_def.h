@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <functional>
 #include <map>
 #include <variant>
 
@@ -31,7 +32,9 @@ class PacketDef : public ParentDef {
 
   PacketField* GetNewField(const std::string& name, ParseLocation loc) const;
 
-  void GenParserDefinition(std::ostream& s) const;
+  // With |fixed_offset_accessors|, fields at a known offset are read with PacketView::GetFixedField() and arrays of
+  // fixed size elements get an extra Get<Field>Span() accessor that does not copy them into a vector.
+  void GenParserDefinition(std::ostream& s, bool fixed_offset_accessors) const;
 
   void GenTestingParserFromBytes(std::ostream& s) const;
 
@@ -39,6 +42,11 @@ class PacketDef : public ParentDef {
 
   void GenParserFieldGetter(std::ostream& s, const PacketField* field) const;
 
+  // Return false, without generating anything, if the field is not a scalar or enum at a fixed offset.
+  bool GenFixedOffsetFieldGetter(std::ostream& s, const PacketField* field) const;
+
+  void GenArraySpanGetter(std::ostream& s, const PacketField* field) const;
+
   void GenValidator(std::ostream& s) const;
 
   void GenParserToString(std::ostream& s) const;
@@ -73,13 +81,28 @@ class PacketDef : public ParentDef {
 
   void GenRustStructFieldNames(std::ostream& s) const;
 
+  // Variables the parse of this packet matches against the constraints of its children.
+  std::vector<std::string> GetRustChildMatchVariables() const;
+
+  // Generate "let child = match (...) { ... };" selecting the child whose constraints match the
+  // variables, |gen_child| generates the value of the arm of each child.
+  void GenRustChildMatch(std::ostream& s, const std::function<void(const ParentDef* child)>& gen_child) const;
+
   void GenRustStructImpls(std::ostream& s) const;
 
   void GenRustAccessStructImpls(std::ostream& s) const;
 
   void GenRustBuilderStructImpls(std::ostream& s) const;
 
-  void GenRustBuilderTest(std::ostream& s) const;
+  // With |views|, the test also parses the bytes into a view and writes them back with write_to_slice().
+  void GenRustBuilderTest(std::ostream& s, bool views) const;
+
+  // XxxView<'a> borrows the bytes of the root packet and reads the fields on demand. Only the fields of
+  // fixed size are read when the view is created, the other ones, and the children, when accessed.
+  void GenRustViewDeclarations(std::ostream& s) const;
+
+  void GenRustViewImpls(std::ostream& s) const;
 
-  void GenRustDef(std::ostream& s) const;
+  // With |views|, the borrowed XxxView types are generated next to the owned XxxPacket types.
+  void GenRustDef(std::ostream& s, bool views) const;
 };
@@ -558,6 +558,18 @@ TEST(GeneratedPacketTest, testCountArrayEnum) {
   }
 }
 
+TEST(GeneratedPacketTest, testCountArrayEnumSpan) {
+  std::vector<ForArrays> count_array{{ForArrays::ONE, ForArrays::TWO_THREE, ForArrays::FFFF}};
+  auto packet_bytes = std::make_shared<std::vector<uint8_t>>(count_array_enum);
+  auto view = CountArrayEnumView::Create(PacketView<kLittleEndian>(packet_bytes));
+  ASSERT_TRUE(view.IsValid());
+  auto span = view.GetEnumArraySpan();
+  ASSERT_EQ(count_array.size(), span.size());
+  for (size_t i = 0; i < count_array.size(); i++) {
+    ASSERT_EQ(span[i], count_array[i]);
+  }
+}
+
 TEST(GeneratedPacketTest, testFixedSizeByteArray) {
   constexpr std::size_t byte_array_size = 32;
   std::array<uint8_t, byte_array_size> byte_array;
@@ -985,6 +997,33 @@ TEST(GeneratedPacketTest, testVectorOfStruct) {
   }
 }
 
+TEST(GeneratedPacketTest, testVectorOfStructSpan) {
+  auto packet_bytes = std::make_shared<std::vector<uint8_t>>(array_or_vector_of_struct);
+  auto view = VectorOfStructView::Create(PacketView<kLittleEndian>(packet_bytes));
+  ASSERT_TRUE(view.IsValid());
+  auto array = view.GetArray();
+  auto span = view.GetArraySpan();
+  ASSERT_EQ(array.size(), span.size());
+  size_t index = 0;
+  for (const auto element : span) {
+    ASSERT_EQ(array[index].id_, element.id_);
+    ASSERT_EQ(array[index].count_, element.count_);
+    index++;
+  }
+  ASSERT_EQ(index, array.size());
+}
+
+TEST(GeneratedPacketTest, testVectorOfStructSpanTruncated) {
+  // The count claims four elements but only two and a half are present.
+  std::vector<uint8_t> truncated(array_or_vector_of_struct.begin(), array_or_vector_of_struct.begin() + 8);
+  auto view = VectorOfStructView::Create(PacketView<kLittleEndian>(std::make_shared<std::vector<uint8_t>>(truncated)));
+  ASSERT_TRUE(view.IsValid());
+  auto span = view.GetArraySpan();
+  ASSERT_EQ(view.GetArray().size(), span.size());
+  ASSERT_EQ(2ul, span.size());
+  ASSERT_EQ(2, span[1].id_);
+}
+
 TEST(GeneratedPacketTest, testArrayOfStruct) {
   std::array<TwoRelatedNumbers, 4> count_array;
   for (uint8_t i = 1; i < 5; i++) {
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace bluetooth {
+namespace packet {
+namespace internal {
+
+// Per-thread cache of freed blocks of one size. Blocks freed on a thread are reused by that thread, whichever thread
+// allocated them, so the cache needs no locking. At most kMaxCachedBlocks are kept, the rest go back to the heap.
+template <size_t BlockSize>
+class BlockCache {
+ public:
+  static constexpr size_t kMaxCachedBlocks = 256;
+
+  static void* Allocate() {
+    if (alive_) {
+      auto& cache = Instance();
+      if (cache.head_ != nullptr) {
+        FreeBlock* block = cache.head_;
+        cache.head_ = block->next;
+        cache.count_--;
+        return block;
+      }
+    }
+    return ::operator new(kAllocationSize);
+  }
+
+  static void Deallocate(void* pointer) {
+    // The cache may already be gone when packets are released while the thread exits
+    if (alive_) {
+      auto& cache = Instance();
+      if (cache.count_ < kMaxCachedBlocks) {
+        FreeBlock* block = static_cast<FreeBlock*>(pointer);
+        block->next = cache.head_;
+        cache.head_ = block;
+        cache.count_++;
+        return;
+      }
+    }
+    ::operator delete(pointer);
+  }
+
+  static size_t CachedBlockCount() {
+    return alive_ ? Instance().count_ : 0;
+  }
+
+ private:
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+  static constexpr size_t kAllocationSize = BlockSize < sizeof(FreeBlock) ? sizeof(FreeBlock) : BlockSize;
+
+  BlockCache() {
+    alive_ = true;
+  }
+
+  ~BlockCache() {
+    alive_ = false;
+    while (head_ != nullptr) {
+      FreeBlock* block = head_;
+      head_ = block->next;
+      ::operator delete(block);
+    }
+  }
+
+  static BlockCache& Instance() {
+    static thread_local BlockCache cache;
+    return cache;
+  }
+
+  // Trivially destructible, so still readable after the cache itself is destroyed at thread exit
+  static thread_local bool alive_;
+
+  FreeBlock* head_ = nullptr;
+  size_t count_ = 0;
+};
+
+// Start out alive so that the first Allocate() on a thread constructs its cache
+template <size_t BlockSize>
+thread_local bool BlockCache<BlockSize>::alive_ = true;
+
+}  // namespace internal
+
+// Allocator for node based containers and shared_ptr control blocks, which allocate one object at a time. Single
+// objects come from a per-thread cache of recycled blocks, anything else from the heap.
+template <typename T>
+class PooledAllocator {
+ public:
+  using value_type = T;
+  static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__, "over-aligned types are not supported");
+
+  PooledAllocator() noexcept = default;
+  template <typename U>
+  PooledAllocator(const PooledAllocator<U>&) noexcept {}
+
+  T* allocate(size_t n) {
+    if (n == 1) {
+      return static_cast<T*>(internal::BlockCache<sizeof(T)>::Allocate());
+    }
+    return static_cast<T*>(::operator new(n * sizeof(T)));
+  }
+
+  void deallocate(T* pointer, size_t n) noexcept {
+    if (n == 1) {
+      internal::BlockCache<sizeof(T)>::Deallocate(pointer);
+      return;
+    }
+    ::operator delete(pointer);
+  }
+
+  template <typename U>
+  bool operator==(const PooledAllocator<U>&) const noexcept {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(const PooledAllocator<U>&) const noexcept {
+    return false;
+  }
+};
+
+}  // namespace packet
+}  // namespace bluetooth
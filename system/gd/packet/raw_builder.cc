@@ -44,6 +44,14 @@ bool RawBuilder::AddOctets(const vector<uint8_t>& bytes) {
   return AddOctets(bytes.size(), bytes);
 }
 
+bool RawBuilder::AddOctets(const uint8_t* data, size_t length) {
+  if (payload_.size() + length > max_bytes_) return false;
+
+  payload_.insert(payload_.end(), data, data + length);
+
+  return true;
+}
+
 bool RawBuilder::AddOctets(size_t octets, uint64_t value) {
   vector<uint8_t> val_vector;
 
@@ -99,9 +107,7 @@ bool RawBuilder::CanAddOctets(size_t num_bytes) const {
 }
 
 void RawBuilder::Serialize(BitInserter& it) const {
-  for (const auto& val : payload_) {
-    insert(val, it);
-  }
+  it.insert_bytes(payload_.data(), payload_.size());
 }
 
 size_t RawBuilder::size() const {
@@ -0,0 +1,46 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "packet/bit_inserter.h"
+#include "packet/scatter_gather_list.h"
+
+namespace bluetooth {
+namespace packet {
+
+// Serializes a builder chain into a ScatterGatherList. Header fields are copied, while payload runs of at least
+// kMinReferenceLength bytes are recorded by reference, so nested builders do not copy their payload at each layer.
+class ScatterGatherInserter : public BitInserter {
+ public:
+  static constexpr size_t kMinReferenceLength = 32;
+
+  explicit ScatterGatherInserter(ScatterGatherList& list);
+
+  void insert_bits(uint8_t byte, size_t num_bits) override;
+
+  void insert_bytes(const uint8_t* data, size_t length) override;
+
+ private:
+  std::vector<uint8_t> to_construct_bit_inserter_;
+  ScatterGatherList& list_;
+};
+
+}  // namespace packet
+}  // namespace bluetooth
@@ -0,0 +1,168 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "packet/scatter_gather_inserter.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <numeric>
+
+#include "packet/fragmenting_inserter.h"
+#include "packet/packet_builder.h"
+#include "packet/raw_builder.h"
+
+namespace bluetooth {
+namespace packet {
+namespace {
+
+// A two byte header in front of a payload builder, standing in for a generated L2CAP or ACL builder.
+class HeaderBuilder : public PacketBuilder<true> {
+ public:
+  HeaderBuilder(uint16_t header, std::unique_ptr<BasePacketBuilder> payload)
+      : header_(header), payload_(std::move(payload)) {}
+
+  size_t size() const override {
+    return sizeof(header_) + payload_->size();
+  }
+
+  void Serialize(BitInserter& it) const override {
+    insert(header_, it);
+    payload_->Serialize(it);
+  }
+
+ private:
+  uint16_t header_;
+  std::unique_ptr<BasePacketBuilder> payload_;
+};
+
+std::vector<uint8_t> CountingPayload(size_t size) {
+  std::vector<uint8_t> payload(size);
+  std::iota(payload.begin(), payload.end(), 0);
+  return payload;
+}
+
+std::vector<uint8_t> Serialize(const BasePacketBuilder& builder) {
+  std::vector<uint8_t> bytes;
+  BitInserter it(bytes);
+  builder.Serialize(it);
+  return bytes;
+}
+
+}  // namespace
+
+TEST(ScatterGatherInserterTest, nested_payload_is_referenced) {
+  auto payload = CountingPayload(200);
+  auto raw = std::make_unique<RawBuilder>(payload);
+  auto inner = std::make_unique<HeaderBuilder>(0x1234, std::move(raw));
+  HeaderBuilder outer(0xabcd, std::move(inner));
+
+  ScatterGatherList list;
+  ScatterGatherInserter it(list);
+  outer.Serialize(it);
+
+  ASSERT_EQ(list.size(), outer.size());
+  ASSERT_EQ(list.GetFragmentCount(), 2ul);
+  auto fragments = list.GetFragments();
+  ASSERT_EQ(fragments[0].size, 4ul);
+  ASSERT_EQ(fragments[1].size, payload.size());
+  ASSERT_EQ(list.Flatten(), Serialize(outer));
+}
+
+TEST(ScatterGatherInserterTest, short_payload_is_copied) {
+  HeaderBuilder builder(0x0102, std::make_unique<RawBuilder>(std::vector<uint8_t>{3, 4, 5}));
+
+  ScatterGatherList list;
+  ScatterGatherInserter it(list);
+  builder.Serialize(it);
+
+  ASSERT_EQ(list.GetFragmentCount(), 1ul);
+  ASSERT_EQ(list.Flatten(), std::vector<uint8_t>({0x02, 0x01, 3, 4, 5}));
+}
+
+TEST(ScatterGatherInserterTest, unaligned_payload_is_copied) {
+  auto payload = CountingPayload(64);
+  RawBuilder raw(payload);
+
+  ScatterGatherList list;
+  ScatterGatherInserter it(list);
+  it.insert_bits(0x1, 4);
+  raw.Serialize(it);
+  it.insert_bits(0x2, 4);
+
+  ASSERT_EQ(list.size(), payload.size() + 1);
+  ASSERT_EQ(list.GetFragmentCount(), 1ul);
+  auto bytes = list.Flatten();
+  ASSERT_EQ(bytes[0], 0x01);
+  ASSERT_EQ(bytes[64], 0x23);
+}
+
+TEST(ScatterGatherInserterTest, observers_see_referenced_bytes) {
+  auto payload = CountingPayload(100);
+  RawBuilder raw(payload);
+
+  ScatterGatherList list;
+  ScatterGatherInserter it(list);
+  std::vector<uint8_t> observed;
+  it.RegisterObserver(ByteObserver([&observed](uint8_t byte) { observed.push_back(byte); }, []() { return 0; }));
+  raw.Serialize(it);
+  it.UnregisterObserver();
+
+  ASSERT_EQ(observed, payload);
+}
+
+TEST(ScatterGatherInserterTest, list_feeds_fragmenting_inserter) {
+  auto payload = CountingPayload(100);
+  HeaderBuilder builder(0x5566, std::make_unique<RawBuilder>(payload));
+
+  ScatterGatherList list;
+  ScatterGatherInserter it(list);
+  builder.Serialize(it);
+
+  std::vector<std::unique_ptr<RawBuilder>> fragments;
+  FragmentingInserter fragmenting_inserter(30, std::back_insert_iterator(fragments));
+  list.Serialize(fragmenting_inserter);
+  fragmenting_inserter.finalize();
+
+  ASSERT_EQ(fragments.size(), 4ul);
+  std::vector<uint8_t> reassembled;
+  for (const auto& fragment : fragments) {
+    ASSERT_LE(fragment->size(), 30ul);
+    auto bytes = Serialize(*fragment);
+    reassembled.insert(reassembled.end(), bytes.begin(), bytes.end());
+  }
+  ASSERT_EQ(reassembled, Serialize(builder));
+}
+
+TEST(ScatterGatherListTest, adjacent_ranges_are_merged) {
+  auto payload = CountingPayload(10);
+  ScatterGatherList list;
+  list.AppendByte(0xff);
+  list.AppendCopy(payload.data(), 2);
+  list.AppendReference(payload.data(), 5);
+  list.AppendReference(payload.data() + 5, 5);
+  list.AppendReference(payload.data(), 0);
+
+  ASSERT_EQ(list.size(), 13ul);
+  ASSERT_EQ(list.GetFragmentCount(), 2ul);
+
+  list.Clear();
+  ASSERT_EQ(list.size(), 0ul);
+  ASSERT_EQ(list.GetFragmentCount(), 0ul);
+}
+
+}  // namespace packet
+}  // namespace bluetooth
@@ -0,0 +1,90 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "packet/scatter_gather_list.h"
+
+namespace bluetooth {
+namespace packet {
+
+void ScatterGatherList::AppendByte(uint8_t byte) {
+  AppendCopy(&byte, 1);
+}
+
+void ScatterGatherList::AppendCopy(const uint8_t* data, size_t length) {
+  if (length == 0) {
+    return;
+  }
+  if (ranges_.empty() || ranges_.back().data != nullptr) {
+    ranges_.push_back({.data = nullptr, .offset = owned_storage_.size(), .size = 0});
+  }
+  owned_storage_.insert(owned_storage_.end(), data, data + length);
+  ranges_.back().size += length;
+  size_ += length;
+}
+
+void ScatterGatherList::AppendReference(const uint8_t* data, size_t length) {
+  if (length == 0) {
+    return;
+  }
+  if (!ranges_.empty() && ranges_.back().data != nullptr && ranges_.back().data + ranges_.back().size == data) {
+    ranges_.back().size += length;
+  } else {
+    ranges_.push_back({.data = data, .offset = 0, .size = length});
+  }
+  size_ += length;
+}
+
+size_t ScatterGatherList::size() const {
+  return size_;
+}
+
+size_t ScatterGatherList::GetFragmentCount() const {
+  return ranges_.size();
+}
+
+std::vector<ScatterGatherList::Fragment> ScatterGatherList::GetFragments() const {
+  std::vector<Fragment> fragments;
+  fragments.reserve(ranges_.size());
+  for (const auto& range : ranges_) {
+    const uint8_t* data = range.data != nullptr ? range.data : owned_storage_.data() + range.offset;
+    fragments.push_back({.data = data, .size = range.size});
+  }
+  return fragments;
+}
+
+std::vector<uint8_t> ScatterGatherList::Flatten() const {
+  std::vector<uint8_t> bytes;
+  bytes.reserve(size_);
+  for (const auto& fragment : GetFragments()) {
+    bytes.insert(bytes.end(), fragment.data, fragment.data + fragment.size);
+  }
+  return bytes;
+}
+
+void ScatterGatherList::Serialize(BitInserter& it) const {
+  for (const auto& fragment : GetFragments()) {
+    it.insert_bytes(fragment.data, fragment.size);
+  }
+}
+
+void ScatterGatherList::Clear() {
+  owned_storage_.clear();
+  ranges_.clear();
+  size_ = 0;
+}
+
+}  // namespace packet
+}  // namespace bluetooth
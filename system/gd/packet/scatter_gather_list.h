@@ -0,0 +1,72 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "packet/bit_inserter.h"
+
+namespace bluetooth {
+namespace packet {
+
+// A serialized packet kept as an ordered list of byte ranges, like an iovec. Header bytes are copied into storage
+// owned by the list. Payload ranges only point at memory owned by the builder that emitted them, so the list must be
+// consumed before that builder is destroyed.
+class ScatterGatherList {
+ public:
+  struct Fragment {
+    const uint8_t* data;
+    size_t size;
+  };
+
+  void AppendByte(uint8_t byte);
+
+  void AppendCopy(const uint8_t* data, size_t length);
+
+  void AppendReference(const uint8_t* data, size_t length);
+
+  size_t size() const;
+
+  size_t GetFragmentCount() const;
+
+  // The returned fragments are invalidated by any further append.
+  std::vector<Fragment> GetFragments() const;
+
+  std::vector<uint8_t> Flatten() const;
+
+  // Copy every fragment into |it|, e.g. to feed a FragmentingInserter.
+  void Serialize(BitInserter& it) const;
+
+  void Clear();
+
+ private:
+  struct Range {
+    // nullptr for ranges of owned_storage_, which may move while the list grows.
+    const uint8_t* data;
+    size_t offset;
+    size_t size;
+  };
+
+  std::vector<uint8_t> owned_storage_;
+  std::vector<Range> ranges_;
+  size_t size_{0};
+};
+
+}  // namespace packet
+}  // namespace bluetooth
@@ -17,9 +17,12 @@
 #pragma once
 
 #include <cstdint>
+#include <forward_list>
 #include <memory>
 #include <vector>
 
+#include "packet/pooled_allocator.h"
+
 namespace bluetooth {
 namespace packet {
 
@@ -35,11 +38,18 @@ class View {
 
   size_t size() const;
 
+  // Contiguous bytes of the view, valid while the view is alive.
+  const uint8_t* data() const;
+
  private:
   std::shared_ptr<const std::vector<uint8_t>> data_;
   size_t begin_;
   size_t end_;
 };
 
+// Fragments making up a PacketView. Views and their iterators copy these lists all the time, so the list nodes
+// come from a per-thread pool instead of the heap.
+using FragmentList = std::forward_list<View, PooledAllocator<View>>;
+
 }  // namespace packet
 }  // namespace bluetooth
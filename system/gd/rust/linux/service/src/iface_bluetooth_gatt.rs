@@ -3,7 +3,7 @@ use bt_topshim::{btif::Uuid128Bit, profiles::gatt::GattStatus};
 use btstack::bluetooth_gatt::{
     BluetoothGattCharacteristic, BluetoothGattDescriptor, BluetoothGattService,
     GattWriteRequestStatus, GattWriteType, IBluetoothGatt, IBluetoothGattCallback,
-    IScannerCallback, LePhy, RSSISettings, ScanFilter, ScanSettings, ScanType,
+    IScannerCallback, LePhy, RSSISettings, ScanFilter, ScanResult, ScanSettings, ScanType,
 };
 use btstack::RPCProxy;
 
@@ -145,6 +145,11 @@ impl IScannerCallback for ScannerCallbackDBus {
     fn on_scanner_registered(&self, status: i32, scanner_id: i32) {
         dbus_generated!()
     }
+
+    #[dbus_method("OnScanResults")]
+    fn on_scan_results(&self, scan_results: Vec<ScanResult>) {
+        dbus_generated!()
+    }
 }
 
 #[dbus_propmap(BluetoothGattDescriptor)]
@@ -186,6 +191,21 @@ struct ScanSettingsDBus {
     window: i32,
     scan_type: ScanType,
     rssi_settings: RSSISettings,
+    report_delay_millis: i32,
+}
+
+#[dbus_propmap(ScanResult)]
+struct ScanResultDBus {
+    address: String,
+    addr_type: u8,
+    event_type: u16,
+    primary_phy: u8,
+    secondary_phy: u8,
+    advertising_sid: u8,
+    tx_power: i32,
+    rssi: i32,
+    periodic_adv_int: u16,
+    adv_data: Vec<u8>,
 }
 
 impl_dbus_arg_enum!(GattStatus);
@@ -6,7 +6,7 @@ use bt_topshim::btif::{
     BtScanMode, BtSspVariant, BtState, BtStatus, BtTransport, RawAddress, Uuid, Uuid128Bit,
 };
 use bt_topshim::{
-    profiles::hid_host::{HHCallbacksDispatcher, HidHost},
+    profiles::hid_host::{BthhConnectionState, HHCallbacks, HHCallbacksDispatcher, HidHost},
     profiles::sdp::{BtSdpRecord, Sdp, SdpCallbacks, SdpCallbacksDispatcher},
     topstack,
 };
@@ -15,7 +15,7 @@ use btif_macros::{btif_callback, btif_callbacks_dispatcher};
 
 use log::{debug, warn};
 use num_traits::cast::ToPrimitive;
-use std::collections::HashMap;
+use std::collections::{HashMap, HashSet};
 use std::sync::Arc;
 use std::sync::Mutex;
 use std::time::Duration;
@@ -300,6 +300,7 @@ pub struct Bluetooth {
     connection_callbacks: HashMap<u32, Box<dyn IBluetoothConnectionCallback + Send>>,
     discovering_started: Instant,
     hh: Option<HidHost>,
+    hid_connections: HashSet<RawAddress>,
     is_connectable: bool,
     is_discovering: bool,
     local_address: Option<RawAddress>,
@@ -327,6 +328,7 @@ impl Bluetooth {
             callbacks: HashMap::new(),
             connection_callbacks: HashMap::new(),
             hh: None,
+            hid_connections: HashSet::new(),
             bluetooth_media,
             discovering_started: Instant::now(),
             intf,
@@ -418,6 +420,46 @@ impl Bluetooth {
         )) == 0
     }
 
+    pub fn dispatch_hid_host_callbacks(&mut self, cb: HHCallbacks) {
+        match cb {
+            HHCallbacks::ConnectionState(addr, state) => match state {
+                BthhConnectionState::Connected => {
+                    self.hid_connections.insert(addr);
+                }
+                BthhConnectionState::Disconnected => {
+                    self.hid_connections.remove(&addr);
+                }
+                _ => (),
+            },
+            // TODO(abps) - Handle the other hid host callbacks
+            _ => debug!("Received HH callback"),
+        }
+    }
+
+    /// Returns the HID devices currently connected.
+    pub(crate) fn get_hid_connections(&self) -> Vec<RawAddress> {
+        self.hid_connections.iter().cloned().collect()
+    }
+
+    pub(crate) fn connect_hid(&self, addr: &RawAddress) -> bool {
+        match self.hh.as_ref() {
+            Some(hh) => hh.connect(&mut addr.clone()) == BtStatus::Success,
+            None => false,
+        }
+    }
+
+    pub(crate) fn disconnect_hid(&self, addr: &RawAddress) -> bool {
+        match self.hh.as_ref() {
+            Some(hh) => hh.disconnect(&mut addr.clone()) == BtStatus::Success,
+            None => false,
+        }
+    }
+
+    /// Lets the controller report all events again, such as incoming connection requests.
+    pub(crate) fn clear_event_filter(&self) -> bool {
+        self.intf.lock().unwrap().clear_event_filter() == 0
+    }
+
     pub(crate) fn callback_disconnected(&mut self, id: u32, cb_type: BluetoothCallbackType) {
         match cb_type {
             BluetoothCallbackType::Adapter => {
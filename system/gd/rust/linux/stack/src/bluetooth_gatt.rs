@@ -5,7 +5,7 @@ use btif_macros::{btif_callback, btif_callbacks_dispatcher};
 use bt_topshim::bindings::root::bluetooth::Uuid;
 use bt_topshim::btif::{BluetoothInterface, RawAddress, Uuid128Bit};
 use bt_topshim::profiles::gatt::{
-    BtGattDbElement, BtGattNotifyParams, BtGattReadParams, Gatt, GattClientCallbacks,
+    BtGattDbElement, BtGattNotification, BtGattReadParams, Gatt, GattClientCallbacks,
     GattClientCallbacksDispatcher, GattScannerCallbacksDispatcher, GattServerCallbacksDispatcher,
     GattStatus,
 };
@@ -13,8 +13,9 @@ use bt_topshim::topstack;
 
 use log::{debug, warn};
 use num_traits::cast::{FromPrimitive, ToPrimitive};
-use std::collections::HashSet;
+use std::collections::{HashMap, HashSet};
 use std::sync::{Arc, Mutex};
+use std::time::{Duration, Instant};
 use tokio::sync::mpsc::Sender;
 
 use crate::{Message, RPCProxy};
@@ -404,6 +405,9 @@ pub trait IBluetoothGattCallback: RPCProxy {
 pub trait IScannerCallback {
     /// When the `register_scanner` request is done.
     fn on_scanner_registered(&self, status: i32, scanner_id: i32);
+
+    /// When scan results were received, at most once per `ScanSettings::report_delay_millis`.
+    fn on_scan_results(&self, scan_results: Vec<ScanResult>);
 }
 
 #[derive(Debug, FromPrimitive, ToPrimitive)]
@@ -472,6 +476,75 @@ pub struct ScanSettings {
     pub window: i32,
     pub scan_type: ScanType,
     pub rssi_settings: RSSISettings,
+    /// Interval between two batches of scan results, or 0 for the default one.
+    pub report_delay_millis: i32,
+}
+
+/// Represents a LE scan result, passed to `IScannerCallback::on_scan_results`.
+#[derive(Debug, Clone, Default, PartialEq)]
+pub struct ScanResult {
+    pub address: String,
+    pub addr_type: u8,
+    pub event_type: u16,
+    pub primary_phy: u8,
+    pub secondary_phy: u8,
+    pub advertising_sid: u8,
+    pub tx_power: i32,
+    pub rssi: i32,
+    pub periodic_adv_int: u16,
+    pub adv_data: Vec<u8>,
+}
+
+const DEFAULT_SCAN_RESULT_REPORT_DELAY: Duration = Duration::from_millis(500);
+
+/// Batches the scan results of a scanner into one callback per interval.
+///
+/// In a dense environment each device advertises many times per second, and a D-Bus message per
+/// advertisement and per scanner overwhelms the bus. Within an interval, a device is reported
+/// only once, with its latest result, at the position it was first seen.
+pub struct ScanResultBatcher {
+    report_delay: Duration,
+    last_report: Instant,
+    results: Vec<ScanResult>,
+    index_by_address: HashMap<String, usize>,
+}
+
+impl ScanResultBatcher {
+    pub fn new(report_delay_millis: i32, now: Instant) -> ScanResultBatcher {
+        let report_delay = match report_delay_millis {
+            delay if delay > 0 => Duration::from_millis(delay as u64),
+            _ => DEFAULT_SCAN_RESULT_REPORT_DELAY,
+        };
+
+        ScanResultBatcher {
+            report_delay,
+            last_report: now,
+            results: vec![],
+            index_by_address: HashMap::new(),
+        }
+    }
+
+    /// Adds a result to the current batch, replacing an earlier one from the same device.
+    pub fn add(&mut self, result: ScanResult) {
+        match self.index_by_address.get(&result.address) {
+            Some(&index) => self.results[index] = result,
+            None => {
+                self.index_by_address.insert(result.address.clone(), self.results.len());
+                self.results.push(result);
+            }
+        }
+    }
+
+    /// Returns the current batch and starts a new one if it is due and not empty.
+    pub fn take_due(&mut self, now: Instant) -> Option<Vec<ScanResult>> {
+        if self.results.is_empty() || now.duration_since(self.last_report) < self.report_delay {
+            return None;
+        }
+
+        self.last_report = now;
+        self.index_by_address.clear();
+        Some(std::mem::take(&mut self.results))
+    }
 }
 
 /// Represents a scan filter to be passed to `IBluetoothGatt::start_scan`.
@@ -908,7 +981,7 @@ pub(crate) trait BtifGattClientCallbacks {
     );
 
     #[btif_callback(Notify)]
-    fn notify_cb(&mut self, conn_id: i32, data: BtGattNotifyParams);
+    fn notify_cb(&mut self, conn_id: i32, data: BtGattNotification);
 
     #[btif_callback(ReadCharacteristic)]
     fn read_characteristic_cb(&mut self, conn_id: i32, status: i32, data: BtGattReadParams);
@@ -1039,16 +1112,16 @@ impl BtifGattClientCallbacks for BluetoothGatt {
         // No-op.
     }
 
-    fn notify_cb(&mut self, conn_id: i32, data: BtGattNotifyParams) {
+    fn notify_cb(&mut self, conn_id: i32, data: BtGattNotification) {
         let client = self.context_map.get_client_by_conn_id(conn_id);
         if client.is_none() {
             return;
         }
 
         client.unwrap().callback.on_notify(
-            RawAddress { val: data.bda.address }.to_string(),
+            data.address.to_string(),
             data.handle as i32,
-            data.value[0..data.len as usize].to_vec(),
+            data.value,
         );
     }
 
@@ -1478,6 +1551,40 @@ mod tests {
         assert_eq!(Uuid { uu: expected }, uuid.unwrap());
     }
 
+    fn make_scan_result(address: &str, rssi: i32) -> ScanResult {
+        ScanResult { address: String::from(address), rssi, ..Default::default() }
+    }
+
+    #[test]
+    fn test_scan_result_batcher() {
+        let start = Instant::now();
+        let mut batcher = ScanResultBatcher::new(100, start);
+
+        batcher.add(make_scan_result("aa:bb:cc:dd:ee:ff", -80));
+        batcher.add(make_scan_result("11:22:33:44:55:66", -70));
+        batcher.add(make_scan_result("aa:bb:cc:dd:ee:ff", -60));
+        assert!(batcher.take_due(start + Duration::from_millis(99)).is_none());
+
+        // One result per device, the latest one, in the order devices were first seen.
+        let batch = batcher.take_due(start + Duration::from_millis(100)).unwrap();
+        assert_eq!(
+            vec![
+                make_scan_result("aa:bb:cc:dd:ee:ff", -60),
+                make_scan_result("11:22:33:44:55:66", -70)
+            ],
+            batch
+        );
+
+        // The next batch is due one interval after this one.
+        batcher.add(make_scan_result("aa:bb:cc:dd:ee:ff", -50));
+        assert!(batcher.take_due(start + Duration::from_millis(150)).is_none());
+        let batch = batcher.take_due(start + Duration::from_millis(200)).unwrap();
+        assert_eq!(vec![make_scan_result("aa:bb:cc:dd:ee:ff", -50)], batch);
+
+        // Nothing is sent without results.
+        assert!(batcher.take_due(start + Duration::from_millis(400)).is_none());
+    }
+
     #[test]
     fn test_context_map_clients() {
         let mut map = ContextMap::new();
@@ -25,7 +25,10 @@ use bt_topshim::{
     btif::BaseCallbacks,
     profiles::{
         a2dp::A2dpCallbacks, avrcp::AvrcpCallbacks, gatt::GattClientCallbacks,
-        gatt::GattServerCallbacks, hfp::HfpCallbacks, hid_host::HHCallbacks, sdp::SdpCallbacks,
+        gatt::GattServerCallbacks,
+        hfp::HfpCallbacks,
+        hid_host::{BthhConnectionState, HHCallbacks},
+        sdp::SdpCallbacks,
     },
 };
 
@@ -59,6 +62,8 @@ pub enum Message {
     // Suspend related
     SuspendCallbackRegistered(u32),
     SuspendCallbackDisconnected(u32),
+    SuspendReady(u32),
+    ResumeReady(u32),
 }
 
 /// Umbrella class for the Bluetooth stack.
@@ -112,9 +117,11 @@ impl Stack {
                     bluetooth_media.lock().unwrap().dispatch_hfp_callbacks(hf);
                 }
 
-                Message::HidHost(_h) => {
-                    // TODO(abps) - Handle hid host callbacks
-                    debug!("Received HH callback");
+                Message::HidHost(h) => {
+                    if let HHCallbacks::ConnectionState(addr, BthhConnectionState::Connected) = &h {
+                        suspend.lock().unwrap().hid_connected(*addr);
+                    }
+                    bluetooth.lock().unwrap().dispatch_hid_host_callbacks(h);
                 }
 
                 Message::Sdp(s) => {
@@ -140,6 +147,14 @@ impl Stack {
                 Message::SuspendCallbackDisconnected(id) => {
                     suspend.lock().unwrap().remove_callback(id);
                 }
+
+                Message::SuspendReady(suspend_id) => {
+                    suspend.lock().unwrap().suspend_ready(suspend_id);
+                }
+
+                Message::ResumeReady(suspend_id) => {
+                    suspend.lock().unwrap().resumed(suspend_id);
+                }
             }
         }
     }
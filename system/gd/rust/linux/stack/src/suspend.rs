@@ -1,8 +1,12 @@
 //! Suspend/Resume API.
 
+use crate::bluetooth::{Bluetooth, IBluetooth};
 use crate::{Message, RPCProxy};
-use log::warn;
-use std::collections::HashMap;
+use bt_topshim::btif::RawAddress;
+use log::{info, warn};
+use std::collections::{HashMap, HashSet};
+use std::sync::{Arc, Mutex};
+use std::time::Instant;
 use tokio::sync::mpsc::Sender;
 
 /// Defines the Suspend/Resume API.
@@ -26,12 +30,12 @@ pub trait ISuspend {
     ///
     /// Returns a positive number identifying the suspend if it can be started. If there is already
     /// a suspend, that active suspend id is returned.
-    fn suspend(&self, suspend_type: SuspendType) -> u32;
+    fn suspend(&mut self, suspend_type: SuspendType) -> u32;
 
     /// Undoes previous suspend preparation identified by `suspend_id`.
     ///
     /// Returns true if suspend can be resumed, and false if there is no suspend to resume.
-    fn resume(&self) -> bool;
+    fn resume(&mut self) -> bool;
 }
 
 /// Suspend events.
@@ -54,15 +58,39 @@ pub enum SuspendType {
     Other,
 }
 
+/// State of the stack saved on suspend, to be restored on resume.
+struct SuspendState {
+    id: u32,
+    discovering: bool,
+    hid_devices: Vec<RawAddress>,
+}
+
 /// Implementation of the suspend API.
+///
+/// Suspend leaves the controller state that does not wake the system as it is, such as the LE
+/// background connections in the accept list, so that resume does not need to rebuild it. Resume
+/// reconnects HID devices before anything else, since keyboards and mice are what users wait for,
+/// and issues all its commands at once rather than waiting for each of them to complete.
 pub struct Suspend {
+    bluetooth: Arc<Mutex<Box<Bluetooth>>>,
     tx: Sender<Message>,
     callbacks: HashMap<u32, Box<dyn ISuspendCallback + Send>>,
+    last_suspend_id: u32,
+    suspend_state: Option<SuspendState>,
+    /// HID devices reconnecting since the resume started at the given time.
+    pending_hid_input: Option<(Instant, HashSet<RawAddress>)>,
 }
 
 impl Suspend {
-    pub fn new(tx: Sender<Message>) -> Suspend {
-        Self { tx, callbacks: HashMap::new() }
+    pub fn new(tx: Sender<Message>, bluetooth: Arc<Mutex<Box<Bluetooth>>>) -> Suspend {
+        Self {
+            bluetooth,
+            tx,
+            callbacks: HashMap::new(),
+            last_suspend_id: 0,
+            suspend_state: None,
+            pending_hid_input: None,
+        }
     }
 
     pub(crate) fn callback_registered(&mut self, id: u32) {
@@ -82,6 +110,47 @@ impl Suspend {
             None => false,
         }
     }
+
+    pub(crate) fn suspend_ready(&self, suspend_id: u32) {
+        for (_, callback) in self.callbacks.iter() {
+            callback.on_suspend_ready(suspend_id);
+        }
+    }
+
+    pub(crate) fn resumed(&self, suspend_id: u32) {
+        for (_, callback) in self.callbacks.iter() {
+            callback.on_resumed(suspend_id);
+        }
+    }
+
+    /// Reports the resume to input latency once a HID device reconnected after resume.
+    pub(crate) fn hid_connected(&mut self, addr: RawAddress) {
+        let all_connected = match self.pending_hid_input.as_mut() {
+            Some((resume_started, pending)) => {
+                if !pending.remove(&addr) {
+                    return;
+                }
+                info!(
+                    "HID [{}] ready for input {} ms after resume",
+                    addr.to_string(),
+                    resume_started.elapsed().as_millis()
+                );
+                pending.is_empty()
+            }
+            None => return,
+        };
+
+        if all_connected {
+            self.pending_hid_input = None;
+        }
+    }
+
+    fn send_message(&self, message: Message) {
+        let tx = self.tx.clone();
+        tokio::spawn(async move {
+            let _result = tx.send(message).await;
+        });
+    }
 }
 
 impl ISuspend for Suspend {
@@ -108,11 +177,71 @@ impl ISuspend for Suspend {
         self.remove_callback(callback_id)
     }
 
-    fn suspend(&self, _suspend_type: SuspendType) -> u32 {
-        todo!()
+    fn suspend(&mut self, suspend_type: SuspendType) -> u32 {
+        if let Some(state) = &self.suspend_state {
+            return state.id;
+        }
+
+        self.last_suspend_id = self.last_suspend_id.checked_add(1).unwrap_or(1);
+        self.pending_hid_input = None;
+
+        let bluetooth = self.bluetooth.lock().unwrap();
+        let discovering = bluetooth.is_discovering();
+        if discovering {
+            bluetooth.cancel_discovery();
+        }
+
+        let hid_devices = bluetooth.get_hid_connections();
+        match suspend_type {
+            // HID devices are the wake sources, they must not be able to reach the host
+            SuspendType::NoWakesAllowed => {
+                for addr in hid_devices.iter() {
+                    bluetooth.disconnect_hid(addr);
+                }
+            }
+            // Keeping the links makes input available right on resume
+            SuspendType::AllowWakeFromHid | SuspendType::Other => (),
+        }
+        drop(bluetooth);
+
+        let id = self.last_suspend_id;
+        self.suspend_state = Some(SuspendState { id, discovering, hid_devices });
+        self.send_message(Message::SuspendReady(id));
+        id
     }
 
-    fn resume(&self) -> bool {
-        todo!()
+    fn resume(&mut self) -> bool {
+        let state = match self.suspend_state.take() {
+            Some(state) => state,
+            None => return false,
+        };
+        let resume_started = Instant::now();
+
+        let bluetooth = self.bluetooth.lock().unwrap();
+        let connected: HashSet<RawAddress> = bluetooth.get_hid_connections().into_iter().collect();
+        let mut pending = HashSet::new();
+        for addr in state.hid_devices.iter().filter(|addr| !connected.contains(addr)) {
+            if bluetooth.connect_hid(addr) {
+                pending.insert(*addr);
+            } else {
+                warn!("Unable to reconnect HID [{}] on resume", addr.to_string());
+            }
+        }
+        bluetooth.clear_event_filter();
+        if state.discovering {
+            bluetooth.start_discovery();
+        }
+        drop(bluetooth);
+
+        if pending.is_empty() {
+            if !state.hid_devices.is_empty() {
+                info!("HID ready for input on resume, kept connected during suspend");
+            }
+        } else {
+            self.pending_hid_input = Some((resume_started, pending));
+        }
+
+        self.send_message(Message::ResumeReady(state.id));
+        true
     }
 }
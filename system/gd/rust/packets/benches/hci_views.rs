@@ -0,0 +1,177 @@
+//
+//  Copyright 2026 The Android Open Source Project
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at:
+//
+//  http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+//! Time the dispatch of HCI event and ACL streams with the owned packets
+//! (XxxPacket::parse) against the borrowed views (XxxView::parse).
+//!
+//! cargo bench --bench hci_views
+
+use bt_packets::custom_types::Address;
+use bt_packets::hci::*;
+use bytes::Bytes;
+use std::convert::TryFrom;
+use std::hint::black_box;
+use std::time::Instant;
+
+const ROUNDS: usize = 20000;
+
+fn event_stream() -> Vec<Vec<u8>> {
+    let address = Address { bytes: [0x11, 0x22, 0x33, 0x44, 0x55, 0x66] };
+    let events: Vec<EventPacket> = vec![
+        NumberOfCompletedPacketsBuilder {
+            completed_packets: vec![CompletedPackets {
+                connection_handle: 0x1,
+                host_num_of_completed_packets: 4,
+            }],
+        }
+        .into(),
+        ReadBdAddrCompleteBuilder {
+            num_hci_command_packets: 1,
+            status: ErrorCode::Success,
+            bd_addr: address,
+        }
+        .into(),
+        DisconnectionCompleteBuilder {
+            status: ErrorCode::Success,
+            connection_handle: 0x1,
+            reason: ErrorCode::RemoteUserTerminatedConnection,
+        }
+        .into(),
+        LeConnectionUpdateCompleteBuilder {
+            status: ErrorCode::Success,
+            connection_handle: 0x1,
+            conn_interval: 0x18,
+            conn_latency: 0,
+            supervision_timeout: 0x48,
+        }
+        .into(),
+    ];
+    events.into_iter().map(|event| event.to_vec()).collect()
+}
+
+fn acl_stream() -> Vec<Vec<u8>> {
+    [27, 251, 1021]
+        .iter()
+        .map(|&size| {
+            AclBuilder {
+                handle: 0x1,
+                packet_boundary_flag: PacketBoundaryFlag::FirstAutomaticallyFlushable,
+                broadcast_flag: BroadcastFlag::PointToPoint,
+                payload: Some(Bytes::from(vec![0x5a; size])),
+            }
+            .build()
+            .to_vec()
+        })
+        .collect()
+}
+
+fn owned_event(bytes: &[u8]) -> usize {
+    match EventPacket::parse(bytes).unwrap().specialize() {
+        EventChild::NumberOfCompletedPackets(event) => event.get_completed_packets().len(),
+        EventChild::CommandComplete(event) => match event.specialize() {
+            CommandCompleteChild::ReadBdAddrComplete(event) => {
+                event.get_bd_addr().bytes[0] as usize
+            }
+            _ => 0,
+        },
+        EventChild::DisconnectionComplete(event) => event.get_connection_handle() as usize,
+        EventChild::LeMetaEvent(event) => match event.specialize() {
+            LeMetaEventChild::LeConnectionUpdateComplete(event) => {
+                event.get_conn_interval() as usize
+            }
+            _ => 0,
+        },
+        _ => 0,
+    }
+}
+
+fn view_event(bytes: &[u8]) -> usize {
+    match EventView::parse(bytes).unwrap().specialize().unwrap() {
+        EventViewChild::NumberOfCompletedPackets(event) => {
+            event.get_completed_packets().unwrap().len()
+        }
+        EventViewChild::CommandComplete(event) => match event.specialize().unwrap() {
+            CommandCompleteViewChild::ReadBdAddrComplete(event) => {
+                event.get_bd_addr().bytes[0] as usize
+            }
+            _ => 0,
+        },
+        EventViewChild::DisconnectionComplete(event) => event.get_connection_handle() as usize,
+        EventViewChild::LeMetaEvent(event) => match event.specialize().unwrap() {
+            LeMetaEventViewChild::LeConnectionUpdateComplete(event) => {
+                event.get_conn_interval() as usize
+            }
+            _ => 0,
+        },
+        _ => 0,
+    }
+}
+
+fn owned_acl(bytes: &[u8]) -> usize {
+    let acl = AclPacket::parse(bytes).unwrap();
+    match acl.specialize() {
+        AclChild::Payload(payload) => acl.get_handle() as usize + payload.len(),
+        AclChild::None => acl.get_handle() as usize,
+    }
+}
+
+fn view_acl(bytes: &[u8]) -> usize {
+    let acl = AclView::parse(bytes).unwrap();
+    acl.get_handle() as usize + acl.get_payload().len()
+}
+
+fn bench(name: &str, stream: &[Vec<u8>], dispatch: fn(&[u8]) -> usize) {
+    let mut sum = 0;
+    let start = Instant::now();
+    for _ in 0..ROUNDS {
+        for packet in stream {
+            sum += dispatch(black_box(packet));
+        }
+    }
+    let elapsed = start.elapsed();
+    black_box(sum);
+    println!(
+        "{:<8} {:>10.1} ns/packet",
+        name,
+        elapsed.as_nanos() as f64 / (ROUNDS * stream.len()) as f64
+    );
+}
+
+fn main() {
+    let events = event_stream();
+    let acls = acl_stream();
+
+    // Both representations see the same packets.
+    for event in &events {
+        assert_eq!(owned_event(event), view_event(event));
+        let view = EventView::parse(event).unwrap();
+        assert_eq!(view.to_packet().unwrap().to_vec(), *event);
+    }
+    for acl in &acls {
+        assert_eq!(owned_acl(acl), view_acl(acl));
+        let mut buffer = vec![0; acl.len()];
+        let packet = AclView::parse(acl).unwrap().to_packet().unwrap();
+        assert_eq!(packet.write_to_slice(&mut buffer).unwrap(), acl.len());
+        assert_eq!(buffer, *acl);
+    }
+    assert!(DisconnectionCompleteView::try_from(EventView::parse(&events[2]).unwrap()).is_ok());
+
+    println!("HCI events ({} packets)", events.len());
+    bench("owned", &events, owned_event);
+    bench("view", &events, view_event);
+    println!("ACL ({} packets)", acls.len());
+    bench("owned", &acls, owned_acl);
+    bench("view", &acls, view_acl);
+}
@@ -66,6 +66,7 @@ fn generate_packets() {
             .arg("--out=".to_owned() + out_dir.as_os_str().to_str().unwrap())
             .arg("--include=bt/gd")
             .arg("--rust")
+            .arg("--rust_views")
             .arg(input_files[i].as_os_str().to_str().unwrap())
             .output()
             .unwrap();
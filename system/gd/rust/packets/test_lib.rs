@@ -48,6 +48,7 @@ pub mod test_packets {
 #[cfg(test)]
 pub mod test {
     use crate::test_packets::*;
+    use std::convert::TryFrom;
 
     #[test]
     fn test_invalid_enum_field_value() {
@@ -98,4 +99,81 @@ pub mod test {
         let res = TestBodySizePacket::parse(&input);
         assert!(res.is_ok());
     }
+
+    #[test]
+    fn test_view_invalid_enum_field_value() {
+        let input = [0x0];
+        assert!(TestEnumView::parse(&input).is_err());
+        let input = [0x2];
+        assert_eq!(TestEnumView::parse(&input).unwrap().get_v(), Enum::Two);
+    }
+
+    #[test]
+    fn test_view_invalid_payload_size() {
+        // Size 2, have 1.
+        let input = [0x2, 0x0];
+        assert!(TestPayloadSizeView::parse(&input).is_err());
+    }
+
+    #[test]
+    fn test_view_array_is_parsed_on_access() {
+        let input = [0x2, 0x1, 0x7];
+        let view = TestArraySizeView::parse(&input).unwrap();
+        let array = view.get_array().unwrap();
+        assert_eq!(array.len(), 1);
+        assert_eq!(array[0].u, 0x7);
+
+        // The bounds are checked by parse(), the content by the accessor.
+        let input = [0x2, 0x0, 0x7];
+        let view = TestArraySizeView::parse(&input).unwrap();
+        assert!(view.get_array().is_err());
+    }
+
+    #[test]
+    fn test_view_payload_is_borrowed() {
+        let input = [0x5, 0x2, 0xaa, 0xbb, 0xcc];
+        let view = CommandView::parse(&input).unwrap();
+        assert_eq!(view.get_op_code(), OpCode::Sub);
+        assert_eq!(view.get_payload(), &[0xaa, 0xbb]);
+        assert_eq!(view.get_payload().as_ptr(), input[2..].as_ptr());
+    }
+
+    #[test]
+    fn test_view_specialize() {
+        let input = [0x5, 0x0];
+        let view = CommandView::parse(&input).unwrap();
+        match view.specialize().unwrap() {
+            CommandViewChild::ComputeCommand(compute) => match compute.specialize().unwrap() {
+                ComputeCommandViewChild::SubCommand(sub) => {
+                    assert_eq!(sub.get_op_code(), OpCode::Sub);
+                    assert_eq!(sub.as_bytes(), &input);
+                }
+                child => panic!("unexpected {:?}", child),
+            },
+            child => panic!("unexpected {:?}", child),
+        }
+
+        let sub = SubCommandView::try_from(view).unwrap();
+        let command: CommandView = sub.into();
+        assert_eq!(command.get_op_code(), OpCode::Sub);
+        assert!(AddCommandView::try_from(view).is_err());
+    }
+
+    #[test]
+    fn test_view_to_packet() {
+        let input = [0x5, 0x0];
+        let view = SubCommandView::try_from(CommandView::parse(&input).unwrap()).unwrap();
+        let packet = view.to_packet().unwrap();
+        assert_eq!(packet.get_op_code(), OpCode::Sub);
+        assert_eq!(&packet.to_bytes()[..], &input);
+    }
+
+    #[test]
+    fn test_write_to_slice() {
+        let packet: CommandPacket = SubCommandBuilder {}.into();
+        let mut buffer = [0xff; 3];
+        assert!(packet.write_to_slice(&mut buffer[..1]).is_err());
+        assert_eq!(packet.write_to_slice(&mut buffer).unwrap(), 2);
+        assert_eq!(buffer, [0x5, 0x0, 0xff]);
+    }
 }
@@ -1061,7 +1061,22 @@ pub fn get_btinterface() -> Option<BluetoothInterface> {
 
 // Turns C-array T[] to Vec<U>.
 pub(crate) fn ptr_to_vec<T: Copy, U: From<T>>(start: *const T, length: usize) -> Vec<U> {
-    unsafe { (0..length).map(|i| U::from(*start.offset(i as isize))).collect::<Vec<U>>() }
+    unsafe { ptr_to_slice(start, length) }.iter().map(|&x| U::from(x)).collect::<Vec<U>>()
+}
+
+/// Borrows C-array T[] without copying it.
+///
+/// Buffers passed to callbacks are only valid until the callback returns, so the returned slice
+/// must not outlive the callback. Anything dispatched from there has to own its data, which is
+/// best done with a single `to_vec()` of the slice (or a `ptr_to_vec`).
+///
+/// # Safety
+/// `start` must point to `length` initialized elements that stay valid and unchanged for `'a`.
+pub(crate) unsafe fn ptr_to_slice<'a, T>(start: *const T, length: usize) -> &'a [T] {
+    if start.is_null() || length == 0 {
+        return &[];
+    }
+    std::slice::from_raw_parts(start, length)
 }
 
 #[cfg(test)]
@@ -1123,6 +1138,20 @@ mod tests {
         let vec: Vec<i32> = ptr_to_vec(arr.as_ptr(), arr.len());
         let expected: Vec<i32> = vec![1, 2, 3];
         assert_eq!(expected, vec);
+
+        let empty: Vec<i32> = ptr_to_vec(std::ptr::null::<i32>(), 0);
+        assert!(empty.is_empty());
+    }
+
+    #[test]
+    fn test_ptr_to_slice() {
+        let arr: [u8; 4] = [1, 2, 3, 4];
+        let slice = unsafe { ptr_to_slice(arr.as_ptr(), 2) };
+        assert_eq!(&[1, 2], slice);
+        assert_eq!(arr.as_ptr(), slice.as_ptr());
+
+        let empty: &[u8] = unsafe { ptr_to_slice(std::ptr::null::<u8>(), 3) };
+        assert!(empty.is_empty());
     }
 
     #[test]
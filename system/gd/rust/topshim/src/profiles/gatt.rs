@@ -447,6 +447,30 @@ pub enum GattStatus {
     OutOfRange = 0xFF,
 }
 
+/// Attribute change notification.
+///
+/// `BtGattNotifyParams` always carries a full `BTGATT_MAX_ATTR_LEN` buffer. Only the `len` bytes
+/// actually received are copied out of it, once, while the callback still owns the buffer.
+#[derive(Debug, Clone)]
+pub struct BtGattNotification {
+    pub address: RawAddress,
+    pub handle: u16,
+    pub is_notify: bool,
+    pub value: Vec<u8>,
+}
+
+impl From<&BtGattNotifyParams> for BtGattNotification {
+    fn from(params: &BtGattNotifyParams) -> Self {
+        let len = std::cmp::min(params.len as usize, params.value.len());
+        BtGattNotification {
+            address: RawAddress { val: params.bda.address },
+            handle: params.handle,
+            is_notify: params.is_notify != 0,
+            value: params.value[0..len].to_vec(),
+        }
+    }
+}
+
 #[derive(Debug)]
 pub enum GattClientCallbacks {
     RegisterClient(i32, i32, Uuid),
@@ -454,7 +478,7 @@ pub enum GattClientCallbacks {
     Disconnect(i32, i32, i32, RawAddress),
     SearchComplete(i32, i32),
     RegisterForNotification(i32, i32, i32, u16),
-    Notify(i32, BtGattNotifyParams),
+    Notify(i32, BtGattNotification),
     ReadCharacteristic(i32, i32, BtGattReadParams),
     WriteCharacteristic(i32, i32, u16, u16, *const u8),
     ReadDescriptor(i32, i32, BtGattReadParams),
@@ -541,7 +565,7 @@ cb_variant!(
     GattClientCb,
     gc_notify_cb -> GattClientCallbacks::Notify,
     i32, *const BtGattNotifyParams, {
-        let _1 = unsafe { *_1.clone() };
+        let _1 = BtGattNotification::from(unsafe { &*_1 });
     }
 );
 
@@ -1657,6 +1681,8 @@ impl Gatt {
             // TODO(b/200073464): Remove these.
             services_removed_cb: None,
             services_added_cb: None,
+            // Notifications are delivered one by one through notify_cb.
+            notify_batch_cb: None,
         });
 
         let mut gatt_server_callbacks = Box::new(btgatt_server_callbacks_t {
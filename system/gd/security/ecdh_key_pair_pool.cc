@@ -0,0 +1,65 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "security/ecdh_key_pair_pool.h"
+
+#include "os/log.h"
+
+namespace bluetooth {
+namespace security {
+
+EcdhKeyPairPool::EcdhKeyPairPool(os::Handler* handler, size_t size) : handler_(handler), size_(size) {
+  refill_scheduled_ = true;
+  handler_->CallOn(this, &EcdhKeyPairPool::Refill);
+}
+
+std::pair<std::array<uint8_t, 32>, EcdhPublicKey> EcdhKeyPairPool::Take() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (!refill_scheduled_) {
+    refill_scheduled_ = true;
+    handler_->CallOn(this, &EcdhKeyPairPool::Refill);
+  }
+
+  if (key_pairs_.empty()) {
+    lock.unlock();
+    LOG_INFO("No precomputed key pair left, generating one");
+    return GenerateECDHKeyPair();
+  }
+
+  auto key_pair = std::move(key_pairs_.front());
+  key_pairs_.pop_front();
+  return key_pair;
+}
+
+size_t EcdhKeyPairPool::GetAvailableCount() const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  return key_pairs_.size();
+}
+
+void EcdhKeyPairPool::Refill() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (key_pairs_.size() < size_) {
+    // Generate without the lock, so that Take() does not wait for the point multiplication
+    lock.unlock();
+    auto key_pair = GenerateECDHKeyPair();
+    lock.lock();
+    key_pairs_.push_back(std::move(key_pair));
+  }
+  refill_scheduled_ = false;
+}
+
+}  // namespace security
+}  // namespace bluetooth
@@ -0,0 +1,61 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+#include "os/handler.h"
+#include "security/ecdh_keys.h"
+
+namespace bluetooth {
+namespace security {
+
+/* Local ECDH key pairs generated ahead of LE Secure Connections pairing.
+ *
+ * A key pair costs a P-256 point multiplication. The pool generates them on |handler| while no pairing is waiting, so
+ * the public key exchange can start right away. Each key pair is handed out once, and the pool refills behind every
+ * Take(), so that no key pair is reused across pairings.
+ */
+class EcdhKeyPairPool {
+ public:
+  static constexpr size_t kDefaultSize = 2;
+
+  EcdhKeyPairPool(os::Handler* handler, size_t size = kDefaultSize);
+  EcdhKeyPairPool(const EcdhKeyPairPool&) = delete;
+  EcdhKeyPairPool& operator=(const EcdhKeyPairPool&) = delete;
+
+  /* Takes a key pair out of the pool, or generates one if it ran dry. Can be called from any thread. */
+  std::pair<std::array<uint8_t, 32>, EcdhPublicKey> Take();
+
+  size_t GetAvailableCount() const;
+
+ private:
+  void Refill();
+
+  os::Handler* handler_;
+  const size_t size_;
+
+  mutable std::mutex mutex_;
+  std::deque<std::pair<std::array<uint8_t, 32>, EcdhPublicKey>> key_pairs_;
+  bool refill_scheduled_ = false;
+};
+
+}  // namespace security
+}  // namespace bluetooth
@@ -29,6 +29,7 @@
 #include "os/handler.h"
 #include "packet/base_packet_builder.h"
 #include "packet/packet_view.h"
+#include "security/ecdh_key_pair_pool.h"
 #include "security/ecdh_keys.h"
 #include "security/pairing_failure.h"
 #include "security/smp_packets.h"
@@ -112,6 +113,9 @@ struct InitialInformations {
   std::optional<out_of_band_data> remote_oob_data;
   std::optional<MyOobData> my_oob_data;
 
+  /* Precomputed local key pairs for Secure Connections. The key pair is generated on demand without it. */
+  EcdhKeyPairPool* ecdh_key_pair_pool = nullptr;
+
   /* Used by Pairing Handler to present user with requests*/
   UI* user_interface;
   os::Handler* user_interface_handler;
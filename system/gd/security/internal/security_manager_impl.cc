@@ -440,7 +440,7 @@ void SecurityManagerImpl::OnPairingHandlerComplete(hci::Address address, Pairing
   }
   auto record = this->security_database_.FindOrCreate(remote);
   record->CancelPairing();
-  security_database_.SaveRecordsToStorage();
+  security_database_.SaveRecordToStorage(record);
   // Only call update link if we need to
   auto policy_callback_entry = enforce_security_policy_callback_map_.find(remote);
   if (policy_callback_entry != enforce_security_policy_callback_map_.end()) {
@@ -547,6 +547,7 @@ void SecurityManagerImpl::OnSmpCommandLe(hci::AddressWithType device) {
         .pairing_request = pairing_request,
         .remote_oob_data = remote_oob_data,
         .my_oob_data = local_le_oob_data_,
+        .ecdh_key_pair_pool = &ecdh_key_pair_pool_,
         /* Used by Pairing Handler to present user with requests*/
         .user_interface = user_interface_,
         .user_interface_handler = user_interface_handler_,
@@ -619,6 +620,7 @@ void SecurityManagerImpl::ConnectionIsReadyStartPairing(LeFixedChannelEntry* sto
       .pairing_request = std::nullopt,  // TODO: handle remotely initiated pairing in SecurityManager properly
       .remote_oob_data = remote_oob_data,
       .my_oob_data = local_le_oob_data_,
+      .ecdh_key_pair_pool = &ecdh_key_pair_pool_,
       /* Used by Pairing Handler to present user with requests*/
       .user_interface = user_interface_,
       .user_interface_handler = user_interface_handler_,
@@ -680,7 +682,8 @@ SecurityManagerImpl::SecurityManagerImpl(
       storage_module_(storage_module),
       security_record_storage_(storage_module, security_handler),
       security_database_(security_record_storage_),
-      name_db_module_(name_db_module) {
+      name_db_module_(name_db_module),
+      ecdh_key_pair_pool_(security_handler) {
   Init();
 
   l2cap_manager_le_->RegisterService(
@@ -722,7 +725,7 @@ void SecurityManagerImpl::OnPairingFinished(security::PairingResultOrFailure pai
   record->remote_signature_key = result.distributed_keys.remote_signature_key;
   if (result.distributed_keys.remote_link_key)
     record->SetLinkKey(*result.distributed_keys.remote_link_key, hci::KeyType::AUTHENTICATED_P256);
-  security_database_.SaveRecordsToStorage();
+  security_database_.SaveRecordToStorage(record);
 
   NotifyDeviceBonded(result.connection_address);
   // We also notify bond complete using identity address. That's what old stack used to do.
@@ -28,6 +28,7 @@
 #include "neighbor/name_db.h"
 #include "os/handler.h"
 #include "security/channel/security_manager_channel.h"
+#include "security/ecdh_key_pair_pool.h"
 #include "security/initial_informations.h"
 #include "security/pairing/classic_pairing_handler.h"
 #include "security/pairing/oob_data.h"
@@ -263,6 +264,7 @@ class SecurityManagerImpl : public channel::ISecurityManagerChannelListener, pub
   uint8_t local_maximum_encryption_key_size_ = 0x10;
   OobDataFlag local_le_oob_data_present_ = OobDataFlag::NOT_PRESENT;
   std::optional<MyOobData> local_le_oob_data_;
+  EcdhKeyPairPool ecdh_key_pair_pool_;
   std::optional<hci::AddressWithType> remote_oob_data_address_;
   std::optional<crypto_toolbox::Octet16> remote_oob_data_le_sc_c_;
   std::optional<crypto_toolbox::Octet16> remote_oob_data_le_sc_r_;
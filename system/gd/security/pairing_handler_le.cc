@@ -106,7 +106,7 @@ void PairingHandlerLe::PairingMain(InitialInformations i) {
     }
     auto [PKa, PKb, dhkey] = std::get<KeyExchangeResult>(key_exchange_result);
 
-    // Public key exchange finished, Diffie-Hellman key computed.
+    // Public key exchange finished, Diffie-Hellman key being computed.
 
     Stage1ResultOrFailure stage1result = DoSecureConnectionsStage1(i, PKa, PKb, pairing_request, pairing_response);
     if (std::holds_alternative<PairingFailure>(stage1result)) {
@@ -114,8 +114,8 @@ void PairingHandlerLe::PairingMain(InitialInformations i) {
       return;
     }
 
-    Stage2ResultOrFailure stage_2_result = DoSecureConnectionsStage2(i, PKa, PKb, pairing_request, pairing_response,
-                                                                     std::get<Stage1Result>(stage1result), dhkey);
+    Stage2ResultOrFailure stage_2_result = DoSecureConnectionsStage2(
+        i, PKa, PKb, pairing_request, pairing_response, std::get<Stage1Result>(stage1result), dhkey.get());
     if (std::holds_alternative<PairingFailure>(stage_2_result)) {
       i.OnPairingFinished(std::get<PairingFailure>(stage_2_result));
       return;
@@ -21,6 +21,7 @@
 #include <array>
 #include <chrono>
 #include <condition_variable>
+#include <future>
 #include <mutex>
 #include <optional>
 #include <queue>
@@ -86,7 +87,7 @@ using CommandViewOrFailure = std::variant<CommandView, PairingFailure>;
 using Phase1Result = std::pair<PairingRequestView /* pairning_request*/, PairingResponseView /* pairing_response */>;
 using Phase1ResultOrFailure = std::variant<PairingFailure, Phase1Result>;
 using KeyExchangeResult =
-    std::tuple<EcdhPublicKey /* PKa */, EcdhPublicKey /* PKb */, std::array<uint8_t, 32> /*dhkey*/>;
+    std::tuple<EcdhPublicKey /* PKa */, EcdhPublicKey /* PKb */, std::shared_future<std::array<uint8_t, 32>> /*dhkey*/>;
 using Stage1Result = std::tuple<Octet16, Octet16, Octet16, Octet16>;
 using Stage1ResultOrFailure = std::variant<PairingFailure, Stage1Result>;
 using Stage2ResultOrFailure = std::variant<PairingFailure, Octet16 /* LTK */>;
@@ -29,10 +29,11 @@ namespace security {
 
 std::variant<PairingFailure, KeyExchangeResult> PairingHandlerLe::ExchangePublicKeys(const InitialInformations& i,
                                                                                      OobDataFlag remote_have_oob_data) {
-  // Generate ECDH, or use one that was used for OOB data
-  const auto [private_key, public_key] = (remote_have_oob_data == OobDataFlag::NOT_PRESENT || !i.my_oob_data)
-                                             ? GenerateECDHKeyPair()
-                                             : std::make_pair(i.my_oob_data->private_key, i.my_oob_data->public_key);
+  // Take a precomputed ECDH key pair, or use one that was used for OOB data
+  const auto [private_key, public_key] =
+      (remote_have_oob_data == OobDataFlag::NOT_PRESENT || !i.my_oob_data)
+          ? (i.ecdh_key_pair_pool ? i.ecdh_key_pair_pool->Take() : GenerateECDHKeyPair())
+          : std::make_pair(i.my_oob_data->private_key, i.my_oob_data->public_key);
 
   LOG_INFO("Public key exchange start");
   std::unique_ptr<PairingPublicKeyBuilder> myPublicKey = PairingPublicKeyBuilder::Create(public_key.x, public_key.y);
@@ -84,7 +85,10 @@ std::variant<PairingFailure, KeyExchangeResult> PairingHandlerLe::ExchangePublic
 
   LOG_INFO("Public key exchange finish");
 
-  std::array<uint8_t, 32> dhkey = ComputeDHKey(private_key, remote_public_key);
+  // The DHKey is only needed in stage 2. Computing it meanwhile hides its cost behind the user confirmation and the
+  // exchange of nonces of stage 1.
+  std::shared_future<std::array<uint8_t, 32>> dhkey =
+      std::async(std::launch::async, ComputeDHKey, private_key, remote_public_key).share();
 
   const EcdhPublicKey& PKa = IAmCentral(i) ? public_key : remote_public_key;
   const EcdhPublicKey& PKb = IAmCentral(i) ? remote_public_key : public_key;
@@ -16,7 +16,9 @@
 
 #pragma once
 
+#include <memory>
 #include <set>
+#include <unordered_map>
 
 #include "hci/address_with_type.h"
 #include "security/record/security_record.h"
@@ -41,6 +43,7 @@ class SecurityRecordDatabase {
     // No security record, create one
     auto record_ptr = std::make_shared<SecurityRecord>(address);
     records_.insert(record_ptr);
+    Index(record_ptr);
     return record_ptr;
   }
 
@@ -50,30 +53,72 @@ class SecurityRecordDatabase {
     // No record exists
     if (it == records_.end()) return;
 
+    Unindex(*it);
     records_.erase(it);
     security_record_storage_.RemoveDevice(address);
   }
 
   iterator Find(hci::AddressWithType address) {
+    // Records are modified in place, so an index entry is only trusted if the record still has that address
+    auto identity = identity_address_index_.find(address);
+    if (identity != identity_address_index_.end() && identity->second->identity_address_ == address) {
+      auto it = records_.find(identity->second);
+      if (it != records_.end()) return it;
+    }
+    auto pseudo = pseudo_address_index_.find(address);
+    if (pseudo != pseudo_address_index_.end() && pseudo->second->GetPseudoAddress() == address) {
+      auto it = records_.find(pseudo->second);
+      if (it != records_.end()) return it;
+    }
+
+    // Resolvable private addresses, and addresses set after the record was indexed
     for (auto it = records_.begin(); it != records_.end(); ++it) {
       std::shared_ptr<SecurityRecord> record = *it;
-      if (record->identity_address_.has_value() && record->identity_address_.value() == address) return it;
-      if (record->GetPseudoAddress() == address) return it;
-      if (record->remote_irk.has_value() && address.IsRpaThatMatchesIrk(record->remote_irk.value())) return it;
+      if ((record->identity_address_.has_value() && record->identity_address_.value() == address) ||
+          (record->GetPseudoAddress() == address) ||
+          (record->remote_irk.has_value() && address.IsRpaThatMatchesIrk(record->remote_irk.value()))) {
+        Index(record);
+        return it;
+      }
     }
     return records_.end();
   }
 
   void LoadRecordsFromStorage() {
     security_record_storage_.LoadSecurityRecords(&records_);
+    pseudo_address_index_.clear();
+    identity_address_index_.clear();
+    for (auto& record : records_) Index(record);
   }
 
   void SaveRecordsToStorage() {
     security_record_storage_.SaveSecurityRecords(&records_);
   }
 
+  /* Stores a single record, for callers that know which one they changed */
+  void SaveRecordToStorage(std::shared_ptr<SecurityRecord> record) {
+    security_record_storage_.SaveSecurityRecord(record);
+  }
+
   std::set<std::shared_ptr<SecurityRecord>> records_;
   record::SecurityRecordStorage security_record_storage_;
+
+ private:
+  void Index(const std::shared_ptr<SecurityRecord>& record) {
+    if (record->pseudo_address_.has_value()) pseudo_address_index_[record->pseudo_address_.value()] = record;
+    if (record->identity_address_.has_value()) identity_address_index_[record->identity_address_.value()] = record;
+  }
+
+  void Unindex(const std::shared_ptr<SecurityRecord>& record) {
+    for (auto index : {&pseudo_address_index_, &identity_address_index_}) {
+      for (auto it = index->begin(); it != index->end();) {
+        it = (it->second == record) ? index->erase(it) : std::next(it);
+      }
+    }
+  }
+
+  std::unordered_map<hci::AddressWithType, std::shared_ptr<SecurityRecord>> pseudo_address_index_;
+  std::unordered_map<hci::AddressWithType, std::shared_ptr<SecurityRecord>> identity_address_index_;
 };
 
 }  // namespace record
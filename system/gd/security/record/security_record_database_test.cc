@@ -0,0 +1,69 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "security/record/security_record_database.h"
+
+#include <gtest/gtest.h>
+
+namespace bluetooth {
+namespace security {
+namespace record {
+namespace {
+
+const hci::AddressWithType kPseudoAddress(
+    hci::Address({0x01, 0x02, 0x03, 0x04, 0x05, 0x06}), hci::AddressType::RANDOM_DEVICE_ADDRESS);
+const hci::AddressWithType kIdentityAddress(
+    hci::Address({0x11, 0x12, 0x13, 0x14, 0x15, 0x16}), hci::AddressType::PUBLIC_DEVICE_ADDRESS);
+const hci::AddressWithType kOtherAddress(
+    hci::Address({0x21, 0x22, 0x23, 0x24, 0x25, 0x26}), hci::AddressType::PUBLIC_DEVICE_ADDRESS);
+
+class SecurityRecordDatabaseTest : public ::testing::Test {
+ protected:
+  // Lookups never reach the storage
+  SecurityRecordDatabase database_{SecurityRecordStorage(nullptr, nullptr)};
+};
+
+TEST_F(SecurityRecordDatabaseTest, find_by_pseudo_address) {
+  auto record = database_.FindOrCreate(kPseudoAddress);
+  ASSERT_EQ(record, database_.FindOrCreate(kPseudoAddress));
+  ASSERT_EQ(1u, database_.records_.size());
+  ASSERT_EQ(database_.records_.end(), database_.Find(kOtherAddress));
+}
+
+TEST_F(SecurityRecordDatabaseTest, find_by_identity_address_set_after_creation) {
+  auto record = database_.FindOrCreate(kPseudoAddress);
+  ASSERT_EQ(database_.records_.end(), database_.Find(kIdentityAddress));
+
+  // Identity address distributed during pairing
+  record->identity_address_ = kIdentityAddress;
+  ASSERT_EQ(record, *database_.Find(kIdentityAddress));
+  ASSERT_EQ(record, *database_.Find(kPseudoAddress));
+}
+
+TEST_F(SecurityRecordDatabaseTest, stale_index_entries_are_not_trusted) {
+  auto record = database_.FindOrCreate(kPseudoAddress);
+  record->identity_address_ = kIdentityAddress;
+  ASSERT_EQ(record, *database_.Find(kIdentityAddress));
+
+  record->identity_address_ = kOtherAddress;
+  ASSERT_EQ(database_.records_.end(), database_.Find(kIdentityAddress));
+  ASSERT_EQ(record, *database_.Find(kOtherAddress));
+}
+
+}  // namespace
+}  // namespace record
+}  // namespace security
+}  // namespace bluetooth
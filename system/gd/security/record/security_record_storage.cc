@@ -103,28 +103,32 @@ SecurityRecordStorage::SecurityRecordStorage(storage::StorageModule* storage_mod
 
 void SecurityRecordStorage::SaveSecurityRecords(std::set<std::shared_ptr<record::SecurityRecord>>* records) {
   for (auto record : *records) {
-    if (record->IsTemporary()) continue;
-    storage::Device device = storage_module_->GetDeviceByClassicMacAddress(record->GetPseudoAddress()->GetAddress());
-    auto mutation = storage_module_->Modify();
-
-    if (record->IsClassicLinkKeyValid() && !record->identity_address_) {
-      mutation.Add(device.SetDeviceType(hci::DeviceType::BR_EDR));
-    } else if (record->IsClassicLinkKeyValid() && record->remote_ltk) {
-      mutation.Add(device.SetDeviceType(hci::DeviceType::DUAL));
-    } else if (!record->IsClassicLinkKeyValid() && record->remote_ltk) {
-      mutation.Add(device.SetDeviceType(hci::DeviceType::LE));
-    } else {
-      mutation.Add(device.SetDeviceType(hci::DeviceType::LE));
-      LOG_WARN(
-          "Cannot determine device type from security record for '%s'; defaulting to LE",
-          record->GetPseudoAddress()->ToString().c_str());
-    }
-    mutation.Commit();
-    SetClassicData(mutation, record, device);
-    SetLeData(mutation, record, device);
-    SetAuthenticationData(mutation, record, device);
-    mutation.Commit();
+    SaveSecurityRecord(record);
+  }
+}
+
+void SecurityRecordStorage::SaveSecurityRecord(std::shared_ptr<record::SecurityRecord> record) {
+  if (record->IsTemporary()) return;
+  storage::Device device = storage_module_->GetDeviceByClassicMacAddress(record->GetPseudoAddress()->GetAddress());
+  auto mutation = storage_module_->Modify();
+
+  if (record->IsClassicLinkKeyValid() && !record->identity_address_) {
+    mutation.Add(device.SetDeviceType(hci::DeviceType::BR_EDR));
+  } else if (record->IsClassicLinkKeyValid() && record->remote_ltk) {
+    mutation.Add(device.SetDeviceType(hci::DeviceType::DUAL));
+  } else if (!record->IsClassicLinkKeyValid() && record->remote_ltk) {
+    mutation.Add(device.SetDeviceType(hci::DeviceType::LE));
+  } else {
+    mutation.Add(device.SetDeviceType(hci::DeviceType::LE));
+    LOG_WARN(
+        "Cannot determine device type from security record for '%s'; defaulting to LE",
+        record->GetPseudoAddress()->ToString().c_str());
   }
+  mutation.Commit();
+  SetClassicData(mutation, record, device);
+  SetLeData(mutation, record, device);
+  SetAuthenticationData(mutation, record, device);
+  mutation.Commit();
 }
 
 void SecurityRecordStorage::LoadSecurityRecords(std::set<std::shared_ptr<record::SecurityRecord>>* records) {
@@ -50,6 +50,13 @@ class SecurityRecordStorage {
    */
   void SaveSecurityRecords(std::set<std::shared_ptr<record::SecurityRecord>>* records);
 
+  /**
+   * Stores the metadata of a single record to disk.
+   *
+   * @param record shared pointer to the record.
+   */
+  void SaveSecurityRecord(std::shared_ptr<record::SecurityRecord> record);
+
   /**
    * Reads the record metadata from disk and converts each item into a SecurityRecord.
    *
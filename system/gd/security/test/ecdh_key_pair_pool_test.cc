@@ -0,0 +1,86 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "security/ecdh_key_pair_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+
+#include "os/handler.h"
+#include "os/thread.h"
+
+using namespace std::chrono_literals;
+
+namespace bluetooth {
+namespace security {
+
+class EcdhKeyPairPoolTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    thread_ = new os::Thread("test_thread", os::Thread::Priority::NORMAL);
+    handler_ = new os::Handler(thread_);
+  }
+
+  void TearDown() override {
+    handler_->Clear();
+    handler_->WaitUntilStopped(2000ms);
+    delete handler_;
+    delete thread_;
+  }
+
+  // Waits until the tasks posted so far to the handler have run
+  void Sync() {
+    std::promise<void> promise;
+    auto future = promise.get_future();
+    handler_->Post(common::BindOnce(&std::promise<void>::set_value, common::Unretained(&promise)));
+    ASSERT_EQ(future.wait_for(2s), std::future_status::ready);
+  }
+
+  os::Thread* thread_;
+  os::Handler* handler_;
+};
+
+TEST_F(EcdhKeyPairPoolTest, key_pairs_are_precomputed_and_used_once) {
+  EcdhKeyPairPool pool(handler_, 2);
+  Sync();
+  ASSERT_EQ(2u, pool.GetAvailableCount());
+
+  auto [private_key_a, public_key_a] = pool.Take();
+  auto [private_key_b, public_key_b] = pool.Take();
+  ASSERT_NE(private_key_a, private_key_b);
+  ASSERT_TRUE(ValidateECDHPoint(public_key_a));
+  ASSERT_TRUE(ValidateECDHPoint(public_key_b));
+  ASSERT_EQ(ComputeDHKey(private_key_a, public_key_b), ComputeDHKey(private_key_b, public_key_a));
+
+  // Taken key pairs are replaced in the background
+  Sync();
+  ASSERT_EQ(2u, pool.GetAvailableCount());
+}
+
+TEST_F(EcdhKeyPairPoolTest, take_from_empty_pool) {
+  EcdhKeyPairPool pool(handler_, 0);
+  Sync();
+  ASSERT_EQ(0u, pool.GetAvailableCount());
+
+  auto [private_key, public_key] = pool.Take();
+  ASSERT_TRUE(ValidateECDHPoint(public_key));
+  Sync();
+}
+
+}  // namespace security
+}  // namespace bluetooth
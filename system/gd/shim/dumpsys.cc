@@ -22,8 +22,12 @@
 
 #include "dumpsys/filter.h"
 #include "module.h"
+#include "os/binary_log.h"
+#include "os/handler.h"
 #include "os/log.h"
 #include "os/system_properties.h"
+#include "os/thread.h"
+#include "os/trace.h"
 #include "shim/dumpsys.h"
 #include "shim/dumpsys_args.h"
 
@@ -35,6 +39,7 @@ static const std::string kReadOnlyDebuggableProperty = "ro.debuggable";
 namespace {
 constexpr char kModuleName[] = "shim::Dumpsys";
 constexpr char kDumpsysTitle[] = "----- Gd Dumpsys ------";
+constexpr std::chrono::milliseconds kDumpStopTimeout = std::chrono::milliseconds(2000);
 }  // namespace
 
 struct Dumpsys::impl {
@@ -43,7 +48,7 @@ struct Dumpsys::impl {
   int GetNumberOfBundledSchemas() const;
 
   impl(const Dumpsys& dumpsys_module, const dumpsys::ReflectionSchema& reflection_schema);
-  ~impl() = default;
+  ~impl();
 
  protected:
   void FilterAsUser(std::string* dumpsys_data);
@@ -53,10 +58,17 @@ struct Dumpsys::impl {
   bool IsDebuggable() const;
 
  private:
-  void DumpWithArgsAsync(int fd, const char** args);
+  void PrintSnapshots(int fd, const DumpsysSnapshots& snapshots, bool trace, std::promise<void> promise);
 
   const Dumpsys& dumpsys_module_;
   const dumpsys::ReflectionSchema reflection_schema_;
+
+  // Only accessed on the module handler
+  DumpsysSnapshots snapshots_;
+
+  // Merges, filters and prints the module snapshots away from the stack threads
+  os::Thread dump_thread_{"bt_dumpsys_thread", os::Thread::Priority::NORMAL};
+  os::Handler dump_handler_{&dump_thread_};
 };
 
 const ModuleFactory Dumpsys::Factory =
@@ -65,6 +77,11 @@ const ModuleFactory Dumpsys::Factory =
 Dumpsys::impl::impl(const Dumpsys& dumpsys_module, const dumpsys::ReflectionSchema& reflection_schema)
     : dumpsys_module_(dumpsys_module), reflection_schema_(std::move(reflection_schema)) {}
 
+Dumpsys::impl::~impl() {
+  dump_handler_.Clear();
+  dump_handler_.WaitUntilStopped(kDumpStopTimeout);
+}
+
 int Dumpsys::impl::GetNumberOfBundledSchemas() const {
   return reflection_schema_.GetNumberOfBundledSchemas();
 }
@@ -115,23 +132,46 @@ std::string Dumpsys::impl::PrintAsJson(std::string* dumpsys_data) const {
   return jsongen;
 }
 
-void Dumpsys::impl::DumpWithArgsAsync(int fd, const char** args) {
-  ParsedDumpsysArgs parsed_dumpsys_args(args);
-  const auto registry = dumpsys_module_.GetModuleRegistry();
+void Dumpsys::impl::PrintSnapshots(int fd, const DumpsysSnapshots& snapshots, bool trace, std::promise<void> promise) {
+  const reflection::Schema* schema = reflection_schema_.GetRootReflectionSchema();
+  if (schema == nullptr) {
+    LOG_WARN("Unable to find root schema in prebundled reflection schema");
+    dprintf(fd, "ERROR: Unable to find root schema in prebundled reflection schema\n");
+    promise.set_value();
+    return;
+  }
 
-  ModuleDumper dumper(*registry, kDumpsysTitle);
+  ModuleDumper dumper(*dumpsys_module_.GetModuleRegistry(), kDumpsysTitle);
   std::string dumpsys_data;
-  dumper.DumpState(&dumpsys_data);
+  dumper.DumpState(snapshots, *schema, &dumpsys_data);
 
   dprintf(fd, " ----- Filtering as Developer -----\n");
   FilterAsDeveloper(&dumpsys_data);
 
   dprintf(fd, "%s", PrintAsJson(&dumpsys_data).c_str());
+
+  if (os::BinaryLog::IsEnabled()) {
+    dprintf(fd, " ----- Binary log -----\n");
+    os::BinaryLog::Write(fd);
+  }
+
+  if (trace) {
+    dprintf(fd, " ----- Trace -----\n");
+    os::Trace::WriteFtrace(fd);
+  }
+  promise.set_value();
 }
 
 void Dumpsys::impl::DumpWithArgsSync(int fd, const char** args, std::promise<void> promise) {
-  DumpWithArgsAsync(fd, args);
-  promise.set_value();
+  ParsedDumpsysArgs parsed_dumpsys_args(args);
+  const auto registry = dumpsys_module_.GetModuleRegistry();
+
+  // Only the data of the modules that changed since the last dump is collected on the module handler
+  ModuleDumper dumper(*registry, kDumpsysTitle);
+  dumper.DumpSnapshots(&snapshots_);
+
+  dump_handler_.CallOn(
+      this, &Dumpsys::impl::PrintSnapshots, fd, snapshots_, parsed_dumpsys_args.IsTrace(), std::move(promise));
 }
 
 Dumpsys::Dumpsys(const std::string& pre_bundled_schema)
@@ -183,6 +223,11 @@ DumpsysDataFinisher Dumpsys::GetDumpsysData(flatbuffers::FlatBufferBuilder* fb_b
   return [dumpsys_data](DumpsysDataBuilder* builder) { builder->add_shim_dumpsys_data(dumpsys_data); };
 }
 
+uint64_t Dumpsys::GetDumpsysDataVersion() const {
+  // The bundled schemas never change
+  return 1;
+}
+
 std::string Dumpsys::ToString() const {
   return kModuleName;
 }
@@ -26,6 +26,8 @@ namespace bluetooth {
 namespace shim {
 
 constexpr char kArgumentDeveloper[] = "--dev";
+// Append the recorded os::Trace events in the ftrace text format
+constexpr char kArgumentTrace[] = "--trace";
 
 class Dumpsys : public bluetooth::Module {
  public:
@@ -50,6 +52,7 @@ class Dumpsys : public bluetooth::Module {
   void Stop() override;                              // Module
   std::string ToString() const override;             // Module
   DumpsysDataFinisher GetDumpsysData(flatbuffers::FlatBufferBuilder* builder) const override;  // Module
+  uint64_t GetDumpsysDataVersion() const override;                                             // Module
 
  private:
   struct impl;
@@ -28,6 +28,8 @@ shim::ParsedDumpsysArgs::ParsedDumpsysArgs(const char** args) {
     num_args_++;
     if (!std::strcmp(p, kArgumentDeveloper)) {
       dev_arg_ = true;
+    } else if (!std::strcmp(p, kArgumentTrace)) {
+      trace_arg_ = true;
     } else {
       // silently ignore unexpected option
     }
@@ -39,3 +41,7 @@ shim::ParsedDumpsysArgs::ParsedDumpsysArgs(const char** args) {
 bool shim::ParsedDumpsysArgs::IsDeveloper() const {
   return dev_arg_;
 }
+
+bool shim::ParsedDumpsysArgs::IsTrace() const {
+  return trace_arg_;
+}
@@ -23,10 +23,12 @@ class ParsedDumpsysArgs {
  public:
   ParsedDumpsysArgs(const char** args);
   bool IsDeveloper() const;
+  bool IsTrace() const;
 
  private:
   unsigned num_args_{0};
   bool dev_arg_{false};
+  bool trace_arg_{false};
 };
 
 }  // namespace shim
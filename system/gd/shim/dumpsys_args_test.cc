@@ -43,6 +43,18 @@ TEST(DumpsysArgsTest, parsed_args_with_dev) {
   };
   shim::ParsedDumpsysArgs parsed_dumpsys_args(args);
   ASSERT_TRUE(parsed_dumpsys_args.IsDeveloper());
+  ASSERT_FALSE(parsed_dumpsys_args.IsTrace());
+}
+
+TEST(DumpsysArgsTest, parsed_args_with_trace) {
+  const char* args[]{
+      bluetooth::shim::kArgumentTrace,
+      bluetooth::shim::kArgumentDeveloper,
+      nullptr,
+  };
+  shim::ParsedDumpsysArgs parsed_dumpsys_args(args);
+  ASSERT_TRUE(parsed_dumpsys_args.IsDeveloper());
+  ASSERT_TRUE(parsed_dumpsys_args.IsTrace());
 }
 
 }  // namespace testing
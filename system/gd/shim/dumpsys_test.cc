@@ -60,6 +60,47 @@ bool SimpleJsonValidator(int fd, int* dumpsys_byte_cnt) {
   return left_bracket == right_bracket;
 }
 
+std::string ReadAll(int fd) {
+  std::string output;
+  char buf[256];
+  ssize_t size;
+  while ((size = read(fd, buf, sizeof(buf))) > 0) {
+    output.append(buf, size);
+  }
+  return output;
+}
+
+class TestVersionedModule : public bluetooth::Module {
+ public:
+  static const bluetooth::ModuleFactory Factory;
+
+  std::string test_string_{"Initial Test String"};
+  uint64_t test_version_{1};
+
+ protected:
+  void ListDependencies(bluetooth::ModuleList* list) const override {}
+  void Start() override {}
+  void Stop() override {}
+  std::string ToString() const override {
+    return std::string("TestVersionedModule");
+  }
+
+  bluetooth::DumpsysDataFinisher GetDumpsysData(flatbuffers::FlatBufferBuilder* fb_builder) const override {
+    auto string = fb_builder->CreateString(test_string_.c_str());
+    auto builder = bluetooth::ModuleUnitTestDataBuilder(*fb_builder);
+    builder.add_title(string);
+    auto table = builder.Finish();
+    return [table](bluetooth::DumpsysDataBuilder* builder) { builder->add_module_unittest_data(table); };
+  }
+
+  uint64_t GetDumpsysDataVersion() const override {
+    return test_version_;
+  }
+};
+
+const bluetooth::ModuleFactory TestVersionedModule::Factory =
+    bluetooth::ModuleFactory([]() { return new TestVersionedModule(); });
+
 }  // namespace
 
 // To create dumpsys_test_header_bin.h:
@@ -134,4 +175,35 @@ TEST_F(DumpsysTest, dump_as_user) {
   ASSERT_TRUE(dumpsys_byte_cnt < socket_buffer_size);
 }
 
+TEST_F(DumpsysTest, dump_reuses_unchanged_module_data) {
+  TestVersionedModule* test_module = new TestVersionedModule();
+  fake_registry_.InjectTestModule(&TestVersionedModule::Factory, test_module);
+
+  int sv[2];
+  ASSERT_EQ(0, socketpair(AF_LOCAL, SOCK_STREAM | SOCK_NONBLOCK, 0, sv));
+  auto dump = [this, &sv]() {
+    std::promise<void> promise;
+    std::future future = promise.get_future();
+    dumpsys_module_->Dump(sv[0], nullptr, std::move(promise));
+    future.wait();
+    return ReadAll(sv[1]);
+  };
+
+  std::string output = dump();
+  EXPECT_NE(std::string::npos, output.find("Initial Test String")) << output;
+  EXPECT_NE(std::string::npos, output.find("Shim Dumpsys")) << output;
+
+  // Not collected again until the module version changes
+  test_module->test_string_ = "A Second Test String";
+  output = dump();
+  EXPECT_NE(std::string::npos, output.find("Initial Test String")) << output;
+  test_module->test_version_++;
+  output = dump();
+  EXPECT_NE(std::string::npos, output.find("A Second Test String")) << output;
+  EXPECT_NE(std::string::npos, output.find("Shim Dumpsys")) << output;
+
+  close(sv[0]);
+  close(sv[1]);
+}
+
 }  // namespace testing
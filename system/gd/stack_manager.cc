@@ -23,9 +23,11 @@
 
 #include "common/bind.h"
 #include "module.h"
+#include "os/binary_log.h"
 #include "os/handler.h"
 #include "os/log.h"
 #include "os/thread.h"
+#include "os/trace.h"
 #include "os/wakelock_manager.h"
 
 using ::bluetooth::os::Handler;
@@ -35,8 +37,11 @@ using ::bluetooth::os::WakelockManager;
 namespace bluetooth {
 
 void StackManager::StartUp(ModuleList* modules, Thread* stack_thread) {
+  os::Trace::SetSamplePeriodFromSystemProperty();
+  os::BinaryLog::SetEnabledFromSystemProperty();
   management_thread_ = new Thread("management_thread", Thread::Priority::NORMAL);
   handler_ = new Handler(management_thread_);
+  WakelockManager::Get().SetReleaseTailFromSystemProperty(handler_);
 
   WakelockManager::Get().Acquire();
 
@@ -58,6 +63,7 @@ void StackManager::StartUp(ModuleList* modules, Thread* stack_thread) {
 }
 
 void StackManager::handle_start_up(ModuleList* modules, Thread* stack_thread, std::promise<void> promise) {
+  registry_.SetStartThreadsFromSystemProperty();
   registry_.Start(modules, stack_thread);
   promise.set_value();
 }
@@ -73,6 +79,7 @@ void StackManager::ShutDown() {
 
   WakelockManager::Get().Release();
   WakelockManager::Get().CleanUp();
+  WakelockManager::Get().SetReleaseTail(std::chrono::milliseconds(0), nullptr);
 
   ASSERT_LOG(
       stop_status == std::future_status::ready,
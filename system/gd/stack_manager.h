@@ -37,6 +37,10 @@ class StackManager {
     return registry_.IsStarted(&T::Factory);
   }
 
+  std::vector<ModuleRegistry::ModuleStartTime> GetModuleStartTimes() const {
+    return registry_.GetStartTimes();
+  }
+
  private:
   os::Thread* management_thread_ = nullptr;
   os::Handler* handler_ = nullptr;
@@ -73,6 +73,8 @@ class AdapterConfig {
   GENERATE_PROPERTY_GETTER_SETTER_REMOVER(LeIdentityResolvingKey, common::ByteArray<16>, "LE_LOCAL_KEY_IRK");
   GENERATE_PROPERTY_GETTER_SETTER_REMOVER(LegacyScanMode, hci::LegacyScanMode, "ScanMode");
   GENERATE_PROPERTY_GETTER_SETTER_REMOVER(DiscoveryTimeoutSeconds, int, "DiscoveryTimeout");
+  // Snapshot of the controller capabilities, read again when the controller firmware changes
+  GENERATE_PROPERTY_GETTER_SETTER_REMOVER(ControllerCapabilities, std::string, "ControllerCapabilities");
 };
 
 }  // namespace storage
@@ -0,0 +1,374 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "storage/binary_config_file.h"
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+
+#include "hci/address.h"
+#include "os/files.h"
+#include "os/log.h"
+#include "storage/device.h"
+
+namespace bluetooth {
+namespace storage {
+
+namespace {
+
+constexpr char kMagic[] = {'B', 'T', 'C', 'F'};
+constexpr uint8_t kVersion = 1;
+constexpr size_t kHeaderSize = sizeof(kMagic) + 1;
+constexpr size_t kCrcSize = 4;
+
+enum class ValueType : uint8_t {
+  STRING = 0,
+  // Lowercase hex string, e.g. link keys and IRKs
+  BYTES = 1,
+  // Decimal integer, zigzag encoded
+  INTEGER = 2,
+  // Address in the legacy config format
+  ADDRESS = 3,
+};
+
+std::array<uint32_t, 256> MakeCrcTable() {
+  std::array<uint32_t, 256> table = {};
+  for (uint32_t i = 0; i < table.size(); i++) {
+    uint32_t crc = i;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc & 1) ? (crc >> 1) ^ 0xedb88320 : crc >> 1;
+    }
+    table[i] = crc;
+  }
+  return table;
+}
+
+// CRC-32 as used by zlib
+uint32_t Crc32(const std::string& data, size_t size) {
+  static const std::array<uint32_t, 256> table = MakeCrcTable();
+  uint32_t crc = 0xffffffff;
+  for (size_t i = 0; i < size; i++) {
+    crc = table[(crc ^ static_cast<uint8_t>(data[i])) & 0xff] ^ (crc >> 8);
+  }
+  return crc ^ 0xffffffff;
+}
+
+int HexDigit(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  return -1;
+}
+
+bool IsLowercaseHex(const std::string& value) {
+  if (value.empty() || value.size() % 2 != 0) {
+    return false;
+  }
+  for (char c : value) {
+    if (HexDigit(c) < 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Only the integers printed back as the very same string are typed, e.g. not "007" or "+1"
+std::optional<int64_t> ParseInteger(const std::string& value) {
+  if (value.empty() || value.size() > 20) {
+    return std::nullopt;
+  }
+  char* end = nullptr;
+  errno = 0;
+  long long integer = std::strtoll(value.c_str(), &end, 10);
+  if (errno != 0 || end != value.c_str() + value.size() || std::to_string(integer) != value) {
+    return std::nullopt;
+  }
+  return static_cast<int64_t>(integer);
+}
+
+void AppendVarint(uint64_t value, std::string* out) {
+  while (value >= 0x80) {
+    out->push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out->push_back(static_cast<char>(value));
+}
+
+void AppendString(const std::string& value, std::string* out) {
+  AppendVarint(value.size(), out);
+  out->append(value);
+}
+
+void AppendValue(const std::string& value, std::string* out) {
+  auto integer = ParseInteger(value);
+  if (integer) {
+    out->push_back(static_cast<char>(ValueType::INTEGER));
+    AppendVarint((static_cast<uint64_t>(*integer) << 1) ^ static_cast<uint64_t>(*integer >> 63), out);
+    return;
+  }
+  if (IsLowercaseHex(value)) {
+    out->push_back(static_cast<char>(ValueType::BYTES));
+    AppendVarint(value.size() / 2, out);
+    for (size_t i = 0; i < value.size(); i += 2) {
+      out->push_back(static_cast<char>(HexDigit(value[i]) << 4 | HexDigit(value[i + 1])));
+    }
+    return;
+  }
+  auto address = hci::Address::FromLegacyConfigString(value);
+  if (address && address->ToLegacyConfigString() == value) {
+    out->push_back(static_cast<char>(ValueType::ADDRESS));
+    out->append(reinterpret_cast<const char*>(address->data()), hci::Address::kLength);
+    return;
+  }
+  out->push_back(static_cast<char>(ValueType::STRING));
+  AppendString(value, out);
+}
+
+// Bounds checked reader of the serialized config
+class Reader {
+ public:
+  Reader(const std::string& data, size_t begin, size_t end) : data_(data), pos_(begin), end_(end) {}
+
+  bool AtEnd() const {
+    return pos_ == end_;
+  }
+
+  bool ReadByte(uint8_t* value) {
+    if (pos_ >= end_) {
+      return false;
+    }
+    *value = static_cast<uint8_t>(data_[pos_++]);
+    return true;
+  }
+
+  bool ReadVarint(uint64_t* value) {
+    *value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      uint8_t byte;
+      if (!ReadByte(&byte)) {
+        return false;
+      }
+      *value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  bool ReadBytes(size_t size, const char** bytes) {
+    if (size > end_ - pos_) {
+      return false;
+    }
+    *bytes = data_.data() + pos_;
+    pos_ += size;
+    return true;
+  }
+
+  bool ReadString(std::string* value) {
+    uint64_t size;
+    const char* bytes;
+    if (!ReadVarint(&size) || !ReadBytes(size, &bytes)) {
+      return false;
+    }
+    value->assign(bytes, size);
+    return true;
+  }
+
+  bool ReadValue(std::string* value) {
+    static constexpr char kHexDigits[] = "0123456789abcdef";
+    uint8_t type;
+    if (!ReadByte(&type)) {
+      return false;
+    }
+    switch (static_cast<ValueType>(type)) {
+      case ValueType::STRING:
+        return ReadString(value);
+      case ValueType::BYTES: {
+        uint64_t size;
+        const char* bytes;
+        if (!ReadVarint(&size) || !ReadBytes(size, &bytes)) {
+          return false;
+        }
+        value->resize(size * 2);
+        for (size_t i = 0; i < size; i++) {
+          uint8_t byte = static_cast<uint8_t>(bytes[i]);
+          (*value)[2 * i] = kHexDigits[byte >> 4];
+          (*value)[2 * i + 1] = kHexDigits[byte & 0xf];
+        }
+        return true;
+      }
+      case ValueType::INTEGER: {
+        uint64_t zigzag;
+        if (!ReadVarint(&zigzag)) {
+          return false;
+        }
+        *value = std::to_string(static_cast<int64_t>((zigzag >> 1) ^ (~(zigzag & 1) + 1)));
+        return true;
+      }
+      case ValueType::ADDRESS: {
+        const char* bytes;
+        if (!ReadBytes(hci::Address::kLength, &bytes)) {
+          return false;
+        }
+        hci::Address address;
+        address.FromOctets(reinterpret_cast<const uint8_t*>(bytes));
+        *value = address.ToLegacyConfigString();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Skip the next value if it is made of at least |min_size| bytes, and return where they are. Leave the next value to
+  // be read otherwise
+  bool SkipBytesValue(size_t min_size, size_t* offset, size_t* size) {
+    size_t pos = pos_;
+    uint8_t type;
+    uint64_t bytes_size;
+    const char* bytes;
+    if (ReadByte(&type) && static_cast<ValueType>(type) == ValueType::BYTES && ReadVarint(&bytes_size) &&
+        bytes_size >= min_size) {
+      *offset = pos_;
+      if (ReadBytes(bytes_size, &bytes)) {
+        *size = bytes_size;
+        return true;
+      }
+    }
+    pos_ = pos;
+    return false;
+  }
+
+ private:
+  const std::string& data_;
+  size_t pos_;
+  size_t end_;
+};
+
+}  // namespace
+
+BinaryConfigFile::BinaryConfigFile(std::string path) : path_(std::move(path)) {
+  ASSERT(!path_.empty());
+}
+
+std::optional<ConfigCache> BinaryConfigFile::Read(size_t temp_devices_capacity) {
+  ASSERT(!path_.empty());
+  if (!os::FileExists(path_)) {
+    return std::nullopt;
+  }
+  auto source = ConfigFileSource::Open(path_, ConfigFileSource::Encoding::HEX);
+  auto data = source ? source->ReadAll() : std::nullopt;
+  if (!data) {
+    LOG_ERROR("unable to read file '%s'", path_.c_str());
+    return std::nullopt;
+  }
+  auto cache = Parse(*data, temp_devices_capacity, std::move(source));
+  if (!cache) {
+    LOG_WARN("invalid binary config file '%s'", path_.c_str());
+  }
+  return cache;
+}
+
+bool BinaryConfigFile::Write(const ConfigCache& cache) {
+  return os::WriteToFile(path_, Serialize(cache));
+}
+
+bool BinaryConfigFile::Delete() {
+  if (!os::FileExists(path_)) {
+    LOG_WARN("Config file at \"%s\" does not exist", path_.c_str());
+    return false;
+  }
+  return os::RemoveFile(path_);
+}
+
+std::string BinaryConfigFile::Serialize(const ConfigCache& cache) {
+  std::string data(kMagic, sizeof(kMagic));
+  data.push_back(static_cast<char>(kVersion));
+  cache.ForEachPersistentSection(
+      [&data](const std::string& section, const common::ListMap<std::string, std::string>& properties) {
+        AppendValue(section, &data);
+        AppendVarint(properties.size(), &data);
+        for (const auto& property : properties) {
+          AppendString(property.first, &data);
+          AppendValue(property.second, &data);
+        }
+      });
+  uint32_t crc = Crc32(data, data.size());
+  for (size_t i = 0; i < kCrcSize; i++) {
+    data.push_back(static_cast<char>(crc >> (8 * i)));
+  }
+  return data;
+}
+
+std::optional<ConfigCache> BinaryConfigFile::Parse(
+    const std::string& data, size_t temp_devices_capacity, std::shared_ptr<const ConfigFileSource> source) {
+  if (data.size() < kHeaderSize + kCrcSize || data.compare(0, sizeof(kMagic), kMagic, sizeof(kMagic)) != 0) {
+    LOG_WARN("not a binary config");
+    return std::nullopt;
+  }
+  if (static_cast<uint8_t>(data[sizeof(kMagic)]) != kVersion) {
+    LOG_WARN("unsupported binary config version %d", data[sizeof(kMagic)]);
+    return std::nullopt;
+  }
+  size_t end = data.size() - kCrcSize;
+  uint32_t crc = 0;
+  for (size_t i = 0; i < kCrcSize; i++) {
+    crc |= static_cast<uint32_t>(static_cast<uint8_t>(data[end + i])) << (8 * i);
+  }
+  if (crc != Crc32(data, end)) {
+    LOG_WARN("binary config checksum mismatch");
+    return std::nullopt;
+  }
+  ConfigCache cache(temp_devices_capacity, Device::kLinkKeyProperties);
+  Reader reader(data, kHeaderSize, end);
+  while (!reader.AtEnd()) {
+    std::string section;
+    uint64_t num_properties;
+    if (!reader.ReadValue(&section) || !reader.ReadVarint(&num_properties)) {
+      LOG_WARN("truncated binary config section");
+      return std::nullopt;
+    }
+    bool is_device_section = source != nullptr && ConfigCache::IsDeviceSection(section);
+    for (uint64_t i = 0; i < num_properties; i++) {
+      std::string property;
+      std::string value;
+      size_t offset;
+      size_t size;
+      if (!reader.ReadString(&property)) {
+        LOG_WARN("truncated binary config property in section %s", section.c_str());
+        return std::nullopt;
+      }
+      // Bytes are read back as their hex string, twice as long
+      if (is_device_section && reader.SkipBytesValue(ConfigCache::kMinLazyValueSize / 2, &offset, &size)) {
+        cache.SetLazyProperty(section, std::move(property), source, offset, size);
+        continue;
+      }
+      if (!reader.ReadValue(&value)) {
+        LOG_WARN("truncated binary config property in section %s", section.c_str());
+        return std::nullopt;
+      }
+      cache.SetProperty(section, std::move(property), std::move(value));
+    }
+  }
+  return cache;
+}
+
+}  // namespace storage
+}  // namespace bluetooth
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "storage/config_cache.h"
+#include "storage/config_file_source.h"
+
+namespace bluetooth {
+namespace storage {
+
+// Compact binary config file, holding the same information and persistent sections as the legacy config file
+//
+// The file starts with a magic and a version, followed by the sections and ends with the CRC-32 of all the bytes
+// before it. All integers are little endian, counts and lengths are LEB128 varints. Each section is made of its name,
+// its number of properties, then for each property its name and its value. Section names and values are typed: the
+// addresses, integers and lowercase hex strings of the legacy format are stored in binary form, and converted back to
+// the exact same string when read, the other values are stored as they are. The large byte values of the devices are
+// only read from the file when accessed
+class BinaryConfigFile {
+ public:
+  static BinaryConfigFile FromPath(std::string path) {
+    return BinaryConfigFile(std::move(path));
+  }
+  explicit BinaryConfigFile(std::string path);
+  // Return std::nullopt if the file does not exist or is not a valid binary config file
+  std::optional<ConfigCache> Read(size_t temp_devices_capacity);
+  bool Write(const ConfigCache& cache);
+  bool Delete();
+
+  static std::string Serialize(const ConfigCache& cache);
+  // The large byte values are read from |source| when accessed if given, |data| being its content
+  static std::optional<ConfigCache> Parse(
+      const std::string& data,
+      size_t temp_devices_capacity,
+      std::shared_ptr<const ConfigFileSource> source = nullptr);
+
+ private:
+  std::string path_;
+};
+
+}  // namespace storage
+}  // namespace bluetooth
@@ -0,0 +1,153 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/binary_config_file.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+#include "os/files.h"
+#include "storage/device.h"
+#include "storage/legacy_config_file.h"
+
+namespace testing {
+
+using bluetooth::storage::BinaryConfigFile;
+using bluetooth::storage::ConfigCache;
+using bluetooth::storage::Device;
+using bluetooth::storage::LegacyConfigFile;
+
+static const std::string kTestConfig =
+    "[Info]\n"
+    "FileSource = Empty\n"
+    "TimeCreated = 2020-05-20 01:20:56\n"
+    "\n"
+    "[Metrics]\n"
+    "Salt256Bit = 1234567890abcdef1234567890abcdef1234567890abcdef1234567890abcdef\n"
+    "\n"
+    "[Adapter]\n"
+    "Address = 01:02:03:ab:cd:ef\n"
+    "LE_LOCAL_KEY_IRK = fedcba0987654321fedcba0987654321\n"
+    "ScanMode = 2\n"
+    "DiscoveryTimeout = -120\n"
+    "\n"
+    "[01:02:03:ab:cd:ea]\n"
+    "name = hello world\n"
+    "LinkKey = fedcba0987654321fedcba0987654328\n"
+    "Upper = FEDCBA\n"
+    "Padded = 007\n"
+    "Odd = abc\n"
+    "Zero = 0\n"
+    "Large = 18446744073709551616\n"
+    "UpperAddress = 01:02:03:AB:CD:EF\n"
+    "\n"
+    "[AA:BB:CC:DD:EE:FF]\n"
+    "LinkKey = 0123456789abcdef0123456789abcdef\n"
+    "\n";
+
+class BinaryConfigFileTest : public Test {
+ protected:
+  void SetUp() override {
+    temp_legacy_config_ = std::filesystem::temp_directory_path() / "temp_config.txt";
+    temp_config_ = std::filesystem::temp_directory_path() / "temp_config.bin";
+    ASSERT_TRUE(bluetooth::os::WriteToFile(temp_legacy_config_.string(), kTestConfig));
+  }
+
+  void TearDown() override {
+    std::filesystem::remove(temp_legacy_config_);
+    std::filesystem::remove(temp_config_);
+  }
+
+  std::filesystem::path temp_legacy_config_;
+  std::filesystem::path temp_config_;
+};
+
+TEST_F(BinaryConfigFileTest, convert_from_legacy_format_test) {
+  auto legacy_config = LegacyConfigFile::FromPath(temp_legacy_config_.string()).Read(100);
+  ASSERT_TRUE(legacy_config);
+  ASSERT_TRUE(BinaryConfigFile::FromPath(temp_config_.string()).Write(*legacy_config));
+  auto config = BinaryConfigFile::FromPath(temp_config_.string()).Read(100);
+  ASSERT_TRUE(config);
+  // Every value reads back as the exact same string
+  EXPECT_EQ(*legacy_config, *config);
+  EXPECT_EQ(config->SerializeToLegacyFormat(), kTestConfig);
+  EXPECT_THAT(config->GetPersistentSections(), ElementsAre("01:02:03:ab:cd:ea", "AA:BB:CC:DD:EE:FF"));
+
+  // Smaller than the legacy format
+  auto binary_size = std::filesystem::file_size(temp_config_);
+  auto legacy_size = std::filesystem::file_size(temp_legacy_config_);
+  EXPECT_LT(binary_size, legacy_size);
+}
+
+TEST_F(BinaryConfigFileTest, only_persistent_sections_test) {
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  config.SetProperty("A", "B", "C");
+  config.SetProperty("AA:BB:CC:DD:EE:FF", "B", "C");
+  config.SetProperty("cc:dd:ee:ff:00:11", "LinkKey", "aabbaabbccddee");
+  auto config_read = BinaryConfigFile::Parse(BinaryConfigFile::Serialize(config), 100);
+  ASSERT_TRUE(config_read);
+  // Unpaired devices do not exist in persistent config file
+  config.RemoveSection("AA:BB:CC:DD:EE:FF");
+  EXPECT_EQ(config, *config_read);
+  EXPECT_THAT(config_read->GetProperty("cc:dd:ee:ff:00:11", "LinkKey"), Optional(StrEq("aabbaabbccddee")));
+}
+
+TEST_F(BinaryConfigFileTest, corrupted_file_test) {
+  auto legacy_config = LegacyConfigFile::FromPath(temp_legacy_config_.string()).Read(100);
+  ASSERT_TRUE(legacy_config);
+  auto data = BinaryConfigFile::Serialize(*legacy_config);
+  ASSERT_TRUE(BinaryConfigFile::Parse(data, 100));
+
+  // Any flipped bit is detected
+  for (size_t i = 0; i < data.size(); i++) {
+    auto corrupted = data;
+    corrupted[i] ^= 0x10;
+    EXPECT_FALSE(BinaryConfigFile::Parse(corrupted, 100)) << "byte " << i;
+  }
+  // As well as a truncated file
+  EXPECT_FALSE(BinaryConfigFile::Parse(data.substr(0, data.size() - 1), 100));
+  EXPECT_FALSE(BinaryConfigFile::Parse("", 100));
+  // The legacy format is not mistaken for the binary one
+  EXPECT_FALSE(BinaryConfigFile::Parse(kTestConfig, 100));
+}
+
+TEST_F(BinaryConfigFileTest, read_non_existing_file_test) {
+  EXPECT_FALSE(BinaryConfigFile::FromPath(temp_config_.string()).Read(100));
+  EXPECT_FALSE(BinaryConfigFile::FromPath(temp_config_.string()).Delete());
+}
+
+TEST_F(BinaryConfigFileTest, lazy_property_test) {
+  const std::string descriptor(ConfigCache::kMinLazyValueSize, 'a');
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  config.SetProperty("Adapter", "Address", "01:02:03:ab:cd:ef");
+  config.SetProperty("01:02:03:ab:cd:ea", "LinkKey", "fedcba0987654321fedcba0987654328");
+  config.SetProperty("01:02:03:ab:cd:ea", "HidDescriptor", descriptor);
+  config.SetProperty("01:02:03:ab:cd:ea", "Name", std::string(ConfigCache::kMinLazyValueSize, 'n'));
+  config.SetProperty("01:02:03:ab:cd:ea", "SinkPacsBin", descriptor.substr(2));
+  ASSERT_TRUE(BinaryConfigFile::FromPath(temp_config_.string()).Write(config));
+
+  auto config_read = BinaryConfigFile::FromPath(temp_config_.string()).Read(100);
+  ASSERT_TRUE(config_read);
+  EXPECT_EQ(config, *config_read);
+  // The values are still read once the config file is removed, as when it is replaced by a new one
+  std::filesystem::remove(temp_config_);
+  EXPECT_THAT(config_read->GetProperty("01:02:03:ab:cd:ea", "HidDescriptor"), Optional(StrEq(descriptor)));
+  EXPECT_EQ(BinaryConfigFile::Serialize(config), BinaryConfigFile::Serialize(*config_read));
+}
+
+}  // namespace testing
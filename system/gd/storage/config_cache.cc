@@ -65,40 +65,82 @@ ConfigCache::ConfigCache(size_t temp_device_capacity, std::unordered_set<std::st
       temporary_devices_(temp_device_capacity) {}
 
 void ConfigCache::SetPersistentConfigChangedCallback(std::function<void()> persistent_config_changed_callback) {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::unique_lock<std::shared_mutex> lock(mutex_);
   persistent_config_changed_callback_ = std::move(persistent_config_changed_callback);
 }
 
+void ConfigCache::SetPersistentSectionChangedCallback(
+    std::function<void(const std::string&)> persistent_section_changed_callback) {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  persistent_section_changed_callback_ = std::move(persistent_section_changed_callback);
+}
+
 ConfigCache::ConfigCache(ConfigCache&& other) noexcept
     : persistent_config_changed_callback_(std::move(other.persistent_config_changed_callback_)),
+      persistent_section_changed_callback_(std::move(other.persistent_section_changed_callback_)),
+      persistent_generation_(other.persistent_generation_.load()),
       persistent_property_names_(std::move(other.persistent_property_names_)),
       information_sections_(std::move(other.information_sections_)),
       persistent_devices_(std::move(other.persistent_devices_)),
-      temporary_devices_(std::move(other.temporary_devices_)) {
+      temporary_devices_(std::move(other.temporary_devices_)),
+      property_index_(std::move(other.property_index_)),
+      lazy_values_(std::move(other.lazy_values_)) {
   // std::function will be in a valid but unspecified state after std::move(), hence resetting it
   other.persistent_config_changed_callback_ = {};
+  other.persistent_section_changed_callback_ = {};
+  other.property_index_.clear();
+  other.lazy_values_.clear();
 }
 
 ConfigCache& ConfigCache::operator=(ConfigCache&& other) noexcept {
   if (&other == this) {
     return *this;
   }
-  std::lock_guard<std::recursive_mutex> my_lock(mutex_);
-  std::lock_guard<std::recursive_mutex> others_lock(other.mutex_);
+  std::unique_lock<std::shared_mutex> my_lock(mutex_);
+  std::unique_lock<std::shared_mutex> others_lock(other.mutex_);
   persistent_config_changed_callback_.swap(other.persistent_config_changed_callback_);
   other.persistent_config_changed_callback_ = {};
+  persistent_section_changed_callback_.swap(other.persistent_section_changed_callback_);
+  other.persistent_section_changed_callback_ = {};
+  // The content is replaced, make sure that the copies of the previous one are read again
+  persistent_generation_++;
   persistent_property_names_ = std::move(other.persistent_property_names_);
   information_sections_ = std::move(other.information_sections_);
   persistent_devices_ = std::move(other.persistent_devices_);
   temporary_devices_ = std::move(other.temporary_devices_);
+  property_index_ = std::move(other.property_index_);
+  other.property_index_.clear();
+  lazy_values_ = std::move(other.lazy_values_);
+  other.lazy_values_.clear();
   return *this;
 }
 
 bool ConfigCache::operator==(const ConfigCache& rhs) const {
-  std::lock_guard<std::recursive_mutex> my_lock(mutex_);
-  std::lock_guard<std::recursive_mutex> others_lock(rhs.mutex_);
+  std::shared_lock<std::shared_mutex> my_lock(mutex_);
+  std::shared_lock<std::shared_mutex> others_lock(rhs.mutex_);
+  if (lazy_values_.empty() && rhs.lazy_values_.empty()) {
+    return persistent_property_names_ == rhs.persistent_property_names_ &&
+           information_sections_ == rhs.information_sections_ && persistent_devices_ == rhs.persistent_devices_ &&
+           temporary_devices_ == rhs.temporary_devices_;
+  }
+  // Lazy properties are compared by value
+  auto persistent_devices_equal = [this, &rhs]() {
+    if (persistent_devices_.size() != rhs.persistent_devices_.size()) {
+      return false;
+    }
+    auto rhs_iter = rhs.persistent_devices_.begin();
+    for (const auto& device : persistent_devices_) {
+      if (device.first != rhs_iter->first ||
+          GetPropertiesLocked(device.first, device.second) !=
+              rhs.GetPropertiesLocked(rhs_iter->first, rhs_iter->second)) {
+        return false;
+      }
+      rhs_iter++;
+    }
+    return true;
+  };
   return persistent_property_names_ == rhs.persistent_property_names_ &&
-         information_sections_ == rhs.information_sections_ && persistent_devices_ == rhs.persistent_devices_ &&
+         information_sections_ == rhs.information_sections_ && persistent_devices_equal() &&
          temporary_devices_ == rhs.temporary_devices_;
 }
 
@@ -107,7 +149,11 @@ bool ConfigCache::operator!=(const ConfigCache& rhs) const {
 }
 
 void ConfigCache::Clear() {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  for (auto& index : property_index_) {
+    index.second.clear();
+  }
+  lazy_values_.clear();
   if (information_sections_.size() > 0) {
     information_sections_.clear();
     PersistentConfigChangedCallback();
@@ -116,41 +162,58 @@ void ConfigCache::Clear() {
     persistent_devices_.clear();
     PersistentConfigChangedCallback();
   }
-  if (temporary_devices_.size() > 0) {
-    temporary_devices_.clear();
-  }
+  temporary_devices_.Clear();
 }
 
-bool ConfigCache::HasSection(const std::string& section) const {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
-  return information_sections_.contains(section) || persistent_devices_.contains(section) ||
-         temporary_devices_.contains(section);
-}
-
-bool ConfigCache::HasProperty(const std::string& section, const std::string& property) const {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+const common::ListMap<std::string, std::string>* ConfigCache::FindPersistentSection(const std::string& section) const {
   auto section_iter = information_sections_.find(section);
   if (section_iter != information_sections_.end()) {
-    return section_iter->second.find(property) != section_iter->second.end();
+    return &section_iter->second;
   }
   section_iter = persistent_devices_.find(section);
   if (section_iter != persistent_devices_.end()) {
-    return section_iter->second.find(property) != section_iter->second.end();
+    return &section_iter->second;
   }
-  section_iter = temporary_devices_.find(section);
-  if (section_iter != temporary_devices_.end()) {
-    return section_iter->second.find(property) != section_iter->second.end();
+  return nullptr;
+}
+
+bool ConfigCache::HasSection(const std::string& section) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  return FindPersistentSection(section) != nullptr || temporary_devices_.HasSection(section);
+}
+
+bool ConfigCache::HasProperty(const std::string& section, const std::string& property) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  auto section_ptr = FindPersistentSection(section);
+  if (section_ptr != nullptr) {
+    return section_ptr->contains(property);
   }
-  return false;
+  return temporary_devices_.HasProperty(section, property);
 }
 
 std::optional<std::string> ConfigCache::GetProperty(const std::string& section, const std::string& property) const {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto section_ptr = FindPersistentSection(section);
+    if (section_ptr != nullptr) {
+      auto property_iter = section_ptr->find(property);
+      if (property_iter == section_ptr->end()) {
+        return std::nullopt;
+      }
+      if (property_iter->second != kEncryptedStr || os::ParameterProvider::GetBtKeystoreInterface() == nullptr) {
+        return GetValueLocked(section, property, property_iter->second);
+      }
+    } else {
+      return temporary_devices_.GetProperty(section, property);
+    }
+  }
+  // The keystore is not thread safe
+  std::unique_lock<std::shared_mutex> lock(mutex_);
   auto section_iter = information_sections_.find(section);
   if (section_iter != information_sections_.end()) {
     auto property_iter = section_iter->second.find(property);
     if (property_iter != section_iter->second.end()) {
-      return property_iter->second;
+      return GetValueLocked(section, property, property_iter->second);
     }
   }
   section_iter = persistent_devices_.find(section);
@@ -161,46 +224,61 @@ std::optional<std::string> ConfigCache::GetProperty(const std::string& section,
       if (os::ParameterProvider::GetBtKeystoreInterface() != nullptr && value == kEncryptedStr) {
         return os::ParameterProvider::GetBtKeystoreInterface()->get_key(section + "-" + property);
       }
-      return value;
+      return GetValueLocked(section, property, value);
     }
   }
-  section_iter = temporary_devices_.find(section);
-  if (section_iter != temporary_devices_.end()) {
-    auto property_iter = section_iter->second.find(property);
-    if (property_iter != section_iter->second.end()) {
-      return property_iter->second;
+  return temporary_devices_.GetProperty(section, property);
+}
+
+void ConfigCache::SetProperty(std::string section, std::string property, std::string value) {
+  if (IsDeviceSection(section) && !IsPersistentProperty(property)) {
+    // Unpaired devices, e.g. found while scanning, are modified without blocking the readers of the config
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (!persistent_devices_.contains(section)) {
+      if (TrimAfterNewLine(property) || TrimAfterNewLine(value)) {
+        android_errorWriteLog(0x534e4554, "70808273");
+      }
+      ASSERT_LOG(!property.empty(), "Empty property name not allowed");
+      temporary_devices_.SetProperty(section, std::move(property), std::move(value));
+      return;
     }
   }
-  return std::nullopt;
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  SetPropertyLocked(std::move(section), std::move(property), std::move(value));
 }
 
-void ConfigCache::SetProperty(std::string section, std::string property, std::string value) {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+void ConfigCache::SetPropertyLocked(std::string section, std::string property, std::string value) {
   if (TrimAfterNewLine(section) || TrimAfterNewLine(property) || TrimAfterNewLine(value)) {
     android_errorWriteLog(0x534e4554, "70808273");
   }
   ASSERT_LOG(!section.empty(), "Empty section name not allowed");
   ASSERT_LOG(!property.empty(), "Empty property name not allowed");
+  RemoveLazyValue(section, property);
   if (!IsDeviceSection(section)) {
+    AddToPropertyIndex(section, property);
     auto section_iter = information_sections_.find(section);
     if (section_iter == information_sections_.end()) {
       section_iter = information_sections_.try_emplace_back(section, common::ListMap<std::string, std::string>{}).first;
     }
     section_iter->second.insert_or_assign(property, std::move(value));
-    PersistentConfigChangedCallback();
+    PersistentSectionChangedCallback(section);
     return;
   }
   auto section_iter = persistent_devices_.find(section);
   if (section_iter == persistent_devices_.end() && IsPersistentProperty(property)) {
     // move paired devices or create new paired device when a link key is set
-    auto section_properties = temporary_devices_.extract(section);
+    auto section_properties = temporary_devices_.ExtractSection(section);
     if (section_properties) {
-      section_iter = persistent_devices_.try_emplace_back(section, std::move(section_properties->second)).first;
+      for (const auto& section_property : *section_properties) {
+        AddToPropertyIndex(section, section_property.first);
+      }
+      section_iter = persistent_devices_.try_emplace_back(section, std::move(*section_properties)).first;
     } else {
       section_iter = persistent_devices_.try_emplace_back(section, common::ListMap<std::string, std::string>{}).first;
     }
   }
   if (section_iter != persistent_devices_.end()) {
+    AddToPropertyIndex(section, property);
     bool is_encrypted = value == kEncryptedStr;
     if ((!value.empty()) && os::ParameterProvider::GetBtKeystoreInterface() != nullptr &&
         os::ParameterProvider::IsCommonCriteriaMode() && InEncryptKeyNameList(property) && !is_encrypted) {
@@ -210,30 +288,50 @@ void ConfigCache::SetProperty(std::string section, std::string property, std::st
       }
     }
     section_iter->second.insert_or_assign(property, std::move(value));
-    PersistentConfigChangedCallback();
+    PersistentSectionChangedCallback(section);
     return;
   }
-  section_iter = temporary_devices_.find(section);
-  if (section_iter == temporary_devices_.end()) {
-    auto triple = temporary_devices_.try_emplace(section, common::ListMap<std::string, std::string>{});
-    section_iter = std::get<0>(triple);
-  }
-  section_iter->second.insert_or_assign(property, std::move(value));
+  temporary_devices_.SetProperty(section, std::move(property), std::move(value));
+}
+
+void ConfigCache::SetLazyProperty(
+    std::string section,
+    std::string property,
+    std::shared_ptr<const LazyValueSource> source,
+    uint64_t offset,
+    size_t length) {
+  ASSERT(source != nullptr);
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  SetPropertyLocked(section, property, "");
+  lazy_values_[std::move(section)].insert_or_assign(
+      std::move(property), LazyValue{.source = std::move(source), .offset = offset, .length = length});
 }
 
 bool ConfigCache::RemoveSection(const std::string& section) {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  return RemoveSectionLocked(section);
+}
+
+bool ConfigCache::RemoveSectionLocked(const std::string& section) {
+  RemoveSectionFromPropertyIndex(section);
+  RemoveLazyValues(section);
   // sections are unique among all three maps, hence removing from one of them is enough
   if (information_sections_.extract(section) || persistent_devices_.extract(section)) {
-    PersistentConfigChangedCallback();
+    PersistentSectionChangedCallback(section);
     return true;
   } else {
-    return temporary_devices_.extract(section).has_value();
+    return temporary_devices_.RemoveSection(section);
   }
 }
 
 bool ConfigCache::RemoveProperty(const std::string& section, const std::string& property) {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  return RemovePropertyLocked(section, property);
+}
+
+bool ConfigCache::RemovePropertyLocked(const std::string& section, const std::string& property) {
+  RemoveFromPropertyIndex(section, property);
+  RemoveLazyValue(section, property);
   auto section_iter = information_sections_.find(section);
   if (section_iter != information_sections_.end()) {
     auto value = section_iter->second.extract(property);
@@ -242,7 +340,7 @@ bool ConfigCache::RemoveProperty(const std::string& section, const std::string&
       information_sections_.erase(section_iter);
     }
     if (value.has_value()) {
-      PersistentConfigChangedCallback();
+      PersistentSectionChangedCallback(section);
       return true;
     } else {
       return false;
@@ -255,12 +353,14 @@ bool ConfigCache::RemoveProperty(const std::string& section, const std::string&
     if (section_iter->second.size() == 0) {
       persistent_devices_.erase(section_iter);
     } else if (value && IsPersistentProperty(property)) {
-      // move unpaired device
+      // move unpaired device, with the values of its lazy properties
       auto section_properties = persistent_devices_.extract(section);
-      temporary_devices_.insert_or_assign(section, std::move(section_properties->second));
+      RemoveSectionFromPropertyIndex(section);
+      temporary_devices_.InsertSection(section, GetPropertiesLocked(section, section_properties->second));
+      RemoveLazyValues(section);
     }
     if (value.has_value()) {
-      PersistentConfigChangedCallback();
+      PersistentSectionChangedCallback(section);
       if (os::ParameterProvider::GetBtKeystoreInterface() != nullptr && os::ParameterProvider::IsCommonCriteriaMode() &&
           InEncryptKeyNameList(property)) {
         os::ParameterProvider::GetBtKeystoreInterface()->set_encrypt_key_or_remove_key(section + "-" + property, "");
@@ -270,21 +370,13 @@ bool ConfigCache::RemoveProperty(const std::string& section, const std::string&
       return false;
     }
   }
-  section_iter = temporary_devices_.find(section);
-  if (section_iter != temporary_devices_.end()) {
-    auto value = section_iter->second.extract(property);
-    if (section_iter->second.size() == 0) {
-      temporary_devices_.erase(section_iter);
-    }
-    return value.has_value();
-  }
-  return false;
+  return temporary_devices_.RemoveProperty(section, property);
 }
 
 void ConfigCache::ConvertEncryptOrDecryptKeyIfNeeded() {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::unique_lock<std::shared_mutex> lock(mutex_);
   LOG_INFO("%s", __func__);
-  auto persistent_sections = GetPersistentSections();
+  auto persistent_sections = GetPersistentSectionsLocked();
   for (const auto& section : persistent_sections) {
     auto section_iter = persistent_devices_.find(section);
     for (const auto& property : kEncryptKeyNameList) {
@@ -295,14 +387,14 @@ void ConfigCache::ConvertEncryptOrDecryptKeyIfNeeded() {
             os::ParameterProvider::IsCommonCriteriaMode() && !is_encrypted) {
           if (os::ParameterProvider::GetBtKeystoreInterface()->set_encrypt_key_or_remove_key(
                   section + "-" + std::string(property), property_iter->second)) {
-            SetProperty(section, std::string(property), kEncryptedStr);
+            SetPropertyLocked(section, std::string(property), kEncryptedStr);
           }
         }
         if (os::ParameterProvider::GetBtKeystoreInterface() != nullptr && is_encrypted) {
           std::string value_str =
               os::ParameterProvider::GetBtKeystoreInterface()->get_key(section + "-" + std::string(property));
           if (!os::ParameterProvider::IsCommonCriteriaMode()) {
-            SetProperty(section, std::string(property), value_str);
+            SetPropertyLocked(section, std::string(property), value_str);
           }
         }
       }
@@ -319,12 +411,14 @@ bool ConfigCache::IsPersistentProperty(const std::string& property) const {
 }
 
 void ConfigCache::RemoveSectionWithProperty(const std::string& property) {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::unique_lock<std::shared_mutex> lock(mutex_);
   size_t num_persistent_removed = 0;
   for (auto* config_section : {&information_sections_, &persistent_devices_}) {
     for (auto it = config_section->begin(); it != config_section->end();) {
       if (it->second.contains(property)) {
         LOG_INFO("Removing persistent section %s with property %s", it->first.c_str(), property.c_str());
+        RemoveSectionFromPropertyIndex(it->first);
+        RemoveLazyValues(it->first);
         it = config_section->erase(it);
         num_persistent_removed++;
         continue;
@@ -332,21 +426,18 @@ void ConfigCache::RemoveSectionWithProperty(const std::string& property) {
       it++;
     }
   }
-  for (auto it = temporary_devices_.begin(); it != temporary_devices_.end();) {
-    if (it->second.contains(property)) {
-      LOG_INFO("Removing temporary section %s with property %s", it->first.c_str(), property.c_str());
-      it = temporary_devices_.erase(it);
-      continue;
-    }
-    it++;
-  }
+  temporary_devices_.RemoveSectionWithProperty(property);
   if (num_persistent_removed > 0) {
     PersistentConfigChangedCallback();
   }
 }
 
 std::vector<std::string> ConfigCache::GetPersistentSections() const {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  return GetPersistentSectionsLocked();
+}
+
+std::vector<std::string> ConfigCache::GetPersistentSectionsLocked() const {
   std::vector<std::string> paired_devices;
   paired_devices.reserve(persistent_devices_.size());
   for (const auto& elem : persistent_devices_) {
@@ -356,19 +447,19 @@ std::vector<std::string> ConfigCache::GetPersistentSections() const {
 }
 
 void ConfigCache::Commit(std::queue<MutationEntry>& mutation_entries) {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::unique_lock<std::shared_mutex> lock(mutex_);
   while (!mutation_entries.empty()) {
     auto entry = std::move(mutation_entries.front());
     mutation_entries.pop();
     switch (entry.entry_type) {
       case MutationEntry::EntryType::SET:
-        SetProperty(std::move(entry.section), std::move(entry.property), std::move(entry.value));
+        SetPropertyLocked(std::move(entry.section), std::move(entry.property), std::move(entry.value));
         break;
       case MutationEntry::EntryType::REMOVE_PROPERTY:
-        RemoveProperty(entry.section, entry.property);
+        RemovePropertyLocked(entry.section, entry.property);
         break;
       case MutationEntry::EntryType::REMOVE_SECTION:
-        RemoveSection(entry.section);
+        RemoveSectionLocked(entry.section);
         break;
         // do not write a default case so that when a new enum is defined, compilation would fail automatically
     }
@@ -376,13 +467,14 @@ void ConfigCache::Commit(std::queue<MutationEntry>& mutation_entries) {
 }
 
 std::string ConfigCache::SerializeToLegacyFormat() const {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   std::stringstream serialized;
   for (const auto* config_section : {&information_sections_, &persistent_devices_}) {
     for (const auto& section : *config_section) {
       serialized << "[" << section.first << "]" << std::endl;
       for (const auto& property : section.second) {
-        serialized << property.first << " = " << property.second << std::endl;
+        serialized << property.first << " = " << GetValueLocked(section.first, property.first, property.second)
+                   << std::endl;
       }
       serialized << std::endl;
     }
@@ -390,29 +482,145 @@ std::string ConfigCache::SerializeToLegacyFormat() const {
   return serialized.str();
 }
 
+std::string ConfigCache::SerializeSectionToLegacyFormat(const std::string& section) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  std::stringstream serialized;
+  serialized << "[" << section << "]" << std::endl;
+  auto section_ptr = FindPersistentSection(section);
+  if (section_ptr != nullptr) {
+    for (const auto& property : *section_ptr) {
+      serialized << property.first << " = " << GetValueLocked(section, property.first, property.second) << std::endl;
+    }
+  }
+  serialized << std::endl;
+  return serialized.str();
+}
+
+void ConfigCache::ForEachPersistentSection(const SectionVisitor& visitor) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  for (const auto* config_section : {&information_sections_, &persistent_devices_}) {
+    for (const auto& section : *config_section) {
+      if (lazy_values_.count(section.first) > 0) {
+        visitor(section.first, GetPropertiesLocked(section.first, section.second));
+      } else {
+        visitor(section.first, section.second);
+      }
+    }
+  }
+}
+
 std::vector<ConfigCache::SectionAndPropertyValue> ConfigCache::GetSectionNamesWithProperty(
     const std::string& property) const {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
-  std::vector<SectionAndPropertyValue> result;
-  for (auto* config_section : {&information_sections_, &persistent_devices_}) {
-    for (const auto& elem : *config_section) {
-      auto it = elem.second.find(property);
-      if (it != elem.second.end()) {
-        result.emplace_back(SectionAndPropertyValue{.section = elem.first, .property = it->second});
-        continue;
-      }
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto index_iter = property_index_.find(property);
+    if (index_iter != property_index_.end()) {
+      return GetSectionNamesWithPropertyLocked(index_iter->second, property);
     }
   }
-  for (const auto& elem : temporary_devices_) {
-    auto it = elem.second.find(property);
-    if (it != elem.second.end()) {
-      result.emplace_back(SectionAndPropertyValue{.section = elem.first, .property = it->second});
-      continue;
+  // Index the sections with |property| on its first look up, then keep the index up to date
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  auto index_iter = property_index_.find(property);
+  if (index_iter == property_index_.end()) {
+    index_iter = property_index_.try_emplace(property).first;
+    for (auto* config_section : {&information_sections_, &persistent_devices_}) {
+      for (const auto& elem : *config_section) {
+        if (elem.second.contains(property)) {
+          index_iter->second.insert(elem.first);
+        }
+      }
     }
   }
+  return GetSectionNamesWithPropertyLocked(index_iter->second, property);
+}
+
+std::vector<ConfigCache::SectionAndPropertyValue> ConfigCache::GetSectionNamesWithPropertyLocked(
+    const std::unordered_set<std::string>& sections, const std::string& property) const {
+  std::vector<SectionAndPropertyValue> result;
+  result.reserve(sections.size());
+  for (const auto& section : sections) {
+    auto section_ptr = FindPersistentSection(section);
+    ASSERT(section_ptr != nullptr);
+    auto property_iter = section_ptr->find(property);
+    ASSERT(property_iter != section_ptr->end());
+    result.emplace_back(SectionAndPropertyValue{
+        .section = section, .property = GetValueLocked(section, property, property_iter->second)});
+  }
+  // Information and persistent sections first, as the remaining temporary devices may be evicted
+  for (auto& temporary_section : temporary_devices_.GetSectionNamesWithProperty(property)) {
+    result.emplace_back(SectionAndPropertyValue{
+        .section = std::move(temporary_section.first), .property = std::move(temporary_section.second)});
+  }
   return result;
 }
 
+void ConfigCache::AddToPropertyIndex(const std::string& section, const std::string& property) {
+  auto index_iter = property_index_.find(property);
+  if (index_iter != property_index_.end()) {
+    index_iter->second.insert(section);
+  }
+}
+
+void ConfigCache::RemoveFromPropertyIndex(const std::string& section, const std::string& property) {
+  auto index_iter = property_index_.find(property);
+  if (index_iter != property_index_.end()) {
+    index_iter->second.erase(section);
+  }
+}
+
+void ConfigCache::RemoveSectionFromPropertyIndex(const std::string& section) {
+  for (auto& index : property_index_) {
+    index.second.erase(section);
+  }
+}
+
+std::string ConfigCache::GetValueLocked(
+    const std::string& section, const std::string& property, const std::string& value) const {
+  if (!value.empty() || lazy_values_.empty()) {
+    return value;
+  }
+  auto section_iter = lazy_values_.find(section);
+  if (section_iter == lazy_values_.end()) {
+    return value;
+  }
+  auto property_iter = section_iter->second.find(property);
+  if (property_iter == section_iter->second.end()) {
+    return value;
+  }
+  const LazyValue& lazy_value = property_iter->second;
+  auto lazy_value_read = lazy_value.source->Read(lazy_value.offset, lazy_value.length);
+  // The value would otherwise be lost at the next save
+  ASSERT_LOG(lazy_value_read.has_value(), "unable to read %s of section %s", property.c_str(), section.c_str());
+  return std::move(*lazy_value_read);
+}
+
+common::ListMap<std::string, std::string> ConfigCache::GetPropertiesLocked(
+    const std::string& section, const common::ListMap<std::string, std::string>& properties) const {
+  if (lazy_values_.count(section) == 0) {
+    return properties;
+  }
+  common::ListMap<std::string, std::string> result;
+  for (const auto& property : properties) {
+    result.insert_or_assign(property.first, GetValueLocked(section, property.first, property.second));
+  }
+  return result;
+}
+
+void ConfigCache::RemoveLazyValue(const std::string& section, const std::string& property) {
+  auto section_iter = lazy_values_.find(section);
+  if (section_iter == lazy_values_.end()) {
+    return;
+  }
+  section_iter->second.erase(property);
+  if (section_iter->second.empty()) {
+    lazy_values_.erase(section_iter);
+  }
+}
+
+void ConfigCache::RemoveLazyValues(const std::string& section) {
+  lazy_values_.erase(section);
+}
+
 namespace {
 
 bool FixDeviceTypeInconsistencyInSection(
@@ -465,21 +673,17 @@ bool FixDeviceTypeInconsistencyInSection(
 }  // namespace
 
 bool ConfigCache::FixDeviceTypeInconsistencies() {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::unique_lock<std::shared_mutex> lock(mutex_);
   bool persistent_device_changed = false;
   for (auto* config_section : {&information_sections_, &persistent_devices_}) {
     for (auto& elem : *config_section) {
       if (FixDeviceTypeInconsistencyInSection(elem.first, elem.second)) {
+        AddToPropertyIndex(elem.first, "DevType");
         persistent_device_changed = true;
       }
     }
   }
-  bool temp_device_changed = false;
-  for (auto& elem : temporary_devices_) {
-    if (FixDeviceTypeInconsistencyInSection(elem.first, elem.second)) {
-      temp_device_changed = true;
-    }
-  }
+  bool temp_device_changed = temporary_devices_.ModifyEachSection(&FixDeviceTypeInconsistencyInSection);
   if (persistent_device_changed) {
     PersistentConfigChangedCallback();
   }
@@ -488,23 +692,10 @@ bool ConfigCache::FixDeviceTypeInconsistencies() {
 
 bool ConfigCache::HasAtLeastOneMatchingPropertiesInSection(
     const std::string& section, const std::unordered_set<std::string_view>& property_names) const {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
-  const common::ListMap<std::string, std::string>* section_ptr;
-  if (!IsDeviceSection(section)) {
-    auto section_iter = information_sections_.find(section);
-    if (section_iter == information_sections_.end()) {
-      return false;
-    }
-    section_ptr = &section_iter->second;
-  } else {
-    auto section_iter = persistent_devices_.find(section);
-    if (section_iter == persistent_devices_.end()) {
-      section_iter = temporary_devices_.find(section);
-      if (section_iter == temporary_devices_.end()) {
-        return false;
-      }
-    }
-    section_ptr = &section_iter->second;
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  auto section_ptr = FindPersistentSection(section);
+  if (section_ptr == nullptr) {
+    return temporary_devices_.HasAtLeastOneMatchingProperty(section, property_names);
   }
   for (const auto& property : *section_ptr) {
     if (property_names.count(property.first) > 0) {
@@ -514,10 +705,18 @@ bool ConfigCache::HasAtLeastOneMatchingPropertiesInSection(
   return false;
 }
 
+TemporaryDeviceCache::Stats ConfigCache::GetTemporaryDeviceStats() const {
+  return temporary_devices_.GetStats();
+}
+
 bool ConfigCache::IsPersistentSection(const std::string& section) const {
-  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   return persistent_devices_.contains(section);
 }
 
+uint64_t ConfigCache::GetPersistentGeneration() const {
+  return persistent_generation_.load();
+}
+
 }  // namespace storage
 }  // namespace bluetooth
\ No newline at end of file
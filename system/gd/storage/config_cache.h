@@ -15,22 +15,27 @@
  */
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <list>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <queue>
+#include <shared_mutex>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "common/list_map.h"
-#include "common/lru_cache.h"
 #include "hci/address.h"
 #include "os/utils.h"
 #include "storage/mutation_entry.h"
+#include "storage/temporary_device_cache.h"
 
 namespace bluetooth {
 namespace storage {
@@ -48,9 +53,19 @@ class Mutation;
 // The definition of persistent sections is up to the user and is defined through the |persistent_property_names|
 // argument. When these properties are link key properties, then persistent sections is equal to bonded devices
 //
-// This class is thread safe
+// This class is thread safe. Readers of the information and persistent sections don't block each other, the callbacks
+// are called while the config is locked and must not call back into it. The temporary devices have their own locks, so
+// that they are looked up and modified while only sharing the config lock
 class ConfigCache {
  public:
+  // Where the lazy properties are read from, see SetLazyProperty()
+  class LazyValueSource {
+   public:
+    virtual ~LazyValueSource() = default;
+    // Return the value of |length| bytes stored at |offset|, std::nullopt if it cannot be read
+    virtual std::optional<std::string> Read(uint64_t offset, size_t length) const = 0;
+  };
+
   ConfigCache(size_t temp_device_capacity, std::unordered_set<std::string_view> persistent_property_names);
 
   ConfigCache(const ConfigCache&) = delete;
@@ -77,6 +92,9 @@ class ConfigCache {
   virtual std::vector<std::string> GetPersistentSections() const;
   // Return true if a section is persistent
   virtual bool IsPersistentSection(const std::string& section) const;
+  // Incremented by every change of the persistent sections, so that users keeping copies of their properties can tell
+  // when to read them again
+  virtual uint64_t GetPersistentGeneration() const;
   // Return true if a section has one of the properties in |property_names|
   virtual bool HasAtLeastOneMatchingPropertiesInSection(
       const std::string& section, const std::unordered_set<std::string_view>& property_names) const;
@@ -84,7 +102,15 @@ class ConfigCache {
   virtual bool IsPersistentProperty(const std::string& property) const;
   // Serialize to legacy config format
   virtual std::string SerializeToLegacyFormat() const;
-  // Return a copy of pair<section_name, property_value> with property
+  // Serialize a single section to legacy config format, only its header is serialized if it is not persistent
+  virtual std::string SerializeSectionToLegacyFormat(const std::string& section) const;
+  // Call |visitor| with each information and persistent section and its properties, in the order they are serialized.
+  // The config is locked meanwhile, |visitor| must not access it
+  using SectionVisitor =
+      std::function<void(const std::string& section, const common::ListMap<std::string, std::string>& properties)>;
+  virtual void ForEachPersistentSection(const SectionVisitor& visitor) const;
+  // Return a copy of pair<section_name, property_value> with property, information and persistent sections first
+  // The sections with |property| are indexed on the first call, so that the next calls don't scan the whole config
   struct SectionAndPropertyValue {
     std::string section;
     std::string property;
@@ -96,11 +122,21 @@ class ConfigCache {
     }
   };
   virtual std::vector<SectionAndPropertyValue> GetSectionNamesWithProperty(const std::string& property) const;
+  // Return the size of the temporary devices cache and how well it performs
+  virtual TemporaryDeviceCache::Stats GetTemporaryDeviceStats() const;
 
   // modifiers
   // Commit all mutation entries in sequence while holding the config mutex
   virtual void Commit(std::queue<MutationEntry>& mutation);
   virtual void SetProperty(std::string section, std::string property, std::string value);
+  // Set a property whose value is only read from |source| when accessed, so that the large values of the bonded
+  // devices are not kept in memory. It behaves as any other property otherwise, and holds its value once set again
+  virtual void SetLazyProperty(
+      std::string section,
+      std::string property,
+      std::shared_ptr<const LazyValueSource> source,
+      uint64_t offset,
+      size_t length);
   virtual bool RemoveSection(const std::string& section);
   virtual bool RemoveProperty(const std::string& section, const std::string& property);
   virtual void ConvertEncryptOrDecryptKeyIfNeeded();
@@ -111,6 +147,10 @@ class ConfigCache {
   virtual void Clear();
   // Set a callback to notify interested party that a persistent config change has just happened
   virtual void SetPersistentConfigChangedCallback(std::function<void()> persistent_config_changed_callback);
+  // Set a callback to notify interested party that the persistent content of a single section has just changed. When
+  // set, it is called instead of the persistent config changed callback for the changes limited to one section
+  virtual void SetPersistentSectionChangedCallback(
+      std::function<void(const std::string&)> persistent_section_changed_callback);
 
   // Device config specific methods
   // TODO: methods here should be moved to a device specific config cache if this config cache is supposed to be generic
@@ -123,11 +163,17 @@ class ConfigCache {
 
   // constants
   static const std::string kDefaultSectionName;
+  // Device property values at least this long are loaded as lazy properties from the config files
+  static constexpr size_t kMinLazyValueSize = 128;
 
  private:
-  mutable std::recursive_mutex mutex_;
+  mutable std::shared_mutex mutex_;
   // A callback to notify interested party that a persistent config change has just happened, empty by default
   std::function<void()> persistent_config_changed_callback_;
+  // A callback to notify interested party that a persistent section has just changed, empty by default
+  std::function<void(const std::string&)> persistent_section_changed_callback_;
+  // Number of persistent changes so far, see GetPersistentGeneration()
+  mutable std::atomic<uint64_t> persistent_generation_ = 0;
   // A set of property names that if set would make a section persistent and if non of these properties are set, a
   // section would become temporary again
   std::unordered_set<std::string_view> persistent_property_names_;
@@ -136,15 +182,53 @@ class ConfigCache {
   // Information about persistent devices, normally paired, will be written to disk
   common::ListMap<std::string, common::ListMap<std::string, std::string>> persistent_devices_;
   // Information about temporary devices, normally unpaired, will not be written to disk, will be evicted automatically
-  // if capacity exceeds given value during initialization
-  common::LruCache<std::string, common::ListMap<std::string, std::string>> temporary_devices_;
+  // if capacity exceeds given value during initialization. They never have lazy properties
+  TemporaryDeviceCache temporary_devices_;
+  // Information and persistent sections holding each of the properties given to GetSectionNamesWithProperty()
+  mutable std::unordered_map<std::string, std::unordered_set<std::string>> property_index_;
+  // Properties set by SetLazyProperty(), by section and property. Their value in the sections above is empty
+  struct LazyValue {
+    std::shared_ptr<const LazyValueSource> source;
+    uint64_t offset;
+    size_t length;
+  };
+  std::unordered_map<std::string, std::unordered_map<std::string, LazyValue>> lazy_values_;
+
+  // Methods below must be called with |mutex_| held, exclusively for the non const ones
+  void SetPropertyLocked(std::string section, std::string property, std::string value);
+  bool RemoveSectionLocked(const std::string& section);
+  bool RemovePropertyLocked(const std::string& section, const std::string& property);
+  std::vector<std::string> GetPersistentSectionsLocked() const;
+  std::vector<SectionAndPropertyValue> GetSectionNamesWithPropertyLocked(
+      const std::unordered_set<std::string>& sections, const std::string& property) const;
+  // Return the properties of an information or persistent section, nullptr if there is none
+  const common::ListMap<std::string, std::string>* FindPersistentSection(const std::string& section) const;
+  void AddToPropertyIndex(const std::string& section, const std::string& property);
+  void RemoveFromPropertyIndex(const std::string& section, const std::string& property);
+  void RemoveSectionFromPropertyIndex(const std::string& section);
+  // Return |value| of |property|, or read it from its source if it is a lazy property
+  std::string GetValueLocked(const std::string& section, const std::string& property, const std::string& value) const;
+  // Return |properties| of |section| with the values of its lazy properties read from their source
+  common::ListMap<std::string, std::string> GetPropertiesLocked(
+      const std::string& section, const common::ListMap<std::string, std::string>& properties) const;
+  void RemoveLazyValue(const std::string& section, const std::string& property);
+  void RemoveLazyValues(const std::string& section);
 
   // Convenience method to check if the callback is valid before calling it
   inline void PersistentConfigChangedCallback() const {
+    persistent_generation_++;
     if (persistent_config_changed_callback_) {
       persistent_config_changed_callback_();
     }
   }
+  inline void PersistentSectionChangedCallback(const std::string& section) const {
+    if (persistent_section_changed_callback_) {
+      persistent_generation_++;
+      persistent_section_changed_callback_(section);
+    } else {
+      PersistentConfigChangedCallback();
+    }
+  }
 };
 
 }  // namespace storage
@@ -20,6 +20,7 @@
 #include <gtest/gtest.h>
 
 #include <cstdio>
+#include <thread>
 
 #include "hci/enum_helper.h"
 #include "storage/device.h"
@@ -33,6 +34,17 @@ std::string GetTestAddress(int i) {
   std::snprintf(res.data(), res.capacity(), "AA:BB:CC:DD:EE:%02d", i);
   return res;
 }
+
+class FakeLazyValueSource : public bluetooth::storage::ConfigCache::LazyValueSource {
+ public:
+  explicit FakeLazyValueSource(std::string data) : data_(std::move(data)) {}
+  std::optional<std::string> Read(uint64_t offset, size_t length) const override {
+    num_reads_++;
+    return data_.substr(offset, length);
+  }
+  std::string data_;
+  mutable int num_reads_ = 0;
+};
 }  // namespace
 
 using bluetooth::storage::ConfigCache;
@@ -275,6 +287,50 @@ TEST(ConfigCacheTest, persistent_config_changed_callback_test) {
   ASSERT_EQ(num_change, 4);
 }
 
+TEST(ConfigCacheTest, persistent_section_changed_callback_test) {
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  int num_change = 0;
+  std::vector<std::string> sections;
+  config.SetPersistentConfigChangedCallback([&num_change] { num_change++; });
+  config.SetPersistentSectionChangedCallback([&sections](const std::string& section) { sections.push_back(section); });
+  config.SetProperty("A", "B", "C");
+  config.SetProperty("AA:BB:CC:DD:EE:FF", "B", "C");
+  config.SetProperty("CC:DD:EE:FF:00:11", "B", "AABBAABBCCDDEE");
+  config.SetProperty("CC:DD:EE:FF:00:11", "LinkKey", "AABBAABBCCDDEE");
+  ASSERT_EQ(
+      config.SerializeSectionToLegacyFormat("CC:DD:EE:FF:00:11"),
+      "[CC:DD:EE:FF:00:11]\nB = AABBAABBCCDDEE\nLinkKey = AABBAABBCCDDEE\n\n");
+  config.RemoveProperty("CC:DD:EE:FF:00:11", "LinkKey");
+  // Unpaired devices are not persisted
+  ASSERT_EQ(config.SerializeSectionToLegacyFormat("CC:DD:EE:FF:00:11"), "[CC:DD:EE:FF:00:11]\n\n");
+  config.RemoveSection("A");
+  ASSERT_THAT(sections, ElementsAre("A", "CC:DD:EE:FF:00:11", "CC:DD:EE:FF:00:11", "A"));
+  ASSERT_EQ(num_change, 0);
+  config.SetProperty("A", "B", "C");
+  config.RemoveSectionWithProperty("B");
+  ASSERT_EQ(num_change, 1);
+}
+
+TEST(ConfigCacheTest, persistent_generation_test) {
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  config.SetPersistentSectionChangedCallback([](const std::string& section) {});
+  uint64_t generation = config.GetPersistentGeneration();
+  // Temporary devices don't count
+  config.SetProperty("AA:BB:CC:DD:EE:FF", "B", "C");
+  ASSERT_EQ(config.GetPersistentGeneration(), generation);
+  config.SetProperty("AA:BB:CC:DD:EE:FF", "LinkKey", "AABBAABBCCDDEE");
+  ASSERT_GT(config.GetPersistentGeneration(), generation);
+  generation = config.GetPersistentGeneration();
+  config.SetProperty("AA:BB:CC:DD:EE:FF", "Name", "Headset");
+  ASSERT_GT(config.GetPersistentGeneration(), generation);
+  generation = config.GetPersistentGeneration();
+  config.Clear();
+  ASSERT_GT(config.GetPersistentGeneration(), generation);
+  generation = config.GetPersistentGeneration();
+  config = ConfigCache(100, Device::kLinkKeyProperties);
+  ASSERT_GT(config.GetPersistentGeneration(), generation);
+}
+
 TEST(ConfigCacheTest, fix_device_type_inconsistency_missing_devtype_no_keys_test) {
   ConfigCache config(100, Device::kLinkKeyProperties);
   config.SetProperty("A", "B", "C");
@@ -391,6 +447,57 @@ TEST(ConfigCacheTest, test_get_section_with_property) {
           SectionAndPropertyValue{.section = "AA:BB:CC:DD:EE:FF", .property = "C"}));
 }
 
+TEST(ConfigCacheTest, test_get_section_with_property_index) {
+  ConfigCache config(2, Device::kLinkKeyProperties);
+  config.SetProperty("A", "B", "C");
+  config.SetProperty("AA:BB:CC:DD:EE:FF", "B", "C");
+  ASSERT_THAT(config.GetSectionNamesWithProperty("B"), SizeIs(2));
+  // The index follows the changes made after the first look up
+  config.SetProperty("CC:DD:EE:FF:00:11", "B", "D");
+  config.SetProperty("CC:DD:EE:FF:00:11", "LinkKey", "AABBAABBCCDDEE");
+  config.RemoveProperty("A", "B");
+  ASSERT_THAT(
+      config.GetSectionNamesWithProperty("B"),
+      ElementsAre(
+          SectionAndPropertyValue{.section = "CC:DD:EE:FF:00:11", .property = "D"},
+          SectionAndPropertyValue{.section = "AA:BB:CC:DD:EE:FF", .property = "C"}));
+  // Evicted temporary devices
+  config.SetProperty("AA:BB:CC:DD:EE:01", "C", "D");
+  config.SetProperty("AA:BB:CC:DD:EE:02", "C", "D");
+  ASSERT_FALSE(config.HasSection("AA:BB:CC:DD:EE:FF"));
+  ASSERT_THAT(
+      config.GetSectionNamesWithProperty("B"),
+      ElementsAre(SectionAndPropertyValue{.section = "CC:DD:EE:FF:00:11", .property = "D"}));
+  config.RemoveSection("CC:DD:EE:FF:00:11");
+  ASSERT_THAT(config.GetSectionNamesWithProperty("B"), IsEmpty());
+  config.SetProperty("A", "B", "C");
+  config.Clear();
+  ASSERT_THAT(config.GetSectionNamesWithProperty("B"), IsEmpty());
+}
+
+TEST(ConfigCacheTest, concurrent_readers_test) {
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  config.SetProperty("CC:DD:EE:FF:00:11", "LinkKey", "AABBAABBCCDDEE");
+  config.SetProperty("AA:BB:CC:DD:EE:FF", "B", "C");
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; i++) {
+    readers.emplace_back([&config] {
+      for (int j = 0; j < 1000; j++) {
+        ASSERT_THAT(config.GetProperty("CC:DD:EE:FF:00:11", "LinkKey"), Optional(StrEq("AABBAABBCCDDEE")));
+        ASSERT_THAT(config.GetProperty("AA:BB:CC:DD:EE:FF", "B"), Optional(StrEq("C")));
+        ASSERT_THAT(config.GetSectionNamesWithProperty("LinkKey"), SizeIs(1));
+      }
+    });
+  }
+  for (int j = 0; j < 1000; j++) {
+    config.SetProperty("CC:DD:EE:FF:00:11", "Name", std::to_string(j));
+  }
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  ASSERT_THAT(config.GetProperty("CC:DD:EE:FF:00:11", "Name"), Optional(StrEq("999")));
+}
+
 TEST(ConfigCacheTest, test_get_sections_matching_at_least_one_property) {
   ConfigCache config(100, Device::kLinkKeyProperties);
   config.SetProperty("A", "B", "C");
@@ -413,4 +520,81 @@ TEST(ConfigCacheTest, test_empty_persistent_properties) {
   ASSERT_THAT(config.GetPersistentSections(), ElementsAre());
 }
 
-}  // namespace testing
\ No newline at end of file
+TEST(ConfigCacheTest, lazy_property_test) {
+  auto source = std::make_shared<FakeLazyValueSource>("0123456789");
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  config.SetProperty("AA:BB:CC:DD:EE:FF", "LinkKey", "AABBAABBCCDDEE");
+  config.SetLazyProperty("AA:BB:CC:DD:EE:FF", "HidDescriptor", source, 2, 4);
+  config.SetLazyProperty("AA:BB:CC:DD:EE:FF", "SinkPacsBin", source, 6, 3);
+  EXPECT_EQ(source->num_reads_, 0);
+  EXPECT_TRUE(config.HasProperty("AA:BB:CC:DD:EE:FF", "HidDescriptor"));
+  EXPECT_EQ(source->num_reads_, 0);
+  // Read on each access
+  EXPECT_THAT(config.GetProperty("AA:BB:CC:DD:EE:FF", "HidDescriptor"), Optional(StrEq("2345")));
+  EXPECT_THAT(config.GetProperty("AA:BB:CC:DD:EE:FF", "HidDescriptor"), Optional(StrEq("2345")));
+  EXPECT_EQ(source->num_reads_, 2);
+  EXPECT_EQ(
+      config.SerializeToLegacyFormat(),
+      "[AA:BB:CC:DD:EE:FF]\n"
+      "LinkKey = AABBAABBCCDDEE\n"
+      "HidDescriptor = 2345\n"
+      "SinkPacsBin = 678\n"
+      "\n");
+
+  // Once set again, the property holds its value
+  config.SetProperty("AA:BB:CC:DD:EE:FF", "HidDescriptor", "");
+  source->num_reads_ = 0;
+  EXPECT_THAT(config.GetProperty("AA:BB:CC:DD:EE:FF", "HidDescriptor"), Optional(StrEq("")));
+  EXPECT_EQ(source->num_reads_, 0);
+
+  // Lazy properties are compared by value
+  ConfigCache config_copy(100, Device::kLinkKeyProperties);
+  config_copy.SetProperty("AA:BB:CC:DD:EE:FF", "LinkKey", "AABBAABBCCDDEE");
+  config_copy.SetProperty("AA:BB:CC:DD:EE:FF", "HidDescriptor", "");
+  config_copy.SetProperty("AA:BB:CC:DD:EE:FF", "SinkPacsBin", "678");
+  EXPECT_EQ(config, config_copy);
+  config_copy.SetProperty("AA:BB:CC:DD:EE:FF", "SinkPacsBin", "679");
+  EXPECT_NE(config, config_copy);
+
+  // Unpaired devices keep their lazy properties
+  EXPECT_TRUE(config.RemoveProperty("AA:BB:CC:DD:EE:FF", "LinkKey"));
+  EXPECT_THAT(config.GetPersistentSections(), ElementsAre());
+  EXPECT_THAT(config.GetProperty("AA:BB:CC:DD:EE:FF", "SinkPacsBin"), Optional(StrEq("678")));
+  EXPECT_TRUE(config.RemoveSection("AA:BB:CC:DD:EE:FF"));
+  EXPECT_FALSE(config.GetProperty("AA:BB:CC:DD:EE:FF", "SinkPacsBin"));
+  // A new device with the same address doesn't get them back
+  config.SetProperty("AA:BB:CC:DD:EE:FF", "SinkPacsBin", "");
+  EXPECT_THAT(config.GetProperty("AA:BB:CC:DD:EE:FF", "SinkPacsBin"), Optional(StrEq("")));
+}
+
+TEST(ConfigCacheTest, temporary_device_stats_test) {
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  config.SetProperty("A", "B", "C");
+  config.SetProperty(GetTestAddress(0), "Name", "0");
+  config.SetProperty(GetTestAddress(1), "Name", "1");
+  // Information and persistent sections are not looked up among the temporary devices
+  EXPECT_TRUE(config.HasSection("A"));
+  EXPECT_THAT(config.GetProperty(GetTestAddress(0), "Name"), Optional(StrEq("0")));
+  EXPECT_FALSE(config.HasSection(GetTestAddress(2)));
+  auto stats = config.GetTemporaryDeviceStats();
+  EXPECT_EQ(stats.size, 2u);
+  EXPECT_EQ(stats.capacity, 100u);
+  EXPECT_EQ(stats.hits, 1u);
+  EXPECT_EQ(stats.misses, 1u);
+  EXPECT_EQ(stats.evictions, 0u);
+
+  // Paired devices are no longer temporary, and are temporary again once unpaired
+  config.SetProperty(GetTestAddress(1), "LinkKey", "AABBAABBCCDDEE");
+  EXPECT_EQ(config.GetTemporaryDeviceStats().size, 1u);
+  EXPECT_THAT(
+      config.GetSectionNamesWithProperty("Name"),
+      ElementsAre(SectionAndPropertyValue{GetTestAddress(1), "1"}, SectionAndPropertyValue{GetTestAddress(0), "0"}));
+  EXPECT_TRUE(config.RemoveProperty(GetTestAddress(1), "LinkKey"));
+  EXPECT_EQ(config.GetTemporaryDeviceStats().size, 2u);
+  EXPECT_THAT(
+      config.GetSectionNamesWithProperty("Name"),
+      UnorderedElementsAre(
+          SectionAndPropertyValue{GetTestAddress(1), "1"}, SectionAndPropertyValue{GetTestAddress(0), "0"}));
+}
+
+}  // namespace testing
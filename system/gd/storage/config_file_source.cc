@@ -0,0 +1,99 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "storage/config_file_source.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "os/log.h"
+#include "os/utils.h"
+
+namespace bluetooth {
+namespace storage {
+
+std::shared_ptr<ConfigFileSource> ConfigFileSource::Open(const std::string& path, Encoding encoding) {
+  int fd;
+  RUN_NO_INTR(fd = open(path.c_str(), O_RDONLY | O_CLOEXEC));
+  if (fd < 0) {
+    LOG_ERROR("unable to open file '%s', error: %s", path.c_str(), strerror(errno));
+    return nullptr;
+  }
+  return std::make_shared<ConfigFileSource>(fd, encoding);
+}
+
+ConfigFileSource::ConfigFileSource(int fd, Encoding encoding) : fd_(fd), encoding_(encoding) {
+  ASSERT(fd_ >= 0);
+}
+
+ConfigFileSource::~ConfigFileSource() {
+  close(fd_);
+}
+
+std::optional<std::string> ConfigFileSource::ReadAll() const {
+  struct stat file_stat;
+  if (fstat(fd_, &file_stat) != 0) {
+    LOG_ERROR("unable to get file size, error: %s", strerror(errno));
+    return std::nullopt;
+  }
+  std::string data(static_cast<size_t>(file_stat.st_size), '\0');
+  size_t size = 0;
+  while (size < data.size()) {
+    ssize_t result;
+    RUN_NO_INTR(result = pread(fd_, data.data() + size, data.size() - size, size));
+    if (result <= 0) {
+      LOG_ERROR("unable to read file, error: %s", result < 0 ? strerror(errno) : "end of file");
+      return std::nullopt;
+    }
+    size += result;
+  }
+  return data;
+}
+
+std::optional<std::string> ConfigFileSource::Read(uint64_t offset, size_t length) const {
+  static constexpr char kHexDigits[] = "0123456789abcdef";
+  std::string data(length, '\0');
+  size_t size = 0;
+  while (size < length) {
+    ssize_t result;
+    RUN_NO_INTR(result = pread(fd_, data.data() + size, length - size, offset + size));
+    if (result <= 0) {
+      LOG_ERROR(
+          "unable to read %zu bytes at %llu, error: %s",
+          length,
+          static_cast<unsigned long long>(offset),
+          result < 0 ? strerror(errno) : "end of file");
+      return std::nullopt;
+    }
+    size += result;
+  }
+  if (encoding_ == Encoding::RAW) {
+    return data;
+  }
+  std::string value(length * 2, '\0');
+  for (size_t i = 0; i < length; i++) {
+    uint8_t byte = static_cast<uint8_t>(data[i]);
+    value[2 * i] = kHexDigits[byte >> 4];
+    value[2 * i + 1] = kHexDigits[byte & 0xf];
+  }
+  return value;
+}
+
+}  // namespace storage
+}  // namespace bluetooth
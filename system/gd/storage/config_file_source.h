@@ -0,0 +1,58 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "storage/config_cache.h"
+
+namespace bluetooth {
+namespace storage {
+
+// Config file kept open to read the lazy properties of the config cache loaded from it
+//
+// The config files are replaced by new ones when saved, never written in place, so the values can still be read from
+// the open file once it is renamed or removed
+class ConfigFileSource : public ConfigCache::LazyValueSource {
+ public:
+  // How the values are stored in the file
+  enum class Encoding {
+    // As they are in the config
+    RAW,
+    // As bytes, the values are their lowercase hex string
+    HEX,
+  };
+  // Return nullptr if the file cannot be opened
+  static std::shared_ptr<ConfigFileSource> Open(const std::string& path, Encoding encoding);
+  ConfigFileSource(int fd, Encoding encoding);
+  ConfigFileSource(const ConfigFileSource&) = delete;
+  ConfigFileSource& operator=(const ConfigFileSource&) = delete;
+  ~ConfigFileSource() override;
+
+  // Read the whole file
+  std::optional<std::string> ReadAll() const;
+  std::optional<std::string> Read(uint64_t offset, size_t length) const override;
+
+ private:
+  int fd_;
+  Encoding encoding_;
+};
+
+}  // namespace storage
+}  // namespace bluetooth
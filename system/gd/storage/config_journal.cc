@@ -0,0 +1,105 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "storage/config_journal.h"
+
+#include <utility>
+#include <vector>
+
+#include "common/strings.h"
+#include "os/files.h"
+#include "os/log.h"
+
+namespace bluetooth {
+namespace storage {
+
+// Terminates each record, a record is only complete once its terminator is on disk
+static const std::string kRecordTerminator = "\n\n";
+
+ConfigJournal::ConfigJournal(std::string path) : path_(std::move(path)) {
+  ASSERT(!path_.empty());
+}
+
+size_t ConfigJournal::Replay(ConfigCache* cache) {
+  ASSERT(cache != nullptr);
+  size_ = 0;
+  if (!os::FileExists(path_)) {
+    return 0;
+  }
+  auto journal = os::ReadSmallFile(path_);
+  if (!journal) {
+    return 0;
+  }
+  size_ = journal->size();
+  size_t num_records = 0;
+  size_t begin = 0;
+  while (begin < journal->size()) {
+    size_t end = journal->find(kRecordTerminator, begin);
+    if (end == std::string::npos) {
+      LOG_WARN("ignoring incomplete record at offset %zu of '%s'", begin, path_.c_str());
+      break;
+    }
+    auto lines = common::StringSplit(journal->substr(begin, end - begin), "\n");
+    begin = end + kRecordTerminator.size();
+    const auto& header = lines.front();
+    if (header.size() < 3 || header.front() != '[' || header.back() != ']') {
+      LOG_WARN("invalid section name at record %zu of '%s'", num_records, path_.c_str());
+      break;
+    }
+    std::vector<std::pair<std::string, std::string>> properties;
+    for (size_t i = 1; i < lines.size(); i++) {
+      auto tokens = common::StringSplit(lines[i], "=", 2);
+      if (tokens.size() != 2) {
+        break;
+      }
+      properties.emplace_back(common::StringTrim(std::move(tokens[0])), common::StringTrim(std::move(tokens[1])));
+    }
+    if (properties.size() != lines.size() - 1) {
+      LOG_WARN("no key/value separator found at record %zu of '%s'", num_records, path_.c_str());
+      break;
+    }
+    // Read 'text' from '[text]', hence -2
+    std::string section = header.substr(1, header.size() - 2);
+    cache->RemoveSection(section);
+    for (auto& property : properties) {
+      cache->SetProperty(section, std::move(property.first), std::move(property.second));
+    }
+    num_records++;
+  }
+  return num_records;
+}
+
+bool ConfigJournal::Append(const ConfigCache& cache, const std::set<std::string>& sections) {
+  std::string records;
+  for (const auto& section : sections) {
+    records += cache.SerializeSectionToLegacyFormat(section);
+  }
+  if (!os::AppendToFile(path_, records)) {
+    return false;
+  }
+  size_ += records.size();
+  return true;
+}
+
+bool ConfigJournal::Delete() {
+  size_ = 0;
+  if (!os::FileExists(path_)) {
+    return true;
+  }
+  return os::RemoveFile(path_);
+}
+
+}  // namespace storage
+}  // namespace bluetooth
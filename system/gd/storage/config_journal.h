@@ -0,0 +1,56 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <set>
+#include <string>
+#include <utility>
+
+#include "storage/config_cache.h"
+
+namespace bluetooth {
+namespace storage {
+
+// Append-only journal of the changes made to the persistent sections of a config cache since the config file was last
+// written
+//
+// Each record holds the whole persistent content of one section in the legacy config format, followed by an empty
+// line. A record without any property removes its section. Replaying the records in order on top of the config file
+// restores the config cache, and an incomplete record left by a crash is ignored.
+class ConfigJournal {
+ public:
+  static ConfigJournal FromPath(std::string path) {
+    return ConfigJournal(std::move(path));
+  }
+  explicit ConfigJournal(std::string path);
+  // Apply the records on disk to |cache|, return the number of records applied
+  size_t Replay(ConfigCache* cache);
+  // Append a record for each of |sections| with their current content in |cache| and sync them to disk
+  bool Append(const ConfigCache& cache, const std::set<std::string>& sections);
+  // Remove the journal from disk, return true if it no longer exists
+  bool Delete();
+  // Size of the journal on disk, as of the last call to the methods above
+  size_t Size() const {
+    return size_;
+  }
+
+ private:
+  std::string path_;
+  size_t size_ = 0;
+};
+
+}  // namespace storage
+}  // namespace bluetooth
@@ -0,0 +1,102 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/config_journal.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+
+#include "os/files.h"
+#include "storage/device.h"
+#include "storage/legacy_config_file.h"
+
+namespace testing {
+
+using bluetooth::os::AppendToFile;
+using bluetooth::storage::ConfigCache;
+using bluetooth::storage::ConfigJournal;
+using bluetooth::storage::Device;
+using bluetooth::storage::LegacyConfigFile;
+
+class ConfigJournalTest : public Test {
+ protected:
+  void SetUp() override {
+    temp_journal_ = std::filesystem::temp_directory_path() / "temp_config.journal";
+    ASSERT_TRUE(ConfigJournal::FromPath(temp_journal_.string()).Delete());
+  }
+
+  void TearDown() override {
+    ASSERT_TRUE(ConfigJournal::FromPath(temp_journal_.string()).Delete());
+  }
+
+  std::filesystem::path temp_journal_;
+};
+
+TEST_F(ConfigJournalTest, append_and_replay_loop_back_test) {
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  config.SetProperty("A", "B", "C");
+  config.SetProperty("AA:BB:CC:DD:EE:FF", "B", "C");
+  config.SetProperty("CC:DD:EE:FF:00:11", "LinkKey", "AABBAABBCCDDEE");
+  ConfigCache replayed(100, Device::kLinkKeyProperties);
+  replayed.SetProperty("A", "D", "E");
+  replayed.SetProperty("DD:EE:FF:00:11:22", "LinkKey", "AABBAABBCCDDEE");
+
+  auto journal = ConfigJournal::FromPath(temp_journal_.string());
+  ASSERT_TRUE(journal.Append(config, {"A", "AA:BB:CC:DD:EE:FF", "CC:DD:EE:FF:00:11"}));
+  config.RemoveProperty("CC:DD:EE:FF:00:11", "LinkKey");
+  ASSERT_TRUE(journal.Append(config, {"CC:DD:EE:FF:00:11"}));
+  config.SetProperty("CC:DD:EE:FF:00:11", "LinkKey", "BBAABBAACCDDEE");
+  ASSERT_TRUE(journal.Append(config, {"CC:DD:EE:FF:00:11"}));
+  EXPECT_EQ(journal.Size(), std::filesystem::file_size(temp_journal_));
+
+  EXPECT_EQ(ConfigJournal::FromPath(temp_journal_.string()).Replay(&replayed), 5u);
+  // Sections are replaced as a whole, unpaired devices are not journaled
+  EXPECT_FALSE(replayed.HasProperty("A", "D"));
+  EXPECT_FALSE(replayed.HasSection("AA:BB:CC:DD:EE:FF"));
+  EXPECT_THAT(replayed.GetProperty("CC:DD:EE:FF:00:11", "LinkKey"), Optional(StrEq("BBAABBAACCDDEE")));
+  EXPECT_THAT(replayed.GetPersistentSections(), ElementsAre("DD:EE:FF:00:11:22", "CC:DD:EE:FF:00:11"));
+  EXPECT_EQ(replayed.SerializeToLegacyFormat(), "[A]\nB = C\n\n"
+                                                "[DD:EE:FF:00:11:22]\nLinkKey = AABBAABBCCDDEE\n\n"
+                                                "[CC:DD:EE:FF:00:11]\nLinkKey = BBAABBAACCDDEE\n\n");
+}
+
+TEST_F(ConfigJournalTest, incomplete_record_test) {
+  ASSERT_TRUE(AppendToFile(temp_journal_.string(), "[A]\nB = C\n\n[A]\nB = D\n"));
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  auto journal = ConfigJournal::FromPath(temp_journal_.string());
+  EXPECT_EQ(journal.Replay(&config), 1u);
+  EXPECT_THAT(config.GetProperty("A", "B"), Optional(StrEq("C")));
+  EXPECT_EQ(journal.Size(), std::filesystem::file_size(temp_journal_));
+}
+
+TEST_F(ConfigJournalTest, remove_section_record_test) {
+  ASSERT_TRUE(AppendToFile(temp_journal_.string(), "[A]\nB = C\n\n[A]\n\n"));
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  EXPECT_EQ(ConfigJournal::FromPath(temp_journal_.string()).Replay(&config), 2u);
+  EXPECT_FALSE(config.HasSection("A"));
+}
+
+TEST_F(ConfigJournalTest, replay_non_existing_journal_test) {
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  auto journal = ConfigJournal::FromPath(temp_journal_.string());
+  EXPECT_EQ(journal.Replay(&config), 0u);
+  EXPECT_EQ(journal.Size(), 0u);
+  EXPECT_TRUE(journal.Delete());
+}
+
+}  // namespace testing
@@ -16,13 +16,10 @@
 
 #include "storage/legacy_config_file.h"
 
-#include <cerrno>
-#include <fstream>
-#include <sstream>
-
 #include "common/strings.h"
 #include "os/files.h"
 #include "os/log.h"
+#include "storage/config_file_source.h"
 #include "storage/device.h"
 
 namespace bluetooth {
@@ -34,18 +31,29 @@ LegacyConfigFile::LegacyConfigFile(std::string path) : path_(std::move(path)) {
 
 std::optional<ConfigCache> LegacyConfigFile::Read(size_t temp_devices_capacity) {
   ASSERT(!path_.empty());
-  std::ifstream config_file(path_);
-  if (!config_file || !config_file.is_open()) {
-    LOG_ERROR("unable to open file '%s', error: %s", path_.c_str(), strerror(errno));
+  auto source = ConfigFileSource::Open(path_, ConfigFileSource::Encoding::RAW);
+  if (!source) {
+    return std::nullopt;
+  }
+  auto data = source->ReadAll();
+  if (!data) {
+    LOG_ERROR("unable to read file '%s'", path_.c_str());
     return std::nullopt;
   }
   int line_num = 0;
   ConfigCache cache(temp_devices_capacity, Device::kLinkKeyProperties);
-  std::string line;
   std::string section(ConfigCache::kDefaultSectionName);
-  while (std::getline(config_file, line)) {
+  size_t line_begin = 0;
+  while (line_begin < data->size()) {
+    size_t line_end = data->find('\n', line_begin);
+    if (line_end == std::string::npos) {
+      line_end = data->size();
+    }
     ++line_num;
-    line = common::StringTrim(std::move(line));
+    std::string raw_line = data->substr(line_begin, line_end - line_begin);
+    size_t line_offset = line_begin;
+    line_begin = line_end + 1;
+    std::string line = common::StringTrim(raw_line);
     if (line.front() == '\0' || line.front() == '#') {
       continue;
     }
@@ -64,6 +72,12 @@ std::optional<ConfigCache> LegacyConfigFile::Read(size_t temp_devices_capacity)
       }
       tokens[0] = common::StringTrim(std::move(tokens[0]));
       tokens[1] = common::StringTrim(std::move(tokens[1]));
+      if (ConfigCache::IsDeviceSection(section) && tokens[1].size() >= ConfigCache::kMinLazyValueSize) {
+        // Only whitespaces are trimmed between the separator and the value
+        size_t value_offset = line_offset + raw_line.find(tokens[1], raw_line.find('=') + 1);
+        cache.SetLazyProperty(section, std::move(tokens[0]), source, value_offset, tokens[1].size());
+        continue;
+      }
       cache.SetProperty(section, tokens[0], std::move(tokens[1]));
     }
   }
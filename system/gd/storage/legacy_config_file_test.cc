@@ -184,4 +184,50 @@ TEST(LegacyConfigFileTest, duplicate_section_and_key_test) {
   EXPECT_TRUE(std::filesystem::remove(temp_config));
 }
 
-}  // namespace testing
\ No newline at end of file
+TEST(LegacyConfigFileTest, lazy_property_test) {
+  auto temp_dir = std::filesystem::temp_directory_path();
+  auto temp_config = temp_dir / "temp_config.txt";
+  auto temp_backup_config = temp_dir / "temp_config.bak";
+  const std::string descriptor(ConfigCache::kMinLazyValueSize, 'a');
+  const std::string name(ConfigCache::kMinLazyValueSize - 1, 'n');
+  ASSERT_TRUE(WriteToFile(
+      temp_config.string(),
+      "[Adapter]\n"
+      "Address = 01:02:03:ab:cd:ef\n"
+      "\n"
+      "[01:02:03:ab:cd:ea]\n"
+      "LinkKey = fedcba0987654321fedcba0987654328\n"
+      "  HidDescriptor \t=  " +
+          descriptor +
+          " \r\n"
+          "Name = " +
+          name +
+          "\n"
+          "\n"
+          "[01:02:03:ab:cd:eb]\n"
+          "LinkKey = fedcba0987654321fedcba0987654329\n"
+          "SinkPacsBin = " +
+          descriptor + "bb"));
+
+  auto config_read = LegacyConfigFile::FromPath(temp_config.string()).Read(100);
+  ASSERT_TRUE(config_read);
+  ConfigCache config(100, Device::kLinkKeyProperties);
+  config.SetProperty("Adapter", "Address", "01:02:03:ab:cd:ef");
+  config.SetProperty("01:02:03:ab:cd:ea", "LinkKey", "fedcba0987654321fedcba0987654328");
+  config.SetProperty("01:02:03:ab:cd:ea", "HidDescriptor", descriptor);
+  config.SetProperty("01:02:03:ab:cd:ea", "Name", name);
+  config.SetProperty("01:02:03:ab:cd:eb", "LinkKey", "fedcba0987654321fedcba0987654329");
+  config.SetProperty("01:02:03:ab:cd:eb", "SinkPacsBin", descriptor + "bb");
+  EXPECT_EQ(config, *config_read);
+
+  // The values are still read once the config file is saved again and removed, as when it is replaced by a new one
+  std::filesystem::rename(temp_config, temp_backup_config);
+  EXPECT_TRUE(LegacyConfigFile::FromPath(temp_config.string()).Write(*config_read));
+  EXPECT_TRUE(std::filesystem::remove(temp_backup_config));
+  EXPECT_TRUE(std::filesystem::remove(temp_config));
+  EXPECT_THAT(config_read->GetProperty("01:02:03:ab:cd:ea", "HidDescriptor"), Optional(StrEq(descriptor)));
+  EXPECT_THAT(config_read->GetProperty("01:02:03:ab:cd:eb", "SinkPacsBin"), Optional(StrEq(descriptor + "bb")));
+  EXPECT_EQ(config.SerializeToLegacyFormat(), config_read->SerializeToLegacyFormat());
+}
+
+}  // namespace testing
@@ -20,6 +20,7 @@
 #include <ctime>
 #include <iomanip>
 #include <memory>
+#include <set>
 #include <utility>
 
 #include "common/bind.h"
@@ -29,7 +30,9 @@
 #include "os/handler.h"
 #include "os/parameter_provider.h"
 #include "os/system_properties.h"
+#include "storage/binary_config_file.h"
 #include "storage/config_cache.h"
+#include "storage/config_journal.h"
 #include "storage/legacy_config_file.h"
 #include "storage/mutation.h"
 
@@ -37,11 +40,13 @@ namespace bluetooth {
 namespace storage {
 
 using common::ListMap;
-using common::LruCache;
 using os::Alarm;
 using os::Handler;
 
 static const std::string kFactoryResetProperty = "persist.bluetooth.factoryreset";
+// Save the config in the binary format instead of the legacy one. The legacy config is converted at the next save, and
+// converted back once the property is cleared
+static const std::string kBinaryConfigProperty = "persist.bluetooth.binaryconfig";
 
 static const size_t kDefaultTempDeviceCapacity = 10000;
 // Save config whenever there is a change, but delay it by this value so that burst config change won't overwhelm disk
@@ -49,6 +54,9 @@ static const std::chrono::milliseconds kDefaultConfigSaveDelay = std::chrono::mi
 // Writing a config to disk takes a minimum 10 ms on a decent x86_64 machine, and 20 ms if including backup file
 // The config saving delay must be bigger than this value to avoid overwhelming the disk
 static const std::chrono::milliseconds kMinConfigSaveDelay = std::chrono::milliseconds(20);
+// Saved changes are appended to the journal until it reaches this size, the config file is then rewritten. A config
+// with a few bonded devices is about this size
+static const size_t kMaxConfigJournalSize = 16 * 1024;
 
 const int kConfigFileComparePass = 1;
 const int kConfigBackupComparePass = 2;
@@ -75,6 +83,9 @@ StorageModule::StorageModule(
       is_single_user_mode_(is_single_user_mode) {
   // e.g. "/data/misc/bluedroid/bt_config.conf" to "/data/misc/bluedroid/bt_config.bak"
   config_backup_path_ = config_file_path_.substr(0, config_file_path_.find_last_of('.')) + ".bak";
+  config_journal_path_ = config_file_path_.substr(0, config_file_path_.find_last_of('.')) + ".journal";
+  config_binary_path_ = config_file_path_.substr(0, config_file_path_.find_last_of('.')) + ".bin";
+  config_binary_backup_path_ = config_binary_path_ + ".bak";
   ASSERT_LOG(
       config_save_delay > kMinConfigSaveDelay,
       "Config save delay of %lld ms is not enough, must be at least %lld ms to avoid overwhelming the disk",
@@ -93,12 +104,28 @@ const ModuleFactory StorageModule::Factory = ModuleFactory([]() {
 });
 
 struct StorageModule::impl {
-  explicit impl(Handler* handler, ConfigCache cache, size_t in_memory_cache_size_limit)
-      : config_save_alarm_(handler), cache_(std::move(cache)), memory_only_cache_(in_memory_cache_size_limit, {}) {}
+  explicit impl(Handler* handler, ConfigCache cache, size_t in_memory_cache_size_limit, ConfigJournal journal)
+      : config_save_alarm_(handler),
+        cache_(std::move(cache)),
+        memory_only_cache_(in_memory_cache_size_limit, {}),
+        journal_(std::move(journal)) {}
   Alarm config_save_alarm_;
   ConfigCache cache_;
   ConfigCache memory_only_cache_;
   bool has_pending_config_save_ = false;
+  ConfigJournal journal_;
+  // Disabled in common criteria mode, where only the checksummed config file can be trusted
+  bool journal_enabled_ = true;
+  // Save the config in the binary format, never in common criteria mode either
+  bool binary_config_enabled_ = false;
+  // Changes are reported by |cache_| while it holds its own lock, hence the separate mutex
+  std::mutex changes_mutex_;
+  // Sections changed since the last save
+  std::set<std::string> changed_sections_;
+  // The config file must be rewritten at the next save
+  bool needs_config_write_ = false;
+  // A change spanning several sections made the journal stale, it must be removed before rewriting the config file
+  bool journal_stale_ = false;
 };
 
 Mutation StorageModule::Modify() {
@@ -121,31 +148,100 @@ void StorageModule::SaveDelayed() {
   if (pimpl_->has_pending_config_save_) {
     return;
   }
-  pimpl_->config_save_alarm_.Schedule(
-      common::BindOnce(&StorageModule::SaveImmediately, common::Unretained(this)), config_save_delay_);
+  pimpl_->config_save_alarm_.Schedule(common::BindOnce(&StorageModule::Save, common::Unretained(this)), config_save_delay_);
   pimpl_->has_pending_config_save_ = true;
 }
 
+void StorageModule::Save() {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  pimpl_->has_pending_config_save_ = false;
+  bool write_config = !pimpl_->journal_enabled_ || pimpl_->journal_.Size() >= kMaxConfigJournalSize;
+  std::set<std::string> changed_sections;
+  {
+    std::lock_guard<std::mutex> changes_lock(pimpl_->changes_mutex_);
+    write_config |= pimpl_->needs_config_write_;
+    if (!write_config) {
+      changed_sections.swap(pimpl_->changed_sections_);
+    }
+  }
+  if (write_config) {
+    SaveImmediately();
+    return;
+  }
+  if (changed_sections.empty() || pimpl_->journal_.Append(pimpl_->cache_, changed_sections)) {
+    return;
+  }
+  LOG_WARN("unable to append to config journal at %s, rewriting config", config_journal_path_.c_str());
+  {
+    std::lock_guard<std::mutex> changes_lock(pimpl_->changes_mutex_);
+    pimpl_->journal_stale_ = true;
+  }
+  SaveImmediately();
+}
+
 void StorageModule::SaveImmediately() {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
   if (pimpl_->has_pending_config_save_) {
     pimpl_->config_save_alarm_.Cancel();
     pimpl_->has_pending_config_save_ = false;
   }
-  // 1. rename old config to backup name
-  if (os::FileExists(config_file_path_)) {
-    ASSERT(os::RenameFile(config_file_path_, config_backup_path_));
+  std::set<std::string> changed_sections;
+  bool journal_stale;
+  {
+    std::lock_guard<std::mutex> changes_lock(pimpl_->changes_mutex_);
+    changed_sections.swap(pimpl_->changed_sections_);
+    journal_stale = pimpl_->journal_stale_;
+    pimpl_->needs_config_write_ = false;
+    pimpl_->journal_stale_ = false;
+  }
+  // 0. bring the journal up to date, so that replaying it after a crash during the rewrite gives the config written
+  // below. A stale journal is dropped instead, the config is then as old as the config file until it is rewritten
+  if (pimpl_->journal_.Size() > 0) {
+    if (journal_stale || (!changed_sections.empty() && !pimpl_->journal_.Append(pimpl_->cache_, changed_sections))) {
+      pimpl_->journal_.Delete();
+    }
+  }
+  if (pimpl_->binary_config_enabled_) {
+    // 1. rename old config to backup name
+    if (os::FileExists(config_binary_path_)) {
+      ASSERT(os::RenameFile(config_binary_path_, config_binary_backup_path_));
+    }
+    // 2. write in-memory config to disk, if failed, backup can still be used
+    ASSERT(BinaryConfigFile::FromPath(config_binary_path_).Write(pimpl_->cache_));
+    // 3. now write back up to disk as well
+    ASSERT(BinaryConfigFile::FromPath(config_binary_backup_path_).Write(pimpl_->cache_));
+    // The legacy config is now converted, it would otherwise take precedence at the next start
+    if (os::FileExists(config_file_path_)) {
+      LegacyConfigFile::FromPath(config_file_path_).Delete();
+    }
+    if (os::FileExists(config_backup_path_)) {
+      LegacyConfigFile::FromPath(config_backup_path_).Delete();
+    }
+  } else {
+    // 1. rename old config to backup name
+    if (os::FileExists(config_file_path_)) {
+      ASSERT(os::RenameFile(config_file_path_, config_backup_path_));
+    }
+    // 2. write in-memory config to disk, if failed, backup can still be used
+    ASSERT(LegacyConfigFile::FromPath(config_file_path_).Write(pimpl_->cache_));
+    // 3. now write back up to disk as well
+    ASSERT(LegacyConfigFile::FromPath(config_backup_path_).Write(pimpl_->cache_));
+    // The binary config, if any, is now converted back
+    if (os::FileExists(config_binary_path_)) {
+      BinaryConfigFile::FromPath(config_binary_path_).Delete();
+    }
+    if (os::FileExists(config_binary_backup_path_)) {
+      BinaryConfigFile::FromPath(config_binary_backup_path_).Delete();
+    }
   }
-  // 2. write in-memory config to disk, if failed, backup can still be used
-  ASSERT(LegacyConfigFile::FromPath(config_file_path_).Write(pimpl_->cache_));
-  // 3. now write back up to disk as well
-  ASSERT(LegacyConfigFile::FromPath(config_backup_path_).Write(pimpl_->cache_));
   // 4. save checksum if it is running in common criteria mode
   if (bluetooth::os::ParameterProvider::GetBtKeystoreInterface() != nullptr &&
       bluetooth::os::ParameterProvider::IsCommonCriteriaMode()) {
     bluetooth::os::ParameterProvider::GetBtKeystoreInterface()->set_encrypt_key_or_remove_key(
         kConfigFilePrefix, kConfigFileHash);
   }
+  // 5. the journal is now part of the config file
+  pimpl_->journal_.Delete();
 }
 
 void StorageModule::ListDependencies(ModuleList* list) const {
@@ -159,6 +255,9 @@ void StorageModule::Start() {
     LOG_INFO("%s is true, delete config files", kFactoryResetProperty.c_str());
     LegacyConfigFile::FromPath(config_file_path_).Delete();
     LegacyConfigFile::FromPath(config_backup_path_).Delete();
+    BinaryConfigFile::FromPath(config_binary_path_).Delete();
+    BinaryConfigFile::FromPath(config_binary_backup_path_).Delete();
+    ConfigJournal::FromPath(config_journal_path_).Delete();
     os::SetSystemProperty(kFactoryResetProperty, "false");
   }
   if (!is_config_checksum_pass(kConfigFileComparePass)) {
@@ -167,7 +266,26 @@ void StorageModule::Start() {
   if (!is_config_checksum_pass(kConfigBackupComparePass)) {
     LegacyConfigFile::FromPath(config_backup_path_).Delete();
   }
-  auto config = LegacyConfigFile::FromPath(config_file_path_).Read(temp_devices_capacity_);
+  bool journal_enabled = bluetooth::os::ParameterProvider::GetBtKeystoreInterface() == nullptr ||
+                         !bluetooth::os::ParameterProvider::IsCommonCriteriaMode();
+  std::optional<ConfigCache> config;
+  // The legacy config file is only found next to the binary one when written by an older stack or copied over by a
+  // data migration, it is then the most recent of the two. The binary one isn't checksummed in common criteria mode
+  if (journal_enabled && !os::FileExists(config_file_path_) &&
+      (os::FileExists(config_binary_path_) || os::FileExists(config_binary_backup_path_))) {
+    config = BinaryConfigFile::FromPath(config_binary_path_).Read(temp_devices_capacity_);
+    if (!config || !config->HasSection(kAdapterSection)) {
+      LOG_WARN(
+          "cannot load config at %s, using backup at %s.",
+          config_binary_path_.c_str(),
+          config_binary_backup_path_.c_str());
+      config = BinaryConfigFile::FromPath(config_binary_backup_path_).Read(temp_devices_capacity_);
+      file_source = "Backup";
+    }
+  }
+  if (!config || !config->HasSection(kAdapterSection)) {
+    config = LegacyConfigFile::FromPath(config_file_path_).Read(temp_devices_capacity_);
+  }
   if (!config || !config->HasSection(kAdapterSection)) {
     LOG_WARN("cannot load config at %s, using backup at %s.", config_file_path_.c_str(), config_backup_path_.c_str());
     config = LegacyConfigFile::FromPath(config_backup_path_).Read(temp_devices_capacity_);
@@ -178,6 +296,16 @@ void StorageModule::Start() {
     config.emplace(temp_devices_capacity_, Device::kLinkKeyProperties);
     file_source = "Empty";
   }
+  // Apply the changes saved since the config file was last written
+  auto journal = ConfigJournal::FromPath(config_journal_path_);
+  if (journal_enabled) {
+    size_t num_records = journal.Replay(&config.value());
+    if (num_records > 0) {
+      LOG_INFO("replayed %zu records from config journal at %s", num_records, config_journal_path_.c_str());
+    }
+  } else {
+    journal.Delete();
+  }
   if (!file_source.empty()) {
     config->SetProperty(kInfoSection, kFileSourceProperty, std::move(file_source));
   }
@@ -195,10 +323,33 @@ void StorageModule::Start() {
     config->SetProperty(kInfoSection, kTimeCreatedProperty, ss.str());
   }
   config->FixDeviceTypeInconsistencies();
-  config->SetPersistentConfigChangedCallback([this] { this->CallOn(this, &StorageModule::SaveDelayed); });
+  config->SetPersistentSectionChangedCallback([this](const std::string& section) {
+    {
+      std::lock_guard<std::mutex> changes_lock(pimpl_->changes_mutex_);
+      pimpl_->changed_sections_.insert(section);
+    }
+    this->CallOn(this, &StorageModule::SaveDelayed);
+  });
+  config->SetPersistentConfigChangedCallback([this] {
+    {
+      std::lock_guard<std::mutex> changes_lock(pimpl_->changes_mutex_);
+      pimpl_->needs_config_write_ = true;
+      pimpl_->journal_stale_ = true;
+      pimpl_->changed_sections_.clear();
+    }
+    this->CallOn(this, &StorageModule::SaveDelayed);
+  });
   // TODO (b/158035889) Migrate metrics module to GD
-  pimpl_ = std::make_unique<impl>(GetHandler(), std::move(config.value()), temp_devices_capacity_);
-  SaveDelayed();
+  pimpl_ = std::make_unique<impl>(GetHandler(), std::move(config.value()), temp_devices_capacity_, std::move(journal));
+  pimpl_->journal_enabled_ = journal_enabled;
+  pimpl_->binary_config_enabled_ = journal_enabled && os::GetSystemProperty(kBinaryConfigProperty) == "true";
+  pimpl_->needs_config_write_ = true;
+  if (pimpl_->journal_.Size() > 0) {
+    // Fold the journal into the config file before appending to it, it may end with an incomplete record
+    SaveImmediately();
+  } else {
+    SaveDelayed();
+  }
   if (bluetooth::os::ParameterProvider::GetBtKeystoreInterface() != nullptr) {
     bluetooth::os::ParameterProvider::GetBtKeystoreInterface()->ConvertEncryptOrDecryptKeyIfNeeded();
   }
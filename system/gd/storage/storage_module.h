@@ -121,13 +121,18 @@ class StorageModule : public bluetooth::Module {
   ConfigCache* GetMemoryOnlyConfigCache();
   // Normally, underlying config will be saved at most 3 seconds after the first config change in a series of changes
   // This method triggers the delayed saving automatically, the delay is equal to |config_save_delay_|
+  // The changed sections are appended to a journal next to the config file, which is only rewritten once the journal
+  // grows too large
   void SaveDelayed();
   // In some cases, one may want to save the config immediately to disk. Call this method with caution as it runs
   // immediately on the calling thread
+  // The whole config file is rewritten and the journal is removed
   void SaveImmediately();
 
   // Create the storage module where:
-  // - config_file_path is the path to the config file on disk, a .bak file will be created with the original
+  // - config_file_path is the path to the config file on disk, a .bak file will be created with the original, as well
+  //   as a .journal file holding the changes saved since the config file was last written. When the binary config is
+  //   enabled, the config is saved to a .bin file and its .bin.bak backup instead
   // - config_save_delay is the duration after which to dump config to disk after SaveDelayed() is called
   // - temp_devices_capacity is the number of temporary, typically unpaired devices to hold in a memory based LRU
   // - is_restricted_mode and is_single_user_mode are flags from upper layer
@@ -139,11 +144,17 @@ class StorageModule : public bluetooth::Module {
       bool is_single_user_mode);
 
  private:
+  // Save the changes since the last save, to the journal or by rewriting the config file
+  void Save();
+
   struct impl;
   mutable std::recursive_mutex mutex_;
   std::unique_ptr<impl> pimpl_;
   std::string config_file_path_;
   std::string config_backup_path_;
+  std::string config_journal_path_;
+  std::string config_binary_path_;
+  std::string config_binary_backup_path_;
   std::chrono::milliseconds config_save_delay_;
   size_t temp_devices_capacity_;
   bool is_restricted_mode_;
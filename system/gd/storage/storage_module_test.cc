@@ -29,7 +29,10 @@
 
 #include "module.h"
 #include "os/files.h"
+#include "os/system_properties.h"
+#include "storage/binary_config_file.h"
 #include "storage/config_cache.h"
+#include "storage/config_journal.h"
 #include "storage/device.h"
 #include "storage/legacy_config_file.h"
 
@@ -37,11 +40,14 @@ namespace testing {
 
 using bluetooth::TestModuleRegistry;
 using bluetooth::hci::Address;
+using bluetooth::storage::BinaryConfigFile;
 using bluetooth::storage::ConfigCache;
+using bluetooth::storage::ConfigJournal;
 using bluetooth::storage::Device;
 using bluetooth::storage::LegacyConfigFile;
 using bluetooth::storage::StorageModule;
 
+static const std::string kBinaryConfigProperty = "persist.bluetooth.binaryconfig";
 static const std::chrono::milliseconds kTestConfigSaveDelay = std::chrono::milliseconds(100);
 // Assume it takes at most 1 second to write the file
 static const std::chrono::milliseconds kTestConfigSaveWaitDelay =
@@ -108,12 +114,19 @@ class StorageModuleTest : public Test {
     temp_dir_ = std::filesystem::temp_directory_path();
     temp_config_ = temp_dir_ / "temp_config.txt";
     temp_backup_config_ = temp_dir_ / "temp_config.bak";
+    temp_journal_ = temp_dir_ / "temp_config.journal";
+    temp_binary_config_ = temp_dir_ / "temp_config.bin";
+    temp_binary_backup_config_ = temp_dir_ / "temp_config.bin.bak";
     DeleteConfigFiles();
     ASSERT_FALSE(std::filesystem::exists(temp_config_));
     ASSERT_FALSE(std::filesystem::exists(temp_backup_config_));
+    ASSERT_FALSE(std::filesystem::exists(temp_journal_));
+    ASSERT_FALSE(std::filesystem::exists(temp_binary_config_));
+    ASSERT_FALSE(std::filesystem::exists(temp_binary_backup_config_));
   }
 
   void TearDown() override {
+    bluetooth::os::SetSystemProperty(kBinaryConfigProperty, "false");
     DeleteConfigFiles();
   }
 
@@ -124,11 +137,32 @@ class StorageModuleTest : public Test {
     if (std::filesystem::exists(temp_backup_config_)) {
       ASSERT_TRUE(std::filesystem::remove(temp_backup_config_));
     }
+    if (std::filesystem::exists(temp_journal_)) {
+      ASSERT_TRUE(std::filesystem::remove(temp_journal_));
+    }
+    if (std::filesystem::exists(temp_binary_config_)) {
+      ASSERT_TRUE(std::filesystem::remove(temp_binary_config_));
+    }
+    if (std::filesystem::exists(temp_binary_backup_config_)) {
+      ASSERT_TRUE(std::filesystem::remove(temp_binary_backup_config_));
+    }
+  }
+
+  // Read the config as it would be loaded, with the journal applied
+  std::optional<ConfigCache> ReadSavedConfig() {
+    auto config = LegacyConfigFile::FromPath(temp_config_.string()).Read(10);
+    if (config) {
+      ConfigJournal::FromPath(temp_journal_.string()).Replay(&config.value());
+    }
+    return config;
   }
 
   std::filesystem::path temp_dir_;
   std::filesystem::path temp_config_;
   std::filesystem::path temp_backup_config_;
+  std::filesystem::path temp_journal_;
+  std::filesystem::path temp_binary_config_;
+  std::filesystem::path temp_binary_backup_config_;
 };
 
 TEST_F(StorageModuleTest, empty_config_no_op_test) {
@@ -245,36 +279,46 @@ TEST_F(StorageModuleTest, save_config_test) {
   // Test
   ASSERT_NE(storage->GetConfigCachePublic(), nullptr);
 
+  // Wait for the loaded config to be written back
+  std::this_thread::sleep_for(kTestConfigSaveWaitDelay);
+
   // Change a property
   ASSERT_THAT(
       storage->GetConfigCachePublic()->GetProperty("01:02:03:ab:cd:ea", "name"), Optional(StrEq("hello world")));
   storage->GetConfigCachePublic()->SetProperty("01:02:03:ab:cd:ea", "name", "foo");
   ASSERT_THAT(storage->GetConfigCachePublic()->GetProperty("01:02:03:ab:cd:ea", "name"), Optional(StrEq("foo")));
   std::this_thread::sleep_for(kTestConfigSaveWaitDelay);
-  auto config = LegacyConfigFile::FromPath(temp_config_.string()).Read(10);
+  auto config = ReadSavedConfig();
   ASSERT_TRUE(config);
   ASSERT_THAT(config->GetProperty("01:02:03:ab:cd:ea", "name"), Optional(StrEq("foo")));
+  // Only the journal was written
+  ASSERT_TRUE(std::filesystem::exists(temp_journal_));
+  ASSERT_THAT(
+      LegacyConfigFile::FromPath(temp_config_.string()).Read(10)->GetProperty("01:02:03:ab:cd:ea", "name"),
+      Optional(StrEq("hello world")));
 
   // Remove a property
   storage->GetConfigCachePublic()->RemoveProperty("01:02:03:ab:cd:ea", "name");
   std::this_thread::sleep_for(kTestConfigSaveWaitDelay);
-  config = LegacyConfigFile::FromPath(temp_config_.string()).Read(10);
+  config = ReadSavedConfig();
   ASSERT_TRUE(config);
   ASSERT_FALSE(config->HasProperty("01:02:03:ab:cd:ea", "name"));
 
   // Remove a section
   storage->GetConfigCachePublic()->RemoveSection("01:02:03:ab:cd:ea");
   std::this_thread::sleep_for(kTestConfigSaveWaitDelay);
-  config = LegacyConfigFile::FromPath(temp_config_.string()).Read(10);
+  config = ReadSavedConfig();
   ASSERT_TRUE(config);
   ASSERT_FALSE(config->HasSection("01:02:03:ab:cd:ea"));
 
   // Add a section and save immediately
   storage->GetConfigCachePublic()->SetProperty("01:02:03:ab:cd:eb", "LinkKey", "123456");
   storage->SaveImmediatelyPublic();
+  ASSERT_FALSE(std::filesystem::exists(temp_journal_));
   config = LegacyConfigFile::FromPath(temp_config_.string()).Read(10);
   ASSERT_TRUE(config);
   ASSERT_TRUE(config->HasSection("01:02:03:ab:cd:eb"));
+  ASSERT_FALSE(config->HasSection("01:02:03:ab:cd:ea"));
 
   // Tear down
   test_registry.StopAll();
@@ -283,6 +327,85 @@ TEST_F(StorageModuleTest, save_config_test) {
   ASSERT_TRUE(std::filesystem::exists(temp_config_));
 }
 
+TEST_F(StorageModuleTest, replay_journal_test) {
+  // Prepare config file and the journal left by a crash
+  ASSERT_TRUE(bluetooth::os::WriteToFile(temp_config_.string(), kReadTestConfig));
+  ASSERT_TRUE(bluetooth::os::AppendToFile(
+      temp_journal_.string(),
+      "[01:02:03:ab:cd:ea]\nname = foo\nLinkKey = fedcba0987654321fedcba0987654328\nDevType = 1\n\n"
+      "[01:02:03:ab:cd:eb]\nLinkKey = 123456\n"));
+
+  // Set up
+  auto* storage = new TestStorageModule(temp_config_.string(), kTestConfigSaveDelay, 10, false, false);
+  TestModuleRegistry test_registry;
+  test_registry.InjectTestModule(&StorageModule::Factory, storage);
+
+  // The journal is folded into the config file, without its incomplete record
+  ASSERT_THAT(storage->GetConfigCachePublic()->GetProperty("01:02:03:ab:cd:ea", "name"), Optional(StrEq("foo")));
+  ASSERT_FALSE(storage->GetConfigCachePublic()->HasSection("01:02:03:ab:cd:eb"));
+  ASSERT_FALSE(std::filesystem::exists(temp_journal_));
+  auto config = LegacyConfigFile::FromPath(temp_config_.string()).Read(10);
+  ASSERT_TRUE(config);
+  ASSERT_THAT(config->GetProperty("01:02:03:ab:cd:ea", "name"), Optional(StrEq("foo")));
+
+  // Tear down
+  test_registry.StopAll();
+}
+
+TEST_F(StorageModuleTest, binary_config_test) {
+  // Prepare config file, e.g. copied over by a data migration
+  ASSERT_TRUE(bluetooth::os::WriteToFile(temp_config_.string(), kReadTestConfig));
+  ASSERT_TRUE(bluetooth::os::SetSystemProperty(kBinaryConfigProperty, "true"));
+
+  // The legacy config is converted at the first save
+  {
+    auto* storage = new TestStorageModule(temp_config_.string(), kTestConfigSaveDelay, 10, false, false);
+    TestModuleRegistry test_registry;
+    test_registry.InjectTestModule(&StorageModule::Factory, storage);
+    ASSERT_THAT(
+        storage->GetConfigCachePublic()->GetProperty("01:02:03:ab:cd:ea", "name"), Optional(StrEq("hello world")));
+    std::this_thread::sleep_for(kTestConfigSaveWaitDelay);
+    ASSERT_FALSE(std::filesystem::exists(temp_config_));
+    ASSERT_FALSE(std::filesystem::exists(temp_backup_config_));
+    ASSERT_TRUE(std::filesystem::exists(temp_binary_backup_config_));
+    auto config = BinaryConfigFile::FromPath(temp_binary_config_.string()).Read(10);
+    ASSERT_TRUE(config);
+    ASSERT_EQ(config->SerializeToLegacyFormat(), kReadTestConfigCorrected);
+
+    storage->GetConfigCachePublic()->SetProperty("01:02:03:ab:cd:ea", "name", "foo");
+    test_registry.StopAll();
+  }
+
+  // Loaded from the binary config, with the journal applied
+  {
+    auto* storage = new TestStorageModule(temp_config_.string(), kTestConfigSaveDelay, 10, false, false);
+    TestModuleRegistry test_registry;
+    test_registry.InjectTestModule(&StorageModule::Factory, storage);
+    ASSERT_THAT(storage->GetConfigCachePublic()->GetProperty("01:02:03:ab:cd:ea", "name"), Optional(StrEq("foo")));
+    ASSERT_THAT(
+        storage->GetConfigCachePublic()->GetProperty(StorageModule::kAdapterSection, "Address"),
+        Optional(StrEq("01:02:03:ab:cd:ef")));
+    ASSERT_FALSE(std::filesystem::exists(temp_config_));
+    test_registry.StopAll();
+  }
+
+  // Converted back to the legacy config once disabled
+  ASSERT_TRUE(bluetooth::os::SetSystemProperty(kBinaryConfigProperty, "false"));
+  {
+    auto* storage = new TestStorageModule(temp_config_.string(), kTestConfigSaveDelay, 10, false, false);
+    TestModuleRegistry test_registry;
+    test_registry.InjectTestModule(&StorageModule::Factory, storage);
+    ASSERT_THAT(storage->GetConfigCachePublic()->GetProperty("01:02:03:ab:cd:ea", "name"), Optional(StrEq("foo")));
+    storage->SaveImmediatelyPublic();
+    ASSERT_FALSE(std::filesystem::exists(temp_binary_config_));
+    ASSERT_FALSE(std::filesystem::exists(temp_binary_backup_config_));
+    auto config = LegacyConfigFile::FromPath(temp_config_.string()).Read(10);
+    ASSERT_TRUE(config);
+    ASSERT_THAT(config->GetProperty("01:02:03:ab:cd:ea", "name"), Optional(StrEq("foo")));
+    test_registry.StopAll();
+  }
+}
+
 TEST_F(StorageModuleTest, get_bonded_devices_test) {
   // Prepare config file
   ASSERT_TRUE(bluetooth::os::WriteToFile(temp_config_.string(), kReadTestConfig));
@@ -0,0 +1,288 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "storage/temporary_device_cache.h"
+
+#include <algorithm>
+
+#include "os/log.h"
+
+namespace bluetooth {
+namespace storage {
+
+namespace {
+
+// Shards smaller than this would evict devices too far from the least recently used ones
+constexpr size_t kMinShardCapacity = 256;
+constexpr size_t kMaxNumShards = 16;
+
+}  // namespace
+
+TemporaryDeviceCache::TemporaryDeviceCache(size_t capacity) : capacity_(capacity) {
+  ASSERT_LOG(capacity_ != 0, "Unable to have 0 temporary device capacity");
+  size_t num_shards = std::clamp<size_t>(capacity_ / kMinShardCapacity, 1, kMaxNumShards);
+  shards_.reserve(num_shards);
+  for (size_t i = 0; i < num_shards; i++) {
+    shards_.push_back(std::make_unique<Shard>(capacity_ / num_shards + (i < capacity_ % num_shards ? 1 : 0)));
+  }
+}
+
+bool TemporaryDeviceCache::operator==(const TemporaryDeviceCache& rhs) const {
+  if (&rhs == this) {
+    return true;
+  }
+  if (capacity_ != rhs.capacity_ || shards_.size() != rhs.shards_.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < shards_.size(); i++) {
+    std::scoped_lock lock(shards_[i]->mutex, rhs.shards_[i]->mutex);
+    if (shards_[i]->devices != rhs.shards_[i]->devices) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool TemporaryDeviceCache::operator!=(const TemporaryDeviceCache& rhs) const {
+  return !(*this == rhs);
+}
+
+TemporaryDeviceCache::Shard& TemporaryDeviceCache::GetShard(const std::string& section) const {
+  return *shards_[std::hash<std::string>{}(section) % shards_.size()];
+}
+
+bool TemporaryDeviceCache::HasSection(const std::string& section) const {
+  auto& shard = GetShard(section);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  return shard.Find(section) != nullptr;
+}
+
+bool TemporaryDeviceCache::HasProperty(const std::string& section, const std::string& property) const {
+  auto& shard = GetShard(section);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto properties = shard.Find(section);
+  return properties != nullptr && properties->contains(property);
+}
+
+bool TemporaryDeviceCache::HasAtLeastOneMatchingProperty(
+    const std::string& section, const std::unordered_set<std::string_view>& property_names) const {
+  auto& shard = GetShard(section);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto properties = shard.Find(section);
+  if (properties == nullptr) {
+    return false;
+  }
+  for (const auto& property : *properties) {
+    if (property_names.count(property.first) > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::optional<std::string> TemporaryDeviceCache::GetProperty(
+    const std::string& section, const std::string& property) const {
+  auto& shard = GetShard(section);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto properties = shard.Find(section);
+  if (properties == nullptr) {
+    return std::nullopt;
+  }
+  auto property_iter = properties->find(property);
+  if (property_iter == properties->end()) {
+    return std::nullopt;
+  }
+  return property_iter->second;
+}
+
+std::vector<std::pair<std::string, std::string>> TemporaryDeviceCache::GetSectionNamesWithProperty(
+    const std::string& property) const {
+  std::vector<std::pair<std::string, std::string>> result;
+  for (const auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    auto index_iter = shard->property_index.find(property);
+    if (index_iter == shard->property_index.end()) {
+      // Index the sections with |property| on its first look up, then keep the index up to date
+      index_iter = shard->property_index.try_emplace(property).first;
+      for (const auto& elem : shard->devices) {
+        if (elem.second.contains(property)) {
+          index_iter->second.insert(elem.first);
+        }
+      }
+    }
+    for (const auto& section : index_iter->second) {
+      // Not warming up the devices, as when iterating through them
+      auto section_iter = shard->devices.peek(section);
+      ASSERT(section_iter != shard->devices.end());
+      auto property_iter = section_iter->second.find(property);
+      ASSERT(property_iter != section_iter->second.end());
+      result.emplace_back(section, property_iter->second);
+    }
+  }
+  return result;
+}
+
+TemporaryDeviceCache::Stats TemporaryDeviceCache::GetStats() const {
+  Stats stats = {
+      .size = 0, .capacity = capacity_, .num_shards = shards_.size(), .hits = 0, .misses = 0, .evictions = 0};
+  for (const auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    stats.size += shard->devices.size();
+    stats.hits += shard->hits;
+    stats.misses += shard->misses;
+    stats.evictions += shard->evictions;
+  }
+  return stats;
+}
+
+void TemporaryDeviceCache::SetProperty(const std::string& section, std::string property, std::string value) {
+  auto& shard = GetShard(section);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  // Not counted as a look up
+  auto section_iter = shard.devices.find(section);
+  auto properties =
+      section_iter != shard.devices.end() ? &section_iter->second : shard.Insert(section, Properties{});
+  shard.AddToPropertyIndex(section, property);
+  properties->insert_or_assign(std::move(property), std::move(value));
+}
+
+void TemporaryDeviceCache::InsertSection(const std::string& section, Properties properties) {
+  auto& shard = GetShard(section);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  shard.Insert(section, std::move(properties));
+}
+
+std::optional<TemporaryDeviceCache::Properties> TemporaryDeviceCache::ExtractSection(const std::string& section) {
+  auto& shard = GetShard(section);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto node = shard.devices.extract(section);
+  if (!node) {
+    return std::nullopt;
+  }
+  shard.RemoveSectionFromPropertyIndex(section);
+  return std::move(node->second);
+}
+
+bool TemporaryDeviceCache::RemoveSection(const std::string& section) {
+  return ExtractSection(section).has_value();
+}
+
+bool TemporaryDeviceCache::RemoveProperty(const std::string& section, const std::string& property) {
+  auto& shard = GetShard(section);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto section_iter = shard.devices.find(section);
+  if (section_iter == shard.devices.end()) {
+    return false;
+  }
+  shard.RemoveFromPropertyIndex(section, property);
+  auto value = section_iter->second.extract(property);
+  // if section is empty after removal, remove the whole section as empty section is not allowed
+  if (section_iter->second.size() == 0) {
+    shard.devices.erase(section_iter);
+  }
+  return value.has_value();
+}
+
+void TemporaryDeviceCache::RemoveSectionWithProperty(const std::string& property) {
+  for (const auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    for (auto it = shard->devices.begin(); it != shard->devices.end();) {
+      if (it->second.contains(property)) {
+        LOG_INFO("Removing temporary section %s with property %s", it->first.c_str(), property.c_str());
+        shard->RemoveSectionFromPropertyIndex(it->first);
+        it = shard->devices.erase(it);
+        continue;
+      }
+      it++;
+    }
+  }
+}
+
+bool TemporaryDeviceCache::ModifyEachSection(
+    const std::function<bool(const std::string& section, Properties& properties)>& visitor) {
+  bool modified = false;
+  for (const auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    for (auto& elem : shard->devices) {
+      if (visitor(elem.first, elem.second)) {
+        shard->RemoveSectionFromPropertyIndex(elem.first);
+        for (const auto& property : elem.second) {
+          shard->AddToPropertyIndex(elem.first, property.first);
+        }
+        modified = true;
+      }
+    }
+  }
+  return modified;
+}
+
+void TemporaryDeviceCache::Clear() {
+  for (const auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    shard->devices.clear();
+    for (auto& index : shard->property_index) {
+      index.second.clear();
+    }
+  }
+}
+
+TemporaryDeviceCache::Properties* TemporaryDeviceCache::Shard::Find(const std::string& section) const {
+  auto section_iter = devices.find(section);
+  if (section_iter == devices.end()) {
+    misses++;
+    return nullptr;
+  }
+  hits++;
+  return &section_iter->second;
+}
+
+TemporaryDeviceCache::Properties* TemporaryDeviceCache::Shard::Insert(
+    const std::string& section, Properties properties) {
+  RemoveSectionFromPropertyIndex(section);
+  auto evicted = devices.insert_or_assign(section, std::move(properties));
+  if (evicted) {
+    evictions++;
+    RemoveSectionFromPropertyIndex(evicted->first);
+  }
+  // The section is now the most recently used one
+  auto& inserted = devices.begin()->second;
+  for (const auto& property : inserted) {
+    AddToPropertyIndex(section, property.first);
+  }
+  return &inserted;
+}
+
+void TemporaryDeviceCache::Shard::AddToPropertyIndex(const std::string& section, const std::string& property) {
+  auto index_iter = property_index.find(property);
+  if (index_iter != property_index.end()) {
+    index_iter->second.insert(section);
+  }
+}
+
+void TemporaryDeviceCache::Shard::RemoveFromPropertyIndex(const std::string& section, const std::string& property) {
+  auto index_iter = property_index.find(property);
+  if (index_iter != property_index.end()) {
+    index_iter->second.erase(section);
+  }
+}
+
+void TemporaryDeviceCache::Shard::RemoveSectionFromPropertyIndex(const std::string& section) {
+  for (auto& index : property_index) {
+    index.second.erase(section);
+  }
+}
+
+}  // namespace storage
+}  // namespace bluetooth
@@ -0,0 +1,127 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "common/list_map.h"
+#include "common/fixed_lru_cache.h"
+
+namespace bluetooth {
+namespace storage {
+
+// Sections of the temporary devices of a config cache, normally unpaired, evicted from the least recently used once
+// the capacity is reached
+//
+// The devices are split into shards by address, each with its own LRU cache and lock, so that the devices found while
+// scanning are added and looked up concurrently. Small capacities have a single shard, so that the eviction order is
+// exactly the least recently used one. This class is thread safe
+class TemporaryDeviceCache {
+ public:
+  using Properties = common::ListMap<std::string, std::string>;
+
+  struct Stats {
+    size_t size;
+    size_t capacity;
+    size_t num_shards;
+    // Look ups of a section found, or not, among the temporary devices
+    uint64_t hits;
+    uint64_t misses;
+    // Devices evicted to make room for new ones
+    uint64_t evictions;
+  };
+
+  explicit TemporaryDeviceCache(size_t capacity);
+
+  TemporaryDeviceCache(const TemporaryDeviceCache&) = delete;
+  TemporaryDeviceCache& operator=(const TemporaryDeviceCache&) = delete;
+
+  // can move, but not concurrently with any other access
+  TemporaryDeviceCache(TemporaryDeviceCache&& other) noexcept = default;
+  TemporaryDeviceCache& operator=(TemporaryDeviceCache&& other) noexcept = default;
+
+  // comparison operators, the statistics don't count
+  bool operator==(const TemporaryDeviceCache& rhs) const;
+  bool operator!=(const TemporaryDeviceCache& rhs) const;
+
+  // observers, all of them warm up the section they look up
+  bool HasSection(const std::string& section) const;
+  bool HasProperty(const std::string& section, const std::string& property) const;
+  // Return true if the section has one of the properties in |property_names|
+  bool HasAtLeastOneMatchingProperty(
+      const std::string& section, const std::unordered_set<std::string_view>& property_names) const;
+  std::optional<std::string> GetProperty(const std::string& section, const std::string& property) const;
+  // Return pair<section_name, property_value> for all the sections with |property|, without warming them up. The
+  // sections with |property| are indexed on the first call, so that the next calls don't scan the whole cache
+  std::vector<std::pair<std::string, std::string>> GetSectionNamesWithProperty(const std::string& property) const;
+  Stats GetStats() const;
+
+  // modifiers
+  void SetProperty(const std::string& section, std::string property, std::string value);
+  // Add |section| with |properties|, replacing the existing one if any
+  void InsertSection(const std::string& section, Properties properties);
+  // Remove |section| and return its properties if there is one
+  std::optional<Properties> ExtractSection(const std::string& section);
+  bool RemoveSection(const std::string& section);
+  // Remove |property|, and its section if it was the last one
+  bool RemoveProperty(const std::string& section, const std::string& property);
+  // Remove the sections with |property| set
+  void RemoveSectionWithProperty(const std::string& property);
+  // Call |visitor| with each section, |visitor| returns true if it modified the properties. Return true if any of them
+  // was modified
+  bool ModifyEachSection(const std::function<bool(const std::string& section, Properties& properties)>& visitor);
+  void Clear();
+
+ private:
+  struct Shard {
+    explicit Shard(size_t capacity) : devices(capacity) {}
+    mutable std::mutex mutex;
+    // Lookups warm the devices up, hence mutable
+    mutable common::FixedLruCache<std::string, Properties> devices;
+    // Sections holding each of the properties given to GetSectionNamesWithProperty()
+    mutable std::unordered_map<std::string, std::unordered_set<std::string>> property_index;
+    mutable uint64_t hits = 0;
+    mutable uint64_t misses = 0;
+    uint64_t evictions = 0;
+
+    // Methods below must be called with |mutex| held
+    // Return the properties of |section| and warm it up, nullptr if there is none
+    Properties* Find(const std::string& section) const;
+    // Insert a new section in front of the cache, evicting the least recently used one at capacity
+    Properties* Insert(const std::string& section, Properties properties);
+    void AddToPropertyIndex(const std::string& section, const std::string& property);
+    void RemoveFromPropertyIndex(const std::string& section, const std::string& property);
+    void RemoveSectionFromPropertyIndex(const std::string& section);
+  };
+
+  Shard& GetShard(const std::string& section) const;
+
+  size_t capacity_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+}  // namespace storage
+}  // namespace bluetooth
@@ -0,0 +1,162 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "storage/temporary_device_cache.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <thread>
+
+namespace testing {
+
+using bluetooth::storage::TemporaryDeviceCache;
+
+namespace {
+std::string GetTestAddress(int i) {
+  char address[18];
+  std::snprintf(address, sizeof(address), "AA:BB:CC:DD:%02X:%02X", (i >> 8) & 0xff, i & 0xff);
+  return address;
+}
+}  // namespace
+
+TEST(TemporaryDeviceCacheTest, lru_eviction_test) {
+  TemporaryDeviceCache cache(2);
+  EXPECT_EQ(cache.GetStats().num_shards, 1u);
+  cache.SetProperty(GetTestAddress(0), "Name", "0");
+  cache.SetProperty(GetTestAddress(1), "Name", "1");
+  // Warm up the first device, the second one is evicted instead
+  EXPECT_TRUE(cache.HasSection(GetTestAddress(0)));
+  cache.SetProperty(GetTestAddress(2), "Name", "2");
+  EXPECT_FALSE(cache.HasSection(GetTestAddress(1)));
+  EXPECT_THAT(cache.GetProperty(GetTestAddress(0), "Name"), Optional(StrEq("0")));
+  EXPECT_THAT(cache.GetProperty(GetTestAddress(2), "Name"), Optional(StrEq("2")));
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.size, 2u);
+  EXPECT_EQ(stats.capacity, 2u);
+  EXPECT_EQ(stats.hits, 3u);
+  EXPECT_EQ(stats.misses, 1u);
+  EXPECT_EQ(stats.evictions, 1u);
+}
+
+TEST(TemporaryDeviceCacheTest, sharded_capacity_test) {
+  TemporaryDeviceCache cache(10000);
+  EXPECT_EQ(cache.GetStats().num_shards, 16u);
+  for (int i = 0; i < 20000; i++) {
+    cache.SetProperty(GetTestAddress(i), "Name", std::to_string(i));
+  }
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.size, 10000u);
+  EXPECT_EQ(stats.evictions, 10000u);
+  // The most recent devices are still there
+  EXPECT_THAT(cache.GetProperty(GetTestAddress(19999), "Name"), Optional(StrEq("19999")));
+  EXPECT_FALSE(cache.HasSection(GetTestAddress(0)));
+}
+
+TEST(TemporaryDeviceCacheTest, insert_and_extract_section_test) {
+  TemporaryDeviceCache cache(100);
+  cache.SetProperty(GetTestAddress(0), "Name", "0");
+  TemporaryDeviceCache::Properties properties;
+  properties.insert_or_assign("Name", "1");
+  properties.insert_or_assign("DevType", "2");
+  cache.InsertSection(GetTestAddress(0), std::move(properties));
+  EXPECT_THAT(cache.GetProperty(GetTestAddress(0), "DevType"), Optional(StrEq("2")));
+  EXPECT_TRUE(cache.HasAtLeastOneMatchingProperty(GetTestAddress(0), {"DevType", "LinkKey"}));
+  EXPECT_FALSE(cache.HasAtLeastOneMatchingProperty(GetTestAddress(0), {"LinkKey"}));
+
+  auto extracted = cache.ExtractSection(GetTestAddress(0));
+  ASSERT_TRUE(extracted);
+  EXPECT_THAT(extracted->find("Name")->second, StrEq("1"));
+  EXPECT_FALSE(cache.HasSection(GetTestAddress(0)));
+  EXPECT_FALSE(cache.ExtractSection(GetTestAddress(0)));
+
+  // The last property removed removes its section
+  cache.SetProperty(GetTestAddress(1), "Name", "1");
+  EXPECT_TRUE(cache.RemoveProperty(GetTestAddress(1), "Name"));
+  EXPECT_FALSE(cache.HasSection(GetTestAddress(1)));
+  EXPECT_FALSE(cache.RemoveProperty(GetTestAddress(1), "Name"));
+}
+
+TEST(TemporaryDeviceCacheTest, get_section_names_with_property_test) {
+  TemporaryDeviceCache cache(1000);
+  EXPECT_EQ(cache.GetStats().num_shards, 3u);
+  for (int i = 0; i < 10; i++) {
+    cache.SetProperty(GetTestAddress(i), "Name", std::to_string(i));
+  }
+  cache.SetProperty(GetTestAddress(0), "Restricted", "true");
+  EXPECT_THAT(
+      cache.GetSectionNamesWithProperty("Restricted"), ElementsAre(std::make_pair(GetTestAddress(0), "true")));
+  // The index is kept up to date
+  cache.SetProperty(GetTestAddress(1), "Restricted", "false");
+  cache.RemoveProperty(GetTestAddress(0), "Restricted");
+  EXPECT_THAT(
+      cache.GetSectionNamesWithProperty("Restricted"), ElementsAre(std::make_pair(GetTestAddress(1), "false")));
+  EXPECT_TRUE(cache.ModifyEachSection([](const std::string& section, TemporaryDeviceCache::Properties& properties) {
+    if (section != GetTestAddress(2)) {
+      return false;
+    }
+    properties.insert_or_assign("Restricted", "true");
+    return true;
+  }));
+  EXPECT_THAT(
+      cache.GetSectionNamesWithProperty("Restricted"),
+      UnorderedElementsAre(std::make_pair(GetTestAddress(1), "false"), std::make_pair(GetTestAddress(2), "true")));
+
+  cache.RemoveSectionWithProperty("Restricted");
+  EXPECT_THAT(cache.GetSectionNamesWithProperty("Restricted"), ElementsAre());
+  EXPECT_EQ(cache.GetSectionNamesWithProperty("Name").size(), 8u);
+  cache.Clear();
+  EXPECT_THAT(cache.GetSectionNamesWithProperty("Name"), ElementsAre());
+  EXPECT_EQ(cache.GetStats().size, 0u);
+}
+
+TEST(TemporaryDeviceCacheTest, comparison_test) {
+  TemporaryDeviceCache cache(1000);
+  TemporaryDeviceCache other(1000);
+  cache.SetProperty(GetTestAddress(0), "Name", "0");
+  EXPECT_NE(cache, other);
+  other.SetProperty(GetTestAddress(0), "Name", "0");
+  EXPECT_EQ(cache, other);
+  // The statistics don't count
+  EXPECT_TRUE(cache.HasSection(GetTestAddress(0)));
+  EXPECT_EQ(cache, other);
+  EXPECT_NE(cache, TemporaryDeviceCache(100));
+}
+
+TEST(TemporaryDeviceCacheTest, concurrent_writers_test) {
+  TemporaryDeviceCache cache(10000);
+  std::vector<std::thread> threads;
+  for (int thread = 0; thread < 4; thread++) {
+    threads.emplace_back([&cache, thread] {
+      for (int i = 0; i < 1000; i++) {
+        auto section = GetTestAddress(thread * 1000 + i);
+        cache.SetProperty(section, "Name", section);
+        EXPECT_THAT(cache.GetProperty(section, "Name"), Optional(StrEq(section)));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.size, 4000u);
+  EXPECT_EQ(stats.hits, 4000u);
+  EXPECT_EQ(stats.evictions, 0u);
+}
+
+}  // namespace testing
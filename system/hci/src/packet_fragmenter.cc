@@ -515,7 +515,7 @@ static void reassemble_and_dispatch(BT_HDR* packet) {
       partial_packet->offset = projected_offset;
 
       if (partial_packet->offset == partial_packet->len) {
-        partial_packets.erase(handle);
+        partial_packets.erase(map_iter);
         partial_packet->offset = 0;
         callbacks->reassembled(partial_packet);
       }
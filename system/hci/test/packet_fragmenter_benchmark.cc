@@ -0,0 +1,135 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "hci/src/packet_fragmenter.cc"
+#include "osi/include/allocator.h"
+#include "stack/include/bt_hdr.h"
+
+using ::benchmark::State;
+
+// Needed for linkage
+const controller_t* controller_get_interface() { return nullptr; }
+
+namespace {
+
+constexpr uint16_t kHandle = 0x123;
+constexpr uint16_t kCid = 0x0040;
+// Usual ACL data size of BR/EDR controllers
+constexpr uint16_t kAclDataSize = 1021;
+// Largest L2CAP PDU reassembled into a single buffer on this path
+constexpr uint16_t kMaxL2capLength = BT_DEFAULT_BUFFER_SIZE - sizeof(BT_HDR) -
+                                     L2CAP_HEADER_SIZE - HCI_ACL_PREAMBLE_SIZE;
+
+int reassembled_count;
+
+void OnFragmented(BT_HDR* packet, bool send_transmit_finished) {}
+
+void OnReassembled(BT_HDR* packet) {
+  reassembled_count++;
+  ::benchmark::DoNotOptimize(packet->data[packet->len - 1]);
+  osi_free(packet);
+}
+
+void OnTransmitFinished(BT_HDR* packet, bool all_fragments_sent) {}
+
+packet_fragmenter_callbacks_t result_callbacks = {
+    .fragmented = OnFragmented,
+    .reassembled = OnReassembled,
+    .transmit_finished = OnTransmitFinished,
+};
+
+// The ACL packets carrying an L2CAP PDU of |l2cap_length| bytes
+std::vector<std::vector<uint8_t>> MakeAclPackets(uint16_t l2cap_length) {
+  std::vector<uint8_t> pdu(L2CAP_HEADER_SIZE + l2cap_length);
+  uint8_t* stream = pdu.data();
+  UINT16_TO_STREAM(stream, l2cap_length);
+  UINT16_TO_STREAM(stream, kCid);
+  for (size_t i = L2CAP_HEADER_SIZE; i < pdu.size(); i++) pdu[i] = i;
+
+  std::vector<std::vector<uint8_t>> packets;
+  for (size_t offset = 0; offset < pdu.size(); offset += kAclDataSize) {
+    uint16_t length = std::min<size_t>(kAclDataSize, pdu.size() - offset);
+    std::vector<uint8_t> packet(HCI_ACL_PREAMBLE_SIZE + length);
+    stream = packet.data();
+    UINT16_TO_STREAM(stream, offset == 0 ? APPLY_START_FLAG(kHandle)
+                                         : APPLY_CONTINUATION_FLAG(kHandle));
+    UINT16_TO_STREAM(stream, length);
+    memcpy(stream, pdu.data() + offset, length);
+    packets.push_back(std::move(packet));
+  }
+  return packets;
+}
+
+// Wraps |packet| in a BT_HDR, the copy made by the HCI layer for every packet
+// received from the controller
+BT_HDR* WrapAclPacket(const std::vector<uint8_t>& packet) {
+  BT_HDR* hdr = (BT_HDR*)osi_malloc(sizeof(BT_HDR) + packet.size());
+  hdr->event = MSG_HC_TO_STACK_HCI_ACL;
+  hdr->len = packet.size();
+  hdr->offset = 0;
+  hdr->layer_specific = 0;
+  memcpy(hdr->data, packet.data(), packet.size());
+  return hdr;
+}
+
+class PacketFragmenterBenchmark : public ::benchmark::Fixture {
+ public:
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    fragmenter_ = packet_fragmenter_get_interface();
+    fragmenter_->init(&result_callbacks);
+    reassembled_count = 0;
+  }
+
+  void TearDown(State& st) override {
+    fragmenter_->cleanup();
+    ::benchmark::Fixture::TearDown(st);
+  }
+
+  const packet_fragmenter_t* fragmenter_;
+};
+
+BENCHMARK_DEFINE_F(PacketFragmenterBenchmark, reassemble_acl)
+(State& state) {
+  const uint16_t l2cap_length = state.range(0);
+  const auto packets = MakeAclPackets(l2cap_length);
+
+  for (auto _ : state) {
+    for (const auto& packet : packets) {
+      fragmenter_->reassemble_and_dispatch(WrapAclPacket(packet));
+    }
+  }
+  if (reassembled_count != state.iterations()) {
+    state.SkipWithError("Packets not reassembled");
+  }
+  state.SetBytesProcessed(state.iterations() * l2cap_length);
+  state.counters["fragments"] = packets.size();
+}
+BENCHMARK_REGISTER_F(PacketFragmenterBenchmark, reassemble_acl)
+    ->Arg(kAclDataSize - L2CAP_HEADER_SIZE)
+    ->Arg(2 * kAclDataSize)
+    ->Arg(kMaxL2capLength);
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -63,6 +63,12 @@ typedef struct {
   uint8_t is_notify;
 } btgatt_notify_params_t;
 
+/** Notification of a batch, with the connection it was received on */
+typedef struct {
+  int conn_id;
+  btgatt_notify_params_t params;
+} btgatt_notify_batch_entry_t;
+
 typedef struct {
   RawAddress* bda1;
   bluetooth::Uuid* uuid1;
@@ -124,6 +130,14 @@ typedef void (*register_for_notification_callback)(int conn_id, int registered,
 typedef void (*notify_callback)(int conn_id,
                                 const btgatt_notify_params_t& p_data);
 
+/**
+ * Batched form of notify_callback. When set, the notifications and
+ * indications received back to back are delivered in order with a single
+ * call, instead of one notify_cb call each.
+ */
+typedef void (*notify_batch_callback)(
+    const btgatt_notify_batch_entry_t* entries, int count);
+
 /** Reports result of a GATT read operation */
 typedef void (*read_characteristic_callback)(int conn_id, int status,
                                              btgatt_read_params_t* p_data);
@@ -207,6 +221,7 @@ typedef struct {
   phy_updated_callback phy_updated_cb;
   conn_updated_callback conn_updated_cb;
   service_changed_callback service_changed_cb;
+  notify_batch_callback notify_batch_cb;
 } btgatt_client_callbacks_t;
 
 /** Represents the standard BT-GATT client interface. */
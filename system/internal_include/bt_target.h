@@ -176,6 +176,12 @@
 #define L2CAP_FCR_ERTM_BUF_SIZE (10240 + 24)
 #endif
 
+/* Bytes of I-frames an ERTM channel keeps until they are acknowledged. The
+ * channel stops sending new I-frames once it holds that many. */
+#ifndef L2CAP_FCR_TX_BUDGET
+#define L2CAP_FCR_TX_BUDGET (4 * L2CAP_FCR_ERTM_BUF_SIZE)
+#endif
+
 /* Number of ACL buffers to assign to LE */
 /*
  * TODO: Do we need this?
@@ -267,9 +273,10 @@
 #define BTM_SCO_DATA_SIZE_MAX 240
 #endif
 
-/* The size in bytes of the BTM inquiry database. */
-#ifndef BTM_INQ_DB_SIZE
-#define BTM_INQ_DB_SIZE 40
+/* The maximum size in bytes of the BTM inquiry database, which grows as
+ * devices are found by inquiries and LE scans. About 350 bytes per device. */
+#ifndef BTM_INQ_DB_MAX_MEMORY
+#define BTM_INQ_DB_MAX_MEMORY (128 * 1024)
 #endif
 
 /* Sets the Page_Scan_Window:  the length of time that the device is performing
@@ -712,6 +719,12 @@
 #define PORT_RX_BUF_CRITICAL_WM 15
 #endif
 
+/* The maximum number of credits granted to the peer of a call-out port, as the
+ * app keeps up with the data. Must stay below 255. */
+#ifndef PORT_CO_CREDIT_RX_MAX
+#define PORT_CO_CREDIT_RX_MAX 40
+#endif
+
 /* The port transmit queue high watermark level, in bytes. */
 #ifndef PORT_TX_HIGH_WM
 #define PORT_TX_HIGH_WM (BTA_RFC_MTU_SIZE * PORT_TX_BUF_HIGH_WM)
@@ -727,6 +740,11 @@
 #define PORT_TX_BUF_HIGH_WM 10
 #endif
 
+/* The maximum number of frames read at once from a call-out data port. */
+#ifndef PORT_CO_MAX_FRAMES
+#define PORT_CO_MAX_FRAMES PORT_TX_BUF_HIGH_WM
+#endif
+
 /* The port transmit queue high watermark level, in number of buffers. */
 #ifndef PORT_TX_BUF_CRITICAL_WM
 #define PORT_TX_BUF_CRITICAL_WM 15
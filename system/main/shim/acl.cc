@@ -20,6 +20,7 @@
 #include <base/strings/stringprintf.h>
 #include <time.h>
 
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <functional>
@@ -62,6 +63,7 @@
 #include "stack/include/bt_hdr.h"
 #include "stack/include/btm_api.h"
 #include "stack/include/btm_status.h"
+#include "stack/include/btu.h"
 #include "stack/include/gatt_api.h"
 #include "stack/include/pan_api.h"
 #include "stack/include/sec_hci_link_interface.h"
@@ -315,6 +317,15 @@ class FixedQueue {
 
 constexpr size_t kConnectionHistorySize = 40;
 
+// Thread hops of the ACL data sent upwards once dequeued on the gd stack
+// handler: none when the handler runs on the main thread, which is then handed
+// the data directly, one when the data is posted to the main thread
+struct AclDataHops {
+  std::atomic<uint64_t> direct{0};
+  std::atomic<uint64_t> posted{0};
+};
+AclDataHops acl_data_hops;
+
 inline uint8_t LowByte(uint16_t val) { return val & 0xff; }
 inline uint8_t HighByte(uint16_t val) { return val >> 8; }
 
@@ -407,10 +418,15 @@ class ShimAclConnection {
     if (send_data_upwards_ == nullptr) {
       LOG_WARN("Dropping ACL data with no callback");
       osi_free(p_buf);
+    } else if (is_on_main_thread()) {
+      direct_data_count_++;
+      send_data_upwards_(p_buf);
     } else if (do_in_main_thread(FROM_HERE,
                                  base::Bind(send_data_upwards_, p_buf)) !=
                BT_STATUS_SUCCESS) {
       osi_free(p_buf);
+    } else {
+      posted_data_count_++;
     }
   }
 
@@ -448,6 +464,7 @@ class ShimAclConnection {
     is_disconnected_ = true;
     UnregisterEnqueue();
     queue_up_end_->UnregisterDequeue();
+    ReportDataHops();
     if (!queue_.empty())
       LOG_WARN(
           "ACL disconnect with non-empty queue handle:%04x stranded_pkts::%zu",
@@ -464,6 +481,16 @@ class ShimAclConnection {
   bool is_enqueue_registered_{false};
   bool is_disconnected_{false};
   CreationTime creation_time_;
+  // Packets sent upwards, counted on the handler and reported on disconnect
+  uint64_t direct_data_count_{0};
+  uint64_t posted_data_count_{0};
+
+  void ReportDataHops() {
+    acl_data_hops.direct += direct_data_count_;
+    acl_data_hops.posted += posted_data_count_;
+    direct_data_count_ = 0;
+    posted_data_count_ = 0;
+  }
 
   void RegisterEnqueue() {
     ASSERT_LOG(!is_disconnected_,
@@ -1091,7 +1118,8 @@ struct shim::legacy::Acl::impl {
 extern tL2C_CB l2cb;
 void DumpsysL2cap(int fd) {
   LOG_DUMPSYS_TITLE(fd, DUMPSYS_TAG);
-  for (int i = 0; i < MAX_L2CAP_LINKS; i++) {
+  shim::DumpsysWriter writer(fd, DUMPSYS_TAG);
+  for (int i = 0; i < MAX_L2CAP_LINKS && !writer.Expired(); i++) {
     const tL2C_LCB& lcb = l2cb.lcb_pool[i];
     if (!lcb.in_use) continue;
     LOG_DUMPSYS(fd, "link_state:%s", link_state_text(lcb.link_state).c_str());
@@ -1118,8 +1146,14 @@ void DumpsysAcl(int fd) {
   if (shim::Stack::GetInstance()->IsRunning()) {
     shim::Stack::GetInstance()->GetAcl()->DumpConnectionHistory(fd);
   }
+  LOG_DUMPSYS(fd,
+              "Data upwards of disconnected links direct:%llu "
+              "posted_to_main_thread:%llu",
+              static_cast<unsigned long long>(acl_data_hops.direct),
+              static_cast<unsigned long long>(acl_data_hops.posted));
 
-  for (int i = 0; i < MAX_L2CAP_LINKS; i++) {
+  shim::DumpsysWriter writer(fd, DUMPSYS_TAG);
+  for (int i = 0; i < MAX_L2CAP_LINKS && !writer.Expired(); i++) {
     const tACL_CONN& link = acl_cb.acl_db[i];
     if (!link.in_use) continue;
 
@@ -1166,7 +1200,6 @@ void DumpsysAcl(int fd) {
 }
 #undef DUMPSYS_TAG
 
-using Record = common::TimestampedEntry<std::string>;
 const std::string kTimeFormat("%Y-%m-%d %H:%M:%S");
 
 #define DUMPSYS_TAG "shim::legacy::hid"
@@ -1198,18 +1231,32 @@ void DumpsysHid(int fd) {
 #undef DUMPSYS_TAG
 
 #define DUMPSYS_TAG "shim::legacy::btm"
+extern void btm_ble_resolve_cache_dump(int fd);
 void DumpsysBtm(int fd) {
   LOG_DUMPSYS_TITLE(fd, DUMPSYS_TAG);
+  btm_ble_resolve_cache_dump(fd);
   if (btm_cb.history_ != nullptr) {
-    std::vector<Record> history = btm_cb.history_->Pull();
-    for (auto& record : history) {
-      time_t then = record.timestamp / 1000;
-      struct tm tm;
-      localtime_r(&then, &tm);
-      auto s2 = common::StringFormatTime(kTimeFormat, tm);
-      LOG_DUMPSYS(fd, " %s.%03u %s", s2.c_str(),
-                  static_cast<unsigned int>(record.timestamp % 1000),
-                  record.entry.c_str());
+    // Pulled in slices so that logging the history is not held up by the dump
+    shim::DumpsysWriter writer(fd, DUMPSYS_TAG);
+    uint64_t next = 0;
+    std::vector<BtmLogHistoryBuffer::Entry> history;
+    while (!writer.Expired() &&
+           !(history = btm_cb.history_->Pull(&next, shim::kDumpsysSliceSize))
+                .empty()) {
+      for (auto& entry : history) {
+        time_t then = entry.timestamp / 1000;
+        struct tm tm;
+        localtime_r(&then, &tm);
+        auto s2 = common::StringFormatTime(kTimeFormat, tm);
+        LOG_DUMPSYS(fd, " %s.%03u %s", s2.c_str(),
+                    static_cast<unsigned int>(entry.timestamp % 1000),
+                    entry.ToString().c_str());
+      }
+    }
+    if (btm_cb.history_->GetDroppedCount() != 0) {
+      LOG_DUMPSYS(fd, "dropped:%llu",
+                  static_cast<unsigned long long>(
+                      btm_cb.history_->GetDroppedCount()));
     }
   }
 }
@@ -1224,10 +1271,11 @@ void DumpsysRecord(int fd) {
     return;
   }
 
+  shim::DumpsysWriter writer(fd, DUMPSYS_TAG);
   unsigned cnt = 0;
   list_node_t* end = list_end(btm_cb.sec_dev_rec);
-  for (list_node_t* node = list_begin(btm_cb.sec_dev_rec); node != end;
-       node = list_next(node)) {
+  for (list_node_t* node = list_begin(btm_cb.sec_dev_rec);
+       node != end && !writer.Expired(); node = list_next(node)) {
     tBTM_SEC_DEV_REC* p_dev_rec =
         static_cast<tBTM_SEC_DEV_REC*>(list_node(node));
     LOG_DUMPSYS(fd, "%03u %s", ++cnt, p_dev_rec->ToString().c_str());
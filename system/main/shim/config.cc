@@ -17,7 +17,9 @@
 #define LOG_TAG "bt_shim_storage"
 
 #include <algorithm>
+#include <cinttypes>
 #include <cstdint>
+#include <cstdio>
 #include <cstring>
 #include <memory>
 
@@ -156,6 +158,23 @@ std::vector<std::string> BtifConfigInterface::GetPersistentDevices() {
   return GetStorage()->GetConfigCache()->GetPersistentSections();
 }
 
+uint64_t BtifConfigInterface::GetPersistentGeneration() {
+  return GetStorage()->GetConfigCache()->GetPersistentGeneration();
+}
+
+void BtifConfigInterface::DumpTemporaryDevices(int fd) {
+  auto stats = GetStorage()->GetConfigCache()->GetTemporaryDeviceStats();
+  uint64_t lookups = stats.hits + stats.misses;
+  dprintf(fd, "  Temporary devices: %zu/%zu in %zu shards\n", stats.size,
+          stats.capacity, stats.num_shards);
+  dprintf(fd,
+          "  Temporary device lookups: %" PRIu64 " hits, %" PRIu64
+          " misses (%" PRIu64 "%% hit rate)\n",
+          stats.hits, stats.misses,
+          lookups > 0 ? stats.hits * 100 / lookups : 0);
+  dprintf(fd, "  Temporary device evictions: %" PRIu64 "\n", stats.evictions);
+}
+
 void BtifConfigInterface::ConvertEncryptOrDecryptKeyIfNeeded() {
   GetStorage()->GetConfigCache()->ConvertEncryptOrDecryptKeyIfNeeded();
 }
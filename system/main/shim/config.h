@@ -53,6 +53,10 @@ class BtifConfigInterface {
   static bool RemoveProperty(const std::string& section,
                              const std::string& key);
   static std::vector<std::string> GetPersistentDevices();
+  // Changes each time the persistent config changes
+  static uint64_t GetPersistentGeneration();
+  // Dump the state of the temporary device cache to |fd|
+  static void DumpTemporaryDevices(int fd);
   static void ConvertEncryptOrDecryptKeyIfNeeded();
   static void Save();
   static void Flush();
@@ -16,8 +16,10 @@
 
 #define LOG_TAG "bt_shim_storage"
 
+#include <chrono>
 #include <unordered_map>
 
+#include "gd/os/log.h"
 #include "main/shim/dumpsys.h"
 #include "main/shim/entry.h"
 #include "main/shim/shim.h"
@@ -50,7 +52,14 @@ void bluetooth::shim::Dump(int fd, const char** args) {
     dprintf(fd, "%s Dumping shim legacy targets:%zd\n", kModuleName,
             dumpsys_functions_.size());
     for (auto& dumpsys : dumpsys_functions_) {
+      auto start = std::chrono::steady_clock::now();
       dumpsys.second(fd);
+      auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+          std::chrono::steady_clock::now() - start);
+      if (elapsed > kDumpsysTimeBudget) {
+        LOG_WARN("%s target %p took %lld ms", kModuleName, dumpsys.first,
+                 static_cast<long long>(elapsed.count()));
+      }
     }
   }
   if (bluetooth::shim::is_gd_stack_started_up()) {
@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <chrono>
+#include <cstdio>
 #include <functional>
 #include <list>
 #include <string>
@@ -57,6 +59,46 @@ namespace shim {
 
 using DumpsysFunction = std::function<void(int fd)>;
 
+/**
+ * Time a dumpsys target may spend walking the stack state, and number of
+ * entries pulled from a history buffer at once.
+ */
+constexpr std::chrono::milliseconds kDumpsysTimeBudget =
+    std::chrono::milliseconds(100);
+constexpr size_t kDumpsysSliceSize = 16;
+
+/**
+ * Writes the dumpsys of one target to the fd as its state is walked, rather
+ * than building it up first. Targets check Expired() between entries and stop
+ * once the budget is spent, so that a bugreport never holds the stack state
+ * for more than a bounded time however large the tables are.
+ */
+class DumpsysWriter {
+ public:
+  DumpsysWriter(int fd, const char* tag,
+                std::chrono::milliseconds budget = kDumpsysTimeBudget)
+      : fd_(fd),
+        tag_(tag),
+        deadline_(std::chrono::steady_clock::now() + budget) {}
+
+  int fd() const { return fd_; }
+
+  // The first call to return true notes the truncation in the output
+  bool Expired() {
+    if (expired_) return true;
+    if (std::chrono::steady_clock::now() < deadline_) return false;
+    expired_ = true;
+    dprintf(fd_, "%s ... truncated, dumpsys time budget exceeded\n", tag_);
+    return true;
+  }
+
+ private:
+  const int fd_;
+  const char* tag_;
+  const std::chrono::steady_clock::time_point deadline_;
+  bool expired_{false};
+};
+
 /**
  * Entrypoint from legacy stack to provide dumpsys functionality
  * for both the legacy shim and the Gabeldorsche stack.
@@ -0,0 +1,135 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "hci/hci_packets.h"
+#include "os/log.h"
+
+namespace bluetooth {
+namespace shim {
+
+/**
+ * A legacy HCI command, built as a gd command whose parameters the legacy
+ * stack writes in place with the stream macros. It reaches the gd HCI layer
+ * without going through a BT_HDR and a copy.
+ *
+ * Parameters of up to kMaxInlineParameterSize bytes, the size of nearly all
+ * commands, are kept inline, and the builders are recycled through a small
+ * pool, so that building a command does not allocate once the pool is warm.
+ */
+class LegacyCommandBuilder : public hci::CommandBuilder {
+ public:
+  static constexpr size_t kMaxInlineParameterSize = 32;
+  static constexpr size_t kMaxPooledBuilders = 16;
+
+  static std::unique_ptr<LegacyCommandBuilder> Create(uint16_t opcode,
+                                                      uint8_t parameter_size) {
+    return std::unique_ptr<LegacyCommandBuilder>(
+        new LegacyCommandBuilder(opcode, parameter_size));
+  }
+
+  uint16_t GetOpcode() const { return static_cast<uint16_t>(op_code_); }
+
+  uint8_t GetParameterSize() const { return parameter_size_; }
+
+  /* The GetParameterSize() bytes of parameters following the opcode and the
+   * parameter length in the command */
+  uint8_t* GetParameters() {
+    return parameter_size_ <= kMaxInlineParameterSize
+               ? inline_parameters_.data()
+               : heap_parameters_.data();
+  }
+  const uint8_t* GetParameters() const {
+    return const_cast<LegacyCommandBuilder*>(this)->GetParameters();
+  }
+
+  size_t size() const override { return kHeaderSize + parameter_size_; }
+
+  void Serialize(packet::BitInserter& it) const override {
+    uint16_t opcode = GetOpcode();
+    const uint8_t header[kHeaderSize] = {static_cast<uint8_t>(opcode),
+                                         static_cast<uint8_t>(opcode >> 8),
+                                         parameter_size_};
+    it.insert_bytes(header, kHeaderSize);
+    it.insert_bytes(GetParameters(), parameter_size_);
+  }
+
+  static void* operator new(size_t size) {
+    ASSERT(size == sizeof(LegacyCommandBuilder));
+    Pool& pool = GetPool();
+    {
+      std::lock_guard<std::mutex> lock(pool.mutex);
+      if (!pool.free_builders.empty()) {
+        void* builder = pool.free_builders.back();
+        pool.free_builders.pop_back();
+        return builder;
+      }
+    }
+    return ::operator new(size);
+  }
+
+  /* Builders are freed on the gd HCI thread, once the command got its
+   * response */
+  static void operator delete(void* builder) {
+    Pool& pool = GetPool();
+    {
+      std::lock_guard<std::mutex> lock(pool.mutex);
+      if (pool.free_builders.size() < kMaxPooledBuilders) {
+        pool.free_builders.push_back(builder);
+        return;
+      }
+    }
+    ::operator delete(builder);
+  }
+
+ private:
+  static constexpr size_t kHeaderSize = 3;
+
+  struct Pool {
+    Pool() { free_builders.reserve(kMaxPooledBuilders); }
+    std::mutex mutex;
+    std::vector<void*> free_builders;
+  };
+
+  // Never destroyed, as commands may still be in flight at exit
+  static Pool& GetPool() {
+    static Pool* pool = new Pool();
+    return *pool;
+  }
+
+  LegacyCommandBuilder(uint16_t opcode, uint8_t parameter_size)
+      : hci::CommandBuilder(static_cast<hci::OpCode>(opcode)),
+        parameter_size_(parameter_size) {
+    if (parameter_size_ > kMaxInlineParameterSize) {
+      heap_parameters_.resize(parameter_size_);
+    }
+  }
+
+  uint8_t parameter_size_;
+  std::array<uint8_t, kMaxInlineParameterSize> inline_parameters_;
+  std::vector<uint8_t> heap_parameters_;
+};
+
+}  // namespace shim
+}  // namespace bluetooth
@@ -29,7 +29,9 @@
 #include "hci/include/packet_fragmenter.h"
 #include "hci/le_acl_connection_interface.h"
 #include "hci/vendor_specific_event_manager.h"
+#include "main/shim/hci_command.h"
 #include "main/shim/hci_layer.h"
+#include "main/shim/helpers.h"
 #include "main/shim/shim.h"
 #include "main/shim/stack.h"
 #include "osi/include/allocator.h"
@@ -38,6 +40,7 @@
 #include "src/bridge.rs.h"
 #include "stack/include/bt_hdr.h"
 #include "stack/include/bt_types.h"
+#include "stack/include/btm_iso_sdu_pool.h"
 
 /**
  * Callback data wrapped as opaque token bundled with the command
@@ -55,6 +58,11 @@ constexpr size_t kCommandOpcodeSize = sizeof(uint16_t);
 static base::Callback<void(const base::Location&, BT_HDR*)> send_data_upwards;
 static const packet_fragmenter_t* packet_fragmenter;
 
+/* Commands held back by the HciCommandBatch of the thread */
+static thread_local int command_batch_depth = 0;
+static thread_local std::vector<bluetooth::hci::HciLayer::BatchedCommand>
+    batched_commands;
+
 namespace {
 bool is_valid_event_code(bluetooth::hci::EventCode event_code) {
   switch (event_code) {
@@ -281,13 +289,8 @@ static bluetooth::os::EnqueueBuffer<bluetooth::hci::ScoBuilder>*
 
 static std::unique_ptr<bluetooth::packet::RawBuilder> MakeUniquePacket(
     const uint8_t* data, size_t len) {
-  bluetooth::packet::RawBuilder builder;
-  std::vector<uint8_t> bytes(data, data + len);
-
-  auto payload = std::make_unique<bluetooth::packet::RawBuilder>();
-  payload->AddOctets(bytes);
-
-  return payload;
+  return std::make_unique<bluetooth::packet::RawBuilder>(
+      std::vector<uint8_t>(data, data + len));
 }
 
 static BT_HDR* WrapPacketAndCopy(
@@ -299,7 +302,23 @@ static BT_HDR* WrapPacketAndCopy(
   packet->len = data->size();
   packet->layer_specific = 0;
   packet->event = event;
-  std::copy(data->begin(), data->end(), packet->data);
+  bluetooth::CopyPacketBytes(*data, packet->data);
+  return packet;
+}
+
+static BT_HDR* WrapCommandAndCopy(
+    const bluetooth::shim::LegacyCommandBuilder& command) {
+  size_t parameter_size = command.GetParameterSize();
+  size_t len = kCommandOpcodeSize + kCommandLengthSize + parameter_size;
+  BT_HDR* packet = reinterpret_cast<BT_HDR*>(osi_malloc(kBtHdrSize + len));
+  packet->offset = 0;
+  packet->len = len;
+  packet->layer_specific = 0;
+  packet->event = 0;
+  uint8_t* data = packet->data;
+  UINT16_TO_STREAM(data, command.GetOpcode());
+  UINT8_TO_STREAM(data, parameter_size);
+  std::copy_n(command.GetParameters(), parameter_size, data);
   return packet;
 }
 
@@ -335,7 +354,6 @@ void OnTransmitPacketCommandComplete(command_complete_cb complete_callback,
                                      bluetooth::hci::CommandCompleteView view) {
   LOG_DEBUG("Received cmd complete for %s",
             bluetooth::hci::OpCodeText(view.GetCommandOpCode()).c_str());
-  std::vector<uint8_t> data(view.begin(), view.end());
   BT_HDR* response = WrapPacketAndCopy(MSG_HC_TO_STACK_HCI_EVT, &view);
   complete_callback(response, context);
 }
@@ -350,6 +368,18 @@ void OnTransmitPacketStatus(command_status_cb status_callback, void* context,
   status_callback(status, static_cast<BT_HDR*>(command->Release()), context);
 }
 
+template <typename TResponse>
+static void EnqueueCommand(
+    std::unique_ptr<bluetooth::hci::CommandBuilder> command,
+    bluetooth::common::ContextualOnceCallback<void(TResponse)> on_response) {
+  if (command_batch_depth > 0) {
+    batched_commands.push_back({std::move(command), std::move(on_response)});
+    return;
+  }
+  bluetooth::shim::GetHciLayer()->EnqueueCommand(std::move(command),
+                                                 std::move(on_response));
+}
+
 static void transmit_command(const BT_HDR* command,
                              command_complete_cb complete_callback,
                              command_status_cb status_callback, void* context) {
@@ -375,19 +405,41 @@ static void transmit_command(const BT_HDR* command,
 
   if (bluetooth::hci::Checker::IsCommandStatusOpcode(op_code)) {
     auto command_unique = std::make_unique<OsiObject>(command);
-    bluetooth::shim::GetHciLayer()->EnqueueCommand(
-        std::move(packet), bluetooth::shim::GetGdShimHandler()->BindOnce(
-                               OnTransmitPacketStatus, status_callback, context,
-                               std::move(command_unique)));
+    EnqueueCommand(std::move(packet),
+                   bluetooth::shim::GetGdShimHandler()->BindOnce(
+                       OnTransmitPacketStatus, status_callback, context,
+                       std::move(command_unique)));
   } else {
-    bluetooth::shim::GetHciLayer()->EnqueueCommand(
-        std::move(packet),
-        bluetooth::shim::GetGdShimHandler()->BindOnce(
-            OnTransmitPacketCommandComplete, complete_callback, context));
+    EnqueueCommand(std::move(packet),
+                   bluetooth::shim::GetGdShimHandler()->BindOnce(
+                       OnTransmitPacketCommandComplete, complete_callback,
+                       context));
     osi_free(const_cast<void*>(static_cast<const void*>(command)));
   }
 }
 
+static void transmit_command(
+    std::unique_ptr<bluetooth::shim::LegacyCommandBuilder> command,
+    command_complete_cb complete_callback, command_status_cb status_callback,
+    void* context) {
+  auto op_code = static_cast<bluetooth::hci::OpCode>(command->GetOpcode());
+  LOG_DEBUG("Sending command %s", bluetooth::hci::OpCodeText(op_code).c_str());
+
+  if (bluetooth::hci::Checker::IsCommandStatusOpcode(op_code)) {
+    auto command_unique =
+        std::make_unique<OsiObject>(WrapCommandAndCopy(*command));
+    EnqueueCommand(std::move(command),
+                   bluetooth::shim::GetGdShimHandler()->BindOnce(
+                       OnTransmitPacketStatus, status_callback, context,
+                       std::move(command_unique)));
+  } else {
+    EnqueueCommand(std::move(command),
+                   bluetooth::shim::GetGdShimHandler()->BindOnce(
+                       OnTransmitPacketCommandComplete, complete_callback,
+                       context));
+  }
+}
+
 static void transmit_fragment(const uint8_t* stream, size_t length) {
   uint16_t handle_with_flags;
   STREAM_TO_UINT16(handle_with_flags, stream);
@@ -724,6 +776,30 @@ static void transmit_command(const BT_HDR* command,
   }
 }
 
+void bluetooth::shim::hci_layer_transmit_command(
+    std::unique_ptr<LegacyCommandBuilder> command,
+    command_complete_cb complete_callback, command_status_cb status_callback,
+    void* context) {
+  if (bluetooth::common::init_flags::gd_rust_is_enabled()) {
+    rust::transmit_command(cpp::WrapCommandAndCopy(*command),
+                           complete_callback, status_callback, context);
+  } else {
+    cpp::transmit_command(std::move(command), complete_callback,
+                          status_callback, context);
+  }
+}
+
+bluetooth::shim::HciCommandBatch::HciCommandBatch() { command_batch_depth++; }
+
+bluetooth::shim::HciCommandBatch::~HciCommandBatch() {
+  if (--command_batch_depth > 0 || batched_commands.empty()) {
+    return;
+  }
+  std::vector<bluetooth::hci::HciLayer::BatchedCommand> commands;
+  commands.swap(batched_commands);
+  bluetooth::shim::GetHciLayer()->EnqueueCommandBatch(std::move(commands));
+}
+
 static void command_complete_callback(BT_HDR* response, void* context) {
   auto future = static_cast<future_t*>(context);
   future_ready(future, response);
@@ -777,7 +853,11 @@ static void transmit_fragment(BT_HDR* packet, bool send_transmit_finished) {
   }
 
   if (free_after_transmit) {
-    osi_free(packet);
+    if (event == MSG_STACK_TO_HC_HCI_ISO) {
+      bluetooth::hci::iso_manager::GetIsoSduPool().Release(packet);
+    } else {
+      osi_free(packet);
+    }
   }
 }
 static void dispatch_reassembled(BT_HDR* packet) {
@@ -19,6 +19,8 @@
  */
 #pragma once
 
+#include <memory>
+
 #include "hci/include/hci_layer.h"
 
 namespace bluetooth {
@@ -30,5 +32,30 @@ void hci_on_reset_complete();
 
 void hci_on_shutting_down();
 
+class LegacyCommandBuilder;
+
+/* Send |command| built by the legacy stack, the callbacks are called as for
+ * hci_t::transmit_command(). The legacy stack reads the commands answered with
+ * a command status back from a BT_HDR, those are copied into one. */
+void hci_layer_transmit_command(std::unique_ptr<LegacyCommandBuilder> command,
+                                command_complete_cb complete_callback,
+                                command_status_cb status_callback,
+                                void* context);
+
+/* Commands sent from a thread while it holds an HciCommandBatch are handed to
+ * the HCI layer together, in order, once its outermost batch is destroyed. Use
+ * it around sequences of commands, to save the thread hop per command.
+ *
+ * Only the legacy btsnd_hcic_* commands are batched: commands the gd modules
+ * enqueue meanwhile go out first. Hold a batch only around code that sends
+ * nothing through the gd modules. */
+class HciCommandBatch {
+ public:
+  HciCommandBatch();
+  ~HciCommandBatch();
+  HciCommandBatch(const HciCommandBatch&) = delete;
+  HciCommandBatch& operator=(const HciCommandBatch&) = delete;
+};
+
 }  // namespace shim
 }  // namespace bluetooth
@@ -107,25 +107,35 @@ inline tBLE_BD_ADDR ToLegacyAddressWithType(
 
 inline std::unique_ptr<bluetooth::packet::RawBuilder> MakeUniquePacket(
     const uint8_t* data, size_t len, bool is_flushable) {
-  bluetooth::packet::RawBuilder builder;
-  std::vector<uint8_t> bytes(data, data + len);
-  auto payload = std::make_unique<bluetooth::packet::RawBuilder>();
-  payload->AddOctets(bytes);
+  auto payload = std::make_unique<bluetooth::packet::RawBuilder>(
+      std::vector<uint8_t>(data, data + len));
   payload->SetFlushable(is_flushable);
   return payload;
 }
 
+// Copy the bytes of |packet| to |dst|, which must hold packet.size() bytes.
+// Packets received from the controller are a single fragment, so this is
+// usually one memcpy rather than a walk with the fragment iterator.
+inline void CopyPacketBytes(
+    const bluetooth::hci::PacketView<bluetooth::hci::kLittleEndian>& packet,
+    uint8_t* dst) {
+  const uint8_t* bytes = packet.GetContiguousData();
+  if (bytes != nullptr) {
+    std::copy(bytes, bytes + packet.size(), dst);
+  } else {
+    std::copy(packet.begin(), packet.end(), dst);
+  }
+}
+
 inline BT_HDR* MakeLegacyBtHdrPacket(
     std::unique_ptr<bluetooth::hci::PacketView<bluetooth::hci::kLittleEndian>>
         packet,
     const std::vector<uint8_t>& preamble) {
-  std::vector<uint8_t> packet_vector(packet->begin(), packet->end());
   BT_HDR* buffer = static_cast<BT_HDR*>(
-      osi_calloc(packet_vector.size() + preamble.size() + sizeof(BT_HDR)));
+      osi_calloc(packet->size() + preamble.size() + sizeof(BT_HDR)));
   std::copy(preamble.begin(), preamble.end(), buffer->data);
-  std::copy(packet_vector.begin(), packet_vector.end(),
-            buffer->data + preamble.size());
-  buffer->len = preamble.size() + packet_vector.size();
+  CopyPacketBytes(*packet, buffer->data + preamble.size());
+  buffer->len = preamble.size() + packet->size();
   return buffer;
 }
 
@@ -23,6 +23,7 @@
 #include <unistd.h>
 #include <string>
 
+#include "common/startup_trace.h"
 #include "gd/att/att_module.h"
 #include "gd/btaa/activity_attribution.h"
 #include "gd/common/init_flags.h"
@@ -216,6 +217,11 @@ void Stack::Start(ModuleList* modules) {
   stack_thread_ =
       new os::Thread("gd_stack_thread", os::Thread::Priority::REAL_TIME);
   stack_manager_.StartUp(modules, stack_thread_);
+  for (const auto& start_time : stack_manager_.GetModuleStartTimes()) {
+    common::StartupTrace::GetInstance().AddPhase(
+        common::StartupPhaseType::GD_MODULE, start_time.name,
+        start_time.begin, start_time.end);
+  }
 
   stack_handler_ = new os::Handler(stack_thread_);
 
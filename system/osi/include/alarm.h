@@ -79,6 +79,12 @@ void alarm_set(alarm_t* alarm, uint64_t interval_ms, alarm_callback_t cb,
 void alarm_set_on_mloop(alarm_t* alarm, uint64_t interval_ms,
                         alarm_callback_t cb, void* data);
 
+// Lets |alarm| fire up to |slack_ms| after its deadline, so that alarms with
+// overlapping slack windows are dispatched on a single wakeup. Applies from the
+// next time |alarm| is set, and to every period of a periodic alarm. A
+// |slack_ms| of 0, the default, fires |alarm| on time. |alarm| may not be NULL.
+void alarm_set_slack(alarm_t* alarm, uint64_t slack_ms);
+
 // This function cancels the |alarm| if it was previously set.
 // When this call returns, the caller has a guarantee that the
 // callback is not in progress and will not be called if it
@@ -29,6 +29,15 @@ typedef uint8_t allocator_id_t;
 // the allocation tracker functions do nothing but are still safe to call.
 void allocation_tracker_init(void);
 
+// Initialize the allocation tracker in sampling mode, where roughly one in
+// |interval| allocations is recorded together with its call site. There are
+// no canaries and no double free checks in this mode, only live sampled
+// allocations by call site in |osi_allocator_debug_dump|. Unsampled
+// allocations do not take a lock, so this is cheap enough for production
+// builds. Does nothing if |interval| is 0 or the tracker is already
+// initialized with |allocation_tracker_init|.
+void allocation_tracker_init_sampling(size_t interval);
+
 // Reset the allocation tracker. Don't call this in the normal course of
 // operations. Useful mostly for testing.
 void allocation_tracker_reset(void);
@@ -47,6 +56,12 @@ size_t allocation_tracker_expect_no_allocations(void);
 void* allocation_tracker_notify_alloc(allocator_id_t allocator_id, void* ptr,
                                       size_t requested_size);
 
+// Same as |allocation_tracker_notify_alloc|, with the address of the code
+// that requested the allocation for call site attribution in sampling mode.
+void* allocation_tracker_notify_alloc_from(allocator_id_t allocator_id,
+                                           void* ptr, size_t requested_size,
+                                           const void* call_site);
+
 // Notify the tracker of an allocation that is being freed. |ptr| must be a
 // pointer returned by a call to |allocation_tracker_notify_alloc| with the
 // same |allocator_id|. If |ptr| is NULL, this function does nothing. Returns
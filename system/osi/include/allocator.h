@@ -52,6 +52,10 @@ void osi_free_and_reset(void** p_ptr);
 // The information is in user-readable text format. The |fd| must be valid.
 void osi_allocator_debug_dump(int fd);
 
+// Dump per size class statistics of the buffer caches behind |osi_malloc|
+// and |osi_calloc| to the |fd| file descriptor.
+void osi_allocator_pool_debug_dump(int fd);
+
 class OsiObject {
  public:
   OsiObject(void* ptr);
@@ -20,6 +20,9 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
 
 // The default section name to use if a key/value pair is not defined within
 // a section.
@@ -30,18 +33,114 @@ struct entry_t {
   std::string value;
 };
 
+// The sections and their entries are kept in lists, in the order they are
+// serialized, and indexed by name so that the look ups don't scan the lists.
+// The lists may be iterated directly but must only be modified through the
+// methods below, and the names must not be changed in place, as the index
+// refers to them.
 struct section_t {
+  section_t() = default;
+  explicit section_t(std::string section_name)
+      : name(std::move(section_name)) {}
+  section_t(const section_t& other) : name(other.name), entries(other.entries) {
+    Reindex();
+  }
+  section_t(section_t&& other) = default;
+  section_t& operator=(const section_t& other) {
+    if (this != &other) {
+      name = other.name;
+      entries = other.entries;
+      Reindex();
+    }
+    return *this;
+  }
+  section_t& operator=(section_t&& other) = default;
+
   std::string name;
   std::list<entry_t> entries;
   void Set(std::string key, std::string value);
   std::list<entry_t>::iterator Find(const std::string& key);
   bool Has(const std::string& key);
+  std::list<entry_t>::const_iterator Find(const std::string& key) const {
+    auto it = index_.find(key);
+    return it == index_.end() ? entries.end() : it->second;
+  }
+  // Removes |entry| and returns the entry following it
+  std::list<entry_t>::iterator Erase(std::list<entry_t>::iterator entry) {
+    index_.erase(entry->key);
+    return entries.erase(entry);
+  }
+
+ private:
+  void Reindex() {
+    index_.clear();
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+      index_.emplace(it->key, it);
+    }
+  }
+  std::unordered_map<std::string_view, std::list<entry_t>::iterator> index_;
 };
 
 struct config_t {
+  config_t() = default;
+  config_t(const config_t& other) : sections(other.sections) { Reindex(); }
+  config_t(config_t&& other) = default;
+  config_t& operator=(const config_t& other) {
+    if (this != &other) {
+      sections = other.sections;
+      Reindex();
+    }
+    return *this;
+  }
+  config_t& operator=(config_t&& other) = default;
+
   std::list<section_t> sections;
   std::list<section_t>::iterator Find(const std::string& section);
   bool Has(const std::string& section);
+  std::list<section_t>::const_iterator Find(const std::string& section) const {
+    auto it = index_.find(section);
+    return it == index_.end() ? sections.end() : it->second;
+  }
+  // Appends |section|, or replaces the section with the same name in place
+  std::list<section_t>::iterator Append(section_t section) {
+    auto it = index_.find(section.name);
+    if (it != index_.end()) {
+      auto existing = it->second;
+      index_.erase(it);
+      *existing = std::move(section);
+      index_.emplace(existing->name, existing);
+      return existing;
+    }
+    sections.emplace_back(std::move(section));
+    auto appended = std::prev(sections.end());
+    index_.emplace(appended->name, appended);
+    return appended;
+  }
+  // Removes |section| and returns the section following it
+  std::list<section_t>::iterator Erase(std::list<section_t>::iterator section) {
+    index_.erase(section->name);
+    return sections.erase(section);
+  }
+  // Removes |section| and returns it
+  section_t Extract(std::list<section_t>::iterator section) {
+    index_.erase(section->name);
+    section_t extracted = std::move(*section);
+    sections.erase(section);
+    return extracted;
+  }
+  void Clear() {
+    index_.clear();
+    sections.clear();
+  }
+
+ private:
+  void Reindex() {
+    index_.clear();
+    for (auto it = sections.begin(); it != sections.end(); ++it) {
+      index_.emplace(it->name, it);
+    }
+  }
+  std::unordered_map<std::string_view, std::list<section_t>::iterator> index_;
 };
 
 // Creates a new config object with no entries (i.e. not backed by a file).
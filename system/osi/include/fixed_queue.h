@@ -36,6 +36,16 @@ typedef void (*fixed_queue_cb)(fixed_queue_t* queue, void* context);
 // the returned queue with |fixed_queue_free|.
 fixed_queue_t* fixed_queue_new(size_t capacity);
 
+// Creates a new fixed queue like |fixed_queue_new| for use by exactly one
+// producer thread and one consumer thread. Elements are kept in a lock-free
+// ring of |capacity| entries, and the queue only makes syscalls to wake a
+// side that had to wait. |capacity| must be between 1 and 65536.
+// |fixed_queue_try_remove_from_queue|, |fixed_queue_get_list| and
+// |fixed_queue_get_enqueue_fd| are not supported on such queues. The
+// dequeue fd may be readable while the queue is empty, and is meant for
+// |fixed_queue_register_dequeue|. Returns NULL on failure.
+fixed_queue_t* fixed_queue_new_spsc(size_t capacity);
+
 // Frees a queue and (optionally) the enqueued elements.
 // |queue| is the queue to free. If the |free_cb| callback is not null,
 // it is called on each queue element to free it.
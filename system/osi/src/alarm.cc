@@ -35,12 +35,13 @@
 
 #include <hardware/bluetooth.h>
 
+#include <algorithm>
 #include <mutex>
+#include <vector>
 
 #include "check.h"
 #include "osi/include/allocator.h"
 #include "osi/include/fixed_queue.h"
-#include "osi/include/list.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
 #include "osi/include/semaphore.h"
@@ -71,6 +72,8 @@ typedef struct {
   uint64_t last_update_ms;
   stat_t overdue_scheduling;
   stat_t premature_scheduling;
+  size_t wakeup_count;     // Dispatches that woke the dispatcher up
+  size_t coalesced_count;  // Dispatches that shared an earlier wakeup
 } alarm_stats_t;
 
 /* Wrapper around CancellableClosure that let it be embedded in structs, without
@@ -84,6 +87,13 @@ struct CancelableClosureInStruct {
   }
 };
 
+// Intrusive, circular doubly-linked list node. List heads have a NULL alarm.
+typedef struct alarm_link_t {
+  struct alarm_link_t* next;
+  struct alarm_link_t* prev;
+  alarm_t* alarm;
+} alarm_link_t;
+
 struct alarm_t {
   // The mutex is held while the callback for this alarm is being executed.
   // It allows us to release the coarse-grained monitor lock while a
@@ -93,6 +103,7 @@ struct alarm_t {
   std::shared_ptr<std::recursive_mutex> callback_mutex;
   uint64_t creation_time_ms;
   uint64_t period_ms;
+  uint64_t slack_ms;  // How late the alarm may fire to share a wakeup
   uint64_t deadline_ms;
   uint64_t prev_deadline_ms;  // Previous deadline - used for accounting of
                               // periodic timers
@@ -104,8 +115,37 @@ struct alarm_t {
 
   bool for_msg_loop;  // True, if the alarm should be processed on message loop
   CancelableClosureInStruct closure;  // posted to message loop for processing
+
+  alarm_link_t link;    // Position in |alarms|, |link.next| is NULL if unset
+  uint8_t wheel_level;  // Where |link| is filed, see alarm_wheel_t
+  uint8_t wheel_slot;
 };
 
+// Pending alarms are kept in a hierarchical timing wheel. Level |l| has
+// ALARM_WHEEL_SLOTS slots of 2^(l * ALARM_WHEEL_BITS) ms each. An alarm is
+// filed at the lowest level whose span covers its distance from |time_ms|,
+// and is moved down when the wheel reaches the start of its slot, so insert
+// and cancel are O(1). Alarms beyond the top level wait on |overflow|, and
+// alarms that are due wait on |expired|, in deadline order, for
+// |callback_dispatch|. The wheel only advances when alarms are set or
+// dispatched, and skips over empty slots, so there are no periodic ticks.
+#define ALARM_WHEEL_BITS 6
+#define ALARM_WHEEL_SLOTS (1 << ALARM_WHEEL_BITS)
+#define ALARM_WHEEL_LEVELS 5
+#define ALARM_WHEEL_OVERFLOW ALARM_WHEEL_LEVELS
+#define ALARM_WHEEL_EXPIRED (ALARM_WHEEL_LEVELS + 1)
+
+typedef struct {
+  uint64_t time_ms;  // Every ms before |time_ms| has been processed
+  size_t count;      // Alarms in the wheel, |overflow| and |expired|
+  uint64_t occupied[ALARM_WHEEL_LEVELS];  // Bitmaps of non-empty slots
+  alarm_link_t slots[ALARM_WHEEL_LEVELS][ALARM_WHEEL_SLOTS];
+  alarm_link_t overflow;
+  alarm_link_t expired;
+  bool next_valid;  // Whether |next| is the earliest pending alarm
+  alarm_t* next;
+} alarm_wheel_t;
+
 // If the next wakeup time is less than this threshold, we should acquire
 // a wakelock instead of setting a wake alarm so we're not bouncing in
 // and out of suspend frequently. This value is externally visible to allow
@@ -115,9 +155,9 @@ static const clockid_t CLOCK_ID = CLOCK_BOOTTIME;
 
 // This mutex ensures that the |alarm_set|, |alarm_cancel|, and alarm callback
 // functions execute serially and not concurrently. As a result, this mutex
-// also protects the |alarms| list.
+// also protects the |alarms| wheel.
 static std::mutex alarms_mutex;
-static list_t* alarms;
+static alarm_wheel_t* alarms;
 static timer_t timer;
 static timer_t wakeup_timer;
 static bool timer_set;
@@ -152,6 +192,225 @@ static void update_scheduling_stats(alarm_stats_t* stats, uint64_t now_ms,
 static void alarm_register_processing_queue(fixed_queue_t* queue,
                                             thread_t* thread);
 
+static void link_init(alarm_link_t* head) {
+  head->next = head;
+  head->prev = head;
+  head->alarm = NULL;
+}
+
+static bool link_is_empty(const alarm_link_t* head) {
+  return head->next == head;
+}
+
+static void link_insert_before(alarm_link_t* pos, alarm_link_t* link) {
+  link->next = pos;
+  link->prev = pos->prev;
+  pos->prev->next = link;
+  pos->prev = link;
+}
+
+static void link_remove(alarm_link_t* link) {
+  link->prev->next = link->next;
+  link->next->prev = link->prev;
+  link->next = NULL;
+  link->prev = NULL;
+}
+
+static uint64_t rotate_right(uint64_t bits, unsigned shift) {
+  return (bits >> shift) | (bits << ((64 - shift) & 63));
+}
+
+// Offset, in slots of |level|, from the current slot to the first non-empty
+// one. The current slot is only pending while |time_ms| is at its start,
+// otherwise it holds alarms a full turn ahead.
+static uint64_t wheel_first_slot_offset(unsigned level) {
+  unsigned shift = level * ALARM_WHEEL_BITS;
+  uint64_t time = alarms->time_ms;
+  unsigned first = (time >> shift) & (ALARM_WHEEL_SLOTS - 1);
+  uint64_t offset = 0;
+  if ((time & ((1ULL << shift) - 1)) != 0) {
+    first = (first + 1) & (ALARM_WHEEL_SLOTS - 1);
+    offset = 1;
+  }
+  return offset + __builtin_ctzll(rotate_right(alarms->occupied[level], first));
+}
+
+// Files |alarm| by its deadline relative to the wheel time.
+static void wheel_file(alarm_t* alarm) {
+  uint64_t deadline_ms = alarm->deadline_ms;
+  alarm->link.alarm = alarm;
+  if (deadline_ms < alarms->time_ms) {
+    alarm_link_t* pos = &alarms->expired;
+    while (pos->prev != &alarms->expired &&
+           pos->prev->alarm->deadline_ms > deadline_ms)
+      pos = pos->prev;
+    alarm->wheel_level = ALARM_WHEEL_EXPIRED;
+    link_insert_before(pos, &alarm->link);
+    return;
+  }
+
+  uint64_t delta_ms = deadline_ms - alarms->time_ms;
+  for (unsigned level = 0; level < ALARM_WHEEL_LEVELS; level++) {
+    unsigned shift = level * ALARM_WHEEL_BITS;
+    if (delta_ms < (1ULL << (shift + ALARM_WHEEL_BITS))) {
+      unsigned slot = (deadline_ms >> shift) & (ALARM_WHEEL_SLOTS - 1);
+      alarm->wheel_level = level;
+      alarm->wheel_slot = slot;
+      link_insert_before(&alarms->slots[level][slot], &alarm->link);
+      alarms->occupied[level] |= 1ULL << slot;
+      return;
+    }
+  }
+
+  alarm->wheel_level = ALARM_WHEEL_OVERFLOW;
+  link_insert_before(&alarms->overflow, &alarm->link);
+}
+
+static void wheel_unfile(alarm_t* alarm) {
+  link_remove(&alarm->link);
+  if (alarm->wheel_level < ALARM_WHEEL_LEVELS &&
+      link_is_empty(&alarms->slots[alarm->wheel_level][alarm->wheel_slot]))
+    alarms->occupied[alarm->wheel_level] &= ~(1ULL << alarm->wheel_slot);
+}
+
+// Moves every alarm on |head| to where it belongs at the current wheel time
+static void wheel_refile(alarm_link_t* head) {
+  alarm_link_t pending;
+  link_init(&pending);
+  if (!link_is_empty(head)) {
+    pending.next = head->next;
+    pending.prev = head->prev;
+    pending.next->prev = &pending;
+    pending.prev->next = &pending;
+    link_init(head);
+  }
+  while (!link_is_empty(&pending)) {
+    alarm_t* alarm = pending.next->alarm;
+    link_remove(&alarm->link);
+    wheel_file(alarm);
+  }
+}
+
+// Time of the next slot that must be processed, UINT64_MAX if none
+static uint64_t wheel_next_event_ms(void) {
+  uint64_t next_ms = UINT64_MAX;
+  for (unsigned level = 0; level < ALARM_WHEEL_LEVELS; level++) {
+    if (!alarms->occupied[level]) continue;
+    unsigned shift = level * ALARM_WHEEL_BITS;
+    uint64_t slot_ms = ((alarms->time_ms >> shift) +
+                        wheel_first_slot_offset(level))
+                       << shift;
+    next_ms = std::min(next_ms, slot_ms);
+  }
+  if (!link_is_empty(&alarms->overflow)) {
+    unsigned shift = ALARM_WHEEL_LEVELS * ALARM_WHEEL_BITS;
+    uint64_t mask = (1ULL << shift) - 1;
+    next_ms = std::min(next_ms, (alarms->time_ms + mask) & ~mask);
+  }
+  return next_ms;
+}
+
+// Processes the slots at |time_ms|: alarms from higher levels are moved
+// down, and the alarms due at |time_ms| are moved to |expired|.
+static void wheel_process_slots(void) {
+  uint64_t time = alarms->time_ms;
+  unsigned top_shift = ALARM_WHEEL_LEVELS * ALARM_WHEEL_BITS;
+  if ((time & ((1ULL << top_shift) - 1)) == 0) wheel_refile(&alarms->overflow);
+
+  for (unsigned level = ALARM_WHEEL_LEVELS - 1; level > 0; level--) {
+    unsigned shift = level * ALARM_WHEEL_BITS;
+    if ((time & ((1ULL << shift) - 1)) != 0) continue;
+    unsigned slot = (time >> shift) & (ALARM_WHEEL_SLOTS - 1);
+    if (!(alarms->occupied[level] & (1ULL << slot))) continue;
+    alarms->occupied[level] &= ~(1ULL << slot);
+    wheel_refile(&alarms->slots[level][slot]);
+  }
+
+  // Everything in the current level 0 slot is due now
+  alarms->time_ms = time + 1;
+  unsigned slot = time & (ALARM_WHEEL_SLOTS - 1);
+  if (alarms->occupied[0] & (1ULL << slot)) {
+    alarms->occupied[0] &= ~(1ULL << slot);
+    wheel_refile(&alarms->slots[0][slot]);
+  }
+}
+
+// Processes the wheel up to and including |now_ms|
+static void wheel_advance(uint64_t now_ms) {
+  while (alarms->time_ms <= now_ms) {
+    uint64_t next_ms = wheel_next_event_ms();
+    if (next_ms > now_ms) {
+      alarms->time_ms = now_ms + 1;
+      break;
+    }
+    alarms->time_ms = next_ms;
+    wheel_process_slots();
+  }
+}
+
+static void wheel_insert(alarm_t* alarm, uint64_t now_ms) {
+  wheel_advance(now_ms);
+  wheel_file(alarm);
+  alarms->count++;
+  if (alarms->next_valid &&
+      (alarms->next == NULL || alarm->deadline_ms < alarms->next->deadline_ms))
+    alarms->next = alarm;
+}
+
+static void wheel_remove(alarm_t* alarm) {
+  if (alarm->link.next == NULL) return;
+  wheel_unfile(alarm);
+  alarms->count--;
+  if (alarms->next == alarm) alarms->next_valid = false;
+}
+
+static alarm_t* alarm_min_deadline(const alarm_link_t* head, alarm_t* best) {
+  for (const alarm_link_t* link = head->next; link != head; link = link->next)
+    if (best == NULL || link->alarm->deadline_ms < best->deadline_ms)
+      best = link->alarm;
+  return best;
+}
+
+// Returns the pending alarm with the earliest deadline, NULL if none
+static alarm_t* wheel_front(void) {
+  if (alarms->next_valid) return alarms->next;
+
+  alarm_t* next = NULL;
+  if (!link_is_empty(&alarms->expired)) {
+    next = alarms->expired.next->alarm;
+  } else {
+    for (unsigned level = 0; level < ALARM_WHEEL_LEVELS; level++) {
+      if (!alarms->occupied[level]) continue;
+      unsigned slot = ((alarms->time_ms >> (level * ALARM_WHEEL_BITS)) +
+                       wheel_first_slot_offset(level)) &
+                      (ALARM_WHEEL_SLOTS - 1);
+      next = alarm_min_deadline(&alarms->slots[level][slot], next);
+    }
+    next = alarm_min_deadline(&alarms->overflow, next);
+  }
+
+  alarms->next = next;
+  alarms->next_valid = true;
+  return next;
+}
+
+// Removes and returns the earliest alarm that is due, NULL if none
+static alarm_t* wheel_pop_expired(void) {
+  if (link_is_empty(&alarms->expired)) return NULL;
+  alarm_t* alarm = alarms->expired.next->alarm;
+  wheel_remove(alarm);
+  return alarm;
+}
+
+// Rounds |deadline_ms| up to a multiple of the largest power of two that is
+// not above |slack_ms|. Alarms whose slack windows overlap are moved onto the
+// same boundary of the boot clock and are dispatched on a single wakeup.
+static uint64_t align_deadline(uint64_t deadline_ms, uint64_t slack_ms) {
+  if (slack_ms == 0) return deadline_ms;
+  uint64_t grain_ms = 1ULL << (63 - __builtin_clzll(slack_ms));
+  return (deadline_ms + grain_ms - 1) & ~(grain_ms - 1);
+}
+
 static void update_stat(stat_t* stat, uint64_t delta_ms) {
   if (stat->max_ms < delta_ms) stat->max_ms = delta_ms;
   stat->total_ms += delta_ms;
@@ -260,8 +519,7 @@ void alarm_cancel(alarm_t* alarm) {
 // Internal implementation of canceling an alarm.
 // The caller must hold the |alarms_mutex|
 static void alarm_cancel_internal(alarm_t* alarm) {
-  bool needs_reschedule =
-      (!list_is_empty(alarms) && list_front(alarms) == alarm);
+  bool needs_reschedule = alarm->link.next != NULL && wheel_front() == alarm;
 
   remove_pending_alarm(alarm);
 
@@ -275,6 +533,14 @@ static void alarm_cancel_internal(alarm_t* alarm) {
   if (needs_reschedule) reschedule_root_alarm();
 }
 
+void alarm_set_slack(alarm_t* alarm, uint64_t slack_ms) {
+  CHECK(alarms != NULL);
+  CHECK(alarm != NULL);
+
+  std::lock_guard<std::mutex> lock(alarms_mutex);
+  alarm->slack_ms = slack_ms;
+}
+
 bool alarm_is_scheduled(const alarm_t* alarm) {
   if ((alarms == NULL) || (alarm == NULL)) return false;
   return (alarm->callback != NULL);
@@ -301,7 +567,17 @@ void alarm_cleanup(void) {
   semaphore_free(alarm_expired);
   alarm_expired = NULL;
 
-  list_free(alarms);
+  // Alarms still set outlive the wheel, make them look unset
+  alarm_link_t* heads[ALARM_WHEEL_LEVELS * ALARM_WHEEL_SLOTS + 2];
+  size_t num_heads = 0;
+  for (auto& level : alarms->slots)
+    for (auto& slot : level) heads[num_heads++] = &slot;
+  heads[num_heads++] = &alarms->overflow;
+  heads[num_heads++] = &alarms->expired;
+  for (size_t i = 0; i < num_heads; i++)
+    while (!link_is_empty(heads[i])) link_remove(heads[i]->next);
+
+  osi_free(alarms);
   alarms = NULL;
 }
 
@@ -315,11 +591,13 @@ static bool lazy_initialize(void) {
 
   std::lock_guard<std::mutex> lock(alarms_mutex);
 
-  alarms = list_new(NULL);
-  if (!alarms) {
-    LOG_ERROR("%s unable to allocate alarm list.", __func__);
-    goto error;
-  }
+  alarms = static_cast<alarm_wheel_t*>(osi_calloc(sizeof(alarm_wheel_t)));
+  for (auto& level : alarms->slots)
+    for (auto& slot : level) link_init(&slot);
+  link_init(&alarms->overflow);
+  link_init(&alarms->expired);
+  alarms->next_valid = true;
+  alarms->time_ms = now_ms();
 
   if (!timer_create_internal(CLOCK_ID, &timer)) goto error;
   timer_initialized = true;
@@ -380,7 +658,7 @@ error:
 
   if (timer_initialized) timer_delete(timer);
 
-  list_free(alarms);
+  osi_free(alarms);
   alarms = NULL;
 
   return false;
@@ -401,7 +679,7 @@ static uint64_t now_ms(void) {
 // Remove alarm from internal alarm list and the processing queue
 // The caller must hold the |alarms_mutex|
 static void remove_pending_alarm(alarm_t* alarm) {
-  list_remove(alarms, alarm);
+  wheel_remove(alarm);
 
   if (alarm->for_msg_loop) {
     alarm->closure.i.Cancel();
@@ -416,10 +694,9 @@ static void remove_pending_alarm(alarm_t* alarm) {
 
 // Must be called with |alarms_mutex| held
 static void schedule_next_instance(alarm_t* alarm) {
-  // If the alarm is currently set and it's at the start of the list,
-  // we'll need to re-schedule since we've adjusted the earliest deadline.
-  bool needs_reschedule =
-      (!list_is_empty(alarms) && list_front(alarms) == alarm);
+  // If the alarm is currently set and it's the earliest one, we'll need to
+  // re-schedule since we've adjusted the earliest deadline.
+  bool needs_reschedule = alarm->link.next != NULL && wheel_front() == alarm;
   if (alarm->callback) remove_pending_alarm(alarm);
 
   // Calculate the next deadline for this alarm
@@ -428,28 +705,14 @@ static void schedule_next_instance(alarm_t* alarm) {
   if ((alarm->is_periodic) && (alarm->period_ms != 0))
     ms_into_period =
         ((just_now_ms - alarm->creation_time_ms) % alarm->period_ms);
-  alarm->deadline_ms = just_now_ms + (alarm->period_ms - ms_into_period);
+  alarm->deadline_ms = align_deadline(
+      just_now_ms + (alarm->period_ms - ms_into_period), alarm->slack_ms);
 
-  // Add it into the timer list sorted by deadline (earliest deadline first).
-  if (list_is_empty(alarms) ||
-      ((alarm_t*)list_front(alarms))->deadline_ms > alarm->deadline_ms) {
-    list_prepend(alarms, alarm);
-  } else {
-    for (list_node_t* node = list_begin(alarms); node != list_end(alarms);
-         node = list_next(node)) {
-      list_node_t* next = list_next(node);
-      if (next == list_end(alarms) ||
-          ((alarm_t*)list_node(next))->deadline_ms > alarm->deadline_ms) {
-        list_insert_after(alarms, node, alarm);
-        break;
-      }
-    }
-  }
+  wheel_insert(alarm, just_now_ms);
 
   // If the new alarm has the earliest deadline, we need to re-evaluate our
   // schedule.
-  if (needs_reschedule ||
-      (!list_is_empty(alarms) && list_front(alarms) == alarm)) {
+  if (needs_reschedule || wheel_front() == alarm) {
     reschedule_root_alarm();
   }
 }
@@ -466,9 +729,9 @@ static void reschedule_root_alarm(void) {
   struct itimerspec timer_time;
   memset(&timer_time, 0, sizeof(timer_time));
 
-  if (list_is_empty(alarms)) goto done;
+  next = wheel_front();
+  if (next == NULL) goto done;
 
-  next = static_cast<alarm_t*>(list_front(alarms));
   next_expiration = next->deadline_ms - now_ms();
   if (next_expiration < TIMER_INTERVAL_FOR_WAKELOCK_IN_MS) {
     if (!timer_set) {
@@ -626,16 +889,23 @@ static void callback_dispatch(UNUSED_ATTR void* context) {
     alarm_t* alarm;
 
     // Take into account that the alarm may get cancelled before we get to it.
-    // We're done here if there are no alarms or the alarm at the front is in
-    // the future. Exit right away since there's nothing left to do.
-    if (list_is_empty(alarms) ||
-        (alarm = static_cast<alarm_t*>(list_front(alarms)))->deadline_ms >
-            now_ms()) {
+    // We're done here if no alarm is due yet. Exit right away since there's
+    // nothing left to do.
+    // Alarms already due before the wheel is advanced share a wakeup that an
+    // earlier alarm paid for.
+    bool coalesced = !link_is_empty(&alarms->expired);
+    wheel_advance(now_ms());
+    alarm = wheel_pop_expired();
+    if (alarm == NULL) {
       reschedule_root_alarm();
       continue;
     }
 
-    list_remove(alarms, alarm);
+    if (coalesced) {
+      alarm->stats.coalesced_count++;
+    } else {
+      alarm->stats.wakeup_count++;
+    }
 
     if (alarm->is_periodic) {
       alarm->prev_deadline_ms = alarm->deadline_ms;
@@ -734,38 +1004,52 @@ void alarm_debug_dump(int fd) {
 
   uint64_t just_now_ms = now_ms();
 
-  dprintf(fd, "  Total Alarms: %zu\n\n", list_length(alarms));
+  dprintf(fd, "  Total Alarms: %zu\n\n", alarms->count);
+
+  // Dump info for each alarm, due ones first
+  std::vector<alarm_link_t*> heads = {&alarms->expired};
+  for (auto& level : alarms->slots)
+    for (auto& slot : level) heads.push_back(&slot);
+  heads.push_back(&alarms->overflow);
+
+  for (alarm_link_t* head : heads) {
+    for (alarm_link_t* link = head->next; link != head; link = link->next) {
+      alarm_t* alarm = link->alarm;
+      alarm_stats_t* stats = &alarm->stats;
 
-  // Dump info for each alarm
-  for (list_node_t* node = list_begin(alarms); node != list_end(alarms);
-       node = list_next(node)) {
-    alarm_t* alarm = (alarm_t*)list_node(node);
-    alarm_stats_t* stats = &alarm->stats;
+      dprintf(fd, "  Alarm : %s (%s)\n", stats->name,
+              (alarm->is_periodic) ? "PERIODIC" : "SINGLE");
 
-    dprintf(fd, "  Alarm : %s (%s)\n", stats->name,
-            (alarm->is_periodic) ? "PERIODIC" : "SINGLE");
+      dprintf(fd, "%-51s: %zu / %zu / %zu / %zu\n",
+              "    Action counts (sched/resched/exec/cancel)",
+              stats->scheduled_count, stats->rescheduled_count,
+              stats->total_updates, stats->canceled_count);
 
-    dprintf(fd, "%-51s: %zu / %zu / %zu / %zu\n",
-            "    Action counts (sched/resched/exec/cancel)",
-            stats->scheduled_count, stats->rescheduled_count,
-            stats->total_updates, stats->canceled_count);
+      dprintf(fd, "%-51s: %zu / %zu\n",
+              "    Deviation counts (overdue/premature)",
+              stats->overdue_scheduling.count,
+              stats->premature_scheduling.count);
 
-    dprintf(fd, "%-51s: %zu / %zu\n",
-            "    Deviation counts (overdue/premature)",
-            stats->overdue_scheduling.count, stats->premature_scheduling.count);
+      dprintf(fd, "%-51s: %zu / %zu\n",
+              "    Dispatch counts (wakeup/coalesced)", stats->wakeup_count,
+              stats->coalesced_count);
 
-    dprintf(fd, "%-51s: %llu / %llu / %lld\n",
-            "    Time in ms (since creation/interval/remaining)",
-            (unsigned long long)(just_now_ms - alarm->creation_time_ms),
-            (unsigned long long)alarm->period_ms,
-            (long long)(alarm->deadline_ms - just_now_ms));
+      dprintf(fd, "%-51s: %llu / %llu / %lld\n",
+              "    Time in ms (since creation/interval/remaining)",
+              (unsigned long long)(just_now_ms - alarm->creation_time_ms),
+              (unsigned long long)alarm->period_ms,
+              (long long)(alarm->deadline_ms - just_now_ms));
 
-    dump_stat(fd, &stats->overdue_scheduling,
-              "    Overdue scheduling time in ms (total/max/avg)");
+      dprintf(fd, "%-51s: %llu\n", "    Slack in ms",
+              (unsigned long long)alarm->slack_ms);
 
-    dump_stat(fd, &stats->premature_scheduling,
-              "    Premature scheduling time in ms (total/max/avg)");
+      dump_stat(fd, &stats->overdue_scheduling,
+                "    Overdue scheduling time in ms (total/max/avg)");
 
-    dprintf(fd, "\n");
+      dump_stat(fd, &stats->premature_scheduling,
+                "    Premature scheduling time in ms (total/max/avg)");
+
+      dprintf(fd, "\n");
+    }
   }
 }
@@ -21,10 +21,14 @@
 #include "osi/include/allocation_tracker.h"
 
 #include <base/logging.h>
+#include <dlfcn.h>
 #include <stdlib.h>
 #include <string.h>
+#include <algorithm>
+#include <atomic>
 #include <mutex>
 #include <unordered_map>
+#include <vector>
 
 #include "check.h"
 #include "osi/include/allocator.h"
@@ -42,7 +46,7 @@ static const size_t canary_size = 8;
 static char canary[canary_size];
 static std::unordered_map<void*, allocation_t*> allocations;
 static std::mutex tracker_lock;
-static bool enabled = false;
+static std::atomic<bool> enabled{false};
 
 // Memory allocation statistics
 static size_t alloc_counter = 0;
@@ -50,6 +54,147 @@ static size_t free_counter = 0;
 static size_t alloc_total_size = 0;
 static size_t free_total_size = 0;
 
+// Sampling mode, see allocation_tracker_init_sampling(). Only sampled
+// allocations take |sample_lock|. Frees first check |sample_filter|, a
+// counting filter over the addresses of live samples, so that the common
+// unsampled free does not lock.
+typedef struct {
+  const void* call_site;
+  size_t size;
+} sample_t;
+
+typedef struct {
+  size_t live_count;
+  size_t live_size;
+  size_t total_count;
+} call_site_stats_t;
+
+static const size_t sample_filter_size = 16384;
+static const size_t sample_dump_max_call_sites = 20;
+static std::atomic<size_t> sample_interval{0};
+static std::atomic<uint16_t> sample_filter[sample_filter_size];
+static std::mutex sample_lock;
+static std::unordered_map<void*, sample_t> samples;
+static std::unordered_map<const void*, call_site_stats_t> call_sites;
+static size_t sample_alloc_counter = 0;
+static size_t sample_free_counter = 0;
+
+// Allocations left before the calling thread takes its next sample
+static thread_local size_t sample_countdown = 0;
+static thread_local uint32_t sample_rand_state = 0;
+
+static size_t sample_filter_index(const void* ptr) {
+  uint64_t key = reinterpret_cast<uintptr_t>(ptr) >> 4;
+  return (key * 0x9E3779B97F4A7C15ull) >> 50;  // top 14 bits
+}
+
+// Intervals are drawn uniformly from [1, 2 * |interval| - 1] so that
+// periodic allocation patterns do not always sample the same call site.
+static size_t sample_next_countdown(size_t interval) {
+  uint32_t x = sample_rand_state;
+  if (x == 0) x = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&x)) | 1;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  sample_rand_state = x;
+  return 1 + x % (2 * interval - 1);
+}
+
+static void sample_clear(void) {
+  std::unique_lock<std::mutex> lock(sample_lock);
+  samples.clear();
+  call_sites.clear();
+  sample_alloc_counter = 0;
+  sample_free_counter = 0;
+  for (auto& count : sample_filter) count.store(0, std::memory_order_relaxed);
+}
+
+static void sample_notify_alloc(void* ptr, size_t size,
+                                const void* call_site, size_t interval) {
+  if (sample_countdown == 0) sample_countdown = sample_next_countdown(interval);
+  if (--sample_countdown != 0) return;
+
+  std::unique_lock<std::mutex> lock(sample_lock);
+  auto result = samples.emplace(ptr, sample_t{call_site, size});
+  if (!result.second) {
+    // The previous block at this address was never reported freed
+    call_site_stats_t& stale = call_sites[result.first->second.call_site];
+    stale.live_count--;
+    stale.live_size -= result.first->second.size;
+    result.first->second = sample_t{call_site, size};
+  } else {
+    sample_filter[sample_filter_index(ptr)].fetch_add(
+        1, std::memory_order_relaxed);
+  }
+
+  call_site_stats_t& stats = call_sites[call_site];
+  stats.live_count++;
+  stats.live_size += size;
+  stats.total_count++;
+  sample_alloc_counter++;
+}
+
+static void sample_notify_free(void* ptr) {
+  size_t index = sample_filter_index(ptr);
+  if (sample_filter[index].load(std::memory_order_relaxed) == 0) return;
+
+  std::unique_lock<std::mutex> lock(sample_lock);
+  auto sample = samples.find(ptr);
+  if (sample == samples.end()) return;
+
+  call_site_stats_t& stats = call_sites[sample->second.call_site];
+  stats.live_count--;
+  stats.live_size -= sample->second.size;
+  sample_free_counter++;
+  samples.erase(sample);
+  sample_filter[index].fetch_sub(1, std::memory_order_relaxed);
+}
+
+static void sample_debug_dump(int fd, size_t interval) {
+  std::vector<std::pair<const void*, call_site_stats_t>> live;
+  size_t sampled_allocs, sampled_frees;
+  {
+    std::unique_lock<std::mutex> lock(sample_lock);
+    sampled_allocs = sample_alloc_counter;
+    sampled_frees = sample_free_counter;
+    for (const auto& entry : call_sites) {
+      if (entry.second.live_count > 0) live.push_back(entry);
+    }
+  }
+
+  std::sort(live.begin(), live.end(), [](const auto& a, const auto& b) {
+    return a.second.live_size > b.second.live_size;
+  });
+  if (live.size() > sample_dump_max_call_sites) {
+    live.resize(sample_dump_max_call_sites);
+  }
+
+  dprintf(fd, "  Sampling 1 in %zu allocations\n", interval);
+  dprintf(fd, "  Sampled allocated/free/live counts : %zu / %zu / %zu\n",
+          sampled_allocs, sampled_frees, sampled_allocs - sampled_frees);
+  dprintf(fd, "  Estimated live octets by call site:\n");
+  for (const auto& entry : live) {
+    const void* call_site = entry.first;
+    const call_site_stats_t& stats = entry.second;
+    Dl_info info = {};
+    if (call_site != nullptr && dladdr(call_site, &info) != 0 &&
+        info.dli_sname != nullptr) {
+      dprintf(fd, "    %10zu %6zu  %s+0x%zx\n", stats.live_size * interval,
+              stats.live_count, info.dli_sname,
+              static_cast<size_t>(static_cast<const char*>(call_site) -
+                                  static_cast<const char*>(info.dli_saddr)));
+    } else if (info.dli_fname != nullptr) {
+      dprintf(fd, "    %10zu %6zu  %s+0x%zx\n", stats.live_size * interval,
+              stats.live_count, info.dli_fname,
+              static_cast<size_t>(static_cast<const char*>(call_site) -
+                                  static_cast<const char*>(info.dli_fbase)));
+    } else {
+      dprintf(fd, "    %10zu %6zu  %p\n", stats.live_size * interval,
+              stats.live_count, call_site);
+    }
+  }
+}
+
 void allocation_tracker_init(void) {
   std::unique_lock<std::mutex> lock(tracker_lock);
   if (enabled) return;
@@ -59,12 +204,23 @@ void allocation_tracker_init(void) {
 
   LOG_INFO("canary initialized");
 
+  sample_interval = 0;
   enabled = true;
 }
 
+void allocation_tracker_init_sampling(size_t interval) {
+  std::unique_lock<std::mutex> lock(tracker_lock);
+  if (enabled || interval == 0) return;
+
+  LOG_INFO("sampling 1 in %zu allocations", interval);
+  sample_interval = interval;
+}
+
 // Test function only. Do not call in the normal course of operations.
 void allocation_tracker_uninit(void) {
   std::unique_lock<std::mutex> lock(tracker_lock);
+  sample_interval = 0;
+  sample_clear();
   if (!enabled) return;
 
   allocations.clear();
@@ -73,6 +229,7 @@ void allocation_tracker_uninit(void) {
 
 void allocation_tracker_reset(void) {
   std::unique_lock<std::mutex> lock(tracker_lock);
+  sample_clear();
   if (!enabled) return;
 
   allocations.clear();
@@ -99,10 +256,26 @@ size_t allocation_tracker_expect_no_allocations(void) {
 
 void* allocation_tracker_notify_alloc(uint8_t allocator_id, void* ptr,
                                       size_t requested_size) {
+  return allocation_tracker_notify_alloc_from(allocator_id, ptr,
+                                              requested_size, nullptr);
+}
+
+void* allocation_tracker_notify_alloc_from(uint8_t allocator_id, void* ptr,
+                                           size_t requested_size,
+                                           const void* call_site) {
+  if (!ptr) return ptr;
+  if (!enabled) {
+    size_t interval = sample_interval.load(std::memory_order_relaxed);
+    if (interval != 0) {
+      sample_notify_alloc(ptr, requested_size, call_site, interval);
+    }
+    return ptr;
+  }
+
   char* return_ptr;
   {
     std::unique_lock<std::mutex> lock(tracker_lock);
-    if (!enabled || !ptr) return ptr;
+    if (!enabled) return ptr;
 
     // Keep statistics
     alloc_counter++;
@@ -135,9 +308,17 @@ void* allocation_tracker_notify_alloc(uint8_t allocator_id, void* ptr,
 
 void* allocation_tracker_notify_free(UNUSED_ATTR uint8_t allocator_id,
                                      void* ptr) {
+  if (!ptr) return ptr;
+  if (!enabled) {
+    if (sample_interval.load(std::memory_order_relaxed) != 0) {
+      sample_notify_free(ptr);
+    }
+    return ptr;
+  }
+
   std::unique_lock<std::mutex> lock(tracker_lock);
 
-  if (!enabled || !ptr) return ptr;
+  if (!enabled) return ptr;
 
   auto map_entry = allocations.find(ptr);
   CHECK(map_entry != allocations.end());
@@ -184,4 +365,10 @@ void osi_allocator_debug_dump(int fd) {
   dprintf(fd, "  Total allocated/free/used octets : %zu / %zu / %zu\n",
           alloc_total_size, free_total_size,
           alloc_total_size - free_total_size);
+  lock.unlock();
+
+  size_t interval = sample_interval.load(std::memory_order_relaxed);
+  if (interval != 0) sample_debug_dump(fd, interval);
+
+  osi_allocator_pool_debug_dump(fd);
 }
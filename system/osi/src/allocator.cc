@@ -16,23 +16,140 @@
  *
  ******************************************************************************/
 #include <base/logging.h>
+#include <malloc.h>
 #include <stdlib.h>
 #include <string.h>
 
+#include <atomic>
+
 #include "check.h"
 #include "osi/include/allocation_tracker.h"
 #include "osi/include/allocator.h"
 
 static const allocator_id_t alloc_allocator_id = 42;
 
+// Buffers of the sizes the stack allocates at packet rate are kept in small
+// per-thread caches and handed out again instead of going back to malloc.
+// Freed blocks are classified by malloc_usable_size(), so no header is needed
+// and blocks from plain malloc() may be given to osi_free() and vice versa.
+// Sanitizer builds bypass the caches so that use-after-free is still caught.
+#if defined(__SANITIZE_ADDRESS__)
+#define OSI_ALLOCATOR_POOL_DISABLED
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(hwaddress_sanitizer)
+#define OSI_ALLOCATOR_POOL_DISABLED
+#endif
+#endif
+
+namespace {
+
+// Control messages, small SDP/AVCTP buffers, ACL packets, L2CAP MTU sized
+// SDUs and BT_DEFAULT_BUFFER_SIZE media packets respectively.
+constexpr size_t kPoolClassSizes[] = {128, 680, 1100, 2048, 4112};
+constexpr size_t kPoolNumClasses =
+    sizeof(kPoolClassSizes) / sizeof(kPoolClassSizes[0]);
+constexpr size_t kPoolMaxBlockSize = 2 * kPoolClassSizes[kPoolNumClasses - 1];
+constexpr size_t kPoolCacheDepth = 32;
+
+struct pool_stats_t {
+  std::atomic<size_t> hits{0};
+  std::atomic<size_t> misses{0};
+  std::atomic<size_t> cached{0};
+  std::atomic<size_t> released{0};
+};
+
+pool_stats_t pool_stats[kPoolNumClasses];
+
+struct pool_cache_t {
+  void* blocks[kPoolNumClasses][kPoolCacheDepth];
+  size_t count[kPoolNumClasses];
+  ~pool_cache_t();
+};
+
+// Set once the calling thread's cache has been destroyed, after which the
+// thread falls back to malloc and free.
+thread_local bool pool_cache_gone = false;
+thread_local pool_cache_t pool_cache = {};
+
+pool_cache_t::~pool_cache_t() {
+  pool_cache_gone = true;
+  for (size_t i = 0; i < kPoolNumClasses; i++) {
+    while (count[i] > 0) free(blocks[i][--count[i]]);
+  }
+}
+
+// Smallest class holding |size| bytes, or kPoolNumClasses if none.
+size_t pool_class_for_alloc(size_t size) {
+  for (size_t i = 0; i < kPoolNumClasses; i++) {
+    if (size <= kPoolClassSizes[i]) return i;
+  }
+  return kPoolNumClasses;
+}
+
+// Largest class a block of |usable| bytes can serve, or kPoolNumClasses if
+// the block is too small or too large to be worth keeping.
+size_t pool_class_for_free(size_t usable) {
+  if (usable < kPoolClassSizes[0] || usable > kPoolMaxBlockSize) {
+    return kPoolNumClasses;
+  }
+  size_t i = kPoolNumClasses - 1;
+  while (kPoolClassSizes[i] > usable) i--;
+  return i;
+}
+
+void* pool_malloc(size_t size) {
+#if !defined(OSI_ALLOCATOR_POOL_DISABLED)
+  size_t cls = pool_class_for_alloc(size);
+  if (cls < kPoolNumClasses && !pool_cache_gone) {
+    if (pool_cache.count[cls] > 0) {
+      pool_stats[cls].hits.fetch_add(1, std::memory_order_relaxed);
+      return pool_cache.blocks[cls][--pool_cache.count[cls]];
+    }
+    pool_stats[cls].misses.fetch_add(1, std::memory_order_relaxed);
+    return malloc(kPoolClassSizes[cls]);
+  }
+#endif
+  return malloc(size);
+}
+
+void* pool_calloc(size_t size) {
+#if !defined(OSI_ALLOCATOR_POOL_DISABLED)
+  if (pool_class_for_alloc(size) < kPoolNumClasses) {
+    void* ptr = pool_malloc(size);
+    if (ptr != nullptr) memset(ptr, 0, size);
+    return ptr;
+  }
+#endif
+  return calloc(1, size);
+}
+
+void pool_free(void* ptr) {
+#if !defined(OSI_ALLOCATOR_POOL_DISABLED)
+  if (ptr != nullptr && !pool_cache_gone) {
+    size_t cls = pool_class_for_free(malloc_usable_size(ptr));
+    if (cls < kPoolNumClasses) {
+      if (pool_cache.count[cls] < kPoolCacheDepth) {
+        pool_stats[cls].cached.fetch_add(1, std::memory_order_relaxed);
+        pool_cache.blocks[cls][pool_cache.count[cls]++] = ptr;
+        return;
+      }
+      pool_stats[cls].released.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+#endif
+  free(ptr);
+}
+
+}  // namespace
+
 char* osi_strdup(const char* str) {
   size_t size = strlen(str) + 1;  // + 1 for the null terminator
   size_t real_size = allocation_tracker_resize_for_canary(size);
-  void* ptr = malloc(real_size);
+  void* ptr = pool_malloc(real_size);
   CHECK(ptr);
 
-  char* new_string = static_cast<char*>(
-      allocation_tracker_notify_alloc(alloc_allocator_id, ptr, size));
+  char* new_string = static_cast<char*>(allocation_tracker_notify_alloc_from(
+      alloc_allocator_id, ptr, size, __builtin_return_address(0)));
   if (!new_string) return NULL;
 
   memcpy(new_string, str, size);
@@ -44,11 +161,11 @@ char* osi_strndup(const char* str, size_t len) {
   if (len < size) size = len;
 
   size_t real_size = allocation_tracker_resize_for_canary(size + 1);
-  void* ptr = malloc(real_size);
+  void* ptr = pool_malloc(real_size);
   CHECK(ptr);
 
-  char* new_string = static_cast<char*>(
-      allocation_tracker_notify_alloc(alloc_allocator_id, ptr, size + 1));
+  char* new_string = static_cast<char*>(allocation_tracker_notify_alloc_from(
+      alloc_allocator_id, ptr, size + 1, __builtin_return_address(0)));
   if (!new_string) return NULL;
 
   memcpy(new_string, str, size);
@@ -59,21 +176,23 @@ char* osi_strndup(const char* str, size_t len) {
 void* osi_malloc(size_t size) {
   CHECK(static_cast<ssize_t>(size) >= 0);
   size_t real_size = allocation_tracker_resize_for_canary(size);
-  void* ptr = malloc(real_size);
+  void* ptr = pool_malloc(real_size);
   CHECK(ptr);
-  return allocation_tracker_notify_alloc(alloc_allocator_id, ptr, size);
+  return allocation_tracker_notify_alloc_from(alloc_allocator_id, ptr, size,
+                                              __builtin_return_address(0));
 }
 
 void* osi_calloc(size_t size) {
   CHECK(static_cast<ssize_t>(size) >= 0);
   size_t real_size = allocation_tracker_resize_for_canary(size);
-  void* ptr = calloc(1, real_size);
+  void* ptr = pool_calloc(real_size);
   CHECK(ptr);
-  return allocation_tracker_notify_alloc(alloc_allocator_id, ptr, size);
+  return allocation_tracker_notify_alloc_from(alloc_allocator_id, ptr, size,
+                                              __builtin_return_address(0));
 }
 
 void osi_free(void* ptr) {
-  free(allocation_tracker_notify_free(alloc_allocator_id, ptr));
+  pool_free(allocation_tracker_notify_free(alloc_allocator_id, ptr));
 }
 
 void osi_free_and_reset(void** p_ptr) {
@@ -82,6 +201,23 @@ void osi_free_and_reset(void** p_ptr) {
   *p_ptr = NULL;
 }
 
+void osi_allocator_pool_debug_dump(int fd) {
+  dprintf(fd, "\nBluetooth Buffer Pool Statistics:\n");
+#if defined(OSI_ALLOCATOR_POOL_DISABLED)
+  dprintf(fd, "  Disabled in this build\n");
+#else
+  dprintf(fd, "  %8s %10s %10s %10s %10s\n", "size", "hits", "misses",
+          "cached", "released");
+  for (size_t i = 0; i < kPoolNumClasses; i++) {
+    dprintf(fd, "  %8zu %10zu %10zu %10zu %10zu\n", kPoolClassSizes[i],
+            pool_stats[i].hits.load(std::memory_order_relaxed),
+            pool_stats[i].misses.load(std::memory_order_relaxed),
+            pool_stats[i].cached.load(std::memory_order_relaxed),
+            pool_stats[i].released.load(std::memory_order_relaxed));
+  }
+#endif
+}
+
 const allocator_t allocator_calloc = {osi_calloc, osi_free};
 
 const allocator_t allocator_malloc = {osi_malloc, osi_free};
@@ -32,64 +32,52 @@
 #include <unistd.h>
 
 #include <sstream>
-#include <type_traits>
 
 #include "check.h"
 
 void section_t::Set(std::string key, std::string value) {
-  for (entry_t& entry : entries) {
-    if (entry.key == key) {
-      entry.value = value;
-      return;
-    }
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    it->second->value = std::move(value);
+    return;
   }
   // add a new key to the section
   entries.emplace_back(
       entry_t{.key = std::move(key), .value = std::move(value)});
+  auto entry = std::prev(entries.end());
+  index_.emplace(entry->key, entry);
 }
 
 std::list<entry_t>::iterator section_t::Find(const std::string& key) {
-  return std::find_if(
-      entries.begin(), entries.end(),
-      [&key](const entry_t& entry) { return entry.key == key; });
+  auto it = index_.find(key);
+  return it == index_.end() ? entries.end() : it->second;
 }
 
 bool section_t::Has(const std::string& key) {
-  return Find(key) != entries.end();
+  return index_.find(key) != index_.end();
 }
 
 std::list<section_t>::iterator config_t::Find(const std::string& section) {
-  return std::find_if(
-      sections.begin(), sections.end(),
-      [&section](const section_t& sec) { return sec.name == section; });
+  auto it = index_.find(section);
+  return it == index_.end() ? sections.end() : it->second;
 }
 
 bool config_t::Has(const std::string& key) {
-  return Find(key) != sections.end();
+  return index_.find(key) != index_.end();
 }
 
 static bool config_parse(FILE* fp, config_t* config);
 
-template <typename T,
-          class = typename std::enable_if<std::is_same<
-              config_t, typename std::remove_const<T>::type>::value>>
-static auto section_find(T& config, const std::string& section) {
-  return std::find_if(
-      config.sections.begin(), config.sections.end(),
-      [&section](const section_t& sec) { return sec.name == section; });
-}
-
 static const entry_t* entry_find(const config_t& config,
                                  const std::string& section,
                                  const std::string& key) {
-  auto sec = section_find(config, section);
+  auto sec = config.Find(section);
   if (sec == config.sections.end()) return nullptr;
 
-  for (const entry_t& entry : sec->entries) {
-    if (entry.key == key) return &entry;
-  }
+  auto entry = sec->Find(key);
+  if (entry == sec->entries.end()) return nullptr;
 
-  return nullptr;
+  return &*entry;
 }
 
 std::unique_ptr<config_t> config_new_empty(void) {
@@ -130,19 +118,11 @@ std::string checksum_read(const char* filename) {
 }
 
 std::unique_ptr<config_t> config_new_clone(const config_t& src) {
-  std::unique_ptr<config_t> ret = config_new_empty();
-
-  for (const section_t& sec : src.sections) {
-    for (const entry_t& entry : sec.entries) {
-      config_set_string(ret.get(), sec.name, entry.key, entry.value);
-    }
-  }
-
-  return ret;
+  return std::make_unique<config_t>(src);
 }
 
 bool config_has_section(const config_t& config, const std::string& section) {
-  return (section_find(config, section) != config.sections.end());
+  return (config.Find(section) != config.sections.end());
 }
 
 bool config_has_key(const config_t& config, const std::string& section,
@@ -210,10 +190,9 @@ void config_set_string(config_t* config, const std::string& section,
                        const std::string& key, const std::string& value) {
   CHECK(config);
 
-  auto sec = section_find(*config, section);
+  auto sec = config->Find(section);
   if (sec == config->sections.end()) {
-    config->sections.emplace_back(section_t{.name = section});
-    sec = std::prev(config->sections.end());
+    sec = config->Append(section_t(section));
   }
 
   std::string value_no_newline;
@@ -225,41 +204,30 @@ void config_set_string(config_t* config, const std::string& section,
     value_no_newline = value;
   }
 
-  for (entry_t& entry : sec->entries) {
-    if (entry.key == key) {
-      entry.value = value_no_newline;
-      return;
-    }
-  }
-
-  sec->entries.emplace_back(entry_t{.key = key, .value = value_no_newline});
+  sec->Set(key, std::move(value_no_newline));
 }
 
 bool config_remove_section(config_t* config, const std::string& section) {
   CHECK(config);
 
-  auto sec = section_find(*config, section);
+  auto sec = config->Find(section);
   if (sec == config->sections.end()) return false;
 
-  config->sections.erase(sec);
+  config->Erase(sec);
   return true;
 }
 
 bool config_remove_key(config_t* config, const std::string& section,
                        const std::string& key) {
   CHECK(config);
-  auto sec = section_find(*config, section);
+  auto sec = config->Find(section);
   if (sec == config->sections.end()) return false;
 
-  for (auto entry = sec->entries.begin(); entry != sec->entries.end();
-       ++entry) {
-    if (entry->key == key) {
-      sec->entries.erase(entry);
-      return true;
-    }
-  }
+  auto entry = sec->Find(key);
+  if (entry == sec->entries.end()) return false;
 
-  return false;
+  sec->Erase(entry);
+  return true;
 }
 
 bool config_save(const config_t& config, const std::string& filename) {
@@ -17,8 +17,13 @@
  ******************************************************************************/
 
 #include <base/logging.h>
+#include <errno.h>
+#include <poll.h>
 #include <string.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
+#include <atomic>
 #include <mutex>
 
 #include "check.h"
@@ -29,7 +34,28 @@
 #include "osi/include/reactor.h"
 #include "osi/include/semaphore.h"
 
+// Ring used by queues from fixed_queue_new_spsc(). |head| is only written by
+// the consumer and |tail| only by the producer. A side that finds the ring
+// empty (or full) sets its |*_waiting| flag and checks again before sleeping
+// on its eventfd. The other side only writes that eventfd after clearing a
+// set flag, so there are no syscalls while both sides keep up.
+// The flags are only cleared by the side that wakes the sleeper.
+typedef struct {
+  alignas(64) std::atomic<size_t> head;
+  std::atomic<bool> consumer_waiting;
+  alignas(64) std::atomic<size_t> tail;
+  std::atomic<bool> producer_waiting;
+  alignas(64) size_t mask;
+  void** slots;
+  int dequeue_fd;
+  int enqueue_fd;
+} spsc_ring_t;
+
+static const size_t SPSC_MAX_CAPACITY = 1 << 16;
+
 typedef struct fixed_queue_t {
+  spsc_ring_t* ring;  // Not NULL for single producer single consumer queues
+
   list_t* list;
   semaphore_t* enqueue_sem;
   semaphore_t* dequeue_sem;
@@ -43,6 +69,99 @@ typedef struct fixed_queue_t {
 
 static void internal_dequeue_ready(void* context);
 
+static bool spsc_is_empty(spsc_ring_t* ring) {
+  size_t head = ring->head.load(std::memory_order_seq_cst);
+  return head == ring->tail.load(std::memory_order_seq_cst);
+}
+
+static bool spsc_is_full(spsc_ring_t* ring, size_t capacity) {
+  size_t head = ring->head.load(std::memory_order_seq_cst);
+  return ring->tail.load(std::memory_order_seq_cst) - head >= capacity;
+}
+
+static void spsc_wake(std::atomic<bool>& waiting, int fd) {
+  if (waiting.load(std::memory_order_seq_cst) &&
+      waiting.exchange(false, std::memory_order_seq_cst)) {
+    if (eventfd_write(fd, 1ULL) == -1)
+      LOG_ERROR("%s unable to wake queue waiter: %s", __func__,
+                strerror(errno));
+  }
+}
+
+// Blocks until |fd| has been written to since it was last cleared.
+static void spsc_sleep(int fd) {
+  struct pollfd pfd;
+  pfd.fd = fd;
+  pfd.events = POLLIN;
+  pfd.revents = 0;
+  int ret;
+  OSI_NO_INTR(ret = poll(&pfd, 1, -1));
+  eventfd_t value;
+  eventfd_read(fd, &value);
+}
+
+static bool spsc_try_push(fixed_queue_t* queue, void* data) {
+  spsc_ring_t* ring = queue->ring;
+  size_t tail = ring->tail.load(std::memory_order_relaxed);
+  if (tail - ring->head.load(std::memory_order_acquire) >= queue->capacity)
+    return false;
+
+  ring->slots[tail & ring->mask] = data;
+  ring->tail.store(tail + 1, std::memory_order_seq_cst);
+  spsc_wake(ring->consumer_waiting, ring->dequeue_fd);
+  return true;
+}
+
+static void* spsc_try_pop(fixed_queue_t* queue) {
+  spsc_ring_t* ring = queue->ring;
+  size_t head = ring->head.load(std::memory_order_relaxed);
+  if (head == ring->tail.load(std::memory_order_acquire)) return NULL;
+
+  void* data = ring->slots[head & ring->mask];
+  ring->head.store(head + 1, std::memory_order_seq_cst);
+  spsc_wake(ring->producer_waiting, ring->enqueue_fd);
+  return data;
+}
+
+static void spsc_ring_free(spsc_ring_t* ring) {
+  if (ring->dequeue_fd != INVALID_FD) close(ring->dequeue_fd);
+  if (ring->enqueue_fd != INVALID_FD) close(ring->enqueue_fd);
+  delete[] ring->slots;
+  delete ring;
+}
+
+fixed_queue_t* fixed_queue_new_spsc(size_t capacity) {
+  CHECK(capacity > 0 && capacity <= SPSC_MAX_CAPACITY);
+
+  fixed_queue_t* ret =
+      static_cast<fixed_queue_t*>(osi_calloc(sizeof(fixed_queue_t)));
+  ret->capacity = capacity;
+
+  size_t slots = 1;
+  while (slots < capacity) slots <<= 1;
+
+  spsc_ring_t* ring = new spsc_ring_t();
+  ring->head = 0;
+  ring->tail = 0;
+  // Nobody is consuming yet, so the first enqueue signals the dequeue fd
+  ring->consumer_waiting = true;
+  ring->producer_waiting = false;
+  ring->mask = slots - 1;
+  ring->slots = new void*[slots];
+  ring->dequeue_fd = eventfd(0, EFD_NONBLOCK);
+  ring->enqueue_fd = eventfd(0, EFD_NONBLOCK);
+  ret->ring = ring;
+
+  if (ring->dequeue_fd == INVALID_FD || ring->enqueue_fd == INVALID_FD) {
+    LOG_ERROR("%s unable to allocate queue eventfd: %s", __func__,
+              strerror(errno));
+    fixed_queue_free(ret, NULL);
+    return NULL;
+  }
+
+  return ret;
+}
+
 fixed_queue_t* fixed_queue_new(size_t capacity) {
   fixed_queue_t* ret =
       static_cast<fixed_queue_t*>(osi_calloc(sizeof(fixed_queue_t)));
@@ -71,6 +190,15 @@ void fixed_queue_free(fixed_queue_t* queue, fixed_queue_free_cb free_cb) {
 
   fixed_queue_unregister_dequeue(queue);
 
+  if (queue->ring) {
+    void* data;
+    while ((data = spsc_try_pop(queue)) != NULL)
+      if (free_cb) free_cb(data);
+    spsc_ring_free(queue->ring);
+    osi_free(queue);
+    return;
+  }
+
   if (free_cb)
     for (const list_node_t* node = list_begin(queue->list);
          node != list_end(queue->list); node = list_next(node))
@@ -96,6 +224,7 @@ void fixed_queue_flush(fixed_queue_t* queue, fixed_queue_free_cb free_cb) {
 
 bool fixed_queue_is_empty(fixed_queue_t* queue) {
   if (queue == NULL) return true;
+  if (queue->ring) return spsc_is_empty(queue->ring);
 
   std::lock_guard<std::mutex> lock(*queue->mutex);
   return list_is_empty(queue->list);
@@ -103,6 +232,10 @@ bool fixed_queue_is_empty(fixed_queue_t* queue) {
 
 size_t fixed_queue_length(fixed_queue_t* queue) {
   if (queue == NULL) return 0;
+  if (queue->ring) {
+    size_t head = queue->ring->head.load(std::memory_order_acquire);
+    return queue->ring->tail.load(std::memory_order_acquire) - head;
+  }
 
   std::lock_guard<std::mutex> lock(*queue->mutex);
   return list_length(queue->list);
@@ -118,6 +251,15 @@ void fixed_queue_enqueue(fixed_queue_t* queue, void* data) {
   CHECK(queue != NULL);
   CHECK(data != NULL);
 
+  if (queue->ring) {
+    while (!spsc_try_push(queue, data)) {
+      queue->ring->producer_waiting.store(true, std::memory_order_seq_cst);
+      if (spsc_is_full(queue->ring, queue->capacity))
+        spsc_sleep(queue->ring->enqueue_fd);
+    }
+    return;
+  }
+
   semaphore_wait(queue->enqueue_sem);
 
   {
@@ -131,6 +273,15 @@ void fixed_queue_enqueue(fixed_queue_t* queue, void* data) {
 void* fixed_queue_dequeue(fixed_queue_t* queue) {
   CHECK(queue != NULL);
 
+  if (queue->ring) {
+    void* data;
+    while ((data = spsc_try_pop(queue)) == NULL) {
+      queue->ring->consumer_waiting.store(true, std::memory_order_seq_cst);
+      if (spsc_is_empty(queue->ring)) spsc_sleep(queue->ring->dequeue_fd);
+    }
+    return data;
+  }
+
   semaphore_wait(queue->dequeue_sem);
 
   void* ret = NULL;
@@ -149,6 +300,8 @@ bool fixed_queue_try_enqueue(fixed_queue_t* queue, void* data) {
   CHECK(queue != NULL);
   CHECK(data != NULL);
 
+  if (queue->ring) return spsc_try_push(queue, data);
+
   if (!semaphore_try_wait(queue->enqueue_sem)) return false;
 
   {
@@ -162,6 +315,7 @@ bool fixed_queue_try_enqueue(fixed_queue_t* queue, void* data) {
 
 void* fixed_queue_try_dequeue(fixed_queue_t* queue) {
   if (queue == NULL) return NULL;
+  if (queue->ring) return spsc_try_pop(queue);
 
   if (!semaphore_try_wait(queue->dequeue_sem)) return NULL;
 
@@ -179,6 +333,12 @@ void* fixed_queue_try_dequeue(fixed_queue_t* queue) {
 
 void* fixed_queue_try_peek_first(fixed_queue_t* queue) {
   if (queue == NULL) return NULL;
+  if (queue->ring) {
+    spsc_ring_t* ring = queue->ring;
+    size_t head = ring->head.load(std::memory_order_relaxed);
+    if (head == ring->tail.load(std::memory_order_acquire)) return NULL;
+    return ring->slots[head & ring->mask];
+  }
 
   std::lock_guard<std::mutex> lock(*queue->mutex);
   return list_is_empty(queue->list) ? NULL : list_front(queue->list);
@@ -186,6 +346,12 @@ void* fixed_queue_try_peek_first(fixed_queue_t* queue) {
 
 void* fixed_queue_try_peek_last(fixed_queue_t* queue) {
   if (queue == NULL) return NULL;
+  if (queue->ring) {
+    spsc_ring_t* ring = queue->ring;
+    size_t tail = ring->tail.load(std::memory_order_acquire);
+    if (ring->head.load(std::memory_order_acquire) == tail) return NULL;
+    return ring->slots[(tail - 1) & ring->mask];
+  }
 
   std::lock_guard<std::mutex> lock(*queue->mutex);
   return list_is_empty(queue->list) ? NULL : list_back(queue->list);
@@ -193,6 +359,7 @@ void* fixed_queue_try_peek_last(fixed_queue_t* queue) {
 
 void* fixed_queue_try_remove_from_queue(fixed_queue_t* queue, void* data) {
   if (queue == NULL) return NULL;
+  CHECK(queue->ring == NULL);
 
   bool removed = false;
   {
@@ -213,6 +380,7 @@ void* fixed_queue_try_remove_from_queue(fixed_queue_t* queue, void* data) {
 
 list_t* fixed_queue_get_list(fixed_queue_t* queue) {
   CHECK(queue != NULL);
+  CHECK(queue->ring == NULL);
 
   // NOTE: Using the list in this way is not thread-safe.
   // Using this list in any context where threads can call other functions
@@ -222,11 +390,13 @@ list_t* fixed_queue_get_list(fixed_queue_t* queue) {
 
 int fixed_queue_get_dequeue_fd(const fixed_queue_t* queue) {
   CHECK(queue != NULL);
+  if (queue->ring) return queue->ring->dequeue_fd;
   return semaphore_get_fd(queue->dequeue_sem);
 }
 
 int fixed_queue_get_enqueue_fd(const fixed_queue_t* queue) {
   CHECK(queue != NULL);
+  CHECK(queue->ring == NULL);
   return semaphore_get_fd(queue->enqueue_sem);
 }
 
@@ -259,5 +429,17 @@ static void internal_dequeue_ready(void* context) {
   CHECK(context != NULL);
 
   fixed_queue_t* queue = static_cast<fixed_queue_t*>(context);
+  spsc_ring_t* ring = queue->ring;
+  if (ring && spsc_is_empty(ring)) {
+    // Drained: clear the fd and only have it signaled by the next enqueue.
+    // The callback is not run here, it may free the queue.
+    eventfd_t value;
+    eventfd_read(ring->dequeue_fd, &value);
+    ring->consumer_waiting.store(true, std::memory_order_seq_cst);
+    if (!spsc_is_empty(ring))
+      spsc_wake(ring->consumer_waiting, ring->dequeue_fd);
+    return;
+  }
+
   queue->dequeue_ready(queue, queue->dequeue_context);
 }
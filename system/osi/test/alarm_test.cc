@@ -176,6 +176,27 @@ TEST_F(AlarmTest, test_set_long) {
   alarm_free(alarm);
 }
 
+TEST_F(AlarmTest, test_set_slack) {
+  alarm_t* alarm = alarm_new_periodic("alarm_test.test_set_slack");
+
+  alarm_set_slack(alarm, 300);
+  alarm_set(alarm, 100, cb, NULL);
+
+  // The deadline may move up to 255 ms later, onto a multiple of 256 ms
+  uint64_t remaining_ms = alarm_get_remaining_ms(alarm);
+  EXPECT_GT(remaining_ms, 100 - EPSILON_MS);
+  EXPECT_LE(remaining_ms, 100u + 255);
+
+  semaphore_wait(semaphore);
+  semaphore_wait(semaphore);
+  EXPECT_EQ(cb_counter, 2);
+
+  alarm_cancel(alarm);
+  alarm_free(alarm);
+
+  EXPECT_FALSE(WakeLockHeld());
+}
+
 TEST_F(AlarmTest, test_set_short_short) {
   alarm_t* alarm[2] = {alarm_new("alarm_test.test_set_short_short_0"),
                        alarm_new("alarm_test.test_set_short_short_1")};
@@ -296,6 +317,62 @@ TEST_F(AlarmTest, test_callback_ordering) {
   EXPECT_FALSE(WakeLockHeld());
 }
 
+// Test whether alarms set in reverse order and filed at different levels of
+// the timer wheel are invoked in deadline order
+TEST_F(AlarmTest, test_callback_ordering_across_wheel_levels) {
+  alarm_t* alarms[50];
+
+  for (int i = 0; i < 50; i++) {
+    const std::string alarm_name =
+        "alarm_test.test_callback_ordering_across_wheel_levels[" +
+        std::to_string(i) + "]";
+    alarms[i] = alarm_new(alarm_name.c_str());
+  }
+
+  for (int i = 49; i >= 0; i--) {
+    alarm_set(alarms[i], 10 + 20 * i, ordered_cb, INT_TO_PTR(i));
+  }
+
+  for (int i = 1; i <= 50; i++) {
+    semaphore_wait(semaphore);
+    EXPECT_GE(cb_counter, i);
+  }
+  EXPECT_EQ(cb_counter, 50);
+  EXPECT_EQ(cb_misordered_counter, 0);
+
+  for (int i = 0; i < 50; i++) alarm_free(alarms[i]);
+
+  EXPECT_FALSE(WakeLockHeld());
+}
+
+TEST_F(AlarmTest, test_cancel_far_future) {
+  const uint64_t hour_ms = 60 * 60 * 1000;
+  const uint64_t month_ms = 30 * 24 * hour_ms;
+  alarm_t* alarm[3] = {alarm_new("alarm_test.test_cancel_far_future_0"),
+                       alarm_new("alarm_test.test_cancel_far_future_1"),
+                       alarm_new("alarm_test.test_cancel_far_future_2")};
+
+  alarm_set(alarm[0], hour_ms, cb, NULL);
+  alarm_set(alarm[1], month_ms, cb, NULL);
+  alarm_set(alarm[2], 10, cb, NULL);
+
+  EXPECT_GT(alarm_get_remaining_ms(alarm[0]), hour_ms - EPSILON_MS);
+  EXPECT_GT(alarm_get_remaining_ms(alarm[1]), month_ms - EPSILON_MS);
+
+  alarm_cancel(alarm[1]);
+  EXPECT_FALSE(alarm_is_scheduled(alarm[1]));
+  EXPECT_TRUE(alarm_is_scheduled(alarm[0]));
+
+  semaphore_wait(semaphore);
+  EXPECT_EQ(cb_counter, 1);
+
+  alarm_cancel(alarm[0]);
+  EXPECT_FALSE(alarm_is_scheduled(alarm[0]));
+  EXPECT_FALSE(WakeLockHeld());
+
+  for (int i = 0; i < 3; i++) alarm_free(alarm[i]);
+}
+
 // Test whether the callbacks are involed in the expected order on a
 // message loop.
 TEST_F(AlarmTest, test_callback_ordering_on_mloop) {
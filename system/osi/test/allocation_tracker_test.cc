@@ -17,8 +17,11 @@
  ******************************************************************************/
 
 #include <gtest/gtest.h>
+#include <string.h>
+#include <unistd.h>
 
 #include "osi/include/allocation_tracker.h"
+#include "osi/include/allocator.h"
 
 void allocation_tracker_uninit(void);
 
@@ -62,3 +65,49 @@ TEST(AllocationTrackerTest, test_canaries_on) {
 
   free(dummy_allocation);
 }
+
+TEST(AllocationTrackerTest, test_sampling) {
+  static const size_t interval = 4;
+  allocation_tracker_uninit();
+  allocation_tracker_init_sampling(interval);
+
+  // No canaries in sampling mode
+  EXPECT_EQ(4U, allocation_tracker_resize_for_canary(4));
+
+  void* allocations[100];
+  for (auto& allocation : allocations) {
+    void* ptr = malloc(4);
+    allocation = allocation_tracker_notify_alloc_from(allocator_id, ptr, 4,
+                                                      &allocations);
+    EXPECT_EQ(ptr, allocation);
+  }
+
+  char buf[4096] = {};
+  int fds[2];
+  ASSERT_EQ(0, pipe(fds));
+  osi_allocator_debug_dump(fds[1]);
+  close(fds[1]);
+  ASSERT_GT(read(fds[0], buf, sizeof(buf) - 1), 0);
+  close(fds[0]);
+  EXPECT_NE(nullptr, strstr(buf, "Sampling 1 in 4 allocations"));
+  EXPECT_EQ(nullptr, strstr(buf, "live counts : 0 /"));
+
+  for (auto& allocation : allocations) {
+    EXPECT_EQ(allocation,
+              allocation_tracker_notify_free(allocator_id, allocation));
+    free(allocation);
+  }
+
+  allocation_tracker_uninit();
+}
+
+TEST(AllocationTrackerTest, test_sampling_ignored_when_tracking) {
+  allocation_tracker_uninit();
+  allocation_tracker_init();
+  allocation_tracker_init_sampling(4);
+
+  // Full tracking stays on
+  EXPECT_TRUE(allocation_tracker_resize_for_canary(4) > 4);
+
+  allocation_tracker_uninit();
+}
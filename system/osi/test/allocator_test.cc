@@ -50,3 +50,33 @@ TEST_F(AllocatorTest, test_osi_strndup) {
   EXPECT_EQ(0, strcmp(str, copy_str));
   osi_free(copy_str);
 }
+
+TEST_F(AllocatorTest, test_osi_calloc_reused_buffer_is_zeroed) {
+  // Sizes below, at and above the pooled buffer sizes
+  const size_t sizes[] = {1, 128, 660, 1021, 1691, 4112, 4113, 10000};
+  for (size_t size : sizes) {
+    uint8_t* buf = static_cast<uint8_t*>(osi_malloc(size));
+    memset(buf, 0xa5, size);
+    osi_free(buf);
+
+    buf = static_cast<uint8_t*>(osi_calloc(size));
+    for (size_t i = 0; i < size; i++) {
+      ASSERT_EQ(0, buf[i]) << "size " << size << " offset " << i;
+    }
+    osi_free(buf);
+  }
+}
+
+TEST_F(AllocatorTest, test_osi_malloc_many_buffers) {
+  // More buffers than the per thread cache holds, freed in both orders
+  void* bufs[100];
+  for (size_t size : {128, 2000, 4112}) {
+    for (auto& buf : bufs) {
+      buf = osi_malloc(size);
+      memset(buf, 0, size);
+    }
+    for (auto& buf : bufs) osi_free(buf);
+    for (auto& buf : bufs) buf = osi_malloc(size);
+    for (size_t i = 0; i < 100; i++) osi_free(bufs[99 - i]);
+  }
+}
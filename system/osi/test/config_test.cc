@@ -134,6 +134,70 @@ TEST_F(ConfigTest, section_set) {
   EXPECT_EQ(entry_iter->value, "bar");
 }
 
+TEST_F(ConfigTest, section_erase) {
+  section_t section("section");
+  section.Set("a", "1");
+  section.Set("b", "2");
+  section.Set("c", "3");
+  auto next = section.Erase(section.Find("b"));
+  EXPECT_EQ(next->key, "c");
+  EXPECT_FALSE(section.Has("b"));
+  EXPECT_EQ(section.Find("b"), section.entries.end());
+  section.Set("b", "4");
+  // Keys are kept in insertion order
+  std::string keys;
+  for (const entry_t& entry : section.entries) keys += entry.key;
+  EXPECT_EQ(keys, "acb");
+  EXPECT_EQ(section.Find("b")->value, "4");
+}
+
+TEST_F(ConfigTest, config_copy_and_move) {
+  std::unique_ptr<config_t> config = config_new(CONFIG_FILE);
+  ASSERT_NE(config, nullptr);
+  config_t copy = *config;
+  config_set_string(&copy, "DID", "version", "0x1111");
+  config_remove_key(&copy, "DID", "HiSyncId");
+  EXPECT_EQ(*config_get_string(*config, "DID", "version", nullptr), "0x1436");
+  EXPECT_EQ(*config_get_string(copy, "DID", "version", nullptr), "0x1111");
+  EXPECT_TRUE(config_has_key(*config, "DID", "HiSyncId"));
+  EXPECT_FALSE(config_has_key(copy, "DID", "HiSyncId"));
+  // The copy is indexed on its own sections and entries
+  EXPECT_EQ(&*copy.Find("DID"), &copy.sections.back());
+  EXPECT_NE(&*copy.Find("DID")->Find("recordNumber"),
+            &*config->Find("DID")->Find("recordNumber"));
+  EXPECT_EQ(&*copy.Find("DID")->Find("recordNumber"),
+            &copy.sections.back().entries.front());
+
+  config_t moved = std::move(copy);
+  EXPECT_EQ(*config_get_string(moved, "DID", "version", nullptr), "0x1111");
+  config_set_string(&moved, "DID", "version", "0x2222");
+  EXPECT_EQ(*config_get_string(moved, "DID", "version", nullptr), "0x2222");
+  EXPECT_FALSE(config_has_key(moved, "DID", "HiSyncId"));
+}
+
+TEST_F(ConfigTest, config_append_and_extract) {
+  config_t config;
+  section_t section("A");
+  section.Set("key", "1");
+  config.Append(section);
+  config.Append(section_t("B"));
+  // Replaced in place
+  section.Set("key", "2");
+  auto it = config.Append(std::move(section));
+  EXPECT_EQ(it, config.sections.begin());
+  EXPECT_EQ(config.sections.size(), 2u);
+  EXPECT_EQ(*config_get_string(config, "A", "key", nullptr), "2");
+
+  section_t extracted = config.Extract(config.Find("A"));
+  EXPECT_EQ(extracted.name, "A");
+  EXPECT_TRUE(extracted.Has("key"));
+  EXPECT_FALSE(config.Has("A"));
+  EXPECT_TRUE(config.Has("B"));
+  config.Clear();
+  EXPECT_FALSE(config.Has("B"));
+  EXPECT_TRUE(config.sections.empty());
+}
+
 TEST_F(ConfigTest, config_new_empty) {
   std::unique_ptr<config_t> config = config_new_empty();
   EXPECT_TRUE(config.get() != NULL);
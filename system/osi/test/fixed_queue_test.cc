@@ -348,3 +348,86 @@ TEST_F(FixedQueueTest, test_fixed_queue_register_dequeue) {
   thread_free(worker_thread);
   fixed_queue_free(queue, NULL);
 }
+
+TEST_F(FixedQueueTest, test_fixed_queue_spsc_enqueue_dequeue) {
+  fixed_queue_t* queue = fixed_queue_new_spsc(TEST_QUEUE_SIZE);
+  ASSERT_TRUE(queue != NULL);
+  EXPECT_EQ(TEST_QUEUE_SIZE, fixed_queue_capacity(queue));
+  EXPECT_TRUE(fixed_queue_is_empty(queue));
+  EXPECT_EQ(NULL, fixed_queue_try_dequeue(queue));
+  EXPECT_EQ(NULL, fixed_queue_try_peek_first(queue));
+
+  // Fill the queue, wrapping around the ring twice
+  uintptr_t next_in = 1, next_out = 1;
+  for (int round = 0; round < 3; round++) {
+    while (fixed_queue_try_enqueue(queue, (void*)next_in)) next_in++;
+    EXPECT_EQ(TEST_QUEUE_SIZE, fixed_queue_length(queue));
+    EXPECT_EQ((void*)next_out, fixed_queue_try_peek_first(queue));
+    EXPECT_EQ((void*)(next_in - 1), fixed_queue_try_peek_last(queue));
+
+    for (size_t i = 0; i < TEST_QUEUE_SIZE / 2; i++) {
+      EXPECT_EQ((void*)next_out++, fixed_queue_dequeue(queue));
+    }
+  }
+  EXPECT_EQ(TEST_QUEUE_SIZE / 2, fixed_queue_length(queue));
+
+  test_queue_entry_free_counter = 0;
+  fixed_queue_free(queue, test_queue_entry_free_cb);
+  EXPECT_EQ(TEST_QUEUE_SIZE / 2, (size_t)test_queue_entry_free_counter);
+}
+
+static void spsc_blocking_producer(void* context) {
+  fixed_queue_t* queue = static_cast<fixed_queue_t*>(context);
+  for (uintptr_t i = 1; i <= 1000; i++) fixed_queue_enqueue(queue, (void*)i);
+}
+
+TEST_F(FixedQueueTest, test_fixed_queue_spsc_blocking) {
+  // Small queue so both sides have to wait for each other
+  fixed_queue_t* queue = fixed_queue_new_spsc(4);
+  ASSERT_TRUE(queue != NULL);
+
+  thread_t* producer_thread = thread_new("test_fixed_queue_spsc_producer");
+  ASSERT_TRUE(producer_thread != NULL);
+  thread_post(producer_thread, spsc_blocking_producer, queue);
+
+  for (uintptr_t i = 1; i <= 1000; i++) {
+    EXPECT_EQ((void*)i, fixed_queue_dequeue(queue));
+  }
+
+  thread_free(producer_thread);
+  EXPECT_TRUE(fixed_queue_is_empty(queue));
+  fixed_queue_free(queue, NULL);
+}
+
+static uintptr_t spsc_next_expected = 0;
+
+static void fixed_queue_spsc_ready(fixed_queue_t* queue,
+                                   UNUSED_ATTR void* context) {
+  uintptr_t msg = (uintptr_t)fixed_queue_dequeue(queue);
+  EXPECT_EQ(spsc_next_expected++, msg);
+  if (msg == 1000) future_ready(received_message_future, (void*)msg);
+}
+
+TEST_F(FixedQueueTest, test_fixed_queue_spsc_register_dequeue) {
+  fixed_queue_t* queue = fixed_queue_new_spsc(TEST_QUEUE_SIZE);
+  ASSERT_TRUE(queue != NULL);
+
+  received_message_future = future_new();
+  ASSERT_TRUE(received_message_future != NULL);
+  spsc_next_expected = 1;
+
+  thread_t* worker_thread = thread_new("test_fixed_queue_worker_thread");
+  ASSERT_TRUE(worker_thread != NULL);
+
+  fixed_queue_register_dequeue(queue, thread_get_reactor(worker_thread),
+                               fixed_queue_spsc_ready, NULL);
+
+  // The consumer goes idle and is woken up again as the producer runs ahead
+  for (uintptr_t i = 1; i <= 1000; i++) fixed_queue_enqueue(queue, (void*)i);
+  EXPECT_EQ((void*)1000, future_await(received_message_future));
+
+  fixed_queue_unregister_dequeue(queue);
+  thread_free(worker_thread);
+  EXPECT_TRUE(fixed_queue_is_empty(queue));
+  fixed_queue_free(queue, NULL);
+}
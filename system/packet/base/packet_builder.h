@@ -17,6 +17,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 namespace bluetooth {
 
@@ -51,6 +52,10 @@ class PacketBuilder {
     return AddPayloadOctets(pkt, 8, value);
   }
 
+  // Add bytes that are already encoded, in order
+  bool AddPayloadBytes(const std::shared_ptr<Packet>& pkt,
+                       const std::vector<uint8_t>& bytes);
+
  private:
   // Add |octets| bytes to the payload.  Return true if:
   // - the value of |value| fits in |octets| bytes and
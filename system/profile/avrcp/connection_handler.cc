@@ -259,6 +259,7 @@ void ConnectionHandler::InitiatorControlCb(uint8_t handle, uint8_t event,
       std::shared_ptr<Device> newDevice = std::make_shared<Device>(
           *peer_addr, !supports_browsing, callback, ctrl_mtu, browse_mtu);
 
+      newDevice->SetMetadataCache(metadata_cache_);
       device_map_[handle] = newDevice;
       // TODO (apanicke): Create the device with all of the interfaces it
       // needs. Return the new device where the service will register the
@@ -330,6 +331,7 @@ void ConnectionHandler::AcceptorControlCb(uint8_t handle, uint8_t event,
       std::shared_ptr<Device> newDevice = std::make_shared<Device>(
           *peer_addr, false, callback, ctrl_mtu, browse_mtu);
 
+      newDevice->SetMetadataCache(metadata_cache_);
       device_map_[handle] = newDevice;
       connection_cb_.Run(newDevice);
 
@@ -135,6 +135,9 @@ class ConnectionHandler {
   ConnectionCallback connection_cb_;
 
   std::map<uint8_t, std::shared_ptr<Device>> device_map_;
+  // Encoded metadata responses, shared by the devices
+  std::shared_ptr<MetadataCache> metadata_cache_ =
+      std::make_shared<MetadataCache>();
   // TODO (apanicke): Replace the features with a class that has individual
   // fields.
   std::map<RawAddress, uint16_t> feature_map_;
@@ -49,7 +49,8 @@ Device::Device(
       send_message_cb_(send_msg_cb),
       ctrl_mtu_(ctrl_mtu),
       browse_mtu_(browse_mtu),
-      has_bip_client_(false) {}
+      has_bip_client_(false),
+      metadata_cache_(std::make_shared<MetadataCache>()) {}
 
 void Device::RegisterInterfaces(MediaInterface* media_interface,
                                 A2dpInterface* a2dp_interface,
@@ -61,6 +62,11 @@ void Device::RegisterInterfaces(MediaInterface* media_interface,
   volume_interface_ = volume_interface;
 }
 
+void Device::SetMetadataCache(std::shared_ptr<MetadataCache> metadata_cache) {
+  CHECK(metadata_cache);
+  metadata_cache_ = std::move(metadata_cache);
+}
+
 base::WeakPtr<Device> Device::Get() {
   return weak_ptr_factory_.GetWeakPtr();
 }
@@ -174,6 +180,18 @@ void Device::VendorPacketHandler(uint8_t label,
         send_message(label, false, std::move(response));
         return;
       }
+
+      // Another request, or another device, may have had these attributes of
+      // the track already
+      auto encoded = metadata_cache_->Find(
+          ElementAttributesKey(*get_element_attributes_request_pkt));
+      if (encoded != nullptr) {
+        DEVICE_VLOG(3) << __func__ << ": Using the encoded element attributes";
+        last_song_info_ = metadata_cache_->GetSongInfo();
+        send_message(label, false,
+                     std::make_unique<EncodedResponseBuilder>(encoded));
+        return;
+      }
       media_interface_->GetSongInfo(base::Bind(&Device::GetElementAttributesResponse, weak_ptr_factory_.GetWeakPtr(),
                                                label, get_element_attributes_request_pkt));
     } break;
@@ -482,6 +500,8 @@ void Device::TrackChangedNotificationResponse(uint8_t label, bool interim,
       uid = now_playing_ids_.get_uid(curr_song_id);
     }
   }
+  // Keep the list the UIDs were given for
+  now_playing_listing_ = std::move(song_list);
 
   if (uid == 0) {
     // uid 0 is not valid here when browsing is supported
@@ -645,8 +665,6 @@ void Device::GetElementAttributesResponse(
     filter_cover_art(info);
   }
 
-  last_song_info_ = info;
-
   if (attributes_requested.size() != 0) {
     for (const auto& attribute : attributes_requested) {
       if (info.attributes.find(attribute) != info.attributes.end()) {
@@ -659,7 +677,10 @@ void Device::GetElementAttributesResponse(
     }
   }
 
-  send_message(label, false, std::move(response));
+  auto encoded = metadata_cache_->Insert(
+      ElementAttributesKey(*get_element_attributes_pkt), info, *response);
+  last_song_info_ = std::move(info);
+  send_message(label, false, std::make_unique<EncodedResponseBuilder>(encoded));
 }
 
 void Device::MessageReceived(uint8_t label, std::shared_ptr<Packet> pkt) {
@@ -851,12 +872,23 @@ void Device::HandleGetFolderItems(uint8_t label,
                      weak_ptr_factory_.GetWeakPtr(), label, pkt));
       break;
     case Scope::VFS:
+      if (const FolderListing* listing = CurrentFolderListing()) {
+        DEVICE_VLOG(3) << __func__ << ": Using the cached folder listing";
+        SendVFSList(label, *pkt, *listing);
+        break;
+      }
       media_interface_->GetFolderItems(
           curr_browsed_player_id_, CurrentFolder(),
           base::Bind(&Device::GetVFSListResponse,
-                     weak_ptr_factory_.GetWeakPtr(), label, pkt));
+                     weak_ptr_factory_.GetWeakPtr(), label, pkt,
+                     curr_browsed_player_id_, CurrentFolder()));
       break;
     case Scope::NOW_PLAYING:
+      if (now_playing_listing_) {
+        DEVICE_VLOG(3) << __func__ << ": Using the cached now playing list";
+        SendNowPlayingList(label, *pkt, *now_playing_listing_);
+        break;
+      }
       media_interface_->GetNowPlayingList(
           base::Bind(&Device::GetNowPlayingListResponse,
                      weak_ptr_factory_.GetWeakPtr(), label, pkt));
@@ -888,12 +920,25 @@ void Device::HandleGetTotalNumberOfItems(
       break;
     }
     case Scope::VFS:
+      if (const FolderListing* listing = CurrentFolderListing()) {
+        auto builder = GetTotalNumberOfItemsResponseBuilder::MakeBuilder(
+            Status::NO_ERROR, 0x0000, listing->items.size());
+        send_message(label, true, std::move(builder));
+        break;
+      }
       media_interface_->GetFolderItems(
           curr_browsed_player_id_, CurrentFolder(),
           base::Bind(&Device::GetTotalNumberOfItemsVFSResponse,
-                     weak_ptr_factory_.GetWeakPtr(), label));
+                     weak_ptr_factory_.GetWeakPtr(), label,
+                     curr_browsed_player_id_, CurrentFolder()));
       break;
     case Scope::NOW_PLAYING:
+      if (now_playing_listing_) {
+        auto builder = GetTotalNumberOfItemsResponseBuilder::MakeBuilder(
+            Status::NO_ERROR, 0x0000, now_playing_listing_->size());
+        send_message(label, true, std::move(builder));
+        break;
+      }
       media_interface_->GetNowPlayingList(
           base::Bind(&Device::GetTotalNumberOfItemsNowPlayingResponse,
                      weak_ptr_factory_.GetWeakPtr(), label));
@@ -913,13 +958,18 @@ void Device::GetTotalNumberOfItemsMediaPlayersResponse(
   send_message(label, true, std::move(builder));
 }
 
-void Device::GetTotalNumberOfItemsVFSResponse(uint8_t label,
+void Device::GetTotalNumberOfItemsVFSResponse(uint8_t label, int player_id,
+                                              std::string folder,
                                               std::vector<ListItem> list) {
   DEVICE_VLOG(2) << __func__ << ": num_items=" << list.size();
 
   auto builder = GetTotalNumberOfItemsResponseBuilder::MakeBuilder(
       Status::NO_ERROR, 0x0000, list.size());
   send_message(label, true, std::move(builder));
+
+  // The items are usually requested next
+  CacheFolderListing(
+      MakeFolderListing(player_id, std::move(folder), std::move(list)));
 }
 
 void Device::GetTotalNumberOfItemsNowPlayingResponse(
@@ -972,20 +1022,24 @@ void Device::HandleChangePath(uint8_t label,
                    << "\"";
   }
 
+  // The new folder is always listed again, its listing replaces the cached
+  // one.
   media_interface_->GetFolderItems(
       curr_browsed_player_id_, CurrentFolder(),
       base::Bind(&Device::ChangePathResponse, weak_ptr_factory_.GetWeakPtr(),
-                 label, pkt));
+                 label, pkt, curr_browsed_player_id_, CurrentFolder()));
 }
 
 void Device::ChangePathResponse(uint8_t label,
                                 std::shared_ptr<ChangePathRequest> pkt,
+                                int player_id, std::string folder,
                                 std::vector<ListItem> list) {
-  // TODO (apanicke): Reconstruct the VFS ID's here. Right now it gets
-  // reconstructed in GetFolderItemsVFS
   auto builder =
       ChangePathResponseBuilder::MakeBuilder(Status::NO_ERROR, list.size());
   send_message(label, true, std::move(builder));
+
+  CacheFolderListing(
+      MakeFolderListing(player_id, std::move(folder), std::move(list)));
 }
 
 void Device::HandleGetItemAttributes(
@@ -1195,38 +1249,80 @@ std::set<AttributeEntry> filter_attributes_requested(
   return result;
 }
 
+Device::FolderListing Device::MakeFolderListing(int player_id,
+                                                std::string folder,
+                                                std::vector<ListItem> items) {
+  FolderListing listing = {player_id, std::move(folder), std::move(items), {}};
+
+  // Map the items to UIDs once for the whole folder, the ranges requested
+  // afterwards only read them. These items do not need to correspond with the
+  // now playing list as the UID's only need to be unique in the context of the
+  // current scope and the current folder
+  vfs_ids_.reserve(vfs_ids_.size() + listing.items.size());
+  listing.uids.reserve(listing.items.size());
+  for (const auto& item : listing.items) {
+    uint64_t uid = 0;
+    if (item.type == ListItem::FOLDER) {
+      uid = vfs_ids_.insert(item.folder.media_id);
+    } else if (item.type == ListItem::SONG) {
+      uid = vfs_ids_.insert(item.song.media_id);
+    }
+    listing.uids.push_back(uid);
+  }
+
+  return listing;
+}
+
+void Device::CacheFolderListing(FolderListing listing) {
+  // The player or the folder may have changed while it was listed
+  if (listing.player_id != curr_browsed_player_id_ ||
+      listing.folder != CurrentFolder()) {
+    return;
+  }
+  folder_listing_ = std::move(listing);
+}
+
+const Device::FolderListing* Device::CurrentFolderListing() const {
+  if (!folder_listing_ ||
+      folder_listing_->player_id != curr_browsed_player_id_ ||
+      folder_listing_->folder != CurrentFolder()) {
+    return nullptr;
+  }
+  return &folder_listing_.value();
+}
+
+void Device::InvalidateBrowseCache() {
+  folder_listing_.reset();
+  now_playing_listing_.reset();
+}
+
 void Device::GetVFSListResponse(uint8_t label,
                                 std::shared_ptr<GetFolderItemsRequest> pkt,
+                                int player_id, std::string folder,
                                 std::vector<ListItem> items) {
-  DEVICE_VLOG(2) << __func__ << ": start_item=" << pkt->GetStartItem()
-                 << " end_item=" << pkt->GetEndItem();
+  auto listing =
+      MakeFolderListing(player_id, std::move(folder), std::move(items));
+  SendVFSList(label, *pkt, listing);
+  CacheFolderListing(std::move(listing));
+}
+
+void Device::SendVFSList(uint8_t label, const GetFolderItemsRequest& pkt,
+                         const FolderListing& listing) {
+  DEVICE_VLOG(2) << __func__ << ": start_item=" << pkt.GetStartItem()
+                 << " end_item=" << pkt.GetEndItem();
 
   // The builder will automatically correct the status if there are zero items
   auto builder = GetFolderItemsResponseBuilder::MakeVFSBuilder(
       Status::NO_ERROR, 0x0000, browse_mtu_);
 
-  // TODO (apanicke): Add test that checks if vfs_ids_ is the correct size after
-  // an operation.
-  for (const auto& item : items) {
-    if (item.type == ListItem::FOLDER) {
-      vfs_ids_.insert(item.folder.media_id);
-    } else if (item.type == ListItem::SONG) {
-      vfs_ids_.insert(item.song.media_id);
-    }
-  }
-
-  // Add the elements retrieved in the last get folder items request and map
-  // them to UIDs The maps will be cleared every time a directory change
-  // happens. These items do not need to correspond with the now playing list as
-  // the UID's only need to be unique in the context of the current scope and
-  // the current folder
-  for (auto i = pkt->GetStartItem(); i <= pkt->GetEndItem() && i < items.size();
+  const auto& items = listing.items;
+  for (auto i = pkt.GetStartItem(); i <= pkt.GetEndItem() && i < items.size();
        i++) {
     if (items[i].type == ListItem::FOLDER) {
-      auto folder = items[i].folder;
+      const auto& folder = items[i].folder;
       // right now we always use folders of mixed type
-      FolderItem folder_item(vfs_ids_.get_uid(folder.media_id), 0x00,
-                             folder.is_playable, folder.name);
+      FolderItem folder_item(listing.uids[i], 0x00, folder.is_playable,
+                             folder.name);
       if (!builder->AddFolder(folder_item)) break;
     } else if (items[i].type == ListItem::SONG) {
       auto song = items[i].song;
@@ -1240,14 +1336,14 @@ void Device::GetVFSListResponse(uint8_t label,
           song.attributes.find(Attribute::TITLE) != song.attributes.end()
               ? song.attributes.find(Attribute::TITLE)->value()
               : "No Song Info";
-      MediaElementItem song_item(vfs_ids_.get_uid(song.media_id), title,
+      MediaElementItem song_item(listing.uids[i], title,
                                  std::set<AttributeEntry>());
 
-      if (pkt->GetNumAttributes() == 0x00) {  // All attributes requested
+      if (pkt.GetNumAttributes() == 0x00) {  // All attributes requested
         song_item.attributes_ = std::move(song.attributes);
       } else {
         song_item.attributes_ =
-            filter_attributes_requested(song, pkt->GetAttributesRequested());
+            filter_attributes_requested(song, pkt.GetAttributesRequested());
       }
 
       // If we fail to add a song, don't accidentally add one later that might
@@ -1263,16 +1359,24 @@ void Device::GetNowPlayingListResponse(
     uint8_t label, std::shared_ptr<GetFolderItemsRequest> pkt,
     std::string /* unused curr_song_id */, std::vector<SongInfo> song_list) {
   DEVICE_VLOG(2) << __func__;
-  auto builder = GetFolderItemsResponseBuilder::MakeNowPlayingBuilder(
-      Status::NO_ERROR, 0x0000, browse_mtu_);
 
   now_playing_ids_.clear();
+  now_playing_ids_.reserve(song_list.size());
   for (const SongInfo& song : song_list) {
     now_playing_ids_.insert(song.media_id);
   }
 
-  for (size_t i = pkt->GetStartItem();
-       i <= pkt->GetEndItem() && i < song_list.size(); i++) {
+  SendNowPlayingList(label, *pkt, song_list);
+  now_playing_listing_ = std::move(song_list);
+}
+
+void Device::SendNowPlayingList(uint8_t label, const GetFolderItemsRequest& pkt,
+                                const std::vector<SongInfo>& song_list) {
+  auto builder = GetFolderItemsResponseBuilder::MakeNowPlayingBuilder(
+      Status::NO_ERROR, 0x0000, browse_mtu_);
+
+  for (size_t i = pkt.GetStartItem();
+       i <= pkt.GetEndItem() && i < song_list.size(); i++) {
     auto song = song_list[i];
 
     // Filter out DEFAULT_COVER_ART handle if this device has no client
@@ -1285,11 +1389,11 @@ void Device::GetNowPlayingListResponse(
                      : "No Song Info";
 
     MediaElementItem item(i + 1, title, std::set<AttributeEntry>());
-    if (pkt->GetNumAttributes() == 0x00) {
+    if (pkt.GetNumAttributes() == 0x00) {
       item.attributes_ = std::move(song.attributes);
     } else {
       item.attributes_ =
-          filter_attributes_requested(song, pkt->GetAttributesRequested());
+          filter_attributes_requested(song, pkt.GetAttributesRequested());
     }
 
     // If we fail to add a song, don't accidentally add one later that might
@@ -1338,6 +1442,7 @@ void Device::SetBrowsedPlayerResponse(
   }
 
   curr_browsed_player_id_ = pkt->GetPlayerId();
+  folder_listing_.reset();
 
   // Clear the path and push the new root.
   current_path_ = std::stack<std::string>();
@@ -1356,7 +1461,10 @@ void Device::SendMediaUpdate(bool metadata, bool play_status, bool queue) {
                  << " : play_status= " << play_status << " : queue=" << queue
                  << " ; is_silence=" << is_silence;
 
+  if (metadata) metadata_cache_->Invalidate();
+
   if (queue) {
+    now_playing_listing_.reset();
     HandleNowPlayingUpdate();
   }
 
@@ -1375,11 +1483,17 @@ void Device::SendFolderUpdate(bool available_players, bool addressed_player,
   CHECK(media_interface_);
   DEVICE_VLOG(4) << __func__;
 
+  // The cached listings may no longer match what the player would list
+  if (uids) {
+    InvalidateBrowseCache();
+  }
+
   if (available_players) {
     HandleAvailablePlayerUpdate();
   }
 
   if (addressed_player) {
+    now_playing_listing_.reset();
     HandleAddressedPlayerUpdate();
   }
 }
@@ -1432,9 +1546,11 @@ void Device::HandleNowPlayingNotificationResponse(
   }
 
   now_playing_ids_.clear();
+  now_playing_ids_.reserve(song_list.size());
   for (const SongInfo& song : song_list) {
     now_playing_ids_.insert(song.media_id);
   }
+  now_playing_listing_ = std::move(song_list);
 
   auto response =
       RegisterNotificationResponseBuilder::MakeNowPlayingBuilder(interim);
@@ -1492,6 +1608,7 @@ void Device::HandleAddressedPlayerUpdate() {
 void Device::DeviceDisconnected() {
   DEVICE_LOG(INFO) << "Device was disconnected";
   play_pos_update_cb_.Cancel();
+  InvalidateBrowseCache();
 
   // TODO (apanicke): Once the interfaces are set in the Device construction,
   // remove these conditionals.
@@ -18,7 +18,9 @@
 
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <stack>
+#include <vector>
 
 #include <base/bind.h>
 #include <base/cancelable_callback.h>
@@ -39,6 +41,7 @@
 #include "packet/avrcp/set_browsed_player.h"
 #include "packet/avrcp/vendor_packet.h"
 #include "profile/avrcp/media_id_map.h"
+#include "profile/avrcp/metadata_cache.h"
 #include "raw_address.h"
 
 namespace bluetooth {
@@ -115,6 +118,12 @@ class Device {
                           A2dpInterface* a2dp_interface,
                           VolumeInterface* volume_interface);
 
+  /**
+   * Share the encoded metadata responses with the other connected devices.
+   * Until this is called the device keeps its own.
+   */
+  void SetMetadataCache(std::shared_ptr<MetadataCache> metadata_cache);
+
   /**
    * Set the maximum size of a AVRCP Browsing Packet. This is done after the
    * connection of the Browsing channel.
@@ -210,6 +219,7 @@ class Device {
       uint16_t curr_player, std::vector<MediaPlayerInfo> players);
   virtual void GetVFSListResponse(uint8_t label,
                                   std::shared_ptr<GetFolderItemsRequest> pkt,
+                                  int player_id, std::string folder,
                                   std::vector<ListItem> items);
   virtual void GetNowPlayingListResponse(
       uint8_t label, std::shared_ptr<GetFolderItemsRequest> pkt,
@@ -220,7 +230,8 @@ class Device {
       uint8_t label, std::shared_ptr<GetTotalNumberOfItemsRequest> pkt);
   virtual void GetTotalNumberOfItemsMediaPlayersResponse(
       uint8_t label, uint16_t curr_player, std::vector<MediaPlayerInfo> list);
-  virtual void GetTotalNumberOfItemsVFSResponse(uint8_t label,
+  virtual void GetTotalNumberOfItemsVFSResponse(uint8_t label, int player_id,
+                                                std::string folder,
                                                 std::vector<ListItem> items);
   virtual void GetTotalNumberOfItemsNowPlayingResponse(
       uint8_t label, std::string curr_song_id, std::vector<SongInfo> song_list);
@@ -247,6 +258,7 @@ class Device {
                                 std::shared_ptr<ChangePathRequest> request);
   virtual void ChangePathResponse(uint8_t label,
                                   std::shared_ptr<ChangePathRequest> request,
+                                  int player_id, std::string folder,
                                   std::vector<ListItem> list);
 
   // PLAY ITEM
@@ -291,6 +303,30 @@ class Device {
     return current_path_.top();
   }
 
+  MetadataCache::Key ElementAttributesKey(
+      const GetElementAttributesRequest& pkt) const {
+    return {pkt.GetAttributesRequested(), ctrl_mtu_, HasBipClient()};
+  }
+
+  // A VFS folder as the media player listed it, with the UIDs of its items.
+  struct FolderListing {
+    int player_id;
+    std::string folder;
+    std::vector<ListItem> items;
+    std::vector<uint64_t> uids;
+  };
+
+  FolderListing MakeFolderListing(int player_id, std::string folder,
+                                  std::vector<ListItem> items);
+  // Keep the listing if it is still the one of the current folder
+  void CacheFolderListing(FolderListing listing);
+  const FolderListing* CurrentFolderListing() const;
+  void SendVFSList(uint8_t label, const GetFolderItemsRequest& pkt,
+                   const FolderListing& listing);
+  void SendNowPlayingList(uint8_t label, const GetFolderItemsRequest& pkt,
+                          const std::vector<SongInfo>& song_list);
+  void InvalidateBrowseCache();
+
   void send_message(uint8_t label, bool browse,
                     std::unique_ptr<::bluetooth::PacketBuilder> message) {
     active_labels_.erase(label);
@@ -328,9 +364,17 @@ class Device {
   MediaIdMap vfs_ids_;
   MediaIdMap now_playing_ids_;
 
+  // Listings of the current folder and of the now playing list. Browsing a
+  // large folder takes a GetFolderItems request for each range of items, all
+  // but the first are answered from these without asking the media player.
+  // They are dropped when the player reports its UIDs or queue changed.
+  std::optional<FolderListing> folder_listing_;
+  std::optional<std::vector<SongInfo>> now_playing_listing_;
+
   uint32_t play_pos_interval_ = 0;
 
   SongInfo last_song_info_;
+  std::shared_ptr<MetadataCache> metadata_cache_;
   PlayStatus last_play_status_;
 
   base::CancelableClosure play_pos_update_cb_;
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "metadata_cache.h"
+
+#include <base/logging.h>
+
+#include "avrcp_message_converter.h"
+
+namespace bluetooth {
+namespace avrcp {
+
+bool EncodedResponseBuilder::Serialize(
+    const std::shared_ptr<::bluetooth::Packet>& pkt) {
+  ReserveSpace(pkt, size());
+  return AddPayloadBytes(pkt, *bytes_);
+}
+
+MetadataCache::Encoded MetadataCache::Find(const Key& key) const {
+  auto it = responses_.find(key);
+  if (it == responses_.end()) return nullptr;
+  return it->second;
+}
+
+MetadataCache::Encoded MetadataCache::Insert(
+    const Key& key, const SongInfo& info,
+    ::bluetooth::PacketBuilder& response) {
+  if (info.media_id != song_info_.media_id ||
+      responses_.size() >= kMaxResponses) {
+    responses_.clear();
+  }
+  song_info_ = info;
+
+  auto packet = VectorPacket::Make();
+  response.Serialize(packet);
+  auto encoded =
+      std::make_shared<const std::vector<uint8_t>>(packet->GetData());
+  responses_[key] = encoded;
+  VLOG(3) << __func__ << ": media_id=\"" << info.media_id
+          << "\" responses=" << responses_.size();
+  return encoded;
+}
+
+void MetadataCache::Invalidate() {
+  song_info_ = SongInfo();
+  responses_.clear();
+}
+
+}  // namespace avrcp
+}  // namespace bluetooth
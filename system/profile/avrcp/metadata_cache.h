@@ -0,0 +1,89 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "hardware/avrcp/avrcp.h"
+#include "packet/base/packet_builder.h"
+
+namespace bluetooth {
+namespace avrcp {
+
+// Builder that sends again the bytes of a response encoded earlier.
+class EncodedResponseBuilder : public ::bluetooth::PacketBuilder {
+ public:
+  explicit EncodedResponseBuilder(
+      std::shared_ptr<const std::vector<uint8_t>> bytes)
+      : bytes_(std::move(bytes)) {}
+
+  virtual size_t size() const override { return bytes_->size(); }
+  virtual bool Serialize(
+      const std::shared_ptr<::bluetooth::Packet>& pkt) override;
+
+ private:
+  std::shared_ptr<const std::vector<uint8_t>> bytes_;
+};
+
+// The GetElementAttributes responses encoded for the current track, shared by
+// all the connected devices. Controllers ask for the metadata of a track
+// several times, and with a car and a watch connected the same attributes are
+// asked for by both. The responses are kept encoded as they were sent, for
+// each set of attributes and MTU, until the track or its metadata changes.
+class MetadataCache {
+ public:
+  using Encoded = std::shared_ptr<const std::vector<uint8_t>>;
+
+  struct Key {
+    // Empty when all attributes are requested
+    std::vector<Attribute> attributes;
+    size_t mtu;
+    bool cover_art;
+
+    bool operator<(const Key& other) const {
+      return std::tie(attributes, mtu, cover_art) <
+             std::tie(other.attributes, other.mtu, other.cover_art);
+    }
+  };
+
+  // Returns the response encoded for key, nullptr if there is none
+  Encoded Find(const Key& key) const;
+
+  // Encode the response of the track with the given song info, keep it and
+  // return it. The responses of another track are dropped.
+  Encoded Insert(const Key& key, const SongInfo& info,
+                 ::bluetooth::PacketBuilder& response);
+
+  // The song info the responses were built from
+  const SongInfo& GetSongInfo() const { return song_info_; }
+
+  // Drop the responses, called when the track or its metadata changes
+  void Invalidate();
+
+ private:
+  // More than a few controllers asking for different attributes is unusual
+  static constexpr size_t kMaxResponses = 16;
+
+  SongInfo song_info_;
+  std::map<Key, Encoded> responses_;
+};
+
+}  // namespace avrcp
+}  // namespace bluetooth
@@ -737,6 +737,56 @@ TEST_F(AvrcpDeviceTest, getElementAttributesMtuTest) {
       1, TestAvrcpPacket::Make(get_element_attributes_request_full));
 }
 
+TEST_F(AvrcpDeviceTest, getElementAttributesSharedTest) {
+  MockMediaInterface interface;
+  NiceMock<MockA2dpInterface> a2dp_interface;
+
+  base::Callback<void(uint8_t, bool, AvrcpResponse)> cb =
+      base::Bind([](MockFunction<void(uint8_t, bool, const AvrcpResponse&)>* a,
+                    uint8_t b, bool c, AvrcpResponse d) { a->Call(b, c, d); },
+                 &response_cb);
+  Device other_device(RawAddress::kAny, true, cb, 0xFFFF, 0xFFFF);
+
+  auto metadata_cache = std::make_shared<MetadataCache>();
+  test_device->SetMetadataCache(metadata_cache);
+  other_device.SetMetadataCache(metadata_cache);
+  test_device->RegisterInterfaces(&interface, &a2dp_interface, nullptr);
+  other_device.RegisterInterfaces(&interface, &a2dp_interface, nullptr);
+
+  SongInfo info = {"test_id",
+                   {AttributeEntry(Attribute::TITLE, "Test Song"),
+                    AttributeEntry(Attribute::ARTIST_NAME, "Test Artist")}};
+  SongInfo next_info = {"test_id2",
+                        {AttributeEntry(Attribute::TITLE, "Test Song2")}};
+
+  // The track is asked for once by the two devices, then again after it
+  // changed
+  EXPECT_CALL(interface, GetSongInfo(_))
+      .Times(2)
+      .WillOnce(InvokeCb<0>(info))
+      .WillOnce(InvokeCb<0>(next_info));
+
+  auto compare_to_partial =
+      GetElementAttributesResponseBuilder::MakeBuilder(0xFFFF);
+  compare_to_partial->AddAttributeEntry(Attribute::TITLE, "Test Song");
+  EXPECT_CALL(response_cb,
+              Call(1, false, matchPacket(std::move(compare_to_partial))))
+      .Times(2);
+  SendMessage(1, TestAvrcpPacket::Make(get_element_attributes_request_partial));
+  other_device.MessageReceived(
+      1, TestAvrcpPacket::Make(get_element_attributes_request_partial));
+
+  other_device.SendMediaUpdate(true, false, false);
+
+  auto compare_to_next =
+      GetElementAttributesResponseBuilder::MakeBuilder(0xFFFF);
+  compare_to_next->AddAttributeEntry(Attribute::TITLE, "Test Song2");
+  EXPECT_CALL(response_cb,
+              Call(2, false, matchPacket(std::move(compare_to_next))))
+      .Times(1);
+  SendMessage(2, TestAvrcpPacket::Make(get_element_attributes_request_partial));
+}
+
 TEST_F(AvrcpDeviceTest, getTotalNumberOfItemsMediaPlayersTest) {
   MockMediaInterface interface;
   NiceMock<MockA2dpInterface> a2dp_interface;
@@ -987,8 +1037,10 @@ TEST_F(AvrcpDeviceTest, changePathTest) {
   ListItem item3 = {ListItem::FOLDER, info3, SongInfo()};
   ListItem item4 = {ListItem::FOLDER, info4, SongInfo()};
   std::vector<ListItem> list1 = {item2, item3, item4};
+  // Listed on each change path, the folder items after the first one come from
+  // that listing
   EXPECT_CALL(interface, GetFolderItems(_, "test_id1", _))
-      .Times(3)
+      .Times(2)
       .WillRepeatedly(InvokeCb<2>(list1));
 
   std::vector<ListItem> list2 = {};
@@ -1060,6 +1112,135 @@ TEST_F(AvrcpDeviceTest, changePathTest) {
   SendBrowseMessage(5, request);
 }
 
+TEST_F(AvrcpDeviceTest, getVFSFolderPagedTest) {
+  MockMediaInterface interface;
+  NiceMock<MockA2dpInterface> a2dp_interface;
+
+  test_device->RegisterInterfaces(&interface, &a2dp_interface, nullptr);
+
+  std::vector<ListItem> list = {
+      {ListItem::FOLDER, {"test_id0", true, "Test Folder0"}, SongInfo()},
+      {ListItem::FOLDER, {"test_id1", true, "Test Folder1"}, SongInfo()},
+      {ListItem::FOLDER, {"test_id2", true, "Test Folder2"}, SongInfo()},
+  };
+
+  // Only the first range asks the media player
+  EXPECT_CALL(interface, GetFolderItems(_, "", _))
+      .Times(1)
+      .WillOnce(InvokeCb<2>(list));
+
+  auto folder_items_response = GetFolderItemsResponseBuilder::MakeVFSBuilder(
+      Status::NO_ERROR, 0x0000, 0xFFFF);
+  folder_items_response->AddFolder(FolderItem(1, 0, true, "Test Folder0"));
+  folder_items_response->AddFolder(FolderItem(2, 0, true, "Test Folder1"));
+  EXPECT_CALL(response_cb,
+              Call(1, true, matchPacket(std::move(folder_items_response))))
+      .Times(1);
+  auto request = TestBrowsePacket::Make();
+  GetFolderItemsRequestBuilder::MakeBuilder(Scope::VFS, 0, 1, {})
+      ->Serialize(request);
+  SendBrowseMessage(1, request);
+
+  folder_items_response = GetFolderItemsResponseBuilder::MakeVFSBuilder(
+      Status::NO_ERROR, 0x0000, 0xFFFF);
+  folder_items_response->AddFolder(FolderItem(3, 0, true, "Test Folder2"));
+  EXPECT_CALL(response_cb,
+              Call(2, true, matchPacket(std::move(folder_items_response))))
+      .Times(1);
+  request = TestBrowsePacket::Make();
+  GetFolderItemsRequestBuilder::MakeBuilder(Scope::VFS, 2, 2, {})
+      ->Serialize(request);
+  SendBrowseMessage(2, request);
+
+  auto total_items_response =
+      GetTotalNumberOfItemsResponseBuilder::MakeBuilder(Status::NO_ERROR, 0,
+                                                        list.size());
+  EXPECT_CALL(response_cb,
+              Call(3, true, matchPacket(std::move(total_items_response))))
+      .Times(1);
+  SendBrowseMessage(
+      3, TestBrowsePacket::Make(get_total_number_of_items_request_vfs));
+}
+
+TEST_F(AvrcpDeviceTest, getVFSFolderUidsChangedTest) {
+  MockMediaInterface interface;
+  NiceMock<MockA2dpInterface> a2dp_interface;
+
+  test_device->RegisterInterfaces(&interface, &a2dp_interface, nullptr);
+
+  std::vector<ListItem> list0 = {
+      {ListItem::FOLDER, {"test_id0", true, "Test Folder0"}, SongInfo()},
+  };
+  std::vector<ListItem> list1 = {
+      {ListItem::FOLDER, {"test_id1", true, "Test Folder1"}, SongInfo()},
+  };
+
+  EXPECT_CALL(interface, GetFolderItems(_, "", _))
+      .Times(2)
+      .WillOnce(InvokeCb<2>(list0))
+      .WillOnce(InvokeCb<2>(list1));
+
+  auto folder_items_response = GetFolderItemsResponseBuilder::MakeVFSBuilder(
+      Status::NO_ERROR, 0x0000, 0xFFFF);
+  folder_items_response->AddFolder(FolderItem(1, 0, true, "Test Folder0"));
+  EXPECT_CALL(response_cb,
+              Call(1, true, matchPacket(std::move(folder_items_response))))
+      .Times(1);
+  SendBrowseMessage(1, TestBrowsePacket::Make(get_folder_items_request_vfs));
+
+  // The folder is listed again once the player reports its UIDs changed
+  test_device->SendFolderUpdate(false, false, true);
+
+  folder_items_response = GetFolderItemsResponseBuilder::MakeVFSBuilder(
+      Status::NO_ERROR, 0x0000, 0xFFFF);
+  folder_items_response->AddFolder(FolderItem(2, 0, true, "Test Folder1"));
+  EXPECT_CALL(response_cb,
+              Call(2, true, matchPacket(std::move(folder_items_response))))
+      .Times(1);
+  SendBrowseMessage(2, TestBrowsePacket::Make(get_folder_items_request_vfs));
+}
+
+TEST_F(AvrcpDeviceTest, getNowPlayingListPagedTest) {
+  MockMediaInterface interface;
+  NiceMock<MockA2dpInterface> a2dp_interface;
+
+  test_device->RegisterInterfaces(&interface, &a2dp_interface, nullptr);
+
+  SongInfo info0 = {"test_id0",
+                    {AttributeEntry(Attribute::TITLE, "Test Song0")}};
+  SongInfo info1 = {"test_id1",
+                    {AttributeEntry(Attribute::TITLE, "Test Song1")}};
+  std::vector<SongInfo> list = {info0, info1};
+
+  EXPECT_CALL(interface, GetNowPlayingList(_))
+      .Times(1)
+      .WillOnce(InvokeCb<0>("test_id0", list));
+
+  auto expected_response = GetFolderItemsResponseBuilder::MakeNowPlayingBuilder(
+      Status::NO_ERROR, 0x0000, 0xFFFF);
+  expected_response->AddSong(
+      MediaElementItem(1, "Test Song0", info0.attributes));
+  EXPECT_CALL(response_cb,
+              Call(1, true, matchPacket(std::move(expected_response))))
+      .Times(1);
+  auto request = TestBrowsePacket::Make();
+  GetFolderItemsRequestBuilder::MakeBuilder(Scope::NOW_PLAYING, 0, 0, {})
+      ->Serialize(request);
+  SendBrowseMessage(1, request);
+
+  expected_response = GetFolderItemsResponseBuilder::MakeNowPlayingBuilder(
+      Status::NO_ERROR, 0x0000, 0xFFFF);
+  expected_response->AddSong(
+      MediaElementItem(2, "Test Song1", info1.attributes));
+  EXPECT_CALL(response_cb,
+              Call(2, true, matchPacket(std::move(expected_response))))
+      .Times(1);
+  request = TestBrowsePacket::Make();
+  GetFolderItemsRequestBuilder::MakeBuilder(Scope::NOW_PLAYING, 1, 1, {})
+      ->Serialize(request);
+  SendBrowseMessage(2, request);
+}
+
 TEST_F(AvrcpDeviceTest, getItemAttributesNowPlayingTest) {
   MockMediaInterface interface;
   NiceMock<MockA2dpInterface> a2dp_interface;
@@ -29,6 +29,7 @@
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
+#include "stack/include/avdt_api.h"
 #include "stack/include/bt_hdr.h"
 
 //
@@ -38,12 +39,16 @@
 // A2DP AAC encoder interval in milliseconds
 #define A2DP_AAC_ENCODER_INTERVAL_MS 20
 
-// offset
-#if (BTA_AV_CO_CP_SCMS_T == TRUE)
-#define A2DP_AAC_OFFSET (AVDT_MEDIA_OFFSET + 1)
-#else
-#define A2DP_AAC_OFFSET AVDT_MEDIA_OFFSET
-#endif
+// Adaptation of the bit rate to the transmit queue length: the bit rate (the
+// peak bit rate in VBR mode) is lowered by one step when the queue is above
+// the high watermark, and raised back by one step once the queue stayed at
+// or below the low watermark for A2DP_AAC_ABR_RAISE_TICKS. The bit rate is
+// not lowered below half of the configured one.
+#define A2DP_AAC_ABR_QUEUE_HIGH 3
+#define A2DP_AAC_ABR_QUEUE_LOW 1
+#define A2DP_AAC_ABR_STEPS 8        // Steps from the configured bit rate to 0
+#define A2DP_AAC_ABR_LOWER_TICKS 5  // Min. ticks between two steps down
+#define A2DP_AAC_ABR_RAISE_TICKS 50 // Ticks with a short queue to step up
 
 typedef struct {
   uint32_t sample_rate;
@@ -72,10 +77,20 @@ typedef struct {
   size_t media_read_total_actual_read_bytes;
 } a2dp_aac_encoder_stats_t;
 
+typedef struct {
+  bool vbr;              // The peak bit rate is adapted, not the bit rate
+  int nominal_bit_rate;  // Bit rate of the codec configuration
+  int bit_rate;          // Current bit rate
+  size_t ticks;          // Ticks since the last adjustment
+  size_t adjustments;
+} tA2DP_AAC_ABR_STATE;
+
 typedef struct {
   a2dp_source_read_callback_t read_callback;
   a2dp_source_enqueue_callback_t enqueue_callback;
   uint16_t TxAaMtuSize;
+  size_t TxQueueLength;
+  tA2DP_AAC_ABR_STATE abr_state;
 
   bool use_SCMS_T;
   tA2DP_ENCODER_INIT_PEER_PARAMS peer_params;
@@ -159,7 +174,7 @@ static void a2dp_aac_encoder_update(A2dpCodecConfig* a2dp_codec_config,
       &a2dp_aac_encoder_cb.aac_encoder_params;
   uint8_t codec_info[AVDT_CODEC_SIZE];
   AACENC_ERROR aac_error;
-  int aac_param_value, aac_sampling_freq, aac_peak_bit_rate;
+  int aac_param_value, aac_sampling_freq, aac_peak_bit_rate, aac_bit_rate;
 
   *p_restart_input = false;
   *p_restart_output = false;
@@ -288,6 +303,7 @@ static void a2dp_aac_encoder_update(A2dpCodecConfig* a2dp_codec_config,
   aac_peak_bit_rate =
       A2DP_ComputeMaxBitRateAac(p_codec_info, a2dp_aac_encoder_cb.TxAaMtuSize);
   aac_param_value = std::min(aac_param_value, aac_peak_bit_rate);
+  aac_bit_rate = aac_param_value;
   LOG_INFO("%s: MTU = %d Sampling Frequency = %d Bit Rate = %d", __func__,
            a2dp_aac_encoder_cb.TxAaMtuSize, aac_sampling_freq, aac_param_value);
   if (aac_param_value == -1) {
@@ -426,6 +442,14 @@ static void a2dp_aac_encoder_update(A2dpCodecConfig* a2dp_codec_config,
       p_encoder_params->input_channels_n,
       p_encoder_params->max_encoded_buffer_bytes);
 
+  // The bit rate adaptation starts from the configured bit rate
+  tA2DP_AAC_ABR_STATE* p_abr_state = &a2dp_aac_encoder_cb.abr_state;
+  p_abr_state->vbr = (aac_param_value != 0);  // AACENC_BITRATEMODE 0 is CBR
+  p_abr_state->nominal_bit_rate =
+      p_abr_state->vbr ? aac_peak_bit_rate : aac_bit_rate;
+  p_abr_state->bit_rate = p_abr_state->nominal_bit_rate;
+  p_abr_state->ticks = 0;
+
   // After encoder params ready, reset the feeding state and its interval.
   a2dp_aac_feeding_reset();
 }
@@ -482,10 +506,54 @@ int a2dp_aac_get_effective_frame_size() {
   return a2dp_aac_encoder_cb.TxAaMtuSize;
 }
 
+void a2dp_aac_set_transmit_queue_length(size_t transmit_queue_length) {
+  a2dp_aac_encoder_cb.TxQueueLength = transmit_queue_length;
+}
+
+// Adapts the bit rate to the transmit queue length, once per media tick.
+static void a2dp_aac_adapt_bit_rate(void) {
+  tA2DP_AAC_ABR_STATE* p_abr_state = &a2dp_aac_encoder_cb.abr_state;
+  int step = p_abr_state->nominal_bit_rate / A2DP_AAC_ABR_STEPS;
+  int bit_rate = p_abr_state->bit_rate;
+
+  if (!a2dp_aac_encoder_cb.has_aac_handle || step <= 0) return;
+
+  p_abr_state->ticks++;
+  if (a2dp_aac_encoder_cb.TxQueueLength > A2DP_AAC_ABR_QUEUE_HIGH) {
+    if (p_abr_state->ticks < A2DP_AAC_ABR_LOWER_TICKS) return;
+    bit_rate = std::max(bit_rate - step, p_abr_state->nominal_bit_rate / 2);
+  } else if (a2dp_aac_encoder_cb.TxQueueLength <= A2DP_AAC_ABR_QUEUE_LOW) {
+    if (p_abr_state->ticks < A2DP_AAC_ABR_RAISE_TICKS) return;
+    bit_rate = std::min(bit_rate + step, p_abr_state->nominal_bit_rate);
+  } else {
+    // Hold the bit rate, and restart the wait before raising it
+    p_abr_state->ticks = 0;
+    return;
+  }
+  p_abr_state->ticks = 0;
+  if (bit_rate == p_abr_state->bit_rate) return;
+
+  LOG_INFO("%s: transmit queue length %zu, %sbit rate %d -> %d", __func__,
+           a2dp_aac_encoder_cb.TxQueueLength, p_abr_state->vbr ? "peak " : "",
+           p_abr_state->bit_rate, bit_rate);
+  // The encoder applies the new bit rate from the next frame
+  AACENC_ERROR aac_error = aacEncoder_SetParam(
+      a2dp_aac_encoder_cb.aac_handle,
+      p_abr_state->vbr ? AACENC_PEAK_BITRATE : AACENC_BITRATE, bit_rate);
+  if (aac_error != AACENC_OK) {
+    LOG_ERROR("%s: Cannot set AAC bit rate to %d: AAC error 0x%x", __func__,
+              bit_rate, aac_error);
+    return;
+  }
+  p_abr_state->bit_rate = bit_rate;
+  p_abr_state->adjustments++;
+}
+
 void a2dp_aac_send_frames(uint64_t timestamp_us) {
   uint8_t nb_frame = 0;
   uint8_t nb_iterations = 0;
 
+  a2dp_aac_adapt_bit_rate();
   a2dp_aac_get_num_frame_iteration(&nb_iterations, &nb_frame, timestamp_us);
   LOG_VERBOSE("%s: Sending %d frames per iteration, %d iterations", __func__,
               nb_frame, nb_iterations);
@@ -586,10 +654,7 @@ static void a2dp_aac_encode_frames(uint8_t nb_frame) {
   int written = 0;
 
   while (nb_frame) {
-    BT_HDR* p_buf = (BT_HDR*)osi_malloc(BT_DEFAULT_BUFFER_SIZE);
-    p_buf->offset = A2DP_AAC_OFFSET;
-    p_buf->len = 0;
-    p_buf->layer_specific = 0;
+    BT_HDR* p_buf = AVDT_AllocMediaPacket(0);
     a2dp_aac_encoder_cb.stats.media_read_total_expected_packets++;
 
     count = 0;
@@ -689,7 +754,7 @@ static bool a2dp_aac_read_feeding(uint8_t* read_buffer, uint32_t* bytes_read) {
 
 static uint16_t adjust_effective_mtu(
     const tA2DP_ENCODER_INIT_PEER_PARAMS& peer_params) {
-  uint16_t mtu_size = BT_DEFAULT_BUFFER_SIZE - A2DP_AAC_OFFSET - sizeof(BT_HDR);
+  uint16_t mtu_size = AVDT_MediaPacketPayloadSize(0);
   if (mtu_size > peer_params.peer_mtu) {
     mtu_size = peer_params.peer_mtu;
   }
@@ -725,6 +790,15 @@ void A2dpCodecConfigAacSource::debug_codec_dump(int fd) {
   dprintf(fd, "  Encoder interval (ms): %" PRIu64 "\n",
           a2dp_aac_get_encoder_interval_ms());
   dprintf(fd, "  Effective MTU: %d\n", a2dp_aac_get_effective_frame_size());
+  dprintf(fd,
+          "  AAC adapted bit rate (current/configured/adjustments)   : %d / "
+          "%d / %zu\n",
+          a2dp_aac_encoder_cb.abr_state.bit_rate,
+          a2dp_aac_encoder_cb.abr_state.nominal_bit_rate,
+          a2dp_aac_encoder_cb.abr_state.adjustments);
+  dprintf(fd,
+          "  AAC saved transmit queue length                         : %zu\n",
+          a2dp_aac_encoder_cb.TxQueueLength);
   dprintf(fd,
           "  Packet counts (expected/dropped)                        : %zu / "
           "%zu\n",
@@ -25,18 +25,19 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <algorithm>
+#include <memory>
+
 #include "a2dp_sbc.h"
-#include "a2dp_sbc_up_sample.h"
+#include "common/audio_resampler.h"
 #include "common/time_util.h"
 #include "embdrv/sbc/encoder/include/sbc_encoder.h"
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
+#include "stack/include/avdt_api.h"
 #include "stack/include/bt_hdr.h"
 
-/* Buffer pool */
-#define A2DP_SBC_BUFFER_SIZE BT_DEFAULT_BUFFER_SIZE
-
 // A2DP SBC encoder interval in milliseconds.
 #define A2DP_SBC_ENCODER_INTERVAL_MS 20
 
@@ -53,6 +54,19 @@
 /* Define the bitrate step when trying to match bitpool value */
 #define A2DP_SBC_BITRATE_STEP 5
 
+/*
+ * Adaptation of the bitpool to the transmit queue length: the bitpool is
+ * lowered by one step when the queue is above the high watermark, and raised
+ * back by one step once the queue stayed at or below the low watermark for
+ * A2DP_SBC_ABR_RAISE_TICKS. The bitpool is not lowered below half of the
+ * configured one.
+ */
+#define A2DP_SBC_ABR_QUEUE_HIGH 3
+#define A2DP_SBC_ABR_QUEUE_LOW 1
+#define A2DP_SBC_ABR_BITPOOL_STEP 4
+#define A2DP_SBC_ABR_LOWER_TICKS 5  /* Min. ticks between two steps down */
+#define A2DP_SBC_ABR_RAISE_TICKS 50 /* Ticks with a short queue to step up */
+
 /* Readability constants */
 #define A2DP_SBC_FRAME_HEADER_SIZE_BYTES 4  // A2DP Spec v1.3, 12.4, Table 12.12
 #define A2DP_SBC_SCALE_FACTOR_BITS 4        // A2DP Spec v1.3, 12.4, Table 12.13
@@ -61,10 +75,8 @@
 #if (BTA_AV_CO_CP_SCMS_T == TRUE)
 /* A2DP header will contain a CP header of size 1 */
 #define A2DP_HDR_SIZE 2
-#define A2DP_SBC_OFFSET (AVDT_MEDIA_OFFSET + A2DP_SBC_MPL_HDR_LEN + 1)
 #else
 #define A2DP_HDR_SIZE 1
-#define A2DP_SBC_OFFSET (AVDT_MEDIA_OFFSET + A2DP_SBC_MPL_HDR_LEN)
 #endif
 
 typedef struct {
@@ -76,6 +88,13 @@ typedef struct {
   uint64_t last_frame_us;
 } tA2DP_SBC_FEEDING_STATE;
 
+typedef struct {
+  int16_t nominal_bitpool; /* Bitpool of the codec configuration */
+  int16_t min_bitpool;     /* Lowest bitpool of the adaptation */
+  size_t ticks;            /* Ticks since the last adjustment */
+  size_t adjustments;
+} tA2DP_SBC_ABR_STATE;
+
 typedef struct {
   uint64_t session_start_us;
 
@@ -96,6 +115,8 @@ typedef struct {
   a2dp_source_enqueue_callback_t enqueue_callback;
   uint16_t TxAaMtuSize;
   uint8_t tx_sbc_frames;
+  size_t TxQueueLength;
+  tA2DP_SBC_ABR_STATE abr_state;
   tA2DP_ENCODER_INIT_PEER_PARAMS peer_params;
   uint32_t timestamp;       /* Timestamp for the A2DP frames */
   SBC_ENC_PARAMS sbc_encoder_params;
@@ -107,6 +128,9 @@ typedef struct {
 } tA2DP_SBC_ENCODER_CB;
 
 static tA2DP_SBC_ENCODER_CB a2dp_sbc_encoder_cb;
+/* Converts the feeding to the SBC sampling rate when they differ, kept out of
+ * a2dp_sbc_encoder_cb as that one is cleared with memset */
+static std::unique_ptr<bluetooth::common::AudioResampler> a2dp_sbc_resampler;
 
 static void a2dp_sbc_encoder_update(A2dpCodecConfig* a2dp_codec_config,
                                     bool* p_restart_input,
@@ -337,10 +361,18 @@ static void a2dp_sbc_encoder_update(A2dpCodecConfig* a2dp_codec_config,
   /* Reset the SBC encoder */
   SBC_Encoder_Init(&a2dp_sbc_encoder_cb.sbc_encoder_params);
   a2dp_sbc_encoder_cb.tx_sbc_frames = calculate_max_frames_per_packet();
+
+  /* The bitpool adaptation starts from the configured bitpool */
+  tA2DP_SBC_ABR_STATE* p_abr_state = &a2dp_sbc_encoder_cb.abr_state;
+  p_abr_state->nominal_bitpool = p_encoder_params->s16BitPool;
+  p_abr_state->min_bitpool =
+      std::max<int16_t>(min_bitpool, p_encoder_params->s16BitPool / 2);
+  p_abr_state->ticks = 0;
 }
 
 void a2dp_sbc_encoder_cleanup(void) {
   memset(&a2dp_sbc_encoder_cb, 0, sizeof(a2dp_sbc_encoder_cb));
+  a2dp_sbc_resampler.reset();
 }
 
 void a2dp_sbc_feeding_reset(void) {
@@ -357,11 +389,13 @@ void a2dp_sbc_feeding_reset(void) {
 
   LOG_INFO("%s: PCM bytes per tick %u", __func__,
            a2dp_sbc_encoder_cb.feeding_state.bytes_per_tick);
+  a2dp_sbc_resampler.reset();
 }
 
 void a2dp_sbc_feeding_flush(void) {
   a2dp_sbc_encoder_cb.feeding_state.counter = 0.0f;
   a2dp_sbc_encoder_cb.feeding_state.aa_feed_residue = 0;
+  if (a2dp_sbc_resampler != nullptr) a2dp_sbc_resampler->Reset();
 }
 
 uint64_t a2dp_sbc_get_encoder_interval_ms(void) {
@@ -372,10 +406,47 @@ int a2dp_sbc_get_effective_frame_size() {
   return a2dp_sbc_encoder_cb.TxAaMtuSize;
 }
 
+void a2dp_sbc_set_transmit_queue_length(size_t transmit_queue_length) {
+  a2dp_sbc_encoder_cb.TxQueueLength = transmit_queue_length;
+}
+
+// Adapts the bitpool to the transmit queue length, once per media tick.
+static void a2dp_sbc_adapt_bitpool(void) {
+  SBC_ENC_PARAMS* p_encoder_params = &a2dp_sbc_encoder_cb.sbc_encoder_params;
+  tA2DP_SBC_ABR_STATE* p_abr_state = &a2dp_sbc_encoder_cb.abr_state;
+  int16_t bitpool = p_encoder_params->s16BitPool;
+
+  p_abr_state->ticks++;
+  if (a2dp_sbc_encoder_cb.TxQueueLength > A2DP_SBC_ABR_QUEUE_HIGH) {
+    if (p_abr_state->ticks < A2DP_SBC_ABR_LOWER_TICKS) return;
+    bitpool = std::max<int16_t>(bitpool - A2DP_SBC_ABR_BITPOOL_STEP,
+                                p_abr_state->min_bitpool);
+  } else if (a2dp_sbc_encoder_cb.TxQueueLength <= A2DP_SBC_ABR_QUEUE_LOW) {
+    if (p_abr_state->ticks < A2DP_SBC_ABR_RAISE_TICKS) return;
+    bitpool = std::min<int16_t>(bitpool + A2DP_SBC_ABR_BITPOOL_STEP,
+                                p_abr_state->nominal_bitpool);
+  } else {
+    // Hold the bitpool, and restart the wait before raising it
+    p_abr_state->ticks = 0;
+    return;
+  }
+  p_abr_state->ticks = 0;
+  if (bitpool == p_encoder_params->s16BitPool) return;
+
+  LOG_INFO("%s: transmit queue length %zu, bitpool %d -> %d", __func__,
+           a2dp_sbc_encoder_cb.TxQueueLength, p_encoder_params->s16BitPool,
+           bitpool);
+  // The bitpool is read for each frame by the encoder, no reset is needed
+  p_encoder_params->s16BitPool = bitpool;
+  a2dp_sbc_encoder_cb.tx_sbc_frames = calculate_max_frames_per_packet();
+  p_abr_state->adjustments++;
+}
+
 void a2dp_sbc_send_frames(uint64_t timestamp_us) {
   uint8_t nb_frame = 0;
   uint8_t nb_iterations = 0;
 
+  a2dp_sbc_adapt_bitpool();
   a2dp_sbc_get_num_frame_iteration(&nb_iterations, &nb_frame, timestamp_us);
   LOG_VERBOSE("%s: Sending %d frames per iteration, %d iterations", __func__,
               nb_frame, nb_iterations);
@@ -497,12 +568,9 @@ static void a2dp_sbc_encode_frames(uint8_t nb_frame) {
   uint8_t last_frame_len = 0;
 
   while (nb_frame) {
-    BT_HDR* p_buf = (BT_HDR*)osi_malloc(A2DP_SBC_BUFFER_SIZE);
+    BT_HDR* p_buf = AVDT_AllocMediaPacket(A2DP_SBC_MPL_HDR_LEN);
     uint32_t bytes_read = 0;
 
-    p_buf->offset = A2DP_SBC_OFFSET;
-    p_buf->len = 0;
-    p_buf->layer_specific = 0;
     a2dp_sbc_encoder_cb.stats.media_read_total_expected_packets++;
 
     do {
@@ -577,7 +645,6 @@ static bool a2dp_sbc_read_feeding(uint32_t* bytes_read) {
   static uint16_t read_buffer[SBC_MAX_NUM_FRAME * SBC_MAX_NUM_OF_BLOCKS *
                               SBC_MAX_NUM_OF_CHANNELS *
                               SBC_MAX_NUM_OF_SUBBANDS];
-  uint32_t src_size_used;
   uint32_t dst_size_used;
   bool fract_needed;
   int32_t fract_max;
@@ -680,23 +747,41 @@ static bool a2dp_sbc_read_feeding(uint32_t* bytes_read) {
   }
   a2dp_sbc_encoder_cb.stats.media_read_total_actual_reads_count++;
 
-  /* Initialize PCM up-sampling engine */
-  a2dp_sbc_init_up_sample(a2dp_sbc_encoder_cb.feeding_params.sample_rate,
-                          sbc_sampling,
-                          a2dp_sbc_encoder_cb.feeding_params.bits_per_sample,
-                          a2dp_sbc_encoder_cb.feeding_params.channel_count);
+  /* The resampler keeps its filter state across the reads */
+  if (a2dp_sbc_resampler == nullptr ||
+      a2dp_sbc_resampler->GetDstRate() != sbc_sampling) {
+    if (a2dp_sbc_encoder_cb.feeding_params.bits_per_sample != 16) {
+      LOG_ERROR("%s: cannot resample %u bits per sample", __func__,
+                a2dp_sbc_encoder_cb.feeding_params.bits_per_sample);
+      return false;
+    }
+    a2dp_sbc_resampler = bluetooth::common::AudioResampler::Create(
+        a2dp_sbc_encoder_cb.feeding_params.sample_rate, sbc_sampling,
+        a2dp_sbc_encoder_cb.feeding_params.channel_count);
+    if (a2dp_sbc_resampler == nullptr) {
+      LOG_ERROR("%s: cannot resample from %u to %u Hz", __func__,
+                a2dp_sbc_encoder_cb.feeding_params.sample_rate, sbc_sampling);
+      return false;
+    }
+  }
 
   /*
    * Re-sample the read buffer.
-   * The output PCM buffer will be stereo, 16 bit per sample.
+   * The output PCM buffer has the channels of the feeding, 16 bit per sample.
    */
-  dst_size_used = a2dp_sbc_up_sample(
-      (uint8_t*)read_buffer,
-      (uint8_t*)up_sampled_buffer +
-          a2dp_sbc_encoder_cb.feeding_state.aa_feed_residue,
-      nb_byte_read, sizeof(up_sampled_buffer) -
-                        a2dp_sbc_encoder_cb.feeding_state.aa_feed_residue,
-      &src_size_used);
+  size_t frame_size = a2dp_sbc_encoder_cb.feeding_params.channel_count *
+                      sizeof(int16_t);
+  size_t src_frames_used;
+  dst_size_used =
+      a2dp_sbc_resampler->Resample(
+          (const int16_t*)read_buffer, nb_byte_read / frame_size,
+          (int16_t*)((uint8_t*)up_sampled_buffer +
+                     a2dp_sbc_encoder_cb.feeding_state.aa_feed_residue),
+          (sizeof(up_sampled_buffer) -
+           a2dp_sbc_encoder_cb.feeding_state.aa_feed_residue) /
+              frame_size,
+          &src_frames_used) *
+      frame_size;
 
   /* update the residue */
   a2dp_sbc_encoder_cb.feeding_state.aa_feed_residue += dst_size_used;
@@ -721,7 +806,7 @@ static bool a2dp_sbc_read_feeding(uint32_t* bytes_read) {
 
 static uint16_t adjust_effective_mtu(
     const tA2DP_ENCODER_INIT_PEER_PARAMS& peer_params) {
-  uint16_t mtu_size = A2DP_SBC_BUFFER_SIZE - A2DP_SBC_OFFSET - sizeof(BT_HDR);
+  uint16_t mtu_size = AVDT_MediaPacketPayloadSize(A2DP_SBC_MPL_HDR_LEN);
   if (mtu_size > peer_params.peer_mtu) {
     mtu_size = peer_params.peer_mtu;
   }
@@ -895,6 +980,15 @@ void A2dpCodecConfigSbcSource::debug_codec_dump(int fd) {
         "  SBC Bitpool (min/max)                                   : %d / %d\n",
         A2DP_GetMinBitpoolSbc(codec_info), A2DP_GetMaxBitpoolSbc(codec_info));
   }
+  dprintf(fd,
+          "  SBC Bitpool (current/configured/adjustments)            : %d / %d "
+          "/ %zu\n",
+          a2dp_sbc_encoder_cb.sbc_encoder_params.s16BitPool,
+          a2dp_sbc_encoder_cb.abr_state.nominal_bitpool,
+          a2dp_sbc_encoder_cb.abr_state.adjustments);
+  dprintf(fd,
+          "  SBC saved transmit queue length                         : %zu\n",
+          a2dp_sbc_encoder_cb.TxQueueLength);
 
   dprintf(fd, "  Encoder interval (ms): %" PRIu64 "\n",
           a2dp_sbc_get_encoder_interval_ms());
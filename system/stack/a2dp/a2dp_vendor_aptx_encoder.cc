@@ -29,6 +29,7 @@
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
+#include "stack/include/avdt_api.h"
 #include "stack/include/bt_hdr.h"
 
 //
@@ -48,14 +49,6 @@ static const std::string APTX_ENCODER_SIZEOF_PARAMS_NAME = "SizeofAptxbtenc";
 
 static tAPTX_API aptx_api;
 
-// offset
-#if (BTA_AV_CO_CP_SCMS_T == TRUE)
-#define A2DP_APTX_OFFSET (AVDT_MEDIA_OFFSET + 1)
-#else
-// no RTP header for aptX classic
-#define A2DP_APTX_OFFSET (AVDT_MEDIA_OFFSET - AVDT_MEDIA_HDR_SIZE)
-#endif
-
 #define LOAD_APTX_SYMBOL(symbol_name, api_type)      \
   LOAD_CODEC_SYMBOL("AptX", aptx_encoder_lib_handle, \
                     A2DP_VendorUnloadEncoderAptx, symbol_name, api_type)
@@ -342,10 +335,7 @@ void a2dp_vendor_aptx_send_frames(uint64_t timestamp_us) {
   tAPTX_FRAMING_PARAMS* framing_params = &a2dp_aptx_encoder_cb.framing_params;
 
   // Prepare the packet to send
-  BT_HDR* p_buf = (BT_HDR*)osi_malloc(BT_DEFAULT_BUFFER_SIZE);
-  p_buf->offset = A2DP_APTX_OFFSET;
-  p_buf->len = 0;
-  p_buf->layer_specific = 0;
+  BT_HDR* p_buf = AVDT_AllocMediaPacket(0);
 
   uint8_t* encoded_ptr = (uint8_t*)(p_buf + 1);
   encoded_ptr += p_buf->offset;
@@ -29,6 +29,7 @@
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
+#include "stack/include/avdt_api.h"
 #include "stack/include/bt_hdr.h"
 
 //
@@ -49,13 +50,6 @@ static const std::string APTX_HD_ENCODER_SIZEOF_PARAMS_NAME =
 
 static tAPTX_HD_API aptx_hd_api;
 
-// offset
-#if (BTA_AV_CO_CP_SCMS_T == TRUE)
-#define A2DP_APTX_HD_OFFSET (AVDT_MEDIA_OFFSET + 1)
-#else
-#define A2DP_APTX_HD_OFFSET AVDT_MEDIA_OFFSET
-#endif
-
 #define LOAD_APTX_HD_SYMBOL(symbol_name, api_type)        \
   LOAD_CODEC_SYMBOL("AptXHd", aptx_hd_encoder_lib_handle, \
                     A2DP_VendorUnloadEncoderAptxHd, symbol_name, api_type)
@@ -327,10 +321,7 @@ void a2dp_vendor_aptx_hd_send_frames(uint64_t timestamp_us) {
       &a2dp_aptx_hd_encoder_cb.framing_params;
 
   // Prepare the packet to send
-  BT_HDR* p_buf = (BT_HDR*)osi_malloc(BT_DEFAULT_BUFFER_SIZE);
-  p_buf->offset = A2DP_APTX_HD_OFFSET;
-  p_buf->len = 0;
-  p_buf->layer_specific = 0;
+  BT_HDR* p_buf = AVDT_AllocMediaPacket(0);
 
   uint8_t* encoded_ptr = (uint8_t*)(p_buf + 1);
   encoded_ptr += p_buf->offset;
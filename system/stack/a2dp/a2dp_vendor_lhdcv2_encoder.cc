@@ -35,6 +35,7 @@
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
+#include "stack/include/avdt_api.h"
 
 //
 // Encoder for LHDC Source Codec
@@ -98,15 +99,6 @@ static tLHDC_GET_BLOCK_SIZE lhdc_get_block_size;
 #define A2DP_LHDC_ENCODER_SHORT_INTERVAL_MS 11
 #define A2DP_LHDC_ENCODER_INTERVAL_MS 20
 
-// offset
-#if (BTA_AV_CO_CP_SCMS_T == TRUE)
-#define A2DP_LHDC_OFFSET (AVDT_MEDIA_OFFSET + A2DP_LHDC_MPL_HDR_LEN + 1)
-#else
-#define A2DP_LHDC_OFFSET (AVDT_MEDIA_OFFSET + A2DP_LHDC_MPL_HDR_LEN)
-#endif
-
-//#define A2DP_LHDC_OFFSET (AVDT_MEDIA_OFFSET + 0)
-
 typedef struct {
   uint32_t sample_rate;
   uint8_t channel_mode;
@@ -399,8 +391,7 @@ static void a2dp_vendor_lhdcv2_encoder_update(uint16_t peer_mtu,
   p_encoder_params->sample_rate =
       a2dp_lhdc_encoder_cb.feeding_params.sample_rate;
 
-  uint16_t mtu_size =
-      BT_DEFAULT_BUFFER_SIZE - A2DP_LHDC_OFFSET - sizeof(BT_HDR);
+  uint16_t mtu_size = AVDT_MediaPacketPayloadSize(A2DP_LHDC_MPL_HDR_LEN);
 
   a2dp_lhdc_encoder_cb.TxAaMtuSize = (mtu_size < peer_mtu) ? mtu_size : peer_mtu;
 
@@ -634,16 +625,13 @@ static void a2dp_lhdcv2_get_num_frame_iteration(uint8_t* num_of_iterations,
 }
 
 static BT_HDR *bt_buf_new( void) {
-    BT_HDR *p_buf = ( BT_HDR*)osi_malloc( BT_DEFAULT_BUFFER_SIZE);
+    BT_HDR *p_buf = AVDT_AllocMediaPacket(A2DP_LHDC_MPL_HDR_LEN);
     if ( p_buf == NULL) {
         // LeoKu(C): should not happen
         LOG_ERROR(  "%s: bt_buf_new failed!", __func__);
         return  NULL;
     }
 
-    p_buf->offset = A2DP_LHDC_OFFSET;
-    p_buf->len = 0;
-    p_buf->layer_specific = 0;
     return  p_buf;
 }
 
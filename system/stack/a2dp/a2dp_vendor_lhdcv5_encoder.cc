@@ -35,6 +35,7 @@
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
+#include "stack/include/avdt_api.h"
 
 //
 // Encoder for LHDC Source Codec
@@ -142,13 +143,6 @@ static tLHDCV5_EXT_SET_DATA lhdcv5_ext_set_data;
 #define A2DP_LHDC_ENCODER_SHORT_INTERVAL_MS 10
 #define A2DP_LHDC_ENCODER_INTERVAL_MS 20
 
-// offset
-#if (BTA_AV_CO_CP_SCMS_T == TRUE)
-#define A2DP_LHDC_OFFSET (AVDT_MEDIA_OFFSET + A2DP_LHDC_MPL_HDR_LEN + 1)
-#else
-#define A2DP_LHDC_OFFSET (AVDT_MEDIA_OFFSET + A2DP_LHDC_MPL_HDR_LEN)
-#endif
-
 typedef struct {
   tA2DP_SAMPLE_RATE sample_rate;
   uint32_t bits_per_sample;
@@ -668,7 +662,7 @@ static void a2dp_vendor_lhdcv5_encoder_update(uint16_t peer_mtu,
   p_encoder_params->sample_rate = a2dp_lhdc_encoder_cb.feeding_params.sample_rate;
 
   // default mtu size (uint32_t)
-  mtu_size = (BT_DEFAULT_BUFFER_SIZE - A2DP_LHDC_OFFSET - sizeof(BT_HDR));
+  mtu_size = (AVDT_MediaPacketPayloadSize(A2DP_LHDC_MPL_HDR_LEN));
   // allowed mtu size (uint32_t)
   a2dp_lhdc_encoder_cb.TxAaMtuSize = (mtu_size < peer_mtu) ? mtu_size : (uint32_t)peer_mtu;
   // real mtu size (uint32_t)
@@ -982,16 +976,13 @@ static void a2dp_lhdcv5_get_num_frame_iteration(uint8_t* num_of_iterations,
 }
 
 static BT_HDR *bt_buf_new( void) {
-  BT_HDR *p_buf = ( BT_HDR*)osi_malloc(BT_DEFAULT_BUFFER_SIZE);
+  BT_HDR *p_buf = AVDT_AllocMediaPacket(A2DP_LHDC_MPL_HDR_LEN);
   if ( p_buf == NULL) {
     // LeoKu(C): should not happen
     LOG_ERROR(  "%s: bt_buf_new failed!", __func__);
     return NULL;
   }
 
-  p_buf->offset = A2DP_LHDC_OFFSET;
-  p_buf->len = 0;
-  p_buf->layer_specific = 0;
   return p_buf;
 }
 
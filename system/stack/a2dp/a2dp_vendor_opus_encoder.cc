@@ -34,6 +34,7 @@
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
+#include "stack/include/avdt_api.h"
 #include "stack/include/bt_hdr.h"
 
 typedef struct {
@@ -241,8 +242,7 @@ static bool a2dp_vendor_opus_encoder_update(uint16_t peer_mtu,
   p_encoder_params->framesize = A2DP_VendorGetFrameSizeOpus(p_codec_info);
   p_encoder_params->bitrate = A2DP_VendorGetBitRateOpus(p_codec_info);
 
-  uint16_t mtu_size =
-      BT_DEFAULT_BUFFER_SIZE - A2DP_OPUS_OFFSET - sizeof(BT_HDR);
+  uint16_t mtu_size = AVDT_MediaPacketPayloadSize(A2DP_OPUS_MPL_HDR_LEN);
   if (mtu_size < peer_mtu) {
     a2dp_opus_encoder_cb.TxAaMtuSize = mtu_size;
   } else {
@@ -383,10 +383,7 @@ static void a2dp_opus_encode_frames(uint8_t nb_frame) {
 
   uint32_t bytes_read = 0;
   while (nb_frame) {
-    BT_HDR* p_buf = (BT_HDR*)osi_malloc(BT_DEFAULT_BUFFER_SIZE);
-    p_buf->offset = A2DP_OPUS_OFFSET;
-    p_buf->len = 0;
-    p_buf->layer_specific = 0;
+    BT_HDR* p_buf = AVDT_AllocMediaPacket(A2DP_OPUS_MPL_HDR_LEN);
     a2dp_opus_encoder_cb.stats.media_read_total_expected_packets++;
 
     do {
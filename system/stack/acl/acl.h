@@ -21,6 +21,7 @@
 #include <unordered_set>
 #include <vector>
 
+#include "stack/acl/btm_pm_traffic.h"
 #include "stack/acl/peer_packet_types.h"
 #include "stack/include/acl_api_types.h"
 #include "stack/include/bt_types.h"
@@ -166,6 +167,9 @@ struct tBTM_PM_MCB {
   uint16_t max_lat = 0;
   uint16_t min_loc_to = 0;
   uint16_t min_rmt_to = 0;
+  /* Maximum latency of the last sniff subrating sent to the controller */
+  uint16_t sent_max_lat = 0;
+  PowerModeTrafficPredictor traffic;
   void Init(RawAddress bda, uint16_t handle) {
     bda_ = bda;
     handle_ = handle;
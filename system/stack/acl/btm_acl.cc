@@ -48,6 +48,7 @@
 #include "main/shim/btm_api.h"
 #include "main/shim/controller.h"
 #include "main/shim/dumpsys.h"
+#include "main/shim/hci_layer.h"
 #include "main/shim/l2c_api.h"
 #include "main/shim/shim.h"
 #include "osi/include/allocator.h"
@@ -409,17 +410,18 @@ void btm_acl_created(const RawAddress& bda, uint16_t hci_handle,
       bt_transport_text(transport).c_str());
 
   if (transport == BT_TRANSPORT_BR_EDR) {
+    /* The BR/EDR link setup commands are handed to the HCI layer in one go.
+     * Nothing in between goes through the gd modules, whose commands would
+     * otherwise overtake the batch. */
+    bluetooth::shim::HciCommandBatch batch;
     btm_set_link_policy(p_acl, btm_cb.acl_cb_.DefaultLinkPolicy());
+    btsnd_hcic_read_rmt_clk_offset(hci_handle);
   }
 
   if (transport == BT_TRANSPORT_LE) {
     btm_ble_refresh_local_resolvable_private_addr(
         bda, btm_cb.ble_ctr_cb.addr_mgnt_cb.private_addr);
   }
-  /* if BR/EDR do something more */
-  if (transport == BT_TRANSPORT_BR_EDR) {
-    btsnd_hcic_read_rmt_clk_offset(hci_handle);
-  }
 
   if (transport == BT_TRANSPORT_LE) {
     btm_ble_get_acl_remote_addr(hci_handle, p_acl->active_remote_addr,
@@ -2650,6 +2652,7 @@ void acl_send_data_packet_br_edr(const RawAddress& bd_addr, BT_HDR* p_buf) {
       osi_free(p_buf);
       return;
     }
+    btm_pm_on_acl_traffic(p_acl->hci_handle);
     return bluetooth::shim::ACL_WriteData(p_acl->hci_handle, p_buf);
 }
 
@@ -2726,6 +2729,7 @@ void acl_rcv_acl_data(BT_HDR* p_msg) {
     osi_free(p_msg);
     return;
   }
+  btm_pm_on_acl_traffic(acl_header.handle);
   l2c_rcv_acl_data(p_msg);
 }
 
@@ -35,6 +35,7 @@
 #include <unordered_map>
 
 #include "bt_target.h"
+#include "common/time_util.h"
 #include "device/include/controller.h"
 #include "device/include/interop.h"
 #include "main/shim/dumpsys.h"
@@ -42,7 +43,9 @@
 #include "main/shim/shim.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"  // UNUSED_ATTR
+#include "osi/include/properties.h"
 #include "stack/btm/btm_int_types.h"
+#include "stack/include/acl_hci_link_interface.h"
 #include "stack/include/btm_api.h"
 #include "stack/include/btm_api_types.h"
 #include "stack/include/btm_status.h"
@@ -72,6 +75,18 @@ tBTM_PM_RCB pm_reg_db; /* per application/module */
 uint8_t pm_pend_id = 0; /* the id pf the module, which has a pending PM cmd */
 
 constexpr char kBtmLogTag[] = "ACL";
+
+constexpr char kAdaptiveSniffProperty[] =
+    "bluetooth.btm.pm.adaptive_sniff.enabled";
+/* Sniff subrating maximum latency of the idle links, 1.28s */
+constexpr uint16_t kIdleSniffSubrateMaxLatency = 0x0800;
+
+/* The sniff intervals, subrating and exits follow the traffic of the links */
+bool is_adaptive_sniff_enabled() {
+  static const bool enabled =
+      osi_property_get_bool(kAdaptiveSniffProperty, false);
+  return enabled;
+}
 }
 
 /*****************************************************************************/
@@ -91,11 +106,11 @@ const uint8_t
 
         BTM_PM_GET_MD1,  BTM_PM_GET_MD2,  BTM_PM_GET_COMP};
 
-static void send_sniff_subrating(uint16_t handle, const RawAddress& addr,
-                                 uint16_t max_lat, uint16_t min_rmt_to,
-                                 uint16_t min_loc_to) {
-  btsnd_hcic_sniff_sub_rate(handle, max_lat, min_rmt_to, min_loc_to);
-  BTM_LogHistory(kBtmLogTag, addr, "Sniff subrating",
+static void send_sniff_subrating(tBTM_PM_MCB* p_cb, uint16_t max_lat,
+                                 uint16_t min_rmt_to, uint16_t min_loc_to) {
+  btsnd_hcic_sniff_sub_rate(p_cb->handle_, max_lat, min_rmt_to, min_loc_to);
+  p_cb->sent_max_lat = max_lat;
+  BTM_LogHistory(kBtmLogTag, p_cb->bda_, "Sniff subrating",
                  base::StringPrintf(
                      "max_latency:%.2f peer_timeout:%.2f local_timeout:%.2f",
                      ticks_to_seconds(max_lat), ticks_to_seconds(min_rmt_to),
@@ -352,8 +367,7 @@ tBTM_STATUS BTM_SetSsrParams(const RawAddress& remote_bda, uint16_t max_lat,
         " min_local_timeout:0x%04x",
         power_mode_state_text(p_cb->state).c_str(), p_cb->state, max_lat,
         min_rmt_to, min_loc_to);
-    send_sniff_subrating(p_cb->handle_, remote_bda, max_lat, min_rmt_to,
-                         min_loc_to);
+    send_sniff_subrating(p_cb, max_lat, min_rmt_to, min_loc_to);
     return BTM_SUCCESS;
   }
   LOG_INFO("pm_mode_db state: %d", p_cb->state);
@@ -567,10 +581,29 @@ static tBTM_STATUS btm_pm_snd_md_req(uint16_t handle, uint8_t pm_id,
     const controller_t* controller = controller_get_interface();
     if (controller->supports_sniff_subrating()) {
       LOG_DEBUG("Sending sniff subrating to controller");
-      send_sniff_subrating(handle, p_cb->bda_, p_cb->max_lat, p_cb->min_rmt_to,
+      send_sniff_subrating(p_cb, p_cb->max_lat, p_cb->min_rmt_to,
                            p_cb->min_loc_to);
     }
     p_cb->max_lat = 0;
+  } else if (BTM_PM_MD_SNIFF == md_res.mode && is_adaptive_sniff_enabled() &&
+             p_cb->sent_max_lat < kIdleSniffSubrateMaxLatency &&
+             p_cb->traffic.IsIdle(
+                 bluetooth::common::time_get_os_boottime_ms())) {
+    const controller_t* controller = controller_get_interface();
+    if (controller->supports_sniff_subrating()) {
+      LOG_DEBUG("Sending idle link sniff subrating to controller");
+      send_sniff_subrating(p_cb, kIdleSniffSubrateMaxLatency, p_cb->min_rmt_to,
+                           p_cb->min_loc_to);
+    }
+  }
+
+  if (BTM_PM_MD_SNIFF == md_res.mode && is_adaptive_sniff_enabled()) {
+    const uint16_t max = md_res.max;
+    p_cb->traffic.AdaptSniffInterval(md_res.min, &md_res.max);
+    if (md_res.max != max) {
+      LOG_DEBUG("Lowered sniff max interval from %hu to %hu for traffic %s",
+                max, md_res.max, p_cb->traffic.ToString().c_str());
+    }
   }
   /* Default is failure */
   pm_pend_link = 0;
@@ -911,6 +944,47 @@ tBTM_CONTRL_STATE BTM_PM_ReadControllerState(void) {
     return BTM_CONTRL_IDLE;
 }
 
+/*******************************************************************************
+ *
+ * Function         btm_pm_on_acl_traffic
+ *
+ * Description      This function is called for each ACL packet sent to or
+ *                  received from the controller. It updates the traffic
+ *                  prediction of the link, and takes it out of sniff mode when
+ *                  the traffic became periodic with a period much shorter than
+ *                  the sniff interval, ahead of the next packets.
+ *
+ * Returns          none.
+ *
+ ******************************************************************************/
+void btm_pm_on_acl_traffic(uint16_t handle) {
+  if (!is_adaptive_sniff_enabled() ||
+      bluetooth::shim::is_gd_link_policy_enabled()) {
+    return;
+  }
+  auto it = pm_mode_db.find(handle);
+  if (it == pm_mode_db.end()) {
+    return;
+  }
+  tBTM_PM_MCB* p_cb = &it->second;
+  p_cb->traffic.OnPacket(bluetooth::common::time_get_os_boottime_ms());
+
+  if (p_cb->state != BTM_PM_ST_SNIFF ||
+      !p_cb->traffic.ShouldExitSniff(p_cb->interval)) {
+    return;
+  }
+  LOG_INFO("Exiting sniff interval:%hu ahead of the traffic %s peer:%s",
+           p_cb->interval, p_cb->traffic.ToString().c_str(),
+           PRIVATE_ADDRESS(p_cb->bda_));
+  BTM_LogHistory(kBtmLogTag, p_cb->bda_, "Sniff pre-exit",
+                 base::StringPrintf("interval:%.2f %s",
+                                    ticks_to_seconds(p_cb->interval),
+                                    p_cb->traffic.ToString().c_str()));
+  tBTM_PM_PWR_MD settings = {};
+  settings.mode = BTM_PM_MD_ACTIVE;
+  BTM_SetPowerMode(BTM_PM_SET_ONLY_ID, p_cb->bda_, &settings);
+}
+
 void btm_pm_on_mode_change(tHCI_STATUS status, uint16_t handle,
                            tHCI_MODE current_mode, uint16_t interval) {
   if (bluetooth::shim::is_gd_link_policy_enabled()) {
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stack/acl/btm_pm_traffic.h"
+
+#include <base/strings/stringprintf.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+constexpr uint64_t kUsPerSlot = 625;
+
+/* Weights of the new sample in the moving averages, as in the TCP round trip
+ * time estimation */
+constexpr int64_t kMeanWeightShift = 3;
+constexpr int64_t kDeviationWeightShift = 2;
+
+}  // namespace
+
+void PowerModeTrafficPredictor::OnPacket(uint64_t now_ms) {
+  if (!has_packet_) {
+    has_packet_ = true;
+    burst_start_ms_ = last_packet_ms_ = now_ms;
+    return;
+  }
+
+  const uint64_t gap_ms =
+      now_ms > burst_start_ms_ ? now_ms - burst_start_ms_ : 0;
+  last_packet_ms_ = std::max(last_packet_ms_, now_ms);
+  if (gap_ms < kBurstGapMs) {
+    return;
+  }
+  burst_start_ms_ = now_ms;
+
+  if (gap_ms > kMaxPatternGapMs) {
+    samples_ = 0;
+    mean_us_ = deviation_us_ = 0;
+    return;
+  }
+
+  const int64_t gap_us = static_cast<int64_t>(gap_ms * 1000);
+  if (samples_ == 0) {
+    mean_us_ = gap_us;
+    deviation_us_ = gap_us / 2;
+  } else {
+    const int64_t error = gap_us - static_cast<int64_t>(mean_us_);
+    const int64_t deviation = static_cast<int64_t>(deviation_us_);
+    deviation_us_ =
+        deviation + ((std::abs(error) - deviation) >> kDeviationWeightShift);
+    mean_us_ = static_cast<int64_t>(mean_us_) + (error >> kMeanWeightShift);
+  }
+  if (samples_ < UINT32_MAX) {
+    samples_++;
+  }
+}
+
+bool PowerModeTrafficPredictor::IsPeriodic() const {
+  return samples_ >= kMinSamples && mean_us_ <= kMaxPeriodMs * 1000 &&
+         4 * deviation_us_ <= mean_us_;
+}
+
+bool PowerModeTrafficPredictor::IsIdle(uint64_t now_ms) const {
+  return !has_packet_ ||
+         (now_ms > last_packet_ms_ && now_ms - last_packet_ms_ >= kIdleMs);
+}
+
+uint16_t PowerModeTrafficPredictor::GetPeriodSlots() const {
+  /* Sniff intervals are even numbers of slots */
+  return std::max<uint64_t>(mean_us_ / kUsPerSlot, 2) & ~uint64_t{1};
+}
+
+void PowerModeTrafficPredictor::AdaptSniffInterval(uint16_t min,
+                                                   uint16_t* max) const {
+  if (!IsPeriodic()) {
+    return;
+  }
+  *max = std::min(*max, std::max(min, GetPeriodSlots()));
+}
+
+bool PowerModeTrafficPredictor::ShouldExitSniff(uint16_t interval) const {
+  return IsPeriodic() && interval > 2 * GetPeriodSlots();
+}
+
+std::string PowerModeTrafficPredictor::ToString() const {
+  return base::StringPrintf(
+      "period:%.1fms deviation:%.1fms samples:%u periodic:%s",
+      mean_us_ / 1000.0, deviation_us_ / 1000.0, samples_,
+      IsPeriodic() ? "true" : "false");
+}
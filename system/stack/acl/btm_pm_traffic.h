@@ -0,0 +1,71 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/* Traffic pattern of an ACL link, predicted from the inter-arrival times of
+ * its transmitted and received packets.
+ *
+ * The gap between bursts is averaged with an exponentially weighted moving
+ * average, as is its deviation, and the link is taken as periodic, as for
+ * audio or HID reports, when the gaps are short and stable enough. Packets
+ * closer than kBurstGapMs belong to the same burst, and a gap longer than
+ * kMaxPatternGapMs restarts the prediction.
+ *
+ * While the link is in sniff mode the received packets can only arrive at the
+ * sniff anchor points, so that the gaps they measure are never shorter than
+ * the sniff interval: only a transmit side period shorter than the interval
+ * can ask to leave sniff mode.
+ */
+class PowerModeTrafficPredictor {
+ public:
+  static constexpr uint64_t kBurstGapMs = 2;
+  static constexpr uint64_t kMaxPatternGapMs = 500;
+  static constexpr uint64_t kMaxPeriodMs = 100;
+  static constexpr uint32_t kMinSamples = 8;
+  /* Time without traffic after which the link is idle */
+  static constexpr uint64_t kIdleMs = 10000;
+
+  void OnPacket(uint64_t now_ms);
+
+  /* Stable period of at most kMaxPeriodMs */
+  bool IsPeriodic() const;
+  uint64_t GetPeriodMs() const { return mean_us_ / 1000; }
+  bool IsIdle(uint64_t now_ms) const;
+
+  /* Lower |*max|, in slots, to the predicted period so that the sniff anchor
+   * points follow the traffic, keeping |*max| at least |min|.
+   */
+  void AdaptSniffInterval(uint16_t min, uint16_t* max) const;
+  /* Whether a sniff |interval|, in slots, is too long for the traffic */
+  bool ShouldExitSniff(uint16_t interval) const;
+
+  std::string ToString() const;
+
+ private:
+  uint16_t GetPeriodSlots() const;
+
+  bool has_packet_ = false;
+  uint64_t burst_start_ms_ = 0;
+  uint64_t last_packet_ms_ = 0;
+  uint32_t samples_ = 0;
+  /* Moving averages of the gap between bursts and of its deviation */
+  uint64_t mean_us_ = 0;
+  uint64_t deviation_us_ = 0;
+};
@@ -34,6 +34,7 @@
 #include "btm_api.h"
 #include "l2c_api.h"
 #include "main/shim/dumpsys.h"
+#include "osi/include/allocator.h"
 #include "osi/include/log.h"
 #include "stack/btm/btm_sec.h"
 #include "stack/include/a2dp_codec_api.h"
@@ -824,6 +825,39 @@ uint16_t AVDT_SecurityRsp(uint8_t handle, uint8_t label, uint8_t error_code,
   return result;
 }
 
+/*******************************************************************************
+ *
+ * Function         AVDT_AllocMediaPacket
+ *
+ * Description      Allocate a buffer for a media packet, with the headroom
+ *                  for all the headers in front of the codec frames.
+ *
+ * Returns          The buffer, of BT_DEFAULT_BUFFER_SIZE with a zero len.
+ *
+ ******************************************************************************/
+BT_HDR* AVDT_AllocMediaPacket(uint16_t codec_hdr_len) {
+  BT_HDR* p_buf = (BT_HDR*)osi_malloc(BT_DEFAULT_BUFFER_SIZE);
+  p_buf->offset = AVDT_MEDIA_OFFSET + AVDT_MEDIA_CP_HDR_SIZE + codec_hdr_len;
+  p_buf->len = 0;
+  p_buf->layer_specific = 0;
+  return p_buf;
+}
+
+/*******************************************************************************
+ *
+ * Function         AVDT_MediaPacketPayloadSize
+ *
+ * Description      The number of bytes of codec frames a buffer allocated by
+ *                  AVDT_AllocMediaPacket() can hold.
+ *
+ * Returns          The payload size in bytes.
+ *
+ ******************************************************************************/
+uint16_t AVDT_MediaPacketPayloadSize(uint16_t codec_hdr_len) {
+  return BT_DEFAULT_BUFFER_SIZE - sizeof(BT_HDR) - AVDT_MEDIA_OFFSET -
+         AVDT_MEDIA_CP_HDR_SIZE - codec_hdr_len;
+}
+
 /*******************************************************************************
  *
  * Function         AVDT_WriteReqOpt
@@ -1085,6 +1119,8 @@ void stack_debug_avdtp_api_dump(int fd) {
       dprintf(fd, "      Current event: %d\n", scb.curr_evt);
       dprintf(fd, "      Congested: %s\n", scb.cong ? "true" : "false");
       dprintf(fd, "      Close response code: %d\n", scb.close_code);
+      dprintf(fd, "      Media packets: %u copied for headroom: %u\n",
+              scb.media_pkt_count, scb.media_pkt_copy_count);
     }
   }
 }
@@ -416,6 +416,8 @@ class AvdtpScb {
         p_pkt(nullptr),
         p_ccb(nullptr),
         media_seq(0),
+        media_pkt_count(0),
+        media_pkt_copy_count(0),
         allocated(false),
         in_use(false),
         role(0),
@@ -465,6 +467,8 @@ class AvdtpScb {
     p_pkt = nullptr;
     p_ccb = nullptr;
     media_seq = 0;
+    media_pkt_count = 0;
+    media_pkt_copy_count = 0;
     allocated = false;
     in_use = false;
     role = 0;
@@ -489,6 +493,8 @@ class AvdtpScb {
   BT_HDR* p_pkt;                     // Packet waiting to be sent
   AvdtpCcb* p_ccb;                   // CCB associated with this SCB
   uint16_t media_seq;                // Media packet sequence number
+  uint32_t media_pkt_count;          // Media packets written
+  uint32_t media_pkt_copy_count;     // Of them, copied to make headroom
   bool allocated;                    // True if the SCB is allocated
   bool in_use;                       // True if used by peer
   uint8_t role;        // Initiator/acceptor role in current procedure
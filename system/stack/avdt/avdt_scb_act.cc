@@ -38,6 +38,8 @@
 #include "osi/include/osi.h"
 #include "stack/include/bt_hdr.h"
 #include "stack/include/bt_types.h"
+#include "stack/include/hcidefs.h"
+#include "stack/include/l2cdefs.h"
 #include "types/raw_address.h"
 
 /* This table is used to lookup the callback event that matches a particular
@@ -991,6 +993,29 @@ void avdt_scb_hdl_tc_open_sto(AvdtpScb* p_scb, tAVDT_SCB_EVT* p_data) {
   }
 }
 
+/*******************************************************************************
+ *
+ * Function         avdt_scb_copy_media_pkt
+ *
+ * Description      Copy a media packet into a buffer with the room for the
+ *                  headers in front of it, then free it.
+ *
+ * Returns          The new buffer.
+ *
+ ******************************************************************************/
+static BT_HDR* avdt_scb_copy_media_pkt(BT_HDR* p_buf) {
+  BT_HDR* p_new =
+      (BT_HDR*)osi_malloc(BT_HDR_SIZE + AVDT_MEDIA_OFFSET + p_buf->len);
+  p_new->event = p_buf->event;
+  p_new->len = p_buf->len;
+  p_new->offset = AVDT_MEDIA_OFFSET;
+  p_new->layer_specific = p_buf->layer_specific;
+  memcpy((uint8_t*)(p_new + 1) + p_new->offset,
+         (uint8_t*)(p_buf + 1) + p_buf->offset, p_buf->len);
+  osi_free(p_buf);
+  return p_new;
+}
+
 /*******************************************************************************
  *
  * Function         avdt_scb_hdl_write_req
@@ -1006,6 +1031,7 @@ void avdt_scb_hdl_write_req(AvdtpScb* p_scb, tAVDT_SCB_EVT* p_data) {
   uint8_t* p;
   uint32_t ssrc;
   bool add_rtp_header = !(p_data->apiwrite.opt & AVDT_DATA_OPT_NO_RTP);
+  uint16_t headroom = L2CAP_PKT_OVERHEAD + HCI_DATA_PREAMBLE_SIZE;
 
   /* free packet we're holding, if any; to be replaced with new */
   if (p_scb->p_pkt != NULL) {
@@ -1020,6 +1046,17 @@ void avdt_scb_hdl_write_req(AvdtpScb* p_scb, tAVDT_SCB_EVT* p_data) {
     add_rtp_header =
         A2DP_UsesRtpHeader(is_content_protection, p_scb->curr_cfg.codec_info);
   }
+  if (add_rtp_header) headroom += AVDT_MEDIA_HDR_SIZE;
+
+  /* The headers are written in front of the payload; a buffer without the
+   * room for them, not made by AVDT_AllocMediaPacket(), is copied */
+  p_scb->media_pkt_count++;
+  if (p_data->apiwrite.p_buf->offset < headroom) {
+    AVDT_TRACE_WARNING("%s: media packet offset %d, copied for headroom",
+                       __func__, p_data->apiwrite.p_buf->offset);
+    p_data->apiwrite.p_buf = avdt_scb_copy_media_pkt(p_data->apiwrite.p_buf);
+    p_scb->media_pkt_copy_count++;
+  }
 
   /* Build a media packet, and add an RTP header if required. */
   if (add_rtp_header) {
@@ -23,9 +23,14 @@
  ******************************************************************************/
 
 #include <base/bind.h>
+#include <stdio.h>
 #include <string.h>
 
+#include <array>
+#include <map>
+
 #include "btm_ble_int.h"
+#include "common/time_util.h"
 #include "device/include/controller.h"
 #include "gap_api.h"
 #include "main/shim/shim.h"
@@ -113,17 +118,98 @@ bool btm_ble_init_pseudo_addr(tBTM_SEC_DEV_REC* p_dev_rec,
   return false;
 }
 
+namespace {
+
+/* The key schedules of the peer IRKs are computed once, instead of for each
+ * resolved address. Bounded in case the bonds keep changing. */
+constexpr size_t kMaxIrkKeySchedules = 256;
+std::map<Octet16, crypto_toolbox::Aes128KeySchedule> irk_key_schedules;
+
+const crypto_toolbox::Aes128KeySchedule& irk_key_schedule(const Octet16& irk) {
+  auto it = irk_key_schedules.find(irk);
+  if (it != irk_key_schedules.end()) return it->second;
+
+  if (irk_key_schedules.size() >= kMaxIrkKeySchedules)
+    irk_key_schedules.clear();
+  return irk_key_schedules
+      .emplace(irk, crypto_toolbox::aes_128_key_schedule(irk))
+      .first->second;
+}
+
+/* Recently resolved RPAs. The devices advertise with the same RPA for
+ * minutes, the ones not matching any IRK are cached too until a new IRK is
+ * stored. The entries expire after the recommended RPA rotation interval,
+ * past which the peer most likely moved to a new address. */
+struct RpaCacheEntry {
+  RawAddress rpa;
+  tBTM_SEC_DEV_REC* p_dev_rec; /* nullptr if not resolvable */
+  Octet16 irk;
+  uint64_t added_ms;
+};
+constexpr size_t kRpaCacheSize = 32;
+constexpr uint64_t kRpaCacheLifetimeMs = 15 * 60 * 1000;
+std::array<RpaCacheEntry, kRpaCacheSize> rpa_cache;
+size_t rpa_cache_next = 0;
+
+struct RpaCacheStats {
+  uint64_t hits;
+  uint64_t negative_hits;
+  uint64_t misses;
+  uint64_t expired;
+  uint64_t invalidated;
+};
+RpaCacheStats rpa_cache_stats;
+
+RpaCacheEntry* rpa_cache_find(const RawAddress& rpa) {
+  for (auto& entry : rpa_cache) {
+    if (entry.rpa == rpa) return &entry;
+  }
+  return nullptr;
+}
+
+void rpa_cache_add(const RawAddress& rpa, tBTM_SEC_DEV_REC* p_dev_rec,
+                   uint64_t now_ms) {
+  RpaCacheEntry& entry = rpa_cache[rpa_cache_next];
+  rpa_cache_next = (rpa_cache_next + 1) % kRpaCacheSize;
+  entry.rpa = rpa;
+  entry.p_dev_rec = p_dev_rec;
+  entry.added_ms = now_ms;
+  if (p_dev_rec != nullptr) entry.irk = p_dev_rec->ble.keys.irk;
+}
+
+bool has_irk(const tBTM_SEC_DEV_REC* p_dev_rec) {
+  return (p_dev_rec->device_type & BT_DEVICE_TYPE_BLE) &&
+         (p_dev_rec->ble.key_type & BTM_LE_KEY_PID);
+}
+
+/* The cached record can be removed, or its keys replaced, since the RPA was
+ * resolved */
+bool rpa_cache_entry_valid(const RpaCacheEntry& entry) {
+  if (entry.p_dev_rec == nullptr) return true;
+
+  list_node_t* end = list_end(btm_cb.sec_dev_rec);
+  for (list_node_t* node = list_begin(btm_cb.sec_dev_rec); node != end;
+       node = list_next(node)) {
+    if (list_node(node) != entry.p_dev_rec) continue;
+    return has_irk(entry.p_dev_rec) &&
+           entry.p_dev_rec->ble.keys.irk == entry.irk;
+  }
+  return false;
+}
+
+}  // namespace
+
 /* Return true if given Resolvable Privae Address |rpa| matches Identity
  * Resolving Key |irk| */
 static bool rpa_matches_irk(const RawAddress& rpa, const Octet16& irk) {
   /* use the 3 MSB of bd address as prand */
-  uint8_t rand[3];
+  Octet16 rand{0};
   rand[0] = rpa.address[2];
   rand[1] = rpa.address[1];
   rand[2] = rpa.address[0];
 
   /* generate X = E irk(R0, R1, R2) and R is random address 3 LSO */
-  Octet16 x = crypto_toolbox::aes_128(irk, &rand[0], 3);
+  Octet16 x = crypto_toolbox::aes_128(irk_key_schedule(irk), rand);
 
   rand[0] = rpa.address[5];
   rand[1] = rpa.address[4];
@@ -163,8 +249,7 @@ static bool btm_ble_match_random_bda(void* data, void* context) {
   tBTM_SEC_DEV_REC* p_dev_rec = static_cast<tBTM_SEC_DEV_REC*>(data);
   RawAddress* random_bda = static_cast<RawAddress*>(context);
 
-  if (!(p_dev_rec->device_type & BT_DEVICE_TYPE_BLE) ||
-      !(p_dev_rec->ble.key_type & BTM_LE_KEY_PID))
+  if (!has_irk(p_dev_rec))
     // Match fails preconditions
     return true;
 
@@ -183,10 +268,61 @@ static bool btm_ble_match_random_bda(void* data, void* context) {
  */
 tBTM_SEC_DEV_REC* btm_ble_resolve_random_addr(const RawAddress& random_bda) {
   if (btm_cb.sec_dev_rec == nullptr) return nullptr;
+
+  bool cacheable = !random_bda.IsEmpty() && BTM_BLE_IS_RESOLVE_BDA(random_bda);
+  uint64_t now_ms = 0;
+  if (cacheable) {
+    now_ms = bluetooth::common::time_get_os_boottime_ms();
+    RpaCacheEntry* entry = rpa_cache_find(random_bda);
+    if (entry != nullptr) {
+      if (now_ms - entry->added_ms >= kRpaCacheLifetimeMs) {
+        rpa_cache_stats.expired++;
+      } else if (!rpa_cache_entry_valid(*entry)) {
+        rpa_cache_stats.invalidated++;
+      } else {
+        if (entry->p_dev_rec != nullptr) {
+          rpa_cache_stats.hits++;
+        } else {
+          rpa_cache_stats.negative_hits++;
+        }
+        return entry->p_dev_rec;
+      }
+      entry->rpa = RawAddress::kEmpty;
+    }
+    rpa_cache_stats.misses++;
+  }
+
   list_node_t* n = list_foreach(btm_cb.sec_dev_rec, btm_ble_match_random_bda,
                                 (void*)&random_bda);
-  return (n == nullptr) ? (nullptr)
-                        : (static_cast<tBTM_SEC_DEV_REC*>(list_node(n)));
+  tBTM_SEC_DEV_REC* p_dev_rec =
+      (n == nullptr) ? (nullptr)
+                     : (static_cast<tBTM_SEC_DEV_REC*>(list_node(n)));
+  if (cacheable) rpa_cache_add(random_bda, p_dev_rec, now_ms);
+  return p_dev_rec;
+}
+
+/** This function is called when a peer IRK is stored or removed, the
+ * addresses that were not resolvable must be resolved again.
+ */
+void btm_ble_resolve_cache_clear() {
+  for (auto& entry : rpa_cache) entry.rpa = RawAddress::kEmpty;
+  irk_key_schedules.clear();
+}
+
+void btm_ble_resolve_cache_dump(int fd) {
+  const RpaCacheStats& stats = rpa_cache_stats;
+  uint64_t lookups = stats.hits + stats.negative_hits + stats.misses;
+  dprintf(fd,
+          "  RPA resolution cache: lookups:%llu hits:%llu negative_hits:%llu "
+          "misses:%llu (expired:%llu invalidated:%llu) hit_rate:%.1f%%\n",
+          static_cast<unsigned long long>(lookups),
+          static_cast<unsigned long long>(stats.hits),
+          static_cast<unsigned long long>(stats.negative_hits),
+          static_cast<unsigned long long>(stats.misses),
+          static_cast<unsigned long long>(stats.expired),
+          static_cast<unsigned long long>(stats.invalidated),
+          lookups == 0 ? 0.0
+                       : 100.0 * (stats.hits + stats.negative_hits) / lookups);
 }
 
 /*******************************************************************************
@@ -2437,16 +2437,13 @@ void btm_ble_update_inq_result(tINQ_DB_ENT* p_i, uint8_t addr_type,
  *
  ******************************************************************************/
 void btm_clear_all_pending_le_entry(void) {
-  uint16_t xx;
-  tINQ_DB_ENT* p_ent = btm_cb.btm_inq_vars.inq_db;
-
-  for (xx = 0; xx < BTM_INQ_DB_SIZE; xx++, p_ent++) {
+  for (tINQ_DB_ENT& ent : btm_cb.inq_db) {
     /* mark all pending LE entry as unused if an LE only device has scan
      * response outstanding */
-    if ((p_ent->in_use) &&
-        (p_ent->inq_info.results.device_type == BT_DEVICE_TYPE_BLE) &&
-        !p_ent->scan_rsp)
-      p_ent->in_use = false;
+    if ((ent.in_use) &&
+        (ent.inq_info.results.device_type == BT_DEVICE_TYPE_BLE) &&
+        !ent.scan_rsp)
+      btm_inq_db_remove(&ent);
   }
 }
 
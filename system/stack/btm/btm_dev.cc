@@ -39,6 +39,7 @@
 #include "osi/include/compat.h"
 #include "stack/include/acl_api.h"
 #include "stack/include/bt_octets.h"
+#include "stack/include/hcidefs.h"
 #include "types/raw_address.h"
 
 extern tBTM_CB btm_cb;
@@ -130,9 +131,33 @@ bool BTM_SecAddDevice(const RawAddress& bd_addr, DEV_CLASS dev_class,
   return true;
 }
 
+/* Entries kept in each lookup index at most. Random addresses that resolve to
+ * a record are indexed too and rotate, so the indexes are emptied when full. */
+#define BTM_SEC_DEV_REC_INDEX_MAX (4 * BTM_SEC_MAX_DEVICE_RECORDS)
+
+/* Drop every index entry pointing at |p_dev_rec|, it is about to be freed */
+static void btm_sec_dev_rec_unindex(tBTM_SEC_DEV_REC* p_dev_rec) {
+  for (auto it = btm_cb.sec_dev_rec_by_addr.begin();
+       it != btm_cb.sec_dev_rec_by_addr.end();) {
+    if (it->second == p_dev_rec)
+      it = btm_cb.sec_dev_rec_by_addr.erase(it);
+    else
+      ++it;
+  }
+  for (auto it = btm_cb.sec_dev_rec_by_handle.begin();
+       it != btm_cb.sec_dev_rec_by_handle.end();) {
+    if (it->second == p_dev_rec)
+      it = btm_cb.sec_dev_rec_by_handle.erase(it);
+    else
+      ++it;
+  }
+}
+
 void wipe_secrets_and_remove(tBTM_SEC_DEV_REC* p_dev_rec) {
   p_dev_rec->link_key.fill(0);
   memset(&p_dev_rec->ble.keys, 0, sizeof(tBTM_SEC_BLE_KEYS));
+  btm_ble_resolve_cache_clear();
+  btm_sec_dev_rec_unindex(p_dev_rec);
   list_remove(btm_cb.sec_dev_rec, p_dev_rec);
 }
 
@@ -334,8 +359,25 @@ bool is_handle_equal(void* data, void* context) {
  *
  ******************************************************************************/
 tBTM_SEC_DEV_REC* btm_find_dev_by_handle(uint16_t handle) {
+  // Handles are written straight into the records, only trust the index when
+  // the record still holds the handle.
+  auto it = btm_cb.sec_dev_rec_by_handle.find(handle);
+  if (it != btm_cb.sec_dev_rec_by_handle.end() &&
+      !is_handle_equal(it->second, &handle)) {
+    return it->second;
+  }
+
   list_node_t* n = list_foreach(btm_cb.sec_dev_rec, is_handle_equal, &handle);
-  if (n) return static_cast<tBTM_SEC_DEV_REC*>(list_node(n));
+  if (n) {
+    tBTM_SEC_DEV_REC* p_dev_rec = static_cast<tBTM_SEC_DEV_REC*>(list_node(n));
+    if (handle != HCI_INVALID_HANDLE) {
+      if (btm_cb.sec_dev_rec_by_handle.size() >= BTM_SEC_DEV_REC_INDEX_MAX) {
+        btm_cb.sec_dev_rec_by_handle.clear();
+      }
+      btm_cb.sec_dev_rec_by_handle[handle] = p_dev_rec;
+    }
+    return p_dev_rec;
+  }
 
   return NULL;
 }
@@ -365,9 +407,24 @@ bool is_address_equal(void* data, void* context) {
 tBTM_SEC_DEV_REC* btm_find_dev(const RawAddress& bd_addr) {
   if (btm_cb.sec_dev_rec == nullptr) return nullptr;
 
+  // Addresses are written straight into the records, only trust the index
+  // when the record still matches the address.
+  auto it = btm_cb.sec_dev_rec_by_addr.find(bd_addr);
+  if (it != btm_cb.sec_dev_rec_by_addr.end() &&
+      !is_address_equal(it->second, (void*)&bd_addr)) {
+    return it->second;
+  }
+
   list_node_t* n =
       list_foreach(btm_cb.sec_dev_rec, is_address_equal, (void*)&bd_addr);
-  if (n) return static_cast<tBTM_SEC_DEV_REC*>(list_node(n));
+  if (n) {
+    tBTM_SEC_DEV_REC* p_dev_rec = static_cast<tBTM_SEC_DEV_REC*>(list_node(n));
+    if (btm_cb.sec_dev_rec_by_addr.size() >= BTM_SEC_DEV_REC_INDEX_MAX) {
+      btm_cb.sec_dev_rec_by_addr.clear();
+    }
+    btm_cb.sec_dev_rec_by_addr[bd_addr] = p_dev_rec;
+    return p_dev_rec;
+  }
 
   return NULL;
 }
@@ -32,6 +32,9 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
+#include <vector>
+
 #include "advertise_data_parser.h"
 #include "common/time_util.h"
 #include "device/include/controller.h"
@@ -671,11 +674,8 @@ tBTM_INQ_INFO* BTM_InqDbRead(const RawAddress& p_bda) {
  *
  ******************************************************************************/
 tBTM_INQ_INFO* BTM_InqDbFirst(void) {
-  uint16_t xx;
-  tINQ_DB_ENT* p_ent = btm_cb.btm_inq_vars.inq_db;
-
-  for (xx = 0; xx < BTM_INQ_DB_SIZE; xx++, p_ent++) {
-    if (p_ent->in_use) return (&p_ent->inq_info);
+  for (tINQ_DB_ENT& ent : btm_cb.inq_db) {
+    if (ent.in_use) return (&ent.inq_info);
   }
 
   /* If here, no used entry found */
@@ -699,10 +699,9 @@ tBTM_INQ_INFO* BTM_InqDbNext(tBTM_INQ_INFO* p_cur) {
 
   if (p_cur) {
     p_ent = (tINQ_DB_ENT*)((uint8_t*)p_cur - offsetof(tINQ_DB_ENT, inq_info));
-    inx = (uint16_t)((p_ent - btm_cb.btm_inq_vars.inq_db) + 1);
 
-    for (p_ent = &btm_cb.btm_inq_vars.inq_db[inx]; inx < BTM_INQ_DB_SIZE;
-         inx++, p_ent++) {
+    for (inx = p_ent->db_index + 1; inx < btm_cb.inq_db.size(); inx++) {
+      p_ent = &btm_cb.inq_db[inx];
       if (p_ent->in_use) return (&p_ent->inq_info);
     }
 
@@ -885,20 +884,19 @@ void btm_inq_clear_ssp(void) {
  *
  ******************************************************************************/
 void btm_clr_inq_db(const RawAddress* p_bda) {
-  tBTM_INQUIRY_VAR_ST* p_inq = &btm_cb.btm_inq_vars;
-  tINQ_DB_ENT* p_ent = p_inq->inq_db;
-  uint16_t xx;
-
 #if (BTM_INQ_DEBUG == TRUE)
   BTM_TRACE_DEBUG("btm_clr_inq_db: inq_active:0x%x state:%d",
                   btm_cb.btm_inq_vars.inq_active, btm_cb.btm_inq_vars.state);
 #endif
-  for (xx = 0; xx < BTM_INQ_DB_SIZE; xx++, p_ent++) {
-    if (p_ent->in_use) {
-      /* If this is the specified BD_ADDR or clearing all devices */
-      if (p_bda == NULL || (p_ent->inq_info.results.remote_bd_addr == *p_bda)) {
-        p_ent->in_use = false;
-      }
+  if (p_bda != NULL) {
+    tINQ_DB_ENT* p_ent = btm_inq_db_find(*p_bda);
+    if (p_ent != NULL) btm_inq_db_remove(p_ent);
+  } else {
+    btm_cb.inq_db_by_addr.clear();
+    btm_cb.inq_db_free.clear();
+    for (tINQ_DB_ENT& ent : btm_cb.inq_db) {
+      ent.in_use = false;
+      btm_cb.inq_db_free.push_back(&ent);
     }
   }
 #if (BTM_INQ_DEBUG == TRUE)
@@ -969,57 +967,70 @@ bool btm_inq_find_bdaddr(const RawAddress& p_bda) {
  *
  ******************************************************************************/
 tINQ_DB_ENT* btm_inq_db_find(const RawAddress& p_bda) {
-  uint16_t xx;
-  tINQ_DB_ENT* p_ent = btm_cb.btm_inq_vars.inq_db;
-
-  for (xx = 0; xx < BTM_INQ_DB_SIZE; xx++, p_ent++) {
-    if (p_ent->in_use && p_ent->inq_info.results.remote_bd_addr == p_bda)
-      return (p_ent);
-  }
+  auto it = btm_cb.inq_db_by_addr.find(p_bda);
+  return (it == btm_cb.inq_db_by_addr.end()) ? NULL : it->second;
+}
 
-  /* If here, not found */
-  return (NULL);
+/*******************************************************************************
+ *
+ * Function         btm_inq_db_remove
+ *
+ * Description      This function marks an inquiry database entry as unused,
+ *                  to be reused by the next new entry.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void btm_inq_db_remove(tINQ_DB_ENT* p_ent) {
+  if (!p_ent->in_use) return;
+  btm_cb.inq_db_by_addr.erase(p_ent->inq_info.results.remote_bd_addr);
+  p_ent->in_use = false;
+  btm_cb.inq_db_free.push_back(p_ent);
 }
 
 /*******************************************************************************
  *
  * Function         btm_inq_db_new
  *
- * Description      This function looks through the inquiry database for an
- *                  unused entry. If no entry is free, it allocates the oldest
- *                  entry.
+ * Description      This function returns a cleared entry of the inquiry
+ *                  database for a device. It reuses an unused entry, or grows
+ *                  the database up to BTM_INQ_DB_MAX_MEMORY bytes. Once full,
+ *                  the entry of the device found the least recently is
+ *                  replaced.
  *
  * Returns          pointer to entry
  *
  ******************************************************************************/
 tINQ_DB_ENT* btm_inq_db_new(const RawAddress& p_bda) {
-  uint16_t xx;
-  tINQ_DB_ENT* p_ent = btm_cb.btm_inq_vars.inq_db;
-  tINQ_DB_ENT* p_old = btm_cb.btm_inq_vars.inq_db;
-  uint64_t ot = UINT64_MAX;
-
-  for (xx = 0; xx < BTM_INQ_DB_SIZE; xx++, p_ent++) {
-    if (!p_ent->in_use) {
-      memset(p_ent, 0, sizeof(tINQ_DB_ENT));
-      p_ent->inq_info.results.remote_bd_addr = p_bda;
-      p_ent->in_use = true;
-
-      return (p_ent);
-    }
+  static const size_t max_entries =
+      std::max<size_t>(1, BTM_INQ_DB_MAX_MEMORY / sizeof(tINQ_DB_ENT));
+  tINQ_DB_ENT* p_ent = btm_inq_db_find(p_bda);
 
-    if (p_ent->time_of_resp < ot) {
-      p_old = p_ent;
-      ot = p_ent->time_of_resp;
-    }
+  if (p_ent == NULL && !btm_cb.inq_db_free.empty()) {
+    p_ent = btm_cb.inq_db_free.back();
+    btm_cb.inq_db_free.pop_back();
+  } else if (p_ent == NULL && btm_cb.inq_db.size() < max_entries) {
+    btm_cb.inq_db.emplace_back();
+    p_ent = &btm_cb.inq_db.back();
+    p_ent->db_index = btm_cb.inq_db.size() - 1;
+  } else if (p_ent == NULL) {
+    /* If here, no free entry found. Replace the oldest. */
+    p_ent = &*std::min_element(
+        btm_cb.inq_db.begin(), btm_cb.inq_db.end(),
+        [](const tINQ_DB_ENT& a, const tINQ_DB_ENT& b) {
+          return a.time_of_resp < b.time_of_resp;
+        });
+    btm_cb.inq_db_by_addr.erase(p_ent->inq_info.results.remote_bd_addr);
   }
 
-  /* If here, no free entry found. Return the oldest. */
+  uint16_t db_index = p_ent->db_index;
+  memset(p_ent, 0, sizeof(tINQ_DB_ENT));
+  p_ent->db_index = db_index;
+  p_ent->inq_info.results.remote_bd_addr = p_bda;
+  p_ent->in_use = true;
+  btm_cb.inq_db_by_addr[p_bda] = p_ent;
 
-  memset(p_old, 0, sizeof(tINQ_DB_ENT));
-  p_old->inq_info.results.remote_bd_addr = p_bda;
-  p_old->in_use = true;
-
-  return (p_old);
+  return (p_ent);
 }
 
 /*******************************************************************************
@@ -1223,28 +1234,24 @@ void btm_process_inq_results(const uint8_t* p, uint8_t hci_evt_len,
  *
  ******************************************************************************/
 void btm_sort_inq_result(void) {
-  uint8_t xx, yy, num_resp;
-  tINQ_DB_ENT* p_ent = btm_cb.btm_inq_vars.inq_db;
-  tINQ_DB_ENT* p_next = btm_cb.btm_inq_vars.inq_db + 1;
-  int size;
-  tINQ_DB_ENT* p_tmp = (tINQ_DB_ENT*)osi_malloc(sizeof(tINQ_DB_ENT));
-
-  num_resp = (btm_cb.btm_inq_vars.inq_cmpl_info.num_resp < BTM_INQ_DB_SIZE)
-                 ? btm_cb.btm_inq_vars.inq_cmpl_info.num_resp
-                 : BTM_INQ_DB_SIZE;
-
-  size = sizeof(tINQ_DB_ENT);
-  for (xx = 0; xx < num_resp - 1; xx++, p_ent++) {
-    for (yy = xx + 1, p_next = p_ent + 1; yy < num_resp; yy++, p_next++) {
-      if (p_ent->inq_info.results.rssi < p_next->inq_info.results.rssi) {
-        memcpy(p_tmp, p_next, size);
-        memcpy(p_next, p_ent, size);
-        memcpy(p_ent, p_tmp, size);
-      }
-    }
+  std::vector<tINQ_DB_ENT> results;
+  for (const tINQ_DB_ENT& ent : btm_cb.inq_db) {
+    if (ent.in_use) results.push_back(ent);
+  }
+  std::stable_sort(results.begin(), results.end(),
+                   [](const tINQ_DB_ENT& a, const tINQ_DB_ENT& b) {
+                     return a.inq_info.results.rssi > b.inq_info.results.rssi;
+                   });
+
+  /* The in use entries are given the sorted results in place */
+  auto result = results.begin();
+  for (tINQ_DB_ENT& ent : btm_cb.inq_db) {
+    if (!ent.in_use) continue;
+    uint16_t db_index = ent.db_index;
+    ent = *result++;
+    ent.db_index = db_index;
+    btm_cb.inq_db_by_addr[ent.inq_info.results.remote_bd_addr] = &ent;
   }
-
-  osi_free(p_tmp);
 }
 
 /*******************************************************************************
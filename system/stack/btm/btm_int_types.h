@@ -19,15 +19,18 @@
 #define BTM_INT_TYPES_H
 
 #include <cstdint>
+#include <deque>
 #include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
-#include "gd/common/circular_buffer.h"
 #include "osi/include/allocator.h"
 #include "osi/include/fixed_queue.h"
 #include "osi/include/list.h"
 #include "stack/acl/acl.h"
 #include "stack/btm/btm_ble_int_types.h"
+#include "stack/btm/btm_log_history_buffer.h"
 #include "stack/btm/btm_sco.h"
 #include "stack/btm/neighbor_inquiry.h"
 #include "stack/btm/security_device_record.h"
@@ -38,29 +41,8 @@
 
 #define BTM_MAX_SCN_ 31  // PORT_MAX_RFC_PORTS packages/modules/Bluetooth/system/stack/include/rfcdefs.h
 
-constexpr size_t kMaxLogSize = 255;
 constexpr size_t kBtmLogHistoryBufferSize = 100;
 
-class TimestampedStringCircularBuffer
-    : public bluetooth::common::TimestampedCircularBuffer<std::string> {
- public:
-  explicit TimestampedStringCircularBuffer(size_t size)
-      : bluetooth::common::TimestampedCircularBuffer<std::string>(size) {}
-
-  void Push(std::string s) {
-    bluetooth::common::TimestampedCircularBuffer<std::string>::Push(
-        s.substr(0, kMaxLogSize));
-  }
-
-  template <typename... Args>
-  void Push(Args... args) {
-    char buf[kMaxLogSize];
-    std::snprintf(buf, sizeof(buf), args...);
-    bluetooth::common::TimestampedCircularBuffer<std::string>::Push(
-        std::string(buf));
-  }
-};
-
 /*
  * Local device configuration
  */
@@ -243,6 +225,11 @@ typedef struct tBTM_CB {
   **      Inquiry
   *****************************************************/
   tBTM_INQUIRY_VAR_ST btm_inq_vars;
+  /* Inquiry database, see btm_inq_db_new(). Entries are only released with
+   * the database, so the tBTM_INQ_INFO handed out remain valid. */
+  std::deque<tINQ_DB_ENT> inq_db;
+  std::unordered_map<RawAddress, tINQ_DB_ENT*> inq_db_by_addr;
+  std::vector<tINQ_DB_ENT*> inq_db_free;
 
   /*****************************************************
   **      SCO Management
@@ -279,6 +266,11 @@ typedef struct tBTM_CB {
   uint8_t disc_reason{0};           /* for legacy devices */
   tBTM_SEC_SERV_REC sec_serv_rec[BTM_SEC_MAX_SERVICE_RECORDS];
   list_t* sec_dev_rec{nullptr}; /* list of tBTM_SEC_DEV_REC */
+  /* Records of |sec_dev_rec| last found for an address (identity, pseudo or
+   * resolved random address) and for an ACL handle. Only hints, the record is
+   * checked against the key before it is returned, see btm_find_dev(). */
+  std::unordered_map<RawAddress, tBTM_SEC_DEV_REC*> sec_dev_rec_by_addr;
+  std::unordered_map<uint16_t, tBTM_SEC_DEV_REC*> sec_dev_rec_by_handle;
   tBTM_SEC_SERV_REC* p_out_serv{nullptr};
   tBTM_MKEY_CALLBACK* mkey_cback{nullptr};
 
@@ -308,7 +300,7 @@ typedef struct tBTM_CB {
 
   tACL_CB acl_cb_;
 
-  std::shared_ptr<TimestampedStringCircularBuffer> history_{nullptr};
+  std::shared_ptr<BtmLogHistoryBuffer> history_{nullptr};
 
   void Init(uint8_t initial_security_mode) {
     memset(&cfg, 0, sizeof(cfg));
@@ -342,6 +334,11 @@ typedef struct tBTM_CB {
     security_mode = initial_security_mode;
     pairing_bda = RawAddress::kAny;
     sec_dev_rec = list_new(osi_free);
+    sec_dev_rec_by_addr.clear();
+    sec_dev_rec_by_handle.clear();
+    inq_db.clear();
+    inq_db_by_addr.clear();
+    inq_db_free.clear();
 
     /* Initialize BTM component structures */
     btm_inq_vars.Init(); /* Inquiry Database and Structures */
@@ -349,10 +346,9 @@ typedef struct tBTM_CB {
     sco_cb.Init();       /* SCO Database and Structures (If included) */
     devcb.Init();
 
-    history_ = std::make_shared<TimestampedStringCircularBuffer>(
-        kBtmLogHistoryBufferSize);
+    history_ = std::make_shared<BtmLogHistoryBuffer>(kBtmLogHistoryBufferSize);
     CHECK(history_ != nullptr);
-    history_->Push(std::string("Initialized btm history"));
+    history_->Push("Initialized btm history");
   }
 
   void Free() {
@@ -361,6 +357,9 @@ typedef struct tBTM_CB {
     devcb.Free();
     sco_cb.Free();
     btm_inq_vars.Free();
+    inq_db.clear();
+    inq_db_by_addr.clear();
+    inq_db_free.clear();
 
     fixed_queue_free(page_queue, nullptr);
     page_queue = nullptr;
@@ -370,6 +369,8 @@ typedef struct tBTM_CB {
 
     list_free(sec_dev_rec);
     sec_dev_rec = nullptr;
+    sec_dev_rec_by_addr.clear();
+    sec_dev_rec_by_handle.clear();
 
     alarm_free(sec_collision_timer);
     sec_collision_timer = nullptr;
@@ -102,6 +102,14 @@ void IsoManager::SendIsoData(uint16_t iso_handle, const uint8_t* data,
   pimpl_->iso_impl_->send_iso_data(iso_handle, data, data_len);
 }
 
+uint8_t* IsoManager::GetIsoSduBuffer(uint16_t iso_handle, uint16_t data_len) {
+  return pimpl_->iso_impl_->get_iso_sdu_buffer(iso_handle, data_len);
+}
+
+void IsoManager::SendIsoSduBuffer(uint16_t iso_handle) {
+  pimpl_->iso_impl_->send_iso_sdu_buffer(iso_handle);
+}
+
 void IsoManager::CreateBig(uint8_t big_id,
                            struct iso_manager::big_create_params big_params) {
   pimpl_->iso_impl_->create_big(big_id, std::move(big_params));
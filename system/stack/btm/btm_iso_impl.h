@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <array>
 #include <map>
 #include <memory>
 #include <set>
@@ -26,6 +27,7 @@
 #include "base/logging.h"
 #include "bind_helpers.h"
 #include "btm_iso_api.h"
+#include "btm_iso_sdu_pool.h"
 #include "common/time_util.h"
 #include "device/include/controller.h"
 #include "hci/include/hci_layer.h"
@@ -43,6 +45,9 @@ static constexpr uint8_t kIsoDataInTsBtHdrOffset = 0x0C;
 static constexpr uint8_t kIsoHeaderWithTsLen = 12;
 static constexpr uint8_t kIsoHeaderWithoutTsLen = 8;
 
+/* Connection handles are 12 bits, up to 0x0EFF */
+static constexpr size_t kIsoHandleTableSize = 0x0F00;
+
 static constexpr uint8_t kStateFlagsNone = 0x00;
 static constexpr uint8_t kStateFlagIsConnecting = 0x01;
 static constexpr uint8_t kStateFlagIsConnected = 0x02;
@@ -79,6 +84,58 @@ struct iso_base {
 
   credits_stats cr_stats;
   event_stats evt_stats;
+
+  /* SDU handed out for the encoder to write in place, not sent yet */
+  BT_HDR* pending_sdu = nullptr;
+  uint64_t pending_sdu_us = 0;
+
+  iso_data_path_stats dp_stats;
+  bool has_tx_seq_nb = false;
+  uint16_t last_tx_seq_nb = 0;
+  bool has_rx_seq_nb = false;
+  uint16_t last_rx_seq_nb = 0;
+
+  /* Send times of the SDUs waiting for their completion, oldest first.
+   * Pushed by the sender and popped on the Number Of Completed Packets events.
+   */
+  static constexpr uint32_t kMaxSduSendTimes = 32;
+  std::array<uint64_t, kMaxSduSendTimes> sdu_send_us;
+  std::atomic_uint32_t sdu_send_head{0};
+  std::atomic_uint32_t sdu_send_tail{0};
+
+  void ResetDataPathStats() {
+    dp_stats = {};
+    has_tx_seq_nb = false;
+    has_rx_seq_nb = false;
+    sdu_send_tail = sdu_send_head.load();
+  }
+
+  void OnSduSent(uint64_t now_us) {
+    dp_stats.sent_sdus++;
+    if (used_credits > dp_stats.max_used_credits)
+      dp_stats.max_used_credits = used_credits;
+
+    uint32_t head = sdu_send_head;
+    if (head - sdu_send_tail < kMaxSduSendTimes) {
+      sdu_send_us[head % kMaxSduSendTimes] = now_us;
+      sdu_send_head = head + 1;
+    }
+  }
+
+  void OnSdusCompleted(uint16_t num_sdus, uint64_t now_us) {
+    uint32_t tail = sdu_send_tail;
+    for (; num_sdus > 0 && tail != sdu_send_head; num_sdus--, tail++) {
+      uint64_t queue_us = now_us - sdu_send_us[tail % kMaxSduSendTimes];
+      dp_stats.queue_samples++;
+      dp_stats.queue_us_total += queue_us;
+      if (queue_us > dp_stats.queue_us_max) dp_stats.queue_us_max = queue_us;
+    }
+    sdu_send_tail = tail;
+  }
+
+  ~iso_base() {
+    if (pending_sdu) GetIsoSduPool().Release(pending_sdu);
+  }
 };
 
 typedef iso_base iso_cis;
@@ -126,10 +183,12 @@ struct iso_impl {
       if (evt_code == kIsoEventCigOnReconfigureCmpl) {
         auto cis_it = conn_hdl_to_cis_map_.cbegin();
         while (cis_it != conn_hdl_to_cis_map_.cend()) {
-          if (cis_it->second->cig_id == evt.cig_id)
+          if (cis_it->second->cig_id == evt.cig_id) {
+            iso_hdl_table_[cis_it->first] = nullptr;
             cis_it = conn_hdl_to_cis_map_.erase(cis_it);
-          else
+          } else {
             ++cis_it;
+          }
         }
       }
 
@@ -145,6 +204,7 @@ struct iso_impl {
         cis->sync_info = {.first_sync_ts = 0, .seq_nb = 0};
         cis->used_credits = 0;
         cis->state_flags = kStateFlagsNone;
+        AddIsoHandle(conn_handle, cis.get());
         conn_hdl_to_cis_map_[conn_handle] = std::move(cis);
       }
     }
@@ -191,10 +251,12 @@ struct iso_impl {
     if (evt.status == HCI_SUCCESS) {
       auto cis_it = conn_hdl_to_cis_map_.cbegin();
       while (cis_it != conn_hdl_to_cis_map_.cend()) {
-        if (cis_it->second->cig_id == evt.cig_id)
+        if (cis_it->second->cig_id == evt.cig_id) {
+          iso_hdl_table_[cis_it->first] = nullptr;
           cis_it = conn_hdl_to_cis_map_.erase(cis_it);
-        else
+        } else {
           ++cis_it;
+        }
       }
     }
 
@@ -409,11 +471,8 @@ struct iso_impl {
 
     /* Add 2 for handle, 2 for length */
     uint16_t iso_full_len = iso_data_load_len + 4;
-    BT_HDR* packet = (BT_HDR*)osi_malloc(iso_full_len + sizeof(BT_HDR));
-    packet->len = iso_full_len;
-    packet->offset = 0;
+    BT_HDR* packet = GetIsoSduPool().Acquire(iso_full_len);
     packet->event = MSG_STACK_TO_HC_HCI_ISO;
-    packet->layer_specific = 0;
 
     uint8_t* packet_data = packet->data;
     UINT16_TO_STREAM(packet_data, iso_handle);
@@ -432,53 +491,103 @@ struct iso_impl {
     bte_main_hci_send(packet, MSG_STACK_TO_HC_HCI_ISO | 0x0001);
   }
 
-  void send_iso_data(uint16_t iso_handle, const uint8_t* data,
-                     uint16_t data_len) {
+  uint8_t* get_iso_sdu_buffer(uint16_t iso_handle, uint16_t data_len) {
     iso_base* iso = GetIsoIfKnown(iso_handle);
     LOG_ASSERT(iso != nullptr)
         << "No such iso connection handle: " << loghex(iso_handle);
 
+    if (iso->pending_sdu) {
+      GetIsoSduPool().Release(iso->pending_sdu);
+      iso->pending_sdu = nullptr;
+    }
+
     if (!(iso->state_flags & kStateFlagIsBroadcast)) {
       if (!(iso->state_flags & kStateFlagIsConnected)) {
         LOG(WARNING) << __func__ << "Cis handle: " << loghex(iso_handle)
                      << " not established";
-        return;
+        return nullptr;
       }
     }
 
     if (!(iso->state_flags & kStateFlagHasDataPathSet)) {
       LOG_WARN("Data path not set for handle: 0x%04x", iso_handle);
-      return;
+      return nullptr;
     }
 
     /* Calculate sequence number for the ISO data packet.
      * It should be incremented by 1 every SDU Interval.
      */
-    uint32_t ts = bluetooth::common::time_get_os_boottime_us();
+    uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
+    uint32_t ts = now_us;
     iso->sync_info.seq_nb = (ts - iso->sync_info.first_sync_ts) / iso->sdu_itv;
 
+    /* Each SDU is expected in its own SDU interval */
+    if (iso->has_tx_seq_nb) {
+      uint16_t delta = iso->sync_info.seq_nb - iso->last_tx_seq_nb;
+      if (delta == 0) {
+        iso->dp_stats.late_sdus++;
+      } else if (delta < 0x8000) {
+        iso->dp_stats.missed_intervals += delta - 1;
+      }
+    }
+    iso->has_tx_seq_nb = true;
+    iso->last_tx_seq_nb = iso->sync_info.seq_nb;
+
     if (iso_credits_ == 0 || data_len > iso_buffer_size_) {
       iso->cr_stats.credits_underflow_bytes += data_len;
       iso->cr_stats.credits_underflow_count++;
-      iso->cr_stats.credits_last_underflow_us =
-          bluetooth::common::time_get_os_boottime_us();
+      iso->cr_stats.credits_last_underflow_us = now_us;
+      iso->dp_stats.dropped_sdus++;
 
       LOG(WARNING) << __func__ << ", dropping ISO packet, len: "
                    << static_cast<int>(data_len)
                    << ", iso credits: " << static_cast<int>(iso_credits_)
                    << ", iso handle: " << loghex(iso_handle);
+      return nullptr;
+    }
+
+    iso->pending_sdu =
+        prepare_ts_hci_packet(iso_handle, ts, iso->sync_info.seq_nb, data_len);
+    iso->pending_sdu_us = now_us;
+    return iso->pending_sdu->data + kIsoDataInTsBtHdrOffset;
+  }
+
+  void send_iso_sdu_buffer(uint16_t iso_handle) {
+    iso_base* iso = GetIsoIfKnown(iso_handle);
+    LOG_ASSERT(iso != nullptr)
+        << "No such iso connection handle: " << loghex(iso_handle);
+
+    BT_HDR* packet = iso->pending_sdu;
+    if (packet == nullptr) return;
+    iso->pending_sdu = nullptr;
+
+    if (iso_credits_ == 0) {
+      iso->dp_stats.dropped_sdus++;
+      GetIsoSduPool().Release(packet);
       return;
     }
 
+    uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
+    uint64_t encode_us = now_us - iso->pending_sdu_us;
+    iso->dp_stats.encode_us_total += encode_us;
+    if (encode_us > iso->dp_stats.encode_us_max)
+      iso->dp_stats.encode_us_max = encode_us;
+
     iso_credits_--;
     iso->used_credits++;
-
-    BT_HDR* packet =
-        prepare_ts_hci_packet(iso_handle, ts, iso->sync_info.seq_nb, data_len);
-    memcpy(packet->data + kIsoDataInTsBtHdrOffset, data, data_len);
+    iso->OnSduSent(now_us);
     send_iso_data_hci_packet(packet);
   }
 
+  void send_iso_data(uint16_t iso_handle, const uint8_t* data,
+                     uint16_t data_len) {
+    uint8_t* sdu = get_iso_sdu_buffer(iso_handle, data_len);
+    if (sdu == nullptr) return;
+
+    memcpy(sdu, data, data_len);
+    send_iso_sdu_buffer(iso_handle);
+  }
+
   void process_cis_est_pkt(uint8_t len, uint8_t* data) {
     cis_establish_cmpl_evt evt;
 
@@ -492,6 +601,7 @@ struct iso_impl {
     LOG_ASSERT(cis != nullptr) << "No such cis: " << +evt.cis_conn_hdl;
 
     cis->sync_info.first_sync_ts = bluetooth::common::time_get_os_boottime_us();
+    cis->ResetDataPathStats();
 
     STREAM_TO_UINT24(evt.cig_sync_delay, data);
     STREAM_TO_UINT24(evt.cis_sync_delay, data);
@@ -529,6 +639,7 @@ struct iso_impl {
           .reason = reason,
           .cis_conn_hdl = handle,
           .cig_id = cis->cig_id,
+          .data_path_stats = cis->dp_stats,
       };
 
       cig_callbacks_->OnCisEvent(kIsoEventCisDisconnected, &evt);
@@ -537,6 +648,7 @@ struct iso_impl {
       /* return used credits */
       iso_credits_ += cis->used_credits;
       cis->used_credits = 0;
+      cis->sdu_send_tail = cis->sdu_send_head.load();
 
       /* Data path is considered still valid, but can be reconfigured only once
        * CIS is reestablished.
@@ -551,40 +663,30 @@ struct iso_impl {
 
     LOG_ASSERT(evt_len == num_handles * 4 + 1);
 
+    uint64_t now_us = bluetooth::common::time_get_os_boottime_us();
+
     for (int i = 0; i < num_handles; i++) {
       uint16_t handle, num_sent;
 
       STREAM_TO_UINT16(handle, p);
       STREAM_TO_UINT16(num_sent, p);
 
-      auto iter = conn_hdl_to_cis_map_.find(handle);
-      if (iter != conn_hdl_to_cis_map_.end()) {
-        iter->second->used_credits -= num_sent;
+      iso_base* iso = GetIsoIfKnown(handle);
+      if (iso != nullptr) {
+        iso->used_credits -= num_sent;
         iso_credits_ += num_sent;
-        continue;
-      }
-
-      iter = conn_hdl_to_bis_map_.find(handle);
-      if (iter != conn_hdl_to_bis_map_.end()) {
-        iter->second->used_credits -= num_sent;
-        iso_credits_ += num_sent;
-        continue;
+        iso->OnSdusCompleted(num_sent, now_us);
       }
     }
   }
 
   void handle_gd_num_completed_pkts(uint16_t handle, uint16_t credits) {
-    auto iter = conn_hdl_to_cis_map_.find(handle);
-    if (iter != conn_hdl_to_cis_map_.end()) {
-      iter->second->used_credits -= credits;
-      iso_credits_ += credits;
-      return;
-    }
-
-    iter = conn_hdl_to_bis_map_.find(handle);
-    if (iter != conn_hdl_to_bis_map_.end()) {
-      iter->second->used_credits -= credits;
+    iso_base* iso = GetIsoIfKnown(handle);
+    if (iso != nullptr) {
+      iso->used_credits -= credits;
       iso_credits_ += credits;
+      iso->OnSdusCompleted(credits,
+                           bluetooth::common::time_get_os_boottime_us());
     }
   }
 
@@ -627,6 +729,7 @@ struct iso_impl {
         bis->sync_info = {.first_sync_ts = ts, .seq_nb = 0};
         bis->used_credits = 0;
         bis->state_flags = kStateFlagIsBroadcast;
+        AddIsoHandle(conn_handle, bis.get());
         conn_hdl_to_bis_map_[conn_handle] = std::move(bis);
       }
     }
@@ -647,6 +750,7 @@ struct iso_impl {
     auto bis_it = conn_hdl_to_bis_map_.cbegin();
     while (bis_it != conn_hdl_to_bis_map_.cend()) {
       if (bis_it->second->big_handle == evt.big_id) {
+        iso_hdl_table_[bis_it->first] = nullptr;
         bis_it = conn_hdl_to_bis_map_.erase(bis_it);
         is_known_handle = true;
       } else {
@@ -737,6 +841,13 @@ struct iso_impl {
 
     STREAM_TO_UINT16(seq_nb, stream);
 
+    if (iso->has_rx_seq_nb) {
+      uint16_t gap = seq_nb - iso->last_rx_seq_nb - 1;
+      if (gap != 0 && gap < 0x8000) iso->dp_stats.rx_seq_nb_gaps += gap;
+    }
+    iso->has_rx_seq_nb = true;
+    iso->last_rx_seq_nb = seq_nb;
+
     uint32_t ts = bluetooth::common::time_get_os_boottime_us();
     uint32_t new_calc_seq_nb =
         (ts - iso->sync_info.first_sync_ts) / iso->sdu_itv;
@@ -772,21 +883,26 @@ struct iso_impl {
     cig_callbacks_->OnCisEvent(kIsoEventCisDataAvailable, &evt);
   }
 
-  iso_cis* GetCisIfKnown(uint16_t cis_conn_handle) {
-    auto cis_it = conn_hdl_to_cis_map_.find(cis_conn_handle);
-    return (cis_it != conn_hdl_to_cis_map_.end()) ? cis_it->second.get()
-                                                  : nullptr;
+  void AddIsoHandle(uint16_t iso_handle, iso_base* iso) {
+    LOG_ASSERT(iso_handle < kIsoHandleTableSize)
+        << "Invalid iso connection handle: " << loghex(iso_handle);
+    iso_hdl_table_[iso_handle] = iso;
   }
 
-  iso_bis* GetBisIfKnown(uint16_t bis_conn_handle) {
-    auto bis_it = conn_hdl_to_bis_map_.find(bis_conn_handle);
-    return (bis_it != conn_hdl_to_bis_map_.end()) ? bis_it->second.get()
-                                                  : nullptr;
+  iso_base* GetIsoIfKnown(uint16_t iso_handle) {
+    return (iso_handle < kIsoHandleTableSize) ? iso_hdl_table_[iso_handle]
+                                              : nullptr;
   }
 
-  iso_base* GetIsoIfKnown(uint16_t iso_handle) {
-    struct iso_base* iso = GetCisIfKnown(iso_handle);
-    return (iso != nullptr) ? iso : GetBisIfKnown(iso_handle);
+  iso_cis* GetCisIfKnown(uint16_t cis_conn_handle) {
+    iso_base* iso = GetIsoIfKnown(cis_conn_handle);
+    return (iso && !(iso->state_flags & kStateFlagIsBroadcast)) ? iso
+                                                                : nullptr;
+  }
+
+  iso_bis* GetBisIfKnown(uint16_t bis_conn_handle) {
+    iso_base* iso = GetIsoIfKnown(bis_conn_handle);
+    return (iso && (iso->state_flags & kStateFlagIsBroadcast)) ? iso : nullptr;
   }
 
   bool IsCigKnown(uint8_t cig_id) const {
@@ -836,11 +952,37 @@ struct iso_impl {
                  : 0llu));
   }
 
+  static void dump_data_path_stats(int fd, const iso_data_path_stats& stats) {
+    dprintf(fd, "        Data Path Stats:\n");
+    dprintf(fd, "          Sent SDUs (count): %zu\n", stats.sent_sdus);
+    dprintf(fd, "          Late SDUs (count): %zu\n", stats.late_sdus);
+    dprintf(fd, "          Dropped SDUs (count): %zu\n", stats.dropped_sdus);
+    dprintf(fd, "          Missed SDU intervals (count): %zu\n",
+            stats.missed_intervals);
+    dprintf(fd, "          Encode time avg/max (us): %llu/%llu\n",
+            (unsigned long long)(stats.sent_sdus > 0 ? stats.encode_us_total /
+                                                           stats.sent_sdus
+                                                     : 0),
+            (unsigned long long)stats.encode_us_max);
+    dprintf(fd, "          Controller queueing avg/max (us): %llu/%llu\n",
+            (unsigned long long)(stats.queue_samples > 0
+                                     ? stats.queue_us_total /
+                                           stats.queue_samples
+                                     : 0),
+            (unsigned long long)stats.queue_us_max);
+    dprintf(fd, "          Max. used credits: %d\n", stats.max_used_credits);
+    dprintf(fd, "          Received sequence number gaps (count): %zu\n",
+            stats.rx_seq_nb_gaps);
+  }
+
   void dump(int fd) const {
     dprintf(fd, "  ----------------\n ");
     dprintf(fd, "  ISO Manager:\n");
     dprintf(fd, "    Available credits: %d\n", iso_credits_.load());
     dprintf(fd, "    Controller buffer size: %d\n", iso_buffer_size_);
+    auto pool_stats = GetIsoSduPool().GetStats();
+    dprintf(fd, "    SDU pool hits: %zu, misses: %zu, free: %zu\n",
+            pool_stats.hits, pool_stats.misses, pool_stats.free);
     dprintf(fd, "    CISes:\n");
     for (auto const& cis_pair : conn_hdl_to_cis_map_) {
       dprintf(fd, "      CIS Connection handle: %d\n", cis_pair.first);
@@ -852,6 +994,7 @@ struct iso_impl {
               cis_pair.second->state_flags.load());
       dump_credits_stats(fd, cis_pair.second->cr_stats);
       dump_event_stats(fd, cis_pair.second->evt_stats);
+      dump_data_path_stats(fd, cis_pair.second->dp_stats);
     }
     dprintf(fd, "    BISes:\n");
     for (auto const& cis_pair : conn_hdl_to_bis_map_) {
@@ -864,6 +1007,7 @@ struct iso_impl {
               cis_pair.second->state_flags.load());
       dump_credits_stats(fd, cis_pair.second->cr_stats);
       dump_event_stats(fd, cis_pair.second->evt_stats);
+      dump_data_path_stats(fd, cis_pair.second->dp_stats);
     }
     dprintf(fd, "  ----------------\n ");
   }
@@ -871,6 +1015,9 @@ struct iso_impl {
   std::map<uint16_t, std::unique_ptr<iso_cis>> conn_hdl_to_cis_map_;
   std::map<uint16_t, std::unique_ptr<iso_bis>> conn_hdl_to_bis_map_;
 
+  /* Direct lookup of the CISes and BISes of the maps by connection handle */
+  std::array<iso_base*, kIsoHandleTableSize> iso_hdl_table_{};
+
   std::atomic_uint16_t iso_credits_;
   uint16_t iso_buffer_size_;
   uint32_t last_big_create_req_sdu_itv_;
@@ -0,0 +1,188 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stack/btm/btm_log_history_buffer.h"
+
+#include <base/strings/stringprintf.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "main/shim/dumpsys.h"
+
+namespace {
+
+/* Offsets of the null terminated fields in the text of an entry */
+constexpr size_t kTagOffset = 0;
+constexpr size_t kMsgOffset = 8;
+constexpr size_t kExtraOffset = 40;
+static_assert(kMsgOffset > BtmLogHistoryBuffer::kMaxTagLength);
+static_assert(kExtraOffset - kMsgOffset > BtmLogHistoryBuffer::kMaxMsgLength);
+static_assert(BtmLogHistoryBuffer::kTextBytes - kExtraOffset >
+              BtmLogHistoryBuffer::kMaxExtraLength);
+
+void CopyField(char* text, size_t offset, size_t max_length,
+               std::string_view field) {
+  size_t length = std::min(field.size(), max_length);
+  memcpy(text + offset, field.data(), length);
+}
+
+std::string_view GetField(const std::array<char, BtmLogHistoryBuffer::kTextBytes>& text,
+                          size_t offset, size_t max_length) {
+  return std::string_view(text.data() + offset,
+                          strnlen(text.data() + offset, max_length));
+}
+
+uint64_t PackAddress(BtmLogHistoryBuffer::AddressKind kind,
+                     const RawAddress& addr, tBLE_ADDR_TYPE type) {
+  uint64_t packed = 0;
+  for (size_t i = 0; i < RawAddress::kLength; i++) {
+    packed |= static_cast<uint64_t>(addr.address[i]) << (8 * i);
+  }
+  packed |= static_cast<uint64_t>(type) << 48;
+  packed |= static_cast<uint64_t>(kind) << 56;
+  return packed;
+}
+
+long long NowMs() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+std::string_view BtmLogHistoryBuffer::Entry::Tag() const {
+  return GetField(text, kTagOffset, kMaxTagLength);
+}
+
+std::string_view BtmLogHistoryBuffer::Entry::Msg() const {
+  return GetField(text, kMsgOffset, kMaxMsgLength);
+}
+
+std::string_view BtmLogHistoryBuffer::Entry::Extra() const {
+  return GetField(text, kExtraOffset, kMaxExtraLength);
+}
+
+std::string BtmLogHistoryBuffer::Entry::ToString() const {
+  const std::string extra(Extra());
+  switch (address_kind) {
+    case AddressKind::NONE:
+      return extra;
+    case AddressKind::RAW:
+      return base::StringPrintf("%-6s %-25s: %s %s", std::string(Tag()).c_str(),
+                                std::string(Msg()).c_str(),
+                                PRIVATE_ADDRESS(address), extra.c_str());
+    case AddressKind::BLE: {
+      const tBLE_BD_ADDR ble_bd_addr = {.type = address_type, .bda = address};
+      return base::StringPrintf("%-6s %-25s: %s %s", std::string(Tag()).c_str(),
+                                std::string(Msg()).c_str(),
+                                PRIVATE_ADDRESS(ble_bd_addr), extra.c_str());
+    }
+  }
+  return extra;
+}
+
+BtmLogHistoryBuffer::BtmLogHistoryBuffer(size_t size)
+    : size_(std::max<size_t>(size, 1)), slots_(new Slot[size_]) {}
+
+void BtmLogHistoryBuffer::Push(std::string_view tag, const RawAddress& addr,
+                               std::string_view msg, std::string_view extra) {
+  Push(tag, AddressKind::RAW, addr, BLE_ADDR_PUBLIC, msg, extra);
+}
+
+void BtmLogHistoryBuffer::Push(std::string_view tag, const tBLE_BD_ADDR& addr,
+                               std::string_view msg, std::string_view extra) {
+  Push(tag, AddressKind::BLE, addr.bda, addr.type, msg, extra);
+}
+
+void BtmLogHistoryBuffer::Push(std::string_view text) {
+  Push(std::string_view(), AddressKind::NONE, RawAddress::kEmpty,
+       BLE_ADDR_PUBLIC, std::string_view(), text);
+}
+
+void BtmLogHistoryBuffer::Push(std::string_view tag, AddressKind address_kind,
+                               const RawAddress& addr,
+                               tBLE_ADDR_TYPE address_type,
+                               std::string_view msg, std::string_view extra) {
+  char text[kTextBytes] = {};
+  CopyField(text, kTagOffset, kMaxTagLength, tag);
+  CopyField(text, kMsgOffset, kMaxMsgLength, msg);
+  CopyField(text, kExtraOffset, kMaxExtraLength, extra);
+  const long long timestamp = NowMs();
+
+  const uint64_t index = pushed_.fetch_add(1, std::memory_order_relaxed);
+  Slot& slot = slots_[index % size_];
+  uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+  // Still written by another push, or already holding a later entry
+  if ((sequence & 1) || sequence > 2 * index ||
+      !slot.sequence.compare_exchange_strong(sequence, 2 * index + 1,
+                                             std::memory_order_relaxed)) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  std::atomic_thread_fence(std::memory_order_release);
+
+  slot.timestamp.store(timestamp, std::memory_order_relaxed);
+  slot.address.store(PackAddress(address_kind, addr, address_type),
+                     std::memory_order_relaxed);
+  for (size_t i = 0; i < kTextWords; i++) {
+    uint64_t word;
+    memcpy(&word, text + i * sizeof(word), sizeof(word));
+    slot.text[i].store(word, std::memory_order_relaxed);
+  }
+  slot.sequence.store(2 * (index + 1), std::memory_order_release);
+}
+
+std::vector<BtmLogHistoryBuffer::Entry> BtmLogHistoryBuffer::Pull(
+    uint64_t* next, size_t max_entries) const {
+  const uint64_t pushed = pushed_.load(std::memory_order_acquire);
+  const uint64_t oldest = pushed > size_ ? pushed - size_ : 0;
+  if (*next < oldest) {
+    *next = oldest;
+  }
+
+  std::vector<Entry> entries;
+  while (*next < pushed && entries.size() < max_entries) {
+    const uint64_t index = (*next)++;
+    const Slot& slot = slots_[index % size_];
+    const uint64_t sequence = 2 * (index + 1);
+    if (slot.sequence.load(std::memory_order_acquire) != sequence) {
+      continue;
+    }
+
+    Entry entry;
+    entry.timestamp = slot.timestamp.load(std::memory_order_relaxed);
+    const uint64_t address = slot.address.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < kTextWords; i++) {
+      uint64_t word = slot.text[i].load(std::memory_order_relaxed);
+      memcpy(entry.text.data() + i * sizeof(word), &word, sizeof(word));
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != sequence) {
+      continue;
+    }
+
+    for (size_t i = 0; i < RawAddress::kLength; i++) {
+      entry.address.address[i] = static_cast<uint8_t>(address >> (8 * i));
+    }
+    entry.address_type = static_cast<tBLE_ADDR_TYPE>(address >> 48);
+    entry.address_kind = static_cast<AddressKind>(address >> 56);
+    entries.push_back(entry);
+  }
+  return entries;
+}
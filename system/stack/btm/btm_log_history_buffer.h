@@ -0,0 +1,110 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "types/ble_address_with_type.h"
+#include "types/raw_address.h"
+
+/* History of the connection, security and ACL events, dumped in dumpsys.
+ *
+ * The entries are kept in fixed slots, written without lock nor allocation:
+ * the tag, message and extra text are truncated to fixed lengths and the
+ * address is kept raw, the line being only formatted when the history is
+ * dumped. A push from any thread claims the next slot with an atomic
+ * increment. Each slot carries the sequence number of its entry, odd while
+ * being written, so that readers skip the entries being overwritten, and a
+ * push finding its slot still written by another one is dropped.
+ */
+class BtmLogHistoryBuffer {
+ public:
+  static constexpr size_t kMaxTagLength = 6;
+  static constexpr size_t kMaxMsgLength = 25;
+  static constexpr size_t kMaxExtraLength = 215;
+  /* Tag, message and extra text, each null terminated */
+  static constexpr size_t kTextBytes = 256;
+
+  enum class AddressKind : uint8_t { NONE, RAW, BLE };
+
+  struct Entry {
+    /* Milliseconds since the epoch */
+    long long timestamp;
+    AddressKind address_kind;
+    RawAddress address;
+    tBLE_ADDR_TYPE address_type;
+    std::array<char, kTextBytes> text;
+
+    std::string_view Tag() const;
+    std::string_view Msg() const;
+    std::string_view Extra() const;
+    /* The entry as logged, without its timestamp */
+    std::string ToString() const;
+  };
+
+  explicit BtmLogHistoryBuffer(size_t size);
+
+  void Push(std::string_view tag, const RawAddress& addr, std::string_view msg,
+            std::string_view extra);
+  void Push(std::string_view tag, const tBLE_BD_ADDR& addr,
+            std::string_view msg, std::string_view extra);
+  /* A line without tag nor address */
+  void Push(std::string_view text);
+
+  /* Return up to |max_entries| entries starting from the |*next| pushed
+   * entry, or from the oldest remaining one when it was already overwritten,
+   * and set |*next| after the last returned entry. Entries being written are
+   * skipped.
+   */
+  std::vector<Entry> Pull(uint64_t* next, size_t max_entries) const;
+
+  /* Number of entries dropped as their slot was still being written */
+  uint64_t GetDroppedCount() const {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr size_t kTextWords = kTextBytes / sizeof(uint64_t);
+
+  struct Slot {
+    /* 2 * (index + 1) once the entry |index| is written, odd while being
+     * written and 0 before the first push.
+     */
+    std::atomic<uint64_t> sequence{0};
+    std::atomic<long long> timestamp{0};
+    /* Address, address type and address kind */
+    std::atomic<uint64_t> address{0};
+    std::array<std::atomic<uint64_t>, kTextWords> text;
+  };
+
+  void Push(std::string_view tag, AddressKind address_kind,
+            const RawAddress& addr, tBLE_ADDR_TYPE address_type,
+            std::string_view msg, std::string_view extra);
+
+  const size_t size_;
+  std::unique_ptr<Slot[]> slots_;
+  /* Number of entries ever pushed */
+  std::atomic<uint64_t> pushed_{0};
+  std::atomic<uint64_t> dropped_{0};
+};
@@ -24,12 +24,13 @@
 
 #include <memory>
 #include <string>
+#include <string_view>
 
 #include "bt_target.h"
-#include "main/shim/dumpsys.h"
 #include "osi/include/log.h"
 #include "stack/btm/btm_int_types.h"
 #include "stack/include/btm_client_interface.h"
+#include "stack/include/btm_log_history.h"
 #include "stack_config.h"
 #include "types/raw_address.h"
 
@@ -60,37 +61,30 @@ void btm_free(void) {
   btm_cb.Free();
 }
 
-constexpr size_t kMaxLogHistoryTagLength = 6;
-constexpr size_t kMaxLogHistoryMsgLength = 25;
-
-static void btm_log_history(const std::string& tag, const char* addr,
-                            const std::string& msg, const std::string& extra) {
+void BTM_LogHistory(std::string_view tag, const RawAddress& bd_addr,
+                    std::string_view msg, std::string_view extra) {
   if (btm_cb.history_ == nullptr) {
     LOG_ERROR("BTM_LogHistory has not been constructed or already destroyed !");
     return;
   }
-
-  btm_cb.history_->Push(
-      "%-6s %-25s: %s %s", tag.substr(0, kMaxLogHistoryTagLength).c_str(),
-      msg.substr(0, kMaxLogHistoryMsgLength).c_str(), addr, extra.c_str());
-}
-
-void BTM_LogHistory(const std::string& tag, const RawAddress& bd_addr,
-                    const std::string& msg, const std::string& extra) {
-  btm_log_history(tag, PRIVATE_ADDRESS(bd_addr), msg, extra);
+  btm_cb.history_->Push(tag, bd_addr, msg, extra);
 }
 
-void BTM_LogHistory(const std::string& tag, const RawAddress& bd_addr,
-                    const std::string& msg) {
-  BTM_LogHistory(tag, bd_addr, msg, std::string());
+void BTM_LogHistory(std::string_view tag, const RawAddress& bd_addr,
+                    std::string_view msg) {
+  BTM_LogHistory(tag, bd_addr, msg, std::string_view());
 }
 
-void BTM_LogHistory(const std::string& tag, const tBLE_BD_ADDR& ble_bd_addr,
-                    const std::string& msg, const std::string& extra) {
-  btm_log_history(tag, PRIVATE_ADDRESS(ble_bd_addr), msg, extra);
+void BTM_LogHistory(std::string_view tag, const tBLE_BD_ADDR& ble_bd_addr,
+                    std::string_view msg, std::string_view extra) {
+  if (btm_cb.history_ == nullptr) {
+    LOG_ERROR("BTM_LogHistory has not been constructed or already destroyed !");
+    return;
+  }
+  btm_cb.history_->Push(tag, ble_bd_addr, msg, extra);
 }
 
-void BTM_LogHistory(const std::string& tag, const tBLE_BD_ADDR& ble_bd_addr,
-                    const std::string& msg) {
-  BTM_LogHistory(tag, ble_bd_addr, msg, std::string());
+void BTM_LogHistory(std::string_view tag, const tBLE_BD_ADDR& ble_bd_addr,
+                    std::string_view msg) {
+  BTM_LogHistory(tag, ble_bd_addr, msg, std::string_view());
 }
@@ -95,6 +95,9 @@ static tBTM_STATUS BTM_ChangeEScoLinkParms(uint16_t sco_inx,
                                            tBTM_CHG_ESCO_PARAMS* p_parms);
 
 static uint16_t btm_sco_voice_settings_to_legacy(enh_esco_params_t* p_parms);
+static bluetooth::audio::sco::HostCodec btm_sco_host_codec(
+    const enh_esco_params_t& params);
+static enh_esco_params_t btm_sco_hci_params(const enh_esco_params_t& params);
 
 /*******************************************************************************
  *
@@ -161,7 +164,8 @@ static void btm_esco_conn_rsp(uint16_t sco_inx, uint8_t hci_status,
           p_setup->max_latency_ms, p_setup->retransmission_effort,
           p_setup->packet_types, p_setup->input_data_path);
 
-      btsnd_hcic_enhanced_accept_synchronous_connection(bda, p_setup);
+      enh_esco_params_t params = btm_sco_hci_params(*p_setup);
+      btsnd_hcic_enhanced_accept_synchronous_connection(bda, &params);
 
     } else {
       /* Use legacy command if enhanced SCO setup is not supported */
@@ -211,9 +215,17 @@ void btm_route_sco_data(BT_HDR* p_msg) {
   }
   uint16_t handle = handle_with_flags & 0xFFF;
   ASSERT_LOG(handle <= 0xEFF, "Require handle <= 0xEFF, but is 0x%X", handle);
+  // Packet status flag per Core 5.3 Vol 4 Part E 5.4.3
+  uint8_t packet_status = (handle_with_flags >> 12) & 0x3;
   auto* active_sco = btm_get_active_sco();
-  if (active_sco != nullptr && active_sco->hci_handle == handle) {
-    // TODO: For MSBC, we need to decode here
+  bool is_active = active_sco != nullptr && active_sco->hci_handle == handle;
+  // The codec thread decodes and answers the wideband speech packets
+  if (is_active && bluetooth::audio::sco::host_codec() !=
+                       bluetooth::audio::sco::HostCodec::NONE) {
+    bluetooth::audio::sco::receive(p_msg, handle, packet_status);
+    return;
+  }
+  if (is_active) {
     bluetooth::audio::sco::write(payload, length);
   }
   osi_free(p_msg);
@@ -221,7 +233,6 @@ void btm_route_sco_data(BT_HDR* p_msg) {
   uint8_t out_buf[BTM_SCO_DATA_SIZE_MAX];
   auto size_read = bluetooth::audio::sco::read(out_buf, length);
   auto data = std::vector<uint8_t>(out_buf, out_buf + size_read);
-  // TODO: For MSBC, we need to encode here
   btm_send_sco_packet(std::move(data));
 }
 
@@ -366,7 +377,8 @@ static tBTM_STATUS btm_send_connect_request(uint16_t acl_handle,
                 << unsigned(p_setup->retransmission_effort) << ", pkt_type=0x"
                 << unsigned(p_setup->packet_types) << ", path=0x"
                 << unsigned(p_setup->input_data_path);
-      btsnd_hcic_enhanced_set_up_synchronous_connection(acl_handle, p_setup);
+      enh_esco_params_t params = btm_sco_hci_params(*p_setup);
+      btsnd_hcic_enhanced_set_up_synchronous_connection(acl_handle, &params);
       p_setup->packet_types = saved_packet_types;
       p_setup->retransmission_effort = saved_retransmission_effort;
       p_setup->max_latency_ms = saved_max_latency_ms;
@@ -775,7 +787,7 @@ void btm_sco_connected(const RawAddress& bda, uint16_t hci_handle,
 
       (*p->p_conn_cb)(xx);
 
-      bluetooth::audio::sco::open();
+      bluetooth::audio::sco::open(btm_sco_host_codec(p->esco.setup));
 
       return;
     }
@@ -1192,8 +1204,9 @@ static tBTM_STATUS BTM_ChangeEScoLinkParms(uint16_t sco_inx,
       /* Use the saved SCO routing */
       p_setup->input_data_path = p_setup->output_data_path = ESCO_DATA_PATH;
 
+      enh_esco_params_t params = btm_sco_hci_params(*p_setup);
       btsnd_hcic_enhanced_set_up_synchronous_connection(p_sco->hci_handle,
-                                                        p_setup);
+                                                        &params);
       p_setup->packet_types = saved_packet_types;
     } else { /* Use older command */
       uint16_t voice_content_format = btm_sco_voice_settings_to_legacy(p_setup);
@@ -1400,6 +1413,7 @@ static uint16_t btm_sco_voice_settings_to_legacy(enh_esco_params_t* p_params) {
       break;
 
     case ESCO_CODING_FORMAT_MSBC:
+    case ESCO_CODING_FORMAT_LC3:
       voice_settings |= HCI_AIR_CODING_FORMAT_TRANSPNT;
       break;
 
@@ -1422,3 +1436,62 @@ static uint16_t btm_sco_voice_settings_to_legacy(enh_esco_params_t* p_params) {
 
   return (voice_settings);
 }
+
+/*******************************************************************************
+ *
+ * Function         btm_sco_host_codec
+ *
+ * Description      Codec of the connection the host encodes and decodes: the
+ *                  wideband speech codecs, when the SCO data goes over HCI.
+ *
+ * Returns          the codec, NONE when the PCM goes through as it is
+ *
+ ******************************************************************************/
+static bluetooth::audio::sco::HostCodec btm_sco_host_codec(
+    const enh_esco_params_t& params) {
+  using bluetooth::audio::sco::HostCodec;
+
+  if (ESCO_DATA_PATH != ESCO_DATA_PATH_HCI) return HostCodec::NONE;
+
+  switch (params.transmit_coding_format.coding_format) {
+    case ESCO_CODING_FORMAT_MSBC:
+      return HostCodec::MSBC;
+    case ESCO_CODING_FORMAT_LC3:
+      return HostCodec::LC3_SWB;
+    default:
+      return HostCodec::NONE;
+  }
+}
+
+/*******************************************************************************
+ *
+ * Function         btm_sco_hci_params
+ *
+ * Description      Parameters of the enhanced synchronous connection commands.
+ *                  When the host encodes the audio, the controller carries the
+ *                  codec frames as transparent data both over HCI and over the
+ *                  air.
+ *
+ * Returns          the parameters to send
+ *
+ ******************************************************************************/
+static enh_esco_params_t btm_sco_hci_params(const enh_esco_params_t& params) {
+  enh_esco_params_t hci_params = params;
+
+  if (btm_sco_host_codec(params) == bluetooth::audio::sco::HostCodec::NONE)
+    return hci_params;
+
+  hci_params.transmit_coding_format.coding_format = ESCO_CODING_FORMAT_TRANSPNT;
+  hci_params.receive_coding_format.coding_format = ESCO_CODING_FORMAT_TRANSPNT;
+  hci_params.input_coding_format.coding_format = ESCO_CODING_FORMAT_TRANSPNT;
+  hci_params.output_coding_format.coding_format = ESCO_CODING_FORMAT_TRANSPNT;
+  hci_params.input_bandwidth = params.transmit_bandwidth;
+  hci_params.output_bandwidth = params.receive_bandwidth;
+  hci_params.input_coded_data_size = 8;
+  hci_params.output_coded_data_size = 8;
+  hci_params.input_pcm_data_format = ESCO_PCM_DATA_FORMAT_NA;
+  hci_params.output_pcm_data_format = ESCO_PCM_DATA_FORMAT_NA;
+  hci_params.input_pcm_payload_msb_position = 0;
+  hci_params.output_pcm_payload_msb_position = 0;
+  return hci_params;
+}
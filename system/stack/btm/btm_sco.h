@@ -20,6 +20,8 @@
 #include <string>
 
 #include "device/include/esco_parameters.h"
+#include "stack/btm/btm_sco_codec.h"
+#include "stack/include/bt_hdr.h"
 #include "stack/include/btm_api_types.h"
 
 constexpr uint16_t kMaxScoLinks = static_cast<uint16_t>(BTM_MAX_SCO_LINKS);
@@ -38,8 +40,9 @@ namespace bluetooth::audio::sco {
 // Initialize SCO-over-HCI socket (UIPC); the client is audio server.
 void init();
 
-// Open the socket when there is SCO connection open
-void open();
+// Open the socket when there is SCO connection open, the wideband speech
+// codecs being encoded and decoded by the host
+void open(HostCodec codec);
 
 // Clean up the socket when the SCO connection is done
 void cleanup();
@@ -49,6 +52,14 @@ size_t read(uint8_t* p_buf, uint32_t len);
 
 // Write to the socket from SCO Rx
 size_t write(const uint8_t* buf, uint32_t len);
+
+// Codec encoded by the host for the open connection, NONE for PCM
+HostCodec host_codec();
+
+// Hand a SCO packet received on |handle| to the codec thread, which decodes
+// it to the socket and sends back the next packet encoded from the socket.
+// Takes the ownership of p_msg.
+void receive(BT_HDR* p_msg, uint16_t handle, uint8_t packet_status);
 }  // namespace bluetooth::audio::sco
 
 /* Define the structures needed by sco
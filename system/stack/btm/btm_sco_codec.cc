@@ -0,0 +1,296 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stack/btm/btm_sco_codec.h"
+
+#include <iterator>
+
+#include "embdrv/lc3/include/lc3.h"
+#include "embdrv/sbc/decoder/include/oi_codec_sbc.h"
+#include "embdrv/sbc/encoder/include/sbc_encoder.h"
+
+namespace bluetooth::audio::sco {
+
+namespace {
+
+constexpr uint8_t kH2Sync = 0x01;
+// Second byte of the H2 header for each sequence number, its bits doubled
+constexpr uint8_t kH2Seq[] = {0x08, 0x38, 0xc8, 0xf8};
+
+constexpr int kLc3SwbSampleRate = 32000;
+
+// Gains of the concealment, Q15
+constexpr int32_t kGainOne = 1 << 15;
+
+bool is_h2_header(uint8_t b0, uint8_t b1) {
+  return b0 == kH2Sync &&
+         std::find(std::begin(kH2Seq), std::end(kH2Seq), b1) !=
+             std::end(kH2Seq);
+}
+
+}  // namespace
+
+void PacketLossConcealment::Reset(size_t frame_samples) {
+  frame_samples_ = std::min(frame_samples, kMaxFrameSamples);
+  memset(history_, 0, sizeof(history_));
+  lost_ = 0;
+  pitch_ = frame_samples_;
+  phase_ = 0;
+}
+
+// Lag between frame/3 and frame samples, 133 to 400 Hz at both rates, best
+// matching the end of the history with what came a lag before it
+size_t PacketLossConcealment::FindPitch() const {
+  const size_t min_lag = frame_samples_ / 3;
+  const size_t max_lag = frame_samples_;
+  const size_t window = frame_samples_ / 4;
+  const int16_t* p_end = history_ + kHistorySize - window;
+
+  size_t best_lag = max_lag;
+  double best_score = 0;
+  for (size_t lag = min_lag; lag <= max_lag; lag++) {
+    const int16_t* p_prev = p_end - lag;
+    int64_t corr = 0;
+    int64_t energy = 1;
+    for (size_t i = 0; i < window; i++) {
+      corr += p_end[i] * p_prev[i];
+      energy += p_prev[i] * p_prev[i];
+    }
+    if (corr <= 0) continue;
+    double score = static_cast<double>(corr) * corr / energy;
+    if (score > best_score) {
+      best_score = score;
+      best_lag = lag;
+    }
+  }
+  return best_lag;
+}
+
+void PacketLossConcealment::Extrapolate(int16_t* p_out, size_t num_samples,
+                                        int32_t gain_start, int32_t gain_end) {
+  const int16_t* p_period = history_ + kHistorySize - pitch_;
+  for (size_t i = 0; i < num_samples; i++) {
+    int32_t gain = gain_start + (gain_end - gain_start) *
+                                    static_cast<int32_t>(i) /
+                                    static_cast<int32_t>(num_samples);
+    p_out[i] = static_cast<int16_t>((p_period[phase_] * gain) >> 15);
+    phase_ = (phase_ + 1) % pitch_;
+  }
+}
+
+void PacketLossConcealment::AddHistory(const int16_t* p_pcm,
+                                       size_t num_samples) {
+  memmove(history_, history_ + num_samples,
+          (kHistorySize - num_samples) * sizeof(int16_t));
+  memcpy(history_ + kHistorySize - num_samples, p_pcm,
+         num_samples * sizeof(int16_t));
+}
+
+void PacketLossConcealment::Good(int16_t* p_pcm) {
+  if (lost_ != 0) {
+    // Cross fade from the concealed audio, at the gain it was left at
+    const size_t overlap = frame_samples_ / 4;
+    int32_t gain = lost_ < kMaxConcealedFrames
+                       ? kGainOne - kGainOne * lost_ / kMaxConcealedFrames
+                       : 0;
+    int16_t concealed[kMaxFrameSamples / 4];
+    Extrapolate(concealed, overlap, gain, gain);
+    for (size_t i = 0; i < overlap; i++) {
+      p_pcm[i] = static_cast<int16_t>(
+          (concealed[i] * static_cast<int32_t>(overlap - i) +
+           p_pcm[i] * static_cast<int32_t>(i)) /
+          static_cast<int32_t>(overlap));
+    }
+    lost_ = 0;
+  }
+  AddHistory(p_pcm, frame_samples_);
+}
+
+// The history is left with the last audio decoded, the lost frames carry on
+// with its pitch period where the previous one stopped
+void PacketLossConcealment::Conceal(int16_t* p_pcm) {
+  if (lost_ == 0) {
+    pitch_ = FindPitch();
+    phase_ = 0;
+  }
+  lost_++;
+  if (lost_ > kMaxConcealedFrames) {
+    memset(p_pcm, 0, frame_samples_ * sizeof(int16_t));
+    return;
+  }
+  Extrapolate(p_pcm, frame_samples_,
+              kGainOne - kGainOne * (lost_ - 1) / kMaxConcealedFrames,
+              kGainOne - kGainOne * lost_ / kMaxConcealedFrames);
+}
+
+struct HostCodecPath::CodecState {
+  SBC_ENC_PARAMS sbc_encoder;
+  OI_CODEC_SBC_DECODER_CONTEXT sbc_decoder;
+  uint32_t sbc_decoder_data[CODEC_DATA_WORDS(1, SBC_CODEC_FAST_FILTER_BUFFERS)];
+  lc3_encoder_t lc3_encoder;
+  lc3_decoder_t lc3_decoder;
+  LC3_ENCODER_MEM_T(kCodecFrameUs, kLc3SwbSampleRate) lc3_encoder_mem;
+  LC3_DECODER_MEM_T(kCodecFrameUs, kLc3SwbSampleRate) lc3_decoder_mem;
+  // The SBC encoder takes a non const input
+  int16_t pcm_in[kMaxFrameSamples];
+};
+
+HostCodecPath::HostCodecPath() : state_(std::make_unique<CodecState>()) {}
+
+HostCodecPath::~HostCodecPath() = default;
+
+bool HostCodecPath::Init(HostCodec codec) {
+  codec_ = HostCodec::NONE;
+  switch (codec) {
+    case HostCodec::MSBC: {
+      memset(&state_->sbc_encoder, 0, sizeof(state_->sbc_encoder));
+      state_->sbc_encoder.mSBCEnabled = TRUE;
+      SBC_Encoder_Init(&state_->sbc_encoder);
+      OI_STATUS status = OI_CODEC_mSBC_DecoderReset(
+          &state_->sbc_decoder, state_->sbc_decoder_data,
+          sizeof(state_->sbc_decoder_data));
+      if (!OI_SUCCESS(status)) return false;
+      frame_samples_ = 120;
+      break;
+    }
+    case HostCodec::LC3_SWB:
+      state_->lc3_encoder =
+          lc3_setup_encoder(kCodecFrameUs, kLc3SwbSampleRate, 0,
+                            &state_->lc3_encoder_mem);
+      state_->lc3_decoder =
+          lc3_setup_decoder(kCodecFrameUs, kLc3SwbSampleRate, 0,
+                            &state_->lc3_decoder_mem);
+      if (state_->lc3_encoder == nullptr || state_->lc3_decoder == nullptr)
+        return false;
+      frame_samples_ = lc3_frame_samples(kCodecFrameUs, kLc3SwbSampleRate);
+      break;
+    default:
+      return false;
+  }
+  codec_ = codec;
+  Reset();
+  return true;
+}
+
+void HostCodecPath::Reset() {
+  rx_ring_.Clear();
+  tx_ring_.Clear();
+  rx_total_ = rx_bad_end_ = 0;
+  rx_skipped_ = 0;
+  tx_seq_ = 0;
+  memset(pcm_, 0, sizeof(pcm_));
+  plc_.Reset(frame_samples_);
+  stats_ = {};
+}
+
+void HostCodecPath::ReceivePacket(const uint8_t* p_data, size_t len,
+                                  uint8_t packet_status) {
+  if (packet_status != kScoPacketStatusCorrect) {
+    rx_bad_end_ = rx_total_ + len;
+  }
+  // Keep the latest data when the decoding falls behind
+  if (len > rx_ring_.Room()) {
+    stats_.rx_overflow_bytes += rx_ring_.Pop(nullptr, len - rx_ring_.Room());
+  }
+  rx_ring_.Push(p_data, len);
+  rx_total_ += len;
+}
+
+const int16_t* HostCodecPath::DecodeFrame() {
+  while (rx_ring_.Size() >= kH2FrameSize) {
+    if (!is_h2_header(rx_ring_.At(0), rx_ring_.At(1))) {
+      rx_ring_.Pop(nullptr, 1);
+      stats_.sync_lost_bytes++;
+      // A frame worth of data went by without a header
+      if (++rx_skipped_ >= kH2FrameSize) {
+        rx_skipped_ = 0;
+        Conceal();
+        return pcm_;
+      }
+      continue;
+    }
+
+    rx_skipped_ = 0;
+    bool damaged = rx_total_ - rx_ring_.Size() < rx_bad_end_;
+    uint8_t frame[kH2FrameSize];
+    rx_ring_.Pop(frame, kH2FrameSize);
+    if (damaged || !Decode(frame + kH2HeaderSize)) {
+      Conceal();
+    } else {
+      stats_.frames_decoded++;
+    }
+    return pcm_;
+  }
+  return nullptr;
+}
+
+bool HostCodecPath::Decode(const uint8_t* p_frame) {
+  if (codec_ == HostCodec::LC3_SWB) {
+    return lc3_decode(state_->lc3_decoder, p_frame, kLc3SwbFrameSize,
+                      LC3_PCM_FORMAT_S16, pcm_, 1) == 0;
+  }
+
+  // The decoder would look for a syncword further into the frame
+  if (p_frame[0] != SBC_MSBC_SYNCWORD) return false;
+  const OI_BYTE* p_data = p_frame;
+  uint32_t size = kMsbcFrameSize;
+  uint32_t pcm_bytes = sizeof(pcm_);
+  OI_STATUS status = OI_CODEC_SBC_DecodeFrame(&state_->sbc_decoder, &p_data,
+                                              &size, pcm_, &pcm_bytes);
+  if (!OI_SUCCESS(status) || pcm_bytes != frame_samples_ * sizeof(int16_t)) {
+    return false;
+  }
+  plc_.Good(pcm_);
+  return true;
+}
+
+// LC3 has its own concealment, run by decoding without a frame
+void HostCodecPath::Conceal() {
+  stats_.frames_concealed++;
+  if (codec_ == HostCodec::LC3_SWB) {
+    lc3_decode(state_->lc3_decoder, nullptr, kLc3SwbFrameSize,
+               LC3_PCM_FORMAT_S16, pcm_, 1);
+  } else {
+    plc_.Conceal(pcm_);
+  }
+}
+
+void HostCodecPath::EncodeFrame(const int16_t* p_pcm) {
+  uint8_t frame[kH2FrameSize] = {kH2Sync, kH2Seq[tx_seq_]};
+  tx_seq_ = (tx_seq_ + 1) % sizeof(kH2Seq);
+
+  if (codec_ == HostCodec::LC3_SWB) {
+    lc3_encode(state_->lc3_encoder, LC3_PCM_FORMAT_S16, p_pcm, 1,
+               kLc3SwbFrameSize, frame + kH2HeaderSize);
+  } else {
+    memcpy(state_->pcm_in, p_pcm, frame_samples_ * sizeof(int16_t));
+    SBC_Encode(&state_->sbc_encoder, state_->pcm_in, frame + kH2HeaderSize);
+  }
+
+  // Drop the oldest frame when the controller does not keep up
+  if (tx_ring_.Room() < kH2FrameSize) {
+    tx_ring_.Pop(nullptr, kH2FrameSize);
+    stats_.tx_overflow_frames++;
+  }
+  tx_ring_.Push(frame, kH2FrameSize);
+  stats_.frames_encoded++;
+}
+
+size_t HostCodecPath::NextPacket(uint8_t* p_out, size_t len) {
+  return tx_ring_.Pop(p_out, len);
+}
+
+}  // namespace bluetooth::audio::sco
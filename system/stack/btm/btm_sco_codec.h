@@ -0,0 +1,190 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+// Wideband speech codecs of the SCO-over-HCI audio, for the controllers
+// without codec offload
+namespace bluetooth::audio::sco {
+
+// Codec encoded and decoded by the host
+enum class HostCodec : uint8_t {
+  NONE,     // CVSD, the PCM goes through as it is
+  MSBC,     // HFP 1.6 wideband speech, 16 kHz
+  LC3_SWB,  // HFP 1.9 super wideband speech, 32 kHz
+};
+
+// The codec frames are sent with a H2 synchronization header, HFP 1.9 5.7.4,
+// each taking 60 bytes
+constexpr size_t kH2HeaderSize = 2;
+constexpr size_t kH2FrameSize = 60;
+constexpr size_t kMsbcFrameSize = 57;
+constexpr size_t kLc3SwbFrameSize = 58;
+
+// Both codecs have 7.5 ms frames: 120 samples for mSBC, 240 for LC3-SWB
+constexpr uint32_t kCodecFrameUs = 7500;
+constexpr size_t kMaxFrameSamples = 240;
+
+// Packet status of the received SCO data, Core 5.3 Vol 4 Part E 5.4.3
+constexpr uint8_t kScoPacketStatusCorrect = 0;
+constexpr uint8_t kScoPacketStatusPossiblyInvalid = 1;
+constexpr uint8_t kScoPacketStatusNoData = 2;
+constexpr uint8_t kScoPacketStatusPartiallyLost = 3;
+
+// Byte ring of a fixed size, for the SCO data waiting to be decoded or sent
+template <size_t N>
+class ScoRing {
+ public:
+  size_t Size() const { return size_; }
+  size_t Room() const { return N - size_; }
+  void Clear() { head_ = size_ = 0; }
+
+  uint8_t At(size_t pos) const { return buf_[(head_ + pos) % N]; }
+
+  // Append up to Room() bytes, returns how many were appended
+  size_t Push(const uint8_t* p_data, size_t len) {
+    len = std::min(len, Room());
+    size_t tail = (head_ + size_) % N;
+    size_t first = std::min(len, N - tail);
+    memcpy(buf_ + tail, p_data, first);
+    memcpy(buf_, p_data + first, len - first);
+    size_ += len;
+    return len;
+  }
+
+  // Remove up to len bytes, copied to p_out unless it is nullptr
+  size_t Pop(uint8_t* p_out, size_t len) {
+    len = std::min(len, size_);
+    size_t first = std::min(len, N - head_);
+    if (p_out != nullptr) {
+      memcpy(p_out, buf_ + head_, first);
+      memcpy(p_out + first, buf_, len - first);
+    }
+    head_ = (head_ + len) % N;
+    size_ -= len;
+    return len;
+  }
+
+ private:
+  uint8_t buf_[N];
+  size_t head_ = 0;
+  size_t size_ = 0;
+};
+
+// Conceal the lost frames by repeating the last pitch period of the audio,
+// fading out as the losses go on, then cross fade back to the decoded audio.
+class PacketLossConcealment {
+ public:
+  void Reset(size_t frame_samples);
+
+  // Keep a frame decoded correctly, smoothed in place after a loss
+  void Good(int16_t* p_pcm);
+
+  // Fill in a lost frame
+  void Conceal(int16_t* p_pcm);
+
+ private:
+  static constexpr size_t kHistorySize = 2 * kMaxFrameSamples;
+  // Frames lost in a row before the audio is muted
+  static constexpr size_t kMaxConcealedFrames = 5;
+
+  size_t FindPitch() const;
+  // Repeat the pitch period, the gain going from gain_start to gain_end, Q15
+  void Extrapolate(int16_t* p_out, size_t num_samples, int32_t gain_start,
+                   int32_t gain_end);
+  void AddHistory(const int16_t* p_pcm, size_t num_samples);
+
+  size_t frame_samples_ = 0;
+  int16_t history_[kHistorySize] = {};
+  size_t lost_ = 0;
+  size_t pitch_ = 0;
+  size_t phase_ = 0;
+};
+
+// Host encoding and decoding of the SCO data. The payloads of the received SCO
+// packets are put back into codec frames then decoded, concealing the frames
+// lost or damaged; the PCM to send is encoded into the frames the next SCO
+// packets are cut from. Everything is allocated by Init().
+class HostCodecPath {
+ public:
+  struct Stats {
+    uint64_t frames_decoded;
+    uint64_t frames_concealed;
+    uint64_t frames_encoded;
+    uint64_t sync_lost_bytes;
+    uint64_t rx_overflow_bytes;
+    uint64_t tx_overflow_frames;
+  };
+
+  HostCodecPath();
+  ~HostCodecPath();
+
+  // Set up the codec, false if it is not one the host can handle
+  bool Init(HostCodec codec);
+  // Drop the data waiting to be decoded or sent
+  void Reset();
+
+  HostCodec Codec() const { return codec_; }
+  size_t FrameSamples() const { return frame_samples_; }
+  const Stats& GetStats() const { return stats_; }
+
+  // Add the payload of a received SCO packet
+  void ReceivePacket(const uint8_t* p_data, size_t len, uint8_t packet_status);
+  // Decode the next frame received, returns its FrameSamples() samples or
+  // nullptr if there is no full frame yet
+  const int16_t* DecodeFrame();
+  // Received data waiting for the rest of its frame
+  size_t RxPending() const { return rx_ring_.Size(); }
+
+  // Encode a frame of FrameSamples() samples for the next packets
+  void EncodeFrame(const int16_t* p_pcm);
+  // Encoded data waiting to be sent
+  size_t TxPending() const { return tx_ring_.Size(); }
+  // Take the payload of the next SCO packet, returns its size
+  size_t NextPacket(uint8_t* p_out, size_t len);
+
+ private:
+  static constexpr size_t kRxRingSize = 8 * kH2FrameSize;
+  static constexpr size_t kTxRingSize = 8 * kH2FrameSize;
+
+  struct CodecState;
+
+  bool Decode(const uint8_t* p_frame);
+  void Conceal();
+
+  std::unique_ptr<CodecState> state_;
+  HostCodec codec_ = HostCodec::NONE;
+  size_t frame_samples_ = 0;
+  ScoRing<kRxRingSize> rx_ring_;
+  ScoRing<kTxRingSize> tx_ring_;
+  // Bytes received, and the position up to which they may be damaged
+  uint64_t rx_total_ = 0;
+  uint64_t rx_bad_end_ = 0;
+  // Bytes dropped since the last frame, while looking for a H2 header
+  size_t rx_skipped_ = 0;
+  uint8_t tx_seq_ = 0;
+  int16_t pcm_[kMaxFrameSamples] = {};
+  PacketLossConcealment plc_;
+  Stats stats_ = {};
+};
+
+}  // namespace bluetooth::audio::sco
@@ -20,30 +20,53 @@
 
 #include <memory>
 
+#include "osi/include/allocator.h"
 #include "osi/include/log.h"
 #include "stack/btm/btm_sco.h"
 #include "udrv/include/uipc.h"
 
+#if ESCO_DATA_PATH != ESCO_DATA_PATH_PCM
+#include <base/bind.h>
+
+#include "common/message_loop_thread.h"
+#include "stack/include/bt_types.h"
+#include "stack/include/hcimsgs.h"
+#endif
+
 #if ESCO_DATA_PATH == ESCO_DATA_PATH_PCM
 // For hardware encoding path, provide an empty implementation
 
 namespace bluetooth::audio::sco {
-void open() {}
+void open(HostCodec) {}
 void cleanup() {}
 size_t read(uint8_t*, uint32_t) { return 0; }
 size_t write(const uint8_t*, uint32_t) { return 0; }
+HostCodec host_codec() { return HostCodec::NONE; }
+void receive(BT_HDR* p_msg, uint16_t, uint8_t) { osi_free(p_msg); }
 }  // namespace bluetooth::audio::sco
 #else
 
 #define SCO_DATA_READ_POLL_MS 10
+// A packet is read for each packet received: batch the reads of the socket
+#define SCO_DATA_RX_BATCH_SIZE 2048
 #define SCO_HOST_DATA_PATH "/var/run/bluetooth/audio/.sco_data"
 // TODO(b/198260375): Make SCO data owner group configurable.
 #define SCO_HOST_DATA_GROUP "bluetooth-audio"
 
 namespace {
 
+using bluetooth::audio::sco::HostCodec;
+using bluetooth::audio::sco::HostCodecPath;
+
 std::unique_ptr<tUIPC_STATE> sco_uipc = nullptr;
 
+// The wideband speech is encoded and decoded on a real time thread of its
+// own, the codec path being only used from there while the thread runs
+HostCodec host_codec_type = HostCodec::NONE;
+std::unique_ptr<HostCodecPath> host_codec_path = nullptr;
+bluetooth::common::MessageLoopThread sco_codec_thread("bt_sco_codec_thread");
+int16_t sco_codec_pcm[bluetooth::audio::sco::kMaxFrameSamples];
+
 void sco_data_cb(tUIPC_CH_ID, tUIPC_EVENT event) {
   switch (event) {
     case UIPC_OPEN_EVT:
@@ -55,19 +78,56 @@ void sco_data_cb(tUIPC_CH_ID, tUIPC_EVENT event) {
                  NULL);
       UIPC_Ioctl(*sco_uipc, UIPC_CH_ID_AV_AUDIO, UIPC_SET_READ_POLL_TMO,
                  reinterpret_cast<void*>(SCO_DATA_READ_POLL_MS));
+      UIPC_Ioctl(*sco_uipc, UIPC_CH_ID_AV_AUDIO, UIPC_SET_RX_BATCH_SIZE,
+                 reinterpret_cast<void*>(SCO_DATA_RX_BATCH_SIZE));
       break;
     default:
       break;
   }
 }
 
+// Decode the received packet to the socket, then send back a packet of the
+// same size, encoding the audio of the socket as the packets use it up
+void sco_codec_process(BT_HDR* p_msg, uint16_t handle, uint8_t packet_status) {
+  // SCO header size is 3 per Core 5.2 Vol 4 Part E 5.4.3 figure 5.3
+  uint8_t length = p_msg->data[2];
+  host_codec_path->ReceivePacket(p_msg->data + 3, length, packet_status);
+  osi_free(p_msg);
+
+  const size_t frame_bytes = host_codec_path->FrameSamples() * sizeof(int16_t);
+  while (const int16_t* p_pcm = host_codec_path->DecodeFrame()) {
+    UIPC_Send(*sco_uipc, UIPC_CH_ID_AV_AUDIO, 0,
+              reinterpret_cast<const uint8_t*>(p_pcm), frame_bytes);
+  }
+
+  while (host_codec_path->TxPending() < length) {
+    uint8_t* p_pcm = reinterpret_cast<uint8_t*>(sco_codec_pcm);
+    size_t pcm_bytes =
+        UIPC_Read(*sco_uipc, UIPC_CH_ID_AV_AUDIO, p_pcm, frame_bytes);
+    // The audio server fell behind, send silence for what is missing
+    memset(p_pcm + pcm_bytes, 0, frame_bytes - pcm_bytes);
+    host_codec_path->EncodeFrame(sco_codec_pcm);
+  }
+
+  BT_HDR* p_buf = (BT_HDR*)osi_malloc(BT_HDR_SIZE + 3 + length);
+  p_buf->event = BT_EVT_TO_LM_HCI_SCO;
+  p_buf->len = 3 + length;
+  p_buf->offset = 0;
+  p_buf->layer_specific = 0;
+  uint8_t* payload = p_buf->data;
+  UINT16_TO_STREAM(payload, handle);
+  UINT8_TO_STREAM(payload, length);
+  host_codec_path->NextPacket(payload, length);
+  bte_main_hci_send(p_buf, BT_EVT_TO_LM_HCI_SCO);
+}
+
 }  // namespace
 
 namespace bluetooth {
 namespace audio {
 namespace sco {
 
-void open() {
+void open(HostCodec codec) {
   if (sco_uipc != nullptr) {
     LOG_WARN("Re-opening UIPC that is already running");
   }
@@ -81,9 +141,43 @@ void open() {
       LOG_ERROR("%s failed: %s", __func__, strerror(errno));
     }
   }
+
+  host_codec_type = HostCodec::NONE;
+  if (codec == HostCodec::NONE) {
+    return;
+  }
+  if (host_codec_path == nullptr) {
+    host_codec_path = std::make_unique<HostCodecPath>();
+  }
+  if (!host_codec_path->Init(codec)) {
+    LOG_ERROR("Unable to set up the host codec %hhu",
+              static_cast<uint8_t>(codec));
+    return;
+  }
+  sco_codec_thread.StartUp();
+  if (!sco_codec_thread.EnableRealTimeScheduling()) {
+    LOG_WARN("Unable to make the SCO codec thread real time");
+  }
+  host_codec_type = codec;
 }
 
 void cleanup() {
+  // Runs the packets still queued before the socket goes away
+  if (sco_codec_thread.IsRunning()) {
+    sco_codec_thread.ShutDown();
+    const auto& stats = host_codec_path->GetStats();
+    LOG_INFO(
+        "SCO codec frames decoded:%llu concealed:%llu encoded:%llu, lost "
+        "sync:%llu bytes, dropped rx:%llu bytes tx:%llu frames",
+        (unsigned long long)stats.frames_decoded,
+        (unsigned long long)stats.frames_concealed,
+        (unsigned long long)stats.frames_encoded,
+        (unsigned long long)stats.sync_lost_bytes,
+        (unsigned long long)stats.rx_overflow_bytes,
+        (unsigned long long)stats.tx_overflow_frames);
+  }
+  host_codec_type = HostCodec::NONE;
+
   if (sco_uipc == nullptr) {
     return;
   }
@@ -107,6 +201,17 @@ size_t write(const uint8_t* p_buf, uint32_t len) {
   return UIPC_Send(*sco_uipc, UIPC_CH_ID_AV_AUDIO, 0, p_buf, len);
 }
 
+HostCodec host_codec() { return host_codec_type; }
+
+void receive(BT_HDR* p_msg, uint16_t handle, uint8_t packet_status) {
+  if (host_codec_type == HostCodec::NONE ||
+      !sco_codec_thread.DoInThread(
+          FROM_HERE,
+          base::BindOnce(&sco_codec_process, p_msg, handle, packet_status))) {
+    osi_free(p_msg);
+  }
+}
+
 }  // namespace sco
 }  // namespace audio
 }  // namespace bluetooth
@@ -36,6 +36,7 @@
 #include "btif/include/btif_config.h"
 #include "common/metrics.h"
 #include "device/include/controller.h"
+#include "main/shim/hci_command.h"
 #include "main/shim/hci_layer.h"
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
@@ -338,6 +339,16 @@ void btu_hcif_process_event(UNUSED_ATTR uint8_t controller_id,
       STREAM_TO_UINT8(ble_sub_code, p);
 
       uint8_t ble_evt_len = hci_evt_len - 1;
+      // validate sub-event size, so that the handlers can read the fixed
+      // parameters without checking the length again
+      if (ble_sub_code < sizeof(hci_le_subevent_parameters_minimum_length) &&
+          ble_evt_len <
+              hci_le_subevent_parameters_minimum_length[ble_sub_code]) {
+        HCI_TRACE_WARNING("%s: sub_evt:0x%2X, malformed event of size %hhd",
+                          __func__, ble_sub_code, ble_evt_len);
+        return;
+      }
+
       switch (ble_sub_code) {
         case HCI_BLE_ADV_PKT_RPT_EVT: /* result of inquiry */
           btm_ble_process_adv_pkt(ble_evt_len, p);
@@ -715,6 +726,34 @@ void btu_hcif_send_cmd(UNUSED_ATTR uint8_t controller_id, const BT_HDR* p_buf) {
       vsc_callback);
 }
 
+/*******************************************************************************
+ *
+ * Function         btu_hcif_send_cmd
+ *
+ * Description      This function is called to send commands built in place
+ *                  to the Host Controller. Vendor specific commands, which
+ *                  carry their callback after the BT_HDR, use the BT_HDR
+ *                  version.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void btu_hcif_send_cmd(
+    UNUSED_ATTR uint8_t controller_id,
+    std::unique_ptr<bluetooth::shim::LegacyCommandBuilder> command) {
+  uint16_t opcode = command->GetOpcode();
+  CHECK((opcode & HCI_GRP_VENDOR_SPECIFIC) != HCI_GRP_VENDOR_SPECIFIC &&
+        opcode != HCI_BLE_RAND && opcode != HCI_BLE_ENCRYPT)
+      << "Command 0x" << loghex(opcode) << " needs its callback";
+
+  btu_hcif_log_command_metrics(opcode, command->GetParameters(),
+                               android::bluetooth::hci::STATUS_UNKNOWN, false);
+
+  bluetooth::shim::hci_layer_transmit_command(
+      std::move(command), btu_hcif_command_complete_evt,
+      btu_hcif_command_status_evt, nullptr);
+}
+
 using hci_cmd_cb = base::OnceCallback<void(
     uint8_t* /* return_parameters */, uint16_t /* return_parameters_length*/)>;
 
@@ -35,6 +35,7 @@
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
+#include "osi/include/properties.h"
 #include "stack/include/acl_hci_link_interface.h"
 #include "stack/include/bt_hdr.h"
 #include "stack/include/btu.h"
@@ -49,6 +50,13 @@ uint8_t btu_trace_level = HCI_INITIAL_TRACE_LEVEL;
 
 static MessageLoopThread main_thread("bt_main_thread", true);
 
+// Instrument the tasks of the main thread, and log the ones that waited longer
+// than the queueing delay alarm when it is set
+static const char kMainThreadTaskStatsProperty[] =
+    "persist.bluetooth.main_thread_task_stats";
+static const char kMainThreadQueueingDelayAlarmProperty[] =
+    "persist.bluetooth.main_thread_queueing_delay_alarm_ms";
+
 void btu_hci_msg_process(BT_HDR* p_msg) {
   /* Determine the input message type. */
   switch (p_msg->event & BT_EVT_MASK) {
@@ -107,6 +115,16 @@ bt_status_t do_in_main_thread_delayed(const base::Location& from_here,
   return BT_STATUS_SUCCESS;
 }
 
+bt_status_t do_in_main_thread_with_priority(
+    const base::Location& from_here, base::OnceClosure task,
+    MessageLoopThread::Priority priority) {
+  if (!main_thread.DoInThread(from_here, std::move(task), priority)) {
+    LOG(ERROR) << __func__ << ": failed from " << from_here.ToString();
+    return BT_STATUS_FAIL;
+  }
+  return BT_STATUS_SUCCESS;
+}
+
 static void do_post_on_bt_main(BtMainClosure closure) { closure(); }
 
 void post_on_bt_main(BtMainClosure closure) {
@@ -120,6 +138,10 @@ void main_thread_start_up() {
   if (!main_thread.IsRunning()) {
     LOG(FATAL) << __func__ << ": unable to start btu message loop thread.";
   }
+  if (osi_property_get_bool(kMainThreadTaskStatsProperty, false)) {
+    main_thread.EnableTaskStats(std::chrono::milliseconds(
+        osi_property_get_int32(kMainThreadQueueingDelayAlarmProperty, 0)));
+  }
   if (!main_thread.EnableRealTimeScheduling()) {
 #if defined(OS_ANDROID)
     LOG(FATAL) << __func__ << ": unable to enable real time scheduling";
@@ -21,7 +21,6 @@
 
 #include <algorithm>
 
-#include "stack/crypto_toolbox/aes.h"
 #include "stack/include/bt_octets.h"
 
 using base::HexEncode;
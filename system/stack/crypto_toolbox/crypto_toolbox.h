@@ -18,14 +18,18 @@
 #include <base/logging.h>
 
 #include "check.h"
+#include "gd/crypto_toolbox/aes_cmac.h"
 #include "stack/include/bt_octets.h"
 #include "stack/include/bt_types.h"
 
 namespace crypto_toolbox {
 
-extern Octet16 aes_128(const Octet16& key, const Octet16& message);
-extern Octet16 aes_cmac(const Octet16& key, const uint8_t* message,
-                        uint16_t length);
+/* AES-128 and AES-CMAC, shared with the GD stack */
+using bluetooth::crypto::Aes128KeySchedule;
+using bluetooth::crypto::aes_128;
+using bluetooth::crypto::aes_128_key_schedule;
+using bluetooth::crypto::aes_cmac;
+
 extern Octet16 f4(const uint8_t* u, const uint8_t* v, const Octet16& x,
                   uint8_t z);
 extern void f5(const uint8_t* w, const Octet16& n1, const Octet16& n2,
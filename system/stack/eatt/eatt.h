@@ -55,6 +55,7 @@ class EattChannel {
   alarm_t* ind_confirmation_timer_;
   /* GATT client command queue */
   std::queue<tGATT_CMD_Q> cl_cmd_q_;
+  tGATT_CL_CMD_STATS cl_cmd_stats_;
 
   EattChannel(RawAddress& bda, uint16_t cid, uint16_t tx_mtu, uint16_t rx_mtu)
       : bda_(bda),
@@ -270,6 +271,13 @@ class EattExtension {
    */
   virtual void StopAppIndicationTimer(const RawAddress& bd_addr, uint16_t cid);
 
+  /**
+   * Dump the client command queues of the EATT channels.
+   *
+   * @param fd file descriptor to write to
+   */
+  virtual void Dump(int fd);
+
   /**
    * Starts the EattExtension module
    */
@@ -679,14 +679,36 @@ struct eatt_impl {
     eatt_device* eatt_dev = find_device_by_address(bd_addr);
     if (!eatt_dev) return nullptr;
 
-    auto iter = find_if(
-        eatt_dev->eatt_channels.begin(), eatt_dev->eatt_channels.end(),
-        [](const std::pair<uint16_t, std::shared_ptr<EattChannel>>& el) {
-          return el.second->cl_cmd_q_.empty();
-        });
+    /* The connected channel with the fewest client commands queued, the first
+     * idle one if any */
+    EattChannel* least_busy = nullptr;
+    for (const auto& el : eatt_dev->eatt_channels) {
+      EattChannel* channel = el.second.get();
+      if (channel->state_ == EattChannelState::EATT_CHANNEL_PENDING) continue;
+      if (least_busy == nullptr ||
+          channel->cl_cmd_q_.size() < least_busy->cl_cmd_q_.size()) {
+        least_busy = channel;
+        if (channel->cl_cmd_q_.empty()) break;
+      }
+    }
+    return least_busy;
+  }
 
-    return (iter == eatt_dev->eatt_channels.end()) ? nullptr
-                                                   : iter->second.get();
+  void dump(int fd) {
+    for (const eatt_device& eatt_dev : devices_) {
+      if (eatt_dev.eatt_channels.empty()) continue;
+
+      dprintf(fd, "  %s EATT channels:\n", eatt_dev.bda_.ToString().c_str());
+      for (const auto& el : eatt_dev.eatt_channels) {
+        const EattChannel* channel = el.second.get();
+        const tGATT_CL_CMD_STATS& stats = channel->cl_cmd_stats_;
+        dprintf(fd,
+                "    cid: 0x%04x, tx mtu: %d, queued: %zu, commands: %u, "
+                "queued behind: %u, max depth: %d\n",
+                channel->cid_, channel->tx_mtu_, channel->cl_cmd_q_.size(),
+                stats.commands, stats.queued_behind, stats.max_depth);
+      }
+    }
   }
 
   void free_gatt_resources(const RawAddress& bd_addr) {
@@ -27,6 +27,7 @@
 #include <base/strings/string_number_conversions.h>
 #include <stdio.h>
 
+#include <algorithm>
 #include <string>
 
 #include "bt_target.h"
@@ -134,6 +135,7 @@ static void gatt_update_last_srv_info() {
 /** Update database hash and client status */
 static void gatt_update_for_database_change() {
   gatt_cb.database_hash = gatts_calculate_database_hash(gatt_cb.srv_list_info);
+  gatt_sr_clear_rsp_cache();
 
   uint8_t i = 0;
   for (i = 0; i < GATT_MAX_PHY_CHANNEL; i++) {
@@ -285,17 +287,8 @@ tGATT_STATUS GATTS_AddService(tGATT_IF gatt_if, btgatt_db_element_t* service,
 
   /*this is a new application service start */
 
-  // find a place for this service in the list
-  auto lst_ptr = gatt_cb.srv_list_info;
-  auto it = lst_ptr->begin();
-  for (; it != lst_ptr->end(); it++) {
-    if (list.asgn_range.s_handle < it->s_hdl) break;
-  }
-  auto rit = lst_ptr->emplace(it);
-
-  tGATT_SRV_LIST_ELEM& elem = *rit;
+  tGATT_SRV_LIST_ELEM& elem = gatt_sr_add_srv(list.asgn_range.s_handle);
   elem.gatt_if = gatt_if;
-  elem.s_hdl = list.asgn_range.s_handle;
   elem.e_hdl = list.asgn_range.e_handle;
   elem.p_db = &list.svc_db;
   elem.is_primary = list.asgn_range.is_primary;
@@ -416,7 +409,7 @@ void GATTS_StopService(uint16_t service_handle) {
     SDP_DeleteRecord(it->sdp_handle);
   }
 
-  gatt_cb.srv_list_info->erase(it);
+  gatt_sr_remove_srv(it);
   gatt_update_last_srv_info();
 }
 /*******************************************************************************
@@ -616,6 +609,158 @@ tGATT_STATUS GATTS_HandleValueNotification(uint16_t conn_id,
   return cmd_sent;
 }
 
+/* Build the PDU notifying the values [first, last), as a Multiple Handle Value
+ * Notification when there are several of them */
+static BT_HDR* gatt_build_notif(uint16_t payload_size,
+                                const std::vector<tGATTS_NOTIF_VALUE>& values,
+                                size_t first, size_t last) {
+  BT_HDR* p_buf =
+      (BT_HDR*)osi_malloc(sizeof(BT_HDR) + payload_size + L2CAP_MIN_OFFSET);
+  uint8_t* p = (uint8_t*)(p_buf + 1) + L2CAP_MIN_OFFSET;
+  p_buf->offset = L2CAP_MIN_OFFSET;
+
+  if (last - first == 1) {
+    /* ensure data not exceed MTU size */
+    uint16_t len = std::min<uint16_t>(values[first].len, payload_size - 3);
+    UINT8_TO_STREAM(p, GATT_HANDLE_VALUE_NOTIF);
+    UINT16_TO_STREAM(p, values[first].handle);
+    ARRAY_TO_STREAM(p, values[first].p_value, len);
+    p_buf->len = 3 + len;
+    return p_buf;
+  }
+
+  UINT8_TO_STREAM(p, GATT_HANDLE_MULTI_VALUE_NOTIF);
+  p_buf->len = 1;
+  for (size_t i = first; i < last; i++) {
+    UINT16_TO_STREAM(p, values[i].handle);
+    UINT16_TO_STREAM(p, values[i].len);
+    ARRAY_TO_STREAM(p, values[i].p_value, values[i].len);
+    p_buf->len += 4 + values[i].len;
+  }
+  return p_buf;
+}
+
+/* Build the PDUs notifying all the values, packing as many of them as fit in
+ * each Multiple Handle Value Notification if |multi| */
+static std::vector<BT_HDR*> gatt_build_notifs(
+    uint16_t payload_size, bool multi,
+    const std::vector<tGATTS_NOTIF_VALUE>& values) {
+  std::vector<BT_HDR*> pdus;
+  size_t first = 0;
+  while (first < values.size()) {
+    size_t last = first + 1;
+    if (multi) {
+      size_t len = 1 + 4 + values[first].len;
+      while (last < values.size() &&
+             len + 4 + values[last].len <= payload_size) {
+        len += 4 + values[last].len;
+        last++;
+      }
+    }
+    pdus.push_back(gatt_build_notif(payload_size, values, first, last));
+    first = last;
+  }
+  return pdus;
+}
+
+/*******************************************************************************
+ *
+ * Function         GATTS_HandleMultipleValueNotification
+ *
+ * Description      This function sends the same attribute values as
+ *                  notifications to several clients.
+ *
+ * Parameter        conn_ids: connection identifiers of the clients.
+ *                  values: attribute values to notify.
+ *
+ * Returns          the status of each connection, in the order of conn_ids,
+ *                  GATT_SUCCESS if sucessfully sent; otherwise error code.
+ *
+ ******************************************************************************/
+std::vector<tGATT_STATUS> GATTS_HandleMultipleValueNotification(
+    const std::vector<uint16_t>& conn_ids,
+    const std::vector<tGATTS_NOTIF_VALUE>& values) {
+  std::vector<tGATT_STATUS> statuses(conn_ids.size(), GATT_SUCCESS);
+
+  VLOG(1) << __func__ << ": clients=" << conn_ids.size()
+          << ", values=" << values.size();
+
+  for (const tGATTS_NOTIF_VALUE& value : values) {
+    if (!GATT_HANDLE_IS_VALID(value.handle)) {
+      std::fill(statuses.begin(), statuses.end(), GATT_ILLEGAL_PARAMETER);
+      return statuses;
+    }
+  }
+  if (values.empty()) return statuses;
+
+  /* The clients with the same payload size and Multiple Handle Value
+   * Notification support get the same PDUs */
+  struct notif_class {
+    uint16_t payload_size;
+    bool multi;
+    std::vector<BT_HDR*> pdus;
+    size_t last_client;
+  };
+  struct notif_client {
+    tGATT_TCB* p_tcb;
+    uint16_t cid;
+    size_t class_idx;
+  };
+  std::vector<notif_class> classes;
+  std::vector<notif_client> clients(conn_ids.size());
+
+  for (size_t i = 0; i < conn_ids.size(); i++) {
+    tGATT_REG* p_reg = gatt_get_regcb(GATT_GET_GATT_IF(conn_ids[i]));
+    tGATT_TCB* p_tcb = gatt_get_tcb_by_idx(GATT_GET_TCB_IDX(conn_ids[i]));
+    if ((p_reg == NULL) || (p_tcb == NULL)) {
+      LOG(ERROR) << __func__ << ": Unknown conn_id=" << loghex(conn_ids[i]);
+      statuses[i] = (tGATT_STATUS)GATT_INVALID_CONN_ID;
+      continue;
+    }
+
+    uint16_t cid = gatt_tcb_get_att_cid(*p_tcb, p_reg->eatt_support);
+    uint16_t payload_size = gatt_tcb_get_payload_size_tx(*p_tcb, cid);
+    bool multi = values.size() > 1 &&
+                 gatt_sr_is_cl_multi_variable_len_notif_supported(*p_tcb);
+
+    size_t class_idx = 0;
+    while (class_idx < classes.size() &&
+           (classes[class_idx].payload_size != payload_size ||
+            classes[class_idx].multi != multi)) {
+      class_idx++;
+    }
+    if (class_idx == classes.size()) {
+      classes.push_back(
+          {.payload_size = payload_size,
+           .multi = multi,
+           .pdus = gatt_build_notifs(payload_size, multi, values)});
+    }
+    classes[class_idx].last_client = i;
+    clients[i] = {.p_tcb = p_tcb, .cid = cid, .class_idx = class_idx};
+  }
+
+  for (size_t i = 0; i < conn_ids.size(); i++) {
+    if (clients[i].p_tcb == NULL) continue;
+
+    const notif_class& notif = classes[clients[i].class_idx];
+    for (BT_HDR* p_pdu : notif.pdus) {
+      /* L2CAP takes the buffers sent, the last client of the class gets the
+       * ones built and the others a copy */
+      BT_HDR* p_buf = p_pdu;
+      if (i != notif.last_client) {
+        size_t size = sizeof(BT_HDR) + p_pdu->offset + p_pdu->len;
+        p_buf = (BT_HDR*)osi_malloc(size);
+        memcpy(p_buf, p_pdu, size);
+      }
+
+      tGATT_STATUS status =
+          attp_send_sr_msg(*clients[i].p_tcb, clients[i].cid, p_buf);
+      if (statuses[i] == GATT_SUCCESS) statuses[i] = status;
+    }
+  }
+  return statuses;
+}
+
 /*******************************************************************************
  *
  * Function         GATTS_SendRsp
@@ -800,6 +945,28 @@ tGATT_STATUS GATTC_Discover(uint16_t conn_id, tGATT_DISC_TYPE disc_type,
                         Uuid::kEmpty);
 }
 
+/*******************************************************************************
+ *
+ * Function         GATTC_IsReadMultiVarLenSupported
+ *
+ * Description      This function is called to check if the server supports the
+ *                  Read Multiple Variable Length request. The request is
+ *                  mandatory for the servers supporting EATT.
+ *
+ * Parameters       conn_id: connection identifier.
+ *
+ * Returns          true if the request can be sent to the server.
+ *
+ ******************************************************************************/
+bool GATTC_IsReadMultiVarLenSupported(uint16_t conn_id) {
+  uint8_t tcb_idx = GATT_GET_TCB_IDX(conn_id);
+  tGATT_TCB* p_tcb = gatt_get_tcb_by_idx(tcb_idx);
+
+  if (p_tcb == NULL || p_tcb->transport != BT_TRANSPORT_LE) return false;
+
+  return gatt_profile_get_eatt_support(p_tcb->peer_bda);
+}
+
 /*******************************************************************************
  *
  * Function         GATTC_Read
@@ -864,6 +1031,9 @@ tGATT_STATUS GATTC_Read(uint16_t conn_id, tGATT_READ_TYPE type,
           (tGATT_READ_MULTI*)osi_malloc(sizeof(tGATT_READ_MULTI));
       p_clcb->p_attr_buf = (uint8_t*)p_read_multi;
       memcpy(p_read_multi, &p_read->read_multiple, sizeof(tGATT_READ_MULTI));
+      if (p_read_multi->variable_len) {
+        p_clcb->op_subtype = GATT_READ_MULTIPLE_VAR_LEN;
+      }
       break;
     }
     case GATT_READ_BY_HANDLE:
@@ -33,6 +33,7 @@
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
+#include "osi/include/properties.h"
 #include "stack/eatt/eatt.h"
 #include "stack/include/bt_types.h"
 #include "types/bluetooth/uuid.h"
@@ -61,6 +62,16 @@ using bluetooth::eatt::EattChannel;
  *                      G L O B A L      G A T T       D A T A                 *
  ******************************************************************************/
 void gatt_send_prepare_write(tGATT_TCB& tcb, tGATT_CLCB* p_clcb);
+static void gatt_send_prepare_write_window(tGATT_TCB& tcb,
+                                           tGATT_CLCB* p_clcb);
+
+/* Whether the prepare writes of a long write may be sent over several EATT
+ * bearers at once */
+static bool gatt_prep_write_pipelining_enabled() {
+  static const bool enabled = osi_property_get_bool(
+      "bluetooth.gatt.prepare_write_pipelining.enabled", false);
+  return enabled;
+}
 
 uint8_t disc_type_to_att_opcode[GATT_DISC_MAX] = {
     0,
@@ -265,6 +276,12 @@ void gatt_act_write(tGATT_CLCB* p_clcb, uint8_t sec_act) {
           gatt_end_operation(p_clcb, rt, NULL);
         }
 
+      } else if (tcb.eatt && p_clcb->p_reg && p_clcb->p_reg->eatt_support &&
+                 gatt_prep_write_pipelining_enabled()) {
+        /* prepare writes for long attribute, one per idle bearer */
+        p_clcb->prep_write_pipelined = true;
+        p_clcb->num_prep_writes = 0;
+        gatt_send_prepare_write_window(tcb, p_clcb);
       } else {
         /* prepare write for long attribute */
         gatt_send_prepare_write(tcb, p_clcb);
@@ -378,6 +395,128 @@ void gatt_send_prepare_write(tGATT_TCB& tcb, tGATT_CLCB* p_clcb) {
   }
 }
 
+/*******************************************************************************
+ *
+ * Function         gatt_prep_write_rsp_matches
+ *
+ * Description      Check that a prepare write response echoes the part of the
+ *                  attribute value sent by the prepare write.
+ *
+ * Returns          true if the response matches the request.
+ *
+ ******************************************************************************/
+bool gatt_prep_write_rsp_matches(const tGATT_VALUE& attr,
+                                 const tGATT_PREP_WRITE& prep_write,
+                                 const tGATT_VALUE& rsp) {
+  return rsp.handle == attr.handle && rsp.offset == prep_write.offset &&
+         rsp.len == prep_write.len &&
+         prep_write.offset + prep_write.len <= attr.len &&
+         !memcmp(rsp.value, attr.value + prep_write.offset, rsp.len);
+}
+
+/* Idle bearer to send the next prepare write on, or 0 if all are busy */
+static uint16_t gatt_prep_write_idle_cid(tGATT_TCB& tcb) {
+  if (!gatt_tcb_is_cid_busy(tcb, tcb.att_lcid)) return tcb.att_lcid;
+
+  /* The least busy channel is an idle one when there is any */
+  EattChannel* channel =
+      EattExtension::GetInstance()->GetChannelAvailableForClientRequest(
+          tcb.peer_bda);
+  if (channel && channel->cl_cmd_q_.empty()) return channel->cid_;
+
+  return 0;
+}
+
+/*******************************************************************************
+ *
+ * Function         gatt_send_prepare_write_window
+ *
+ * Description      Send the prepare writes of a pipelined long write on the
+ *                  idle bearers, up to GATT_PREP_WRITE_WINDOW outstanding.
+ *                  ATT allows a single outstanding request per bearer, so
+ *                  that the window spans the EATT bearers. The attribute
+ *                  offset is the offset of the next prepare write to send.
+ *
+ *                  Once no prepare write is outstanding the queued writes are
+ *                  executed, or cancelled when one of them failed.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void gatt_send_prepare_write_window(tGATT_TCB& tcb,
+                                           tGATT_CLCB* p_clcb) {
+  tGATT_VALUE* p_attr = (tGATT_VALUE*)p_clcb->p_attr_buf;
+
+  while (p_clcb->status == GATT_SUCCESS &&
+         p_clcb->num_prep_writes < GATT_PREP_WRITE_WINDOW &&
+         p_attr->offset < p_attr->len) {
+    uint16_t cid = gatt_prep_write_idle_cid(tcb);
+    if (cid == 0) {
+      if (p_clcb->num_prep_writes > 0) break;
+      /* nothing outstanding, queue up on the bearer of the request */
+      cid = p_clcb->cid;
+    }
+    p_clcb->cid = cid;
+
+    uint16_t to_send = p_attr->len - p_attr->offset;
+    uint16_t payload_size = gatt_tcb_get_payload_size_tx(tcb, cid);
+    if (to_send > payload_size - GATT_WRITE_LONG_HDR_SIZE)
+      to_send = payload_size - GATT_WRITE_LONG_HDR_SIZE;
+
+    VLOG(1) << StringPrintf("%s cid=0x%04x offset=0x%x len=%d", __func__, cid,
+                            p_attr->offset, to_send);
+
+    p_clcb->s_handle = p_attr->handle;
+    tGATT_STATUS rt = gatt_send_write_msg(
+        tcb, p_clcb, GATT_REQ_PREPARE_WRITE, p_attr->handle, to_send,
+        p_attr->offset, p_attr->value + p_attr->offset);
+    if (rt != GATT_SUCCESS && rt != GATT_CMD_STARTED && rt != GATT_CONGESTED) {
+      p_clcb->status = rt;
+      break;
+    }
+
+    tGATT_PREP_WRITE& prep_write = p_clcb->prep_writes[p_clcb->num_prep_writes];
+    prep_write.cid = cid;
+    prep_write.offset = p_attr->offset;
+    prep_write.len = to_send;
+    p_clcb->num_prep_writes++;
+    p_attr->offset += to_send;
+  }
+
+  if (p_clcb->num_prep_writes > 0) {
+    /* the response timer was stopped by the response just received, it now
+     * guards the first outstanding prepare write */
+    p_clcb->cid = p_clcb->prep_writes[0].cid;
+    gatt_start_rsp_timer(p_clcb);
+    return;
+  }
+
+  if (p_attr->offset == 0) {
+    /* no prepare write was sent, nothing to cancel */
+    gatt_end_operation(p_clcb, p_clcb->status, NULL);
+    return;
+  }
+
+  gatt_send_queue_write_cancel(tcb, p_clcb,
+                               p_clcb->status == GATT_SUCCESS
+                                   ? GATT_PREP_WRITE_EXEC
+                                   : GATT_PREP_WRITE_CANCEL);
+}
+
+/* Outstanding prepare write answered on |cid| */
+static tGATT_PREP_WRITE* gatt_find_prep_write(tGATT_CLCB* p_clcb,
+                                              uint16_t cid) {
+  for (uint8_t i = 0; i < p_clcb->num_prep_writes; i++) {
+    if (p_clcb->prep_writes[i].cid == cid) return &p_clcb->prep_writes[i];
+  }
+  return nullptr;
+}
+
+static void gatt_remove_prep_write(tGATT_CLCB* p_clcb,
+                                   tGATT_PREP_WRITE* p_prep_write) {
+  *p_prep_write = p_clcb->prep_writes[--p_clcb->num_prep_writes];
+}
+
 /*******************************************************************************
  *
  * Function         gatt_process_find_type_value_rsp
@@ -562,6 +701,14 @@ void gatt_process_error_rsp(tGATT_TCB& tcb, tGATT_CLCB* p_clcb,
         (opcode == GATT_REQ_PREPARE_WRITE) && (p_attr) &&
         (handle == p_attr->handle)) {
       p_clcb->status = static_cast<tGATT_STATUS>(reason);
+      if (p_clcb->prep_write_pipelined) {
+        /* cancel once the other prepare writes are answered */
+        tGATT_PREP_WRITE* p_prep_write =
+            gatt_find_prep_write(p_clcb, p_clcb->cid);
+        if (p_prep_write) gatt_remove_prep_write(p_clcb, p_prep_write);
+        gatt_send_prepare_write_window(tcb, p_clcb);
+        return;
+      }
       gatt_send_queue_write_cancel(tcb, p_clcb, GATT_PREP_WRITE_CANCEL);
     } else if ((p_clcb->operation == GATTC_OPTYPE_READ) &&
                ((p_clcb->op_subtype == GATT_READ_CHAR_VALUE_HDL) ||
@@ -609,6 +756,20 @@ void gatt_process_prep_write_rsp(tGATT_TCB& tcb, tGATT_CLCB* p_clcb,
 
   memcpy(value.value, p, value.len);
 
+  if (p_clcb->prep_write_pipelined) {
+    tGATT_PREP_WRITE* p_prep_write = gatt_find_prep_write(p_clcb, p_clcb->cid);
+    if (!p_prep_write ||
+        !gatt_prep_write_rsp_matches(*(tGATT_VALUE*)p_clcb->p_attr_buf,
+                                     *p_prep_write, value)) {
+      LOG_WARN("Prepare write response on cid:0x%04x does not match",
+               p_clcb->cid);
+      p_clcb->status = GATT_ERROR;
+    }
+    if (p_prep_write) gatt_remove_prep_write(p_clcb, p_prep_write);
+    gatt_send_prepare_write_window(tcb, p_clcb);
+    return;
+  }
+
   if (!gatt_check_write_long_terminate(tcb, p_clcb, &value)) {
     gatt_send_prepare_write(tcb, p_clcb);
     return;
@@ -1001,7 +1162,8 @@ void gatt_process_read_rsp(tGATT_TCB& tcb, tGATT_CLCB* p_clcb,
 
   if (p_clcb->operation == GATTC_OPTYPE_READ) {
     if (p_clcb->op_subtype != GATT_READ_BY_HANDLE) {
-      p_clcb->counter = len;
+      /* a Read Multiple response may be as long as the MTU */
+      p_clcb->counter = std::min(len, (uint16_t)GATT_MAX_ATTR_LEN);
       gatt_end_operation(p_clcb, GATT_SUCCESS, (void*)p);
     } else {
       /* allocate GKI buffer holding up long attribute value  */
@@ -27,6 +27,8 @@
 #include <stdio.h>
 #include <string.h>
 
+#include <algorithm>
+
 #include "bt_target.h"
 #include "bt_trace.h"
 #include "bt_utils.h"
@@ -280,8 +282,10 @@ tGATT_STATUS gatts_db_read_attr_value_by_type(
   uint8_t* p = (uint8_t*)(p_rsp + 1) + p_rsp->len + L2CAP_MIN_OFFSET;
 
   if (p_db) {
-    for (tGATT_ATTR& attr : p_db->attr_list) {
-      if (attr.handle >= s_handle && type == attr.uuid) {
+    for (auto it = gatts_find_attr_lower_bound(*p_db, s_handle);
+         it != p_db->attr_list.end(); it++) {
+      tGATT_ATTR& attr = *it;
+      if (type == attr.uuid) {
         if (*p_len <= 2) {
           status = GATT_NO_RESOURCES;
           break;
@@ -442,15 +446,38 @@ uint16_t gatts_add_char_descr(tGATT_SVC_DB& db, tGATT_PERM perm,
 /******************************************************************************/
 /* Service Attribute Database Query Utility Functions */
 /******************************************************************************/
+/**
+ * Returns the first attribute of |db| with a handle not lower than |handle|,
+ * or attr_list.end() if there is none.
+ *
+ * allocate_attr_in_db() hands out consecutive handles, so the attribute is
+ * normally found at its offset from the service handle without searching.
+ */
+std::vector<tGATT_ATTR>::iterator gatts_find_attr_lower_bound(
+    tGATT_SVC_DB& db, uint16_t handle) {
+  auto& attrs = db.attr_list;
+  if (attrs.empty() || handle <= attrs.front().handle) return attrs.begin();
+
+  size_t index = handle - attrs.front().handle;
+  if (index >= attrs.size()) {
+    if (attrs.back().handle < handle) return attrs.end();
+  } else if (attrs[index].handle == handle) {
+    return attrs.begin() + index;
+  }
+
+  return std::lower_bound(attrs.begin(), attrs.end(), handle,
+                          [](const tGATT_ATTR& attr, uint16_t handle) {
+                            return attr.handle < handle;
+                          });
+}
+
 tGATT_ATTR* find_attr_by_handle(tGATT_SVC_DB* p_db, uint16_t handle) {
   if (!p_db) return nullptr;
 
-  for (auto& attr : p_db->attr_list) {
-    if (attr.handle == handle) return &attr;
-    if (attr.handle > handle) return nullptr;
-  }
+  auto it = gatts_find_attr_lower_bound(*p_db, handle);
+  if (it == p_db->attr_list.end() || it->handle != handle) return nullptr;
 
-  return nullptr;
+  return &*it;
 }
 
 /*******************************************************************************
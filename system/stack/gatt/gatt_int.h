@@ -25,6 +25,7 @@
 
 #include <list>
 #include <queue>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
@@ -88,6 +89,10 @@ inline std::string gatt_security_action_text(const tGATT_SEC_ACTION& action) {
 #define GATT_WAIT_FOR_DISC_RSP_TIMEOUT_MS (5 * 1000)
 #define GATT_REQ_RETRY_LIMIT 2
 
+/* Most prepare writes of a long write outstanding at once, one per ATT
+ * bearer */
+#define GATT_PREP_WRITE_WINDOW 4
+
 typedef struct {
   bool is_link_key_known;
   bool is_link_key_authed;
@@ -212,6 +217,18 @@ typedef struct {
   uint16_t cid;
 } tGATT_CMD_Q;
 
+/* client command queue statistics of an ATT bearer */
+typedef struct {
+  uint32_t commands{0};      /* commands queued on the bearer */
+  uint32_t queued_behind{0}; /* commands that waited for another one */
+  uint16_t max_depth{0};     /* most commands queued at once */
+  void OnEnqueue(size_t depth) {
+    commands++;
+    if (depth > 1) queued_behind++;
+    if (depth > max_depth) max_depth = depth;
+  }
+} tGATT_CL_CMD_STATS;
+
 #if GATT_MAX_SR_PROFILES <= 8
 typedef uint8_t tGATT_APP_MASK;
 #elif GATT_MAX_SR_PROFILES <= 16
@@ -331,6 +348,7 @@ typedef struct {
   uint8_t ind_count;
 
   std::queue<tGATT_CMD_Q> cl_cmd_q;
+  tGATT_CL_CMD_STATS cl_cmd_stats; /* statistics of cl_cmd_q */
   alarm_t* ind_ack_timer; /* local app confirm to indication timer */
 
   // TODO(hylo): support byte array data
@@ -352,6 +370,13 @@ typedef struct {
   tGATT_DISC_RES result;
   bool wait_for_read_rsp;
 } tGATT_READ_INC_UUID128;
+/* Prepare write of a long write outstanding on an ATT bearer */
+typedef struct {
+  uint16_t cid;
+  uint16_t offset;
+  uint16_t len;
+} tGATT_PREP_WRITE;
+
 struct tGATT_CLCB {
   tGATT_TCB* p_tcb; /* associated TCB of this CLCB */
   tGATT_REG* p_reg; /* owner of this CLCB */
@@ -375,6 +400,10 @@ struct tGATT_CLCB {
   uint16_t read_req_current_mtu; /* This is the MTU value that the read was
                                     initiated with */
   uint16_t cid;
+  /* Long write sent over several ATT bearers at once */
+  bool prep_write_pipelined;
+  uint8_t num_prep_writes;
+  tGATT_PREP_WRITE prep_writes[GATT_PREP_WRITE_WINDOW];
 };
 
 typedef struct {
@@ -403,6 +432,12 @@ typedef struct {
   uint16_t e_handle;
 } tGATT_PROFILE_CLCB;
 
+/* Pre-encoded response to a discovery request, see gatt_sr_cache_rsp() */
+typedef struct {
+  uint8_t status; /* error sent instead of |pdu| when not GATT_SUCCESS */
+  std::vector<uint8_t> pdu;
+} tGATT_SR_CACHED_RSP;
+
 typedef struct {
   tGATT_TCB tcb[GATT_MAX_PHY_CHANNEL];
   fixed_queue_t* sign_op_queue;
@@ -413,6 +448,8 @@ typedef struct {
   tGATT_IF gatt_if;
   std::list<tGATT_HDL_LIST_ELEM>* hdl_list_info;
   std::list<tGATT_SRV_LIST_ELEM>* srv_list_info;
+  /* srv_list_info entries ordered by handle, see gatt_sr_add_srv() */
+  std::vector<std::list<tGATT_SRV_LIST_ELEM>::iterator> srv_list_index;
 
   fixed_queue_t* srv_chg_clt_q; /* service change clients queue */
   tGATT_REG cl_rcb[GATT_MAX_APPS];
@@ -441,6 +478,8 @@ typedef struct {
 
   uint16_t handle_of_database_hash;
   Octet16 database_hash;
+  /* discovery responses for the current database, cleared with the hash */
+  std::unordered_map<uint64_t, tGATT_SR_CACHED_RSP> sr_rsp_cache;
 
   tGATT_APPL_INFO cb_info;
 
@@ -555,6 +594,17 @@ extern bool gatt_auto_connect_dev_remove(tGATT_IF gatt_if,
 /* server function */
 extern std::list<tGATT_SRV_LIST_ELEM>::iterator gatt_sr_find_i_rcb_by_handle(
     uint16_t handle);
+extern std::list<tGATT_SRV_LIST_ELEM>::iterator gatt_sr_find_first_srv_from(
+    uint16_t handle);
+extern tGATT_SRV_LIST_ELEM& gatt_sr_add_srv(uint16_t s_hdl);
+extern void gatt_sr_remove_srv(std::list<tGATT_SRV_LIST_ELEM>::iterator it);
+extern void gatt_sr_clear_srv_list();
+extern const tGATT_SR_CACHED_RSP* gatt_sr_find_cached_rsp(
+    uint8_t op_code, uint16_t s_hdl, uint16_t e_hdl, uint16_t payload_size);
+extern void gatt_sr_cache_rsp(uint8_t op_code, uint16_t s_hdl, uint16_t e_hdl,
+                              uint16_t payload_size, uint8_t status,
+                              const BT_HDR* p_msg);
+extern void gatt_sr_clear_rsp_cache();
 extern tGATT_STATUS gatt_sr_process_app_rsp(tGATT_TCB& tcb, tGATT_IF gatt_if,
                                             uint32_t trans_id, uint8_t op_code,
                                             tGATT_STATUS status,
@@ -637,6 +687,9 @@ extern void gatt_client_handle_server_rsp(tGATT_TCB& tcb, uint16_t cid,
                                           uint8_t* p_data);
 extern void gatt_send_queue_write_cancel(tGATT_TCB& tcb, tGATT_CLCB* p_clcb,
                                          tGATT_EXEC_FLAG flag);
+extern bool gatt_prep_write_rsp_matches(const tGATT_VALUE& attr,
+                                        const tGATT_PREP_WRITE& prep_write,
+                                        const tGATT_VALUE& rsp);
 
 /* gatt_auth.cc */
 extern bool gatt_security_check_start(tGATT_CLCB* p_clcb);
@@ -659,6 +712,8 @@ extern uint16_t gatts_add_char_ext_prop_descr(tGATT_SVC_DB& db,
                                               uint16_t extended_properties);
 extern uint16_t gatts_add_char_descr(tGATT_SVC_DB& db, tGATT_PERM perm,
                                      const bluetooth::Uuid& dscp_uuid);
+extern std::vector<tGATT_ATTR>::iterator gatts_find_attr_lower_bound(
+    tGATT_SVC_DB& db, uint16_t handle);
 extern tGATT_STATUS gatts_db_read_attr_value_by_type(
     tGATT_TCB& tcb, uint16_t cid, tGATT_SVC_DB* p_db, uint8_t op_code,
     BT_HDR* p_rsp, uint16_t s_handle, uint16_t e_handle,
@@ -137,6 +137,32 @@ void gatt_init(void) {
   EattExtension::GetInstance()->Start();
 }
 
+/*******************************************************************************
+ *
+ * Function         gatt_debug_dump
+ *
+ * Description      This function dumps the client command queues of the
+ *                  connected ATT and EATT bearers.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void gatt_debug_dump(int fd) {
+  dprintf(fd, "\nGATT client bearers:\n");
+  for (int i = 0; i < GATT_MAX_PHY_CHANNEL; i++) {
+    const tGATT_TCB& tcb = gatt_cb.tcb[i];
+    if (!tcb.in_use) continue;
+
+    const tGATT_CL_CMD_STATS& stats = tcb.cl_cmd_stats;
+    dprintf(fd,
+            "  %s ATT cid: 0x%04x, queued: %zu, commands: %u, queued behind: "
+            "%u, max depth: %d\n",
+            tcb.peer_bda.ToString().c_str(), tcb.att_lcid, tcb.cl_cmd_q.size(),
+            stats.commands, stats.queued_behind, stats.max_depth);
+  }
+  EattExtension::GetInstance()->Dump(fd);
+}
+
 /*******************************************************************************
  *
  * Function         gatt_free
@@ -176,7 +202,7 @@ void gatt_free(void) {
   gatt_cb.hdl_list_info->clear();
   delete gatt_cb.hdl_list_info;
   gatt_cb.hdl_list_info = nullptr;
-  gatt_cb.srv_list_info->clear();
+  gatt_sr_clear_srv_list();
   delete gatt_cb.srv_list_info;
   gatt_cb.srv_list_info = nullptr;
 
@@ -502,6 +502,38 @@ void gatt_process_read_multi_req(tGATT_TCB& tcb, uint16_t cid, uint8_t op_code,
     gatt_send_error_rsp(tcb, cid, err, op_code, handle, false);
 }
 
+/*******************************************************************************
+ *
+ * Function         gatts_send_cached_rsp
+ *
+ * Description      Send the response cached for a discovery request, either
+ *                  the encoded PDU or the error it ended with.
+ *
+ * Returns          true if a cached response was sent.
+ *
+ ******************************************************************************/
+static bool gatts_send_cached_rsp(tGATT_TCB& tcb, uint16_t cid,
+                                  uint8_t op_code, uint16_t s_hdl,
+                                  uint16_t e_hdl, uint16_t payload_size) {
+  const tGATT_SR_CACHED_RSP* p_rsp =
+      gatt_sr_find_cached_rsp(op_code, s_hdl, e_hdl, payload_size);
+  if (p_rsp == nullptr) return false;
+
+  if (p_rsp->status != GATT_SUCCESS) {
+    gatt_send_error_rsp(tcb, cid, p_rsp->status, op_code, s_hdl, false);
+    return true;
+  }
+
+  BT_HDR* p_msg = (BT_HDR*)osi_calloc(sizeof(BT_HDR) + payload_size +
+                                      L2CAP_MIN_OFFSET);
+  p_msg->offset = L2CAP_MIN_OFFSET;
+  p_msg->len = p_rsp->pdu.size();
+  memcpy((uint8_t*)(p_msg + 1) + p_msg->offset, p_rsp->pdu.data(),
+         p_msg->len);
+  attp_send_sr_msg(tcb, cid, p_msg);
+  return true;
+}
+
 /*******************************************************************************
  *
  * Function         gatt_build_primary_service_rsp
@@ -523,9 +555,10 @@ static tGATT_STATUS gatt_build_primary_service_rsp(
 
   uint16_t payload_size = gatt_tcb_get_payload_size_tx(tcb, cid);
 
-  for (tGATT_SRV_LIST_ELEM& el : *gatt_cb.srv_list_info) {
-    if (el.s_hdl < s_hdl || el.s_hdl > e_hdl ||
-        el.type != GATT_UUID_PRI_SERVICE) {
+  for (auto it = gatt_sr_find_first_srv_from(s_hdl);
+       it != gatt_cb.srv_list_info->end() && it->s_hdl <= e_hdl; it++) {
+    tGATT_SRV_LIST_ELEM& el = *it;
+    if (el.s_hdl < s_hdl || el.type != GATT_UUID_PRI_SERVICE) {
       continue;
     }
 
@@ -593,11 +626,11 @@ static tGATT_STATUS gatt_build_find_info_rsp(tGATT_SRV_LIST_ELEM& el,
 
   uint8_t* p = (uint8_t*)(p_msg + 1) + L2CAP_MIN_OFFSET + p_msg->len;
 
-  for (auto& attr : el.p_db->attr_list) {
+  for (auto it = gatts_find_attr_lower_bound(*el.p_db, s_hdl);
+       it != el.p_db->attr_list.end(); it++) {
+    auto& attr = *it;
     if (attr.handle > e_hdl) break;
 
-    if (attr.handle < s_hdl) continue;
-
     uint8_t uuid_len = attr.uuid.GetShortestRepresentationSize();
     if (p_msg->offset == 0)
       p_msg->offset = (uuid_len == Uuid::kNumBytes16) ? GATT_INFO_TYPE_PAIR_16
@@ -718,11 +751,21 @@ void gatts_process_primary_service_req(tGATT_TCB& tcb, uint16_t cid,
 
   uint16_t payload_size = gatt_tcb_get_payload_size_tx(tcb, cid);
 
+  /* Find By Type Value responses depend on the value, only cache the others */
+  bool cacheable = op_code == GATT_REQ_READ_BY_GRP_TYPE;
+  if (cacheable &&
+      gatts_send_cached_rsp(tcb, cid, op_code, s_hdl, e_hdl, payload_size)) {
+    return;
+  }
+
   uint16_t msg_len =
       (uint16_t)(sizeof(BT_HDR) + payload_size + L2CAP_MIN_OFFSET);
   BT_HDR* p_msg = (BT_HDR*)osi_calloc(msg_len);
   reason = gatt_build_primary_service_rsp(p_msg, tcb, cid, op_code, s_hdl,
                                           e_hdl, p_data, value);
+  if (cacheable) {
+    gatt_sr_cache_rsp(op_code, s_hdl, e_hdl, payload_size, reason, p_msg);
+  }
   if (reason != GATT_SUCCESS) {
     osi_free(p_msg);
     gatt_send_error_rsp(tcb, cid, reason, op_code, s_hdl, false);
@@ -753,6 +796,10 @@ static void gatts_process_find_info(tGATT_TCB& tcb, uint16_t cid,
   }
 
   uint16_t payload_size = gatt_tcb_get_payload_size_tx(tcb, cid);
+  if (gatts_send_cached_rsp(tcb, cid, op_code, s_hdl, e_hdl, payload_size)) {
+    return;
+  }
+
   uint16_t buf_len =
       (uint16_t)(sizeof(BT_HDR) + payload_size + L2CAP_MIN_OFFSET);
 
@@ -765,7 +812,9 @@ static void gatts_process_find_info(tGATT_TCB& tcb, uint16_t cid,
 
   buf_len = payload_size - 2;
 
-  for (tGATT_SRV_LIST_ELEM& el : *gatt_cb.srv_list_info) {
+  for (auto it = gatt_sr_find_first_srv_from(s_hdl);
+       it != gatt_cb.srv_list_info->end() && it->s_hdl <= e_hdl; it++) {
+    tGATT_SRV_LIST_ELEM& el = *it;
     if (el.s_hdl <= e_hdl && el.e_hdl >= s_hdl) {
       reason = gatt_build_find_info_rsp(el, p_msg, buf_len, s_hdl, e_hdl);
       if (reason == GATT_NO_RESOURCES) {
@@ -779,6 +828,7 @@ static void gatts_process_find_info(tGATT_TCB& tcb, uint16_t cid,
 
   p_msg->offset = L2CAP_MIN_OFFSET;
 
+  gatt_sr_cache_rsp(op_code, s_hdl, e_hdl, payload_size, reason, p_msg);
   if (reason != GATT_SUCCESS) {
     osi_free(p_msg);
     gatt_send_error_rsp(tcb, cid, reason, op_code, s_hdl, false);
@@ -897,7 +947,9 @@ static void gatts_process_read_by_type_req(tGATT_TCB& tcb, uint16_t cid,
   uint16_t buf_len = payload_size - 2;
 
   reason = GATT_NOT_FOUND;
-  for (tGATT_SRV_LIST_ELEM& el : *gatt_cb.srv_list_info) {
+  for (auto it = gatt_sr_find_first_srv_from(s_hdl);
+       it != gatt_cb.srv_list_info->end() && it->s_hdl <= e_hdl; it++) {
+    tGATT_SRV_LIST_ELEM& el = *it;
     if (el.s_hdl <= e_hdl && el.e_hdl >= s_hdl) {
       tGATT_SEC_FLAG sec_flag;
       uint8_t key_size;
@@ -1117,31 +1169,29 @@ void gatts_process_attribute_req(tGATT_TCB& tcb, uint16_t cid, uint8_t op_code,
 #endif
 
   if (GATT_HANDLE_IS_VALID(handle)) {
-    for (auto& el : *gatt_cb.srv_list_info) {
-      if (el.s_hdl <= handle && el.e_hdl >= handle) {
-        for (const auto& attr : el.p_db->attr_list) {
-          if (attr.handle == handle) {
-            switch (op_code) {
-              case GATT_REQ_READ: /* read char/char descriptor value */
-              case GATT_REQ_READ_BLOB:
-                gatts_process_read_req(tcb, cid, el, op_code, handle, len, p);
-                break;
-
-              case GATT_REQ_WRITE: /* write char/char descriptor value */
-              case GATT_CMD_WRITE:
-              case GATT_SIGN_CMD_WRITE:
-              case GATT_REQ_PREPARE_WRITE:
-                gatts_process_write_req(tcb, cid, el, handle, op_code, len, p,
-                                        attr.gatt_type);
-                break;
-              default:
-                break;
-            }
-            status = GATT_SUCCESS;
+    auto it = gatt_sr_find_i_rcb_by_handle(handle);
+    if (it != gatt_cb.srv_list_info->end()) {
+      tGATT_SRV_LIST_ELEM& el = *it;
+      auto attr_it = gatts_find_attr_lower_bound(*el.p_db, handle);
+      if (attr_it != el.p_db->attr_list.end() && attr_it->handle == handle) {
+        const auto& attr = *attr_it;
+        switch (op_code) {
+          case GATT_REQ_READ: /* read char/char descriptor value */
+          case GATT_REQ_READ_BLOB:
+            gatts_process_read_req(tcb, cid, el, op_code, handle, len, p);
+            break;
+
+          case GATT_REQ_WRITE: /* write char/char descriptor value */
+          case GATT_CMD_WRITE:
+          case GATT_SIGN_CMD_WRITE:
+          case GATT_REQ_PREPARE_WRITE:
+            gatts_process_write_req(tcb, cid, el, handle, op_code, len, p,
+                                    attr.gatt_type);
+            break;
+          default:
             break;
-          }
         }
-        break;
+        status = GATT_SUCCESS;
       }
     }
   }
@@ -26,6 +26,7 @@
 #include <base/logging.h>
 #include <base/strings/stringprintf.h>
 
+#include <algorithm>
 #include <cstdint>
 
 #include "bt_target.h"  // Must be first to define build configuration
@@ -744,17 +745,154 @@ void  gatt_ind_ack_timeout(void* data) {
  ******************************************************************************/
 std::list<tGATT_SRV_LIST_ELEM>::iterator gatt_sr_find_i_rcb_by_handle(
     uint16_t handle) {
-  auto it = gatt_cb.srv_list_info->begin();
+  auto it = gatt_sr_find_first_srv_from(handle);
+  if (it != gatt_cb.srv_list_info->end() && it->s_hdl <= handle) return it;
 
-  for (; it != gatt_cb.srv_list_info->end(); it++) {
-    if (it->s_hdl <= handle && it->e_hdl >= handle) {
-      return it;
-    }
+  return gatt_cb.srv_list_info->end();
+}
+
+/*******************************************************************************
+ *
+ * Function         gatt_sr_find_first_srv_from
+ *
+ * Description      Find the first started service that ends at or after
+ *                  |handle|. Services don't overlap, so walking
+ *                  srv_list_info from there visits the services of a handle
+ *                  range in order.
+ *
+ * Returns          Iterator into srv_list_info, end() if there is none.
+ *
+ ******************************************************************************/
+std::list<tGATT_SRV_LIST_ELEM>::iterator gatt_sr_find_first_srv_from(
+    uint16_t handle) {
+  auto& index = gatt_cb.srv_list_index;
+  auto it = std::lower_bound(
+      index.begin(), index.end(), handle,
+      [](const std::list<tGATT_SRV_LIST_ELEM>::iterator& srv,
+         uint16_t handle) { return srv->e_hdl < handle; });
+  if (it == index.end()) return gatt_cb.srv_list_info->end();
+
+  return *it;
+}
+
+/*******************************************************************************
+ *
+ * Function         gatt_sr_add_srv
+ *
+ * Description      Add a service starting at |s_hdl| to srv_list_info, keeping
+ *                  the list and srv_list_index ordered by handle.
+ *
+ * Returns          The new, default initialized, element.
+ *
+ ******************************************************************************/
+tGATT_SRV_LIST_ELEM& gatt_sr_add_srv(uint16_t s_hdl) {
+  auto& index = gatt_cb.srv_list_index;
+  auto pos = std::upper_bound(
+      index.begin(), index.end(), s_hdl,
+      [](uint16_t s_hdl, const std::list<tGATT_SRV_LIST_ELEM>::iterator& srv) {
+        return s_hdl < srv->s_hdl;
+      });
+  auto list_pos = pos == index.end() ? gatt_cb.srv_list_info->end() : *pos;
+  auto it = gatt_cb.srv_list_info->emplace(list_pos);
+  it->s_hdl = s_hdl;
+  index.insert(pos, it);
+  gatt_sr_clear_rsp_cache();
+  return *it;
+}
+
+/*******************************************************************************
+ *
+ * Function         gatt_sr_remove_srv
+ *
+ * Description      Remove a service from srv_list_info and srv_list_index.
+ *
+ ******************************************************************************/
+void gatt_sr_remove_srv(std::list<tGATT_SRV_LIST_ELEM>::iterator it) {
+  auto& index = gatt_cb.srv_list_index;
+  index.erase(std::remove(index.begin(), index.end(), it), index.end());
+  gatt_cb.srv_list_info->erase(it);
+  gatt_sr_clear_rsp_cache();
+}
+
+/*******************************************************************************
+ *
+ * Function         gatt_sr_clear_srv_list
+ *
+ * Description      Remove all services from srv_list_info and srv_list_index.
+ *
+ ******************************************************************************/
+void gatt_sr_clear_srv_list() {
+  gatt_cb.srv_list_index.clear();
+  gatt_cb.srv_list_info->clear();
+  gatt_sr_clear_rsp_cache();
+}
+
+/* Cached responses kept at most, the cache is emptied when it is full. Large
+ * enough for the discovery of every service by a few clients with different
+ * MTUs. */
+#define GATT_SR_RSP_CACHE_MAX_ENTRIES 128
+
+static uint64_t gatt_sr_rsp_cache_key(uint8_t op_code, uint16_t s_hdl,
+                                      uint16_t e_hdl, uint16_t payload_size) {
+  return ((uint64_t)op_code << 48) | ((uint64_t)s_hdl << 32) |
+         ((uint64_t)e_hdl << 16) | payload_size;
+}
+
+/*******************************************************************************
+ *
+ * Function         gatt_sr_find_cached_rsp
+ *
+ * Description      Find the response cached for a discovery request.
+ *
+ * Returns          Pointer to the response, nullptr if none is cached.
+ *
+ ******************************************************************************/
+const tGATT_SR_CACHED_RSP* gatt_sr_find_cached_rsp(uint8_t op_code,
+                                                   uint16_t s_hdl,
+                                                   uint16_t e_hdl,
+                                                   uint16_t payload_size) {
+  auto it = gatt_cb.sr_rsp_cache.find(
+      gatt_sr_rsp_cache_key(op_code, s_hdl, e_hdl, payload_size));
+  if (it == gatt_cb.sr_rsp_cache.end()) return nullptr;
+
+  return &it->second;
+}
+
+/*******************************************************************************
+ *
+ * Function         gatt_sr_cache_rsp
+ *
+ * Description      Cache the response to a discovery request that only depends
+ *                  on the database layout. |p_msg| holds the encoded response
+ *                  when |status| is GATT_SUCCESS and is ignored otherwise.
+ *
+ ******************************************************************************/
+void gatt_sr_cache_rsp(uint8_t op_code, uint16_t s_hdl, uint16_t e_hdl,
+                       uint16_t payload_size, uint8_t status,
+                       const BT_HDR* p_msg) {
+  if (gatt_cb.sr_rsp_cache.size() >= GATT_SR_RSP_CACHE_MAX_ENTRIES) {
+    gatt_cb.sr_rsp_cache.clear();
   }
 
-  return it;
+  tGATT_SR_CACHED_RSP& rsp = gatt_cb.sr_rsp_cache[gatt_sr_rsp_cache_key(
+      op_code, s_hdl, e_hdl, payload_size)];
+  rsp.status = status;
+  rsp.pdu.clear();
+  if (status == GATT_SUCCESS) {
+    const uint8_t* p = (const uint8_t*)(p_msg + 1) + p_msg->offset;
+    rsp.pdu.assign(p, p + p_msg->len);
+  }
 }
 
+/*******************************************************************************
+ *
+ * Function         gatt_sr_clear_rsp_cache
+ *
+ * Description      Drop all cached discovery responses, the database changed.
+ *
+ ******************************************************************************/
+void gatt_sr_clear_rsp_cache() { gatt_cb.sr_rsp_cache.clear(); }
+
 /*******************************************************************************
  *
  * Function         gatt_sr_get_sec_info
@@ -1101,7 +1239,10 @@ bool gatt_tcb_find_indicate_handle(tGATT_TCB& tcb, uint16_t cid,
  *
  * Function         gatt_tcb_get_att_cid
  *
- * Description      This function gets cid for the GATT operation
+ * Description      This function gets cid for the GATT operation. Client
+ *                  requests are spread over the EATT bearers and the ATT
+ *                  bearer, each one going to the bearer with the fewest
+ *                  commands queued. EATT bearers are preferred on a tie.
  *
  * Returns          Available CID
  *
@@ -1111,7 +1252,7 @@ uint16_t gatt_tcb_get_att_cid(tGATT_TCB& tcb, bool eatt_support) {
   if (eatt_support && tcb.eatt) {
     EattChannel* channel =
         EattExtension::GetInstance()->GetChannelAvailableForClientRequest(tcb.peer_bda);
-    if (channel) {
+    if (channel && channel->cl_cmd_q_.size() <= tcb.cl_cmd_q.size()) {
       return channel->cid_;
     }
   }
@@ -1450,11 +1591,13 @@ void gatt_cmd_enq(tGATT_TCB& tcb, tGATT_CLCB* p_clcb, bool to_send,
 
   if (p_clcb->cid == tcb.att_lcid) {
     tcb.cl_cmd_q.push(cmd);
+    tcb.cl_cmd_stats.OnEnqueue(tcb.cl_cmd_q.size());
   } else {
     EattChannel* channel =
         EattExtension::GetInstance()->FindEattChannelByCid(tcb.peer_bda, cmd.cid);
     CHECK(channel);
     channel->cl_cmd_q_.push(cmd);
+    channel->cl_cmd_stats_.OnEnqueue(channel->cl_cmd_q_.size());
   }
 }
 
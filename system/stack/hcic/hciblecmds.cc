@@ -33,6 +33,7 @@
 #include "btu.h"
 #include "hcidefs.h"
 #include "hcimsgs.h"
+#include "main/shim/hci_command.h"
 #include "osi/include/allocator.h"
 #include "stack/include/bt_hdr.h"
 #include "stack/include/bt_octets.h"
@@ -123,18 +124,13 @@ void btsnd_hcic_ble_set_local_used_feat(uint8_t feat_set[8]) {
 }
 
 void btsnd_hcic_ble_set_random_addr(const RawAddress& random_bda) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_WRITE_RANDOM_ADDR_CMD;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_WRITE_RANDOM_ADDR);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_WRITE_RANDOM_ADDR_CMD);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_BLE_WRITE_RANDOM_ADDR, HCIC_PARAM_SIZE_WRITE_RANDOM_ADDR_CMD);
+  uint8_t* pp = command->GetParameters();
 
   BDADDR_TO_STREAM(pp, random_bda);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_ble_write_adv_params(uint16_t adv_int_min, uint16_t adv_int_max,
@@ -144,14 +140,9 @@ void btsnd_hcic_ble_write_adv_params(uint16_t adv_int_min, uint16_t adv_int_max,
                                      const RawAddress& direct_bda,
                                      uint8_t channel_map,
                                      uint8_t adv_filter_policy) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_WRITE_ADV_PARAMS;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_WRITE_ADV_PARAMS);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_WRITE_ADV_PARAMS);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_BLE_WRITE_ADV_PARAMS, HCIC_PARAM_SIZE_BLE_WRITE_ADV_PARAMS);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, adv_int_min);
   UINT16_TO_STREAM(pp, adv_int_max);
@@ -162,19 +153,13 @@ void btsnd_hcic_ble_write_adv_params(uint16_t adv_int_min, uint16_t adv_int_max,
   UINT8_TO_STREAM(pp, channel_map);
   UINT8_TO_STREAM(pp, adv_filter_policy);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 void btsnd_hcic_ble_read_adv_chnl_tx_power(void) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_READ_CMD;
-  p->offset = 0;
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_BLE_READ_ADV_CHNL_TX_POWER, HCIC_PARAM_SIZE_READ_CMD);
 
-  UINT16_TO_STREAM(pp, HCI_BLE_READ_ADV_CHNL_TX_POWER);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_READ_CMD);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_ble_set_adv_data(uint8_t data_len, uint8_t* p_data) {
@@ -224,30 +209,20 @@ void btsnd_hcic_ble_set_scan_rsp_data(uint8_t data_len, uint8_t* p_scan_rsp) {
 }
 
 void btsnd_hcic_ble_set_adv_enable(uint8_t adv_enable) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_WRITE_ADV_ENABLE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_WRITE_ADV_ENABLE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_WRITE_ADV_ENABLE);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_BLE_WRITE_ADV_ENABLE, HCIC_PARAM_SIZE_WRITE_ADV_ENABLE);
+  uint8_t* pp = command->GetParameters();
 
   UINT8_TO_STREAM(pp, adv_enable);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 void btsnd_hcic_ble_set_scan_params(uint8_t scan_type, uint16_t scan_int,
                                     uint16_t scan_win, uint8_t addr_type_own,
                                     uint8_t scan_filter_policy) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_WRITE_SCAN_PARAM;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_WRITE_SCAN_PARAMS);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_WRITE_SCAN_PARAM);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_BLE_WRITE_SCAN_PARAMS, HCIC_PARAM_SIZE_BLE_WRITE_SCAN_PARAM);
+  uint8_t* pp = command->GetParameters();
 
   UINT8_TO_STREAM(pp, scan_type);
   UINT16_TO_STREAM(pp, scan_int);
@@ -255,23 +230,18 @@ void btsnd_hcic_ble_set_scan_params(uint8_t scan_type, uint16_t scan_int,
   UINT8_TO_STREAM(pp, addr_type_own);
   UINT8_TO_STREAM(pp, scan_filter_policy);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_ble_set_scan_enable(uint8_t scan_enable, uint8_t duplicate) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_WRITE_SCAN_ENABLE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_WRITE_SCAN_ENABLE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_WRITE_SCAN_ENABLE);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_BLE_WRITE_SCAN_ENABLE, HCIC_PARAM_SIZE_BLE_WRITE_SCAN_ENABLE);
+  uint8_t* pp = command->GetParameters();
 
   UINT8_TO_STREAM(pp, scan_enable);
   UINT8_TO_STREAM(pp, duplicate);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 /* link layer connection management commands */
@@ -283,14 +253,9 @@ void btsnd_hcic_ble_create_ll_conn(uint16_t scan_int, uint16_t scan_win,
                                    uint16_t conn_int_min, uint16_t conn_int_max,
                                    uint16_t conn_latency, uint16_t conn_timeout,
                                    uint16_t min_ce_len, uint16_t max_ce_len) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_CREATE_LL_CONN;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_CREATE_LL_CONN);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_CREATE_LL_CONN);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_BLE_CREATE_LL_CONN, HCIC_PARAM_SIZE_BLE_CREATE_LL_CONN);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, scan_int);
   UINT16_TO_STREAM(pp, scan_win);
@@ -308,20 +273,14 @@ void btsnd_hcic_ble_create_ll_conn(uint16_t scan_int, uint16_t scan_win,
   UINT16_TO_STREAM(pp, min_ce_len);
   UINT16_TO_STREAM(pp, max_ce_len);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_ble_create_conn_cancel(void) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_CREATE_CONN_CANCEL;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_CREATE_CONN_CANCEL);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_CREATE_CONN_CANCEL);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_BLE_CREATE_CONN_CANCEL, HCIC_PARAM_SIZE_BLE_CREATE_CONN_CANCEL);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_ble_clear_acceptlist(
@@ -362,14 +321,9 @@ void btsnd_hcic_ble_upd_ll_conn_params(uint16_t handle, uint16_t conn_int_min,
                                        uint16_t conn_timeout,
                                        uint16_t min_ce_len,
                                        uint16_t max_ce_len) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_UPD_LL_CONN_PARAMS;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_UPD_LL_CONN_PARAMS);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_UPD_LL_CONN_PARAMS);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_BLE_UPD_LL_CONN_PARAMS, HCIC_PARAM_SIZE_BLE_UPD_LL_CONN_PARAMS);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, handle);
 
@@ -380,53 +334,38 @@ void btsnd_hcic_ble_upd_ll_conn_params(uint16_t handle, uint16_t conn_int_min,
   UINT16_TO_STREAM(pp, min_ce_len);
   UINT16_TO_STREAM(pp, max_ce_len);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_ble_set_host_chnl_class(
     uint8_t chnl_map[HCIC_BLE_CHNL_MAP_SIZE]) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_SET_HOST_CHNL_CLASS;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_SET_HOST_CHNL_CLASS);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_SET_HOST_CHNL_CLASS);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_BLE_SET_HOST_CHNL_CLASS, HCIC_PARAM_SIZE_SET_HOST_CHNL_CLASS);
+  uint8_t* pp = command->GetParameters();
 
   ARRAY_TO_STREAM(pp, chnl_map, HCIC_BLE_CHNL_MAP_SIZE);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_ble_read_chnl_map(uint16_t handle) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_READ_CHNL_MAP;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_READ_CHNL_MAP);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_READ_CHNL_MAP);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_BLE_READ_CHNL_MAP, HCIC_PARAM_SIZE_READ_CHNL_MAP);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, handle);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_ble_read_remote_feat(uint16_t handle) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_READ_REMOTE_FEAT;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_READ_REMOTE_FEAT);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_READ_REMOTE_FEAT);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_BLE_READ_REMOTE_FEAT, HCIC_PARAM_SIZE_BLE_READ_REMOTE_FEAT);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, handle);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_ble_rand(base::Callback<void(BT_OCTET8)> cb) {
@@ -444,111 +383,74 @@ void btsnd_hcic_ble_rand(base::Callback<void(BT_OCTET8)> cb) {
 void btsnd_hcic_ble_start_enc(uint16_t handle,
                               uint8_t rand[HCIC_BLE_RAND_DI_SIZE],
                               uint16_t ediv, const Octet16& ltk) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_START_ENC;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_START_ENC);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_START_ENC);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_BLE_START_ENC, HCIC_PARAM_SIZE_BLE_START_ENC);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, handle);
   ARRAY_TO_STREAM(pp, rand, HCIC_BLE_RAND_DI_SIZE);
   UINT16_TO_STREAM(pp, ediv);
   ARRAY_TO_STREAM(pp, ltk.data(), HCIC_BLE_ENCRYPT_KEY_SIZE);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_ble_ltk_req_reply(uint16_t handle, const Octet16& ltk) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_LTK_REQ_REPLY;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_LTK_REQ_REPLY);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_LTK_REQ_REPLY);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_BLE_LTK_REQ_REPLY, HCIC_PARAM_SIZE_LTK_REQ_REPLY);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, handle);
   ARRAY_TO_STREAM(pp, ltk.data(), HCIC_BLE_ENCRYPT_KEY_SIZE);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_ble_ltk_req_neg_reply(uint16_t handle) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_LTK_REQ_NEG_REPLY;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_LTK_REQ_NEG_REPLY);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_LTK_REQ_NEG_REPLY);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_BLE_LTK_REQ_NEG_REPLY, HCIC_PARAM_SIZE_LTK_REQ_NEG_REPLY);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, handle);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_ble_receiver_test(uint8_t rx_freq) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_WRITE_PARAM1;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_RECEIVER_TEST);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_WRITE_PARAM1);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_BLE_RECEIVER_TEST, HCIC_PARAM_SIZE_WRITE_PARAM1);
+  uint8_t* pp = command->GetParameters();
 
   UINT8_TO_STREAM(pp, rx_freq);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_ble_transmitter_test(uint8_t tx_freq, uint8_t test_data_len,
                                      uint8_t payload) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_WRITE_PARAM3;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_TRANSMITTER_TEST);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_WRITE_PARAM3);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_BLE_TRANSMITTER_TEST, HCIC_PARAM_SIZE_WRITE_PARAM3);
+  uint8_t* pp = command->GetParameters();
 
   UINT8_TO_STREAM(pp, tx_freq);
   UINT8_TO_STREAM(pp, test_data_len);
   UINT8_TO_STREAM(pp, payload);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_ble_test_end(void) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_READ_CMD;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_TEST_END);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_READ_CMD);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_BLE_TEST_END, HCIC_PARAM_SIZE_READ_CMD);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_ble_read_host_supported(void) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_READ_LE_HOST_SUPPORT, HCIC_PARAM_SIZE_READ_CMD);
 
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_READ_CMD;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_READ_LE_HOST_SUPPORT);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_READ_CMD);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_ble_rc_param_req_reply(uint16_t handle, uint16_t conn_int_min,
@@ -557,14 +459,9 @@ void btsnd_hcic_ble_rc_param_req_reply(uint16_t handle, uint16_t conn_int_min,
                                        uint16_t conn_timeout,
                                        uint16_t min_ce_len,
                                        uint16_t max_ce_len) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_RC_PARAM_REQ_REPLY;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_RC_PARAM_REQ_REPLY);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_RC_PARAM_REQ_REPLY);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_BLE_RC_PARAM_REQ_REPLY, HCIC_PARAM_SIZE_BLE_RC_PARAM_REQ_REPLY);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, handle);
   UINT16_TO_STREAM(pp, conn_int_min);
@@ -574,137 +471,102 @@ void btsnd_hcic_ble_rc_param_req_reply(uint16_t handle, uint16_t conn_int_min,
   UINT16_TO_STREAM(pp, min_ce_len);
   UINT16_TO_STREAM(pp, max_ce_len);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_ble_rc_param_req_neg_reply(uint16_t handle, uint8_t reason) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_RC_PARAM_REQ_NEG_REPLY;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_RC_PARAM_REQ_NEG_REPLY);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_RC_PARAM_REQ_NEG_REPLY);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_BLE_RC_PARAM_REQ_NEG_REPLY,
+      HCIC_PARAM_SIZE_BLE_RC_PARAM_REQ_NEG_REPLY);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, handle);
   UINT8_TO_STREAM(pp, reason);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_ble_read_resolvable_addr_peer(uint8_t addr_type_peer,
                                               const RawAddress& bda_peer) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_READ_RESOLVABLE_ADDR_PEER;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_READ_RESOLVABLE_ADDR_PEER);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_READ_RESOLVABLE_ADDR_PEER);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_BLE_READ_RESOLVABLE_ADDR_PEER,
+      HCIC_PARAM_SIZE_BLE_READ_RESOLVABLE_ADDR_PEER);
+  uint8_t* pp = command->GetParameters();
   UINT8_TO_STREAM(pp, addr_type_peer);
   BDADDR_TO_STREAM(pp, bda_peer);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_ble_read_resolvable_addr_local(uint8_t addr_type_peer,
                                                const RawAddress& bda_peer) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_READ_RESOLVABLE_ADDR_LOCAL;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_READ_RESOLVABLE_ADDR_LOCAL);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_READ_RESOLVABLE_ADDR_LOCAL);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_BLE_READ_RESOLVABLE_ADDR_LOCAL,
+      HCIC_PARAM_SIZE_BLE_READ_RESOLVABLE_ADDR_LOCAL);
+  uint8_t* pp = command->GetParameters();
   UINT8_TO_STREAM(pp, addr_type_peer);
   BDADDR_TO_STREAM(pp, bda_peer);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_ble_set_addr_resolution_enable(uint8_t addr_resolution_enable) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_SET_ADDR_RESOLUTION_ENABLE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_SET_ADDR_RESOLUTION_ENABLE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_SET_ADDR_RESOLUTION_ENABLE);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_BLE_SET_ADDR_RESOLUTION_ENABLE,
+      HCIC_PARAM_SIZE_BLE_SET_ADDR_RESOLUTION_ENABLE);
+  uint8_t* pp = command->GetParameters();
   UINT8_TO_STREAM(pp, addr_resolution_enable);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_ble_set_rand_priv_addr_timeout(uint16_t rpa_timout) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_SET_RAND_PRIV_ADDR_TIMOUT;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_SET_RAND_PRIV_ADDR_TIMOUT);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_SET_RAND_PRIV_ADDR_TIMOUT);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_BLE_SET_RAND_PRIV_ADDR_TIMOUT,
+      HCIC_PARAM_SIZE_BLE_SET_RAND_PRIV_ADDR_TIMOUT);
+  uint8_t* pp = command->GetParameters();
   UINT16_TO_STREAM(pp, rpa_timout);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_ble_set_data_length(uint16_t conn_handle, uint16_t tx_octets,
                                     uint16_t tx_time) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_SET_DATA_LENGTH;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_SET_DATA_LENGTH);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_SET_DATA_LENGTH);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_BLE_SET_DATA_LENGTH, HCIC_PARAM_SIZE_BLE_SET_DATA_LENGTH);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, conn_handle);
   UINT16_TO_STREAM(pp, tx_octets);
   UINT16_TO_STREAM(pp, tx_time);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_ble_enh_rx_test(uint8_t rx_chan, uint8_t phy,
                                 uint8_t mod_index) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_ENH_RX_TEST;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_ENH_RECEIVER_TEST);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_ENH_RX_TEST);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_BLE_ENH_RECEIVER_TEST, HCIC_PARAM_SIZE_BLE_ENH_RX_TEST);
+  uint8_t* pp = command->GetParameters();
 
   UINT8_TO_STREAM(pp, rx_chan);
   UINT8_TO_STREAM(pp, phy);
   UINT8_TO_STREAM(pp, mod_index);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_ble_enh_tx_test(uint8_t tx_chan, uint8_t data_len,
                                 uint8_t payload, uint8_t phy) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_BLE_ENH_TX_TEST;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_BLE_ENH_TRANSMITTER_TEST);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_BLE_ENH_TX_TEST);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_BLE_ENH_TRANSMITTER_TEST, HCIC_PARAM_SIZE_BLE_ENH_TX_TEST);
+  uint8_t* pp = command->GetParameters();
   UINT8_TO_STREAM(pp, tx_chan);
   UINT8_TO_STREAM(pp, data_len);
   UINT8_TO_STREAM(pp, payload);
   UINT8_TO_STREAM(pp, phy);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_ble_set_extended_scan_params(uint8_t own_address_type,
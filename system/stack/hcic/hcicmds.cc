@@ -32,6 +32,7 @@
 #include "device/include/esco_parameters.h"
 #include "hcidefs.h"
 #include "hcimsgs.h"
+#include "main/shim/hci_command.h"
 #include "osi/include/allocator.h"
 #include "stack/include/acl_hci_link_interface.h"
 #include "stack/include/bt_hdr.h"
@@ -483,45 +484,30 @@ void bte_main_hci_send(BT_HDR* p_msg, uint16_t event);
 
 static void btsnd_hcic_inquiry(const LAP inq_lap, uint8_t duration,
                                uint8_t response_cnt) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_INQUIRY;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_INQUIRY);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_INQUIRY);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_INQUIRY, HCIC_PARAM_SIZE_INQUIRY);
+  uint8_t* pp = command->GetParameters();
 
   LAP_TO_STREAM(pp, inq_lap);
   UINT8_TO_STREAM(pp, duration);
   UINT8_TO_STREAM(pp, response_cnt);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 static void btsnd_hcic_inq_cancel(void) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_INQ_CANCEL;
-  p->offset = 0;
-  UINT16_TO_STREAM(pp, HCI_INQUIRY_CANCEL);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_INQ_CANCEL);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_INQUIRY_CANCEL, HCIC_PARAM_SIZE_INQ_CANCEL);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_per_inq_mode(uint16_t max_period, uint16_t min_period,
                              const LAP inq_lap, uint8_t duration,
                              uint8_t response_cnt) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_PER_INQ_MODE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_PERIODIC_INQUIRY_MODE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_PER_INQ_MODE);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_PERIODIC_INQUIRY_MODE, HCIC_PARAM_SIZE_PER_INQ_MODE);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, max_period);
   UINT16_TO_STREAM(pp, min_period);
@@ -529,19 +515,14 @@ void btsnd_hcic_per_inq_mode(uint16_t max_period, uint16_t min_period,
   UINT8_TO_STREAM(pp, duration);
   UINT8_TO_STREAM(pp, response_cnt);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_exit_per_inq(void) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_EXIT_PERIODIC_INQUIRY_MODE, HCIC_PARAM_SIZE_EXIT_PER_INQ);
 
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_EXIT_PER_INQ;
-  p->offset = 0;
-  UINT16_TO_STREAM(pp, HCI_EXIT_PERIODIC_INQUIRY_MODE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_EXIT_PER_INQ);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_create_conn(const RawAddress& dest, uint16_t packet_types,
@@ -565,112 +546,77 @@ void btsnd_hcic_create_conn(const RawAddress& dest, uint16_t packet_types,
 }
 
 static void btsnd_hcic_disconnect(uint16_t handle, uint8_t reason) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_DISCONNECT;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_DISCONNECT);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_DISCONNECT);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_DISCONNECT, HCIC_PARAM_SIZE_DISCONNECT);
+  uint8_t* pp = command->GetParameters();
   UINT16_TO_STREAM(pp, handle);
   UINT8_TO_STREAM(pp, reason);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_add_SCO_conn(uint16_t handle, uint16_t packet_types) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_ADD_SCO_CONN;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_ADD_SCO_CONNECTION);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_ADD_SCO_CONN);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_ADD_SCO_CONNECTION, HCIC_PARAM_SIZE_ADD_SCO_CONN);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, handle);
   UINT16_TO_STREAM(pp, packet_types);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_create_conn_cancel(const RawAddress& dest) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_CREATE_CONN_CANCEL;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_CREATE_CONNECTION_CANCEL);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_CREATE_CONN_CANCEL);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_CREATE_CONNECTION_CANCEL, HCIC_PARAM_SIZE_CREATE_CONN_CANCEL);
+  uint8_t* pp = command->GetParameters();
 
   BDADDR_TO_STREAM(pp, dest);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_accept_conn(const RawAddress& dest, uint8_t role) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_ACCEPT_CONN;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_ACCEPT_CONNECTION_REQUEST);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_ACCEPT_CONN);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_ACCEPT_CONNECTION_REQUEST, HCIC_PARAM_SIZE_ACCEPT_CONN);
+  uint8_t* pp = command->GetParameters();
   BDADDR_TO_STREAM(pp, dest);
   UINT8_TO_STREAM(pp, role);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_reject_conn(const RawAddress& dest, uint8_t reason) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_REJECT_CONN;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_REJECT_CONNECTION_REQUEST);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_REJECT_CONN);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_REJECT_CONNECTION_REQUEST, HCIC_PARAM_SIZE_REJECT_CONN);
+  uint8_t* pp = command->GetParameters();
 
   BDADDR_TO_STREAM(pp, dest);
   UINT8_TO_STREAM(pp, reason);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_link_key_req_reply(const RawAddress& bd_addr,
                                    const LinkKey& link_key) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_LINK_KEY_REQ_REPLY;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_LINK_KEY_REQUEST_REPLY);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_LINK_KEY_REQ_REPLY);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_LINK_KEY_REQUEST_REPLY, HCIC_PARAM_SIZE_LINK_KEY_REQ_REPLY);
+  uint8_t* pp = command->GetParameters();
 
   BDADDR_TO_STREAM(pp, bd_addr);
   ARRAY16_TO_STREAM(pp, link_key.data());
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_link_key_neg_reply(const RawAddress& bd_addr) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_LINK_KEY_NEG_REPLY;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_LINK_KEY_REQUEST_NEG_REPLY);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_LINK_KEY_NEG_REPLY);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_LINK_KEY_REQUEST_NEG_REPLY, HCIC_PARAM_SIZE_LINK_KEY_NEG_REPLY);
+  uint8_t* pp = command->GetParameters();
 
   BDADDR_TO_STREAM(pp, bd_addr);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_pin_code_req_reply(const RawAddress& bd_addr,
@@ -696,65 +642,45 @@ void btsnd_hcic_pin_code_req_reply(const RawAddress& bd_addr,
 }
 
 void btsnd_hcic_pin_code_neg_reply(const RawAddress& bd_addr) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_PIN_CODE_NEG_REPLY;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_PIN_CODE_REQUEST_NEG_REPLY);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_PIN_CODE_NEG_REPLY);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_PIN_CODE_REQUEST_NEG_REPLY, HCIC_PARAM_SIZE_PIN_CODE_NEG_REPLY);
+  uint8_t* pp = command->GetParameters();
 
   BDADDR_TO_STREAM(pp, bd_addr);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_change_conn_type(uint16_t handle, uint16_t packet_types) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_CHANGE_CONN_TYPE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_CHANGE_CONN_PACKET_TYPE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_CHANGE_CONN_TYPE);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_CHANGE_CONN_PACKET_TYPE, HCIC_PARAM_SIZE_CHANGE_CONN_TYPE);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, handle);
   UINT16_TO_STREAM(pp, packet_types);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_auth_request(uint16_t handle) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_CMD_HANDLE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_AUTHENTICATION_REQUESTED);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_CMD_HANDLE);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_AUTHENTICATION_REQUESTED, HCIC_PARAM_SIZE_CMD_HANDLE);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, handle);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_set_conn_encrypt(uint16_t handle, bool enable) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_SET_CONN_ENCRYPT;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_SET_CONN_ENCRYPTION);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_SET_CONN_ENCRYPT);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_SET_CONN_ENCRYPTION, HCIC_PARAM_SIZE_SET_CONN_ENCRYPT);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, handle);
   UINT8_TO_STREAM(pp, enable);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_rmt_name_req(const RawAddress& bd_addr,
@@ -778,108 +704,73 @@ void btsnd_hcic_rmt_name_req(const RawAddress& bd_addr,
 }
 
 void btsnd_hcic_rmt_name_req_cancel(const RawAddress& bd_addr) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_RMT_NAME_REQ_CANCEL;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_RMT_NAME_REQUEST_CANCEL);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_RMT_NAME_REQ_CANCEL);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_RMT_NAME_REQUEST_CANCEL, HCIC_PARAM_SIZE_RMT_NAME_REQ_CANCEL);
+  uint8_t* pp = command->GetParameters();
 
   BDADDR_TO_STREAM(pp, bd_addr);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_rmt_features_req(uint16_t handle) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_CMD_HANDLE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_READ_RMT_FEATURES);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_CMD_HANDLE);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_READ_RMT_FEATURES, HCIC_PARAM_SIZE_CMD_HANDLE);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, handle);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_rmt_ext_features(uint16_t handle, uint8_t page_num) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_RMT_EXT_FEATURES;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_READ_RMT_EXT_FEATURES);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_RMT_EXT_FEATURES);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_READ_RMT_EXT_FEATURES, HCIC_PARAM_SIZE_RMT_EXT_FEATURES);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, handle);
   UINT8_TO_STREAM(pp, page_num);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_rmt_ver_req(uint16_t handle) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_CMD_HANDLE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_READ_RMT_VERSION_INFO);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_CMD_HANDLE);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_READ_RMT_VERSION_INFO, HCIC_PARAM_SIZE_CMD_HANDLE);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, handle);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_read_rmt_clk_offset(uint16_t handle) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_CMD_HANDLE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_READ_RMT_CLOCK_OFFSET);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_CMD_HANDLE);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_READ_RMT_CLOCK_OFFSET, HCIC_PARAM_SIZE_CMD_HANDLE);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, handle);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_read_lmp_handle(uint16_t handle) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_CMD_HANDLE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_READ_LMP_HANDLE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_CMD_HANDLE);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_READ_LMP_HANDLE, HCIC_PARAM_SIZE_CMD_HANDLE);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, handle);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_setup_esco_conn(uint16_t handle, uint32_t transmit_bandwidth,
                                 uint32_t receive_bandwidth,
                                 uint16_t max_latency, uint16_t voice,
                                 uint8_t retrans_effort, uint16_t packet_types) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_SETUP_ESCO;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_SETUP_ESCO_CONNECTION);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_SETUP_ESCO);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_SETUP_ESCO_CONNECTION, HCIC_PARAM_SIZE_SETUP_ESCO);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, handle);
   UINT32_TO_STREAM(pp, transmit_bandwidth);
@@ -889,7 +780,7 @@ void btsnd_hcic_setup_esco_conn(uint16_t handle, uint32_t transmit_bandwidth,
   UINT8_TO_STREAM(pp, retrans_effort);
   UINT16_TO_STREAM(pp, packet_types);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_accept_esco_conn(const RawAddress& bd_addr,
@@ -898,14 +789,9 @@ void btsnd_hcic_accept_esco_conn(const RawAddress& bd_addr,
                                  uint16_t max_latency, uint16_t content_fmt,
                                  uint8_t retrans_effort,
                                  uint16_t packet_types) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_ACCEPT_ESCO;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_ACCEPT_ESCO_CONNECTION);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_ACCEPT_ESCO);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_ACCEPT_ESCO_CONNECTION, HCIC_PARAM_SIZE_ACCEPT_ESCO);
+  uint8_t* pp = command->GetParameters();
 
   BDADDR_TO_STREAM(pp, bd_addr);
   UINT32_TO_STREAM(pp, transmit_bandwidth);
@@ -915,54 +801,39 @@ void btsnd_hcic_accept_esco_conn(const RawAddress& bd_addr,
   UINT8_TO_STREAM(pp, retrans_effort);
   UINT16_TO_STREAM(pp, packet_types);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_reject_esco_conn(const RawAddress& bd_addr, uint8_t reason) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_REJECT_ESCO;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_REJECT_ESCO_CONNECTION);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_REJECT_ESCO);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_REJECT_ESCO_CONNECTION, HCIC_PARAM_SIZE_REJECT_ESCO);
+  uint8_t* pp = command->GetParameters();
 
   BDADDR_TO_STREAM(pp, bd_addr);
   UINT8_TO_STREAM(pp, reason);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_hold_mode(uint16_t handle, uint16_t max_hold_period,
                           uint16_t min_hold_period) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_HOLD_MODE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_HOLD_MODE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_HOLD_MODE);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_HOLD_MODE, HCIC_PARAM_SIZE_HOLD_MODE);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, handle);
   UINT16_TO_STREAM(pp, max_hold_period);
   UINT16_TO_STREAM(pp, min_hold_period);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_sniff_mode(uint16_t handle, uint16_t max_sniff_period,
                            uint16_t min_sniff_period, uint16_t sniff_attempt,
                            uint16_t sniff_timeout) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_SNIFF_MODE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_SNIFF_MODE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_SNIFF_MODE);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_SNIFF_MODE, HCIC_PARAM_SIZE_SNIFF_MODE);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, handle);
   UINT16_TO_STREAM(pp, max_sniff_period);
@@ -970,68 +841,48 @@ void btsnd_hcic_sniff_mode(uint16_t handle, uint16_t max_sniff_period,
   UINT16_TO_STREAM(pp, sniff_attempt);
   UINT16_TO_STREAM(pp, sniff_timeout);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_exit_sniff_mode(uint16_t handle) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_CMD_HANDLE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_EXIT_SNIFF_MODE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_CMD_HANDLE);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_EXIT_SNIFF_MODE, HCIC_PARAM_SIZE_CMD_HANDLE);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, handle);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_park_mode(uint16_t handle, uint16_t beacon_max_interval,
                           uint16_t beacon_min_interval) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_PARK_MODE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_PARK_MODE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_PARK_MODE);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_PARK_MODE, HCIC_PARAM_SIZE_PARK_MODE);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, handle);
   UINT16_TO_STREAM(pp, beacon_max_interval);
   UINT16_TO_STREAM(pp, beacon_min_interval);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_exit_park_mode(uint16_t handle) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_CMD_HANDLE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_EXIT_PARK_MODE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_CMD_HANDLE);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_EXIT_PARK_MODE, HCIC_PARAM_SIZE_CMD_HANDLE);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, handle);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_qos_setup(uint16_t handle, uint8_t flags, uint8_t service_type,
                           uint32_t token_rate, uint32_t peak, uint32_t latency,
                           uint32_t delay_var) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_QOS_SETUP;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_QOS_SETUP);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_QOS_SETUP);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_QOS_SETUP, HCIC_PARAM_SIZE_QOS_SETUP);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, handle);
   UINT8_TO_STREAM(pp, flags);
@@ -1041,52 +892,39 @@ void btsnd_hcic_qos_setup(uint16_t handle, uint8_t flags, uint8_t service_type,
   UINT32_TO_STREAM(pp, latency);
   UINT32_TO_STREAM(pp, delay_var);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 static void btsnd_hcic_switch_role(const RawAddress& bd_addr, uint8_t role) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_SWITCH_ROLE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_SWITCH_ROLE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_SWITCH_ROLE);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_SWITCH_ROLE, HCIC_PARAM_SIZE_SWITCH_ROLE);
+  uint8_t* pp = command->GetParameters();
 
   BDADDR_TO_STREAM(pp, bd_addr);
   UINT8_TO_STREAM(pp, role);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_write_policy_set(uint16_t handle, uint16_t settings) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_WRITE_POLICY_SET;
-  p->offset = 0;
-  UINT16_TO_STREAM(pp, HCI_WRITE_POLICY_SETTINGS);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_WRITE_POLICY_SET);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_WRITE_POLICY_SETTINGS, HCIC_PARAM_SIZE_WRITE_POLICY_SET);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, handle);
   UINT16_TO_STREAM(pp, settings);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_write_def_policy_set(uint16_t settings) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_WRITE_DEF_POLICY_SET;
-  p->offset = 0;
-  UINT16_TO_STREAM(pp, HCI_WRITE_DEF_POLICY_SETTINGS);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_WRITE_DEF_POLICY_SET);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_WRITE_DEF_POLICY_SETTINGS, HCIC_PARAM_SIZE_WRITE_DEF_POLICY_SET);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, settings);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_set_event_filter(uint8_t filt_type, uint8_t filt_cond_type,
@@ -1131,35 +969,25 @@ void btsnd_hcic_set_event_filter(uint8_t filt_type, uint8_t filt_cond_type,
 }
 
 void btsnd_hcic_write_pin_type(uint8_t type) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_WRITE_PARAM1;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_WRITE_PIN_TYPE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_WRITE_PARAM1);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_WRITE_PIN_TYPE, HCIC_PARAM_SIZE_WRITE_PARAM1);
+  uint8_t* pp = command->GetParameters();
 
   UINT8_TO_STREAM(pp, type);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_delete_stored_key(const RawAddress& bd_addr,
                                   bool delete_all_flag) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_DELETE_STORED_KEY;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_DELETE_STORED_LINK_KEY);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_DELETE_STORED_KEY);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_DELETE_STORED_LINK_KEY, HCIC_PARAM_SIZE_DELETE_STORED_KEY);
+  uint8_t* pp = command->GetParameters();
 
   BDADDR_TO_STREAM(pp, bd_addr);
   UINT8_TO_STREAM(pp, delete_all_flag);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_change_name(BD_NAME name) {
@@ -1183,155 +1011,105 @@ void btsnd_hcic_change_name(BD_NAME name) {
 }
 
 void btsnd_hcic_read_name(void) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_READ_CMD;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_READ_LOCAL_NAME);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_READ_CMD);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_READ_LOCAL_NAME, HCIC_PARAM_SIZE_READ_CMD);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_write_page_tout(uint16_t timeout) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_WRITE_PARAM2;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_WRITE_PAGE_TOUT);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_WRITE_PARAM2);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_WRITE_PAGE_TOUT, HCIC_PARAM_SIZE_WRITE_PARAM2);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, timeout);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_write_scan_enable(uint8_t flag) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_WRITE_PARAM1;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_WRITE_SCAN_ENABLE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_WRITE_PARAM1);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_WRITE_SCAN_ENABLE, HCIC_PARAM_SIZE_WRITE_PARAM1);
+  uint8_t* pp = command->GetParameters();
 
   UINT8_TO_STREAM(pp, flag);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_write_pagescan_cfg(uint16_t interval, uint16_t window) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_WRITE_PAGESCAN_CFG;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_WRITE_PAGESCAN_CFG);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_WRITE_PAGESCAN_CFG);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_WRITE_PAGESCAN_CFG, HCIC_PARAM_SIZE_WRITE_PAGESCAN_CFG);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, interval);
   UINT16_TO_STREAM(pp, window);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_write_inqscan_cfg(uint16_t interval, uint16_t window) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_WRITE_INQSCAN_CFG;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_WRITE_INQUIRYSCAN_CFG);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_WRITE_INQSCAN_CFG);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_WRITE_INQUIRYSCAN_CFG, HCIC_PARAM_SIZE_WRITE_INQSCAN_CFG);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, interval);
   UINT16_TO_STREAM(pp, window);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_write_auth_enable(uint8_t flag) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_WRITE_PARAM1;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_WRITE_AUTHENTICATION_ENABLE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_WRITE_PARAM1);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_WRITE_AUTHENTICATION_ENABLE, HCIC_PARAM_SIZE_WRITE_PARAM1);
+  uint8_t* pp = command->GetParameters();
 
   UINT8_TO_STREAM(pp, flag);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_write_dev_class(DEV_CLASS dev_class) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_WRITE_PARAM3;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_WRITE_CLASS_OF_DEVICE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_WRITE_PARAM3);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_WRITE_CLASS_OF_DEVICE, HCIC_PARAM_SIZE_WRITE_PARAM3);
+  uint8_t* pp = command->GetParameters();
 
   DEVCLASS_TO_STREAM(pp, dev_class);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_write_voice_settings(uint16_t flags) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_WRITE_PARAM2;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_WRITE_VOICE_SETTINGS);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_WRITE_PARAM2);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_WRITE_VOICE_SETTINGS, HCIC_PARAM_SIZE_WRITE_PARAM2);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, flags);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_write_auto_flush_tout(uint16_t handle, uint16_t tout) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_WRITE_AUTOMATIC_FLUSH_TIMEOUT;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_WRITE_AUTOMATIC_FLUSH_TIMEOUT);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_WRITE_AUTOMATIC_FLUSH_TIMEOUT);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_WRITE_AUTOMATIC_FLUSH_TIMEOUT,
+      HCIC_PARAM_SIZE_WRITE_AUTOMATIC_FLUSH_TIMEOUT);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, handle);
   UINT16_TO_STREAM(pp, tout);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_read_tx_power(uint16_t handle, uint8_t type) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_READ_TX_POWER;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_READ_TRANSMIT_POWER_LEVEL);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_READ_TX_POWER);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_READ_TRANSMIT_POWER_LEVEL, HCIC_PARAM_SIZE_READ_TX_POWER);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, handle);
   UINT8_TO_STREAM(pp, type);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_host_num_xmitted_pkts(uint8_t num_handles, uint16_t* handle,
@@ -1356,19 +1134,14 @@ void btsnd_hcic_host_num_xmitted_pkts(uint8_t num_handles, uint16_t* handle,
 }
 
 void btsnd_hcic_write_link_super_tout(uint16_t handle, uint16_t timeout) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_WRITE_LINK_SUPER_TOUT;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_WRITE_LINK_SUPER_TOUT);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_WRITE_LINK_SUPER_TOUT);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_WRITE_LINK_SUPER_TOUT, HCIC_PARAM_SIZE_WRITE_LINK_SUPER_TOUT);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, handle);
   UINT16_TO_STREAM(pp, timeout);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_write_cur_iac_lap(uint8_t num_cur_iac, LAP* const iac_lap) {
@@ -1394,21 +1167,16 @@ void btsnd_hcic_write_cur_iac_lap(uint8_t num_cur_iac, LAP* const iac_lap) {
 void btsnd_hcic_sniff_sub_rate(uint16_t handle, uint16_t max_lat,
                                uint16_t min_remote_lat,
                                uint16_t min_local_lat) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_SNIFF_SUB_RATE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_SNIFF_SUB_RATE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_SNIFF_SUB_RATE);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_SNIFF_SUB_RATE, HCIC_PARAM_SIZE_SNIFF_SUB_RATE);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, handle);
   UINT16_TO_STREAM(pp, max_lat);
   UINT16_TO_STREAM(pp, min_remote_lat);
   UINT16_TO_STREAM(pp, min_local_lat);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 /**** Extended Inquiry Response Commands ****/
@@ -1429,33 +1197,23 @@ void btsnd_hcic_write_ext_inquiry_response(void* buffer, uint8_t fec_req) {
 
 void btsnd_hcic_io_cap_req_reply(const RawAddress& bd_addr, uint8_t capability,
                                  uint8_t oob_present, uint8_t auth_req) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_IO_CAP_RESP;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_IO_CAPABILITY_REQUEST_REPLY);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_IO_CAP_RESP);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_IO_CAPABILITY_REQUEST_REPLY, HCIC_PARAM_SIZE_IO_CAP_RESP);
+  uint8_t* pp = command->GetParameters();
 
   BDADDR_TO_STREAM(pp, bd_addr);
   UINT8_TO_STREAM(pp, capability);
   UINT8_TO_STREAM(pp, oob_present);
   UINT8_TO_STREAM(pp, auth_req);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_enhanced_set_up_synchronous_connection(
     uint16_t conn_handle, enh_esco_params_t* p_params) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_ENH_SET_ESCO_CONN;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_ENH_SETUP_ESCO_CONNECTION);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_ENH_SET_ESCO_CONN);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_ENH_SETUP_ESCO_CONNECTION, HCIC_PARAM_SIZE_ENH_SET_ESCO_CONN);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, conn_handle);
   UINT32_TO_STREAM(pp, p_params->transmit_bandwidth);
@@ -1492,19 +1250,14 @@ void btsnd_hcic_enhanced_set_up_synchronous_connection(
   UINT16_TO_STREAM(pp, p_params->packet_types);
   UINT8_TO_STREAM(pp, p_params->retransmission_effort);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_enhanced_accept_synchronous_connection(
     const RawAddress& bd_addr, enh_esco_params_t* p_params) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_ENH_ACC_ESCO_CONN;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_ENH_ACCEPT_ESCO_CONNECTION);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_ENH_ACC_ESCO_CONN);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_ENH_ACCEPT_ESCO_CONNECTION, HCIC_PARAM_SIZE_ENH_ACC_ESCO_CONN);
+  uint8_t* pp = command->GetParameters();
 
   BDADDR_TO_STREAM(pp, bd_addr);
   UINT32_TO_STREAM(pp, p_params->transmit_bandwidth);
@@ -1541,37 +1294,26 @@ void btsnd_hcic_enhanced_accept_synchronous_connection(
   UINT16_TO_STREAM(pp, p_params->packet_types);
   UINT8_TO_STREAM(pp, p_params->retransmission_effort);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_io_cap_req_neg_reply(const RawAddress& bd_addr,
                                      uint8_t err_code) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_IO_CAP_NEG_REPLY;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_IO_CAP_REQ_NEG_REPLY);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_IO_CAP_NEG_REPLY);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_IO_CAP_REQ_NEG_REPLY, HCIC_PARAM_SIZE_IO_CAP_NEG_REPLY);
+  uint8_t* pp = command->GetParameters();
 
   BDADDR_TO_STREAM(pp, bd_addr);
   UINT8_TO_STREAM(pp, err_code);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_read_local_oob_data(void) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_READ_LOCAL_OOB_DATA, HCIC_PARAM_SIZE_R_LOCAL_OOB);
 
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_R_LOCAL_OOB;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_READ_LOCAL_OOB_DATA);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_R_LOCAL_OOB);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_user_conf_reply(const RawAddress& bd_addr, bool is_yes) {
@@ -1597,113 +1339,78 @@ void btsnd_hcic_user_conf_reply(const RawAddress& bd_addr, bool is_yes) {
 }
 
 void btsnd_hcic_user_passkey_reply(const RawAddress& bd_addr, uint32_t value) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_U_PKEY_REPLY;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_USER_PASSKEY_REQ_REPLY);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_U_PKEY_REPLY);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_USER_PASSKEY_REQ_REPLY, HCIC_PARAM_SIZE_U_PKEY_REPLY);
+  uint8_t* pp = command->GetParameters();
 
   BDADDR_TO_STREAM(pp, bd_addr);
   UINT32_TO_STREAM(pp, value);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_user_passkey_neg_reply(const RawAddress& bd_addr) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_U_PKEY_NEG_REPLY;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_USER_PASSKEY_REQ_NEG_REPLY);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_U_PKEY_NEG_REPLY);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_USER_PASSKEY_REQ_NEG_REPLY, HCIC_PARAM_SIZE_U_PKEY_NEG_REPLY);
+  uint8_t* pp = command->GetParameters();
 
   BDADDR_TO_STREAM(pp, bd_addr);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_rem_oob_reply(const RawAddress& bd_addr, const Octet16& c,
                               const Octet16& r) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_REM_OOB_REPLY;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_REM_OOB_DATA_REQ_REPLY);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_REM_OOB_REPLY);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_REM_OOB_DATA_REQ_REPLY, HCIC_PARAM_SIZE_REM_OOB_REPLY);
+  uint8_t* pp = command->GetParameters();
 
   BDADDR_TO_STREAM(pp, bd_addr);
   ARRAY16_TO_STREAM(pp, c.data());
   ARRAY16_TO_STREAM(pp, r.data());
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_rem_oob_neg_reply(const RawAddress& bd_addr) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_REM_OOB_NEG_REPLY;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_REM_OOB_DATA_REQ_NEG_REPLY);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_REM_OOB_NEG_REPLY);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_REM_OOB_DATA_REQ_NEG_REPLY, HCIC_PARAM_SIZE_REM_OOB_NEG_REPLY);
+  uint8_t* pp = command->GetParameters();
 
   BDADDR_TO_STREAM(pp, bd_addr);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_read_inq_tx_power(void) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_R_TX_POWER;
-  p->offset = 0;
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_READ_INQ_TX_POWER_LEVEL, HCIC_PARAM_SIZE_R_TX_POWER);
 
-  UINT16_TO_STREAM(pp, HCI_READ_INQ_TX_POWER_LEVEL);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_R_TX_POWER);
-
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_send_keypress_notif(const RawAddress& bd_addr, uint8_t notif) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_SEND_KEYPRESS_NOTIF;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_SEND_KEYPRESS_NOTIF);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_SEND_KEYPRESS_NOTIF);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_SEND_KEYPRESS_NOTIF, HCIC_PARAM_SIZE_SEND_KEYPRESS_NOTIF);
+  uint8_t* pp = command->GetParameters();
 
   BDADDR_TO_STREAM(pp, bd_addr);
   UINT8_TO_STREAM(pp, notif);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 /**** end of Simple Pairing Commands ****/
 
 void btsnd_hcic_enhanced_flush(uint16_t handle, uint8_t packet_type) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_ENHANCED_FLUSH;
-  p->offset = 0;
-  UINT16_TO_STREAM(pp, HCI_ENHANCED_FLUSH);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_ENHANCED_FLUSH);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_ENHANCED_FLUSH, HCIC_PARAM_SIZE_ENHANCED_FLUSH);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, handle);
   UINT8_TO_STREAM(pp, packet_type);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 /*************************
@@ -1711,33 +1418,23 @@ void btsnd_hcic_enhanced_flush(uint16_t handle, uint8_t packet_type) {
  *************************/
 
 void btsnd_hcic_get_link_quality(uint16_t handle) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_CMD_HANDLE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_GET_LINK_QUALITY);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_CMD_HANDLE);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_GET_LINK_QUALITY, HCIC_PARAM_SIZE_CMD_HANDLE);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, handle);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_read_rssi(uint16_t handle) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_CMD_HANDLE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_READ_RSSI);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_CMD_HANDLE);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_READ_RSSI, HCIC_PARAM_SIZE_CMD_HANDLE);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, handle);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 static void read_encryption_key_size_complete(ReadEncKeySizeCb cb, uint8_t* return_parameters,
@@ -1765,91 +1462,60 @@ void btsnd_hcic_read_encryption_key_size(uint16_t handle, ReadEncKeySizeCb cb) {
 }
 
 void btsnd_hcic_read_failed_contact_counter(uint16_t handle) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_CMD_HANDLE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_READ_FAILED_CONTACT_COUNTER);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_CMD_HANDLE);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_READ_FAILED_CONTACT_COUNTER, HCIC_PARAM_SIZE_CMD_HANDLE);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, handle);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_read_automatic_flush_timeout(uint16_t handle) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_CMD_HANDLE;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_READ_AUTOMATIC_FLUSH_TIMEOUT);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_CMD_HANDLE);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_READ_AUTOMATIC_FLUSH_TIMEOUT, HCIC_PARAM_SIZE_CMD_HANDLE);
+  uint8_t* pp = command->GetParameters();
 
   UINT16_TO_STREAM(pp, handle);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_enable_test_mode(void) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_READ_CMD;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_ENABLE_DEV_UNDER_TEST_MODE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_READ_CMD);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_ENABLE_DEV_UNDER_TEST_MODE, HCIC_PARAM_SIZE_READ_CMD);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_write_inqscan_type(uint8_t type) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_WRITE_PARAM1;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_WRITE_INQSCAN_TYPE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_WRITE_PARAM1);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_WRITE_INQSCAN_TYPE, HCIC_PARAM_SIZE_WRITE_PARAM1);
+  uint8_t* pp = command->GetParameters();
 
   UINT8_TO_STREAM(pp, type);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_write_inquiry_mode(uint8_t mode) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_WRITE_PARAM1;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_WRITE_INQUIRY_MODE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_WRITE_PARAM1);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_WRITE_INQUIRY_MODE, HCIC_PARAM_SIZE_WRITE_PARAM1);
+  uint8_t* pp = command->GetParameters();
 
   UINT8_TO_STREAM(pp, mode);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 void btsnd_hcic_write_pagescan_type(uint8_t type) {
-  BT_HDR* p = (BT_HDR*)osi_malloc(HCI_CMD_BUF_SIZE);
-  uint8_t* pp = (uint8_t*)(p + 1);
-
-  p->len = HCIC_PREAMBLE_SIZE + HCIC_PARAM_SIZE_WRITE_PARAM1;
-  p->offset = 0;
-
-  UINT16_TO_STREAM(pp, HCI_WRITE_PAGESCAN_TYPE);
-  UINT8_TO_STREAM(pp, HCIC_PARAM_SIZE_WRITE_PARAM1);
+  auto command = bluetooth::shim::LegacyCommandBuilder::Create(
+      HCI_WRITE_PAGESCAN_TYPE, HCIC_PARAM_SIZE_WRITE_PARAM1);
+  uint8_t* pp = command->GetParameters();
 
   UINT8_TO_STREAM(pp, type);
 
-  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, p);
+  btu_hcif_send_cmd(LOCAL_BR_EDR_CONTROLLER_ID, std::move(command));
 }
 
 /* Must have room to store BT_HDR + max VSC length + callback pointer */
@@ -79,3 +79,6 @@ void btm_pm_on_sniff_subrating(tHCI_STATUS status, uint16_t handle,
                                uint16_t maximum_receive_latency,
                                uint16_t minimum_remote_timeout,
                                uint16_t minimum_local_timeout);
+
+/* A packet of the link |handle| was sent to or received from the controller */
+void btm_pm_on_acl_traffic(uint16_t handle);
@@ -97,6 +97,16 @@ inline std::string avdt_result_text(const tAVDT_RESULT& result) {
 */
 #define AVDT_MEDIA_OFFSET 23
 
+/* The size in bytes of the content protection header a media packet starts
+ * with when SCMS-T is used.  It is placed after AVDT_MEDIA_OFFSET in the
+ * buffers from AVDT_AllocMediaPacket().
+*/
+#if (BTA_AV_CO_CP_SCMS_T == TRUE)
+#define AVDT_MEDIA_CP_HDR_SIZE 1
+#else
+#define AVDT_MEDIA_CP_HDR_SIZE 0
+#endif
+
 /* The marker bit is used by the application to mark significant events such
  * as frame boundaries in the data stream.  This constant is used to check or
  * set the marker bit in the m_pt parameter of an AVDT_WriteReq()
@@ -830,6 +840,35 @@ extern uint16_t AVDT_SecurityRsp(uint8_t handle, uint8_t label,
                                  uint8_t error_code, uint8_t* p_data,
                                  uint16_t len);
 
+/*******************************************************************************
+ *
+ * Function         AVDT_AllocMediaPacket
+ *
+ * Description      Allocate a buffer for a media packet.  Its offset leaves
+ *                  room for the media packet, L2CAP and HCI ACL headers, the
+ *                  content protection header if any, then codec_hdr_len bytes
+ *                  for the header of the codec.  The codec writes its frames
+ *                  at the offset and prepends its header, AVDTP and L2CAP
+ *                  prepend theirs in place: the packet is never copied to
+ *                  make room for a header.
+ *
+ * Returns          The buffer, of BT_DEFAULT_BUFFER_SIZE with a zero len.
+ *
+ ******************************************************************************/
+extern BT_HDR* AVDT_AllocMediaPacket(uint16_t codec_hdr_len);
+
+/*******************************************************************************
+ *
+ * Function         AVDT_MediaPacketPayloadSize
+ *
+ * Description      The number of bytes of codec frames a buffer allocated by
+ *                  AVDT_AllocMediaPacket() can hold.
+ *
+ * Returns          The payload size in bytes.
+ *
+ ******************************************************************************/
+extern uint16_t AVDT_MediaPacketPayloadSize(uint16_t codec_hdr_len);
+
 /*******************************************************************************
  *
  * Function         AVDT_WriteReqOpt
@@ -853,7 +892,8 @@ extern uint16_t AVDT_SecurityRsp(uint8_t handle, uint8_t label,
  *                  field must be equal to or greater than AVDT_MEDIA_OFFSET
  *                  (if NO_RTP is specified, L2CAP_MIN_OFFSET can be used)
  *                  This allows enough space in the buffer for the L2CAP and
- *                  AVDTP headers.
+ *                  AVDTP headers.  AVDT_AllocMediaPacket() makes such
+ *                  buffers; a packet with less room is copied into one.
  *
  *                  The memory pointed to by p_pkt must be a GKI buffer
  *                  allocated by the application.  This buffer will be freed
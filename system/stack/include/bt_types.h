@@ -91,6 +91,7 @@
 /* ISO Layer specific */
 #define BT_ISO_HDR_CONTAINS_TS (0x0001)
 #define BT_ISO_HDR_OFFSET_POINTS_DATA (0x0002)
+#define BT_ISO_HDR_POOLED (0x0004)
 
 enum {
   BT_PSM_SDP = 0x0001,
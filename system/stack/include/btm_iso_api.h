@@ -165,6 +165,23 @@ class IsoManager {
   virtual void SendIsoData(uint16_t conn_handle, const uint8_t* data,
                            uint16_t data_len);
 
+  /**
+   * Returns the buffer of the next SDU, for the encoder to write its data in
+   * place. The SDU is sent with SendIsoSduBuffer().
+   *
+   * @param conn_handle handle of BIS or CIS connection
+   * @param data_len SDU length
+   * @return buffer of data_len bytes, or nullptr if the SDU would be dropped
+   */
+  virtual uint8_t* GetIsoSduBuffer(uint16_t conn_handle, uint16_t data_len);
+
+  /**
+   * Sends the SDU written in the buffer returned by GetIsoSduBuffer()
+   *
+   * @param conn_handle handle of BIS or CIS connection
+   */
+  virtual void SendIsoSduBuffer(uint16_t conn_handle);
+
   /**
    * Creates the Broadcast Isochronous Group
    *
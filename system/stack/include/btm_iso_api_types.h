@@ -17,6 +17,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 #include "hcimsgs.h"
@@ -126,10 +127,38 @@ struct cis_establish_cmpl_evt {
   uint16_t iso_itv;
 };
 
+/* Timing of the SDUs sent on an ISO data path, and of the SDUs received */
+struct iso_data_path_stats {
+  size_t sent_sdus = 0;
+  /* Sent in the SDU interval of the previous SDU, past its anchor */
+  size_t late_sdus = 0;
+  /* Dropped for lack of controller buffer credits */
+  size_t dropped_sdus = 0;
+  /* SDU intervals without any SDU sent */
+  size_t missed_intervals = 0;
+
+  /* From the SDU buffer handed out to the encoder until its send */
+  uint64_t encode_us_total = 0;
+  uint64_t encode_us_max = 0;
+
+  /* From the send until the controller reports the SDU completed */
+  size_t queue_samples = 0;
+  uint64_t queue_us_total = 0;
+  uint64_t queue_us_max = 0;
+
+  /* Max. number of SDUs waiting for their completion in the controller */
+  uint16_t max_used_credits = 0;
+
+  /* SDUs missing from the sequence numbers of the received SDUs */
+  size_t rx_seq_nb_gaps = 0;
+};
+
 struct cis_disconnected_evt {
   uint8_t reason;
   uint8_t cig_id;
   uint16_t cis_conn_hdl;
+  /* Data path statistics since the CIS has been established */
+  iso_data_path_stats data_path_stats;
 };
 
 struct big_create_params {
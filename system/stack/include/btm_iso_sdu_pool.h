@@ -0,0 +1,127 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "osi/include/allocator.h"
+#include "stack/include/bt_hdr.h"
+#include "stack/include/bt_types.h"
+
+namespace bluetooth {
+namespace hci {
+namespace iso_manager {
+
+/* Recycles the buffers of the outgoing ISO SDUs.
+ *
+ * The HCI layer frees the SDUs on its own thread, once they are copied to the
+ * controller queue. The pooled buffers are flagged with BT_ISO_HDR_POOLED and
+ * handed back with Release(), so that a stream in steady state doesn't
+ * allocate. A pooled buffer freed with osi_free() is only lost to the pool.
+ *
+ * The number of SDUs in flight is bounded by the controller ISO credits, so a
+ * few buffers shared by all the CISes and BISes are enough.
+ */
+class IsoSduPool {
+ public:
+  /* Largest HCI ISO packet held by a pooled buffer. Covers the stereo LC3
+   * frames at the highest bitrates, larger packets are not pooled.
+   */
+  static constexpr size_t kMaxPacketLen = 640;
+  static constexpr size_t kBufferSize = sizeof(BT_HDR) + kMaxPacketLen;
+  static constexpr size_t kMaxFreeBuffers = 16;
+
+  struct Stats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t free = 0;
+  };
+
+  IsoSduPool() { free_.reserve(kMaxFreeBuffers); }
+
+  /* Returns a buffer for an HCI ISO packet of |len| bytes */
+  BT_HDR* Acquire(size_t len) {
+    BT_HDR* packet = nullptr;
+    if (len <= kMaxPacketLen) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!free_.empty()) {
+          packet = free_.back();
+          free_.pop_back();
+        }
+      }
+      if (packet == nullptr) {
+        misses_++;
+        packet = static_cast<BT_HDR*>(osi_malloc(kBufferSize));
+      } else {
+        hits_++;
+      }
+      packet->layer_specific = BT_ISO_HDR_POOLED;
+    } else {
+      packet = static_cast<BT_HDR*>(osi_malloc(sizeof(BT_HDR) + len));
+      packet->layer_specific = 0;
+    }
+    packet->len = len;
+    packet->offset = 0;
+    return packet;
+  }
+
+  /* Frees the ISO packet, or keeps its buffer for the next SDUs. Can be called
+   * from any thread.
+   */
+  void Release(BT_HDR* packet) {
+    if (packet->layer_specific & BT_ISO_HDR_POOLED) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (free_.size() < kMaxFreeBuffers) {
+        free_.push_back(packet);
+        return;
+      }
+    }
+    osi_free(packet);
+  }
+
+  Stats GetStats() {
+    Stats stats;
+    stats.hits = hits_;
+    stats.misses = misses_;
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats.free = free_.size();
+    return stats;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<BT_HDR*> free_;
+  std::atomic_size_t hits_{0};
+  std::atomic_size_t misses_{0};
+};
+
+/* The pool is never destroyed, the HCI thread may release buffers during the
+ * shutdown.
+ */
+inline IsoSduPool& GetIsoSduPool() {
+  static IsoSduPool* pool = new IsoSduPool();
+  return *pool;
+}
+
+}  // namespace iso_manager
+}  // namespace hci
+}  // namespace bluetooth
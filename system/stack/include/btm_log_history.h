@@ -17,15 +17,16 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
 #include "types/ble_address_with_type.h"
 #include "types/raw_address.h"
 
-void BTM_LogHistory(const std::string& tag, const RawAddress& addr,
-                    const std::string& msg);
-void BTM_LogHistory(const std::string& tag, const RawAddress& addr,
-                    const std::string& msg, const std::string& extra);
-void BTM_LogHistory(const std::string& tag, const tBLE_BD_ADDR& addr,
-                    const std::string& msg);
-void BTM_LogHistory(const std::string& tag, const tBLE_BD_ADDR& addr,
-                    const std::string& msg, const std::string& extra);
+void BTM_LogHistory(std::string_view tag, const RawAddress& addr,
+                    std::string_view msg);
+void BTM_LogHistory(std::string_view tag, const RawAddress& addr,
+                    std::string_view msg, std::string_view extra);
+void BTM_LogHistory(std::string_view tag, const tBLE_BD_ADDR& addr,
+                    std::string_view msg);
+void BTM_LogHistory(std::string_view tag, const tBLE_BD_ADDR& addr,
+                    std::string_view msg, std::string_view extra);
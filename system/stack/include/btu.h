@@ -32,6 +32,7 @@
 #include <base/threading/thread.h>
 
 #include <cstdint>
+#include <memory>
 
 #include "bt_target.h"
 #include "common/message_loop_thread.h"
@@ -49,6 +50,12 @@ extern uint8_t btu_trace_level;
 void btu_hcif_process_event(UNUSED_ATTR uint8_t controller_id,
                             const BT_HDR* p_buf);
 void btu_hcif_send_cmd(UNUSED_ATTR uint8_t controller_id, const BT_HDR* p_msg);
+namespace bluetooth::shim {
+class LegacyCommandBuilder;
+}  // namespace bluetooth::shim
+void btu_hcif_send_cmd(
+    UNUSED_ATTR uint8_t controller_id,
+    std::unique_ptr<bluetooth::shim::LegacyCommandBuilder> command);
 void btu_hcif_send_cmd_with_cb(const base::Location& posted_from,
                                uint16_t opcode, uint8_t* params,
                                uint8_t params_len,
@@ -68,6 +75,11 @@ bt_status_t do_in_main_thread(const base::Location& from_here,
 bt_status_t do_in_main_thread_delayed(const base::Location& from_here,
                                       base::OnceClosure task,
                                       const base::TimeDelta& delay);
+// Post |task| ahead of (high), or behind (low), the tasks of normal priority
+// waiting on the main thread
+bt_status_t do_in_main_thread_with_priority(
+    const base::Location& from_here, base::OnceClosure task,
+    bluetooth::common::MessageLoopThread::Priority priority);
 
 bool is_on_main_thread();
 using BtMainClosure = std::function<void()>;
@@ -22,6 +22,7 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "bt_target.h"
 #include "btm_ble_api.h"
@@ -437,6 +438,14 @@ typedef struct {
   uint8_t value[GATT_MAX_ATTR_LEN]; /* the actual attribute value */
 } tGATT_VALUE;
 
+/* Attribute value notified to several clients at once
+*/
+typedef struct {
+  uint16_t handle; /* attribute handle */
+  uint16_t len;    /* length of attribute value */
+  const uint8_t* p_value;
+} tGATTS_NOTIF_VALUE;
+
 /* Union of the event data which is used in the server respond API to carry the
  * server response information
 */
@@ -866,6 +875,28 @@ extern tGATT_STATUS GATTS_HandleValueNotification(uint16_t conn_id,
                                                   uint16_t val_len,
                                                   uint8_t* p_val);
 
+/*******************************************************************************
+ *
+ * Function         GATTS_HandleMultipleValueNotification
+ *
+ * Description      This function sends the same attribute values as
+ *                  notifications to several clients. The PDUs are built once
+ *                  for all the clients sharing the same payload size, as
+ *                  Multiple Handle Value Notifications for the clients
+ *                  supporting them, one Handle Value Notification per value
+ *                  otherwise.
+ *
+ * Parameter        conn_ids: connection identifiers of the clients.
+ *                  values: attribute values to notify.
+ *
+ * Returns          the status of each connection, in the order of conn_ids,
+ *                  GATT_SUCCESS if sucessfully sent; otherwise error code.
+ *
+ ******************************************************************************/
+extern std::vector<tGATT_STATUS> GATTS_HandleMultipleValueNotification(
+    const std::vector<uint16_t>& conn_ids,
+    const std::vector<tGATTS_NOTIF_VALUE>& values);
+
 /*******************************************************************************
  *
  * Function         GATTS_SendRsp
@@ -924,6 +955,20 @@ extern tGATT_STATUS GATTC_Discover(uint16_t conn_id, tGATT_DISC_TYPE disc_type,
 extern tGATT_STATUS GATTC_Discover(uint16_t conn_id, tGATT_DISC_TYPE disc_type,
                                    uint16_t start_handle, uint16_t end_handle);
 
+/*******************************************************************************
+ *
+ * Function         GATTC_IsReadMultiVarLenSupported
+ *
+ * Description      This function is called to check if the server supports the
+ *                  Read Multiple Variable Length request.
+ *
+ * Parameters       conn_id: connection identifier.
+ *
+ * Returns          true if the request can be sent to the server.
+ *
+ ******************************************************************************/
+extern bool GATTC_IsReadMultiVarLenSupported(uint16_t conn_id);
+
 /*******************************************************************************
  *
  * Function         GATTC_Read
@@ -1174,6 +1219,9 @@ extern void gatt_init(void);
 // Frees resources used by the GATT profile.
 extern void gatt_free(void);
 
+// Dumps the client command queues of the ATT and EATT bearers.
+extern void gatt_debug_dump(int fd);
+
 // Link encryption complete notification for all encryption process
 // initiated outside GATT.
 extern void gatt_notify_enc_cmpl(const RawAddress& bd_addr);
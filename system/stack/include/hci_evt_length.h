@@ -281,3 +281,45 @@ static const uint8_t hci_event_parameters_minimum_length[] = {
     0,    //  0xFE - N/A
     0,    //  0xFF - HCI_Vendor_Specific Event
 };
+
+/*
+ *  Definitions for HCI LE Meta Event Parameter Minimum Length, without the
+ *  Subevent_Code
+ */
+static const uint8_t hci_le_subevent_parameters_minimum_length[] = {
+    0,   //  0x00 - N/A
+    18,  //  0x01 - HCI_LE_Connection_Complete Event
+    11,  //  0x02 - HCI_LE_Advertising_Report Event (Num_Reports = 1)
+    9,   //  0x03 - HCI_LE_Connection_Update_Complete Event
+    11,  //  0x04 - HCI_LE_Read_Remote_Features_Complete Event
+    12,  //  0x05 - HCI_LE_Long_Term_Key_Request Event
+    10,  //  0x06 - HCI_LE_Remote_Connection_Parameter_Request Event
+    10,  //  0x07 - HCI_LE_Data_Length_Change Event
+    65,  //  0x08 - HCI_LE_Read_Local_P-256_Public_Key_Complete Event
+    33,  //  0x09 - HCI_LE_Generate_DHKey_Complete Event
+    30,  //  0x0A - HCI_LE_Enhanced_Connection_Complete Event
+    17,  //  0x0B - HCI_LE_Directed_Advertising_Report Event (Num_Reports = 1)
+    5,   //  0x0C - HCI_LE_PHY_Update_Complete Event
+    25,  //  0x0D - HCI_LE_Extended_Advertising_Report Event (Num_Reports = 1)
+    15,  //  0x0E - HCI_LE_Periodic_Advertising_Sync_Established Event
+    7,   //  0x0F - HCI_LE_Periodic_Advertising_Report Event
+    2,   //  0x10 - HCI_LE_Periodic_Advertising_Sync_Lost Event
+    0,   //  0x11 - HCI_LE_Scan_Timeout Event
+    5,   //  0x12 - HCI_LE_Advertising_Set_Terminated Event
+    8,   //  0x13 - HCI_LE_Scan_Request_Received Event
+    3,   //  0x14 - HCI_LE_Channel_Selection_Algorithm Event
+    12,  //  0x15 - HCI_LE_Connectionless_IQ_Report Event (Sample_Count = 0)
+    13,  //  0x16 - HCI_LE_Connection_IQ_Report Event (Sample_Count = 0)
+    3,   //  0x17 - HCI_LE_CTE_Request_Failed Event
+    19,  //  0x18 - HCI_LE_Periodic_Advertising_Sync_Transfer_Received Event
+    28,  //  0x19 - HCI_LE_CIS_Established Event
+    6,   //  0x1A - HCI_LE_CIS_Request Event
+    18,  //  0x1B - HCI_LE_Create_BIG_Complete Event (Num_BIS = 0)
+    2,   //  0x1C - HCI_LE_Terminate_BIG_Complete Event
+    14,  //  0x1D - HCI_LE_BIG_Sync_Established Event (Num_BIS = 0)
+    2,   //  0x1E - HCI_LE_BIG_Sync_Lost Event
+    4,   //  0x1F - HCI_LE_Request_Peer_SCA_Complete Event
+    4,   //  0x20 - HCI_LE_Path_Loss_Threshold Event
+    8,   //  0x21 - HCI_LE_Transmit_Power_Reporting Event
+    19,  //  0x22 - HCI_LE_BIGInfo_Advertising_Report Event
+};
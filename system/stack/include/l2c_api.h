@@ -187,6 +187,10 @@ constexpr uint16_t L2CAP_LE_CREDIT_THRESHOLD = 0x0040;
 static_assert(L2CAP_LE_CREDIT_THRESHOLD < L2CAP_LE_CREDIT_DEFAULT,
               "Threshold must be smaller than default credits");
 
+// Overrides the threshold above, a higher value returns credits in smaller
+// batches
+#define L2CAP_LE_CREDIT_THRESHOLD_PROPERTY "bluetooth.l2cap.le.credit_threshold"
+
 // Max number of CIDs in the L2CAP CREDIT BASED CONNECTION REQUEST
 constexpr uint16_t L2CAP_CREDIT_BASED_MAX_CIDS = 5;
 
@@ -227,6 +227,18 @@ bool SDP_InitDiscoveryDb(tSDP_DISCOVERY_DB* p_db, uint32_t len,
  ******************************************************************************/
 bool SDP_CancelServiceSearch(const tSDP_DISCOVERY_DB* p_db);
 
+/*******************************************************************************
+ *
+ * Function         SDP_FlushDiscoveryCache
+ *
+ * Description      This function drops the records of a peer kept from its
+ *                  last full discovery, when they may no longer be valid.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void SDP_FlushDiscoveryCache(const RawAddress& bd_addr);
+
 /*******************************************************************************
  *
  * Function         SDP_ServiceSearchRequest
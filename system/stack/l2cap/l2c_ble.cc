@@ -30,12 +30,14 @@
 
 #include "bt_target.h"
 #include "bta/include/bta_hearing_aid_api.h"
+#include "common/time_util.h"
 #include "device/include/controller.h"
 #include "main/shim/l2c_api.h"
 #include "main/shim/shim.h"
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
+#include "osi/include/properties.h"
 #include "stack/btm/btm_dev.h"
 #include "stack/btm/btm_sec.h"
 #include "stack/include/acl_api.h"
@@ -1404,6 +1406,162 @@ void l2cble_process_data_length_change_event(uint16_t handle,
   /* ignore rx_data len for now */
 }
 
+/* The throughput optimizer sets the LE links with bulk traffic up for
+ * throughput, and relaxes their connection interval afterwards */
+static bool l2cble_is_throughput_optimizer_enabled() {
+  static const bool enabled = osi_property_get_bool(
+      "bluetooth.l2cap.le.throughput_optimizer.enabled", false);
+  return enabled;
+}
+
+/* Connection interval range of the bulk traffic, 11.25ms to 15ms */
+constexpr uint16_t kBulkConnIntervalMin = BTM_BLE_CONN_INT_MIN_LIMIT;
+constexpr uint16_t kBulkConnIntervalMax = 0x000C;
+
+static size_t l2cble_xmit_queue_depth(tL2C_LCB* p_lcb) {
+  size_t depth = list_length(p_lcb->link_xmit_data_q);
+  for (tL2C_CCB* p_ccb = p_lcb->ccb_queue.p_first_ccb; p_ccb != nullptr;
+       p_ccb = p_ccb->p_next_ccb) {
+    depth += fixed_queue_length(p_ccb->xmit_hold_q);
+  }
+  for (int i = 0; i < L2CAP_NUM_FIXED_CHNLS; i++) {
+    if (p_lcb->p_fixed_ccbs[i] != nullptr) {
+      depth += fixed_queue_length(p_lcb->p_fixed_ccbs[i]->xmit_hold_q);
+    }
+  }
+  return depth;
+}
+
+static void l2cble_upgrade_throughput(tL2C_LCB* p_lcb) {
+  const RawAddress& bda = p_lcb->remote_bd_addr;
+  std::string actions;
+
+  if (p_lcb->tx_data_len < BTM_BLE_DATA_SIZE_MAX &&
+      BTM_SetBleDataLength(bda, BTM_BLE_DATA_SIZE_MAX) == BTM_SUCCESS) {
+    actions += " data_length";
+  }
+
+  if (controller_get_interface()->supports_ble_2m_phy() &&
+      acl_peer_supports_ble_2m_phy(p_lcb->Handle())) {
+    BTM_BleSetPhy(bda, PHY_LE_2M, PHY_LE_2M, 0);
+    actions += " 2m_phy";
+  }
+
+  uint16_t min_interval = kBulkConnIntervalMin;
+  uint16_t max_interval = kBulkConnIntervalMax;
+  L2CA_AdjustConnectionIntervals(&min_interval, &max_interval,
+                                 kBulkConnIntervalMin);
+  if (p_lcb->max_interval == 0 || p_lcb->max_interval > max_interval) {
+    p_lcb->throughput_params_saved = true;
+    p_lcb->saved_min_interval = p_lcb->min_interval;
+    p_lcb->saved_max_interval = p_lcb->max_interval;
+    p_lcb->saved_latency = p_lcb->latency;
+    p_lcb->saved_timeout = p_lcb->timeout;
+    const uint16_t timeout =
+        (p_lcb->timeout != 0) ? p_lcb->timeout : BTM_BLE_CONN_TIMEOUT_DEF;
+    if (L2CA_UpdateBleConnParams(bda, min_interval, max_interval, 0, timeout,
+                                 0, 0)) {
+      actions += " interval";
+    }
+  }
+
+  LOG_INFO("Set up LE link for bulk traffic peer:%s%s %s",
+           PRIVATE_ADDRESS(bda), actions.c_str(),
+           p_lcb->throughput.ToString().c_str());
+  BTM_LogHistory(kBtmLogTag, bda, "LE throughput upgrade",
+                 base::StringPrintf("%s [%s ]",
+                                    p_lcb->throughput.ToString().c_str(),
+                                    actions.c_str()));
+}
+
+static void l2cble_relax_throughput(tL2C_LCB* p_lcb) {
+  const RawAddress& bda = p_lcb->remote_bd_addr;
+  if (!p_lcb->throughput_params_saved) {
+    return;
+  }
+  p_lcb->throughput_params_saved = false;
+
+  /* Keep the connection parameters requested since the upgrade */
+  uint16_t bulk_min_interval = kBulkConnIntervalMin;
+  uint16_t bulk_max_interval = kBulkConnIntervalMax;
+  L2CA_AdjustConnectionIntervals(&bulk_min_interval, &bulk_max_interval,
+                                 kBulkConnIntervalMin);
+  if (p_lcb->min_interval != bulk_min_interval ||
+      p_lcb->max_interval != bulk_max_interval) {
+    return;
+  }
+
+  uint16_t min_interval = p_lcb->saved_min_interval;
+  uint16_t max_interval = p_lcb->saved_max_interval;
+  uint16_t latency = p_lcb->saved_latency;
+  uint16_t timeout = p_lcb->saved_timeout;
+  if (max_interval == 0) {
+    min_interval = BTM_BLE_CONN_INT_MIN_DEF;
+    max_interval = BTM_BLE_CONN_INT_MAX_DEF;
+    latency = BTM_BLE_CONN_PERIPHERAL_LATENCY_DEF;
+    timeout = BTM_BLE_CONN_TIMEOUT_DEF;
+  }
+
+  LOG_INFO("Relaxing LE link peer:%s interval:%hu-%hu latency:%hu %s",
+           PRIVATE_ADDRESS(bda), min_interval, max_interval, latency,
+           p_lcb->throughput.ToString().c_str());
+  BTM_LogHistory(
+      kBtmLogTag, bda, "LE throughput relax",
+      base::StringPrintf("%s interval:%hu-%hu latency:%hu",
+                         p_lcb->throughput.ToString().c_str(), min_interval,
+                         max_interval, latency));
+  L2CA_UpdateBleConnParams(bda, min_interval, max_interval, latency, timeout,
+                           0, 0);
+}
+
+static void l2cble_throughput_timer_timeout(void* data);
+
+static void l2cble_evaluate_throughput(tL2C_LCB* p_lcb, uint64_t now_ms) {
+  switch (p_lcb->throughput.Evaluate(now_ms, l2cble_xmit_queue_depth(p_lcb))) {
+    case L2cBleThroughputMonitor::Decision::UPGRADE:
+      l2cble_upgrade_throughput(p_lcb);
+      break;
+    case L2cBleThroughputMonitor::Decision::RELAX:
+      l2cble_relax_throughput(p_lcb);
+      break;
+    case L2cBleThroughputMonitor::Decision::NONE:
+      break;
+  }
+
+  /* Keep evaluating while bulk to relax the link once the traffic stops */
+  if (p_lcb->throughput.IsBulk() &&
+      !alarm_is_scheduled(p_lcb->throughput_timer)) {
+    alarm_set_on_mloop(p_lcb->throughput_timer,
+                       L2cBleThroughputMonitor::kWindowMs,
+                       l2cble_throughput_timer_timeout, p_lcb);
+  }
+}
+
+static void l2cble_throughput_timer_timeout(void* data) {
+  tL2C_LCB* p_lcb = (tL2C_LCB*)data;
+  if (!p_lcb->in_use) return;
+  l2cble_evaluate_throughput(p_lcb,
+                             bluetooth::common::time_get_os_boottime_ms());
+}
+
+/*******************************************************************************
+ *
+ * Function         l2cble_on_data_sent
+ *
+ * Description      This function is called for each packet sent to the
+ *                  controller on an LE link, to follow its transmit demand.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void l2cble_on_data_sent(tL2C_LCB* p_lcb, uint16_t len) {
+  if (!l2cble_is_throughput_optimizer_enabled()) return;
+
+  const uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+  p_lcb->throughput.OnDataSent(now_ms, len);
+  l2cble_evaluate_throughput(p_lcb, now_ms);
+}
+
 /*******************************************************************************
  *
  * Function         l2cble_credit_based_conn_req
@@ -0,0 +1,79 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stack/l2cap/l2c_ble_throughput.h"
+
+#include <base/strings/stringprintf.h>
+
+void L2cBleThroughputMonitor::OnDataSent(uint64_t now_ms, size_t bytes) {
+  if (!started_) {
+    started_ = true;
+    window_start_ms_ = now_ms;
+  }
+  window_bytes_ += bytes;
+}
+
+L2cBleThroughputMonitor::Decision L2cBleThroughputMonitor::Evaluate(
+    uint64_t now_ms, size_t queue_depth) {
+  if (!started_) {
+    started_ = true;
+    window_start_ms_ = now_ms;
+  }
+
+  /* A deep queue is bulk traffic without waiting for the window to elapse */
+  if (!bulk_ && queue_depth >= kBulkQueueDepth) {
+    bulk_ = true;
+    idle_windows_ = 0;
+    return Decision::UPGRADE;
+  }
+
+  if (now_ms < window_start_ms_ || now_ms - window_start_ms_ < kWindowMs) {
+    return Decision::NONE;
+  }
+  const uint64_t elapsed_ms = now_ms - window_start_ms_;
+  /* Scale a window stretched by idle time down to kWindowMs */
+  const uint64_t window_bytes = window_bytes_ * kWindowMs / elapsed_ms;
+  last_window_bytes_per_s_ = window_bytes * 1000 / kWindowMs;
+  window_start_ms_ = now_ms;
+  window_bytes_ = 0;
+
+  if (!bulk_) {
+    if (window_bytes >= kBulkBytes) {
+      bulk_ = true;
+      idle_windows_ = 0;
+      return Decision::UPGRADE;
+    }
+    return Decision::NONE;
+  }
+
+  if (window_bytes >= kIdleBytes || queue_depth > 0) {
+    idle_windows_ = 0;
+    return Decision::NONE;
+  }
+  if (++idle_windows_ < kRelaxWindows) {
+    return Decision::NONE;
+  }
+  bulk_ = false;
+  idle_windows_ = 0;
+  return Decision::RELAX;
+}
+
+std::string L2cBleThroughputMonitor::ToString() const {
+  return base::StringPrintf("bulk:%s throughput:%llu B/s",
+                            bulk_ ? "true" : "false",
+                            static_cast<unsigned long long>(
+                                last_window_bytes_per_s_));
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/* Transmit demand of an LE link, from the bytes sent to the controller and
+ * the depth of the L2CAP queues.
+ *
+ * The link turns bulk when a window of kWindowMs carries kBulkBytes or when
+ * kBulkQueueDepth packets are queued, and relaxes after kRelaxWindows windows
+ * carrying less than kIdleBytes with empty queues.
+ */
+class L2cBleThroughputMonitor {
+ public:
+  enum class Decision { NONE, UPGRADE, RELAX };
+
+  static constexpr uint64_t kWindowMs = 1000;
+  static constexpr uint64_t kBulkBytes = 16 * 1024;
+  static constexpr size_t kBulkQueueDepth = 8;
+  static constexpr uint64_t kIdleBytes = 2 * 1024;
+  static constexpr uint32_t kRelaxWindows = 3;
+
+  void OnDataSent(uint64_t now_ms, size_t bytes);
+  /* Close the window if it elapsed and tell whether the link parameters
+   * should be changed */
+  Decision Evaluate(uint64_t now_ms, size_t queue_depth);
+
+  bool IsBulk() const { return bulk_; }
+  /* Bytes per second of the last closed window */
+  uint64_t GetThroughput() const { return last_window_bytes_per_s_; }
+
+  std::string ToString() const;
+
+ private:
+  bool started_ = false;
+  bool bulk_ = false;
+  uint64_t window_start_ms_ = 0;
+  uint64_t window_bytes_ = 0;
+  uint64_t last_window_bytes_per_s_ = 0;
+  uint32_t idle_windows_ = 0;
+};
@@ -218,7 +218,8 @@ void l2c_fcr_cleanup(tL2C_CCB* p_ccb) {
   fixed_queue_free(p_fcrb->srej_rcv_hold_q, osi_free);
   p_fcrb->srej_rcv_hold_q = NULL;
 
-  fixed_queue_free(p_fcrb->retrans_q, osi_free);
+  /* The buffers are owned by the waiting for ack queue */
+  fixed_queue_free(p_fcrb->retrans_q, NULL);
   p_fcrb->retrans_q = NULL;
 
   memset(p_fcrb, 0, sizeof(tL2C_FCRB));
@@ -264,10 +265,12 @@ BT_HDR* l2c_fcr_clone_buf(BT_HDR* p_buf, uint16_t new_offset,
 bool l2c_fcr_is_flow_controlled(tL2C_CCB* p_ccb) {
   CHECK(p_ccb != NULL);
   if (p_ccb->peer_cfg.fcr.mode == L2CAP_FCR_ERTM_MODE) {
-    /* Check if remote side flowed us off or the transmit window is full */
+    /* Check if remote side flowed us off, the transmit window is full or we
+     * hold too much unacknowledged data */
     if ((p_ccb->fcrb.remote_busy) ||
         (fixed_queue_length(p_ccb->fcrb.waiting_for_ack_q) >=
-         p_ccb->peer_cfg.fcr.tx_win_sz)) {
+         p_ccb->peer_cfg.fcr.tx_win_sz) ||
+        (p_ccb->fcrb.waiting_for_ack_bytes >= L2CAP_FCR_TX_BUDGET)) {
       return (true);
     }
   }
@@ -883,6 +886,11 @@ static bool process_reqseq(tL2C_CCB* p_ccb, uint16_t ctrl_word) {
       if ((ls == L2CAP_FCR_UNSEG_SDU) || (ls == L2CAP_FCR_END_SDU))
         full_sdus_xmitted++;
 
+      /* No need to retransmit it anymore, it may have been queued again by a
+       * SREJ */
+      while (fixed_queue_try_remove_from_queue(p_fcrb->retrans_q, p_tmp))
+        ;
+      p_fcrb->waiting_for_ack_bytes -= p_tmp->len;
       osi_free(p_tmp);
     }
 
@@ -1340,25 +1348,21 @@ static bool retransmit_i_frames(tL2C_CCB* p_ccb, uint8_t tx_seq) {
     }
 
     /* Also flush our retransmission queue */
-    while (!fixed_queue_is_empty(p_ccb->fcrb.retrans_q))
-      osi_free(fixed_queue_try_dequeue(p_ccb->fcrb.retrans_q));
+    fixed_queue_flush(p_ccb->fcrb.retrans_q, NULL);
 
     if (list_ack != NULL) node_ack = list_begin(list_ack);
   }
 
+  /* The frames stay in the waiting for ack queue, they are copied only when
+   * they are sent again */
   if (list_ack != NULL) {
     while (node_ack != list_end(list_ack)) {
       p_buf = (BT_HDR*)list_node(node_ack);
       node_ack = list_next(node_ack);
 
-      BT_HDR* p_buf2 = l2c_fcr_clone_buf(p_buf, p_buf->offset, p_buf->len);
-      if (p_buf2) {
-        p_buf2->layer_specific = p_buf->layer_specific;
+      fixed_queue_enqueue(p_ccb->fcrb.retrans_q, p_buf);
 
-        fixed_queue_enqueue(p_ccb->fcrb.retrans_q, p_buf2);
-      }
-
-      if ((tx_seq != L2C_FCR_RETX_ALL_PKTS) || (p_buf2 == NULL)) break;
+      if (tx_seq != L2C_FCR_RETX_ALL_PKTS) break;
     }
   }
 
@@ -1395,8 +1399,12 @@ BT_HDR* l2c_fcr_get_next_xmit_sdu_seg(tL2C_CCB* p_ccb,
 
   /* If there is anything in the retransmit queue, that goes first
   */
-  p_buf = (BT_HDR*)fixed_queue_try_dequeue(p_ccb->fcrb.retrans_q);
-  if (p_buf != NULL) {
+  BT_HDR* p_retrans = (BT_HDR*)fixed_queue_try_dequeue(p_ccb->fcrb.retrans_q);
+  if (p_retrans != NULL) {
+    /* The frame is kept until it is acked, send a copy of it */
+    p_buf = l2c_fcr_clone_buf(p_retrans, p_retrans->offset, p_retrans->len);
+    p_buf->layer_specific = p_retrans->layer_specific;
+
     /* Update Rx Seq and FCS if we acked some packets while this one was queued
      */
     prepare_I_frame(p_ccb, p_buf, true);
@@ -1506,6 +1514,7 @@ BT_HDR* l2c_fcr_get_next_xmit_sdu_seg(tL2C_CCB* p_ccb,
 
       /* Pretend we sent it and it got lost */
       fixed_queue_enqueue(p_ccb->fcrb.waiting_for_ack_q, p_xmit);
+      p_ccb->fcrb.waiting_for_ack_bytes += p_xmit->len;
       return (NULL);
     } else {
       /* We will not save the FCS in case we reconfigure and change options */
@@ -1513,6 +1522,7 @@ BT_HDR* l2c_fcr_get_next_xmit_sdu_seg(tL2C_CCB* p_ccb,
 
       p_wack->layer_specific = p_xmit->layer_specific;
       fixed_queue_enqueue(p_ccb->fcrb.waiting_for_ack_q, p_wack);
+      p_ccb->fcrb.waiting_for_ack_bytes += p_wack->len;
     }
 
   }
@@ -1522,47 +1532,58 @@ BT_HDR* l2c_fcr_get_next_xmit_sdu_seg(tL2C_CCB* p_ccb,
 
 /** Get the next PDU to transmit for LE connection oriented channel. Returns
  * pointer to buffer with PDU. |last_piece_of_sdu| will be set to true, if
- * returned PDU is last piece from this SDU.*/
+ * returned PDU is last piece from this SDU.
+ *
+ * The last piece of the SDU is sent from the SDU buffer itself when it has
+ * room in front for the headers, only the pieces before it are copied out. */
 BT_HDR* l2c_lcc_get_next_xmit_sdu_seg(tL2C_CCB* p_ccb,
                                       bool* last_piece_of_sdu) {
   uint16_t max_pdu = p_ccb->peer_conn_cfg.mps - 4 /* Length and CID */;
 
   BT_HDR* p_buf = (BT_HDR*)fixed_queue_try_peek_first(p_ccb->xmit_hold_q);
   bool first_pdu = (p_buf->event == 0) ? true : false;
+  uint16_t sdu_len = p_buf->len;
+  uint16_t offset = first_pdu ? L2CAP_LCC_OFFSET : L2CAP_MIN_OFFSET;
 
   uint16_t no_of_bytes_to_send = std::min(
       p_buf->len,
       (uint16_t)(first_pdu ? (max_pdu - L2CAP_LCC_SDU_LENGTH) : max_pdu));
   bool last_pdu = (no_of_bytes_to_send == p_buf->len);
 
-  /* Get a new buffer and copy the data that can be sent in a PDU */
-  BT_HDR* p_xmit =
-      l2c_fcr_clone_buf(p_buf, first_pdu ? L2CAP_LCC_OFFSET : L2CAP_MIN_OFFSET,
-                        no_of_bytes_to_send);
+  BT_HDR* p_xmit;
+  if (last_pdu && p_buf->offset >= offset) {
+    /* The earlier pieces left their room in front of the rest of the SDU */
+    p_xmit = (BT_HDR*)fixed_queue_try_dequeue(p_ccb->xmit_hold_q);
+  } else {
+    /* Get a new buffer and copy the data that can be sent in a PDU */
+    p_xmit = l2c_fcr_clone_buf(p_buf, offset, no_of_bytes_to_send);
+    p_ccb->lcc_stats.tx_pdus_copied++;
+
+    p_buf->len -= no_of_bytes_to_send;
+    p_buf->offset += no_of_bytes_to_send;
 
-  p_buf->event = p_ccb->local_cid;
+    /* copy PBF setting */
+    p_xmit->layer_specific = p_buf->layer_specific;
+
+    if (last_pdu) {
+      p_buf = (BT_HDR*)fixed_queue_try_dequeue(p_ccb->xmit_hold_q);
+      osi_free(p_buf);
+    } else {
+      p_buf->event = p_ccb->local_cid;
+    }
+  }
   p_xmit->event = p_ccb->local_cid;
+  p_ccb->lcc_stats.tx_pdus++;
 
   if (first_pdu) {
     p_xmit->offset -= L2CAP_LCC_SDU_LENGTH; /* for writing the SDU length. */
     uint8_t* p = (uint8_t*)(p_xmit + 1) + p_xmit->offset;
-    UINT16_TO_STREAM(p, p_buf->len);
+    UINT16_TO_STREAM(p, sdu_len);
     p_xmit->len += L2CAP_LCC_SDU_LENGTH;
   }
 
-  p_buf->len -= no_of_bytes_to_send;
-  p_buf->offset += no_of_bytes_to_send;
-
-  /* copy PBF setting */
-  p_xmit->layer_specific = p_buf->layer_specific;
-
   if (last_piece_of_sdu) *last_piece_of_sdu = last_pdu;
 
-  if (last_pdu) {
-    p_buf = (BT_HDR*)fixed_queue_try_dequeue(p_ccb->xmit_hold_q);
-    osi_free(p_buf);
-  }
-
   /* Step back to add the L2CAP headers */
   p_xmit->offset -= L2CAP_PKT_OVERHEAD;
   p_xmit->len += L2CAP_PKT_OVERHEAD;
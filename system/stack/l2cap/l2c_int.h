@@ -42,6 +42,7 @@
 #include "osi/include/list.h"
 #include "stack/include/bt_hdr.h"
 #include "stack/include/hci_error_code.h"
+#include "stack/l2cap/l2c_ble_throughput.h"
 #include "types/hci_role.h"
 #include "types/raw_address.h"
 
@@ -245,8 +246,10 @@ typedef struct {
   BT_HDR* p_rx_sdu;    /* Buffer holding the SDU being received */
   fixed_queue_t*
       waiting_for_ack_q;          /* Buffers sent and waiting for peer to ack */
+  uint32_t waiting_for_ack_bytes; /* Length of the buffers waiting for ack */
   fixed_queue_t* srej_rcv_hold_q; /* Buffers rcvd but held pending SREJ rsp */
-  fixed_queue_t* retrans_q;       /* Buffers being retransmitted */
+  fixed_queue_t* retrans_q; /* Buffers of waiting_for_ack_q to retransmit, a
+                               copy is sent when their turn comes */
 
   alarm_t* ack_timer;         /* Timer delaying RR */
   alarm_t* mon_retrans_timer; /* Timer Monitor or Retransmission */
@@ -354,6 +357,14 @@ typedef struct t_l2c_ccb {
    * remote). Valid only for LE CoC */
   uint16_t remote_credit_count;
 
+  /* LE CoC flow control and segmentation counters */
+  struct {
+    unsigned credit_packets{0};   /* Flow control credit packets sent */
+    unsigned credits_returned{0}; /* Credits given back to the remote */
+    unsigned tx_pdus{0};          /* K-frames sent */
+    unsigned tx_pdus_copied{0};   /* K-frames copied out of their SDU */
+  } lcc_stats;
+
   /* used to indicate that ECOC is used */
   bool ecoc{false};
   bool reconfig_started;
@@ -539,6 +550,16 @@ typedef struct t_l2c_linkcb {
   uint16_t min_ce_len;
   uint16_t max_ce_len;
 
+  /* LE transmit demand, and connection parameters requested before the link
+   * was set up for bulk traffic */
+  L2cBleThroughputMonitor throughput;
+  alarm_t* throughput_timer; /* Timer evaluating the bulk traffic */
+  bool throughput_params_saved;
+  uint16_t saved_min_interval;
+  uint16_t saved_max_interval;
+  uint16_t saved_latency;
+  uint16_t saved_timeout;
+
   /* each priority group is limited burst transmission */
   /* round robin service for the same priority channels */
   tL2C_RR_SERV rr_serv[L2CAP_NUM_CHNL_PRIORITY];
@@ -568,6 +589,12 @@ typedef struct t_l2c_linkcb {
   }
 } tL2C_LCB;
 
+/* Largest valid ACL connection handle, 0x0F00 - 0x0FFF are reserved */
+#define L2CAP_MAX_ACL_HANDLE 0x0EFF
+
+static_assert(MAX_L2CAP_LINKS < UINT8_MAX,
+              "lcb_by_handle must hold an index in lcb_pool");
+
 /* Define the L2CAP control structure
 */
 typedef struct {
@@ -591,6 +618,9 @@ typedef struct {
   bool is_cong_cback_context;
 
   tL2C_LCB lcb_pool[MAX_L2CAP_LINKS];    /* Link Control Block pool */
+  /* Index + 1 in |lcb_pool| of the link last given each ACL handle, 0 if
+   * none. Set by l2cu_set_lcb_handle(), see l2cu_find_lcb_by_handle(). */
+  uint8_t lcb_by_handle[L2CAP_MAX_ACL_HANDLE + 1];
   tL2C_CCB ccb_pool[MAX_L2CAP_CHANNELS]; /* Channel Control Block pool */
   tL2C_RCB rcb_pool[MAX_L2CAP_CLIENTS];  /* Registration info pool */
 
@@ -640,6 +670,9 @@ typedef struct {
   uint16_t le_dyn_psm; /* Next LE dynamic PSM value to try to assign */
   bool le_dyn_psm_assigned[LE_DYNAMIC_PSM_RANGE]; /* Table of assigned LE PSM */
 
+  /* Credits left on the remote when LE CoC credits are given back to it */
+  uint16_t le_credit_threshold;
+
 } tL2C_CB;
 
 /* Define a structure that contains the information about a connection.
@@ -866,6 +899,7 @@ extern tL2CAP_LE_RESULT_CODE l2ble_sec_access_req(const RawAddress& bd_addr,
                                                   void* p_ref_data);
 
 extern void l2cble_update_data_length(tL2C_LCB* p_lcb);
+extern void l2cble_on_data_sent(tL2C_LCB* p_lcb, uint16_t len);
 
 extern void l2cu_process_fixed_disc_cback(tL2C_LCB* p_lcb);
 
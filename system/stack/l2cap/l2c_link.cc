@@ -1079,6 +1079,7 @@ static void l2c_link_send_to_lower_ble(tL2C_LCB* p_lcb, BT_HDR* p_buf) {
   p_buf->layer_specific = 0;
   l2cb.controller_le_xmit_window--;
 
+  l2cble_on_data_sent(p_lcb, p_buf->len);
   acl_send_data_packet_ble(p_lcb->remote_bd_addr, p_buf);
   LOG_DEBUG("TotalWin=%d,Hndl=0x%x,Quota=%d,Unack=%d,RRQuota=%d,RRUnack=%d",
             l2cb.controller_le_xmit_window, p_lcb->Handle(),
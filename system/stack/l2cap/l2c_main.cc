@@ -32,6 +32,7 @@
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
 #include "osi/include/osi.h"
+#include "osi/include/properties.h"
 #include "stack/include/bt_hdr.h"
 #include "stack/include/l2c_api.h"
 #include "stack/include/l2cdefs.h"
@@ -220,10 +221,13 @@ void l2c_rcv_acl_data(BT_HDR* p_msg) {
     /* The remote device has one less credit left */
     --p_ccb->remote_credit_count;
 
-    /* If the credits left on the remote device are getting low, send some */
-    if (p_ccb->remote_credit_count <= L2CAP_LE_CREDIT_THRESHOLD) {
+    /* If the credits left on the remote device are getting low, send all the
+     * ones it used at once */
+    if (p_ccb->remote_credit_count <= l2cb.le_credit_threshold) {
       uint16_t credits = L2CAP_LE_CREDIT_DEFAULT - p_ccb->remote_credit_count;
       p_ccb->remote_credit_count = L2CAP_LE_CREDIT_DEFAULT;
+      p_ccb->lcc_stats.credit_packets++;
+      p_ccb->lcc_stats.credits_returned += credits;
 
       /* Return back credits */
       l2c_csm_execute(p_ccb, L2CEVT_L2CA_SEND_FLOW_CONTROL_CREDIT, &credits);
@@ -900,6 +904,16 @@ void l2c_init(void) {
   /* the LE PSM is increased by 1 before being used */
   l2cb.le_dyn_psm = LE_DYNAMIC_PSM_START - 1;
 
+  /* A higher threshold returns the credits earlier, in smaller batches */
+  int32_t credit_threshold = osi_property_get_int32(
+      L2CAP_LE_CREDIT_THRESHOLD_PROPERTY, L2CAP_LE_CREDIT_THRESHOLD);
+  if (credit_threshold < 0 || credit_threshold >= L2CAP_LE_CREDIT_DEFAULT) {
+    LOG_WARN("Invalid LE credit threshold %d, using %d", credit_threshold,
+             L2CAP_LE_CREDIT_THRESHOLD);
+    credit_threshold = L2CAP_LE_CREDIT_THRESHOLD;
+  }
+  l2cb.le_credit_threshold = credit_threshold;
+
   /* Put all the channel control blocks on the free queue */
   for (xx = 0; xx < MAX_L2CAP_CHANNELS - 1; xx++) {
     l2cb.ccb_pool[xx].p_next_ccb = &l2cb.ccb_pool[xx + 1];
@@ -63,6 +63,7 @@ tL2C_LCB* l2cu_allocate_lcb(const RawAddress& p_bd_addr, bool is_bonding,
     if (!p_lcb->in_use) {
       alarm_free(p_lcb->l2c_lcb_timer);
       alarm_free(p_lcb->info_resp_timer);
+      alarm_free(p_lcb->throughput_timer);
       memset(p_lcb, 0, sizeof(tL2C_LCB));
 
       p_lcb->remote_bd_addr = p_bd_addr;
@@ -72,6 +73,7 @@ tL2C_LCB* l2cu_allocate_lcb(const RawAddress& p_bd_addr, bool is_bonding,
       p_lcb->InvalidateHandle();
       p_lcb->l2c_lcb_timer = alarm_new("l2c_lcb.l2c_lcb_timer");
       p_lcb->info_resp_timer = alarm_new("l2c_lcb.info_resp_timer");
+      p_lcb->throughput_timer = alarm_new("l2c_lcb.throughput_timer");
       p_lcb->idle_timeout = l2cb.idle_timeout;
       p_lcb->signal_id = 1; /* spec does not allow '0' */
       if (is_bonding) {
@@ -106,6 +108,9 @@ void l2cu_set_lcb_handle(struct t_l2c_linkcb& p_lcb, uint16_t handle) {
              p_lcb.Handle(), handle);
   }
   p_lcb.SetHandle(handle);
+  if (handle <= L2CAP_MAX_ACL_HANDLE) {
+    l2cb.lcb_by_handle[handle] = (&p_lcb - l2cb.lcb_pool) + 1;
+  }
 }
 
 /*******************************************************************************
@@ -158,6 +163,8 @@ void l2cu_release_lcb(tL2C_LCB* p_lcb) {
   p_lcb->l2c_lcb_timer = NULL;
   alarm_free(p_lcb->info_resp_timer);
   p_lcb->info_resp_timer = NULL;
+  alarm_free(p_lcb->throughput_timer);
+  p_lcb->throughput_timer = NULL;
 
   if (p_lcb->transport == BT_TRANSPORT_BR_EDR) /* Release all SCO links */
     BTM_RemoveSco(p_lcb->remote_bd_addr);
@@ -1461,6 +1468,7 @@ tL2C_CCB* l2cu_allocate_ccb(tL2C_LCB* p_lcb, uint16_t cid) {
 
   p_ccb->is_flushable = false;
   p_ccb->ecoc = false;
+  p_ccb->lcc_stats = {};
 
   alarm_free(p_ccb->l2c_ccb_timer);
   p_ccb->l2c_ccb_timer = alarm_new("l2c.l2c_ccb_timer");
@@ -1550,6 +1558,16 @@ void l2cu_release_ccb(tL2C_CCB* p_ccb) {
   /* If already released, could be race condition */
   if (!p_ccb->in_use) return;
 
+  if (p_lcb && p_lcb->transport == BT_TRANSPORT_LE &&
+      p_ccb->lcc_stats.tx_pdus + p_ccb->lcc_stats.credit_packets != 0) {
+    LOG_INFO(
+        "LE CoC cid 0x%04x sent %u K-frames, %u copied, returned %u credits "
+        "in %u packets",
+        p_ccb->local_cid, p_ccb->lcc_stats.tx_pdus,
+        p_ccb->lcc_stats.tx_pdus_copied, p_ccb->lcc_stats.credits_returned,
+        p_ccb->lcc_stats.credit_packets);
+  }
+
   if (p_rcb && (p_rcb->psm != p_rcb->real_psm)) {
     BTM_SecClrServiceByPsm(p_rcb->psm);
   }
@@ -3265,8 +3283,16 @@ void l2cu_send_peer_ble_credit_based_disconn_req(tL2C_CCB* p_ccb) {
  ******************************************************************************/
 tL2C_LCB* l2cu_find_lcb_by_handle(uint16_t handle) {
   int xx;
-  tL2C_LCB* p_lcb = &l2cb.lcb_pool[0];
+  tL2C_LCB* p_lcb;
+
+  /* Links are indexed when given a handle. Released links and invalidated
+   * handles are not removed from the index, so check that it still holds. */
+  if (handle <= L2CAP_MAX_ACL_HANDLE && l2cb.lcb_by_handle[handle] != 0) {
+    p_lcb = &l2cb.lcb_pool[l2cb.lcb_by_handle[handle] - 1];
+    if (p_lcb->in_use && p_lcb->Handle() == handle) return p_lcb;
+  }
 
+  p_lcb = &l2cb.lcb_pool[0];
   for (xx = 0; xx < MAX_L2CAP_LINKS; xx++, p_lcb++) {
     if ((p_lcb->in_use) && (p_lcb->Handle() == handle)) {
       return (p_lcb);
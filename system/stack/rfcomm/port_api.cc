@@ -27,6 +27,7 @@
 #include "stack/include/port_api.h"
 
 #include <base/logging.h>
+#include <sys/uio.h>
 
 #include <cstdint>
 
@@ -928,6 +929,8 @@ int PORT_WriteDataCO(uint16_t handle, int* p_len) {
 
   // max_read = available < max_read ? available : max_read;
 
+  if (p_port->peer_mtu < length) length = p_port->peer_mtu;
+
   while (available) {
     /* if we're over buffer high water mark, we're done */
     if ((p_port->tx.queue_size > PORT_TX_HIGH_WM) ||
@@ -941,41 +944,71 @@ int PORT_WriteDataCO(uint16_t handle, int* p_len) {
       break;
     }
 
-    /* continue with rfcomm data write */
-    p_buf = (BT_HDR*)osi_malloc(RFCOMM_DATA_BUF_SIZE);
-    p_buf->offset = L2CAP_MIN_OFFSET + RFCOMM_MIN_OFFSET;
-    p_buf->layer_specific = handle;
-
-    if (p_port->peer_mtu < length) length = p_port->peer_mtu;
-    if (available < (int)length) length = (uint16_t)available;
-    p_buf->len = length;
-    p_buf->event = BT_EVT_TO_BTU_SP_DATA;
-
-    // memcpy ((uint8_t *)(p_buf + 1) + p_buf->offset, p_data, length);
-    // if(recv(fd, (uint8_t *)(p_buf + 1) + p_buf->offset, (int)length, 0) !=
-    // (int)length)
-    if (!p_port->p_data_co_callback(handle,
-                                    (uint8_t*)(p_buf + 1) + p_buf->offset,
-                                    length, DATA_CO_CALLBACK_TYPE_OUTGOING)) {
+    /* Read at once as many frames as the peer can take right away, and as the
+     * tx queue can hold */
+    int max_frames = PORT_CO_MAX_FRAMES;
+    if (p_port->rfc.p_mcb != NULL &&
+        p_port->rfc.p_mcb->flow == PORT_FC_CREDIT && p_port->credit_tx > 0 &&
+        p_port->credit_tx < max_frames) {
+      max_frames = p_port->credit_tx;
+    }
+    BT_HDR* frames[PORT_CO_MAX_FRAMES];
+    struct iovec iov[PORT_CO_MAX_FRAMES];
+    int num_frames = 0;
+    int batch_len = 0;
+    do {
+      uint16_t frame_len = length;
+      if (available - batch_len < (int)frame_len)
+        frame_len = (uint16_t)(available - batch_len);
+
+      p_buf = (BT_HDR*)osi_malloc(RFCOMM_DATA_BUF_SIZE);
+      p_buf->offset = L2CAP_MIN_OFFSET + RFCOMM_MIN_OFFSET;
+      p_buf->layer_specific = handle;
+      p_buf->len = frame_len;
+      p_buf->event = BT_EVT_TO_BTU_SP_DATA;
+
+      iov[num_frames].iov_base = (uint8_t*)(p_buf + 1) + p_buf->offset;
+      iov[num_frames].iov_len = frame_len;
+      frames[num_frames++] = p_buf;
+      batch_len += frame_len;
+    } while (num_frames < max_frames && batch_len < available &&
+             p_port->tx.queue_size + batch_len <= PORT_TX_HIGH_WM &&
+             fixed_queue_length(p_port->tx.queue) + num_frames <=
+                 PORT_TX_BUF_HIGH_WM);
+
+    if (!p_port->p_data_co_callback(handle, (uint8_t*)iov, num_frames,
+                                    DATA_CO_CALLBACK_TYPE_OUTGOING_IOV)) {
       error(
-          "p_data_co_callback DATA_CO_CALLBACK_TYPE_OUTGOING failed, length:%d",
-          length);
+          "p_data_co_callback DATA_CO_CALLBACK_TYPE_OUTGOING_IOV failed, "
+          "length:%d",
+          batch_len);
+      for (int i = 0; i < num_frames; i++) osi_free(frames[i]);
       return (PORT_UNKNOWN_ERROR);
     }
 
-    RFCOMM_TRACE_EVENT("PORT_WriteData %d bytes", length);
+    RFCOMM_TRACE_EVENT("PORT_WriteData %d bytes in %d frames", batch_len,
+                       num_frames);
 
-    rc = port_write(p_port, p_buf);
+    int i;
+    for (i = 0; i < num_frames; i++) {
+      uint16_t frame_len = frames[i]->len;
+      rc = port_write(p_port, frames[i]);
 
-    /* If queue went below the threashold need to send flow control */
-    event |= port_flow_control_user(p_port);
+      /* If queue went below the threashold need to send flow control */
+      event |= port_flow_control_user(p_port);
 
-    if (rc == PORT_SUCCESS) event |= PORT_EV_TXCHAR;
+      if (rc == PORT_SUCCESS) event |= PORT_EV_TXCHAR;
 
-    if ((rc != PORT_SUCCESS) && (rc != PORT_CMD_PENDING)) break;
+      if ((rc != PORT_SUCCESS) && (rc != PORT_CMD_PENDING)) break;
 
-    *p_len += length;
-    available -= (int)length;
+      *p_len += frame_len;
+      available -= (int)frame_len;
+    }
+    if (i < num_frames) {
+      /* The port cannot take more data, the frames already read are lost */
+      for (i++; i < num_frames; i++) osi_free(frames[i]);
+      break;
+    }
   }
   if (!available && (rc != PORT_CMD_PENDING) && (rc != PORT_TX_QUEUE_DISABLED))
     event |= PORT_EV_TXEMPTY;
@@ -185,6 +185,9 @@ typedef struct {
   uint16_t
       credit_rx_max; /* Max number of credits we will allow this guy to sent */
   uint16_t credit_rx_low;   /* Number of credits when we send credit update */
+  uint16_t
+      credit_rx_max_min; /* Initial credit_rx_max, the least it adapts to */
+  uint16_t credit_rx_low_min; /* Initial credit_rx_low */
   uint16_t rx_buf_critical; /* port receive queue critical watermark level */
   bool keep_port_handle;    /* true if port is not deallocated when closing */
   /* it is set to true for server when allocating port */
@@ -215,6 +218,7 @@ extern uint32_t port_get_signal_changes(tPORT* p_port, uint8_t old_signals,
                                         uint8_t signal);
 extern uint32_t port_flow_control_user(tPORT* p_port);
 extern void port_flow_control_peer(tPORT* p_port, bool enable, uint16_t count);
+extern void port_adapt_credit_rx(tPORT* p_port, bool app_ready);
 
 /*
  * Functions provided by the port_rfc.cc
@@ -801,8 +801,17 @@ void PORT_DataInd(tRFC_MCB* p_mcb, uint8_t dlci, BT_HDR* p_buf) {
     /* Another packet is delivered to user.  Send credits to peer if required */
     if (p_port->p_data_co_callback(p_port->handle, (uint8_t*)p_buf, -1,
                                    DATA_CO_CALLBACK_TYPE_INCOMING)) {
+      /* The app kept up with a whole round of credits */
+      if (p_port->rfc.p_mcb && p_port->rfc.p_mcb->flow == PORT_FC_CREDIT &&
+          p_port->credit_rx <= p_port->credit_rx_low + 1 &&
+          !p_port->rx.user_fc) {
+        port_adapt_credit_rx(p_port, true);
+      }
       port_flow_control_peer(p_port, true, 1);
     } else {
+      if (p_port->rfc.p_mcb && p_port->rfc.p_mcb->flow == PORT_FC_CREDIT) {
+        port_adapt_credit_rx(p_port, false);
+      }
       port_flow_control_peer(p_port, false, 0);
     }
     // osi_free(p_buf);
@@ -184,6 +184,8 @@ void port_select_mtu(tPORT* p_port) {
   p_port->credit_rx_low = (PORT_RX_LOW_WM / p_port->mtu);
   if (p_port->credit_rx_low > PORT_RX_BUF_LOW_WM)
     p_port->credit_rx_low = PORT_RX_BUF_LOW_WM;
+  p_port->credit_rx_max_min = p_port->credit_rx_max;
+  p_port->credit_rx_low_min = p_port->credit_rx_low;
   p_port->rx_buf_critical = (PORT_RX_CRITICAL_WM / p_port->mtu);
   if (p_port->rx_buf_critical > PORT_RX_BUF_CRITICAL_WM)
     p_port->rx_buf_critical = PORT_RX_BUF_CRITICAL_WM;
@@ -440,6 +442,50 @@ uint32_t port_get_signal_changes(tPORT* p_port, uint8_t old_signals,
   return (p_port->ev_mask & events);
 }
 
+/*******************************************************************************
+ *
+ * Function         port_adapt_credit_rx
+ *
+ * Description      Adapt the number of credits granted to the peer of a
+ *                  call-out port to how fast the app reads its data. Called
+ *                  with app_ready true when the peer used up its credits down
+ *                  to the low watermark and the app took all the data, in
+ *                  which case the peer is allowed to send more at once, up to
+ *                  PORT_CO_CREDIT_RX_MAX, so that it is not left waiting for
+ *                  credits on links with a long round trip. Called with
+ *                  app_ready false when the app falls behind, in which case
+ *                  the number of credits is halved back towards its initial
+ *                  value.
+ *
+ * Returns          nothing
+ *
+ ******************************************************************************/
+void port_adapt_credit_rx(tPORT* p_port, bool app_ready) {
+  uint16_t credit_rx_max = p_port->credit_rx_max;
+  if (app_ready) {
+    if (credit_rx_max >= PORT_CO_CREDIT_RX_MAX) return;
+    credit_rx_max += p_port->credit_rx_max_min;
+    if (credit_rx_max > PORT_CO_CREDIT_RX_MAX)
+      credit_rx_max = PORT_CO_CREDIT_RX_MAX;
+  } else {
+    credit_rx_max /= 2;
+  }
+  if (credit_rx_max < p_port->credit_rx_max_min)
+    credit_rx_max = p_port->credit_rx_max_min;
+  if (credit_rx_max == p_port->credit_rx_max) return;
+
+  p_port->credit_rx_max = credit_rx_max;
+  /* Send the credit update once half of the credits are used, so that it
+   * reaches the peer before it runs out */
+  p_port->credit_rx_low = (credit_rx_max == p_port->credit_rx_max_min)
+                              ? p_port->credit_rx_low_min
+                              : credit_rx_max / 2;
+  if (p_port->credit_rx_low < p_port->credit_rx_low_min)
+    p_port->credit_rx_low = p_port->credit_rx_low_min;
+  RFCOMM_TRACE_DEBUG("%s: credit_rx_max %d, credit_rx_low %d", __func__,
+                     p_port->credit_rx_max, p_port->credit_rx_low);
+}
+
 /*******************************************************************************
  *
  * Function         port_flow_control_peer
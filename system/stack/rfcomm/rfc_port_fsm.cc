@@ -443,8 +443,10 @@ void rfc_port_sm_opened(tPORT* p_port, tRFC_PORT_EVENT event, void* p_data) {
       /* There might be an initial case when we reduced rx_max and credit_rx is
        * still */
       /* bigger.  Make sure that we do not send 255 */
+      /* The credit field is not part of the information field, and room for it
+       * is kept by RFCOMM_MIN_OFFSET, so full frames can carry credits too */
       if ((p_port->rfc.p_mcb->flow == PORT_FC_CREDIT) &&
-          (((BT_HDR*)p_data)->len < p_port->peer_mtu) &&
+          (((BT_HDR*)p_data)->len <= p_port->peer_mtu) &&
           (!p_port->rx.user_fc) &&
           (p_port->credit_rx_max > p_port->credit_rx)) {
         ((BT_HDR*)p_data)->layer_specific =
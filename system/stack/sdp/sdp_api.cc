@@ -111,13 +111,27 @@ bool SDP_InitDiscoveryDb(tSDP_DISCOVERY_DB* p_db, uint32_t len,
  ******************************************************************************/
 bool SDP_CancelServiceSearch(const tSDP_DISCOVERY_DB* p_db) {
   tCONN_CB* p_ccb = sdpu_find_ccb_by_db(p_db);
-  if (!p_ccb) return (false);
+  if (!p_ccb) return (sdp_disc_cache_cancel(p_db));
 
   sdp_disconnect(p_ccb, SDP_CANCEL);
   p_ccb->disc_state = SDP_DISC_WAIT_CANCEL;
   return (true);
 }
 
+/*******************************************************************************
+ *
+ * Function         SDP_FlushDiscoveryCache
+ *
+ * Description      This function drops the records of a peer kept from its
+ *                  last full discovery, when they may no longer be valid.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void SDP_FlushDiscoveryCache(const RawAddress& bd_addr) {
+  sdp_disc_cache_flush(bd_addr);
+}
+
 /*******************************************************************************
  *
  * Function         SDP_ServiceSearchRequest
@@ -163,6 +177,9 @@ bool SDP_ServiceSearchAttributeRequest(const RawAddress& p_bd_addr,
                                        tSDP_DISC_CMPL_CB* p_cb) {
   tCONN_CB* p_ccb;
 
+  /* Answered by a recent search of all the records of the peer */
+  if (sdp_disc_cache_answer(p_bd_addr, p_db, p_cb, NULL, NULL)) return (true);
+
   /* Specific BD address */
   p_ccb = sdp_conn_originate(p_bd_addr);
 
@@ -196,6 +213,10 @@ bool SDP_ServiceSearchAttributeRequest2(const RawAddress& p_bd_addr,
                                         const void* user_data) {
   tCONN_CB* p_ccb;
 
+  /* Answered by a recent search of all the records of the peer */
+  if (sdp_disc_cache_answer(p_bd_addr, p_db, NULL, p_cb2, user_data))
+    return (true);
+
   /* Specific BD address */
   p_ccb = sdp_conn_originate(p_bd_addr);
 
@@ -24,7 +24,10 @@
 
 #include <string.h>
 
+#include <algorithm>
 #include <cstdint>
+#include <unordered_map>
+#include <vector>
 
 #include "bt_target.h"
 #include "osi/include/allocator.h"
@@ -34,85 +37,89 @@
 #include "stack/sdp/sdpint.h"
 #include "types/bluetooth/uuid.h"
 
-/******************************************************************************/
-/*            L O C A L    F U N C T I O N     P R O T O T Y P E S            */
-/******************************************************************************/
-static bool find_uuid_in_seq(uint8_t* p, uint32_t seq_len,
-                             const uint8_t* p_his_uuid, uint16_t his_len,
-                             int nest_level);
+/* Number of changes made to the database so far, and number of records seen
+ * when it was last read. sdp_init() clears the database behind our back */
+static uint32_t sdp_db_generation = 1;
+static uint16_t sdp_db_generation_records = 0;
+
+/* Indices of the records holding each UUID, in increasing order, rebuilt on
+ * the first search after a change to the database */
+static std::unordered_map<bluetooth::Uuid, std::vector<uint16_t>>
+    sdp_db_uuid_index;
+static uint32_t sdp_db_uuid_index_generation = 0;
 
 /*******************************************************************************
  *
- * Function         sdp_db_service_search
+ * Function         sdp_db_invalidate
  *
- * Description      This function searches for a record that contains the
- *                  specified UIDs. It is passed either NULL to start at the
- *                  beginning, or the previous record found.
+ * Description      This function is called whenever a record or an attribute
+ *                  of the database is added, changed or removed.
  *
- * Returns          Pointer to the record, or NULL if not found.
+ * Returns          void
  *
  ******************************************************************************/
-const tSDP_RECORD* sdp_db_service_search(const tSDP_RECORD* p_rec,
-                                         const tSDP_UUID_SEQ* p_seq) {
-  uint16_t xx, yy;
-  const tSDP_ATTRIBUTE* p_attr;
-  tSDP_RECORD* p_end = &sdp_cb.server_db.record[sdp_cb.server_db.num_records];
+static void sdp_db_invalidate(void) { sdp_db_generation++; }
 
-  /* If NULL, start at the beginning, else start at the first specified record
-   */
-  if (!p_rec)
-    p_rec = &sdp_cb.server_db.record[0];
-  else
-    p_rec++;
-
-  /* Look through the records. The spec says that a match occurs if */
-  /* the record contains all the passed UUIDs in it.                */
-  for (; p_rec < p_end; p_rec++) {
-    for (yy = 0; yy < p_seq->num_uids; yy++) {
-      p_attr = &p_rec->attribute[0];
-      for (xx = 0; xx < p_rec->num_attributes; xx++, p_attr++) {
-        if (p_attr->type == UUID_DESC_TYPE) {
-          if (sdpu_compare_uuid_arrays(p_attr->value_ptr, p_attr->len,
-                                       &p_seq->uuid_entry[yy].value[0],
-                                       p_seq->uuid_entry[yy].len))
-            break;
-        } else if (p_attr->type == DATA_ELE_SEQ_DESC_TYPE) {
-          if (find_uuid_in_seq(p_attr->value_ptr, p_attr->len,
-                               &p_seq->uuid_entry[yy].value[0],
-                               p_seq->uuid_entry[yy].len, 0))
-            break;
-        }
-      }
-      /* If any UUID was not found,  on to the next record */
-      if (xx == p_rec->num_attributes) break;
-    }
+/*******************************************************************************
+ *
+ * Function         sdp_db_get_generation
+ *
+ * Description      This function returns a number that changes whenever the
+ *                  database changes, so that the state derived from it can be
+ *                  kept until then.
+ *
+ * Returns          The generation of the database
+ *
+ ******************************************************************************/
+uint32_t sdp_db_get_generation(void) {
+  if (sdp_cb.server_db.num_records != sdp_db_generation_records) {
+    sdp_db_generation_records = sdp_cb.server_db.num_records;
+    sdp_db_invalidate();
+  }
+  return sdp_db_generation;
+}
 
-    /* If every UUID was found in the record, return the record */
-    if (yy == p_seq->num_uids) return (p_rec);
+/*******************************************************************************
+ *
+ * Function         sdp_db_index_uuid
+ *
+ * Description      This function adds a record to the ones holding a UUID.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void sdp_db_index_uuid(const uint8_t* p, uint32_t len,
+                              uint16_t record_index) {
+  bluetooth::Uuid uuid;
+
+  if (!sdpu_uuid_from_array(p, len, &uuid)) {
+    SDP_TRACE_ERROR("%s: invalid length", __func__);
+    return;
   }
 
-  /* If here, no more records found */
-  return (NULL);
+  std::vector<uint16_t>& records = sdp_db_uuid_index[uuid];
+  if (records.empty() || records.back() != record_index)
+    records.push_back(record_index);
 }
 
 /*******************************************************************************
  *
- * Function         find_uuid_in_seq
+ * Function         sdp_db_index_seq
  *
- * Description      This function searches a data element sequenct for a UUID.
+ * Description      This function adds a record to the ones holding each UUID
+ *                  found in a data element sequence.
  *
- * Returns          true if found, else false
+ * Returns          void
  *
  ******************************************************************************/
-static bool find_uuid_in_seq(uint8_t* p, uint32_t seq_len,
-                             const uint8_t* p_uuid, uint16_t uuid_len,
-                             int nest_level) {
+static void sdp_db_index_seq(uint8_t* p, uint32_t seq_len, int nest_level,
+                             uint16_t record_index) {
   uint8_t* p_end = p + seq_len;
   uint8_t type;
   uint32_t len;
 
   /* A little safety check to avoid excessive recursion */
-  if (nest_level > 3) return (false);
+  if (nest_level > 3) return;
 
   while (p < p_end) {
     type = *p++;
@@ -123,16 +130,94 @@ static bool find_uuid_in_seq(uint8_t* p, uint32_t seq_len,
     }
     type = type >> 3;
     if (type == UUID_DESC_TYPE) {
-      if (sdpu_compare_uuid_arrays(p, len, p_uuid, uuid_len)) return (true);
+      sdp_db_index_uuid(p, len, record_index);
     } else if (type == DATA_ELE_SEQ_DESC_TYPE) {
-      if (find_uuid_in_seq(p, len, p_uuid, uuid_len, nest_level + 1))
-        return (true);
+      sdp_db_index_seq(p, len, nest_level + 1, record_index);
     }
     p = p + len;
   }
+}
 
-  /* If here, failed to match */
-  return (false);
+/*******************************************************************************
+ *
+ * Function         sdp_db_update_index
+ *
+ * Description      This function rebuilds the UUID index if the database
+ *                  changed since it was last built.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void sdp_db_update_index(void) {
+  uint32_t generation = sdp_db_get_generation();
+
+  if (generation == sdp_db_uuid_index_generation) return;
+
+  sdp_db_uuid_index.clear();
+  for (uint16_t xx = 0; xx < sdp_cb.server_db.num_records; xx++) {
+    tSDP_RECORD* p_rec = &sdp_cb.server_db.record[xx];
+    for (uint16_t yy = 0; yy < p_rec->num_attributes; yy++) {
+      tSDP_ATTRIBUTE* p_attr = &p_rec->attribute[yy];
+      if (p_attr->type == UUID_DESC_TYPE)
+        sdp_db_index_uuid(p_attr->value_ptr, p_attr->len, xx);
+      else if (p_attr->type == DATA_ELE_SEQ_DESC_TYPE)
+        sdp_db_index_seq(p_attr->value_ptr, p_attr->len, 0, xx);
+    }
+  }
+  sdp_db_uuid_index_generation = generation;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_db_service_search
+ *
+ * Description      This function searches for a record that contains the
+ *                  specified UIDs. It is passed either NULL to start at the
+ *                  beginning, or the previous record found.
+ *
+ * Returns          Pointer to the record, or NULL if not found.
+ *
+ ******************************************************************************/
+const tSDP_RECORD* sdp_db_service_search(const tSDP_RECORD* p_rec,
+                                         const tSDP_UUID_SEQ* p_seq) {
+  const std::vector<uint16_t>* records[MAX_UUIDS_PER_SEQ];
+  bluetooth::Uuid uuid;
+  uint16_t first, yy;
+
+  /* If NULL, start at the beginning, else start after the specified record */
+  first = p_rec ? (uint16_t)(p_rec - &sdp_cb.server_db.record[0]) + 1 : 0;
+  if (first >= sdp_cb.server_db.num_records) return (NULL);
+  if (p_seq->num_uids == 0) return (&sdp_cb.server_db.record[first]);
+
+  sdp_db_update_index();
+
+  /* The spec says that a match occurs if the record contains all the passed
+   * UUIDs in it. Find the records holding each of them */
+  for (yy = 0; yy < p_seq->num_uids; yy++) {
+    if (!sdpu_uuid_from_array(&p_seq->uuid_entry[yy].value[0],
+                             p_seq->uuid_entry[yy].len, &uuid)) {
+      SDP_TRACE_ERROR("%s: invalid length", __func__);
+      return (NULL);
+    }
+    auto it = sdp_db_uuid_index.find(uuid);
+    if (it == sdp_db_uuid_index.end()) return (NULL);
+    records[yy] = &it->second;
+  }
+
+  /* Look through the records holding the first UUID for the others */
+  auto it = std::lower_bound(records[0]->begin(), records[0]->end(), first);
+  for (; it != records[0]->end(); it++) {
+    for (yy = 1; yy < p_seq->num_uids; yy++) {
+      if (!std::binary_search(records[yy]->begin(), records[yy]->end(), *it))
+        break;
+    }
+
+    /* If every UUID was found in the record, return the record */
+    if (yy == p_seq->num_uids) return (&sdp_cb.server_db.record[*it]);
+  }
+
+  /* If here, no more records found */
+  return (NULL);
 }
 
 /*******************************************************************************
@@ -268,6 +353,7 @@ uint32_t SDP_CreateRecord(void) {
     p_db->record[p_db->num_records].record_handle = handle;
 
     p_db->num_records++;
+    sdp_db_invalidate();
     SDP_TRACE_DEBUG("SDP_CreateRecord ok, num_records:%d", p_db->num_records);
     /* Add the first attribute (the handle) automatically */
     UINT32_TO_BE_FIELD(buf, handle);
@@ -305,6 +391,7 @@ bool SDP_DeleteRecord(uint32_t handle) {
     /* require new DI record to be created in SDP_SetLocalDiRecord */
     sdp_cb.server_db.di_primary_handle = 0;
 
+    sdp_db_invalidate();
     return (true);
   } else {
     /* Find the record in the database */
@@ -320,6 +407,7 @@ bool SDP_DeleteRecord(uint32_t handle) {
         }
 
         sdp_cb.server_db.num_records--;
+        sdp_db_invalidate();
 
         SDP_TRACE_DEBUG("SDP_DeleteRecord ok, num_records:%d",
                         sdp_cb.server_db.num_records);
@@ -402,6 +490,8 @@ bool SDP_AddAttribute(uint32_t handle, uint16_t attr_id, uint8_t attr_type,
     if (p_rec->record_handle == handle) {
       tSDP_ATTRIBUTE* p_attr = &p_rec->attribute[0];
 
+      sdp_db_invalidate();
+
       /* Found the record. Now, see if the attribute already exists */
       for (xx = 0; xx < p_rec->num_attributes; xx++, p_attr++) {
         /* The attribute exists. replace it */
@@ -780,6 +870,8 @@ bool SDP_DeleteAttribute(uint32_t handle, uint16_t attr_id) {
       /* Found it. Now, find the attribute */
       for (uint16_t attribute_index = 0; attribute_index < p_rec->num_attributes; attribute_index++, p_attr++) {
         if (p_attr->id == attr_id) {
+          sdp_db_invalidate();
+
           pad_ptr = p_attr->value_ptr;
           len = p_attr->len;
 
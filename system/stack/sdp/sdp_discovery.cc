@@ -24,13 +24,19 @@
 
 #define LOG_TAG "sdp_discovery"
 
+#include <base/bind.h>
+
 #include <cstdint>
+#include <list>
+#include <vector>
 
 #include "bt_target.h"
+#include "common/time_util.h"
 #include "osi/include/allocator.h"
 #include "osi/include/log.h"
 #include "stack/include/bt_hdr.h"
 #include "stack/include/bt_types.h"
+#include "stack/include/btu.h"  // do_in_main_thread
 #include "stack/include/sdp_api.h"
 #include "stack/include/sdpdefs.h"
 #include "stack/sdp/sdpint.h"
@@ -54,6 +60,27 @@ static tSDP_DISC_REC* add_record(tSDP_DISCOVERY_DB* p_db,
 static uint8_t* add_attr(uint8_t* p, uint8_t* p_end, tSDP_DISCOVERY_DB* p_db,
                          tSDP_DISC_REC* p_rec, uint16_t attr_id,
                          tSDP_DISC_ATTR* p_parent_attr, uint8_t nest_level);
+static void sdp_disc_cache_save(tCONN_CB* p_ccb, uint8_t* p, uint8_t* p_end);
+
+/* Attribute lists of the records of a peer found by the last search for all
+ * the records holding the L2CAP protocol, with all their attributes */
+typedef struct {
+  RawAddress bd_addr;
+  uint64_t timestamp_ms;
+  std::vector<uint8_t> attr_lists;
+} tSDP_DISC_CACHE_ENTRY;
+
+/* Peers with encoded attribute lists, the most recent first */
+static std::list<tSDP_DISC_CACHE_ENTRY> sdp_disc_cache;
+
+/* Search answered from the attribute lists, whose completion callback is
+ * still to be called */
+typedef struct {
+  const tSDP_DISCOVERY_DB* p_db;
+  tSDP_RESULT result;
+} tSDP_DISC_CACHE_ANSWER;
+
+static std::list<tSDP_DISC_CACHE_ANSWER> sdp_disc_cache_answers;
 
 /* Safety check in case we go crazy */
 #define MAX_NEST_LEVELS 5
@@ -658,6 +685,8 @@ static void process_service_search_attr_rsp(tCONN_CB* p_ccb, uint8_t* p_reply,
     return;
   }
 
+  sdp_disc_cache_save(p_ccb, p, p_end);
+
   while (p < p_end) {
     p = save_attr_seq(p_ccb, p, &p_ccb->rsp_list[p_ccb->list_len]);
     if (!p) {
@@ -996,3 +1025,332 @@ static uint8_t* add_attr(uint8_t* p, uint8_t* p_end, tSDP_DISCOVERY_DB* p_db,
 
   return (p);
 }
+
+/*******************************************************************************
+ *
+ * Function         sdp_disc_check_attr_lists
+ *
+ * Description      This function checks that a sequence of attribute lists
+ *                  is made of attribute ID and value pairs that fit.
+ *
+ * Returns          true if the attribute lists are valid, else false
+ *
+ ******************************************************************************/
+static bool sdp_disc_check_attr_lists(uint8_t* p, uint8_t* p_end) {
+  uint8_t *p_seq_end, type;
+  uint32_t seq_len, len;
+
+  while (p < p_end) {
+    type = *p++;
+    if ((type >> 3) != DATA_ELE_SEQ_DESC_TYPE) return false;
+    p = sdpu_get_len_from_type(p, p_end, type, &seq_len);
+    if (p == NULL || (p + seq_len) > p_end) return false;
+    p_seq_end = p + seq_len;
+
+    while (p < p_seq_end) {
+      if (p + 3 > p_seq_end ||
+          *p != ((UINT_DESC_TYPE << 3) | SIZE_TWO_BYTES))
+        return false;
+      p += 3;
+
+      if (p >= p_seq_end) return false;
+      type = *p++;
+      p = sdpu_get_len_from_type(p, p_seq_end, type, &len);
+      if (p == NULL || (p + len) > p_seq_end) return false;
+      p += len;
+    }
+  }
+  return true;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_disc_cache_save
+ *
+ * Description      This function keeps the attribute lists received for a
+ *                  search of all the records holding the L2CAP protocol,
+ *                  with all their attributes, so that the next searches to
+ *                  the same peer can be answered without asking it again.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void sdp_disc_cache_save(tCONN_CB* p_ccb, uint8_t* p, uint8_t* p_end) {
+  tSDP_DISCOVERY_DB* p_db = p_ccb->p_db;
+
+  if (p_db->num_uuid_filters != 1 ||
+      p_db->uuid_filters[0] != Uuid::From16Bit(UUID_PROTOCOL_L2CAP) ||
+      p_db->num_attr_filters != 0)
+    return;
+
+  if (!sdp_disc_check_attr_lists(p, p_end)) return;
+
+  for (auto it = sdp_disc_cache.begin(); it != sdp_disc_cache.end(); it++) {
+    if (it->bd_addr == p_ccb->device_address) {
+      sdp_disc_cache.erase(it);
+      break;
+    }
+  }
+
+  sdp_disc_cache.push_front({p_ccb->device_address,
+                             bluetooth::common::time_get_os_boottime_ms(),
+                             std::vector<uint8_t>(p, p_end)});
+  if (sdp_disc_cache.size() > SDP_MAX_DISC_CACHE_ENTRIES)
+    sdp_disc_cache.pop_back();
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_disc_find_uuid
+ *
+ * Description      This function searches data elements for a UUID, looking
+ *                  into the sequences.
+ *
+ * Returns          true if found, else false
+ *
+ ******************************************************************************/
+static bool sdp_disc_find_uuid(uint8_t* p, uint8_t* p_end, const Uuid& uuid,
+                               int nest_level) {
+  uint8_t type;
+  uint32_t len;
+  Uuid found;
+
+  /* Attribute values are one level down, as for the local database search */
+  if (nest_level > 4) return false;
+
+  while (p < p_end) {
+    type = *p++;
+    p = sdpu_get_len_from_type(p, p_end, type, &len);
+    if (p == NULL || (p + len) > p_end) return false;
+
+    type = type >> 3;
+    if (type == UUID_DESC_TYPE) {
+      if (sdpu_uuid_from_array(p, len, &found) && found == uuid) return true;
+    } else if (type == DATA_ELE_SEQ_DESC_TYPE) {
+      if (sdp_disc_find_uuid(p, p + len, uuid, nest_level + 1)) return true;
+    }
+    p += len;
+  }
+  return false;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_disc_cache_add_record
+ *
+ * Description      This function adds a record of the peer to the discovery
+ *                  database, with the attributes it asks for.
+ *
+ * Returns          false if the database is full, else true
+ *
+ ******************************************************************************/
+static bool sdp_disc_cache_add_record(tSDP_DISCOVERY_DB* p_db,
+                                      const RawAddress& bd_addr, uint8_t* p,
+                                      uint8_t* p_end) {
+  tSDP_DISC_REC* p_rec = add_record(p_db, bd_addr);
+  uint16_t attr_id, xx;
+  uint32_t len;
+  uint8_t type;
+
+  if (!p_rec) return false;
+
+  while (p < p_end) {
+    /* Skip the attribute ID type */
+    p += 1;
+    BE_STREAM_TO_UINT16(attr_id, p);
+
+    for (xx = 0; xx < p_db->num_attr_filters; xx++) {
+      if (p_db->attr_filters[xx] == attr_id) break;
+    }
+
+    if (p_db->num_attr_filters == 0 || xx < p_db->num_attr_filters) {
+      p = add_attr(p, p_end, p_db, p_rec, attr_id, NULL, 0);
+      if (!p) return false;
+    } else {
+      type = *p++;
+      p = sdpu_get_len_from_type(p, p_end, type, &len);
+      p += len;
+    }
+  }
+  return true;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_disc_cache_lookup
+ *
+ * Description      This function adds the records matching a service search
+ *                  attribute request to its discovery database, from the
+ *                  attribute lists of the peer received by a recent search.
+ *
+ *                  Records without the L2CAP protocol, such as the Device ID
+ *                  one, are not in that list. Searches with no match are
+ *                  therefore sent to the peer.
+ *
+ * Returns          true if the request was answered, with its result, else
+ *                  false
+ *
+ ******************************************************************************/
+static bool sdp_disc_cache_lookup(const RawAddress& bd_addr,
+                                  tSDP_DISCOVERY_DB* p_db,
+                                  tSDP_RESULT* p_result) {
+  uint64_t now_ms = bluetooth::common::time_get_os_boottime_ms();
+  uint8_t *p, *p_end, *p_seq_end, type;
+  uint32_t seq_len;
+  uint16_t xx;
+  bool found = false;
+
+  /* The lists were checked when they were saved */
+
+  /* The raw data of the records matching is not kept */
+  if (p_db->raw_data || p_db->num_uuid_filters == 0) return false;
+
+  auto it = sdp_disc_cache.begin();
+  for (; it != sdp_disc_cache.end(); it++) {
+    if (it->bd_addr == bd_addr) break;
+  }
+  if (it == sdp_disc_cache.end()) return false;
+  if (now_ms - it->timestamp_ms > SDP_DISC_CACHE_TIMEOUT_MS) {
+    sdp_disc_cache.erase(it);
+    return false;
+  }
+
+  p = it->attr_lists.data();
+  p_end = p + it->attr_lists.size();
+  while (p < p_end) {
+    type = *p++;
+    p = sdpu_get_len_from_type(p, p_end, type, &seq_len);
+    p_seq_end = p + seq_len;
+
+    /* The record must hold all the UUIDs */
+    for (xx = 0; xx < p_db->num_uuid_filters; xx++) {
+      if (!sdp_disc_find_uuid(p, p_seq_end, p_db->uuid_filters[xx], 0)) break;
+    }
+
+    if (xx == p_db->num_uuid_filters) {
+      found = true;
+      if (!sdp_disc_cache_add_record(p_db, bd_addr, p, p_seq_end)) {
+        *p_result = SDP_DB_FULL;
+        return true;
+      }
+    }
+    p = p_seq_end;
+  }
+
+  if (found) *p_result = SDP_SUCCESS;
+  return found;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_disc_cache_complete
+ *
+ * Description      This function calls the completion callback of a search
+ *                  answered from the attribute lists, with SDP_CANCEL if the
+ *                  search was cancelled in between.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void sdp_disc_cache_complete(const tSDP_DISCOVERY_DB* p_db,
+                                    tSDP_DISC_CMPL_CB* p_cb,
+                                    tSDP_DISC_CMPL_CB2* p_cb2,
+                                    const void* user_data) {
+  for (auto it = sdp_disc_cache_answers.begin();
+       it != sdp_disc_cache_answers.end(); it++) {
+    if (it->p_db == p_db) {
+      tSDP_RESULT result = it->result;
+
+      sdp_disc_cache_answers.erase(it);
+      if (p_cb)
+        (*p_cb)(result);
+      else if (p_cb2)
+        (*p_cb2)(result, user_data);
+      return;
+    }
+  }
+
+  /* The answers were dropped by sdp_init() */
+  SDP_TRACE_WARNING("%s: no pending answer", __func__);
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_disc_cache_answer
+ *
+ * Description      This function answers a service search attribute request
+ *                  with the attribute lists of the peer received by a recent
+ *                  search, if any of them matches. The completion callback
+ *                  is called from the main thread, unless the search is
+ *                  cancelled first.
+ *
+ * Returns          true if the request was answered, else false
+ *
+ ******************************************************************************/
+bool sdp_disc_cache_answer(const RawAddress& bd_addr, tSDP_DISCOVERY_DB* p_db,
+                           tSDP_DISC_CMPL_CB* p_cb, tSDP_DISC_CMPL_CB2* p_cb2,
+                           const void* user_data) {
+  tSDP_RESULT result;
+
+  if (!sdp_disc_cache_lookup(bd_addr, p_db, &result)) return false;
+
+  /* As if the records had been received from the peer */
+  if (result == SDP_SUCCESS) sdpu_log_attribute_metrics(bd_addr, p_db);
+
+  sdp_disc_cache_answers.push_back({p_db, result});
+  do_in_main_thread(FROM_HERE, base::Bind(&sdp_disc_cache_complete, p_db,
+                                          p_cb, p_cb2, user_data));
+  return true;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_disc_cache_cancel
+ *
+ * Description      This function cancels a search answered from the
+ *                  attribute lists whose completion callback was not called
+ *                  yet. The callback is then called with SDP_CANCEL.
+ *
+ * Returns          true if the search was cancelled, false if not found
+ *
+ ******************************************************************************/
+bool sdp_disc_cache_cancel(const tSDP_DISCOVERY_DB* p_db) {
+  for (auto& answer : sdp_disc_cache_answers) {
+    if (answer.p_db == p_db) {
+      answer.result = SDP_CANCEL;
+      return true;
+    }
+  }
+  return false;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_disc_cache_flush
+ *
+ * Description      This function drops the attribute lists of a peer, when
+ *                  the link to it is lost or its bond is removed.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void sdp_disc_cache_flush(const RawAddress& bd_addr) {
+  sdp_disc_cache.remove_if([&bd_addr](const tSDP_DISC_CACHE_ENTRY& entry) {
+    return entry.bd_addr == bd_addr;
+  });
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_disc_cache_clear
+ *
+ * Description      This function drops the attribute lists of all the peers
+ *                  and the answers not delivered yet.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+void sdp_disc_cache_clear(void) {
+  sdp_disc_cache.clear();
+  sdp_disc_cache_answers.clear();
+}
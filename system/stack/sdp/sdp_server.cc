@@ -28,6 +28,8 @@
 #include <string.h>  // memcpy
 
 #include <cstdint>
+#include <list>
+#include <vector>
 
 #include "btif/include/btif_config.h"
 #include "device/include/interop.h"
@@ -43,6 +45,22 @@
 #define SDP_MAX_SERVATTR_RSPHDR_LEN 10
 #define SDP_MAX_ATTR_RSPHDR_LEN 10
 
+/* Maximum number of encoded attribute lists kept for the next requests */
+#define SDP_MAX_CACHED_RSP 8
+
+/* Attribute list encoded for a request, with the UUID sequence or record
+ * handle and the attribute sequence of the request as received */
+typedef struct {
+  uint8_t pdu_id;
+  std::vector<uint8_t> request;
+  std::vector<uint8_t> attr_list;
+} tSDP_RSP_CACHE_ENTRY;
+
+/* Encoded attribute lists, the most recently used first, all of them valid
+ * for the generation of the database they were encoded from */
+static std::list<tSDP_RSP_CACHE_ENTRY> sdp_rsp_cache;
+static uint32_t sdp_rsp_cache_generation = 0;
+
 /******************************************************************************/
 /*            L O C A L    F U N C T I O N     P R O T O T Y P E S            */
 /******************************************************************************/
@@ -303,6 +321,255 @@ static void process_service_search(tCONN_CB* p_ccb, uint16_t trans_num,
   L2CA_DataWrite(p_ccb->connection_id, p_buf);
 }
 
+/*******************************************************************************
+ *
+ * Function         sdp_rsp_cache_find
+ *
+ * Description      This function looks for the attribute list encoded for an
+ *                  identical request, provided that the database did not
+ *                  change since.
+ *
+ * Returns          Pointer to the attribute list, or NULL if not found.
+ *
+ ******************************************************************************/
+static const std::vector<uint8_t>* sdp_rsp_cache_find(
+    uint8_t pdu_id, const std::vector<uint8_t>& request) {
+  uint32_t generation = sdp_db_get_generation();
+
+  if (generation != sdp_rsp_cache_generation) {
+    sdp_rsp_cache.clear();
+    sdp_rsp_cache_generation = generation;
+    return NULL;
+  }
+
+  for (auto it = sdp_rsp_cache.begin(); it != sdp_rsp_cache.end(); it++) {
+    if (it->pdu_id == pdu_id && it->request == request) {
+      /* Keep the most recently used lists first */
+      sdp_rsp_cache.splice(sdp_rsp_cache.begin(), sdp_rsp_cache, it);
+      return &sdp_rsp_cache.front().attr_list;
+    }
+  }
+  return NULL;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_rsp_cache_add
+ *
+ * Description      This function keeps the attribute list encoded for a
+ *                  request, dropping the least recently used one if needed.
+ *
+ * Returns          Pointer to the attribute list kept.
+ *
+ ******************************************************************************/
+static const std::vector<uint8_t>* sdp_rsp_cache_add(
+    uint8_t pdu_id, std::vector<uint8_t> request,
+    std::vector<uint8_t> attr_list) {
+  sdp_rsp_cache.push_front(
+      {pdu_id, std::move(request), std::move(attr_list)});
+  if (sdp_rsp_cache.size() > SDP_MAX_CACHED_RSP) sdp_rsp_cache.pop_back();
+  return &sdp_rsp_cache.front().attr_list;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_insert_seq_header
+ *
+ * Description      This function turns the end of a list, from an offset on,
+ *                  into a data element sequence.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void sdp_insert_seq_header(std::vector<uint8_t>& list, size_t offset,
+                                  bool size_in_next_word) {
+  size_t seq_len = list.size() - offset;
+  uint8_t hdr[3];
+  uint8_t* p = hdr;
+
+  if (size_in_next_word) {
+    UINT8_TO_BE_STREAM(p, (DATA_ELE_SEQ_DESC_TYPE << 3) | SIZE_IN_NEXT_WORD);
+    UINT16_TO_BE_STREAM(p, seq_len);
+  } else {
+    UINT8_TO_BE_STREAM(p, (DATA_ELE_SEQ_DESC_TYPE << 3) | SIZE_IN_NEXT_BYTE);
+    UINT8_TO_BE_STREAM(p, seq_len);
+  }
+  list.insert(list.begin() + offset, hdr, p);
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_build_attrib_list
+ *
+ * Description      This function appends the attributes of a record matching
+ *                  an attribute sequence to a list.
+ *
+ * Returns          false if the attributes were tailored to the peer, and the
+ *                  list can't be sent to other peers, else true
+ *
+ ******************************************************************************/
+static bool sdp_build_attrib_list(tCONN_CB* p_ccb, const tSDP_RECORD* p_rec,
+                                  const tSDP_ATTR_SEQ* attr_seq,
+                                  std::vector<uint8_t>& list) {
+  bool is_service_avrc_target = false;
+  const tSDP_ATTRIBUTE* p_attr;
+  uint16_t start_id, end_id, xx;
+  size_t offset;
+
+  p_attr = sdp_db_find_attr_in_rec(p_rec, ATTR_ID_SERVICE_CLASS_ID_LIST,
+                                   ATTR_ID_SERVICE_CLASS_ID_LIST);
+  if (p_attr) is_service_avrc_target = sdpu_is_service_id_avrc_target(p_attr);
+
+  for (xx = 0; xx < attr_seq->num_attr; xx++) {
+    start_id = attr_seq->attr_entry[xx].start;
+    end_id = attr_seq->attr_entry[xx].end;
+
+    /* If doing a range, stick with it till no more attributes found */
+    while ((p_attr = sdp_db_find_attr_in_rec(p_rec, start_id, end_id))) {
+      if (is_service_avrc_target) {
+        sdpu_set_avrc_target_version(p_attr, &(p_ccb->device_address));
+      }
+      offset = list.size();
+      list.resize(offset + sdpu_get_attrib_entry_len(p_attr));
+      sdpu_build_attrib_entry(&list[offset], p_attr);
+
+      if (p_attr->id == end_id) break;
+      start_id = p_attr->id + 1;
+    }
+  }
+  return !is_service_avrc_target;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_set_rsp_list
+ *
+ * Description      This function copies the attribute list to send in one or
+ *                  more responses to the connection control block.
+ *
+ * Returns          false if the list is too long, else true
+ *
+ ******************************************************************************/
+static bool sdp_set_rsp_list(tCONN_CB* p_ccb,
+                             const std::vector<uint8_t>& attr_list) {
+  if (attr_list.size() > UINT16_MAX) {
+    SDP_TRACE_ERROR("SDP attr list too big: list_len=%zu", attr_list.size());
+    return false;
+  }
+
+  osi_free(p_ccb->rsp_list);
+  p_ccb->rsp_list = (uint8_t*)osi_malloc(attr_list.size());
+  memcpy(p_ccb->rsp_list, attr_list.data(), attr_list.size());
+  p_ccb->list_len = (uint16_t)attr_list.size();
+  p_ccb->cont_offset = 0;
+  return true;
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_send_attrib_list_rsp
+ *
+ * Description      This function sends the next part of the attribute list
+ *                  held in the connection control block, with the
+ *                  continuation state for the remaining part if any.
+ *
+ * Returns          void
+ *
+ ******************************************************************************/
+static void sdp_send_attrib_list_rsp(tCONN_CB* p_ccb, uint8_t pdu_id,
+                                     uint16_t trans_num,
+                                     uint16_t max_list_len) {
+  uint8_t *p_rsp, *p_rsp_start, *p_rsp_param_len;
+  uint16_t len_to_send, rsp_param_len;
+
+  len_to_send = p_ccb->list_len - p_ccb->cont_offset;
+  if (len_to_send > max_list_len) len_to_send = max_list_len;
+
+  /* Get a buffer to use to build the response */
+  BT_HDR* p_buf = (BT_HDR*)osi_malloc(SDP_DATA_BUF_SIZE);
+  p_buf->offset = L2CAP_MIN_OFFSET;
+  p_rsp = p_rsp_start = (uint8_t*)(p_buf + 1) + L2CAP_MIN_OFFSET;
+
+  /* Start building a rsponse */
+  UINT8_TO_BE_STREAM(p_rsp, pdu_id);
+  UINT16_TO_BE_STREAM(p_rsp, trans_num);
+
+  /* Skip the parameter length, add it when we know the length */
+  p_rsp_param_len = p_rsp;
+  p_rsp += 2;
+
+  /* Stream the list length to send */
+  UINT16_TO_BE_STREAM(p_rsp, len_to_send);
+
+  /* copy from rsp_list to the actual buffer to be sent */
+  memcpy(p_rsp, &p_ccb->rsp_list[p_ccb->cont_offset], len_to_send);
+  p_rsp += len_to_send;
+
+  p_ccb->cont_offset += len_to_send;
+
+  /* If anything left to send, continuation needed */
+  if (p_ccb->cont_offset < p_ccb->list_len) {
+    UINT8_TO_BE_STREAM(p_rsp, SDP_CONTINUATION_LEN);
+    UINT16_TO_BE_STREAM(p_rsp, p_ccb->cont_offset);
+  } else
+    UINT8_TO_BE_STREAM(p_rsp, 0);
+
+  /* Go back and put the parameter length into the buffer */
+  rsp_param_len = p_rsp - p_rsp_param_len - 2;
+  UINT16_TO_BE_STREAM(p_rsp_param_len, rsp_param_len);
+
+  /* Set the length of the SDP data in the buffer */
+  p_buf->len = p_rsp - p_rsp_start;
+
+  /* Send the buffer through L2CAP */
+  L2CA_DataWrite(p_ccb->connection_id, p_buf);
+}
+
+/*******************************************************************************
+ *
+ * Function         sdp_check_cont_state
+ *
+ * Description      This function checks the continuation state of a request,
+ *                  which must point within the attribute list being sent.
+ *
+ * Returns          true if the request continues the current list, false if
+ *                  it starts a new one or an error was sent
+ *
+ ******************************************************************************/
+static bool sdp_check_cont_state(tCONN_CB* p_ccb, uint16_t trans_num,
+                                 uint8_t* p_req, uint8_t* p_req_end,
+                                 bool* p_is_cont) {
+  uint16_t cont_offset;
+
+  *p_is_cont = false;
+  if (p_req + 1 > p_req_end) {
+    sdpu_build_n_send_error(p_ccb, trans_num, SDP_INVALID_CONT_STATE,
+                            SDP_TEXT_BAD_CONT_LEN);
+    return false;
+  }
+  if (*p_req == 0) return true;
+
+  if (*p_req++ != SDP_CONTINUATION_LEN ||
+      (p_req + sizeof(cont_offset) > p_req_end)) {
+    sdpu_build_n_send_error(p_ccb, trans_num, SDP_INVALID_CONT_STATE,
+                            SDP_TEXT_BAD_CONT_LEN);
+    return false;
+  }
+  BE_STREAM_TO_UINT16(cont_offset, p_req);
+
+  /* The list was kept as it was when the first response was sent, so a
+   * valid continuation always makes progress even if the database changed
+   * in between */
+  if (p_ccb->rsp_list == NULL || cont_offset != p_ccb->cont_offset ||
+      cont_offset >= p_ccb->list_len) {
+    sdpu_build_n_send_error(p_ccb, trans_num, SDP_INVALID_CONT_STATE,
+                            SDP_TEXT_BAD_CONT_INX);
+    return false;
+  }
+  *p_is_cont = true;
+  return true;
+}
+
 /*******************************************************************************
  *
  * Function         process_service_attr_req
@@ -317,16 +584,12 @@ static void process_service_search(tCONN_CB* p_ccb, uint16_t trans_num,
 static void process_service_attr_req(tCONN_CB* p_ccb, uint16_t trans_num,
                                      uint16_t param_len, uint8_t* p_req,
                                      uint8_t* p_req_end) {
-  uint16_t max_list_len, len_to_send, cont_offset;
-  int16_t rem_len;
-  tSDP_ATTR_SEQ attr_seq, attr_seq_sav;
-  uint8_t *p_rsp, *p_rsp_start, *p_rsp_param_len;
-  uint16_t rsp_param_len, xx;
+  uint16_t max_list_len;
+  tSDP_ATTR_SEQ attr_seq;
   uint32_t rec_handle;
   const tSDP_RECORD* p_rec;
-  const tSDP_ATTRIBUTE* p_attr;
-  bool is_cont = false;
-  uint16_t attr_len;
+  uint8_t* p_seq_start;
+  bool is_cont;
 
   if (p_req + sizeof(rec_handle) + sizeof(max_list_len) > p_req_end) {
     android_errorWriteLog(0x534e4554, "69384124");
@@ -336,6 +599,7 @@ static void process_service_attr_req(tCONN_CB* p_ccb, uint16_t trans_num,
   }
 
   /* Extract the record handle */
+  std::vector<uint8_t> request(p_req, p_req + sizeof(rec_handle));
   BE_STREAM_TO_UINT32(rec_handle, p_req);
   param_len -= sizeof(rec_handle);
 
@@ -346,6 +610,7 @@ static void process_service_attr_req(tCONN_CB* p_ccb, uint16_t trans_num,
   if (max_list_len > (p_ccb->rem_mtu_size - SDP_MAX_ATTR_RSPHDR_LEN))
     max_list_len = p_ccb->rem_mtu_size - SDP_MAX_ATTR_RSPHDR_LEN;
 
+  p_seq_start = p_req;
   p_req = sdpu_extract_attr_seq(p_req, param_len, &attr_seq);
 
   if ((!p_req) || (!attr_seq.num_attr) ||
@@ -354,8 +619,7 @@ static void process_service_attr_req(tCONN_CB* p_ccb, uint16_t trans_num,
                             SDP_TEXT_BAD_ATTR_LIST);
     return;
   }
-
-  memcpy(&attr_seq_sav, &attr_seq, sizeof(tSDP_ATTR_SEQ));
+  request.insert(request.end(), p_seq_start, p_req);
 
   /* Find a record with the record handle */
   p_rec = sdp_db_find_record(rec_handle);
@@ -371,184 +635,36 @@ static void process_service_attr_req(tCONN_CB* p_ccb, uint16_t trans_num,
     return;
   }
 
-  /* Free and reallocate buffer */
-  osi_free(p_ccb->rsp_list);
-  p_ccb->rsp_list = (uint8_t*)osi_malloc(max_list_len);
-
   /* Check if this is a continuation request */
-  if (p_req + 1 > p_req_end) {
-    sdpu_build_n_send_error(p_ccb, trans_num, SDP_INVALID_CONT_STATE,
-                            SDP_TEXT_BAD_CONT_LEN);
+  if (!sdp_check_cont_state(p_ccb, trans_num, p_req, p_req_end, &is_cont))
     return;
-  }
-  if (*p_req) {
-    if (*p_req++ != SDP_CONTINUATION_LEN ||
-        (p_req + sizeof(cont_offset) > p_req_end)) {
-      sdpu_build_n_send_error(p_ccb, trans_num, SDP_INVALID_CONT_STATE,
-                              SDP_TEXT_BAD_CONT_LEN);
-      return;
-    }
-    BE_STREAM_TO_UINT16(cont_offset, p_req);
 
-    if (cont_offset != p_ccb->cont_offset) {
-      sdpu_build_n_send_error(p_ccb, trans_num, SDP_INVALID_CONT_STATE,
-                              SDP_TEXT_BAD_CONT_INX);
-      return;
-    }
-    is_cont = true;
-
-    /* Initialise for continuation response */
-    p_rsp = &p_ccb->rsp_list[0];
-    attr_seq.attr_entry[p_ccb->cont_info.next_attr_index].start =
-        p_ccb->cont_info.next_attr_start_id;
-  } else {
-    p_ccb->cont_offset = 0;
-    p_rsp = &p_ccb->rsp_list[3]; /* Leave space for data elem descr */
-
-    /* Reset continuation parameters in p_ccb */
-    p_ccb->cont_info.prev_sdp_rec = NULL;
-    p_ccb->cont_info.next_attr_index = 0;
-    p_ccb->cont_info.attr_offset = 0;
-  }
-
-  bool is_service_avrc_target = false;
-  const tSDP_ATTRIBUTE* p_attr_service_id;
-  p_attr_service_id = sdp_db_find_attr_in_rec(
-      p_rec, ATTR_ID_SERVICE_CLASS_ID_LIST, ATTR_ID_SERVICE_CLASS_ID_LIST);
-  if (p_attr_service_id) {
-    is_service_avrc_target = sdpu_is_service_id_avrc_target(p_attr_service_id);
-  }
-  /* Search for attributes that match the list given to us */
-  for (xx = p_ccb->cont_info.next_attr_index; xx < attr_seq.num_attr; xx++) {
-    p_attr = sdp_db_find_attr_in_rec(p_rec, attr_seq.attr_entry[xx].start,
-                                     attr_seq.attr_entry[xx].end);
-
-    if (p_attr) {
-      if (is_service_avrc_target) {
-        sdpu_set_avrc_target_version(p_attr, &(p_ccb->device_address));
-      }
-      /* Check if attribute fits. Assume 3-byte value type/length */
-      rem_len = max_list_len - (int16_t)(p_rsp - &p_ccb->rsp_list[0]);
-
-      /* just in case */
-      if (rem_len <= 0) {
-        p_ccb->cont_info.next_attr_index = xx;
-        p_ccb->cont_info.next_attr_start_id = p_attr->id;
-        break;
-      }
-
-      attr_len = sdpu_get_attrib_entry_len(p_attr);
-      /* if there is a partial attribute pending to be sent */
-      if (p_ccb->cont_info.attr_offset) {
-        if (attr_len < p_ccb->cont_info.attr_offset) {
-          android_errorWriteLog(0x534e4554, "79217770");
-          LOG(ERROR) << "offset is bigger than attribute length";
-          sdpu_build_n_send_error(p_ccb, trans_num, SDP_INVALID_CONT_STATE,
-                                  SDP_TEXT_BAD_CONT_LEN);
-          return;
-        }
-        p_rsp = sdpu_build_partial_attrib_entry(p_rsp, p_attr, rem_len,
-                                                &p_ccb->cont_info.attr_offset);
-
-        /* If the partial attrib could not been fully added yet */
-        if (p_ccb->cont_info.attr_offset != attr_len)
-          break;
-        else /* If the partial attrib has been added in full by now */
-          p_ccb->cont_info.attr_offset = 0; /* reset attr_offset */
-      } else if (rem_len <
-                 attr_len) /* Not enough space for attr... so add partially */
-      {
-        if (attr_len >= SDP_MAX_ATTR_LEN) {
-          SDP_TRACE_ERROR("SDP attr too big: max_list_len=%d,attr_len=%d",
-                          max_list_len, attr_len);
-          sdpu_build_n_send_error(p_ccb, trans_num, SDP_NO_RESOURCES, NULL);
-          return;
-        }
-
-        /* add the partial attribute if possible */
-        p_rsp = sdpu_build_partial_attrib_entry(
-            p_rsp, p_attr, (uint16_t)rem_len, &p_ccb->cont_info.attr_offset);
-
-        p_ccb->cont_info.next_attr_index = xx;
-        p_ccb->cont_info.next_attr_start_id = p_attr->id;
-        break;
-      } else /* build the whole attribute */
-        p_rsp = sdpu_build_attrib_entry(p_rsp, p_attr);
-
-      /* If doing a range, stick with this one till no more attributes found */
-      if (attr_seq.attr_entry[xx].start != attr_seq.attr_entry[xx].end) {
-        /* Update for next time through */
-        attr_seq.attr_entry[xx].start = p_attr->id + 1;
-
-        xx--;
-      }
+  if (!is_cont) {
+    const std::vector<uint8_t>* p_list =
+        sdp_rsp_cache_find(SDP_PDU_SERVICE_ATTR_REQ, request);
+    std::vector<uint8_t> attr_list;
+
+    if (!p_list) {
+      bool is_cacheable =
+          sdp_build_attrib_list(p_ccb, p_rec, &attr_seq, attr_list);
+      /* Put in the sequence header (2 or 3 bytes) */
+      sdp_insert_seq_header(attr_list, 0, attr_list.size() + 3 > 255);
+
+      if (is_cacheable)
+        p_list = sdp_rsp_cache_add(SDP_PDU_SERVICE_ATTR_REQ,
+                                   std::move(request), std::move(attr_list));
+      else
+        p_list = &attr_list;
     }
-  }
-  /* If all the attributes have been accomodated in p_rsp,
-     reset next_attr_index */
-  if (xx == attr_seq.num_attr) p_ccb->cont_info.next_attr_index = 0;
 
-  len_to_send = (uint16_t)(p_rsp - &p_ccb->rsp_list[0]);
-  cont_offset = 0;
-
-  if (!is_cont) {
-    p_ccb->list_len = sdpu_get_attrib_seq_len(p_rec, &attr_seq_sav) + 3;
-    /* Put in the sequence header (2 or 3 bytes) */
-    if (p_ccb->list_len > 255) {
-      p_ccb->rsp_list[0] =
-          (uint8_t)((DATA_ELE_SEQ_DESC_TYPE << 3) | SIZE_IN_NEXT_WORD);
-      p_ccb->rsp_list[1] = (uint8_t)((p_ccb->list_len - 3) >> 8);
-      p_ccb->rsp_list[2] = (uint8_t)(p_ccb->list_len - 3);
-    } else {
-      cont_offset = 1;
-
-      p_ccb->rsp_list[1] =
-          (uint8_t)((DATA_ELE_SEQ_DESC_TYPE << 3) | SIZE_IN_NEXT_BYTE);
-      p_ccb->rsp_list[2] = (uint8_t)(p_ccb->list_len - 3);
-
-      p_ccb->list_len--;
-      len_to_send--;
+    if (!sdp_set_rsp_list(p_ccb, *p_list)) {
+      sdpu_build_n_send_error(p_ccb, trans_num, SDP_NO_RESOURCES, NULL);
+      return;
     }
   }
 
-  /* Get a buffer to use to build the response */
-  BT_HDR* p_buf = (BT_HDR*)osi_malloc(SDP_DATA_BUF_SIZE);
-  p_buf->offset = L2CAP_MIN_OFFSET;
-  p_rsp = p_rsp_start = (uint8_t*)(p_buf + 1) + L2CAP_MIN_OFFSET;
-
-  /* Start building a rsponse */
-  UINT8_TO_BE_STREAM(p_rsp, SDP_PDU_SERVICE_ATTR_RSP);
-  UINT16_TO_BE_STREAM(p_rsp, trans_num);
-
-  /* Skip the parameter length, add it when we know the length */
-  p_rsp_param_len = p_rsp;
-  p_rsp += 2;
-
-  UINT16_TO_BE_STREAM(p_rsp, len_to_send);
-
-  memcpy(p_rsp, &p_ccb->rsp_list[cont_offset], len_to_send);
-  p_rsp += len_to_send;
-
-  p_ccb->cont_offset += len_to_send;
-
-  /* If anything left to send, continuation needed */
-  if (p_ccb->cont_offset < p_ccb->list_len) {
-    is_cont = true;
-
-    UINT8_TO_BE_STREAM(p_rsp, SDP_CONTINUATION_LEN);
-    UINT16_TO_BE_STREAM(p_rsp, p_ccb->cont_offset);
-  } else
-    UINT8_TO_BE_STREAM(p_rsp, 0);
-
-  /* Go back and put the parameter length into the buffer */
-  rsp_param_len = p_rsp - p_rsp_param_len - 2;
-  UINT16_TO_BE_STREAM(p_rsp_param_len, rsp_param_len);
-
-  /* Set the length of the SDP data in the buffer */
-  p_buf->len = p_rsp - p_rsp_start;
-
-  /* Send the buffer through L2CAP */
-  L2CA_DataWrite(p_ccb->connection_id, p_buf);
+  sdp_send_attrib_list_rsp(p_ccb, SDP_PDU_SERVICE_ATTR_RSP, trans_num,
+                           max_list_len);
 }
 
 /*******************************************************************************
@@ -567,17 +683,11 @@ static void process_service_search_attr_req(tCONN_CB* p_ccb, uint16_t trans_num,
                                             uint16_t param_len, uint8_t* p_req,
                                             uint8_t* p_req_end) {
   uint16_t max_list_len;
-  int16_t rem_len;
-  uint16_t len_to_send, cont_offset;
   tSDP_UUID_SEQ uid_seq;
-  uint8_t *p_rsp, *p_rsp_start, *p_rsp_param_len;
-  uint16_t rsp_param_len, xx;
   const tSDP_RECORD* p_rec;
-  tSDP_ATTR_SEQ attr_seq, attr_seq_sav;
-  const tSDP_ATTRIBUTE* p_attr;
-  bool maxxed_out = false, is_cont = false;
-  uint8_t* p_seq_start;
-  uint16_t seq_len, attr_len;
+  tSDP_ATTR_SEQ attr_seq;
+  uint8_t* p_seq_start = p_req;
+  bool is_cont;
 
   /* Extract the UUID sequence to search for */
   p_req = sdpu_extract_uid_seq(p_req, param_len, &uid_seq);
@@ -588,6 +698,7 @@ static void process_service_search_attr_req(tCONN_CB* p_ccb, uint16_t trans_num,
                             SDP_TEXT_BAD_UUID_LIST);
     return;
   }
+  std::vector<uint8_t> request(p_seq_start, p_req);
 
   /* Get the max list length we can send. Cap it at our max list length. */
   BE_STREAM_TO_UINT16(max_list_len, p_req);
@@ -596,6 +707,7 @@ static void process_service_search_attr_req(tCONN_CB* p_ccb, uint16_t trans_num,
     max_list_len = p_ccb->rem_mtu_size - SDP_MAX_SERVATTR_RSPHDR_LEN;
 
   param_len = static_cast<uint16_t>(p_req_end - p_req);
+  p_seq_start = p_req;
   p_req = sdpu_extract_attr_seq(p_req, param_len, &attr_seq);
 
   if ((!p_req) || (!attr_seq.num_attr) ||
@@ -604,8 +716,7 @@ static void process_service_search_attr_req(tCONN_CB* p_ccb, uint16_t trans_num,
                             SDP_TEXT_BAD_ATTR_LIST);
     return;
   }
-
-  memcpy(&attr_seq_sav, &attr_seq, sizeof(tSDP_ATTR_SEQ));
+  request.insert(request.end(), p_seq_start, p_req);
 
   if (max_list_len < 4) {
     sdpu_build_n_send_error(p_ccb, trans_num, SDP_ILLEGAL_PARAMETER, NULL);
@@ -613,258 +724,46 @@ static void process_service_search_attr_req(tCONN_CB* p_ccb, uint16_t trans_num,
     return;
   }
 
-  /* Free and reallocate buffer */
-  osi_free(p_ccb->rsp_list);
-  p_ccb->rsp_list = (uint8_t*)osi_malloc(max_list_len);
-
   /* Check if this is a continuation request */
-  if (p_req + 1 > p_req_end) {
-    sdpu_build_n_send_error(p_ccb, trans_num, SDP_INVALID_CONT_STATE,
-                            SDP_TEXT_BAD_CONT_LEN);
+  if (!sdp_check_cont_state(p_ccb, trans_num, p_req, p_req_end, &is_cont))
     return;
-  }
-  if (*p_req) {
-    if (*p_req++ != SDP_CONTINUATION_LEN ||
-        (p_req + sizeof(uint16_t) > p_req_end)) {
-      sdpu_build_n_send_error(p_ccb, trans_num, SDP_INVALID_CONT_STATE,
-                              SDP_TEXT_BAD_CONT_LEN);
-      return;
-    }
-    BE_STREAM_TO_UINT16(cont_offset, p_req);
 
-    if (cont_offset != p_ccb->cont_offset) {
-      sdpu_build_n_send_error(p_ccb, trans_num, SDP_INVALID_CONT_STATE,
-                              SDP_TEXT_BAD_CONT_INX);
-      return;
-    }
-    is_cont = true;
+  if (!is_cont) {
+    const std::vector<uint8_t>* p_list =
+        sdp_rsp_cache_find(SDP_PDU_SERVICE_SEARCH_ATTR_REQ, request);
+    std::vector<uint8_t> attr_list;
 
-    /* Initialise for continuation response */
-    p_rsp = &p_ccb->rsp_list[0];
-    attr_seq.attr_entry[p_ccb->cont_info.next_attr_index].start =
-        p_ccb->cont_info.next_attr_start_id;
-  } else {
-    p_ccb->cont_offset = 0;
-    p_rsp = &p_ccb->rsp_list[3]; /* Leave space for data elem descr */
+    if (!p_list) {
+      bool is_cacheable = true;
 
-    /* Reset continuation parameters in p_ccb */
-    p_ccb->cont_info.prev_sdp_rec = NULL;
-    p_ccb->cont_info.next_attr_index = 0;
-    p_ccb->cont_info.last_attr_seq_desc_sent = false;
-    p_ccb->cont_info.attr_offset = 0;
-  }
+      /* Get a list of handles that match the UUIDs given to us */
+      for (p_rec = sdp_db_service_search(NULL, &uid_seq); p_rec;
+           p_rec = sdp_db_service_search(p_rec, &uid_seq)) {
+        size_t seq_start = attr_list.size();
 
-  /* Get a list of handles that match the UUIDs given to us */
-  for (p_rec = sdp_db_service_search(p_ccb->cont_info.prev_sdp_rec, &uid_seq);
-       p_rec; p_rec = sdp_db_service_search(p_rec, &uid_seq)) {
-    /* Allow space for attribute sequence type and length */
-    p_seq_start = p_rsp;
-    if (!p_ccb->cont_info.last_attr_seq_desc_sent) {
-      /* See if there is enough room to include a new service in the current
-       * response */
-      rem_len = max_list_len - (int16_t)(p_rsp - &p_ccb->rsp_list[0]);
-      if (rem_len < 3) {
-        /* Not enough room. Update continuation info for next response */
-        p_ccb->cont_info.next_attr_index = 0;
-        p_ccb->cont_info.next_attr_start_id = attr_seq.attr_entry[0].start;
-        break;
-      }
-      p_rsp += 3;
-    }
+        if (!sdp_build_attrib_list(p_ccb, p_rec, &attr_seq, attr_list))
+          is_cacheable = false;
 
-    bool is_service_avrc_target = false;
-    const tSDP_ATTRIBUTE* p_attr_service_id;
-    p_attr_service_id = sdp_db_find_attr_in_rec(
-        p_rec, ATTR_ID_SERVICE_CLASS_ID_LIST, ATTR_ID_SERVICE_CLASS_ID_LIST);
-    if (p_attr_service_id) {
-      is_service_avrc_target =
-          sdpu_is_service_id_avrc_target(p_attr_service_id);
-    }
-    /* Get a list of handles that match the UUIDs given to us */
-    for (xx = p_ccb->cont_info.next_attr_index; xx < attr_seq.num_attr; xx++) {
-      p_attr = sdp_db_find_attr_in_rec(p_rec, attr_seq.attr_entry[xx].start,
-                                       attr_seq.attr_entry[xx].end);
-
-      if (p_attr) {
-        if (is_service_avrc_target) {
-          sdpu_set_avrc_target_version(p_attr, &(p_ccb->device_address));
-        }
-        /* Check if attribute fits. Assume 3-byte value type/length */
-        rem_len = max_list_len - (int16_t)(p_rsp - &p_ccb->rsp_list[0]);
-
-        /* just in case */
-        if (rem_len <= 0) {
-          p_ccb->cont_info.next_attr_index = xx;
-          p_ccb->cont_info.next_attr_start_id = p_attr->id;
-          maxxed_out = true;
-          break;
-        }
-
-        attr_len = sdpu_get_attrib_entry_len(p_attr);
-        /* if there is a partial attribute pending to be sent */
-        if (p_ccb->cont_info.attr_offset) {
-          if (attr_len < p_ccb->cont_info.attr_offset) {
-            android_errorWriteLog(0x534e4554, "79217770");
-            LOG(ERROR) << "offset is bigger than attribute length";
-            sdpu_build_n_send_error(p_ccb, trans_num, SDP_INVALID_CONT_STATE,
-                                    SDP_TEXT_BAD_CONT_LEN);
-            return;
-          }
-          p_rsp = sdpu_build_partial_attrib_entry(
-              p_rsp, p_attr, rem_len, &p_ccb->cont_info.attr_offset);
-
-          /* If the partial attrib could not been fully added yet */
-          if (p_ccb->cont_info.attr_offset != attr_len) {
-            maxxed_out = true;
-            break;
-          } else /* If the partial attrib has been added in full by now */
-            p_ccb->cont_info.attr_offset = 0; /* reset attr_offset */
-        } else if (rem_len <
-                   attr_len) /* Not enough space for attr... so add partially */
-        {
-          if (attr_len >= SDP_MAX_ATTR_LEN) {
-            SDP_TRACE_ERROR("SDP attr too big: max_list_len=%d,attr_len=%d",
-                            max_list_len, attr_len);
-            sdpu_build_n_send_error(p_ccb, trans_num, SDP_NO_RESOURCES, NULL);
-            return;
-          }
-
-          /* add the partial attribute if possible */
-          p_rsp = sdpu_build_partial_attrib_entry(
-              p_rsp, p_attr, (uint16_t)rem_len, &p_ccb->cont_info.attr_offset);
-
-          p_ccb->cont_info.next_attr_index = xx;
-          p_ccb->cont_info.next_attr_start_id = p_attr->id;
-          maxxed_out = true;
-          break;
-        } else /* build the whole attribute */
-          p_rsp = sdpu_build_attrib_entry(p_rsp, p_attr);
-
-        /* If doing a range, stick with this one till no more attributes found
-         */
-        if (attr_seq.attr_entry[xx].start != attr_seq.attr_entry[xx].end) {
-          /* Update for next time through */
-          attr_seq.attr_entry[xx].start = p_attr->id + 1;
-
-          xx--;
-        }
+        /* Records without any of the attributes are left out */
+        if (attr_list.size() != seq_start)
+          sdp_insert_seq_header(attr_list, seq_start, true);
       }
+      /* Put in the sequence header (2 or 3 bytes) */
+      sdp_insert_seq_header(attr_list, 0, attr_list.size() + 3 > 255);
+
+      if (is_cacheable)
+        p_list = sdp_rsp_cache_add(SDP_PDU_SERVICE_SEARCH_ATTR_REQ,
+                                   std::move(request), std::move(attr_list));
+      else
+        p_list = &attr_list;
     }
 
-    /* Go back and put the type and length into the buffer */
-    if (!p_ccb->cont_info.last_attr_seq_desc_sent) {
-      seq_len = sdpu_get_attrib_seq_len(p_rec, &attr_seq_sav);
-      if (seq_len != 0) {
-        UINT8_TO_BE_STREAM(p_seq_start,
-                           (DATA_ELE_SEQ_DESC_TYPE << 3) | SIZE_IN_NEXT_WORD);
-        UINT16_TO_BE_STREAM(p_seq_start, seq_len);
-
-        if (maxxed_out) p_ccb->cont_info.last_attr_seq_desc_sent = true;
-      } else
-        p_rsp = p_seq_start;
-    }
-
-    if (maxxed_out) break;
-
-    /* Restore the attr_seq to look for in the next sdp record */
-    memcpy(&attr_seq, &attr_seq_sav, sizeof(tSDP_ATTR_SEQ));
-
-    /* Reset the next attr index */
-    p_ccb->cont_info.next_attr_index = 0;
-    p_ccb->cont_info.prev_sdp_rec = p_rec;
-    p_ccb->cont_info.last_attr_seq_desc_sent = false;
-  }
-
-  /* response length */
-  len_to_send = (uint16_t)(p_rsp - &p_ccb->rsp_list[0]);
-  cont_offset = 0;
-
-  // The current SDP server design has a critical flaw where it can run into
-  // an infinite request/response loop with the client. Here's the scenario:
-  // - client makes SDP request
-  // - server returns the first fragment of the response with a continuation
-  //   token
-  // - an SDP record is deleted from the server
-  // - client issues another request with previous continuation token
-  // - server has nothing to send back because the record is unavailable but
-  //   in the first fragment, it had specified more response bytes than are
-  //   now available
-  // - server sends back no additional response bytes and returns the same
-  //   continuation token
-  // - client issues another request with the continuation token, and the
-  //   process repeats
-  //
-  // We work around this design flaw here by checking if we will make forward
-  // progress (i.e. we will send > 0 response bytes) on a continued request.
-  // If not, we must have run into the above situation and we tell the peer an
-  // error occurred.
-  //
-  // TODO(sharvil): rewrite SDP server.
-  if (is_cont && len_to_send == 0) {
-    sdpu_build_n_send_error(p_ccb, trans_num, SDP_INVALID_CONT_STATE, NULL);
-    return;
-  }
-
-  /* If first response, insert sequence header */
-  if (!is_cont) {
-    /* Get the total list length for requested uid and attribute sequence */
-    p_ccb->list_len = sdpu_get_list_len(&uid_seq, &attr_seq_sav) + 3;
-    /* Put in the sequence header (2 or 3 bytes) */
-    if (p_ccb->list_len > 255) {
-      p_ccb->rsp_list[0] =
-          (uint8_t)((DATA_ELE_SEQ_DESC_TYPE << 3) | SIZE_IN_NEXT_WORD);
-      p_ccb->rsp_list[1] = (uint8_t)((p_ccb->list_len - 3) >> 8);
-      p_ccb->rsp_list[2] = (uint8_t)(p_ccb->list_len - 3);
-    } else {
-      cont_offset = 1;
-
-      p_ccb->rsp_list[1] =
-          (uint8_t)((DATA_ELE_SEQ_DESC_TYPE << 3) | SIZE_IN_NEXT_BYTE);
-      p_ccb->rsp_list[2] = (uint8_t)(p_ccb->list_len - 3);
-
-      p_ccb->list_len--;
-      len_to_send--;
+    if (!sdp_set_rsp_list(p_ccb, *p_list)) {
+      sdpu_build_n_send_error(p_ccb, trans_num, SDP_NO_RESOURCES, NULL);
+      return;
     }
   }
 
-  /* Get a buffer to use to build the response */
-  BT_HDR* p_buf = (BT_HDR*)osi_malloc(SDP_DATA_BUF_SIZE);
-  p_buf->offset = L2CAP_MIN_OFFSET;
-  p_rsp = p_rsp_start = (uint8_t*)(p_buf + 1) + L2CAP_MIN_OFFSET;
-
-  /* Start building a rsponse */
-  UINT8_TO_BE_STREAM(p_rsp, SDP_PDU_SERVICE_SEARCH_ATTR_RSP);
-  UINT16_TO_BE_STREAM(p_rsp, trans_num);
-
-  /* Skip the parameter length, add it when we know the length */
-  p_rsp_param_len = p_rsp;
-  p_rsp += 2;
-
-  /* Stream the list length to send */
-  UINT16_TO_BE_STREAM(p_rsp, len_to_send);
-
-  /* copy from rsp_list to the actual buffer to be sent */
-  memcpy(p_rsp, &p_ccb->rsp_list[cont_offset], len_to_send);
-  p_rsp += len_to_send;
-
-  p_ccb->cont_offset += len_to_send;
-
-  /* If anything left to send, continuation needed */
-  if (p_ccb->cont_offset < p_ccb->list_len) {
-    is_cont = true;
-
-    UINT8_TO_BE_STREAM(p_rsp, SDP_CONTINUATION_LEN);
-    UINT16_TO_BE_STREAM(p_rsp, p_ccb->cont_offset);
-  } else
-    UINT8_TO_BE_STREAM(p_rsp, 0);
-
-  /* Go back and put the parameter length into the buffer */
-  rsp_param_len = p_rsp - p_rsp_param_len - 2;
-  UINT16_TO_BE_STREAM(p_rsp_param_len, rsp_param_len);
-
-  /* Set the length of the SDP data in the buffer */
-  p_buf->len = p_rsp - p_rsp_start;
-
-  /* Send the buffer through L2CAP */
-  L2CA_DataWrite(p_ccb->connection_id, p_buf);
+  sdp_send_attrib_list_rsp(p_ccb, SDP_PDU_SERVICE_SEARCH_ATTR_RSP, trans_num,
+                           max_list_len);
 }
@@ -874,6 +874,32 @@ bool sdpu_is_base_uuid(uint8_t* p_uuid) {
   return (true);
 }
 
+/*******************************************************************************
+ *
+ * Function         sdpu_uuid_from_array
+ *
+ * Description      This function converts a UUID of 2, 4 or 16 bytes, as
+ *                  found in a data element, to its 128-bit form.
+ *
+ * Returns          true if the length is valid, else false
+ *
+ ******************************************************************************/
+bool sdpu_uuid_from_array(const uint8_t* p, uint32_t len, Uuid* p_uuid) {
+  switch (len) {
+    case Uuid::kNumBytes16:
+      *p_uuid = Uuid::From16Bit((p[0] << 8) | p[1]);
+      return true;
+    case Uuid::kNumBytes32:
+      *p_uuid = Uuid::From32Bit(((uint32_t)p[0] << 24) | (p[1] << 16) |
+                                (p[2] << 8) | p[3]);
+      return true;
+    case Uuid::kNumBytes128:
+      *p_uuid = Uuid::From128BitBE(p);
+      return true;
+  }
+  return false;
+}
+
 /*******************************************************************************
  *
  * Function         sdpu_compare_uuid_arrays
@@ -1006,76 +1032,6 @@ void sdpu_sort_attr_list(uint16_t num_attr, tSDP_DISCOVERY_DB* p_db) {
   }
 }
 
-/*******************************************************************************
- *
- * Function         sdpu_get_list_len
- *
- * Description      gets the total list length in the sdp database for a given
- *                  uid sequence and attr sequence
- *
- * Returns          void
- *
- ******************************************************************************/
-uint16_t sdpu_get_list_len(tSDP_UUID_SEQ* uid_seq, tSDP_ATTR_SEQ* attr_seq) {
-  const tSDP_RECORD* p_rec;
-  uint16_t len = 0;
-  uint16_t len1;
-
-  for (p_rec = sdp_db_service_search(NULL, uid_seq); p_rec;
-       p_rec = sdp_db_service_search(p_rec, uid_seq)) {
-    len += 3;
-
-    len1 = sdpu_get_attrib_seq_len(p_rec, attr_seq);
-
-    if (len1 != 0)
-      len += len1;
-    else
-      len -= 3;
-  }
-  return len;
-}
-
-/*******************************************************************************
- *
- * Function         sdpu_get_attrib_seq_len
- *
- * Description      gets the length of the specific attributes in a given
- *                  sdp record
- *
- * Returns          void
- *
- ******************************************************************************/
-uint16_t sdpu_get_attrib_seq_len(const tSDP_RECORD* p_rec,
-                                 const tSDP_ATTR_SEQ* attr_seq) {
-  const tSDP_ATTRIBUTE* p_attr;
-  uint16_t len1 = 0;
-  uint16_t xx;
-  bool is_range = false;
-  uint16_t start_id = 0, end_id = 0;
-
-  for (xx = 0; xx < attr_seq->num_attr; xx++) {
-    if (!is_range) {
-      start_id = attr_seq->attr_entry[xx].start;
-      end_id = attr_seq->attr_entry[xx].end;
-    }
-    p_attr = sdp_db_find_attr_in_rec(p_rec, start_id, end_id);
-    if (p_attr) {
-      len1 += sdpu_get_attrib_entry_len(p_attr);
-
-      /* If doing a range, stick with this one till no more attributes found */
-      if (start_id != end_id) {
-        /* Update for next time through */
-        start_id = p_attr->id + 1;
-        xx--;
-        is_range = true;
-      } else
-        is_range = false;
-    } else
-      is_range = false;
-  }
-  return len1;
-}
-
 /*******************************************************************************
  *
  * Function         sdpu_get_attrib_entry_len
@@ -1130,47 +1086,6 @@ uint16_t sdpu_get_attrib_entry_len(const tSDP_ATTRIBUTE* p_attr) {
   return len;
 }
 
-/*******************************************************************************
- *
- * Function         sdpu_build_partial_attrib_entry
- *
- * Description      This function fills a buffer with partial attribute. It is
- *                  assumed that the maximum size of any attribute is 256 bytes.
- *
- *                  p_out: output buffer
- *                  p_attr: attribute to be copied partially into p_out
- *                  rem_len: num bytes to copy into p_out
- *                  offset: current start offset within the attr that needs to
- *                          be copied
- *
- * Returns          Pointer to next byte in the output buffer.
- *                  offset is also updated
- *
- ******************************************************************************/
-uint8_t* sdpu_build_partial_attrib_entry(uint8_t* p_out,
-                                         const tSDP_ATTRIBUTE* p_attr,
-                                         uint16_t len, uint16_t* offset) {
-  uint8_t* p_attr_buff =
-      (uint8_t*)osi_malloc(sizeof(uint8_t) * SDP_MAX_ATTR_LEN);
-  sdpu_build_attrib_entry(p_attr_buff, p_attr);
-
-  uint16_t attr_len = sdpu_get_attrib_entry_len(p_attr);
-
-  if (len > SDP_MAX_ATTR_LEN) {
-    SDP_TRACE_ERROR("%s len %d exceeds SDP_MAX_ATTR_LEN", __func__, len);
-    len = SDP_MAX_ATTR_LEN;
-  }
-
-  size_t len_to_copy =
-      ((attr_len - *offset) < len) ? (attr_len - *offset) : len;
-  memcpy(p_out, &p_attr_buff[*offset], len_to_copy);
-
-  p_out = &p_out[len_to_copy];
-  *offset += len_to_copy;
-
-  osi_free(p_attr_buff);
-  return p_out;
-}
 /*******************************************************************************
  *
  * Function         sdpu_is_avrcp_profile_description_list
@@ -40,6 +40,11 @@
 
 /* Timeout definitions. */
 #define SDP_INACT_TIMEOUT_MS (30 * 1000) /* Inactivity timeout (in ms) */
+/* How long the attribute lists of a peer answer the searches (in ms) */
+#define SDP_DISC_CACHE_TIMEOUT_MS (30 * 1000)
+
+/* Number of peers whose attribute lists are kept */
+#define SDP_MAX_DISC_CACHE_ENTRIES 4
 
 /* Define the Protocol Data Unit (PDU) types.
  */
@@ -109,19 +114,6 @@ typedef struct {
   tSDP_RECORD record[SDP_MAX_RECORDS];
 } tSDP_DB;
 
-/* Continuation information for the SDP server response */
-typedef struct {
-  uint16_t next_attr_index;    /* attr index for next continuation response */
-  uint16_t next_attr_start_id; /* attr id to start with for the attr index in
-                                  next cont. response */
-  const tSDP_RECORD* prev_sdp_rec; /* last sdp record that was completely sent
-                                in the response */
-  bool last_attr_seq_desc_sent; /* whether attr seq length has been sent
-                                   previously */
-  uint16_t attr_offset; /* offset within the attr to keep trak of partial
-                           attributes in the responses */
-} tSDP_CONT_INFO;
-
 /* Define the SDP Connection Control Block */
 typedef struct {
 #define SDP_STATE_IDLE 0
@@ -164,8 +156,6 @@ typedef struct {
   uint8_t is_attr_search;
 
   uint16_t cont_offset;     /* Continuation state data in the server response */
-  tSDP_CONT_INFO cont_info; /* structure to hold continuation information for
-                               the server response */
 
 } tCONN_CB;
 
@@ -216,20 +206,15 @@ extern uint8_t* sdpu_extract_uid_seq(uint8_t* p, uint16_t param_len,
 extern uint8_t* sdpu_get_len_from_type(uint8_t* p, uint8_t* p_end, uint8_t type,
                                        uint32_t* p_len);
 extern bool sdpu_is_base_uuid(uint8_t* p_uuid);
+extern bool sdpu_uuid_from_array(const uint8_t* p, uint32_t len,
+                                 bluetooth::Uuid* p_uuid);
 extern bool sdpu_compare_uuid_arrays(const uint8_t* p_uuid1, uint32_t len1,
                                      const uint8_t* p_uuid2, uint16_t len2);
 extern bool sdpu_compare_uuid_with_attr(const bluetooth::Uuid& uuid,
                                         tSDP_DISC_ATTR* p_attr);
 
 extern void sdpu_sort_attr_list(uint16_t num_attr, tSDP_DISCOVERY_DB* p_db);
-extern uint16_t sdpu_get_list_len(tSDP_UUID_SEQ* uid_seq,
-                                  tSDP_ATTR_SEQ* attr_seq);
-extern uint16_t sdpu_get_attrib_seq_len(const tSDP_RECORD* p_rec,
-                                        const tSDP_ATTR_SEQ* attr_seq);
 extern uint16_t sdpu_get_attrib_entry_len(const tSDP_ATTRIBUTE* p_attr);
-extern uint8_t* sdpu_build_partial_attrib_entry(uint8_t* p_out,
-                                                const tSDP_ATTRIBUTE* p_attr,
-                                                uint16_t len, uint16_t* offset);
 extern uint16_t sdpu_is_avrcp_profile_description_list(
     const tSDP_ATTRIBUTE* p_attr);
 extern bool sdpu_is_service_id_avrc_target(const tSDP_ATTRIBUTE* p_attr);
@@ -245,6 +230,7 @@ extern tSDP_RECORD* sdp_db_find_record(uint32_t handle);
 extern const tSDP_ATTRIBUTE* sdp_db_find_attr_in_rec(const tSDP_RECORD* p_rec,
                                                      uint16_t start_attr,
                                                      uint16_t end_attr);
+extern uint32_t sdp_db_get_generation(void);
 
 /* Functions provided by sdp_server.cc
  */
@@ -254,5 +240,13 @@ extern void sdp_server_handle_client_req(tCONN_CB* p_ccb, BT_HDR* p_msg);
  */
 extern void sdp_disc_connected(tCONN_CB* p_ccb);
 extern void sdp_disc_server_rsp(tCONN_CB* p_ccb, BT_HDR* p_msg);
+extern bool sdp_disc_cache_answer(const RawAddress& bd_addr,
+                                  tSDP_DISCOVERY_DB* p_db,
+                                  tSDP_DISC_CMPL_CB* p_cb,
+                                  tSDP_DISC_CMPL_CB2* p_cb2,
+                                  const void* user_data);
+extern bool sdp_disc_cache_cancel(const tSDP_DISCOVERY_DB* p_db);
+extern void sdp_disc_cache_flush(const RawAddress& bd_addr);
+extern void sdp_disc_cache_clear(void);
 
 #endif
@@ -60,6 +60,8 @@ bool ECC_ValidatePoint(const Point& p);
 
 void ECC_PointMult_Bin_NAF(Point* q, Point* p, uint32_t* n);
 
-#define ECC_PointMult(q, p, n) ECC_PointMult_Bin_NAF(q, p, n)
+/* q = n * p, with the affine coordinates of q. Uses the P-256 implementation
+ * of BoringSSL, or ECC_PointMult_Bin_NAF() if |p| is not on the curve. */
+void ECC_PointMult(Point* q, Point* p, uint32_t* n);
 
 void p_256_init_curve();
@@ -70,6 +70,8 @@ void SMP_Init(void) {
   smp_l2cap_if_init();
   /* initialization of P-256 parameters */
   p_256_init_curve();
+  /* ready for the first Secure Connections pairing */
+  smp_precompute_local_key_pair();
 
   /* Initialize failure case for certification */
   smp_cb.cert_failure = static_cast<tSMP_STATUS>(
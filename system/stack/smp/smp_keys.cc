@@ -23,6 +23,7 @@
  ******************************************************************************/
 #include <base/bind.h>
 #include <base/callback.h>
+#include <openssl/rand.h>
 
 #include <algorithm>
 #include <cstring>
@@ -40,6 +41,7 @@
 #include "stack/crypto_toolbox/crypto_toolbox.h"
 #include "stack/include/acl_api.h"
 #include "stack/include/bt_octets.h"
+#include "stack/include/btu.h"
 #include "types/raw_address.h"
 
 extern tBTM_CB btm_cb;  // TODO Remove
@@ -54,6 +56,7 @@ using crypto_toolbox::aes_128;
 static void smp_process_stk(tSMP_CB* p_cb, Octet16* p);
 static Octet16 smp_calculate_legacy_short_term_key(tSMP_CB* p_cb);
 static void smp_process_private_key(tSMP_CB* p_cb);
+static void smp_process_local_key_pair(tSMP_CB* p_cb);
 
 #define SMP_PASSKEY_MASK 0xfff00000
 
@@ -67,6 +70,32 @@ void smp_save_local_oob_data(tSMP_CB* p_cb) {
 
 void smp_clear_local_oob_data() { saved_local_oob_data = {}; }
 
+// Local key pair generated ahead of the next Secure Connections pairing, so
+// that the pairing doesn't wait for the controller random numbers and the
+// point multiplication. Each key pair is used once.
+static struct {
+  bool valid;
+  BT_OCTET32 private_key;
+  tSMP_PUBLIC_KEY public_key;
+} next_local_key_pair = {};
+
+void smp_precompute_local_key_pair() {
+  if (next_local_key_pair.valid) return;
+
+  BT_OCTET32 private_key;
+  if (RAND_bytes(private_key, BT_OCTET32_LEN) != 1) {
+    LOG_WARN("Unable to generate the next local private key");
+    return;
+  }
+  memcpy(next_local_key_pair.private_key, private_key, BT_OCTET32_LEN);
+
+  Point public_key;
+  ECC_PointMult(&public_key, &(curve_p256.G), (uint32_t*)private_key);
+  memcpy(next_local_key_pair.public_key.x, public_key.x, BT_OCTET32_LEN);
+  memcpy(next_local_key_pair.public_key.y, public_key.y, BT_OCTET32_LEN);
+  next_local_key_pair.valid = true;
+}
+
 static bool is_empty(tSMP_LOC_OOB_DATA* data) {
   tSMP_LOC_OOB_DATA empty_data = {};
   return memcmp(data, &empty_data, sizeof(tSMP_LOC_OOB_DATA)) == 0;
@@ -613,6 +642,18 @@ void smp_create_private_key(tSMP_CB* p_cb, tSMP_INT_DATA* p_data) {
     LOG_WARN("OOB Association Model with no saved data present");
   }
 
+  // Prepare the key pair of the next pairing, once this event is processed
+  do_in_main_thread(FROM_HERE, base::Bind(&smp_precompute_local_key_pair));
+
+  if (next_local_key_pair.valid) {
+    LOG_DEBUG("Using the precomputed local key pair");
+    memcpy(p_cb->private_key, next_local_key_pair.private_key, BT_OCTET32_LEN);
+    p_cb->loc_publ_key = next_local_key_pair.public_key;
+    memset(&next_local_key_pair, 0, sizeof(next_local_key_pair));
+    smp_process_local_key_pair(p_cb);
+    return;
+  }
+
   btsnd_hcic_ble_rand(Bind(
       [](tSMP_CB* p_cb, BT_OCTET8 rand) {
         memcpy((void*)p_cb->private_key, rand, BT_OCTET8_LEN);
@@ -717,6 +758,11 @@ void smp_process_private_key(tSMP_CB* p_cb) {
   memcpy(p_cb->loc_publ_key.x, public_key.x, BT_OCTET32_LEN);
   memcpy(p_cb->loc_publ_key.y, public_key.y, BT_OCTET32_LEN);
 
+  smp_process_local_key_pair(p_cb);
+}
+
+/** Notifies SM that the local private key / public key pair is created */
+static void smp_process_local_key_pair(tSMP_CB* p_cb) {
   smp_debug_print_nbyte_little_endian(p_cb->private_key, "private",
                                       BT_OCTET32_LEN);
   smp_debug_print_nbyte_little_endian(p_cb->loc_publ_key.x, "local public(x)",
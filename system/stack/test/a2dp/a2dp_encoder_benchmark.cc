@@ -0,0 +1,266 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "osi/include/allocator.h"
+#include "stack/include/a2dp_codec_api.h"
+#include "stack/include/a2dp_vendor_ldac_constants.h"
+#include "stack/include/a2dp_vendor_lhdc_constants.h"
+#include "stack/include/avdt_api.h"
+#include "stack/include/bt_hdr.h"
+
+using ::benchmark::Counter;
+using ::benchmark::State;
+
+namespace {
+
+// Counts the C++ heap allocations made by this binary, for the allocations per
+// frame of the encoders.
+std::atomic<uint64_t> allocation_count{0};
+
+}  // namespace
+
+void* operator new(size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  void* ptr = std::malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+
+namespace {
+
+// One second of stereo 32 bit audio at 192 kHz, cycled through by the reads.
+constexpr size_t kPcmSize = 192000 * 2 * 4;
+
+// The encoder callbacks are plain function pointers, hence the globals.
+std::vector<uint8_t> pcm;
+size_t pcm_offset;
+uint64_t encoded_frames;
+uint64_t encoded_packets;
+
+// Synthetic PCM, white noise at full scale whatever the sample format.
+uint32_t ReadPcm(uint8_t* p_buf, uint32_t len) {
+  uint32_t read = 0;
+  while (read < len) {
+    size_t chunk = std::min<size_t>(len - read, pcm.size() - pcm_offset);
+    memcpy(p_buf + read, pcm.data() + pcm_offset, chunk);
+    read += chunk;
+    pcm_offset = (pcm_offset + chunk) % pcm.size();
+  }
+  return len;
+}
+
+bool EnqueuePacket(BT_HDR* p_buf, size_t frames_n, uint32_t /* num_bytes */) {
+  encoded_frames += frames_n;
+  encoded_packets++;
+  osi_free(p_buf);
+  return true;
+}
+
+int SampleRateHz(btav_a2dp_codec_sample_rate_t sample_rate) {
+  switch (sample_rate) {
+    case BTAV_A2DP_CODEC_SAMPLE_RATE_16000:
+      return 16000;
+    case BTAV_A2DP_CODEC_SAMPLE_RATE_24000:
+      return 24000;
+    case BTAV_A2DP_CODEC_SAMPLE_RATE_44100:
+      return 44100;
+    case BTAV_A2DP_CODEC_SAMPLE_RATE_48000:
+      return 48000;
+    case BTAV_A2DP_CODEC_SAMPLE_RATE_88200:
+      return 88200;
+    case BTAV_A2DP_CODEC_SAMPLE_RATE_96000:
+      return 96000;
+    case BTAV_A2DP_CODEC_SAMPLE_RATE_176400:
+      return 176400;
+    case BTAV_A2DP_CODEC_SAMPLE_RATE_192000:
+      return 192000;
+    default:
+      return 0;
+  }
+}
+
+int BitsPerSample(btav_a2dp_codec_bits_per_sample_t bits_per_sample) {
+  switch (bits_per_sample) {
+    case BTAV_A2DP_CODEC_BITS_PER_SAMPLE_16:
+      return 16;
+    case BTAV_A2DP_CODEC_BITS_PER_SAMPLE_24:
+      return 24;
+    case BTAV_A2DP_CODEC_BITS_PER_SAMPLE_32:
+      return 32;
+    default:
+      return 0;
+  }
+}
+
+struct QualityMode {
+  int64_t codec_specific_1;
+  std::string name;
+};
+
+// Quality modes selected by codec_specific_1, the adaptive ones excepted as
+// they follow the transmit queue.
+std::vector<QualityMode> QualityModes(btav_a2dp_codec_index_t codec_index) {
+  switch (codec_index) {
+    case BTAV_A2DP_CODEC_INDEX_SOURCE_LDAC:
+      return {{1000 + A2DP_LDAC_QUALITY_HIGH, "high"},
+              {1000 + A2DP_LDAC_QUALITY_MID, "mid"},
+              {1000 + A2DP_LDAC_QUALITY_LOW, "low"}};
+    case BTAV_A2DP_CODEC_INDEX_SOURCE_LHDCV2:
+    case BTAV_A2DP_CODEC_INDEX_SOURCE_LHDCV3:
+    case BTAV_A2DP_CODEC_INDEX_SOURCE_LHDCV5:
+      return {{A2DP_LHDC_QUALITY_MAGIC_NUM | A2DP_LHDC_QUALITY_HIGH, "high"},
+              {A2DP_LHDC_QUALITY_MAGIC_NUM | A2DP_LHDC_QUALITY_MID, "mid"},
+              {A2DP_LHDC_QUALITY_MAGIC_NUM | A2DP_LHDC_QUALITY_LOW, "low"}};
+    default:
+      return {{0, ""}};
+  }
+}
+
+// Drives the encoder of |user_config| through its tA2DP_ENCODER_INTERFACE, one
+// encoder interval of audio per iteration, with a 3 Mbps EDR peer supporting
+// the local capabilities.
+void BM_A2dpEncode(State& state, btav_a2dp_codec_config_t user_config) {
+  A2dpCodecs codecs((std::vector<btav_a2dp_codec_config_t>()));
+  AvdtpSepConfig peer_capabilities = {};
+  if (!codecs.init() ||
+      !A2DP_InitCodecConfig(user_config.codec_type, &peer_capabilities)) {
+    state.SkipWithError("Codec not available");
+    return;
+  }
+
+  tA2DP_ENCODER_INIT_PEER_PARAMS peer_params = {
+      .is_peer_edr = true,
+      .peer_supports_3mbps = true,
+      .peer_mtu = MAX_3MBPS_AVDTP_MTU,
+  };
+  uint8_t codec_config[AVDT_CODEC_SIZE];
+  bool restart_input, restart_output, config_updated;
+  if (!codecs.setCodecUserConfig(user_config, &peer_params,
+                                 peer_capabilities.codec_info, codec_config,
+                                 &restart_input, &restart_output,
+                                 &config_updated)) {
+    state.SkipWithError("Configuration not supported");
+    return;
+  }
+  A2dpCodecConfig* a2dp_codec_config = codecs.getCurrentCodecConfig();
+  const tA2DP_ENCODER_INTERFACE* encoder =
+      A2DP_GetEncoderInterface(codec_config);
+  if (a2dp_codec_config == nullptr || encoder == nullptr) {
+    state.SkipWithError("No encoder");
+    return;
+  }
+
+  encoder->encoder_init(&peer_params, a2dp_codec_config, ReadPcm,
+                        EnqueuePacket);
+  encoder->set_transmit_queue_length(0);
+  encoder->feeding_reset();
+  const uint64_t interval_us = encoder->get_encoder_interval_ms() * 1000;
+
+  uint64_t timestamp_us = 0;
+  encoded_frames = 0;
+  encoded_packets = 0;
+  const uint64_t start_allocations = allocation_count.load();
+  for (auto _ : state) {
+    timestamp_us += interval_us;
+    encoder->send_frames(timestamp_us);
+  }
+  // Each packet is one osi_malloc, freed by EnqueuePacket
+  const uint64_t allocations =
+      allocation_count.load() - start_allocations + encoded_packets;
+  encoder->encoder_cleanup();
+
+  const double audio_s = state.iterations() * interval_us / 1e6;
+  state.counters["frames_per_s"] =
+      Counter(static_cast<double>(encoded_frames), Counter::kIsRate);
+  state.counters["cpu_per_audio_s"] =
+      Counter(audio_s, Counter::kIsRate | Counter::kInvert);
+  state.counters["allocs_per_frame"] =
+      encoded_frames ? static_cast<double>(allocations) / encoded_frames : 0;
+}
+
+// One benchmark per source codec, sample rate, bit depth and quality mode of
+// the local capabilities.
+void RegisterEncodeBenchmarks() {
+  A2dpCodecs codecs((std::vector<btav_a2dp_codec_config_t>()));
+  if (!codecs.init()) return;
+
+  for (A2dpCodecConfig* codec : codecs.orderedSourceCodecs()) {
+    btav_a2dp_codec_config_t capability = codec->getCodecLocalCapability();
+    for (int rate_bit = 0; rate_bit < 8; rate_bit++) {
+      auto sample_rate =
+          static_cast<btav_a2dp_codec_sample_rate_t>(1 << rate_bit);
+      if (!(capability.sample_rate & sample_rate)) continue;
+
+      for (int bits_bit = 0; bits_bit < 3; bits_bit++) {
+        auto bits_per_sample =
+            static_cast<btav_a2dp_codec_bits_per_sample_t>(1 << bits_bit);
+        if (!(capability.bits_per_sample & bits_per_sample)) continue;
+
+        for (const QualityMode& quality : QualityModes(codec->codecIndex())) {
+          btav_a2dp_codec_config_t user_config = {
+              .codec_type = codec->codecIndex(),
+              .codec_priority = BTAV_A2DP_CODEC_PRIORITY_HIGHEST,
+              .sample_rate = sample_rate,
+              .bits_per_sample = bits_per_sample,
+              .channel_mode = BTAV_A2DP_CODEC_CHANNEL_MODE_STEREO,
+              .codec_specific_1 = quality.codec_specific_1,
+          };
+          std::string name = "BM_A2dpEncode/" + codec->name() + "/" +
+                             std::to_string(SampleRateHz(sample_rate)) + "/" +
+                             std::to_string(BitsPerSample(bits_per_sample));
+          if (!quality.name.empty()) name += "/" + quality.name;
+          ::benchmark::RegisterBenchmark(name.c_str(), BM_A2dpEncode,
+                                         user_config);
+        }
+      }
+    }
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+
+  pcm.resize(kPcmSize);
+  std::mt19937 gen(1);
+  std::uniform_int_distribution<int> dist(0, UINT8_MAX);
+  for (auto& byte : pcm) byte = dist(gen);
+
+  RegisterEncodeBenchmarks();
+  ::benchmark::RunSpecifiedBenchmarks();
+}
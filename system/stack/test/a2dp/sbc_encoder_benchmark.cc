@@ -0,0 +1,115 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "embdrv/sbc/encoder/include/sbc_analysis_simd.h"
+#include "embdrv/sbc/encoder/include/sbc_encoder.h"
+
+using ::benchmark::State;
+
+namespace {
+
+constexpr int kNumPcmFrames = 32;
+constexpr size_t kMaxFrameSize = 1024;
+
+// 16 block frames at 44.1 kHz with the high quality bitpools, state.range(0)
+// is the number of subbands and state.range(1) the number of channels.
+class SbcEncoderBenchmark : public ::benchmark::Fixture {
+ public:
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    num_of_channels_ = st.range(1);
+    memset(&params_, 0, sizeof(params_));
+    params_.s16SamplingFreq = SBC_sf44100;
+    params_.s16ChannelMode =
+        (num_of_channels_ == 1) ? SBC_MONO : SBC_JOINT_STEREO;
+    params_.s16NumOfSubBands = st.range(0);
+    params_.s16NumOfChannels = num_of_channels_;
+    params_.s16NumOfBlocks = 16;
+    params_.s16AllocationMethod = SBC_LOUDNESS;
+    params_.u16BitRate = (num_of_channels_ == 1) ? 229 : 328;
+
+    samples_per_frame_ = params_.s16NumOfSubBands * params_.s16NumOfBlocks *
+                         params_.s16NumOfChannels;
+    pcm_.resize(kNumPcmFrames * samples_per_frame_);
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<int> dist(INT16_MIN, INT16_MAX);
+    for (auto& sample : pcm_) sample = dist(gen);
+  }
+
+  void TearDown(State& st) override {
+    SbcAnalysisEnableSimd(true);
+    ::benchmark::Fixture::TearDown(st);
+  }
+
+  void Run(State& state, bool simd) {
+    SbcAnalysisEnableSimd(simd);
+    SBC_Encoder_Init(&params_);
+    uint8_t output[kMaxFrameSize];
+    int frame = 0;
+    for (auto _ : state) {
+      ::benchmark::DoNotOptimize(SBC_Encode(
+          &params_, pcm_.data() + frame * samples_per_frame_, output));
+      frame = (frame + 1) % kNumPcmFrames;
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * samples_per_frame_ *
+                            sizeof(int16_t));
+  }
+
+  SBC_ENC_PARAMS params_;
+  int num_of_channels_;
+  size_t samples_per_frame_;
+  std::vector<int16_t> pcm_;
+};
+
+BENCHMARK_DEFINE_F(SbcEncoderBenchmark, encode_scalar)(State& state) {
+  Run(state, false);
+}
+BENCHMARK_REGISTER_F(SbcEncoderBenchmark, encode_scalar)
+    ->Args({4, 1})
+    ->Args({4, 2})
+    ->Args({8, 1})
+    ->Args({8, 2});
+
+BENCHMARK_DEFINE_F(SbcEncoderBenchmark, encode_simd)(State& state) {
+  if (SbcAnalysisSimdKernels() == nullptr) {
+    state.SkipWithError("No SIMD analysis kernels on this CPU");
+    return;
+  }
+  Run(state, true);
+}
+BENCHMARK_REGISTER_F(SbcEncoderBenchmark, encode_simd)
+    ->Args({4, 1})
+    ->Args({4, 2})
+    ->Args({8, 1})
+    ->Args({8, 2});
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  ::benchmark::RunSpecifiedBenchmarks();
+}
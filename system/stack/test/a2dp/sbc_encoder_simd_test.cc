@@ -0,0 +1,113 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "embdrv/sbc/encoder/include/sbc_analysis_simd.h"
+#include "embdrv/sbc/encoder/include/sbc_encoder.h"
+
+namespace {
+
+constexpr int kNumFrames = 64;
+constexpr size_t kMaxFrameSize = 1024;
+
+struct SbcConfig {
+  int16_t num_of_subbands;
+  int16_t channel_mode;
+  int16_t num_of_blocks;
+};
+
+void InitParams(const SbcConfig& config, SBC_ENC_PARAMS* params) {
+  memset(params, 0, sizeof(*params));
+  params->s16SamplingFreq = SBC_sf44100;
+  params->s16ChannelMode = config.channel_mode;
+  params->s16NumOfSubBands = config.num_of_subbands;
+  params->s16NumOfChannels = (config.channel_mode == SBC_MONO) ? 1 : 2;
+  params->s16NumOfBlocks = config.num_of_blocks;
+  params->s16AllocationMethod = SBC_LOUDNESS;
+  params->u16BitRate = 328;
+}
+
+// Encodes |pcm| frame by frame, collecting both the subband samples and the
+// encoded bitstream.
+void Encode(const SbcConfig& config, bool simd,
+            const std::vector<int16_t>& pcm,
+            std::vector<int32_t>* subbands, std::vector<uint8_t>* output) {
+  SBC_ENC_PARAMS params;
+  InitParams(config, &params);
+  SbcAnalysisEnableSimd(simd);
+  SBC_Encoder_Init(&params);
+
+  size_t samples_per_frame = params.s16NumOfSubBands * params.s16NumOfBlocks *
+                             params.s16NumOfChannels;
+  uint8_t frame[kMaxFrameSize];
+  for (int i = 0; i < kNumFrames; i++) {
+    int16_t* input = const_cast<int16_t*>(pcm.data()) + i * samples_per_frame;
+    uint32_t len = SBC_Encode(&params, input, frame);
+    output->insert(output->end(), frame, frame + len);
+    subbands->insert(subbands->end(), params.s32SbBuffer,
+                     params.s32SbBuffer + samples_per_frame);
+  }
+}
+
+class SbcEncoderSimdTest : public ::testing::TestWithParam<SbcConfig> {
+ protected:
+  void TearDown() override { SbcAnalysisEnableSimd(true); }
+};
+
+TEST_P(SbcEncoderSimdTest, bit_exact_with_scalar_path) {
+  if (SbcAnalysisSimdKernels() == nullptr) {
+    GTEST_SKIP() << "No SIMD analysis kernels on this CPU";
+  }
+  const SbcConfig& config = GetParam();
+
+  // Random samples mixed with full scale runs to hit the window and DCT
+  // extremes.
+  std::mt19937 gen(config.num_of_subbands * 100 + config.num_of_blocks);
+  std::uniform_int_distribution<int> dist(INT16_MIN, INT16_MAX);
+  std::vector<int16_t> pcm(kNumFrames * SBC_MAX_NUM_OF_SUBBANDS *
+                           SBC_MAX_NUM_OF_BLOCKS * SBC_MAX_NUM_OF_CHANNELS);
+  for (size_t i = 0; i < pcm.size(); i++) {
+    if ((i / 512) % 2 == 0) {
+      pcm[i] = dist(gen);
+    } else {
+      pcm[i] = ((i / 7) % 2) ? INT16_MAX : INT16_MIN;
+    }
+  }
+
+  std::vector<int32_t> scalar_subbands, simd_subbands;
+  std::vector<uint8_t> scalar_output, simd_output;
+  Encode(config, false, pcm, &scalar_subbands, &scalar_output);
+  Encode(config, true, pcm, &simd_subbands, &simd_output);
+
+  ASSERT_EQ(scalar_subbands, simd_subbands)
+      << "kernels " << SbcAnalysisSimdKernels()->name;
+  ASSERT_EQ(scalar_output, simd_output);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    SbcConfigs, SbcEncoderSimdTest,
+    ::testing::Values(SbcConfig{4, SBC_MONO, 16}, SbcConfig{4, SBC_DUAL, 12},
+                      SbcConfig{4, SBC_JOINT_STEREO, 16},
+                      SbcConfig{8, SBC_MONO, 4}, SbcConfig{8, SBC_STEREO, 8},
+                      SbcConfig{8, SBC_JOINT_STEREO, 16}));
+
+}  // namespace
@@ -0,0 +1,213 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <base/logging.h>
+#include <benchmark/benchmark.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "btif/include/btif_hh.h"
+#include "hci/include/hci_layer.h"
+#include "hci/include/hci_packet_factory.h"
+#include "internal_include/stack_config.h"
+#include "stack/btm/btm_dev.h"
+#include "stack/btm/btm_int_types.h"
+#include "stack/btm/security_device_record.h"
+#include "stack/include/hcidefs.h"
+#include "stack/l2cap/l2c_int.h"
+#include "types/raw_address.h"
+
+using ::benchmark::State;
+
+extern tBTM_CB btm_cb;
+
+uint8_t appl_trace_level = BT_TRACE_LEVEL_NONE;
+btif_hh_cb_t btif_hh_cb;
+tL2C_CB l2cb;
+
+const hci_t* hci_layer_get_interface() { return nullptr; }
+
+void LogMsg(uint32_t trace_set_mask, const char* fmt_str, ...) {}
+
+const std::string kSmpOptions("mock smp options");
+const std::string kBroadcastAudioConfigOptions(
+    "mock broadcast audio config options");
+
+bool get_trace_config_enabled(void) { return false; }
+bool get_pts_avrcp_test(void) { return false; }
+bool get_pts_secure_only_mode(void) { return false; }
+bool get_pts_conn_updates_disabled(void) { return false; }
+bool get_pts_crosskey_sdp_disable(void) { return false; }
+const std::string* get_pts_smp_options(void) { return &kSmpOptions; }
+int get_pts_smp_failure_case(void) { return 123; }
+bool get_pts_force_eatt_for_notifications(void) { return false; }
+bool get_pts_connect_eatt_unconditionally(void) { return false; }
+bool get_pts_connect_eatt_before_encryption(void) { return false; }
+bool get_pts_unencrypt_broadcast(void) { return false; }
+bool get_pts_eatt_peripheral_collision_support(void) { return false; }
+bool get_pts_use_eatt_for_all_services(void) { return false; }
+bool get_pts_force_le_audio_multiple_contexts_metadata(void) { return false; }
+bool get_pts_l2cap_ecoc_upper_tester(void) { return false; }
+int get_pts_l2cap_ecoc_min_key_size(void) { return -1; }
+int get_pts_l2cap_ecoc_initial_chan_cnt(void) { return -1; }
+bool get_pts_l2cap_ecoc_connect_remaining(void) { return false; }
+int get_pts_l2cap_ecoc_send_num_of_sdu(void) { return -1; }
+bool get_pts_l2cap_ecoc_reconfigure(void) { return false; }
+const std::string* get_pts_broadcast_audio_config_options(void) {
+  return &kBroadcastAudioConfigOptions;
+}
+config_t* get_all(void) { return nullptr; }
+const packet_fragmenter_t* packet_fragmenter_get_interface() { return nullptr; }
+
+stack_config_t mock_stack_config{
+    .get_trace_config_enabled = get_trace_config_enabled,
+    .get_pts_avrcp_test = get_pts_avrcp_test,
+    .get_pts_secure_only_mode = get_pts_secure_only_mode,
+    .get_pts_conn_updates_disabled = get_pts_conn_updates_disabled,
+    .get_pts_crosskey_sdp_disable = get_pts_crosskey_sdp_disable,
+    .get_pts_smp_options = get_pts_smp_options,
+    .get_pts_smp_failure_case = get_pts_smp_failure_case,
+    .get_pts_force_eatt_for_notifications =
+        get_pts_force_eatt_for_notifications,
+    .get_pts_connect_eatt_unconditionally =
+        get_pts_connect_eatt_unconditionally,
+    .get_pts_connect_eatt_before_encryption =
+        get_pts_connect_eatt_before_encryption,
+    .get_pts_unencrypt_broadcast = get_pts_unencrypt_broadcast,
+    .get_pts_eatt_peripheral_collision_support =
+        get_pts_eatt_peripheral_collision_support,
+    .get_pts_l2cap_ecoc_upper_tester = get_pts_l2cap_ecoc_upper_tester,
+    .get_pts_l2cap_ecoc_min_key_size = get_pts_l2cap_ecoc_min_key_size,
+    .get_pts_force_le_audio_multiple_contexts_metadata =
+        get_pts_force_le_audio_multiple_contexts_metadata,
+    .get_pts_l2cap_ecoc_initial_chan_cnt = get_pts_l2cap_ecoc_initial_chan_cnt,
+    .get_pts_l2cap_ecoc_connect_remaining =
+        get_pts_l2cap_ecoc_connect_remaining,
+    .get_pts_l2cap_ecoc_send_num_of_sdu = get_pts_l2cap_ecoc_send_num_of_sdu,
+    .get_pts_l2cap_ecoc_reconfigure = get_pts_l2cap_ecoc_reconfigure,
+    .get_pts_broadcast_audio_config_options =
+        get_pts_broadcast_audio_config_options,
+    .get_all = get_all,
+};
+const stack_config_t* stack_config_get_interface(void) {
+  return &mock_stack_config;
+}
+
+std::map<std::string, int> mock_function_count_map;
+
+// Predicates btm_find_dev() and btm_find_dev_by_handle() scan the list with.
+bool is_address_equal(void* data, void* context);
+bool is_handle_equal(void* data, void* context);
+
+namespace {
+
+constexpr size_t kNumRecords = BTM_SEC_MAX_DEVICE_RECORDS;
+
+RawAddress MakeAddress(size_t i) {
+  return RawAddress({0x00, 0x11, 0x22, 0x33, (uint8_t)(i >> 8), (uint8_t)i});
+}
+
+uint16_t MakeHandle(size_t i) { return 0x0100 + i; }
+
+class BtmDevBenchmark : public ::benchmark::Fixture {
+ public:
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    btm_cb.Init(BTM_SEC_MODE_SC);
+    for (size_t i = 0; i < kNumRecords; i++) {
+      tBTM_SEC_DEV_REC* p_dev_rec = btm_sec_allocate_dev_rec();
+      p_dev_rec->bd_addr = MakeAddress(i);
+      p_dev_rec->hci_handle = HCI_INVALID_HANDLE;
+      p_dev_rec->ble_hci_handle = MakeHandle(i);
+    }
+  }
+
+  void TearDown(State& st) override {
+    btm_cb.Free();
+    ::benchmark::Fixture::TearDown(st);
+  }
+};
+
+// Lookups of every record by address as done before the index, for comparison.
+BENCHMARK_DEFINE_F(BtmDevBenchmark, find_dev_linear)(State& state) {
+  for (auto _ : state) {
+    for (size_t i = 0; i < kNumRecords; i++) {
+      RawAddress bd_addr = MakeAddress(i);
+      ::benchmark::DoNotOptimize(
+          list_foreach(btm_cb.sec_dev_rec, is_address_equal, &bd_addr));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumRecords);
+}
+BENCHMARK_REGISTER_F(BtmDevBenchmark, find_dev_linear);
+
+BENCHMARK_DEFINE_F(BtmDevBenchmark, find_dev)(State& state) {
+  for (auto _ : state) {
+    for (size_t i = 0; i < kNumRecords; i++) {
+      ::benchmark::DoNotOptimize(btm_find_dev(MakeAddress(i)));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumRecords);
+}
+BENCHMARK_REGISTER_F(BtmDevBenchmark, find_dev);
+
+BENCHMARK_DEFINE_F(BtmDevBenchmark, find_dev_by_handle_linear)(State& state) {
+  for (auto _ : state) {
+    for (size_t i = 0; i < kNumRecords; i++) {
+      uint16_t handle = MakeHandle(i);
+      ::benchmark::DoNotOptimize(
+          list_foreach(btm_cb.sec_dev_rec, is_handle_equal, &handle));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumRecords);
+}
+BENCHMARK_REGISTER_F(BtmDevBenchmark, find_dev_by_handle_linear);
+
+BENCHMARK_DEFINE_F(BtmDevBenchmark, find_dev_by_handle)(State& state) {
+  for (auto _ : state) {
+    for (size_t i = 0; i < kNumRecords; i++) {
+      ::benchmark::DoNotOptimize(btm_find_dev_by_handle(MakeHandle(i)));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumRecords);
+}
+BENCHMARK_REGISTER_F(BtmDevBenchmark, find_dev_by_handle);
+
+// Unknown devices are not indexed and still scan the whole list.
+BENCHMARK_DEFINE_F(BtmDevBenchmark, find_dev_unknown)(State& state) {
+  RawAddress bd_addr = MakeAddress(kNumRecords);
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(btm_find_dev(bd_addr));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_REGISTER_F(BtmDevBenchmark, find_dev_unknown);
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  // Disable LOG() output from libchrome
+  logging::LoggingSettings log_settings;
+  log_settings.logging_dest = logging::LoggingDestination::LOG_NONE;
+  CHECK(logging::InitLogging(log_settings)) << "Failed to set up logging";
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  ::benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "stack/btm/btm_log_history_buffer.h"
+
+namespace {
+
+const RawAddress kAddress({0x11, 0x22, 0x33, 0x44, 0x55, 0x66});
+
+std::vector<BtmLogHistoryBuffer::Entry> PullAll(
+    const BtmLogHistoryBuffer& buffer) {
+  uint64_t next = 0;
+  return buffer.Pull(&next, SIZE_MAX);
+}
+
+TEST(BtmLogHistoryBufferTest, formats_when_pulled) {
+  BtmLogHistoryBuffer buffer(4);
+  buffer.Push("Initialized btm history");
+  buffer.Push("SCO", kAddress, "Connection created", "handle:0x0001");
+  buffer.Push("ACL", tBLE_BD_ADDR{.type = BLE_ADDR_RANDOM, .bda = kAddress},
+              "Le connection", "");
+
+  auto entries = PullAll(buffer);
+  ASSERT_EQ(entries.size(), 3u);
+  ASSERT_EQ(entries[0].ToString(), "Initialized btm history");
+  ASSERT_EQ(entries[1].ToString(),
+            "SCO    Connection created       : xx:xx:xx:xx:55:66 "
+            "handle:0x0001");
+  ASSERT_EQ(entries[2].ToString(),
+            "ACL    Le connection            : xx:xx:xx:xx:55:66[random] ");
+  ASSERT_NE(entries[1].timestamp, 0);
+}
+
+TEST(BtmLogHistoryBufferTest, fields_are_truncated) {
+  BtmLogHistoryBuffer buffer(1);
+  const std::string extra(2 * BtmLogHistoryBuffer::kMaxExtraLength, 'e');
+  buffer.Push("SECURITY", kAddress, std::string(40, 'm'), extra);
+
+  auto entries = PullAll(buffer);
+  ASSERT_EQ(entries.size(), 1u);
+  ASSERT_EQ(entries[0].Tag(), "SECURI");
+  ASSERT_EQ(entries[0].Msg(),
+            std::string(BtmLogHistoryBuffer::kMaxMsgLength, 'm'));
+  ASSERT_EQ(entries[0].Extra(),
+            std::string(BtmLogHistoryBuffer::kMaxExtraLength, 'e'));
+}
+
+TEST(BtmLogHistoryBufferTest, keeps_the_latest_entries) {
+  BtmLogHistoryBuffer buffer(3);
+  for (int i = 0; i < 5; i++) {
+    buffer.Push(std::to_string(i));
+  }
+
+  uint64_t next = 0;
+  auto entries = buffer.Pull(&next, 2);
+  ASSERT_EQ(entries.size(), 2u);
+  ASSERT_EQ(entries[0].ToString(), "2");
+  ASSERT_EQ(entries[1].ToString(), "3");
+  ASSERT_EQ(next, 4u);
+
+  buffer.Push("5");
+  entries = buffer.Pull(&next, 2);
+  ASSERT_EQ(entries.size(), 2u);
+  ASSERT_EQ(entries[0].ToString(), "4");
+  ASSERT_EQ(entries[1].ToString(), "5");
+  ASSERT_TRUE(buffer.Pull(&next, 2).empty());
+}
+
+TEST(BtmLogHistoryBufferTest, concurrent_pushes) {
+  constexpr int kThreads = 4;
+  constexpr int kPushes = 1000;
+  BtmLogHistoryBuffer buffer(kThreads * kPushes);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; t++) {
+    threads.emplace_back([&buffer, t]() {
+      for (int i = 0; i < kPushes; i++) {
+        buffer.Push("T" + std::to_string(t), kAddress, std::to_string(i), "");
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  auto entries = PullAll(buffer);
+  ASSERT_EQ(entries.size(), static_cast<size_t>(kThreads * kPushes));
+  ASSERT_EQ(buffer.GetDroppedCount(), 0u);
+  std::vector<int> next_push(kThreads, 0);
+  for (const auto& entry : entries) {
+    int t = std::stoi(std::string(entry.Tag().substr(1)));
+    // The pushes of each thread keep their order
+    ASSERT_EQ(std::stoi(std::string(entry.Msg())), next_push[t]++);
+  }
+}
+
+}  // namespace
@@ -0,0 +1,129 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "embdrv/lc3/include/lc3.h"
+#include "stack/btm/btm_sco_codec.h"
+
+using ::benchmark::Counter;
+using ::benchmark::State;
+using bluetooth::audio::sco::HostCodec;
+using bluetooth::audio::sco::HostCodecPath;
+using bluetooth::audio::sco::kCodecFrameUs;
+using bluetooth::audio::sco::kH2FrameSize;
+using bluetooth::audio::sco::kScoPacketStatusCorrect;
+using bluetooth::audio::sco::kScoPacketStatusPartiallyLost;
+
+namespace {
+
+constexpr size_t kNumPcmFrames = 64;
+// Delay of the analysis and synthesis filters of SBC with 8 subbands
+constexpr int kMsbcDelaySamples = 73;
+
+// Controller loopback of the SCO data, the packets the host sends coming
+// back as the received ones. An iteration is one packet of state.range(0)
+// bytes going around, as the codec thread handles it; one in state.range(1)
+// packets comes back damaged, none if 0.
+class ScoCodecBenchmark : public ::benchmark::Fixture {
+ public:
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    packet_size_ = st.range(0);
+    loss_period_ = st.range(1);
+  }
+
+  void Run(State& state, HostCodec codec, int sample_rate, int delay_samples) {
+    HostCodecPath path;
+    if (!path.Init(codec)) {
+      state.SkipWithError("Codec not available");
+      return;
+    }
+    const size_t frame_samples = path.FrameSamples();
+    std::vector<int16_t> pcm(kNumPcmFrames * frame_samples);
+    for (size_t i = 0; i < pcm.size(); i++) {
+      pcm[i] = 8000 * sin(2 * M_PI * 440 * i / sample_rate);
+    }
+
+    uint8_t packet[kH2FrameSize];
+    size_t frame = 0;
+    uint64_t packets = 0;
+    uint64_t buffered_bytes = 0;
+    for (auto _ : state) {
+      while (path.TxPending() < packet_size_) {
+        path.EncodeFrame(pcm.data() + frame * frame_samples);
+        frame = (frame + 1) % kNumPcmFrames;
+      }
+      path.NextPacket(packet, packet_size_);
+      packets++;
+      bool damaged = loss_period_ != 0 && packets % loss_period_ == 0;
+      path.ReceivePacket(packet, packet_size_,
+                         damaged ? kScoPacketStatusPartiallyLost
+                                 : kScoPacketStatusCorrect);
+      while (const int16_t* p_pcm = path.DecodeFrame()) {
+        ::benchmark::DoNotOptimize(p_pcm);
+      }
+      buffered_bytes += path.TxPending() + path.RxPending();
+    }
+
+    const auto& stats = path.GetStats();
+    const double frame_ms = kCodecFrameUs / 1000.0;
+    const double ms_per_byte = frame_ms / kH2FrameSize;
+    // A frame of PCM is captured before it is encoded, then it waits in the
+    // rings and goes over the air a packet at a time
+    double latency_ms = frame_ms +
+                        ms_per_byte * buffered_bytes / state.iterations() +
+                        ms_per_byte * packet_size_ +
+                        1000.0 * delay_samples / sample_rate;
+    state.counters["latency_ms"] = latency_ms;
+    state.counters["concealed"] =
+        Counter(stats.frames_concealed, Counter::kAvgIterations);
+    // Seconds of speech coded each second, the real time margin
+    state.counters["realtime"] =
+        Counter(stats.frames_encoded * frame_ms / 1000.0, Counter::kIsRate);
+    state.SetItemsProcessed(stats.frames_decoded + stats.frames_concealed);
+  }
+
+  size_t packet_size_;
+  uint64_t loss_period_;
+};
+
+BENCHMARK_DEFINE_F(ScoCodecBenchmark, msbc_loopback)(State& state) {
+  Run(state, HostCodec::MSBC, 16000, kMsbcDelaySamples);
+}
+BENCHMARK_REGISTER_F(ScoCodecBenchmark, msbc_loopback)
+    ->Args({24, 0})
+    ->Args({30, 0})
+    ->Args({60, 0})
+    ->Args({60, 20});
+
+BENCHMARK_DEFINE_F(ScoCodecBenchmark, lc3_swb_loopback)(State& state) {
+  Run(state, HostCodec::LC3_SWB, 32000,
+      lc3_delay_samples(kCodecFrameUs, 32000));
+}
+BENCHMARK_REGISTER_F(ScoCodecBenchmark, lc3_swb_loopback)
+    ->Args({24, 0})
+    ->Args({30, 0})
+    ->Args({60, 0})
+    ->Args({60, 20});
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,150 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+#include "stack/btm/btm_sco_codec.h"
+
+namespace {
+
+using bluetooth::audio::sco::HostCodec;
+using bluetooth::audio::sco::HostCodecPath;
+using bluetooth::audio::sco::kH2FrameSize;
+using bluetooth::audio::sco::kScoPacketStatusCorrect;
+using bluetooth::audio::sco::kScoPacketStatusPossiblyInvalid;
+using bluetooth::audio::sco::PacketLossConcealment;
+using bluetooth::audio::sco::ScoRing;
+using testing::Test;
+
+constexpr size_t kPacketSize = 24;
+
+class ScoCodecTest : public Test {
+ protected:
+  void SetUp() override { ASSERT_TRUE(path_.Init(HostCodec::MSBC)); }
+
+  // Encode num_frames frames of a tone, then send them back a packet at a
+  // time, returning the packets
+  std::vector<std::vector<uint8_t>> EncodeTone(size_t num_frames) {
+    std::vector<int16_t> pcm(path_.FrameSamples());
+    for (size_t frame = 0; frame < num_frames; frame++) {
+      for (size_t i = 0; i < pcm.size(); i++, sample_++) {
+        pcm[i] = 8000 * sin(2 * M_PI * 400 * sample_ / 16000);
+      }
+      path_.EncodeFrame(pcm.data());
+    }
+    std::vector<std::vector<uint8_t>> packets;
+    while (path_.TxPending() != 0) {
+      std::vector<uint8_t> packet(kPacketSize);
+      packet.resize(path_.NextPacket(packet.data(), packet.size()));
+      packets.push_back(packet);
+    }
+    return packets;
+  }
+
+  size_t DecodeAll() {
+    size_t frames = 0;
+    while (path_.DecodeFrame() != nullptr) frames++;
+    return frames;
+  }
+
+  HostCodecPath path_;
+  size_t sample_ = 0;
+};
+
+TEST(ScoRingTest, push_pop_wrap_around) {
+  ScoRing<8> ring;
+  const uint8_t data[] = {1, 2, 3, 4, 5, 6};
+  uint8_t out[8];
+
+  ASSERT_EQ(ring.Push(data, 6), 6u);
+  ASSERT_EQ(ring.Pop(out, 4), 4u);
+  ASSERT_EQ(ring.Push(data, 6), 6u);
+  ASSERT_EQ(ring.Room(), 0u);
+  ASSERT_EQ(ring.Push(data, 1), 0u);
+  ASSERT_EQ(ring.At(2), 1);
+
+  ASSERT_EQ(ring.Pop(out, 8), 8u);
+  const uint8_t expected[] = {5, 6, 1, 2, 3, 4, 5, 6};
+  ASSERT_EQ(memcmp(out, expected, sizeof(expected)), 0);
+  ASSERT_EQ(ring.Size(), 0u);
+}
+
+TEST_F(ScoCodecTest, frames_cut_into_packets) {
+  auto packets = EncodeTone(4);
+  ASSERT_EQ(packets.size(), 4 * kH2FrameSize / kPacketSize);
+
+  for (const auto& packet : packets) {
+    path_.ReceivePacket(packet.data(), packet.size(), kScoPacketStatusCorrect);
+  }
+  ASSERT_EQ(DecodeAll(), 4u);
+  ASSERT_EQ(path_.GetStats().frames_decoded, 4u);
+  ASSERT_EQ(path_.GetStats().frames_concealed, 0u);
+}
+
+TEST_F(ScoCodecTest, damaged_packet_concealed) {
+  auto packets = EncodeTone(4);
+  for (size_t i = 0; i < packets.size(); i++) {
+    path_.ReceivePacket(packets[i].data(), packets[i].size(),
+                        i == 3 ? kScoPacketStatusPossiblyInvalid
+                               : kScoPacketStatusCorrect);
+  }
+  // The packet spans the end of the first frame and the start of the second
+  ASSERT_EQ(DecodeAll(), 4u);
+  ASSERT_EQ(path_.GetStats().frames_decoded, 2u);
+  ASSERT_EQ(path_.GetStats().frames_concealed, 2u);
+}
+
+TEST_F(ScoCodecTest, resync_after_lost_data) {
+  auto packets = EncodeTone(4);
+  packets[0].erase(packets[0].begin(), packets[0].begin() + 10);
+  for (const auto& packet : packets) {
+    path_.ReceivePacket(packet.data(), packet.size(), kScoPacketStatusCorrect);
+  }
+  // The first frame is skipped looking for the header of the second one
+  ASSERT_EQ(DecodeAll(), 3u);
+  ASSERT_EQ(path_.GetStats().frames_decoded, 3u);
+  ASSERT_EQ(path_.GetStats().sync_lost_bytes, kH2FrameSize - 10);
+}
+
+TEST(PacketLossConcealmentTest, repeats_pitch_then_mutes) {
+  constexpr size_t kFrameSamples = 120;
+  PacketLossConcealment plc;
+  plc.Reset(kFrameSamples);
+
+  // 200 Hz at 16 kHz, a pitch period of 80 samples
+  int16_t pcm[kFrameSamples];
+  size_t sample = 0;
+  for (int frame = 0; frame < 4; frame++) {
+    for (size_t i = 0; i < kFrameSamples; i++, sample++) {
+      pcm[i] = 8000 * sin(2 * M_PI * 200 * sample / 16000);
+    }
+    plc.Good(pcm);
+  }
+
+  plc.Conceal(pcm);
+  for (size_t i = 0; i < 10; i++, sample++) {
+    int16_t expected = 8000 * sin(2 * M_PI * 200 * sample / 16000);
+    ASSERT_NEAR(pcm[i], expected, 400);
+  }
+
+  for (int frame = 0; frame < 5; frame++) plc.Conceal(pcm);
+  for (size_t i = 0; i < kFrameSamples; i++) ASSERT_EQ(pcm[i], 0);
+}
+
+}  // namespace
@@ -373,6 +373,107 @@ TEST_F(StackBtmWithInitFreeTest, btm_sec_encrypt_change) {
   wipe_secrets_and_remove(device_record);
 }
 
+TEST_F(StackBtmWithInitFreeTest, btm_find_dev_index) {
+  const RawAddress bd_addr = RawAddress({0x11, 0x22, 0x33, 0x44, 0x55, 0x66});
+  const RawAddress pseudo_addr =
+      RawAddress({0x66, 0x55, 0x44, 0x33, 0x22, 0x11});
+  const RawAddress other_addr = RawAddress({0x01, 0x02, 0x03, 0x04, 0x05, 0x06});
+
+  tBTM_SEC_DEV_REC* first = btm_sec_allocate_dev_rec();
+  first->bd_addr = other_addr;
+  tBTM_SEC_DEV_REC* device_record = btm_sec_allocate_dev_rec();
+  device_record->bd_addr = bd_addr;
+  device_record->ble.pseudo_addr = pseudo_addr;
+
+  ASSERT_EQ(device_record, btm_find_dev(bd_addr));
+  ASSERT_EQ(device_record, btm_find_dev(pseudo_addr));
+  ASSERT_EQ(1u, btm_cb.sec_dev_rec_by_addr.count(bd_addr));
+  ASSERT_EQ(device_record, btm_find_dev(bd_addr));
+
+  // Fields are updated in place, a stale index entry must not be returned.
+  device_record->ble.pseudo_addr = RawAddress::kEmpty;
+  first->ble.pseudo_addr = pseudo_addr;
+  ASSERT_EQ(first, btm_find_dev(pseudo_addr));
+
+  wipe_secrets_and_remove(device_record);
+  ASSERT_EQ(0u, btm_cb.sec_dev_rec_by_addr.count(bd_addr));
+  ASSERT_EQ(nullptr, btm_find_dev(bd_addr));
+
+  wipe_secrets_and_remove(first);
+  ASSERT_TRUE(btm_cb.sec_dev_rec_by_addr.empty());
+}
+
+TEST_F(StackBtmWithInitFreeTest, btm_find_dev_by_handle_index) {
+  tBTM_SEC_DEV_REC* classic = btm_sec_allocate_dev_rec();
+  classic->hci_handle = 0x0001;
+  classic->ble_hci_handle = HCI_INVALID_HANDLE;
+  tBTM_SEC_DEV_REC* le = btm_sec_allocate_dev_rec();
+  le->hci_handle = HCI_INVALID_HANDLE;
+  le->ble_hci_handle = 0x0002;
+
+  ASSERT_EQ(classic, btm_find_dev_by_handle(0x0001));
+  ASSERT_EQ(le, btm_find_dev_by_handle(0x0002));
+  ASSERT_EQ(le, btm_find_dev_by_handle(0x0002));
+  ASSERT_EQ(nullptr, btm_find_dev_by_handle(0x0003));
+
+  // The handle is reused by another device after a disconnection.
+  classic->hci_handle = HCI_INVALID_HANDLE;
+  le->hci_handle = 0x0001;
+  ASSERT_EQ(le, btm_find_dev_by_handle(0x0001));
+
+  // Invalid handles are never indexed.
+  btm_find_dev_by_handle(HCI_INVALID_HANDLE);
+  ASSERT_EQ(0u, btm_cb.sec_dev_rec_by_handle.count(HCI_INVALID_HANDLE));
+
+  wipe_secrets_and_remove(le);
+  ASSERT_EQ(nullptr, btm_find_dev_by_handle(0x0001));
+  wipe_secrets_and_remove(classic);
+  ASSERT_TRUE(btm_cb.sec_dev_rec_by_handle.empty());
+}
+
+TEST_F(StackBtmWithInitFreeTest, btm_inq_db) {
+  const size_t max_entries = BTM_INQ_DB_MAX_MEMORY / sizeof(tINQ_DB_ENT);
+  std::vector<RawAddress> addrs;
+  for (size_t i = 0; i <= max_entries; i++) {
+    addrs.push_back(RawAddress({0x11, 0x22, 0x33, 0x44, (uint8_t)(i >> 8),
+                                (uint8_t)i}));
+  }
+
+  for (size_t i = 0; i < max_entries; i++) {
+    tINQ_DB_ENT* p_ent = btm_inq_db_new(addrs[i]);
+    p_ent->time_of_resp = 1000 + i;
+  }
+  ASSERT_EQ(max_entries, btm_cb.inq_db.size());
+  tINQ_DB_ENT* first = btm_inq_db_find(addrs[0]);
+  ASSERT_NE(nullptr, first);
+  ASSERT_EQ(&first->inq_info, BTM_InqDbRead(addrs[0]));
+
+  // Once full, the oldest entry is replaced.
+  first->time_of_resp = 2000;
+  tINQ_DB_ENT* p_ent = btm_inq_db_new(addrs[max_entries]);
+  ASSERT_EQ(max_entries, btm_cb.inq_db.size());
+  ASSERT_EQ(p_ent, btm_inq_db_find(addrs[max_entries]));
+  ASSERT_EQ(nullptr, btm_inq_db_find(addrs[1]));
+  ASSERT_EQ(first, btm_inq_db_find(addrs[0]));
+
+  // Removed entries are reused before the oldest one.
+  btm_inq_db_remove(first);
+  ASSERT_EQ(nullptr, btm_inq_db_find(addrs[0]));
+  ASSERT_EQ(first, btm_inq_db_new(addrs[1]));
+  ASSERT_EQ(max_entries, btm_cb.inq_db.size());
+
+  size_t count = 0;
+  for (tBTM_INQ_INFO* p_info = BTM_InqDbFirst(); p_info != nullptr;
+       p_info = BTM_InqDbNext(p_info)) {
+    count++;
+  }
+  ASSERT_EQ(max_entries, count);
+
+  ASSERT_EQ(BTM_SUCCESS, BTM_ClearInqDb(nullptr));
+  ASSERT_EQ(nullptr, BTM_InqDbFirst());
+  ASSERT_TRUE(btm_cb.inq_db_by_addr.empty());
+}
+
 TEST_F(StackBtmWithInitFreeTest, BTM_SetEncryption) {
   const RawAddress bd_addr = RawAddress({0x11, 0x22, 0x33, 0x44, 0x55, 0x66});
   const tBT_TRANSPORT transport{BT_TRANSPORT_LE};
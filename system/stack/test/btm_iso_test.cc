@@ -19,6 +19,7 @@
 #include <gtest/gtest.h>
 
 #include "btm_iso_api.h"
+#include "btm_iso_sdu_pool.h"
 #include "hci/include/hci_layer.h"
 #include "main/shim/shim.h"
 #include "mock_controller.h"
@@ -62,7 +63,11 @@ static void SetMockBteInterface(MockBteInterface* interface) {
 
 void bte_main_hci_send(BT_HDR* p_msg, uint16_t event) {
   bte::bte_interface->HciSend(p_msg, event);
-  osi_free(p_msg);
+  if ((event & MSG_EVT_MASK) == MSG_STACK_TO_HC_HCI_ISO) {
+    bluetooth::hci::iso_manager::GetIsoSduPool().Release(p_msg);
+  } else {
+    osi_free(p_msg);
+  }
 }
 
 namespace {
@@ -1886,6 +1891,62 @@ TEST_F(IsoManagerTest, SendIsoDataCigValid) {
   }
 }
 
+TEST_F(IsoManagerTest, SendIsoSduBufferInPlace) {
+  IsoManager::GetInstance()->CreateCig(
+      volatile_test_cig_create_cmpl_evt_.cig_id, kDefaultCigParams);
+
+  auto handle = volatile_test_cig_create_cmpl_evt_.conn_handles[0];
+  bluetooth::hci::iso_manager::cis_establish_params params;
+  params.conn_pairs.push_back({handle, 1});
+  IsoManager::GetInstance()->EstablishCis(params);
+  IsoManager::GetInstance()->SetupIsoDataPath(handle,
+                                              kDefaultIsoDataPathParams);
+
+  constexpr uint8_t data_len = 108;
+  std::vector<BT_HDR*> sent_packets;
+  EXPECT_CALL(bte_interface_, HciSend)
+      .Times(3)
+      .WillRepeatedly([&sent_packets, data_len](BT_HDR* p_msg, uint16_t event) {
+        ASSERT_TRUE((event & MSG_STACK_TO_HC_HCI_ISO) != 0);
+        ASSERT_TRUE(p_msg->layer_specific & BT_ISO_HDR_CONTAINS_TS);
+        ASSERT_EQ(p_msg->len, data_len + 12);
+
+        // The SDU is sent as written by the encoder
+        uint8_t* sdu = p_msg->data + 12;
+        for (uint8_t i = 0; i < data_len; i++) ASSERT_EQ(sdu[i], i);
+        sent_packets.push_back(p_msg);
+      });
+
+  for (int i = 0; i < 3; i++) {
+    uint8_t* sdu = IsoManager::GetInstance()->GetIsoSduBuffer(handle, data_len);
+    ASSERT_NE(sdu, nullptr);
+    for (uint8_t j = 0; j < data_len; j++) sdu[j] = j;
+    IsoManager::GetInstance()->SendIsoSduBuffer(handle);
+  }
+
+  // Released buffers are reused by the next SDUs
+  ASSERT_EQ(sent_packets.size(), 3u);
+  ASSERT_EQ(sent_packets[0], sent_packets[1]);
+  ASSERT_EQ(sent_packets[1], sent_packets[2]);
+
+  // Nothing is sent twice
+  IsoManager::GetInstance()->SendIsoSduBuffer(handle);
+}
+
+TEST_F(IsoManagerTest, GetIsoSduBufferWithNoDataPath) {
+  IsoManager::GetInstance()->CreateCig(
+      volatile_test_cig_create_cmpl_evt_.cig_id, kDefaultCigParams);
+
+  auto handle = volatile_test_cig_create_cmpl_evt_.conn_handles[0];
+  bluetooth::hci::iso_manager::cis_establish_params params;
+  params.conn_pairs.push_back({handle, 1});
+  IsoManager::GetInstance()->EstablishCis(params);
+
+  EXPECT_CALL(bte_interface_, HciSend).Times(0);
+  ASSERT_EQ(IsoManager::GetInstance()->GetIsoSduBuffer(handle, 108), nullptr);
+  IsoManager::GetInstance()->SendIsoSduBuffer(handle);
+}
+
 TEST_F(IsoManagerTest, SendIsoDataBigValid) {
   IsoManager::GetInstance()->CreateBig(volatile_test_big_params_evt_.big_id,
                                        kDefaultBigParams);
@@ -2079,6 +2140,53 @@ TEST_F(IsoManagerTest, SendIsoDataCreditsReturned) {
   }
 }
 
+TEST_F(IsoManagerTest, DataPathStatsReportedOnDisconnection) {
+  uint8_t num_buffers = controller_interface_.GetIsoBufferCount();
+  std::vector<uint8_t> data_vec(108, 0);
+
+  IsoManager::GetInstance()->CreateCig(
+      volatile_test_cig_create_cmpl_evt_.cig_id, kDefaultCigParams);
+
+  auto handle = volatile_test_cig_create_cmpl_evt_.conn_handles[0];
+  bluetooth::hci::iso_manager::cis_establish_params params;
+  params.conn_pairs.push_back({handle, 1});
+  IsoManager::GetInstance()->EstablishCis(params);
+  IsoManager::GetInstance()->SetupIsoDataPath(handle,
+                                              kDefaultIsoDataPathParams);
+
+  // All the SDUs are sent within a single SDU interval or two
+  EXPECT_CALL(bte_interface_, HciSend).Times(num_buffers);
+  for (uint8_t i = 0; i < (2 * num_buffers); i++) {
+    IsoManager::GetInstance()->SendIsoData(handle, data_vec.data(),
+                                           data_vec.size());
+  }
+
+  uint8_t mock_rsp[5];
+  uint8_t* p = mock_rsp;
+  UINT8_TO_STREAM(p, 1);
+  UINT16_TO_STREAM(p, handle);
+  UINT16_TO_STREAM(p, num_buffers);
+  IsoManager::GetInstance()->HandleNumComplDataPkts(mock_rsp, sizeof(mock_rsp));
+
+  bluetooth::hci::iso_manager::iso_data_path_stats stats;
+  EXPECT_CALL(*cig_callbacks_, OnCisEvent)
+      .WillOnce([&stats](uint8_t event_code, void* data) {
+        ASSERT_EQ(event_code,
+                  bluetooth::hci::iso_manager::kIsoEventCisDisconnected);
+        stats = static_cast<bluetooth::hci::iso_manager::cis_disconnected_evt*>(
+                    data)
+                    ->data_path_stats;
+      });
+  IsoManager::GetInstance()->DisconnectCis(handle, 0x16);
+
+  ASSERT_EQ(stats.sent_sdus, num_buffers);
+  ASSERT_EQ(stats.dropped_sdus, num_buffers);
+  ASSERT_GE(stats.late_sdus, 2u * num_buffers - 2);
+  ASSERT_EQ(stats.queue_samples, num_buffers);
+  ASSERT_EQ(stats.max_used_credits, num_buffers);
+  ASSERT_LE(stats.encode_us_max, stats.encode_us_total);
+}
+
 TEST_F(IsoManagerTest, SendIsoDataCreditsReturnedByDisconnection) {
   uint8_t num_buffers = controller_interface_.GetIsoBufferCount();
   std::vector<uint8_t> data_vec(108, 0);
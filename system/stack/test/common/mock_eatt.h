@@ -66,6 +66,8 @@ class MockEattExtension : public EattExtension {
   MOCK_METHOD((void), StopAppIndicationTimer,
               (const RawAddress& bd_addr, uint16_t cid));
 
+  MOCK_METHOD((void), Dump, (int fd));
+
   MOCK_METHOD((void), Start, ());
   MOCK_METHOD((void), Stop, ());
 };
@@ -23,9 +23,9 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <vector>
 
-#include "stack/crypto_toolbox/aes.h"
 #include "stack/include/bt_octets.h"
 
 using ::testing::ElementsAreArray;
@@ -43,10 +43,13 @@ TEST(CryptoToolboxTest, bt_spec_test_d_1_test) {
   uint8_t aes_cmac_k_m[] = {0x7d, 0xf7, 0x6b, 0x0c, 0x1a, 0xb8, 0x99, 0xb3,
                             0x3e, 0x42, 0xf0, 0x47, 0xb9, 0x1b, 0x54, 0x6f};
 
-  uint8_t output[16];
-  aes_context ctx;
-  aes_set_key(k, sizeof(k), &ctx);
-  aes_encrypt(m, output, &ctx); /* outputs in byte 48 to byte 63 */
+  /* The vector is big endian, aes_128() works on little endian blocks */
+  Octet16 key;
+  Octet16 message;
+  std::reverse_copy(k, k + OCTET16_LEN, key.begin());
+  std::reverse_copy(m, m + OCTET16_LEN, message.begin());
+  Octet16 output = aes_128(key, message);
+  std::reverse(output.begin(), output.end());
 
   EXPECT_THAT(output, ElementsAreArray(aes_cmac_k_m, OCTET16_LEN));
 
@@ -317,6 +320,12 @@ TEST(CryptoToolboxTest, bt_spec_example_d_7_test) {
   EXPECT_EQ(result[0], expected_ah[0]);
   EXPECT_EQ(result[1], expected_ah[1]);
   EXPECT_EQ(result[2], expected_ah[2]);
+
+  // Same result with the precomputed key schedule
+  Aes128KeySchedule key_schedule = aes_128_key_schedule(IRK);
+  Octet16 msg{0};
+  std::copy(prand.begin(), prand.begin() + 3, msg.begin());
+  EXPECT_EQ(expected_aes_128, aes_128(key_schedule, msg));
 }
 
 // BT Spec 5.0 | Vol 3, Part H D.8
@@ -366,6 +366,42 @@ TEST_F(EattTest, DisonnectByPeerSucceed) {
   ASSERT_TRUE(channel == nullptr);
 }
 
+TEST_F(EattTest, ChannelAvailableForClientRequest) {
+  ConnectDeviceEattSupported(3);
+
+  std::vector<EattChannel*> channels;
+  for (uint16_t cid : connected_cids_) {
+    channels.push_back(eatt_instance_->FindEattChannelByCid(test_address, cid));
+  }
+
+  /* Each request goes to an idle channel first */
+  channels[0]->cl_cmd_q_.push({});
+  channels[2]->cl_cmd_q_.push({});
+  ASSERT_EQ(channels[1],
+            eatt_instance_->GetChannelAvailableForClientRequest(test_address));
+
+  /* Then to the least busy one */
+  channels[0]->cl_cmd_q_.push({});
+  channels[1]->cl_cmd_q_.push({});
+  ASSERT_EQ(channels[1],
+            eatt_instance_->GetChannelAvailableForClientRequest(test_address));
+  channels[1]->cl_cmd_q_.push({});
+  ASSERT_EQ(channels[2],
+            eatt_instance_->GetChannelAvailableForClientRequest(test_address));
+
+  /* Channels still connecting are not used */
+  channels[2]->state_ = EattChannelState::EATT_CHANNEL_PENDING;
+  channels[2]->cl_cmd_q_ = std::queue<tGATT_CMD_Q>();
+  ASSERT_EQ(channels[0],
+            eatt_instance_->GetChannelAvailableForClientRequest(test_address));
+  channels[2]->state_ = EattChannelState::EATT_CHANNEL_OPENED;
+
+  for (EattChannel* channel : channels) {
+    channel->cl_cmd_q_ = std::queue<tGATT_CMD_Q>();
+  }
+  DisconnectEattDevice(connected_cids_);
+}
+
 TEST_F(EattTest, ReconfigAllSucceed) {
   ConnectDeviceEattSupported(3);
 
@@ -0,0 +1,245 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <base/logging.h>
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "stack/crypto_toolbox/crypto_toolbox.h"
+#include "stack/gatt/gatt_int.h"
+#include "stack/include/l2cdefs.h"
+#include "types/bluetooth/uuid.h"
+
+using ::benchmark::State;
+using bluetooth::Uuid;
+
+tGATT_CB gatt_cb;
+
+std::map<std::string, int> mock_function_count_map;
+
+namespace {
+
+// 25 services of 20 attributes: the service declaration, 9 characteristics
+// and a client characteristic configuration descriptor.
+constexpr uint16_t kNumServices = 25;
+constexpr uint16_t kNumCharacteristics = 9;
+constexpr uint16_t kAttributesPerService = 1 + 2 * kNumCharacteristics + 1;
+constexpr uint16_t kNumAttributes = kNumServices * kAttributesPerService;
+static_assert(kNumAttributes == 500, "Database should hold 500 attributes");
+
+constexpr uint16_t kMtu = GATT_DEF_BLE_MTU_SIZE;
+
+class GattDbBenchmark : public ::benchmark::Fixture {
+ public:
+  void SetUp(State& st) override {
+    ::benchmark::Fixture::SetUp(st);
+    gatt_cb = tGATT_CB();
+    gatt_cb.srv_list_info = new std::list<tGATT_SRV_LIST_ELEM>();
+    dbs_ = std::vector<tGATT_SVC_DB>(kNumServices);
+    for (uint16_t i = 0; i < kNumServices; i++) {
+      uint16_t s_hdl = 1 + i * kAttributesPerService;
+      tGATT_SVC_DB& db = dbs_[i];
+      gatts_init_service_db(db, Uuid::From16Bit(0x1800 + i), true, s_hdl,
+                            kAttributesPerService);
+      for (uint16_t j = 0; j < kNumCharacteristics; j++) {
+        gatts_add_characteristic(db, GATT_PERM_READ, GATT_CHAR_PROP_BIT_READ,
+                                 Uuid::From16Bit(0x2A00 + j));
+      }
+      gatts_add_char_descr(db, GATT_PERM_READ | GATT_PERM_WRITE,
+                           Uuid::From16Bit(GATT_UUID_CHAR_CLIENT_CONFIG));
+
+      tGATT_SRV_LIST_ELEM& elem = gatt_sr_add_srv(s_hdl);
+      elem.e_hdl = s_hdl + kAttributesPerService - 1;
+      elem.p_db = &db;
+      elem.is_primary = true;
+      elem.type = GATT_UUID_PRI_SERVICE;
+    }
+    rsp_buffer_ = std::vector<uint8_t>(sizeof(BT_HDR) + L2CAP_MIN_OFFSET + kMtu);
+  }
+
+  void TearDown(State& st) override {
+    gatt_sr_clear_srv_list();
+    delete gatt_cb.srv_list_info;
+    gatt_cb.srv_list_info = nullptr;
+    dbs_.clear();
+    ::benchmark::Fixture::TearDown(st);
+  }
+
+  // Handle lookup as it was done before srv_list_index, for comparison.
+  static tGATT_ATTR* LinearFindAttr(uint16_t handle) {
+    for (auto& el : *gatt_cb.srv_list_info) {
+      if (el.s_hdl <= handle && el.e_hdl >= handle) {
+        for (auto& attr : el.p_db->attr_list) {
+          if (attr.handle == handle) return &attr;
+          if (attr.handle > handle) return nullptr;
+        }
+      }
+    }
+    return nullptr;
+  }
+
+  static tGATT_ATTR* IndexedFindAttr(uint16_t handle) {
+    auto it = gatt_sr_find_i_rcb_by_handle(handle);
+    if (it == gatt_cb.srv_list_info->end()) return nullptr;
+    auto attr_it = gatts_find_attr_lower_bound(*it->p_db, handle);
+    if (attr_it == it->p_db->attr_list.end() || attr_it->handle != handle) {
+      return nullptr;
+    }
+    return &*attr_it;
+  }
+
+  // One Read By Type request for characteristic declarations from |s_hdl|,
+  // walked the same way gatts_process_read_by_type_req() does. Returns the
+  // last handle in the response, 0 if nothing was found.
+  uint16_t ReadCharacteristicsByType(uint16_t s_hdl) {
+    BT_HDR* p_rsp = reinterpret_cast<BT_HDR*>(rsp_buffer_.data());
+    memset(p_rsp, 0, sizeof(BT_HDR));
+    uint16_t buf_len = kMtu - 2;
+    uint16_t err_hdl = 0;
+    tGATT_SEC_FLAG sec_flag{};
+    tGATT_STATUS status = GATT_NOT_FOUND;
+    Uuid type = Uuid::From16Bit(GATT_UUID_CHAR_DECLARE);
+    for (auto it = gatt_sr_find_first_srv_from(s_hdl);
+         it != gatt_cb.srv_list_info->end(); it++) {
+      tGATT_STATUS ret = gatts_db_read_attr_value_by_type(
+          tcb_, L2CAP_ATT_CID, it->p_db, GATT_REQ_READ_BY_TYPE, p_rsp, s_hdl,
+          0xFFFF, type, &buf_len, sec_flag, 0, 0, &err_hdl);
+      if (ret != GATT_NOT_FOUND) status = ret;
+      if (ret != GATT_SUCCESS && ret != GATT_NOT_FOUND) break;
+    }
+    if ((status != GATT_SUCCESS && status != GATT_NO_RESOURCES) ||
+        p_rsp->len == 0) {
+      return 0;
+    }
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(p_rsp + 1) +
+                       L2CAP_MIN_OFFSET + p_rsp->len - p_rsp->offset;
+    return p[0] | (p[1] << 8);
+  }
+
+  // One Find Information request from |s_hdl|, returning the last handle
+  // that fit in the response, 0 if there is none.
+  static uint16_t FindInformation(uint16_t s_hdl) {
+    // Handle and 16 bit UUID pairs after the opcode and format bytes.
+    size_t room = (kMtu - 2) / 4;
+    uint16_t last_handle = 0;
+    for (auto it = gatt_sr_find_first_srv_from(s_hdl);
+         it != gatt_cb.srv_list_info->end() && room > 0; it++) {
+      for (auto attr_it = gatts_find_attr_lower_bound(*it->p_db, s_hdl);
+           attr_it != it->p_db->attr_list.end() && room > 0; attr_it++) {
+        ::benchmark::DoNotOptimize(attr_it->uuid.As16Bit());
+        last_handle = attr_it->handle;
+        room--;
+      }
+    }
+    return last_handle;
+  }
+
+  std::vector<tGATT_SVC_DB> dbs_;
+  tGATT_TCB tcb_;
+  std::vector<uint8_t> rsp_buffer_;
+};
+
+BENCHMARK_DEFINE_F(GattDbBenchmark, find_attr_by_handle_linear)
+(State& state) {
+  for (auto _ : state) {
+    for (uint16_t handle = 1; handle <= kNumAttributes; handle++) {
+      ::benchmark::DoNotOptimize(LinearFindAttr(handle));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumAttributes);
+}
+BENCHMARK_REGISTER_F(GattDbBenchmark, find_attr_by_handle_linear);
+
+BENCHMARK_DEFINE_F(GattDbBenchmark, find_attr_by_handle_indexed)
+(State& state) {
+  for (auto _ : state) {
+    for (uint16_t handle = 1; handle <= kNumAttributes; handle++) {
+      ::benchmark::DoNotOptimize(IndexedFindAttr(handle));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumAttributes);
+}
+BENCHMARK_REGISTER_F(GattDbBenchmark, find_attr_by_handle_indexed);
+
+// Characteristic discovery of the whole database, one request per response.
+BENCHMARK_DEFINE_F(GattDbBenchmark, read_by_type_discovery)(State& state) {
+  size_t requests = 0;
+  for (auto _ : state) {
+    uint16_t s_hdl = 1;
+    while (uint16_t last_handle = ReadCharacteristicsByType(s_hdl)) {
+      requests++;
+      s_hdl = last_handle + 1;
+    }
+  }
+  state.counters["requests_per_discovery"] = ::benchmark::Counter(
+      requests, ::benchmark::Counter::kAvgIterations);
+}
+BENCHMARK_REGISTER_F(GattDbBenchmark, read_by_type_discovery);
+
+// Descriptor discovery of the whole database, one request per response.
+BENCHMARK_DEFINE_F(GattDbBenchmark, find_information_discovery)
+(State& state) {
+  size_t requests = 0;
+  for (auto _ : state) {
+    uint16_t s_hdl = 1;
+    while (uint16_t last_handle = FindInformation(s_hdl)) {
+      requests++;
+      s_hdl = last_handle + 1;
+    }
+  }
+  state.counters["requests_per_discovery"] = ::benchmark::Counter(
+      requests, ::benchmark::Counter::kAvgIterations);
+}
+BENCHMARK_REGISTER_F(GattDbBenchmark, find_information_discovery);
+
+// Database hash of the whole database, recomputed on each service change.
+BENCHMARK_DEFINE_F(GattDbBenchmark, database_hash)(State& state) {
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(
+        gatts_calculate_database_hash(gatt_cb.srv_list_info));
+  }
+}
+BENCHMARK_REGISTER_F(GattDbBenchmark, database_hash);
+
+// CMAC throughput, up to the largest input of crypto_toolbox::aes_cmac()
+void BM_AesCmac(State& state) {
+  std::vector<uint8_t> message(state.range(0), 0xA5);
+  Octet16 key{0};
+  for (auto _ : state) {
+    ::benchmark::DoNotOptimize(
+        crypto_toolbox::aes_cmac(key, message.data(), message.size()));
+  }
+  state.SetBytesProcessed(state.iterations() * message.size());
+}
+BENCHMARK(BM_AesCmac)->Arg(64)->Arg(1024)->Arg(16384)->Arg(65535);
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  // Disable LOG() output from libchrome
+  logging::LoggingSettings log_settings;
+  log_settings.logging_dest = logging::LoggingDestination::LOG_NONE;
+  CHECK(logging::InitLogging(log_settings)) << "Failed to set up logging";
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  ::benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,216 @@
+/*
+ * Copyright 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+
+#include "osi/include/allocator.h"
+#include "stack/gatt/gatt_int.h"
+#include "stack/include/bt_hdr.h"
+#include "types/bluetooth/uuid.h"
+
+using bluetooth::Uuid;
+
+tGATT_CB gatt_cb;
+
+std::map<std::string, int> mock_function_count_map;
+
+namespace {
+
+constexpr uint16_t kServiceHandle = 0x0010;
+constexpr uint16_t kNumCharacteristics = 5;
+// Service declaration, then a declaration and a value per characteristic.
+constexpr uint16_t kNumHandles = 1 + 2 * kNumCharacteristics;
+
+void init_db(tGATT_SVC_DB& db, uint16_t s_hdl) {
+  db = tGATT_SVC_DB();
+  gatts_init_service_db(db, Uuid::From16Bit(0x180F), true, s_hdl,
+                        kNumHandles);
+  for (uint16_t i = 0; i < kNumCharacteristics; i++) {
+    gatts_add_characteristic(db, GATT_PERM_READ, GATT_CHAR_PROP_BIT_READ,
+                             Uuid::From16Bit(0x2A19 + i));
+  }
+}
+
+class GattDbIndexTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    gatt_cb = tGATT_CB();
+    gatt_cb.srv_list_info = new std::list<tGATT_SRV_LIST_ELEM>();
+  }
+
+  void TearDown() override {
+    gatt_sr_clear_srv_list();
+    delete gatt_cb.srv_list_info;
+    gatt_cb.srv_list_info = nullptr;
+  }
+
+  void AddService(uint16_t s_hdl, uint16_t e_hdl) {
+    tGATT_SRV_LIST_ELEM& elem = gatt_sr_add_srv(s_hdl);
+    elem.e_hdl = e_hdl;
+  }
+
+  void CacheRsp(uint8_t op_code, uint16_t s_hdl, uint16_t payload_size,
+                const std::vector<uint8_t>& pdu) {
+    BT_HDR* p_msg = (BT_HDR*)osi_calloc(sizeof(BT_HDR) + pdu.size() + 8);
+    p_msg->offset = 8;
+    p_msg->len = pdu.size();
+    memcpy((uint8_t*)(p_msg + 1) + p_msg->offset, pdu.data(), pdu.size());
+    gatt_sr_cache_rsp(op_code, s_hdl, 0xFFFF, payload_size, GATT_SUCCESS,
+                      p_msg);
+    osi_free(p_msg);
+  }
+};
+
+TEST_F(GattDbIndexTest, attr_lower_bound) {
+  tGATT_SVC_DB db;
+  init_db(db, kServiceHandle);
+  ASSERT_EQ(kNumHandles, db.attr_list.size());
+
+  for (uint16_t handle = kServiceHandle; handle < kServiceHandle + kNumHandles;
+       handle++) {
+    auto it = gatts_find_attr_lower_bound(db, handle);
+    ASSERT_NE(db.attr_list.end(), it);
+    ASSERT_EQ(handle, it->handle);
+  }
+  ASSERT_EQ(db.attr_list.begin(), gatts_find_attr_lower_bound(db, 0x0001));
+  ASSERT_EQ(db.attr_list.end(),
+            gatts_find_attr_lower_bound(db, kServiceHandle + kNumHandles));
+  ASSERT_EQ(db.attr_list.end(), gatts_find_attr_lower_bound(db, 0xFFFF));
+}
+
+TEST_F(GattDbIndexTest, attr_lower_bound_with_gap) {
+  tGATT_SVC_DB db;
+  init_db(db, kServiceHandle);
+  // Handles are consecutive when allocated, make sure a gap still works.
+  db.attr_list.erase(db.attr_list.begin() + 3);
+
+  auto it = gatts_find_attr_lower_bound(db, kServiceHandle + 3);
+  ASSERT_EQ(kServiceHandle + 4, it->handle);
+  it = gatts_find_attr_lower_bound(db, kServiceHandle + 5);
+  ASSERT_EQ(kServiceHandle + 5, it->handle);
+  it = gatts_find_attr_lower_bound(db, kServiceHandle + kNumHandles - 1);
+  ASSERT_EQ(kServiceHandle + kNumHandles - 1, it->handle);
+}
+
+TEST_F(GattDbIndexTest, services_are_kept_in_handle_order) {
+  AddService(0x0040, 0x004F);
+  AddService(0x0001, 0x0009);
+  AddService(0x0020, 0x0025);
+
+  uint16_t previous = 0;
+  for (const auto& elem : *gatt_cb.srv_list_info) {
+    ASSERT_LT(previous, elem.s_hdl);
+    previous = elem.s_hdl;
+  }
+  ASSERT_EQ(3u, gatt_cb.srv_list_index.size());
+}
+
+TEST_F(GattDbIndexTest, find_service_by_handle) {
+  AddService(0x0040, 0x004F);
+  AddService(0x0001, 0x0009);
+  AddService(0x0020, 0x0025);
+
+  auto end = gatt_cb.srv_list_info->end();
+  ASSERT_EQ(0x0001, gatt_sr_find_i_rcb_by_handle(0x0001)->s_hdl);
+  ASSERT_EQ(0x0001, gatt_sr_find_i_rcb_by_handle(0x0009)->s_hdl);
+  ASSERT_EQ(end, gatt_sr_find_i_rcb_by_handle(0x000A));
+  ASSERT_EQ(0x0020, gatt_sr_find_i_rcb_by_handle(0x0022)->s_hdl);
+  ASSERT_EQ(end, gatt_sr_find_i_rcb_by_handle(0x0030));
+  ASSERT_EQ(0x0040, gatt_sr_find_i_rcb_by_handle(0x004F)->s_hdl);
+  ASSERT_EQ(end, gatt_sr_find_i_rcb_by_handle(0x0050));
+
+  ASSERT_EQ(0x0020, gatt_sr_find_first_srv_from(0x000A)->s_hdl);
+  ASSERT_EQ(0x0040, gatt_sr_find_first_srv_from(0x0026)->s_hdl);
+  ASSERT_EQ(end, gatt_sr_find_first_srv_from(0x0050));
+}
+
+TEST_F(GattDbIndexTest, remove_service) {
+  AddService(0x0001, 0x0009);
+  AddService(0x0020, 0x0025);
+  AddService(0x0040, 0x004F);
+
+  gatt_sr_remove_srv(gatt_sr_find_i_rcb_by_handle(0x0020));
+  ASSERT_EQ(2u, gatt_cb.srv_list_info->size());
+  ASSERT_EQ(2u, gatt_cb.srv_list_index.size());
+  ASSERT_EQ(gatt_cb.srv_list_info->end(), gatt_sr_find_i_rcb_by_handle(0x0020));
+  ASSERT_EQ(0x0040, gatt_sr_find_first_srv_from(0x000A)->s_hdl);
+
+  AddService(0x0020, 0x0025);
+  ASSERT_EQ(0x0020, gatt_sr_find_i_rcb_by_handle(0x0021)->s_hdl);
+}
+
+TEST_F(GattDbIndexTest, cached_rsp) {
+  const std::vector<uint8_t> pdu = {0x11, 0x06, 0x01, 0x00, 0x09, 0x00};
+  CacheRsp(GATT_REQ_READ_BY_GRP_TYPE, 0x0001, 23, pdu);
+
+  const tGATT_SR_CACHED_RSP* p_rsp =
+      gatt_sr_find_cached_rsp(GATT_REQ_READ_BY_GRP_TYPE, 0x0001, 0xFFFF, 23);
+  ASSERT_NE(nullptr, p_rsp);
+  ASSERT_EQ(GATT_SUCCESS, p_rsp->status);
+  ASSERT_EQ(pdu, p_rsp->pdu);
+
+  // Any other request parameter is a different response.
+  ASSERT_EQ(nullptr,
+            gatt_sr_find_cached_rsp(GATT_REQ_FIND_INFO, 0x0001, 0xFFFF, 23));
+  ASSERT_EQ(nullptr, gatt_sr_find_cached_rsp(GATT_REQ_READ_BY_GRP_TYPE,
+                                             0x0002, 0xFFFF, 23));
+  ASSERT_EQ(nullptr, gatt_sr_find_cached_rsp(GATT_REQ_READ_BY_GRP_TYPE,
+                                             0x0001, 0xFFFF, 517));
+}
+
+TEST_F(GattDbIndexTest, cached_error_rsp) {
+  gatt_sr_cache_rsp(GATT_REQ_FIND_INFO, 0x0050, 0xFFFF, 23, GATT_NOT_FOUND,
+                    nullptr);
+
+  const tGATT_SR_CACHED_RSP* p_rsp =
+      gatt_sr_find_cached_rsp(GATT_REQ_FIND_INFO, 0x0050, 0xFFFF, 23);
+  ASSERT_NE(nullptr, p_rsp);
+  ASSERT_EQ(GATT_NOT_FOUND, p_rsp->status);
+  ASSERT_TRUE(p_rsp->pdu.empty());
+}
+
+TEST_F(GattDbIndexTest, cached_rsp_dropped_on_database_change) {
+  const std::vector<uint8_t> pdu = {0x05, 0x01};
+  CacheRsp(GATT_REQ_FIND_INFO, 0x0001, 23, pdu);
+  AddService(0x0020, 0x0025);
+  ASSERT_EQ(nullptr,
+            gatt_sr_find_cached_rsp(GATT_REQ_FIND_INFO, 0x0001, 0xFFFF, 23));
+
+  CacheRsp(GATT_REQ_FIND_INFO, 0x0001, 23, pdu);
+  gatt_sr_remove_srv(gatt_sr_find_i_rcb_by_handle(0x0020));
+  ASSERT_EQ(nullptr,
+            gatt_sr_find_cached_rsp(GATT_REQ_FIND_INFO, 0x0001, 0xFFFF, 23));
+
+  CacheRsp(GATT_REQ_FIND_INFO, 0x0001, 23, pdu);
+  gatt_sr_clear_rsp_cache();
+  ASSERT_EQ(nullptr,
+            gatt_sr_find_cached_rsp(GATT_REQ_FIND_INFO, 0x0001, 0xFFFF, 23));
+}
+
+TEST_F(GattDbIndexTest, cached_rsp_bounded) {
+  const std::vector<uint8_t> pdu = {0x05, 0x01};
+  for (uint16_t handle = 1; handle <= 1000; handle++) {
+    CacheRsp(GATT_REQ_FIND_INFO, handle, 23, pdu);
+    ASSERT_LE(gatt_cb.sr_rsp_cache.size(), 128u);
+  }
+  ASSERT_NE(nullptr,
+            gatt_sr_find_cached_rsp(GATT_REQ_FIND_INFO, 1000, 0xFFFF, 23));
+}
+
+}  // namespace
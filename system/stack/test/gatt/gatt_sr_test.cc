@@ -91,6 +91,10 @@ tGATT_STATUS gatts_db_read_attr_value_by_type(
     uint32_t trans_id, uint16_t* p_cur_handle) {
   return GATT_SUCCESS;
 }
+std::vector<tGATT_ATTR>::iterator gatts_find_attr_lower_bound(
+    tGATT_SVC_DB& db, uint16_t handle) {
+  return db.attr_list.end();
+}
 void gatt_set_ch_state(tGATT_TCB* p_tcb, tGATT_CH_STATE ch_state) {}
 Uuid* gatts_get_service_uuid(tGATT_SVC_DB* p_db) { return nullptr; }
 tGATT_STATUS GATTS_HandleValueIndication(uint16_t conn_id, uint16_t attr_handle,
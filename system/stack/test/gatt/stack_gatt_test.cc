@@ -21,11 +21,17 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "common/message_loop_thread.h"
 #include "common/strings.h"
+#include "osi/include/allocator.h"
 #include "stack/gatt/gatt_int.h"
+#include "stack/include/bt_hdr.h"
 #include "stack/include/gatt_api.h"
+#include "stack/include/l2c_api.h"
+#include "stack/include/l2cdefs.h"
+#include "test/mock/mock_stack_l2cap_api.h"
 #include "types/bluetooth/uuid.h"
 #include "types/raw_address.h"
 
@@ -139,3 +145,86 @@ TEST_F(StackGattTest, GATT_Register_Deregister) {
 
   gatt_free();
 }
+
+TEST_F(StackGattTest, GATTS_HandleMultipleValueNotification) {
+  gatt_init();
+  tGATT_IF gatt_if = GATT_Register(bluetooth::Uuid::GetRandom(), "name",
+                                   &gatt_callbacks, false);
+
+  // Two clients supporting Multiple Handle Value Notifications, and one not
+  std::vector<uint16_t> conn_ids;
+  for (uint8_t i = 0; i < 3; i++) {
+    tGATT_TCB* p_tcb = gatt_allocate_tcb_by_bdaddr(
+        RawAddress({0x00, 0x11, 0x22, 0x33, 0x44, i}), BT_TRANSPORT_LE);
+    ASSERT_NE(nullptr, p_tcb);
+    p_tcb->att_lcid = L2CAP_ATT_CID;
+    p_tcb->payload_size = 100;
+    p_tcb->cl_supp_feat = (i < 2) ? 0x04 : 0x00;
+    conn_ids.push_back(GATT_CREATE_CONN_ID(p_tcb->tcb_idx, gatt_if));
+  }
+  conn_ids.push_back(GATT_CREATE_CONN_ID(GATT_MAX_PHY_CHANNEL - 1, gatt_if));
+
+  std::vector<std::pair<uint8_t, std::vector<uint8_t>>> pdus;
+  test::mock::stack_l2cap_api::L2CA_SendFixedChnlData.body =
+      [&pdus](uint16_t fixed_cid, const RawAddress& rem_bda, BT_HDR* p_buf) {
+        uint8_t* p = p_buf->data + p_buf->offset;
+        pdus.emplace_back(rem_bda.address[5],
+                          std::vector<uint8_t>(p, p + p_buf->len));
+        osi_free(p_buf);
+        return L2CAP_DW_SUCCESS;
+      };
+
+  uint8_t value1[] = {1, 2, 3};
+  uint8_t value2[] = {4, 5};
+  std::vector<tGATT_STATUS> statuses = GATTS_HandleMultipleValueNotification(
+      conn_ids, {{.handle = 0x10, .len = 3, .p_value = value1},
+                 {.handle = 0x11, .len = 2, .p_value = value2}});
+  test::mock::stack_l2cap_api::L2CA_SendFixedChnlData = {};
+
+  ASSERT_EQ(4u, statuses.size());
+  ASSERT_EQ(GATT_SUCCESS, statuses[0]);
+  ASSERT_EQ(GATT_SUCCESS, statuses[1]);
+  ASSERT_EQ(GATT_SUCCESS, statuses[2]);
+  ASSERT_EQ(GATT_INVALID_CONN_ID, statuses[3]);
+
+  std::vector<uint8_t> multi_notif = {0x23, 0x10, 0x00, 0x03, 0x00, 1, 2, 3,
+                                      0x11, 0x00, 0x02, 0x00, 4,    5};
+  ASSERT_EQ(4u, pdus.size());
+  ASSERT_EQ(0, pdus[0].first);
+  ASSERT_EQ(multi_notif, pdus[0].second);
+  ASSERT_EQ(1, pdus[1].first);
+  ASSERT_EQ(multi_notif, pdus[1].second);
+  ASSERT_EQ(2, pdus[2].first);
+  ASSERT_EQ(std::vector<uint8_t>({0x1b, 0x10, 0x00, 1, 2, 3}), pdus[2].second);
+  ASSERT_EQ(2, pdus[3].first);
+  ASSERT_EQ(std::vector<uint8_t>({0x1b, 0x11, 0x00, 4, 5}), pdus[3].second);
+
+  GATT_Deregister(gatt_if);
+  gatt_free();
+}
+
+TEST_F(StackGattTest, gatt_prep_write_rsp_matches) {
+  tGATT_VALUE attr = {.handle = 0x20, .len = 8};
+  for (uint8_t i = 0; i < attr.len; i++) attr.value[i] = i;
+  tGATT_PREP_WRITE prep_write = {.cid = 0x40, .offset = 4, .len = 3};
+
+  tGATT_VALUE rsp = {.handle = 0x20, .offset = 4, .len = 3};
+  memcpy(rsp.value, attr.value + 4, 3);
+  ASSERT_TRUE(gatt_prep_write_rsp_matches(attr, prep_write, rsp));
+
+  tGATT_VALUE wrong = rsp;
+  wrong.value[2] = 0xff;
+  ASSERT_FALSE(gatt_prep_write_rsp_matches(attr, prep_write, wrong));
+
+  wrong = rsp;
+  wrong.offset = 3;
+  ASSERT_FALSE(gatt_prep_write_rsp_matches(attr, prep_write, wrong));
+
+  wrong = rsp;
+  wrong.len = 2;
+  ASSERT_FALSE(gatt_prep_write_rsp_matches(attr, prep_write, wrong));
+
+  wrong = rsp;
+  wrong.handle = 0x21;
+  ASSERT_FALSE(gatt_prep_write_rsp_matches(attr, prep_write, wrong));
+}
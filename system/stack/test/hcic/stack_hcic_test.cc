@@ -0,0 +1,233 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "main/shim/hci_command.h"
+#include "osi/include/allocator.h"
+#include "packet/bit_inserter.h"
+#include "stack/include/bt_hdr.h"
+#include "stack/include/bt_octets.h"
+#include "stack/include/btu.h"
+#include "stack/include/hcidefs.h"
+#include "stack/include/hcimsgs.h"
+#include "types/raw_address.h"
+
+std::map<std::string, int> mock_function_count_map;
+
+namespace {
+
+/* The commands handed to btu, as they go to the controller */
+std::vector<std::vector<uint8_t>> sent_commands;
+std::vector<bool> sent_as_builder;
+
+/* A command encoded the way the hcic functions did before they built
+ * LegacyCommandBuilders: in a HCI_CMD_BUF_SIZE BT_HDR, with the opcode and the
+ * parameter length ahead of the parameters. */
+class LegacyHciCommand {
+ public:
+  LegacyHciCommand(uint16_t opcode, uint8_t parameter_size)
+      : p_buf_(static_cast<BT_HDR*>(osi_malloc(HCI_CMD_BUF_SIZE))) {
+    p_buf_->len = HCIC_PREAMBLE_SIZE + parameter_size;
+    p_buf_->offset = 0;
+    pp = (uint8_t*)(p_buf_ + 1);
+
+    UINT16_TO_STREAM(pp, opcode);
+    UINT8_TO_STREAM(pp, parameter_size);
+  }
+  ~LegacyHciCommand() { osi_free(p_buf_); }
+
+  std::vector<uint8_t> Bytes() const {
+    const uint8_t* p = p_buf_->data + p_buf_->offset;
+    return std::vector<uint8_t>(p, p + p_buf_->len);
+  }
+
+  uint8_t* pp;
+
+ private:
+  BT_HDR* p_buf_;
+};
+
+}  // namespace
+
+void btu_hcif_send_cmd(uint8_t controller_id, const BT_HDR* p_msg) {
+  const uint8_t* p = p_msg->data + p_msg->offset;
+  sent_commands.emplace_back(p, p + p_msg->len);
+  sent_as_builder.push_back(false);
+  osi_free(const_cast<BT_HDR*>(p_msg));
+}
+
+void btu_hcif_send_cmd(
+    uint8_t controller_id,
+    std::unique_ptr<bluetooth::shim::LegacyCommandBuilder> command) {
+  std::vector<uint8_t> bytes;
+  bluetooth::packet::BitInserter it(bytes);
+  command->Serialize(it);
+  EXPECT_EQ(command->size(), bytes.size());
+  sent_commands.push_back(std::move(bytes));
+  sent_as_builder.push_back(true);
+}
+
+void btu_hcif_send_cmd_with_cb(const base::Location& posted_from,
+                               uint16_t opcode, uint8_t* params,
+                               uint8_t params_len,
+                               base::OnceCallback<void(uint8_t*, uint16_t)> cb) {
+  mock_function_count_map[__func__]++;
+}
+
+void btm_acl_paging(BT_HDR* p, const RawAddress& bd_addr) {
+  mock_function_count_map[__func__]++;
+  osi_free(p);
+}
+
+void bte_main_hci_send(BT_HDR* p_msg, uint16_t event) {
+  mock_function_count_map[__func__]++;
+  osi_free(p_msg);
+}
+
+namespace {
+
+const RawAddress kRawAddress({0x11, 0x22, 0x33, 0x44, 0x55, 0x66});
+const Octet16 kLtk{0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                   0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f};
+
+class StackHcicTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    mock_function_count_map.clear();
+    sent_commands.clear();
+    sent_as_builder.clear();
+  }
+
+  /* The only command sent since the last call, which must have been built as
+   * a LegacyCommandBuilder */
+  std::vector<uint8_t> TakeBuilderCommand() {
+    EXPECT_EQ(1u, sent_commands.size());
+    if (sent_commands.size() != 1) return {};
+    EXPECT_TRUE(sent_as_builder[0]);
+    std::vector<uint8_t> command = std::move(sent_commands[0]);
+    sent_commands.clear();
+    sent_as_builder.clear();
+    return command;
+  }
+};
+
+TEST_F(StackHcicTest, write_policy_set) {
+  btsnd_hcic_write_policy_set(0x0123, 0x000f);
+
+  LegacyHciCommand expected(HCI_WRITE_POLICY_SETTINGS, 4);
+  UINT16_TO_STREAM(expected.pp, 0x0123);
+  UINT16_TO_STREAM(expected.pp, 0x000f);
+
+  ASSERT_EQ(expected.Bytes(), TakeBuilderCommand());
+}
+
+TEST_F(StackHcicTest, read_rmt_clk_offset) {
+  btsnd_hcic_read_rmt_clk_offset(0x0abc);
+
+  LegacyHciCommand expected(HCI_READ_RMT_CLOCK_OFFSET, 2);
+  UINT16_TO_STREAM(expected.pp, 0x0abc);
+
+  ASSERT_EQ(expected.Bytes(), TakeBuilderCommand());
+}
+
+TEST_F(StackHcicTest, sniff_mode) {
+  btsnd_hcic_sniff_mode(0x0001, 0x0320, 0x0190, 0x0004, 0x0001);
+
+  LegacyHciCommand expected(HCI_SNIFF_MODE, 10);
+  UINT16_TO_STREAM(expected.pp, 0x0001);
+  UINT16_TO_STREAM(expected.pp, 0x0320);
+  UINT16_TO_STREAM(expected.pp, 0x0190);
+  UINT16_TO_STREAM(expected.pp, 0x0004);
+  UINT16_TO_STREAM(expected.pp, 0x0001);
+
+  ASSERT_EQ(expected.Bytes(), TakeBuilderCommand());
+}
+
+TEST_F(StackHcicTest, ble_read_remote_feat) {
+  btsnd_hcic_ble_read_remote_feat(0x0040);
+
+  LegacyHciCommand expected(HCI_BLE_READ_REMOTE_FEAT, 2);
+  UINT16_TO_STREAM(expected.pp, 0x0040);
+
+  ASSERT_EQ(expected.Bytes(), TakeBuilderCommand());
+}
+
+TEST_F(StackHcicTest, ble_create_ll_conn) {
+  btsnd_hcic_ble_create_ll_conn(0x0060, 0x0030, 0x00, BLE_ADDR_RANDOM,
+                                kRawAddress, BLE_ADDR_PUBLIC, 0x0018, 0x0028,
+                                0x0000, 0x01f4, 0x0000, 0x0000);
+
+  LegacyHciCommand expected(HCI_BLE_CREATE_LL_CONN, 25);
+  UINT16_TO_STREAM(expected.pp, 0x0060);
+  UINT16_TO_STREAM(expected.pp, 0x0030);
+  UINT8_TO_STREAM(expected.pp, 0x00);
+  UINT8_TO_STREAM(expected.pp, BLE_ADDR_RANDOM);
+  BDADDR_TO_STREAM(expected.pp, kRawAddress);
+  UINT8_TO_STREAM(expected.pp, BLE_ADDR_PUBLIC);
+  UINT16_TO_STREAM(expected.pp, 0x0018);
+  UINT16_TO_STREAM(expected.pp, 0x0028);
+  UINT16_TO_STREAM(expected.pp, 0x0000);
+  UINT16_TO_STREAM(expected.pp, 0x01f4);
+  UINT16_TO_STREAM(expected.pp, 0x0000);
+  UINT16_TO_STREAM(expected.pp, 0x0000);
+
+  ASSERT_EQ(expected.Bytes(), TakeBuilderCommand());
+}
+
+TEST_F(StackHcicTest, ble_start_enc) {
+  uint8_t rand[HCIC_BLE_RAND_DI_SIZE] = {0xf0, 0xf1, 0xf2, 0xf3,
+                                         0xf4, 0xf5, 0xf6, 0xf7};
+  btsnd_hcic_ble_start_enc(0x0041, rand, 0x1234, kLtk);
+
+  LegacyHciCommand expected(HCI_BLE_START_ENC, 28);
+  UINT16_TO_STREAM(expected.pp, 0x0041);
+  ARRAY_TO_STREAM(expected.pp, rand, HCIC_BLE_RAND_DI_SIZE);
+  UINT16_TO_STREAM(expected.pp, 0x1234);
+  ARRAY_TO_STREAM(expected.pp, kLtk.data(), OCTET16_LEN);
+
+  ASSERT_EQ(expected.Bytes(), TakeBuilderCommand());
+}
+
+/* Builders come back from the pool with the parameters of the previous
+ * command, which must all be overwritten */
+TEST_F(StackHcicTest, pooled_builders_are_fully_rewritten) {
+  uint8_t rand[HCIC_BLE_RAND_DI_SIZE] = {0xff, 0xff, 0xff, 0xff,
+                                         0xff, 0xff, 0xff, 0xff};
+  for (int i = 0; i < 3; i++) {
+    btsnd_hcic_ble_start_enc(0x0fff, rand, 0xffff, kLtk);
+    TakeBuilderCommand();
+
+    btsnd_hcic_ble_ltk_req_reply(0x0042, kLtk);
+    LegacyHciCommand ltk_req_reply(HCI_BLE_LTK_REQ_REPLY, 18);
+    UINT16_TO_STREAM(ltk_req_reply.pp, 0x0042);
+    ARRAY_TO_STREAM(ltk_req_reply.pp, kLtk.data(), OCTET16_LEN);
+    ASSERT_EQ(ltk_req_reply.Bytes(), TakeBuilderCommand());
+
+    btsnd_hcic_read_rmt_clk_offset(0x0001);
+    LegacyHciCommand read_rmt_clk_offset(HCI_READ_RMT_CLOCK_OFFSET, 2);
+    UINT16_TO_STREAM(read_rmt_clk_offset.pp, 0x0001);
+    ASSERT_EQ(read_rmt_clk_offset.Bytes(), TakeBuilderCommand());
+  }
+}
+
+}  // namespace
@@ -889,4 +889,29 @@ TEST_F(StackRfcommTest, TestConnectionCollision) {
   l2cap_appl_info_.pL2CA_DataInd_Cb(new_lcid, uih_msc_rsp_from_peer);
 }
 
+TEST(StackRfcommCreditTest, AdaptCreditRx) {
+  tPORT port = {};
+  port.credit_rx_max = port.credit_rx_max_min = 10;
+  port.credit_rx_low = port.credit_rx_low_min = 4;
+
+  // Grows as the app keeps up, up to the limit
+  port_adapt_credit_rx(&port, true);
+  EXPECT_EQ(port.credit_rx_max, 20);
+  EXPECT_EQ(port.credit_rx_low, 10);
+  for (int i = 0; i < PORT_CO_CREDIT_RX_MAX; i++) {
+    port_adapt_credit_rx(&port, true);
+  }
+  EXPECT_EQ(port.credit_rx_max, PORT_CO_CREDIT_RX_MAX);
+  EXPECT_EQ(port.credit_rx_low, PORT_CO_CREDIT_RX_MAX / 2);
+
+  // Halves when the app falls behind, down to the initial values
+  port_adapt_credit_rx(&port, false);
+  EXPECT_EQ(port.credit_rx_max, PORT_CO_CREDIT_RX_MAX / 2);
+  for (int i = 0; i < 8; i++) {
+    port_adapt_credit_rx(&port, false);
+  }
+  EXPECT_EQ(port.credit_rx_max, 10);
+  EXPECT_EQ(port.credit_rx_low, 4);
+}
+
 }  // namespace
@@ -0,0 +1,682 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "bt_types.h"
+#include "common/time_util.h"
+#include "osi/include/allocator.h"
+#include "stack/include/bt_hdr.h"
+#include "stack/include/l2c_api.h"
+#include "stack/include/sdp_api.h"
+#include "stack/include/sdpdefs.h"
+#include "stack/include/stack_metrics_logging.h"
+#include "stack/sdp/sdpint.h"
+#include "test/common/main_handler.h"
+#include "types/raw_address.h"
+
+namespace {
+
+constexpr uint16_t kConnectionId = 0x0040;
+constexpr uint16_t kClientConnectionId = 0x0041;
+constexpr uint16_t kRemoteMtu = 672;
+constexpr size_t kServiceNameLen = 200;
+constexpr uint16_t kFragmentLen = 32;
+
+// Every PDU sent to the peer, in order
+std::vector<std::vector<uint8_t>> sent_pdus;
+int num_connect_reqs;
+bool disconnect_requested;
+int num_attributes_logged;
+uint64_t boottime_ms = 1000;
+
+}  // namespace
+
+namespace bluetooth {
+namespace common {
+uint64_t time_get_os_boottime_ms() { return boottime_ms; }
+}  // namespace common
+}  // namespace bluetooth
+
+uint16_t L2CA_Register2(uint16_t psm, const tL2CAP_APPL_INFO& p_cb_info,
+                        bool enable_snoop, tL2CAP_ERTM_INFO* p_ertm_info,
+                        uint16_t my_mtu, uint16_t required_remote_mtu,
+                        uint16_t sec_level) {
+  return psm;
+}
+uint16_t L2CA_ConnectReq2(uint16_t psm, const RawAddress& p_bd_addr,
+                          uint16_t sec_level) {
+  num_connect_reqs++;
+  return kClientConnectionId;
+}
+bool L2CA_DisconnectReq(uint16_t cid) {
+  disconnect_requested = true;
+  return true;
+}
+uint8_t L2CA_DataWrite(uint16_t cid, BT_HDR* p_data) {
+  uint8_t* p = (uint8_t*)(p_data + 1) + p_data->offset;
+  sent_pdus.emplace_back(p, p + p_data->len);
+  osi_free(p_data);
+  return L2CAP_DW_SUCCESS;
+}
+
+void log_sdp_attribute(const RawAddress& address, uint16_t protocol_uuid,
+                       uint16_t attribute_id, size_t attribute_size,
+                       const char* attribute_value) {
+  num_attributes_logged++;
+}
+void log_manufacturer_info(const RawAddress& address,
+                           android::bluetooth::AddressTypeEnum address_type,
+                           android::bluetooth::DeviceInfoSrcEnum source_type,
+                           const std::string& source_name,
+                           const std::string& manufacturer,
+                           const std::string& model,
+                           const std::string& hardware_version,
+                           const std::string& software_version) {}
+
+bool btif_config_set_int(const std::string& section, const std::string& key,
+                         int value) {
+  return true;
+}
+
+class StackSdpServerTest : public ::testing::Test {
+ protected:
+  // The attribute list of a ServiceSearchAttribute response, the
+  // continuation state following it, or the error code of an error response
+  struct Response {
+    uint8_t pdu_id{0};
+    std::vector<uint8_t> list;
+    std::vector<uint8_t> cont;
+    uint16_t error{0};
+  };
+
+  void SetUp() override {
+    sent_pdus.clear();
+    sdp_init();
+
+    p_ccb_ = sdpu_allocate_ccb();
+    ASSERT_NE(nullptr, p_ccb_);
+    p_ccb_->con_state = SDP_STATE_CONNECTED;
+    p_ccb_->connection_id = kConnectionId;
+    p_ccb_->rem_mtu_size = kRemoteMtu;
+    p_ccb_->device_address = RawAddress({0x11, 0x22, 0x33, 0x44, 0x55, 0x66});
+
+    uint16_t service = UUID_SERVCLASS_SERIAL_PORT;
+    handle_ = SDP_CreateRecord();
+    ASSERT_NE(0u, handle_);
+    ASSERT_TRUE(SDP_AddServiceClassIdList(handle_, 1, &service));
+    SetServiceName('a');
+  }
+
+  void TearDown() override {
+    for (int i = 0; i < SDP_MAX_CONNECTIONS; i++) {
+      if (sdp_cb.ccb[i].con_state != SDP_STATE_IDLE)
+        sdpu_release_ccb(&sdp_cb.ccb[i]);
+    }
+    sdp_free();
+  }
+
+  void SetServiceName(char c) {
+    std::vector<uint8_t> name(kServiceNameLen, c);
+    ASSERT_TRUE(SDP_AddAttribute(handle_, ATTR_ID_SERVICE_NAME,
+                                 TEXT_STR_DESC_TYPE, name.size(),
+                                 name.data()));
+  }
+
+  // Changes the service name in place, leaving the database generation as
+  // is so that only a cached list still shows the previous name
+  void OverwriteServiceName(char c) {
+    tSDP_RECORD* p_rec = &sdp_cb.server_db.record[0];
+    for (uint16_t xx = 0; xx < p_rec->num_attributes; xx++) {
+      if (p_rec->attribute[xx].id == ATTR_ID_SERVICE_NAME) {
+        memset(p_rec->attribute[xx].value_ptr, c, p_rec->attribute[xx].len);
+        return;
+      }
+    }
+    FAIL() << "No service name attribute";
+  }
+
+  // Sends a ServiceSearchAttribute request for the serial port service
+  Response SendSearchAttrReq(uint16_t max_list_len, uint16_t attr_start,
+                             uint16_t attr_end,
+                             const std::vector<uint8_t>& cont) {
+    std::vector<uint8_t> params = {
+        (DATA_ELE_SEQ_DESC_TYPE << 3) | SIZE_IN_NEXT_BYTE,
+        3,
+        (UUID_DESC_TYPE << 3) | SIZE_TWO_BYTES,
+        UUID_SERVCLASS_SERIAL_PORT >> 8,
+        UUID_SERVCLASS_SERIAL_PORT & 0xff,
+        (uint8_t)(max_list_len >> 8),
+        (uint8_t)max_list_len,
+        (DATA_ELE_SEQ_DESC_TYPE << 3) | SIZE_IN_NEXT_BYTE,
+        5,
+        (UINT_DESC_TYPE << 3) | SIZE_FOUR_BYTES,
+        (uint8_t)(attr_start >> 8),
+        (uint8_t)attr_start,
+        (uint8_t)(attr_end >> 8),
+        (uint8_t)attr_end,
+    };
+    params.insert(params.end(), cont.begin(), cont.end());
+    return SendReq(SDP_PDU_SERVICE_SEARCH_ATTR_REQ, params);
+  }
+
+  Response SendReq(uint8_t pdu_id, const std::vector<uint8_t>& params) {
+    BT_HDR* p_msg = (BT_HDR*)osi_malloc(sizeof(BT_HDR) + 5 + params.size());
+    uint8_t* p = (uint8_t*)(p_msg + 1);
+
+    p_msg->offset = 0;
+    p_msg->len = 5 + params.size();
+    UINT8_TO_BE_STREAM(p, pdu_id);
+    UINT16_TO_BE_STREAM(p, ++trans_num_);
+    UINT16_TO_BE_STREAM(p, params.size());
+    memcpy(p, params.data(), params.size());
+
+    size_t num_sent = sent_pdus.size();
+    sdp_server_handle_client_req(p_ccb_, p_msg);
+    osi_free(p_msg);
+
+    Response rsp;
+    EXPECT_EQ(num_sent + 1, sent_pdus.size());
+    if (sent_pdus.size() != num_sent + 1) return rsp;
+
+    const std::vector<uint8_t>& pdu = sent_pdus.back();
+    EXPECT_LE(5u, pdu.size());
+    EXPECT_EQ(trans_num_, (pdu[1] << 8) | pdu[2]);
+    EXPECT_EQ(pdu.size() - 5, (size_t)((pdu[3] << 8) | pdu[4]));
+    rsp.pdu_id = pdu[0];
+    if (rsp.pdu_id == SDP_PDU_ERROR_RESPONSE) {
+      rsp.error = (pdu[5] << 8) | pdu[6];
+      return rsp;
+    }
+
+    size_t list_len = (pdu[5] << 8) | pdu[6];
+    EXPECT_LE(7 + list_len + 1, pdu.size());
+    rsp.list.assign(pdu.begin() + 7, pdu.begin() + 7 + list_len);
+    rsp.cont.assign(pdu.begin() + 7 + list_len, pdu.end());
+    EXPECT_EQ(rsp.cont.size(), 1u + rsp.cont[0]);
+    return rsp;
+  }
+
+  // Reads a whole attribute list, in fragments of max_list_len bytes
+  std::vector<uint8_t> ReadAll(uint16_t max_list_len, uint16_t attr_start,
+                               uint16_t attr_end, size_t* p_num_fragments) {
+    std::vector<uint8_t> list;
+    std::vector<uint8_t> cont = {0};
+
+    *p_num_fragments = 0;
+    do {
+      Response rsp = SendSearchAttrReq(max_list_len, attr_start, attr_end,
+                                       cont);
+      EXPECT_EQ(SDP_PDU_SERVICE_SEARCH_ATTR_RSP, rsp.pdu_id);
+      if (rsp.pdu_id != SDP_PDU_SERVICE_SEARCH_ATTR_RSP) break;
+      EXPECT_GE(max_list_len, rsp.list.size());
+      list.insert(list.end(), rsp.list.begin(), rsp.list.end());
+      cont = rsp.cont;
+      (*p_num_fragments)++;
+    } while (cont[0] != 0);
+    return list;
+  }
+
+  std::vector<uint8_t> ReadAll(uint16_t attr_start, uint16_t attr_end) {
+    size_t num_fragments;
+    return ReadAll(kRemoteMtu, attr_start, attr_end, &num_fragments);
+  }
+
+  static bool HasServiceName(const std::vector<uint8_t>& list, char c) {
+    std::vector<uint8_t> name(kServiceNameLen, c);
+    return std::search(list.begin(), list.end(), name.begin(), name.end()) !=
+           list.end();
+  }
+
+  void ExpectInvalidContState(const std::vector<uint8_t>& cont) {
+    Response rsp = SendSearchAttrReq(kFragmentLen, 0x0000, 0xffff, cont);
+    EXPECT_EQ(SDP_PDU_ERROR_RESPONSE, rsp.pdu_id);
+    EXPECT_EQ(SDP_INVALID_CONT_STATE, rsp.error);
+  }
+
+  tCONN_CB* p_ccb_{nullptr};
+  uint32_t handle_{0};
+  uint16_t trans_num_{0};
+};
+
+TEST_F(StackSdpServerTest, continuation_round_trip) {
+  std::vector<uint8_t> whole = ReadAll(0x0000, 0xffff);
+  ASSERT_TRUE(HasServiceName(whole, 'a'));
+
+  size_t num_fragments;
+  std::vector<uint8_t> fragmented =
+      ReadAll(kFragmentLen, 0x0000, 0xffff, &num_fragments);
+  EXPECT_EQ((whole.size() + kFragmentLen - 1) / kFragmentLen, num_fragments);
+  EXPECT_LT(1u, num_fragments);
+  EXPECT_EQ(whole, fragmented);
+}
+
+TEST_F(StackSdpServerTest, continuation_without_list) {
+  ExpectInvalidContState({SDP_CONTINUATION_LEN, 0x00, 0x00});
+  ExpectInvalidContState({SDP_CONTINUATION_LEN, 0x00, kFragmentLen});
+}
+
+TEST_F(StackSdpServerTest, continuation_malformed) {
+  Response rsp = SendSearchAttrReq(kFragmentLen, 0x0000, 0xffff, {0});
+  ASSERT_EQ(SDP_PDU_SERVICE_SEARCH_ATTR_RSP, rsp.pdu_id);
+  ASSERT_EQ(SDP_CONTINUATION_LEN, rsp.cont[0]);
+
+  // Short, truncated and oversized continuation states
+  ExpectInvalidContState({1, rsp.cont[1]});
+  ExpectInvalidContState({SDP_CONTINUATION_LEN, rsp.cont[1]});
+  ExpectInvalidContState({3, rsp.cont[1], rsp.cont[2], 0x00});
+
+  // The list being sent is left as it was
+  Response next = SendSearchAttrReq(kFragmentLen, 0x0000, 0xffff, rsp.cont);
+  EXPECT_EQ(SDP_PDU_SERVICE_SEARCH_ATTR_RSP, next.pdu_id);
+  EXPECT_EQ(kFragmentLen, next.list.size());
+}
+
+TEST_F(StackSdpServerTest, continuation_out_of_range) {
+  Response rsp = SendSearchAttrReq(kFragmentLen, 0x0000, 0xffff, {0});
+  ASSERT_EQ(SDP_PDU_SERVICE_SEARCH_ATTR_RSP, rsp.pdu_id);
+  ASSERT_EQ(SDP_CONTINUATION_LEN, rsp.cont[0]);
+
+  uint16_t list_len = p_ccb_->list_len;
+  ExpectInvalidContState({SDP_CONTINUATION_LEN, 0xff, 0xff});
+  ExpectInvalidContState({SDP_CONTINUATION_LEN, (uint8_t)(list_len >> 8),
+                          (uint8_t)list_len});
+  ExpectInvalidContState({SDP_CONTINUATION_LEN, 0x00, kFragmentLen + 1});
+  ExpectInvalidContState({SDP_CONTINUATION_LEN, 0x00, kFragmentLen - 1});
+}
+
+TEST_F(StackSdpServerTest, continuation_replayed) {
+  Response first = SendSearchAttrReq(kFragmentLen, 0x0000, 0xffff, {0});
+  ASSERT_EQ(SDP_CONTINUATION_LEN, first.cont[0]);
+  Response second =
+      SendSearchAttrReq(kFragmentLen, 0x0000, 0xffff, first.cont);
+  ASSERT_EQ(SDP_PDU_SERVICE_SEARCH_ATTR_RSP, second.pdu_id);
+  ASSERT_EQ(SDP_CONTINUATION_LEN, second.cont[0]);
+
+  ExpectInvalidContState(first.cont);
+
+  // Read to the end, after which no continuation is valid any more
+  std::vector<uint8_t> cont = second.cont;
+  std::vector<uint8_t> last_cont;
+  while (cont[0] != 0) {
+    last_cont = cont;
+    cont = SendSearchAttrReq(kFragmentLen, 0x0000, 0xffff, cont).cont;
+  }
+  ExpectInvalidContState(last_cont);
+}
+
+TEST_F(StackSdpServerTest, continuation_after_database_change) {
+  std::vector<uint8_t> before = ReadAll(0x0000, 0xffff);
+  ASSERT_TRUE(HasServiceName(before, 'a'));
+
+  Response rsp = SendSearchAttrReq(kFragmentLen, 0x0000, 0xffff, {0});
+  ASSERT_EQ(SDP_CONTINUATION_LEN, rsp.cont[0]);
+  std::vector<uint8_t> list = rsp.list;
+
+  uint32_t generation = sdp_db_get_generation();
+  SetServiceName('b');
+  EXPECT_NE(generation, sdp_db_get_generation());
+
+  // The list being sent is completed as it was when the first part was sent
+  std::vector<uint8_t> cont = rsp.cont;
+  while (cont[0] != 0) {
+    rsp = SendSearchAttrReq(kFragmentLen, 0x0000, 0xffff, cont);
+    ASSERT_EQ(SDP_PDU_SERVICE_SEARCH_ATTR_RSP, rsp.pdu_id);
+    list.insert(list.end(), rsp.list.begin(), rsp.list.end());
+    cont = rsp.cont;
+  }
+  EXPECT_EQ(before, list);
+
+  // The next request is answered from the changed database
+  std::vector<uint8_t> after = ReadAll(0x0000, 0xffff);
+  EXPECT_TRUE(HasServiceName(after, 'b'));
+  EXPECT_FALSE(HasServiceName(after, 'a'));
+}
+
+TEST_F(StackSdpServerTest, cached_list_reused) {
+  ASSERT_TRUE(HasServiceName(ReadAll(0x0000, 0xffff), 'a'));
+
+  // The list encoded for the first request is sent again as is
+  OverwriteServiceName('c');
+  EXPECT_TRUE(HasServiceName(ReadAll(0x0000, 0xffff), 'a'));
+
+  // Until the database changes
+  SetServiceName('d');
+  EXPECT_TRUE(HasServiceName(ReadAll(0x0000, 0xffff), 'd'));
+}
+
+TEST_F(StackSdpServerTest, cached_list_kept_until_evicted) {
+  ASSERT_TRUE(HasServiceName(ReadAll(0x0000, 0xffff), 'a'));
+
+  // Seven other requests still leave room for the first one
+  for (uint16_t start = 1; start < 8; start++) ReadAll(start, 0xffff);
+  OverwriteServiceName('c');
+  EXPECT_TRUE(HasServiceName(ReadAll(0x0000, 0xffff), 'a'));
+}
+
+TEST_F(StackSdpServerTest, cached_list_evicted) {
+  ASSERT_TRUE(HasServiceName(ReadAll(0x0000, 0xffff), 'a'));
+
+  // Eight other requests push the least recently used list out
+  for (uint16_t start = 1; start <= 8; start++) ReadAll(start, 0xffff);
+  OverwriteServiceName('c');
+  EXPECT_TRUE(HasServiceName(ReadAll(0x0000, 0xffff), 'c'));
+}
+
+TEST_F(StackSdpServerTest, cached_list_recently_used_kept) {
+  ASSERT_TRUE(HasServiceName(ReadAll(0x0000, 0xffff), 'a'));
+  for (uint16_t start = 1; start < 8; start++) ReadAll(start, 0xffff);
+
+  // Reading the first list again makes it the most recently used
+  ReadAll(0x0000, 0xffff);
+  ReadAll(8, 0xffff);
+  OverwriteServiceName('c');
+  EXPECT_TRUE(HasServiceName(ReadAll(0x0000, 0xffff), 'a'));
+}
+
+namespace {
+
+const RawAddress kPeerAddress({0x11, 0x22, 0x33, 0x44, 0x55, 0x66});
+const RawAddress kOtherAddress({0x66, 0x55, 0x44, 0x33, 0x22, 0x11});
+constexpr uint32_t kDiscoveryDbSize = 4096;
+constexpr uint16_t kRfcommChannel = 3;
+
+// Completion callbacks called so far, in order
+std::vector<tSDP_RESULT> results;
+std::vector<const void*> user_data_seen;
+
+void disc_cmpl_cb(tSDP_RESULT result) { results.push_back(result); }
+void disc_cmpl_cb2(tSDP_RESULT result, const void* user_data) {
+  results.push_back(result);
+  user_data_seen.push_back(user_data);
+}
+
+}  // namespace
+
+// The records of the local database play the peer, searched by the client
+// side through a loopback of the L2CAP channel
+class StackSdpDiscoveryCacheTest : public StackSdpServerTest {
+ protected:
+  void SetUp() override {
+    StackSdpServerTest::SetUp();
+    main_thread_start_up();
+    results.clear();
+    user_data_seen.clear();
+    num_connect_reqs = 0;
+    disconnect_requested = false;
+    num_attributes_logged = 0;
+
+    tSDP_PROTOCOL_ELEM elems[2] = {};
+    elems[0].protocol_uuid = UUID_PROTOCOL_L2CAP;
+    elems[1].protocol_uuid = UUID_PROTOCOL_RFCOMM;
+    elems[1].num_params = 1;
+    elems[1].params[0] = kRfcommChannel;
+    ASSERT_TRUE(SDP_AddProtocolList(handle_, 2, elems));
+
+    // No L2CAP protocol, as for the Device ID record
+    uint16_t service = UUID_SERVCLASS_PNP_INFORMATION;
+    uint8_t spec_id[2] = {0x01, 0x03};
+    uint32_t di_handle = SDP_CreateRecord();
+    ASSERT_NE(0u, di_handle);
+    ASSERT_TRUE(SDP_AddServiceClassIdList(di_handle, 1, &service));
+    ASSERT_TRUE(SDP_AddAttribute(di_handle, ATTR_ID_SPECIFICATION_ID,
+                                 UINT_DESC_TYPE, sizeof(spec_id), spec_id));
+  }
+
+  void TearDown() override {
+    main_thread_shut_down();
+    for (tSDP_DISCOVERY_DB* p_db : dbs_) osi_free(p_db);
+    StackSdpServerTest::TearDown();
+  }
+
+  tSDP_DISCOVERY_DB* NewDb(uint16_t uuid16,
+                           const std::vector<uint16_t>& attr_ids) {
+    tSDP_DISCOVERY_DB* p_db = (tSDP_DISCOVERY_DB*)osi_malloc(kDiscoveryDbSize);
+    bluetooth::Uuid uuid = bluetooth::Uuid::From16Bit(uuid16);
+    EXPECT_TRUE(SDP_InitDiscoveryDb(p_db, kDiscoveryDbSize, 1, &uuid,
+                                    attr_ids.size(), attr_ids.data()));
+    dbs_.push_back(p_db);
+    return p_db;
+  }
+
+  // Plays the connection to the peer opened for a search, with the local
+  // server answering the requests, until the client disconnects
+  void RunPeerSearch() {
+    tL2CAP_CFG_INFO cfg = {};
+    cfg.mtu_present = true;
+    cfg.mtu = kRemoteMtu;
+
+    disconnect_requested = false;
+    sdp_cb.reg_info.pL2CA_ConnectCfm_Cb(kClientConnectionId, L2CAP_CONN_OK);
+    sdp_cb.reg_info.pL2CA_ConfigCfm_Cb(kClientConnectionId, 0, &cfg);
+
+    while (!disconnect_requested) {
+      std::vector<uint8_t> req = sent_pdus.back();
+      ASSERT_EQ(SDP_PDU_SERVICE_SEARCH_ATTR_REQ, req[0]);
+      BT_HDR* p_msg = NewMsg(req);
+      sdp_server_handle_client_req(p_ccb_, p_msg);
+      osi_free(p_msg);
+
+      std::vector<uint8_t> rsp = sent_pdus.back();
+      ASSERT_EQ(SDP_PDU_SERVICE_SEARCH_ATTR_RSP, rsp[0]);
+      sdp_cb.reg_info.pL2CA_DataInd_Cb(kClientConnectionId, NewMsg(rsp));
+    }
+    sdp_cb.reg_info.pL2CA_DisconnectCfm_Cb(kClientConnectionId, 0);
+  }
+
+  // Searches all the records of the peer holding the L2CAP protocol, with
+  // all their attributes, as the device discovery does
+  void RunFullDiscovery(const RawAddress& bd_addr) {
+    tSDP_DISCOVERY_DB* p_db = NewDb(UUID_PROTOCOL_L2CAP, {});
+    ASSERT_TRUE(SDP_ServiceSearchAttributeRequest(bd_addr, p_db, disc_cmpl_cb));
+    RunPeerSearch();
+    ASSERT_EQ(1u, results.size());
+    ASSERT_EQ(SDP_SUCCESS, results.back());
+    results.clear();
+  }
+
+  // Runs on the main thread, as the profiles do, so that the answers posted
+  // to it wait for the end of the call
+  static void RunOnMainThread(std::function<void()> closure) {
+    post_on_bt_main(std::move(closure));
+    sync_main_handler();
+  }
+
+  static BT_HDR* NewMsg(const std::vector<uint8_t>& data) {
+    BT_HDR* p_msg = (BT_HDR*)osi_malloc(sizeof(BT_HDR) + data.size());
+    p_msg->offset = 0;
+    p_msg->len = data.size();
+    memcpy(p_msg + 1, data.data(), data.size());
+    return p_msg;
+  }
+
+  // Searches the serial port service, whose channel is only in the
+  // protocol descriptor list
+  tSDP_DISCOVERY_DB* SearchSerialPort(const RawAddress& bd_addr) {
+    tSDP_DISCOVERY_DB* p_db =
+        NewDb(UUID_SERVCLASS_SERIAL_PORT,
+              {ATTR_ID_SERVICE_CLASS_ID_LIST, ATTR_ID_PROTOCOL_DESC_LIST});
+    EXPECT_TRUE(SDP_ServiceSearchAttributeRequest(bd_addr, p_db, disc_cmpl_cb));
+    return p_db;
+  }
+
+  static void ExpectSerialPort(tSDP_DISCOVERY_DB* p_db) {
+    tSDP_DISC_REC* p_rec =
+        SDP_FindServiceInDb(p_db, UUID_SERVCLASS_SERIAL_PORT, NULL);
+    ASSERT_NE(nullptr, p_rec);
+    EXPECT_EQ(kPeerAddress, p_rec->remote_bd_addr);
+
+    tSDP_PROTOCOL_ELEM elem;
+    ASSERT_TRUE(
+        SDP_FindProtocolListElemInRec(p_rec, UUID_PROTOCOL_RFCOMM, &elem));
+    EXPECT_EQ(1, elem.num_params);
+    EXPECT_EQ(kRfcommChannel, elem.params[0]);
+
+    // Only the attributes asked for
+    EXPECT_EQ(nullptr, SDP_FindAttributeInRec(p_rec, ATTR_ID_SERVICE_NAME));
+  }
+
+  std::vector<tSDP_DISCOVERY_DB*> dbs_;
+};
+
+TEST_F(StackSdpDiscoveryCacheTest, search_sent_to_peer_first) {
+  tSDP_DISCOVERY_DB* p_db = SearchSerialPort(kPeerAddress);
+  EXPECT_EQ(1, num_connect_reqs);
+  RunPeerSearch();
+  ASSERT_EQ(1u, results.size());
+  EXPECT_EQ(SDP_SUCCESS, results[0]);
+  ExpectSerialPort(p_db);
+}
+
+TEST_F(StackSdpDiscoveryCacheTest, search_answered_after_discovery) {
+  RunFullDiscovery(kPeerAddress);
+  EXPECT_EQ(1, num_connect_reqs);
+
+  num_attributes_logged = 0;
+  size_t num_sent = sent_pdus.size();
+  tSDP_DISCOVERY_DB* p_db = nullptr;
+  RunOnMainThread([this, &p_db]() {
+    p_db = SearchSerialPort(kPeerAddress);
+    // The result is still delivered asynchronously
+    EXPECT_TRUE(results.empty());
+  });
+  EXPECT_EQ(1, num_connect_reqs);
+  EXPECT_EQ(num_sent, sent_pdus.size());
+  EXPECT_LT(0, num_attributes_logged);
+
+  sync_main_handler();
+  ASSERT_EQ(1u, results.size());
+  EXPECT_EQ(SDP_SUCCESS, results[0]);
+  ExpectSerialPort(p_db);
+}
+
+TEST_F(StackSdpDiscoveryCacheTest, search_answered_with_user_data) {
+  RunFullDiscovery(kPeerAddress);
+
+  int user_data;
+  tSDP_DISCOVERY_DB* p_db =
+      NewDb(UUID_SERVCLASS_SERIAL_PORT, {ATTR_ID_PROTOCOL_DESC_LIST});
+  RunOnMainThread([p_db, &user_data]() {
+    EXPECT_TRUE(SDP_ServiceSearchAttributeRequest2(kPeerAddress, p_db,
+                                                   disc_cmpl_cb2, &user_data));
+  });
+  EXPECT_EQ(1, num_connect_reqs);
+  sync_main_handler();
+  ASSERT_EQ(1u, results.size());
+  EXPECT_EQ(SDP_SUCCESS, results[0]);
+  EXPECT_EQ(&user_data, user_data_seen[0]);
+}
+
+TEST_F(StackSdpDiscoveryCacheTest, device_id_search_sent_to_peer) {
+  RunFullDiscovery(kPeerAddress);
+
+  tSDP_DISCOVERY_DB* p_db =
+      NewDb(UUID_SERVCLASS_PNP_INFORMATION,
+            {ATTR_ID_SERVICE_CLASS_ID_LIST, ATTR_ID_SPECIFICATION_ID});
+  ASSERT_TRUE(SDP_ServiceSearchAttributeRequest(kPeerAddress, p_db,
+                                                disc_cmpl_cb));
+  EXPECT_EQ(2, num_connect_reqs);
+
+  RunPeerSearch();
+  ASSERT_EQ(1u, results.size());
+  EXPECT_EQ(SDP_SUCCESS, results[0]);
+  EXPECT_NE(nullptr,
+            SDP_FindServiceInDb(p_db, UUID_SERVCLASS_PNP_INFORMATION, NULL));
+}
+
+TEST_F(StackSdpDiscoveryCacheTest, other_peer_search_sent_to_peer) {
+  RunFullDiscovery(kOtherAddress);
+
+  SearchSerialPort(kPeerAddress);
+  EXPECT_EQ(2, num_connect_reqs);
+}
+
+TEST_F(StackSdpDiscoveryCacheTest, raw_data_search_sent_to_peer) {
+  RunFullDiscovery(kPeerAddress);
+
+  uint8_t raw_data[512];
+  tSDP_DISCOVERY_DB* p_db =
+      NewDb(UUID_SERVCLASS_SERIAL_PORT, {ATTR_ID_PROTOCOL_DESC_LIST});
+  p_db->raw_data = raw_data;
+  p_db->raw_size = sizeof(raw_data);
+  ASSERT_TRUE(SDP_ServiceSearchAttributeRequest(kPeerAddress, p_db,
+                                                disc_cmpl_cb));
+  EXPECT_EQ(2, num_connect_reqs);
+
+  RunPeerSearch();
+  ASSERT_EQ(1u, results.size());
+  EXPECT_EQ(SDP_SUCCESS, results[0]);
+  EXPECT_LT(0u, p_db->raw_used);
+}
+
+TEST_F(StackSdpDiscoveryCacheTest, lists_expire) {
+  RunFullDiscovery(kPeerAddress);
+
+  boottime_ms += SDP_DISC_CACHE_TIMEOUT_MS;
+  RunOnMainThread([this]() { SearchSerialPort(kPeerAddress); });
+  EXPECT_EQ(1, num_connect_reqs);
+  sync_main_handler();
+  EXPECT_EQ(1u, results.size());
+
+  boottime_ms += 1;
+  SearchSerialPort(kPeerAddress);
+  EXPECT_EQ(2, num_connect_reqs);
+}
+
+TEST_F(StackSdpDiscoveryCacheTest, lists_flushed) {
+  RunFullDiscovery(kPeerAddress);
+  RunFullDiscovery(kOtherAddress);
+
+  SDP_FlushDiscoveryCache(kPeerAddress);
+  SearchSerialPort(kPeerAddress);
+  EXPECT_EQ(3, num_connect_reqs);
+
+  // The lists of the other peers are kept
+  RunOnMainThread([this]() { SearchSerialPort(kOtherAddress); });
+  EXPECT_EQ(3, num_connect_reqs);
+  sync_main_handler();
+}
+
+TEST_F(StackSdpDiscoveryCacheTest, lists_dropped_by_init) {
+  RunFullDiscovery(kPeerAddress);
+
+  sdpu_release_ccb(p_ccb_);
+  sdp_free();
+  sdp_init();
+  SearchSerialPort(kPeerAddress);
+  EXPECT_EQ(2, num_connect_reqs);
+}
+
+TEST_F(StackSdpDiscoveryCacheTest, answer_cancelled) {
+  RunFullDiscovery(kPeerAddress);
+
+  tSDP_DISCOVERY_DB* p_db = nullptr;
+  RunOnMainThread([this, &p_db]() {
+    p_db = SearchSerialPort(kPeerAddress);
+    EXPECT_TRUE(SDP_CancelServiceSearch(p_db));
+  });
+  sync_main_handler();
+  ASSERT_EQ(1u, results.size());
+  EXPECT_EQ(SDP_CANCEL, results[0]);
+
+  // Nothing left to cancel
+  EXPECT_FALSE(SDP_CancelServiceSearch(p_db));
+}
@@ -22,6 +22,7 @@
 #include "common/init_flags.h"
 #include "osi/include/log.h"
 #include "stack/acl/acl.h"
+#include "stack/acl/btm_pm_traffic.h"
 #include "stack/btm/btm_int_types.h"
 #include "stack/btm/security_device_record.h"
 #include "stack/include/acl_api.h"
@@ -127,3 +128,66 @@ TEST_F(StackAclTest, acl_process_extended_features) {
 
   btm_acl_removed(hci_handle);
 }
+
+TEST_F(StackAclTest, power_mode_traffic_periodic) {
+  PowerModeTrafficPredictor traffic;
+  ASSERT_TRUE(traffic.IsIdle(0));
+
+  // Bursts of two packets every 20ms, as for an audio stream
+  uint64_t now_ms = 1000;
+  for (uint32_t i = 0; i < PowerModeTrafficPredictor::kMinSamples; i++) {
+    traffic.OnPacket(now_ms);
+    traffic.OnPacket(now_ms + 1);
+    ASSERT_FALSE(traffic.IsPeriodic());
+    now_ms += 20;
+  }
+  traffic.OnPacket(now_ms);
+  ASSERT_TRUE(traffic.IsPeriodic());
+  ASSERT_EQ(traffic.GetPeriodMs(), 20u);
+  ASSERT_FALSE(traffic.IsIdle(now_ms));
+
+  // 20ms are 32 slots
+  uint16_t max = 800;
+  traffic.AdaptSniffInterval(24, &max);
+  ASSERT_EQ(max, 32);
+  max = 800;
+  traffic.AdaptSniffInterval(400, &max);
+  ASSERT_EQ(max, 400);
+  max = 16;
+  traffic.AdaptSniffInterval(8, &max);
+  ASSERT_EQ(max, 16);
+
+  ASSERT_FALSE(traffic.ShouldExitSniff(64));
+  ASSERT_TRUE(traffic.ShouldExitSniff(66));
+}
+
+TEST_F(StackAclTest, power_mode_traffic_not_periodic) {
+  PowerModeTrafficPredictor traffic;
+  uint64_t now_ms = 1000;
+  for (uint32_t i = 0; i < 4 * PowerModeTrafficPredictor::kMinSamples; i++) {
+    traffic.OnPacket(now_ms);
+    now_ms += (i % 2) ? 10 : 90;
+  }
+  ASSERT_FALSE(traffic.IsPeriodic());
+  ASSERT_FALSE(traffic.ShouldExitSniff(800));
+
+  uint16_t max = 800;
+  traffic.AdaptSniffInterval(24, &max);
+  ASSERT_EQ(max, 800);
+}
+
+TEST_F(StackAclTest, power_mode_traffic_pause_restarts_prediction) {
+  PowerModeTrafficPredictor traffic;
+  uint64_t now_ms = 1000;
+  for (uint32_t i = 0; i <= PowerModeTrafficPredictor::kMinSamples; i++) {
+    traffic.OnPacket(now_ms);
+    now_ms += 15;
+  }
+  ASSERT_TRUE(traffic.IsPeriodic());
+
+  now_ms += PowerModeTrafficPredictor::kMaxPatternGapMs;
+  traffic.OnPacket(now_ms);
+  ASSERT_FALSE(traffic.IsPeriodic());
+  ASSERT_FALSE(traffic.IsIdle(now_ms));
+  ASSERT_TRUE(traffic.IsIdle(now_ms + PowerModeTrafficPredictor::kIdleMs));
+}
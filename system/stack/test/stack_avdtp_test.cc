@@ -24,6 +24,8 @@
 #include "osi/include/allocator.h"
 #include "stack/avdt/avdt_int.h"
 #include "stack/include/avdt_api.h"
+#include "stack/include/hcidefs.h"
+#include "stack/include/l2cdefs.h"
 #include "stack/test/common/mock_stack_avdt_msg.h"
 #include "types/raw_address.h"
 
@@ -456,3 +458,38 @@ TEST_F(StackAvdtpTest, avdt_scb_hdl_pkt_no_frag_regression_test3) {
   // thus vt_data.p_pkt will be set to nullptr
   ASSERT_EQ(evt_data.p_pkt, nullptr);
 }
+
+void avdt_scb_hdl_write_req(AvdtpScb* p_scb, tAVDT_SCB_EVT* p_data);
+// The media packets allocated with the headroom of all the headers are
+// written as they are, the others are copied into a larger buffer
+TEST_F(StackAvdtpTest, avdt_scb_hdl_write_req_headroom) {
+  AvdtpScb* pscb = avdt_scb_by_hdl(scb_handle_);
+  ASSERT_NE(pscb, nullptr);
+  const uint16_t headroom = L2CAP_PKT_OVERHEAD + HCI_DATA_PREAMBLE_SIZE;
+  tAVDT_SCB_EVT evt_data = {};
+  evt_data.apiwrite.opt = AVDT_DATA_OPT_NO_RTP;
+
+  BT_HDR* p_buf = AVDT_AllocMediaPacket(0);
+  ASSERT_GE(p_buf->offset, headroom);
+  p_buf->len = 10;
+  evt_data.apiwrite.p_buf = p_buf;
+  avdt_scb_hdl_write_req(pscb, &evt_data);
+  ASSERT_EQ(pscb->p_pkt, p_buf);
+  ASSERT_EQ(pscb->media_pkt_count, 1u);
+  ASSERT_EQ(pscb->media_pkt_copy_count, 0u);
+
+  p_buf = (BT_HDR*)osi_malloc(sizeof(BT_HDR) + 10);
+  p_buf->offset = 0;
+  p_buf->len = 10;
+  memset(p_buf + 1, 0x5a, 10);
+  evt_data.apiwrite.p_buf = p_buf;
+  avdt_scb_hdl_write_req(pscb, &evt_data);
+  ASSERT_EQ(pscb->media_pkt_count, 2u);
+  ASSERT_EQ(pscb->media_pkt_copy_count, 1u);
+  ASSERT_GE(pscb->p_pkt->offset, headroom);
+  ASSERT_EQ(pscb->p_pkt->len, 10);
+  uint8_t* p = (uint8_t*)(pscb->p_pkt + 1) + pscb->p_pkt->offset;
+  for (int i = 0; i < 10; i++) ASSERT_EQ(p[i], 0x5a);
+
+  osi_free_and_reset((void**)&pscb->p_pkt);
+}
@@ -17,25 +17,78 @@
 #include <gtest/gtest.h>
 
 #include <cstdint>
+#include <cstring>
 #include <map>
 #include <string>
+#include <vector>
 
+#include "device/include/controller.h"
+#include "stack/include/bt_hdr.h"
 #include "stack/include/btu.h"
 #include "stack/include/hci_error_code.h"
+#include "stack/include/hci_evt_length.h"
 #include "stack/include/hcidefs.h"
 
 std::map<std::string, int> mock_function_count_map;
 
+namespace test {
+namespace mock {
+namespace main_shim_controller {
+extern const controller_t* controller;
+}  // namespace main_shim_controller
+}  // namespace mock
+}  // namespace test
+
 /* Function for test provided by btu_hcif.cc */
 void btu_hcif_hdl_command_status(uint16_t opcode, uint8_t status,
                                  const uint8_t* p_cmd,
                                  void* p_vsc_status_cback);
 
-void LogMsg(uint32_t trace_set_mask, const char* fmt_str, ...) {}
+namespace {
+
+int malformed_event_warnings = 0;
+
+bool supports_ble_packet_extension() { return false; }
+
+}  // namespace
+
+void LogMsg(uint32_t trace_set_mask, const char* fmt_str, ...) {
+  if (strstr(fmt_str, "malformed event") != nullptr) {
+    malformed_event_warnings++;
+  }
+}
 
 class StackBtuTest : public ::testing::Test {
  protected:
-  void SetUp() override { mock_function_count_map.clear(); }
+  void SetUp() override {
+    mock_function_count_map.clear();
+    malformed_event_warnings = 0;
+    btu_trace_level = BT_TRACE_LEVEL_WARNING;
+    controller_.supports_ble_packet_extension = supports_ble_packet_extension;
+    test::mock::main_shim_controller::controller = &controller_;
+  }
+
+  void TearDown() override {
+    test::mock::main_shim_controller::controller = nullptr;
+  }
+
+  // Feeds an LE Meta event carrying |param_len| zeroed parameter bytes after
+  // the Subevent_Code. The buffer ends right after the parameters so that a
+  // handler reading past them is caught by the sanitizers.
+  void ProcessLeMetaEvent(uint8_t sub_code, uint8_t param_len) {
+    const size_t evt_len = 1 + param_len;
+    std::vector<uint8_t> buf(sizeof(BT_HDR) + 2 + evt_len, 0);
+    BT_HDR* p_msg = reinterpret_cast<BT_HDR*>(buf.data());
+    p_msg->len = 2 + evt_len;
+    p_msg->offset = 0;
+    uint8_t* p = reinterpret_cast<uint8_t*>(p_msg + 1);
+    p[0] = HCI_BLE_EVENT;
+    p[1] = evt_len;
+    p[2] = sub_code;
+    btu_hcif_process_event(0, p_msg);
+  }
+
+  controller_t controller_{};
 };
 
 TEST_F(StackBtuTest, post_on_main) {}
@@ -46,3 +99,42 @@ TEST_F(StackBtuTest, btm_sco_connection_failed_called) {
       HCI_SETUP_ESCO_CONNECTION, HCI_ERR_UNSPECIFIED, p_cmd, nullptr);
   ASSERT_EQ(1, mock_function_count_map["btm_sco_connection_failed"]);
 }
+
+TEST_F(StackBtuTest, le_meta_event_minimum_length) {
+  for (uint8_t sub_code = 0;
+       sub_code < sizeof(hci_le_subevent_parameters_minimum_length);
+       sub_code++) {
+    const uint8_t min_len = hci_le_subevent_parameters_minimum_length[sub_code];
+
+    malformed_event_warnings = 0;
+    ProcessLeMetaEvent(sub_code, min_len);
+    ASSERT_EQ(0, malformed_event_warnings)
+        << "sub_code:" << +sub_code << " rejected at its minimum length";
+
+    if (min_len == 0) continue;
+
+    mock_function_count_map.clear();
+    ProcessLeMetaEvent(sub_code, min_len - 1);
+    ASSERT_EQ(1, malformed_event_warnings)
+        << "sub_code:" << +sub_code << " accepted below its minimum length";
+    ASSERT_TRUE(mock_function_count_map.empty())
+        << "sub_code:" << +sub_code << " dispatched below its minimum length";
+  }
+}
+
+TEST_F(StackBtuTest, le_meta_event_minimum_length_dispatched) {
+  ProcessLeMetaEvent(HCI_BLE_ADV_PKT_RPT_EVT,
+                     hci_le_subevent_parameters_minimum_length
+                         [HCI_BLE_ADV_PKT_RPT_EVT]);
+  ASSERT_EQ(1, mock_function_count_map["btm_ble_process_adv_pkt"]);
+
+  ProcessLeMetaEvent(HCI_BLE_LL_CONN_PARAM_UPD_EVT,
+                     hci_le_subevent_parameters_minimum_length
+                         [HCI_BLE_LL_CONN_PARAM_UPD_EVT]);
+  ASSERT_EQ(1, mock_function_count_map["acl_ble_update_event_received"]);
+
+  ProcessLeMetaEvent(HCI_BLE_LTK_REQ_EVT,
+                     hci_le_subevent_parameters_minimum_length
+                         [HCI_BLE_LTK_REQ_EVT]);
+  ASSERT_EQ(1, mock_function_count_map["btm_ble_ltk_request"]);
+}
@@ -17,9 +17,16 @@
 #include <gtest/gtest.h>
 
 #include "common/init_flags.h"
+#include "internal_include/bt_target.h"
 #include "internal_include/bt_trace.h"
+#include "osi/include/allocator.h"
+#include "osi/include/fixed_queue.h"
 #include "stack/btm/btm_int_types.h"
+#include "stack/include/bt_hdr.h"
+#include "stack/include/bt_types.h"
+#include "stack/include/hcidefs.h"
 #include "stack/include/l2cap_hci_link_interface.h"
+#include "stack/l2cap/l2c_ble_throughput.h"
 #include "stack/l2cap/l2c_int.h"
 #include "types/raw_address.h"
 
@@ -65,3 +72,174 @@ TEST_F(StackL2capTest, l2cble_process_data_length_change_event) {
   l2cble_process_data_length_change_event(0x1234, 0x001b, 0x001b);
   ASSERT_EQ(0x001b, l2cb.lcb_pool[0].tx_data_len);
 }
+
+TEST_F(StackL2capTest, l2cu_find_lcb_by_handle) {
+  l2cb.lcb_pool[0].in_use = true;
+  l2cb.lcb_pool[1].in_use = true;
+  l2cu_set_lcb_handle(l2cb.lcb_pool[0], 0x0001);
+  l2cu_set_lcb_handle(l2cb.lcb_pool[1], 0x0002);
+
+  ASSERT_EQ(&l2cb.lcb_pool[0], l2cu_find_lcb_by_handle(0x0001));
+  ASSERT_EQ(&l2cb.lcb_pool[1], l2cu_find_lcb_by_handle(0x0002));
+  ASSERT_EQ(nullptr, l2cu_find_lcb_by_handle(0x0003));
+
+  // Released link is not returned
+  l2cb.lcb_pool[0].in_use = false;
+  ASSERT_EQ(nullptr, l2cu_find_lcb_by_handle(0x0001));
+
+  // Handle reused by another link
+  l2cu_set_lcb_handle(l2cb.lcb_pool[1], 0x0001);
+  ASSERT_EQ(&l2cb.lcb_pool[1], l2cu_find_lcb_by_handle(0x0001));
+  ASSERT_EQ(nullptr, l2cu_find_lcb_by_handle(0x0002));
+
+  // Handle outside the indexed range is still found
+  l2cb.lcb_pool[0].in_use = true;
+  l2cu_set_lcb_handle(l2cb.lcb_pool[0], 0x1234);
+  ASSERT_EQ(&l2cb.lcb_pool[0], l2cu_find_lcb_by_handle(0x1234));
+}
+
+TEST_F(StackL2capTest, l2c_lcc_get_next_xmit_sdu_seg) {
+  tL2C_CCB& ccb = l2cb.ccb_pool[0];
+  ccb.local_cid = 0x0040;
+  ccb.remote_cid = 0x0041;
+  ccb.peer_conn_cfg.mps = 104;
+  ccb.xmit_hold_q = fixed_queue_new(SIZE_MAX);
+
+  constexpr uint16_t kSduLen = 250;
+  BT_HDR* p_sdu = (BT_HDR*)osi_malloc(BT_HDR_SIZE + L2CAP_MIN_OFFSET + kSduLen);
+  p_sdu->offset = L2CAP_MIN_OFFSET;
+  p_sdu->len = kSduLen;
+  p_sdu->event = 0;
+  uint8_t* data = (uint8_t*)(p_sdu + 1) + p_sdu->offset;
+  for (uint16_t i = 0; i < kSduLen; i++) data[i] = i;
+  fixed_queue_enqueue(ccb.xmit_hold_q, p_sdu);
+
+  // The SDU goes in 98 + 100 + 52 bytes, the last piece from the SDU buffer
+  const uint16_t payloads[] = {98, 100, 52};
+  uint16_t sent = 0;
+  for (size_t i = 0; i < 3; i++) {
+    bool last_piece_of_sdu = false;
+    BT_HDR* p_buf = l2c_lcc_get_next_xmit_sdu_seg(&ccb, &last_piece_of_sdu);
+    ASSERT_NE(nullptr, p_buf);
+    ASSERT_EQ(i == 2, last_piece_of_sdu);
+    ASSERT_EQ(i == 2, p_buf == p_sdu);
+    ASSERT_GE(p_buf->offset, HCI_DATA_PREAMBLE_SIZE);
+
+    uint8_t* p = (uint8_t*)(p_buf + 1) + p_buf->offset;
+    uint16_t length, cid;
+    STREAM_TO_UINT16(length, p);
+    STREAM_TO_UINT16(cid, p);
+    ASSERT_EQ(0x0041, cid);
+    ASSERT_EQ(p_buf->len, length + L2CAP_PKT_OVERHEAD);
+    if (i == 0) {
+      uint16_t sdu_len;
+      STREAM_TO_UINT16(sdu_len, p);
+      ASSERT_EQ(kSduLen, sdu_len);
+      length -= L2CAP_LCC_SDU_LENGTH;
+    }
+    ASSERT_EQ(payloads[i], length);
+    for (uint16_t j = 0; j < length; j++) {
+      ASSERT_EQ((uint8_t)(sent + j), p[j]);
+    }
+    sent += length;
+    osi_free(p_buf);
+  }
+  ASSERT_TRUE(fixed_queue_is_empty(ccb.xmit_hold_q));
+  ASSERT_EQ(3u, ccb.lcc_stats.tx_pdus);
+  ASSERT_EQ(2u, ccb.lcc_stats.tx_pdus_copied);
+
+  // Without room for the headers in front, the SDU is copied
+  p_sdu = (BT_HDR*)osi_malloc(BT_HDR_SIZE + 20);
+  p_sdu->offset = 0;
+  p_sdu->len = 20;
+  p_sdu->event = 0;
+  fixed_queue_enqueue(ccb.xmit_hold_q, p_sdu);
+  BT_HDR* p_buf = l2c_lcc_get_next_xmit_sdu_seg(&ccb, nullptr);
+  ASSERT_NE(p_sdu, p_buf);
+  ASSERT_EQ(20 + L2CAP_LCC_SDU_LENGTH + L2CAP_PKT_OVERHEAD, p_buf->len);
+  ASSERT_EQ(3u, ccb.lcc_stats.tx_pdus_copied);
+  ASSERT_TRUE(fixed_queue_is_empty(ccb.xmit_hold_q));
+  osi_free(p_buf);
+
+  fixed_queue_free(ccb.xmit_hold_q, osi_free);
+}
+
+TEST_F(StackL2capTest, l2c_fcr_is_flow_controlled) {
+  tL2C_CCB& ccb = l2cb.ccb_pool[0];
+  ccb.peer_cfg.fcr.mode = L2CAP_FCR_ERTM_MODE;
+  ccb.peer_cfg.fcr.tx_win_sz = 10;
+  ccb.fcrb.waiting_for_ack_q = fixed_queue_new(SIZE_MAX);
+  ASSERT_FALSE(l2c_fcr_is_flow_controlled(&ccb));
+
+  // Few frames but too many bytes waiting for ack
+  ccb.fcrb.waiting_for_ack_bytes = L2CAP_FCR_TX_BUDGET;
+  ASSERT_TRUE(l2c_fcr_is_flow_controlled(&ccb));
+  ccb.fcrb.waiting_for_ack_bytes = L2CAP_FCR_TX_BUDGET - 1;
+  ASSERT_FALSE(l2c_fcr_is_flow_controlled(&ccb));
+
+  ccb.fcrb.remote_busy = true;
+  ASSERT_TRUE(l2c_fcr_is_flow_controlled(&ccb));
+
+  fixed_queue_free(ccb.fcrb.waiting_for_ack_q, nullptr);
+}
+
+TEST_F(StackL2capTest, l2c_ble_throughput_upgrade_and_relax) {
+  L2cBleThroughputMonitor monitor;
+  using Decision = L2cBleThroughputMonitor::Decision;
+
+  uint64_t now_ms = 1000;
+  ASSERT_EQ(Decision::NONE, monitor.Evaluate(now_ms, 0));
+
+  // 20kB within a window
+  for (int i = 0; i < 100; i++) {
+    monitor.OnDataSent(now_ms, 200);
+    ASSERT_EQ(Decision::NONE, monitor.Evaluate(now_ms, 0));
+    now_ms += 5;
+  }
+  now_ms = 1000 + L2cBleThroughputMonitor::kWindowMs;
+  ASSERT_EQ(Decision::UPGRADE, monitor.Evaluate(now_ms, 0));
+  ASSERT_TRUE(monitor.IsBulk());
+
+  // Still bulk with a few idle windows
+  for (uint32_t i = 1; i < L2cBleThroughputMonitor::kRelaxWindows; i++) {
+    now_ms += L2cBleThroughputMonitor::kWindowMs;
+    ASSERT_EQ(Decision::NONE, monitor.Evaluate(now_ms, 0));
+  }
+  // Queued packets keep the link bulk
+  now_ms += L2cBleThroughputMonitor::kWindowMs;
+  ASSERT_EQ(Decision::NONE, monitor.Evaluate(now_ms, 1));
+
+  for (uint32_t i = 1; i < L2cBleThroughputMonitor::kRelaxWindows; i++) {
+    now_ms += L2cBleThroughputMonitor::kWindowMs;
+    ASSERT_EQ(Decision::NONE, monitor.Evaluate(now_ms, 0));
+  }
+  now_ms += L2cBleThroughputMonitor::kWindowMs;
+  ASSERT_EQ(Decision::RELAX, monitor.Evaluate(now_ms, 0));
+  ASSERT_FALSE(monitor.IsBulk());
+  ASSERT_EQ(0u, monitor.GetThroughput());
+}
+
+TEST_F(StackL2capTest, l2c_ble_throughput_queue_depth) {
+  L2cBleThroughputMonitor monitor;
+  using Decision = L2cBleThroughputMonitor::Decision;
+
+  ASSERT_EQ(Decision::NONE,
+            monitor.Evaluate(0, L2cBleThroughputMonitor::kBulkQueueDepth - 1));
+  ASSERT_EQ(Decision::UPGRADE,
+            monitor.Evaluate(1, L2cBleThroughputMonitor::kBulkQueueDepth));
+  ASSERT_EQ(Decision::NONE,
+            monitor.Evaluate(2, L2cBleThroughputMonitor::kBulkQueueDepth));
+}
+
+TEST_F(StackL2capTest, l2c_ble_throughput_sparse_traffic) {
+  L2cBleThroughputMonitor monitor;
+  using Decision = L2cBleThroughputMonitor::Decision;
+
+  // 20kB spread over 10 seconds are not bulk
+  uint64_t now_ms = 0;
+  monitor.OnDataSent(now_ms, 20 * 1024);
+  now_ms += 10 * L2cBleThroughputMonitor::kWindowMs;
+  ASSERT_EQ(Decision::NONE, monitor.Evaluate(now_ms, 0));
+  ASSERT_EQ(2048u, monitor.GetThroughput());
+  ASSERT_FALSE(monitor.IsBulk());
+}
@@ -409,4 +409,49 @@ TEST(SmpEccValidationTest, test_invalid_points) {
 
   EXPECT_FALSE(ECC_ValidatePoint(p));
 }
+
+// Test ECC point multiplication
+TEST(SmpEccValidationTest, test_point_mult) {
+  // Test data from Bluetooth Core Specification
+  // Version 5.0 | Vol 2, Part G | 7.1.2, Sample 1
+  uint32_t private_a[KEY_LENGTH_DWORDS_P256] = {
+      0xcd3c1abd, 0x5899b8a6, 0xeb40b799, 0x4aff607b,
+      0xd2103f50, 0x74c9b3e3, 0xa3c55f38, 0x3f49f6d4};
+  uint32_t public_a_x[KEY_LENGTH_DWORDS_P256] = {
+      0x0e359de6, 0xcc030148, 0xacf4fddb, 0xeff49111,
+      0xe9f9a5b9, 0x5e2c83a7, 0xf297be2c, 0x20b003d2};
+  uint32_t public_a_y[KEY_LENGTH_DWORDS_P256] = {
+      0x1589d28b, 0x741c8ed0, 0x8fed3024, 0x766345c2,
+      0x5a52155c, 0x63329abf, 0x652aeb6d, 0xdc809c49};
+  Point public_b = {
+      .x = {0x2faaa190, 0x559077b2, 0x8615a69f, 0x47b58afd, 0xf19e4c00,
+            0x09592284, 0x1faf1d96, 0x1ea1f0f0},
+      .y = {0x15b1214a, 0x5f89aff9, 0xe28e3676, 0x472d1130, 0x9ab85160,
+            0x7356703a, 0x429dad37, 0x4c55f33e},
+  };
+  uint32_t dhkey[KEY_LENGTH_DWORDS_P256] = {
+      0x73bfa698, 0x868d34f3, 0xb4f866f1, 0x99796b13,
+      0x0a397d9b, 0x341010a6, 0x57c8ad05, 0xec0234a3};
+
+  p_256_init_curve();
+
+  Point public_a;
+  uint32_t k[KEY_LENGTH_DWORDS_P256];
+  memcpy(k, private_a, sizeof(k));
+  ECC_PointMult(&public_a, &(curve_p256.G), k);
+  EXPECT_EQ(memcmp(public_a.x, public_a_x, sizeof(public_a_x)), 0);
+  EXPECT_EQ(memcmp(public_a.y, public_a_y, sizeof(public_a_y)), 0);
+
+  Point dh;
+  memcpy(k, private_a, sizeof(k));
+  ECC_PointMult(&dh, &public_b, k);
+  EXPECT_EQ(memcmp(dh.x, dhkey, sizeof(dhkey)), 0);
+
+  // Same result as the generic implementation
+  Point expected;
+  memcpy(k, private_a, sizeof(k));
+  ECC_PointMult_Bin_NAF(&expected, &public_b, k);
+  EXPECT_EQ(memcmp(dh.x, expected.x, sizeof(dh.x)), 0);
+  EXPECT_EQ(memcmp(dh.y, expected.y, sizeof(dh.y)), 0);
+}
 }  // namespace testing
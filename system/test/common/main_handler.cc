@@ -52,6 +52,14 @@ bt_status_t do_in_main_thread_delayed(const base::Location& from_here,
   return BT_STATUS_SUCCESS;
 }
 
+bt_status_t do_in_main_thread_with_priority(
+    const base::Location& from_here, base::OnceClosure task,
+    MessageLoopThread::Priority priority) {
+  ASSERT_LOG(main_thread.DoInThread(from_here, std::move(task), priority),
+             "Unable to run on main thread with priority");
+  return BT_STATUS_SUCCESS;
+}
+
 void post_on_bt_main(BtMainClosure closure) {
   ASSERT(do_in_main_thread(
              FROM_HERE, base::Bind(do_post_on_bt_main, std::move(closure))) ==
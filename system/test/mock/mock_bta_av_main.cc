@@ -70,6 +70,11 @@ int BTA_AvObtainPeerChannelIndex(const RawAddress& peer_address) {
   mock_function_count_map[__func__]++;
   return 0;
 }
+bool BTA_AvGetStreamLinkState(const RawAddress& peer_address, bool* p_congested,
+                              uint8_t* p_l2c_bufs) {
+  mock_function_count_map[__func__]++;
+  return false;
+}
 tBTA_AV_SCB* bta_av_addr_to_scb(const RawAddress& bd_addr) {
   mock_function_count_map[__func__]++;
   return nullptr;
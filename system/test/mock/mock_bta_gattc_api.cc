@@ -136,7 +136,8 @@ void BTA_GATTC_ReadCharacteristic(uint16_t conn_id, uint16_t handle,
   mock_function_count_map[__func__]++;
 }
 void BTA_GATTC_ReadMultiple(uint16_t conn_id, tBTA_GATTC_MULTI* p_read_multi,
-                            tGATT_AUTH_REQ auth_req) {
+                            bool variable_len, tGATT_AUTH_REQ auth_req,
+                            GATT_READ_MULTI_OP_CB callback, void* cb_data) {
   mock_function_count_map[__func__]++;
 }
 void BTA_GATTC_ReadUsingCharUuid(uint16_t conn_id, const bluetooth::Uuid& uuid,
@@ -155,6 +156,9 @@ void BTA_GATTC_ServiceSearchRequest(uint16_t conn_id,
                                     const bluetooth::Uuid* p_srvc_uuid) {
   mock_function_count_map[__func__]++;
 }
+void BTA_GATTC_WarmupCache(std::vector<RawAddress> bonded_devices) {
+  mock_function_count_map[__func__]++;
+}
 void BTA_GATTC_WriteCharDescr(uint16_t conn_id, uint16_t handle,
                               std::vector<uint8_t> value,
                               tGATT_AUTH_REQ auth_req,
@@ -168,3 +172,6 @@ void BTA_GATTC_WriteCharValue(uint16_t conn_id, uint16_t handle,
                               GATT_WRITE_OP_CB callback, void* cb_data) {
   mock_function_count_map[__func__]++;
 }
+void bta_debug_gattc_cache_dump(int fd) {
+  mock_function_count_map[__func__]++;
+}
@@ -66,6 +66,8 @@ struct btif_config_remove btif_config_remove;
 struct btif_config_save btif_config_save;
 struct btif_config_flush btif_config_flush;
 struct btif_config_clear btif_config_clear;
+struct btif_config_get_persistent_generation
+    btif_config_get_persistent_generation;
 struct btif_debug_config_dump btif_debug_config_dump;
 
 }  // namespace btif_config
@@ -129,6 +131,10 @@ std::vector<RawAddress> btif_config_get_paired_devices() {
   mock_function_count_map[__func__]++;
   return test::mock::btif_config::btif_config_get_paired_devices();
 }
+uint64_t btif_config_get_persistent_generation(void) {
+  mock_function_count_map[__func__]++;
+  return test::mock::btif_config::btif_config_get_persistent_generation();
+}
 bool btif_config_remove(const std::string& section, const std::string& key) {
   mock_function_count_map[__func__]++;
   return test::mock::btif_config::btif_config_remove(section, key);
@@ -228,6 +228,15 @@ struct btif_config_clear {
   bool operator()(void) { return body(); };
 };
 extern struct btif_config_clear btif_config_clear;
+// Name: btif_config_get_persistent_generation
+// Params: void
+// Returns: uint64_t
+struct btif_config_get_persistent_generation {
+  std::function<uint64_t(void)> body{[](void) { return 0; }};
+  uint64_t operator()(void) { return body(); };
+};
+extern struct btif_config_get_persistent_generation
+    btif_config_get_persistent_generation;
 // Name: btif_debug_config_dump
 // Params: int fd
 // Returns: void
@@ -98,6 +98,13 @@ bt_status_t do_in_jni_thread(const base::Location& from_here,
   do_in_jni_thread_task_queue.push(std::move(task));
   return BT_STATUS_SUCCESS;
 }
+bt_status_t do_in_jni_thread_delayed(const base::Location& from_here,
+                                     base::OnceClosure task,
+                                     const base::TimeDelta& delay) {
+  mock_function_count_map[__func__]++;
+  do_in_jni_thread_task_queue.push(std::move(task));
+  return BT_STATUS_SUCCESS;
+}
 btbase::AbstractMessageLoop* get_jni_message_loop() {
   mock_function_count_map[__func__]++;
   return nullptr;
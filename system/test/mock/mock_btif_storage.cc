@@ -22,6 +22,7 @@
 #include <cstdint>
 #include <map>
 #include <string>
+#include <vector>
 
 extern std::map<std::string, int> mock_function_count_map;
 
@@ -243,3 +244,23 @@ void btif_storage_load_bonded_csis_devices() {
 void btif_storage_remove_csis_device(const RawAddress& address) {
   mock_function_count_map[__func__]++;
 }
+void btif_storage_set_a2dp_sep_caps(const RawAddress& bd_addr,
+                                    std::vector<uint8_t> caps) {
+  mock_function_count_map[__func__]++;
+}
+std::vector<uint8_t> btif_storage_get_a2dp_sep_caps(const RawAddress& bd_addr) {
+  mock_function_count_map[__func__]++;
+  return {};
+}
+void btif_storage_remove_a2dp_sep_caps(const RawAddress& bd_addr) {
+  mock_function_count_map[__func__]++;
+}
+void btif_storage_set_hfp_msbc_settings(const RawAddress& bd_addr,
+                                        uint8_t settings) {
+  mock_function_count_map[__func__]++;
+}
+bool btif_storage_get_hfp_msbc_settings(const RawAddress& bd_addr,
+                                        uint8_t* settings) {
+  mock_function_count_map[__func__]++;
+  return false;
+}
@@ -80,6 +80,18 @@ bool MessageLoopThread::DoInThread(const base::Location& from_here,
   return DoInThreadDelayed(from_here, std::move(task), base::TimeDelta());
 }
 
+bool MessageLoopThread::DoInThread(const base::Location& from_here,
+                                   base::OnceClosure task, Priority priority) {
+  return DoInThreadDelayed(from_here, std::move(task), base::TimeDelta());
+}
+
+bool MessageLoopThread::DoInThreadDelayed(const base::Location& from_here,
+                                          base::OnceClosure task,
+                                          const base::TimeDelta& delay,
+                                          Priority priority) {
+  return DoInThreadDelayed(from_here, std::move(task), delay);
+}
+
 bool MessageLoopThread::DoInThreadDelayed(const base::Location& from_here,
                                           base::OnceClosure task,
                                           const base::TimeDelta& delay) {
@@ -208,6 +220,11 @@ bool MessageLoopThread::EnableRealTimeScheduling() {
   return true;
 }
 
+void MessageLoopThread::EnableTaskStats(
+    std::chrono::milliseconds queueing_delay_alarm) {}
+
+void MessageLoopThread::DumpTaskStats(int fd) const {}
+
 base::WeakPtr<MessageLoopThread> MessageLoopThread::GetWeakPtr() {
   std::lock_guard<std::recursive_mutex> api_lock(api_mutex_);
   return weak_ptr_factory_.GetWeakPtr();
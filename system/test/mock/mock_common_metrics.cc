@@ -219,5 +219,10 @@ void LogLeAudioConnectionSessionReported(
   mock_function_count_map[__func__]++;
 }
 
+void LogBluetoothStartupPhase(int32_t phase_type, const std::string& phase_name,
+                              int64_t offset_nanos, int64_t duration_nanos) {
+  mock_function_count_map[__func__]++;
+}
+
 }  // namespace common
 }  // namespace bluetooth
@@ -85,6 +85,10 @@ std::vector<std::string>
 bluetooth::shim::BtifConfigInterface::GetPersistentDevices() {
   return std::vector<std::string>();
 }
+uint64_t bluetooth::shim::BtifConfigInterface::GetPersistentGeneration() {
+  return 0;
+}
+void bluetooth::shim::BtifConfigInterface::DumpTemporaryDevices(int fd) {}
 void bluetooth::shim::BtifConfigInterface::
     ConvertEncryptOrDecryptKeyIfNeeded(){};
 void bluetooth::shim::BtifConfigInterface::Save(){};
@@ -31,9 +31,18 @@ extern std::map<std::string, int> mock_function_count_map;
 #define UNUSED_ATTR
 #endif
 
+namespace test {
+namespace mock {
+namespace main_shim_controller {
+// Returned by controller_get_interface(); tests may point it at a fake
+const controller_t* controller = nullptr;
+}  // namespace main_shim_controller
+}  // namespace mock
+}  // namespace test
+
 const controller_t* bluetooth::shim::controller_get_interface() {
   mock_function_count_map[__func__]++;
-  return nullptr;
+  return test::mock::main_shim_controller::controller;
 }
 
 void bluetooth::shim::controller_clear_event_mask() {
@@ -31,8 +31,21 @@ extern std::map<std::string, int> mock_function_count_map;
 // Mock include file to share data between tests and mock
 #include "test/mock/mock_main_shim_hci_layer.h"
 
+#include "main/shim/hci_command.h"
+
 // Mocked internal structures, if any
 
 const hci_t* bluetooth::shim::hci_layer_get_interface() { return nullptr; }
 
+void bluetooth::shim::hci_layer_transmit_command(
+    std::unique_ptr<LegacyCommandBuilder> command,
+    command_complete_cb complete_callback, command_status_cb status_callback,
+    void* context) {
+  mock_function_count_map[__func__]++;
+}
+
+bluetooth::shim::HciCommandBatch::HciCommandBatch() {}
+
+bluetooth::shim::HciCommandBatch::~HciCommandBatch() {}
+
 // bool hci_is_root_inflammation_event_received() { return false; }
@@ -41,7 +41,10 @@ namespace osi_allocation_tracker {
 struct allocation_tracker_expect_no_allocations
     allocation_tracker_expect_no_allocations;
 struct allocation_tracker_init allocation_tracker_init;
+struct allocation_tracker_init_sampling allocation_tracker_init_sampling;
 struct allocation_tracker_notify_alloc allocation_tracker_notify_alloc;
+struct allocation_tracker_notify_alloc_from
+    allocation_tracker_notify_alloc_from;
 struct allocation_tracker_notify_free allocation_tracker_notify_free;
 struct allocation_tracker_reset allocation_tracker_reset;
 struct allocation_tracker_resize_for_canary
@@ -63,12 +66,24 @@ void allocation_tracker_init(void) {
   mock_function_count_map[__func__]++;
   test::mock::osi_allocation_tracker::allocation_tracker_init();
 }
+void allocation_tracker_init_sampling(size_t interval) {
+  mock_function_count_map[__func__]++;
+  test::mock::osi_allocation_tracker::allocation_tracker_init_sampling(interval);
+}
 void* allocation_tracker_notify_alloc(uint8_t allocator_id, void* ptr,
                                       size_t requested_size) {
   mock_function_count_map[__func__]++;
   return test::mock::osi_allocation_tracker::allocation_tracker_notify_alloc(
       allocator_id, ptr, requested_size);
 }
+void* allocation_tracker_notify_alloc_from(uint8_t allocator_id, void* ptr,
+                                           size_t requested_size,
+                                           const void* call_site) {
+  mock_function_count_map[__func__]++;
+  return test::mock::osi_allocation_tracker::
+      allocation_tracker_notify_alloc_from(allocator_id, ptr, requested_size,
+                                           call_site);
+}
 void* allocation_tracker_notify_free(uint8_t allocator_id, void* ptr) {
   mock_function_count_map[__func__]++;
   return test::mock::osi_allocation_tracker::allocation_tracker_notify_free(
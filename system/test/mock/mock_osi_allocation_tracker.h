@@ -74,6 +74,15 @@ struct allocation_tracker_init {
 };
 extern struct allocation_tracker_init allocation_tracker_init;
 
+// Name: allocation_tracker_init_sampling
+// Params: size_t interval
+// Return: void
+struct allocation_tracker_init_sampling {
+  std::function<void(size_t interval)> body{[](size_t interval) {}};
+  void operator()(size_t interval) { body(interval); };
+};
+extern struct allocation_tracker_init_sampling allocation_tracker_init_sampling;
+
 // Name: allocation_tracker_notify_alloc
 // Params: uint8_t allocator_id, void* ptr, size_t requested_size
 // Return: void*
@@ -89,6 +98,24 @@ struct allocation_tracker_notify_alloc {
 };
 extern struct allocation_tracker_notify_alloc allocation_tracker_notify_alloc;
 
+// Name: allocation_tracker_notify_alloc_from
+// Params: uint8_t allocator_id, void* ptr, size_t requested_size, const void*
+// call_site
+// Return: void*
+struct allocation_tracker_notify_alloc_from {
+  void* return_value{};
+  std::function<void*(uint8_t allocator_id, void* ptr, size_t requested_size,
+                      const void* call_site)>
+      body{[this](uint8_t allocator_id, void* ptr, size_t requested_size,
+                  const void* call_site) { return return_value; }};
+  void* operator()(uint8_t allocator_id, void* ptr, size_t requested_size,
+                   const void* call_site) {
+    return body(allocator_id, ptr, requested_size, call_site);
+  };
+};
+extern struct allocation_tracker_notify_alloc_from
+    allocation_tracker_notify_alloc_from;
+
 // Name: allocation_tracker_notify_free
 // Params:  uint8_t allocator_id, void* ptr
 // Return: void*
@@ -38,6 +38,7 @@ namespace mock {
 namespace osi_allocator {
 
 // Function state capture and return values, if needed
+struct osi_allocator_pool_debug_dump osi_allocator_pool_debug_dump;
 struct osi_calloc osi_calloc;
 struct osi_free osi_free;
 struct osi_free_and_reset osi_free_and_reset;
@@ -50,6 +51,10 @@ struct osi_strndup osi_strndup;
 }  // namespace test
 
 // Mocked functions, if any
+void osi_allocator_pool_debug_dump(int fd) {
+  mock_function_count_map[__func__]++;
+  test::mock::osi_allocator::osi_allocator_pool_debug_dump(fd);
+}
 void* osi_calloc(size_t size) {
   mock_function_count_map[__func__]++;
   return test::mock::osi_allocator::osi_calloc(size);
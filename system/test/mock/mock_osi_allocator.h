@@ -69,6 +69,15 @@ struct osi_free {
 };
 extern struct osi_free osi_free;
 
+// Name: osi_allocator_pool_debug_dump
+// Params: int fd
+// Return: void
+struct osi_allocator_pool_debug_dump {
+  std::function<void(int fd)> body{[](int fd) {}};
+  void operator()(int fd) { body(fd); };
+};
+extern struct osi_allocator_pool_debug_dump osi_allocator_pool_debug_dump;
+
 // Name: osi_free_and_reset
 // Params: void** p_ptr
 // Return: void
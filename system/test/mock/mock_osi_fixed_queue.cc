@@ -49,6 +49,7 @@ struct fixed_queue_get_list fixed_queue_get_list;
 struct fixed_queue_is_empty fixed_queue_is_empty;
 struct fixed_queue_length fixed_queue_length;
 struct fixed_queue_new fixed_queue_new;
+struct fixed_queue_new_spsc fixed_queue_new_spsc;
 struct fixed_queue_register_dequeue fixed_queue_register_dequeue;
 struct fixed_queue_try_dequeue fixed_queue_try_dequeue;
 struct fixed_queue_try_enqueue fixed_queue_try_enqueue;
@@ -106,6 +107,10 @@ fixed_queue_t* fixed_queue_new(size_t capacity) {
   mock_function_count_map[__func__]++;
   return test::mock::osi_fixed_queue::fixed_queue_new(capacity);
 }
+fixed_queue_t* fixed_queue_new_spsc(size_t capacity) {
+  mock_function_count_map[__func__]++;
+  return test::mock::osi_fixed_queue::fixed_queue_new_spsc(capacity);
+}
 void fixed_queue_register_dequeue(fixed_queue_t* queue, reactor_t* reactor,
                                   fixed_queue_cb ready_cb, void* context) {
   mock_function_count_map[__func__]++;
@@ -16,7 +16,7 @@
 
 /*
  * Generated mock file from original source file
- *   Functions generated:17
+ *   Functions generated:18
  */
 
 #include <map>
@@ -87,6 +87,9 @@ void btm_pm_on_sniff_subrating(tHCI_STATUS status, uint16_t handle,
                                uint16_t minimum_local_timeout) {
   mock_function_count_map[__func__]++;
 }
+void btm_pm_on_acl_traffic(uint16_t handle) {
+  mock_function_count_map[__func__]++;
+}
 void btm_pm_proc_cmd_status(tHCI_STATUS status) {
   mock_function_count_map[__func__]++;
 }
@@ -114,6 +114,22 @@ struct btm_ble_resolve_random_addr {
   };
 };
 extern struct btm_ble_resolve_random_addr btm_ble_resolve_random_addr;
+// Name: btm_ble_resolve_cache_clear
+// Params:
+// Returns: void
+struct btm_ble_resolve_cache_clear {
+  std::function<void()> body{[]() {}};
+  void operator()() { body(); };
+};
+extern struct btm_ble_resolve_cache_clear btm_ble_resolve_cache_clear;
+// Name: btm_ble_resolve_cache_dump
+// Params: int fd
+// Returns: void
+struct btm_ble_resolve_cache_dump {
+  std::function<void(int fd)> body{[](int fd) {}};
+  void operator()(int fd) { body(fd); };
+};
+extern struct btm_ble_resolve_cache_dump btm_ble_resolve_cache_dump;
 // Name: btm_identity_addr_to_random_pseudo
 // Params: RawAddress* bd_addr, uint8_t* p_addr_type, bool refresh
 // Returns: bool
@@ -122,6 +122,9 @@ tINQ_DB_ENT* btm_inq_db_new(const RawAddress& p_bda) {
   mock_function_count_map[__func__]++;
   return nullptr;
 }
+void btm_inq_db_remove(tINQ_DB_ENT* p_ent) {
+  mock_function_count_map[__func__]++;
+}
 uint16_t BTM_IsInquiryActive(void) {
   mock_function_count_map[__func__]++;
   return 0;
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Generated mock file from original source file
+ *   Functions generated:9
+ */
+
+#include <map>
+#include <string>
+
+extern std::map<std::string, int> mock_function_count_map;
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "stack/btm/btm_log_history_buffer.h"
+
+#ifndef UNUSED_ATTR
+#define UNUSED_ATTR
+#endif
+
+std::string_view BtmLogHistoryBuffer::Entry::Tag() const {
+  mock_function_count_map[__func__]++;
+  return std::string_view();
+}
+std::string_view BtmLogHistoryBuffer::Entry::Msg() const {
+  mock_function_count_map[__func__]++;
+  return std::string_view();
+}
+std::string_view BtmLogHistoryBuffer::Entry::Extra() const {
+  mock_function_count_map[__func__]++;
+  return std::string_view();
+}
+std::string BtmLogHistoryBuffer::Entry::ToString() const {
+  mock_function_count_map[__func__]++;
+  return std::string();
+}
+BtmLogHistoryBuffer::BtmLogHistoryBuffer(size_t size) : size_(size) {
+  mock_function_count_map[__func__]++;
+}
+void BtmLogHistoryBuffer::Push(std::string_view tag, const RawAddress& addr,
+                               std::string_view msg, std::string_view extra) {
+  mock_function_count_map[__func__]++;
+}
+void BtmLogHistoryBuffer::Push(std::string_view tag, const tBLE_BD_ADDR& addr,
+                               std::string_view msg, std::string_view extra) {
+  mock_function_count_map[__func__]++;
+}
+void BtmLogHistoryBuffer::Push(std::string_view text) {
+  mock_function_count_map[__func__]++;
+}
+std::vector<BtmLogHistoryBuffer::Entry> BtmLogHistoryBuffer::Pull(
+    uint64_t* next, size_t max_entries) const {
+  mock_function_count_map[__func__]++;
+  return std::vector<Entry>();
+}
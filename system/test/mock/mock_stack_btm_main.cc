@@ -26,6 +26,7 @@ extern std::map<std::string, int> mock_function_count_map;
 
 #include <memory>
 #include <string>
+#include <string_view>
 
 #include "bt_target.h"
 #include "main/shim/dumpsys.h"
@@ -38,20 +39,20 @@ extern std::map<std::string, int> mock_function_count_map;
 #define UNUSED_ATTR
 #endif
 
-void BTM_LogHistory(const std::string& tag, const RawAddress& bd_addr,
-                    const std::string& msg) {
+void BTM_LogHistory(std::string_view tag, const RawAddress& bd_addr,
+                    std::string_view msg) {
   mock_function_count_map[__func__]++;
 }
-void BTM_LogHistory(const std::string& tag, const RawAddress& bd_addr,
-                    const std::string& msg, const std::string& extra) {
+void BTM_LogHistory(std::string_view tag, const RawAddress& bd_addr,
+                    std::string_view msg, std::string_view extra) {
   mock_function_count_map[__func__]++;
 }
-void BTM_LogHistory(const std::string& tag, const tBLE_BD_ADDR& ble_bd_addr,
-                    const std::string& msg) {
+void BTM_LogHistory(std::string_view tag, const tBLE_BD_ADDR& ble_bd_addr,
+                    std::string_view msg) {
   mock_function_count_map[__func__]++;
 }
-void BTM_LogHistory(const std::string& tag, const tBLE_BD_ADDR& ble_bd_addr,
-                    const std::string& msg, const std::string& extra) {
+void BTM_LogHistory(std::string_view tag, const tBLE_BD_ADDR& ble_bd_addr,
+                    std::string_view msg, std::string_view extra) {
   mock_function_count_map[__func__]++;
 }
 void btm_free(void) { mock_function_count_map[__func__]++; }
@@ -30,6 +30,7 @@ extern std::map<std::string, int> mock_function_count_map;
 #include <base/callback.h>
 #include <base/location.h>
 
+#include "main/shim/hci_command.h"
 #include "stack/include/bt_hdr.h"
 
 #ifndef UNUSED_ATTR
@@ -53,6 +54,11 @@ void btu_hcif_process_event(UNUSED_ATTR uint8_t controller_id, BT_HDR* p_msg) {
 void btu_hcif_send_cmd(UNUSED_ATTR uint8_t controller_id, const BT_HDR* p_buf) {
   mock_function_count_map[__func__]++;
 }
+void btu_hcif_send_cmd(
+    UNUSED_ATTR uint8_t controller_id,
+    std::unique_ptr<bluetooth::shim::LegacyCommandBuilder> command) {
+  mock_function_count_map[__func__]++;
+}
 void btu_hcif_send_cmd_with_cb(const base::Location& posted_from,
                                uint16_t opcode, uint8_t* params,
                                uint8_t params_len, hci_cmd_cb cb) {
@@ -37,7 +37,6 @@ extern std::map<std::string, int> mock_function_count_map;
 #include <base/logging.h>
 #include <base/strings/string_number_conversions.h>
 #include <algorithm>
-#include "stack/crypto_toolbox/aes.h"
 #include "stack/crypto_toolbox/crypto_toolbox.h"
 
 // Mocked compile conditionals, if any
@@ -24,17 +24,18 @@
 
 extern std::map<std::string, int> mock_function_count_map;
 
-#include "stack/crypto_toolbox/aes.h"
 #include "stack/crypto_toolbox/crypto_toolbox.h"
 
 #ifndef UNUSED_ATTR
 #define UNUSED_ATTR
 #endif
 
-namespace crypto_toolbox {
+namespace bluetooth {
+namespace crypto {
 Octet16 aes_cmac(const Octet16& key, const uint8_t* input, uint16_t length) {
   mock_function_count_map[__func__]++;
   Octet16 octet16;
   return octet16;
 }
-}  // namespace crypto_toolbox
+}  // namespace crypto
+}  // namespace bluetooth
@@ -43,6 +43,7 @@ namespace stack_gatt_api {
 struct GATTC_ConfigureMTU GATTC_ConfigureMTU;
 struct GATTC_Discover GATTC_Discover;
 struct GATTC_ExecuteWrite GATTC_ExecuteWrite;
+struct GATTC_IsReadMultiVarLenSupported GATTC_IsReadMultiVarLenSupported;
 struct GATTC_Read GATTC_Read;
 struct GATTC_SendHandleValueConfirm GATTC_SendHandleValueConfirm;
 struct GATTC_Write GATTC_Write;
@@ -77,6 +78,7 @@ namespace stack_gatt_api {
 tGATT_STATUS GATTC_ConfigureMTU::return_value = GATT_SUCCESS;
 tGATT_STATUS GATTC_Discover::return_value = GATT_SUCCESS;
 tGATT_STATUS GATTC_ExecuteWrite::return_value = GATT_SUCCESS;
+bool GATTC_IsReadMultiVarLenSupported::return_value = false;
 tGATT_STATUS GATTC_Read::return_value = GATT_SUCCESS;
 tGATT_STATUS GATTC_SendHandleValueConfirm::return_value = GATT_SUCCESS;
 tGATT_STATUS GATTC_Write::return_value = GATT_SUCCESS;
@@ -115,6 +117,10 @@ tGATT_STATUS GATTC_ExecuteWrite(uint16_t conn_id, bool is_execute) {
   mock_function_count_map[__func__]++;
   return test::mock::stack_gatt_api::GATTC_ExecuteWrite(conn_id, is_execute);
 }
+bool GATTC_IsReadMultiVarLenSupported(uint16_t conn_id) {
+  mock_function_count_map[__func__]++;
+  return test::mock::stack_gatt_api::GATTC_IsReadMultiVarLenSupported(conn_id);
+}
 tGATT_STATUS GATTC_Read(uint16_t conn_id, tGATT_READ_TYPE type,
                         tGATT_READ_PARAM* p_read) {
   mock_function_count_map[__func__]++;
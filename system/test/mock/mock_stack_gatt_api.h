@@ -108,6 +108,17 @@ struct GATTC_ExecuteWrite {
 };
 extern struct GATTC_ExecuteWrite GATTC_ExecuteWrite;
 
+// Name: GATTC_IsReadMultiVarLenSupported
+// Params: uint16_t conn_id
+// Return: bool
+struct GATTC_IsReadMultiVarLenSupported {
+  static bool return_value;
+  std::function<bool(uint16_t conn_id)> body{
+      [](uint16_t conn_id) { return return_value; }};
+  bool operator()(uint16_t conn_id) { return body(conn_id); };
+};
+extern struct GATTC_IsReadMultiVarLenSupported GATTC_IsReadMultiVarLenSupported;
+
 // Name: GATTC_Read
 // Params: uint16_t conn_id, tGATT_READ_TYPE type, tGATT_READ_PARAM* p_read
 // Return: tGATT_STATUS
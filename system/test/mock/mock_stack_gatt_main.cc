@@ -77,6 +77,7 @@ void gatt_find_in_device_record(const RawAddress& bd_addr,
                                 tBLE_BD_ADDR* address_with_type) {
   mock_function_count_map[__func__]++;
 }
+void gatt_debug_dump(int fd) { mock_function_count_map[__func__]++; }
 void gatt_free(void) { mock_function_count_map[__func__]++; }
 void gatt_init_srv_chg(void) { mock_function_count_map[__func__]++; }
 void gatt_l2cif_config_cfm_cback(uint16_t lcid, uint16_t initiator,
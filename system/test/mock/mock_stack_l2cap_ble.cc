@@ -16,7 +16,7 @@
 
 /*
  * Generated mock file from original source file
- *   Functions generated:22
+ *   Functions generated:23
  *
  *  mockcify.pl ver 0.2
  */
@@ -63,6 +63,7 @@ struct l2c_link_processs_ble_num_bufs l2c_link_processs_ble_num_bufs;
 struct l2c_ble_link_adjust_allocation l2c_ble_link_adjust_allocation;
 struct l2cble_process_rc_param_request_evt l2cble_process_rc_param_request_evt;
 struct l2cble_update_data_length l2cble_update_data_length;
+struct l2cble_on_data_sent l2cble_on_data_sent;
 struct l2cble_process_data_length_change_event
     l2cble_process_data_length_change_event;
 struct l2cble_credit_based_conn_req l2cble_credit_based_conn_req;
@@ -149,6 +150,10 @@ void l2cble_update_data_length(tL2C_LCB* p_lcb) {
   mock_function_count_map[__func__]++;
   test::mock::stack_l2cap_ble::l2cble_update_data_length(p_lcb);
 }
+void l2cble_on_data_sent(tL2C_LCB* p_lcb, uint16_t len) {
+  mock_function_count_map[__func__]++;
+  test::mock::stack_l2cap_ble::l2cble_on_data_sent(p_lcb, len);
+}
 void l2cble_process_data_length_change_event(uint16_t handle,
                                              uint16_t tx_data_len,
                                              uint16_t rx_data_len) {
@@ -210,6 +210,15 @@ struct l2cble_update_data_length {
   void operator()(tL2C_LCB* p_lcb) { body(p_lcb); };
 };
 extern struct l2cble_update_data_length l2cble_update_data_length;
+// Name: l2cble_on_data_sent
+// Params: tL2C_LCB* p_lcb, uint16_t len
+// Returns: void
+struct l2cble_on_data_sent {
+  std::function<void(tL2C_LCB* p_lcb, uint16_t len)> body{
+      [](tL2C_LCB* p_lcb, uint16_t len) {}};
+  void operator()(tL2C_LCB* p_lcb, uint16_t len) { body(p_lcb, len); };
+};
+extern struct l2cble_on_data_sent l2cble_on_data_sent;
 // Name: l2cble_process_data_length_change_event
 // Params: uint16_t handle, uint16_t tx_data_len, uint16_t rx_data_len
 // Returns: void
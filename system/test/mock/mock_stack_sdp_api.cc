@@ -46,6 +46,7 @@ namespace stack_sdp_api {
 
 // Function state capture and return values, if needed
 struct SDP_CancelServiceSearch SDP_CancelServiceSearch;
+struct SDP_FlushDiscoveryCache SDP_FlushDiscoveryCache;
 struct SDP_FindProfileVersionInRec SDP_FindProfileVersionInRec;
 struct SDP_FindProtocolListElemInRec SDP_FindProtocolListElemInRec;
 struct SDP_FindServiceUUIDInRec SDP_FindServiceUUIDInRec;
@@ -73,6 +74,10 @@ bool SDP_CancelServiceSearch(const tSDP_DISCOVERY_DB* p_db) {
   mock_function_count_map[__func__]++;
   return test::mock::stack_sdp_api::SDP_CancelServiceSearch(p_db);
 }
+void SDP_FlushDiscoveryCache(const RawAddress& bd_addr) {
+  mock_function_count_map[__func__]++;
+  test::mock::stack_sdp_api::SDP_FlushDiscoveryCache(bd_addr);
+}
 bool SDP_FindProfileVersionInRec(const tSDP_DISC_REC* p_rec,
                                  uint16_t profile_uuid, uint16_t* p_version) {
   mock_function_count_map[__func__]++;
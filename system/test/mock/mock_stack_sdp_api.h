@@ -62,6 +62,15 @@ struct SDP_CancelServiceSearch {
   bool operator()(const tSDP_DISCOVERY_DB* p_db) { return body(p_db); };
 };
 extern struct SDP_CancelServiceSearch SDP_CancelServiceSearch;
+// Name: SDP_FlushDiscoveryCache
+// Params: const RawAddress& bd_addr
+// Returns: void
+struct SDP_FlushDiscoveryCache {
+  std::function<void(const RawAddress& bd_addr)> body{
+      [](const RawAddress& bd_addr) {}};
+  void operator()(const RawAddress& bd_addr) { body(bd_addr); };
+};
+extern struct SDP_FlushDiscoveryCache SDP_FlushDiscoveryCache;
 // Name: SDP_FindProfileVersionInRec
 // Params: tSDP_DISC_REC* p_rec, uint16_t profile_uuid, uint16_t* p_version
 // Returns: bool
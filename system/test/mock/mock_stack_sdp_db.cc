@@ -16,7 +16,7 @@
 
 /*
  * Generated mock file from original source file
- *   Functions generated:14
+ *   Functions generated:15
  */
 
 #include <map>
@@ -93,6 +93,10 @@ tSDP_RECORD* sdp_db_find_record(uint32_t handle) {
   mock_function_count_map[__func__]++;
   return nullptr;
 }
+uint32_t sdp_db_get_generation(void) {
+  mock_function_count_map[__func__]++;
+  return 0;
+}
 const tSDP_RECORD* sdp_db_service_search(const tSDP_RECORD* p_rec,
                                          tSDP_UUID_SEQ* p_seq) {
   mock_function_count_map[__func__]++;
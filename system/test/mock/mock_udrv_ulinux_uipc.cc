@@ -16,7 +16,7 @@
 
 /*
  * Generated mock file from original source file
- *   Functions generated:12
+ *   Functions generated:13
  */
 
 #include <cstdint>
@@ -36,6 +36,11 @@ bool UIPC_Open(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id, tUIPC_RCV_CBACK* p_cback,
   mock_function_count_map[__func__]++;
   return false;
 }
+bool UIPC_OpenShmRing(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id,
+                      const char* ring_path, uint32_t size) {
+  mock_function_count_map[__func__]++;
+  return false;
+}
 bool UIPC_Send(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id,
                UNUSED_ATTR uint16_t msg_evt, const uint8_t* p_buf,
                uint16_t msglen) {
@@ -8,6 +8,7 @@
 #   $ ./test/run_benchmarks.sh bluetooth_benchmark_example
 
 known_benchmarks=(
+  bluetooth_benchmark_audio_resampler
   bluetooth_benchmark_thread_performance
   bluetooth_benchmark_timer_performance
 )
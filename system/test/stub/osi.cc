@@ -196,6 +196,15 @@ size_t allocation_tracker_resize_for_canary(size_t size) {
 void allocation_tracker_reset(void) { mock_function_count_map[__func__]++; }
 void allocation_tracker_uninit(void) { mock_function_count_map[__func__]++; }
 void osi_allocator_debug_dump(int fd) { mock_function_count_map[__func__]++; }
+void allocation_tracker_init_sampling(size_t interval) {
+  mock_function_count_map[__func__]++;
+}
+void* allocation_tracker_notify_alloc_from(uint8_t allocator_id, void* ptr,
+                                           size_t requested_size,
+                                           const void* call_site) {
+  mock_function_count_map[__func__]++;
+  return nullptr;
+}
 void* allocation_tracker_notify_alloc(uint8_t allocator_id, void* ptr,
                                       size_t requested_size) {
   mock_function_count_map[__func__]++;
@@ -299,6 +308,9 @@ char* osi_strndup(const char* str, size_t len) {
   mock_function_count_map[__func__]++;
   return nullptr;
 }
+void osi_allocator_pool_debug_dump(int fd) {
+  mock_function_count_map[__func__]++;
+}
 void osi_free(void* ptr) { mock_function_count_map[__func__]++; }
 void osi_free_and_reset(void** p_ptr) { mock_function_count_map[__func__]++; }
 void* osi_calloc(size_t size) {
@@ -322,6 +334,10 @@ fixed_queue_t* fixed_queue_new(size_t capacity) {
   mock_function_count_map[__func__]++;
   return nullptr;
 }
+fixed_queue_t* fixed_queue_new_spsc(size_t capacity) {
+  mock_function_count_map[__func__]++;
+  return nullptr;
+}
 int fixed_queue_get_dequeue_fd(const fixed_queue_t* queue) {
   mock_function_count_map[__func__]++;
   return 0;
@@ -418,6 +434,10 @@ void alarm_set_on_mloop(alarm_t* alarm, uint64_t interval_ms,
   fake_osi_alarm_set_on_mloop_.data = data;
 }
 
+void alarm_set_slack(alarm_t* alarm, uint64_t slack_ms) {
+  mock_function_count_map[__func__]++;
+}
+
 int osi_rand(void) {
   mock_function_count_map[__func__]++;
   return 0;
@@ -18,12 +18,13 @@
 #ifndef UIPC_H
 #define UIPC_H
 
-#include <sys/select.h>
+#include <pthread.h>
 
 #include <memory>
 #include <mutex>
 
 #include "stack/include/bt_hdr.h"
+#include "uipc_shm.h"
 
 #define UIPC_CH_ID_AV_CTRL 0
 #define UIPC_CH_ID_AV_AUDIO 1
@@ -51,6 +52,8 @@ typedef enum {
 #define UIPC_REQ_RX_FLUSH 1
 #define UIPC_REG_REMOVE_ACTIVE_READSET 3
 #define UIPC_SET_READ_POLL_TMO 4
+/* Size of the buffer UIPC_Read() drains the socket into, 0 to disable */
+#define UIPC_SET_RX_BATCH_SIZE 5
 
 typedef void(tUIPC_RCV_CBACK)(
     tUIPC_CH_ID ch_id,
@@ -66,7 +69,17 @@ typedef struct {
   int fd;
   int read_poll_tmo_ms;
   int task_evt_flags; /* event flags pending to be processed in read task */
+  int ready_flags;    /* readiness reported by epoll, not processed yet */
+  bool fd_watched;    /* fd is watched by the read task */
   tUIPC_RCV_CBACK* cback;
+  tUIPC_SHM_RING* shm_ring; /* optional shared memory data path */
+
+  /* rx batching: data drained from the socket, not read yet */
+  uint8_t* rx_batch_buf;
+  uint32_t rx_batch_size;
+  uint32_t rx_batch_len;
+  uint32_t rx_batch_offset;
+  int rx_batch_fd; /* connection the buffered data was received on */
 } tUIPC_CHAN;
 
 struct tUIPC_STATE {
@@ -74,9 +87,7 @@ struct tUIPC_STATE {
   int running;
   std::recursive_mutex mutex;
 
-  fd_set active_set;
-  fd_set read_set;
-  int max_fd;
+  int epoll_fd;
   int signal_fds[2];
 
   tUIPC_CHAN ch[UIPC_CH_NUM];
@@ -100,6 +111,21 @@ std::unique_ptr<tUIPC_STATE> UIPC_Init();
 bool UIPC_Open(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id, tUIPC_RCV_CBACK* p_cback,
                const char* socket_path);
 
+/**
+ * Add a shared memory ring to an open UIPC channel
+ *
+ * Once the peer attaches to the ring, UIPC_Read() reads from the ring instead
+ * of the socket. The socket still notifies the connection events. The ring is
+ * removed when the channel is closed.
+ *
+ * @param ch_id Channel ID
+ * @param ring_path Path to the file backing the ring
+ * @param size Min. size of the ring
+ * @return true on success, otherwise false
+ */
+bool UIPC_OpenShmRing(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id,
+                      const char* ring_path, uint32_t size);
+
 /**
  * Closes a channel in UIPC or the entire UIPC module
  *
@@ -122,6 +148,12 @@ bool UIPC_Send(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id, uint16_t msg_evt,
 /**
  * Read a message from UIPC
  *
+ * With UIPC_SET_RX_BATCH_SIZE, all the data ready in the socket is drained in
+ * a single recv() and the following reads are served from memory.
+ *
+ * The data read before the end of the stream or an error is returned first,
+ * the next call reports it.
+ *
  * @param ch_id Channel ID
  * @param p_msg_evt Message event type
  * @param p_buf Buffer for the message
@@ -0,0 +1,153 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+#ifndef UIPC_SHM_H
+#define UIPC_SHM_H
+
+#include <stdint.h>
+
+#include <atomic>
+#include <string>
+
+/*
+ * Shared memory ring carrying a stream of bytes from one writer process to
+ * one reader process, used as an alternative to the UIPC data sockets.
+ *
+ * The ring lives in a file created by the reader and mapped by the writer.
+ * The file starts with a page holding tUIPC_SHM_RING_HEADER, followed by the
+ * ring data. The data is mapped twice back to back, so that any readable or
+ * writable span is contiguous in memory and can be accessed in place.
+ *
+ * Each side sleeps on a futex of the header when the ring is empty (reader)
+ * or full (writer), and the other side only wakes it up when it announced
+ * that it is waiting: the data itself is exchanged without system calls.
+ */
+
+#define UIPC_SHM_RING_MAGIC 0x4d485342 /* "BSHM" */
+#define UIPC_SHM_RING_VERSION 1
+#define UIPC_SHM_RING_HEADER_SIZE 4096
+
+typedef struct {
+  /* Immutable once the ring is created */
+  uint32_t magic;
+  uint32_t version;
+  uint32_t size; /* Size of the ring data, a power of 2 */
+
+  /* Updated by the writer. The positions are running byte counters. */
+  alignas(64) std::atomic<uint32_t> write_pos;
+  std::atomic<uint32_t> writer_attached;
+  std::atomic<uint32_t> writer_waiting; /* writer waiting for space */
+  std::atomic<uint32_t> reader_event;   /* futex the reader sleeps on */
+
+  /* Updated by the reader */
+  alignas(64) std::atomic<uint32_t> read_pos;
+  std::atomic<uint32_t> reader_attached;
+  std::atomic<uint32_t> reader_waiting; /* reader waiting for data */
+  std::atomic<uint32_t> writer_event;   /* futex the writer sleeps on */
+} tUIPC_SHM_RING_HEADER;
+
+static_assert(sizeof(tUIPC_SHM_RING_HEADER) <= UIPC_SHM_RING_HEADER_SIZE,
+              "shared memory ring header doesn't fit in its page");
+static_assert(std::atomic<uint32_t>::is_always_lock_free,
+              "shared memory ring requires lock free atomics");
+
+typedef struct {
+  tUIPC_SHM_RING_HEADER* hdr;
+  uint8_t* data; /* Ring data, mapped twice */
+  uint32_t size;
+  bool is_reader;
+  bool attached; /* Updated by the owner of the ring only */
+  std::string path;
+} tUIPC_SHM_RING;
+
+/**
+ * Create a ring of at least |size| bytes, to be read by the caller
+ *
+ * @param path Path of the file backing the ring; replaced if it exists
+ * @param size Min. size of the ring, rounded up to a power of 2
+ * @return the ring attached as reader, nullptr on failure
+ */
+tUIPC_SHM_RING* UIPC_ShmRingCreate(const char* path, uint32_t size);
+
+/**
+ * Map a ring created by the reader, to write into it
+ *
+ * @param path Path of the file backing the ring
+ * @return the ring, detached, nullptr on failure
+ */
+tUIPC_SHM_RING* UIPC_ShmRingMap(const char* path);
+
+/**
+ * Detach and unmap a ring
+ */
+void UIPC_ShmRingFree(tUIPC_SHM_RING* ring);
+
+/**
+ * Attach to or detach from the ring. Detaching wakes up the peer. The reader
+ * also removes the file backing the ring, which cannot be attached again.
+ */
+void UIPC_ShmRingAttach(tUIPC_SHM_RING* ring);
+void UIPC_ShmRingDetach(tUIPC_SHM_RING* ring);
+
+/**
+ * Returns whether the other side is attached to the ring
+ */
+bool UIPC_ShmRingIsPeerAttached(const tUIPC_SHM_RING* ring);
+
+/**
+ * Returns whether both sides are attached to the ring. Unlike the attached
+ * state of the caller, it can be checked from any thread.
+ */
+bool UIPC_ShmRingIsConnected(const tUIPC_SHM_RING* ring);
+
+/**
+ * Zero copy access to the ring. The span functions return the number of bytes
+ * that can be written or read at |*pp|, the commit functions release |len|
+ * of them to the peer. The positions are checked against the ring size on
+ * every access: a ring corrupted by the peer is detached, and has nothing to
+ * read or write.
+ */
+uint32_t UIPC_ShmRingWriteSpan(tUIPC_SHM_RING* ring, uint8_t** pp);
+void UIPC_ShmRingWriteCommit(tUIPC_SHM_RING* ring, uint32_t len);
+uint32_t UIPC_ShmRingReadSpan(tUIPC_SHM_RING* ring, const uint8_t** pp);
+void UIPC_ShmRingReadCommit(tUIPC_SHM_RING* ring, uint32_t len);
+
+/**
+ * Write |len| bytes to the ring, waiting for space for up to |timeout_ms|
+ * while both sides are attached. The ring may be detached from another
+ * thread, which interrupts the write.
+ *
+ * @return the number of bytes written
+ */
+uint32_t UIPC_ShmRingWrite(tUIPC_SHM_RING* ring, const uint8_t* p_buf,
+                           uint32_t len, int timeout_ms);
+
+/**
+ * Read |len| bytes from the ring, waiting for data for up to |timeout_ms|
+ * while both sides are attached
+ *
+ * @return the number of bytes read
+ */
+uint32_t UIPC_ShmRingRead(tUIPC_SHM_RING* ring, uint8_t* p_buf, uint32_t len,
+                          int timeout_ms);
+
+/**
+ * Drop the data pending in the ring. Called by the reader.
+ */
+void UIPC_ShmRingFlush(tUIPC_SHM_RING* ring);
+
+#endif /* UIPC_SHM_H */
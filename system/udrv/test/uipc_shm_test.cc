@@ -0,0 +1,324 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "uipc_shm.h"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t kRingSize = UIPC_SHM_RING_HEADER_SIZE;
+constexpr int kLongTimeoutMs = 5000;
+
+using Clock = std::chrono::steady_clock;
+
+std::vector<uint8_t> Pattern(size_t size, uint8_t seed) {
+  std::vector<uint8_t> data(size);
+  for (size_t i = 0; i < size; i++) data[i] = (uint8_t)(seed + i * 7);
+  return data;
+}
+
+int ElapsedMs(Clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() -
+                                                               start)
+      .count();
+}
+
+/* Both sides of the ring live in the test process, each with its own
+ * mapping of the file, as they would in two processes */
+class UipcShmRingTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    path_ = ::testing::TempDir() + "uipc_shm_ring_" +
+            std::to_string(getpid());
+    reader_ = UIPC_ShmRingCreate(path_.c_str(), kRingSize);
+    ASSERT_NE(reader_, nullptr);
+    writer_ = UIPC_ShmRingMap(path_.c_str());
+    ASSERT_NE(writer_, nullptr);
+    UIPC_ShmRingAttach(writer_);
+  }
+
+  void TearDown() override {
+    UIPC_ShmRingFree(writer_);
+    UIPC_ShmRingFree(reader_);
+    unlink(path_.c_str());
+  }
+
+  std::string path_;
+  tUIPC_SHM_RING* reader_ = nullptr;
+  tUIPC_SHM_RING* writer_ = nullptr;
+};
+
+TEST_F(UipcShmRingTest, create_map_attach) {
+  EXPECT_EQ(reader_->size, kRingSize);
+  EXPECT_EQ(writer_->size, kRingSize);
+  EXPECT_TRUE(reader_->is_reader);
+  EXPECT_FALSE(writer_->is_reader);
+  EXPECT_TRUE(UIPC_ShmRingIsConnected(reader_));
+  EXPECT_TRUE(UIPC_ShmRingIsConnected(writer_));
+  EXPECT_TRUE(UIPC_ShmRingIsPeerAttached(reader_));
+  EXPECT_TRUE(UIPC_ShmRingIsPeerAttached(writer_));
+
+  const uint8_t* p;
+  EXPECT_EQ(UIPC_ShmRingReadSpan(reader_, &p), 0u);
+  uint8_t* q;
+  EXPECT_EQ(UIPC_ShmRingWriteSpan(writer_, &q), kRingSize);
+}
+
+TEST_F(UipcShmRingTest, size_is_rounded_up_to_a_power_of_two) {
+  std::string path = path_ + "_large";
+  tUIPC_SHM_RING* ring = UIPC_ShmRingCreate(path.c_str(), 3 * kRingSize);
+  ASSERT_NE(ring, nullptr);
+  EXPECT_EQ(ring->size, 4 * kRingSize);
+  UIPC_ShmRingFree(ring);
+}
+
+TEST_F(UipcShmRingTest, map_rejects_invalid_files) {
+  EXPECT_EQ(UIPC_ShmRingMap((path_ + "_missing").c_str()), nullptr);
+
+  std::string path = path_ + "_invalid";
+  FILE* file = fopen(path.c_str(), "w");
+  ASSERT_NE(file, nullptr);
+  std::vector<uint8_t> garbage(2 * kRingSize, 0xa5);
+  fwrite(garbage.data(), 1, garbage.size(), file);
+  fclose(file);
+  EXPECT_EQ(UIPC_ShmRingMap(path.c_str()), nullptr);
+  unlink(path.c_str());
+}
+
+TEST_F(UipcShmRingTest, write_then_read) {
+  std::vector<uint8_t> data = Pattern(100, 1);
+  EXPECT_EQ(UIPC_ShmRingWrite(writer_, data.data(), data.size(), 0),
+            data.size());
+
+  std::vector<uint8_t> read(data.size());
+  EXPECT_EQ(UIPC_ShmRingRead(reader_, read.data(), read.size(), 0),
+            read.size());
+  EXPECT_EQ(read, data);
+}
+
+TEST_F(UipcShmRingTest, full_ring_stops_the_writer) {
+  std::vector<uint8_t> data = Pattern(kRingSize + 10, 2);
+  EXPECT_EQ(UIPC_ShmRingWrite(writer_, data.data(), data.size(), 0),
+            kRingSize);
+
+  std::vector<uint8_t> read(data.size());
+  EXPECT_EQ(UIPC_ShmRingRead(reader_, read.data(), read.size(), 0),
+            kRingSize);
+  read.resize(kRingSize);
+  data.resize(kRingSize);
+  EXPECT_EQ(read, data);
+}
+
+/* The data is mapped twice: a span crossing the end of the ring is
+ * contiguous */
+TEST_F(UipcShmRingTest, wrap_around) {
+  const uint32_t kOffset = kRingSize - 10;
+  std::vector<uint8_t> skipped = Pattern(kOffset, 3);
+  ASSERT_EQ(UIPC_ShmRingWrite(writer_, skipped.data(), skipped.size(), 0),
+            kOffset);
+  ASSERT_EQ(UIPC_ShmRingRead(reader_, skipped.data(), skipped.size(), 0),
+            kOffset);
+
+  for (int round = 0; round < 4; round++) {
+    std::vector<uint8_t> data = Pattern(kRingSize / 2 + 3, round);
+    uint8_t* q;
+    ASSERT_EQ(UIPC_ShmRingWriteSpan(writer_, &q), kRingSize);
+    ASSERT_EQ(UIPC_ShmRingWrite(writer_, data.data(), data.size(), 0),
+              data.size());
+
+    const uint8_t* p;
+    ASSERT_EQ(UIPC_ShmRingReadSpan(reader_, &p), data.size());
+    EXPECT_EQ(std::vector<uint8_t>(p, p + data.size()), data);
+    UIPC_ShmRingReadCommit(reader_, data.size());
+  }
+}
+
+TEST_F(UipcShmRingTest, zero_copy_spans) {
+  uint8_t* q;
+  ASSERT_EQ(UIPC_ShmRingWriteSpan(writer_, &q), kRingSize);
+  q[0] = 0x42;
+  q[1] = 0x43;
+  UIPC_ShmRingWriteCommit(writer_, 2);
+  ASSERT_EQ(UIPC_ShmRingWriteSpan(writer_, &q), kRingSize - 2);
+
+  const uint8_t* p;
+  ASSERT_EQ(UIPC_ShmRingReadSpan(reader_, &p), 2u);
+  EXPECT_EQ(p[0], 0x42);
+  EXPECT_EQ(p[1], 0x43);
+  UIPC_ShmRingReadCommit(reader_, 1);
+  ASSERT_EQ(UIPC_ShmRingReadSpan(reader_, &p), 1u);
+  EXPECT_EQ(p[0], 0x43);
+}
+
+TEST_F(UipcShmRingTest, read_waits_for_the_writer) {
+  std::vector<uint8_t> data = Pattern(64, 4);
+  std::thread writer([&] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    UIPC_ShmRingWrite(writer_, data.data(), data.size(), 0);
+  });
+
+  std::vector<uint8_t> read(data.size());
+  Clock::time_point start = Clock::now();
+  EXPECT_EQ(UIPC_ShmRingRead(reader_, read.data(), read.size(),
+                             kLongTimeoutMs),
+            read.size());
+  EXPECT_LT(ElapsedMs(start), kLongTimeoutMs);
+  EXPECT_EQ(read, data);
+  writer.join();
+}
+
+TEST_F(UipcShmRingTest, write_waits_for_the_reader) {
+  std::vector<uint8_t> data = Pattern(kRingSize + 64, 5);
+  std::vector<uint8_t> read(data.size());
+  std::thread reader([&] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    UIPC_ShmRingRead(reader_, read.data(), read.size(), kLongTimeoutMs);
+  });
+
+  Clock::time_point start = Clock::now();
+  EXPECT_EQ(UIPC_ShmRingWrite(writer_, data.data(), data.size(),
+                              kLongTimeoutMs),
+            data.size());
+  EXPECT_LT(ElapsedMs(start), kLongTimeoutMs);
+  reader.join();
+  EXPECT_EQ(read, data);
+}
+
+TEST_F(UipcShmRingTest, read_times_out) {
+  uint8_t byte;
+  Clock::time_point start = Clock::now();
+  EXPECT_EQ(UIPC_ShmRingRead(reader_, &byte, 1, 50), 0u);
+  EXPECT_GE(ElapsedMs(start), 50);
+  EXPECT_TRUE(UIPC_ShmRingIsConnected(reader_));
+}
+
+TEST_F(UipcShmRingTest, detach_wakes_up_the_reader) {
+  std::thread writer([&] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    UIPC_ShmRingDetach(writer_);
+  });
+
+  uint8_t byte;
+  Clock::time_point start = Clock::now();
+  EXPECT_EQ(UIPC_ShmRingRead(reader_, &byte, 1, kLongTimeoutMs), 0u);
+  EXPECT_LT(ElapsedMs(start), kLongTimeoutMs);
+  EXPECT_FALSE(UIPC_ShmRingIsPeerAttached(reader_));
+  writer.join();
+}
+
+TEST_F(UipcShmRingTest, detach_wakes_up_the_writer) {
+  std::vector<uint8_t> data = Pattern(kRingSize + 1, 6);
+  std::thread reader([&] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    UIPC_ShmRingDetach(reader_);
+  });
+
+  Clock::time_point start = Clock::now();
+  EXPECT_EQ(UIPC_ShmRingWrite(writer_, data.data(), data.size(),
+                              kLongTimeoutMs),
+            kRingSize);
+  EXPECT_LT(ElapsedMs(start), kLongTimeoutMs);
+  EXPECT_FALSE(UIPC_ShmRingIsConnected(writer_));
+  reader.join();
+}
+
+TEST_F(UipcShmRingTest, reader_detach_removes_the_file) {
+  UIPC_ShmRingDetach(reader_);
+  EXPECT_NE(access(path_.c_str(), F_OK), 0);
+  EXPECT_EQ(UIPC_ShmRingMap(path_.c_str()), nullptr);
+
+  UIPC_ShmRingAttach(reader_);
+  EXPECT_FALSE(reader_->attached);
+}
+
+TEST_F(UipcShmRingTest, flush_drops_pending_data) {
+  std::vector<uint8_t> data = Pattern(kRingSize, 7);
+  ASSERT_EQ(UIPC_ShmRingWrite(writer_, data.data(), data.size(), 0),
+            kRingSize);
+  uint8_t* q;
+  ASSERT_EQ(UIPC_ShmRingWriteSpan(writer_, &q), 0u);
+
+  UIPC_ShmRingFlush(reader_);
+  const uint8_t* p;
+  EXPECT_EQ(UIPC_ShmRingReadSpan(reader_, &p), 0u);
+  EXPECT_EQ(UIPC_ShmRingWriteSpan(writer_, &q), kRingSize);
+
+  data = Pattern(10, 8);
+  ASSERT_EQ(UIPC_ShmRingWrite(writer_, data.data(), data.size(), 0), 10u);
+  std::vector<uint8_t> read(data.size());
+  EXPECT_EQ(UIPC_ShmRingRead(reader_, read.data(), read.size(), 0), 10u);
+  EXPECT_EQ(read, data);
+}
+
+/* A peer moving the write position past the ring size must not make the
+ * reader copy past the data mapping */
+TEST_F(UipcShmRingTest, corrupt_write_position_detaches_the_reader) {
+  writer_->hdr->write_pos.store(2 * kRingSize + 1);
+
+  const uint8_t* p;
+  EXPECT_EQ(UIPC_ShmRingReadSpan(reader_, &p), 0u);
+  EXPECT_FALSE(reader_->attached);
+  EXPECT_FALSE(UIPC_ShmRingIsConnected(writer_));
+
+  std::vector<uint8_t> read(3 * kRingSize);
+  EXPECT_EQ(UIPC_ShmRingRead(reader_, read.data(), read.size(),
+                             kLongTimeoutMs),
+            0u);
+}
+
+/* Same for a read position behind the write position by more than the ring
+ * size, or ahead of it */
+TEST_F(UipcShmRingTest, corrupt_read_position_detaches_the_writer) {
+  reader_->hdr->read_pos.store(1);
+
+  uint8_t* q;
+  EXPECT_EQ(UIPC_ShmRingWriteSpan(writer_, &q), 0u);
+  EXPECT_FALSE(writer_->attached);
+  EXPECT_FALSE(UIPC_ShmRingIsConnected(reader_));
+
+  std::vector<uint8_t> data = Pattern(3 * kRingSize, 9);
+  EXPECT_EQ(UIPC_ShmRingWrite(writer_, data.data(), data.size(),
+                              kLongTimeoutMs),
+            0u);
+}
+
+/* A corruption while the reader waits ends the wait */
+TEST_F(UipcShmRingTest, corruption_wakes_up_the_reader) {
+  std::thread writer([&] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    writer_->hdr->write_pos.store(kRingSize + 1);
+    UIPC_ShmRingWriteCommit(writer_, 0);
+  });
+
+  std::vector<uint8_t> read(2 * kRingSize);
+  Clock::time_point start = Clock::now();
+  EXPECT_EQ(UIPC_ShmRingRead(reader_, read.data(), read.size(),
+                             kLongTimeoutMs),
+            0u);
+  EXPECT_LT(ElapsedMs(start), kLongTimeoutMs);
+  EXPECT_FALSE(reader_->attached);
+  writer.join();
+}
+
+}  // namespace
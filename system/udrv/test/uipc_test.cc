@@ -0,0 +1,253 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "uipc.h"
+
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bt_utils.h"
+#include "osi/include/socket_utils/sockets.h"
+
+void raise_priority_a2dp(tHIGH_PRIORITY_TASK high_task) {}
+
+namespace {
+
+constexpr tUIPC_CH_ID kChannel = UIPC_CH_ID_AV_AUDIO;
+constexpr auto kTimeout = std::chrono::seconds(5);
+
+/* The namespace of the channel sockets */
+#if defined(OS_GENERIC)
+constexpr int kSocketNamespace = ANDROID_SOCKET_NAMESPACE_FILESYSTEM;
+#else   // !defined(OS_GENERIC)
+constexpr int kSocketNamespace = ANDROID_SOCKET_NAMESPACE_ABSTRACT;
+#endif  // defined(OS_GENERIC)
+
+std::mutex lock;
+std::condition_variable signaled;
+std::vector<tUIPC_EVENT> events;
+std::vector<uint8_t> received;
+
+tUIPC_STATE* uipc_state;
+/* Bytes read by the callback for each UIPC_RX_DATA_READY_EVT */
+uint32_t read_size_per_event;
+
+void on_event(tUIPC_CH_ID ch_id, tUIPC_EVENT event) {
+  std::vector<uint8_t> data;
+  if (event == UIPC_RX_DATA_READY_EVT) {
+    data.resize(read_size_per_event);
+    data.resize(UIPC_Read(*uipc_state, ch_id, data.data(), data.size()));
+  }
+
+  std::unique_lock<std::mutex> guard(lock);
+  events.push_back(event);
+  received.insert(received.end(), data.begin(), data.end());
+  signaled.notify_all();
+}
+
+/* The UIPC read task and its epoll loop, with a client connected to the
+ * audio channel */
+class UipcTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    events.clear();
+    received.clear();
+    read_size_per_event = 1024;
+    name_ = ::testing::TempDir() + "uipc_test_" + std::to_string(getpid());
+
+    uipc_ = UIPC_Init();
+    uipc_state = uipc_.get();
+    ASSERT_TRUE(UIPC_Open(*uipc_, kChannel, on_event, name_.c_str()));
+
+    client_fd_ = socket(AF_LOCAL, SOCK_STREAM, 0);
+    ASSERT_GE(client_fd_, 0);
+    ASSERT_GE(osi_socket_local_client_connect(client_fd_, name_.c_str(),
+                                              kSocketNamespace, SOCK_STREAM),
+              0);
+    ASSERT_TRUE(WaitForEvent(UIPC_OPEN_EVT));
+  }
+
+  void TearDown() override {
+    if (client_fd_ >= 0) close(client_fd_);
+    UIPC_Close(*uipc_, UIPC_CH_ID_ALL);
+    uipc_.reset();
+    unlink(name_.c_str());
+  }
+
+  bool WaitForEvent(tUIPC_EVENT event) {
+    std::unique_lock<std::mutex> guard(lock);
+    return signaled.wait_for(guard, kTimeout, [event] {
+      return std::find(events.begin(), events.end(), event) != events.end();
+    });
+  }
+
+  bool WaitForReceived(size_t count) {
+    std::unique_lock<std::mutex> guard(lock);
+    return signaled.wait_for(guard, kTimeout,
+                             [count] { return received.size() >= count; });
+  }
+
+  size_t EventCount(tUIPC_EVENT event) {
+    std::unique_lock<std::mutex> guard(lock);
+    return std::count(events.begin(), events.end(), event);
+  }
+
+  void Send(const std::string& data) {
+    ASSERT_EQ((ssize_t)data.size(),
+              write(client_fd_, data.data(), data.size()));
+  }
+
+  /* Stop the callback from reading, the test reads the channel itself */
+  void ReadDirectly() {
+    UIPC_Ioctl(*uipc_, kChannel, UIPC_REG_REMOVE_ACTIVE_READSET, nullptr);
+  }
+
+  std::string Read(uint32_t len) {
+    std::string data(len, '\0');
+    data.resize(UIPC_Read(*uipc_, kChannel, (uint8_t*)data.data(), len));
+    return data;
+  }
+
+  std::string Received() {
+    std::unique_lock<std::mutex> guard(lock);
+    return std::string(received.begin(), received.end());
+  }
+
+  std::string name_;
+  std::unique_ptr<tUIPC_STATE> uipc_;
+  int client_fd_ = -1;
+};
+
+TEST_F(UipcTest, data_is_signaled_and_read) {
+  Send("hello");
+  ASSERT_TRUE(WaitForReceived(5));
+  EXPECT_EQ(Received(), "hello");
+}
+
+/* The connection is edge triggered: the data left unread by the callback
+ * keeps the channel ready, without any new data */
+TEST_F(UipcTest, data_left_unread_is_signaled_again) {
+  read_size_per_event = 2;
+  Send("0123456789");
+  ASSERT_TRUE(WaitForReceived(10));
+  EXPECT_EQ(Received(), "0123456789");
+  EXPECT_GE(EventCount(UIPC_RX_DATA_READY_EVT), 5u);
+}
+
+TEST_F(UipcTest, data_sent_in_several_writes_is_all_read) {
+  std::string sent;
+  for (int i = 0; i < 10; i++) {
+    std::string data = std::to_string(i) + "abc";
+    Send(data);
+    sent += data;
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  ASSERT_TRUE(WaitForReceived(sent.size()));
+  EXPECT_EQ(Received(), sent);
+}
+
+TEST_F(UipcTest, close_is_signaled) {
+  UIPC_Close(*uipc_, kChannel);
+  ASSERT_TRUE(WaitForEvent(UIPC_CLOSE_EVT));
+}
+
+TEST_F(UipcTest, removed_from_read_set_is_not_signaled) {
+  ReadDirectly();
+  Send("xyz");
+  EXPECT_EQ(Read(3), "xyz");
+  EXPECT_EQ(EventCount(UIPC_RX_DATA_READY_EVT), 0u);
+}
+
+TEST_F(UipcTest, hang_up_closes_the_channel) {
+  ReadDirectly();
+  close(client_fd_);
+  client_fd_ = -1;
+  EXPECT_EQ(Read(10), "");
+  ASSERT_TRUE(WaitForEvent(UIPC_CLOSE_EVT));
+}
+
+TEST_F(UipcTest, read_returns_data_before_hang_up) {
+  ReadDirectly();
+  Send("0123456789");
+  close(client_fd_);
+  client_fd_ = -1;
+
+  EXPECT_EQ(Read(20), "0123456789");
+  EXPECT_EQ(Read(20), "");
+  ASSERT_TRUE(WaitForEvent(UIPC_CLOSE_EVT));
+}
+
+TEST_F(UipcTest, batch_serves_reads_from_memory) {
+  ReadDirectly();
+  UIPC_Ioctl(*uipc_, kChannel, UIPC_SET_RX_BATCH_SIZE, (void*)64);
+  Send("0123456789abcdef");
+
+  EXPECT_EQ(Read(4), "0123");
+  EXPECT_EQ(Read(4), "4567");
+  EXPECT_EQ(Read(8), "89abcdef");
+}
+
+TEST_F(UipcTest, batch_flush_drops_batched_data) {
+  ReadDirectly();
+  UIPC_Ioctl(*uipc_, kChannel, UIPC_SET_RX_BATCH_SIZE, (void*)64);
+  Send("0123456789");
+  EXPECT_EQ(Read(2), "01");
+
+  UIPC_Ioctl(*uipc_, kChannel, UIPC_REQ_RX_FLUSH, nullptr);
+  Send("ab");
+  EXPECT_EQ(Read(2), "ab");
+}
+
+/* The stream ends while the batch buffer is being refilled: the data copied
+ * out of the previous batches is returned, the end of the stream is reported
+ * by the next read */
+TEST_F(UipcTest, batch_read_returns_data_before_hang_up) {
+  ReadDirectly();
+  UIPC_Ioctl(*uipc_, kChannel, UIPC_SET_RX_BATCH_SIZE, (void*)4);
+  Send("0123456789");
+  close(client_fd_);
+  client_fd_ = -1;
+
+  EXPECT_EQ(Read(20), "0123456789");
+  EXPECT_EQ(Read(20), "");
+  ASSERT_TRUE(WaitForEvent(UIPC_CLOSE_EVT));
+}
+
+TEST_F(UipcTest, batch_read_returns_batched_data_after_hang_up) {
+  ReadDirectly();
+  UIPC_Ioctl(*uipc_, kChannel, UIPC_SET_RX_BATCH_SIZE, (void*)64);
+  Send("0123456789");
+  EXPECT_EQ(Read(2), "01");
+  close(client_fd_);
+  client_fd_ = -1;
+
+  EXPECT_EQ(Read(20), "23456789");
+  EXPECT_EQ(Read(20), "");
+  ASSERT_TRUE(WaitForEvent(UIPC_CLOSE_EVT));
+}
+
+}  // namespace
@@ -32,8 +32,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/mman.h>
+#include <sys/epoll.h>
 #include <sys/prctl.h>
-#include <sys/select.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/un.h>
@@ -52,7 +52,7 @@
  *  Constants & Macros
  *****************************************************************************/
 
-#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
 
 #define CASE_RETURN_STR(const) \
   case const:                  \
@@ -60,10 +60,15 @@
 
 #define UIPC_DISCONNECTED (-1)
 
-#define SAFE_FD_ISSET(fd, set) (((fd) == -1) ? false : FD_ISSET((fd), (set)))
-
 #define UIPC_FLUSH_BUFFER_SIZE 1024
 
+#define UIPC_EPOLL_MAX_EVENTS 8
+
+/* epoll event data: the kind of fd, and its channel */
+#define UIPC_EPOLL_TAG(kind, ch_id) (((kind) << 8) | (ch_id))
+#define UIPC_EPOLL_TAG_KIND(tag) ((tag) >> 8)
+#define UIPC_EPOLL_TAG_CH_ID(tag) ((tag)&0xff)
+
 /*****************************************************************************
  *  Local type definitions
  *****************************************************************************/
@@ -72,6 +77,17 @@ typedef enum {
   UIPC_TASK_FLAG_DISCONNECT_CHAN = 0x1,
 } tUIPC_TASK_FLAGS;
 
+typedef enum {
+  UIPC_READY_FLAG_ACCEPT = 0x1, /* incoming connection on the server socket */
+  UIPC_READY_FLAG_RX = 0x2,     /* data received on the connection */
+} tUIPC_READY_FLAGS;
+
+typedef enum {
+  UIPC_EPOLL_SIGNAL,
+  UIPC_EPOLL_SERVER,
+  UIPC_EPOLL_CONNECTION,
+} tUIPC_EPOLL_KIND;
+
 /*****************************************************************************
  *  Static functions
  *****************************************************************************/
@@ -165,6 +181,49 @@ static int accept_server_socket(int sfd) {
   return fd;
 }
 
+/*****************************************************************************
+ *   epoll helper functions
+ ****************************************************************************/
+
+static void uipc_epoll_add_locked(tUIPC_STATE& uipc, int fd, uint32_t events,
+                                  uint32_t tag) {
+  struct epoll_event ev;
+  memset(&ev, 0, sizeof(ev));
+  ev.events = events;
+  ev.data.u32 = tag;
+
+  if (epoll_ctl(uipc.epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+    LOG_ERROR("epoll_ctl add fd %d failed (%s)", fd, strerror(errno));
+  }
+}
+
+static void uipc_epoll_del_locked(tUIPC_STATE& uipc, int fd) {
+  if (epoll_ctl(uipc.epoll_fd, EPOLL_CTL_DEL, fd, NULL) < 0) {
+    LOG_ERROR("epoll_ctl del fd %d failed (%s)", fd, strerror(errno));
+  }
+}
+
+/* Stop watching the connection of a channel */
+static void uipc_unwatch_fd_locked(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id) {
+  tUIPC_CHAN* p = &uipc.ch[ch_id];
+
+  if (p->fd_watched) {
+    uipc_epoll_del_locked(uipc, p->fd);
+    p->fd_watched = false;
+  }
+  p->ready_flags &= ~UIPC_READY_FLAG_RX;
+}
+
+static bool uipc_fd_readable(int fd) {
+  struct pollfd pfd;
+  pfd.fd = fd;
+  pfd.events = POLLIN;
+
+  int ret;
+  OSI_NO_INTR(ret = poll(&pfd, 1, 0));
+  return ret > 0 && (pfd.revents & POLLIN);
+}
+
 /*****************************************************************************
  *
  *   uipc helper functions
@@ -178,28 +237,34 @@ static int uipc_main_init(tUIPC_STATE& uipc) {
 
   uipc.tid = 0;
   uipc.running = 0;
-  memset(&uipc.active_set, 0, sizeof(uipc.active_set));
-  memset(&uipc.read_set, 0, sizeof(uipc.read_set));
-  uipc.max_fd = 0;
   memset(&uipc.signal_fds, 0, sizeof(uipc.signal_fds));
   memset(&uipc.ch, 0, sizeof(uipc.ch));
 
-  /* setup interrupt socket pair */
-  if (socketpair(AF_UNIX, SOCK_STREAM, 0, uipc.signal_fds) < 0) {
-    return -1;
-  }
-
-  FD_SET(uipc.signal_fds[0], &uipc.active_set);
-  uipc.max_fd = MAX(uipc.max_fd, uipc.signal_fds[0]);
-
   for (i = 0; i < UIPC_CH_NUM; i++) {
     tUIPC_CHAN* p = &uipc.ch[i];
     p->srvfd = UIPC_DISCONNECTED;
     p->fd = UIPC_DISCONNECTED;
     p->task_evt_flags = 0;
+    p->ready_flags = 0;
+    p->fd_watched = false;
     p->cback = NULL;
+    p->rx_batch_fd = UIPC_DISCONNECTED;
+  }
+
+  uipc.epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (uipc.epoll_fd < 0) {
+    LOG_ERROR("epoll_create1 failed (%s)", strerror(errno));
+    return -1;
   }
 
+  /* setup interrupt socket pair */
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, uipc.signal_fds) < 0) {
+    return -1;
+  }
+
+  uipc_epoll_add_locked(uipc, uipc.signal_fds[0], EPOLLIN,
+                        UIPC_EPOLL_TAG(UIPC_EPOLL_SIGNAL, 0));
+
   return 0;
 }
 
@@ -212,7 +277,17 @@ void uipc_main_cleanup(tUIPC_STATE& uipc) {
   close(uipc.signal_fds[1]);
 
   /* close any open channels */
-  for (i = 0; i < UIPC_CH_NUM; i++) uipc_close_ch_locked(uipc, i);
+  for (i = 0; i < UIPC_CH_NUM; i++) {
+    uipc_close_ch_locked(uipc, i);
+    UIPC_ShmRingFree(uipc.ch[i].shm_ring);
+    uipc.ch[i].shm_ring = NULL;
+    free(uipc.ch[i].rx_batch_buf);
+    uipc.ch[i].rx_batch_buf = NULL;
+    uipc.ch[i].rx_batch_size = 0;
+  }
+
+  close(uipc.epoll_fd);
+  uipc.epoll_fd = UIPC_DISCONNECTED;
 }
 
 /* check pending events in read task */
@@ -229,17 +304,48 @@ static void uipc_check_task_flags_locked(tUIPC_STATE& uipc) {
   }
 }
 
+static void uipc_check_interrupt_locked(tUIPC_STATE& uipc) {
+  char sig_recv = 0;
+  OSI_NO_INTR(
+      recv(uipc.signal_fds[0], &sig_recv, sizeof(sig_recv), MSG_WAITALL));
+}
+
+/* record the readiness reported by epoll, processed by
+ * uipc_check_fd_locked() */
+static void uipc_check_epoll_event_locked(tUIPC_STATE& uipc,
+                                          const struct epoll_event& ev) {
+  tUIPC_CH_ID ch_id = UIPC_EPOLL_TAG_CH_ID(ev.data.u32);
+
+  switch (UIPC_EPOLL_TAG_KIND(ev.data.u32)) {
+    case UIPC_EPOLL_SIGNAL:
+      uipc_check_interrupt_locked(uipc);
+      break;
+
+    case UIPC_EPOLL_SERVER:
+      uipc.ch[ch_id].ready_flags |= UIPC_READY_FLAG_ACCEPT;
+      break;
+
+    case UIPC_EPOLL_CONNECTION:
+      /* the connection may have been unwatched since epoll_wait() */
+      if (uipc.ch[ch_id].fd_watched)
+        uipc.ch[ch_id].ready_flags |= UIPC_READY_FLAG_RX;
+      break;
+  }
+}
+
 static int uipc_check_fd_locked(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id) {
   if (ch_id >= UIPC_CH_NUM) return -1;
 
-  if (SAFE_FD_ISSET(uipc.ch[ch_id].srvfd, &uipc.read_set)) {
+  if (uipc.ch[ch_id].ready_flags & UIPC_READY_FLAG_ACCEPT) {
+    uipc.ch[ch_id].ready_flags &= ~UIPC_READY_FLAG_ACCEPT;
+
     LOG_DEBUG("INCOMING CONNECTION ON CH %d", ch_id);
 
     // Close the previous connection
     if (uipc.ch[ch_id].fd != UIPC_DISCONNECTED) {
       LOG_DEBUG("CLOSE CONNECTION (FD %d)", uipc.ch[ch_id].fd);
+      uipc_unwatch_fd_locked(uipc, ch_id);
       close(uipc.ch[ch_id].fd);
-      FD_CLR(uipc.ch[ch_id].fd, &uipc.active_set);
       uipc.ch[ch_id].fd = UIPC_DISCONNECTED;
     }
 
@@ -248,11 +354,13 @@ static int uipc_check_fd_locked(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id) {
     LOG_DEBUG("NEW FD %d", uipc.ch[ch_id].fd);
 
     if ((uipc.ch[ch_id].fd >= 0) && uipc.ch[ch_id].cback) {
-      /*  if we have a callback we should add this fd to the active set
-          and notify user with callback event */
-      LOG_DEBUG("ADD FD %d TO ACTIVE SET", uipc.ch[ch_id].fd);
-      FD_SET(uipc.ch[ch_id].fd, &uipc.active_set);
-      uipc.max_fd = MAX(uipc.max_fd, uipc.ch[ch_id].fd);
+      /*  if we have a callback we should watch this fd and notify user with
+          callback event. The fd is edge triggered: the readiness is tracked
+          in ready_flags until the data is consumed. */
+      LOG_DEBUG("WATCH FD %d", uipc.ch[ch_id].fd);
+      uipc_epoll_add_locked(uipc, uipc.ch[ch_id].fd, EPOLLIN | EPOLLET,
+                            UIPC_EPOLL_TAG(UIPC_EPOLL_CONNECTION, ch_id));
+      uipc.ch[ch_id].fd_watched = true;
     }
 
     if (uipc.ch[ch_id].fd < 0) {
@@ -263,20 +371,25 @@ static int uipc_check_fd_locked(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id) {
     if (uipc.ch[ch_id].cback) uipc.ch[ch_id].cback(ch_id, UIPC_OPEN_EVT);
   }
 
-  if (SAFE_FD_ISSET(uipc.ch[ch_id].fd, &uipc.read_set)) {
+  if (uipc.ch[ch_id].ready_flags & UIPC_READY_FLAG_RX) {
+    uipc.ch[ch_id].ready_flags &= ~UIPC_READY_FLAG_RX;
 
     if (uipc.ch[ch_id].cback)
       uipc.ch[ch_id].cback(ch_id, UIPC_RX_DATA_READY_EVT);
+
+    /* no new edge is reported for the data left in the socket: keep the
+       channel ready until the callback consumed all of it */
+    if (uipc.ch[ch_id].fd_watched && uipc_fd_readable(uipc.ch[ch_id].fd))
+      uipc.ch[ch_id].ready_flags |= UIPC_READY_FLAG_RX;
   }
   return 0;
 }
 
-static void uipc_check_interrupt_locked(tUIPC_STATE& uipc) {
-  if (SAFE_FD_ISSET(uipc.signal_fds[0], &uipc.read_set)) {
-    char sig_recv = 0;
-    OSI_NO_INTR(
-        recv(uipc.signal_fds[0], &sig_recv, sizeof(sig_recv), MSG_WAITALL));
+static bool uipc_check_ready_locked(tUIPC_STATE& uipc) {
+  for (int i = 0; i < UIPC_CH_NUM; i++) {
+    if (uipc.ch[i].ready_flags) return true;
   }
+  return false;
 }
 
 static inline void uipc_wakeup_locked(tUIPC_STATE& uipc) {
@@ -303,17 +416,14 @@ static int uipc_setup_server_locked(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id,
     return -1;
   }
 
-  LOG_DEBUG("ADD SERVER FD TO ACTIVE SET %d", fd);
-  FD_SET(fd, &uipc.active_set);
-  uipc.max_fd = MAX(uipc.max_fd, fd);
+  LOG_DEBUG("WATCH SERVER FD %d", fd);
+  uipc_epoll_add_locked(uipc, fd, EPOLLIN,
+                        UIPC_EPOLL_TAG(UIPC_EPOLL_SERVER, ch_id));
 
   uipc.ch[ch_id].srvfd = fd;
   uipc.ch[ch_id].cback = cback;
   uipc.ch[ch_id].read_poll_tmo_ms = DEFAULT_READ_POLL_TMO_MS;
 
-  /* trigger main thread to update read set */
-  uipc_wakeup_locked(uipc);
-
   return 0;
 }
 
@@ -354,9 +464,31 @@ static void uipc_flush_ch_locked(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id) {
   }
 }
 
+static void uipc_set_rx_batch_size_locked(tUIPC_STATE& uipc,
+                                          tUIPC_CH_ID ch_id, uint32_t size) {
+  if (ch_id >= UIPC_CH_NUM) return;
+
+  tUIPC_CHAN* p = &uipc.ch[ch_id];
+  if (size != p->rx_batch_size) {
+    free(p->rx_batch_buf);
+    p->rx_batch_buf = (size > 0) ? (uint8_t*)malloc(size) : NULL;
+    p->rx_batch_size = (p->rx_batch_buf != NULL) ? size : 0;
+  }
+  p->rx_batch_len = 0;
+  p->rx_batch_offset = 0;
+  p->rx_batch_fd = p->fd;
+}
+
 static void uipc_flush_locked(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id) {
   if (ch_id >= UIPC_CH_NUM) return;
 
+  uipc.ch[ch_id].rx_batch_len = 0;
+  uipc.ch[ch_id].rx_batch_offset = 0;
+
+  if (uipc.ch[ch_id].shm_ring != NULL && uipc.ch[ch_id].shm_ring->attached) {
+    UIPC_ShmRingFlush(uipc.ch[ch_id].shm_ring);
+  }
+
   switch (ch_id) {
     case UIPC_CH_ID_AV_CTRL:
       uipc_flush_ch_locked(uipc, UIPC_CH_ID_AV_CTRL);
@@ -369,34 +501,34 @@ static void uipc_flush_locked(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id) {
 }
 
 static int uipc_close_ch_locked(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id) {
-  int wakeup = 0;
-
   LOG_DEBUG("CLOSE CHANNEL %d", ch_id);
 
   if (ch_id >= UIPC_CH_NUM) return -1;
 
   if (uipc.ch[ch_id].srvfd != UIPC_DISCONNECTED) {
     LOG_DEBUG("CLOSE SERVER (FD %d)", uipc.ch[ch_id].srvfd);
+    uipc_epoll_del_locked(uipc, uipc.ch[ch_id].srvfd);
     close(uipc.ch[ch_id].srvfd);
-    FD_CLR(uipc.ch[ch_id].srvfd, &uipc.active_set);
     uipc.ch[ch_id].srvfd = UIPC_DISCONNECTED;
-    wakeup = 1;
   }
 
   if (uipc.ch[ch_id].fd != UIPC_DISCONNECTED) {
     LOG_DEBUG("CLOSE CONNECTION (FD %d)", uipc.ch[ch_id].fd);
+    uipc_unwatch_fd_locked(uipc, ch_id);
     close(uipc.ch[ch_id].fd);
-    FD_CLR(uipc.ch[ch_id].fd, &uipc.active_set);
     uipc.ch[ch_id].fd = UIPC_DISCONNECTED;
-    wakeup = 1;
+  }
+  uipc.ch[ch_id].ready_flags = 0;
+
+  /* the ring stays mapped as UIPC_Read() may still be accessing it, it is
+     only unmapped when replaced or on cleanup */
+  if (uipc.ch[ch_id].shm_ring != NULL) {
+    UIPC_ShmRingDetach(uipc.ch[ch_id].shm_ring);
   }
 
   /* notify this connection is closed */
   if (uipc.ch[ch_id].cback) uipc.ch[ch_id].cback(ch_id, UIPC_CLOSE_EVT);
 
-  /* trigger main thread update if something was updated */
-  if (wakeup) uipc_wakeup_locked(uipc);
-
   return 0;
 }
 
@@ -413,6 +545,8 @@ void uipc_close_locked(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id) {
 
 static void* uipc_read_task(void* arg) {
   tUIPC_STATE& uipc = *((tUIPC_STATE*)arg);
+  struct epoll_event events[UIPC_EPOLL_MAX_EVENTS];
+  bool ready = false;
   int ch_id;
   int result;
 
@@ -421,17 +555,13 @@ static void* uipc_read_task(void* arg) {
   raise_priority_a2dp(TASK_UIPC_READ);
 
   while (uipc.running) {
-    uipc.read_set = uipc.active_set;
+    /* don't block while some channels are still ready */
+    result = epoll_wait(uipc.epoll_fd, events, UIPC_EPOLL_MAX_EVENTS,
+                        ready ? 0 : -1);
 
-    result = select(uipc.max_fd + 1, &uipc.read_set, NULL, NULL, NULL);
-
-    if (result == 0) {
-      LOG_DEBUG("select timeout");
-      continue;
-    }
     if (result < 0) {
       if (errno != EINTR) {
-        LOG_DEBUG("select failed %s", strerror(errno));
+        LOG_DEBUG("epoll_wait failed %s", strerror(errno));
       }
       continue;
     }
@@ -439,8 +569,10 @@ static void* uipc_read_task(void* arg) {
     {
       std::lock_guard<std::recursive_mutex> guard(uipc.mutex);
 
-      /* clear any wakeup interrupt */
-      uipc_check_interrupt_locked(uipc);
+      /* clear any wakeup interrupt, and record the channels ready */
+      for (int i = 0; i < result; i++) {
+        uipc_check_epoll_event_locked(uipc, events[i]);
+      }
 
       /* check pending task events */
       uipc_check_task_flags_locked(uipc);
@@ -452,6 +584,8 @@ static void* uipc_read_task(void* arg) {
       for (ch_id = 0; ch_id < UIPC_CH_NUM; ch_id++) {
         if (ch_id != UIPC_CH_ID_AV_AUDIO) uipc_check_fd_locked(uipc, ch_id);
       }
+
+      ready = uipc_check_ready_locked(uipc);
     }
   }
 
@@ -544,6 +678,43 @@ bool UIPC_Open(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id, tUIPC_RCV_CBACK* p_cback,
   return true;
 }
 
+/*******************************************************************************
+ **
+ ** Function         UIPC_OpenShmRing
+ **
+ ** Description      Add a shared memory ring to an open UIPC channel
+ **
+ ** Returns          true in case of success, false in case of failure.
+ **
+ ******************************************************************************/
+bool UIPC_OpenShmRing(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id,
+                      const char* ring_path, uint32_t size) {
+  LOG_DEBUG("UIPC_OpenShmRing : ch_id %d", ch_id);
+
+  std::lock_guard<std::recursive_mutex> lock(uipc.mutex);
+
+  if (ch_id >= UIPC_CH_NUM) {
+    return false;
+  }
+
+  tUIPC_CHAN* p = &uipc.ch[ch_id];
+  if (p->srvfd == UIPC_DISCONNECTED) {
+    LOG_ERROR("UIPC_OpenShmRing : channel %d closed", ch_id);
+    return false;
+  }
+
+  if (p->shm_ring != NULL && p->shm_ring->attached) {
+    LOG_DEBUG("SHM RING OF CHANNEL %d ALREADY OPEN", ch_id);
+    return true;
+  }
+
+  /* Release the ring of the previous session */
+  UIPC_ShmRingFree(p->shm_ring);
+  p->shm_ring = UIPC_ShmRingCreate(ring_path, size);
+
+  return p->shm_ring != NULL;
+}
+
 /*******************************************************************************
  **
  ** Function         UIPC_Close
@@ -619,7 +790,44 @@ uint32_t UIPC_Read(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id, uint8_t* p_buf,
     return 0;
   }
 
+  tUIPC_SHM_RING* ring = uipc.ch[ch_id].shm_ring;
+  if (ring != NULL && UIPC_ShmRingIsConnected(ring)) {
+    n_read =
+        UIPC_ShmRingRead(ring, p_buf, len, uipc.ch[ch_id].read_poll_tmo_ms);
+    if (n_read < (int)len) {
+      /* the socket is not read anymore: check if the peer went away without
+         detaching from the ring */
+      pfd.fd = fd;
+      pfd.events = POLLHUP;
+      int poll_ret;
+      OSI_NO_INTR(poll_ret = poll(&pfd, 1, 0));
+      if (poll_ret > 0 && (pfd.revents & (POLLHUP | POLLNVAL))) {
+        LOG_WARN("UIPC_Read : channel detached remotely");
+        std::lock_guard<std::recursive_mutex> lock(uipc.mutex);
+        uipc_close_locked(uipc, ch_id);
+      }
+    }
+    return n_read;
+  }
+
+  tUIPC_CHAN* p = &uipc.ch[ch_id];
+  if (p->rx_batch_fd != fd) {
+    /* drop the data batched from a previous connection */
+    p->rx_batch_len = 0;
+    p->rx_batch_offset = 0;
+    p->rx_batch_fd = fd;
+  }
+
   while (n_read < (int)len) {
+    /* serve the data drained from the socket by a previous read first */
+    if (p->rx_batch_offset < p->rx_batch_len) {
+      uint32_t n = MIN(len - n_read, p->rx_batch_len - p->rx_batch_offset);
+      memcpy(p_buf + n_read, p->rx_batch_buf + p->rx_batch_offset, n);
+      p->rx_batch_offset += n;
+      n_read += n;
+      continue;
+    }
+
     pfd.fd = fd;
     pfd.events = POLLIN | POLLHUP;
 
@@ -638,7 +846,13 @@ uint32_t UIPC_Read(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id, uint8_t* p_buf,
       break;
     }
 
-    if (pfd.revents & (POLLHUP | POLLNVAL)) {
+    /* the data sent before the hang up is still read, recv() then reports
+       the end of the stream */
+    if ((pfd.revents & POLLNVAL) ||
+        ((pfd.revents & POLLHUP) && !(pfd.revents & POLLIN))) {
+      /* return the data read so far, the next call reports the hang up */
+      if (n_read > 0) break;
+
       LOG_WARN("poll : channel detached remotely");
       std::lock_guard<std::recursive_mutex> lock(uipc.mutex);
       uipc_close_locked(uipc, ch_id);
@@ -646,7 +860,22 @@ uint32_t UIPC_Read(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id, uint8_t* p_buf,
     }
 
     ssize_t n;
-    OSI_NO_INTR(n = recv(fd, p_buf + n_read, len - n_read, 0));
+    if (p->rx_batch_size > 0) {
+      /* drain all the data ready in a single call */
+      OSI_NO_INTR(
+          n = recv(fd, p->rx_batch_buf, p->rx_batch_size, MSG_DONTWAIT));
+      if (n > 0) {
+        p->rx_batch_len = n;
+        p->rx_batch_offset = 0;
+        continue;
+      }
+    } else {
+      OSI_NO_INTR(n = recv(fd, p_buf + n_read, len - n_read, 0));
+    }
+
+    /* return the data read so far, the next call reports the end of the
+       stream or the error */
+    if (n <= 0 && n_read > 0) break;
 
     if (n == 0) {
       LOG_WARN("UIPC_Read : channel detached remotely");
@@ -687,13 +916,9 @@ extern bool UIPC_Ioctl(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id, uint32_t request,
       break;
 
     case UIPC_REG_REMOVE_ACTIVE_READSET:
-      /* user will read data directly and not use select loop */
+      /* user will read data directly and not use epoll loop */
       if (uipc.ch[ch_id].fd != UIPC_DISCONNECTED) {
-        /* remove this channel from active set */
-        FD_CLR(uipc.ch[ch_id].fd, &uipc.active_set);
-
-        /* refresh active set */
-        uipc_wakeup_locked(uipc);
+        uipc_unwatch_fd_locked(uipc, ch_id);
       }
       break;
 
@@ -703,6 +928,12 @@ extern bool UIPC_Ioctl(tUIPC_STATE& uipc, tUIPC_CH_ID ch_id, uint32_t request,
                 uipc.ch[ch_id].read_poll_tmo_ms);
       break;
 
+    case UIPC_SET_RX_BATCH_SIZE:
+      uipc_set_rx_batch_size_locked(uipc, ch_id, (intptr_t)param);
+      LOG_DEBUG("UIPC_SET_RX_BATCH_SIZE : CH %d, SIZE %u", ch_id,
+                uipc.ch[ch_id].rx_batch_size);
+      break;
+
     default:
       LOG_DEBUG("UIPC_Ioctl : request not handled (%d)", request);
       break;
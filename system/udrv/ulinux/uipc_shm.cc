@@ -0,0 +1,466 @@
+/******************************************************************************
+ *
+ *  Copyright 2026 The Android Open Source Project
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at:
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ ******************************************************************************/
+
+/*****************************************************************************
+ *
+ *  Filename:      uipc_shm.cc
+ *
+ *  Description:   Shared memory ring transport for UIPC
+ *
+ *****************************************************************************/
+
+#include "uipc_shm.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <linux/futex.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "osi/include/log.h"
+#include "osi/include/osi.h"
+
+/*****************************************************************************
+ *   futex helper functions
+ ****************************************************************************/
+
+/* The futexes are shared between processes: FUTEX_PRIVATE_FLAG can't be
+ * used. */
+static void uipc_shm_futex_wait(std::atomic<uint32_t>* addr, uint32_t val,
+                                int timeout_ms) {
+  struct timespec ts;
+  ts.tv_sec = timeout_ms / 1000;
+  ts.tv_nsec = (timeout_ms % 1000) * 1000000L;
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAIT, val, &ts,
+          nullptr, 0);
+}
+
+static void uipc_shm_futex_wake(std::atomic<uint32_t>* addr) {
+  syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAKE, INT_MAX,
+          nullptr, nullptr, 0);
+}
+
+static uint64_t uipc_shm_now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/* Signal |event| if the peer announced it sleeps on it. Together with the
+ * sleeper setting |waiting| before checking the ring (both sequentially
+ * consistent), this guarantees that a wake up is never missed. */
+static void uipc_shm_notify(std::atomic<uint32_t>* waiting,
+                            std::atomic<uint32_t>* event) {
+  if (waiting->load() == 0) return;
+  event->fetch_add(1);
+  uipc_shm_futex_wake(event);
+}
+
+/*****************************************************************************
+ *   ring helper functions
+ ****************************************************************************/
+
+/* Load the positions of the ring. The header is shared with the peer
+ * process, which can write anything to it: positions more than the ring size
+ * apart would make the caller access memory past the data mapping. Such a
+ * ring is detached, which also ends the waits of both sides.
+ * Returns false if the positions are corrupt. */
+static bool uipc_shm_load_positions(tUIPC_SHM_RING* ring, uint32_t* read_pos,
+                                    uint32_t* write_pos) {
+  *read_pos = ring->hdr->read_pos.load();
+  *write_pos = ring->hdr->write_pos.load();
+  if (*write_pos - *read_pos <= ring->size) return true;
+
+  if (ring->attached) {
+    LOG_ERROR("%s: corrupt ring %s, read %u write %u, detaching", __func__,
+              ring->path.c_str(), *read_pos, *write_pos);
+    UIPC_ShmRingDetach(ring);
+  }
+  return false;
+}
+
+static uint32_t uipc_shm_readable(tUIPC_SHM_RING* ring) {
+  uint32_t read_pos, write_pos;
+  if (!uipc_shm_load_positions(ring, &read_pos, &write_pos)) return 0;
+  return write_pos - read_pos;
+}
+
+static uint32_t uipc_shm_writable(tUIPC_SHM_RING* ring) {
+  uint32_t read_pos, write_pos;
+  if (!uipc_shm_load_positions(ring, &read_pos, &write_pos)) return 0;
+  return ring->size - (write_pos - read_pos);
+}
+
+/* Wait up to |timeout_ms| for |available| to return a non zero value, while
+ * both sides are attached. Returns the last value of |available|. */
+static uint32_t uipc_shm_wait(tUIPC_SHM_RING* ring,
+                              std::atomic<uint32_t>* event,
+                              std::atomic<uint32_t>* waiting,
+                              uint32_t (*available)(tUIPC_SHM_RING*),
+                              int timeout_ms) {
+  uint64_t deadline_ms = uipc_shm_now_ms() + timeout_ms;
+  uint32_t n;
+
+  while (true) {
+    uint32_t val = event->load();
+    waiting->store(1);
+
+    n = available(ring);
+    if (n > 0 || !UIPC_ShmRingIsConnected(ring)) break;
+
+    uint64_t now_ms = uipc_shm_now_ms();
+    if (now_ms >= deadline_ms) break;
+
+    uipc_shm_futex_wait(event, val, (int)(deadline_ms - now_ms));
+  }
+
+  waiting->store(0);
+  return n;
+}
+
+static void uipc_shm_unmap(tUIPC_SHM_RING* ring) {
+  if (ring->data != nullptr) munmap(ring->data, 2 * ring->size);
+  if (ring->hdr != nullptr) munmap(ring->hdr, UIPC_SHM_RING_HEADER_SIZE);
+  ring->data = nullptr;
+  ring->hdr = nullptr;
+}
+
+/* Map the header and the data of the ring backed by |fd|, the data being
+ * mapped twice in a row. */
+static bool uipc_shm_map(tUIPC_SHM_RING* ring, int fd, uint32_t size) {
+  void* hdr = mmap(nullptr, UIPC_SHM_RING_HEADER_SIZE, PROT_READ | PROT_WRITE,
+                   MAP_SHARED, fd, 0);
+  if (hdr == MAP_FAILED) {
+    LOG_ERROR("%s: unable to map header: %s", __func__, strerror(errno));
+    return false;
+  }
+  ring->hdr = (tUIPC_SHM_RING_HEADER*)hdr;
+
+  uint8_t* data = (uint8_t*)mmap(nullptr, 2 * size, PROT_NONE,
+                                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (data == MAP_FAILED) {
+    LOG_ERROR("%s: unable to reserve data: %s", __func__, strerror(errno));
+    uipc_shm_unmap(ring);
+    return false;
+  }
+  ring->data = data;
+  ring->size = size;
+
+  for (uint8_t* p = data; p < data + 2 * size; p += size) {
+    if (mmap(p, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd,
+             UIPC_SHM_RING_HEADER_SIZE) == MAP_FAILED) {
+      LOG_ERROR("%s: unable to map data: %s", __func__, strerror(errno));
+      uipc_shm_unmap(ring);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/*******************************************************************************
+ **
+ ** Function         UIPC_ShmRingCreate
+ **
+ ** Description      Create a ring to be read by the caller
+ **
+ ** Returns          the ring, nullptr in case of failure.
+ **
+ ******************************************************************************/
+tUIPC_SHM_RING* UIPC_ShmRingCreate(const char* path, uint32_t size) {
+  uint32_t ring_size = UIPC_SHM_RING_HEADER_SIZE;
+  while (ring_size < size) ring_size <<= 1;
+
+  unlink(path);
+  int fd;
+  OSI_NO_INTR(fd = open(path, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0660));
+  if (fd < 0) {
+    LOG_ERROR("%s: unable to create %s: %s", __func__, path, strerror(errno));
+    return nullptr;
+  }
+
+  tUIPC_SHM_RING* ring = new tUIPC_SHM_RING{};
+  ring->is_reader = true;
+  ring->path = path;
+
+  if (ftruncate(fd, UIPC_SHM_RING_HEADER_SIZE + ring_size) < 0) {
+    LOG_ERROR("%s: unable to size %s: %s", __func__, path, strerror(errno));
+  } else if (uipc_shm_map(ring, fd, ring_size)) {
+    /* The file is zero filled: only the immutable fields need to be
+       written. The magic is written last, marking the ring valid. */
+    ring->hdr->size = ring_size;
+    ring->hdr->version = UIPC_SHM_RING_VERSION;
+    ring->hdr->reader_attached.store(1);
+    ring->attached = true;
+    std::atomic_thread_fence(std::memory_order_release);
+    ring->hdr->magic = UIPC_SHM_RING_MAGIC;
+  }
+  close(fd);
+
+  if (ring->hdr == nullptr) {
+    unlink(path);
+    delete ring;
+    return nullptr;
+  }
+
+  LOG_INFO("%s: created %s (%u bytes)", __func__, path, ring_size);
+  return ring;
+}
+
+/*******************************************************************************
+ **
+ ** Function         UIPC_ShmRingMap
+ **
+ ** Description      Map a ring created by the reader
+ **
+ ** Returns          the ring, nullptr in case of failure.
+ **
+ ******************************************************************************/
+tUIPC_SHM_RING* UIPC_ShmRingMap(const char* path) {
+  int fd;
+  OSI_NO_INTR(fd = open(path, O_RDWR | O_CLOEXEC));
+  if (fd < 0) {
+    LOG_INFO("%s: unable to open %s: %s", __func__, path, strerror(errno));
+    return nullptr;
+  }
+
+  /* Check the immutable fields of the header before trusting the size of
+     the mapping */
+  uint32_t hdr[3]; /* magic, version, size */
+  struct stat st;
+  ssize_t ret;
+  OSI_NO_INTR(ret = pread(fd, hdr, sizeof(hdr), 0));
+  uint32_t size = hdr[2];
+  if (ret != (ssize_t)sizeof(hdr) || fstat(fd, &st) < 0 ||
+      hdr[0] != UIPC_SHM_RING_MAGIC || hdr[1] != UIPC_SHM_RING_VERSION ||
+      size < UIPC_SHM_RING_HEADER_SIZE || (size & (size - 1)) != 0 ||
+      st.st_size != (off_t)(UIPC_SHM_RING_HEADER_SIZE + size)) {
+    LOG_ERROR("%s: invalid ring %s", __func__, path);
+    close(fd);
+    return nullptr;
+  }
+
+  tUIPC_SHM_RING* ring = new tUIPC_SHM_RING{};
+  ring->is_reader = false;
+  ring->path = path;
+
+  bool mapped = uipc_shm_map(ring, fd, size);
+  close(fd);
+  if (!mapped) {
+    delete ring;
+    return nullptr;
+  }
+
+  LOG_INFO("%s: mapped %s (%u bytes)", __func__, path, ring->size);
+  return ring;
+}
+
+/*******************************************************************************
+ **
+ ** Function         UIPC_ShmRingFree
+ **
+ ** Description      Detach and unmap a ring
+ **
+ ** Returns          void
+ **
+ ******************************************************************************/
+void UIPC_ShmRingFree(tUIPC_SHM_RING* ring) {
+  if (ring == nullptr) return;
+
+  UIPC_ShmRingDetach(ring);
+  uipc_shm_unmap(ring);
+  delete ring;
+}
+
+/*******************************************************************************
+ **
+ ** Function         UIPC_ShmRingAttach
+ **
+ ** Description      Attach the caller to its side of the ring
+ **
+ ** Returns          void
+ **
+ ******************************************************************************/
+void UIPC_ShmRingAttach(tUIPC_SHM_RING* ring) {
+  if (ring->attached) return;
+
+  /* Once detached, the file of the reader is removed */
+  if (ring->is_reader) {
+    LOG_ERROR("%s: ring %s was closed", __func__, ring->path.c_str());
+    return;
+  }
+
+  ring->hdr->writer_attached.store(1);
+  ring->attached = true;
+}
+
+/*******************************************************************************
+ **
+ ** Function         UIPC_ShmRingDetach
+ **
+ ** Description      Detach the caller from its side of the ring, and wake up
+ **                  the peer.
+ **
+ ** Returns          void
+ **
+ ******************************************************************************/
+void UIPC_ShmRingDetach(tUIPC_SHM_RING* ring) {
+  if (!ring->attached) return;
+  ring->attached = false;
+
+  if (ring->is_reader) {
+    ring->hdr->reader_attached.store(0);
+    unlink(ring->path.c_str());
+  } else {
+    ring->hdr->writer_attached.store(0);
+  }
+
+  /* Wake up both sides: the detach may happen while another thread of the
+     caller is waiting on the ring */
+  ring->hdr->reader_event.fetch_add(1);
+  uipc_shm_futex_wake(&ring->hdr->reader_event);
+  ring->hdr->writer_event.fetch_add(1);
+  uipc_shm_futex_wake(&ring->hdr->writer_event);
+}
+
+bool UIPC_ShmRingIsPeerAttached(const tUIPC_SHM_RING* ring) {
+  return (ring->is_reader ? ring->hdr->writer_attached.load()
+                          : ring->hdr->reader_attached.load()) != 0;
+}
+
+bool UIPC_ShmRingIsConnected(const tUIPC_SHM_RING* ring) {
+  return ring->hdr->reader_attached.load() != 0 &&
+         ring->hdr->writer_attached.load() != 0;
+}
+
+/*******************************************************************************
+ **
+ ** Function         UIPC_ShmRingWriteSpan / UIPC_ShmRingReadSpan
+ **
+ ** Description      Get the contiguous span that can be written or read.
+ **
+ ** Returns          the size of the span.
+ **
+ ******************************************************************************/
+uint32_t UIPC_ShmRingWriteSpan(tUIPC_SHM_RING* ring, uint8_t** pp) {
+  uint32_t read_pos, write_pos;
+  if (!uipc_shm_load_positions(ring, &read_pos, &write_pos)) {
+    *pp = ring->data;
+    return 0;
+  }
+  *pp = ring->data + (write_pos & (ring->size - 1));
+  return ring->size - (write_pos - read_pos);
+}
+
+void UIPC_ShmRingWriteCommit(tUIPC_SHM_RING* ring, uint32_t len) {
+  ring->hdr->write_pos.fetch_add(len);
+  uipc_shm_notify(&ring->hdr->reader_waiting, &ring->hdr->reader_event);
+}
+
+uint32_t UIPC_ShmRingReadSpan(tUIPC_SHM_RING* ring, const uint8_t** pp) {
+  uint32_t read_pos, write_pos;
+  if (!uipc_shm_load_positions(ring, &read_pos, &write_pos)) {
+    *pp = ring->data;
+    return 0;
+  }
+  *pp = ring->data + (read_pos & (ring->size - 1));
+  return write_pos - read_pos;
+}
+
+void UIPC_ShmRingReadCommit(tUIPC_SHM_RING* ring, uint32_t len) {
+  ring->hdr->read_pos.fetch_add(len);
+  uipc_shm_notify(&ring->hdr->writer_waiting, &ring->hdr->writer_event);
+}
+
+/*******************************************************************************
+ **
+ ** Function         UIPC_ShmRingWrite
+ **
+ ** Description      Copy a buffer into the ring.
+ **
+ ** Returns          the number of bytes written.
+ **
+ ******************************************************************************/
+uint32_t UIPC_ShmRingWrite(tUIPC_SHM_RING* ring, const uint8_t* p_buf,
+                           uint32_t len, int timeout_ms) {
+  uint32_t n_written = 0;
+
+  while (n_written < len && UIPC_ShmRingIsConnected(ring)) {
+    uint8_t* p;
+    uint32_t n = UIPC_ShmRingWriteSpan(ring, &p);
+    if (n == 0) {
+      n = uipc_shm_wait(ring, &ring->hdr->writer_event,
+                        &ring->hdr->writer_waiting, uipc_shm_writable,
+                        timeout_ms);
+      if (n == 0) break;
+      continue;
+    }
+
+    n = std::min(n, len - n_written);
+    memcpy(p, p_buf + n_written, n);
+    UIPC_ShmRingWriteCommit(ring, n);
+    n_written += n;
+  }
+
+  return n_written;
+}
+
+/*******************************************************************************
+ **
+ ** Function         UIPC_ShmRingRead
+ **
+ ** Description      Copy data out of the ring.
+ **
+ ** Returns          the number of bytes read.
+ **
+ ******************************************************************************/
+uint32_t UIPC_ShmRingRead(tUIPC_SHM_RING* ring, uint8_t* p_buf, uint32_t len,
+                          int timeout_ms) {
+  uint32_t n_read = 0;
+
+  while (n_read < len) {
+    const uint8_t* p;
+    uint32_t n = UIPC_ShmRingReadSpan(ring, &p);
+    if (n == 0) {
+      n = uipc_shm_wait(ring, &ring->hdr->reader_event,
+                        &ring->hdr->reader_waiting, uipc_shm_readable,
+                        timeout_ms);
+      if (n == 0) break;
+      continue;
+    }
+
+    n = std::min(n, len - n_read);
+    memcpy(p_buf + n_read, p, n);
+    UIPC_ShmRingReadCommit(ring, n);
+    n_read += n;
+  }
+
+  return n_read;
+}
+
+void UIPC_ShmRingFlush(tUIPC_SHM_RING* ring) {
+  ring->hdr->read_pos.store(ring->hdr->write_pos.load());
+  uipc_shm_notify(&ring->hdr->writer_waiting, &ring->hdr->writer_event);
+}
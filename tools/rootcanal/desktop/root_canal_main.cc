@@ -21,6 +21,7 @@
 #include <optional>
 
 #include "model/setup/async_manager.h"
+#include "model/setup/clock.h"
 #include "net/posix/posix_async_socket_connector.h"
 #include "net/posix/posix_async_socket_server.h"
 #include "os/log.h"
@@ -37,6 +38,12 @@ DEFINE_string(default_commands_file, "",
               "commands file which root-canal runs it as default");
 DEFINE_bool(enable_hci_sniffer, false, "enable hci sniffer");
 DEFINE_bool(enable_baseband_sniffer, false, "enable baseband sniffer");
+DEFINE_bool(enable_virtual_time, false,
+            "run the tasks without waiting for them to be due, for the "
+            "scenarios that only involve simulated devices");
+DEFINE_uint32(num_phy_shards, 0,
+              "number of threads ticking the devices and delivering their "
+              "packets, 0 to run them on the timer thread");
 
 constexpr uint16_t kTestPort = 6401;
 constexpr uint16_t kHciServerPort = 6402;
@@ -116,6 +123,10 @@ int main(int argc, char** argv) {
       }
     }
   }
+  if (FLAGS_enable_virtual_time) {
+    LOG_INFO("Running in virtual time");
+    rootcanal::Clock::SetVirtualTime(true);
+  }
   AsyncManager am;
   TestEnvironment root_canal(
       std::make_shared<PosixAsyncSocketServer>(test_port, &am),
@@ -124,7 +135,8 @@ int main(int argc, char** argv) {
       std::make_shared<PosixAsyncSocketServer>(link_ble_server_port, &am),
       std::make_shared<PosixAsyncSocketConnector>(&am),
       FLAGS_controller_properties_file, FLAGS_default_commands_file,
-      FLAGS_enable_hci_sniffer, FLAGS_enable_baseband_sniffer);
+      FLAGS_enable_hci_sniffer, FLAGS_enable_baseband_sniffer,
+      FLAGS_num_phy_shards);
   std::promise<void> barrier;
   std::future<void> barrier_future = barrier.get_future();
   root_canal.initialize(std::move(barrier));
@@ -83,6 +83,10 @@ void TestEnvironment::initialize(std::promise<void> barrier) {
   SetUpLinkLayerServer();
   SetUpLinkBleLayerServer();
 
+  if (num_phy_shards_ != 0) {
+    test_model_.SetNumPhyShards(num_phy_shards_);
+  }
+
   if (enable_baseband_sniffer_) {
     std::string filename = "baseband.pcap";
     for (auto i = 0; std::filesystem::exists(filename); i++) {
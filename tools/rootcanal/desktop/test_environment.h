@@ -56,7 +56,8 @@ class TestEnvironment {
                   const std::string& controller_properties_file = "",
                   const std::string& default_commands_file = "",
                   bool enable_hci_sniffer = false,
-                  bool enable_baseband_sniffer = false)
+                  bool enable_baseband_sniffer = false,
+                  size_t num_phy_shards = 0)
       : test_socket_server_(test_port),
         hci_socket_server_(hci_server_port),
         link_socket_server_(link_server_port),
@@ -66,6 +67,7 @@ class TestEnvironment {
         default_commands_file_(default_commands_file),
         enable_hci_sniffer_(enable_hci_sniffer),
         enable_baseband_sniffer_(enable_baseband_sniffer),
+        num_phy_shards_(num_phy_shards),
         controller_(std::make_shared<rootcanal::DualModeController>(
             controller_properties_file)) {}
 
@@ -84,6 +86,7 @@ class TestEnvironment {
   std::string default_commands_file_;
   bool enable_hci_sniffer_;
   bool enable_baseband_sniffer_;
+  size_t num_phy_shards_;
   bool test_channel_open_{false};
   std::promise<void> barrier_;
 
@@ -16,6 +16,8 @@
 
 #include "acl_connection.h"
 
+#include "model/setup/clock.h"
+
 namespace rootcanal {
 AclConnection::AclConnection(AddressWithType address,
                              AddressWithType own_address,
@@ -25,7 +27,7 @@ AclConnection::AclConnection(AddressWithType address,
       own_address_(own_address),
       resolved_address_(resolved_address),
       type_(phy_type),
-      last_packet_timestamp_(std::chrono::steady_clock::now()),
+      last_packet_timestamp_(Clock::now()),
       timeout_(std::chrono::seconds(1)) {}
 
 void AclConnection::Encrypt() { encrypted_ = true; };
@@ -61,13 +63,12 @@ bluetooth::hci::Role AclConnection::GetRole() const { return role_; };
 void AclConnection::SetRole(bluetooth::hci::Role role) { role_ = role; }
 
 void AclConnection::ResetLinkTimer() {
-  last_packet_timestamp_ = std::chrono::steady_clock::now();
+  last_packet_timestamp_ = Clock::now();
 }
 
 std::chrono::steady_clock::duration AclConnection::TimeUntilNearExpiring()
     const {
-  return (last_packet_timestamp_ + timeout_ / 2) -
-         std::chrono::steady_clock::now();
+  return (last_packet_timestamp_ + timeout_ / 2) - Clock::now();
 }
 
 bool AclConnection::IsNearExpiring() const {
@@ -75,7 +76,7 @@ bool AclConnection::IsNearExpiring() const {
 }
 
 std::chrono::steady_clock::duration AclConnection::TimeUntilExpired() const {
-  return (last_packet_timestamp_ + timeout_) - std::chrono::steady_clock::now();
+  return (last_packet_timestamp_ + timeout_) - Clock::now();
 }
 
 bool AclConnection::HasExpired() const {
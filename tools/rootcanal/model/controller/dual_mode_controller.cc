@@ -44,7 +44,7 @@ std::string DualModeController::GetTypeString() const {
 }
 
 void DualModeController::IncomingPacket(
-    model::packets::LinkLayerPacketView incoming) {
+    const model::packets::LinkLayerPacketView& incoming) {
   link_layer_controller_.IncomingPacket(incoming);
 }
 
@@ -68,6 +68,27 @@ void DualModeController::SendCommandCompleteUnknownOpCodeEvent(
                                            std::move(raw_builder_ptr)));
 }
 
+void DualModeController::SetCommandHandler(OpCode op_code,
+                                           CommandHandler handler) {
+  uint16_t opcode = static_cast<uint16_t>(op_code);
+  std::vector<CommandHandler>& ogf_handlers =
+      active_hci_commands_[opcode >> 10];
+  uint16_t ocf = opcode & 0x03FF;
+  if (ogf_handlers.size() <= ocf) {
+    ogf_handlers.resize(ocf + 1, nullptr);
+  }
+  ogf_handlers[ocf] = handler;
+}
+
+DualModeController::CommandHandler DualModeController::GetCommandHandler(
+    OpCode op_code) const {
+  uint16_t opcode = static_cast<uint16_t>(op_code);
+  const std::vector<CommandHandler>& ogf_handlers =
+      active_hci_commands_[opcode >> 10];
+  uint16_t ocf = opcode & 0x03FF;
+  return ocf < ogf_handlers.size() ? ogf_handlers[ocf] : nullptr;
+}
+
 #ifdef ROOTCANAL_LMP
 DualModeController::DualModeController(const std::string& properties_filename,
                                        uint16_t)
@@ -94,10 +115,8 @@ DualModeController::DualModeController(const std::string& properties_filename,
     supported_commands[i] = 0;
   }
 
-#define SET_HANDLER(name, method)                                  \
-  active_hci_commands_[OpCode::name] = [this](CommandView param) { \
-    method(std::move(param));                                      \
-  };
+#define SET_HANDLER(name, method) \
+  SetCommandHandler(OpCode::name, &DualModeController::method)
 
 #define SET_SUPPORTED(name, method)                                        \
   SET_HANDLER(name, method);                                               \
@@ -423,8 +442,9 @@ void DualModeController::HandleCommand(
     raw_builder_ptr->AddOctets(*packet);
     send_event_(bluetooth::hci::LoopbackCommandBuilder::Create(
         std::move(raw_builder_ptr)));
-  } else if (active_hci_commands_.count(op) > 0) {
-    active_hci_commands_[op](command_packet);
+  } else if (CommandHandler handler = GetCommandHandler(op);
+             handler != nullptr) {
+    (this->*handler)(std::move(command_packet));
   } else {
     uint16_t opcode = static_cast<uint16_t>(op);
     SendCommandCompleteUnknownOpCodeEvent(opcode);
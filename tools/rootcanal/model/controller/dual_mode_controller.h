@@ -18,10 +18,10 @@
 
 #include <unistd.h>
 
+#include <array>
 #include <cstdint>
 #include <memory>
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 #include "hci/address.h"
@@ -68,7 +68,7 @@ class DualModeController : public Device {
   virtual std::string GetTypeString() const override;
 
   virtual void IncomingPacket(
-      model::packets::LinkLayerPacketView incoming) override;
+      const model::packets::LinkLayerPacketView& incoming) override;
 
   virtual void TimerTick() override;
 
@@ -638,6 +638,16 @@ class DualModeController : public Device {
 
   void SendCommandCompleteUnknownOpCodeEvent(uint16_t command_opcode) const;
 
+  using CommandHandler = void (DualModeController::*)(CommandView);
+
+  // Register the handler of the command with opcode |op_code|.
+  void SetCommandHandler(bluetooth::hci::OpCode op_code,
+                         CommandHandler handler);
+
+  // Returns the handler of the command with opcode |op_code|, or nullptr
+  // if the command is not implemented.
+  CommandHandler GetCommandHandler(bluetooth::hci::OpCode op_code) const;
+
   // Unused state to maintain consistency for the Host
   uint16_t le_suggested_default_data_bytes_{0x20};
   uint16_t le_suggested_default_data_time_{0x148};
@@ -650,11 +660,9 @@ class DualModeController : public Device {
   std::function<void(std::shared_ptr<bluetooth::hci::IsoBuilder>)> send_iso_;
 
   // Maintains the commands to be registered and used in the HciHandler object.
-  // Keys are command opcodes and values are the callbacks to handle each
-  // command.
-  std::unordered_map<bluetooth::hci::OpCode,
-                     std::function<void(bluetooth::hci::CommandView)>>
-      active_hci_commands_;
+  // Indexed by the OGF then the OCF of the command opcodes; the table of each
+  // OGF only extends to the highest OCF registered.
+  std::array<std::vector<CommandHandler>, 64> active_hci_commands_;
 
   bluetooth::hci::LoopbackMode loopback_mode_;
 
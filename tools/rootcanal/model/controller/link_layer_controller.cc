@@ -22,6 +22,7 @@
 #endif /* ROOTCANAL_LMP */
 
 #include "crypto_toolbox/crypto_toolbox.h"
+#include "model/setup/clock.h"
 #include "os/log.h"
 #include "packet/raw_builder.h"
 
@@ -417,14 +418,16 @@ ErrorCode LinkLayerController::SendScoToRemote(
   return ErrorCode::SUCCESS;
 }
 
+// The packet has been validated by the phy layer, only the RSSI wrapper and
+// the packet it wraps are left to check
 void LinkLayerController::IncomingPacket(
-    model::packets::LinkLayerPacketView incoming) {
-  ASSERT(incoming.IsValid());
+    const model::packets::LinkLayerPacketView& incoming) {
   if (incoming.GetType() == PacketType::RSSI_WRAPPER) {
     auto rssi_wrapper = model::packets::RssiWrapperView::Create(incoming);
     ASSERT(rssi_wrapper.IsValid());
     auto wrapped =
         model::packets::LinkLayerPacketView::Create(rssi_wrapper.GetPayload());
+    ASSERT(wrapped.IsValid());
     IncomingPacketWithRssi(wrapped, rssi_wrapper.GetRssi());
   } else {
     IncomingPacketWithRssi(incoming, GetRssi());
@@ -432,8 +435,7 @@ void LinkLayerController::IncomingPacket(
 }
 
 void LinkLayerController::IncomingPacketWithRssi(
-    model::packets::LinkLayerPacketView incoming, uint8_t rssi) {
-  ASSERT(incoming.IsValid());
+    const model::packets::LinkLayerPacketView& incoming, uint8_t rssi) {
   auto destination_address = incoming.GetDestinationAddress();
 
   // Match broadcasts
@@ -2371,7 +2373,7 @@ void LinkLayerController::Close() {
 }
 
 void LinkLayerController::LeAdvertising() {
-  steady_clock::time_point now = steady_clock::now();
+  steady_clock::time_point now = Clock::now();
   for (auto& advertiser : advertisers_) {
     auto event = advertiser.GetEvent(now);
     if (event != nullptr) {
@@ -3998,7 +4000,7 @@ void LinkLayerController::Reset() {
     CancelScheduledTask(inquiry_timer_task_id_);
     inquiry_timer_task_id_ = kInvalidTaskId;
   }
-  last_inquiry_ = steady_clock::now();
+  last_inquiry_ = Clock::now();
   page_scan_enable_ = false;
   inquiry_scan_enable_ = false;
 #ifdef ROOTCANAL_LMP
@@ -4039,7 +4041,7 @@ void LinkLayerController::SetInquiryMaxResponses(uint8_t max) {
 }
 
 void LinkLayerController::Inquiry() {
-  steady_clock::time_point now = steady_clock::now();
+  steady_clock::time_point now = Clock::now();
   if (duration_cast<milliseconds>(now - last_inquiry_) < milliseconds(2000)) {
     return;
   }
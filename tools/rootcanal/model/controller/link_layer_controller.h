@@ -122,13 +122,13 @@ class LinkLayerController {
  private:
   void SendDisconnectionCompleteEvent(uint16_t handle, ErrorCode reason);
 
-  void IncomingPacketWithRssi(model::packets::LinkLayerPacketView incoming,
-                              uint8_t rssi);
+  void IncomingPacketWithRssi(
+      const model::packets::LinkLayerPacketView& incoming, uint8_t rssi);
 
  public:
   const Address& GetAddress() const;
 
-  void IncomingPacket(model::packets::LinkLayerPacketView incoming);
+  void IncomingPacket(const model::packets::LinkLayerPacketView& incoming);
 
   void TimerTick();
 
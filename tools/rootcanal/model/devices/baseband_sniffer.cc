@@ -92,7 +92,7 @@ static uint32_t BuildBtPacketHeader(uint8_t uap, uint8_t lt_addr,
 }
 
 void BaseBandSniffer::IncomingPacket(
-    model::packets::LinkLayerPacketView packet) {
+    const model::packets::LinkLayerPacketView& packet) {
   auto packet_type = packet.GetType();
   auto address = packet.GetSourceAddress();
 
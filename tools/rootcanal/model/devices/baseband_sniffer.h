@@ -46,7 +46,7 @@ class BaseBandSniffer : public Device {
   }
 
   virtual void IncomingPacket(
-      model::packets::LinkLayerPacketView packet) override;
+      const model::packets::LinkLayerPacketView& packet) override;
 
   virtual void TimerTick() override;
 
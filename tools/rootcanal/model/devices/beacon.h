@@ -40,7 +40,7 @@ class Beacon : public Device {
 
   virtual void TimerTick() override;
   virtual void IncomingPacket(
-      model::packets::LinkLayerPacketView packet) override;
+      const model::packets::LinkLayerPacketView& packet) override;
 
  protected:
   model::packets::AdvertisementType advertising_type_{};
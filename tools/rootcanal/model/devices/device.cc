@@ -16,8 +16,11 @@
 
 #include "device.h"
 
+#include <optional>
 #include <vector>
 
+#include "model/setup/phy_layer_factory.h"
+
 namespace rootcanal {
 
 std::string Device::ToString() const {
@@ -51,16 +54,21 @@ void Device::UnregisterPhyLayer(Phy::Type phy_type, uint32_t factory_id) {
 void Device::SendLinkLayerPacket(
     std::shared_ptr<model::packets::LinkLayerPacketBuilder> to_send,
     Phy::Type phy_type) {
-  for (auto phy : phy_layers_) {
+  // Serialized once, the same view is sent on all the phys
+  std::optional<model::packets::LinkLayerPacketView> packet;
+  for (const auto& phy : phy_layers_) {
     if (phy != nullptr && phy->GetType() == phy_type) {
-      phy->Send(to_send);
+      if (!packet.has_value()) {
+        packet = PhyLayerFactory::Serialize(*to_send);
+      }
+      phy->Send(*packet);
     }
   }
 }
 
-void Device::SendLinkLayerPacket(model::packets::LinkLayerPacketView to_send,
-                                 Phy::Type phy_type) {
-  for (auto phy : phy_layers_) {
+void Device::SendLinkLayerPacket(
+    const model::packets::LinkLayerPacketView& to_send, Phy::Type phy_type) {
+  for (const auto& phy : phy_layers_) {
     if (phy != nullptr && phy->GetType() == phy_type) {
       phy->Send(to_send);
     }
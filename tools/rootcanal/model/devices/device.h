@@ -58,14 +58,14 @@ class Device {
 
   void UnregisterPhyLayer(Phy::Type phy_type, uint32_t factory_id);
 
-  virtual void IncomingPacket(model::packets::LinkLayerPacketView){};
+  virtual void IncomingPacket(const model::packets::LinkLayerPacketView&){};
 
   virtual void SendLinkLayerPacket(
       std::shared_ptr<model::packets::LinkLayerPacketBuilder> packet,
       Phy::Type phy_type);
 
-  virtual void SendLinkLayerPacket(model::packets::LinkLayerPacketView packet,
-                                   Phy::Type phy_type);
+  virtual void SendLinkLayerPacket(
+      const model::packets::LinkLayerPacketView& packet, Phy::Type phy_type);
 
   virtual void Close();
 
@@ -86,9 +86,20 @@ HciDevice::HciDevice(std::shared_ptr<HciTransport> transport,
       });
 }
 
+// The packets sent to the host while handling the commands received in a
+// tick, or an incoming link layer packet, are written to the transport at once.
+void HciDevice::IncomingPacket(
+    const model::packets::LinkLayerPacketView& incoming) {
+  transport_->StartBatch();
+  DualModeController::IncomingPacket(incoming);
+  transport_->FlushBatch();
+}
+
 void HciDevice::TimerTick() {
+  transport_->StartBatch();
   transport_->TimerTick();
   DualModeController::TimerTick();
+  transport_->FlushBatch();
 }
 
 void HciDevice::Close() {
@@ -38,6 +38,9 @@ class HciDevice : public DualModeController {
 
   std::string GetTypeString() const override { return "hci_device"; }
 
+  void IncomingPacket(
+      const model::packets::LinkLayerPacketView& incoming) override;
+
   void TimerTick() override;
 
   void Close() override;
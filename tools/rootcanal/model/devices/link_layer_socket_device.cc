@@ -99,7 +99,7 @@ void LinkLayerSocketDevice::Close() {
 }
 
 void LinkLayerSocketDevice::IncomingPacket(
-    model::packets::LinkLayerPacketView packet) {
+    const model::packets::LinkLayerPacketView& packet) {
   auto size_packet = bluetooth::packet::RawBuilder();
   size_packet.AddOctets4(packet.size());
   std::vector<uint8_t> size_bytes;
@@ -49,7 +49,7 @@ class LinkLayerSocketDevice : public Device {
   }
 
   virtual void IncomingPacket(
-      model::packets::LinkLayerPacketView packet) override;
+      const model::packets::LinkLayerPacketView& packet) override;
 
   virtual void TimerTick() override;
 
@@ -39,7 +39,7 @@ class Sniffer : public Device {
   virtual std::string GetTypeString() const override { return "sniffer"; }
 
   virtual void IncomingPacket(
-      model::packets::LinkLayerPacketView packet) override;
+      const model::packets::LinkLayerPacketView& packet) override;
 
  private:
   static bool registered_;
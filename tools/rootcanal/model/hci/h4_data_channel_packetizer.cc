@@ -64,12 +64,19 @@ size_t H4DataChannelPacketizer::Send(uint8_t type, const uint8_t* data,
   return to_be_written;
 }
 
+size_t H4DataChannelPacketizer::SendFrames(const uint8_t* data,
+                                           size_t length) {
+  size_t written = WriteSafely(uart_socket_.get(), data, length);
+  if (written != length) {
+    LOG_ERROR("%d / %d bytes written - something went wrong...",
+              static_cast<int>(written), static_cast<int>(length));
+  }
+  return written;
+}
+
 void H4DataChannelPacketizer::OnDataReady(
     std::shared_ptr<AsyncDataChannel> socket) {
-  ssize_t bytes_to_read = h4_parser_.BytesRequested();
-  std::vector<uint8_t> buffer(bytes_to_read);
-
-  ssize_t bytes_read = socket->Recv(buffer.data(), bytes_to_read);
+  ssize_t bytes_read = socket->Recv(read_buffer_.data(), read_buffer_.size());
   if (bytes_read == 0) {
     LOG_INFO("remote disconnected!");
     disconnected_ = true;
@@ -89,7 +96,7 @@ void H4DataChannelPacketizer::OnDataReady(
                        strerror(errno));
     }
   }
-  h4_parser_.Consume(buffer.data(), bytes_read);
+  h4_parser_.ConsumeStream(read_buffer_.data(), bytes_read);
 }
 
 }  // namespace rootcanal
@@ -20,6 +20,7 @@
 #include <stdint.h>  // for uint8_t
 
 #include <memory>  // for shared_ptr
+#include <vector>  // for vector
 
 #include "h4_parser.h"     // for ClientDisconnectCallback, H4Parser
 #include "hci_protocol.h"  // for PacketReadCallback, AsyncDataChannel, HciProtocol
@@ -42,6 +43,10 @@ class H4DataChannelPacketizer : public HciProtocol {
 
   size_t Send(uint8_t type, const uint8_t* data, size_t length) override;
 
+  // Send |length| bytes of packets already framed with their H4 type, in a
+  // single write to the socket.
+  size_t SendFrames(const uint8_t* data, size_t length);
+
   void OnDataReady(std::shared_ptr<AsyncDataChannel> socket);
 
  private:
@@ -50,6 +55,11 @@ class H4DataChannelPacketizer : public HciProtocol {
 
   ClientDisconnectCallback disconnect_cb_;
   bool disconnected_{false};
+
+  // Reused across reads so that a single read can pick up every packet
+  // currently queued on the transport.
+  static constexpr size_t kReadBufferSize = 64 * 1024;
+  std::vector<uint8_t> read_buffer_ = std::vector<uint8_t>(kReadBufferSize);
 };
 
 }  // namespace rootcanal
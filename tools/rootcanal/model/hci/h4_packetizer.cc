@@ -56,11 +56,8 @@ size_t H4Packetizer::Send(uint8_t type, const uint8_t* data, size_t length) {
 
 void H4Packetizer::OnDataReady(int fd) {
   if (disconnected_) return;
-  ssize_t bytes_to_read = h4_parser_.BytesRequested();
-  std::vector<uint8_t> buffer(bytes_to_read);
-
   ssize_t bytes_read;
-  OSI_NO_INTR(bytes_read = read(fd, buffer.data(), bytes_to_read));
+  OSI_NO_INTR(bytes_read = read(fd, read_buffer_.data(), read_buffer_.size()));
   if (bytes_read == 0) {
     LOG_INFO("remote disconnected!");
     disconnected_ = true;
@@ -80,7 +77,7 @@ void H4Packetizer::OnDataReady(int fd) {
                        strerror(errno));
     }
   }
-  h4_parser_.Consume(buffer.data(), bytes_read);
+  h4_parser_.ConsumeStream(read_buffer_.data(), bytes_read);
 }
 
 }  // namespace rootcanal
@@ -45,6 +45,11 @@ class H4Packetizer : public HciProtocol {
 
   ClientDisconnectCallback disconnect_cb_;
   bool disconnected_{false};
+
+  // Reused across reads so that a single read can pick up every packet
+  // currently queued on the transport.
+  static constexpr size_t kReadBufferSize = 64 * 1024;
+  std::vector<uint8_t> read_buffer_ = std::vector<uint8_t>(kReadBufferSize);
 };
 
 }  // namespace rootcanal
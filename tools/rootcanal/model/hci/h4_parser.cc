@@ -18,6 +18,7 @@
 
 #include <stddef.h>  // for size_t
 
+#include <algorithm>   // for min
 #include <cstdint>     // for uint8_t, int32_t
 #include <functional>  // for function
 #include <utility>     // for move
@@ -171,4 +172,21 @@ bool H4Parser::Consume(uint8_t* buffer, int32_t bytes_read) {
   }
   return true;
 }
+
+bool H4Parser::ConsumeStream(const uint8_t* buffer, size_t bytes) {
+  if (bytes == 0) {
+    LOG_INFO("remote disconnected, or unhandled error?");
+    return false;
+  }
+  while (bytes > 0) {
+    size_t chunk = std::min(bytes, BytesRequested());
+    if (!Consume(const_cast<uint8_t*>(buffer), chunk)) {
+      return false;
+    }
+    buffer += chunk;
+    bytes -= chunk;
+  }
+  return true;
+}
+
 }  // namespace rootcanal
@@ -41,6 +41,9 @@ using ClientDisconnectCallback = std::function<void()>;
 // std::vector fill_this_vector_with_at_most_nr_bytes(nr_bytes);
 // h4.Consume(fill_this_vector_with_at_most_nr_bytes.data(), nr_bytes.size());
 //
+// Transports that can read more than requested (e.g. everything currently
+// available on a socket) can instead hand each chunk to ConsumeStream().
+//
 // The parser will invoke the proper callbacks once a packet has been parsed.
 // The parser keeps internal state and is not thread safe.
 class H4Parser {
@@ -54,6 +57,11 @@ class H4Parser {
   // Consumes the given number of bytes, returns true on success.
   bool Consume(uint8_t* buffer, int32_t bytes);
 
+  // Consumes a chunk of a byte stream, which may hold several packets and
+  // end in the middle of one. The callbacks are invoked for every packet
+  // completed by the chunk, returns true on success.
+  bool ConsumeStream(const uint8_t* buffer, size_t bytes);
+
   // The maximum number of bytes the parser can consume in the current state.
   size_t BytesRequested();
 
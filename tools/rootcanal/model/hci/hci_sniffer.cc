@@ -84,6 +84,10 @@ void HciSniffer::RegisterCallbacks(PacketCallback command_callback,
       close_callback);
 }
 
+void HciSniffer::StartBatch() { transport_->StartBatch(); }
+
+void HciSniffer::FlushBatch() { transport_->FlushBatch(); }
+
 void HciSniffer::TimerTick() { transport_->TimerTick(); }
 
 void HciSniffer::Close() {
@@ -62,6 +62,10 @@ class HciSniffer : public HciTransport {
                          PacketCallback iso_callback,
                          CloseCallback close_callback) override;
 
+  void StartBatch() override;
+
+  void FlushBatch() override;
+
   void TimerTick() override;
 
   void Close() override;
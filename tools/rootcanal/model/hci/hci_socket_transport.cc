@@ -16,7 +16,7 @@
 
 #include "hci_socket_transport.h"
 
-#include "os/log.h"  // for LOG_INFO, LOG_ALWAYS_FATAL
+#include "os/log.h"  // for LOG_INFO, LOG_ALWAYS_FATAL, ASSERT
 
 namespace rootcanal {
 
@@ -67,9 +67,30 @@ void HciSocketTransport::SendHci(PacketType packet_type,
     return;
   }
   uint8_t type = static_cast<uint8_t>(packet_type);
+  if (batch_depth_ > 0) {
+    batch_.push_back(type);
+    batch_.insert(batch_.end(), packet.begin(), packet.end());
+    return;
+  }
   h4_.Send(type, packet.data(), packet.size());
 }
 
+void HciSocketTransport::StartBatch() { batch_depth_++; }
+
+void HciSocketTransport::FlushBatch() {
+  ASSERT(batch_depth_ > 0);
+  if (--batch_depth_ > 0 || batch_.empty()) {
+    return;
+  }
+  if (socket_ && socket_->Connected()) {
+    h4_.SendFrames(batch_.data(), batch_.size());
+  } else {
+    LOG_INFO("Closed socket. Dropping %zu bytes of packets", batch_.size());
+  }
+  // Keep the capacity for the next batch.
+  batch_.clear();
+}
+
 void HciSocketTransport::SendEvent(const std::vector<uint8_t>& packet) {
   SendHci(PacketType::EVENT, packet);
 }
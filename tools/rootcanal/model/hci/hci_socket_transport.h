@@ -17,6 +17,7 @@
 #pragma once
 
 #include <memory>  // for shared_ptr, make_...
+#include <vector>  // for vector
 
 #include "model/hci/h4_data_channel_packetizer.h"  // for H4DataChannelP...
 #include "model/hci/hci_transport.h"               // for HciTransport
@@ -50,6 +51,10 @@ class HciSocketTransport : public HciTransport {
                          PacketCallback iso_callback,
                          CloseCallback close_callback) override;
 
+  void StartBatch() override;
+
+  void FlushBatch() override;
+
   void TimerTick() override;
 
   void Close() override;
@@ -58,6 +63,12 @@ class HciSocketTransport : public HciTransport {
   void SendHci(PacketType packet_type, const std::vector<uint8_t>& packet);
 
   std::shared_ptr<AsyncDataChannel> socket_;
+
+  // H4 packets held back until the outermost FlushBatch, and the number of
+  // batches currently started.
+  std::vector<uint8_t> batch_;
+  int batch_depth_{0};
+
   H4DataChannelPacketizer h4_{socket_,
                               [](const std::vector<uint8_t>&) {},
                               [](const std::vector<uint8_t>&) {},
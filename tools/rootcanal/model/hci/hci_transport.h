@@ -44,6 +44,13 @@ class HciTransport {
                                  PacketCallback iso_callback,
                                  CloseCallback close_callback) = 0;
 
+  // The packets sent between StartBatch and the matching FlushBatch may be
+  // held back and written together by FlushBatch. Batches can be nested, the
+  // outermost FlushBatch writes the packets.
+  virtual void StartBatch() {}
+
+  virtual void FlushBatch() {}
+
   virtual void TimerTick() = 0;
 
   virtual void Close() = 0;
@@ -24,10 +24,15 @@
 #include <vector>
 
 #include "fcntl.h"
+#include "model/setup/clock.h"
 #include "os/log.h"
 #include "sys/select.h"
 #include "unistd.h"
 
+#ifdef __linux__
+#include "sys/epoll.h"
+#endif
+
 namespace rootcanal {
 // Implementation of AsyncManager is divided between two classes, three if
 // AsyncManager itself is taken into account, but its only responsability
@@ -39,14 +44,18 @@ namespace rootcanal {
 // After construction of this objects nothing happens beyond some very simple
 // member initialization. When the first FD is set up for watching the object
 // starts a new thread which watches the given (and later provided) FDs using
-// select() inside a loop. A special FD (a pipe) is also watched which is
-// used to notify the thread of internal changes on the object state (like
-// the addition of new FDs to watch on). Every access to internal state is
-// synchronized using a single internal mutex. The thread is only stopped on
-// destruction of the object, by modifying a flag, which is the only member
-// variable accessed without acquiring the lock (because the notification to
-// the thread is done later by writing to a pipe which means the thread will
-// be notified regardless of what phase of the loop it is in that moment)
+// epoll_wait() inside a loop, or select() where epoll is not available. The
+// epoll set is updated when FDs are added or removed, so the cost of a wakeup
+// only depends on the number of FDs ready, not on the number watched. A
+// special FD (a pipe) is also watched which is used to notify the thread of
+// internal changes on the object state (like the stop request or, with
+// select(), the addition of new FDs to watch on). Every access to internal
+// state is synchronized using a single internal mutex. The thread is only
+// stopped on destruction of the object, by modifying a flag, which is the only
+// member variable accessed without acquiring the lock (because the
+// notification to the thread is done later by writing to a pipe which means
+// the thread will be notified regardless of what phase of the loop it is in
+// that moment)
 
 // The scheduling of asynchronous tasks, periodic or not, is handled by the
 // AsyncTaskManager class. Like the one for FDs, this class shares no internal
@@ -54,7 +63,9 @@ namespace rootcanal {
 // this class, also nothing interesting happens upon construction, but only
 // after a Task has been scheduled and access to internal state is synchronized
 // using a single internal mutex. When the first task is scheduled a thread
-// is started which monitors a queue of tasks. The queue is peeked to see
+// is started which monitors a queue of tasks, kept as a binary heap ordered by
+// due time. Canceled tasks are only dropped from the heap when they reach its
+// top, or when they make up most of it. The queue is peeked to see
 // when the next task should be carried out and then the thread performs a
 // (absolute) timed wait on a condition variable. The wait ends because of a
 // time out or a notify on the cond var, the former means a task is due
@@ -79,6 +90,9 @@ static const uint16_t kMaxTaskId =
 static inline AsyncTaskId NextAsyncTaskId(const AsyncTaskId id) {
   return (id == kMaxTaskId) ? 1 : id + 1;
 }
+// Size under which the task heap is not worth compacting, the canceled tasks
+// are dropped when they reach its top
+static const size_t kMinTasksToCompact = 64;
 // The buffer is only 10 bytes because the expected number of bytes
 // written on this socket is 1. It is possible that the thread is notified
 // more than once but highly unlikely, so a buffer of size 10 seems enough
@@ -91,6 +105,12 @@ static inline AsyncTaskId NextAsyncTaskId(const AsyncTaskId id) {
 // no need to treat that case.
 static const int kNotificationBufferSize = 10;
 
+#ifdef __linux__
+// Maximum number of ready FDs handled per wakeup of the reading thread, the
+// others are reported by the next epoll_wait()
+static const int kMaxEpollEvents = 64;
+#endif
+
 // Async File Descriptor Watcher Implementation:
 class AsyncManager::AsyncFdWatcher {
  public:
@@ -109,15 +129,36 @@ class AsyncManager::AsyncFdWatcher {
       return started;
     }
 
+#ifdef __linux__
+    // epoll_wait() picks up the new FD without waking up the thread
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = file_descriptor;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, file_descriptor, &event) < 0 &&
+        (errno != EEXIST ||
+         epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, file_descriptor, &event) < 0)) {
+      LOG_ERROR("%s: Unable to watch fd %d: %s", __func__, file_descriptor,
+                strerror(errno));
+      StopWatchingFileDescriptor(file_descriptor);
+      return -1;
+    }
+#else
     // notify the thread so that it knows of the new FD
     notifyThread();
+#endif
 
     return 0;
   }
 
   void StopWatchingFileDescriptor(int file_descriptor) {
     std::unique_lock<std::recursive_mutex> guard(internal_mutex_);
-    watched_shared_fds_.erase(file_descriptor);
+    if (watched_shared_fds_.erase(file_descriptor) == 0) {
+      return;
+    }
+#ifdef __linux__
+    // The FD may be closed already, which removed it from the epoll set
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, file_descriptor, nullptr);
+#endif
   }
 
   AsyncFdWatcher() = default;
@@ -135,6 +176,10 @@ class AsyncManager::AsyncFdWatcher {
 
     if (std::this_thread::get_id() != thread_.get_id()) {
       thread_.join();
+#ifdef __linux__
+      close(epoll_fd_);
+      epoll_fd_ = -1;
+#endif
     } else {
       LOG_WARN("%s: Starting thread stop from inside the reading thread itself",
                __func__);
@@ -167,6 +212,19 @@ class AsyncManager::AsyncFdWatcher {
     notification_listen_fd_ = pipe_fds[0];
     notification_write_fd_ = pipe_fds[1];
 
+#ifdef __linux__
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    struct epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = notification_listen_fd_;
+    if (epoll_fd_ < 0 || epoll_ctl(epoll_fd_, EPOLL_CTL_ADD,
+                                   notification_listen_fd_, &event) < 0) {
+      LOG_ERROR("%s: Unable to set up the epoll set: %s", __func__,
+                strerror(errno));
+      return -1;
+    }
+#endif
+
     thread_ = std::thread([this]() { ThreadRoutine(); });
     if (!thread_.joinable()) {
       LOG_ERROR("%s: Unable to start reading thread", __func__);
@@ -184,6 +242,63 @@ class AsyncManager::AsyncFdWatcher {
     return 0;
   }
 
+  // read everything there is on the comm channel
+  void consumeThreadNotifications() {
+    char buffer[kNotificationBufferSize];
+    while (TEMP_FAILURE_RETRY(read(notification_listen_fd_, buffer,
+                                   kNotificationBufferSize)) ==
+           kNotificationBufferSize) {
+    }
+  }
+
+#ifdef __linux__
+  // call the callbacks of the ready FDs, skipping those that an earlier
+  // callback stopped watching
+  void runAppropriateCallbacks(const struct epoll_event* events,
+                               int num_events) {
+    std::unique_lock<std::recursive_mutex> guard(internal_mutex_);
+    for (int i = 0; i < num_events; i++) {
+      int fd = events[i].data.fd;
+      auto it = watched_shared_fds_.find(fd);
+      if (it == watched_shared_fds_.end()) {
+        continue;
+      }
+      // Copied as the callback may stop watching its own FD
+      ReadCallback callback = it->second;
+      callback(fd);
+    }
+  }
+
+  void ThreadRoutine() {
+    struct epoll_event events[kMaxEpollEvents];
+    while (running_) {
+      // wait until there is data available to read on some FD
+      int num_events = epoll_wait(epoll_fd_, events, kMaxEpollEvents, -1);
+      if (num_events < 0) {
+        if (errno != EINTR) {
+          LOG_ERROR(
+              "%s: There was an error while waiting for data on the file "
+              "descriptors: %s",
+              __func__, strerror(errno));
+        }
+        continue;
+      }
+
+      for (int i = 0; i < num_events; i++) {
+        if (events[i].data.fd == notification_listen_fd_) {
+          consumeThreadNotifications();
+        }
+      }
+
+      // Do not read if there was a call to stop running
+      if (!running_) {
+        break;
+      }
+
+      runAppropriateCallbacks(events, num_events);
+    }
+  }
+#else
   int setUpFileDescriptorSet(fd_set& read_fds) {
     // add comm channel to the set
     FD_SET(notification_listen_fd_, &read_fds);
@@ -200,19 +315,6 @@ class AsyncManager::AsyncFdWatcher {
     return nfds;
   }
 
-  // check the comm channel and read everything there
-  bool consumeThreadNotifications(fd_set& read_fds) {
-    if (FD_ISSET(notification_listen_fd_, &read_fds)) {
-      char buffer[kNotificationBufferSize];
-      while (TEMP_FAILURE_RETRY(read(notification_listen_fd_, buffer,
-                                     kNotificationBufferSize)) ==
-             kNotificationBufferSize) {
-      }
-      return true;
-    }
-    return false;
-  }
-
   // check all file descriptors and call callbacks if necesary
   void runAppropriateCallbacks(fd_set& read_fds) {
     std::vector<decltype(watched_shared_fds_)::value_type> fds;
@@ -243,7 +345,10 @@ class AsyncManager::AsyncFdWatcher {
         continue;
       }
 
-      consumeThreadNotifications(read_fds);
+      // check the comm channel
+      if (FD_ISSET(notification_listen_fd_, &read_fds)) {
+        consumeThreadNotifications();
+      }
 
       // Do not read if there was a call to stop running
       if (!running_) {
@@ -253,6 +358,7 @@ class AsyncManager::AsyncFdWatcher {
       runAppropriateCallbacks(read_fds);
     }
   }
+#endif
 
   std::atomic_bool running_{false};
   std::thread thread_;
@@ -263,6 +369,10 @@ class AsyncManager::AsyncFdWatcher {
   // A pair of FD to send information to the reading thread
   int notification_listen_fd_{};
   int notification_write_fd_{};
+
+#ifdef __linux__
+  int epoll_fd_{-1};
+#endif
 };
 
 // Async task manager implementation
@@ -273,7 +383,7 @@ class AsyncManager::AsyncTaskManager {
   AsyncTaskId ExecAsync(AsyncUserId user_id, std::chrono::milliseconds delay,
                         const TaskCallback& callback) {
     return scheduleTask(std::make_shared<Task>(
-        std::chrono::steady_clock::now() + delay, callback, user_id));
+        Clock::now() + delay, callback, user_id));
   }
 
   AsyncTaskId ExecAsyncPeriodically(AsyncUserId user_id,
@@ -281,7 +391,7 @@ class AsyncManager::AsyncTaskManager {
                                     std::chrono::milliseconds period,
                                     const TaskCallback& callback) {
     return scheduleTask(std::make_shared<Task>(
-        std::chrono::steady_clock::now() + delay, period, callback, user_id));
+        Clock::now() + delay, period, callback, user_id));
   }
 
   bool CancelAsyncTask(AsyncTaskId async_task_id) {
@@ -313,7 +423,7 @@ class AsyncManager::AsyncTaskManager {
     {
       std::unique_lock<std::mutex> guard(internal_mutex_);
       tasks_by_id_.clear();
-      task_queue_.clear();
+      task_heap_.clear();
       if (!running_) {
         return 0;
       }
@@ -370,14 +480,55 @@ class AsyncManager::AsyncTaskManager {
     AsyncUserId user_id;
   };
 
-  // A comparator class to put shared pointers to tasks in an ordered set
-  struct task_p_comparator {
+  // A comparator class to keep the earliest task at the top of the heap
+  struct task_p_later {
     bool operator()(const std::shared_ptr<Task>& t1,
                     const std::shared_ptr<Task>& t2) const {
-      return *t1 < *t2;
+      return *t2 < *t1;
     }
   };
 
+  // A heap entry is stale once its task was canceled or has run
+  bool isTaskQueued(const std::shared_ptr<Task>& task) const {
+    auto it = tasks_by_id_.find(task->task_id);
+    return it != tasks_by_id_.end() && it->second == task;
+  }
+
+  void pushTask(const std::shared_ptr<Task>& task) {
+    task_heap_.push_back(task);
+    std::push_heap(task_heap_.begin(), task_heap_.end(), task_p_later());
+  }
+
+  void popTask() {
+    std::pop_heap(task_heap_.begin(), task_heap_.end(), task_p_later());
+    task_heap_.pop_back();
+  }
+
+  // Drop the stale entries from the top of the heap, returns the next task to
+  // run or nullptr if there are none
+  std::shared_ptr<Task> peekNextTask() {
+    while (!task_heap_.empty() && !isTaskQueued(task_heap_.front())) {
+      popTask();
+    }
+    return task_heap_.empty() ? nullptr : task_heap_.front();
+  }
+
+  // Rebuild the heap when it is mostly made of canceled tasks, which would
+  // otherwise stay until they are due
+  void compactTasks() {
+    if (task_heap_.size() < kMinTasksToCompact ||
+        task_heap_.size() < 2 * tasks_by_id_.size()) {
+      return;
+    }
+    auto stale = [this](const std::shared_ptr<Task>& task) {
+      return !isTaskQueued(task);
+    };
+    task_heap_.erase(
+        std::remove_if(task_heap_.begin(), task_heap_.end(), stale),
+        task_heap_.end());
+    std::make_heap(task_heap_.begin(), task_heap_.end(), task_p_later());
+  }
+
   bool cancel_task_with_lock_held(AsyncTaskId async_task_id) {
     if (tasks_by_id_.count(async_task_id) == 0) {
       return false;
@@ -391,12 +542,11 @@ class AsyncManager::AsyncTaskManager {
     if (thread_.get_id() != std::this_thread::get_id()) {
       auto task = tasks_by_id_[async_task_id];
       const std::lock_guard<std::mutex> lock(task->in_callback);
-      task_queue_.erase(task);
       tasks_by_id_.erase(async_task_id);
     } else {
-      task_queue_.erase(tasks_by_id_[async_task_id]);
       tasks_by_id_.erase(async_task_id);
     }
+    compactTasks();
 
     return true;
   }
@@ -414,7 +564,7 @@ class AsyncManager::AsyncTaskManager {
       // add task to the queue and map
       tasks_by_id_[lastTaskId_] = task;
       tasks_by_user_id_[task->user_id].insert(task->task_id);
-      task_queue_.insert(task);
+      pushTask(task);
     }
     // start thread if necessary
     int started = tryStartThread();
@@ -456,16 +606,21 @@ class AsyncManager::AsyncTaskManager {
       bool run_it = false;
       {
         std::unique_lock<std::mutex> guard(internal_mutex_);
-        if (!task_queue_.empty()) {
-          task_p = *(task_queue_.begin());
-          if (task_p->time < std::chrono::steady_clock::now()) {
+        task_p = peekNextTask();
+        if (task_p != nullptr) {
+          // Nothing can happen in the simulation before the next task is
+          // due, jump straight to it
+          if (Clock::IsVirtualTime()) {
+            Clock::AdvanceTo(task_p->time);
+          }
+          if (task_p->time <= Clock::now()) {
             run_it = true;
             callback = task_p->callback;
-            task_queue_.erase(task_p);  // need to remove and add again if
-                                        // periodic to update order
+            popTask();  // need to remove and add again if periodic to
+                        // update order
             if (task_p->isPeriodic()) {
               task_p->time += task_p->period;
-              task_queue_.insert(task_p);
+              pushTask(task_p);
             } else {
               tasks_by_user_id_[task_p->user_id].erase(task_p->task_id);
               tasks_by_id_.erase(task_p->task_id);
@@ -482,12 +637,16 @@ class AsyncManager::AsyncTaskManager {
         // check for termination right before waiting
         if (!running_) break;
         // wait until time for the next task (if any)
-        if (task_queue_.size() > 0) {
+        std::shared_ptr<Task> next_task_p = peekNextTask();
+        if (next_task_p != nullptr) {
+          // The clock does not move by itself in virtual time
+          if (Clock::IsVirtualTime()) {
+            continue;
+          }
           // Make a copy of the time_point because wait_until takes a reference
           // to it and may read it after waiting, by which time the task may
-          // have been freed (e.g. via CancelAsyncTask).
-          std::chrono::steady_clock::time_point time =
-              (*task_queue_.begin())->time;
+          // have been rescheduled.
+          std::chrono::steady_clock::time_point time = next_task_p->time;
           internal_cond_var_.wait_until(guard, time);
         } else {
           internal_cond_var_.wait(guard);
@@ -505,7 +664,7 @@ class AsyncManager::AsyncTaskManager {
   AsyncUserId lastUserId_{1};
   std::map<AsyncTaskId, std::shared_ptr<Task>> tasks_by_id_;
   std::map<AsyncUserId, std::set<AsyncTaskId>> tasks_by_user_id_;
-  std::set<std::shared_ptr<Task>, task_p_comparator> task_queue_;
+  std::vector<std::shared_ptr<Task>> task_heap_;
 };
 
 // Async Manager Implementation:
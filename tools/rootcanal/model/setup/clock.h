@@ -0,0 +1,68 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>  // for atomic
+#include <chrono>  // for steady_clock
+
+namespace rootcanal {
+
+// Time source of the simulation, used in place of std::chrono::steady_clock.
+// By default it reads the steady clock. In virtual time the clock only moves
+// when the AsyncManager task thread jumps it to the time of the next task, so
+// the scenarios run as fast as the tasks can be executed instead of idling
+// until the tasks are due. Virtual time is meant for self-contained scenarios:
+// hosts connected over a socket keep running in real time.
+class Clock {
+ public:
+  using duration = std::chrono::steady_clock::duration;
+  using rep = duration::rep;
+  using period = duration::period;
+  using time_point = std::chrono::steady_clock::time_point;
+  static constexpr bool is_steady = true;
+
+  static time_point now() {
+    if (!virtual_time_) {
+      return std::chrono::steady_clock::now();
+    }
+    return time_point(duration(virtual_now_.load()));
+  }
+
+  // Switch to or from virtual time. The virtual time starts from the current
+  // steady clock time so that the time points already taken stay meaningful.
+  static void SetVirtualTime(bool enabled) {
+    virtual_now_ = std::chrono::steady_clock::now().time_since_epoch().count();
+    virtual_time_ = enabled;
+  }
+
+  static bool IsVirtualTime() { return virtual_time_; }
+
+  // Move the virtual time forward to time, never backwards
+  static void AdvanceTo(time_point time) {
+    rep target = time.time_since_epoch().count();
+    rep current = virtual_now_.load();
+    while (current < target &&
+           !virtual_now_.compare_exchange_weak(current, target)) {
+    }
+  }
+
+ private:
+  static inline std::atomic_bool virtual_time_{false};
+  static inline std::atomic<rep> virtual_now_{0};
+};
+
+}  // namespace rootcanal
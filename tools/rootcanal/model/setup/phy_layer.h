@@ -23,7 +23,8 @@ namespace rootcanal {
 class PhyLayer {
  public:
   PhyLayer(Phy::Type phy_type, uint32_t id,
-           const std::function<void(model::packets::LinkLayerPacketView)>&
+           const std::function<
+               void(const model::packets::LinkLayerPacketView&)>&
                device_receive,
            uint32_t device_id)
       : phy_type_(phy_type),
@@ -33,9 +34,11 @@ class PhyLayer {
 
   virtual void Send(
       std::shared_ptr<model::packets::LinkLayerPacketBuilder> packet) = 0;
-  virtual void Send(model::packets::LinkLayerPacketView packet) = 0;
+  virtual void Send(const model::packets::LinkLayerPacketView& packet) = 0;
 
-  virtual void Receive(model::packets::LinkLayerPacketView packet) = 0;
+  // The packet is shared by all the receivers of a transmission, it has
+  // already been validated by the phy layer factory
+  virtual void Receive(const model::packets::LinkLayerPacketView& packet) = 0;
 
   virtual void TimerTick() = 0;
 
@@ -57,7 +60,7 @@ class PhyLayer {
   uint32_t device_id_;
 
  protected:
-  const std::function<void(model::packets::LinkLayerPacketView)>
+  const std::function<void(const model::packets::LinkLayerPacketView&)>
       transmit_to_device_;
 };
 
@@ -18,6 +18,8 @@
 
 #include <sstream>
 
+#include "model/setup/sharded_phy_simulation.h"
+
 namespace rootcanal {
 
 PhyLayerFactory::PhyLayerFactory(Phy::Type phy_type, uint32_t factory_id)
@@ -28,18 +30,24 @@ Phy::Type PhyLayerFactory::GetType() { return phy_type_; }
 uint32_t PhyLayerFactory::GetFactoryId() { return factory_id_; }
 
 std::shared_ptr<PhyLayer> PhyLayerFactory::GetPhyLayer(
-    const std::function<void(model::packets::LinkLayerPacketView)>&
+    const std::function<void(const model::packets::LinkLayerPacketView&)>&
         device_receive,
     uint32_t device_id) {
   std::shared_ptr<PhyLayer> new_phy = std::make_shared<PhyLayerImpl>(
       phy_type_, next_id_++, device_receive, device_id, this);
   phy_layers_.push_back(new_phy);
+  if (radio_model_ != nullptr) {
+    radio_model_->AddPhyLayer(new_phy);
+  }
   return new_phy;
 }
 
 void PhyLayerFactory::UnregisterPhyLayer(uint32_t id) {
   for (auto phy : phy_layers_) {
     if (phy->GetId() == id) {
+      if (radio_model_ != nullptr) {
+        radio_model_->RemovePhyLayer(id);
+      }
       phy_layers_.remove(phy);
       return;
     }
@@ -55,32 +63,87 @@ void PhyLayerFactory::UnregisterAllPhyLayers() {
   }
 }
 
-void PhyLayerFactory::Send(
-    const std::shared_ptr<model::packets::LinkLayerPacketBuilder> packet,
-    uint32_t id, [[maybe_unused]] uint32_t device_id) {
+model::packets::LinkLayerPacketView PhyLayerFactory::Serialize(
+    const model::packets::LinkLayerPacketBuilder& packet) {
   // Convert from a Builder to a View
   auto bytes = std::make_shared<std::vector<uint8_t>>();
   bluetooth::packet::BitInserter i(*bytes);
-  bytes->reserve(packet->size());
-  packet->Serialize(i);
+  bytes->reserve(packet.size());
+  packet.Serialize(i);
   auto packet_view =
       bluetooth::packet::PacketView<bluetooth::packet::kLittleEndian>(bytes);
-  auto link_layer_packet_view =
-      model::packets::LinkLayerPacketView::Create(packet_view);
-  ASSERT(link_layer_packet_view.IsValid());
+  return model::packets::LinkLayerPacketView::Create(packet_view);
+}
 
-  Send(link_layer_packet_view, id, device_id);
+void PhyLayerFactory::Send(
+    const std::shared_ptr<model::packets::LinkLayerPacketBuilder> packet,
+    uint32_t id, [[maybe_unused]] uint32_t device_id) {
+  Send(Serialize(*packet), id, device_id);
 }
 
-void PhyLayerFactory::Send(model::packets::LinkLayerPacketView packet,
+void PhyLayerFactory::Send(const model::packets::LinkLayerPacketView& packet,
                            uint32_t id, [[maybe_unused]] uint32_t device_id) {
+  // The packet is validated once here, all the receivers then share the
+  // same view of its bytes and don't check it again
+  model::packets::LinkLayerPacketView shared_packet = packet;
+  ASSERT(shared_packet.IsValid());
+  // In a sharded step the packet is delivered once all the shards are done
+  if (ShardedPhySimulation::Post(this, id, shared_packet)) {
+    return;
+  }
+  if (radio_model_ != nullptr &&
+      radio_model_->ForEachInRange(id, [&shared_packet](PhyLayer& phy) {
+        phy.Receive(shared_packet);
+      })) {
+    return;
+  }
   for (const auto& phy : phy_layers_) {
     if (id != phy->GetId()) {
+      phy->Receive(shared_packet);
+    }
+  }
+}
+
+void PhyLayerFactory::DeliverToShard(
+    const model::packets::LinkLayerPacketView& packet, uint32_t id,
+    size_t shard, size_t num_shards) {
+  auto receive = [&](PhyLayer& phy) {
+    if (phy.GetDeviceId() % num_shards == shard) {
+      phy.Receive(packet);
+    }
+  };
+  if (radio_model_ != nullptr && radio_model_->ForEachInRange(id, receive)) {
+    return;
+  }
+  for (const auto& phy : phy_layers_) {
+    if (id != phy->GetId() && phy->GetDeviceId() % num_shards == shard) {
       phy->Receive(packet);
     }
   }
 }
 
+void PhyLayerFactory::SetRadioRange(double range) {
+  if (range <= 0) {
+    radio_model_.reset();
+    return;
+  }
+  if (radio_model_ != nullptr) {
+    radio_model_->SetRange(range);
+    return;
+  }
+  radio_model_ = std::make_unique<RadioModel>(range);
+  for (const auto& phy : phy_layers_) {
+    radio_model_->AddPhyLayer(phy);
+  }
+}
+
+void PhyLayerFactory::SetDevicePosition(uint32_t device_id, double x,
+                                        double y) {
+  if (radio_model_ != nullptr) {
+    radio_model_->SetDevicePosition(device_id, RadioModel::Position{x, y});
+  }
+}
+
 void PhyLayerFactory::TimerTick() {
   for (auto& phy : phy_layers_) {
     phy->TimerTick();
@@ -103,13 +166,16 @@ std::string PhyLayerFactory::ToString() const {
     factory << phy->GetDeviceId();
     factory << ",";
   }
+  if (radio_model_ != nullptr) {
+    factory << " range: " << radio_model_->GetRange();
+  }
 
   return factory.str();
 }
 
 PhyLayerImpl::PhyLayerImpl(
     Phy::Type phy_type, uint32_t id,
-    const std::function<void(model::packets::LinkLayerPacketView)>&
+    const std::function<void(const model::packets::LinkLayerPacketView&)>&
         device_receive,
     uint32_t device_id, PhyLayerFactory* factory)
     : PhyLayer(phy_type, id, device_receive, device_id), factory_(factory) {}
@@ -121,7 +187,7 @@ void PhyLayerImpl::Send(
   factory_->Send(packet, GetId(), GetDeviceId());
 }
 
-void PhyLayerImpl::Send(model::packets::LinkLayerPacketView packet) {
+void PhyLayerImpl::Send(const model::packets::LinkLayerPacketView& packet) {
   factory_->Send(packet, GetId(), GetDeviceId());
 }
 
@@ -131,7 +197,8 @@ bool PhyLayerImpl::IsFactoryId(uint32_t id) {
   return factory_->GetFactoryId() == id;
 }
 
-void PhyLayerImpl::Receive(model::packets::LinkLayerPacketView packet) {
+void PhyLayerImpl::Receive(
+    const model::packets::LinkLayerPacketView& packet) {
   transmit_to_device_(packet);
 }
 
@@ -21,6 +21,7 @@
 #include <vector>
 
 #include "include/phy.h"
+#include "model/setup/radio_model.h"
 #include "packets/link_layer_packets.h"
 #include "phy_layer.h"
 
@@ -39,45 +40,62 @@ class PhyLayerFactory {
   uint32_t GetFactoryId();
 
   std::shared_ptr<PhyLayer> GetPhyLayer(
-      const std::function<void(model::packets::LinkLayerPacketView)>&
-          device_receive,
+      const std::function<
+          void(const model::packets::LinkLayerPacketView&)>& device_receive,
       uint32_t device_id);
 
   void UnregisterPhyLayer(uint32_t id);
 
+  // Serialize a packet into the view shared by all its receivers
+  static model::packets::LinkLayerPacketView Serialize(
+      const model::packets::LinkLayerPacketBuilder& packet);
+
   void UnregisterAllPhyLayers();
 
   virtual void TimerTick();
 
   virtual std::string ToString() const;
 
+  // Deliver a packet sent by the phy layer phy_id to the phy layers of the
+  // devices in shard, those with device_id % num_shards == shard
+  void DeliverToShard(const model::packets::LinkLayerPacketView& packet,
+                      uint32_t phy_id, size_t shard, size_t num_shards);
+
+  // Only deliver the packets to the devices within range of the sender, or
+  // to all of them when range is not positive
+  void SetRadioRange(double range);
+
+  // Position of the device, used once a radio range is set
+  void SetDevicePosition(uint32_t device_id, double x, double y);
+
  protected:
   virtual void Send(
       std::shared_ptr<model::packets::LinkLayerPacketBuilder> packet,
       uint32_t phy_id, uint32_t device_id);
-  virtual void Send(
-      model::packets::LinkLayerPacketView packet,
-      uint32_t phy_id, uint32_t device_id);
+  virtual void Send(const model::packets::LinkLayerPacketView& packet,
+                    uint32_t phy_id, uint32_t device_id);
   std::list<std::shared_ptr<PhyLayer>> phy_layers_;
 
  private:
   Phy::Type phy_type_;
   uint32_t next_id_{1};
+  std::unique_ptr<RadioModel> radio_model_;
   const uint32_t factory_id_;
 };
 
 class PhyLayerImpl : public PhyLayer {
  public:
   PhyLayerImpl(Phy::Type phy_type, uint32_t id,
-               const std::function<void(model::packets::LinkLayerPacketView)>&
+               const std::function<
+                   void(const model::packets::LinkLayerPacketView&)>&
                    device_receive,
                uint32_t device_id, PhyLayerFactory* factory);
   ~PhyLayerImpl() override;
 
   void Send(
       std::shared_ptr<model::packets::LinkLayerPacketBuilder> packet) override;
-  void Send(model::packets::LinkLayerPacketView packet) override;
-  void Receive(model::packets::LinkLayerPacketView packet) override;
+  void Send(const model::packets::LinkLayerPacketView& packet) override;
+  void Receive(const model::packets::LinkLayerPacketView& packet) override;
   void Unregister() override;
   bool IsFactoryId(uint32_t factory_id) override;
   void TimerTick() override;
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "model/setup/radio_model.h"
+
+#include <algorithm>  // for remove_if, sort
+
+namespace rootcanal {
+
+void RadioModel::SetRange(double range) {
+  range_ = range;
+  cells_.clear();
+  // Placed again in the order of the phy ids, for the delivery order not to
+  // depend on the hashing
+  std::vector<uint32_t> phy_ids;
+  for (auto& [phy_id, position] : phy_positions_) {
+    phy_ids.push_back(phy_id);
+  }
+  std::sort(phy_ids.begin(), phy_ids.end());
+  for (uint32_t phy_id : phy_ids) {
+    const Position& position = phy_positions_[phy_id];
+    Cell cell = CellOf(position);
+    cells_[CellKey(cell.x, cell.y)].push_back(
+        Placed{phys_[phy_id].get(), position});
+  }
+}
+
+void RadioModel::AddPhyLayer(const std::shared_ptr<PhyLayer>& phy) {
+  phys_[phy->GetId()] = phy;
+  Place(phy);
+}
+
+void RadioModel::RemovePhyLayer(uint32_t phy_id) {
+  Unplace(phy_id);
+  phys_.erase(phy_id);
+}
+
+void RadioModel::SetDevicePosition(uint32_t device_id, Position position) {
+  device_positions_[device_id] = position;
+  for (auto& [phy_id, phy] : phys_) {
+    if (phy->GetDeviceId() == device_id) {
+      Unplace(phy_id);
+      Place(phy);
+    }
+  }
+}
+
+void RadioModel::Place(const std::shared_ptr<PhyLayer>& phy) {
+  auto position = device_positions_.find(phy->GetDeviceId());
+  if (position == device_positions_.end()) {
+    unplaced_.push_back(phy.get());
+    return;
+  }
+  phy_positions_[phy->GetId()] = position->second;
+  Cell cell = CellOf(position->second);
+  cells_[CellKey(cell.x, cell.y)].push_back(
+      Placed{phy.get(), position->second});
+}
+
+void RadioModel::Unplace(uint32_t phy_id) {
+  auto position = phy_positions_.find(phy_id);
+  if (position == phy_positions_.end()) {
+    unplaced_.erase(std::remove_if(unplaced_.begin(), unplaced_.end(),
+                                   [phy_id](PhyLayer* phy) {
+                                     return phy->GetId() == phy_id;
+                                   }),
+                    unplaced_.end());
+    return;
+  }
+  Cell cell = CellOf(position->second);
+  auto it = cells_.find(CellKey(cell.x, cell.y));
+  if (it != cells_.end()) {
+    auto& placed = it->second;
+    placed.erase(std::remove_if(placed.begin(), placed.end(),
+                                [phy_id](const Placed& p) {
+                                  return p.phy->GetId() == phy_id;
+                                }),
+                 placed.end());
+    if (placed.empty()) {
+      cells_.erase(it);
+    }
+  }
+  phy_positions_.erase(position);
+}
+
+}  // namespace rootcanal
@@ -0,0 +1,122 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cmath>          // for floor
+#include <cstdint>        // for uint32_t, uint64_t
+#include <memory>         // for shared_ptr
+#include <optional>       // for optional
+#include <unordered_map>  // for unordered_map
+#include <vector>         // for vector
+
+#include "model/setup/phy_layer.h"  // for PhyLayer
+
+namespace rootcanal {
+
+// Positions of the devices on a phy, for the packets to only reach the
+// devices within range of the sender. The devices placed are kept in a grid
+// of square cells the size of the range, so that the receivers are found in
+// the 3x3 cells around the sender instead of going through all the devices.
+// Devices without a position, like the controllers of the hosts, hear and
+// are heard by every device.
+class RadioModel {
+ public:
+  struct Position {
+    double x;
+    double y;
+  };
+
+  explicit RadioModel(double range) : range_(range) {}
+
+  double GetRange() const { return range_; }
+
+  // Change the range, the devices are placed in a new grid
+  void SetRange(double range);
+
+  void AddPhyLayer(const std::shared_ptr<PhyLayer>& phy);
+  void RemovePhyLayer(uint32_t phy_id);
+
+  // Move the phy layers of the device, and those it registers later
+  void SetDevicePosition(uint32_t device_id, Position position);
+
+  // Call receive(PhyLayer&) on the phy layers in range of phy_id, itself
+  // excluded. Returns false without calling it if phy_id has no position,
+  // the packet then has to reach every phy layer.
+  template <typename F>
+  bool ForEachInRange(uint32_t phy_id, F receive) const {
+    auto sender = phy_positions_.find(phy_id);
+    if (sender == phy_positions_.end()) {
+      return false;
+    }
+    const Position& from = sender->second;
+    for (PhyLayer* phy : unplaced_) {
+      receive(*phy);
+    }
+    const double range2 = range_ * range_;
+    const Cell cell = CellOf(from);
+    for (int32_t dx = -1; dx <= 1; dx++) {
+      for (int32_t dy = -1; dy <= 1; dy++) {
+        auto it = cells_.find(CellKey(cell.x + dx, cell.y + dy));
+        if (it == cells_.end()) {
+          continue;
+        }
+        for (const auto& placed : it->second) {
+          double ex = placed.position.x - from.x;
+          double ey = placed.position.y - from.y;
+          if (placed.phy->GetId() != phy_id && ex * ex + ey * ey <= range2) {
+            receive(*placed.phy);
+          }
+        }
+      }
+    }
+    return true;
+  }
+
+ private:
+  struct Cell {
+    int32_t x;
+    int32_t y;
+  };
+
+  struct Placed {
+    PhyLayer* phy;
+    Position position;
+  };
+
+  Cell CellOf(Position position) const {
+    return Cell{static_cast<int32_t>(std::floor(position.x / range_)),
+                static_cast<int32_t>(std::floor(position.y / range_))};
+  }
+
+  static uint64_t CellKey(int32_t x, int32_t y) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) |
+           static_cast<uint32_t>(y);
+  }
+
+  void Place(const std::shared_ptr<PhyLayer>& phy);
+  void Unplace(uint32_t phy_id);
+
+  double range_;
+  std::unordered_map<uint32_t, Position> device_positions_;
+  std::unordered_map<uint32_t, std::shared_ptr<PhyLayer>> phys_;
+  std::unordered_map<uint32_t, Position> phy_positions_;
+  std::unordered_map<uint64_t, std::vector<Placed>> cells_;
+  std::vector<PhyLayer*> unplaced_;
+};
+
+}  // namespace rootcanal
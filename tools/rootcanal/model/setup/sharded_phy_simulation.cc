@@ -0,0 +1,148 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "model/setup/sharded_phy_simulation.h"
+
+#include <utility>  // for move
+
+#include "model/setup/phy_layer_factory.h"  // for PhyLayerFactory
+#include "os/log.h"                         // for LOG_WARN
+
+namespace rootcanal {
+
+thread_local ShardedPhySimulation::Shard*
+    ShardedPhySimulation::current_shard_ = nullptr;
+
+ShardedPhySimulation::ShardedPhySimulation(size_t num_shards) {
+  for (size_t i = 0; i < num_shards; i++) {
+    auto shard = std::make_unique<Shard>();
+    shard->simulation = this;
+    shard->index = i;
+    shards_.push_back(std::move(shard));
+  }
+  // Started once the shards are all in place, the workers never touch the
+  // vector itself outside of a phase
+  for (auto& shard : shards_) {
+    Shard* shard_p = shard.get();
+    shard->thread = std::thread([this, shard_p]() { WorkerRoutine(shard_p); });
+  }
+}
+
+ShardedPhySimulation::~ShardedPhySimulation() {
+  {
+    std::unique_lock<std::mutex> guard(mutex_);
+    stopping_ = true;
+  }
+  start_cv_.notify_all();
+  for (auto& shard : shards_) {
+    shard->thread.join();
+  }
+}
+
+void ShardedPhySimulation::Step(size_t num_devices,
+                                const std::function<void(size_t)>& tick) {
+  const size_t num_shards = shards_.size();
+  RunPhase([&](Shard& shard) {
+    for (size_t i = shard.index; i < num_devices; i += num_shards) {
+      tick(i);
+    }
+  });
+
+  for (size_t round = 0; round < kMaxDeliveryRounds && HasPendingPackets();
+       round++) {
+    const size_t delivering = sending_;
+    sending_ = 1 - sending_;
+    RunPhase([&](Shard& shard) {
+      for (auto& sender : shards_) {
+        for (auto& pending : sender->outbox[delivering]) {
+          pending.factory->DeliverToShard(pending.packet, pending.phy_id,
+                                          shard.index, num_shards);
+        }
+      }
+    });
+    for (auto& shard : shards_) {
+      shard->outbox[delivering].clear();
+    }
+  }
+
+  if (HasPendingPackets()) {
+    LOG_WARN("Dropping the packets still sent after %zu delivery rounds",
+             kMaxDeliveryRounds);
+    for (auto& shard : shards_) {
+      shard->outbox[sending_].clear();
+    }
+  }
+}
+
+bool ShardedPhySimulation::Post(
+    PhyLayerFactory* factory, uint32_t phy_id,
+    const model::packets::LinkLayerPacketView& packet) {
+  Shard* shard = current_shard_;
+  if (shard == nullptr) {
+    return false;
+  }
+  shard->outbox[shard->simulation->sending_].push_back(
+      PendingPacket{factory, phy_id, packet});
+  return true;
+}
+
+void ShardedPhySimulation::RunPhase(const Phase& phase) {
+  std::unique_lock<std::mutex> guard(mutex_);
+  phase_ = &phase;
+  running_ = shards_.size();
+  generation_++;
+  start_cv_.notify_all();
+  done_cv_.wait(guard, [this]() { return running_ == 0; });
+  phase_ = nullptr;
+}
+
+bool ShardedPhySimulation::HasPendingPackets() const {
+  for (auto& shard : shards_) {
+    if (!shard->outbox[sending_].empty()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void ShardedPhySimulation::WorkerRoutine(Shard* shard) {
+  current_shard_ = shard;
+  uint64_t generation = 0;
+  while (true) {
+    const Phase* phase;
+    {
+      std::unique_lock<std::mutex> guard(mutex_);
+      start_cv_.wait(guard, [this, generation]() {
+        return stopping_ || generation_ != generation;
+      });
+      if (stopping_) {
+        return;
+      }
+      generation = generation_;
+      phase = phase_;
+    }
+    (*phase)(*shard);
+    {
+      std::unique_lock<std::mutex> guard(mutex_);
+      if (--running_ == 0) {
+        done_cv_.notify_one();
+      }
+    }
+  }
+}
+
+}  // namespace rootcanal
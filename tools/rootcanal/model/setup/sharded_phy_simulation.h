@@ -0,0 +1,105 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <condition_variable>  // for condition_variable
+#include <cstddef>             // for size_t
+#include <cstdint>             // for uint32_t, uint64_t
+#include <functional>          // for function
+#include <memory>              // for unique_ptr
+#include <mutex>               // for mutex
+#include <thread>              // for thread
+#include <vector>              // for vector
+
+#include "packets/link_layer_packets.h"  // for LinkLayerPacketView
+
+namespace rootcanal {
+
+class PhyLayerFactory;
+
+// Runs the time steps of the devices on a pool of worker threads, one per
+// shard, device i belonging to shard i % NumShards(). The packets sent from a
+// worker are not delivered right away but kept in the outbox of its shard,
+// which only that worker writes to. Once every shard is done, the packets of
+// all the outboxes are delivered in rounds: in each round every shard hands
+// the packets to its own devices, in the order of the sending shards then of
+// the sends. The replies are delivered in the next round. The order does not
+// depend on the scheduling of the threads, and the packets go between the
+// shards without any lock or atomic operation, the workers only synchronize at
+// the end of each phase.
+class ShardedPhySimulation {
+ public:
+  explicit ShardedPhySimulation(size_t num_shards);
+  ~ShardedPhySimulation();
+
+  ShardedPhySimulation(const ShardedPhySimulation&) = delete;
+  ShardedPhySimulation& operator=(const ShardedPhySimulation&) = delete;
+
+  size_t NumShards() const { return shards_.size(); }
+
+  // Call tick(i) for the devices 0 to num_devices - 1, on the worker of their
+  // shard, then deliver the packets sent until there are none left
+  void Step(size_t num_devices, const std::function<void(size_t)>& tick);
+
+  // Keep a packet sent by the phy layer phy_id of factory for the delivery
+  // rounds. Returns false when not called from a worker, the packet must then
+  // be delivered directly.
+  static bool Post(PhyLayerFactory* factory, uint32_t phy_id,
+                   const model::packets::LinkLayerPacketView& packet);
+
+ private:
+  // Packets ping-ponging faster than this are dropped at the end of a step
+  static constexpr size_t kMaxDeliveryRounds = 16;
+
+  struct PendingPacket {
+    PhyLayerFactory* factory;
+    uint32_t phy_id;
+    model::packets::LinkLayerPacketView packet;
+  };
+
+  struct Shard {
+    ShardedPhySimulation* simulation;
+    size_t index;
+    // Written by the worker of the shard while the other is delivered
+    std::vector<PendingPacket> outbox[2];
+    std::thread thread;
+  };
+
+  using Phase = std::function<void(Shard&)>;
+
+  // Run phase on every shard and wait for them to be done
+  void RunPhase(const Phase& phase);
+  bool HasPendingPackets() const;
+  void WorkerRoutine(Shard* shard);
+
+  static thread_local Shard* current_shard_;
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+  // Outbox the packets are sent to, the other one is being delivered
+  size_t sending_{0};
+
+  std::mutex mutex_;
+  std::condition_variable start_cv_;
+  std::condition_variable done_cv_;
+  const Phase* phase_{nullptr};
+  uint64_t generation_{0};
+  size_t running_{0};
+  bool stopping_{false};
+};
+
+}  // namespace rootcanal
@@ -46,6 +46,8 @@ TestCommandHandler::TestCommandHandler(TestModel& test_model)
   SET_HANDLER("del_device_from_phy", DelDeviceFromPhy);
   SET_HANDLER("list", List);
   SET_HANDLER("set_device_address", SetDeviceAddress);
+  SET_HANDLER("set_radio_range", SetRadioRange);
+  SET_HANDLER("set_device_position", SetDevicePosition);
   SET_HANDLER("set_timer_period", SetTimerPeriod);
   SET_HANDLER("start_timer", StartTimer);
   SET_HANDLER("stop_timer", StopTimer);
@@ -262,6 +264,41 @@ void TestCommandHandler::SetDeviceAddress(const vector<std::string>& args) {
   send_response_(response_string_);
 }
 
+void TestCommandHandler::SetRadioRange(const vector<std::string>& args) {
+  if (args.size() != 2) {
+    response_string_ =
+        "TestCommandHandler 'set_radio_range' takes two arguments";
+    send_response_(response_string_);
+    return;
+  }
+  size_t phy_id = std::stoi(args[0]);
+  double range = std::stod(args[1]);
+  model_.SetRadioRange(phy_id, range);
+  response_string_ = "set_radio_range " + args[0];
+  response_string_ += " ";
+  response_string_ += args[1];
+  send_response_(response_string_);
+}
+
+void TestCommandHandler::SetDevicePosition(const vector<std::string>& args) {
+  if (args.size() != 3) {
+    response_string_ =
+        "TestCommandHandler 'set_device_position' takes three arguments";
+    send_response_(response_string_);
+    return;
+  }
+  size_t device_id = std::stoi(args[0]);
+  double x = std::stod(args[1]);
+  double y = std::stod(args[2]);
+  model_.SetDevicePosition(device_id, x, y);
+  response_string_ = "set_device_position " + args[0];
+  response_string_ += " ";
+  response_string_ += args[1];
+  response_string_ += " ";
+  response_string_ += args[2];
+  send_response_(response_string_);
+}
+
 void TestCommandHandler::SetTimerPeriod(const vector<std::string>& args) {
   if (args.size() != 1) {
     LOG_INFO("SetTimerPeriod takes 1 argument");
@@ -78,6 +78,11 @@ class TestCommandHandler {
   // Change the device's MAC address
   void SetDeviceAddress(const std::vector<std::string>& args);
 
+  // Radio model: phy range and device positions
+  void SetRadioRange(const std::vector<std::string>& args);
+
+  void SetDevicePosition(const std::vector<std::string>& args);
+
   // Timer management functions
   void SetTimerPeriod(const std::vector<std::string>& args);
 
@@ -66,6 +66,18 @@ void TestModel::SetTimerPeriod(std::chrono::milliseconds new_period) {
   StartTimer();
 }
 
+void TestModel::SetNumPhyShards(size_t num_shards) {
+  LOG_INFO("Using %zu phy shards", num_shards);
+  // Swapped between two ticks
+  schedule_task_(model_user_id_, std::chrono::milliseconds(0),
+                 [this, num_shards]() {
+                   sharded_phy_simulation_ =
+                       num_shards == 0
+                           ? nullptr
+                           : std::make_unique<ShardedPhySimulation>(num_shards);
+                 });
+}
+
 void TestModel::StartTimer() {
   LOG_INFO("StartTimer()");
   timer_tick_task_ = schedule_periodic_task_(
@@ -127,8 +139,8 @@ void TestModel::AddDeviceToPhy(size_t dev_index, size_t phy_index) {
   }
   auto dev = devices_[dev_index];
   dev->RegisterPhyLayer(phys_[phy_index]->GetPhyLayer(
-      [dev](model::packets::LinkLayerPacketView packet) {
-        dev->IncomingPacket(std::move(packet));
+      [dev](const model::packets::LinkLayerPacketView& packet) {
+        dev->IncomingPacket(packet);
       },
       dev_index));
 }
@@ -223,6 +235,24 @@ void TestModel::SetDeviceAddress(size_t index, Address address) {
   devices_[index]->SetAddress(std::move(address));
 }
 
+void TestModel::SetRadioRange(size_t phy_index, double range) {
+  if (phy_index >= phys_.size()) {
+    LOG_WARN("Can't find phy %zu", phy_index);
+    return;
+  }
+  phys_[phy_index]->SetRadioRange(range);
+}
+
+void TestModel::SetDevicePosition(size_t index, double x, double y) {
+  if (index >= devices_.size() || devices_[index] == nullptr) {
+    LOG_WARN("Can't find device %zu", index);
+    return;
+  }
+  for (auto& phy : phys_) {
+    phy->SetDevicePosition(index, x, y);
+  }
+}
+
 const std::string& TestModel::List() {
   list_string_ = "";
   list_string_ += " Devices: \r\n";
@@ -243,6 +273,14 @@ const std::string& TestModel::List() {
 }
 
 void TestModel::TimerTick() {
+  if (sharded_phy_simulation_ != nullptr) {
+    sharded_phy_simulation_->Step(devices_.size(), [this](size_t i) {
+      if (devices_[i] != nullptr) {
+        devices_[i]->TimerTick();
+      }
+    });
+    return;
+  }
   for (size_t i = 0; i < devices_.size(); i++) {
     if (devices_[i] != nullptr) {
       devices_[i]->TimerTick();
@@ -24,11 +24,12 @@
 #include <string>      // for string
 #include <vector>      // for vector
 
-#include "hci/address.h"                       // for Address
-#include "model/devices/hci_device.h"          // for HciDevice
-#include "model/setup/async_manager.h"         // for AsyncUserId, AsyncTaskId
-#include "phy.h"                               // for Phy, Phy::Type
-#include "phy_layer_factory.h"                 // for PhyLayerFactory
+#include "hci/address.h"                         // for Address
+#include "model/devices/hci_device.h"            // for HciDevice
+#include "model/setup/async_manager.h"           // for AsyncUserId, AsyncTaskId
+#include "model/setup/sharded_phy_simulation.h"  // for ShardedPhySimulation
+#include "phy.h"                                 // for Phy, Phy::Type
+#include "phy_layer_factory.h"                   // for PhyLayerFactory
 
 namespace rootcanal {
 class Device;
@@ -91,12 +92,22 @@ class TestModel {
   // Set the device's Bluetooth address
   void SetDeviceAddress(size_t device_index, Address device_address);
 
+  // Only deliver the packets of the phy to the devices within range
+  void SetRadioRange(size_t phy_index, double range);
+
+  // Set the device's position, for the phys with a radio range
+  void SetDevicePosition(size_t device_index, double x, double y);
+
   // Let devices know about the passage of time
   void TimerTick();
   void StartTimer();
   void StopTimer();
   void SetTimerPeriod(std::chrono::milliseconds new_period);
 
+  // Tick the devices and deliver their packets on num_shards worker threads,
+  // or on the timer thread when 0
+  void SetNumPhyShards(size_t num_shards);
+
   // List the devices that the test knows about
   const std::string& List();
 
@@ -121,6 +132,8 @@ class TestModel {
   std::function<std::shared_ptr<Device>(const std::string&, int, Phy::Type)>
       connect_to_remote_;
 
+  std::unique_ptr<ShardedPhySimulation> sharded_phy_simulation_;
+
   AsyncUserId model_user_id_;
   AsyncTaskId timer_tick_task_{kInvalidTaskId};
   std::chrono::milliseconds timer_period_{};
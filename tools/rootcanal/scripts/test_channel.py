@@ -214,6 +214,18 @@ class TestChannelShell(cmd.Cmd):
     """
         self._test_channel.send_command('set_device_address', args.split())
 
+    def do_set_radio_range(self, args):
+        """Arguments: phy_num range Only deliver the packets of phy phy_num to the devices within range.
+
+    """
+        self._test_channel.send_command('set_radio_range', args.split())
+
+    def do_set_device_position(self, args):
+        """Arguments: dev_num x y Set the position of device dev_num, for the phys with a radio range.
+
+    """
+        self._test_channel.send_command('set_device_position', args.split())
+
     def do_list(self, args):
         """Arguments: [dev_num [attr]] List the devices from the controller, optionally filtered by device and attr.
 
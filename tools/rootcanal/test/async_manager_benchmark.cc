@@ -0,0 +1,134 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+#include <fcntl.h>   // for O_NONBLOCK
+#include <unistd.h>  // for pipe2, read, write, close
+
+#include <chrono>              // for milliseconds, hours
+#include <condition_variable>  // for condition_variable
+#include <cstdint>             // for uint64_t
+#include <mutex>               // for mutex
+#include <vector>              // for vector
+
+#include "model/setup/async_manager.h"
+
+using ::benchmark::State;
+using rootcanal::AsyncManager;
+using rootcanal::AsyncTaskId;
+using rootcanal::AsyncUserId;
+
+namespace {
+
+// Counts the events handled by the AsyncManager threads, for the benchmark
+// thread to wait on
+class EventCounter {
+ public:
+  void Add() {
+    std::unique_lock<std::mutex> lk(m_);
+    count_++;
+    cv_.notify_all();
+  }
+
+  void WaitFor(uint64_t count) {
+    std::unique_lock<std::mutex> lk(m_);
+    cv_.wait(lk, [&] { return count_ >= count; });
+  }
+
+ private:
+  std::mutex m_;
+  std::condition_variable cv_;
+  uint64_t count_ = 0;
+};
+
+// Each of the state.range(0) devices is a pipe watched by the AsyncManager,
+// as the HCI and link layer sockets are. An iteration is one byte written to
+// the next device and read back by its callback, so the time of an event
+// shows how the wakeups scale with the number of FDs watched.
+void BM_FdEvents(State& state) {
+  const int num_devices = state.range(0);
+  AsyncManager async_manager;
+  EventCounter counter;
+  std::vector<int> read_fds;
+  std::vector<int> write_fds;
+  for (int i = 0; i < num_devices; i++) {
+    int fds[2];
+    if (pipe2(fds, O_NONBLOCK) != 0) {
+      state.SkipWithError("Unable to create the pipes");
+      break;
+    }
+    async_manager.WatchFdForNonBlockingReads(fds[0], [&counter](int fd) {
+      char buffer;
+      while (read(fd, &buffer, 1) == 1) {
+        counter.Add();
+      }
+    });
+    read_fds.push_back(fds[0]);
+    write_fds.push_back(fds[1]);
+  }
+
+  uint64_t events = 0;
+  for (auto _ : state) {
+    if (write_fds.empty()) break;
+    char buffer = 0;
+    if (write(write_fds[events % write_fds.size()], &buffer, 1) != 1) {
+      state.SkipWithError("Unable to write to the pipe");
+      break;
+    }
+    counter.WaitFor(++events);
+  }
+  state.SetItemsProcessed(events);
+
+  for (int fd : read_fds) {
+    async_manager.StopWatchingFileDescriptor(fd);
+    close(fd);
+  }
+  for (int fd : write_fds) {
+    close(fd);
+  }
+}
+BENCHMARK(BM_FdEvents)->RangeMultiplier(4)->Range(1, 1024)->UseRealTime();
+
+// The state.range(0) tasks pending are the timers of that many controllers.
+// An iteration schedules and cancels a timer on top of them, then runs a task
+// through the task thread.
+void BM_TaskEvents(State& state) {
+  const int num_tasks = state.range(0);
+  AsyncManager async_manager;
+  AsyncUserId user_id = async_manager.GetNextUserId();
+  EventCounter counter;
+  for (int i = 0; i < num_tasks; i++) {
+    async_manager.ExecAsync(
+        user_id, std::chrono::hours(1) + std::chrono::milliseconds(i), [] {});
+  }
+
+  uint64_t events = 0;
+  for (auto _ : state) {
+    AsyncTaskId timer =
+        async_manager.ExecAsync(user_id, std::chrono::hours(1), [] {});
+    async_manager.CancelAsyncTask(timer);
+    async_manager.ExecAsync(user_id, std::chrono::milliseconds(0),
+                            [&counter] { counter.Add(); });
+    counter.WaitFor(++events);
+  }
+  state.SetItemsProcessed(events);
+  async_manager.CancelAsyncTasksFromUser(user_id);
+}
+BENCHMARK(BM_TaskEvents)->RangeMultiplier(8)->Range(1, 32768)->UseRealTime();
+
+}  // namespace
+
+BENCHMARK_MAIN();
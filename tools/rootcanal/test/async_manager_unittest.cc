@@ -34,8 +34,10 @@
 #include <string>              // for string
 #include <tuple>               // for tuple
 #include <thread>
+#include <vector>              // for vector
 
-#include "osi/include/osi.h"  // for OSI_NO_INTR
+#include "model/setup/clock.h"  // for Clock
+#include "osi/include/osi.h"    // for OSI_NO_INTR
 
 namespace rootcanal {
 
@@ -477,4 +479,57 @@ TEST_F(AsyncManagerTest, TestCancelAsyncTasksFromUser) {
   ASSERT_FALSE(async_manager_.CancelAsyncTask(task5_id));
 }
 
+TEST_F(AsyncManagerTest, TestTasksRunInOrderAfterCancel) {
+  AsyncUserId user1 = async_manager_.GetNextUserId();
+  std::vector<int> order;
+  std::vector<AsyncTaskId> task_ids;
+  Event done;
+  // Enough canceled tasks for the queue to be compacted
+  for (int i = 199; i >= 0; i--) {
+    task_ids.push_back(async_manager_.ExecAsync(
+        user1, std::chrono::milliseconds(20 + i / 10 * 5),
+        [&order, i]() { order.push_back(i); }));
+  }
+  async_manager_.ExecAsync(user1, std::chrono::milliseconds(150),
+                           [&done]() { done.set(); });
+  for (int i = 0; i < 200; i++) {
+    if (i % 4 != 0) {
+      ASSERT_TRUE(async_manager_.CancelAsyncTask(task_ids[199 - i]));
+    }
+  }
+  ASSERT_TRUE(done.wait_for(std::chrono::seconds(1)));
+  ASSERT_EQ(order.size(), 50u);
+  for (size_t i = 0; i < order.size(); i++) {
+    ASSERT_EQ(order[i] / 10, static_cast<int>(i) * 4 / 10);
+  }
+}
+
+class AsyncManagerVirtualTimeTest : public AsyncManagerTest {
+ public:
+  void SetUp() override { Clock::SetVirtualTime(true); }
+  void TearDown() override { Clock::SetVirtualTime(false); }
+};
+
+TEST_F(AsyncManagerVirtualTimeTest, TestTasksRunWithoutWaiting) {
+  AsyncUserId user1 = async_manager_.GetNextUserId();
+  Clock::time_point start = Clock::now();
+  int ticks = 0;
+  int ticks_at_end = 0;
+  Clock::duration elapsed{};
+  Event done;
+  async_manager_.ExecAsyncPeriodically(user1, std::chrono::milliseconds(0),
+                                       std::chrono::seconds(1),
+                                       [&ticks]() { ticks++; });
+  async_manager_.ExecAsync(user1, std::chrono::milliseconds(60500), [&]() {
+    ticks_at_end = ticks;
+    elapsed = Clock::now() - start;
+    done.set();
+  });
+  // A minute of simulated time goes by in much less than a second
+  ASSERT_TRUE(done.wait_for(std::chrono::seconds(1)));
+  async_manager_.CancelAsyncTasksFromUser(user1);
+  ASSERT_EQ(ticks_at_end, 61);
+  ASSERT_EQ(elapsed, std::chrono::milliseconds(60500));
+}
+
 }  // namespace rootcanal
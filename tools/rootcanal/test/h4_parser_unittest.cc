@@ -141,4 +141,30 @@ TEST_F(H4ParserTest, CallsTheRightCallbacks) {
   }
 }
 
+TEST_F(H4ParserTest, ConsumeStreamSplitsPackets) {
+  // Two back to back events followed by the first half of an ACL packet.
+  PacketData stream = {
+      (uint8_t)PacketType::EVENT, 0x0e, 0x02, 0x01, 0x02,
+      (uint8_t)PacketType::EVENT, 0x0f, 0x00,
+      (uint8_t)PacketType::ACL,   0x01, 0x00, 0x04, 0x00, 0xaa, 0xbb,
+  };
+  ASSERT_TRUE(parser_.ConsumeStream(stream.data(), stream.size()));
+  ASSERT_EQ(PacketType::EVENT, type_);
+  ASSERT_EQ(PacketData({0x0f, 0x00}), packet_);
+  ASSERT_EQ(H4Parser::State::HCI_PAYLOAD, parser_.CurrentState());
+  ASSERT_EQ(2u, parser_.BytesRequested());
+
+  PacketData rest = {0xcc, 0xdd};
+  ASSERT_TRUE(parser_.ConsumeStream(rest.data(), rest.size()));
+  ASSERT_EQ(PacketType::ACL, type_);
+  ASSERT_EQ(PacketData({0x01, 0x00, 0x04, 0x00, 0xaa, 0xbb, 0xcc, 0xdd}),
+            packet_);
+  ASSERT_EQ(H4Parser::State::HCI_TYPE, parser_.CurrentState());
+}
+
+TEST_F(H4ParserTest, ConsumeStreamRejectsNoData) {
+  PacketData empty;
+  ASSERT_FALSE(parser_.ConsumeStream(empty.data(), empty.size()));
+}
+
 }  // namespace rootcanal
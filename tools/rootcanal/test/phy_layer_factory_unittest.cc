@@ -0,0 +1,55 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "model/setup/phy_layer_factory.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+namespace rootcanal {
+
+using ::bluetooth::hci::Address;
+using model::packets::AddressType;
+using model::packets::AdvertisementType;
+using model::packets::LeAdvertisementBuilder;
+using model::packets::LinkLayerPacketView;
+
+TEST(PhyLayerFactoryTest, ReceiversShareThePacket) {
+  PhyLayerFactory factory(Phy::Type::LOW_ENERGY, 0);
+  std::vector<std::shared_ptr<PhyLayer>> phys;
+  std::vector<const LinkLayerPacketView*> received;
+  for (uint32_t i = 0; i < 4; i++) {
+    phys.push_back(factory.GetPhyLayer(
+        [&received](const LinkLayerPacketView& packet) {
+          received.push_back(&packet);
+        },
+        i));
+  }
+
+  phys[0]->Send(LeAdvertisementBuilder::Create(
+      Address{{1, 2, 3, 4, 5, 6}}, Address::kEmpty, AddressType::PUBLIC,
+      AdvertisementType::ADV_NONCONN_IND, {}));
+
+  // Serialized once, the same view is given to all the other devices
+  ASSERT_EQ(received.size(), 3u);
+  EXPECT_EQ(received[0], received[1]);
+  EXPECT_EQ(received[0], received[2]);
+}
+
+}  // namespace rootcanal
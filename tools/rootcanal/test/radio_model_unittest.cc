@@ -0,0 +1,111 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "model/setup/radio_model.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace rootcanal {
+
+using model::packets::LinkLayerPacketBuilder;
+using model::packets::LinkLayerPacketView;
+
+class FakePhyLayer : public PhyLayer {
+ public:
+  FakePhyLayer(uint32_t id, uint32_t device_id)
+      : PhyLayer(Phy::Type::LOW_ENERGY, id, nullptr, device_id) {}
+
+  void Send(std::shared_ptr<LinkLayerPacketBuilder>) override {}
+  void Send(const LinkLayerPacketView&) override {}
+  void Receive(const LinkLayerPacketView&) override {}
+  void TimerTick() override {}
+  bool IsFactoryId(uint32_t) override { return true; }
+  void Unregister() override {}
+};
+
+class RadioModelTest : public ::testing::Test {
+ public:
+  // Phy layer i is the one of device i
+  void AddDevices(size_t num_devices) {
+    for (uint32_t i = 0; i < num_devices; i++) {
+      auto phy = std::make_shared<FakePhyLayer>(i, i);
+      phys_.push_back(phy);
+      radio_model_.AddPhyLayer(phy);
+    }
+  }
+
+  std::vector<uint32_t> InRange(uint32_t phy_id) {
+    std::vector<uint32_t> ids;
+    in_range_ = radio_model_.ForEachInRange(
+        phy_id, [&ids](PhyLayer& phy) { ids.push_back(phy.GetId()); });
+    std::sort(ids.begin(), ids.end());
+    return ids;
+  }
+
+  RadioModel radio_model_{10};
+  std::vector<std::shared_ptr<PhyLayer>> phys_;
+  bool in_range_{false};
+};
+
+TEST_F(RadioModelTest, OnlyDevicesInRange) {
+  AddDevices(4);
+  radio_model_.SetDevicePosition(0, {0, 0});
+  radio_model_.SetDevicePosition(1, {6, 8});
+  radio_model_.SetDevicePosition(2, {8, 8});
+  radio_model_.SetDevicePosition(3, {-25, 0});
+
+  ASSERT_EQ(InRange(0), std::vector<uint32_t>({1}));
+  ASSERT_TRUE(in_range_);
+  ASSERT_EQ(InRange(1), std::vector<uint32_t>({0, 2}));
+  ASSERT_EQ(InRange(3), std::vector<uint32_t>({}));
+}
+
+TEST_F(RadioModelTest, UnplacedDevicesHearEverything) {
+  AddDevices(3);
+  radio_model_.SetDevicePosition(0, {0, 0});
+  radio_model_.SetDevicePosition(1, {100, 0});
+
+  // Device 2 has no position
+  ASSERT_EQ(InRange(0), std::vector<uint32_t>({2}));
+  ASSERT_EQ(InRange(1), std::vector<uint32_t>({2}));
+  InRange(2);
+  ASSERT_FALSE(in_range_);
+}
+
+TEST_F(RadioModelTest, MovedAndRemoved) {
+  AddDevices(3);
+  radio_model_.SetDevicePosition(0, {0, 0});
+  radio_model_.SetDevicePosition(1, {50, 0});
+  radio_model_.SetDevicePosition(2, {55, 0});
+  ASSERT_EQ(InRange(0), std::vector<uint32_t>({}));
+
+  radio_model_.SetDevicePosition(1, {-5, 0});
+  ASSERT_EQ(InRange(0), std::vector<uint32_t>({1}));
+  ASSERT_EQ(InRange(2), std::vector<uint32_t>({}));
+
+  radio_model_.SetRange(60);
+  ASSERT_EQ(InRange(2), std::vector<uint32_t>({0, 1}));
+
+  radio_model_.RemovePhyLayer(1);
+  ASSERT_EQ(InRange(2), std::vector<uint32_t>({0}));
+}
+
+}  // namespace rootcanal
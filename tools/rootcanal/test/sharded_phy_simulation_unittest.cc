@@ -0,0 +1,116 @@
+/*
+ * Copyright 2026 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "model/setup/sharded_phy_simulation.h"
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "model/setup/phy_layer_factory.h"
+
+namespace rootcanal {
+
+using ::bluetooth::hci::Address;
+using model::packets::AddressType;
+using model::packets::AdvertisementType;
+using model::packets::LeAdvertisementBuilder;
+using model::packets::LinkLayerPacketView;
+
+class ShardedPhySimulationTest : public ::testing::Test {
+ public:
+  // Devices numbered from 0, each on its own phy layer of the factory
+  void AddDevices(size_t num_devices) {
+    received_.resize(num_devices);
+    for (size_t i = 0; i < num_devices; i++) {
+      phys_.push_back(factory_.GetPhyLayer(
+          [this, i](const LinkLayerPacketView& packet) {
+            received_[i].push_back(packet.GetSourceAddress().address[0]);
+            if (on_receive_) {
+              on_receive_(i, packet);
+            }
+          },
+          i));
+    }
+  }
+
+  void Advertise(size_t device, Address destination = Address::kEmpty) {
+    phys_[device]->Send(LeAdvertisementBuilder::Create(
+        Address{{static_cast<uint8_t>(device), 0, 0, 0, 0, 0}}, destination,
+        AddressType::PUBLIC, AdvertisementType::ADV_NONCONN_IND, {}));
+  }
+
+  PhyLayerFactory factory_{Phy::Type::LOW_ENERGY, 0};
+  std::vector<std::shared_ptr<PhyLayer>> phys_;
+  std::vector<std::vector<uint8_t>> received_;
+  std::function<void(size_t, const LinkLayerPacketView&)> on_receive_;
+};
+
+TEST_F(ShardedPhySimulationTest, DeliveredInShardOrder) {
+  AddDevices(8);
+  ShardedPhySimulation simulation(3);
+  std::vector<std::thread::id> tick_threads(8);
+  simulation.Step(8, [&](size_t i) {
+    tick_threads[i] = std::this_thread::get_id();
+    Advertise(i);
+  });
+
+  // The sends of shard 0 (devices 0, 3, 6) come first, then those of shard 1
+  // (1, 4, 7) and shard 2 (2, 5)
+  const std::vector<uint8_t> order = {0, 3, 6, 1, 4, 7, 2, 5};
+  for (size_t i = 0; i < 8; i++) {
+    std::vector<uint8_t> expected;
+    for (auto sender : order) {
+      if (sender != i) {
+        expected.push_back(sender);
+      }
+    }
+    ASSERT_EQ(received_[i], expected);
+    ASSERT_NE(tick_threads[i], std::this_thread::get_id());
+    ASSERT_EQ(tick_threads[i], tick_threads[i % 3]);
+  }
+}
+
+TEST_F(ShardedPhySimulationTest, RepliesDeliveredInTheSameStep) {
+  AddDevices(4);
+  // Device 1 replies to device 0, which sees the reply after its own round
+  on_receive_ = [this](size_t i, const LinkLayerPacketView& packet) {
+    if (i == 1 && packet.GetSourceAddress().address[0] == 0) {
+      Advertise(1, packet.GetSourceAddress());
+    }
+  };
+  ShardedPhySimulation simulation(2);
+  simulation.Step(4, [this](size_t i) {
+    if (i == 0) {
+      Advertise(0);
+    }
+  });
+  ASSERT_EQ(received_[0], std::vector<uint8_t>({1}));
+  ASSERT_EQ(received_[2], std::vector<uint8_t>({0, 1}));
+}
+
+TEST_F(ShardedPhySimulationTest, DeliveredDirectlyOutsideOfSteps) {
+  AddDevices(2);
+  ShardedPhySimulation simulation(2);
+  Advertise(0);
+  ASSERT_EQ(received_[1], std::vector<uint8_t>({0}));
+}
+
+}  // namespace rootcanal